@@ -0,0 +1,154 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "CancellationToken.h"
+
+#include "Structs.h"
+
+#include <algorithm>
+
+namespace SHOT
+{
+
+CancellationToken::~CancellationToken()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopWatchdog = true;
+    }
+
+    deadlineChanged.notify_all();
+
+    if(watchdog.joinable())
+        watchdog.join();
+}
+
+void CancellationToken::cancel(E_TerminationReason cancelReason)
+{
+    // The callbacks are called with the lock, so that they are not removed, e.g. with the MIP solver, meanwhile
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if(cancelled.load())
+        return;
+
+    reason = cancelReason;
+    cancelled.store(true);
+
+    for(auto& [callbackId, callback] : callbacks)
+        callback();
+
+    deadlineChanged.notify_all();
+}
+
+E_TerminationReason CancellationToken::getReason()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return (reason);
+}
+
+void CancellationToken::setDeadline(double seconds)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(seconds >= SHOT_DBL_MAX / 2 || seconds * 1e9 >= (double)(noDeadline - getNow()))
+        {
+            deadline.store(noDeadline);
+        }
+        else
+        {
+            deadline.store(getNow() + (int64_t)(std::max(0.0, seconds) * 1e9));
+
+            if(!watchdog.joinable())
+                watchdog = std::thread(&CancellationToken::runWatchdog, this);
+        }
+    }
+
+    deadlineChanged.notify_all();
+}
+
+void CancellationToken::clearDeadline()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        deadline.store(noDeadline);
+    }
+
+    deadlineChanged.notify_all();
+}
+
+double CancellationToken::getRemainingTime()
+{
+    if(cancelled.load())
+        return (0.0);
+
+    auto deadlineTime = deadline.load();
+
+    if(deadlineTime == noDeadline)
+        return (SHOT_DBL_MAX);
+
+    return (std::max(0.0, (deadlineTime - getNow()) * 1e-9));
+}
+
+int CancellationToken::registerCallback(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if(cancelled.load())
+        callback();
+
+    callbacks.emplace(nextCallbackId, std::move(callback));
+    return (nextCallbackId++);
+}
+
+void CancellationToken::removeCallback(int callbackId)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    callbacks.erase(callbackId);
+}
+
+void CancellationToken::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    cancelled.store(false);
+    deadline.store(noDeadline);
+    reason = E_TerminationReason::None;
+
+    deadlineChanged.notify_all();
+}
+
+void CancellationToken::runWatchdog()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while(!stopWatchdog)
+    {
+        auto deadlineTime = deadline.load();
+
+        if(cancelled.load() || deadlineTime == noDeadline)
+        {
+            deadlineChanged.wait(lock);
+            continue;
+        }
+
+        if(getNow() < deadlineTime)
+        {
+            deadlineChanged.wait_for(lock, std::chrono::nanoseconds(deadlineTime - getNow()));
+            continue;
+        }
+
+        // The lock is released since cancel() calls the callbacks with it
+        lock.unlock();
+        cancel(E_TerminationReason::TimeLimit);
+        lock.lock();
+    }
+}
+} // namespace SHOT
@@ -0,0 +1,128 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Enums.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace SHOT
+{
+
+// Tells the running solver to stop as soon as possible, either since it was cancelled by the user or since the hard
+// time limit was reached. The token is checked in the long loops of the solver, and the functions registered with it,
+// e.g. terminating the running MIP solver, are called once when it is cancelled. The deadline is watched by a
+// background thread, so that also the work that does not check the token is stopped in time.
+class CancellationToken
+{
+public:
+    CancellationToken() = default;
+    ~CancellationToken();
+
+    CancellationToken(const CancellationToken&) = delete;
+    CancellationToken& operator=(const CancellationToken&) = delete;
+
+    // Can be called from any thread, only the first call has an effect until the token is reset
+    void cancel(E_TerminationReason reason = E_TerminationReason::UserAbort);
+
+    // One atomic load if no deadline is set, so that it can be called in inner loops
+    inline bool isCancelled()
+    {
+        if(cancelled.load(std::memory_order_relaxed))
+            return (true);
+
+        auto deadlineTime = deadline.load(std::memory_order_relaxed);
+
+        if(deadlineTime == noDeadline || getNow() < deadlineTime)
+            return (false);
+
+        cancel(E_TerminationReason::TimeLimit);
+        return (true);
+    }
+
+    // UserAbort or TimeLimit, None if not cancelled
+    E_TerminationReason getReason();
+
+    // Cancels the token with the reason TimeLimit after the given time (s)
+    void setDeadline(double seconds);
+    void clearDeadline();
+
+    // The time (s) left until the deadline, zero if cancelled and SHOT_DBL_MAX if there is no deadline
+    double getRemainingTime();
+
+    // The function is called when the token is cancelled, from the cancelling thread, and directly if it already is.
+    // It must not call the token itself. Returns the identifier used to remove it.
+    int registerCallback(std::function<void()> callback);
+
+    // Waits for the function to finish if it is being called
+    void removeCallback(int callbackId);
+
+    // Clears the cancellation and the deadline before a new solve, the callbacks are kept
+    void reset();
+
+private:
+    static constexpr int64_t noDeadline = INT64_MAX;
+
+    std::atomic<bool> cancelled { false };
+    std::atomic<int64_t> deadline { noDeadline }; // In nanoseconds of the steady clock
+
+    std::mutex mutex;
+    std::condition_variable deadlineChanged;
+    E_TerminationReason reason = E_TerminationReason::None;
+
+    std::map<int, std::function<void()>> callbacks;
+    int nextCallbackId = 0;
+
+    std::thread watchdog;
+    bool stopWatchdog = false;
+
+    inline static int64_t getNow()
+    {
+        return (std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+    }
+
+    void runWatchdog();
+};
+
+// Registers the function with the token while in scope, e.g. to terminate a subsolver during its solve call
+class ScopedCancellationCallback
+{
+public:
+    ScopedCancellationCallback(std::shared_ptr<CancellationToken> token, std::function<void()> callback)
+        : token(std::move(token))
+    {
+        if(this->token)
+            callbackId = this->token->registerCallback(std::move(callback));
+    }
+
+    ~ScopedCancellationCallback()
+    {
+        if(token)
+            token->removeCallback(callbackId);
+    }
+
+    ScopedCancellationCallback(const ScopedCancellationCallback&) = delete;
+    ScopedCancellationCallback& operator=(const ScopedCancellationCallback&) = delete;
+
+private:
+    std::shared_ptr<CancellationToken> token;
+    int callbackId = -1;
+};
+} // namespace SHOT
@@ -0,0 +1,105 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "CutStore.h"
+#include "PointStore.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <iterator>
+
+namespace SHOT
+{
+
+bool CutStore::open(const std::string& filename, int numberOfVariables, int numberOfConstraints)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if(file.is_open())
+        file.close();
+
+    file.open(filename, std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+
+    if(!file)
+        return (false);
+
+    file << header << ' ' << version << '\n' << numberOfVariables << ' ' << numberOfConstraints << '\n';
+    file.flush();
+
+    return (file.good());
+}
+
+StoredPointPtr CutStore::add(int sourceConstraintIndex, E_HyperplaneSource source, const VectorDouble& point)
+{
+    fmt::memory_buffer buffer;
+
+    // The same record as a cut in a warm start file, with the shortest representation that is read back exactly
+    fmt::format_to(std::back_inserter(buffer), "{} {} {}", sourceConstraintIndex, static_cast<int>(source),
+        point.size());
+
+    for(auto& V : point)
+        fmt::format_to(std::back_inserter(buffer), " {}", V);
+
+    buffer.push_back('\n');
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    file.seekp(0, std::ios::end);
+    int64_t offset = file.tellp();
+
+    // Written at once so that a stopped run leaves at most the last record incomplete
+    file.write(buffer.data(), buffer.size());
+    file.flush();
+
+    if(!file || offset < 0)
+    {
+        file.clear();
+        return (nullptr);
+    }
+
+    auto storedPoint = std::make_shared<StoredPoint>();
+    storedPoint->numberOfValues = point.size();
+    storedPoint->cutStore = shared_from_this();
+    storedPoint->cutStoreOffset = offset;
+
+    return (storedPoint);
+}
+
+VectorDouble CutStore::readPoint(int64_t offset)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    file.seekg(offset);
+
+    int sourceConstraintIndex, source;
+    size_t size;
+    VectorDouble point;
+
+    if(!(file >> sourceConstraintIndex >> source >> size))
+    {
+        file.clear();
+        return (point);
+    }
+
+    point.resize(size);
+
+    for(auto& V : point)
+    {
+        if(!(file >> V))
+        {
+            file.clear();
+            return (VectorDouble());
+        }
+    }
+
+    return (point);
+}
+
+} // namespace SHOT
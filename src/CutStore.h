@@ -0,0 +1,52 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Enums.h"
+#include "Structs.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace SHOT
+{
+
+// An append-only file with the source and point of each generated cut, so that only the other data of the cuts is kept
+// in memory during long runs. The points are read back from the file when they are needed, e.g. when the cuts are
+// reused. Since every cut is written when it is added, the file of a stopped run can be read by WarmStart::read() to
+// resume the run with its cuts.
+class CutStore : public std::enable_shared_from_this<CutStore>
+{
+public:
+    CutStore() = default;
+
+    // Replaces an existing file
+    bool open(const std::string& filename, int numberOfVariables, int numberOfConstraints);
+    bool isOpen() const { return (file.is_open()); }
+
+    // The constraint index is -1 for the objective function, returns an empty handle if the cut could not be written
+    StoredPointPtr add(int sourceConstraintIndex, E_HyperplaneSource source, const VectorDouble& point);
+
+    VectorDouble readPoint(int64_t offset);
+
+    static constexpr const char* header = "SHOTCUTSTORE";
+    static constexpr int version = 1;
+
+private:
+    std::fstream file;
+    std::mutex mutex;
+};
+
+using CutStorePtr = std::shared_ptr<CutStore>;
+
+} // namespace SHOT
@@ -0,0 +1,159 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "DebugWriter.h"
+
+#include "Output.h"
+#include "Settings.h"
+#include "Utilities.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <fstream>
+
+#ifdef HAS_ZLIB
+#include <zlib.h>
+#endif
+
+namespace SHOT
+{
+
+DebugWriter::DebugWriter(EnvironmentPtr envPtr) : env(envPtr) { }
+
+DebugWriter::~DebugWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopWriterThread = true;
+    }
+
+    queueChanged.notify_all();
+
+    // The queued files are written before the thread stops
+    if(writerThread.joinable())
+        writerThread.join();
+}
+
+void DebugWriter::write(const std::string& fileName, std::string contents)
+{
+    bool compress = isCompressionAvailable() && env->settings->getSetting<bool>("Debug.Compress", "Output");
+
+    if(!env->settings->getSetting<bool>("Debug.Asynchronous", "Output"))
+    {
+        writeFile(fileName, contents, compress);
+        return;
+    }
+
+    size_t maxQueuedBytes = env->settings->getSetting<double>("Debug.QueueSize", "Output") * 1024.0 * 1024.0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if(!writerThread.joinable())
+        writerThread = std::thread(&DebugWriter::writeQueuedFiles, this);
+
+    // A file larger than the limit is queued when the queue is empty
+    queueChanged.wait(lock, [&] { return (queue.empty() || queuedBytes + contents.size() <= maxQueuedBytes); });
+
+    queuedBytes += contents.size();
+    queue.push_back({ fileName, std::move(contents), compress });
+
+    lock.unlock();
+    queueChanged.notify_all();
+}
+
+void DebugWriter::writePoint(const VectorDouble& point, const VectorString& variables, const std::string& fileName)
+{
+    write(fileName, Utilities::getVariablePointVectorString(point, variables));
+}
+
+void DebugWriter::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if(!writerThread.joinable())
+        return;
+
+    queueChanged.wait(lock, [&] { return (queue.empty() && !isWriting); });
+}
+
+bool DebugWriter::isCompressionAvailable()
+{
+#ifdef HAS_ZLIB
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+void DebugWriter::writeQueuedFiles()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while(true)
+    {
+        queueChanged.wait(lock, [&] { return (stopWriterThread || !queue.empty()); });
+
+        if(queue.empty())
+            return;
+
+        auto file = std::move(queue.front());
+        queue.pop_front();
+        queuedBytes -= file.contents.size();
+        isWriting = true;
+
+        lock.unlock();
+        queueChanged.notify_all();
+
+        writeFile(file.fileName, file.contents, file.compress);
+
+        lock.lock();
+        isWriting = false;
+        queueChanged.notify_all();
+    }
+}
+
+bool DebugWriter::writeFile(
+    const std::string& fileName, const std::string& contents, [[maybe_unused]] bool compress)
+{
+#ifdef HAS_ZLIB
+    if(compress)
+    {
+        z_stream stream {};
+
+        // The window bits 15 + 16 give a gzip header, so that the files can be read with e.g. zcat
+        if(deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK)
+        {
+            std::string compressed(deflateBound(&stream, contents.size()), '\0');
+
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(contents.data()));
+            stream.avail_in = contents.size();
+            stream.next_out = reinterpret_cast<Bytef*>(compressed.data());
+            stream.avail_out = compressed.size();
+
+            bool isCompressed = (deflate(&stream, Z_FINISH) == Z_STREAM_END);
+            compressed.resize(stream.total_out);
+            deflateEnd(&stream);
+
+            if(isCompressed)
+                return (writeFile(fileName + ".gz", compressed, false));
+        }
+
+        env->output->outputWarning(fmt::format(" Could not compress debug file {}.", fileName));
+    }
+#endif
+
+    if(Utilities::writeStringToFile(fileName, contents))
+        return (true);
+
+    env->output->outputError(fmt::format(" Could not write debug file {}.", fileName));
+    return (false);
+}
+
+} // namespace SHOT
@@ -0,0 +1,71 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Environment.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace SHOT
+{
+
+// Writes the debug files in Debug.Path, e.g. the problems, points and iteration data, so that the solver does not wait
+// for the disk. The contents are created in memory by the calling thread and written by a background thread, which is
+// started by the first file. If the queued contents exceed Debug.QueueSize, the calling thread waits until there is
+// room. With Debug.Compress and zlib, the files are compressed by the background thread and get the suffix .gz. The
+// files written directly by the MIP solvers, e.g. the dual problems, are not handled here.
+class DebugWriter
+{
+public:
+    DebugWriter(EnvironmentPtr envPtr);
+    ~DebugWriter();
+
+    DebugWriter(const DebugWriter&) = delete;
+    DebugWriter& operator=(const DebugWriter&) = delete;
+
+    // Writes the file directly instead if Debug.Asynchronous is false, may be called from any thread
+    void write(const std::string& fileName, std::string contents);
+
+    // As Utilities::saveVariablePointVectorToFile()
+    void writePoint(const VectorDouble& point, const VectorString& variables, const std::string& fileName);
+
+    // Waits until the queued files have been written
+    void flush();
+
+    static bool isCompressionAvailable();
+
+private:
+    EnvironmentPtr env;
+
+    std::thread writerThread;
+    std::mutex mutex;
+    std::condition_variable queueChanged;
+
+    struct QueuedFile
+    {
+        std::string fileName;
+        std::string contents;
+        bool compress;
+    };
+
+    std::deque<QueuedFile> queue;
+    size_t queuedBytes = 0;
+    bool isWriting = false;
+    bool stopWriterThread = false;
+
+    void writeQueuedFiles();
+    bool writeFile(const std::string& fileName, const std::string& contents, bool compress);
+};
+
+} // namespace SHOT
@@ -0,0 +1,150 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Structs.h"
+
+#include <cmath>
+#include <cstdint>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// An exact set of assignments of discrete variables, e.g. the integer combinations already used in fixed NLP problems
+// or integer cuts. Unlike a fingerprint (see HashIndex), two different assignments are never taken as the same. The
+// values are rounded to the nearest integer and packed with the binary variables as single bits and the other discrete
+// variables as one integer each. Assignments of different sets of variables are stored separately.
+class DiscreteAssignmentSet
+{
+public:
+    DiscreteAssignmentSet() = default;
+
+    // Indexed by the variable index, the other variables are packed as integers
+    void setBinaryVariables(std::vector<bool> isBinary) { isBinaryVariable = std::move(isBinary); }
+
+    // The values are given in the order of the variable indexes, returns false if the assignment was already added
+    template <typename T> bool add(const VectorInteger& variableIndexes, const std::vector<T>& values)
+    {
+        auto& layout = getLayout(variableIndexes);
+        return (layout.assignments.insert(pack(layout, values)).second);
+    }
+
+    template <typename T> bool contains(const VectorInteger& variableIndexes, const std::vector<T>& values) const
+    {
+        for(auto& L : layouts)
+        {
+            if(L.variableIndexes == variableIndexes)
+                return (L.assignments.count(pack(L, values)) > 0);
+        }
+
+        return (false);
+    }
+
+    size_t size() const
+    {
+        size_t numberOfAssignments = 0;
+
+        for(auto& L : layouts)
+            numberOfAssignments += L.assignments.size();
+
+        return (numberOfAssignments);
+    }
+
+    void clear() { layouts.clear(); }
+
+private:
+    using PackedAssignment = std::vector<uint64_t>;
+
+    struct PackedAssignmentHash
+    {
+        size_t operator()(const PackedAssignment& assignment) const
+        {
+            uint64_t hash = assignment.size();
+
+            for(auto W : assignment)
+                hash ^= W + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+
+            return (hash);
+        }
+    };
+
+    struct Layout
+    {
+        VectorInteger variableIndexes;
+        std::vector<bool> isBinary; // In the order of the variable indexes
+        size_t numberOfBitWords = 0;
+        std::unordered_set<PackedAssignment, PackedAssignmentHash> assignments;
+    };
+
+    std::vector<bool> isBinaryVariable;
+
+    // There are usually only one or two, e.g. the discrete variables of the original and the reformulated problem
+    std::vector<Layout> layouts;
+
+    Layout& getLayout(const VectorInteger& variableIndexes)
+    {
+        for(auto& L : layouts)
+        {
+            if(L.variableIndexes == variableIndexes)
+                return (L);
+        }
+
+        Layout layout;
+        layout.variableIndexes = variableIndexes;
+        layout.isBinary.reserve(variableIndexes.size());
+
+        size_t numberOfBinaries = 0;
+
+        for(auto I : variableIndexes)
+        {
+            bool isBinary = (I >= 0 && (size_t)I < isBinaryVariable.size() && isBinaryVariable[I]);
+            layout.isBinary.push_back(isBinary);
+
+            if(isBinary)
+                numberOfBinaries++;
+        }
+
+        layout.numberOfBitWords = (numberOfBinaries + 63) / 64;
+
+        layouts.push_back(std::move(layout));
+        return (layouts.back());
+    }
+
+    // The bits of the binary variables first, then the values of the other variables
+    template <typename T> static PackedAssignment pack(const Layout& layout, const std::vector<T>& values)
+    {
+        PackedAssignment packed(layout.numberOfBitWords, 0);
+        packed.reserve(layout.numberOfBitWords + layout.variableIndexes.size());
+
+        size_t bit = 0;
+
+        for(size_t i = 0; i < layout.isBinary.size(); i++)
+        {
+            auto value = (int64_t)std::llround((double)values[i]);
+
+            if(!layout.isBinary[i])
+            {
+                packed.push_back((uint64_t)value);
+                continue;
+            }
+
+            if(value != 0)
+                packed[bit / 64] |= (1ULL << (bit % 64));
+
+            bit++;
+        }
+
+        return (packed);
+    }
+};
+} // namespace SHOT
@@ -15,13 +15,48 @@
 #include "Iteration.h"
 #include "Utilities.h"
 #include "Timing.h"
+#include "Metrics.h"
 #include "Problem.h"
 #include "ObjectiveFunction.h"
 #include "MIPSolver/IMIPSolver.h"
 
+#include <unordered_map>
+
 namespace SHOT
 {
 
+namespace
+{
+
+// The values of binary variables as bits
+std::vector<uint64_t> packBinaryValues(const VectorInteger& values)
+{
+    std::vector<uint64_t> bits((values.size() + 63) / 64, 0);
+
+    for(size_t i = 0; i < values.size(); i++)
+    {
+        if(values[i] != 0)
+            bits[i / 64] |= (1ULL << (i % 64));
+    }
+
+    return (bits);
+}
+
+struct PackedBinaryValuesHash
+{
+    size_t operator()(const std::vector<uint64_t>& bits) const
+    {
+        uint64_t hash = bits.size();
+
+        for(auto W : bits)
+            hash ^= W + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+
+        return (hash);
+    }
+};
+
+} // namespace
+
 DualSolver::DualSolver(EnvironmentPtr envPtr) { env = envPtr; }
 
 void DualSolver::addDualSolutionCandidate(DualSolution solution)
@@ -108,13 +143,43 @@ void DualSolver::checkDualSolutionCandidates()
                 break;
             }
 
-            env->output->outputDebug(fmt::format("        New dual bound {}, source: {}", C.objValue, sourceDesc));
+            env->output->outputDebug("        New dual bound {}, source: {}", C.objValue, sourceDesc);
         }
     }
 
     this->dualSolutionCandidates.clear();
 }
 
+bool DualSolver::isPrimalSolutionCutOff(const Hyperplane& hyperplane)
+{
+    if(!env->results->hasPrimalSolution())
+        return (false);
+
+    auto point = env->results->primalSolution;
+
+    if(point.size() + env->reformulatedProblem->properties.numberOfAuxiliaryVariables
+        == (size_t)env->reformulatedProblem->properties.numberOfVariables)
+        env->reformulatedProblem->augmentAuxiliaryVariableValues(point);
+
+    if(point.size() != (size_t)env->reformulatedProblem->properties.numberOfVariables
+        || hyperplane.generatedPoint.size() != point.size())
+        return (false);
+
+    auto& constraint = hyperplane.sourceConstraint;
+    double tolerance = env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal");
+
+    if(constraint->calculateFunctionValue(point) > constraint->valueRHS + tolerance)
+        return (false);
+
+    // The value of the linearization in the primal solution
+    double value = constraint->calculateFunctionValue(hyperplane.generatedPoint);
+
+    for(auto& [V, derivative] : constraint->calculateGradient(hyperplane.generatedPoint, true))
+        value += derivative * (point[V->index] - hyperplane.generatedPoint[V->index]);
+
+    return (value > constraint->valueRHS + tolerance);
+}
+
 void DualSolver::addHyperplane(Hyperplane& hyperplane)
 {
     assert((int)hyperplane.generatedPoint.size() == env->reformulatedProblem->properties.numberOfVariables);
@@ -129,16 +194,24 @@ void DualSolver::addHyperplane(Hyperplane& hyperplane)
             && (!hasHyperplaneBeenAdded(hyperplane.pointHash, hyperplane.sourceConstraint->index))))
     {
         this->hyperplaneWaitingList.push_back(hyperplane);
+
+        if(env->metrics)
+            env->metrics->increment(E_MetricsCounter::CutsGenerated);
     }
     else
     {
-        env->output->outputDebug(
-            fmt::format("        Hyperplane with hash {} has been added already.", hyperplane.pointHash));
+        if(env->metrics)
+            env->metrics->increment(E_MetricsCounter::CutsFiltered);
+
+        env->output->outputDebug("        Hyperplane with hash {} has been added already.", hyperplane.pointHash);
     }
 }
 
 void DualSolver::addGeneratedHyperplane(const Hyperplane& hyperplane)
 {
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::CutsAdded);
+
     std::string source = "";
 
     switch(hyperplane.source)
@@ -179,6 +252,9 @@ void DualSolver::addGeneratedHyperplane(const Hyperplane& hyperplane)
     case E_HyperplaneSource::ObjectiveCuttingPlane:
         source = "objective cutting plane";
         break;
+    case E_HyperplaneSource::InitialTangent:
+        source = "initial tangent";
+        break;
     default:
         break;
     }
@@ -198,11 +274,23 @@ void DualSolver::addGeneratedHyperplane(const Hyperplane& hyperplane)
     genHyperplane.isLazy = false;
     genHyperplane.pointHash = hyperplane.pointHash;
 
-    if(env->settings->getSetting<bool>("HyperplaneCuts.SaveHyperplanePoints", "Dual"))
-        genHyperplane.generatedPoint = hyperplane.generatedPoint;
-
     genHyperplane.isSourceConvex = hyperplane.isSourceConvex;
 
+    // A convexity determined by sampling is not certain, so it is no longer used if a cut removes a feasible solution
+    if(genHyperplane.isSourceConvex && hyperplane.sourceConstraint
+        && hyperplane.sourceConstraint->properties.isConvexityFromSampling && isPrimalSolutionCutOff(hyperplane))
+    {
+        env->output->outputWarning(fmt::format("        Constraint {} is not convex as determined by sampling, since a "
+                                               "cut removes the primal solution.",
+            hyperplane.sourceConstraint->name));
+
+        hyperplane.sourceConstraint->properties.convexity = E_Convexity::Nonconvex;
+        hyperplane.sourceConstraint->properties.isConvexityFromSampling = false;
+        env->reformulatedProblem->properties.convexity = E_ProblemConvexity::Nonconvex;
+
+        genHyperplane.isSourceConvex = false;
+    }
+
     if(!genHyperplane.isSourceConvex)
     {
         if(env->results->solutionIsGlobal)
@@ -214,51 +302,80 @@ void DualSolver::addGeneratedHyperplane(const Hyperplane& hyperplane)
 
     if(hasHyperplaneBeenAdded(genHyperplane.pointHash, genHyperplane.sourceConstraintIndex))
     {
-        env->output->outputTrace(fmt::format("        Not added hyperplane with hash {} to constraint {}",
-            genHyperplane.pointHash, genHyperplane.sourceConstraintIndex));
+        env->output->outputTrace("        Not added hyperplane with hash {} to constraint {}",
+            genHyperplane.pointHash, genHyperplane.sourceConstraintIndex);
         return;
     }
 
     if(hyperplane.sourceConstraint)
     {
-        env->output->outputTrace(fmt::format("        Added hyperplane with hash {} to constraint {}",
-            genHyperplane.pointHash, genHyperplane.sourceConstraint->index));
+        env->output->outputTrace("        Added hyperplane with hash {} to constraint {}",
+            genHyperplane.pointHash, genHyperplane.sourceConstraint->index);
+    }
+
+    bool isObjectiveCut = (genHyperplane.source == E_HyperplaneSource::ObjectiveRootsearch
+        || genHyperplane.source == E_HyperplaneSource::ObjectiveCuttingPlane);
+
+    auto cutStoreFile = env->settings->getSetting<std::string>("HyperplaneCuts.DiskStore.File", "Dual");
+
+    if(cutStoreFile != "" && !hyperplaneCutStore)
+    {
+        hyperplaneCutStore = std::make_shared<CutStore>();
+
+        if(!hyperplaneCutStore->open(cutStoreFile, env->reformulatedProblem->properties.numberOfVariables,
+               env->reformulatedProblem->properties.numberOfNumericConstraints))
+        {
+            env->output->outputWarning(
+                fmt::format("        Could not create cut store {}, the points are kept in memory.", cutStoreFile));
+        }
+    }
+
+    if(hyperplaneCutStore && hyperplaneCutStore->isOpen())
+    {
+        genHyperplane.generatedPoint = hyperplaneCutStore->add(
+            isObjectiveCut ? -1 : genHyperplane.sourceConstraintIndex, genHyperplane.source, hyperplane.generatedPoint);
+    }
+    else if(env->settings->getSetting<bool>("HyperplaneCuts.SaveHyperplanePoints", "Dual")
+        || env->settings->getSetting<bool>("HyperplaneCuts.ReuseOnResolve", "Dual")
+        || env->settings->getSetting<std::string>("Checkpoint.File", "Output") != "")
+    {
+        // The points are needed to recreate the cuts when the problem is solved again or resumed
+        if(!hyperplanePointStore.hasReferenceBounds())
+            hyperplanePointStore.setReferenceBounds(env->reformulatedProblem->getVariableLowerBounds(),
+                env->reformulatedProblem->getVariableUpperBounds());
+
+        genHyperplane.generatedPoint = hyperplanePointStore.add(hyperplane.generatedPoint, hyperplane.pointHash);
     }
 
     generatedHyperplanes.push_back(genHyperplane);
+    generatedHyperplaneHashes.add(genHyperplane.pointHash, isObjectiveCut ? -1 : genHyperplane.sourceConstraintIndex);
 
     auto currentIteration = env->results->getCurrentIteration();
     currentIteration->numHyperplanesAdded++;
     currentIteration->totNumHyperplanes++;
     env->solutionStatistics.iterationLastDualCutAdded = currentIteration->iterationNumber;
 
-    env->output->outputTrace("        Hyperplane generated from: " + source);
+    env->output->outputTrace("        Hyperplane generated from: {}", source);
 }
 
-bool DualSolver::hasHyperplaneBeenAdded(double hash, int constraintIndex)
+bool DualSolver::hasHyperplaneBeenAdded(uint64_t hash, int constraintIndex)
 {
     // Cuts added as lazy might not actually always be added (e.g. in different threads), thus we have to allow them to
     // be added again
-    if(env->settings->getSetting<int>("TreeStrategy", "Dual") == static_cast<int>(ES_TreeStrategy::SingleTree))
+    if(!treeStrategySetting.isValid())
+        treeStrategySetting = env->settings->getSettingHandle<int>("TreeStrategy", "Dual");
+
+    if(treeStrategySetting.get() == static_cast<int>(ES_TreeStrategy::SingleTree))
         return false;
 
-    for(auto& H : generatedHyperplanes)
-    {
-        if((H.source == E_HyperplaneSource::ObjectiveRootsearch
-               || H.source == E_HyperplaneSource::ObjectiveCuttingPlane)
-            && constraintIndex == -1 && Utilities::isAlmostEqual(H.pointHash, hash, 1e-8))
-        {
-            return (true);
-        }
-        else if(H.source != E_HyperplaneSource::ObjectiveRootsearch
-            && H.source != E_HyperplaneSource::ObjectiveCuttingPlane && H.sourceConstraint->index == constraintIndex
-            && Utilities::isAlmostEqual(H.pointHash, hash, 1e-8))
-        {
-            return (true);
-        }
-    }
+    return (generatedHyperplaneHashes.contains(hash, constraintIndex));
+}
 
-    return (false);
+void DualSolver::clearGeneratedHyperplanes()
+{
+    generatedHyperplanes.clear();
+    generatedHyperplaneHashes.clear();
+    hyperplanePointStore.clear();
 }
 
 void DualSolver::addIntegerCut(IntegerCut integerCut)
@@ -275,11 +392,10 @@ void DualSolver::addIntegerCut(IntegerCut integerCut)
 
     integerCut.pointHash = Utilities::calculateHash(integerCut.variableValues);
 
-    if(!hasIntegerCutBeenAdded(integerCut.pointHash))
-        this->integerCutWaitingList.push_back(integerCut);
+    if(!hasIntegerCutBeenAdded(integerCut))
+        this->integerCutWaitingList.push_back(std::move(integerCut));
     else
-        env->output->outputDebug(
-            fmt::format("        Integer cut with hash {} has been added already.", integerCut.pointHash));
+        env->output->outputDebug("        Integer cut with hash {} has been added already.", integerCut.pointHash);
 }
 
 void DualSolver::addGeneratedIntegerCut(IntegerCut integerCut)
@@ -292,6 +408,10 @@ void DualSolver::addGeneratedIntegerCut(IntegerCut integerCut)
         source = "NLP fixed integer";
         break;
 
+    case E_IntegerCutSource::Combined:
+        source = "combined integer cuts";
+        break;
+
     default:
         break;
     }
@@ -304,9 +424,13 @@ void DualSolver::addGeneratedIntegerCut(IntegerCut integerCut)
         env->output->outputInfo("        Solution is no longer global since integer cut has been added.");
     }
 
-    env->output->outputDebug(fmt::format("        Added integer cut with hash {}", integerCut.pointHash));
+    env->output->outputDebug("        Added integer cut with hash {}", integerCut.pointHash);
+
+    generatedIntegerCutHashes.add(integerCut.pointHash);
 
-    generatedIntegerCuts.push_back(integerCut);
+    initializeIntegerCutVariables();
+    generatedIntegerCutAssignments.add(integerCut.variableIndexes, integerCut.variableValues);
+    generatedIntegerCuts.push_back(std::move(integerCut));
 
     auto currentIteration = env->results->getCurrentIteration();
     currentIteration->numHyperplanesAdded++;
@@ -314,20 +438,164 @@ void DualSolver::addGeneratedIntegerCut(IntegerCut integerCut)
 
     env->solutionStatistics.numberOfIntegerCuts++;
 
-    env->output->outputDebug("        Integer cut generated from: " + source);
+    env->output->outputDebug("        Integer cut generated from: {}", source);
 }
 
-bool DualSolver::hasIntegerCutBeenAdded(double hash)
+bool DualSolver::hasIntegerCutBeenAdded(uint64_t hash)
 {
+    return (generatedIntegerCutHashes.contains(hash));
+}
+
+bool DualSolver::hasIntegerCutBeenAdded(const IntegerCut& integerCut)
+{
+    return (generatedIntegerCutAssignments.contains(integerCut.variableIndexes, integerCut.variableValues));
+}
+
+void DualSolver::combineIntegerCuts()
+{
+    if(integerCutWaitingList.empty())
+        return;
+
+    // The cuts with the same variables and their index in the waiting list, -1 for the generated cuts
+    std::map<VectorInteger, std::vector<std::pair<IntegerCut*, int>>> cutGroups;
+
     for(auto& IC : generatedIntegerCuts)
     {
-        if(Utilities::isAlmostEqual(IC.pointHash, hash, 1e-8))
+        if(IC.areAllVariablesBinary)
+            cutGroups[IC.variableIndexes].emplace_back(&IC, -1);
+    }
+
+    for(size_t i = 0; i < integerCutWaitingList.size(); i++)
+    {
+        if(integerCutWaitingList[i].areAllVariablesBinary)
+            cutGroups[integerCutWaitingList[i].variableIndexes].emplace_back(&integerCutWaitingList[i], i);
+    }
+
+    std::vector<IntegerCut> combinedCuts;
+    std::vector<bool> isCombined(integerCutWaitingList.size(), false);
+
+    for(auto& [variableIndexes, cuts] : cutGroups)
+    {
+        if(cuts.size() < 2 || variableIndexes.size() < 2)
+            continue;
+
+        std::unordered_map<std::vector<uint64_t>, std::pair<IntegerCut*, int>, PackedBinaryValuesHash> packedCuts;
+
+        for(auto& C : cuts)
+            packedCuts.emplace(packBinaryValues(C.first->variableValues), C);
+
+        for(auto& [C, waitingIndex] : cuts)
+        {
+            if(waitingIndex == -1 || isCombined[waitingIndex])
+                continue;
+
+            auto bits = packBinaryValues(C->variableValues);
+
+            for(size_t i = 0; i < variableIndexes.size(); i++)
+            {
+                bits[i / 64] ^= (1ULL << (i % 64));
+                auto partner = packedCuts.find(bits);
+                bits[i / 64] ^= (1ULL << (i % 64));
+
+                if(partner == packedCuts.end())
+                    continue;
+
+                auto [P, partnerWaitingIndex] = partner->second;
+
+                if(partnerWaitingIndex != -1 && isCombined[partnerWaitingIndex])
+                    continue;
+
+                IntegerCut combinedCut;
+                combinedCut.source = E_IntegerCutSource::Combined;
+                combinedCut.areAllVariablesBinary = true;
+                combinedCut.variableIndexes.reserve(variableIndexes.size() - 1);
+                combinedCut.variableValues.reserve(variableIndexes.size() - 1);
+
+                for(size_t j = 0; j < variableIndexes.size(); j++)
+                {
+                    if(j == i)
+                        continue;
+
+                    combinedCut.variableIndexes.push_back(variableIndexes[j]);
+                    combinedCut.variableValues.push_back(C->variableValues[j]);
+                }
+
+                combinedCut.pointHash = Utilities::calculateHash(combinedCut.variableValues);
+
+                isCombined[waitingIndex] = true;
+
+                if(partnerWaitingIndex != -1)
+                    isCombined[partnerWaitingIndex] = true;
+
+                env->output->outputDebug(
+                    "        Integer cuts with hashes {} and {} combined into one without variable {}", C->pointHash,
+                    P->pointHash, variableIndexes[i]);
+
+                if(!hasIntegerCutBeenAdded(combinedCut))
+                    combinedCuts.push_back(std::move(combinedCut));
+
+                break;
+            }
+        }
+    }
+
+    if(combinedCuts.empty())
+        return;
+
+    std::vector<IntegerCut> remainingCuts;
+    remainingCuts.reserve(integerCutWaitingList.size() + combinedCuts.size());
+
+    for(size_t i = 0; i < integerCutWaitingList.size(); i++)
+    {
+        if(!isCombined[i])
+            remainingCuts.push_back(std::move(integerCutWaitingList[i]));
+    }
+
+    for(auto& IC : combinedCuts)
+        remainingCuts.push_back(std::move(IC));
+
+    integerCutWaitingList = std::move(remainingCuts);
+}
+
+std::optional<std::pair<std::map<int, double>, double>> DualSolver::getBinaryIntegerCutTerms(
+    const IntegerCut& integerCut)
+{
+    std::map<int, double> terms;
+    double constant = 1.0;
+
+    for(size_t i = 0; i < integerCut.variableIndexes.size(); i++)
+    {
+        if(integerCut.variableValues[i] == 1)
+        {
+            terms.emplace_hint(terms.end(), integerCut.variableIndexes[i], 1.0);
+            constant -= 1.0;
+        }
+        else if(integerCut.variableValues[i] == 0)
+        {
+            terms.emplace_hint(terms.end(), integerCut.variableIndexes[i], -1.0);
+        }
+        else
         {
-            return (true);
+            return (std::nullopt);
         }
     }
 
-    return (false);
+    return (std::make_pair(std::move(terms), constant));
+}
+
+void DualSolver::initializeIntegerCutVariables()
+{
+    if(areIntegerCutVariablesInitialized)
+        return;
+
+    // The cuts are created in the original or reformulated problem, where the original variables have the same indexes
+    std::vector<bool> isBinary(env->reformulatedProblem->properties.numberOfVariables, false);
+
+    for(auto& V : env->reformulatedProblem->binaryVariables)
+        isBinary[V->index] = true;
+
+    generatedIntegerCutAssignments.setBinaryVariables(std::move(isBinary));
+    areIntegerCutVariablesInitialized = true;
 }
 
 } // namespace SHOT
\ No newline at end of file
@@ -11,6 +11,15 @@
 #pragma once
 #include "Environment.h"
 #include "Structs.h"
+#include "HashIndex.h"
+#include "DiscreteAssignmentSet.h"
+#include "PointStore.h"
+#include "CutStore.h"
+#include "Settings.h"
+
+#include <map>
+#include <optional>
+#include <utility>
 
 namespace SHOT
 {
@@ -29,27 +38,70 @@ public:
 
     void addHyperplane(Hyperplane& hyperplane);
     void addGeneratedHyperplane(const Hyperplane& hyperplane);
-    bool hasHyperplaneBeenAdded(double hash, int constraintIndex);
+    bool hasHyperplaneBeenAdded(uint64_t hash, int constraintIndex);
 
     void addIntegerCut(IntegerCut integerCut);
     void addGeneratedIntegerCut(IntegerCut integerCut);
-    bool hasIntegerCutBeenAdded(double hash);
+    bool hasIntegerCutBeenAdded(uint64_t hash);
+    bool hasIntegerCutBeenAdded(const IntegerCut& integerCut);
+
+    // Replaces the cuts in the waiting list that differ from another waiting or generated cut in the value of only one
+    // binary variable with a cut without this variable, which excludes both assignments
+    void combineIntegerCuts();
+
+    // The no-good cut sum(x_i, x_i = 1) - sum(x_i, x_i = 0) + 1 - |{x_i = 1}| <= 0 for a cut with only binary
+    // variables, as the terms and constant in the same form as for hyperplanes, or empty if a value is not 0 or 1
+    std::optional<std::pair<std::map<int, double>, double>> getBinaryIntegerCutTerms(const IntegerCut& integerCut);
+
+    void clearGeneratedHyperplanes();
 
     std::vector<GeneratedHyperplane> generatedHyperplanes;
     std::vector<Hyperplane> hyperplaneWaitingList;
 
+    // The points of the generated hyperplanes, each only stored once even if several hyperplanes are generated in it
+    PointStore hyperplanePointStore;
+
+    // If HyperplaneCuts.DiskStore.File is given, the points of the generated hyperplanes are only kept in this file
+    CutStorePtr hyperplaneCutStore;
+
     std::vector<IntegerCut> generatedIntegerCuts;
     std::vector<IntegerCut> integerCutWaitingList;
 
     std::vector<std::shared_ptr<InteriorPoint>> interiorPointCandidates;
     std::vector<std::shared_ptr<InteriorPoint>> interiorPts;
 
+    // Set by the solution limit strategy, the remaining total time is used if it is smaller
+    double MIPIterationTimeLimit = SHOT_DBL_MAX;
+
     double cutOffToUse = SHOT_DBL_INF;
     bool useCutOff = false;
     bool isSingleTree = false;
 
+    // Set before each multi-tree MIP solve, the incumbents are then checked in the MIP solver callbacks as they are
+    // found and the solve is interrupted after enough of them violate the nonlinear constraints
+    bool isSolutionStreamingUsed = false;
+    int maxStreamedViolatedSolutions = 0; // 0 if the solve should not be interrupted
+    int numberOfStreamedViolatedSolutions = 0;
+    bool isMIPSolveInterrupted = false;
+
 private:
     EnvironmentPtr env;
+
+    // Resolved on first use since the settings are created after the dual solver
+    SettingHandle<int> treeStrategySetting;
+
+    // The hashes of the generated hyperplanes grouped by source constraint index (-1 for the objective function)
+    HashIndex generatedHyperplaneHashes;
+    HashIndex generatedIntegerCutHashes;
+
+    // The exact variable values of the generated integer cuts, the binary variables are set on first use
+    DiscreteAssignmentSet generatedIntegerCutAssignments;
+    bool areIntegerCutVariablesInitialized = false;
+    void initializeIntegerCutVariables();
+
+    // Whether the hyperplane removes the primal solution although it fulfills the source constraint, which shows that
+    // the constraint is not convex
+    bool isPrimalSolutionCutOff(const Hyperplane& hyperplane);
 };
 
 } // namespace SHOT
\ No newline at end of file
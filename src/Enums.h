@@ -22,6 +22,7 @@ enum class E_AuxiliaryVariableType
     SignomialTermsPartitioning, // From reformulating signomial terms as constraints
     SquareTermsPartitioning, // From reformulating sums of square terms
     ContinuousBilinear, // From linearizing a bilinear term x1 * x2 where x1 and x2 are real
+    BilinearPartitioning, // From partitioning the domain of a variable in continuous bilinear terms
     BinaryBilinear, // From linearizing a bilinear term b1 * b2 where b1 and b2 are binary
     BinaryContinuousBilinear, // From linearizing a bilinear term b1 * x2 where b1 is binary and x2 is continuous
     IntegerBilinear, // From linearizing a bilinear term i1 * x2, where i1 is integer and x2 is continuous or discrete
@@ -52,7 +53,8 @@ enum class E_DualSolutionSource
 enum class E_EventType
 {
     NewPrimalSolution,
-    UserTerminationCheck
+    UserTerminationCheck,
+    IterationFinished // Should be the last event type
 };
 
 enum class E_HyperplaneSource
@@ -70,13 +72,15 @@ enum class E_HyperplaneSource
     InteriorPointSearch,
     MIPCallbackRelaxed,
     ObjectiveRootsearch,
-    ObjectiveCuttingPlane
+    ObjectiveCuttingPlane,
+    InitialTangent
 };
 
 enum class E_IntegerCutSource
 {
     None,
-    NLPFixedInteger
+    NLPFixedInteger,
+    Combined
 };
 
 enum class E_IterationLineType
@@ -110,6 +114,43 @@ enum class E_LogLevel
     Trace = 0
 };
 
+// The last element is only used to give the number of counters
+enum class E_MetricsCounter
+{
+    ConstraintEvaluations,
+    GradientEvaluations,
+    RootsearchCalls,
+    RootsearchIterations,
+    RootsearchWarmStarts,
+    CutsGenerated,
+    CutsFiltered,
+    CutsAdded,
+    MIPProblems,
+    NLPProblems,
+    NumberOfCounters
+};
+
+// The last element is only used to give the number of histograms
+enum class E_MetricsHistogram
+{
+    RootsearchTime,
+    MIPSolveTime,
+    NLPSolveTime,
+    NumberOfHistograms
+};
+
+// The last element is only used to give the number of gauges
+enum class E_MetricsGauge
+{
+    ResidentMemory,
+    PeakResidentMemory,
+    ModelMemory,
+    CutPoolMemory,
+    IterationHistoryMemory,
+    TapeMemory,
+    NumberOfGauges
+};
+
 enum class E_ModelReturnStatus
 {
     None,
@@ -140,7 +181,8 @@ enum class E_PrimalNLPSource
     FeasibleSolution,
     InfeasibleSolution,
     SmallestDeviationSolution,
-    FirstSolutionNewDualBound
+    FirstSolutionNewDualBound,
+    FixAndPropagate
 };
 
 enum class E_PrimalSolutionSource
@@ -152,7 +194,9 @@ enum class E_PrimalSolutionSource
     MIPSolutionPool,
     LPFixedIntegers,
     MIPCallback,
-    InteriorPointSearch
+    InteriorPointSearch,
+    WarmStart,
+    FeasibilityPump
 };
 
 enum class E_ProblemConvexity
@@ -228,6 +272,7 @@ enum class E_SolutionStrategy
     NLP,
     MIQP,
     MIQCQP,
+    Decomposition,
     None
 };
 
@@ -237,6 +282,18 @@ enum class E_SOSType
     Two
 };
 
+// The parts of the environment used by a task, see TaskBase::getReadStates()
+enum class E_TaskEnvironmentState
+{
+    Problem,
+    Results,
+    DualSolver,
+    PrimalSolver,
+    Report,
+    TaskHandler,
+    All
+};
+
 enum class E_TerminationReason
 {
     ConstraintTolerance,
@@ -254,6 +311,16 @@ enum class E_TerminationReason
     None
 };
 
+enum class E_UnivariateFunctionType
+{
+    Exp,
+    Log,
+    Power,
+    Sin,
+    Cos,
+    Tan
+};
+
 enum class E_VariableType
 {
     None,
@@ -269,7 +336,8 @@ enum class ES_AddPrimalPointAsInteriorPoint
     KeepOriginal,
     KeepBoth,
     KeepNew,
-    OnlyAverage
+    OnlyAverage,
+    Adaptive
 };
 
 enum class ES_EigenValueDecompositionFormulation
@@ -294,6 +362,13 @@ enum class ES_IpoptSolver
     mumps
 };
 
+enum class ES_IpoptHessianApproximation
+{
+    Exact,
+    LimitedMemory,
+    Automatic
+};
+
 enum class ES_IterationOutputDetail
 {
     Full,
@@ -317,7 +392,8 @@ enum class ES_RootsearchConstraintStrategy
 enum class ES_RootsearchMethod
 {
     BoostTOMS748,
-    BoostBisection
+    BoostBisection,
+    KSection
 };
 
 enum class ES_MIPSolver
@@ -328,6 +404,14 @@ enum class ES_MIPSolver
     None
 };
 
+enum class ES_MIPSolutionLimitStrategy
+{
+    Increase,
+    Adaptive,
+    Unlimited,
+    TimeProfile
+};
+
 enum class ES_MIPPresolveStrategy
 {
     Never,
@@ -386,6 +470,12 @@ enum class ES_ReformulateBilinearInteger
     Yes
 };
 
+enum class ES_BilinearIntegerEncoding
+{
+    Unary,
+    Logarithmic
+};
+
 enum class ES_PartitionNonlinearSums
 {
     Always,
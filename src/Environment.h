@@ -18,6 +18,7 @@ namespace SHOT
 {
 
 class IRootsearchMethod;
+class IFixedNLPExecutor;
 
 class DllExport Environment
 {
@@ -33,13 +34,23 @@ public:
     DualSolverPtr dualSolver;
     PrimalSolverPtr primalSolver;
     OutputPtr output;
+    DebugWriterPtr debugWriter;
     ReportPtr report;
     TaskHandlerPtr tasks;
     TimingPtr timing;
+    MetricsPtr metrics;
+    MemoryMonitorPtr memoryMonitor;
+    TraceRecorderPtr traceRecorder;
     EventHandlerPtr events;
 
+    // Checked in the long loops, cancelled by Solver::cancel() or at the time limit if TimeLimit.Hard is used
+    CancellationTokenPtr cancellationToken;
+
     std::shared_ptr<IRootsearchMethod> rootsearchMethod;
 
+    // If set, used to solve the fixed NLP problems outside of the solver
+    std::shared_ptr<IFixedNLPExecutor> fixedNLPExecutor;
+
     SolutionStatistics solutionStatistics;
 
 private:
@@ -11,45 +11,206 @@
 #pragma once
 #include "Environment.h"
 #include "Enums.h"
+#include "Structs.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <condition_variable>
+#include <deque>
 #include <functional>
-#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <variant>
 #include <vector>
 #include <utility>
 
 namespace SHOT
 {
 
+// Dispatches the events to the registered callbacks. A callback either takes no arguments or the payload of its
+// event: a PrimalSolution for NewPrimalSolution and an IterationSummary for IterationFinished. The events can be
+// raised from the MIP solver callback threads, but the callbacks are never called concurrently with each other, except
+// with asynchronous dispatch, where the UserTerminationCheck callbacks are still called directly by the solver.
 class EventHandler
 {
 public:
+    using EventPayload = std::variant<std::monostate, const PrimalSolution*, const IterationSummary*>;
+    using EventCallback = std::function<void(const EventPayload&)>;
+
     inline EventHandler(EnvironmentPtr envPtr) : env(envPtr) {};
 
-    template <typename Callback> void registerCallback(const E_EventType& event, Callback&& callback)
+    inline ~EventHandler() { setAsynchronous(false, 0); }
+
+    EventHandler(const EventHandler&) = delete;
+    EventHandler& operator=(const EventHandler&) = delete;
+
+    // Callbacks should be registered before the problem is solved
+    template <typename Callback> void registerCallback(E_EventType event, Callback&& callback)
     {
-        registeredCallbacks[event].push_back(std::forward<Callback>(callback));
+        auto& eventCallbacks = registeredCallbacks[static_cast<size_t>(event)];
+
+        if constexpr(std::is_invocable_v<Callback>)
+        {
+            eventCallbacks.emplace_back(
+                [callback = std::forward<Callback>(callback)](const EventPayload&) mutable { callback(); });
+        }
+        else if constexpr(std::is_invocable_v<Callback, const PrimalSolution&>)
+        {
+            assert(event == E_EventType::NewPrimalSolution);
+
+            eventCallbacks.emplace_back(
+                [callback = std::forward<Callback>(callback)](const EventPayload& payload) mutable
+                { callback(*std::get<const PrimalSolution*>(payload)); });
+        }
+        else
+        {
+            static_assert(std::is_invocable_v<Callback, const IterationSummary&>,
+                "The callback must take no arguments, a PrimalSolution or an IterationSummary");
+
+            assert(event == E_EventType::IterationFinished);
+
+            eventCallbacks.emplace_back(
+                [callback = std::forward<Callback>(callback)](const EventPayload& payload) mutable
+                { callback(*std::get<const IterationSummary*>(payload)); });
+        }
     }
 
-    template <typename Callback> void registerCallback(E_EventType&& event, Callback&& callback)
+    inline bool hasCallbacks(E_EventType event) const
     {
-        registeredCallbacks[std::move(event)].push_back(std::forward<Callback>(callback));
+        return (!registeredCallbacks[static_cast<size_t>(event)].empty());
     }
 
-    inline void notify(const E_EventType& event) const
+    inline void notify(E_EventType event) { dispatch(event, std::monostate()); }
+
+    inline void notify(E_EventType event, const PrimalSolution& solution) { dispatch(event, solution); }
+
+    inline void notify(E_EventType event, const IterationSummary& summary) { dispatch(event, summary); }
+
+    // With asynchronous dispatch, the callbacks are called from a separate thread with copies of the payloads, so that
+    // the solver does not wait for them. The solver is only held up if more than queueSize events are waiting.
+    inline void setAsynchronous(bool useAsynchronous, size_t queueSize)
     {
-        if(registeredCallbacks.size() == 0)
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            maxQueueSize = std::max((size_t)1, queueSize);
+        }
+
+        if(useAsynchronous == dispatchThread.joinable())
             return;
 
-        if(registeredCallbacks.find(event) == registeredCallbacks.end())
+        if(useAsynchronous)
+        {
+            isStopped = false;
+            dispatchThread = std::thread(&EventHandler::dispatchQueuedEvents, this);
             return;
+        }
 
-        for(const auto& C : registeredCallbacks.at(event))
-            C();
+        // Dispatches the remaining queued events and stops the thread
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            isStopped = true;
+        }
+
+        queueChanged.notify_all();
+        dispatchThread.join();
+    }
+
+    // Waits until all queued events have been dispatched
+    inline void flush()
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        queueChanged.wait(lock, [this] { return (queuedEvents.empty() && !isDispatching); });
     }
 
 private:
-    std::map<E_EventType, std::vector<std::function<void()>>> registeredCallbacks;
+    using QueuedPayload = std::variant<std::monostate, PrimalSolution, IterationSummary>;
+
+    static constexpr size_t numberOfEventTypes = static_cast<size_t>(E_EventType::IterationFinished) + 1;
+
+    std::array<std::vector<EventCallback>, numberOfEventTypes> registeredCallbacks;
+
+    // Recursive, since a callback may raise a new event
+    std::recursive_mutex callbackMutex;
+
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+    std::deque<std::pair<E_EventType, QueuedPayload>> queuedEvents;
+    size_t maxQueueSize = 1;
+    bool isStopped = false;
+    bool isDispatching = false;
+    std::thread dispatchThread;
 
     EnvironmentPtr env;
+
+    template <typename Payload> inline void dispatch(E_EventType event, const Payload& payload)
+    {
+        // No locks or copies are needed for events without callbacks
+        if(!hasCallbacks(event))
+            return;
+
+        // The termination check must be answered before the solver continues
+        if(dispatchThread.joinable() && event != E_EventType::UserTerminationCheck)
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueChanged.wait(lock, [this] { return (queuedEvents.size() < maxQueueSize); });
+            queuedEvents.emplace_back(event, QueuedPayload(payload));
+            lock.unlock();
+
+            queueChanged.notify_all();
+            return;
+        }
+
+        if constexpr(std::is_same_v<Payload, std::monostate>)
+            callCallbacks(event, EventPayload());
+        else
+            callCallbacks(event, EventPayload(&payload));
+    }
+
+    inline void callCallbacks(E_EventType event, const EventPayload& payload)
+    {
+        std::lock_guard<std::recursive_mutex> lock(callbackMutex);
+
+        for(auto& C : registeredCallbacks[static_cast<size_t>(event)])
+            C(payload);
+    }
+
+    inline void dispatchQueuedEvents()
+    {
+        std::unique_lock<std::mutex> lock(queueMutex);
+
+        while(true)
+        {
+            queueChanged.wait(lock, [this] { return (!queuedEvents.empty() || isStopped); });
+
+            if(queuedEvents.empty())
+                return;
+
+            auto [event, queuedPayload] = std::move(queuedEvents.front());
+            queuedEvents.pop_front();
+            isDispatching = true;
+            lock.unlock();
+
+            queueChanged.notify_all();
+
+            auto payload = std::visit(
+                [](const auto& P) -> EventPayload
+                {
+                    if constexpr(std::is_same_v<std::decay_t<decltype(P)>, std::monostate>)
+                        return (EventPayload());
+                    else
+                        return (EventPayload(&P));
+                },
+                queuedPayload);
+
+            callCallbacks(event, payload);
+
+            lock.lock();
+            isDispatching = false;
+            queueChanged.notify_all();
+        }
+    }
 };
-} // namespace SHOT
\ No newline at end of file
+} // namespace SHOT
@@ -0,0 +1,135 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "FixedNLPWorker.h"
+
+#include "Output.h"
+#include "Settings.h"
+
+#include "Model/Problem.h"
+
+#include "Tasks/TaskSelectPrimalCandidatesFromNLP.h"
+
+#include "spdlog/fmt/fmt.h"
+
+namespace SHOT
+{
+
+FixedNLPWorker::FixedNLPWorker(EnvironmentPtr envPtr) : env(envPtr) { }
+
+bool FixedNLPWorker::listen(int port)
+{
+    auto address = env->settings->getSetting<std::string>("FixedInteger.WorkerAddress", "Primal");
+
+    if(!listener.listen(port, address))
+    {
+        env->output->outputError(
+            fmt::format(" Could not listen for fixed NLP problems on address {} and port {}.", address, port));
+        return (false);
+    }
+
+    env->output->outputInfo(fmt::format(
+        " Listening for fixed NLP problems on address {} and port {}.", address, listener.getPort()));
+    return (true);
+}
+
+void FixedNLPWorker::serve()
+{
+    isStopped = false;
+
+    while(!isStopped)
+    {
+        // Waits for a limited time so that stop() is noticed
+        auto connection = listener.accept(200);
+
+        if(connection)
+            serveConnection(*connection);
+    }
+}
+
+void FixedNLPWorker::serveConnection(FixedNLPConnection& connection)
+{
+    std::string line;
+    int numberOfVariables;
+    bool isReformulatedProblem;
+
+    if(!connection.readLine(line) || !FixedNLPProtocol::parseHello(line, numberOfVariables, isReformulatedProblem))
+    {
+        connection.sendLine("ERROR unsupported protocol");
+        return;
+    }
+
+    // Creates the NLP solver for the same problem as in the solver
+    TaskSelectPrimalCandidatesFromNLP task(env, isReformulatedProblem);
+
+    if(task.isSourceReformulatedProblem() != isReformulatedProblem
+        || task.getSourceProblem()->properties.numberOfVariables != numberOfVariables)
+    {
+        connection.sendLine(fmt::format("ERROR the problem has {} variables instead of {}",
+            task.getSourceProblem()->properties.numberOfVariables, numberOfVariables));
+        return;
+    }
+
+    if(!connection.sendLine("OK"))
+        return;
+
+    env->output->outputInfo(" Solver connected.");
+
+    while(connection.readLine(line))
+    {
+        auto type = FixedNLPProtocol::getType(line);
+
+        if(type == "BOUNDS")
+        {
+            std::map<int, PairDouble> variableBounds;
+
+            if(!FixedNLPProtocol::parseBounds(line, variableBounds))
+                break;
+
+            task.updateVariableBounds(variableBounds);
+        }
+        else if(type == "SOLVE")
+        {
+            uint64_t ID;
+            PrimalFixedNLPCandidate candidate {};
+
+            if(!FixedNLPProtocol::parseSolve(line, ID, candidate.point)
+                || (int)candidate.point.size() != numberOfVariables)
+                break;
+
+            FixedNLPResult result;
+
+            try
+            {
+                result = task.solveFixedNLPCandidate(candidate);
+            }
+            catch(std::exception& e)
+            {
+                env->output->outputError(" Error when solving fixed NLP problem:", e.what());
+            }
+
+            numberOfSolvedProblems++;
+
+            env->output->outputDebug(
+                " Solved fixed NLP problem {} with objective value {}.", ID, result.objectiveValue);
+
+            if(!connection.sendLine(FixedNLPProtocol::createResult(ID, result)))
+                break;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    env->output->outputInfo(fmt::format(" Solver disconnected after {} problems.", numberOfSolvedProblems.load()));
+}
+
+} // namespace SHOT
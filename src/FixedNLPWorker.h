@@ -0,0 +1,51 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "Environment.h"
+
+#include "NLPSolver/FixedNLPProtocol.h"
+
+#include <atomic>
+
+namespace SHOT
+{
+
+// Solves the fixed NLP problems sent by a solver with FixedInteger.RemoteWorkers, started with SHOT --worker. The
+// problem in the environment must be the same as in the solver, e.g. read from the same problem snapshot or problem
+// file with the same options, which is checked from the number of variables when the solver connects. The
+// connections are served one at a time, and every connection starts from the bounds of the problem.
+class DllExport FixedNLPWorker
+{
+public:
+    FixedNLPWorker(EnvironmentPtr envPtr);
+
+    // A port of 0 uses any free port, see getPort(). The address is given by FixedInteger.WorkerAddress.
+    bool listen(int port);
+    int getPort() { return (listener.getPort()); };
+
+    // Serves the connections until stop() is called
+    void serve();
+    void stop() { isStopped = true; };
+
+    int getNumberOfSolvedProblems() { return (numberOfSolvedProblems); };
+
+private:
+    void serveConnection(FixedNLPConnection& connection);
+
+    EnvironmentPtr env;
+    FixedNLPListener listener;
+
+    std::atomic<bool> isStopped = false;
+    std::atomic<int> numberOfSolvedProblems = 0;
+};
+
+} // namespace SHOT
@@ -0,0 +1,45 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace SHOT
+{
+
+// An index of point fingerprints (see Utilities::calculateHash), used to check whether a cut or point has been seen
+// before in constant expected time. The fingerprints are grouped, e.g. by constraint index, and only fingerprints in
+// the same group are compared.
+class HashIndex
+{
+public:
+    HashIndex() = default;
+
+    void add(uint64_t hash, int group = 0) { groups[group].insert(hash); }
+
+    bool contains(uint64_t hash, int group = 0) const
+    {
+        auto groupIterator = groups.find(group);
+
+        if(groupIterator == groups.end())
+            return (false);
+
+        return (groupIterator->second.count(hash) > 0);
+    }
+
+    void clear() { groups.clear(); }
+
+private:
+    std::unordered_map<int, std::unordered_set<uint64_t>> groups;
+};
+} // namespace SHOT
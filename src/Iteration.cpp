@@ -11,6 +11,12 @@
 #include "Iteration.h"
 #include "Results.h"
 #include "Settings.h"
+#include "Utilities.h"
+
+#include "Model/Problem.h"
+
+#include <algorithm>
+#include <unordered_map>
 
 namespace SHOT
 {
@@ -18,8 +24,16 @@ namespace SHOT
 Iteration::Iteration(EnvironmentPtr envPtr)
 {
     env = envPtr;
+    reset();
+}
+
+void Iteration::reset()
+{
     this->iterationNumber = env->results->getNumberOfIterations() + 1;
 
+    this->isDualProblemDiscrete = false;
+    this->isSolved = false;
+
     this->numHyperplanesAdded = 0;
 
     if(env->results->getNumberOfIterations() == 0)
@@ -27,8 +41,7 @@ Iteration::Iteration(EnvironmentPtr envPtr)
     else if(env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"))
         this->totNumHyperplanes = 0;
     else
-        this->totNumHyperplanes
-            = env->results->iterations.at(env->results->getNumberOfIterations() - 1)->totNumHyperplanes;
+        this->totNumHyperplanes = env->results->getCurrentIteration()->totNumHyperplanes;
 
     this->maxDeviation = SHOT_DBL_MAX;
     this->boundaryDistance = SHOT_DBL_MAX;
@@ -39,6 +52,20 @@ Iteration::Iteration(EnvironmentPtr envPtr)
 
     currentObjectiveBounds.first = env->results->getCurrentDualBound();
     currentObjectiveBounds.second = env->results->getPrimalBound();
+
+    this->maxDeviationConstraint = -1;
+    this->relaxedLazyHyperplanesAdded = 0;
+    this->numberOfExploredNodes = 0;
+    this->numberOfOpenNodes = 0;
+
+    this->hasInfeasibilityRepairBeenPerformed = false;
+    this->wasInfeasibilityRepairSuccessful = false;
+    this->numberOfInfeasibilityRepairedConstraints = 0;
+    this->forceObjectiveReductionCut = false;
+
+    solutionPoints.clear();
+    constraintDeviations.clear();
+    hyperplanePoints.clear();
 }
 
 Iteration::~Iteration()
@@ -83,4 +110,78 @@ int Iteration::getSolutionPointWithSmallestDeviationIndex()
 
     return (tmpIdx);
 }
+
+std::vector<int> Iteration::getPrescreenedSolutionPointIndexes(int maxNumberOfPoints)
+{
+    auto& problem = env->reformulatedProblem;
+
+    VectorInteger discreteVariableIndexes;
+    discreteVariableIndexes.reserve(problem->properties.numberOfDiscreteVariables);
+
+    for(auto& V : problem->allVariables)
+    {
+        if(V->properties.type == E_VariableType::Binary || V->properties.type == E_VariableType::Integer
+            || V->properties.type == E_VariableType::Semiinteger)
+            discreteVariableIndexes.push_back(V->index);
+    }
+
+    // The solution points are from the MIP solver, so the linear constraints need not be checked if trusted
+    bool checkLinearConstraints = problem->properties.numberOfLinearConstraints > 0
+        && !env->settings->getSetting<bool>("Tolerance.TrustLinearConstraintValues", "Primal");
+
+    bool hasPrimalBound = env->results->hasPrimalSolution();
+    double primalBound = env->results->getPrimalBound();
+
+    // The score and index of the best point with each combination of discrete variable values
+    std::vector<std::pair<double, int>> scores;
+    std::unordered_map<uint64_t, size_t> scoreIndexes;
+
+    for(size_t i = 0; i < solutionPoints.size(); i++)
+    {
+        auto& P = solutionPoints[i];
+
+        double score = std::max(0.0, P.maxDeviation.value);
+
+        if(checkLinearConstraints)
+            score += problem->getMaxNumericConstraintValue(P.point, problem->linearConstraints).error;
+
+        if(hasPrimalBound)
+            score += std::abs(P.objectiveValue - primalBound) / (1e-10 + std::abs(primalBound));
+
+        if(discreteVariableIndexes.size() == 0)
+        {
+            scores.emplace_back(score, i);
+            continue;
+        }
+
+        auto hash = Utilities::calculateHash(P.point, discreteVariableIndexes, 1.0);
+
+        if(auto existing = scoreIndexes.find(hash); existing != scoreIndexes.end())
+        {
+            if(score < scores[existing->second].first)
+                scores[existing->second] = std::make_pair(score, (int)i);
+
+            continue;
+        }
+
+        scoreIndexes.emplace(hash, scores.size());
+        scores.emplace_back(score, i);
+    }
+
+    // The points keep their order in the pool if the scores are equal
+    std::stable_sort(scores.begin(), scores.end(),
+        [](const std::pair<double, int>& first, const std::pair<double, int>& second)
+        { return (first.first < second.first); });
+
+    if(maxNumberOfPoints > 0 && (int)scores.size() > maxNumberOfPoints)
+        scores.resize(maxNumberOfPoints);
+
+    std::vector<int> indexes;
+    indexes.reserve(scores.size());
+
+    for(auto& S : scores)
+        indexes.push_back(S.second);
+
+    return (indexes);
+}
 } // namespace SHOT
\ No newline at end of file
@@ -21,6 +21,10 @@ public:
     Iteration(EnvironmentPtr envPtr);
     ~Iteration();
 
+    // Initializes the iteration as the next one, the storage of the point data is kept when a retired iteration is
+    // reused by Results::createIteration()
+    void reset();
+
     E_DualProblemClass dualProblemClass;
     bool isDualProblemDiscrete = false;
 
@@ -66,6 +70,12 @@ public:
     SolutionPoint getSolutionPointWithSmallestDeviation();
     int getSolutionPointWithSmallestDeviationIndex();
 
+    // The indexes of at most maxNumberOfPoints solution points, ordered on a cheap estimate of how promising they are
+    // as primal candidates: the linear constraint error, the nonlinear constraint deviation found when the point was
+    // added and the relative distance of the objective value to the primal bound. Of the points with the same values of
+    // the discrete variables only the best one is included. With 0 all points are included.
+    std::vector<int> getPrescreenedSolutionPointIndexes(int maxNumberOfPoints);
+
 private:
     EnvironmentPtr env;
 };
@@ -0,0 +1,98 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../HashIndex.h"
+#include "../Structs.h"
+#include "../Utilities.h"
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace SHOT
+{
+
+// A pool of the linear cuts created in the callbacks of a MIP solver, shared by the threads of the solver. A cut is
+// stored once, identified by a fingerprint of its coefficients. Each thread has its own position in the pool, so that
+// it can get the cuts created by the other threads since it last looked.
+class CutPool
+{
+public:
+    struct Cut
+    {
+        std::map<int, double> terms; // The cut is sum(terms) + constant <= 0
+        double constant;
+        int threadId;
+    };
+
+    CutPool() = default;
+
+    // Returns false if the same cut is already in the pool
+    bool add(const std::map<int, double>& terms, double constant, int threadId)
+    {
+        VectorDouble coefficients;
+        coefficients.reserve(2 * terms.size() + 1);
+
+        for(auto& T : terms)
+        {
+            coefficients.push_back(T.first);
+            coefficients.push_back(T.second);
+        }
+
+        coefficients.push_back(constant);
+
+        auto hash = Utilities::calculateHash(coefficients);
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(hashes.contains(hash))
+            return (false);
+
+        hashes.add(hash);
+        cuts.push_back(Cut { terms, constant, threadId });
+
+        return (true);
+    }
+
+    // Returns the cuts added by the other threads since the last call from this thread
+    std::vector<Cut> getNewCuts(int threadId)
+    {
+        std::vector<Cut> newCuts;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto& position = positions[threadId];
+
+        for(; position < cuts.size(); position++)
+        {
+            if(cuts[position].threadId != threadId)
+                newCuts.push_back(cuts[position]);
+        }
+
+        return (newCuts);
+    }
+
+    size_t size()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (cuts.size());
+    }
+
+private:
+    std::mutex mutex;
+    std::deque<Cut> cuts;
+    HashIndex hashes;
+    std::unordered_map<int, size_t> positions;
+};
+} // namespace SHOT
@@ -24,6 +24,9 @@ public:
 
     virtual int getInitialLimit() = 0;
 
+    // The time limit for the next MIP problem, in addition to the total time limit
+    virtual double getTimeLimit() { return (SHOT_DBL_MAX); };
+
     EnvironmentPtr env;
 
 protected:
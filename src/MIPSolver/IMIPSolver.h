@@ -22,6 +22,45 @@
 namespace SHOT
 {
 
+// A block of linear constraints sum(coefficients) + constant <= 0 in CSR form, where the terms of constraint i are in
+// the positions rowStarts[i] to rowStarts[i + 1] - 1 of variableIndexes and coefficients
+struct LinearConstraintBlock
+{
+    VectorInteger rowStarts { 0 };
+    VectorInteger variableIndexes;
+    VectorDouble coefficients;
+    VectorDouble constants;
+    std::vector<std::string> names;
+    std::vector<bool> allowRepair;
+
+    inline size_t size() const { return (constants.size()); };
+
+    inline void add(
+        const std::map<int, double>& elements, double constant, std::string name, bool allowConstraintRepair)
+    {
+        for(auto& E : elements)
+        {
+            variableIndexes.push_back(E.first);
+            coefficients.push_back(E.second);
+        }
+
+        rowStarts.push_back(variableIndexes.size());
+        constants.push_back(constant);
+        names.push_back(name);
+        allowRepair.push_back(allowConstraintRepair);
+    };
+
+    inline void clear()
+    {
+        rowStarts.assign(1, 0);
+        variableIndexes.clear();
+        coefficients.clear();
+        constants.clear();
+        names.clear();
+        allowRepair.clear();
+    };
+};
+
 class IMIPSolver
 {
 public:
@@ -35,20 +74,49 @@ public:
     virtual bool initializeObjective() = 0;
     virtual bool addLinearTermToObjective(double coefficient, int variableIndex) = 0;
     virtual bool addQuadraticTermToObjective(double coefficient, int firstVariableIndex, int secondVariableIndex) = 0;
+
+    // Adds the terms coefficients[k] * x[firstVariableIndexes[k]] * x[secondVariableIndexes[k]] in one call, which is
+    // faster than adding large quadratic expressions term by term
+    virtual bool addQuadraticTermsToObjective(const VectorDouble& coefficients,
+        const VectorInteger& firstVariableIndexes, const VectorInteger& secondVariableIndexes)
+        = 0;
+
     virtual bool finalizeObjective(bool isMinimize, double constant = 0.0) = 0;
 
+    // Replaces the objective function in a finalized problem with a linear one, e.g. to solve a sequence of problems
+    // over the same feasible set where the previous solution can be used as a warm start
+    virtual bool replaceObjective(const std::map<int, double>& linearTerms, bool isMinimize) = 0;
+
     virtual bool initializeConstraint() = 0;
     virtual bool addLinearTermToConstraint(double coefficient, int variableIndex) = 0;
     virtual bool addQuadraticTermToConstraint(double coefficient, int firstVariableIndex, int secondVariableIndex) = 0;
+
+    // As addQuadraticTermsToObjective()
+    virtual bool addQuadraticTermsToConstraint(const VectorDouble& coefficients,
+        const VectorInteger& firstVariableIndexes, const VectorInteger& secondVariableIndexes)
+        = 0;
+
     virtual bool finalizeConstraint(std::string name, double valueLHS, double valueRHS, double constant = 0.0) = 0;
 
     virtual bool finalizeProblem() = 0;
 
+    // Stores the number of constraints in the finalized problem, so that the problem can later be returned to this
+    // state with restoreBaseProblem() instead of being recreated, e.g. with TreeStrategy.Multi.Reinitialize
+    virtual void saveBaseProblem() = 0;
+
+    // Removes the constraints added after saveBaseProblem() with one call, except for the integer cuts that are valid
+    // for the whole solution process. Returns false if no base problem has been saved or the constraints could not be
+    // removed, then the problem should be recreated.
+    virtual bool restoreBaseProblem() = 0;
+
     virtual void initializeSolverSettings() = 0;
 
     virtual VectorDouble getVariableSolution(int solIdx) = 0;
     virtual int getNumberOfSolutions() = 0;
 
+    // The reduced costs of the variables in the last solved continuous relaxation, empty if not available
+    virtual VectorDouble getReducedCosts() = 0;
+
     virtual E_DualProblemClass getProblemClass() = 0;
 
     virtual void activateDiscreteVariables(bool activate) = 0;
@@ -82,14 +150,39 @@ public:
         const std::map<int, double>& elements, double constant, std::string name, bool isGreaterThan, bool allowRepair)
         = 0;
 
+    // Adds all the constraints in the block in one model update. Returns the index of the first added constraint, or -1
+    // if the constraints could not be added.
+    virtual int addLinearConstraints(const LinearConstraintBlock& constraints) = 0;
+
+    // Removes the linear constraints with the given sorted indexes, the later constraints get shifted indexes
+    virtual bool removeLinearConstraints(const VectorInteger& constraintIndexes) = 0;
+
+    // The number of constraints in the model, counted in the same way as the indexes in removeLinearConstraints()
+    virtual int getNumberOfConstraints() = 0;
+
+    // Updates the activity of the hyperplane cuts in the given solution points, adds back removed cuts that are
+    // violated and removes the cuts that have been inactive for too long. Returns the number of added and removed cuts.
+    virtual std::pair<int, int> manageHyperplaneCuts(const std::vector<SolutionPoint>& solutionPoints) = 0;
+
     virtual bool addSpecialOrderedSet(E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights = {})
         = 0;
 
+    // Adds the constraint y = f(x) that is handled by the MIP solver, see Gurobi.FunctionConstraints.Use. Returns false
+    // if the function constraints are not supported.
+    virtual bool addFunctionConstraint(const UnivariateFunction& function, int resultVariableIndex, std::string name)
+        = 0;
+
     virtual void setTimeLimit(double seconds) = 0;
 
     virtual void setCutOff(double cutOff) = 0;
     virtual void setCutOffAsConstraint(double cutOff) = 0;
 
+    // The relative gap at which the MIP solver terminates, initially ObjectiveGap.Relative
+    virtual void setRelativeGap(double gap) = 0;
+
+    // The MIP solver terminates when its dual bound reaches this value, if supported by the solver
+    virtual void setDualBoundStop(double bound) = 0;
+
     virtual void addMIPStart(VectorDouble point) = 0;
     virtual void deleteMIPStarts() = 0;
 
@@ -106,11 +199,15 @@ public:
     virtual void presolveAndUpdateBounds() = 0;
     virtual std::pair<VectorDouble, VectorDouble> presolveAndGetNewBounds() = 0;
 
-    virtual bool createHyperplane(Hyperplane hyperplane) = 0;
-    virtual bool createInteriorHyperplane(Hyperplane hyperplane) = 0;
+    virtual bool createHyperplane(const Hyperplane& hyperplane) = 0;
+    // Adds the hyperplanes with one call to addLinearConstraints, and returns for each whether it was added
+    virtual std::vector<bool> createHyperplanes(const std::vector<Hyperplane>& hyperplanes) = 0;
+    virtual bool createInteriorHyperplane(const Hyperplane& hyperplane) = 0;
     virtual bool createIntegerCut(IntegerCut& integerCut) = 0;
 
-    virtual std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(Hyperplane hyperplane) = 0;
+    virtual std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(
+        const Hyperplane& hyperplane)
+        = 0;
 
     virtual bool supportsQuadraticObjective() = 0;
     virtual bool supportsQuadraticConstraints() = 0;
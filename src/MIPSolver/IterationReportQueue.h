@@ -0,0 +1,106 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+namespace SHOT
+{
+
+// The values shown on an iteration line from a callback of a MIP solver, copied when the line is created so that the
+// line can be formatted and printed later by another thread
+struct IterationReportRecord
+{
+    int iterationNumber;
+    int threadId; // -1 if the MIP solver does not give the thread
+    double timeStamp;
+    int numberOfAddedHyperplanes;
+    int totalNumberOfHyperplanes;
+    double currentDualBound;
+    double globalDualBound;
+    double primalBound;
+    double objectiveValue;
+    int maxDeviationIndex;
+    double maxDeviationValue;
+};
+
+// A bounded lock-free queue for the iteration records, where the records can be added by any number of threads and
+// are taken by one thread. The records are not added if the queue is full.
+class IterationReportQueue
+{
+public:
+    IterationReportQueue()
+    {
+        for(size_t i = 0; i < capacity; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Returns false if the queue is full
+    bool push(const IterationReportRecord& record)
+    {
+        auto position = pushPosition.load(std::memory_order_relaxed);
+
+        while(true)
+        {
+            auto& slot = slots[position % capacity];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+
+            if(sequence == position)
+            {
+                if(pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                {
+                    slot.record = record;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return (true);
+                }
+            }
+            else if(sequence < position)
+            {
+                return (false);
+            }
+            else
+            {
+                position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Returns false if there are no records, should only be called from one thread at a time
+    bool pop(IterationReportRecord& record)
+    {
+        auto& slot = slots[popPosition % capacity];
+
+        if(slot.sequence.load(std::memory_order_acquire) != popPosition + 1)
+            return (false);
+
+        record = slot.record;
+        slot.sequence.store(popPosition + capacity, std::memory_order_release);
+        popPosition++;
+
+        return (true);
+    }
+
+private:
+    static constexpr size_t capacity = 256;
+
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        IterationReportRecord record;
+    };
+
+    std::array<Slot, capacity> slots;
+    std::atomic<size_t> pushPosition { 0 };
+    size_t popPosition = 0;
+};
+} // namespace SHOT
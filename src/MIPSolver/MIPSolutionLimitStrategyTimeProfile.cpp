@@ -0,0 +1,190 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "MIPSolutionLimitStrategyTimeProfile.h"
+#include "../Settings.h"
+#include "../Results.h"
+#include "../DualSolver.h"
+#include "../MIPSolver/IMIPSolver.h"
+#include "../Iteration.h"
+#include "../Output.h"
+#include "../Timing.h"
+
+#include "../Model/Problem.h"
+#include "../Model/ObjectiveFunction.h"
+
+#include <cmath>
+
+namespace SHOT
+{
+
+// The solution limit used when the MIP problems are solved to optimality
+constexpr int optimalSolutionLimit = 2100000000;
+
+// The weight of the previous iterations is multiplied by this for every new iteration with the same solution limit
+constexpr double profileDecay = 0.7;
+
+// The time limit is not set below this
+constexpr double minimumTimeLimit = 1.0;
+
+MIPSolutionLimitStrategyTimeProfile::MIPSolutionLimitStrategyTimeProfile(EnvironmentPtr envPtr) { env = envPtr; }
+
+bool MIPSolutionLimitStrategyTimeProfile::updateLimit()
+{
+    auto currIter = env->results->getCurrentIteration();
+    auto prevIter = env->results->getPreviousIteration();
+
+    double currentTime = env->timing->getElapsedTime("Total");
+    double iterationTime = (lastUpdateTime < 0) ? prevIter->solutionTime : currentTime - lastUpdateTime;
+    lastUpdateTime = currentTime;
+
+    if(!currIter->isMIP() || !prevIter->isMIP())
+    {
+        timeLimit = SHOT_DBL_MAX;
+        return (false);
+    }
+
+    int usedLimit = std::min(prevIter->usedMIPSolutionLimit, optimalSolutionLimit);
+
+    double boundImprovement = getBoundImprovement(prevIter->currentObjectiveBounds, currIter->currentObjectiveBounds);
+    addIteration(usedLimit, boundImprovement, iterationTime, prevIter->solutionTime);
+
+    int currentLimit = std::min(env->dualSolver->MIPSolver->getSolutionLimit(), optimalSolutionLimit);
+
+    std::vector<int> candidateLimits { currentLimit };
+
+    if(currentLimit < optimalSolutionLimit)
+    {
+        candidateLimits.push_back(currentLimit + 1);
+        candidateLimits.push_back(optimalSolutionLimit);
+    }
+
+    // A smaller limit is only selected if it has been used, since otherwise it has the same rate as the current one
+    if(currentLimit > 1 && currentLimit < optimalSolutionLimit && profiles.count(currentLimit - 1) > 0)
+        candidateLimits.push_back(currentLimit - 1);
+
+    selectedLimit = currentLimit;
+    double selectedRate = getImprovementRate(currentLimit);
+
+    for(auto L : candidateLimits)
+    {
+        double rate = getImprovementRate(L);
+
+        if(rate > selectedRate)
+        {
+            selectedLimit = L;
+            selectedRate = rate;
+        }
+    }
+
+    // The larger limits not used yet are tried if the bounds were not improved in the last iteration
+    if(selectedLimit == currentLimit && boundImprovement == 0.0)
+    {
+        for(auto L : candidateLimits)
+        {
+            if(L > currentLimit && profiles.count(L) == 0)
+            {
+                selectedLimit = L;
+                break;
+            }
+        }
+    }
+
+    // The problem is solved without a time limit if it reached the previous one without any solutions, or if there
+    // are no solution times for the limit
+    double timeLimitFactor = env->settings->getSetting<double>("MIP.SolutionLimit.Profile.TimeLimitFactor", "Dual");
+    auto profile = profiles.find(selectedLimit);
+
+    if(timeLimitFactor == 0.0 || profile == profiles.end()
+        || (prevIter->solutionStatus == E_ProblemSolutionStatus::TimeLimit && prevIter->solutionPoints.empty()))
+    {
+        timeLimit = SHOT_DBL_MAX;
+    }
+    else
+    {
+        timeLimit = std::max(minimumTimeLimit,
+            timeLimitFactor * profile->second.MIPSolutionTime / std::max(1e-10, profile->second.weight));
+    }
+
+    env->output->outputDebug("        Solution limit {} selected with bound improvement rate {} and time limit {}",
+        selectedLimit, selectedRate, timeLimit);
+
+    return (selectedLimit != currentLimit);
+}
+
+int MIPSolutionLimitStrategyTimeProfile::getNewLimit() { return (selectedLimit); }
+
+int MIPSolutionLimitStrategyTimeProfile::getInitialLimit()
+{
+    selectedLimit = env->settings->getSetting<int>("MIP.SolutionLimit.Initial", "Dual");
+    return (selectedLimit);
+}
+
+double MIPSolutionLimitStrategyTimeProfile::getTimeLimit() { return (timeLimit); }
+
+void MIPSolutionLimitStrategyTimeProfile::addIteration(
+    int solutionLimit, double boundImprovement, double iterationTime, double MIPSolutionTime)
+{
+    auto& profile = profiles[solutionLimit];
+
+    profile.boundImprovement = profileDecay * profile.boundImprovement + boundImprovement;
+    profile.iterationTime = profileDecay * profile.iterationTime + std::max(iterationTime, 0.0);
+    profile.MIPSolutionTime = profileDecay * profile.MIPSolutionTime + std::max(MIPSolutionTime, 0.0);
+    profile.weight = profileDecay * profile.weight + 1.0;
+}
+
+double MIPSolutionLimitStrategyTimeProfile::getBoundImprovement(
+    const PairDouble& previousBounds, const PairDouble& currentBounds)
+{
+    bool isMinimization
+        = env->reformulatedProblem->objectiveFunction->direction == E_ObjectiveFunctionDirection::Minimize;
+
+    double sign = isMinimization ? 1.0 : -1.0;
+    double improvement = 0.0;
+
+    bool isPreviousDualBoundFinite = std::abs(previousBounds.first) < SHOT_DBL_MAX;
+    bool isPreviousPrimalBoundFinite = std::abs(previousBounds.second) < SHOT_DBL_MAX;
+    bool isCurrentDualBoundFinite = std::abs(currentBounds.first) < SHOT_DBL_MAX;
+    bool isCurrentPrimalBoundFinite = std::abs(currentBounds.second) < SHOT_DBL_MAX;
+
+    double scale = 1.0;
+
+    if(isCurrentPrimalBoundFinite)
+        scale = std::max(scale, std::abs(currentBounds.second));
+    else if(isCurrentDualBoundFinite)
+        scale = std::max(scale, std::abs(currentBounds.first));
+
+    // Finding the first primal or dual bound counts as closing the whole gap
+    if(isCurrentDualBoundFinite && !isPreviousDualBoundFinite)
+        improvement += 1.0;
+    else if(isCurrentDualBoundFinite)
+        improvement += std::max(0.0, sign * (currentBounds.first - previousBounds.first)) / scale;
+
+    if(isCurrentPrimalBoundFinite && !isPreviousPrimalBoundFinite)
+        improvement += 1.0;
+    else if(isCurrentPrimalBoundFinite)
+        improvement += std::max(0.0, sign * (previousBounds.second - currentBounds.second)) / scale;
+
+    return (improvement);
+}
+
+double MIPSolutionLimitStrategyTimeProfile::getImprovementRate(int solutionLimit)
+{
+    // The limits not used yet have the rate of the closest smaller limit that has been used
+    auto profile = profiles.upper_bound(solutionLimit);
+
+    if(profile == profiles.begin())
+        return (0.0);
+
+    profile--;
+
+    return (profile->second.boundImprovement / std::max(1e-10, profile->second.iterationTime));
+}
+} // namespace SHOT
@@ -0,0 +1,59 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "IMIPSolutionLimitStrategy.h"
+#include "Environment.h"
+
+#include <map>
+
+namespace SHOT
+{
+// Selects the solution limit with the largest measured improvement of the objective bounds per second of the
+// iterations using it, among the current limit, the next larger limit and solving to optimality. The limits not yet
+// used are given the rate of the closest smaller limit used, and are tried, the next larger limit first, when an
+// iteration does not improve the bounds. The MIP problems are also given a time limit based on the measured solution
+// times for the selected limit.
+class MIPSolutionLimitStrategyTimeProfile : public IMIPSolutionLimitStrategy
+{
+public:
+    MIPSolutionLimitStrategyTimeProfile(EnvironmentPtr envPtr);
+    ~MIPSolutionLimitStrategyTimeProfile() override = default;
+
+    bool updateLimit() override;
+    int getNewLimit() override;
+    int getInitialLimit() override;
+    double getTimeLimit() override;
+
+private:
+    // Exponentially weighted sums over the iterations with a solution limit, so that the recent ones count the most
+    struct LimitProfile
+    {
+        double boundImprovement = 0.0;
+        double iterationTime = 0.0;
+        double MIPSolutionTime = 0.0;
+        double weight = 0.0;
+    };
+
+    std::map<int, LimitProfile> profiles;
+
+    int selectedLimit = 1;
+    double timeLimit = SHOT_DBL_MAX;
+    double lastUpdateTime = -1.0;
+
+    void addIteration(int solutionLimit, double boundImprovement, double iterationTime, double MIPSolutionTime);
+
+    // The relative improvement of the primal and dual bounds from the first to the second bound pair
+    double getBoundImprovement(const PairDouble& previousBounds, const PairDouble& currentBounds);
+
+    double getImprovementRate(int solutionLimit);
+};
+} // namespace SHOT
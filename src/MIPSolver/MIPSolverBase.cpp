@@ -17,6 +17,8 @@
 #include "../Settings.h"
 #include "../Utilities.h"
 
+#include <algorithm>
+
 namespace SHOT
 {
 
@@ -112,15 +114,40 @@ std::vector<SolutionPoint> MIPSolverBase::getAllVariableSolutions()
     return (lastSolutions);
 }
 
-bool MIPSolverBase::createHyperplane(Hyperplane hyperplane)
+void MIPSolverBase::addPendingVariableBound(int varIndex, double lowerBound, double upperBound)
 {
-    auto currIter = env->results->getCurrentIteration(); // The unsolved new iteration
+    pendingVariableBounds[varIndex] = PairDouble(lowerBound, upperBound);
+    modelUpdated = true;
+}
+
+void MIPSolverBase::addPendingConstraintRHS(int constraintIndex, double rhs)
+{
+    pendingConstraintRHS[constraintIndex] = rhs;
+    modelUpdated = true;
+}
+
+std::optional<PairDouble> MIPSolverBase::getPendingVariableBounds(int varIndex)
+{
+    if(auto bounds = pendingVariableBounds.find(varIndex); bounds != pendingVariableBounds.end())
+        return (bounds->second);
+
+    return (std::nullopt);
+}
+
+void MIPSolverBase::clearPendingChanges()
+{
+    pendingVariableBounds.clear();
+    pendingConstraintRHS.clear();
+}
 
+std::optional<std::pair<std::map<int, double>, double>> MIPSolverBase::createCheckedHyperplaneTerms(
+    const Hyperplane& hyperplane, std::string& identifier)
+{
     auto optional = createHyperplaneTerms(hyperplane);
 
     if(!optional)
     {
-        return (false);
+        return (std::nullopt);
     }
 
     auto tmpPair = optional.value();
@@ -140,10 +167,13 @@ bool MIPSolverBase::createHyperplane(Hyperplane hyperplane)
                     + env->reformulatedProblem->getVariable(E.first)->name + " = "
                     + std::to_string(hyperplane.generatedPoint.at(E.first)));
 
-            return (false);
+            return (std::nullopt);
         }
     }
 
+    if(env->settings->getSetting<bool>("HyperplaneCuts.Cleanup.Use", "Dual") && !cleanHyperplaneTerms(tmpPair))
+        return (std::nullopt);
+
     // Small fix to fix badly scaled cuts.
     // TODO: this should be made so it also takes into account small/large coefficients of the linear terms
     if(abs(tmpPair.second) > 1e15)
@@ -164,44 +194,442 @@ bool MIPSolverBase::createHyperplane(Hyperplane hyperplane)
         }
     }
 
-    std::string constraintName;
+    if(useNames)
+    {
+        identifier = getConstraintIdentifier(hyperplane.source);
 
-    std::string identifier = getConstraintIdentifier(hyperplane.source);
+        if(hyperplane.sourceConstraint != nullptr)
+            identifier = identifier + "_" + hyperplane.sourceConstraint->name;
 
-    if(hyperplane.sourceConstraint != nullptr)
-        identifier = identifier + "_" + hyperplane.sourceConstraint->name;
+        identifier += "_" + std::to_string(constraintCounter);
+    }
 
-    identifier += "_" + std::to_string(constraintCounter);
     constraintCounter++;
 
-    if(addLinearConstraint(tmpPair.first, tmpPair.second, identifier, false, !hyperplane.isSourceConvex) < 0)
+    return (tmpPair);
+}
+
+bool MIPSolverBase::cleanHyperplaneTerms(std::pair<std::map<int, double>, double>& terms)
+{
+    auto& elements = terms.first;
+
+    if(elements.size() == 0)
+        return (true);
+
+    double coefficientTolerance
+        = env->settings->getSetting<double>("HyperplaneCuts.Cleanup.CoefficientTolerance", "Dual");
+    double maxRelaxation = env->settings->getSetting<double>("HyperplaneCuts.Cleanup.MaxRelaxation", "Dual");
+    double maxDynamism = env->settings->getSetting<double>("HyperplaneCuts.Cleanup.MaxDynamism", "Dual");
+
+    double maxCoefficient = 0.0;
+
+    for(auto& E : elements)
+        maxCoefficient = std::max(maxCoefficient, std::abs(E.second));
+
+    if(maxCoefficient == 0.0)
+        return (true);
+
+    // The cut is sum(a_j * x_j) + constant <= 0, and a term a_j * x_j can be replaced by its smallest value on the
+    // domain of x_j. The terms weakening the cut the least on the domain are removed first.
+    std::vector<std::pair<double, int>> removableTerms;
+
+    for(auto& E : elements)
+    {
+        if(E.first >= env->reformulatedProblem->properties.numberOfVariables
+            || std::abs(E.second) > coefficientTolerance * maxCoefficient)
+            continue;
+
+        auto variable = env->reformulatedProblem->getVariable(E.first);
+        double weakening = std::abs(E.second) * (variable->upperBound - variable->lowerBound);
+
+        if(variable->lowerBound > SHOT_DBL_MIN && variable->upperBound < SHOT_DBL_MAX && weakening <= maxRelaxation)
+            removableTerms.emplace_back(weakening, E.first);
+    }
+
+    std::sort(removableTerms.begin(), removableTerms.end());
+
+    double totalRelaxation = 0.0;
+    int numberOfRemovedTerms = 0;
+
+    for(auto& T : removableTerms)
+    {
+        if(totalRelaxation + T.first > maxRelaxation)
+            break;
+
+        auto element = elements.find(T.second);
+        auto variable = env->reformulatedProblem->getVariable(T.second);
+
+        terms.second += element->second * (element->second > 0 ? variable->lowerBound : variable->upperBound);
+        totalRelaxation += T.first;
+
+        elements.erase(element);
+        numberOfRemovedTerms++;
+    }
+
+    if(numberOfRemovedTerms > 0)
+        env->output->outputTrace(
+            fmt::format("        Removed {} negligible coefficients from cut", numberOfRemovedTerms));
+
+    double minCoefficient = maxCoefficient;
+
+    for(auto& E : elements)
+        minCoefficient = std::min(minCoefficient, std::abs(E.second));
+
+    if(maxCoefficient / minCoefficient > maxDynamism)
+    {
+        env->output->outputDebug(fmt::format(
+            "        Cut not added, the ratio of its coefficients is {}", maxCoefficient / minCoefficient));
+        return (false);
+    }
+
+    // Scaled with a power of two so that the largest coefficient is in [0.5, 1), which does not introduce rounding
+    // errors
+    int exponent;
+    std::frexp(maxCoefficient, &exponent);
+
+    if(exponent != 0)
+    {
+        for(auto& E : elements)
+            E.second = std::ldexp(E.second, -exponent);
+
+        terms.second = std::ldexp(terms.second, -exponent);
+    }
+
+    return (true);
+}
+
+bool MIPSolverBase::createHyperplane(const Hyperplane& hyperplane)
+{
+    std::string identifier;
+    auto terms = createCheckedHyperplaneTerms(hyperplane, identifier);
+
+    if(!terms)
+        return (false);
+
+    int constraintIndex
+        = addLinearConstraint(terms->first, terms->second, identifier, false, !hyperplane.isSourceConvex);
+
+    if(constraintIndex < 0)
+        return (false);
+
+    if(isHyperplaneCutAgingUsed())
+        addToHyperplaneCutPool(terms.value(), identifier, hyperplane, constraintIndex);
+
+    return (true);
+}
+
+std::vector<bool> MIPSolverBase::createHyperplanes(const std::vector<Hyperplane>& hyperplanes)
+{
+    std::vector<bool> isCreated(hyperplanes.size(), false);
+
+    LinearConstraintBlock constraints;
+    VectorInteger hyperplaneIndexes;
+    std::vector<std::pair<std::map<int, double>, double>> hyperplaneTerms;
+
+    for(size_t i = 0; i < hyperplanes.size(); i++)
+    {
+        std::string identifier;
+        auto terms = createCheckedHyperplaneTerms(hyperplanes[i], identifier);
+
+        if(!terms)
+            continue;
+
+        constraints.add(terms->first, terms->second, identifier, !hyperplanes[i].isSourceConvex);
+        hyperplaneIndexes.push_back(i);
+        hyperplaneTerms.push_back(terms.value());
+    }
+
+    if(constraints.size() == 0)
+        return (isCreated);
+
+    int firstConstraintIndex = addLinearConstraints(constraints);
+
+    if(firstConstraintIndex < 0)
+        return (isCreated);
+
+    bool useCutAging = isHyperplaneCutAgingUsed();
+
+    for(size_t i = 0; i < hyperplaneIndexes.size(); i++)
+    {
+        isCreated[hyperplaneIndexes[i]] = true;
+
+        if(useCutAging)
+        {
+            addToHyperplaneCutPool(hyperplaneTerms[i], constraints.names[i], hyperplanes[hyperplaneIndexes[i]],
+                firstConstraintIndex + (int)i);
+        }
+    }
+
+    return (isCreated);
+}
+
+bool MIPSolverBase::isHyperplaneCutAgingUsed()
+{
+    // The cuts are lazy in the single-tree strategy and the model is recreated if reinitialized
+    return (env->settings->getSetting<bool>("HyperplaneCuts.Aging.Use", "Dual") && !env->dualSolver->isSingleTree
+        && !env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"));
+}
+
+void MIPSolverBase::addToHyperplaneCutPool(const std::pair<std::map<int, double>, double>& terms, std::string name,
+    const Hyperplane& hyperplane, int constraintIndex)
+{
+    // The objective cuts contain the auxiliary objective variable that is not in the solution points, and are never
+    // removed
+    if(hyperplane.isObjectiveHyperplane)
+        return;
+
+    PooledHyperplaneCut cut;
+
+    cut.linearTerms = terms.first;
+    cut.constant = terms.second;
+    cut.name = name;
+    cut.allowRepair = !hyperplane.isSourceConvex;
+    cut.pointHash = hyperplane.pointHash;
+    cut.sourceConstraintIndex = hyperplane.sourceConstraint ? hyperplane.sourceConstraint->index : -1;
+    cut.constraintIndex = constraintIndex;
+    cut.iterationLastActive = env->results->getCurrentIteration()->iterationNumber;
+
+    hyperplaneCutPool.push_back(cut);
+}
+
+bool MIPSolverBase::isConstraintIndexingConsistent()
+{
+    int numberOfConstraints = getNumberOfConstraints();
+
+    if(numberOfConstraints == (int)allowRepairOfConstraint.size())
+        return (true);
+
+    env->output->outputDebug(fmt::format("        The MIP solver has {} constraints but {} are tracked",
+        numberOfConstraints, allowRepairOfConstraint.size()));
+
+    return (false);
+}
+
+void MIPSolverBase::saveBaseProblem()
+{
+    // The base problem is recreated instead if the constraints added later cannot be identified
+    numberOfBaseConstraints = isConstraintIndexingConsistent() ? getNumberOfConstraints() : -1;
+}
+
+bool MIPSolverBase::restoreBaseProblem()
+{
+    if(numberOfBaseConstraints < 0 || !isConstraintIndexingConsistent())
+        return (false);
+
+    VectorInteger removedIndexes;
+
+    for(int i = numberOfBaseConstraints; i < (int)allowRepairOfConstraint.size(); i++)
+    {
+        if(std::find(integerCuts.begin(), integerCuts.end(), i) == integerCuts.end())
+            removedIndexes.push_back(i);
+    }
+
+    bool isCutOffConstraintRemoved = cutOffConstraintDefined
+        && std::binary_search(removedIndexes.begin(), removedIndexes.end(), cutOffConstraintIndex);
+
+    if(!removeLinearConstraints(removedIndexes))
         return (false);
 
+    // The cutoff constraint is added again when the cutoff is next updated
+    if(isCutOffConstraintRemoved)
+        cutOffConstraintDefined = false;
+
+    env->output->outputDebug(fmt::format("        Removed {} constraints to restore the base problem",
+        removedIndexes.size()));
+
     return (true);
 }
 
-std::optional<std::pair<std::map<int, double>, double>> MIPSolverBase::createHyperplaneTerms(Hyperplane hyperplane)
+void MIPSolverBase::updateConstraintIndexesAfterRemoval(const VectorInteger& removedIndexes)
+{
+    if(removedIndexes.size() == 0)
+        return;
+
+    // The number of removed constraints before the given index
+    auto getShiftedIndex = [&](int index) {
+        return (index - (int)(std::lower_bound(removedIndexes.begin(), removedIndexes.end(), index)
+                    - removedIndexes.begin()));
+    };
+
+    if(cutOffConstraintDefined)
+        cutOffConstraintIndex = getShiftedIndex(cutOffConstraintIndex);
+
+    for(auto& I : integerCuts)
+        I = getShiftedIndex(I);
+
+    for(auto& C : hyperplaneCutPool)
+    {
+        if(C.constraintIndex >= 0)
+            C.constraintIndex = getShiftedIndex(C.constraintIndex);
+    }
+
+    for(auto I = removedIndexes.rbegin(); I != removedIndexes.rend(); I++)
+    {
+        if(*I < (int)allowRepairOfConstraint.size())
+            allowRepairOfConstraint.erase(allowRepairOfConstraint.begin() + *I);
+    }
+}
+
+std::pair<int, int> MIPSolverBase::manageHyperplaneCuts(const std::vector<SolutionPoint>& solutionPoints)
+{
+    if(hyperplaneCutPool.size() == 0 || solutionPoints.size() == 0)
+        return (std::make_pair(0, 0));
+
+    int currentIteration = env->results->getCurrentIteration()->iterationNumber;
+    double activityTolerance = env->settings->getSetting<double>("HyperplaneCuts.Aging.ActivityTolerance", "Dual");
+    int maxInactiveIterations = env->settings->getSetting<int>("HyperplaneCuts.Aging.MaxInactiveIterations", "Dual");
+    int minRemovedCuts = env->settings->getSetting<int>("HyperplaneCuts.Aging.MinRemovedCuts", "Dual");
+
+    LinearConstraintBlock violatedCuts;
+    VectorInteger violatedCutIndexes;
+    VectorInteger inactiveCutIndexes;
+
+    for(size_t i = 0; i < hyperplaneCutPool.size(); i++)
+    {
+        auto& cut = hyperplaneCutPool[i];
+        double maxValue = SHOT_DBL_MIN;
+
+        for(auto& P : solutionPoints)
+        {
+            double value = cut.constant;
+
+            for(auto& T : cut.linearTerms)
+                value += T.second * P.point[T.first];
+
+            maxValue = std::max(maxValue, value);
+        }
+
+        // A cut is active if it is tight or violated in one of the points
+        if(maxValue >= -activityTolerance)
+            cut.iterationLastActive = currentIteration;
+
+        if(cut.constraintIndex < 0)
+        {
+            if(maxValue > activityTolerance)
+            {
+                violatedCuts.add(cut.linearTerms, cut.constant, cut.name, cut.allowRepair);
+                violatedCutIndexes.push_back(i);
+            }
+        }
+        else if(currentIteration - cut.iterationLastActive > maxInactiveIterations)
+        {
+            inactiveCutIndexes.push_back(i);
+        }
+    }
+
+    // The cuts are only removed in large batches, since each removal is a costly change to the model
+    if((int)inactiveCutIndexes.size() < minRemovedCuts)
+        inactiveCutIndexes.clear();
+
+    VectorInteger removedConstraintIndexes;
+
+    for(auto I : inactiveCutIndexes)
+        removedConstraintIndexes.push_back(hyperplaneCutPool[I].constraintIndex);
+
+    std::sort(removedConstraintIndexes.begin(), removedConstraintIndexes.end());
+
+    // The wrong constraints would be removed if the indexes do not match the repair flags
+    if(removedConstraintIndexes.size() > 0 && !isConstraintIndexingConsistent())
+    {
+        env->output->outputWarning("        The constraint indexes are inconsistent, cut aging is disabled.");
+        hyperplaneCutPool.clear();
+        return (std::make_pair(0, 0));
+    }
+
+    if(removedConstraintIndexes.size() > 0)
+    {
+        for(auto I : inactiveCutIndexes)
+            hyperplaneCutPool[I].constraintIndex = -1;
+
+        if(!removeLinearConstraints(removedConstraintIndexes))
+        {
+            // The indexes are unknown if the removal fails, so the cuts are not managed anymore
+            env->output->outputWarning("        Could not remove inactive hyperplane cuts, cut aging is disabled.");
+            hyperplaneCutPool.clear();
+            return (std::make_pair(0, 0));
+        }
+    }
+
+    int numberOfAddedCuts = 0;
+
+    if(violatedCuts.size() > 0)
+    {
+        if(int firstConstraintIndex = addLinearConstraints(violatedCuts); firstConstraintIndex >= 0)
+        {
+            for(size_t i = 0; i < violatedCutIndexes.size(); i++)
+                hyperplaneCutPool[violatedCutIndexes[i]].constraintIndex = firstConstraintIndex + (int)i;
+
+            numberOfAddedCuts = violatedCutIndexes.size();
+        }
+    }
+
+    // Marks the removed cuts in the list of generated hyperplanes
+    if(removedConstraintIndexes.size() > 0 || numberOfAddedCuts > 0)
+    {
+        std::map<std::pair<uint64_t, int>, bool> isRemoved;
+
+        for(auto I : inactiveCutIndexes)
+            isRemoved[std::make_pair(hyperplaneCutPool[I].pointHash, hyperplaneCutPool[I].sourceConstraintIndex)]
+                = true;
+
+        for(int i = 0; i < numberOfAddedCuts; i++)
+        {
+            auto& cut = hyperplaneCutPool[violatedCutIndexes[i]];
+            isRemoved[std::make_pair(cut.pointHash, cut.sourceConstraintIndex)] = false;
+        }
+
+        for(auto& H : env->dualSolver->generatedHyperplanes)
+        {
+            if(auto status = isRemoved.find(std::make_pair(H.pointHash, H.sourceConstraintIndex));
+                status != isRemoved.end())
+                H.isRemoved = status->second;
+        }
+    }
+
+    return (std::make_pair(numberOfAddedCuts, (int)removedConstraintIndexes.size()));
+}
+
+std::optional<std::pair<std::map<int, double>, double>> MIPSolverBase::createHyperplaneTerms(
+    const Hyperplane& hyperplane)
 {
     std::map<int, double> elements;
     double constant = 0.0;
-    SparseVariableVector gradient;
+    SparseGradient gradient;
     double signFactor = 1.0; // Will be -1.0 for greater than constraints
 
     if(hyperplane.isObjectiveHyperplane)
     {
         constant = hyperplane.objectiveFunctionValue;
 
-        if(env->reformulatedProblem->objectiveFunction->properties.hasNonlinearExpression)
+        if(hyperplane.sourceGradient)
         {
-            gradient
-                = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
-                      ->calculateGradient(hyperplane.generatedPoint, true);
+            gradient = *hyperplane.sourceGradient;
         }
         else
         {
-            gradient
-                = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
-                      ->calculateGradient(hyperplane.generatedPoint, true);
+            SparseVariableVector objectiveGradient;
+
+            if(env->reformulatedProblem->objectiveFunction->properties.hasNonlinearExpression)
+            {
+                objectiveGradient
+                    = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
+                          ->calculateGradient(hyperplane.generatedPoint, true);
+            }
+            else
+            {
+                objectiveGradient
+                    = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
+                          ->calculateGradient(hyperplane.generatedPoint, true);
+            }
+
+            gradient.indexes.reserve(objectiveGradient.size());
+            gradient.values.reserve(objectiveGradient.size());
+
+            for(auto const& G : objectiveGradient)
+            {
+                gradient.indexes.push_back(G.first->index);
+                gradient.values.push_back(G.second);
+            }
         }
 
         elements.emplace(dualAuxiliaryObjectiveVariableIndex, -1.0);
@@ -212,7 +640,13 @@ std::optional<std::pair<std::map<int, double>, double>> MIPSolverBase::createHyp
     else
     {
         assert(hyperplane.sourceConstraint);
-        auto maxDev = hyperplane.sourceConstraint->calculateNumericValue(hyperplane.generatedPoint);
+
+        // The point has usually been evaluated when the hyperplane was selected
+        auto evaluations
+            = env->reformulatedProblem->getConstraintEvaluations(hyperplane.generatedPoint, hyperplane.pointHash);
+
+        auto maxDev = env->reformulatedProblem->calculateNumericValue(
+            hyperplane.sourceConstraint.get(), hyperplane.generatedPoint, evaluations);
 
         if(maxDev.isFulfilledRHS && !maxDev.isFulfilledLHS)
         {
@@ -224,50 +658,47 @@ std::optional<std::pair<std::map<int, double>, double>> MIPSolverBase::createHyp
             constant = maxDev.normalizedRHSValue;
         }
 
-        gradient = std::dynamic_pointer_cast<NonlinearConstraint>(hyperplane.sourceConstraint)
-                       ->calculateGradient(hyperplane.generatedPoint, true);
+        if(hyperplane.sourceGradient)
+            gradient = *hyperplane.sourceGradient;
+        else
+            env->reformulatedProblem->calculateSparseGradient(
+                hyperplane.sourceConstraint.get(), hyperplane.generatedPoint, gradient, evaluations);
 
-        auto nonzeroes
-            = std::count_if(gradient.begin(), gradient.end(), [](auto element) { return (element.second != 0.0); });
+        auto nonzeroes = std::count_if(
+            gradient.values.begin(), gradient.values.end(), [](double value) { return (value != 0.0); });
 
         if(nonzeroes == 0)
         {
-            gradient = std::dynamic_pointer_cast<NonlinearConstraint>(hyperplane.sourceConstraint)
-                           ->calculateGradient(hyperplane.generatedPoint, false);
-
             double eps = 0.000001;
 
-            for(auto& G : gradient)
-            {
-                if(G.second == 0.0)
-                    G.second = eps;
-            }
+            for(auto& G : gradient.values)
+                G = eps;
 
             env->output->outputDebug("        All gradients nonzero, adding tolerance.");
         }
 
         env->output->outputTrace("        HP point generated for constraint index "
-            + std::to_string(hyperplane.sourceConstraintIndex) + " with " + std::to_string(gradient.size())
+            + std::to_string(hyperplane.sourceConstraintIndex) + " with " + std::to_string(nonzeroes)
             + " elements.");
     }
 
-    for(auto const& G : gradient)
+    for(size_t k = 0; k < gradient.size(); k++)
     {
-        double coefficient = signFactor * G.second;
-        int variableIndex = G.first->index;
+        if(gradient.values[k] == 0.0)
+            continue;
 
-        auto element = elements.emplace(variableIndex, coefficient);
+        double coefficient = signFactor * gradient.values[k];
+        int variableIndex = gradient.indexes[k];
 
-        if(!element.second)
-        {
-            // Element already exists for the variable
-            element.first->second += coefficient;
-        }
+        // The indexes are sorted for constraints, so the elements are inserted at the end of the map
+        auto element = elements.emplace_hint(elements.end(), variableIndex, 0.0);
+        element->second += coefficient;
 
-        constant += signFactor * (-G.second) * hyperplane.generatedPoint.at(variableIndex);
+        constant += signFactor * (-gradient.values[k]) * hyperplane.generatedPoint.at(variableIndex);
 
-        env->output->outputTrace("         Gradient for variable " + G.first->name + " in point "
-            + std::to_string(hyperplane.generatedPoint.at(variableIndex)) + ": " + std::to_string(coefficient));
+        env->output->outputTrace("         Gradient for variable with index " + std::to_string(variableIndex)
+            + " in point " + std::to_string(hyperplane.generatedPoint.at(variableIndex)) + ": "
+            + std::to_string(coefficient));
     }
 
     std::optional<std::pair<std::map<int, double>, double>> optional;
@@ -280,7 +711,7 @@ std::optional<std::pair<std::map<int, double>, double>> MIPSolverBase::createHyp
     return (optional);
 }
 
-bool MIPSolverBase::createInteriorHyperplane([[maybe_unused]] Hyperplane hyperplane)
+bool MIPSolverBase::createInteriorHyperplane([[maybe_unused]] const Hyperplane& hyperplane)
 {
     /*
     auto currIter = env->results->getCurrentIteration(); // The unsolved new iteration
@@ -370,7 +801,7 @@ void MIPSolverBase::presolveAndUpdateBounds()
 
         if(newLB)
         {
-            env->reformulatedProblem->getVariable(i)->lowerBound = newBounds.first.at(i);
+            env->reformulatedProblem->setVariableLowerBound(i, newBounds.first.at(i));
             env->output->outputDebug("        Lower bound for variable (" + std::to_string(i) + ") updated from "
                 + Utilities::toString(currBounds.first) + " to " + Utilities::toString(newBounds.first.at(i)));
 
@@ -383,7 +814,7 @@ void MIPSolverBase::presolveAndUpdateBounds()
 
         if(newUB)
         {
-            env->reformulatedProblem->getVariable(i)->upperBound = newBounds.second.at(i);
+            env->reformulatedProblem->setVariableUpperBound(i, newBounds.second.at(i));
             env->output->outputDebug("        Upper bound for variable (" + std::to_string(i) + ") updated from "
                 + Utilities::toString(currBounds.second) + " to " + Utilities::toString(newBounds.second.at(i)));
 
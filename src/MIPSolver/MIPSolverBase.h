@@ -26,6 +26,21 @@
 
 namespace SHOT
 {
+
+// A hyperplane cut that is kept when it is removed from the dual problem, so that it can be added back if it becomes
+// violated again
+struct PooledHyperplaneCut
+{
+    std::map<int, double> linearTerms;
+    double constant;
+    std::string name;
+    bool allowRepair;
+    uint64_t pointHash;
+    int sourceConstraintIndex;
+    int constraintIndex = -1; // -1 if not in the dual problem
+    int iterationLastActive = -1;
+};
+
 class MIPSolverBase
 {
 private:
@@ -38,6 +53,24 @@ private:
 
     bool warningMessageShownLargeRHS = false;
 
+    // The terms of a hyperplane that has been checked for NaN and inf and rescaled if needed, and its name
+    std::optional<std::pair<std::map<int, double>, double>> createCheckedHyperplaneTerms(
+        const Hyperplane& hyperplane, std::string& identifier);
+
+    // Removes the negligible coefficients by relaxing the constant with the variable bounds, so that the cut remains
+    // valid, and scales the cut. Returns false if the cut is too badly scaled to be added, see HyperplaneCuts.Cleanup.
+    bool cleanHyperplaneTerms(std::pair<std::map<int, double>, double>& terms);
+
+    // The number of constraints in the base problem, -1 if not saved
+    int numberOfBaseConstraints = -1;
+
+    // Whether there is one repair flag per constraint, so that the constraint indexes can be used to remove constraints
+    bool isConstraintIndexingConsistent();
+
+    bool isHyperplaneCutAgingUsed();
+    void addToHyperplaneCutPool(const std::pair<std::map<int, double>, double>& terms, std::string name,
+        const Hyperplane& hyperplane, int constraintIndex);
+
 protected:
     int numberOfVariables = 0;
     int numberOfConstraints = 0;
@@ -48,6 +81,9 @@ protected:
     VectorDouble variableUpperBounds;
     VectorString variableNames;
 
+    // Whether the names of the variables, constraints and cuts are given to the MIP solver, see MIP.UseNames
+    bool useNames = true;
+
     bool cutOffConstraintDefined = false;
     int cutOffConstraintIndex;
 
@@ -57,14 +93,18 @@ protected:
 public:
     ~MIPSolverBase();
 
-    virtual bool createHyperplane(Hyperplane hyperplane);
+    virtual bool createHyperplane(const Hyperplane& hyperplane);
+    virtual std::vector<bool> createHyperplanes(const std::vector<Hyperplane>& hyperplanes);
 
-    virtual bool createInteriorHyperplane(Hyperplane hyperplane);
+    virtual bool createInteriorHyperplane(const Hyperplane& hyperplane);
 
-    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(Hyperplane hyperplane);
+    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(const Hyperplane& hyperplane);
 
     virtual void setCutOffAsConstraint(double cutOff) = 0;
 
+    virtual void saveBaseProblem();
+    virtual bool restoreBaseProblem();
+
     virtual E_DualProblemClass getProblemClass();
     virtual bool getDiscreteVariableStatus();
 
@@ -93,6 +133,16 @@ public:
     virtual int addLinearConstraint(
         const std::map<int, double>& elements, double constant, std::string name, bool isGreaterThan, bool allowRepair)
         = 0;
+    virtual int addLinearConstraints(const LinearConstraintBlock& constraints) = 0;
+
+    virtual bool removeLinearConstraints(const VectorInteger& constraintIndexes) = 0;
+
+    virtual int getNumberOfConstraints() = 0;
+
+    // Shifts the stored constraint indexes after the constraints with the given sorted indexes have been removed
+    void updateConstraintIndexesAfterRemoval(const VectorInteger& removedIndexes);
+
+    virtual std::pair<int, int> manageHyperplaneCuts(const std::vector<SolutionPoint>& solutionPoints);
 
     virtual bool addSpecialOrderedSet(E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights = {})
         = 0;
@@ -162,6 +212,9 @@ public:
         case E_HyperplaneSource::ObjectiveCuttingPlane:
             identifier = "H_CP_OBJ";
             break;
+        case E_HyperplaneSource::InitialTangent:
+            identifier = "H_IT";
+            break;
         default:
             break;
         }
@@ -172,12 +225,25 @@ public:
     std::vector<int> integerCuts; // Contains the constraint indexes that are integerCuts
     std::vector<bool> allowRepairOfConstraint; // Whether to allow the added cuts to be relaxed
 
+    std::vector<PooledHyperplaneCut> hyperplaneCutPool; // Only used if HyperplaneCuts.Aging.Use is true
+
     int prevSolutionLimit = 1;
 
     bool discreteVariablesActivated;
     bool cachedSolutionHasChanged;
     bool modelUpdated = true;
 
+    // Changes to the variable bounds and constraint right-hand sides not yet passed on to the MIP solver
+    // Repeated changes of the same bound are collapsed, so only the last value is set when the changes are flushed
+    // right before solving.
+    std::map<int, PairDouble> pendingVariableBounds;
+    std::map<int, double> pendingConstraintRHS;
+
+    void addPendingVariableBound(int varIndex, double lowerBound, double upperBound);
+    void addPendingConstraintRHS(int constraintIndex, double rhs);
+    std::optional<PairDouble> getPendingVariableBounds(int varIndex);
+    void clearPendingChanges();
+
     bool isVariablesFixed = false;
     bool alreadyInitialized = false;
 
@@ -9,20 +9,307 @@
 */
 
 #include "MIPSolverCallbackBase.h"
+#include "IMIPSolver.h"
+
+#include "../CancellationToken.h"
+#include "../DualSolver.h"
 #include "../EventHandler.h"
 #include "../Iteration.h"
+#include "../PrimalSolver.h"
 #include "../Report.h"
 #include "../Results.h"
 #include "../Settings.h"
 #include "../TaskHandler.h"
 #include "../Timing.h"
+#include "../TraceRecorder.h"
+
+#include "../Model/ObjectiveFunction.h"
+#include "../Model/Problem.h"
 
 namespace SHOT
 {
 
+MIPSolverCallbackBase::~MIPSolverCallbackBase()
+{
+    stopBackgroundPrimalWorker();
+    stopIterationReporter();
+}
+
+void MIPSolverCallbackBase::initializeCallbackTasks()
+{
+    if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        if(static_cast<ES_HyperplaneCutStrategy>(env->settings->getSetting<int>("CutStrategy", "Dual"))
+            == ES_HyperplaneCutStrategy::ESH)
+        {
+            tUpdateInteriorPoint = std::make_shared<TaskUpdateInteriorPoint>(env);
+            taskSelectHPPts = std::make_shared<TaskSelectHyperplanePointsESH>(env);
+        }
+        else
+        {
+            taskSelectHPPts = std::make_shared<TaskSelectHyperplanePointsECP>(env);
+        }
+    }
+
+    if(env->reformulatedProblem->objectiveFunction->properties.classification
+        > E_ObjectiveFunctionClassification::Quadratic)
+    {
+        taskSelectHPPtsByObjectiveRootsearch = std::make_shared<TaskSelectHyperplanePointsObjectiveFunction>(env);
+    }
+
+    auto NLPProblemSource = static_cast<ES_PrimalNLPProblemSource>(
+        env->settings->getSetting<int>("FixedInteger.SourceProblem", "Primal"));
+
+    if(NLPProblemSource == ES_PrimalNLPProblemSource::Both
+        || NLPProblemSource == ES_PrimalNLPProblemSource::OriginalProblem)
+    {
+        taskSelectPrimNLPOriginal = std::make_shared<TaskSelectPrimalCandidatesFromNLP>(env, false);
+    }
+
+    if(NLPProblemSource == ES_PrimalNLPProblemSource::Both
+        || NLPProblemSource == ES_PrimalNLPProblemSource::ReformulatedProblem)
+    {
+        taskSelectPrimNLPReformulated = std::make_shared<TaskSelectPrimalCandidatesFromNLP>(env, true);
+    }
+
+    if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        taskSelectPrimalSolutionFromRootsearch = std::make_shared<TaskSelectPrimalCandidatesFromRootsearch>(env);
+    }
+}
+
+void MIPSolverCallbackBase::selectHyperplanePoints(const std::vector<SolutionPoint>& solutionPoints)
+{
+    if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        if(static_cast<ES_HyperplaneCutStrategy>(env->settings->getSetting<int>("CutStrategy", "Dual"))
+            == ES_HyperplaneCutStrategy::ESH)
+        {
+            tUpdateInteriorPoint->run();
+            static_cast<TaskSelectHyperplanePointsESH*>(taskSelectHPPts.get())->run(solutionPoints);
+        }
+        else
+        {
+            static_cast<TaskSelectHyperplanePointsECP*>(taskSelectHPPts.get())->run(solutionPoints);
+        }
+    }
+
+    if(env->reformulatedProblem->objectiveFunction->properties.classification
+        > E_ObjectiveFunctionClassification::Quadratic)
+    {
+        taskSelectHPPtsByObjectiveRootsearch->run(solutionPoints);
+    }
+}
+
+std::optional<std::pair<std::map<int, double>, double>> MIPSolverCallbackBase::createCutTerms(
+    const Hyperplane& hyperplane)
+{
+    auto cutTerms = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane);
+
+    if(!cutTerms)
+        return (std::nullopt);
+
+    for(auto& E : cutTerms->first)
+    {
+        if(E.second != E.second) // Check for NaN
+        {
+            env->output->outputError(
+                "        Warning: hyperplane not generated, NaN found in linear terms for variable "
+                + env->problem->getVariable(E.first)->name);
+            return (std::nullopt);
+        }
+    }
+
+    // Badly scaled cuts are scaled with the constant only, the coefficients of the linear terms are kept as they are
+    if(std::abs(cutTerms->second) > 1e15)
+    {
+        double scalingFactor = std::abs(cutTerms->second) - 1e15;
+
+        for(auto& E : cutTerms->first)
+            E.second /= scalingFactor;
+
+        cutTerms->second /= scalingFactor;
+
+        if(!warningMessageShownLargeRHS.exchange(true))
+        {
+            env->output->outputWarning(
+                "        Large values found in RHS of cut, you might want to consider reducing the "
+                "bounds of the nonlinear variables.");
+        }
+    }
+
+    return (cutTerms);
+}
+
+void MIPSolverCallbackBase::initializeBackgroundPrimalWorker()
+{
+    useBackgroundPrimalWorker = env->settings->getSetting<bool>("TreeStrategy.Single.BackgroundPrimal", "Dual")
+        && (taskSelectPrimalSolutionFromRootsearch || taskSelectPrimNLPOriginal || taskSelectPrimNLPReformulated);
+}
+
+void MIPSolverCallbackBase::initializeRelaxedCutPolicy()
+{
+    relaxedCutPolicy.setLimits(env->settings->getSetting<int>("Relaxation.Node.MaxCutsPerDepth", "Dual"),
+        env->settings->getSetting<double>("Relaxation.Node.MaxCutsPerSecond", "Dual"),
+        env->settings->getSetting<double>("Relaxation.Node.MinViolation", "Dual"),
+        env->settings->getSetting<int>("Relaxation.Node.CacheSize", "Dual"));
+}
+
+bool MIPSolverCallbackBase::getPrimalSolutionToInject(VectorDouble& point, double& objectiveValue)
+{
+    auto isImproved = [&](double value) {
+        return (std::isnan(injectedPrimalBound)
+            || (isMinimization ? value < injectedPrimalBound : value > injectedPrimalBound));
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(injectedPrimalSolutionMutex);
+
+        if(!isImproved(env->results->getPrimalBound()))
+            return (false);
+    }
+
+    auto bestSolution = env->results->getBestPrimalSolution();
+
+    // The solution is only taken by one thread
+    {
+        std::lock_guard<std::mutex> lock(injectedPrimalSolutionMutex);
+
+        if(bestSolution.first.empty() || !isImproved(bestSolution.second))
+            return (false);
+
+        injectedPrimalBound = bestSolution.second;
+    }
+
+    point = std::move(bestSolution.first);
+    objectiveValue = bestSolution.second;
+
+    if((int)point.size() < env->reformulatedProblem->properties.numberOfVariables)
+        env->reformulatedProblem->augmentAuxiliaryVariableValues(point);
+
+    if(env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
+        point.push_back(env->reformulatedProblem->objectiveFunction->calculateValue(point));
+
+    return (true);
+}
+
+void MIPSolverCallbackBase::addBackgroundPrimalCandidate(const SolutionPoint& point, bool solveFixedNLP)
+{
+    // The newer candidates are kept if the worker cannot keep up with the MIP solver
+    constexpr size_t maxNumberOfWaitingCandidates = 8;
+
+    {
+        std::lock_guard<std::mutex> lock(backgroundPrimalMutex);
+
+        if(!backgroundPrimalThread.joinable())
+        {
+            stopBackgroundPrimalThread = false;
+            backgroundPrimalThread = std::thread(&MIPSolverCallbackBase::runBackgroundPrimalWorker, this);
+        }
+
+        backgroundPrimalCandidates.emplace_back(point, solveFixedNLP);
+
+        if(backgroundPrimalCandidates.size() > maxNumberOfWaitingCandidates)
+            backgroundPrimalCandidates.pop_front();
+    }
+
+    backgroundPrimalCandidateAvailable.notify_one();
+}
+
+void MIPSolverCallbackBase::stopBackgroundPrimalWorker()
+{
+    {
+        std::lock_guard<std::mutex> lock(backgroundPrimalMutex);
+
+        if(!backgroundPrimalThread.joinable())
+            return;
+
+        stopBackgroundPrimalThread = true;
+        backgroundPrimalCandidates.clear();
+    }
+
+    backgroundPrimalCandidateAvailable.notify_one();
+    backgroundPrimalThread.join();
+}
+
+void MIPSolverCallbackBase::runBackgroundPrimalWorker()
+{
+    // Only the Ipopt interface can be used without the lock, the other NLP solvers are used as in the callback
+    bool solveWithoutLock = (env->results->usedPrimalNLPSolver == ES_PrimalNLPSolver::Ipopt);
+
+    while(true)
+    {
+        std::pair<SolutionPoint, bool> candidate;
+
+        {
+            std::unique_lock<std::mutex> lock(backgroundPrimalMutex);
+            backgroundPrimalCandidateAvailable.wait(
+                lock, [&] { return (stopBackgroundPrimalThread || !backgroundPrimalCandidates.empty()); });
+
+            if(stopBackgroundPrimalThread)
+                break;
+
+            candidate = std::move(backgroundPrimalCandidates.front());
+            backgroundPrimalCandidates.pop_front();
+        }
+
+        auto& point = candidate.first;
+        std::vector<PrimalFixedNLPCandidate> fixedNLPCandidates;
+
+        {
+            std::lock_guard<std::mutex> lock(callbackMutex);
+            TraceScope traceScope(env->traceRecorder.get(), "BackgroundPrimal");
+
+            if(taskSelectPrimalSolutionFromRootsearch)
+            {
+                taskSelectPrimalSolutionFromRootsearch->run({ point });
+                env->primalSolver->checkPrimalSolutionCandidates();
+            }
+
+            if(candidate.second && env->results->getRelativeGlobalObjectiveGap() >= 1e-10)
+            {
+                env->primalSolver->addFixedNLPCandidate(point.point, E_PrimalNLPSource::FirstSolution,
+                    point.objectiveValue, point.iterFound, point.maxDeviation);
+
+                // So that the same candidate is not added again before it has been solved
+                for(auto& CAND : env->primalSolver->fixedPrimalNLPCandidates)
+                {
+                    env->primalSolver->addUsedFixedNLPCandidate(CAND);
+                    fixedNLPCandidates.push_back(CAND);
+                }
+
+                env->primalSolver->fixedPrimalNLPCandidates.clear();
+            }
+        }
+
+        for(auto& CAND : fixedNLPCandidates)
+        {
+            for(auto& task : { taskSelectPrimNLPOriginal, taskSelectPrimNLPReformulated })
+            {
+                if(!task)
+                    continue;
+
+                std::unique_lock<std::mutex> lock(callbackMutex, std::defer_lock);
+
+                if(!solveWithoutLock)
+                    lock.lock();
+
+                auto result = task->solveFixedNLPCandidate(CAND);
+
+                if(!lock.owns_lock())
+                    lock.lock();
+
+                task->useFixedNLPResult(CAND, result);
+                env->primalSolver->checkPrimalSolutionCandidates();
+            }
+        }
+    }
+}
+
 bool MIPSolverCallbackBase::checkIterationLimit()
 {
-    if(env->tasks->isTerminated())
+    if(env->tasks->isTerminated() || env->cancellationToken->isCancelled())
         return (true);
 
     auto mainlimit = env->settings->getSetting<int>("IterationLimit", "Termination");
@@ -42,12 +329,45 @@ bool MIPSolverCallbackBase::checkUserTermination()
 {
     env->events->notify(E_EventType::UserTerminationCheck);
 
-    if(env->tasks->isTerminated())
+    if(env->tasks->isTerminated() || env->cancellationToken->isCancelled())
         return (true);
 
     return (false);
 }
 
+bool MIPSolverCallbackBase::addStreamedSolution(const VectorDouble& solution)
+{
+    if(!env->dualSolver->isSolutionStreamingUsed)
+        return (false);
+
+    VectorDouble primalSolution(solution.begin(), solution.begin() + env->problem->properties.numberOfVariables);
+    env->primalSolver->addPrimalSolutionCandidate(
+        primalSolution, E_PrimalSolutionSource::MIPCallback, env->results->getCurrentIteration()->iterationNumber);
+
+    if(env->dualSolver->maxStreamedViolatedSolutions == 0
+        || env->reformulatedProblem->properties.numberOfNonlinearConstraints == 0)
+        return (false);
+
+    VectorDouble point(solution.begin(), solution.begin() + env->reformulatedProblem->properties.numberOfVariables);
+
+    auto maxDeviation
+        = env->reformulatedProblem->getMaxNumericConstraintValue(point, env->reformulatedProblem->nonlinearConstraints);
+
+    if(maxDeviation.normalizedValue <= env->settings->getSetting<double>("ConstraintTolerance", "Termination"))
+        return (false);
+
+    env->dualSolver->numberOfStreamedViolatedSolutions++;
+
+    if(env->dualSolver->numberOfStreamedViolatedSolutions < env->dualSolver->maxStreamedViolatedSolutions)
+        return (false);
+
+    env->output->outputDebug("        Interrupting MIP solver after {} violating solutions.",
+        env->dualSolver->numberOfStreamedViolatedSolutions);
+
+    env->dualSolver->isMIPSolveInterrupted = true;
+    return (true);
+}
+
 bool MIPSolverCallbackBase::checkFixedNLPStrategy(SolutionPoint point)
 {
     if(!env->settings->getSetting<bool>("FixedInteger.Use", "Primal"))
@@ -103,27 +423,118 @@ bool MIPSolverCallbackBase::checkFixedNLPStrategy(SolutionPoint point)
     return (callNLPSolver);
 }
 
-void MIPSolverCallbackBase::printIterationReport(SolutionPoint solution, std::string threadId)
+void MIPSolverCallbackBase::printIterationReport(const SolutionPoint& solution, int threadId)
 {
     auto currIter = env->results->getCurrentIteration();
 
-    std::stringstream tmpType;
-    if(threadId != "")
+    IterationReportRecord record { currIter->iterationNumber, threadId, env->timing->getElapsedTime("Total"),
+        this->lastNumAddedHyperplanes, currIter->totNumHyperplanes, env->results->getCurrentDualBound(),
+        env->results->getGlobalDualBound(), env->results->getPrimalBound(), solution.objectiveValue,
+        solution.maxDeviation.index, solution.maxDeviation.value };
+
+    if(!isIterationReporterStarted)
     {
-        tmpType << "CB (th: " << threadId << ")";
+        std::lock_guard<std::mutex> lock(iterationReporterMutex);
+
+        if(!isIterationReporterStarted)
+        {
+            double rate = env->settings->getSetting<double>("Console.Iteration.CallbackRate", "Output");
+            iterationReportInterval = (rate > 0.0) ? 1.0 / rate : 0.0;
+
+            if(iterationReportInterval > 0.0)
+            {
+                stopIterationReporterThread = false;
+                iterationReporterThread = std::thread(&MIPSolverCallbackBase::runIterationReporter, this);
+            }
+
+            isIterationReporterStarted = true;
+        }
     }
-    else
+
+    if(iterationReportInterval == 0.0)
     {
-        tmpType << "CB";
+        outputIterationRecord(record, false);
+    }
+    else if(!iterationReportQueue.push(record))
+    {
+        // The added hyperplanes are then included in the next record
+        return;
     }
-
-    env->report->outputIterationDetail(currIter->iterationNumber, tmpType.str(), env->timing->getElapsedTime("Total"),
-        this->lastNumAddedHyperplanes, currIter->totNumHyperplanes, env->results->getCurrentDualBound(),
-        env->results->getPrimalBound(), env->results->getAbsoluteGlobalObjectiveGap(),
-        env->results->getRelativeGlobalObjectiveGap(), solution.objectiveValue, solution.maxDeviation.index,
-        solution.maxDeviation.value, E_IterationLineType::DualCallback);
 
     this->lastNumAddedHyperplanes = 0;
 }
 
+void MIPSolverCallbackBase::stopIterationReporter()
+{
+    {
+        std::lock_guard<std::mutex> lock(iterationReporterMutex);
+
+        if(!isIterationReporterStarted)
+            return;
+
+        stopIterationReporterThread = true;
+    }
+
+    iterationReporterStopped.notify_one();
+
+    if(iterationReporterThread.joinable())
+        iterationReporterThread.join();
+
+    isIterationReporterStarted = false;
+}
+
+void MIPSolverCallbackBase::runIterationReporter()
+{
+    bool stop = false;
+
+    while(!stop)
+    {
+        {
+            std::unique_lock<std::mutex> lock(iterationReporterMutex);
+            iterationReporterStopped.wait_for(lock, std::chrono::duration<double>(iterationReportInterval),
+                [&] { return (stopIterationReporterThread); });
+
+            stop = stopIterationReporterThread;
+        }
+
+        // The records in the queue are merged into one line with the values of the latest record
+        IterationReportRecord record;
+        IterationReportRecord mergedRecord;
+        int numberOfRecords = 0;
+        bool isFromMultipleThreads = false;
+
+        while(iterationReportQueue.pop(record))
+        {
+            if(numberOfRecords > 0)
+            {
+                isFromMultipleThreads = isFromMultipleThreads || (record.threadId != mergedRecord.threadId);
+                record.numberOfAddedHyperplanes += mergedRecord.numberOfAddedHyperplanes;
+            }
+
+            mergedRecord = record;
+            numberOfRecords++;
+        }
+
+        if(numberOfRecords > 0)
+            outputIterationRecord(mergedRecord, isFromMultipleThreads);
+    }
+}
+
+void MIPSolverCallbackBase::outputIterationRecord(const IterationReportRecord& record, bool isFromMultipleThreads)
+{
+    std::string description = "CB";
+
+    if(record.threadId >= 0 && !isFromMultipleThreads)
+        description = fmt::format("CB (th: {})", record.threadId);
+
+    // Calculated as in Results, but with the bounds when the record was created
+    double absoluteGap = std::abs(record.globalDualBound - record.primalBound);
+    double relativeGap = absoluteGap / ((1e-10) + std::abs(record.primalBound));
+
+    env->report->outputIterationDetail(record.iterationNumber, description, record.timeStamp,
+        record.numberOfAddedHyperplanes, record.totalNumberOfHyperplanes, record.currentDualBound, record.primalBound,
+        absoluteGap, relativeGap, record.objectiveValue, record.maxDeviationIndex, record.maxDeviationValue,
+        E_IterationLineType::DualCallback);
+}
+
 } // namespace SHOT
\ No newline at end of file
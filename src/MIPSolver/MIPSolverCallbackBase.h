@@ -12,6 +12,10 @@
 
 #include "../Environment.h"
 
+#include "CutPool.h"
+#include "IterationReportQueue.h"
+#include "RelaxedCutPolicy.h"
+
 #include "../Tasks/TaskSelectHyperplanePointsObjectiveFunction.h"
 #include "../Tasks/TaskSelectPrimalCandidatesFromRootsearch.h"
 #include "../Tasks/TaskSelectPrimalCandidatesFromNLP.h"
@@ -19,8 +23,18 @@
 #include "../Tasks/TaskSelectHyperplanePointsECP.h"
 #include "../Tasks/TaskUpdateInteriorPoint.h"
 
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <optional>
 #include <string>
+#include <thread>
+#include <utility>
 #include <vector>
 
 namespace SHOT
@@ -28,10 +42,47 @@ namespace SHOT
 class MIPSolverCallbackBase
 {
 public:
-    virtual ~MIPSolverCallbackBase() = default;
+    virtual ~MIPSolverCallbackBase();
+
+    // Discards the candidates not yet used by the background primal worker and waits for the current one to finish,
+    // should be called when the MIP solver returns
+    void stopBackgroundPrimalWorker();
+
+    // Prints the iteration records not yet shown and stops the reporter thread, should be called when the MIP solver
+    // returns
+    void stopIterationReporter();
 
 private:
+    void runBackgroundPrimalWorker();
+
+    // With Console.Iteration.CallbackRate larger than zero, the iteration lines from the callbacks are printed by a
+    // separate thread, so that the threads of the MIP solver only add the records to the queue. The records from the
+    // same time interval are merged into one line.
+    void runIterationReporter();
+    void outputIterationRecord(const IterationReportRecord& record, bool isFromMultipleThreads);
+
+    IterationReportQueue iterationReportQueue;
+    std::thread iterationReporterThread;
+    std::mutex iterationReporterMutex;
+    std::condition_variable iterationReporterStopped;
+    std::atomic<bool> isIterationReporterStarted { false };
+    bool stopIterationReporterThread = false;
+    double iterationReportInterval = 0.0;
+
+    std::thread backgroundPrimalThread;
+    std::mutex backgroundPrimalMutex;
+    std::condition_variable backgroundPrimalCandidateAvailable;
+    std::deque<std::pair<SolutionPoint, bool>> backgroundPrimalCandidates;
+    bool stopBackgroundPrimalThread = false;
+
+    // The objective value of the last primal solution given to the MIP solver
+    std::mutex injectedPrimalSolutionMutex;
+    double injectedPrimalBound = NAN;
+
 protected:
+    // Guards the solver state used by the callback threads and the background primal worker
+    std::mutex callbackMutex;
+
     bool isMinimization = true;
     int lastNumAddedHyperplanes = 0;
     double lastUpdatedPrimal;
@@ -40,7 +91,14 @@ protected:
     double lastSummaryTimeStamp = 0.0;
     int lastHeaderIter = 0;
 
-    bool warningMessageShownLargeRHS = false;
+    std::atomic<bool> warningMessageShownLargeRHS { false };
+
+    // The cuts created in the callback, shared by the threads of the MIP solver
+    CutPool cutPool;
+
+    // Selects the relaxed solutions in the nodes that are used to generate cuts, within Relaxation.MaxLazyConstraints
+    RelaxedCutPolicy relaxedCutPolicy;
+    void initializeRelaxedCutPolicy();
 
     std::shared_ptr<TaskSelectPrimalCandidatesFromNLP> taskSelectPrimNLPOriginal;
     std::shared_ptr<TaskSelectPrimalCandidatesFromNLP> taskSelectPrimNLPReformulated;
@@ -49,15 +107,43 @@ protected:
     std::shared_ptr<TaskSelectPrimalCandidatesFromRootsearch> taskSelectPrimalSolutionFromRootsearch;
     std::shared_ptr<TaskUpdateInteriorPoint> tUpdateInteriorPoint;
 
+    // Creates the tasks above that are used with the current settings and problem
+    void initializeCallbackTasks();
+
+    // Selects the points for the hyperplane cuts of the given solutions, the cuts are added to the waiting list
+    void selectHyperplanePoints(const std::vector<SolutionPoint>& solutionPoints);
+
+    // The linear terms and constant of the cut for the hyperplane, which are scaled if the constant is very large
+    std::optional<std::pair<std::map<int, double>, double>> createCutTerms(const Hyperplane& hyperplane);
+
     bool checkFixedNLPStrategy(SolutionPoint point);
 
+    // With TreeStrategy.Single.BackgroundPrimal, the primal root searches and fixed NLP problems are performed by a
+    // separate thread instead of in the candidate callback, which then only creates the cuts. The solutions found are
+    // given to the MIP solver in the callbacks like the other primal solutions.
+    bool useBackgroundPrimalWorker = false;
+    void initializeBackgroundPrimalWorker();
+
+    // Called with the callback mutex locked, the fixed NLP problem is only solved if the second argument is true
+    void addBackgroundPrimalCandidate(const SolutionPoint& point, bool solveFixedNLP);
+
+    // The best primal solution is given to the MIP solver by the first callback where it can be posted, in the
+    // variables of the dual problem. It may have been found by the primal heuristics in any thread, or by the
+    // background worker.
+    // Returns false if there is no new solution or if it has been taken by another thread.
+    bool getPrimalSolutionToInject(VectorDouble& point, double& objectiveValue);
+
     bool checkIterationLimit();
 
     bool checkUserTermination();
 
-    void addLazyConstraint(std::vector<SolutionPoint> candidatePoints);
+    // Passes an incumbent found in a multi-tree MIP solve on to the primal solver. Returns true if the MIP solve should
+    // be interrupted since enough solutions violating the nonlinear constraints have been found.
+    bool addStreamedSolution(const VectorDouble& solution);
+
+    void addLazyConstraint(const std::vector<SolutionPoint>& candidatePoints);
 
-    void printIterationReport(SolutionPoint solution, std::string threadId);
+    void printIterationReport(const SolutionPoint& solution, int threadId = -1);
 
     EnvironmentPtr env;
 };
@@ -11,12 +11,15 @@
 #include "MIPSolverCbc.h"
 #include "MIPSolverCallbackBase.h"
 
+#include "../CancellationToken.h"
+#include "../DebugWriter.h"
 #include "../DualSolver.h"
 #include "../Iteration.h"
 #include "../Output.h"
 #include "../PrimalSolver.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 
@@ -28,8 +31,13 @@
 #include "CbcModel.hpp"
 #include "CbcSolver.hpp"
 #include "CbcBranchLotsize.hpp"
+#include "CbcCompareDefault.hpp"
+#include "CbcCompareDepth.hpp"
+#include "CbcStrategy.hpp"
 #include "OsiClpSolverInterface.hpp"
 
+#include <cmath>
+
 namespace SHOT
 {
 
@@ -63,6 +71,17 @@ public:
             return (CbcEventHandler::CbcAction::stop);
         }
 
+        if((whichEvent == CbcEventHandler::CbcEvent::solution
+               || whichEvent == CbcEventHandler::CbcEvent::heuristicSolution)
+            && env->dualSolver->isSolutionStreamingUsed && model_->bestSolution() != nullptr)
+        {
+            const double* values = model_->bestSolution();
+            VectorDouble solution(values, values + model_->getNumCols());
+
+            if(addStreamedSolution(solution))
+                return (CbcEventHandler::CbcAction::stop);
+        }
+
         return (CbcEventHandler::CbcAction::noAction);
     }
 };
@@ -86,6 +105,7 @@ bool MIPSolverCbc::initializeProblem()
 
     cachedSolutionHasChanged = true;
     isVariablesFixed = false;
+    useNames = env->settings->getSetting<bool>("MIP.UseNames", "Dual");
 
     checkParameters();
 
@@ -187,6 +207,14 @@ bool MIPSolverCbc::addQuadraticTermToObjective([[maybe_unused]] double coefficie
     return (false);
 }
 
+bool MIPSolverCbc::addQuadraticTermsToObjective([[maybe_unused]] const VectorDouble& coefficients,
+    [[maybe_unused]] const VectorInteger& firstVariableIndexes,
+    [[maybe_unused]] const VectorInteger& secondVariableIndexes)
+{
+    // Not implemented
+    return (false);
+}
+
 bool MIPSolverCbc::finalizeObjective(bool isMinimize, double constant)
 {
     try
@@ -223,6 +251,38 @@ bool MIPSolverCbc::finalizeObjective(bool isMinimize, double constant)
     return (true);
 }
 
+bool MIPSolverCbc::replaceObjective(const std::map<int, double>& linearTerms, bool isMinimize)
+{
+    try
+    {
+        objectiveLinearExpression.clear();
+
+        for(int i = 0; i < osiInterface->getNumCols(); i++)
+            osiInterface->setObjCoeff(i, 0.0);
+
+        // The problem is always a minimization problem in Cbc
+        for(auto& T : linearTerms)
+        {
+            double coefficient = isMinimize ? T.second : -T.second;
+
+            objectiveLinearExpression.insert(T.first, coefficient);
+            osiInterface->setObjCoeff(T.first, coefficient);
+        }
+
+        isMinimizationProblem = isMinimize;
+        objectiveConstant = 0.0;
+        osiInterface->setDblParam(OsiObjOffset, 0.0);
+        cachedSolutionHasChanged = true;
+    }
+    catch(std::exception& e)
+    {
+        env->output->outputError("        Cbc exception caught when replacing objective function: ", e.what());
+        return (false);
+    }
+
+    return (true);
+}
+
 bool MIPSolverCbc::initializeConstraint() { return (true); }
 
 bool MIPSolverCbc::addLinearTermToConstraint(double coefficient, int variableIndex)
@@ -251,6 +311,14 @@ bool MIPSolverCbc::addQuadraticTermToConstraint([[maybe_unused]] double coeffici
     return (false);
 }
 
+bool MIPSolverCbc::addQuadraticTermsToConstraint([[maybe_unused]] const VectorDouble& coefficients,
+    [[maybe_unused]] const VectorInteger& firstVariableIndexes,
+    [[maybe_unused]] const VectorInteger& secondVariableIndexes)
+{
+    // Not implemented
+    return (false);
+}
+
 bool MIPSolverCbc::finalizeConstraint(std::string name, double valueLHS, double valueRHS, double constant)
 {
     int index = numberOfConstraints;
@@ -265,7 +333,8 @@ bool MIPSolverCbc::finalizeConstraint(std::string name, double valueLHS, double
             coinModel->setRowBounds(index, valueRHS - constant, valueLHS - constant);
         }
 
-        coinModel->setRowName(index, name.c_str());
+        if(useNames)
+            coinModel->setRowName(index, name.c_str());
     }
     catch(std::exception& e)
     {
@@ -311,7 +380,9 @@ void MIPSolverCbc::initializeSolverSettings()
 {
     // Set termination tolerances
     cbcModel->setAllowableGap(env->settings->getSetting<double>("ObjectiveGap.Absolute", "Termination") / 1.0);
-    cbcModel->setAllowableFractionGap(env->settings->getSetting<double>("ObjectiveGap.Relative", "Termination") / 1.0);
+    cbcModel->setAllowableFractionGap(std::isnan(relativeGap)
+            ? env->settings->getSetting<double>("ObjectiveGap.Relative", "Termination")
+            : relativeGap);
     osiInterface->setDblParam(
         OsiPrimalTolerance, env->settings->getSetting<double>("Tolerance.LinearConstraint", "Primal"));
     cbcModel->setIntegerTolerance(env->settings->getSetting<double>("Tolerance.Integer", "Primal"));
@@ -335,9 +406,9 @@ void MIPSolverCbc::initializeSolverSettings()
     {
         // Cbc runs deterministcally if 100 is added to the number of threads
         if(env->settings->getSetting<bool>("Cbc.DeterministicParallelMode", "Subsolver"))
-            numberOfThreads = env->settings->getSetting<int>("MIP.NumberOfThreads", "Dual") + 100;
+            numberOfThreads = ThreadPlacement::getNumberOfMIPThreads(env->settings) + 100;
         else
-            numberOfThreads = env->settings->getSetting<int>("MIP.NumberOfThreads", "Dual");
+            numberOfThreads = ThreadPlacement::getNumberOfMIPThreads(env->settings);
     }
     else
         numberOfThreads = 1;
@@ -394,6 +465,74 @@ int MIPSolverCbc::addLinearConstraint(
     return (osiInterface->getNumRows() - 1);
 }
 
+int MIPSolverCbc::addLinearConstraints(const LinearConstraintBlock& constraints)
+{
+    try
+    {
+        int numConstraintsBefore = osiInterface->getNumRows();
+        int numConstraints = constraints.size();
+
+        VectorDouble rowLowerBounds(numConstraints, -osiInterface->getInfinity());
+        VectorDouble rowUpperBounds(numConstraints);
+
+        for(int i = 0; i < numConstraints; i++)
+            rowUpperBounds[i] = -constraints.constants[i];
+
+        osiInterface->addRows(numConstraints, constraints.rowStarts.data(), constraints.variableIndexes.data(),
+            constraints.coefficients.data(), rowLowerBounds.data(), rowUpperBounds.data());
+
+        if(osiInterface->getNumRows() != numConstraintsBefore + numConstraints)
+        {
+            env->output->outputDebug("        Linear constraints not added by Cbc");
+            return (-1);
+        }
+
+        for(int i = 0; i < numConstraints; i++)
+        {
+            if(useNames)
+                osiInterface->setRowName(numConstraintsBefore + i, constraints.names[i]);
+
+            allowRepairOfConstraint.push_back(constraints.allowRepair[i]);
+        }
+
+        return (numConstraintsBefore);
+    }
+    catch(std::exception& e)
+    {
+        env->output->outputError("        Error when adding linear constraints in Cbc: ", e.what());
+    }
+    catch(CoinError& e)
+    {
+        env->output->outputError("        Error when adding linear constraints in Cbc: ", e.message());
+    }
+
+    return (-1);
+}
+
+bool MIPSolverCbc::removeLinearConstraints(const VectorInteger& constraintIndexes)
+{
+    if(constraintIndexes.size() == 0)
+        return (true);
+
+    try
+    {
+        osiInterface->deleteRows((int)constraintIndexes.size(), constraintIndexes.data());
+    }
+    catch(CoinError& e)
+    {
+        env->output->outputError("        Error when removing linear constraints in Cbc: ", e.message());
+        return (false);
+    }
+
+    // The rows of a persistent model no longer match the ones in the interface
+    isCbcModelPersistent = false;
+
+    updateConstraintIndexesAfterRemoval(constraintIndexes);
+    return (true);
+}
+
+int MIPSolverCbc::getNumberOfConstraints() { return (osiInterface->getNumRows()); }
+
 bool MIPSolverCbc::addSpecialOrderedSet(E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights)
 {
     try
@@ -474,6 +613,9 @@ void MIPSolverCbc::activateDiscreteVariables(bool activate)
 
 E_ProblemSolutionStatus MIPSolverCbc::getSolutionStatus()
 {
+    if(isRelaxationSolvedByClp)
+        return (getRelaxedSolutionStatus());
+
     E_ProblemSolutionStatus MIPSolutionStatus;
 
     if(cbcModel->isProvenOptimal() && cbcModel->numberSavedSolutions() > 0)
@@ -492,6 +634,11 @@ E_ProblemSolutionStatus MIPSolverCbc::getSolutionStatus()
     {
         MIPSolutionStatus = E_ProblemSolutionStatus::SolutionLimit;
     }
+    else if(cbcModel->status() == 5 && env->dualSolver->isMIPSolveInterrupted && cbcModel->numberSavedSolutions() > 0)
+    {
+        // Stopped by the event handler since enough incumbents have been found
+        MIPSolutionStatus = E_ProblemSolutionStatus::SolutionLimit;
+    }
     else if(cbcModel->isSecondsLimitReached())
     {
         MIPSolutionStatus = E_ProblemSolutionStatus::TimeLimit;
@@ -528,6 +675,11 @@ E_ProblemSolutionStatus MIPSolverCbc::solveProblem()
     E_ProblemSolutionStatus MIPSolutionStatus;
     cachedSolutionHasChanged = true;
 
+    if(!discreteVariablesActivated && env->settings->getSetting<bool>("Cbc.RelaxationWarmStart", "Subsolver"))
+        return (solveRelaxedProblem());
+
+    isRelaxationSolvedByClp = false;
+
     const int numArguments = 17;
     char* argv[numArguments];
     std::string arg;
@@ -633,8 +785,9 @@ E_ProblemSolutionStatus MIPSolverCbc::solveProblem()
 
         argv[10] = strdup(arg.c_str());*/
 
+    // Cbc works on a copy of the model here, which is stopped by the event handler when the token is cancelled
     argv[9] = strdup("-sec");
-    arg = fmt::format("{}", this->timeLimit);
+    arg = fmt::format("{}", std::min(this->timeLimit, env->cancellationToken->getRemainingTime()));
     argv[10] = strdup(arg.c_str());
 
     // pass threads option if not running single-threaded (101 = 1 thread + deterministic multithreading)
@@ -661,55 +814,37 @@ E_ProblemSolutionStatus MIPSolverCbc::solveProblem()
 
     try
     {
-        cbcModel = std::make_unique<CbcModel>(*osiInterface);
+        if(env->settings->getSetting<bool>("Cbc.Persistent", "Subsolver"))
+        {
+            solvePersistentProblem();
+        }
+        else
+        {
+            cbcModel = std::make_unique<CbcModel>(*osiInterface);
+            isCbcModelPersistent = false;
 
-        initializeSolverSettings();
+            initializeSolverSettings();
 
-        // Adding the MIP start provided, so far only if there are no special variable types included, since the MIP
-        // start functionality in Cbc version 2 is unstable
-        if(MIPStart.size() > 0
-            && (env->reformulatedProblem->properties.numberOfSemiintegerVariables
-                    + env->reformulatedProblem->properties.numberOfSemicontinuousVariables
-                    + env->reformulatedProblem->properties.numberOfSpecialOrderedSets
-                == 0))
-            cbcModel->setMIPStart(MIPStart);
-
-        // Create and add lotsize objects
-        if(!lotsizes.empty())
-        {
-            std::vector<CbcObject*> cbcobjects;
-            cbcobjects.reserve(lotsizes.size());
+            passMIPStart();
+            addLotsizeObjects();
+
+            CbcSolverUsefulData solverData;
+            CbcMain0(*cbcModel, solverData);
 
-            for(const auto& l : lotsizes)
+            if(!env->settings->getSetting<bool>("Console.DualSolver.Show", "Output"))
             {
-                if(l.second[2] == l.second[3]) // special case where second interval is singleton, too
-                    cbcobjects.push_back(new CbcLotsize(cbcModel.get(), l.first, 2, l.second.data() + 1, false));
-                else
-                    cbcobjects.push_back(new CbcLotsize(cbcModel.get(), l.first, 2, l.second.data(), true));
+                cbcModel->setLogLevel(0);
+                osiInterface->setHintParam(OsiDoReducePrint, false, OsiHintTry);
             }
 
-            cbcModel->addObjects(cbcobjects.size(), cbcobjects.data());
-
-            for(CbcObject* o : cbcobjects)
-                delete o;
-        }
+            osiInterface->setDblParam(OsiObjOffset, this->objectiveConstant);
 
-        CbcSolverUsefulData solverData;
-        CbcMain0(*cbcModel, solverData);
+            TerminationEventHandler eventHandler(env);
+            cbcModel->passInEventHandler(&eventHandler);
 
-        if(!env->settings->getSetting<bool>("Console.DualSolver.Show", "Output"))
-        {
-            cbcModel->setLogLevel(0);
-            osiInterface->setHintParam(OsiDoReducePrint, false, OsiHintTry);
+            CbcMain1(numArguments, const_cast<const char**>(argv), *cbcModel, dummyCallback, solverData);
         }
 
-        osiInterface->setDblParam(OsiObjOffset, this->objectiveConstant);
-
-        TerminationEventHandler eventHandler(env);
-        cbcModel->passInEventHandler(&eventHandler);
-
-        CbcMain1(numArguments, const_cast<const char**>(argv), *cbcModel, dummyCallback, solverData);
-
         MIPSolutionStatus = getSolutionStatus();
     }
     catch(std::exception& e)
@@ -727,6 +862,7 @@ E_ProblemSolutionStatus MIPSolverCbc::solveProblem()
             osiInterface->setColBounds(getDualAuxiliaryObjectiveVariableIndex(), -1000000000.0, 1000000000.0);
 
             cbcModel = std::make_unique<CbcModel>(*osiInterface);
+            isCbcModelPersistent = false;
 
             initializeSolverSettings();
 
@@ -757,39 +893,8 @@ E_ProblemSolutionStatus MIPSolverCbc::solveProblem()
     if(MIPSolutionStatus == E_ProblemSolutionStatus::Unbounded && env->results->getNumberOfIterations() > 0)
     {
         VectorInteger variablesWithChangedBounds;
-        bool problemUpdated = false;
-
-        if((env->reformulatedProblem->objectiveFunction->properties.classification
-                   == E_ObjectiveFunctionClassification::Linear
-               && std::dynamic_pointer_cast<LinearObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
-                      ->isDualUnbounded())
-            || (env->reformulatedProblem->objectiveFunction->properties.classification
-                    == E_ObjectiveFunctionClassification::Quadratic
-                && std::dynamic_pointer_cast<QuadraticObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
-                       ->isDualUnbounded()))
-        {
-            for(auto& V : env->reformulatedProblem->allVariables)
-            {
-                if(V->isDualUnbounded())
-                {
-                    // Temporarily introduce bounds [-1e20,1e20] for unbounded variables in objective
-                    updateVariableBound(V->index, -1e20, 1e20);
-                    variablesWithChangedBounds.push_back(V->index);
-                    problemUpdated = true;
-                }
-            }
-        }
-        else if(env->reformulatedProblem->objectiveFunction->properties.classification
-                >= E_ObjectiveFunctionClassification::QuadraticConsideredAsNonlinear
-            && hasDualAuxiliaryObjectiveVariable())
-        {
-            // The auxiliary variable in the dual problem is unbounded
-            updateVariableBound(getDualAuxiliaryObjectiveVariableIndex(), -getUnboundedVariableBoundValue() / 10e40,
-                getUnboundedVariableBoundValue() / 10e40);
-            problemUpdated = true;
-        }
 
-        if(problemUpdated)
+        if(setTemporaryBoundsForUnboundedProblem(variablesWithChangedBounds))
         {
             if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
             {
@@ -810,6 +915,7 @@ E_ProblemSolutionStatus MIPSolverCbc::solveProblem()
             }
 
             cbcModel = std::make_unique<CbcModel>(*osiInterface);
+            isCbcModelPersistent = false;
 
             initializeSolverSettings();
 
@@ -847,6 +953,300 @@ E_ProblemSolutionStatus MIPSolverCbc::solveProblem()
     return (MIPSolutionStatus);
 }
 
+bool MIPSolverCbc::setTemporaryBoundsForUnboundedProblem(VectorInteger& variablesWithChangedBounds)
+{
+    bool problemUpdated = false;
+
+    if((env->reformulatedProblem->objectiveFunction->properties.classification
+               == E_ObjectiveFunctionClassification::Linear
+           && std::dynamic_pointer_cast<LinearObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
+                  ->isDualUnbounded())
+        || (env->reformulatedProblem->objectiveFunction->properties.classification
+                == E_ObjectiveFunctionClassification::Quadratic
+            && std::dynamic_pointer_cast<QuadraticObjectiveFunction>(env->reformulatedProblem->objectiveFunction)
+                   ->isDualUnbounded()))
+    {
+        for(auto& V : env->reformulatedProblem->allVariables)
+        {
+            if(V->isDualUnbounded())
+            {
+                // Temporarily introduce bounds [-1e20,1e20] for unbounded variables in objective
+                updateVariableBound(V->index, -1e20, 1e20);
+                variablesWithChangedBounds.push_back(V->index);
+                problemUpdated = true;
+            }
+        }
+    }
+    else if(env->reformulatedProblem->objectiveFunction->properties.classification
+            >= E_ObjectiveFunctionClassification::QuadraticConsideredAsNonlinear
+        && hasDualAuxiliaryObjectiveVariable())
+    {
+        // The auxiliary variable in the dual problem is unbounded
+        updateVariableBound(getDualAuxiliaryObjectiveVariableIndex(), -getUnboundedVariableBoundValue() / 10e40,
+            getUnboundedVariableBoundValue() / 10e40);
+        problemUpdated = true;
+    }
+
+    return (problemUpdated);
+}
+
+E_ProblemSolutionStatus MIPSolverCbc::solveRelaxedProblem()
+{
+    E_ProblemSolutionStatus MIPSolutionStatus;
+    isRelaxationSolvedByClp = true;
+
+    try
+    {
+        // Clp cannot be stopped from another thread, so the time limit is also limited by the deadline
+        osiInterface->getModelPtr()->setMaximumSeconds(
+            std::min(this->timeLimit, env->cancellationToken->getRemainingTime()));
+
+        if(!env->settings->getSetting<bool>("Console.DualSolver.Show", "Output"))
+        {
+            osiInterface->messageHandler()->setLogLevel(0);
+            osiInterface->setHintParam(OsiDoReducePrint, true, OsiHintTry);
+        }
+
+        osiInterface->setDblParam(OsiObjOffset, this->objectiveConstant);
+
+        // Clp keeps the basis of the previous LP problem, in which the rows added since are basic, so the LP problem is
+        // reoptimized with the dual simplex method
+        if(isClpWarmStarted)
+        {
+            osiInterface->resolve();
+        }
+        else
+        {
+            osiInterface->initialSolve();
+            isClpWarmStarted = true;
+        }
+
+        MIPSolutionStatus = getRelaxedSolutionStatus();
+
+        // To find a feasible point for an unbounded dual problem and not when solving the minimax-problem
+        if(MIPSolutionStatus == E_ProblemSolutionStatus::Unbounded && env->results->getNumberOfIterations() > 0)
+        {
+            VectorInteger variablesWithChangedBounds;
+
+            if(setTemporaryBoundsForUnboundedProblem(variablesWithChangedBounds))
+            {
+                osiInterface->resolve();
+                MIPSolutionStatus = getRelaxedSolutionStatus();
+
+                if(MIPSolutionStatus == E_ProblemSolutionStatus::Optimal)
+                    MIPSolutionStatus = E_ProblemSolutionStatus::Feasible;
+
+                for(auto& I : variablesWithChangedBounds)
+                {
+                    updateVariableBound(I, env->reformulatedProblem->getVariableLowerBound(I),
+                        env->reformulatedProblem->getVariableUpperBound(I));
+                }
+
+                env->results->getCurrentIteration()->hasInfeasibilityRepairBeenPerformed = true;
+            }
+        }
+    }
+    catch(CoinError& e)
+    {
+        env->output->outputError("        Error when solving relaxed problem with Clp", e.message());
+        MIPSolutionStatus = E_ProblemSolutionStatus::Error;
+    }
+
+    return (MIPSolutionStatus);
+}
+
+E_ProblemSolutionStatus MIPSolverCbc::getRelaxedSolutionStatus()
+{
+    E_ProblemSolutionStatus MIPSolutionStatus;
+
+    if(osiInterface->isProvenOptimal())
+    {
+        MIPSolutionStatus = E_ProblemSolutionStatus::Optimal;
+    }
+    else if(osiInterface->isProvenPrimalInfeasible())
+    {
+        MIPSolutionStatus = E_ProblemSolutionStatus::Infeasible;
+    }
+    else if(osiInterface->isProvenDualInfeasible())
+    {
+        MIPSolutionStatus = E_ProblemSolutionStatus::Unbounded;
+    }
+    else if(osiInterface->isIterationLimitReached())
+    {
+        // No iteration limit is given to Clp, so it has been stopped by the time limit
+        MIPSolutionStatus = E_ProblemSolutionStatus::TimeLimit;
+    }
+    else if(osiInterface->isAbandoned())
+    {
+        MIPSolutionStatus = E_ProblemSolutionStatus::Abort;
+    }
+    else
+    {
+        MIPSolutionStatus = E_ProblemSolutionStatus::Error;
+        env->output->outputError(fmt::format("        LP solver return status unknown (Clp returned status {}).",
+            osiInterface->getModelPtr()->status()));
+    }
+
+    return (MIPSolutionStatus);
+}
+
+void MIPSolverCbc::passMIPStart()
+{
+    // Adding the MIP start provided, so far only if there are no special variable types included, since the MIP
+    // start functionality in Cbc version 2 is unstable
+    if(MIPStart.size() > 0
+        && (env->reformulatedProblem->properties.numberOfSemiintegerVariables
+                + env->reformulatedProblem->properties.numberOfSemicontinuousVariables
+                + env->reformulatedProblem->properties.numberOfSpecialOrderedSets
+            == 0))
+        cbcModel->setMIPStart(MIPStart);
+}
+
+void MIPSolverCbc::addLotsizeObjects()
+{
+    if(lotsizes.empty())
+        return;
+
+    std::vector<CbcObject*> cbcobjects;
+    cbcobjects.reserve(lotsizes.size());
+
+    for(const auto& l : lotsizes)
+    {
+        if(l.second[2] == l.second[3]) // special case where second interval is singleton, too
+            cbcobjects.push_back(new CbcLotsize(cbcModel.get(), l.first, 2, l.second.data() + 1, false));
+        else
+            cbcobjects.push_back(new CbcLotsize(cbcModel.get(), l.first, 2, l.second.data(), true));
+    }
+
+    cbcModel->addObjects(cbcobjects.size(), cbcobjects.data());
+
+    for(CbcObject* o : cbcobjects)
+        delete o;
+}
+
+void MIPSolverCbc::createPersistentModel()
+{
+    cbcModel = std::make_unique<CbcModel>(*osiInterface);
+    isCbcModelPersistent = true;
+
+    addLotsizeObjects();
+
+    // The parameters are set through the API instead of the command line arguments used by CbcMain1. Preprocessing is
+    // not used, since the rows added in later iterations would not match the preprocessed model.
+    CbcStrategyDefault strategy(1, 5, (env->settings->getSetting<int>("Cbc.Strategy", "Subsolver") == 0) ? 0 : 10);
+    strategy.setupPreProcessing(0);
+    cbcModel->setStrategy(strategy);
+
+    switch(env->settings->getSetting<int>("Cbc.NodeStrategy", "Subsolver"))
+    {
+    case 0: // depth
+    case 1: // downdepth
+    case 5: // updepth
+    {
+        CbcCompareDepth compare;
+        cbcModel->setNodeComparison(compare);
+        break;
+    }
+
+    default: // the other strategies are variants of the default hybrid strategy
+    {
+        CbcCompareDefault compare;
+        cbcModel->setNodeComparison(compare);
+        break;
+    }
+    }
+
+    // The values of Cbc.Scaling are ordered differently from the scaling modes in Clp
+    const int scalingModes[] = { 3, 4, 1, 2, 0, 5 };
+    int scaling = env->settings->getSetting<int>("Cbc.Scaling", "Subsolver");
+
+    if(auto clpInterface = dynamic_cast<OsiClpSolverInterface*>(cbcModel->solver()))
+        clpInterface->getModelPtr()->scaling(scalingModes[scaling]);
+
+    if(!env->settings->getSetting<bool>("Console.DualSolver.Show", "Output"))
+    {
+        cbcModel->setLogLevel(0);
+        cbcModel->solver()->setHintParam(OsiDoReducePrint, false, OsiHintTry);
+    }
+}
+
+bool MIPSolverCbc::updatePersistentModel()
+{
+    auto solver = cbcModel->solver();
+
+    int numberOfColumns = osiInterface->getNumCols();
+    int numberOfRows = osiInterface->getNumRows();
+    int numberOfPersistentRows = solver->getNumRows();
+
+    // Only added rows and changed bounds and objective coefficients can be transferred to the persistent model
+    if(solver->getNumCols() != numberOfColumns || numberOfPersistentRows > numberOfRows)
+        return (false);
+
+    for(int i = 0; i < numberOfColumns; i++)
+    {
+        if(solver->isInteger(i) != osiInterface->isInteger(i))
+            return (false);
+    }
+
+    const double* columnLowerBounds = osiInterface->getColLower();
+    const double* columnUpperBounds = osiInterface->getColUpper();
+    const double* objectiveCoefficients = osiInterface->getObjCoefficients();
+
+    for(int i = 0; i < numberOfColumns; i++)
+    {
+        solver->setColBounds(i, columnLowerBounds[i], columnUpperBounds[i]);
+        solver->setObjCoeff(i, objectiveCoefficients[i]);
+    }
+
+    solver->setObjSense(osiInterface->getObjSense());
+
+    const double* rowLowerBounds = osiInterface->getRowLower();
+    const double* rowUpperBounds = osiInterface->getRowUpper();
+
+    for(int i = 0; i < numberOfPersistentRows; i++)
+        solver->setRowBounds(i, rowLowerBounds[i], rowUpperBounds[i]);
+
+    // The new rows are added as basic slacks to the current basis, so the LP basis of the previous iteration is kept
+    const CoinPackedMatrix* matrix = osiInterface->getMatrixByRow();
+
+    for(int i = numberOfPersistentRows; i < numberOfRows; i++)
+        solver->addRow(matrix->getVector(i), rowLowerBounds[i], rowUpperBounds[i]);
+
+    return (true);
+}
+
+void MIPSolverCbc::solvePersistentProblem()
+{
+    // The model, including the pseudo-costs of its branching objects, is kept between the iterations and only rebuilt
+    // if the variables of the problem have changed
+    if(!cbcModel || !isCbcModelPersistent || !updatePersistentModel())
+        createPersistentModel();
+
+    initializeSolverSettings();
+
+    cbcModel->setMaximumSeconds(std::min(this->timeLimit, env->cancellationToken->getRemainingTime()));
+    cbcModel->setNumberThreads(numberOfThreads % 100);
+    cbcModel->setThreadMode(numberOfThreads / 100);
+
+    cbcModel->solver()->setDblParam(OsiObjOffset, this->objectiveConstant);
+    osiInterface->setDblParam(OsiObjOffset, this->objectiveConstant);
+
+    // The solutions of the previous iteration may have been cut off by the added rows and cannot be used as cutoffs
+    cbcModel->deleteSolutions();
+    cbcModel->setCutoff(COIN_DBL_MAX);
+
+    passMIPStart();
+
+    TerminationEventHandler eventHandler(env);
+    cbcModel->passInEventHandler(&eventHandler);
+
+    // The event handler also stops the search when the token is cancelled, but only when a node is created
+    ScopedCancellationCallback cancelSolve(env->cancellationToken, [this] { cbcModel->sayEventHappened(); });
+
+    cbcModel->initialSolve();
+    cbcModel->branchAndBound();
+}
+
 bool MIPSolverCbc::repairInfeasibility()
 {
     if(env->dualSolver->generatedHyperplanes.size() == 0)
@@ -868,9 +1268,13 @@ bool MIPSolverCbc::repairInfeasibility()
 
         auto rowSense = osiInterface->getRowSense();
 
+        std::vector<bool> isInConflict;
+        bool useConflict = env->settings->getSetting<bool>("MIP.InfeasibilityRepair.UseConflict", "Dual")
+            && getConflictingConstraints(isInConflict);
+
         for(int i = numOrigConstraints; i < numCurrConstraints; i++)
         {
-            if(allowRepairOfConstraint[i])
+            if(allowRepairOfConstraint[i] && (!useConflict || isInConflict[i]))
             {
                 repairConstraints.push_back(i);
                 relaxParameters.push_back(1 / (((double)i) - numOrigConstraints + 1.0));
@@ -893,7 +1297,7 @@ bool MIPSolverCbc::repairInfeasibility()
                 env->settings->getSetting<std::string>("Debug.Path", "Output"),
                 env->results->getCurrentIteration()->iterationNumber - 1);
 
-            Utilities::saveVariablePointVectorToFile(relaxParameters, constraints, filename);
+            env->debugWriter->writePoint(relaxParameters, constraints, filename);
         }
 
         for(int i = 0; i < numConstraintsToRepair; i++)
@@ -936,6 +1340,8 @@ bool MIPSolverCbc::repairInfeasibility()
         }
 
         cbcModel = std::make_unique<CbcModel>(*repairedInterface);
+        isCbcModelPersistent = false;
+        isRelaxationSolvedByClp = false;
 
         initializeSolverSettings();
 
@@ -1144,6 +1550,7 @@ bool MIPSolverCbc::repairInfeasibility()
         env->output->outputDebug("        Number of constraints modified: " + std::to_string(numRepairs));
 
         cbcModel = std::make_unique<CbcModel>(*osiInterface);
+        isCbcModelPersistent = false;
 
         return (true);
     }
@@ -1155,6 +1562,59 @@ bool MIPSolverCbc::repairInfeasibility()
     return (false);
 }
 
+bool MIPSolverCbc::getConflictingConstraints(std::vector<bool>& isInConflict)
+{
+    try
+    {
+        auto relaxedInterface = std::unique_ptr<OsiSolverInterface>(osiInterface->clone());
+
+        for(int i = 0; i < relaxedInterface->getNumCols(); i++)
+            relaxedInterface->setContinuous(i);
+
+        // The rays are only available if the problem is not presolved
+        relaxedInterface->setHintParam(OsiDoPresolveInInitial, false, OsiHintDo);
+        relaxedInterface->setHintParam(OsiDoReducePrint, true, OsiHintTry);
+        relaxedInterface->initialSolve();
+
+        if(!relaxedInterface->isProvenPrimalInfeasible())
+            return (false);
+
+        auto rays = relaxedInterface->getDualRays(1);
+
+        if(rays.empty() || rays[0] == nullptr)
+            return (false);
+
+        int numRows = relaxedInterface->getNumRows();
+        int numConflicting = 0;
+
+        isInConflict.assign(numRows, false);
+
+        for(int i = 0; i < numRows; i++)
+        {
+            if(std::abs(rays[0][i]) > 1e-9)
+            {
+                isInConflict[i] = true;
+                numConflicting++;
+            }
+        }
+
+        for(auto& R : rays)
+            delete[] R;
+
+        env->output->outputDebug(
+            fmt::format("        Found {} rows in a Farkas certificate of the LP relaxation.", numConflicting));
+
+        return (numConflicting > 0);
+    }
+    catch(std::exception& e)
+    {
+        env->output->outputDebug(
+            fmt::format("        No Farkas certificate found for the LP relaxation: {}", e.what()));
+    }
+
+    return (false);
+}
+
 int MIPSolverCbc::increaseSolutionLimit(int increment)
 {
     this->solLimit += increment;
@@ -1178,6 +1638,19 @@ void MIPSolverCbc::setTimeLimit(double seconds)
         timeLimit = seconds;
 }
 
+void MIPSolverCbc::setRelativeGap(double gap)
+{
+    // The Cbc model is usually recreated for each solve, so the gap is also set in initializeSolverSettings()
+    relativeGap = gap;
+
+    if(cbcModel)
+        cbcModel->setAllowableFractionGap(gap);
+    env->output->outputDebug(fmt::format("        Setting relative MIP gap to {}.", gap));
+}
+
+// Not available in Cbc, but the cutoff has a similar effect when the dual bound reaches the primal bound
+void MIPSolverCbc::setDualBoundStop([[maybe_unused]] double bound) { }
+
 void MIPSolverCbc::setCutOff(double cutOff)
 {
     if(cutOff == SHOT_DBL_MAX || cutOff == SHOT_DBL_MIN)
@@ -1304,17 +1777,7 @@ double MIPSolverCbc::getObjectiveValue(int solIdx)
     try
     {
         auto variableSolution = getVariableSolution(solIdx);
-        double factor = (isMinimizationProblem) ? 1.0 : -1.0;
-
-        objectiveValue = factor * coinModel->objectiveOffset();
-
-        for(int i = 0; i < objectiveLinearExpression.getNumElements(); i++)
-        {
-            objectiveValue += factor * objectiveLinearExpression.getElements()[i]
-                * variableSolution[objectiveLinearExpression.getIndices()[i]];
-        }
-
-        objectiveValue += this->objectiveConstant;
+        objectiveValue = calculateObjectiveValue(variableSolution.data());
     }
     catch(std::exception& e)
     {
@@ -1326,11 +1789,25 @@ double MIPSolverCbc::getObjectiveValue(int solIdx)
     return (objectiveValue);
 }
 
+double MIPSolverCbc::calculateObjectiveValue(const double* point)
+{
+    double factor = (isMinimizationProblem) ? 1.0 : -1.0;
+    double objectiveValue = factor * coinModel->objectiveOffset();
+
+    for(int i = 0; i < objectiveLinearExpression.getNumElements(); i++)
+    {
+        objectiveValue
+            += factor * objectiveLinearExpression.getElements()[i] * point[objectiveLinearExpression.getIndices()[i]];
+    }
+
+    return (objectiveValue + this->objectiveConstant);
+}
+
 void MIPSolverCbc::deleteMIPStarts() { MIPStart.clear(); }
 
 bool MIPSolverCbc::createIntegerCut(IntegerCut& integerCut)
 {
-    assert(integerCut.variableValues.size() == (size_t)env->reformulatedProblem->properties.numberOfDiscreteVariables);
+    assert(integerCut.variableValues.size() == integerCut.variableIndexes.size());
     bool allowIntegerCutRepair = env->settings->getSetting<bool>("MIP.InfeasibilityRepair.IntegerCuts", "Dual");
 
     int numConstraintsBefore = osiInterface->getNumRows();
@@ -1350,33 +1827,22 @@ bool MIPSolverCbc::createIntegerCut(IntegerCut& integerCut)
     {
         if(integerCut.areAllVariablesBinary) // Integer cut for problem with binary variables only
         {
-            size_t index = 0;
-            CoinPackedVector cut;
+            auto terms = env->dualSolver->getBinaryIntegerCutTerms(integerCut);
 
-            for(auto& VAR : env->reformulatedProblem->allVariables)
+            if(!terms)
             {
-                if(!(VAR->properties.type == E_VariableType::Binary || VAR->properties.type == E_VariableType::Integer
-                       || VAR->properties.type == E_VariableType::Semiinteger))
-                    continue;
-
-                int variableValue = integerCut.variableValues[index];
+                env->output->outputDebug("        Integer cut not added by Cbc ");
+                return (false);
+            }
 
-                if(variableValue == 1.0)
-                    cut.insert(VAR->index, 1.0);
-                else if(variableValue == 0.0)
-                    cut.insert(VAR->index, -1.0);
-                else
-                {
-                    env->output->outputDebug("        Integer cut not added by Cbc ");
-                    return (false);
-                }
+            CoinPackedVector cut;
 
-                index++;
-            }
+            for(auto& T : terms->first)
+                cut.insert(T.first, T.second);
 
             int tmpNumConstraints = osiInterface->getNumRows();
 
-            osiInterface->addRow(cut, -osiInterface->getInfinity(), integerCut.variableValues.size() - 1.0,
+            osiInterface->addRow(cut, -osiInterface->getInfinity(), -terms->second,
                 fmt::format("IC_{}", env->solutionStatistics.numberOfIntegerCuts));
 
             if(osiInterface->getNumRows() > tmpNumConstraints)
@@ -1531,6 +1997,12 @@ bool MIPSolverCbc::createIntegerCut(IntegerCut& integerCut)
 
 VectorDouble MIPSolverCbc::getVariableSolution(int solIdx)
 {
+    if(isRelaxationSolvedByClp)
+    {
+        const double* values = osiInterface->getColSolution();
+        return (VectorDouble(values, values + osiInterface->getNumCols()));
+    }
+
     bool isMIP = getDiscreteVariableStatus();
     int numVar = cbcModel->getNumCols();
     VectorDouble solution(numVar);
@@ -1563,8 +2035,21 @@ VectorDouble MIPSolverCbc::getVariableSolution(int solIdx)
     return (solution);
 }
 
+VectorDouble MIPSolverCbc::getReducedCosts()
+{
+    // The relaxations solved by Cbc itself do not leave a usable LP solution in the solver interface
+    if(!isRelaxationSolvedByClp || !osiInterface->isProvenOptimal())
+        return (VectorDouble());
+
+    const double* values = osiInterface->getReducedCost();
+    return (VectorDouble(values, values + osiInterface->getNumCols()));
+}
+
 int MIPSolverCbc::getNumberOfSolutions()
 {
+    if(isRelaxationSolvedByClp)
+        return (osiInterface->isProvenOptimal() ? 1 : 0);
+
     int numSols = 0;
 
     try
@@ -1687,7 +2172,7 @@ double MIPSolverCbc::getDualObjectiveValue()
         {
             objVal = getObjectiveValue();
         }
-        else
+        else if(!isRelaxationSolvedByClp)
         {
             objVal = cbcModel->getBestPossibleObjValue();
         }
@@ -1718,6 +2203,9 @@ void MIPSolverCbc::checkParameters()
 
 int MIPSolverCbc::getNumberOfExploredNodes()
 {
+    if(isRelaxationSolvedByClp)
+        return (0);
+
     try
     {
         return (cbcModel->getNodeCount());
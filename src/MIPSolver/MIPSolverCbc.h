@@ -46,7 +46,7 @@ public:
     virtual int print();
 };
 
-class MIPSolverCbc : public IMIPSolver, MIPSolverBase
+class MIPSolverCbc : public IMIPSolver, public MIPSolverBase
 {
 public:
     MIPSolverCbc(EnvironmentPtr envPtr);
@@ -62,15 +62,23 @@ public:
     bool initializeObjective() override;
     bool addLinearTermToObjective(double coefficient, int variableIndex) override;
     bool addQuadraticTermToObjective(double coefficient, int firstVariableIndex, int secondVariableIndex) override;
+    bool addQuadraticTermsToObjective(const VectorDouble& coefficients, const VectorInteger& firstVariableIndexes,
+        const VectorInteger& secondVariableIndexes) override;
     bool finalizeObjective(bool isMinimize, double constant = 0.0) override;
+    bool replaceObjective(const std::map<int, double>& linearTerms, bool isMinimize) override;
 
     bool initializeConstraint() override;
     bool addLinearTermToConstraint(double coefficient, int variableIndex) override;
     bool addQuadraticTermToConstraint(double coefficient, int firstVariableIndex, int secondVariableIndex) override;
+    bool addQuadraticTermsToConstraint(const VectorDouble& coefficients, const VectorInteger& firstVariableIndexes,
+        const VectorInteger& secondVariableIndexes) override;
     bool finalizeConstraint(std::string name, double valueLHS, double valueRHS, double constant = 0.0) override;
 
     bool finalizeProblem() override;
 
+    void saveBaseProblem() override { MIPSolverBase::saveBaseProblem(); }
+    bool restoreBaseProblem() override { return (MIPSolverBase::restoreBaseProblem()); }
+
     void initializeSolverSettings() override;
 
     void writeProblemToFile(std::string filename) override;
@@ -90,19 +98,38 @@ public:
     int addLinearConstraint(const std::map<int, double>& elements, double constant, std::string name,
         bool isGreaterThan, bool allowRepair) override;
 
+    int addLinearConstraints(const LinearConstraintBlock& constraints) override;
+
+    bool removeLinearConstraints(const VectorInteger& constraintIndexes) override;
+
+    int getNumberOfConstraints() override;
+
     bool addSpecialOrderedSet(
         E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights = {}) override;
 
-    bool createHyperplane(Hyperplane hyperplane) override { return (MIPSolverBase::createHyperplane(hyperplane)); }
+    bool createHyperplane(const Hyperplane& hyperplane) override
+    {
+        return (MIPSolverBase::createHyperplane(hyperplane));
+    }
+
+    std::vector<bool> createHyperplanes(const std::vector<Hyperplane>& hyperplanes) override
+    {
+        return (MIPSolverBase::createHyperplanes(hyperplanes));
+    }
+
+    std::pair<int, int> manageHyperplaneCuts(const std::vector<SolutionPoint>& solutionPoints) override
+    {
+        return (MIPSolverBase::manageHyperplaneCuts(solutionPoints));
+    }
 
     bool createIntegerCut(IntegerCut& integerCut) override;
 
-    bool createInteriorHyperplane(Hyperplane hyperplane) override
+    bool createInteriorHyperplane(const Hyperplane& hyperplane) override
     {
         return (MIPSolverBase::createInteriorHyperplane(hyperplane));
     }
 
-    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(Hyperplane hyperplane) override
+    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(const Hyperplane& hyperplane) override
     {
         return (MIPSolverBase::createHyperplaneTerms(hyperplane));
     }
@@ -139,6 +166,7 @@ public:
     E_ProblemSolutionStatus getSolutionStatus() override;
     int getNumberOfSolutions() override;
     VectorDouble getVariableSolution(int solIdx) override;
+    VectorDouble getReducedCosts() override;
     std::vector<SolutionPoint> getAllVariableSolutions() override { return (MIPSolverBase::getAllVariableSolutions()); }
     double getDualObjectiveValue() override;
     double getObjectiveValue(int solIdx) override;
@@ -152,12 +180,17 @@ public:
 
     void setCutOff(double cutOff) override;
     void setCutOffAsConstraint(double cutOff) override;
+
+    void setRelativeGap(double gap) override;
+    void setDualBoundStop(double bound) override;
     void addMIPStart(VectorDouble point) override;
     void deleteMIPStarts() override;
 
     bool supportsQuadraticObjective() override;
     bool supportsQuadraticConstraints() override;
 
+    bool addFunctionConstraint(const UnivariateFunction&, int, std::string) override { return (false); }
+
     double getUnboundedVariableBoundValue() override;
 
     int getNumberOfExploredNodes() override;
@@ -185,7 +218,7 @@ public:
 
     std::string getSolverVersion() override;
 
-private:
+protected:
     std::unique_ptr<OsiClpSolverInterface> osiInterface;
     std::unique_ptr<CbcModel> cbcModel;
     std::unique_ptr<CoinModel> coinModel;
@@ -196,6 +229,7 @@ private:
     long int solLimit;
     double timeLimit = 1e100;
     double cutOff;
+    double relativeGap = NAN; // ObjectiveGap.Relative is used if not set with setRelativeGap()
     int numberOfThreads = 1;
     double objectiveConstant = 0.0;
 
@@ -203,6 +237,34 @@ private:
 
     std::vector<E_VariableType> variableTypes;
     std::vector<std::pair<int, std::array<double, 4>>> lotsizes;
+
+    // Marks the rows with a nonzero multiplier in a Farkas certificate of the infeasible LP relaxation, returns
+    // false if the relaxation is not proven infeasible or no certificate is given by Clp
+    bool getConflictingConstraints(std::vector<bool>& isInConflict);
+
+    // Whether cbcModel is kept between the iterations when Cbc.Persistent is enabled
+    bool isCbcModelPersistent = false;
+
+    // Whether the last problem was an LP problem solved directly in Clp when Cbc.RelaxationWarmStart is enabled, and
+    // whether Clp has a basis from a previous LP problem
+    bool isRelaxationSolvedByClp = false;
+    bool isClpWarmStarted = false;
+
+    void passMIPStart();
+    void addLotsizeObjects();
+
+    // The objective value of a point in the variable space of the MIP problem
+    double calculateObjectiveValue(const double* point);
+
+    // Sets temporary bounds on the variables that make the dual problem unbounded, returns true if any were changed
+    bool setTemporaryBoundsForUnboundedProblem(VectorInteger& variablesWithChangedBounds);
+
+    E_ProblemSolutionStatus solveRelaxedProblem();
+    E_ProblemSolutionStatus getRelaxedSolutionStatus();
+
+    void createPersistentModel();
+    bool updatePersistentModel();
+    void solvePersistentProblem();
 };
 
 } // namespace SHOT
\ No newline at end of file
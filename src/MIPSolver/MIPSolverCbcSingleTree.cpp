@@ -0,0 +1,480 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "MIPSolverCbcSingleTree.h"
+
+#include "../DualSolver.h"
+#include "../EventHandler.h"
+#include "../Iteration.h"
+#include "../Output.h"
+#include "../PrimalSolver.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../TaskHandler.h"
+#include "../Timing.h"
+#include "../Utilities.h"
+
+#include "../Model/Problem.h"
+
+#include "CbcModel.hpp"
+#include "CbcTree.hpp"
+#include "CglCutGenerator.hpp"
+#include "OsiAuxInfo.hpp"
+#include "OsiClpSolverInterface.hpp"
+#include "OsiCuts.hpp"
+#include "OsiRowCut.hpp"
+
+namespace SHOT
+{
+
+// Cbc clones the cut generators and event handlers it is given, so these only forward to the callback object
+class CbcLazyCutGenerator : public CglCutGenerator
+{
+public:
+    CbcLazyCutGenerator(CbcCallbackSingleTree* cbcCallback) : callback(cbcCallback) { }
+
+    CglCutGenerator* clone() const override { return new CbcLazyCutGenerator(callback); }
+
+    void generateCuts(const OsiSolverInterface& solver, OsiCuts& cuts, const CglTreeInfo info) override
+    {
+        callback->generateCuts(solver, cuts, info.level);
+    }
+
+    bool mayGenerateRowCutsInTree() const override { return (true); }
+
+private:
+    CbcCallbackSingleTree* callback;
+};
+
+class CbcEventHandlerSingleTree : public CbcEventHandler
+{
+public:
+    CbcEventHandlerSingleTree(CbcCallbackSingleTree* cbcCallback) : callback(cbcCallback) { }
+
+    CbcEventHandler* clone() const override { return new CbcEventHandlerSingleTree(callback); }
+
+    CbcAction event(CbcEvent whichEvent) override
+    {
+        if(whichEvent == CbcEventHandler::CbcEvent::node && callback->updateAtNode(model_))
+            return (CbcEventHandler::CbcAction::stop);
+
+        return (CbcEventHandler::CbcAction::noAction);
+    }
+
+private:
+    CbcCallbackSingleTree* callback;
+};
+
+MIPSolverCbcSingleTree::MIPSolverCbcSingleTree(EnvironmentPtr envPtr) : MIPSolverCbc(envPtr) { }
+
+MIPSolverCbcSingleTree::~MIPSolverCbcSingleTree() = default;
+
+void MIPSolverCbcSingleTree::initializeSolverSettings()
+{
+    MIPSolverCbc::initializeSolverSettings();
+
+    // The callback is not thread safe, and the solutions are limited by the cuts instead
+    numberOfThreads = 1;
+    cbcModel->setMaximumSolutions(SHOT_INT_MAX);
+}
+
+int MIPSolverCbcSingleTree::increaseSolutionLimit(int increment)
+{
+    solLimit = std::min((long)SHOT_INT_MAX, solLimit + increment);
+    return (solLimit);
+}
+
+void MIPSolverCbcSingleTree::setSolutionLimit(long limit) { solLimit = std::min((long)SHOT_INT_MAX, limit); }
+
+int MIPSolverCbcSingleTree::getSolutionLimit() { return (solLimit); }
+
+void MIPSolverCbcSingleTree::checkParameters() { }
+
+E_ProblemSolutionStatus MIPSolverCbcSingleTree::solveProblem()
+{
+    E_ProblemSolutionStatus MIPSolutionStatus;
+    cachedSolutionHasChanged = true;
+
+    try
+    {
+        if(!cbcCallback)
+            cbcCallback = std::make_unique<CbcCallbackSingleTree>(env);
+
+        // The model is set up as in the persistent mode, which does not use preprocessing. Preprocessing would remove
+        // rows and columns that are needed by the cuts added later on.
+        createPersistentModel();
+        isCbcModelPersistent = false;
+
+        initializeSolverSettings();
+        cbcModel->setMaximumSeconds(this->timeLimit);
+
+        // Tells Cbc that an integer solution is only feasible if the cut generators do not cut it off
+        OsiBabSolver solverCharacteristics(4);
+        cbcModel->solver()->setAuxiliaryInfo(&solverCharacteristics);
+
+        CbcLazyCutGenerator cutGenerator(cbcCallback.get());
+        cbcModel->addCutGenerator(&cutGenerator, 1, "SHOT", true, true);
+
+        CbcEventHandlerSingleTree eventHandler(cbcCallback.get());
+        cbcModel->passInEventHandler(&eventHandler);
+
+        cbcModel->solver()->setDblParam(OsiObjOffset, this->objectiveConstant);
+        osiInterface->setDblParam(OsiObjOffset, this->objectiveConstant);
+
+        passMIPStart();
+
+        cbcModel->initialSolve();
+        cbcModel->branchAndBound();
+        cbcCallback->stopIterationReporter();
+
+        MIPSolutionStatus = getSolutionStatus();
+    }
+    catch(std::exception& e)
+    {
+        env->output->outputError("        Error when solving subproblem with Cbc", e.what());
+        MIPSolutionStatus = E_ProblemSolutionStatus::Error;
+    }
+    catch(CoinError& e)
+    {
+        env->output->outputError("        Error when solving subproblem with Cbc", e.message());
+        MIPSolutionStatus = E_ProblemSolutionStatus::Error;
+    }
+
+    return (MIPSolutionStatus);
+}
+
+CbcCallbackSingleTree::CbcCallbackSingleTree(EnvironmentPtr envPtr)
+{
+    env = envPtr;
+
+    lastUpdatedPrimal = env->results->getPrimalBound();
+    isMinimization = env->reformulatedProblem->objectiveFunction->properties.isMinimize;
+
+    env->solutionStatistics.iterationLastLazyAdded = 0;
+
+    initializeCallbackTasks();
+    initializeRelaxedCutPolicy();
+}
+
+CbcCallbackSingleTree::~CbcCallbackSingleTree() = default;
+
+bool CbcCallbackSingleTree::updateAtNode(CbcModel* model)
+{
+    lastExploredNodes = model->getNodeCount();
+    lastOpenNodes = (model->tree() != nullptr) ? model->tree()->size() : 0;
+
+    // Check if better dual bound
+    double dualObjectiveBound = model->getBestPossibleObjValue();
+
+    if(!isMinimization)
+        dualObjectiveBound *= -1.0;
+
+    if((isMinimization && dualObjectiveBound > env->results->getCurrentDualBound())
+        || (!isMinimization && dualObjectiveBound < env->results->getCurrentDualBound()))
+    {
+        VectorDouble doubleSolution; // Empty since we have no point
+
+        DualSolution sol = { doubleSolution, E_DualSolutionSource::MIPSolverBound, dualObjectiveBound,
+            env->results->getCurrentIteration()->iterationNumber, false };
+        env->dualSolver->addDualSolutionCandidate(sol);
+    }
+
+    return (env->results->isAbsoluteObjectiveGapToleranceMet() || env->results->isRelativeObjectiveGapToleranceMet()
+        || checkIterationLimit() || checkUserTermination());
+}
+
+void CbcCallbackSingleTree::generateCuts(const OsiSolverInterface& solver, OsiCuts& cuts, int depth)
+{
+    generatedCuts = &cuts;
+
+    try
+    {
+        int numberOfVariables = (env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
+            ? solver.getNumCols() - 1
+            : solver.getNumCols();
+
+        const double* columnSolution = solver.getColSolution();
+        VectorDouble solution(columnSolution, columnSolution + numberOfVariables);
+
+        double integerTolerance = env->settings->getSetting<double>("Tolerance.Integer", "Primal");
+        bool isIntegerFeasible = true;
+
+        for(int i = 0; i < solver.getNumCols(); i++)
+        {
+            if(solver.isInteger(i) && std::abs(columnSolution[i] - std::round(columnSolution[i])) > integerTolerance)
+            {
+                isIntegerFeasible = false;
+                break;
+            }
+        }
+
+        if(isIntegerFeasible)
+        {
+            auto MIPSolver = static_cast<MIPSolverCbcSingleTree*>(env->dualSolver->MIPSolver.get());
+            addIntegerSolution(solution, MIPSolver->calculateObjectiveValue(columnSolution));
+        }
+        else
+        {
+            addRelaxedSolution(solution, depth);
+        }
+    }
+    catch(std::exception& e)
+    {
+        env->output->outputError("        Error when generating lazy constraints in Cbc", e.what());
+    }
+
+    generatedCuts = nullptr;
+}
+
+void CbcCallbackSingleTree::addRelaxedSolution(const VectorDouble& solution, int depth)
+{
+    if(env->results->getCurrentIteration()->relaxedLazyHyperplanesAdded
+        >= env->settings->getSetting<int>("Relaxation.MaxLazyConstraints", "Dual"))
+        return;
+
+    int waitingListSize = env->dualSolver->hyperplaneWaitingList.size();
+
+    SolutionPoint solutionRelaxed;
+
+    if(env->problem->properties.numberOfNonlinearConstraints > 0)
+    {
+        auto maxDev = env->reformulatedProblem->getMaxNumericConstraintValue(
+            solution, env->reformulatedProblem->nonlinearConstraints);
+        solutionRelaxed.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
+    }
+    else
+    {
+        solutionRelaxed.maxDeviation = PairIndexValue(-1, 0.0);
+    }
+
+    solutionRelaxed.point = solution;
+    solutionRelaxed.objectiveValue = env->reformulatedProblem->objectiveFunction->calculateValue(solution);
+    solutionRelaxed.iterFound = env->results->getCurrentIteration()->iterationNumber;
+    solutionRelaxed.isRelaxedPoint = true;
+
+    // Cbc calls the cut generator from one thread
+    if(!relaxedCutPolicy.shouldSeparate(solutionRelaxed, depth, 0, env->timing->getElapsedTime("Total")))
+        return;
+
+    selectHyperplanePoints({ solutionRelaxed });
+
+    env->results->getCurrentIteration()->relaxedLazyHyperplanesAdded
+        += (env->dualSolver->hyperplaneWaitingList.size() - waitingListSize);
+}
+
+void CbcCallbackSingleTree::addIntegerSolution(const VectorDouble& solution, double objectiveValue)
+{
+    auto currIter = env->results->getCurrentIteration();
+
+    if(currIter->isSolved)
+    {
+        env->results->createIteration();
+        currIter = env->results->getCurrentIteration();
+        currIter->isDualProblemDiscrete = true;
+        currIter->dualProblemClass = env->dualSolver->MIPSolver->getProblemClass();
+    }
+
+    // The point is a primal candidate in the variable space of the original problem
+    VectorDouble primalSolution(solution.begin(), solution.begin() + env->problem->properties.numberOfVariables);
+    double primalObjectiveValue = env->problem->objectiveFunction->calculateValue(primalSolution);
+
+    if((isMinimization && primalObjectiveValue < env->results->getPrimalBound())
+        || (!isMinimization && primalObjectiveValue > env->results->getPrimalBound()))
+    {
+        SolutionPoint primalPoint;
+
+        if(env->problem->properties.numberOfNonlinearConstraints > 0)
+        {
+            auto maxDev
+                = env->problem->getMaxNumericConstraintValue(primalSolution, env->problem->nonlinearConstraints);
+            primalPoint.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
+        }
+        else
+        {
+            primalPoint.maxDeviation = PairIndexValue(-1, 0.0);
+        }
+
+        primalPoint.iterFound = currIter->iterationNumber;
+        primalPoint.objectiveValue = primalObjectiveValue;
+        primalPoint.point = primalSolution;
+
+        env->primalSolver->addPrimalSolutionCandidate(primalPoint, E_PrimalSolutionSource::MIPCallback);
+    }
+
+    SolutionPoint solutionCandidate;
+
+    if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        auto maxDev = env->reformulatedProblem->getMaxNumericConstraintValue(
+            solution, env->reformulatedProblem->nonlinearConstraints);
+
+        solutionCandidate.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
+    }
+    else
+    {
+        solutionCandidate.maxDeviation = PairIndexValue(-1, 0.0);
+    }
+
+    solutionCandidate.point = solution;
+    solutionCandidate.objectiveValue = objectiveValue;
+    solutionCandidate.iterFound = currIter->iterationNumber;
+
+    std::vector<SolutionPoint> candidatePoints { solutionCandidate };
+
+    addLazyConstraint(candidatePoints);
+
+    currIter->maxDeviation = solutionCandidate.maxDeviation.value;
+    currIter->maxDeviationConstraint = solutionCandidate.maxDeviation.index;
+    currIter->solutionStatus = E_ProblemSolutionStatus::Feasible;
+    currIter->objectiveValue = objectiveValue;
+
+    currIter->numberOfExploredNodes = lastExploredNodes - env->solutionStatistics.numberOfExploredNodes;
+    env->solutionStatistics.numberOfExploredNodes = lastExploredNodes;
+    currIter->numberOfOpenNodes = lastOpenNodes;
+
+    auto bounds = std::make_pair(env->results->getCurrentDualBound(), env->results->getPrimalBound());
+    currIter->currentObjectiveBounds = bounds;
+
+    if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        taskSelectPrimalSolutionFromRootsearch.get()->run(candidatePoints);
+        env->primalSolver->checkPrimalSolutionCandidates();
+    }
+
+    if(checkFixedNLPStrategy(candidatePoints.at(0)))
+    {
+        if(taskSelectPrimNLPOriginal)
+        {
+            env->primalSolver->addFixedNLPCandidate(candidatePoints.at(0).point, E_PrimalNLPSource::FirstSolution,
+                objectiveValue, currIter->iterationNumber, candidatePoints.at(0).maxDeviation);
+
+            taskSelectPrimNLPOriginal->run();
+            env->primalSolver->fixedPrimalNLPCandidates.clear();
+        }
+
+        if(taskSelectPrimNLPReformulated)
+        {
+            env->primalSolver->addFixedNLPCandidate(candidatePoints.at(0).point, E_PrimalNLPSource::FirstSolution,
+                objectiveValue, currIter->iterationNumber, candidatePoints.at(0).maxDeviation);
+
+            taskSelectPrimNLPReformulated->run();
+            env->primalSolver->fixedPrimalNLPCandidates.clear();
+        }
+
+        env->primalSolver->checkPrimalSolutionCandidates();
+    }
+
+    if(env->settings->getSetting<bool>("HyperplaneCuts.UseIntegerCuts", "Dual"))
+    {
+        int addedIntegerCuts = 0;
+
+        for(auto& IC : env->dualSolver->integerCutWaitingList)
+        {
+            if(this->createIntegerCut(IC))
+            {
+                env->dualSolver->addGeneratedIntegerCut(IC);
+                addedIntegerCuts++;
+            }
+        }
+
+        if(addedIntegerCuts > 0)
+            env->output->outputDebug("        Added {} integer cut(s)", addedIntegerCuts);
+
+        env->dualSolver->integerCutWaitingList.clear();
+    }
+
+    currIter->isSolved = true;
+
+    printIterationReport(candidatePoints.at(0));
+}
+
+bool CbcCallbackSingleTree::createHyperplane(const Hyperplane& hyperplane)
+{
+    auto cutTerms = createCutTerms(hyperplane);
+
+    if(!cutTerms)
+        return (false);
+
+    auto tmpPair = std::move(cutTerms.value());
+
+    VectorInteger indexes;
+    VectorDouble coefficients;
+
+    indexes.reserve(tmpPair.first.size());
+    coefficients.reserve(tmpPair.first.size());
+
+    for(auto& P : tmpPair.first)
+    {
+        indexes.push_back(P.first);
+        coefficients.push_back(P.second);
+    }
+
+    OsiRowCut cut;
+    cut.setRow(indexes.size(), indexes.data(), coefficients.data());
+    cut.setLb(-COIN_DBL_MAX);
+    cut.setUb(-tmpPair.second);
+    cut.setGloballyValid(true);
+
+    generatedCuts->insert(cut);
+
+    env->dualSolver->addGeneratedHyperplane(hyperplane);
+
+    return (true);
+}
+
+bool CbcCallbackSingleTree::createIntegerCut(IntegerCut& integerCut)
+{
+    if(!integerCut.areAllVariablesBinary)
+    {
+        env->output->outputDebug("        Integer cut for nonbinary variables not supported in single-tree strategy.");
+        return (false);
+    }
+
+    auto terms = env->dualSolver->getBinaryIntegerCutTerms(integerCut);
+
+    if(!terms)
+        return (false);
+
+    VectorInteger indexes;
+    VectorDouble coefficients;
+    indexes.reserve(terms->first.size());
+    coefficients.reserve(terms->first.size());
+
+    for(auto& T : terms->first)
+    {
+        indexes.push_back(T.first);
+        coefficients.push_back(T.second);
+    }
+
+    OsiRowCut cut;
+    cut.setRow(indexes.size(), indexes.data(), coefficients.data());
+    cut.setLb(-COIN_DBL_MAX);
+    cut.setUb(-terms->second);
+    cut.setGloballyValid(true);
+
+    generatedCuts->insert(cut);
+
+    return (true);
+}
+
+void CbcCallbackSingleTree::addLazyConstraint(const std::vector<SolutionPoint>& candidatePoints)
+{
+    selectHyperplanePoints(candidatePoints);
+
+    for(auto& hp : env->dualSolver->hyperplaneWaitingList)
+    {
+        if(this->createHyperplane(hp))
+            this->lastNumAddedHyperplanes++;
+    }
+
+    env->dualSolver->hyperplaneWaitingList.clear();
+}
+} // namespace SHOT
@@ -0,0 +1,73 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "MIPSolverBase.h"
+#include "MIPSolverCbc.h"
+#include "MIPSolverCallbackBase.h"
+
+class OsiSolverInterface;
+class OsiCuts;
+
+namespace SHOT
+{
+
+// Cbc has no lazy constraint callback, instead the hyperplanes are added by a cut generator that is called at every
+// node and at every integer solution found. A solution that is cut off by the generated cuts is rejected by Cbc.
+class CbcCallbackSingleTree : public MIPSolverCallbackBase
+{
+public:
+    CbcCallbackSingleTree(EnvironmentPtr envPtr);
+    ~CbcCallbackSingleTree() override;
+
+    // The depth is the level of the node in the tree
+    void generateCuts(const OsiSolverInterface& solver, OsiCuts& cuts, int depth);
+
+    // Returns true if Cbc should terminate
+    bool updateAtNode(CbcModel* model);
+
+private:
+    int lastExploredNodes = 0;
+    int lastOpenNodes = 0;
+
+    OsiCuts* generatedCuts = nullptr;
+
+    bool createHyperplane(const Hyperplane& hyperplane);
+
+    bool createIntegerCut(IntegerCut& integerCut);
+
+    void addLazyConstraint(const std::vector<SolutionPoint>& candidatePoints);
+
+    void addRelaxedSolution(const VectorDouble& solution, int depth);
+    void addIntegerSolution(const VectorDouble& solution, double objectiveValue);
+};
+
+class MIPSolverCbcSingleTree : public MIPSolverCbc
+{
+public:
+    MIPSolverCbcSingleTree(EnvironmentPtr envPtr);
+    ~MIPSolverCbcSingleTree() override;
+
+    void checkParameters() override;
+
+    void initializeSolverSettings() override;
+
+    int increaseSolutionLimit(int increment) override;
+    void setSolutionLimit(long limit) override;
+    int getSolutionLimit() override;
+
+    E_ProblemSolutionStatus solveProblem() override;
+
+    using MIPSolverCbc::calculateObjectiveValue;
+
+private:
+    std::unique_ptr<CbcCallbackSingleTree> cbcCallback;
+};
+} // namespace SHOT
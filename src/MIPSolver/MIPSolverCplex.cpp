@@ -10,16 +10,21 @@
 
 #include "MIPSolverCplex.h"
 
+#include "../CancellationToken.h"
+#include "../DebugWriter.h"
 #include "../DualSolver.h"
 #include "../Iteration.h"
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 
 #include "../Model/Problem.h"
 
+#include <algorithm>
+
 namespace SHOT
 {
 
@@ -111,6 +116,7 @@ bool MIPSolverCplex::initializeProblem()
 
     cachedSolutionHasChanged = true;
     isVariablesFixed = false;
+    useNames = env->settings->getSetting<bool>("MIP.UseNames", "Dual");
     modelUpdated = false;
 
     checkParameters();
@@ -121,6 +127,9 @@ bool MIPSolverCplex::initializeProblem()
 bool MIPSolverCplex::addVariable(
     std::string name, E_VariableType type, double lowerBound, double upperBound, double semiBound)
 {
+    if(!useNames)
+        name.clear();
+
     if(lowerBound < -getUnboundedVariableBoundValue())
         lowerBound = -getUnboundedVariableBoundValue();
 
@@ -231,6 +240,43 @@ bool MIPSolverCplex::addQuadraticTermToObjective(double coefficient, int firstVa
     return (true);
 }
 
+bool MIPSolverCplex::addQuadraticTermsToObjective(const VectorDouble& coefficients,
+    const VectorInteger& firstVariableIndexes, const VectorInteger& secondVariableIndexes)
+{
+    if(coefficients.size() == 0)
+        return (true);
+
+    try
+    {
+        // The coefficients are set directly in a separate expression, so the terms of the same variables are combined
+        std::map<std::pair<int, int>, double> terms;
+
+        for(size_t k = 0; k < coefficients.size(); k++)
+        {
+            auto variables = std::minmax(firstVariableIndexes[k], secondVariableIndexes[k]);
+            terms[{ variables.first, variables.second }] += coefficients[k];
+        }
+
+        IloExpr quadraticExpression(cplexEnv);
+
+        for(auto& [V, C] : terms)
+            quadraticExpression.setQuadCoef(cplexVars[V.first], cplexVars[V.second], C);
+
+        objExpression += quadraticExpression;
+        quadraticExpression.end();
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError(
+            "        Cplex exception caught when adding quadratic terms to objective: ", e.getMessage());
+        return (false);
+    }
+
+    hasQuadraticObjective = true;
+
+    return (true);
+}
+
 bool MIPSolverCplex::finalizeObjective(bool isMinimize, double constant)
 {
     try
@@ -263,6 +309,35 @@ bool MIPSolverCplex::finalizeObjective(bool isMinimize, double constant)
     return (true);
 }
 
+bool MIPSolverCplex::replaceObjective(const std::map<int, double>& linearTerms, bool isMinimize)
+{
+    try
+    {
+        IloExpr expression(cplexEnv);
+
+        for(auto& T : linearTerms)
+            expression += T.second * cplexVars[T.first];
+
+        cplexObjectiveExpression = expression;
+
+        // Modifying the extracted objective keeps the current basis in Cplex
+        auto objective = cplexInstance.getObjective();
+        objective.setExpr(cplexObjectiveExpression);
+        objective.setSense(isMinimize ? IloObjective::Minimize : IloObjective::Maximize);
+
+        isMinimizationProblem = isMinimize;
+        hasQuadraticObjective = false;
+        cachedSolutionHasChanged = true;
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Cplex exception caught when replacing objective function: ", e.getMessage());
+        return (false);
+    }
+
+    return (true);
+}
+
 bool MIPSolverCplex::initializeConstraint()
 {
     try
@@ -313,8 +388,48 @@ bool MIPSolverCplex::addQuadraticTermToConstraint(double coefficient, int firstV
     return (true);
 }
 
+bool MIPSolverCplex::addQuadraticTermsToConstraint(const VectorDouble& coefficients,
+    const VectorInteger& firstVariableIndexes, const VectorInteger& secondVariableIndexes)
+{
+    if(coefficients.size() == 0)
+        return (true);
+
+    try
+    {
+        // The coefficients are set directly in a separate expression, so the terms of the same variables are combined
+        std::map<std::pair<int, int>, double> terms;
+
+        for(size_t k = 0; k < coefficients.size(); k++)
+        {
+            auto variables = std::minmax(firstVariableIndexes[k], secondVariableIndexes[k]);
+            terms[{ variables.first, variables.second }] += coefficients[k];
+        }
+
+        IloExpr quadraticExpression(cplexEnv);
+
+        for(auto& [V, C] : terms)
+            quadraticExpression.setQuadCoef(cplexVars[V.first], cplexVars[V.second], C);
+
+        constrExpression += quadraticExpression;
+        quadraticExpression.end();
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError(
+            "        Cplex exception caught when adding quadratic terms to constraint: ", e.getMessage());
+        return (false);
+    }
+
+    hasQudraticConstraint = true;
+
+    return (true);
+}
+
 bool MIPSolverCplex::finalizeConstraint(std::string name, double valueLHS, double valueRHS, double constant)
 {
+    if(!useNames)
+        name.clear();
+
     try
     {
         if(constant != 0.0)
@@ -472,7 +587,7 @@ void MIPSolverCplex::initializeSolverSettings()
             IloCplex::Param::Parallel, env->settings->getSetting<int>("Cplex.ParallelMode", "Subsolver"));
 
         // Set number of threads
-        cplexInstance.setParam(IloCplex::Param::Threads, env->settings->getSetting<int>("MIP.NumberOfThreads", "Dual"));
+        cplexInstance.setParam(IloCplex::Param::Threads, ThreadPlacement::getNumberOfMIPThreads(env->settings));
 
         // Options for using swap file
         if(auto workdir = env->settings->getSetting<std::string>("Cplex.WorkDirectory", "Subsolver"); workdir != "")
@@ -497,6 +612,9 @@ void MIPSolverCplex::initializeSolverSettings()
 int MIPSolverCplex::addLinearConstraint(
     const std::map<int, double>& elements, double constant, std::string name, bool isGreaterThan, bool allowRepair)
 {
+    if(!useNames)
+        name.clear();
+
     try
     {
         int numConstraintsBefore = cplexInstance.getNrows();
@@ -557,9 +675,97 @@ int MIPSolverCplex::addLinearConstraint(
         return (-1);
     }
 
-    return (cplexInstance.getNrows() - 1);
+    // The index in cplexConstrs, which differs from the row index if there are quadratic constraints
+    return (cplexConstrs.getSize() - 1);
+}
+
+int MIPSolverCplex::addLinearConstraints(const LinearConstraintBlock& constraints)
+{
+    try
+    {
+        int numConstraintsBefore = cplexInstance.getNrows();
+        int firstConstraintIndex = cplexConstrs.getSize();
+        int numConstraints = constraints.size();
+
+        IloRangeArray ranges(cplexEnv);
+
+        for(int i = 0; i < numConstraints; i++)
+        {
+            IloExpr expr(cplexEnv);
+
+            for(int j = constraints.rowStarts[i]; j < constraints.rowStarts[i + 1]; j++)
+                expr += constraints.coefficients[j] * cplexVars[constraints.variableIndexes[j]];
+
+            IloRange tmpRange(cplexEnv, -IloInfinity, expr, -constraints.constants[i]);
+
+            if(useNames)
+                tmpRange.setName(constraints.names[i].c_str());
+
+            ranges.add(tmpRange);
+
+            expr.end();
+        }
+
+        cplexModel.add(ranges);
+        cplexInstance.extract(cplexModel);
+
+        // Make sure that Cplex actually has added the constraints
+        if(cplexInstance.getNrows() != numConstraintsBefore + numConstraints)
+        {
+            env->output->outputDebug("        Hyperplanes not added by Cplex");
+            ranges.endElements();
+            ranges.end();
+            return (-1);
+        }
+
+        cplexConstrs.add(ranges);
+
+        for(int i = 0; i < numConstraints; i++)
+            allowRepairOfConstraint.push_back(constraints.allowRepair[i]);
+
+        ranges.end();
+
+        return (firstConstraintIndex);
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Error when adding linear constraints", e.getMessage());
+    }
+
+    return (-1);
 }
 
+bool MIPSolverCplex::removeLinearConstraints(const VectorInteger& constraintIndexes)
+{
+    if(constraintIndexes.size() == 0)
+        return (true);
+
+    try
+    {
+        for(auto I = constraintIndexes.rbegin(); I != constraintIndexes.rend(); I++)
+        {
+            cplexModel.remove(cplexConstrs[*I]);
+            cplexConstrs[*I].end();
+            cplexConstrs.remove(*I);
+        }
+
+        // Extracted directly, since the number of rows is used when adding constraints
+        cplexInstance.extract(cplexModel);
+        modelUpdated = false;
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Error when removing linear constraints", e.getMessage());
+        return (false);
+    }
+
+    updateConstraintIndexesAfterRemoval(constraintIndexes);
+    return (true);
+}
+
+// The constraints are indexed as in cplexConstrs, which also contains the quadratic constraints that are not rows
+int MIPSolverCplex::getNumberOfConstraints() { return (cplexConstrs.getSize()); }
+
 bool MIPSolverCplex::addSpecialOrderedSet(E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights)
 {
     try
@@ -757,6 +963,28 @@ E_ProblemSolutionStatus MIPSolverCplex::getSolutionStatus()
     return (MIPSolutionStatus);
 }
 
+void MIPSolverCplex::solveCplexInstance()
+{
+    // A new aborter is used in each call, since the instance may have been recreated after the previous one
+    IloCplex::Aborter aborter(cplexEnv);
+    cplexInstance.use(aborter);
+
+    try
+    {
+        ScopedCancellationCallback cancelSolve(env->cancellationToken, [&aborter] { aborter.abort(); });
+        cplexInstance.solve();
+    }
+    catch(IloException&)
+    {
+        cplexInstance.remove(aborter);
+        aborter.end();
+        throw;
+    }
+
+    cplexInstance.remove(aborter);
+    aborter.end();
+}
+
 E_ProblemSolutionStatus MIPSolverCplex::solveProblem()
 {
     E_ProblemSolutionStatus MIPSolutionStatus;
@@ -791,7 +1019,7 @@ E_ProblemSolutionStatus MIPSolverCplex::solveProblem()
             // Fixes a deadlock bug in Cplex 12.7 and 12.8
             cplexEnv.setNormalizer(false);
 
-            cplexInstance.solve();
+            solveCplexInstance();
             MIPSolutionStatus = MIPSolverCplex::getSolutionStatus();
         }
         else
@@ -804,7 +1032,7 @@ E_ProblemSolutionStatus MIPSolverCplex::solveProblem()
             // Fixes a deadlock bug in Cplex 12.7 and 12.8
             cplexEnv.setNormalizer(false);
 
-            cplexInstance.solve();
+            solveCplexInstance();
             MIPSolutionStatus = getSolutionStatus();
         }
 
@@ -820,7 +1048,7 @@ E_ProblemSolutionStatus MIPSolverCplex::solveProblem()
                 cplexModel.add(IloMaximize(cplexEnv, 0.0));
 
             cplexInstance.extract(cplexModel);
-            cplexInstance.solve();
+            solveCplexInstance();
             MIPSolutionStatus = getSolutionStatus();
 
             if(MIPSolutionStatus == E_ProblemSolutionStatus::Optimal)
@@ -918,7 +1146,7 @@ bool MIPSolverCplex::repairInfeasibility()
                 env->settings->getSetting<std::string>("Debug.Path", "Output"),
                 env->results->getCurrentIteration()->iterationNumber - 1);
 
-            Utilities::saveVariablePointVectorToFile(weights, constraints, filename);
+            env->debugWriter->writePoint(weights, constraints, filename);
         }
 
         if(cplexInstance.feasOpt(cplexConstrs, relax))
@@ -1071,6 +1299,36 @@ VectorDouble MIPSolverCplex::getVariableSolution(int solIdx)
     return (solution);
 }
 
+VectorDouble MIPSolverCplex::getReducedCosts()
+{
+    VectorDouble reducedCosts;
+
+    if((getDiscreteVariableStatus() && isProblemDiscrete)
+        || getSolutionStatus() != E_ProblemSolutionStatus::Optimal)
+        return (reducedCosts);
+
+    IloNumArray tmpReducedCosts(cplexEnv);
+
+    try
+    {
+        cplexInstance.getReducedCosts(tmpReducedCosts, cplexVars);
+
+        int numVar = cplexVars.getSize();
+        reducedCosts.resize(numVar);
+
+        for(int i = 0; i < numVar; i++)
+            reducedCosts[i] = tmpReducedCosts[i];
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Error when reading reduced costs", e.getMessage());
+        reducedCosts.clear();
+    }
+
+    tmpReducedCosts.end();
+    return (reducedCosts);
+}
+
 int MIPSolverCplex::getNumberOfSolutions()
 {
     int numSols = 0;
@@ -1157,6 +1415,22 @@ void MIPSolverCplex::setTimeLimit(double seconds)
     }
 }
 
+void MIPSolverCplex::setRelativeGap(double gap)
+{
+    try
+    {
+        cplexInstance.setParam(IloCplex::Param::MIP::Tolerances::MIPGap, gap);
+        env->output->outputDebug(fmt::format("        Setting relative MIP gap to {}.", gap));
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Error when setting relative gap", e.getMessage());
+    }
+}
+
+// Not available in Cplex, but the cutoff has a similar effect when the dual bound reaches the primal bound
+void MIPSolverCplex::setDualBoundStop([[maybe_unused]] double bound) { }
+
 void MIPSolverCplex::setCutOff(double cutOff)
 {
     try
@@ -1533,7 +1807,7 @@ void MIPSolverCplex::writePresolvedToFile([[maybe_unused]] std::string filename)
 void MIPSolverCplex::checkParameters() { }
 
 bool MIPSolverCplex::createHyperplane(
-    Hyperplane hyperplane, std::function<IloConstraint(IloRange)> addConstraintFunction)
+    const Hyperplane& hyperplane, std::function<IloConstraint(IloRange)> addConstraintFunction)
 {
     auto currIter = env->results->getCurrentIteration(); // The unsolved new iteration
 
@@ -1645,8 +1919,8 @@ bool MIPSolverCplex::createIntegerCut(IntegerCut& integerCut)
                 if(cplexInstance.getNrows() > tmpNumConstraints)
                 {
                     cplexInstance.extract(cplexModel);
-                    integerCuts.push_back(numConstraintsBefore + index);
                     cplexConstrs.add(cut1);
+                    integerCuts.push_back(cplexConstrs.getSize() - 1);
                     allowRepairOfConstraint.push_back(false);
                 }
 
@@ -1658,8 +1932,8 @@ bool MIPSolverCplex::createIntegerCut(IntegerCut& integerCut)
                 if(cplexInstance.getNrows() > tmpNumConstraints)
                 {
                     cplexInstance.extract(cplexModel);
-                    integerCuts.push_back(numConstraintsBefore + index);
                     cplexConstrs.add(cut2);
+                    integerCuts.push_back(cplexConstrs.getSize() - 1);
                     allowRepairOfConstraint.push_back(false);
                 }
 
@@ -1671,8 +1945,8 @@ bool MIPSolverCplex::createIntegerCut(IntegerCut& integerCut)
                 if(cplexInstance.getNrows() > tmpNumConstraints)
                 {
                     cplexInstance.extract(cplexModel);
-                    integerCuts.push_back(numConstraintsBefore + index);
                     cplexConstrs.add(cut3);
+                    integerCuts.push_back(cplexConstrs.getSize() - 1);
                     allowRepairOfConstraint.push_back(false);
                 }
 
@@ -1684,8 +1958,8 @@ bool MIPSolverCplex::createIntegerCut(IntegerCut& integerCut)
                 if(cplexInstance.getNrows() > tmpNumConstraints)
                 {
                     cplexInstance.extract(cplexModel);
-                    integerCuts.push_back(numConstraintsBefore + index);
                     cplexConstrs.add(cut4);
+                    integerCuts.push_back(cplexConstrs.getSize() - 1);
                     allowRepairOfConstraint.push_back(false);
                 }
             }
@@ -1701,8 +1975,8 @@ bool MIPSolverCplex::createIntegerCut(IntegerCut& integerCut)
         if(cplexInstance.getNrows() > tmpNumConstraints)
         {
             cplexInstance.extract(cplexModel);
-            integerCuts.push_back(numConstraintsBefore + index);
             cplexConstrs.add(cut5);
+            integerCuts.push_back(cplexConstrs.getSize() - 1);
             allowRepairOfConstraint.push_back(allowIntegerCutRepair);
         }
 
@@ -54,15 +54,23 @@ public:
     bool initializeObjective() override;
     bool addLinearTermToObjective(double coefficient, int variableIndex) override;
     bool addQuadraticTermToObjective(double coefficient, int firstVariableIndex, int secondVariableIndex) override;
+    bool addQuadraticTermsToObjective(const VectorDouble& coefficients, const VectorInteger& firstVariableIndexes,
+        const VectorInteger& secondVariableIndexes) override;
     bool finalizeObjective(bool isMinimize, double constant = 0.0) override;
+    bool replaceObjective(const std::map<int, double>& linearTerms, bool isMinimize) override;
 
     bool initializeConstraint() override;
     bool addLinearTermToConstraint(double coefficient, int variableIndex) override;
     bool addQuadraticTermToConstraint(double coefficient, int firstVariableIndex, int secondVariableIndex) override;
+    bool addQuadraticTermsToConstraint(const VectorDouble& coefficients, const VectorInteger& firstVariableIndexes,
+        const VectorInteger& secondVariableIndexes) override;
     bool finalizeConstraint(std::string name, double valueLHS, double valueRHS, double constant = 0.0) override;
 
     bool finalizeProblem() override;
 
+    void saveBaseProblem() override { MIPSolverBase::saveBaseProblem(); }
+    bool restoreBaseProblem() override { return (MIPSolverBase::restoreBaseProblem()); }
+
     void initializeSolverSettings() override;
 
     void writeProblemToFile(std::string filename) override;
@@ -82,21 +90,41 @@ public:
     int addLinearConstraint(const std::map<int, double>& elements, double constant, std::string name,
         bool isGreaterThan, bool allowRepair) override;
 
+    int addLinearConstraints(const LinearConstraintBlock& constraints) override;
+
+    bool removeLinearConstraints(const VectorInteger& constraintIndexes) override;
+
+    int getNumberOfConstraints() override;
+
     bool addSpecialOrderedSet(
         E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights = {}) override;
 
-    bool createHyperplane(Hyperplane hyperplane) override { return (MIPSolverBase::createHyperplane(hyperplane)); }
+    bool createHyperplane(const Hyperplane& hyperplane) override
+    {
+        return (MIPSolverBase::createHyperplane(hyperplane));
+    }
+
+    std::vector<bool> createHyperplanes(const std::vector<Hyperplane>& hyperplanes) override
+    {
+        return (MIPSolverBase::createHyperplanes(hyperplanes));
+    }
+
+    std::pair<int, int> manageHyperplaneCuts(const std::vector<SolutionPoint>& solutionPoints) override
+    {
+        return (MIPSolverBase::manageHyperplaneCuts(solutionPoints));
+    }
 
     bool createIntegerCut(IntegerCut& integerCut) override;
 
-    virtual bool createHyperplane(Hyperplane hyperplane, std::function<IloConstraint(IloRange)> addConstraintFunction);
+    virtual bool createHyperplane(
+        const Hyperplane& hyperplane, std::function<IloConstraint(IloRange)> addConstraintFunction);
 
-    bool createInteriorHyperplane(Hyperplane hyperplane) override
+    bool createInteriorHyperplane(const Hyperplane& hyperplane) override
     {
         return (MIPSolverBase::createInteriorHyperplane(hyperplane));
     }
 
-    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(Hyperplane hyperplane) override
+    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(const Hyperplane& hyperplane) override
     {
         return (MIPSolverBase::createHyperplaneTerms(hyperplane));
     }
@@ -133,6 +161,7 @@ public:
     E_ProblemSolutionStatus getSolutionStatus() override;
     int getNumberOfSolutions() override;
     VectorDouble getVariableSolution(int solIdx) override;
+    VectorDouble getReducedCosts() override;
     std::vector<SolutionPoint> getAllVariableSolutions() override { return (MIPSolverBase::getAllVariableSolutions()); }
     double getDualObjectiveValue() override;
     double getObjectiveValue(int solIdx) override;
@@ -148,12 +177,17 @@ public:
 
     void setCutOffAsConstraint(double cutOff) override;
 
+    void setRelativeGap(double gap) override;
+    void setDualBoundStop(double bound) override;
+
     void addMIPStart(VectorDouble point) override;
     void deleteMIPStarts() override;
 
     bool supportsQuadraticObjective() override;
     bool supportsQuadraticConstraints() override;
 
+    bool addFunctionConstraint(const UnivariateFunction&, int, std::string) override { return (false); }
+
     double getUnboundedVariableBoundValue() override;
 
     int getNumberOfExploredNodes() override;
@@ -192,6 +226,9 @@ private:
 protected:
     IloEnv cplexEnv;
 
+    // Solves the instance, which is aborted if the cancellation token of the environment is cancelled meanwhile
+    void solveCplexInstance();
+
     IloNumVarArray cplexVars;
     IloRangeArray cplexConstrs;
     IloExpr cplexObjectiveExpression;
@@ -76,12 +76,54 @@ CplexCallback::CplexCallback(EnvironmentPtr envPtr, const IloNumVarArray& vars,
     lastUpdatedPrimal = env->results->getPrimalBound();
 
     isMinimization = env->reformulatedProblem->objectiveFunction->properties.isMinimize;
+
+    shareCuts = env->settings->getSetting<bool>("TreeStrategy.Single.ShareCuts", "Dual");
+
+    numberOfDualVariables = (env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
+        ? cplexVars.getSize() - 1
+        : cplexVars.getSize();
+
+    if(env->settings->getSetting<bool>("TreeStrategy.Single.SpatialBranching.Use", "Dual"))
+    {
+        spatialBranching = std::make_unique<SpatialBranching>(
+            env->settings->getSetting<double>("TreeStrategy.Single.SpatialBranching.Tolerance", "Dual"));
+        spatialBranching->addTerms(*env->reformulatedProblem);
+
+        if(!spatialBranching->hasTerms())
+            spatialBranching.reset();
+    }
+
+    initializeBackgroundPrimalWorker();
+    initializeRelaxedCutPolicy();
+
+    // The hyperplanes are created by the callback threads at the same time
+    for(auto& C : env->reformulatedProblem->numericConstraints)
+        C->initializeGradientCalculation();
 }
 
 void CplexCallback::invoke(const IloCplex::Callback::Context& context)
 {
+    TraceScope traceScope(env->traceRecorder.get(), "CplexCallback");
+
     try
     {
+        if(context.getId() == IloCplex::Callback::Context::Id::ThreadUp)
+        {
+            getThreadContext(context);
+            return;
+        }
+
+        if(context.getId() == IloCplex::Callback::Context::Id::ThreadDown)
+        {
+            removeThreadContext(context);
+            return;
+        }
+
+        auto& threadContext = getThreadContext(context);
+
+        threadContext.numberOfExploredNodes = std::max(threadContext.numberOfExploredNodes,
+            (int)context.getIntInfo(IloCplex::Callback::Context::Info::NodeCount));
+
         // Check if better dual bound
         double tmpDualObjBound = context.getDoubleInfo(IloCplex::Callback::Context::Info::BestBound);
 
@@ -106,27 +148,13 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                 && ((isMinimization && tmpPrimalObjBound < env->results->getPrimalBound())
                     || (!isMinimization && tmpPrimalObjBound > env->results->getPrimalBound())))
             {
-                IloNumArray tmpPrimalVals(context.getEnv());
-
-                context.getCandidatePoint(cplexVars, tmpPrimalVals);
-
-                int numberOfVariables = env->problem->properties.numberOfVariables;
-
-                VectorDouble primalSolution(numberOfVariables);
-
-                for(int i = 0; i < numberOfVariables; i++)
-                {
-                    primalSolution.at(i) = tmpPrimalVals[i];
-                }
-
-                tmpPrimalVals.end();
-
                 SolutionPoint tmpPt;
+                getCallbackPoint(context, false, env->problem->properties.numberOfVariables, tmpPt.point);
 
                 if(env->problem->properties.numberOfNonlinearConstraints > 0)
                 {
                     auto maxDev = env->problem->getMaxNumericConstraintValue(
-                        primalSolution, env->problem->nonlinearConstraints);
+                        tmpPt.point, env->problem->nonlinearConstraints);
                     tmpPt.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
                 }
                 else
@@ -137,8 +165,7 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                 std::lock_guard<std::mutex> lock(callbackMutex);
 
                 tmpPt.iterFound = env->results->getCurrentIteration()->iterationNumber;
-                tmpPt.objectiveValue = env->problem->objectiveFunction->calculateValue(primalSolution);
-                tmpPt.point = primalSolution;
+                tmpPt.objectiveValue = env->problem->objectiveFunction->calculateValue(tmpPt.point);
 
                 env->primalSolver->addPrimalSolutionCandidate(tmpPt, E_PrimalSolutionSource::MIPCallback);
             }
@@ -151,6 +178,12 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
             return;
         }
 
+        if(context.getId() == IloCplex::Callback::Context::Id::Branching)
+        {
+            branchOnBilinearTerm(context);
+            return;
+        }
+
         if(context.inRelaxation())
         {
             int numberOfAddedHyperplanes;
@@ -162,33 +195,26 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                 iterationNumber = env->results->getCurrentIteration()->iterationNumber;
             }
 
+            if(shareCuts)
+                addSharedCuts(context);
+
+            if(spatialBranching)
+                addLocalEnvelopes(context);
+
             if(numberOfAddedHyperplanes < env->settings->getSetting<int>("Relaxation.MaxLazyConstraints", "Dual"))
             {
                 int waitingListSize = env->dualSolver->hyperplaneWaitingList.size();
 
-                IloNumArray tmpVals(context.getEnv());
+                // The point is extracted directly into the vector given to the tasks
+                std::vector<SolutionPoint> solutionPoints(1);
+                auto& solutionRelaxed = solutionPoints[0];
 
-                context.getRelaxationPoint(cplexVars, tmpVals);
-
-                int numberOfVariables = (env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
-                    ? tmpVals.getSize() - 1
-                    : tmpVals.getSize();
-
-                VectorDouble solution(numberOfVariables);
-
-                for(int i = 0; i < numberOfVariables; i++)
-                {
-                    solution.at(i) = tmpVals[i];
-                }
-
-                tmpVals.end();
-
-                SolutionPoint solutionRelaxed;
+                getCallbackPoint(context, true, numberOfDualVariables, solutionRelaxed.point);
 
                 if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
                 {
                     auto maxDev = env->reformulatedProblem->getMaxNumericConstraintValue(
-                        solution, env->reformulatedProblem->nonlinearConstraints);
+                        solutionRelaxed.point, env->reformulatedProblem->nonlinearConstraints);
                     solutionRelaxed.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
                 }
                 else
@@ -196,15 +222,20 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                     solutionRelaxed.maxDeviation = PairIndexValue(-1, 0.0);
                 }
 
-                solutionRelaxed.point = solution;
                 solutionRelaxed.objectiveValue = context.getRelaxationObjective();
                 solutionRelaxed.iterFound = iterationNumber;
                 solutionRelaxed.isRelaxedPoint = true;
 
-                std::vector<SolutionPoint> solutionPoints = { solutionRelaxed };
-
+                if(relaxedCutPolicy.shouldSeparate(solutionRelaxed,
+                       context.getIntInfo(IloCplex::Callback::Context::Info::NodeDepth),
+                       context.getIntInfo(IloCplex::Callback::Context::Info::ThreadId),
+                       env->timing->getElapsedTime("Total")))
                 {
                     std::lock_guard<std::mutex> lock(callbackMutex);
+
+                    // The time waiting for the mutex is seen as the gap to the start of the callback in the timeline
+                    TraceScope lockedScope(env->traceRecorder.get(), "CplexCallbackHyperplanes");
+
                     if(static_cast<ES_HyperplaneCutStrategy>(env->settings->getSetting<int>("CutStrategy", "Dual"))
                         == ES_HyperplaneCutStrategy::ESH)
                     {
@@ -237,9 +268,14 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                 currIter = env->results->getCurrentIteration();
             }
 
-            std::vector<SolutionPoint> candidatePoints;
+            std::vector<SolutionPoint> candidatePoints(1);
+            auto& solutionCandidate = candidatePoints[0];
 
-            std::lock_guard<std::mutex> lock(callbackMutex);
+            // Extracted before locking the mutex, all threads use their own point
+            getCallbackPoint(context, false, numberOfDualVariables, solutionCandidate.point);
+
+            std::unique_lock<std::mutex> lock(callbackMutex);
+            TraceScope lockedScope(env->traceRecorder.get(), "CplexCallbackCandidate");
 
             if(currIter->isSolved)
             {
@@ -249,29 +285,10 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                 currIter->dualProblemClass = env->dualSolver->MIPSolver->getProblemClass();
             }
 
-            IloNumArray tmpVals(context.getEnv());
-
-            context.getCandidatePoint(cplexVars, tmpVals);
-
-            int numberOfVariables = (env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
-                ? tmpVals.getSize() - 1
-                : tmpVals.getSize();
-
-            VectorDouble solution(numberOfVariables);
-
-            for(int i = 0; i < numberOfVariables; i++)
-            {
-                solution.at(i) = tmpVals[i];
-            }
-
-            tmpVals.end();
-
-            SolutionPoint solutionCandidate;
-
             if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
             {
                 auto maxDev = env->reformulatedProblem->getMaxNumericConstraintValue(
-                    solution, env->reformulatedProblem->nonlinearConstraints);
+                    solutionCandidate.point, env->reformulatedProblem->nonlinearConstraints);
 
                 solutionCandidate.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
             }
@@ -280,13 +297,11 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                 solutionCandidate.maxDeviation = PairIndexValue(-1, 0.0);
             }
 
-            solutionCandidate.point = solution;
             solutionCandidate.objectiveValue = context.getCandidateObjective();
             solutionCandidate.iterFound = env->results->getCurrentIteration()->iterationNumber;
 
-            candidatePoints.push_back(solutionCandidate);
-
-            addLazyConstraint(candidatePoints, context);
+            addLazyConstraint(candidatePoints, context, lock);
+            threadContext.numberOfCandidates++;
 
             currIter->maxDeviation = solutionCandidate.maxDeviation.value;
             currIter->maxDeviationConstraint = solutionCandidate.maxDeviation.index;
@@ -295,14 +310,13 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
 
             currIter->numberOfOpenNodes = cplexInst.getNnodesLeft();
             env->solutionStatistics.numberOfExploredNodes
-                = std::max(context.getIntInfo(IloCplex::Callback::Context::Info::NodeCount),
-                    env->solutionStatistics.numberOfExploredNodes);
+                = std::max(threadContext.numberOfExploredNodes, env->solutionStatistics.numberOfExploredNodes);
 
             auto bounds = std::make_pair(env->results->getCurrentDualBound(), env->results->getPrimalBound());
             currIter->currentObjectiveBounds = bounds;
 
             if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
-                && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+                && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0 && !useBackgroundPrimalWorker)
             {
                 taskSelectPrimalSolutionFromRootsearch->run(candidatePoints);
                 env->primalSolver->checkPrimalSolutionCandidates();
@@ -310,10 +324,16 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
 
             currIter->isSolved = true;
 
-            auto threadId = std::to_string(context.getIntInfo(IloCplex::Callback::Context::Info::ThreadId));
+            int threadId = context.getIntInfo(IloCplex::Callback::Context::Info::ThreadId);
             printIterationReport(candidatePoints.at(0), threadId);
 
-            if(checkFixedNLPStrategy(candidatePoints.at(0)))
+            bool solveFixedNLP = checkFixedNLPStrategy(candidatePoints.at(0));
+
+            if(useBackgroundPrimalWorker)
+            {
+                addBackgroundPrimalCandidate(candidatePoints.at(0), solveFixedNLP);
+            }
+            else if(solveFixedNLP)
             {
 
                 if(taskSelectPrimNLPOriginal)
@@ -353,35 +373,28 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
                 }
 
                 if(addedIntegerCuts > 0)
-                    env->output->outputDebug(fmt::format("        Added {} integer cut(s)", addedIntegerCuts));
+                    env->output->outputDebug("        Added {} integer cut(s)", addedIntegerCuts);
 
                 env->dualSolver->integerCutWaitingList.clear();
             }
         }
 
-        // Add current primal solution as new incumbent candidate
-        auto primalBound = env->results->getPrimalBound();
+        // Posts the best primal solution found by any thread, heuristic solutions can only be posted in relaxations
+        VectorDouble primalSolution;
+        double primalObjectiveValue;
 
-        if((isMinimization && lastUpdatedPrimal < primalBound) || (!isMinimization && lastUpdatedPrimal > primalBound))
+        if(context.inRelaxation() && getPrimalSolutionToInject(primalSolution, primalObjectiveValue))
         {
-            auto primalSol = env->results->primalSolution;
-
             IloNumArray tmpVals(context.getEnv());
 
-            if((int)primalSol.size() < env->reformulatedProblem->properties.numberOfVariables)
-                env->reformulatedProblem->augmentAuxiliaryVariableValues(primalSol);
-
-            if(env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
-                primalSol.push_back(env->reformulatedProblem->objectiveFunction->calculateValue(primalSol));
+            assert(cplexVars.getSize() == primalSolution.size());
 
-            assert(cplexVars.getSize() == primalSol.size());
-
-            for(double S : primalSol)
+            for(double S : primalSolution)
                 tmpVals.add(S);
 
             try
             {
-                context.postHeuristicSolution(cplexVars, tmpVals, env->results->currentPrimalBound,
+                context.postHeuristicSolution(cplexVars, tmpVals, primalObjectiveValue,
                     IloCplex::Callback::Context::SolutionStrategy::CheckFeasible);
             }
             catch(IloException& e)
@@ -392,8 +405,6 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
             }
 
             tmpVals.end();
-
-            lastUpdatedPrimal = env->results->getPrimalBound();
         }
     }
     catch(IloException& e)
@@ -403,11 +414,86 @@ void CplexCallback::invoke(const IloCplex::Callback::Context& context)
 }
 
 /// Destructor
-CplexCallback::~CplexCallback() = default;
+CplexCallback::~CplexCallback()
+{
+    // The contexts of threads for which Cplex did not invoke ThreadDown
+    for(auto& [threadId, threadContext] : threadContexts)
+        threadContext->values.end();
+}
+
+CplexCallback::ThreadContext& CplexCallback::getThreadContext(const IloCplex::Callback::Context& context)
+{
+    int threadId = context.getIntInfo(IloCplex::Callback::Context::Info::ThreadId);
+
+    {
+        std::shared_lock<std::shared_mutex> lock(threadContextsMutex);
+        auto threadContext = threadContexts.find(threadId);
+
+        if(threadContext != threadContexts.end())
+            return (*threadContext->second);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(threadContextsMutex);
+    auto& threadContext = threadContexts[threadId];
+
+    if(!threadContext)
+    {
+        threadContext = std::make_unique<ThreadContext>();
+
+        // Allocated with the full size so that Cplex does not need to grow it
+        threadContext->values = IloNumArray(context.getEnv(), cplexVars.getSize());
+    }
+
+    return (*threadContext);
+}
+
+void CplexCallback::removeThreadContext(const IloCplex::Callback::Context& context)
+{
+    int threadId = context.getIntInfo(IloCplex::Callback::Context::Info::ThreadId);
+    std::unique_ptr<ThreadContext> threadContext;
+
+    {
+        std::unique_lock<std::shared_mutex> lock(threadContextsMutex);
+        auto found = threadContexts.find(threadId);
+
+        if(found == threadContexts.end())
+            return;
+
+        threadContext = std::move(found->second);
+        threadContexts.erase(found);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(callbackMutex);
+        env->solutionStatistics.numberOfExploredNodes
+            = std::max(threadContext->numberOfExploredNodes, env->solutionStatistics.numberOfExploredNodes);
+    }
+
+    env->output->outputTrace("        Cplex thread {} ended after {} candidates and {} created hyperplanes", threadId,
+        threadContext->numberOfCandidates, threadContext->numberOfCreatedHyperplanes);
+
+    threadContext->values.end();
+}
 
-bool CplexCallback::createHyperplane(Hyperplane hyperplane, const IloCplex::Callback::Context& context)
+void CplexCallback::getCallbackPoint(
+    const IloCplex::Callback::Context& context, bool isRelaxationPoint, int numberOfVariables, VectorDouble& point)
+{
+    auto& values = getThreadContext(context).values;
+
+    if(isRelaxationPoint)
+        context.getRelaxationPoint(cplexVars, values);
+    else
+        context.getCandidatePoint(cplexVars, values);
+
+    point.resize(numberOfVariables);
+
+    for(int i = 0; i < numberOfVariables; i++)
+        point[i] = values[i];
+}
+
+bool CplexCallback::createHyperplane(
+    const Hyperplane& hyperplane, const IloCplex::Callback::Context& context, int threadId)
 {
-    auto currIter = env->results->getCurrentIteration(); // The unsolved new iteration
     auto optionalHyperplanes = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane);
 
     if(!optionalHyperplanes)
@@ -415,7 +501,7 @@ bool CplexCallback::createHyperplane(Hyperplane hyperplane, const IloCplex::Call
         return (false);
     }
 
-    auto tmpPair = optionalHyperplanes.value();
+    auto tmpPair = std::move(optionalHyperplanes.value());
 
     for(auto& E : tmpPair.first)
     {
@@ -461,12 +547,9 @@ bool CplexCallback::createHyperplane(Hyperplane hyperplane, const IloCplex::Call
 
         context.rejectCandidate(tmpRange);
 
-        std::string identifier = env->dualSolver->MIPSolver->getConstraintIdentifier(hyperplane.source);
-
-        if(hyperplane.sourceConstraint != nullptr)
-            identifier = identifier + "_" + hyperplane.sourceConstraint->name;
-
-        env->dualSolver->addGeneratedHyperplane(hyperplane);
+        // Cuts for nonconvex constraints are not necessarily valid in the other parts of the tree
+        if(shareCuts && hyperplane.isSourceConvex)
+            cutPool.add(tmpPair.first, tmpPair.second, threadId);
 
         tmpRange.end();
         expr.end();
@@ -488,33 +571,19 @@ bool CplexCallback::createIntegerCut(IntegerCut& integerCut, const IloCplex::Cal
         return (false);
     }
 
+    auto terms = env->dualSolver->getBinaryIntegerCutTerms(integerCut);
+
+    if(!terms)
+        return (false);
+
     try
     {
         IloExpr expr(context.getEnv());
-        size_t index = 0;
 
-        for(auto& VAR : env->reformulatedProblem->allVariables)
-        {
-            if(!(VAR->properties.type == E_VariableType::Binary || VAR->properties.type == E_VariableType::Integer
-                   || VAR->properties.type == E_VariableType::Semiinteger))
-                continue;
-
-            int variableValue = integerCut.variableValues[index];
-            auto variable = cplexVars[VAR->index];
+        for(auto& T : terms->first)
+            expr += T.second * cplexVars[T.first];
 
-            if(variableValue == VAR->upperBound)
-            {
-                expr += (variableValue - variable);
-            }
-            else if(variableValue == VAR->lowerBound)
-            {
-                expr += variable;
-            }
-
-            index++;
-        }
-
-        IloRange tmpRange(context.getEnv(), 1, expr, IloInfinity,
+        IloRange tmpRange(context.getEnv(), -IloInfinity, expr, -terms->second,
             fmt::format("IC{}", env->solutionStatistics.numberOfIntegerCuts).c_str());
 
         context.rejectCandidate(tmpRange);
@@ -531,8 +600,119 @@ bool CplexCallback::createIntegerCut(IntegerCut& integerCut, const IloCplex::Cal
     return (true);
 }
 
-void CplexCallback::addLazyConstraint(
-    std::vector<SolutionPoint> candidatePoints, const IloCplex::Callback::Context& context)
+void CplexCallback::getLocalBounds(
+    const IloCplex::Callback::Context& context, VectorDouble& lowerBounds, VectorDouble& upperBounds)
+{
+    lowerBounds.resize(numberOfDualVariables);
+    upperBounds.resize(numberOfDualVariables);
+
+    for(int i = 0; i < numberOfDualVariables; i++)
+    {
+        lowerBounds[i] = context.getLocalLB(cplexVars[i]);
+        upperBounds[i] = context.getLocalUB(cplexVars[i]);
+    }
+}
+
+void CplexCallback::addLocalEnvelopes(const IloCplex::Callback::Context& context)
+{
+    try
+    {
+        VectorDouble point, lowerBounds, upperBounds;
+
+        getCallbackPoint(context, true, numberOfDualVariables, point);
+        getLocalBounds(context, lowerBounds, upperBounds);
+
+        auto envelopes = spatialBranching->getViolatedEnvelopes(point, lowerBounds, upperBounds);
+
+        for(auto& C : envelopes)
+        {
+            IloExpr expr(context.getEnv());
+
+            for(auto& T : C.terms)
+                expr += T.second * cplexVars[T.first];
+
+            IloRange tmpRange(context.getEnv(), -IloInfinity, expr, C.rhs);
+
+            // Only valid in the subtree of the node
+            context.addUserCut(tmpRange, IloCplex::UseCutPurge, true);
+
+            tmpRange.end();
+            expr.end();
+        }
+
+        if(envelopes.size() > 0)
+            env->output->outputTrace("        Added {} local McCormick envelopes", envelopes.size());
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Cplex error when adding local McCormick envelopes", e.getMessage());
+    }
+}
+
+void CplexCallback::branchOnBilinearTerm(const IloCplex::Callback::Context& context)
+{
+    try
+    {
+        VectorDouble point, lowerBounds, upperBounds;
+
+        getCallbackPoint(context, true, numberOfDualVariables, point);
+        getLocalBounds(context, lowerBounds, upperBounds);
+
+        auto branch = spatialBranching->selectBranch(point, lowerBounds, upperBounds);
+
+        if(branch.variableIndex < 0)
+            return;
+
+        double estimate = context.getRelaxationObjective();
+
+        context.makeBranch(cplexVars[branch.variableIndex], branch.value, IloCplex::BranchDown, estimate);
+        context.makeBranch(cplexVars[branch.variableIndex], branch.value, IloCplex::BranchUp, estimate);
+
+        env->output->outputTrace("        Spatial branching on variable {} at {}",
+            env->reformulatedProblem->getVariable(branch.variableIndex)->name, branch.value);
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Cplex error when branching on a bilinear term", e.getMessage());
+    }
+}
+
+void CplexCallback::addSharedCuts(const IloCplex::Callback::Context& context)
+{
+    int threadId = context.getIntInfo(IloCplex::Callback::Context::Info::ThreadId);
+
+    auto sharedCuts = cutPool.getNewCuts(threadId);
+
+    if(sharedCuts.empty())
+        return;
+
+    try
+    {
+        for(auto& C : sharedCuts)
+        {
+            IloExpr expr(context.getEnv());
+
+            for(auto& T : C.terms)
+                expr += T.second * cplexVars[T.first];
+
+            IloRange tmpRange(context.getEnv(), -IloInfinity, expr, -C.constant);
+
+            context.addUserCut(tmpRange, IloCplex::UseCutPurge, false);
+
+            tmpRange.end();
+            expr.end();
+        }
+
+        env->output->outputTrace("        Added {} cuts from other threads in thread {}", sharedCuts.size(), threadId);
+    }
+    catch(IloException& e)
+    {
+        env->output->outputError("        Cplex error when adding shared cuts", e.getMessage());
+    }
+}
+
+void CplexCallback::addLazyConstraint(const std::vector<SolutionPoint>& candidatePoints,
+    const IloCplex::Callback::Context& context, std::unique_lock<std::mutex>& lock)
 {
     try
     {
@@ -557,16 +737,39 @@ void CplexCallback::addLazyConstraint(
             taskSelectHPPtsByObjectiveRootsearch->run(candidatePoints);
         }
 
-        for(auto& hp : env->dualSolver->hyperplaneWaitingList)
+        // The waiting list is swapped with the cleared staging list of the thread, so that neither is reallocated
+        auto& threadContext = getThreadContext(context);
+        auto& hyperplanes = threadContext.stagedHyperplanes;
+
+        hyperplanes.clear();
+        std::swap(hyperplanes, env->dualSolver->hyperplaneWaitingList);
+
+        int threadId = context.getIntInfo(IloCplex::Callback::Context::Info::ThreadId);
+        threadContext.isCreated.assign(hyperplanes.size(), false);
+
+        // The cuts are created without the lock, so that the gradients are calculated by all threads at the same time
+        lock.unlock();
+
+        for(size_t k = 0; k < hyperplanes.size(); k++)
+            threadContext.isCreated[k] = this->createHyperplane(hyperplanes[k], context, threadId);
+
+        lock.lock();
+
+        for(size_t k = 0; k < hyperplanes.size(); k++)
         {
-            if(this->createHyperplane(hp, context))
-                this->lastNumAddedHyperplanes++;
-        }
+            if(!threadContext.isCreated[k])
+                continue;
 
-        env->dualSolver->hyperplaneWaitingList.clear();
+            env->dualSolver->addGeneratedHyperplane(hyperplanes[k]);
+            this->lastNumAddedHyperplanes++;
+            threadContext.numberOfCreatedHyperplanes++;
+        }
     }
     catch(IloException& e)
     {
+        if(!lock.owns_lock())
+            lock.lock();
+
         env->output->outputError("        Cplex error when invoking general lazy callback", e.getMessage());
     }
 }
@@ -638,7 +841,7 @@ E_ProblemSolutionStatus MIPSolverCplexSingleTree::solveProblem()
             // Fixes a deadlock bug in Cplex 12.7 and 12.8
             cplexEnv.setNormalizer(false);
 
-            cplexInstance.solve();
+            solveCplexInstance();
             MIPSolutionStatus = MIPSolverCplex::getSolutionStatus();
         }
         else
@@ -648,18 +851,21 @@ E_ProblemSolutionStatus MIPSolverCplexSingleTree::solveProblem()
             contextMask |= IloCplex::Callback::Context::Id::Relaxation;
             // contextMask |= IloCplex::Callback::Context::Id::GlobalProgress;
             // contextMask |= IloCplex::Callback::Context::Id::LocalProgress;
-            // contextMask |= IloCplex::Callback::Context::Id::ThreadUp;
-            // contextMask |= IloCplex::Callback::Context::Id::ThreadDown;
+            contextMask |= IloCplex::Callback::Context::Id::ThreadUp;
+            contextMask |= IloCplex::Callback::Context::Id::ThreadDown;
 
             CplexCallback cCallback(env, cplexVars, cplexInstance);
 
+            if(cCallback.usesSpatialBranching())
+                contextMask |= IloCplex::Callback::Context::Id::Branching;
+
             if(contextMask != 0)
                 cplexInstance.use(&cCallback, contextMask);
 
             // Fixes a deadlock bug in Cplex 12.7 and 12.8
             cplexEnv.setNormalizer(false);
 
-            cplexInstance.solve();
+            solveCplexInstance();
             MIPSolutionStatus = MIPSolverCplex::getSolutionStatus();
         }
 
@@ -675,7 +881,7 @@ E_ProblemSolutionStatus MIPSolverCplexSingleTree::solveProblem()
 
             cplexInstance.extract(cplexModel);
 
-            cplexInstance.solve();
+            solveCplexInstance();
             MIPSolutionStatus = getSolutionStatus();
 
             if(MIPSolutionStatus == E_ProblemSolutionStatus::Optimal)
@@ -11,8 +11,12 @@
 #pragma once
 #include "MIPSolverCplex.h"
 #include "MIPSolverCallbackBase.h"
+#include "SpatialBranching.h"
 
+#include <map>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
 
 #ifdef __GNUC__
 #pragma GCC diagnostic ignored "-Wignored-attributes"
@@ -48,7 +52,6 @@ class CplexCallback : public IloCplex::Callback::Function, public MIPSolverCallb
 {
 
 private:
-    std::mutex callbackMutex;
     /* Empty constructor is forbidden. */
     CplexCallback() = delete;
 
@@ -58,14 +61,68 @@ private:
     IloNumVarArray cplexVars;
     IloCplex cplexInst;
 
-    bool createHyperplane(Hyperplane hyperplane, const IloCplex::Callback::Context& context);
+    bool shareCuts = true;
+
+    // The number of variables in the points, without the auxiliary objective variable
+    int numberOfDualVariables = 0;
+
+    // The state of a Cplex worker thread, created in the ThreadUp context and removed in ThreadDown. The threads
+    // extract the points into their own buffer and stage the created cuts without the callback mutex, and the
+    // statistics are only merged into the environment when the thread publishes a candidate or ends.
+    struct ThreadContext
+    {
+        IloNumArray values; // The relaxation or candidate point of the callback, allocated once per thread
+
+        // The hyperplanes taken from the waiting list for the current candidate, and whether they were created
+        std::vector<Hyperplane> stagedHyperplanes;
+        std::vector<bool> isCreated;
+
+        int numberOfExploredNodes = 0; // The largest node count seen by the thread
+        int numberOfCandidates = 0;
+        int numberOfCreatedHyperplanes = 0;
+    };
+
+    std::map<int, std::unique_ptr<ThreadContext>> threadContexts;
+    std::shared_mutex threadContextsMutex;
+
+    // Returns the context of the thread of the callback, which is created here if Cplex has not invoked ThreadUp
+    ThreadContext& getThreadContext(const IloCplex::Callback::Context& context);
+
+    // Merges the statistics of the thread and frees its buffers
+    void removeThreadContext(const IloCplex::Callback::Context& context);
+
+    // Copies the candidate or relaxation point of the context into the given point
+    void getCallbackPoint(
+        const IloCplex::Callback::Context& context, bool isRelaxationPoint, int numberOfVariables, VectorDouble& point);
+
+    // Not created if spatial branching is not used or there are no continuous bilinear terms
+    std::unique_ptr<SpatialBranching> spatialBranching;
+
+    // Copies the bounds of the variables in the current node
+    void getLocalBounds(const IloCplex::Callback::Context& context, VectorDouble& lowerBounds,
+        VectorDouble& upperBounds);
+
+    // Adds the McCormick envelopes over the bounds of the node that are violated by the relaxation point as local cuts
+    void addLocalEnvelopes(const IloCplex::Callback::Context& context);
+
+    // Splits the node on a variable in the most violated bilinear term, otherwise Cplex branches as usual
+    void branchOnBilinearTerm(const IloCplex::Callback::Context& context);
+
+    bool createHyperplane(const Hyperplane& hyperplane, const IloCplex::Callback::Context& context, int threadId);
     bool createIntegerCut(IntegerCut& integerCut, const IloCplex::Callback::Context& context);
 
 public:
     /* Constructor with data */
     CplexCallback(EnvironmentPtr envPtr, const IloNumVarArray& vars, const IloCplex& inst);
 
-    void addLazyConstraint(std::vector<SolutionPoint> candidatePoints, const IloCplex::Callback::Context& context);
+    // Called with the callback mutex locked, which is released while the cuts are created
+    void addLazyConstraint(const std::vector<SolutionPoint>& candidatePoints,
+        const IloCplex::Callback::Context& context, std::unique_lock<std::mutex>& lock);
+
+    bool usesSpatialBranching() const { return (spatialBranching != nullptr); }
+
+    // Adds the cuts created by the other threads as user cuts
+    void addSharedCuts(const IloCplex::Callback::Context& context);
 
     // This is the function that we have to implement and that Cplex will call
     // during the solution process at the places that we asked for.
@@ -174,18 +174,16 @@ void InfoCallbackI::main() // Called at each node...
 
     if(env->results->isRelativeObjectiveGapToleranceMet())
     {
-        env->output->outputDebug(
-            "        Terminated by relative objective gap tolerance in info callback: " + Utilities::toString(relObjGap)
-            + " < " + Utilities::toString(env->settings->getSetting<double>("ObjectiveGap.Relative", "Termination")));
+        env->output->outputDebug("        Terminated by relative objective gap tolerance in info callback: {} < {}",
+            relObjGap, env->settings->getSetting<double>("ObjectiveGap.Relative", "Termination"));
 
         this->abort();
         return;
     }
     else if(env->results->isAbsoluteObjectiveGapToleranceMet())
     {
-        env->output->outputDebug(
-            "        Terminated by absolute objective gap tolerance in info callback: " + Utilities::toString(absObjGap)
-            + " < " + Utilities::toString(env->settings->getSetting<double>("ObjectiveGap.Absolute", "Termination")));
+        env->output->outputDebug("        Terminated by absolute objective gap tolerance in info callback: {} < {}",
+            absObjGap, env->settings->getSetting<double>("ObjectiveGap.Absolute", "Termination"));
 
         this->abort();
         return;
@@ -368,7 +366,7 @@ void CtCallbackI::main()
 
     candidatePoints.at(0) = solutionCandidate;
 
-    auto threadId = std::to_string(this->getMyThreadNum());
+    int threadId = this->getMyThreadNum();
 
     currIter->maxDeviation = solutionCandidate.maxDeviation.value;
     currIter->maxDeviationConstraint = solutionCandidate.maxDeviation.index;
@@ -509,7 +507,7 @@ void CtCallbackI::main()
         }
 
         if(addedIntegerCuts > 0)
-            env->output->outputDebug(fmt::format("        Added {} integer cut(s)", addedIntegerCuts));
+            env->output->outputDebug("        Added {} integer cut(s)", addedIntegerCuts);
 
         env->dualSolver->integerCutWaitingList.clear();
     }
@@ -518,7 +516,7 @@ void CtCallbackI::main()
     solution.clear();
 }
 
-bool CtCallbackI::createHyperplane(Hyperplane hyperplane)
+bool CtCallbackI::createHyperplane(const Hyperplane& hyperplane)
 {
     auto optional = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane);
 
@@ -612,32 +610,19 @@ bool CtCallbackI::createIntegerCut(IntegerCut& integerCut)
         return (false);
     }
 
+    auto terms = env->dualSolver->getBinaryIntegerCutTerms(integerCut);
+
+    if(!terms)
+        return (false);
+
     try
     {
         IloExpr expr(this->getEnv());
-        size_t index = 0;
-
-        for(auto& VAR : env->reformulatedProblem->allVariables)
-        {
-            if(!(VAR->properties.type == E_VariableType::Binary || VAR->properties.type == E_VariableType::Integer
-                   || VAR->properties.type == E_VariableType::Semiinteger))
-                continue;
-
-            int variableValue = integerCut.variableValues[index];
 
-            if(variableValue == VAR->upperBound)
-            {
-                expr += (variableValue - cplexVars[VAR->index]);
-            }
-            else if(variableValue == VAR->lowerBound)
-            {
-                expr += cplexVars[VAR->index];
-            }
-
-            index++;
-        }
+        for(auto& T : terms->first)
+            expr += T.second * cplexVars[T.first];
 
-        IloRange tmpRange(this->getEnv(), 1, expr, IloInfinity,
+        IloRange tmpRange(this->getEnv(), -IloInfinity, expr, -terms->second,
             fmt::format("IC{}", env->solutionStatistics.numberOfIntegerCuts).c_str());
 
         add(tmpRange);
@@ -731,7 +716,7 @@ E_ProblemSolutionStatus MIPSolverCplexSingleTreeLegacy::solveProblem()
             }
         }
 
-        cplexInstance.solve();
+        solveCplexInstance();
         MIPSolutionStatus = getSolutionStatus();
 
         // Try to solve a feasibility problem to get a valid solution point if unbounded
@@ -745,7 +730,7 @@ E_ProblemSolutionStatus MIPSolverCplexSingleTreeLegacy::solveProblem()
                 cplexModel.add(IloMaximize(cplexEnv, SHOT_DBL_MAX));
 
             cplexInstance.extract(cplexModel);
-            cplexInstance.solve();
+            solveCplexInstance();
             MIPSolutionStatus = getSolutionStatus();
 
             if(MIPSolutionStatus == E_ProblemSolutionStatus::Optimal)
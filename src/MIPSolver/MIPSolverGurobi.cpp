@@ -10,6 +10,8 @@
 
 #include "MIPSolverGurobi.h"
 
+#include "../CancellationToken.h"
+#include "../DebugWriter.h"
 #include "../DualSolver.h"
 #include "../EventHandler.h"
 #include "../Iteration.h"
@@ -18,6 +20,7 @@
 #include "../Results.h"
 #include "../Settings.h"
 #include "../TaskHandler.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 
@@ -73,6 +76,7 @@ bool MIPSolverGurobi::initializeProblem()
 
     cachedSolutionHasChanged = true;
     isVariablesFixed = false;
+    useNames = env->settings->getSetting<bool>("MIP.UseNames", "Dual");
 
     checkParameters();
 
@@ -82,6 +86,9 @@ bool MIPSolverGurobi::initializeProblem()
 bool MIPSolverGurobi::addVariable(
     std::string name, E_VariableType type, double lowerBound, double upperBound, double semiBound)
 {
+    if(!useNames)
+        name.clear();
+
     if(lowerBound < -getUnboundedVariableBoundValue())
         lowerBound = -getUnboundedVariableBoundValue();
 
@@ -195,6 +202,40 @@ bool MIPSolverGurobi::addQuadraticTermToObjective(double coefficient, int firstV
     return (true);
 }
 
+bool MIPSolverGurobi::addQuadraticTermsToObjective(const VectorDouble& coefficients,
+    const VectorInteger& firstVariableIndexes, const VectorInteger& secondVariableIndexes)
+{
+    if(coefficients.size() == 0)
+        return (true);
+
+    try
+    {
+        std::vector<GRBVar> firstVariables;
+        std::vector<GRBVar> secondVariables;
+        firstVariables.reserve(coefficients.size());
+        secondVariables.reserve(coefficients.size());
+
+        for(size_t k = 0; k < coefficients.size(); k++)
+        {
+            firstVariables.push_back(gurobiModel->getVar(firstVariableIndexes[k]));
+            secondVariables.push_back(gurobiModel->getVar(secondVariableIndexes[k]));
+        }
+
+        objectiveQuadraticExpression.addTerms(
+            coefficients.data(), firstVariables.data(), secondVariables.data(), (int)coefficients.size());
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError(
+            "        Gurobi exception caught when adding quadratic terms to objective: ", e.getMessage());
+        return (false);
+    }
+
+    hasQuadraticObjective = true;
+
+    return (true);
+}
+
 bool MIPSolverGurobi::finalizeObjective(bool isMinimize, double constant)
 {
     try
@@ -223,6 +264,32 @@ bool MIPSolverGurobi::finalizeObjective(bool isMinimize, double constant)
     return (true);
 }
 
+bool MIPSolverGurobi::replaceObjective(const std::map<int, double>& linearTerms, bool isMinimize)
+{
+    try
+    {
+        objectiveLinearExpression = GRBLinExpr(0);
+        objectiveQuadraticExpression = GRBQuadExpr(0);
+
+        for(auto& T : linearTerms)
+            objectiveLinearExpression += T.second * gurobiModel->getVar(T.first);
+
+        gurobiModel->setObjective(objectiveLinearExpression, isMinimize ? GRB_MINIMIZE : GRB_MAXIMIZE);
+
+        isMinimizationProblem = isMinimize;
+        hasQuadraticObjective = false;
+        cachedSolutionHasChanged = true;
+        modelUpdated = true;
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Gurobi exception caught when replacing objective function: ", e.getMessage());
+        return (false);
+    }
+
+    return (true);
+}
+
 bool MIPSolverGurobi::initializeConstraint()
 {
     try
@@ -274,8 +341,45 @@ bool MIPSolverGurobi::addQuadraticTermToConstraint(double coefficient, int first
     return (true);
 }
 
+bool MIPSolverGurobi::addQuadraticTermsToConstraint(const VectorDouble& coefficients,
+    const VectorInteger& firstVariableIndexes, const VectorInteger& secondVariableIndexes)
+{
+    if(coefficients.size() == 0)
+        return (true);
+
+    try
+    {
+        std::vector<GRBVar> firstVariables;
+        std::vector<GRBVar> secondVariables;
+        firstVariables.reserve(coefficients.size());
+        secondVariables.reserve(coefficients.size());
+
+        for(size_t k = 0; k < coefficients.size(); k++)
+        {
+            firstVariables.push_back(gurobiModel->getVar(firstVariableIndexes[k]));
+            secondVariables.push_back(gurobiModel->getVar(secondVariableIndexes[k]));
+        }
+
+        constraintQuadraticExpression.addTerms(
+            coefficients.data(), firstVariables.data(), secondVariables.data(), (int)coefficients.size());
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError(
+            "        Gurobi exception caught when adding quadratic terms to constraint: ", e.getMessage());
+        return (false);
+    }
+
+    hasQudraticConstraint = true;
+
+    return (true);
+}
+
 bool MIPSolverGurobi::finalizeConstraint(std::string name, double valueLHS, double valueRHS, double constant)
 {
+    if(!useNames)
+        name.clear();
+
     try
     {
         if(constant != 0.0)
@@ -283,25 +387,39 @@ bool MIPSolverGurobi::finalizeConstraint(std::string name, double valueLHS, doub
 
         if(constraintQuadraticExpression.size() == 0)
         {
+            // A ranged constraint is added as two rows, each of which needs its own repair flag
             if(valueLHS == valueRHS)
             {
                 gurobiModel->addConstr(constraintLinearExpression == valueRHS, name);
+                allowRepairOfConstraint.push_back(false);
             }
             else if(valueLHS < valueRHS)
             {
                 if(valueLHS > SHOT_DBL_MIN)
+                {
                     gurobiModel->addConstr(valueLHS <= constraintLinearExpression, name + "_a");
+                    allowRepairOfConstraint.push_back(false);
+                }
 
                 if(valueRHS < SHOT_DBL_MAX)
+                {
                     gurobiModel->addConstr(constraintLinearExpression <= valueRHS, name + "_b");
+                    allowRepairOfConstraint.push_back(false);
+                }
             }
             else
             {
                 if(valueLHS < SHOT_DBL_MAX)
+                {
                     gurobiModel->addConstr(valueLHS >= constraintLinearExpression, name + "_a");
+                    allowRepairOfConstraint.push_back(false);
+                }
 
                 if(valueRHS > SHOT_DBL_MIN)
+                {
                     gurobiModel->addConstr(constraintLinearExpression >= valueRHS, name + "_b");
+                    allowRepairOfConstraint.push_back(false);
+                }
             }
         }
         else
@@ -332,9 +450,6 @@ bool MIPSolverGurobi::finalizeConstraint(std::string name, double valueLHS, doub
                         constraintLinearExpression + constraintQuadraticExpression >= valueRHS, name + "_b");
             }
         }
-
-        if(constraintQuadraticExpression.size() == 0)
-            allowRepairOfConstraint.push_back(false);
     }
     catch(GRBException& e)
     {
@@ -384,6 +499,26 @@ bool MIPSolverGurobi::finalizeProblem()
     return (true);
 }
 
+bool MIPSolverGurobi::restoreBaseProblem()
+{
+    if(!MIPSolverBase::restoreBaseProblem())
+        return (false);
+
+    try
+    {
+        // Discards the solution information, so that the next solve starts as with a new model
+        gurobiModel->reset();
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when resetting Gurobi model", e.getMessage());
+        return (false);
+    }
+
+    cachedSolutionHasChanged = true;
+    return (true);
+}
+
 void MIPSolverGurobi::initializeSolverSettings()
 {
     try
@@ -439,7 +574,7 @@ void MIPSolverGurobi::initializeSolverSettings()
             GRB_DoubleParam_Heuristics, env->settings->getSetting<double>("Gurobi.Heuristics", "Subsolver"));
 
         // Set number of threads
-        gurobiModel->set(GRB_IntParam_Threads, env->settings->getSetting<int>("MIP.NumberOfThreads", "Dual"));
+        gurobiModel->set(GRB_IntParam_Threads, ThreadPlacement::getNumberOfMIPThreads(env->settings));
     }
     catch(GRBException& e)
     {
@@ -450,6 +585,9 @@ void MIPSolverGurobi::initializeSolverSettings()
 int MIPSolverGurobi::addLinearConstraint(
     const std::map<int, double>& elements, double constant, std::string name, bool isGreaterThan, bool allowRepair)
 {
+    if(!useNames)
+        name.clear();
+
     try
     {
         int numConstraintsBefore = gurobiModel->get(GRB_IntAttr_NumConstrs);
@@ -494,6 +632,150 @@ int MIPSolverGurobi::addLinearConstraint(
     return (gurobiModel->get(GRB_IntAttr_NumConstrs) - 1);
 }
 
+int MIPSolverGurobi::addLinearConstraints(const LinearConstraintBlock& constraints)
+{
+    try
+    {
+        int numConstraintsBefore = gurobiModel->get(GRB_IntAttr_NumConstrs);
+        int numConstraints = constraints.size();
+
+        std::vector<GRBLinExpr> expressions(numConstraints);
+        std::vector<char> senses(numConstraints, GRB_LESS_EQUAL);
+        VectorDouble rhs(numConstraints);
+
+        for(int i = 0; i < numConstraints; i++)
+        {
+            for(int j = constraints.rowStarts[i]; j < constraints.rowStarts[i + 1]; j++)
+            {
+                if(std::abs(constraints.coefficients[j]) > 1e-13) // Gurobi might crash otherwise
+                    expressions[i] += constraints.coefficients[j] * gurobiModel->getVar(constraints.variableIndexes[j]);
+            }
+
+            rhs[i] = -constraints.constants[i];
+        }
+
+        auto addedConstraints = gurobiModel->addConstrs(expressions.data(), senses.data(), rhs.data(),
+            useNames ? constraints.names.data() : nullptr, numConstraints);
+        delete[] addedConstraints;
+
+        gurobiModel->update();
+
+        if(gurobiModel->get(GRB_IntAttr_NumConstrs) != numConstraintsBefore + numConstraints)
+        {
+            env->output->outputInfo("        Hyperplanes not added by Gurobi");
+            return (-1);
+        }
+
+        for(int i = 0; i < numConstraints; i++)
+            allowRepairOfConstraint.push_back(constraints.allowRepair[i]);
+
+        return (numConstraintsBefore);
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when adding linear constraints", e.getMessage());
+    }
+
+    return (-1);
+}
+
+bool MIPSolverGurobi::removeLinearConstraints(const VectorInteger& constraintIndexes)
+{
+    if(constraintIndexes.size() == 0)
+        return (true);
+
+    try
+    {
+        // The pending right-hand sides refer to the indexes before the removal
+        applyPendingChanges();
+
+        std::vector<GRBConstr> constraints;
+        constraints.reserve(constraintIndexes.size());
+
+        for(auto I : constraintIndexes)
+            constraints.push_back(gurobiModel->getConstr(I));
+
+        for(auto& C : constraints)
+            gurobiModel->remove(C);
+
+        gurobiModel->update();
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when removing linear constraints", e.getMessage());
+        return (false);
+    }
+
+    updateConstraintIndexesAfterRemoval(constraintIndexes);
+    return (true);
+}
+
+int MIPSolverGurobi::getNumberOfConstraints()
+{
+    try
+    {
+        // The quadratic constraints are not included, since they are not indexed with the linear ones
+        gurobiModel->update();
+        return (gurobiModel->get(GRB_IntAttr_NumConstrs));
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when getting the number of constraints", e.getMessage());
+        return (-1);
+    }
+}
+
+bool MIPSolverGurobi::addFunctionConstraint(
+    const UnivariateFunction& function, int resultVariableIndex, std::string name)
+{
+#if GRB_VERSION_MAJOR >= 11
+    if(!useNames)
+        name.clear();
+
+    try
+    {
+        auto variable = gurobiModel->getVar(function.variableIndex);
+        auto result = gurobiModel->getVar(resultVariableIndex);
+
+        switch(function.type)
+        {
+        case E_UnivariateFunctionType::Exp:
+            gurobiModel->addGenConstrExp(variable, result, name);
+            break;
+        case E_UnivariateFunctionType::Log:
+            gurobiModel->addGenConstrLog(variable, result, name);
+            break;
+        case E_UnivariateFunctionType::Power:
+            gurobiModel->addGenConstrPow(variable, result, function.parameter, name);
+            break;
+        case E_UnivariateFunctionType::Sin:
+            gurobiModel->addGenConstrSin(variable, result, name);
+            break;
+        case E_UnivariateFunctionType::Cos:
+            gurobiModel->addGenConstrCos(variable, result, name);
+            break;
+        case E_UnivariateFunctionType::Tan:
+            gurobiModel->addGenConstrTan(variable, result, name);
+            break;
+        }
+
+        // The functions are then handled exactly in the branch-and-bound instead of with piecewise-linear
+        // approximations, so that the dual bound from Gurobi remains valid
+        gurobiModel->set(GRB_IntParam_FuncNonlinear, 1);
+        modelUpdated = true;
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when adding function constraint", e.getMessage());
+        return (false);
+    }
+
+    return (true);
+#else
+    return (false);
+#endif
+}
+
 bool MIPSolverGurobi::addSpecialOrderedSet(E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights)
 {
     try
@@ -584,7 +866,7 @@ bool MIPSolverGurobi::createIntegerCut(IntegerCut& integerCut)
 
                 if(gurobiModel->get(GRB_IntAttr_NumConstrs) > tmpNumConstraints)
                 {
-                    integerCuts.push_back(numConstraintsBefore + index);
+                    integerCuts.push_back(tmpNumConstraints);
                     allowRepairOfConstraint.push_back(false);
                 }
 
@@ -595,7 +877,7 @@ bool MIPSolverGurobi::createIntegerCut(IntegerCut& integerCut)
 
                 if(gurobiModel->get(GRB_IntAttr_NumConstrs) > tmpNumConstraints)
                 {
-                    integerCuts.push_back(numConstraintsBefore + index);
+                    integerCuts.push_back(tmpNumConstraints);
                     allowRepairOfConstraint.push_back(false);
                 }
 
@@ -606,7 +888,7 @@ bool MIPSolverGurobi::createIntegerCut(IntegerCut& integerCut)
 
                 if(gurobiModel->get(GRB_IntAttr_NumConstrs) > tmpNumConstraints)
                 {
-                    integerCuts.push_back(numConstraintsBefore + index);
+                    integerCuts.push_back(tmpNumConstraints);
                     allowRepairOfConstraint.push_back(false);
                 }
 
@@ -617,7 +899,7 @@ bool MIPSolverGurobi::createIntegerCut(IntegerCut& integerCut)
 
                 if(gurobiModel->get(GRB_IntAttr_NumConstrs) > tmpNumConstraints)
                 {
-                    integerCuts.push_back(numConstraintsBefore + index);
+                    integerCuts.push_back(tmpNumConstraints);
                     allowRepairOfConstraint.push_back(false);
                 }
             }
@@ -631,7 +913,7 @@ bool MIPSolverGurobi::createIntegerCut(IntegerCut& integerCut)
 
         if(gurobiModel->get(GRB_IntAttr_NumConstrs) > tmpNumConstraints)
         {
-            integerCuts.push_back(numConstraintsBefore + index);
+            integerCuts.push_back(tmpNumConstraints);
             allowRepairOfConstraint.push_back(allowIntegerCutRepair);
         }
 
@@ -691,6 +973,30 @@ VectorDouble MIPSolverGurobi::getVariableSolution(int solIdx)
     return (solution);
 }
 
+VectorDouble MIPSolverGurobi::getReducedCosts()
+{
+    VectorDouble reducedCosts;
+
+    if(getDiscreteVariableStatus() || getSolutionStatus() != E_ProblemSolutionStatus::Optimal)
+        return (reducedCosts);
+
+    try
+    {
+        int numVar = gurobiModel->get(GRB_IntAttr_NumVars);
+        reducedCosts.resize(numVar);
+
+        for(int i = 0; i < numVar; i++)
+            reducedCosts[i] = gurobiModel->getVar(i).get(GRB_DoubleAttr_RC);
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when reading reduced costs", e.getMessage());
+        reducedCosts.clear();
+    }
+
+    return (reducedCosts);
+}
+
 int MIPSolverGurobi::getNumberOfSolutions()
 {
     int numSols = 0;
@@ -792,6 +1098,11 @@ E_ProblemSolutionStatus MIPSolverGurobi::getSolutionStatus()
     {
         MIPSolutionStatus = E_ProblemSolutionStatus::SolutionLimit;
     }
+    else if(status == GRB_INTERRUPTED && env->dualSolver->isMIPSolveInterrupted)
+    {
+        // Interrupted since enough incumbents have been found, see MIPSolverCallbackBase::addStreamedSolution
+        MIPSolutionStatus = E_ProblemSolutionStatus::SolutionLimit;
+    }
     else if(status == GRB_INTERRUPTED)
     {
         MIPSolutionStatus = E_ProblemSolutionStatus::Abort;
@@ -804,6 +1115,12 @@ E_ProblemSolutionStatus MIPSolverGurobi::getSolutionStatus()
     {
         MIPSolutionStatus = E_ProblemSolutionStatus::Infeasible;
     }
+    else if(status == GRB_USER_OBJ_LIMIT)
+    {
+        // The dual bound stop has been reached, so no solution better than it exists
+        MIPSolutionStatus = (gurobiModel->get(GRB_IntAttr_SolCount) > 0) ? E_ProblemSolutionStatus::Feasible
+                                                                         : E_ProblemSolutionStatus::Infeasible;
+    }
     else if(status == GRB_SUBOPTIMAL)
     {
         MIPSolutionStatus = E_ProblemSolutionStatus::Feasible;
@@ -821,6 +1138,69 @@ E_ProblemSolutionStatus MIPSolverGurobi::getSolutionStatus()
     return (MIPSolutionStatus);
 }
 
+void MIPSolverGurobi::applyPendingChanges()
+{
+    if(!modelUpdated)
+        return;
+
+    try
+    {
+        if(pendingVariableBounds.size() > 0)
+        {
+            std::vector<GRBVar> variables;
+            VectorDouble lowerBounds;
+            VectorDouble upperBounds;
+
+            variables.reserve(pendingVariableBounds.size());
+            lowerBounds.reserve(pendingVariableBounds.size());
+            upperBounds.reserve(pendingVariableBounds.size());
+
+            for(auto& B : pendingVariableBounds)
+            {
+                variables.push_back(gurobiModel->getVar(B.first));
+                lowerBounds.push_back(B.second.first);
+                upperBounds.push_back(B.second.second);
+            }
+
+            gurobiModel->set(GRB_DoubleAttr_LB, variables.data(), lowerBounds.data(), (int)variables.size());
+            gurobiModel->set(GRB_DoubleAttr_UB, variables.data(), upperBounds.data(), (int)variables.size());
+        }
+
+        if(pendingConstraintRHS.size() > 0)
+        {
+            std::vector<GRBConstr> constraints;
+            VectorDouble values;
+
+            constraints.reserve(pendingConstraintRHS.size());
+            values.reserve(pendingConstraintRHS.size());
+
+            for(auto& R : pendingConstraintRHS)
+            {
+                constraints.push_back(gurobiModel->getConstr(R.first));
+                values.push_back(R.second);
+            }
+
+            gurobiModel->set(GRB_DoubleAttr_RHS, constraints.data(), values.data(), (int)constraints.size());
+        }
+
+        gurobiModel->update();
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when updating the Gurobi model", e.getMessage());
+    }
+
+    clearPendingChanges();
+    modelUpdated = false;
+}
+
+void MIPSolverGurobi::optimizeGurobiModel()
+{
+    // GRBModel::terminate() can be called from any thread
+    ScopedCancellationCallback cancelSolve(env->cancellationToken, [this] { gurobiModel->terminate(); });
+    gurobiModel->optimize();
+}
+
 E_ProblemSolutionStatus MIPSolverGurobi::solveProblem()
 {
     E_ProblemSolutionStatus MIPSolutionStatus;
@@ -828,13 +1208,19 @@ E_ProblemSolutionStatus MIPSolverGurobi::solveProblem()
 
     try
     {
-        if(modelUpdated)
+        applyPendingChanges();
+
+        gurobiCallback->variables.clear();
+
+        if(env->dualSolver->isSolutionStreamingUsed)
         {
-            gurobiModel->update();
-            modelUpdated = false;
+            GRBVar* variables = gurobiModel->getVars();
+            gurobiCallback->variables.assign(variables, variables + gurobiModel->get(GRB_IntAttr_NumVars));
+            delete[] variables;
         }
+
         gurobiModel->setCallback(gurobiCallback.get());
-        gurobiModel->optimize();
+        optimizeGurobiModel();
 
         MIPSolutionStatus = getSolutionStatus();
     }
@@ -887,16 +1273,16 @@ E_ProblemSolutionStatus MIPSolverGurobi::solveProblem()
 
         if(problemUpdated)
         {
-            gurobiModel->update();
+            applyPendingChanges();
             gurobiModel->setCallback(gurobiCallback.get());
-            gurobiModel->optimize();
+            optimizeGurobiModel();
 
             MIPSolutionStatus = getSolutionStatus();
 
             for(auto& P : originalObjectiveCoefficients)
                 gurobiModel->getVar(P.index).set(GRB_DoubleAttr_Obj, P.value);
 
-            gurobiModel->update();
+            modelUpdated = true;
 
             if(env->results->iterations.size() > 0) // Might not have iterations if we are using the minimax solver
                 env->results->getCurrentIteration()->hasInfeasibilityRepairBeenPerformed = true;
@@ -913,7 +1299,7 @@ bool MIPSolverGurobi::repairInfeasibility()
 
     try
     {
-        gurobiModel->update();
+        applyPendingChanges();
         auto feasModel = GRBModel(*gurobiModel);
 
         // Gurobi copies over the cutoff from the original model
@@ -931,9 +1317,13 @@ bool MIPSolverGurobi::repairInfeasibility()
         VectorDouble relaxParameters;
         int numConstraintsToRepair = 0;
 
+        std::vector<bool> isInConflict;
+        bool useConflict = env->settings->getSetting<bool>("MIP.InfeasibilityRepair.UseConflict", "Dual")
+            && getConflictingConstraints(isInConflict);
+
         for(int i = numOrigConstraints; i < numCurrConstraints; i++)
         {
-            if(allowRepairOfConstraint[i])
+            if(allowRepairOfConstraint[i] && (!useConflict || isInConflict[i]))
             {
                 repairConstraints.push_back(feasModel.getConstr(i));
                 originalConstraints.push_back(gurobiModel->getConstr(i));
@@ -957,9 +1347,12 @@ bool MIPSolverGurobi::repairInfeasibility()
                 env->settings->getSetting<std::string>("Debug.Path", "Output"),
                 env->results->getCurrentIteration()->iterationNumber - 1);
 
-            Utilities::saveVariablePointVectorToFile(relaxParameters, constraints, filename);
+            env->debugWriter->writePoint(relaxParameters, constraints, filename);
         }
 
+        if(numConstraintsToRepair == 0)
+            return (false);
+
         // Gurobi modifies the value when running feasModel.optimize()
         int numConstraintsToRepairOrig = numConstraintsToRepair;
 
@@ -1048,6 +1441,47 @@ bool MIPSolverGurobi::repairInfeasibility()
     return (false);
 }
 
+bool MIPSolverGurobi::getConflictingConstraints(std::vector<bool>& isInConflict)
+{
+    try
+    {
+        auto relaxedModel = gurobiModel->relax();
+
+        if(isMinimizationProblem)
+            relaxedModel.set(GRB_DoubleParam_Cutoff, SHOT_DBL_MAX);
+        else
+            relaxedModel.set(GRB_DoubleParam_Cutoff, SHOT_DBL_MIN);
+
+        // Throws if the relaxation is feasible
+        relaxedModel.computeIIS();
+
+        int numConstraints = relaxedModel.get(GRB_IntAttr_NumConstrs);
+        int numConflicting = 0;
+
+        isInConflict.assign(numConstraints, false);
+
+        for(int i = 0; i < numConstraints; i++)
+        {
+            if(relaxedModel.getConstr(i).get(GRB_IntAttr_IISConstr) == 1)
+            {
+                isInConflict[i] = true;
+                numConflicting++;
+            }
+        }
+
+        env->output->outputDebug(
+            fmt::format("        Found {} constraints in an IIS of the LP relaxation.", numConflicting));
+
+        return (numConflicting > 0);
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputDebug("        No IIS found for the LP relaxation: " + e.getMessage());
+    }
+
+    return (false);
+}
+
 int MIPSolverGurobi::increaseSolutionLimit(int increment)
 {
     gurobiModel->set(GRB_IntParam_SolutionLimit, gurobiModel->get(GRB_IntParam_SolutionLimit) + increment);
@@ -1084,6 +1518,36 @@ void MIPSolverGurobi::setTimeLimit(double seconds)
     }
 }
 
+void MIPSolverGurobi::setRelativeGap(double gap)
+{
+    try
+    {
+        gurobiModel->set(GRB_DoubleParam_MIPGap, gap);
+        env->output->outputDebug(fmt::format("        Setting relative MIP gap to {}.", gap));
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when setting relative gap", e.getMessage());
+    }
+}
+
+void MIPSolverGurobi::setDualBoundStop(double bound)
+{
+    try
+    {
+        if(std::abs(bound) > 1e20)
+            gurobiModel->set(GRB_DoubleParam_BestBdStop, isMinimizationProblem ? GRB_INFINITY : -GRB_INFINITY);
+        else
+            gurobiModel->set(GRB_DoubleParam_BestBdStop, bound);
+
+        env->output->outputDebug(fmt::format("        Setting dual bound stop to {}.", bound));
+    }
+    catch(GRBException& e)
+    {
+        env->output->outputError("        Error when setting dual bound stop", e.getMessage());
+    }
+}
+
 void MIPSolverGurobi::setCutOff(double cutOff)
 {
     if(std::abs(cutOff) > 1e20)
@@ -1139,24 +1603,22 @@ void MIPSolverGurobi::setCutOffAsConstraint(double cutOff)
             }
 
             allowRepairOfConstraint.push_back(false);
-            gurobiModel->update();
-            modelUpdated = false;
+            modelUpdated = true;
+            applyPendingChanges();
 
             cutOffConstraintDefined = true;
             cutOffConstraintIndex = gurobiModel->get(GRB_IntAttr_NumConstrs) - 1;
         }
         else
         {
-            auto constraint = gurobiModel->getConstr(cutOffConstraintIndex);
-
             if(env->reformulatedProblem->objectiveFunction->properties.isMaximize)
             {
 
                 if(hasDualAuxiliaryObjectiveVariable())
-                    constraint.set(GRB_DoubleAttr_RHS, -cutOff);
+                    addPendingConstraintRHS(cutOffConstraintIndex, -cutOff);
                 else
-                    constraint.set(
-                        GRB_DoubleAttr_RHS, -(cutOff - env->reformulatedProblem->objectiveFunction->constant));
+                    addPendingConstraintRHS(
+                        cutOffConstraintIndex, -(cutOff - env->reformulatedProblem->objectiveFunction->constant));
 
                 env->output->outputDebug(
                     "        Setting cutoff constraint value to " + Utilities::toString(cutOff) + " for maximization.");
@@ -1165,15 +1627,14 @@ void MIPSolverGurobi::setCutOffAsConstraint(double cutOff)
             {
 
                 if(hasDualAuxiliaryObjectiveVariable())
-                    constraint.set(GRB_DoubleAttr_RHS, cutOff);
+                    addPendingConstraintRHS(cutOffConstraintIndex, cutOff);
                 else
-                    constraint.set(GRB_DoubleAttr_RHS, cutOff - env->reformulatedProblem->objectiveFunction->constant);
+                    addPendingConstraintRHS(
+                        cutOffConstraintIndex, cutOff - env->reformulatedProblem->objectiveFunction->constant);
 
                 env->output->outputDebug(
                     "        Setting cutoff constraint to " + Utilities::toString(cutOff) + " for minimization.");
             }
-
-            modelUpdated = true;
         }
     }
     catch(GRBException& e)
@@ -1219,6 +1680,7 @@ void MIPSolverGurobi::writeProblemToFile(std::string filename)
 {
     try
     {
+        applyPendingChanges();
         gurobiModel->write(filename);
     }
     catch(GRBException& e)
@@ -1308,21 +1770,7 @@ void MIPSolverGurobi::updateVariableBound(int varIndex, double lowerBound, doubl
     if(currentVariableBounds.first == lowerBound && currentVariableBounds.second == upperBound)
         return;
 
-    try
-    {
-        GRBVar tmpVar = gurobiModel->getVar(varIndex);
-
-        tmpVar.set(GRB_DoubleAttr_LB, lowerBound);
-        tmpVar.set(GRB_DoubleAttr_UB, upperBound);
-
-        modelUpdated = true;
-    }
-    catch(GRBException& e)
-    {
-        env->output->outputError(
-            "        Error when updating variable bounds for variable index" + std::to_string(varIndex),
-            e.getMessage());
-    }
+    addPendingVariableBound(varIndex, lowerBound, upperBound);
 }
 
 void MIPSolverGurobi::updateVariableLowerBound(int varIndex, double lowerBound)
@@ -1332,20 +1780,7 @@ void MIPSolverGurobi::updateVariableLowerBound(int varIndex, double lowerBound)
     if(currentVariableBounds.first == lowerBound)
         return;
 
-    try
-    {
-        GRBVar tmpVar = gurobiModel->getVar(varIndex);
-
-        tmpVar.set(GRB_DoubleAttr_LB, lowerBound);
-
-        modelUpdated = true;
-    }
-    catch(GRBException& e)
-    {
-        env->output->outputError(
-            "        Error when updating variable bounds for variable index" + std::to_string(varIndex),
-            e.getMessage());
-    }
+    addPendingVariableBound(varIndex, lowerBound, currentVariableBounds.second);
 }
 
 void MIPSolverGurobi::updateVariableUpperBound(int varIndex, double upperBound)
@@ -1355,24 +1790,14 @@ void MIPSolverGurobi::updateVariableUpperBound(int varIndex, double upperBound)
     if(currentVariableBounds.second == upperBound)
         return;
 
-    try
-    {
-        GRBVar tmpVar = gurobiModel->getVar(varIndex);
-
-        tmpVar.set(GRB_DoubleAttr_UB, upperBound);
-
-        modelUpdated = true;
-    }
-    catch(GRBException& e)
-    {
-        env->output->outputError(
-            "        Error when updating variable bounds for variable index" + std::to_string(varIndex),
-            e.getMessage());
-    }
+    addPendingVariableBound(varIndex, currentVariableBounds.first, upperBound);
 }
 
 PairDouble MIPSolverGurobi::getCurrentVariableBounds(int varIndex)
 {
+    if(auto pendingBounds = getPendingVariableBounds(varIndex))
+        return (pendingBounds.value());
+
     PairDouble tmpBounds;
 
     try
@@ -1475,6 +1900,18 @@ void GurobiCallbackMultiTree::callback()
             currIter->numberOfExploredNodes = (int)getDoubleInfo(GRB_CB_MIP_NODCNT);
             currIter->numberOfOpenNodes = (int)getDoubleInfo(GRB_CB_MIP_NODLFT);
         }
+        else if(where == GRB_CB_MIPSOL && variables.size() > 0)
+        {
+            double* values = getSolution(variables.data(), (int)variables.size());
+            VectorDouble solution(values, values + variables.size());
+            delete[] values;
+
+            if(addStreamedSolution(solution))
+            {
+                this->abort();
+                return;
+            }
+        }
 
         if(checkUserTermination())
             this->abort();
@@ -22,6 +22,9 @@ class GurobiCallbackMultiTree : public GRBCallback, public MIPSolverCallbackBase
 public:
     GurobiCallbackMultiTree(EnvironmentPtr envPtr);
 
+    // Only set if the incumbents are streamed
+    std::vector<GRBVar> variables;
+
 protected:
     void callback() override;
 
@@ -46,15 +49,23 @@ public:
     bool initializeObjective() override;
     bool addLinearTermToObjective(double coefficient, int variableIndex) override;
     bool addQuadraticTermToObjective(double coefficient, int firstVariableIndex, int secondVariableIndex) override;
+    bool addQuadraticTermsToObjective(const VectorDouble& coefficients, const VectorInteger& firstVariableIndexes,
+        const VectorInteger& secondVariableIndexes) override;
     bool finalizeObjective(bool isMinimize, double constant = 0.0) override;
+    bool replaceObjective(const std::map<int, double>& linearTerms, bool isMinimize) override;
 
     bool initializeConstraint() override;
     bool addLinearTermToConstraint(double coefficient, int variableIndex) override;
     bool addQuadraticTermToConstraint(double coefficient, int firstVariableIndex, int secondVariableIndex) override;
+    bool addQuadraticTermsToConstraint(const VectorDouble& coefficients, const VectorInteger& firstVariableIndexes,
+        const VectorInteger& secondVariableIndexes) override;
     bool finalizeConstraint(std::string name, double valueLHS, double valueRHS, double constant = 0.0) override;
 
     bool finalizeProblem() override;
 
+    void saveBaseProblem() override { MIPSolverBase::saveBaseProblem(); }
+    bool restoreBaseProblem() override;
+
     void initializeSolverSettings() override;
 
     void writeProblemToFile(std::string filename) override;
@@ -74,19 +85,38 @@ public:
     int addLinearConstraint(const std::map<int, double>& elements, double constant, std::string name,
         bool isGreaterThan, bool allowRepair) override;
 
+    int addLinearConstraints(const LinearConstraintBlock& constraints) override;
+
+    bool removeLinearConstraints(const VectorInteger& constraintIndexes) override;
+
+    int getNumberOfConstraints() override;
+
     bool addSpecialOrderedSet(
         E_SOSType type, VectorInteger variableIndexes, VectorDouble variableWeights = {}) override;
 
-    bool createHyperplane(Hyperplane hyperplane) override { return (MIPSolverBase::createHyperplane(hyperplane)); }
+    bool createHyperplane(const Hyperplane& hyperplane) override
+    {
+        return (MIPSolverBase::createHyperplane(hyperplane));
+    }
+
+    std::vector<bool> createHyperplanes(const std::vector<Hyperplane>& hyperplanes) override
+    {
+        return (MIPSolverBase::createHyperplanes(hyperplanes));
+    }
+
+    std::pair<int, int> manageHyperplaneCuts(const std::vector<SolutionPoint>& solutionPoints) override
+    {
+        return (MIPSolverBase::manageHyperplaneCuts(solutionPoints));
+    }
 
     bool createIntegerCut(IntegerCut& integerCut) override;
 
-    bool createInteriorHyperplane(Hyperplane hyperplane) override
+    bool createInteriorHyperplane(const Hyperplane& hyperplane) override
     {
         return (MIPSolverBase::createInteriorHyperplane(hyperplane));
     }
 
-    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(Hyperplane hyperplane) override
+    std::optional<std::pair<std::map<int, double>, double>> createHyperplaneTerms(const Hyperplane& hyperplane) override
     {
         return (MIPSolverBase::createHyperplaneTerms(hyperplane));
     }
@@ -123,6 +153,7 @@ public:
     E_ProblemSolutionStatus getSolutionStatus() override;
     int getNumberOfSolutions() override;
     VectorDouble getVariableSolution(int solIdx) override;
+    VectorDouble getReducedCosts() override;
     std::vector<SolutionPoint> getAllVariableSolutions() override { return (MIPSolverBase::getAllVariableSolutions()); }
     double getDualObjectiveValue() override;
     double getObjectiveValue(int solIdx) override;
@@ -137,12 +168,17 @@ public:
     void setCutOff(double cutOff) override;
     void setCutOffAsConstraint(double cutOff) override;
 
+    void setRelativeGap(double gap) override;
+    void setDualBoundStop(double bound) override;
+
     void addMIPStart(VectorDouble point) override;
     void deleteMIPStarts() override;
 
     bool supportsQuadraticObjective() override;
     bool supportsQuadraticConstraints() override;
 
+    bool addFunctionConstraint(const UnivariateFunction& function, int resultVariableIndex, std::string name) override;
+
     double getUnboundedVariableBoundValue() override;
 
     int getNumberOfExploredNodes() override;
@@ -170,6 +206,12 @@ public:
 
     std::string getSolverVersion() override;
 
+    // Writes the pending bound and right-hand side changes to the model and updates it
+    void applyPendingChanges();
+
+    // Optimizes the model, which is terminated if the cancellation token of the environment is cancelled meanwhile
+    void optimizeGurobiModel();
+
     std::shared_ptr<GRBModel> gurobiModel;
     std::unique_ptr<GurobiCallbackMultiTree> gurobiCallback;
     GRBLinExpr objectiveLinearExpression;
@@ -178,6 +220,8 @@ public:
     GRBQuadExpr constraintQuadraticExpression;
 
 private:
+    // Marks the constraints in an IIS of the LP relaxation of the infeasible problem, returns false if none is found
+    bool getConflictingConstraints(std::vector<bool>& isInConflict);
 };
 
 } // namespace SHOT
@@ -94,10 +94,14 @@ E_ProblemSolutionStatus MIPSolverGurobiSingleTree::solveProblem()
             isCallbackInitialized = true;
         }
 
+        applyPendingChanges();
+
         gurobiModel->set(GRB_IntParam_LazyConstraints, 1);
         gurobiModel->setCallback(gurobiCallback.get());
 
-        gurobiModel->optimize();
+        optimizeGurobiModel();
+        gurobiCallback->stopBackgroundPrimalWorker();
+        gurobiCallback->stopIterationReporter();
 
         MIPSolutionStatus = getSolutionStatus();
     }
@@ -143,7 +147,7 @@ E_ProblemSolutionStatus MIPSolverGurobiSingleTree::solveProblem()
 
         if(variableBoundsUpdated)
         {
-            gurobiModel->update();
+            applyPendingChanges();
 
             if(!isCallbackInitialized)
             {
@@ -154,7 +158,9 @@ E_ProblemSolutionStatus MIPSolverGurobiSingleTree::solveProblem()
             gurobiModel->set(GRB_IntParam_LazyConstraints, 1);
             gurobiModel->setCallback(gurobiCallback.get());
 
-            gurobiModel->optimize();
+            optimizeGurobiModel();
+            gurobiCallback->stopBackgroundPrimalWorker();
+            gurobiCallback->stopIterationReporter();
 
             MIPSolutionStatus = getSolutionStatus();
 
@@ -176,6 +182,8 @@ void GurobiCallbackSingleTree::callback()
     if(where == GRB_CB_POLLING || where == GRB_CB_PRESOLVE || where == GRB_CB_SIMPLEX || where == GRB_CB_BARRIER)
         return;
 
+    TraceScope traceScope(env->traceRecorder.get(), "GurobiCallback");
+
     if(where == GRB_CB_MESSAGE && showOutput) // Show output on console and log
     {
         auto message = getStringInfo(GRB_CB_MSG_STRING);
@@ -185,29 +193,21 @@ void GurobiCallbackSingleTree::callback()
 
     try
     {
+        // Gurobi calls the callback from one thread at a time, but the background primal worker uses the same state
+        std::unique_lock<std::mutex> lock(callbackMutex, std::defer_lock);
 
-        // Add current primal bound as new incumbent candidate
-        auto primalBound = env->results->getPrimalBound();
-
-        if(((isMinimization && lastUpdatedPrimal < primalBound)
-               || (!isMinimization && lastUpdatedPrimal > primalBound)))
-        {
-            auto primalSol = env->results->primalSolution;
-
-            if((int)primalSol.size() < env->reformulatedProblem->properties.numberOfVariables)
-                env->reformulatedProblem->augmentAuxiliaryVariableValues(primalSol);
+        if(useBackgroundPrimalWorker)
+            lock.lock();
 
-            assert(env->reformulatedProblem->properties.numberOfVariables == primalSol.size());
-
-            if(env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
-                primalSol.push_back(env->reformulatedProblem->objectiveFunction->calculateValue(primalSol));
-
-            for(size_t i = 0; i < primalSol.size(); i++)
-            {
-                setSolution(vars[i], primalSol.at(i));
-            }
+        // Posts the best primal solution, which may also have been found by the background worker, solutions can only
+        // be set in the nodes
+        VectorDouble primalSolution;
+        double primalObjectiveValue;
 
-            lastUpdatedPrimal = env->results->getPrimalBound();
+        if(where == GRB_CB_MIPNODE && getPrimalSolutionToInject(primalSolution, primalObjectiveValue))
+        {
+            for(size_t i = 0; i < primalSolution.size(); i++)
+                setSolution(vars[i], primalSolution[i]);
         }
 
         // Check if better dual bound
@@ -251,20 +251,13 @@ void GurobiCallbackSingleTree::callback()
                 && ((isMinimization && tmpPrimalObjBound < env->results->getPrimalBound())
                     || (!isMinimization && tmpPrimalObjBound > env->results->getPrimalBound())))
             {
-                int numberOfVariables = env->problem->properties.numberOfVariables;
-                VectorDouble primalSolution(numberOfVariables);
-
-                for(int i = 0; i < numberOfVariables; i++)
-                {
-                    primalSolution.at(i) = getSolution(vars[i]);
-                }
-
                 SolutionPoint tmpPt;
+                getCallbackPoint(false, env->problem->properties.numberOfVariables, tmpPt.point);
 
                 if(env->problem->properties.numberOfNonlinearConstraints > 0)
                 {
                     auto maxDev = env->problem->getMaxNumericConstraintValue(
-                        primalSolution, env->problem->nonlinearConstraints);
+                        tmpPt.point, env->problem->nonlinearConstraints);
                     tmpPt.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
                 }
                 else
@@ -273,8 +266,7 @@ void GurobiCallbackSingleTree::callback()
                 }
 
                 tmpPt.iterFound = env->results->getCurrentIteration()->iterationNumber;
-                tmpPt.objectiveValue = env->problem->objectiveFunction->calculateValue(primalSolution);
-                tmpPt.point = primalSolution;
+                tmpPt.objectiveValue = env->problem->objectiveFunction->calculateValue(tmpPt.point);
 
                 env->primalSolver->addPrimalSolutionCandidate(tmpPt, E_PrimalSolutionSource::MIPCallback);
             }
@@ -294,26 +286,16 @@ void GurobiCallbackSingleTree::callback()
             {
                 int waitingListSize = env->dualSolver->hyperplaneWaitingList.size();
 
-                int numModelVars = static_cast<MIPSolverGurobiSingleTree*>(env->dualSolver->MIPSolver.get())
-                                       ->gurobiModel->get(GRB_IntAttr_NumVars);
-
-                int numberOfVariables = (env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable())
-                    ? numModelVars - 1
-                    : numModelVars;
+                // The point is extracted directly into the vector given to the tasks
+                std::vector<SolutionPoint> solutionPoints(1);
+                auto& solutionRelaxed = solutionPoints[0];
 
-                VectorDouble solution(numberOfVariables);
-
-                for(int i = 0; i < numberOfVariables; i++)
-                {
-                    solution.at(i) = getNodeRel(vars[i]);
-                }
-
-                SolutionPoint solutionRelaxed;
+                getCallbackPoint(true, getNumberOfDualVariables(), solutionRelaxed.point);
 
                 if(env->problem->properties.numberOfNonlinearConstraints > 0)
                 {
                     auto maxDev = env->reformulatedProblem->getMaxNumericConstraintValue(
-                        solution, env->reformulatedProblem->nonlinearConstraints);
+                        solutionRelaxed.point, env->reformulatedProblem->nonlinearConstraints);
                     solutionRelaxed.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
                 }
                 else
@@ -321,32 +303,34 @@ void GurobiCallbackSingleTree::callback()
                     solutionRelaxed.maxDeviation = PairIndexValue(-1, 0.0);
                 }
 
-                solutionRelaxed.point = solution;
-                solutionRelaxed.objectiveValue = env->reformulatedProblem->objectiveFunction->calculateValue(solution);
+                solutionRelaxed.objectiveValue
+                    = env->reformulatedProblem->objectiveFunction->calculateValue(solutionRelaxed.point);
                 solutionRelaxed.iterFound = env->results->getCurrentIteration()->iterationNumber;
                 solutionRelaxed.isRelaxedPoint = true;
 
-                std::vector<SolutionPoint> solutionPoints = { solutionRelaxed };
-
-                if(static_cast<ES_HyperplaneCutStrategy>(env->settings->getSetting<int>("CutStrategy", "Dual"))
-                    == ES_HyperplaneCutStrategy::ESH)
-                {
-                    tUpdateInteriorPoint->run();
-                    static_cast<TaskSelectHyperplanePointsESH*>(taskSelectHPPts.get())->run(solutionPoints);
-                }
-                else
+                // Gurobi does not give the depth of the node, and calls the callback from one thread at a time
+                if(relaxedCutPolicy.shouldSeparate(solutionRelaxed, -1, 0, env->timing->getElapsedTime("Total")))
                 {
-                    static_cast<TaskSelectHyperplanePointsECP*>(taskSelectHPPts.get())->run(solutionPoints);
-                }
+                    if(static_cast<ES_HyperplaneCutStrategy>(env->settings->getSetting<int>("CutStrategy", "Dual"))
+                        == ES_HyperplaneCutStrategy::ESH)
+                    {
+                        tUpdateInteriorPoint->run();
+                        static_cast<TaskSelectHyperplanePointsESH*>(taskSelectHPPts.get())->run(solutionPoints);
+                    }
+                    else
+                    {
+                        static_cast<TaskSelectHyperplanePointsECP*>(taskSelectHPPts.get())->run(solutionPoints);
+                    }
 
-                if(env->reformulatedProblem->objectiveFunction->properties.classification
-                    > E_ObjectiveFunctionClassification::Quadratic)
-                {
-                    taskSelectHPPtsByObjectiveRootsearch->run(solutionPoints);
-                }
+                    if(env->reformulatedProblem->objectiveFunction->properties.classification
+                        > E_ObjectiveFunctionClassification::Quadratic)
+                    {
+                        taskSelectHPPtsByObjectiveRootsearch->run(solutionPoints);
+                    }
 
-                env->results->getCurrentIteration()->relaxedLazyHyperplanesAdded
-                    += (env->dualSolver->hyperplaneWaitingList.size() - waitingListSize);
+                    env->results->getCurrentIteration()->relaxedLazyHyperplanesAdded
+                        += (env->dualSolver->hyperplaneWaitingList.size() - waitingListSize);
+                }
             }
         }
 
@@ -362,25 +346,15 @@ void GurobiCallbackSingleTree::callback()
                 currIter->dualProblemClass = env->dualSolver->MIPSolver->getProblemClass();
             }
 
-            int numModelVars = static_cast<MIPSolverGurobiSingleTree*>(env->dualSolver->MIPSolver.get())
-                                   ->gurobiModel->get(GRB_IntAttr_NumVars);
+            std::vector<SolutionPoint> candidatePoints(1);
+            auto& solutionCandidate = candidatePoints[0];
 
-            int numberOfVariables
-                = (env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable()) ? numModelVars - 1 : numModelVars;
-
-            VectorDouble solution(numberOfVariables);
-
-            for(int i = 0; i < numberOfVariables; i++)
-            {
-                solution.at(i) = getSolution(vars[i]);
-            }
-
-            SolutionPoint solutionCandidate;
+            getCallbackPoint(false, getNumberOfDualVariables(), solutionCandidate.point);
 
             if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
             {
                 auto maxDev = env->reformulatedProblem->getMaxNumericConstraintValue(
-                    solution, env->reformulatedProblem->nonlinearConstraints);
+                    solutionCandidate.point, env->reformulatedProblem->nonlinearConstraints);
 
                 solutionCandidate.maxDeviation = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
             }
@@ -389,12 +363,9 @@ void GurobiCallbackSingleTree::callback()
                 solutionCandidate.maxDeviation = PairIndexValue(-1, 0.0);
             }
 
-            solutionCandidate.point = solution;
             solutionCandidate.objectiveValue = getDoubleInfo(GRB_CB_MIPSOL_OBJ);
             solutionCandidate.iterFound = env->results->getCurrentIteration()->iterationNumber;
 
-            std::vector<SolutionPoint> candidatePoints { solutionCandidate };
-
             addLazyConstraint(candidatePoints);
 
             currIter->maxDeviation = solutionCandidate.maxDeviation.value;
@@ -410,13 +381,19 @@ void GurobiCallbackSingleTree::callback()
             currIter->currentObjectiveBounds = bounds;
 
             if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
-                && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+                && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0 && !useBackgroundPrimalWorker)
             {
                 taskSelectPrimalSolutionFromRootsearch.get()->run(candidatePoints);
                 env->primalSolver->checkPrimalSolutionCandidates();
             }
 
-            if(checkFixedNLPStrategy(candidatePoints.at(0)))
+            bool solveFixedNLP = checkFixedNLPStrategy(candidatePoints.at(0));
+
+            if(useBackgroundPrimalWorker)
+            {
+                addBackgroundPrimalCandidate(candidatePoints.at(0), solveFixedNLP);
+            }
+            else if(solveFixedNLP)
             {
                 if(taskSelectPrimNLPOriginal)
                 {
@@ -455,15 +432,14 @@ void GurobiCallbackSingleTree::callback()
                 }
 
                 if(addedIntegerCuts > 0)
-                    env->output->outputDebug(fmt::format("        Added {} integer cut(s)", addedIntegerCuts));
+                    env->output->outputDebug("        Added {} integer cut(s)", addedIntegerCuts);
 
                 env->dualSolver->integerCutWaitingList.clear();
             }
 
             currIter->isSolved = true;
 
-            auto threadId = "";
-            printIterationReport(candidatePoints.at(0), threadId);
+            printIterationReport(candidatePoints.at(0));
         }
 
         if(where == GRB_CB_MIP)
@@ -478,7 +454,24 @@ void GurobiCallbackSingleTree::callback()
     }
 }
 
-bool GurobiCallbackSingleTree::createHyperplane(Hyperplane hyperplane)
+int GurobiCallbackSingleTree::getNumberOfDualVariables()
+{
+    int numModelVars = static_cast<MIPSolverGurobiSingleTree*>(env->dualSolver->MIPSolver.get())
+                           ->gurobiModel->get(GRB_IntAttr_NumVars);
+
+    return ((env->dualSolver->MIPSolver->hasDualAuxiliaryObjectiveVariable()) ? numModelVars - 1 : numModelVars);
+}
+
+void GurobiCallbackSingleTree::getCallbackPoint(bool isRelaxationPoint, int numberOfVariables, VectorDouble& point)
+{
+    // The values are obtained with one call instead of one call per variable
+    double* values = isRelaxationPoint ? getNodeRel(vars, numberOfVariables) : getSolution(vars, numberOfVariables);
+
+    point.assign(values, values + numberOfVariables);
+    delete[] values;
+}
+
+bool GurobiCallbackSingleTree::createHyperplane(const Hyperplane& hyperplane)
 {
     try
     {
@@ -490,7 +483,7 @@ bool GurobiCallbackSingleTree::createHyperplane(Hyperplane hyperplane)
             return (false);
         }
 
-        auto tmpPair = optionalHyperplanes.value();
+        auto tmpPair = std::move(optionalHyperplanes.value());
 
         for(auto& E : tmpPair.first)
         {
@@ -597,10 +590,17 @@ GurobiCallbackSingleTree::GurobiCallbackSingleTree(GRBVar* xvars, EnvironmentPtr
         taskSelectPrimalSolutionFromRootsearch = std::make_shared<TaskSelectPrimalCandidatesFromRootsearch>(env);
     }
 
+    initializeBackgroundPrimalWorker();
+    initializeRelaxedCutPolicy();
+
     lastUpdatedPrimal = env->results->getPrimalBound();
 }
 
-GurobiCallbackSingleTree::~GurobiCallbackSingleTree() { delete[] vars; }
+GurobiCallbackSingleTree::~GurobiCallbackSingleTree()
+{
+    stopBackgroundPrimalWorker();
+    delete[] vars;
+}
 
 bool GurobiCallbackSingleTree::createIntegerCut(IntegerCut& integerCut)
 {
@@ -610,33 +610,19 @@ bool GurobiCallbackSingleTree::createIntegerCut(IntegerCut& integerCut)
         return (false);
     }
 
+    auto terms = env->dualSolver->getBinaryIntegerCutTerms(integerCut);
+
+    if(!terms)
+        return (false);
+
     try
     {
         GRBLinExpr expr = 0;
-        size_t index = 0;
-
-        for(auto& VAR : env->reformulatedProblem->allVariables)
-        {
-            if(!(VAR->properties.type == E_VariableType::Binary || VAR->properties.type == E_VariableType::Integer
-                   || VAR->properties.type == E_VariableType::Semiinteger))
-                continue;
-
-            int variableValue = integerCut.variableValues[index];
-            auto variable = vars[VAR->index];
-
-            if(variableValue == VAR->upperBound)
-            {
-                expr += (variableValue - variable);
-            }
-            else if(variableValue == VAR->lowerBound)
-            {
-                expr += variable;
-            }
 
-            index++;
-        }
+        for(auto& T : terms->first)
+            expr += T.second * vars[T.first];
 
-        addLazy(expr >= 1);
+        addLazy(expr <= -terms->second);
     }
     catch(GRBException& e)
     {
@@ -647,7 +633,7 @@ bool GurobiCallbackSingleTree::createIntegerCut(IntegerCut& integerCut)
     return (true);
 }
 
-void GurobiCallbackSingleTree::addLazyConstraint(std::vector<SolutionPoint> candidatePoints)
+void GurobiCallbackSingleTree::addLazyConstraint(const std::vector<SolutionPoint>& candidatePoints)
 {
     try
     {
@@ -31,11 +31,17 @@ private:
     int lastOpenNodes = 0;
     bool showOutput = false;
 
-    bool createHyperplane(Hyperplane hyperplane);
+    // The number of variables in the points, without the auxiliary objective variable
+    int getNumberOfDualVariables();
+
+    // Copies the solution or node relaxation of the callback into the given point
+    void getCallbackPoint(bool isRelaxationPoint, int numberOfVariables, VectorDouble& point);
+
+    bool createHyperplane(const Hyperplane& hyperplane);
 
     virtual bool createIntegerCut(IntegerCut& integerCut);
 
-    void addLazyConstraint(std::vector<SolutionPoint> candidatePoints);
+    void addLazyConstraint(const std::vector<SolutionPoint>& candidatePoints);
 };
 
 class MIPSolverGurobiSingleTree : public MIPSolverGurobi
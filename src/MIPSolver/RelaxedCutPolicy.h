@@ -0,0 +1,136 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Structs.h"
+#include "../Utilities.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace SHOT
+{
+
+// Decides which relaxed solutions in the nodes of a single-tree search are used to generate cuts, shared by the
+// threads of the MIP solver. A solution is skipped if its constraint violation is too small, if enough solutions have
+// been used at the same depth of the tree or during the last second, or if the same solution has already been used by
+// the same thread. A limit that is zero is not used.
+class RelaxedCutPolicy
+{
+public:
+    RelaxedCutPolicy() = default;
+
+    void setLimits(int maxPerDepth, double maxPerSecond, double minViolation, int cacheSize)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        maxSeparationsPerDepth = maxPerDepth;
+        maxSeparationsPerSecond = maxPerSecond;
+        minConstraintViolation = minViolation;
+        maxCacheSize = cacheSize;
+
+        separationsAtDepth.clear();
+        caches.clear();
+        availableSeparations = std::max(1.0, maxPerSecond);
+        timeLastSeparation = -1.0;
+    }
+
+    // The depth is -1 if not given by the MIP solver, and the time is the elapsed time in seconds
+    bool shouldSeparate(const SolutionPoint& point, int depth, int threadId, double currentTime)
+    {
+        if(point.maxDeviation.value < minConstraintViolation)
+        {
+            return (false);
+        }
+
+        auto hash = (maxCacheSize > 0) ? Utilities::calculateHash(point.point) : 0;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto& cache = caches[threadId];
+
+        if(maxCacheSize > 0 && cache.hashes.count(hash) > 0)
+        {
+            return (false);
+        }
+
+        bool useDepthLimit = (maxSeparationsPerDepth > 0 && depth >= 0);
+
+        if(useDepthLimit && depth >= (int)separationsAtDepth.size())
+            separationsAtDepth.resize(depth + 1, 0);
+
+        if(useDepthLimit && separationsAtDepth[depth] >= maxSeparationsPerDepth)
+        {
+            return (false);
+        }
+
+        // The separations become available at the given rate, and at most the number of one second are saved
+        if(maxSeparationsPerSecond > 0.0)
+        {
+            if(timeLastSeparation >= 0.0)
+            {
+                availableSeparations = std::min(std::max(1.0, maxSeparationsPerSecond),
+                    availableSeparations + (currentTime - timeLastSeparation) * maxSeparationsPerSecond);
+            }
+
+            timeLastSeparation = currentTime;
+
+            if(availableSeparations < 1.0)
+            {
+                return (false);
+            }
+
+            availableSeparations -= 1.0;
+        }
+
+        if(useDepthLimit)
+            separationsAtDepth[depth]++;
+
+        if(maxCacheSize > 0)
+        {
+            cache.hashes.insert(hash);
+            cache.order.push_back(hash);
+
+            if((int)cache.order.size() > maxCacheSize)
+            {
+                cache.hashes.erase(cache.order.front());
+                cache.order.pop_front();
+            }
+        }
+
+        return (true);
+    }
+
+private:
+    struct Cache
+    {
+        std::unordered_set<uint64_t> hashes;
+        std::deque<uint64_t> order;
+    };
+
+    std::mutex mutex;
+
+    int maxSeparationsPerDepth = 0;
+    double maxSeparationsPerSecond = 0.0;
+    double minConstraintViolation = 0.0;
+    int maxCacheSize = 0;
+
+    std::vector<int> separationsAtDepth;
+    std::unordered_map<int, Cache> caches;
+    double availableSeparations = 1.0;
+    double timeLastSeparation = -1.0;
+};
+} // namespace SHOT
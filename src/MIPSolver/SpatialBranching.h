@@ -0,0 +1,175 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include "../Model/AuxiliaryVariables.h"
+#include "../Model/Problem.h"
+#include "../Model/Terms.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// Spatial branching on the continuous variables in the bilinear terms w = x * y of the reformulated problem, used in
+// the single-tree strategy for nonconvex problems. The McCormick envelopes of a term over the bounds in a node are
+// tighter than the global ones and are added as local cuts. If a term is still violated, the node is split on one of
+// its variables. The points and bounds are given for all variables in the dual problem.
+class SpatialBranching
+{
+public:
+    // The cut sum(coefficient * x[index]) <= rhs
+    struct LocalCut
+    {
+        std::vector<std::pair<int, double>> terms;
+        double rhs = 0.0;
+    };
+
+    // The index is -1 if no term is violated more than the tolerance
+    struct Branch
+    {
+        int variableIndex = -1;
+        double value = 0.0;
+    };
+
+    SpatialBranching(double violationTolerance) : tolerance(violationTolerance) { }
+
+    void addTerm(int auxiliaryVariableIndex, int firstVariableIndex, int secondVariableIndex)
+    {
+        if(firstVariableIndex != secondVariableIndex)
+            terms.push_back({ auxiliaryVariableIndex, firstVariableIndex, secondVariableIndex });
+    }
+
+    // Adds the terms of the auxiliary variables that linearize a product of two continuous variables
+    void addTerms(const Problem& problem)
+    {
+        for(auto& V : problem.auxiliaryVariables)
+        {
+            if(V->properties.auxiliaryType != E_AuxiliaryVariableType::ContinuousBilinear
+                || V->quadraticTerms.size() != 1 || V->linearTerms.size() > 0 || V->constant != 0.0)
+                continue;
+
+            auto& T = V->quadraticTerms[0];
+
+            if(T->coefficient == 1.0)
+                addTerm(V->index, T->firstVariable->index, T->secondVariable->index);
+        }
+    }
+
+    bool hasTerms() const { return (terms.size() > 0); }
+
+    std::vector<LocalCut> getViolatedEnvelopes(
+        const VectorDouble& point, const VectorDouble& lowerBounds, const VectorDouble& upperBounds) const
+    {
+        std::vector<LocalCut> cuts;
+
+        for(auto& T : terms)
+        {
+            double xl = lowerBounds[T.first], xu = upperBounds[T.first];
+            double yl = lowerBounds[T.second], yu = upperBounds[T.second];
+
+            if(!isFinite(xl) || !isFinite(xu) || !isFinite(yl) || !isFinite(yu))
+                continue;
+
+            // w >= xl * y + yl * x - xl * yl, w >= xu * y + yu * x - xu * yu
+            // w <= xu * y + yl * x - xu * yl, w <= xl * y + yu * x - xl * yu
+            addIfViolated(cuts, point, T, -1.0, yl, xl, xl * yl);
+            addIfViolated(cuts, point, T, -1.0, yu, xu, xu * yu);
+            addIfViolated(cuts, point, T, 1.0, -yl, -xu, -xu * yl);
+            addIfViolated(cuts, point, T, 1.0, -yu, -xl, -xl * yu);
+        }
+
+        return (cuts);
+    }
+
+    // Selects the most violated term, and the variable in it with the widest domain. The value is moved away from the
+    // bounds so that both children are smaller than the node.
+    Branch selectBranch(
+        const VectorDouble& point, const VectorDouble& lowerBounds, const VectorDouble& upperBounds) const
+    {
+        Branch branch;
+        double maxViolation = tolerance;
+
+        for(auto& T : terms)
+        {
+            double violation = std::abs(point[T.auxiliary] - point[T.first] * point[T.second]);
+
+            if(violation <= maxViolation)
+                continue;
+
+            int index = (upperBounds[T.first] - lowerBounds[T.first] >= upperBounds[T.second] - lowerBounds[T.second])
+                ? T.first
+                : T.second;
+
+            double width = upperBounds[index] - lowerBounds[index];
+
+            if(!(width > minimumWidth))
+                continue;
+
+            double value = point[index];
+
+            if(isFinite(lowerBounds[index]) && isFinite(upperBounds[index]))
+                value = std::clamp(value, lowerBounds[index] + 0.1 * width, upperBounds[index] - 0.1 * width);
+            else if(value <= lowerBounds[index] || value >= upperBounds[index])
+                continue;
+
+            maxViolation = violation;
+            branch.variableIndex = index;
+            branch.value = value;
+        }
+
+        return (branch);
+    }
+
+private:
+    struct BilinearTerm
+    {
+        int auxiliary;
+        int first;
+        int second;
+    };
+
+    // Bounds larger than this give envelopes that are numerically useless
+    static constexpr double maximumBound = 1e10;
+
+    // Variables with narrower domains are not branched on
+    static constexpr double minimumWidth = 1e-6;
+
+    std::vector<BilinearTerm> terms;
+    double tolerance;
+
+    static bool isFinite(double bound) { return (std::abs(bound) < maximumBound); }
+
+    // The cut auxiliaryCoefficient * w + firstCoefficient * x + secondCoefficient * y <= rhs
+    void addIfViolated(std::vector<LocalCut>& cuts, const VectorDouble& point, const BilinearTerm& term,
+        double auxiliaryCoefficient, double firstCoefficient, double secondCoefficient, double rhs) const
+    {
+        double lhs = auxiliaryCoefficient * point[term.auxiliary] + firstCoefficient * point[term.first]
+            + secondCoefficient * point[term.second];
+
+        if(lhs - rhs <= tolerance)
+            return;
+
+        LocalCut cut;
+        cut.terms = { { term.auxiliary, auxiliaryCoefficient }, { term.first, firstCoefficient },
+            { term.second, secondCoefficient } };
+        cut.rhs = rhs;
+
+        cuts.push_back(std::move(cut));
+    }
+};
+} // namespace SHOT
@@ -0,0 +1,227 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "MemoryMonitor.h"
+
+#include "DualSolver.h"
+#include "Iteration.h"
+#include "Output.h"
+#include "Results.h"
+#include "Settings.h"
+
+#include "Model/Problem.h"
+
+namespace SHOT
+{
+
+// The elements held through shared pointers are allocated together with the control block of the pointer
+static constexpr size_t sharedElementOverhead = sizeof(std::shared_ptr<void>) + 2 * sizeof(long);
+
+void MemoryMonitor::update(bool useLimit)
+{
+    std::tie(usage.residentMemory, usage.peakResidentMemory) = sample();
+
+    usage.modelMemory = 0;
+    usage.tapeMemory = 0;
+
+    for(auto& P : { env->problem, env->reformulatedProblem })
+    {
+        if(!P || (P == env->reformulatedProblem && P == env->problem))
+            continue;
+
+        usage.modelMemory += estimateModelMemory(P);
+        usage.tapeMemory += estimateTapeMemory(P);
+    }
+
+    usage.cutPoolMemory = estimateCutPoolMemory();
+    usage.iterationHistoryMemory = estimateIterationHistoryMemory();
+
+    if(env->metrics)
+    {
+        env->metrics->setGauge(E_MetricsGauge::ModelMemory, usage.modelMemory);
+        env->metrics->setGauge(E_MetricsGauge::CutPoolMemory, usage.cutPoolMemory);
+        env->metrics->setGauge(E_MetricsGauge::IterationHistoryMemory, usage.iterationHistoryMemory);
+        env->metrics->setGauge(E_MetricsGauge::TapeMemory, usage.tapeMemory);
+    }
+
+    if(!useLimit)
+        return;
+
+    double limit = env->settings->getSetting<double>("Memory.Limit", "Strategy");
+
+    if(!isLimitApplied && usage.residentMemory > 0 && usage.residentMemory > limit * 1024.0 * 1024.0)
+        applyLimit();
+}
+
+void MemoryMonitor::applyLimit()
+{
+    isLimitApplied = true;
+
+    env->output->outputWarning(fmt::format("        Resident memory {:.1f} MB exceeds the memory limit of {} MB.",
+        usage.residentMemory / (1024.0 * 1024.0), env->settings->getSetting<double>("Memory.Limit", "Strategy")));
+
+    // The points of the cuts generated from now on are only kept in the file
+    if(env->settings->getSetting<std::string>("HyperplaneCuts.DiskStore.File", "Dual") == "")
+    {
+        auto spillFile = env->settings->getSetting<std::string>("Memory.SpillFile", "Strategy");
+
+        if(spillFile == "")
+        {
+            auto directory = Utilities::createTemporaryDirectory("SHOT_cuts_");
+
+            if(directory != "")
+                spillFile = directory + "/cuts.dat";
+        }
+
+        if(spillFile != "")
+        {
+            env->settings->updateSetting("HyperplaneCuts.DiskStore.File", "Dual", spillFile);
+            env->output->outputWarning("        The points of new cuts are kept in the file " + spillFile);
+        }
+    }
+
+    int maxRetained = env->settings->getSetting<int>("Memory.RetainedIterations", "Strategy");
+    int retained = env->settings->getSetting<int>("Iterations.Retained", "Output");
+
+    if(retained == 0 || retained > maxRetained)
+    {
+        env->settings->updateSetting("Iterations.Retained", "Output", maxRetained);
+        env->output->outputWarning(fmt::format("        Only the last {} iterations are retained.", maxRetained));
+    }
+
+    env->settings->updateSetting("Iterations.KeepPointData", "Output", false);
+}
+
+size_t MemoryMonitor::estimateModelMemory(const ProblemPtr& problem)
+{
+    size_t bytes = sizeof(Problem);
+
+    for(auto& V : problem->allVariables)
+        bytes += sharedElementOverhead + sizeof(Variable) + V->name.capacity();
+
+    for(auto& C : problem->numericConstraints)
+    {
+        bytes += sharedElementOverhead + C->name.capacity();
+
+        auto nonlinearConstraint = std::dynamic_pointer_cast<NonlinearConstraint>(C);
+        auto quadraticConstraint = std::dynamic_pointer_cast<QuadraticConstraint>(C);
+        auto linearConstraint = std::dynamic_pointer_cast<LinearConstraint>(C);
+
+        if(nonlinearConstraint)
+        {
+            bytes += sizeof(NonlinearConstraint)
+                + nonlinearConstraint->monomialTerms.size() * (sharedElementOverhead + sizeof(MonomialTerm))
+                + nonlinearConstraint->signomialTerms.size() * (sharedElementOverhead + sizeof(SignomialTerm));
+        }
+        else if(quadraticConstraint)
+        {
+            bytes += sizeof(QuadraticConstraint);
+        }
+        else if(linearConstraint)
+        {
+            bytes += sizeof(LinearConstraint);
+        }
+
+        if(quadraticConstraint)
+            bytes += quadraticConstraint->quadraticTerms.size() * (sharedElementOverhead + sizeof(QuadraticTerm));
+
+        if(linearConstraint)
+            bytes += linearConstraint->linearTerms.size() * (sharedElementOverhead + sizeof(LinearTerm));
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction))
+        bytes += objective->linearTerms.size() * (sharedElementOverhead + sizeof(LinearTerm));
+
+    if(auto objective = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(problem->objectiveFunction))
+        bytes += objective->quadraticTerms.size() * (sharedElementOverhead + sizeof(QuadraticTerm));
+
+    if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(problem->objectiveFunction))
+    {
+        bytes += objective->monomialTerms.size() * (sharedElementOverhead + sizeof(MonomialTerm))
+            + objective->signomialTerms.size() * (sharedElementOverhead + sizeof(SignomialTerm));
+    }
+
+    return (bytes);
+}
+
+size_t MemoryMonitor::estimateTapeMemory(const ProblemPtr& problem)
+{
+    // Each thread evaluating the recordings has its own copy of them
+    size_t bytes = problem->getADFunctionsMemoryUsage();
+
+    for(auto& C : problem->nonlinearConstraints)
+    {
+        if(C->nonlinearExpressionTape)
+            bytes += C->nonlinearExpressionTape->getMemoryUsage();
+
+        bytes += C->getADFunctionMemoryUsage();
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(problem->objectiveFunction);
+        objective && objective->nonlinearExpressionTape)
+    {
+        bytes += objective->nonlinearExpressionTape->getMemoryUsage();
+    }
+
+    return (bytes);
+}
+
+size_t MemoryMonitor::estimateCutPoolMemory()
+{
+    auto& dualSolver = env->dualSolver;
+
+    if(!dualSolver)
+        return (0);
+
+    size_t bytes = dualSolver->generatedHyperplanes.capacity() * sizeof(GeneratedHyperplane)
+        + dualSolver->hyperplaneWaitingList.capacity() * sizeof(Hyperplane)
+        + dualSolver->hyperplanePointStore.getMemoryUsage();
+
+    for(auto& H : dualSolver->hyperplaneWaitingList)
+        bytes += H.generatedPoint.capacity() * sizeof(double);
+
+    for(auto* integerCuts : { &dualSolver->generatedIntegerCuts, &dualSolver->integerCutWaitingList })
+    {
+        bytes += integerCuts->capacity() * sizeof(IntegerCut);
+
+        for(auto& C : *integerCuts)
+            bytes += (C.variableIndexes.capacity() + C.variableValues.capacity()) * sizeof(int);
+    }
+
+    return (bytes);
+}
+
+size_t MemoryMonitor::estimateIterationHistoryMemory()
+{
+    auto& results = env->results;
+
+    if(!results)
+        return (0);
+
+    // A summary is kept for every iteration
+    size_t bytes = results->getNumberOfIterations() * sizeof(IterationSummary);
+
+    for(auto& I : results->iterations)
+    {
+        bytes += sharedElementOverhead + sizeof(Iteration) + I->solutionPoints.capacity() * sizeof(SolutionPoint)
+            + I->constraintDeviations.capacity() * sizeof(double)
+            + I->hyperplanePoints.capacity() * sizeof(VectorDouble);
+
+        for(auto& P : I->solutionPoints)
+            bytes += P.point.capacity() * sizeof(double);
+
+        for(auto& P : I->hyperplanePoints)
+            bytes += P.capacity() * sizeof(double);
+    }
+
+    return (bytes);
+}
+
+} // namespace SHOT
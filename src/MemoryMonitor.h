@@ -0,0 +1,82 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Environment.h"
+#include "Metrics.h"
+#include "TraceRecorder.h"
+#include "Utilities.h"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace SHOT
+{
+
+// The memory use in bytes
+struct MemoryUsage
+{
+    size_t residentMemory = 0;
+    size_t peakResidentMemory = 0;
+
+    // Estimated from the sizes of the containers, so the allocator overhead and the expression trees are not included
+    size_t modelMemory = 0;
+    size_t cutPoolMemory = 0;
+    size_t iterationHistoryMemory = 0;
+    size_t tapeMemory = 0;
+};
+
+// Samples the resident memory of the process at the boundaries of the solver phases, i.e. when the top level timers are
+// started and stopped, and estimates the memory of the problems, the cuts, the iterations and the tapes after each
+// iteration. The values are given as gauges in the metrics and as counters in the timeline. When the resident memory
+// first exceeds Memory.Limit, the points of the new cuts are kept in a file and fewer iterations are retained.
+class MemoryMonitor
+{
+public:
+    inline MemoryMonitor(EnvironmentPtr envPtr) : env(envPtr) { }
+
+    // Returns the current and peak resident memory, which are 0 if not available on the platform
+    inline std::pair<size_t, size_t> sample()
+    {
+        size_t residentMemory = Utilities::getResidentMemory();
+        size_t peakResidentMemory = std::max(Utilities::getPeakResidentMemory(), residentMemory);
+
+        if(env->metrics)
+        {
+            env->metrics->setGauge(E_MetricsGauge::ResidentMemory, residentMemory);
+            env->metrics->setGauge(E_MetricsGauge::PeakResidentMemory, peakResidentMemory);
+        }
+
+        if(env->traceRecorder)
+            env->traceRecorder->counter("resident memory", residentMemory);
+
+        return (std::make_pair(residentMemory, peakResidentMemory));
+    }
+
+    // Updates the estimates and applies the memory limit if it is used, should be called from the main thread
+    void update(bool useLimit = true);
+
+    // The values from the last update
+    inline const MemoryUsage& getUsage() const { return (usage); }
+
+private:
+    EnvironmentPtr env;
+    MemoryUsage usage;
+
+    bool isLimitApplied = false;
+    void applyLimit();
+
+    size_t estimateModelMemory(const ProblemPtr& problem);
+    size_t estimateTapeMemory(const ProblemPtr& problem);
+    size_t estimateCutPoolMemory();
+    size_t estimateIterationHistoryMemory();
+};
+
+} // namespace SHOT
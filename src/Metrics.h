@@ -0,0 +1,414 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Enums.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace SHOT
+{
+
+struct MetricsHistogramValues
+{
+    // The upper bounds of the buckets in seconds, the last bucket has no upper bound
+    std::vector<double> upperBounds;
+
+    // The number of observations in each bucket (not cumulative)
+    std::vector<uint64_t> counts;
+
+    uint64_t count = 0;
+    double sum = 0.0;
+};
+
+// Low-overhead counters and latency histograms for the hot paths of the solver. The values are kept in a fixed number
+// of cache line aligned shards, and each thread always updates the same shard with relaxed atomic operations, so that
+// threads running in parallel (e.g. the root searches) do not compete for the same cache line. The shards are summed
+// when the values are queried. The gauges are only set at a few points, e.g. with the memory use sampled by
+// MemoryMonitor, and are therefore not sharded.
+class Metrics
+{
+public:
+    // Bucket i has the upper bound 2^i microseconds, the last bucket is unbounded
+    static constexpr int NumberOfBuckets = 28;
+    static constexpr int NumberOfShards = 16;
+
+    inline Metrics() = default;
+    inline ~Metrics() = default;
+
+    inline void increment(E_MetricsCounter counter, uint64_t value = 1)
+    {
+        getShard().counters[(int)counter].fetch_add(value, std::memory_order_relaxed);
+    }
+
+    inline void observe(E_MetricsHistogram histogram, double seconds)
+    {
+        int bucket = 0;
+        double microseconds = seconds * 1e6;
+
+        if(microseconds > 1.0)
+            bucket = std::min(NumberOfBuckets - 1, (int)std::ceil(std::log2(microseconds)));
+
+        auto& shard = getShard();
+        shard.buckets[(int)histogram][bucket].fetch_add(1, std::memory_order_relaxed);
+        shard.sums[(int)histogram].fetch_add((uint64_t)(std::max(0.0, seconds) * 1e9), std::memory_order_relaxed);
+    }
+
+    inline void setGauge(E_MetricsGauge gauge, uint64_t value)
+    {
+        gauges[(int)gauge].store(value, std::memory_order_relaxed);
+    }
+
+    inline uint64_t getGaugeValue(E_MetricsGauge gauge) const
+    {
+        return (gauges[(int)gauge].load(std::memory_order_relaxed));
+    }
+
+    inline uint64_t getCounterValue(E_MetricsCounter counter) const
+    {
+        uint64_t value = 0;
+
+        for(auto& S : shards)
+            value += S.counters[(int)counter].load(std::memory_order_relaxed);
+
+        return (value);
+    }
+
+    inline MetricsHistogramValues getHistogramValues(E_MetricsHistogram histogram) const
+    {
+        MetricsHistogramValues values;
+        values.counts.resize(NumberOfBuckets, 0);
+        uint64_t nanoseconds = 0;
+
+        for(int i = 0; i < NumberOfBuckets - 1; i++)
+            values.upperBounds.push_back(std::ldexp(1e-6, i));
+
+        values.upperBounds.push_back(std::numeric_limits<double>::infinity());
+
+        for(auto& S : shards)
+        {
+            for(int i = 0; i < NumberOfBuckets; i++)
+                values.counts[i] += S.buckets[(int)histogram][i].load(std::memory_order_relaxed);
+
+            nanoseconds += S.sums[(int)histogram].load(std::memory_order_relaxed);
+        }
+
+        for(auto C : values.counts)
+            values.count += C;
+
+        values.sum = nanoseconds * 1e-9;
+
+        return (values);
+    }
+
+    inline void clear()
+    {
+        for(auto& S : shards)
+        {
+            for(auto& C : S.counters)
+                C.store(0, std::memory_order_relaxed);
+
+            for(auto& H : S.buckets)
+            {
+                for(auto& B : H)
+                    B.store(0, std::memory_order_relaxed);
+            }
+
+            for(auto& T : S.sums)
+                T.store(0, std::memory_order_relaxed);
+        }
+
+        for(auto& G : gauges)
+            G.store(0, std::memory_order_relaxed);
+    }
+
+    // Returns the metrics in the Prometheus text exposition format
+    inline std::string getPrometheusFormat() const
+    {
+        std::string output;
+
+        for(int i = 0; i < (int)E_MetricsCounter::NumberOfCounters; i++)
+        {
+            auto counter = static_cast<E_MetricsCounter>(i);
+            auto name = getName(counter);
+
+            output += fmt::format("# HELP shot_{}_total {}\n", name, getDescription(counter));
+            output += fmt::format("# TYPE shot_{}_total counter\n", name);
+            output += fmt::format("shot_{}_total {}\n", name, getCounterValue(counter));
+        }
+
+        for(int i = 0; i < (int)E_MetricsHistogram::NumberOfHistograms; i++)
+        {
+            auto histogram = static_cast<E_MetricsHistogram>(i);
+            auto name = getName(histogram);
+            auto values = getHistogramValues(histogram);
+
+            output += fmt::format("# HELP shot_{}_seconds {}\n", name, getDescription(histogram));
+            output += fmt::format("# TYPE shot_{}_seconds histogram\n", name);
+
+            uint64_t cumulativeCount = 0;
+
+            for(int j = 0; j < NumberOfBuckets; j++)
+            {
+                cumulativeCount += values.counts[j];
+
+                output += fmt::format("shot_{}_seconds_bucket{{le=\"{}\"}} {}\n", name,
+                    j < NumberOfBuckets - 1 ? fmt::format("{}", values.upperBounds[j]) : "+Inf", cumulativeCount);
+            }
+
+            output += fmt::format("shot_{}_seconds_sum {}\n", name, values.sum);
+            output += fmt::format("shot_{}_seconds_count {}\n", name, values.count);
+        }
+
+        for(int i = 0; i < (int)E_MetricsGauge::NumberOfGauges; i++)
+        {
+            auto gauge = static_cast<E_MetricsGauge>(i);
+            auto name = getName(gauge);
+
+            output += fmt::format("# HELP shot_{}_bytes {}\n", name, getDescription(gauge));
+            output += fmt::format("# TYPE shot_{}_bytes gauge\n", name);
+            output += fmt::format("shot_{}_bytes {}\n", name, getGaugeValue(gauge));
+        }
+
+        return (output);
+    }
+
+    // Returns the metrics as a JSON object
+    inline std::string getJSONFormat() const
+    {
+        std::string output = "{\n  \"counters\": {\n";
+
+        for(int i = 0; i < (int)E_MetricsCounter::NumberOfCounters; i++)
+        {
+            auto counter = static_cast<E_MetricsCounter>(i);
+
+            output += fmt::format("    \"{}\": {}{}\n", getName(counter), getCounterValue(counter),
+                i < (int)E_MetricsCounter::NumberOfCounters - 1 ? "," : "");
+        }
+
+        output += "  },\n  \"histograms\": {\n";
+
+        for(int i = 0; i < (int)E_MetricsHistogram::NumberOfHistograms; i++)
+        {
+            auto histogram = static_cast<E_MetricsHistogram>(i);
+            auto values = getHistogramValues(histogram);
+
+            output += fmt::format("    \"{}_seconds\": {{\n", getName(histogram));
+            output += fmt::format("      \"count\": {},\n      \"sum\": {},\n", values.count, values.sum);
+            output += "      \"buckets\": [";
+
+            for(int j = 0; j < NumberOfBuckets; j++)
+            {
+                // JSON has no infinity, so the upper bound of the last bucket is given as null
+                output += fmt::format("{}{{ \"le\": {}, \"count\": {} }}", j > 0 ? ", " : "",
+                    j < NumberOfBuckets - 1 ? fmt::format("{}", values.upperBounds[j]) : "null", values.counts[j]);
+            }
+
+            output += fmt::format("]\n    }}{}\n", i < (int)E_MetricsHistogram::NumberOfHistograms - 1 ? "," : "");
+        }
+
+        output += "  },\n  \"gauges\": {\n";
+
+        for(int i = 0; i < (int)E_MetricsGauge::NumberOfGauges; i++)
+        {
+            auto gauge = static_cast<E_MetricsGauge>(i);
+
+            output += fmt::format("    \"{}_bytes\": {}{}\n", getName(gauge), getGaugeValue(gauge),
+                i < (int)E_MetricsGauge::NumberOfGauges - 1 ? "," : "");
+        }
+
+        output += "  }\n}\n";
+
+        return (output);
+    }
+
+    static inline std::string getName(E_MetricsCounter counter)
+    {
+        switch(counter)
+        {
+        case E_MetricsCounter::ConstraintEvaluations:
+            return ("constraint_evaluations");
+        case E_MetricsCounter::GradientEvaluations:
+            return ("gradient_evaluations");
+        case E_MetricsCounter::RootsearchCalls:
+            return ("rootsearch_calls");
+        case E_MetricsCounter::RootsearchIterations:
+            return ("rootsearch_iterations");
+        case E_MetricsCounter::RootsearchWarmStarts:
+            return ("rootsearch_warm_starts");
+        case E_MetricsCounter::CutsGenerated:
+            return ("cuts_generated");
+        case E_MetricsCounter::CutsFiltered:
+            return ("cuts_filtered");
+        case E_MetricsCounter::CutsAdded:
+            return ("cuts_added");
+        case E_MetricsCounter::MIPProblems:
+            return ("mip_problems");
+        case E_MetricsCounter::NLPProblems:
+            return ("nlp_problems");
+        default:
+            return ("unknown");
+        }
+    }
+
+    static inline std::string getName(E_MetricsHistogram histogram)
+    {
+        switch(histogram)
+        {
+        case E_MetricsHistogram::RootsearchTime:
+            return ("rootsearch_duration");
+        case E_MetricsHistogram::MIPSolveTime:
+            return ("mip_solve_duration");
+        case E_MetricsHistogram::NLPSolveTime:
+            return ("nlp_solve_duration");
+        default:
+            return ("unknown");
+        }
+    }
+
+    static inline std::string getName(E_MetricsGauge gauge)
+    {
+        switch(gauge)
+        {
+        case E_MetricsGauge::ResidentMemory:
+            return ("resident_memory");
+        case E_MetricsGauge::PeakResidentMemory:
+            return ("peak_resident_memory");
+        case E_MetricsGauge::ModelMemory:
+            return ("model_memory");
+        case E_MetricsGauge::CutPoolMemory:
+            return ("cut_pool_memory");
+        case E_MetricsGauge::IterationHistoryMemory:
+            return ("iteration_history_memory");
+        case E_MetricsGauge::TapeMemory:
+            return ("tape_memory");
+        default:
+            return ("unknown");
+        }
+    }
+
+    static inline std::string getDescription(E_MetricsCounter counter)
+    {
+        switch(counter)
+        {
+        case E_MetricsCounter::ConstraintEvaluations:
+            return ("Number of numeric constraint evaluations.");
+        case E_MetricsCounter::GradientEvaluations:
+            return ("Number of constraint and objective gradient evaluations.");
+        case E_MetricsCounter::RootsearchCalls:
+            return ("Number of root searches.");
+        case E_MetricsCounter::RootsearchIterations:
+            return ("Number of iterations in the root searches.");
+        case E_MetricsCounter::RootsearchWarmStarts:
+            return ("Number of root searches started in a bracket around a previous root.");
+        case E_MetricsCounter::CutsGenerated:
+            return ("Number of cuts generated and put in the waiting list.");
+        case E_MetricsCounter::CutsFiltered:
+            return ("Number of cuts discarded as duplicate, almost parallel or with low efficacy.");
+        case E_MetricsCounter::CutsAdded:
+            return ("Number of cuts added to the dual problem.");
+        case E_MetricsCounter::MIPProblems:
+            return ("Number of solved dual (MIP, LP or QP) problems.");
+        case E_MetricsCounter::NLPProblems:
+            return ("Number of solved NLP problems, including the minimax problems.");
+        default:
+            return ("");
+        }
+    }
+
+    static inline std::string getDescription(E_MetricsHistogram histogram)
+    {
+        switch(histogram)
+        {
+        case E_MetricsHistogram::RootsearchTime:
+            return ("Duration of the root searches.");
+        case E_MetricsHistogram::MIPSolveTime:
+            return ("Duration of the dual (MIP, LP or QP) problem solves.");
+        case E_MetricsHistogram::NLPSolveTime:
+            return ("Duration of the NLP problem solves.");
+        default:
+            return ("");
+        }
+    }
+
+    static inline std::string getDescription(E_MetricsGauge gauge)
+    {
+        switch(gauge)
+        {
+        case E_MetricsGauge::ResidentMemory:
+            return ("Resident memory of the process when last sampled.");
+        case E_MetricsGauge::PeakResidentMemory:
+            return ("Peak resident memory of the process.");
+        case E_MetricsGauge::ModelMemory:
+            return ("Estimated memory of the variables, constraints and terms of the problems.");
+        case E_MetricsGauge::CutPoolMemory:
+            return ("Estimated memory of the generated and waiting cuts and their points.");
+        case E_MetricsGauge::IterationHistoryMemory:
+            return ("Estimated memory of the retained iterations and the iteration summaries.");
+        case E_MetricsGauge::TapeMemory:
+            return ("Estimated memory of the compiled expression tapes and the CppAD recordings.");
+        default:
+            return ("");
+        }
+    }
+
+private:
+    struct alignas(64) Shard
+    {
+        std::array<std::atomic<uint64_t>, (int)E_MetricsCounter::NumberOfCounters> counters {};
+        std::array<std::array<std::atomic<uint64_t>, NumberOfBuckets>, (int)E_MetricsHistogram::NumberOfHistograms>
+            buckets {};
+        std::array<std::atomic<uint64_t>, (int)E_MetricsHistogram::NumberOfHistograms> sums {};
+    };
+
+    std::array<Shard, NumberOfShards> shards {};
+    std::array<std::atomic<uint64_t>, (int)E_MetricsGauge::NumberOfGauges> gauges {};
+
+    inline Shard& getShard()
+    {
+        static std::atomic<int> numberOfThreads { 0 };
+        thread_local int shardIndex = numberOfThreads.fetch_add(1, std::memory_order_relaxed) % NumberOfShards;
+
+        return (shards[shardIndex]);
+    }
+};
+
+// Measures the time until it goes out of scope and records it in the given histogram
+class MetricsTimer
+{
+public:
+    inline MetricsTimer(Metrics* metricsPtr, E_MetricsHistogram histogramType)
+        : metrics(metricsPtr), histogram(histogramType), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    inline ~MetricsTimer()
+    {
+        if(metrics)
+            metrics->observe(histogram,
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+
+private:
+    Metrics* metrics;
+    E_MetricsHistogram histogram;
+    std::chrono::steady_clock::time_point start;
+};
+} // namespace SHOT
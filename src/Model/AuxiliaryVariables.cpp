@@ -152,6 +152,10 @@ std::ostream& operator<<(std::ostream& stream, AuxiliaryVariablePtr var)
         auxtype << "cont. bilinear lin.";
         break;
 
+    case E_AuxiliaryVariableType::BilinearPartitioning:
+        auxtype << "cont. bilinear part.";
+        break;
+
     case E_AuxiliaryVariableType::BinaryBilinear:
         auxtype << "bin bilinear lin.";
         break;
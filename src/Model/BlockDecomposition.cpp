@@ -0,0 +1,577 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "BlockDecomposition.h"
+
+#include "../Output.h"
+#include "../Settings.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace SHOT
+{
+
+BlockDecomposition::BlockDecomposition(EnvironmentPtr envPtr, ProblemPtr sourceProblem)
+    : env(envPtr), sourceProblem(sourceProblem)
+{
+}
+
+bool BlockDecomposition::createBlocks()
+{
+    blocks.clear();
+    masterConstraints.clear();
+    masterLinearTerms.clear();
+    masterQuadraticTerms.clear();
+
+    auto rejectDecomposition = [&](std::string reason) {
+        env->output->outputDebug(fmt::format("  Problem cannot be decomposed: {}.", reason));
+        return (false);
+    };
+
+    // The cuts from the block problems are only valid if the blocks are convex
+    if(sourceProblem->properties.convexity != E_ProblemConvexity::Convex)
+        return (rejectDecomposition("the problem is not convex"));
+
+    if(sourceProblem->properties.numberOfDiscreteVariables == 0)
+        return (rejectDecomposition("there are no discrete variables"));
+
+    if(sourceProblem->properties.numberOfSemicontinuousVariables > 0
+        || sourceProblem->properties.numberOfSemiintegerVariables > 0
+        || sourceProblem->properties.numberOfSpecialOrderedSets > 0)
+        return (rejectDecomposition("there are semicontinuous variables or special ordered sets"));
+
+    // The value of this variable is given by the objective function, and not by a block
+    if(sourceProblem->antiEpigraphObjectiveVariable)
+        return (rejectDecomposition("the objective variable has been removed"));
+
+    isMinimize = sourceProblem->objectiveFunction->properties.isMinimize;
+    objectiveSign = isMinimize ? 1.0 : -1.0;
+    masterConstant = sourceProblem->objectiveFunction->constant;
+
+    int numberOfVariables = sourceProblem->allVariables.size();
+
+    // The continuous variables in the same constraint or objective term are joined into the same block
+    VectorInteger parents(numberOfVariables);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto findRoot = [&](int index) {
+        while(parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+
+        return (index);
+    };
+
+    auto joinVariables = [&](const VectorInteger& variables) {
+        int firstRoot = -1;
+
+        for(auto I : variables)
+        {
+            if(isDiscrete(I))
+                continue;
+
+            if(firstRoot < 0)
+                firstRoot = findRoot(I);
+            else
+                parents[findRoot(I)] = firstRoot;
+        }
+
+        return (firstRoot >= 0);
+    };
+
+    std::vector<VectorInteger> constraintVariables;
+    constraintVariables.reserve(sourceProblem->numericConstraints.size());
+
+    for(auto& C : sourceProblem->numericConstraints)
+    {
+        constraintVariables.push_back(getVariableIndexes(C));
+
+        if(joinVariables(constraintVariables.back()))
+            continue;
+
+        if(C->properties.classification != E_ConstraintClassification::Linear)
+            return (rejectDecomposition(fmt::format("constraint {} is nonlinear in the discrete variables", C->name)));
+
+        masterConstraints.push_back(std::dynamic_pointer_cast<LinearConstraint>(C));
+    }
+
+    auto objectiveTerms = getObjectiveTerms();
+    std::vector<bool> isMasterTerm(objectiveTerms.size(), false);
+
+    for(size_t i = 0; i < objectiveTerms.size(); i++)
+    {
+        auto& T = objectiveTerms[i];
+
+        if(joinVariables(T.variables))
+            continue;
+
+        if(T.linearTerm)
+        {
+            masterLinearTerms[T.linearTerm->variable->index] += T.linearTerm->coefficient;
+        }
+        else if(T.quadraticTerm)
+        {
+            auto indexes
+                = std::make_pair(T.quadraticTerm->firstVariable->index, T.quadraticTerm->secondVariable->index);
+
+            if(indexes.first > indexes.second)
+                std::swap(indexes.first, indexes.second);
+
+            masterQuadraticTerms[indexes] += T.quadraticTerm->coefficient;
+        }
+        else
+        {
+            return (rejectDecomposition("the objective function is nonlinear in the discrete variables"));
+        }
+
+        isMasterTerm[i] = true;
+    }
+
+    // The block of each root variable
+    VectorInteger blockIndexes(numberOfVariables, -1);
+    std::vector<BlockContents> contents;
+
+    for(int i = 0; i < numberOfVariables; i++)
+    {
+        if(isDiscrete(i))
+            continue;
+
+        int root = findRoot(i);
+
+        if(blockIndexes[root] < 0)
+        {
+            blockIndexes[root] = contents.size();
+            contents.emplace_back();
+        }
+
+        contents[blockIndexes[root]].continuousVariables.push_back(i);
+    }
+
+    int minimumNumberOfBlocks = env->settings->getSetting<int>("Decomposition.MinimumNumberOfBlocks", "Strategy");
+
+    if((int)contents.size() < minimumNumberOfBlocks)
+    {
+        return (rejectDecomposition(
+            fmt::format("there are {} blocks of continuous variables, at least {} are needed", contents.size(),
+                minimumNumberOfBlocks)));
+    }
+
+    auto getBlockIndex = [&](const VectorInteger& variables) {
+        for(auto I : variables)
+        {
+            if(!isDiscrete(I))
+                return (blockIndexes[findRoot(I)]);
+        }
+
+        return (-1);
+    };
+
+    auto addLinkingVariables = [&](const VectorInteger& variables, BlockContents& block) {
+        for(auto I : variables)
+        {
+            if(isDiscrete(I))
+                block.linkingVariables.push_back(I);
+        }
+    };
+
+    for(size_t i = 0; i < sourceProblem->numericConstraints.size(); i++)
+    {
+        int blockIndex = getBlockIndex(constraintVariables[i]);
+
+        if(blockIndex < 0)
+            continue;
+
+        contents[blockIndex].constraints.push_back(sourceProblem->numericConstraints[i]);
+        addLinkingVariables(constraintVariables[i], contents[blockIndex]);
+    }
+
+    for(size_t i = 0; i < objectiveTerms.size(); i++)
+    {
+        if(isMasterTerm[i])
+            continue;
+
+        int blockIndex = getBlockIndex(objectiveTerms[i].variables);
+
+        contents[blockIndex].objectiveTerms.push_back(objectiveTerms[i]);
+        addLinkingVariables(objectiveTerms[i].variables, contents[blockIndex]);
+    }
+
+    blocks.resize(contents.size());
+
+    for(size_t i = 0; i < contents.size(); i++)
+    {
+        auto& linkingVariables = contents[i].linkingVariables;
+        std::sort(linkingVariables.begin(), linkingVariables.end());
+        linkingVariables.erase(std::unique(linkingVariables.begin(), linkingVariables.end()), linkingVariables.end());
+
+        createBlockProblems(contents[i], blocks[i]);
+    }
+
+    env->output->outputDebug(fmt::format("  Problem decomposed into {} blocks with {} master constraints.",
+        blocks.size(), masterConstraints.size()));
+
+    return (true);
+}
+
+std::vector<BlockDecomposition::ObjectiveTerm> BlockDecomposition::getObjectiveTerms()
+{
+    std::vector<ObjectiveTerm> terms;
+
+    if(auto objective = std::dynamic_pointer_cast<LinearObjectiveFunction>(sourceProblem->objectiveFunction))
+    {
+        for(auto& T : objective->linearTerms)
+        {
+            ObjectiveTerm term;
+            term.linearTerm = T;
+            term.variables = { T->variable->index };
+            terms.push_back(term);
+        }
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(sourceProblem->objectiveFunction))
+    {
+        for(auto& T : objective->quadraticTerms)
+        {
+            ObjectiveTerm term;
+            term.quadraticTerm = T;
+            term.variables = { T->firstVariable->index, T->secondVariable->index };
+            terms.push_back(term);
+        }
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(sourceProblem->objectiveFunction))
+    {
+        for(auto& T : objective->monomialTerms)
+        {
+            ObjectiveTerm term;
+            term.monomialTerm = T;
+
+            for(auto& V : T->variables)
+                term.variables.push_back(V->index);
+
+            terms.push_back(term);
+        }
+
+        for(auto& T : objective->signomialTerms)
+        {
+            ObjectiveTerm term;
+            term.signomialTerm = T;
+
+            for(auto& E : T->elements)
+                term.variables.push_back(E->variable->index);
+
+            terms.push_back(term);
+        }
+
+        // The terms of a sum can be in different blocks
+        if(objective->nonlinearExpression)
+        {
+            NonlinearExpressions expressions;
+
+            if(objective->nonlinearExpression->getType() == E_NonlinearExpressionTypes::Sum)
+                expressions = std::dynamic_pointer_cast<ExpressionSum>(objective->nonlinearExpression)->children;
+            else
+                expressions.push_back(objective->nonlinearExpression);
+
+            for(auto& E : expressions)
+            {
+                ObjectiveTerm term;
+                term.nonlinearExpression = E;
+
+                Variables variables;
+                E->appendNonlinearVariables(variables);
+
+                for(auto& V : variables)
+                    term.variables.push_back(V->index);
+
+                terms.push_back(term);
+            }
+        }
+    }
+
+    return (terms);
+}
+
+VectorInteger BlockDecomposition::getVariableIndexes(const NumericConstraintPtr& constraint)
+{
+    VectorInteger indexes;
+
+    if(auto linearConstraint = std::dynamic_pointer_cast<LinearConstraint>(constraint))
+    {
+        for(auto& T : linearConstraint->linearTerms)
+            indexes.push_back(T->variable->index);
+    }
+
+    if(auto quadraticConstraint = std::dynamic_pointer_cast<QuadraticConstraint>(constraint))
+    {
+        for(auto& T : quadraticConstraint->quadraticTerms)
+        {
+            indexes.push_back(T->firstVariable->index);
+            indexes.push_back(T->secondVariable->index);
+        }
+    }
+
+    if(auto nonlinearConstraint = std::dynamic_pointer_cast<NonlinearConstraint>(constraint))
+    {
+        for(auto& T : nonlinearConstraint->monomialTerms)
+        {
+            for(auto& V : T->variables)
+                indexes.push_back(V->index);
+        }
+
+        for(auto& T : nonlinearConstraint->signomialTerms)
+        {
+            for(auto& E : T->elements)
+                indexes.push_back(E->variable->index);
+        }
+
+        if(nonlinearConstraint->nonlinearExpression)
+        {
+            Variables variables;
+            nonlinearConstraint->nonlinearExpression->appendNonlinearVariables(variables);
+
+            for(auto& V : variables)
+                indexes.push_back(V->index);
+        }
+    }
+
+    std::sort(indexes.begin(), indexes.end());
+    indexes.erase(std::unique(indexes.begin(), indexes.end()), indexes.end());
+
+    return (indexes);
+}
+
+void BlockDecomposition::createBlockProblems(const BlockContents& contents, Block& block)
+{
+    block.sourceIndexes = contents.continuousVariables;
+    block.sourceIndexes.insert(
+        block.sourceIndexes.end(), contents.linkingVariables.begin(), contents.linkingVariables.end());
+
+    block.linkingPositions.resize(contents.linkingVariables.size());
+    std::iota(block.linkingPositions.begin(), block.linkingPositions.end(), (int)contents.continuousVariables.size());
+
+    auto createVariables = [&](VariableSubstitutions& substitutions) {
+        Variables variables;
+
+        for(auto I : block.sourceIndexes)
+        {
+            auto& V = sourceProblem->allVariables[I];
+
+            auto variable = std::make_shared<Variable>(
+                V->name, (int)variables.size(), E_VariableType::Real, V->lowerBound, V->upperBound, V->semiBound);
+
+            substitutions.emplace(V.get(), variable);
+            variables.push_back(variable);
+        }
+
+        return (variables);
+    };
+
+    {
+        block.problem = std::make_shared<Problem>(env);
+        block.problem->name = sourceProblem->name;
+
+        VariableSubstitutions substitutions;
+        block.problem->add(createVariables(substitutions));
+
+        block.problem->add(createObjective(contents.objectiveTerms, substitutions));
+
+        for(auto& C : contents.constraints)
+        {
+            block.problem->add(copyConstraint(C, block.problem->numericConstraints.size(), C->valueLHS, C->valueRHS,
+                substitutions, nullptr, 0.0));
+        }
+
+        block.problem->finalize();
+    }
+
+    {
+        block.feasibilityProblem = std::make_shared<Problem>(env);
+        block.feasibilityProblem->name = sourceProblem->name;
+
+        VariableSubstitutions substitutions;
+        auto variables = createVariables(substitutions);
+
+        auto slack = std::make_shared<Variable>(
+            "s_relaxation", (int)variables.size(), E_VariableType::Real, 0.0, SHOT_DBL_MAX, 0.0);
+        variables.push_back(slack);
+
+        block.feasibilityProblem->add(std::move(variables));
+
+        auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+        objective->add(std::make_shared<LinearTerm>(1.0, slack));
+        block.feasibilityProblem->add(std::move(objective));
+
+        // Each side of a constraint is relaxed separately
+        for(auto& C : contents.constraints)
+        {
+            if(C->valueRHS < SHOT_DBL_MAX)
+            {
+                block.feasibilityProblem->add(copyConstraint(C, block.feasibilityProblem->numericConstraints.size(),
+                    SHOT_DBL_MIN, C->valueRHS, substitutions, slack, -1.0));
+            }
+
+            if(C->valueLHS > SHOT_DBL_MIN)
+            {
+                block.feasibilityProblem->add(copyConstraint(C, block.feasibilityProblem->numericConstraints.size(),
+                    C->valueLHS, SHOT_DBL_MAX, substitutions, slack, 1.0));
+            }
+        }
+
+        block.feasibilityProblem->finalize();
+    }
+}
+
+NumericConstraintPtr BlockDecomposition::copyConstraint(const NumericConstraintPtr& source, int index,
+    double valueLHS, double valueRHS, const VariableSubstitutions& substitutions, const VariablePtr& slack,
+    double slackCoefficient)
+{
+    auto getVariable = [&](const VariablePtr& variable) { return (substitutions.at(variable.get())); };
+
+    std::shared_ptr<LinearConstraint> constraint;
+
+    if(auto nonlinearSource = std::dynamic_pointer_cast<NonlinearConstraint>(source))
+    {
+        auto nonlinearConstraint = std::make_shared<NonlinearConstraint>(index, source->name, valueLHS, valueRHS);
+
+        for(auto& T : nonlinearSource->monomialTerms)
+        {
+            Variables variables;
+
+            for(auto& V : T->variables)
+                variables.push_back(getVariable(V));
+
+            nonlinearConstraint->add(std::make_shared<MonomialTerm>(T->coefficient, variables));
+        }
+
+        for(auto& T : nonlinearSource->signomialTerms)
+        {
+            SignomialElements elements;
+
+            for(auto& E : T->elements)
+                elements.push_back(std::make_shared<SignomialElement>(getVariable(E->variable), E->power));
+
+            nonlinearConstraint->add(std::make_shared<SignomialTerm>(T->coefficient, elements));
+        }
+
+        if(nonlinearSource->nonlinearExpression)
+        {
+            auto expression = copyNonlinearExpression(nonlinearSource->nonlinearExpression.get());
+            substituteVariables(expression, substitutions);
+            nonlinearConstraint->add(expression);
+        }
+
+        constraint = nonlinearConstraint;
+    }
+    else if(std::dynamic_pointer_cast<QuadraticConstraint>(source))
+    {
+        constraint = std::make_shared<QuadraticConstraint>(index, source->name, valueLHS, valueRHS);
+    }
+    else
+    {
+        constraint = std::make_shared<LinearConstraint>(index, source->name, valueLHS, valueRHS);
+    }
+
+    if(auto quadraticSource = std::dynamic_pointer_cast<QuadraticConstraint>(source))
+    {
+        auto quadraticConstraint = std::dynamic_pointer_cast<QuadraticConstraint>(constraint);
+
+        for(auto& T : quadraticSource->quadraticTerms)
+        {
+            quadraticConstraint->add(std::make_shared<QuadraticTerm>(
+                T->coefficient, getVariable(T->firstVariable), getVariable(T->secondVariable)));
+        }
+    }
+
+    if(auto linearSource = std::dynamic_pointer_cast<LinearConstraint>(source))
+    {
+        for(auto& T : linearSource->linearTerms)
+            constraint->add(std::make_shared<LinearTerm>(T->coefficient, getVariable(T->variable)));
+    }
+
+    if(slack)
+        constraint->add(std::make_shared<LinearTerm>(slackCoefficient, slack));
+
+    constraint->constant = source->constant;
+
+    return (constraint);
+}
+
+ObjectiveFunctionPtr BlockDecomposition::createObjective(
+    const std::vector<ObjectiveTerm>& terms, const VariableSubstitutions& substitutions)
+{
+    auto getVariable = [&](const VariablePtr& variable) { return (substitutions.at(variable.get())); };
+
+    // The objective functions of the blocks are minimized, so the terms are multiplied with the sign
+    auto objective = std::make_shared<NonlinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+
+    for(auto& T : terms)
+    {
+        if(T.linearTerm)
+        {
+            objective->add(std::make_shared<LinearTerm>(
+                objectiveSign * T.linearTerm->coefficient, getVariable(T.linearTerm->variable)));
+        }
+        else if(T.quadraticTerm)
+        {
+            objective->add(std::make_shared<QuadraticTerm>(objectiveSign * T.quadraticTerm->coefficient,
+                getVariable(T.quadraticTerm->firstVariable), getVariable(T.quadraticTerm->secondVariable)));
+        }
+        else if(T.monomialTerm)
+        {
+            Variables variables;
+
+            for(auto& V : T.monomialTerm->variables)
+                variables.push_back(getVariable(V));
+
+            objective->add(std::make_shared<MonomialTerm>(objectiveSign * T.monomialTerm->coefficient, variables));
+        }
+        else if(T.signomialTerm)
+        {
+            SignomialElements elements;
+
+            for(auto& E : T.signomialTerm->elements)
+                elements.push_back(std::make_shared<SignomialElement>(getVariable(E->variable), E->power));
+
+            objective->add(std::make_shared<SignomialTerm>(objectiveSign * T.signomialTerm->coefficient, elements));
+        }
+        else if(T.nonlinearExpression)
+        {
+            auto expression = copyNonlinearExpression(T.nonlinearExpression.get());
+            substituteVariables(expression, substitutions);
+
+            if(objectiveSign < 0.0)
+                expression = std::make_shared<ExpressionNegate>(expression);
+
+            objective->add(expression);
+        }
+    }
+
+    if(objective->monomialTerms.size() > 0 || objective->signomialTerms.size() > 0 || objective->nonlinearExpression)
+        return (objective);
+
+    if(objective->quadraticTerms.size() > 0)
+    {
+        auto quadraticObjective = std::make_shared<QuadraticObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+        quadraticObjective->add(objective->linearTerms);
+        quadraticObjective->add(objective->quadraticTerms);
+        return (quadraticObjective);
+    }
+
+    auto linearObjective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+    linearObjective->add(objective->linearTerms);
+    return (linearObjective);
+}
+} // namespace SHOT
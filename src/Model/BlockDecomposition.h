@@ -0,0 +1,121 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Environment.h"
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include "Problem.h"
+#include "Simplifications.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// Splits a convex problem into blocks of continuous variables that are only linked to each other through the discrete
+// variables, e.g. the scenarios of a two-stage problem with integer first-stage decisions. Each block gets a problem
+// in its continuous variables and the discrete variables it contains, which are continuous there and should be fixed
+// before solving it, with the terms of the objective function in the block. The constraints and objective terms with
+// only discrete variables are kept for the master problem. See SolutionStrategyDecomposition.
+class BlockDecomposition
+{
+public:
+    BlockDecomposition(EnvironmentPtr envPtr, ProblemPtr sourceProblem);
+
+    // Returns false if the problem cannot be split into at least Decomposition.MinimumNumberOfBlocks blocks, the reason
+    // is given in the debug output
+    bool createBlocks();
+
+    struct Block
+    {
+        // The objective function is minimized, and is the source objective function multiplied by objectiveSign
+        ProblemPtr problem;
+
+        // The same constraints relaxed by a nonnegative variable, which is the last variable and is minimized
+        ProblemPtr feasibilityProblem;
+
+        // The index in the source problem of each variable in the block problems, except the relaxation variable
+        VectorInteger sourceIndexes;
+
+        // The positions in the block problems of the discrete variables of the source problem
+        VectorInteger linkingPositions;
+
+        // A lower bound on the objective value of the block for any values of the discrete variables, and the index in
+        // the master problem of the variable for the objective value, set when the master problem is created
+        double objectiveLowerBound = SHOT_DBL_MIN;
+        int masterVariableIndex = -1;
+    };
+
+    std::vector<Block> blocks;
+
+    // The variables and constraints of the master problem are in the source problem
+    LinearConstraints masterConstraints;
+    std::map<int, double> masterLinearTerms;
+    std::map<std::pair<int, int>, double> masterQuadraticTerms;
+    double masterConstant = 0.0;
+
+    bool isMinimize = true;
+    double objectiveSign = 1.0;
+
+    ProblemPtr getSourceProblem() { return (sourceProblem); };
+
+private:
+    EnvironmentPtr env;
+    ProblemPtr sourceProblem;
+
+    // A term of the objective function, where only one of the pointers is set
+    struct ObjectiveTerm
+    {
+        LinearTermPtr linearTerm;
+        QuadraticTermPtr quadraticTerm;
+        MonomialTermPtr monomialTerm;
+        SignomialTermPtr signomialTerm;
+        NonlinearExpressionPtr nonlinearExpression;
+
+        VectorInteger variables;
+    };
+
+    struct BlockContents
+    {
+        VectorInteger continuousVariables;
+        VectorInteger linkingVariables;
+        NumericConstraints constraints;
+        std::vector<ObjectiveTerm> objectiveTerms;
+    };
+
+    std::vector<ObjectiveTerm> getObjectiveTerms();
+    VectorInteger getVariableIndexes(const NumericConstraintPtr& constraint);
+
+    inline bool isDiscrete(int index) const
+    {
+        auto type = sourceProblem->allVariables[index]->properties.type;
+        return (type == E_VariableType::Binary || type == E_VariableType::Integer);
+    };
+
+    void createBlockProblems(const BlockContents& contents, Block& block);
+
+    // Copies the terms of the source constraint with the substituted variables, and adds slackCoefficient * slack if
+    // slack is given
+    NumericConstraintPtr copyConstraint(const NumericConstraintPtr& source, int index, double valueLHS,
+        double valueRHS, const VariableSubstitutions& substitutions, const VariablePtr& slack,
+        double slackCoefficient);
+
+    ObjectiveFunctionPtr createObjective(
+        const std::vector<ObjectiveTerm>& terms, const VariableSubstitutions& substitutions);
+};
+
+using BlockDecompositionPtr = std::shared_ptr<BlockDecomposition>;
+} // namespace SHOT
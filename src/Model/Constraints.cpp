@@ -14,6 +14,10 @@
 
 #include "spdlog/fmt/fmt.h"
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
 namespace SHOT
 {
 
@@ -109,6 +113,42 @@ std::ostream& operator<<(std::ostream& stream, ConstraintPtr constraint)
 
 void NumericConstraint::initializeGradientSparsityPattern() { gradientSparsityPattern = std::make_shared<Variables>(); }
 
+std::array<double, 3> NumericConstraint::calculateQuadraticSegmentCoefficients(
+    [[maybe_unused]] const VectorDouble& firstPoint, [[maybe_unused]] const VectorDouble& secondPoint)
+{
+    return { 0.0, 0.0, 0.0 };
+}
+
+double NumericConstraint::calculateNonquadraticFunctionValue(const VectorDouble& point)
+{
+    return (calculateNonaffineFunctionValue(point));
+}
+
+bool NumericConstraint::hasNonquadraticTerms() { return (hasNonaffineTerms()); }
+
+NonquadraticSegmentTerms NumericConstraint::getNonquadraticSegmentTerms(
+    [[maybe_unused]] const VectorDouble& firstPoint, [[maybe_unused]] const VectorDouble& secondPoint)
+{
+    NonquadraticSegmentTerms terms;
+    terms.hasRemainingTerms = hasNonquadraticTerms();
+
+    return (terms);
+}
+
+double NumericConstraint::calculateNonquadraticSegmentValue(
+    const NonquadraticSegmentTerms& terms, const VectorDouble& point)
+{
+    double value = terms.constantValue;
+
+    for(auto& T : terms.movingTerms)
+        value += T->calculate(point);
+
+    if(terms.hasRemainingTerms)
+        value += calculateNonquadraticFunctionValue(point);
+
+    return (value);
+}
+
 std::shared_ptr<Variables> NumericConstraint::getGradientSparsityPattern()
 {
     if(gradientSparsityPattern)
@@ -129,6 +169,75 @@ std::shared_ptr<Variables> NumericConstraint::getGradientSparsityPattern()
     return (gradientSparsityPattern);
 }
 
+void NumericConstraint::initializeGradientCalculation()
+{
+    if(gradientPositionsInitialized.load(std::memory_order_acquire))
+        return;
+
+    // Several threads may calculate the first gradients of the constraint at the same time
+    std::lock_guard<std::mutex> lock(gradientPositionsMutex);
+
+    if(gradientPositionsInitialized.load(std::memory_order_relaxed))
+        return;
+
+    getGradientSparsityPattern();
+    initializeGradientPositions();
+
+    gradientPositionsInitialized.store(true, std::memory_order_release);
+}
+
+void NumericConstraint::calculateSparseGradient(
+    const VectorDouble& point, SparseGradient& gradient, bool includeNonlinearExpression)
+{
+    initializeGradientCalculation();
+
+    auto pattern = getGradientSparsityPattern();
+
+    bool hasLayout = (gradient.indexes.size() == pattern->size());
+
+    for(size_t i = 0; hasLayout && i < pattern->size(); i++)
+        hasLayout = (gradient.indexes[i] == (*pattern)[i]->index);
+
+    if(!hasLayout)
+    {
+        gradient.indexes.resize(pattern->size());
+
+        for(size_t i = 0; i < pattern->size(); i++)
+            gradient.indexes[i] = (*pattern)[i]->index;
+    }
+
+    gradient.values.resize(pattern->size());
+
+    calculateSparseGradient(point, gradient.values.data(), includeNonlinearExpression);
+}
+
+void NumericConstraint::calculateSparseGradient(
+    const VectorDouble& point, double* values, bool includeNonlinearExpression)
+{
+    initializeGradientCalculation();
+
+    auto pattern = getGradientSparsityPattern();
+
+    std::fill(values, values + pattern->size(), 0.0);
+
+    addGradientValues(point, values, includeNonlinearExpression);
+}
+
+int NumericConstraint::getGradientPosition(const VariablePtr& variable)
+{
+    auto pattern = getGradientSparsityPattern();
+
+    auto element = std::lower_bound(pattern->begin(), pattern->end(), variable,
+        [](const VariablePtr& variableOne, const VariablePtr& variableTwo) {
+            return (variableOne->index < variableTwo->index);
+        });
+
+    if(element == pattern->end() || (*element)->index != variable->index)
+        return (-1);
+
+    return (element - pattern->begin());
+}
+
 void NumericConstraint::initializeHessianSparsityPattern()
 {
     hessianSparsityPattern = std::make_shared<std::vector<std::pair<VariablePtr, VariablePtr>>>();
@@ -157,8 +266,25 @@ std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> NumericConstra
 
 NumericConstraintValue NumericConstraint::calculateNumericValue(const VectorDouble& point, double correction)
 {
-    double value = calculateFunctionValue(point) - correction;
+    return (createNumericValue(calculateFunctionValue(point) - correction));
+}
+
+NumericConstraintValues NumericConstraint::calculateNumericValues(const PointBlock& points, double correction)
+{
+    VectorDouble functionValues(points.numberOfPoints);
+    calculateFunctionValues(points, functionValues.data());
+
+    NumericConstraintValues values;
+    values.reserve(points.numberOfPoints);
+
+    for(auto& V : functionValues)
+        values.push_back(createNumericValue(V - correction));
+
+    return (values);
+}
 
+NumericConstraintValue NumericConstraint::createNumericValue(double value)
+{
     NumericConstraintValue constrValue;
     constrValue.constraint = getPointer();
     constrValue.functionValue = value;
@@ -183,6 +309,24 @@ bool NumericConstraint::isFulfilled(const VectorDouble& point)
     return (constraintValue.isFulfilledLHS && constraintValue.isFulfilledRHS);
 }
 
+bool NumericConstraint::updatePropertiesIfChanged()
+{
+    VectorDouble data;
+    appendPropertiesData(data);
+
+    auto fingerprint = Utilities::calculateExactHash(data);
+
+    if(hasPropertiesFingerprint && fingerprint == propertiesFingerprint)
+        return (false);
+
+    updateProperties();
+
+    propertiesFingerprint = fingerprint;
+    hasPropertiesFingerprint = true;
+
+    return (true);
+}
+
 void LinearConstraint::add(LinearTerms terms)
 {
     if(linearTerms.size() == 0)
@@ -207,18 +351,39 @@ void LinearConstraint::add(LinearTermPtr term)
 
 double LinearConstraint::calculateFunctionValue(const VectorDouble& point)
 {
-    double value = linearTerms.calculate(point);
+    double value = isPackedLinearTermsValid() ? packedLinearTerms.calculate(point) : linearTerms.calculate(point);
     value += constant;
     return value;
 }
 
+double LinearConstraint::calculateAffineFunctionValue(const VectorDouble& point)
+{
+    return (LinearConstraint::calculateFunctionValue(point));
+}
+
+double LinearConstraint::calculateNonaffineFunctionValue([[maybe_unused]] const VectorDouble& point) { return (0.0); }
+
+bool LinearConstraint::hasNonaffineTerms() { return (false); }
+
 Interval LinearConstraint::calculateFunctionValue(const IntervalVector& intervalVector)
 {
-    Interval value = linearTerms.calculate(intervalVector);
+    Interval value = isPackedLinearTermsValid() ? packedLinearTerms.calculate(intervalVector)
+                                                : linearTerms.calculate(intervalVector);
     value += Interval(constant);
     return value;
 }
 
+void LinearConstraint::calculateFunctionValues(const PointBlock& points, double* values)
+{
+    for(int p = 0; p < points.numberOfPoints; p++)
+        values[p] = constant;
+
+    if(isPackedLinearTermsValid())
+        packedLinearTerms.calculate(points, values);
+    else
+        linearTerms.calculate(points, values);
+}
+
 Interval LinearConstraint::getConstraintFunctionBounds()
 {
     Interval value = linearTerms.getBounds();
@@ -259,6 +424,37 @@ void LinearConstraint::initializeGradientSparsityPattern()
     }
 }
 
+void LinearConstraint::initializeGradientPositions()
+{
+    linearGradientPositions.resize(linearTerms.size());
+
+    for(size_t i = 0; i < linearTerms.size(); i++)
+        linearGradientPositions[i] = getGradientPosition(linearTerms[i]->variable);
+}
+
+void LinearConstraint::addGradientValues(
+    [[maybe_unused]] const VectorDouble& point, double* values, [[maybe_unused]] bool includeNonlinearExpression)
+{
+    if(isPackedLinearTermsValid())
+    {
+        for(size_t i = 0; i < packedLinearTerms.size(); i++)
+        {
+            if(packedLinearTerms.coefficients[i] != 0.0)
+                values[linearGradientPositions[i]] += packedLinearTerms.coefficients[i];
+        }
+
+        return;
+    }
+
+    for(size_t i = 0; i < linearTerms.size(); i++)
+    {
+        if(linearTerms[i]->coefficient == 0.0)
+            continue;
+
+        values[linearGradientPositions[i]] += linearTerms[i]->coefficient;
+    }
+}
+
 void LinearConstraint::initializeHessianSparsityPattern() { NumericConstraint::initializeHessianSparsityPattern(); }
 
 SparseVariableMatrix LinearConstraint::calculateHessian(
@@ -291,8 +487,21 @@ void LinearConstraint::updateProperties()
     }
 
     properties.convexity = E_Convexity::Linear;
+    properties.isConvexityFromSampling = false;
     properties.classification = E_ConstraintClassification::Linear;
     properties.monotonicity = linearTerms.getMonotonicity();
+
+    auto problem = ownerProblem.lock();
+    packedLinearTerms.update(linearTerms, problem && problem->useCompactTermStorage);
+}
+
+void LinearConstraint::appendPropertiesData(VectorDouble& data) const
+{
+    data.reserve(data.size() + 4 + 2 * linearTerms.size());
+    data.insert(data.end(), { valueLHS, valueRHS, constant, (double)linearTerms.size() });
+
+    for(auto& T : linearTerms)
+        data.insert(data.end(), { (double)T->variable->index, T->coefficient });
 }
 
 void QuadraticConstraint::add(LinearTerms terms) { LinearConstraint::add(terms); }
@@ -324,18 +533,62 @@ void QuadraticConstraint::add(QuadraticTermPtr term)
 double QuadraticConstraint::calculateFunctionValue(const VectorDouble& point)
 {
     double value = LinearConstraint::calculateFunctionValue(point);
-    value += quadraticTerms.calculate(point);
+    value += isPackedQuadraticTermsValid() ? packedQuadraticTerms.calculate(point) : quadraticTerms.calculate(point);
 
     return value;
 }
 
+double QuadraticConstraint::calculateNonaffineFunctionValue(const VectorDouble& point)
+{
+    return (isPackedQuadraticTermsValid() ? packedQuadraticTerms.calculate(point) : quadraticTerms.calculate(point));
+}
+
+bool QuadraticConstraint::hasNonaffineTerms() { return (quadraticTerms.size() > 0); }
+
+std::array<double, 3> QuadraticConstraint::calculateQuadraticSegmentCoefficients(
+    const VectorDouble& firstPoint, const VectorDouble& secondPoint)
+{
+    std::array<double, 3> coefficients = { 0.0, 0.0, 0.0 };
+
+    if(isPackedQuadraticTermsValid())
+    {
+        packedQuadraticTerms.calculateSegmentCoefficients(firstPoint, secondPoint, coefficients.data());
+    }
+    else
+    {
+        PackedQuadraticTerms terms;
+        terms.update(quadraticTerms);
+        terms.calculateSegmentCoefficients(firstPoint, secondPoint, coefficients.data());
+    }
+
+    return (coefficients);
+}
+
+double QuadraticConstraint::calculateNonquadraticFunctionValue([[maybe_unused]] const VectorDouble& point)
+{
+    return (0.0);
+}
+
+bool QuadraticConstraint::hasNonquadraticTerms() { return (false); }
+
 Interval QuadraticConstraint::calculateFunctionValue(const IntervalVector& intervalVector)
 {
     Interval value = LinearConstraint::calculateFunctionValue(intervalVector);
-    value += quadraticTerms.calculate(intervalVector);
+    value += isPackedQuadraticTermsValid() ? packedQuadraticTerms.calculate(intervalVector)
+                                           : quadraticTerms.calculate(intervalVector);
     return value;
 }
 
+void QuadraticConstraint::calculateFunctionValues(const PointBlock& points, double* values)
+{
+    LinearConstraint::calculateFunctionValues(points, values);
+
+    if(isPackedQuadraticTermsValid())
+        packedQuadraticTerms.calculate(points, values);
+    else
+        quadraticTerms.calculate(points, values);
+}
+
 Interval QuadraticConstraint::getConstraintFunctionBounds()
 {
     Interval value = LinearConstraint::getConstraintFunctionBounds();
@@ -381,6 +634,68 @@ void QuadraticConstraint::initializeGradientSparsityPattern()
     }
 }
 
+void QuadraticConstraint::initializeGradientPositions()
+{
+    LinearConstraint::initializeGradientPositions();
+
+    quadraticGradientPositions.resize(2 * quadraticTerms.size());
+
+    for(size_t i = 0; i < quadraticTerms.size(); i++)
+    {
+        quadraticGradientPositions[2 * i] = getGradientPosition(quadraticTerms[i]->firstVariable);
+        quadraticGradientPositions[2 * i + 1] = getGradientPosition(quadraticTerms[i]->secondVariable);
+    }
+}
+
+void QuadraticConstraint::addGradientValues(const VectorDouble& point, double* values, bool includeNonlinearExpression)
+{
+    LinearConstraint::addGradientValues(point, values, includeNonlinearExpression);
+
+    if(isPackedQuadraticTermsValid())
+    {
+        for(size_t i = 0; i < packedQuadraticTerms.size(); i++)
+        {
+            double coefficient = packedQuadraticTerms.coefficients[i];
+
+            if(coefficient == 0.0)
+                continue;
+
+            int firstIndex = packedQuadraticTerms.firstVariableIndexes[i];
+            int secondIndex = packedQuadraticTerms.secondVariableIndexes[i];
+
+            if(firstIndex == secondIndex) // variable squared
+            {
+                values[quadraticGradientPositions[2 * i]] += 2 * coefficient * point[firstIndex];
+            }
+            else
+            {
+                values[quadraticGradientPositions[2 * i]] += coefficient * point[secondIndex];
+                values[quadraticGradientPositions[2 * i + 1]] += coefficient * point[firstIndex];
+            }
+        }
+
+        return;
+    }
+
+    for(size_t i = 0; i < quadraticTerms.size(); i++)
+    {
+        auto& T = quadraticTerms[i];
+
+        if(T->coefficient == 0.0)
+            continue;
+
+        if(T->firstVariable == T->secondVariable) // variable squared
+        {
+            values[quadraticGradientPositions[2 * i]] += 2 * T->coefficient * point[T->firstVariable->index];
+        }
+        else
+        {
+            values[quadraticGradientPositions[2 * i]] += T->coefficient * point[T->secondVariable->index];
+            values[quadraticGradientPositions[2 * i + 1]] += T->coefficient * point[T->firstVariable->index];
+        }
+    }
+}
+
 SparseVariableMatrix QuadraticConstraint::calculateHessian(
     [[maybe_unused]] const VectorDouble& point, [[maybe_unused]] bool eraseZeroes = true)
 {
@@ -486,7 +801,25 @@ void QuadraticConstraint::updateProperties()
     if(valueLHS != SHOT_DBL_MIN)
         properties.convexity = E_Convexity::Nonconvex;
 
+    // Solvers with support for quadratic constraints, e.g. Gurobi and Cplex, handle these as cones
+    properties.isSecondOrderCone = (properties.convexity == E_Convexity::Nonconvex && valueLHS == SHOT_DBL_MIN
+        && valueRHS - constant == 0.0 && linearTerms.size() == 0 && quadraticTerms.isSecondOrderCone());
+
     properties.monotonicity = Utilities::combineMonotonicity(properties.monotonicity, quadraticTerms.getMonotonicity());
+
+    auto problem = ownerProblem.lock();
+    packedQuadraticTerms.update(quadraticTerms, problem && problem->useCompactTermStorage);
+}
+
+void QuadraticConstraint::appendPropertiesData(VectorDouble& data) const
+{
+    LinearConstraint::appendPropertiesData(data);
+
+    data.reserve(data.size() + 1 + 3 * quadraticTerms.size());
+    data.push_back((double)quadraticTerms.size());
+
+    for(auto& T : quadraticTerms)
+        data.insert(data.end(), { (double)T->firstVariable->index, (double)T->secondVariable->index, T->coefficient });
 }
 
 void NonlinearConstraint::add(LinearTerms terms) { LinearConstraint::add(terms); }
@@ -580,6 +913,8 @@ void NonlinearConstraint::add(NonlinearExpressionPtr expression)
         nonlinearExpression = expression;
     }
 
+    nonlinearExpressionTape.reset();
+
     properties.hasNonlinearExpression = true;
     properties.classification = E_ConstraintClassification::Nonlinear;
 }
@@ -589,6 +924,98 @@ void NonlinearConstraint::updateFactorableFunction()
     factorableFunction = std::make_shared<FactorableFunction>(nonlinearExpression->getFactorableFunction());
 }
 
+void NonlinearConstraint::enableNonlinearExpressionADFunction()
+{
+    useNonlinearExpressionADFunction = true;
+    isNonlinearExpressionADFunctionRecorded = false;
+}
+
+void NonlinearConstraint::recordNonlinearExpressionADFunction()
+{
+    // The recordings change the factorable function variables shared by all constraints in the problem
+    auto problem = ownerProblem.lock();
+
+    if(!problem)
+        throw Exception("The nonlinear expression of a constraint without a problem cannot be recorded.");
+
+    std::lock_guard<std::mutex> lock(problem->nonlinearExpressionRecordingMutex);
+
+    if(isNonlinearExpressionADFunctionRecorded)
+        return;
+
+    std::vector<CppAD::AD<double>> variables(variablesInNonlinearExpression.size(), 3.0);
+    std::vector<CppAD::AD<double>*> previousVariables(variablesInNonlinearExpression.size());
+
+    CppAD::Independent(variables);
+
+    for(size_t k = 0; k < variablesInNonlinearExpression.size(); k++)
+    {
+        previousVariables[k] = variablesInNonlinearExpression[k]->factorableFunctionVariable;
+        variablesInNonlinearExpression[k]->factorableFunctionVariable = &variables[k];
+    }
+
+    std::vector<CppAD::AD<double>> function;
+
+    {
+        FactorableFunctionCacheScope cacheScope;
+        function = { nonlinearExpression->getFactorableFunction() };
+    }
+
+    nonlinearExpressionADFunction.Dependent(variables, function);
+
+    CppAD::AD<double>::abort_recording();
+
+    // Restores the variables of the recording of the whole problem
+    for(size_t k = 0; k < variablesInNonlinearExpression.size(); k++)
+        variablesInNonlinearExpression[k]->factorableFunctionVariable = previousVariables[k];
+
+    nonlinearExpressionADFunctionCopies.clear();
+    nonlinearExpressionADFunctionCopies.resize(CPPAD_MAX_NUM_THREADS);
+
+    useNonlinearExpressionADFunction = true;
+    isNonlinearExpressionADFunctionRecorded = true;
+}
+
+const VectorDouble& NonlinearConstraint::calculateNonlinearExpressionDerivatives(const VectorDouble& point)
+{
+    // Reused between calls
+    thread_local VectorDouble pointSubset;
+    thread_local VectorDouble derivatives;
+    static const VectorDouble weight = { 1.0 };
+
+    // The variables of the tape are the same as variablesInNonlinearExpression, see Problem::updateExpressionTapes()
+    if(useTapeForGradient && nonlinearExpressionTape)
+    {
+        nonlinearExpressionTape->calculateGradient(point, derivatives);
+        return (derivatives);
+    }
+
+    if(!isNonlinearExpressionADFunctionRecorded)
+        recordNonlinearExpressionADFunction();
+
+    auto cppADLock = Problem::lockCppADEvaluation();
+
+    auto& function = Problem::getThreadCopy(nonlinearExpressionADFunction, nonlinearExpressionADFunctionCopies);
+
+    pointSubset.resize(variablesInNonlinearExpression.size());
+
+    for(size_t k = 0; k < variablesInNonlinearExpression.size(); k++)
+        pointSubset[k] = point[variablesInNonlinearExpression[k]->index];
+
+    function.Forward(0, pointSubset);
+    derivatives = function.Reverse(1, weight);
+
+    return (derivatives);
+}
+
+size_t NonlinearConstraint::getADFunctionMemoryUsage() const
+{
+    if(!isNonlinearExpressionADFunctionRecorded)
+        return (0);
+
+    return (Problem::getRecordingMemoryUsage(nonlinearExpressionADFunction, nonlinearExpressionADFunctionCopies));
+}
+
 double NonlinearConstraint::calculateFunctionValue(const VectorDouble& point)
 {
     double value = QuadraticConstraint::calculateFunctionValue(point);
@@ -600,11 +1027,105 @@ double NonlinearConstraint::calculateFunctionValue(const VectorDouble& point)
         value += signomialTerms.calculate(point);
 
     if(this->properties.hasNonlinearExpression)
-        value += nonlinearExpression->calculate(point);
+    {
+        if(nonlinearExpressionTape)
+            value += nonlinearExpressionTape->calculate(point);
+        else
+            value += nonlinearExpression->calculate(point);
+    }
+
+    return value;
+}
+
+double NonlinearConstraint::calculateNonaffineFunctionValue(const VectorDouble& point)
+{
+    return (QuadraticConstraint::calculateNonaffineFunctionValue(point) + calculateNonquadraticFunctionValue(point));
+}
+
+bool NonlinearConstraint::hasNonaffineTerms()
+{
+    return (QuadraticConstraint::hasNonaffineTerms() || hasNonquadraticTerms());
+}
+
+double NonlinearConstraint::calculateNonquadraticFunctionValue(const VectorDouble& point)
+{
+    double value = 0.0;
+
+    if(this->properties.hasMonomialTerms)
+        value += monomialTerms.calculate(point);
+
+    if(this->properties.hasSignomialTerms)
+        value += signomialTerms.calculate(point);
+
+    if(this->properties.hasNonlinearExpression)
+    {
+        if(nonlinearExpressionTape)
+            value += nonlinearExpressionTape->calculate(point);
+        else
+            value += nonlinearExpression->calculate(point);
+    }
 
     return value;
 }
 
+bool NonlinearConstraint::hasNonquadraticTerms()
+{
+    return (properties.hasMonomialTerms || properties.hasSignomialTerms || properties.hasNonlinearExpression);
+}
+
+NonquadraticSegmentTerms NonlinearConstraint::getNonquadraticSegmentTerms(
+    const VectorDouble& firstPoint, const VectorDouble& secondPoint)
+{
+    NonquadraticSegmentTerms terms;
+    terms.hasRemainingTerms = properties.hasNonlinearExpression;
+
+    auto isMoving = [&](const VariablePtr& V) { return (firstPoint[V->index] != secondPoint[V->index]); };
+
+    if(properties.hasMonomialTerms)
+    {
+        for(auto& T : monomialTerms)
+        {
+            if(std::any_of(T->variables.begin(), T->variables.end(), isMoving))
+                terms.movingTerms.push_back(T.get());
+            else
+                terms.constantValue += T->calculate(secondPoint);
+        }
+    }
+
+    if(properties.hasSignomialTerms)
+    {
+        for(auto& T : signomialTerms)
+        {
+            if(std::any_of(T->elements.begin(), T->elements.end(),
+                   [&](const SignomialElementPtr& E) { return (isMoving(E->variable)); }))
+                terms.movingTerms.push_back(T.get());
+            else
+                terms.constantValue += T->calculate(secondPoint);
+        }
+    }
+
+    return (terms);
+}
+
+double NonlinearConstraint::calculateNonquadraticSegmentValue(
+    const NonquadraticSegmentTerms& terms, const VectorDouble& point)
+{
+    double value = terms.constantValue;
+
+    for(auto& T : terms.movingTerms)
+        value += T->calculate(point);
+
+    if(terms.hasRemainingTerms)
+    {
+        if(nonlinearExpressionTape)
+            value += nonlinearExpressionTape->calculate(point);
+        else
+            value += nonlinearExpression->calculate(point);
+    }
+
+    return (value);
+}
+
 Interval NonlinearConstraint::calculateFunctionValue(const IntervalVector& intervalVector)
 {
     Interval value = QuadraticConstraint::calculateFunctionValue(intervalVector);
@@ -616,11 +1137,75 @@ Interval NonlinearConstraint::calculateFunctionValue(const IntervalVector& inter
         value += signomialTerms.calculate(intervalVector);
 
     if(this->properties.hasNonlinearExpression)
-        value += nonlinearExpression->calculate(intervalVector);
+    {
+        if(nonlinearExpressionTape)
+            value += nonlinearExpressionTape->calculate(intervalVector);
+        else
+            value += nonlinearExpression->calculate(intervalVector);
+    }
 
     return value;
 }
 
+void NonlinearConstraint::calculateFunctionValues(const PointBlock& points, double* values)
+{
+    QuadraticConstraint::calculateFunctionValues(points, values);
+
+    if(this->properties.hasMonomialTerms)
+        monomialTerms.calculate(points, values);
+
+    if(this->properties.hasSignomialTerms)
+        signomialTerms.calculate(points, values);
+
+    if(!this->properties.hasNonlinearExpression)
+        return;
+
+    if(nonlinearExpressionTape)
+    {
+        nonlinearExpressionTape->calculate(points, values);
+        return;
+    }
+
+    // Without a tape the expression tree is evaluated one point at a time
+    VectorDouble point(points.numberOfVariables);
+
+    for(int p = 0; p < points.numberOfPoints; p++)
+    {
+        for(int i = 0; i < points.numberOfVariables; i++)
+            point[i] = points.values[i * points.numberOfPoints + p];
+
+        values[p] += nonlinearExpression->calculate(point);
+    }
+}
+
+bool NonlinearConstraint::calculateApproximateFunctionValues(
+    const PointBlock& points, const PointBlockFloat& singlePrecisionPoints, double* values)
+{
+    if(this->properties.hasNonlinearExpression && !nonlinearExpressionTape)
+        return (false);
+
+    QuadraticConstraint::calculateFunctionValues(points, values);
+
+    if(this->properties.hasMonomialTerms)
+        monomialTerms.calculate(points, values);
+
+    if(this->properties.hasSignomialTerms)
+        signomialTerms.calculate(points, values);
+
+    if(!this->properties.hasNonlinearExpression)
+        return (true);
+
+    thread_local std::vector<float> expressionValues;
+    expressionValues.assign(points.numberOfPoints, 0.0f);
+
+    nonlinearExpressionTape->calculate(singlePrecisionPoints, expressionValues.data());
+
+    for(int p = 0; p < points.numberOfPoints; p++)
+        values[p] += expressionValues[p];
+
+    return (true);
+}
+
 Interval NonlinearConstraint::getConstraintFunctionBounds()
 {
     Interval value = QuadraticConstraint::getConstraintFunctionBounds();
@@ -662,7 +1247,25 @@ SparseVariableVector NonlinearConstraint::calculateGradient(const VectorDouble&
         signomialGradient = signomialTerms.calculateGradient(point);
     }
 
-    if(this->properties.hasNonlinearExpression)
+    if(this->properties.hasNonlinearExpression && hasSeparateNonlinearExpressionDerivatives())
+    {
+        auto& derivatives = calculateNonlinearExpressionDerivatives(point);
+
+        for(size_t k = 0; k < derivatives.size(); k++)
+        {
+            if(derivatives[k] == 0.0)
+                continue;
+
+            auto element = gradient.emplace(variablesInNonlinearExpression[k], derivatives[k]);
+
+            if(!element.second)
+            {
+                // Element already exists for the variable
+                element.first->second += derivatives[k];
+            }
+        }
+    }
+    else if(this->properties.hasNonlinearExpression)
     {
         if(!nonlinearGradientSparsityMapGenerated)
             initializeGradientSparsityPattern();
@@ -676,8 +1279,10 @@ SparseVariableVector NonlinearConstraint::calculateGradient(const VectorDouble&
             for(auto& VAR : sharedOwnerProblem->nonlinearExpressionVariables)
                 pointNonlinearSubset[VAR->properties.nonlinearVariableIndex] = point[VAR->index];
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             CppAD::sparse_rcv<std::vector<size_t>, std::vector<double>> subset(nonlinearGradientSparsityPattern);
-            sharedOwnerProblem->ADFunctions.subgraph_jac_rev(pointNonlinearSubset, subset);
+            sharedOwnerProblem->getADFunctions().subgraph_jac_rev(pointNonlinearSubset, subset);
 
             const std::vector<size_t>& col(subset.col());
             const std::vector<double>& value(subset.val());
@@ -748,7 +1353,17 @@ void NonlinearConstraint::initializeGradientSparsityPattern()
         }
     }
 
-    if(this->properties.hasNonlinearExpression)
+    if(this->properties.hasNonlinearExpression && hasSeparateNonlinearExpressionDerivatives())
+    {
+        // All variables in the separately recorded expression are considered to be nonzero
+        for(auto& VAR : variablesInNonlinearExpression)
+        {
+            if(std::find(gradientSparsityPattern->begin(), gradientSparsityPattern->end(), VAR)
+                == gradientSparsityPattern->end())
+                gradientSparsityPattern->push_back(VAR);
+        }
+    }
+    else if(this->properties.hasNonlinearExpression)
     {
         if(auto sharedOwnerProblem = ownerProblem.lock())
         {
@@ -766,9 +1381,11 @@ void NonlinearConstraint::initializeGradientSparsityPattern()
 
             nonlinearFunctionMap[this->nonlinearExpressionIndex] = true;
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             CppAD::sparse_rc<std::vector<size_t>> pattern;
 
-            sharedOwnerProblem->ADFunctions.subgraph_sparsity(
+            sharedOwnerProblem->getADFunctions().subgraph_sparsity(
                 nonlinearVariablesInExpressionMap, nonlinearFunctionMap, false, pattern);
 
             // Save for later use when calculating gradients
@@ -796,7 +1413,158 @@ void NonlinearConstraint::initializeGradientSparsityPattern()
     nonlinearGradientSparsityMapGenerated = true;
 }
 
+void NonlinearConstraint::initializeGradientPositions()
+{
+    QuadraticConstraint::initializeGradientPositions();
+
+    monomialGradientPositions.clear();
+
+    for(auto& T : monomialTerms)
+    {
+        for(auto& V : T->variables)
+            monomialGradientPositions.push_back(getGradientPosition(V));
+    }
+
+    signomialGradientPositions.clear();
+
+    for(auto& T : signomialTerms)
+    {
+        for(auto& E : T->elements)
+            signomialGradientPositions.push_back(getGradientPosition(E->variable));
+    }
+
+    nonlinearExpressionGradientPositions.clear();
+    nonlinearExpressionVariableGradientPositions.clear();
+
+    for(auto& VAR : variablesInNonlinearExpression)
+        nonlinearExpressionVariableGradientPositions.push_back(getGradientPosition(VAR));
+
+    if(this->properties.hasNonlinearExpression && !hasSeparateNonlinearExpressionDerivatives())
+    {
+        if(auto sharedOwnerProblem = ownerProblem.lock())
+        {
+            const std::vector<size_t>& col(nonlinearGradientSparsityPattern.col());
+            nonlinearExpressionGradientPositions.resize(nonlinearGradientSparsityPattern.nnz());
+
+            for(size_t k = 0; k < nonlinearGradientSparsityPattern.nnz(); k++)
+            {
+                nonlinearExpressionGradientPositions[k]
+                    = getGradientPosition(sharedOwnerProblem->nonlinearExpressionVariables[col[k]]);
+            }
+        }
+    }
+}
+
+void NonlinearConstraint::addGradientValues(const VectorDouble& point, double* values, bool includeNonlinearExpression)
+{
+    QuadraticConstraint::addGradientValues(point, values, includeNonlinearExpression);
+
+    size_t position = 0;
+
+    for(auto& T : monomialTerms)
+    {
+        if(T->coefficient == 0.0)
+        {
+            position += T->variables.size();
+            continue;
+        }
+
+        for(auto& V1 : T->variables)
+        {
+            double value = T->coefficient;
+
+            for(auto& V2 : T->variables)
+            {
+                if(V1 == V2)
+                    continue;
+
+                value *= point[V2->index];
+            }
+
+            values[monomialGradientPositions[position]] += value;
+            position++;
+        }
+    }
+
+    position = 0;
+
+    for(auto& T : signomialTerms)
+    {
+        if(T->coefficient == 0.0)
+        {
+            position += T->elements.size();
+            continue;
+        }
+
+        for(auto& E1 : T->elements)
+        {
+            double value = T->coefficient;
+
+            for(auto& E2 : T->elements)
+            {
+                if(E1 == E2)
+                {
+                    if(E2->power != 1.0)
+                        value *= E2->power * pow(point[E2->variable->index], E2->power - 1.0);
+                }
+                else
+                {
+                    value *= E2->calculate(point);
+                }
+            }
+
+            values[signomialGradientPositions[position]] += value;
+            position++;
+        }
+    }
+
+    if(!includeNonlinearExpression)
+        return;
+
+    if(this->properties.hasNonlinearExpression && hasSeparateNonlinearExpressionDerivatives())
+    {
+        auto& derivatives = calculateNonlinearExpressionDerivatives(point);
+
+        for(size_t k = 0; k < derivatives.size(); k++)
+        {
+            if(nonlinearExpressionVariableGradientPositions[k] >= 0)
+                values[nonlinearExpressionVariableGradientPositions[k]] += derivatives[k];
+        }
+    }
+    else if(this->properties.hasNonlinearExpression && nonlinearGradientSparsityPattern.nnz() > 0)
+    {
+        if(auto sharedOwnerProblem = ownerProblem.lock())
+        {
+            // Reused between calls, the size only changes if the problem changes
+            thread_local std::vector<double> pointNonlinearSubset;
+            pointNonlinearSubset.resize(sharedOwnerProblem->properties.numberOfVariablesInNonlinearExpressions);
+
+            for(auto& VAR : sharedOwnerProblem->nonlinearExpressionVariables)
+                pointNonlinearSubset[VAR->properties.nonlinearVariableIndex] = point[VAR->index];
+
+            auto cppADLock = Problem::lockCppADEvaluation();
+
+            CppAD::sparse_rcv<std::vector<size_t>, std::vector<double>> subset(nonlinearGradientSparsityPattern);
+            sharedOwnerProblem->getADFunctions().subgraph_jac_rev(pointNonlinearSubset, subset);
+
+            const std::vector<double>& value(subset.val());
+
+            for(size_t k = 0; k < subset.nnz(); k++)
+            {
+                if(nonlinearExpressionGradientPositions[k] >= 0)
+                    values[nonlinearExpressionGradientPositions[k]] += value[k];
+            }
+        }
+    }
+}
+
 SparseVariableMatrix NonlinearConstraint::calculateHessian(const VectorDouble& point, bool eraseZeroes = true)
+{
+    return (calculateHessian(point, eraseZeroes, true));
+}
+
+SparseVariableMatrix NonlinearConstraint::calculateHessian(
+    const VectorDouble& point, bool eraseZeroes, bool includeNonlinearExpression)
 {
     SparseVariableMatrix hessian = QuadraticConstraint::calculateHessian(point, eraseZeroes);
 
@@ -810,12 +1578,40 @@ SparseVariableMatrix NonlinearConstraint::calculateHessian(const VectorDouble& p
         hessian = Utilities::combineSparseVariableMatrices(signomialTerms.calculateHessian(point), hessian);
     }
 
-    if(this->properties.hasNonlinearExpression)
+    if(includeNonlinearExpression && this->properties.hasNonlinearExpression)
     {
         if(!nonlinearHessianSparsityMapGenerated)
             initializeHessianSparsityPattern();
 
-        if(auto sharedOwnerProblem = ownerProblem.lock())
+        // The variables of the tape are the same as variablesInNonlinearExpression, see
+        // Problem::updateExpressionTapes()
+        if(useTapeForHessian && nonlinearExpressionTape)
+        {
+            thread_local VectorDouble calculatedHessian;
+            nonlinearExpressionTape->calculateHessian(point, calculatedHessian);
+
+            size_t numberOfNonlinearVariables = variablesInNonlinearExpression.size();
+
+            for(size_t k = 0; k < numberOfNonlinearVariables; k++)
+            {
+                // The variables are sorted, so the upper triangular part is where the second index is not smaller
+                for(size_t l = k; l < numberOfNonlinearVariables; l++)
+                {
+                    double hessianValue = calculatedHessian[k * numberOfNonlinearVariables + l];
+
+                    if(hessianValue == 0.0)
+                        continue;
+
+                    auto element = hessian.emplace(
+                        std::make_pair(variablesInNonlinearExpression[k], variablesInNonlinearExpression[l]),
+                        hessianValue);
+
+                    if(!element.second)
+                        element.first->second += hessianValue;
+                }
+            }
+        }
+        else if(auto sharedOwnerProblem = ownerProblem.lock())
         {
             int numberOfNonlinearVariables = sharedOwnerProblem->properties.numberOfVariablesInNonlinearExpressions;
 
@@ -827,8 +1623,10 @@ SparseVariableMatrix NonlinearConstraint::calculateHessian(const VectorDouble& p
             for(auto& VAR : sharedOwnerProblem->nonlinearExpressionVariables)
                 pointNonlinearSubset[VAR->properties.nonlinearVariableIndex] = point[VAR->index];
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             // TODO: utilize sparsity pattern
-            auto calculatedHessian = sharedOwnerProblem->ADFunctions.SparseHessian(pointNonlinearSubset, weights);
+            auto calculatedHessian = sharedOwnerProblem->getADFunctions().SparseHessian(pointNonlinearSubset, weights);
 
             for(auto& V1 : variablesInNonlinearExpression)
             {
@@ -932,9 +1730,11 @@ void NonlinearConstraint::initializeHessianSparsityPattern()
 
             nonlinearFunctionMap[this->nonlinearExpressionIndex] = true;
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             CppAD::sparse_rc<std::vector<size_t>> pattern;
 
-            sharedOwnerProblem->ADFunctions.for_hes_sparsity(
+            sharedOwnerProblem->getADFunctions().for_hes_sparsity(
                 nonlinearVariablesInExpressionMap, nonlinearFunctionMap, false, pattern);
 
             nonlinearHessianSparsityPattern = pattern;
@@ -997,9 +1797,13 @@ std::shared_ptr<NumericConstraint> NonlinearConstraint::getPointer()
 
 void NonlinearConstraint::updateProperties()
 {
+    // The subexpressions shared in the expression are analysed once
+    ExpressionPropertyCacheScope propertyCacheScope;
+
     QuadraticConstraint::updateProperties();
 
     properties.classification = E_ConstraintClassification::Nonlinear;
+    properties.isSecondOrderCone = false;
 
     variablesInNonlinearExpression.clear();
 
@@ -1093,6 +1897,89 @@ void NonlinearConstraint::updateProperties()
         });
 }
 
+// Appends the structure of the expression, with the values of the constants and the bounds of the variables that its
+// convexity depends on. Shared subexpressions are only appended once, and later referred to by their position.
+static void appendExpressionData(const NonlinearExpression* expression, VectorDouble& data,
+    std::unordered_map<const NonlinearExpression*, size_t>& visited)
+{
+    if(auto V = visited.find(expression); V != visited.end())
+    {
+        data.push_back(-1.0 - V->second);
+        return;
+    }
+
+    visited.emplace(expression, visited.size());
+    data.push_back((double)static_cast<int>(expression->getType()));
+
+    if(auto constant = dynamic_cast<const ExpressionConstant*>(expression))
+    {
+        data.push_back(constant->constant);
+    }
+    else if(auto variable = dynamic_cast<const ExpressionVariable*>(expression))
+    {
+        data.insert(data.end(),
+            { (double)variable->variable->index, variable->variable->lowerBound, variable->variable->upperBound });
+    }
+    else if(auto unary = dynamic_cast<const ExpressionUnary*>(expression))
+    {
+        appendExpressionData(unary->child.get(), data, visited);
+    }
+    else if(auto binary = dynamic_cast<const ExpressionBinary*>(expression))
+    {
+        appendExpressionData(binary->firstChild.get(), data, visited);
+        appendExpressionData(binary->secondChild.get(), data, visited);
+    }
+    else if(auto general = dynamic_cast<const ExpressionGeneral*>(expression))
+    {
+        data.push_back((double)general->children.size());
+
+        for(auto& C : general->children)
+            appendExpressionData(C.get(), data, visited);
+    }
+}
+
+void NonlinearConstraint::appendPropertiesData(VectorDouble& data) const
+{
+    QuadraticConstraint::appendPropertiesData(data);
+
+    auto appendVariable = [&](const VariablePtr& variable) {
+        data.insert(data.end(), { (double)variable->index, variable->lowerBound, variable->upperBound });
+    };
+
+    data.push_back((double)monomialTerms.size());
+
+    for(auto& T : monomialTerms)
+    {
+        data.insert(data.end(), { T->coefficient, (double)T->variables.size() });
+
+        for(auto& V : T->variables)
+            appendVariable(V);
+    }
+
+    data.push_back((double)signomialTerms.size());
+
+    for(auto& T : signomialTerms)
+    {
+        data.insert(data.end(), { T->coefficient, (double)T->elements.size() });
+
+        for(auto& E : T->elements)
+        {
+            appendVariable(E->variable);
+            data.push_back(E->power);
+        }
+    }
+
+    if(nonlinearExpression)
+    {
+        std::unordered_map<const NonlinearExpression*, size_t> visited;
+        appendExpressionData(nonlinearExpression.get(), data, visited);
+    }
+    else
+    {
+        data.push_back(-1.0);
+    }
+}
+
 std::ostream& operator<<(std::ostream& stream, NumericConstraintPtr constraint)
 {
     stream << *constraint;
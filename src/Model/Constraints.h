@@ -10,8 +10,11 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <string>
 #include <memory>
+#include <mutex>
 
 #include "../Enums.h"
 #include "../Structs.h"
@@ -19,6 +22,7 @@
 #include "Variables.h"
 #include "Terms.h"
 #include "NonlinearExpressions.h"
+#include "ExpressionTape.h"
 
 #include "cppad/cppad.hpp"
 #include "cppad/utility.hpp"
@@ -55,6 +59,17 @@ struct ConstraintProperties
 
     bool isReformulated = false;
 
+    // A quadratic constraint with a convex feasible set, although the constraint function is nonconvex, see
+    // QuadraticTerms::isSecondOrderCone()
+    bool isSecondOrderCone = false;
+
+    // The convexity was determined numerically since it was unknown, see Problem::updateConvexityBySampling()
+    bool isConvexityFromSampling = false;
+
+    // The constraint is f(x) - s <= 0 for an auxiliary variable s replacing the univariate function f in a partitioned
+    // sum, and s = f(x) can be given to the MIP solver, see Gurobi.FunctionConstraints.Use
+    bool isFunctionConstraint = false;
+
     bool hasLinearTerms = false;
     bool hasQuadraticTerms = false;
     bool hasMonomialTerms = false;
@@ -116,6 +131,16 @@ struct NumericConstraintValue
 
 using NumericConstraintValues = std::vector<NumericConstraintValue>;
 
+// The nonquadratic terms of a constraint along a line segment. The monomial and signomial terms without variables that
+// differ between the end points are constant along the segment and only their sum is kept, while the other terms are
+// calculated in the points. The remaining terms, e.g. the nonlinear expression, are always calculated in the points.
+struct NonquadraticSegmentTerms
+{
+    double constantValue = 0.0;
+    std::vector<Term*> movingTerms;
+    bool hasRemainingTerms = false;
+};
+
 class NumericConstraint : public Constraint, public std::enable_shared_from_this<NumericConstraint>
 {
 public:
@@ -123,23 +148,70 @@ public:
     double valueRHS = SHOT_DBL_MAX;
     double constant = 0.0;
 
+    // Set when standardized in Problem::updateConstraints(), which writes L <= f(x) as -f(x) <= -L, and may split
+    // L <= f(x) <= U into f(x) <= U and the added constraint -f(x) <= -L. Used to update the bounds of f(x) later.
+    bool isNegatedInStandardForm = false;
+    std::shared_ptr<NumericConstraint> standardFormLHSConstraint;
+
     std::shared_ptr<Variables> gradientSparsityPattern;
     std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> hessianSparsityPattern;
 
     virtual double calculateFunctionValue(const VectorDouble& point) = 0;
     virtual Interval calculateFunctionValue(const IntervalVector& intervalVector) = 0;
 
+    // Calculates the function value in all points of the block, values must have room for points.numberOfPoints
+    virtual void calculateFunctionValues(const PointBlock& points, double* values) = 0;
+
+    // The function value split into the affine part, i.e. the linear terms and the constant, and the value of the
+    // remaining terms. The affine part varies linearly along a line segment, which is utilized in the root searches.
+    virtual double calculateAffineFunctionValue(const VectorDouble& point) = 0;
+    virtual double calculateNonaffineFunctionValue(const VectorDouble& point) = 0;
+    virtual bool hasNonaffineTerms() = 0;
+
+    // The quadratic terms along the segment lambda * firstPoint + (1 - lambda) * secondPoint are the polynomial
+    // c[0] + c[1] * lambda + c[2] * lambda^2, so that the root searches can calculate them in constant time for each
+    // lambda. The nonaffine terms that are not quadratic are then calculated separately in the points.
+    virtual std::array<double, 3> calculateQuadraticSegmentCoefficients(
+        const VectorDouble& firstPoint, const VectorDouble& secondPoint);
+    virtual double calculateNonquadraticFunctionValue(const VectorDouble& point);
+    virtual bool hasNonquadraticTerms();
+
+    // The nonquadratic terms split into those that are constant along the segment and those that are not, the value in
+    // a point on the segment is then calculated from the terms that are not constant only
+    virtual NonquadraticSegmentTerms getNonquadraticSegmentTerms(
+        const VectorDouble& firstPoint, const VectorDouble& secondPoint);
+    virtual double calculateNonquadraticSegmentValue(const NonquadraticSegmentTerms& terms, const VectorDouble& point);
+
     virtual Interval getConstraintFunctionBounds() = 0;
 
     virtual SparseVariableVector calculateGradient(const VectorDouble& point, bool eraseZeroes) = 0;
     virtual std::shared_ptr<Variables> getGradientSparsityPattern();
 
+    // Writes the gradient into a buffer laid out according to the gradient sparsity pattern. Zero elements are kept,
+    // and the buffer is only reallocated if it does not already have the layout of this constraint. The derivatives of
+    // the nonlinear expression are left out if includeNonlinearExpression is false, e.g. if they are calculated for
+    // several constraints at once by Problem::calculateConstraintGradients().
+    void calculateSparseGradient(
+        const VectorDouble& point, SparseGradient& gradient, bool includeNonlinearExpression = true);
+
+    // As above, but writes the values directly into a buffer with room for the whole gradient sparsity pattern
+    void calculateSparseGradient(const VectorDouble& point, double* values, bool includeNonlinearExpression = true);
+
     // Returns the upper triagonal part of the Hessian matrix is sparse representation
     virtual SparseVariableMatrix calculateHessian(const VectorDouble& point, bool eraseZeroes) = 0;
     virtual std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> getHessianSparsityPattern();
 
     virtual NumericConstraintValue calculateNumericValue(const VectorDouble& point, double correction = 0.0);
 
+    // Initializes the data used by calculateSparseGradient, after which it can be called from several threads
+    void initializeGradientCalculation();
+
+    // Returns one value per point in the block, in the same order as the points
+    NumericConstraintValues calculateNumericValues(const PointBlock& points, double correction = 0.0);
+
+    // Creates the constraint value from an already calculated function value, e.g. one that has been cached
+    NumericConstraintValue createNumericValue(double value);
+
     bool isFulfilled(const VectorDouble& point) override;
 
     void takeOwnership(ProblemPtr owner) override = 0;
@@ -148,9 +220,32 @@ public:
 
     void updateProperties() override = 0;
 
+    // Only updates the properties if the bounds, terms or the bounds of the variables in nonlinear terms have changed
+    // since they were last updated here, returns true if they were updated
+    bool updatePropertiesIfChanged();
+
 protected:
+    // Appends all values that the properties depend on, which are compared in updatePropertiesIfChanged()
+    virtual void appendPropertiesData(VectorDouble& data) const = 0;
+
+    uint64_t propertiesFingerprint = 0;
+    bool hasPropertiesFingerprint = false;
+
     virtual void initializeGradientSparsityPattern() = 0;
     virtual void initializeHessianSparsityPattern() = 0;
+
+    // Positions of the term derivatives in the sparsity pattern, computed once before the first sparse gradient. The
+    // flag is set with release semantics after the sparsity pattern and positions have been written, so a thread that
+    // reads it as true with acquire semantics also sees them without taking the lock.
+    virtual void initializeGradientPositions() {};
+    std::atomic<bool> gradientPositionsInitialized { false };
+    std::mutex gradientPositionsMutex;
+
+    // Returns the position of the variable in the sorted gradient sparsity pattern, or -1 if it is not part of it
+    int getGradientPosition(const VariablePtr& variable);
+
+    // Adds the derivatives of the terms to the values of the gradient, which follow the sparsity pattern
+    virtual void addGradientValues(const VectorDouble& point, double* values, bool includeNonlinearExpression) = 0;
 };
 
 class LinearConstraint : public NumericConstraint
@@ -184,6 +279,11 @@ public:
 
     double calculateFunctionValue(const VectorDouble& point) override;
     Interval calculateFunctionValue(const IntervalVector& intervalVector) override;
+    void calculateFunctionValues(const PointBlock& points, double* values) override;
+
+    double calculateAffineFunctionValue(const VectorDouble& point) override;
+    double calculateNonaffineFunctionValue(const VectorDouble& point) override;
+    bool hasNonaffineTerms() override;
 
     Interval getConstraintFunctionBounds() override;
 
@@ -207,6 +307,17 @@ public:
 protected:
     void initializeGradientSparsityPattern() override;
     void initializeHessianSparsityPattern() override;
+
+    void initializeGradientPositions() override;
+    void addGradientValues(const VectorDouble& point, double* values, bool includeNonlinearExpression) override;
+
+    void appendPropertiesData(VectorDouble& data) const override;
+
+    std::vector<int> linearGradientPositions;
+
+    // Updated in updateProperties(), and used instead of linearTerms when evaluating if it is in sync
+    PackedLinearTerms packedLinearTerms;
+    inline bool isPackedLinearTermsValid() const { return (packedLinearTerms.size() == linearTerms.size()); }
 };
 
 using LinearConstraintPtr = std::shared_ptr<LinearConstraint>;
@@ -262,6 +373,15 @@ public:
 
     double calculateFunctionValue(const VectorDouble& point) override;
     Interval calculateFunctionValue(const IntervalVector& intervalVector) override;
+    void calculateFunctionValues(const PointBlock& points, double* values) override;
+
+    double calculateNonaffineFunctionValue(const VectorDouble& point) override;
+    bool hasNonaffineTerms() override;
+
+    std::array<double, 3> calculateQuadraticSegmentCoefficients(
+        const VectorDouble& firstPoint, const VectorDouble& secondPoint) override;
+    double calculateNonquadraticFunctionValue(const VectorDouble& point) override;
+    bool hasNonquadraticTerms() override;
 
     Interval getConstraintFunctionBounds() override;
 
@@ -285,6 +405,18 @@ public:
 protected:
     void initializeGradientSparsityPattern() override;
     void initializeHessianSparsityPattern() override;
+
+    void initializeGradientPositions() override;
+    void addGradientValues(const VectorDouble& point, double* values, bool includeNonlinearExpression) override;
+
+    void appendPropertiesData(VectorDouble& data) const override;
+
+    // Two positions per term, for the first and second variable
+    std::vector<int> quadraticGradientPositions;
+
+    // Updated in updateProperties(), and used instead of quadraticTerms when evaluating if it is in sync
+    PackedQuadraticTerms packedQuadraticTerms;
+    inline bool isPackedQuadraticTermsValid() const { return (packedQuadraticTerms.size() == quadraticTerms.size()); }
 };
 
 using QuadraticConstraintPtr = std::shared_ptr<QuadraticConstraint>;
@@ -301,12 +433,26 @@ public:
     NonlinearExpressionPtr nonlinearExpression;
     FactorableFunctionPtr factorableFunction;
 
+    // Compiled version of nonlinearExpression, created in Problem::finalize() if enabled
+    ExpressionTapePtr nonlinearExpressionTape;
+
+    // Whether the gradient of the nonlinear expression is calculated on the tape, set in Problem::finalize()
+    bool useTapeForGradient = false;
+
+    // Whether the Hessian of the nonlinear expression is calculated on the tape, set in Problem::finalize()
+    bool useTapeForHessian = false;
+
     CppAD::sparse_rc<std::vector<size_t>> nonlinearGradientSparsityPattern;
     CppAD::sparse_rc<std::vector<size_t>> nonlinearHessianSparsityPattern;
 
     bool nonlinearGradientSparsityMapGenerated = false;
     bool nonlinearHessianSparsityMapGenerated = false;
 
+    // The nonlinear expression recorded as a function of variablesInNonlinearExpression only, so that its gradient
+    // can be calculated without a pass over the recording of the whole problem. Enabled in Problem::finalize() but only
+    // recorded when the derivatives are first needed, and evaluated through per-thread copies.
+    CppAD::ADFun<double> nonlinearExpressionADFunction;
+
     Variables variablesInMonomialTerms;
     Variables variablesInSignomialTerms;
     Variables variablesInNonlinearExpression;
@@ -390,6 +536,18 @@ public:
     void add(NonlinearExpressionPtr expression);
 
     void updateFactorableFunction();
+    void recordNonlinearExpressionADFunction();
+    void enableNonlinearExpressionADFunction();
+
+    // The bytes of nonlinearExpressionADFunction and its copies
+    size_t getADFunctionMemoryUsage() const;
+
+    // Whether the derivatives of the nonlinear expression are calculated with nonlinearExpressionTape or
+    // nonlinearExpressionADFunction instead of the recording of the whole problem
+    inline bool hasSeparateNonlinearExpressionDerivatives() const
+    {
+        return (useNonlinearExpressionADFunction || (useTapeForGradient && nonlinearExpressionTape));
+    }
 
     double calculateFunctionValue(const VectorDouble& point) override;
 
@@ -400,7 +558,28 @@ public:
     // Returns the upper triagonal part of the Hessian matrix is sparse representation
     SparseVariableMatrix calculateHessian(const VectorDouble& point, bool eraseZeroes) override;
 
+    // The nonlinear expression can be left out if its Hessian is calculated elsewhere, see
+    // Problem::calculateLagrangianHessian()
+    SparseVariableMatrix calculateHessian(
+        const VectorDouble& point, bool eraseZeroes, bool includeNonlinearExpression);
+
     Interval calculateFunctionValue(const IntervalVector& intervalVector) override;
+    void calculateFunctionValues(const PointBlock& points, double* values) override;
+
+    // As calculateFunctionValues(), but with the nonlinear expression evaluated in single precision in the points given
+    // as singlePrecisionPoints. Returns false if the nonlinear expression has no tape.
+    bool calculateApproximateFunctionValues(
+        const PointBlock& points, const PointBlockFloat& singlePrecisionPoints, double* values);
+
+    double calculateNonaffineFunctionValue(const VectorDouble& point) override;
+    bool hasNonaffineTerms() override;
+
+    double calculateNonquadraticFunctionValue(const VectorDouble& point) override;
+    bool hasNonquadraticTerms() override;
+
+    NonquadraticSegmentTerms getNonquadraticSegmentTerms(
+        const VectorDouble& firstPoint, const VectorDouble& secondPoint) override;
+    double calculateNonquadraticSegmentValue(const NonquadraticSegmentTerms& terms, const VectorDouble& point) override;
 
     bool isFulfilled(const VectorDouble& point) override;
 
@@ -417,6 +596,28 @@ public:
 protected:
     void initializeGradientSparsityPattern() override;
     void initializeHessianSparsityPattern() override;
+
+    void initializeGradientPositions() override;
+    void addGradientValues(const VectorDouble& point, double* values, bool includeNonlinearExpression) override;
+
+    void appendPropertiesData(VectorDouble& data) const override;
+
+    // One position per variable in each term, in the order of the terms
+    std::vector<int> monomialGradientPositions;
+    std::vector<int> signomialGradientPositions;
+
+    // One position per nonzero in nonlinearGradientSparsityPattern
+    std::vector<int> nonlinearExpressionGradientPositions;
+
+    // One position per variable in variablesInNonlinearExpression
+    std::vector<int> nonlinearExpressionVariableGradientPositions;
+
+    bool useNonlinearExpressionADFunction = false;
+    std::atomic<bool> isNonlinearExpressionADFunctionRecorded { false };
+    std::vector<std::unique_ptr<CppAD::ADFun<double>>> nonlinearExpressionADFunctionCopies;
+
+    // Returns the partial derivatives of the nonlinear expression with respect to variablesInNonlinearExpression
+    const VectorDouble& calculateNonlinearExpressionDerivatives(const VectorDouble& point);
 };
 
 using NonlinearConstraintPtr = std::shared_ptr<NonlinearConstraint>;
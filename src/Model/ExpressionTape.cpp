@@ -0,0 +1,1156 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "ExpressionTape.h"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace SHOT
+{
+
+namespace Tangent
+{
+// A value together with its directional derivative, used to differentiate the reverse pass of the tape once more in
+// the forward direction when calculating Hessian-vector products. The functions are found by argument-dependent
+// lookup, so the same code can be used with plain doubles.
+struct TangentValue
+{
+    double value = 0.0;
+    double tangent = 0.0;
+
+    TangentValue() = default;
+    TangentValue(double value) : value(value) {};
+    TangentValue(double value, double tangent) : value(value), tangent(tangent) {};
+
+    inline TangentValue& operator+=(const TangentValue& other)
+    {
+        value += other.value;
+        tangent += other.tangent;
+        return (*this);
+    }
+
+    inline TangentValue& operator-=(const TangentValue& other)
+    {
+        value -= other.value;
+        tangent -= other.tangent;
+        return (*this);
+    }
+
+    inline TangentValue& operator*=(const TangentValue& other)
+    {
+        tangent = tangent * other.value + value * other.tangent;
+        value *= other.value;
+        return (*this);
+    }
+};
+
+inline TangentValue operator-(const TangentValue& x) { return (TangentValue(-x.value, -x.tangent)); }
+
+inline TangentValue operator+(const TangentValue& x, const TangentValue& y)
+{
+    return (TangentValue(x.value + y.value, x.tangent + y.tangent));
+}
+
+inline TangentValue operator-(const TangentValue& x, const TangentValue& y)
+{
+    return (TangentValue(x.value - y.value, x.tangent - y.tangent));
+}
+
+inline TangentValue operator*(const TangentValue& x, const TangentValue& y)
+{
+    return (TangentValue(x.value * y.value, x.tangent * y.value + x.value * y.tangent));
+}
+
+inline TangentValue operator/(const TangentValue& x, const TangentValue& y)
+{
+    double value = x.value / y.value;
+    return (TangentValue(value, (x.tangent - value * y.tangent) / y.value));
+}
+
+inline TangentValue sqrt(const TangentValue& x)
+{
+    double value = std::sqrt(x.value);
+    return (TangentValue(value, x.tangent * 0.5 / value));
+}
+
+inline TangentValue log(const TangentValue& x) { return (TangentValue(std::log(x.value), x.tangent / x.value)); }
+
+inline TangentValue exp(const TangentValue& x)
+{
+    double value = std::exp(x.value);
+    return (TangentValue(value, x.tangent * value));
+}
+
+inline TangentValue sin(const TangentValue& x)
+{
+    return (TangentValue(std::sin(x.value), x.tangent * std::cos(x.value)));
+}
+
+inline TangentValue cos(const TangentValue& x)
+{
+    return (TangentValue(std::cos(x.value), -x.tangent * std::sin(x.value)));
+}
+
+inline TangentValue tan(const TangentValue& x)
+{
+    double value = std::tan(x.value);
+    return (TangentValue(value, x.tangent * (1.0 + value * value)));
+}
+
+inline TangentValue acos(const TangentValue& x)
+{
+    return (TangentValue(std::acos(x.value), -x.tangent / std::sqrt(1.0 - x.value * x.value)));
+}
+
+inline TangentValue asin(const TangentValue& x)
+{
+    return (TangentValue(std::asin(x.value), x.tangent / std::sqrt(1.0 - x.value * x.value)));
+}
+
+inline TangentValue atan(const TangentValue& x)
+{
+    return (TangentValue(std::atan(x.value), x.tangent / (1.0 + x.value * x.value)));
+}
+
+inline TangentValue fabs(const TangentValue& x)
+{
+    double sign = (x.value > 0.0) ? 1.0 : ((x.value < 0.0) ? -1.0 : 0.0);
+    return (TangentValue(std::fabs(x.value), sign * x.tangent));
+}
+
+inline TangentValue pow(const TangentValue& x, const TangentValue& y)
+{
+    double value = std::pow(x.value, y.value);
+    double tangent = 0.0;
+
+    if(x.tangent != 0.0)
+        tangent += x.tangent * y.value * std::pow(x.value, y.value - 1.0);
+
+    // The logarithm is only needed if the exponent is not constant
+    if(y.tangent != 0.0 && x.value > 0.0)
+        tangent += y.tangent * value * std::log(x.value);
+
+    return (TangentValue(value, tangent));
+}
+
+inline double primal(double x) { return (x); }
+inline double primal(const TangentValue& x) { return (x.value); }
+
+inline bool isZero(double x) { return (x == 0.0); }
+inline bool isZero(const TangentValue& x) { return (x.value == 0.0 && x.tangent == 0.0); }
+} // namespace Tangent
+
+template <typename T, typename F> inline void transformBlock(T* values, int numberOfPoints, F function)
+{
+    for(int p = 0; p < numberOfPoints; p++)
+        values[p] = function(values[p]);
+}
+
+void ExpressionTape::clear()
+{
+    opcodes.clear();
+    operands.clear();
+    constants.clear();
+    maxStackSize = 0;
+
+    childrenStarts.clear();
+    children.clear();
+    variableIndexes.clear();
+    variablePositions.clear();
+}
+
+bool ExpressionTape::compile(const NonlinearExpressionPtr& expression)
+{
+    clear();
+
+    if(!expression)
+        return (false);
+
+    size_t stackSize = 0;
+
+    if(!append(expression, stackSize))
+    {
+        clear();
+        return (false);
+    }
+
+    assert(stackSize == 1);
+
+    opcodes.shrink_to_fit();
+    operands.shrink_to_fit();
+    constants.shrink_to_fit();
+
+    initializeGradientCalculation();
+
+    return (true);
+}
+
+void ExpressionTape::initializeGradientCalculation()
+{
+    const size_t numberOfInstructions = opcodes.size();
+
+    childrenStarts.resize(numberOfInstructions + 1);
+    children.clear();
+    children.reserve(numberOfInstructions);
+
+    // The instructions whose results are on the stack
+    std::vector<int> stack;
+    stack.reserve(maxStackSize);
+
+    for(size_t i = 0; i < numberOfInstructions; i++)
+    {
+        size_t numberOfArguments = 0;
+
+        switch(opcodes[i])
+        {
+        case E_NonlinearExpressionTypes::Constant:
+        case E_NonlinearExpressionTypes::Variable:
+            break;
+
+        case E_NonlinearExpressionTypes::Divide:
+        case E_NonlinearExpressionTypes::Power:
+            numberOfArguments = 2;
+            break;
+
+        case E_NonlinearExpressionTypes::Sum:
+        case E_NonlinearExpressionTypes::Product:
+            numberOfArguments = operands[i];
+            break;
+
+        default:
+            numberOfArguments = 1;
+            break;
+        }
+
+        assert(stack.size() >= numberOfArguments);
+
+        childrenStarts[i] = children.size();
+        children.insert(children.end(), stack.end() - numberOfArguments, stack.end());
+        stack.resize(stack.size() - numberOfArguments);
+        stack.push_back(i);
+    }
+
+    childrenStarts[numberOfInstructions] = children.size();
+
+    for(size_t i = 0; i < numberOfInstructions; i++)
+    {
+        if(opcodes[i] == E_NonlinearExpressionTypes::Variable)
+            variableIndexes.push_back(operands[i]);
+    }
+
+    std::sort(variableIndexes.begin(), variableIndexes.end());
+    variableIndexes.erase(std::unique(variableIndexes.begin(), variableIndexes.end()), variableIndexes.end());
+
+    variablePositions.assign(numberOfInstructions, -1);
+
+    for(size_t i = 0; i < numberOfInstructions; i++)
+    {
+        if(opcodes[i] == E_NonlinearExpressionTypes::Variable)
+        {
+            auto position = std::lower_bound(variableIndexes.begin(), variableIndexes.end(), operands[i]);
+            variablePositions[i] = position - variableIndexes.begin();
+        }
+    }
+}
+
+void ExpressionTape::appendInstruction(
+    E_NonlinearExpressionTypes opcode, int operand, int stackChange, size_t& stackSize)
+{
+    opcodes.push_back(opcode);
+    operands.push_back(operand);
+
+    stackSize += stackChange;
+    maxStackSize = std::max(maxStackSize, stackSize);
+}
+
+bool ExpressionTape::append(const NonlinearExpressionPtr& expression, size_t& stackSize)
+{
+    auto type = expression->getType();
+
+    switch(type)
+    {
+    case E_NonlinearExpressionTypes::Constant:
+        constants.push_back(std::static_pointer_cast<ExpressionConstant>(expression)->constant);
+        appendInstruction(type, (int)constants.size() - 1, 1, stackSize);
+        return (true);
+
+    case E_NonlinearExpressionTypes::Variable:
+        appendInstruction(
+            type, std::static_pointer_cast<ExpressionVariable>(expression)->variable->index, 1, stackSize);
+        return (true);
+
+    case E_NonlinearExpressionTypes::Negate:
+    case E_NonlinearExpressionTypes::Invert:
+    case E_NonlinearExpressionTypes::SquareRoot:
+    case E_NonlinearExpressionTypes::Log:
+    case E_NonlinearExpressionTypes::Exp:
+    case E_NonlinearExpressionTypes::Square:
+    case E_NonlinearExpressionTypes::Cos:
+    case E_NonlinearExpressionTypes::Sin:
+    case E_NonlinearExpressionTypes::Tan:
+    case E_NonlinearExpressionTypes::ArcCos:
+    case E_NonlinearExpressionTypes::ArcSin:
+    case E_NonlinearExpressionTypes::ArcTan:
+    case E_NonlinearExpressionTypes::Abs:
+        if(!append(std::static_pointer_cast<ExpressionUnary>(expression)->child, stackSize))
+            return (false);
+
+        appendInstruction(type, 0, 0, stackSize);
+        return (true);
+
+    case E_NonlinearExpressionTypes::Divide:
+    case E_NonlinearExpressionTypes::Power:
+    {
+        auto binary = std::static_pointer_cast<ExpressionBinary>(expression);
+
+        if(!append(binary->firstChild, stackSize) || !append(binary->secondChild, stackSize))
+            return (false);
+
+        int isConstantExponent = (binary->secondChild->getType() == E_NonlinearExpressionTypes::Constant) ? 1 : 0;
+
+        appendInstruction(type, isConstantExponent, -1, stackSize);
+        return (true);
+    }
+
+    case E_NonlinearExpressionTypes::Sum:
+    case E_NonlinearExpressionTypes::Product:
+    {
+        auto general = std::static_pointer_cast<ExpressionGeneral>(expression);
+        int numberOfChildren = general->getNumberOfChildren();
+
+        if(numberOfChildren == 0)
+        {
+            constants.push_back(type == E_NonlinearExpressionTypes::Sum ? 0.0 : 1.0);
+            appendInstruction(E_NonlinearExpressionTypes::Constant, (int)constants.size() - 1, 1, stackSize);
+            return (true);
+        }
+
+        for(auto& C : general->children)
+        {
+            if(!append(C, stackSize))
+                return (false);
+        }
+
+        appendInstruction(type, numberOfChildren, 1 - numberOfChildren, stackSize);
+        return (true);
+    }
+
+    default:
+        return (false);
+    }
+}
+
+double ExpressionTape::calculate(const VectorDouble& point) const
+{
+    // The stack is thread local so that the same tape can be evaluated concurrently
+    thread_local VectorDouble stack;
+
+    if(stack.size() < maxStackSize)
+        stack.resize(maxStackSize);
+
+    double* top = stack.data() - 1;
+
+    const size_t numberOfInstructions = opcodes.size();
+
+    for(size_t i = 0; i < numberOfInstructions; i++)
+    {
+        switch(opcodes[i])
+        {
+        case E_NonlinearExpressionTypes::Constant:
+            *(++top) = constants[operands[i]];
+            break;
+
+        case E_NonlinearExpressionTypes::Variable:
+            *(++top) = point[operands[i]];
+            break;
+
+        case E_NonlinearExpressionTypes::Negate:
+            *top = -*top;
+            break;
+
+        case E_NonlinearExpressionTypes::Invert:
+            *top = 1.0 / *top;
+            break;
+
+        case E_NonlinearExpressionTypes::SquareRoot:
+            *top = sqrt(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Log:
+            *top = log(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Exp:
+            *top = exp(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Square:
+            *top = *top * *top;
+            break;
+
+        case E_NonlinearExpressionTypes::Cos:
+            *top = cos(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Sin:
+            *top = sin(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Tan:
+            *top = tan(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcCos:
+            *top = acos(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcSin:
+            *top = asin(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcTan:
+            *top = atan(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Abs:
+            *top = fabs(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Divide:
+        {
+            double denominator = *(top--);
+            *top = *top / denominator;
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Power:
+        {
+            double exponent = *(top--);
+            double base = *top;
+
+            // Same special cases as in ExpressionPower::calculate
+            if(std::abs(base - 0.0) <= 1e-10 * std::abs(base))
+                *top = 0.0;
+            else if(std::abs(base - 1.0) <= 1e-10 * std::abs(base))
+                *top = 1.0;
+            else if(std::abs(exponent - 0.0) <= 1e-10 * std::abs(base))
+                *top = 1.0;
+            else if(std::abs(exponent - 1.0) <= 1e-10 * std::abs(base))
+                *top = base;
+            else
+                *top = pow(base, exponent);
+
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Sum:
+        {
+            int numberOfChildren = operands[i];
+            top -= numberOfChildren - 1;
+
+            double value = 0.0;
+
+            for(int j = 0; j < numberOfChildren; j++)
+                value += top[j];
+
+            *top = value;
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Product:
+        {
+            int numberOfChildren = operands[i];
+            top -= numberOfChildren - 1;
+
+            double value = 1.0;
+
+            // A zero factor gives a zero product regardless of the remaining factors, as in the expression tree
+            for(int j = 0; j < numberOfChildren; j++)
+            {
+                if(top[j] == 0.0)
+                {
+                    value = 0.0;
+                    break;
+                }
+
+                value = value * top[j];
+            }
+
+            *top = value;
+            break;
+        }
+
+        default:
+            assert(false);
+            break;
+        }
+    }
+
+    return (stack[0]);
+}
+
+Interval ExpressionTape::calculate(const IntervalVector& intervalVector) const
+{
+    thread_local IntervalVector stack;
+
+    if(stack.size() < maxStackSize)
+        stack.resize(maxStackSize);
+
+    Interval* top = stack.data() - 1;
+
+    const size_t numberOfInstructions = opcodes.size();
+
+    for(size_t i = 0; i < numberOfInstructions; i++)
+    {
+        switch(opcodes[i])
+        {
+        case E_NonlinearExpressionTypes::Constant:
+            *(++top) = Interval(constants[operands[i]]);
+            break;
+
+        case E_NonlinearExpressionTypes::Variable:
+            *(++top) = intervalVector[operands[i]];
+            break;
+
+        case E_NonlinearExpressionTypes::Negate:
+            *top = -*top;
+            break;
+
+        case E_NonlinearExpressionTypes::Invert:
+            *top = 1.0 / *top;
+            break;
+
+        case E_NonlinearExpressionTypes::SquareRoot:
+            *top = sqrt(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Log:
+            if(top->l() <= 0)
+                top->l(SHOT_DBL_EPS);
+
+            *top = log(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Exp:
+            *top = exp(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Square:
+            *top = pow(*top, 2);
+            break;
+
+        case E_NonlinearExpressionTypes::Cos:
+            *top = cos(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Sin:
+            *top = sin(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Tan:
+            *top = tan(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcCos:
+            *top = acos(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcSin:
+            *top = asin(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcTan:
+            *top = atan(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Abs:
+            *top = fabs(*top);
+            break;
+
+        case E_NonlinearExpressionTypes::Divide:
+        {
+            Interval denominator = *(top--);
+            *top = *top / denominator;
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Power:
+        {
+            // Same bound handling as in ExpressionPower::calculate
+            Interval powerBounds = *(top--);
+            Interval baseBounds = *top;
+
+            if(operands[i] == 1)
+            {
+                double power = powerBounds.l();
+
+                double intpart;
+                bool isInteger = (std::modf(power, &intpart) == 0.0);
+                int integerValue = (int)round(intpart);
+                bool isEven = (integerValue % 2 == 0);
+
+                if(baseBounds.l() <= 0)
+                {
+                    if(!isInteger)
+                        baseBounds.l(SHOT_DBL_EPS);
+                    else if(isInteger && power < 0)
+                        baseBounds.l(SHOT_DBL_EPS);
+                }
+
+                Interval bounds(0.0);
+
+                if(isInteger)
+                    bounds = pow(baseBounds, (int)power);
+                else
+                    bounds = pow(baseBounds, power);
+
+                if(isInteger && isEven && bounds.l() <= 0.0)
+                    bounds.l(0.0);
+
+                *top = bounds;
+                break;
+            }
+
+            if(powerBounds.l() < 0)
+            {
+                if(baseBounds.l() <= 0)
+                    baseBounds.l(SHOT_DBL_EPS);
+            }
+            else if(powerBounds.l() == 0.0)
+            {
+                if(baseBounds.l() < 0)
+                    baseBounds.l(0.0);
+                if(baseBounds.l() <= 0)
+                    baseBounds.l(SHOT_DBL_EPS);
+            }
+
+            *top = pow(baseBounds, powerBounds);
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Sum:
+        {
+            int numberOfChildren = operands[i];
+            top -= numberOfChildren - 1;
+
+            Interval value(0.);
+
+            for(int j = 0; j < numberOfChildren; j++)
+                value += top[j];
+
+            *top = value;
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Product:
+        {
+            int numberOfChildren = operands[i];
+            top -= numberOfChildren - 1;
+
+            Interval value(1., 1.);
+
+            for(int j = 0; j < numberOfChildren; j++)
+                value = value * top[j];
+
+            *top = value;
+            break;
+        }
+
+        default:
+            assert(false);
+            break;
+        }
+    }
+
+    return (stack[0]);
+}
+
+template <typename T> void ExpressionTape::calculateBlock(const BasicPointBlock<T>& points, T* values) const
+{
+    const int numberOfPoints = points.numberOfPoints;
+
+    if(numberOfPoints == 0)
+        return;
+
+    // Stack entry k holds the values for all points in stack[k * numberOfPoints, (k + 1) * numberOfPoints)
+    thread_local std::vector<T> stack;
+
+    if(stack.size() < maxStackSize * numberOfPoints)
+        stack.resize(maxStackSize * numberOfPoints);
+
+    T* top = stack.data() - numberOfPoints;
+
+    const size_t numberOfInstructions = opcodes.size();
+
+    for(size_t i = 0; i < numberOfInstructions; i++)
+    {
+        switch(opcodes[i])
+        {
+        case E_NonlinearExpressionTypes::Constant:
+        {
+            top += numberOfPoints;
+            T constant = (T)constants[operands[i]];
+
+            for(int p = 0; p < numberOfPoints; p++)
+                top[p] = constant;
+
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Variable:
+        {
+            top += numberOfPoints;
+            const T* variableValues = points.getVariableValues(operands[i]);
+
+            for(int p = 0; p < numberOfPoints; p++)
+                top[p] = variableValues[p];
+
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Negate:
+            transformBlock(top, numberOfPoints, [](T x) { return (-x); });
+            break;
+
+        case E_NonlinearExpressionTypes::Invert:
+            transformBlock(top, numberOfPoints, [](T x) { return (1 / x); });
+            break;
+
+        case E_NonlinearExpressionTypes::SquareRoot:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::sqrt(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::Log:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::log(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::Exp:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::exp(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::Square:
+            transformBlock(top, numberOfPoints, [](T x) { return (x * x); });
+            break;
+
+        case E_NonlinearExpressionTypes::Cos:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::cos(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::Sin:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::sin(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::Tan:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::tan(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::ArcCos:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::acos(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::ArcSin:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::asin(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::ArcTan:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::atan(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::Abs:
+            transformBlock(top, numberOfPoints, [](T x) { return (std::fabs(x)); });
+            break;
+
+        case E_NonlinearExpressionTypes::Divide:
+        {
+            const T* denominator = top;
+            top -= numberOfPoints;
+
+            for(int p = 0; p < numberOfPoints; p++)
+                top[p] = top[p] / denominator[p];
+
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Power:
+        {
+            const T* exponents = top;
+            top -= numberOfPoints;
+
+            for(int p = 0; p < numberOfPoints; p++)
+            {
+                T base = top[p];
+                T exponent = exponents[p];
+
+                // Same special cases as in ExpressionPower::calculate
+                if(std::abs(base - 0.0) <= 1e-10 * std::abs(base))
+                    top[p] = 0.0;
+                else if(std::abs(base - 1.0) <= 1e-10 * std::abs(base))
+                    top[p] = 1.0;
+                else if(std::abs(exponent - 0.0) <= 1e-10 * std::abs(base))
+                    top[p] = 1.0;
+                else if(std::abs(exponent - 1.0) <= 1e-10 * std::abs(base))
+                    top[p] = base;
+                else
+                    top[p] = std::pow(base, exponent);
+            }
+
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Sum:
+        {
+            int numberOfChildren = operands[i];
+            top -= (numberOfChildren - 1) * numberOfPoints;
+
+            for(int j = 1; j < numberOfChildren; j++)
+            {
+                const T* child = top + j * numberOfPoints;
+
+                for(int p = 0; p < numberOfPoints; p++)
+                    top[p] += child[p];
+            }
+
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Product:
+        {
+            int numberOfChildren = operands[i];
+            top -= (numberOfChildren - 1) * numberOfPoints;
+
+            for(int j = 1; j < numberOfChildren; j++)
+            {
+                const T* child = top + j * numberOfPoints;
+
+                // A zero factor gives a zero product regardless of the remaining factors, as in the expression tree
+                for(int p = 0; p < numberOfPoints; p++)
+                    top[p] = (top[p] == 0 || child[p] == 0) ? T(0) : top[p] * child[p];
+            }
+
+            break;
+        }
+
+        default:
+            assert(false);
+            break;
+        }
+    }
+
+    for(int p = 0; p < numberOfPoints; p++)
+        values[p] += stack[p];
+}
+
+void ExpressionTape::calculate(const PointBlock& points, double* values) const { calculateBlock(points, values); }
+
+void ExpressionTape::calculate(const PointBlockFloat& points, float* values) const { calculateBlock(points, values); }
+
+template <typename T>
+void ExpressionTape::calculateAdjoints(
+    const VectorDouble& point, const double* direction, std::vector<T>& derivatives) const
+{
+    const size_t numberOfInstructions = opcodes.size();
+
+    derivatives.assign(variableIndexes.size(), T(0.0));
+
+    if(numberOfInstructions == 0)
+        return;
+
+    // The value and the adjoint of the result of each instruction
+    thread_local std::vector<T> values;
+    thread_local std::vector<T> adjoints;
+
+    values.resize(numberOfInstructions);
+    adjoints.assign(numberOfInstructions, T(0.0));
+
+    for(size_t i = 0; i < numberOfInstructions; i++)
+    {
+        const int* arguments = children.data() + childrenStarts[i];
+        T value = (childrenStarts[i] < childrenStarts[i + 1]) ? values[arguments[0]] : T(0.0);
+
+        switch(opcodes[i])
+        {
+        case E_NonlinearExpressionTypes::Constant:
+            values[i] = constants[operands[i]];
+            break;
+
+        case E_NonlinearExpressionTypes::Variable:
+            if constexpr(std::is_same_v<T, double>)
+                values[i] = point[operands[i]];
+            else
+                values[i] = T(point[operands[i]], direction[variablePositions[i]]);
+
+            break;
+
+        case E_NonlinearExpressionTypes::Negate:
+            values[i] = -value;
+            break;
+
+        case E_NonlinearExpressionTypes::Invert:
+            values[i] = 1.0 / value;
+            break;
+
+        case E_NonlinearExpressionTypes::SquareRoot:
+            values[i] = sqrt(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Log:
+            values[i] = log(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Exp:
+            values[i] = exp(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Square:
+            values[i] = value * value;
+            break;
+
+        case E_NonlinearExpressionTypes::Cos:
+            values[i] = cos(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Sin:
+            values[i] = sin(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Tan:
+            values[i] = tan(value);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcCos:
+            values[i] = acos(value);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcSin:
+            values[i] = asin(value);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcTan:
+            values[i] = atan(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Abs:
+            values[i] = fabs(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Divide:
+            values[i] = value / values[arguments[1]];
+            break;
+
+        case E_NonlinearExpressionTypes::Power:
+            values[i] = pow(value, values[arguments[1]]);
+            break;
+
+        case E_NonlinearExpressionTypes::Sum:
+        {
+            T sum = 0.0;
+
+            for(int j = 0; j < operands[i]; j++)
+                sum += values[arguments[j]];
+
+            values[i] = sum;
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Product:
+        {
+            T product = 1.0;
+
+            for(int j = 0; j < operands[i]; j++)
+                product *= values[arguments[j]];
+
+            values[i] = product;
+            break;
+        }
+
+        default:
+            assert(false);
+            break;
+        }
+    }
+
+    adjoints[numberOfInstructions - 1] = 1.0;
+
+    for(size_t i = numberOfInstructions; i-- > 0;)
+    {
+        T adjoint = adjoints[i];
+
+        if(Tangent::isZero(adjoint))
+            continue;
+
+        const int* arguments = children.data() + childrenStarts[i];
+        T value = (childrenStarts[i] < childrenStarts[i + 1]) ? values[arguments[0]] : T(0.0);
+
+        switch(opcodes[i])
+        {
+        case E_NonlinearExpressionTypes::Constant:
+            break;
+
+        case E_NonlinearExpressionTypes::Variable:
+            derivatives[variablePositions[i]] += adjoint;
+            break;
+
+        case E_NonlinearExpressionTypes::Negate:
+            adjoints[arguments[0]] -= adjoint;
+            break;
+
+        case E_NonlinearExpressionTypes::Invert:
+            adjoints[arguments[0]] -= adjoint * values[i] * values[i];
+            break;
+
+        case E_NonlinearExpressionTypes::SquareRoot:
+            adjoints[arguments[0]] += adjoint * 0.5 / values[i];
+            break;
+
+        case E_NonlinearExpressionTypes::Log:
+            adjoints[arguments[0]] += adjoint / value;
+            break;
+
+        case E_NonlinearExpressionTypes::Exp:
+            adjoints[arguments[0]] += adjoint * values[i];
+            break;
+
+        case E_NonlinearExpressionTypes::Square:
+            adjoints[arguments[0]] += adjoint * 2.0 * value;
+            break;
+
+        case E_NonlinearExpressionTypes::Cos:
+            adjoints[arguments[0]] -= adjoint * sin(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Sin:
+            adjoints[arguments[0]] += adjoint * cos(value);
+            break;
+
+        case E_NonlinearExpressionTypes::Tan:
+            adjoints[arguments[0]] += adjoint * (1.0 + values[i] * values[i]);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcCos:
+            adjoints[arguments[0]] -= adjoint / sqrt(1.0 - value * value);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcSin:
+            adjoints[arguments[0]] += adjoint / sqrt(1.0 - value * value);
+            break;
+
+        case E_NonlinearExpressionTypes::ArcTan:
+            adjoints[arguments[0]] += adjoint / (1.0 + value * value);
+            break;
+
+        case E_NonlinearExpressionTypes::Abs:
+            adjoints[arguments[0]]
+                += adjoint * ((Tangent::primal(value) > 0.0) ? 1.0 : ((Tangent::primal(value) < 0.0) ? -1.0 : 0.0));
+            break;
+
+        case E_NonlinearExpressionTypes::Divide:
+        {
+            T denominator = values[arguments[1]];
+
+            adjoints[arguments[0]] += adjoint / denominator;
+            adjoints[arguments[1]] -= adjoint * values[i] / denominator;
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Power:
+        {
+            T exponent = values[arguments[1]];
+
+            adjoints[arguments[0]] += adjoint * exponent * pow(value, exponent - 1.0);
+
+            // The operand tells whether the exponent is constant
+            if(operands[i] == 0 && Tangent::primal(value) > 0.0)
+                adjoints[arguments[1]] += adjoint * values[i] * log(value);
+
+            break;
+        }
+
+        case E_NonlinearExpressionTypes::Sum:
+            for(int j = 0; j < operands[i]; j++)
+                adjoints[arguments[j]] += adjoint;
+
+            break;
+
+        case E_NonlinearExpressionTypes::Product:
+        {
+            // The derivative is the product of the factors before and after, so zero factors need no special care
+            thread_local std::vector<T> productsBefore;
+            productsBefore.resize(operands[i]);
+
+            T product = 1.0;
+
+            for(int j = 0; j < operands[i]; j++)
+            {
+                productsBefore[j] = product;
+                product *= values[arguments[j]];
+            }
+
+            product = 1.0;
+
+            for(int j = operands[i] - 1; j >= 0; j--)
+            {
+                adjoints[arguments[j]] += adjoint * productsBefore[j] * product;
+                product *= values[arguments[j]];
+            }
+
+            break;
+        }
+
+        default:
+            assert(false);
+            break;
+        }
+    }
+}
+
+void ExpressionTape::calculateGradient(const VectorDouble& point, VectorDouble& derivatives) const
+{
+    calculateAdjoints(point, nullptr, derivatives);
+}
+
+void ExpressionTape::calculateHessianVectorProduct(
+    const VectorDouble& point, const VectorDouble& direction, VectorDouble& product) const
+{
+    assert(direction.size() == variableIndexes.size());
+
+    thread_local std::vector<Tangent::TangentValue> derivatives;
+    calculateAdjoints(point, direction.data(), derivatives);
+
+    product.resize(derivatives.size());
+
+    for(size_t k = 0; k < derivatives.size(); k++)
+        product[k] = derivatives[k].tangent;
+}
+
+void ExpressionTape::calculateHessian(const VectorDouble& point, VectorDouble& hessian) const
+{
+    const size_t numberOfVariables = variableIndexes.size();
+
+    hessian.assign(numberOfVariables * numberOfVariables, 0.0);
+
+    thread_local VectorDouble direction;
+    thread_local VectorDouble product;
+
+    direction.assign(numberOfVariables, 0.0);
+
+    // Column k is the product with the k:th unit vector
+    for(size_t k = 0; k < numberOfVariables; k++)
+    {
+        direction[k] = 1.0;
+        calculateHessianVectorProduct(point, direction, product);
+        direction[k] = 0.0;
+
+        for(size_t l = 0; l < numberOfVariables; l++)
+            hessian[l * numberOfVariables + k] = product[l];
+    }
+}
+} // namespace SHOT
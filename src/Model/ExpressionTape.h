@@ -0,0 +1,105 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Structs.h"
+#include "NonlinearExpressions.h"
+
+#include <memory>
+#include <vector>
+
+namespace SHOT
+{
+
+// A nonlinear expression tree compiled into a contiguous postfix instruction tape. The opcodes and operands are stored
+// in separate arrays and evaluated by a non-virtual stack interpreter. The operand is the variable index for
+// variables, the index in the constant array for constants, the number of children for sums and products and a flag
+// telling whether the exponent is constant for powers. The evaluation semantics are identical to those of
+// NonlinearExpression::calculate().
+class ExpressionTape
+{
+public:
+    ExpressionTape() = default;
+    ExpressionTape(const NonlinearExpressionPtr& expression) { compile(expression); };
+
+    // Returns false if the expression contains a node that cannot be represented on the tape
+    bool compile(const NonlinearExpressionPtr& expression);
+
+    double calculate(const VectorDouble& point) const;
+    Interval calculate(const IntervalVector& intervalVector) const;
+
+    // Adds the value of the expression in each of the points to values. Every instruction is applied to all points
+    // before moving on to the next one, so the inner loops have unit stride and can be vectorized by the compiler.
+    void calculate(const PointBlock& points, double* values) const;
+
+    // As above but in single precision, for screening evaluations where only an approximate value is needed
+    void calculate(const PointBlockFloat& points, float* values) const;
+
+    // Calculates the partial derivatives with respect to the variables in getVariableIndexes() with one forward and one
+    // reverse pass over the tape, so that the gradient does not need a CppAD recording
+    void calculateGradient(const VectorDouble& point, VectorDouble& derivatives) const;
+
+    // Calculates the product of the Hessian with a direction given for the variables in getVariableIndexes(), by
+    // differentiating the reverse pass in the direction during the same sweep (forward-over-reverse)
+    void calculateHessianVectorProduct(
+        const VectorDouble& point, const VectorDouble& direction, VectorDouble& product) const;
+
+    // Calculates the dense Hessian with respect to the variables in getVariableIndexes() in row-major order, using one
+    // Hessian-vector product per variable
+    void calculateHessian(const VectorDouble& point, VectorDouble& hessian) const;
+
+    // The indexes of the variables in the expression, sorted and without duplicates
+    inline const std::vector<int>& getVariableIndexes() const { return (variableIndexes); };
+
+    inline size_t size() const { return (opcodes.size()); };
+    inline bool isCompiled() const { return (opcodes.size() > 0); };
+
+    // The number of bytes allocated for the instructions
+    inline size_t getMemoryUsage() const
+    {
+        return (opcodes.capacity() * sizeof(E_NonlinearExpressionTypes) + constants.capacity() * sizeof(double)
+            + (operands.capacity() + childrenStarts.capacity() + children.capacity() + variableIndexes.capacity()
+                  + variablePositions.capacity())
+                * sizeof(int));
+    };
+
+    void clear();
+
+private:
+    std::vector<E_NonlinearExpressionTypes> opcodes;
+    std::vector<int> operands;
+    VectorDouble constants;
+
+    size_t maxStackSize = 0;
+
+    // The instructions giving the arguments of instruction i are children[childrenStarts[i]], ...,
+    // children[childrenStarts[i + 1] - 1], used when calculating gradients
+    std::vector<int> childrenStarts;
+    std::vector<int> children;
+
+    std::vector<int> variableIndexes;
+    std::vector<int> variablePositions; // The position in variableIndexes of each variable instruction
+
+    void initializeGradientCalculation();
+
+    // The forward and reverse passes used for both the gradients and Hessian-vector products, where T is double or a
+    // value with a directional derivative. The direction is only used in the latter case.
+    template <typename T>
+    void calculateAdjoints(const VectorDouble& point, const double* direction, std::vector<T>& derivatives) const;
+
+    template <typename T> void calculateBlock(const BasicPointBlock<T>& points, T* values) const;
+
+    bool append(const NonlinearExpressionPtr& expression, size_t& stackSize);
+    void appendInstruction(E_NonlinearExpressionTypes opcode, int operand, int stackChange, size_t& stackSize);
+};
+
+using ExpressionTapePtr = std::shared_ptr<ExpressionTape>;
+} // namespace SHOT
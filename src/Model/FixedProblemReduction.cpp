@@ -0,0 +1,641 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "FixedProblemReduction.h"
+
+#include "../Output.h"
+#include "../Settings.h"
+
+#include "Simplifications.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+namespace SHOT
+{
+
+FixedProblemReduction::FixedProblemReduction(EnvironmentPtr envPtr, ProblemPtr sourceProblem)
+    : env(envPtr), sourceProblem(sourceProblem)
+{
+}
+
+bool FixedProblemReduction::createReducedProblem(
+    const VectorInteger& fixedVariableIndexes, const VectorDouble& fixedVariableValues, const VectorDouble& point)
+{
+    reducedProblem.reset();
+    numberOfRemovedVariables = 0;
+    numberOfRemovedConstraints = 0;
+
+    size_t numberOfVariables = sourceProblem->allVariables.size();
+
+    sourceValues.assign(numberOfVariables, NAN);
+    lowerBounds.resize(numberOfVariables);
+    upperBounds.resize(numberOfVariables);
+
+    for(auto& V : sourceProblem->allVariables)
+    {
+        lowerBounds[V->index] = V->lowerBound;
+        upperBounds[V->index] = V->upperBound;
+    }
+
+    for(auto& [index, bounds] : variableBounds)
+    {
+        lowerBounds[index] = bounds.first;
+        upperBounds[index] = bounds.second;
+    }
+
+    // Variables that are fixed by their bounds are also substituted
+    for(size_t i = 0; i < numberOfVariables; i++)
+    {
+        if(lowerBounds[i] == upperBounds[i])
+            sourceValues[i] = lowerBounds[i];
+    }
+
+    for(size_t k = 0; k < fixedVariableIndexes.size(); k++)
+    {
+        int index = fixedVariableIndexes[k];
+
+        sourceValues[index] = fixedVariableValues[k];
+        lowerBounds[index] = fixedVariableValues[k];
+        upperBounds[index] = fixedVariableValues[k];
+    }
+
+    substitutedValues.clear();
+
+    for(auto& V : sourceProblem->allVariables)
+    {
+        if(isFixed(V->index))
+            substitutedValues.emplace(V.get(), sourceValues[V->index]);
+    }
+
+    std::vector<ReducedFunction> constraints;
+
+    for(auto& C : sourceProblem->numericConstraints)
+    {
+        auto constraint = substituteFixedValues(C);
+        bool isRemoved = false;
+
+        if(!reduceConstraint(constraint, isRemoved))
+        {
+            env->output->outputDebug(
+                fmt::format("         Fixed values are infeasible in constraint {}, no reduced problem created.",
+                    constraint.name));
+            return (false);
+        }
+
+        if(isRemoved)
+            numberOfRemovedConstraints++;
+        else
+            constraints.push_back(std::move(constraint));
+    }
+
+    auto objective = substituteFixedValues(sourceProblem->objectiveFunction);
+
+    removeSeparableVariables(constraints, objective, point);
+    createProblem(constraints, objective);
+
+    env->output->outputDebug(fmt::format("         Reduced problem has {} of {} variables and {} of {} constraints.",
+        reducedProblem->properties.numberOfVariables, numberOfVariables,
+        reducedProblem->properties.numberOfNumericConstraints, sourceProblem->numericConstraints.size()));
+
+    return (true);
+}
+
+VectorDouble FixedProblemReduction::getSourcePoint(const VectorDouble& reducedPoint) const
+{
+    VectorDouble sourcePoint(sourceValues);
+
+    for(size_t i = 0; i < sourceIndexes.size() && i < reducedPoint.size(); i++)
+        sourcePoint[sourceIndexes[i]] = reducedPoint[i];
+
+    return (sourcePoint);
+}
+
+VectorDouble FixedProblemReduction::getReducedPoint(const VectorDouble& sourcePoint) const
+{
+    VectorDouble reducedPoint(sourceIndexes.size());
+
+    for(size_t i = 0; i < sourceIndexes.size(); i++)
+        reducedPoint[i] = sourcePoint.at(sourceIndexes[i]);
+
+    return (reducedPoint);
+}
+
+FixedProblemReduction::ReducedFunction FixedProblemReduction::substituteFixedValues(
+    const NumericConstraintPtr& constraint)
+{
+    ReducedFunction function;
+
+    function.name = constraint->name;
+    function.valueLHS = constraint->valueLHS;
+    function.valueRHS = constraint->valueRHS;
+    function.constant = constraint->constant;
+
+    if(auto linearConstraint = std::dynamic_pointer_cast<LinearConstraint>(constraint))
+        substituteFixedValues(linearConstraint->linearTerms, function);
+
+    if(auto quadraticConstraint = std::dynamic_pointer_cast<QuadraticConstraint>(constraint))
+        substituteFixedValues(quadraticConstraint->quadraticTerms, function);
+
+    if(auto nonlinearConstraint = std::dynamic_pointer_cast<NonlinearConstraint>(constraint))
+    {
+        substituteFixedValues(nonlinearConstraint->monomialTerms, function);
+        substituteFixedValues(nonlinearConstraint->signomialTerms, function);
+
+        if(nonlinearConstraint->nonlinearExpression)
+            substituteFixedValues(nonlinearConstraint->nonlinearExpression, function);
+    }
+
+    updateVariables(function);
+
+    return (function);
+}
+
+FixedProblemReduction::ReducedFunction FixedProblemReduction::substituteFixedValues(
+    const ObjectiveFunctionPtr& objective)
+{
+    ReducedFunction function;
+
+    function.name = "objective";
+    function.constant = objective->constant;
+
+    if(auto linearObjective = std::dynamic_pointer_cast<LinearObjectiveFunction>(objective))
+        substituteFixedValues(linearObjective->linearTerms, function);
+
+    if(auto quadraticObjective = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(objective))
+        substituteFixedValues(quadraticObjective->quadraticTerms, function);
+
+    if(auto nonlinearObjective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objective))
+    {
+        substituteFixedValues(nonlinearObjective->monomialTerms, function);
+        substituteFixedValues(nonlinearObjective->signomialTerms, function);
+
+        if(nonlinearObjective->nonlinearExpression)
+            substituteFixedValues(nonlinearObjective->nonlinearExpression, function);
+    }
+
+    updateVariables(function);
+
+    return (function);
+}
+
+void FixedProblemReduction::substituteFixedValues(const LinearTerms& terms, ReducedFunction& function)
+{
+    for(auto& T : terms)
+    {
+        int index = T->variable->index;
+
+        if(isFixed(index))
+            function.constant += T->coefficient * sourceValues[index];
+        else
+            function.linearTerms[index] += T->coefficient;
+    }
+}
+
+void FixedProblemReduction::substituteFixedValues(const QuadraticTerms& terms, ReducedFunction& function)
+{
+    for(auto& T : terms)
+    {
+        int firstIndex = T->firstVariable->index;
+        int secondIndex = T->secondVariable->index;
+
+        if(isFixed(firstIndex) && isFixed(secondIndex))
+            function.constant += T->coefficient * sourceValues[firstIndex] * sourceValues[secondIndex];
+        else if(isFixed(firstIndex))
+            function.linearTerms[secondIndex] += T->coefficient * sourceValues[firstIndex];
+        else if(isFixed(secondIndex))
+            function.linearTerms[firstIndex] += T->coefficient * sourceValues[secondIndex];
+        else
+            function.quadraticTerms[std::minmax(firstIndex, secondIndex)] += T->coefficient;
+    }
+}
+
+void FixedProblemReduction::substituteFixedValues(const MonomialTerms& terms, ReducedFunction& function)
+{
+    for(auto& T : terms)
+    {
+        double coefficient = T->coefficient;
+        VectorInteger variables;
+
+        for(auto& V : T->variables)
+        {
+            if(isFixed(V->index))
+                coefficient *= sourceValues[V->index];
+            else
+                variables.push_back(V->index);
+        }
+
+        if(variables.size() == 0)
+            function.constant += coefficient;
+        else if(variables.size() == 1)
+            function.linearTerms[variables[0]] += coefficient;
+        else if(variables.size() == 2)
+            function.quadraticTerms[std::minmax(variables[0], variables[1])] += coefficient;
+        else
+            function.monomialTerms.emplace_back(coefficient, variables);
+    }
+}
+
+void FixedProblemReduction::substituteFixedValues(const SignomialTerms& terms, ReducedFunction& function)
+{
+    for(auto& T : terms)
+    {
+        double coefficient = T->coefficient;
+        std::vector<std::pair<int, double>> elements;
+
+        for(auto& E : T->elements)
+        {
+            if(isFixed(E->variable->index))
+                coefficient *= std::pow(sourceValues[E->variable->index], E->power);
+            else
+                elements.emplace_back(E->variable->index, E->power);
+        }
+
+        if(elements.size() == 0)
+            function.constant += coefficient;
+        else if(elements.size() == 1 && elements[0].second == 1.0)
+            function.linearTerms[elements[0].first] += coefficient;
+        else
+            function.signomialTerms.emplace_back(coefficient, elements);
+    }
+}
+
+void FixedProblemReduction::substituteFixedValues(const NonlinearExpressionPtr& expression, ReducedFunction& function)
+{
+    // The copy still refers to the variables in the source problem, which are replaced when creating the problem
+    auto reducedExpression = copyNonlinearExpression(expression.get());
+    substituteVariableValues(reducedExpression, substitutedValues);
+    reducedExpression = simplifyToFixedPoint(reducedExpression);
+
+    Variables variables;
+    reducedExpression->appendNonlinearVariables(variables);
+
+    if(variables.size() == 0)
+        function.constant += reducedExpression->calculate(VectorDouble());
+    else
+        function.nonlinearExpression = reducedExpression;
+}
+
+void FixedProblemReduction::updateVariables(ReducedFunction& function)
+{
+    function.variables.clear();
+
+    for(auto T = function.linearTerms.begin(); T != function.linearTerms.end();)
+    {
+        if(T->second == 0.0)
+        {
+            T = function.linearTerms.erase(T);
+            continue;
+        }
+
+        function.variables.push_back(T->first);
+        ++T;
+    }
+
+    for(auto T = function.quadraticTerms.begin(); T != function.quadraticTerms.end();)
+    {
+        if(T->second == 0.0)
+        {
+            T = function.quadraticTerms.erase(T);
+            continue;
+        }
+
+        function.variables.insert(function.variables.end(), { T->first.first, T->first.second });
+        ++T;
+    }
+
+    for(auto& [coefficient, variables] : function.monomialTerms)
+        function.variables.insert(function.variables.end(), variables.begin(), variables.end());
+
+    for(auto& [coefficient, elements] : function.signomialTerms)
+    {
+        for(auto& E : elements)
+            function.variables.push_back(E.first);
+    }
+
+    if(function.nonlinearExpression)
+    {
+        Variables variables;
+        function.nonlinearExpression->appendNonlinearVariables(variables);
+
+        for(auto& V : variables)
+            function.variables.push_back(V->index);
+    }
+
+    std::sort(function.variables.begin(), function.variables.end());
+    function.variables.erase(
+        std::unique(function.variables.begin(), function.variables.end()), function.variables.end());
+}
+
+bool FixedProblemReduction::reduceConstraint(const ReducedFunction& constraint, bool& isRemoved)
+{
+    double tolerance = constraint.isLinear()
+        ? env->settings->getSetting<double>("Tolerance.LinearConstraint", "Primal")
+        : env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal");
+
+    if(constraint.variables.size() == 0)
+    {
+        isRemoved = true;
+
+        return (constraint.constant >= constraint.valueLHS - tolerance
+            && constraint.constant <= constraint.valueRHS + tolerance);
+    }
+
+    if(!constraint.isLinear() || constraint.linearTerms.size() != 1)
+        return (true);
+
+    // A linear constraint with one variable is a bound
+    auto [index, coefficient] = *constraint.linearTerms.begin();
+
+    double boundFromLHS = (constraint.valueLHS > SHOT_DBL_MIN)
+        ? (constraint.valueLHS - constraint.constant) / coefficient
+        : (coefficient > 0 ? SHOT_DBL_MIN : SHOT_DBL_MAX);
+
+    double boundFromRHS = (constraint.valueRHS < SHOT_DBL_MAX)
+        ? (constraint.valueRHS - constraint.constant) / coefficient
+        : (coefficient > 0 ? SHOT_DBL_MAX : SHOT_DBL_MIN);
+
+    lowerBounds[index] = std::max(lowerBounds[index], std::min(boundFromLHS, boundFromRHS));
+    upperBounds[index] = std::min(upperBounds[index], std::max(boundFromLHS, boundFromRHS));
+
+    if(lowerBounds[index] > upperBounds[index] + tolerance)
+        return (false);
+
+    if(lowerBounds[index] > upperBounds[index])
+        upperBounds[index] = lowerBounds[index];
+
+    isRemoved = true;
+    return (true);
+}
+
+void FixedProblemReduction::removeSeparableVariables(
+    std::vector<ReducedFunction>& constraints, const ReducedFunction& objective, const VectorDouble& point)
+{
+    size_t numberOfVariables = sourceProblem->allVariables.size();
+    double tolerance = env->settings->getSetting<double>("Tolerance.LinearConstraint", "Primal");
+
+    // The blocks are the connected components of the variables, where the variables in a constraint are connected
+    VectorInteger parents(numberOfVariables);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto findBlock = [&](int index) {
+        while(parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+
+        return (index);
+    };
+
+    std::vector<bool> isInConstraint(numberOfVariables, false);
+
+    for(auto& C : constraints)
+    {
+        int block = findBlock(C.variables[0]);
+
+        for(auto I : C.variables)
+        {
+            isInConstraint[I] = true;
+            parents[findBlock(I)] = block;
+        }
+    }
+
+    std::vector<bool> isInObjective(numberOfVariables, false);
+
+    for(auto I : objective.variables)
+        isInObjective[I] = true;
+
+    // The variables in other than linear terms in the objective function
+    auto nonlinearObjective = objective;
+    nonlinearObjective.linearTerms.clear();
+    updateVariables(nonlinearObjective);
+
+    auto getPointValue = [&](int index) {
+        double value = (index < (int)point.size()) ? point[index] : 0.0;
+        return (std::min(std::max(value, lowerBounds[index]), upperBounds[index]));
+    };
+
+    // Only the linear blocks that are feasible in the point and not in the objective function can be removed
+    std::vector<bool> isRemovableBlock(numberOfVariables, true);
+
+    for(size_t i = 0; i < numberOfVariables; i++)
+    {
+        if(isFixed(i) || !isInConstraint[i])
+            continue;
+
+        double value = (i < point.size()) ? point[i] : 0.0;
+
+        if(isInObjective[i] || value < lowerBounds[i] - tolerance || value > upperBounds[i] + tolerance)
+            isRemovableBlock[findBlock(i)] = false;
+    }
+
+    for(auto& C : constraints)
+    {
+        int block = findBlock(C.variables[0]);
+
+        if(!isRemovableBlock[block])
+            continue;
+
+        if(!C.isLinear())
+        {
+            isRemovableBlock[block] = false;
+            continue;
+        }
+
+        double value = C.constant;
+
+        for(auto& [index, coefficient] : C.linearTerms)
+            value += coefficient * getPointValue(index);
+
+        if(value < C.valueLHS - tolerance || value > C.valueRHS + tolerance)
+            isRemovableBlock[block] = false;
+    }
+
+    bool isMinimize = (sourceProblem->objectiveFunction->direction == E_ObjectiveFunctionDirection::Minimize);
+
+    for(size_t i = 0; i < numberOfVariables; i++)
+    {
+        if(isFixed(i))
+            continue;
+
+        if(isInConstraint[i])
+        {
+            if(isRemovableBlock[findBlock(i)])
+                sourceValues[i] = getPointValue(i);
+
+            continue;
+        }
+
+        if(!isInObjective[i])
+        {
+            sourceValues[i] = getPointValue(i);
+            continue;
+        }
+
+        if(std::binary_search(nonlinearObjective.variables.begin(), nonlinearObjective.variables.end(), (int)i))
+            continue;
+
+        // A variable only in a linear term in the objective function is at one of its bounds, if it is finite
+        double coefficient = isMinimize ? objective.linearTerms.at(i) : -objective.linearTerms.at(i);
+        double bound = (coefficient > 0) ? lowerBounds[i] : upperBounds[i];
+
+        if(bound > SHOT_DBL_MIN && bound < SHOT_DBL_MAX)
+            sourceValues[i] = bound;
+    }
+
+    auto numberOfConstraints = constraints.size();
+
+    constraints.erase(std::remove_if(constraints.begin(), constraints.end(),
+                          [&](const ReducedFunction& C) { return (isRemovableBlock[findBlock(C.variables[0])]); }),
+        constraints.end());
+
+    numberOfRemovedConstraints += numberOfConstraints - constraints.size();
+}
+
+void FixedProblemReduction::createProblem(
+    const std::vector<ReducedFunction>& constraints, const ReducedFunction& objective)
+{
+    reducedProblem = std::make_shared<Problem>(env);
+    reducedProblem->name = sourceProblem->name;
+
+    reducedIndexes.assign(sourceProblem->allVariables.size(), -1);
+    sourceIndexes.clear();
+    reducedVariables.clear();
+
+    Variables variables;
+
+    for(auto& V : sourceProblem->allVariables)
+    {
+        if(isFixed(V->index))
+            continue;
+
+        auto variable = std::make_shared<Variable>(V->name, (int)variables.size(), V->properties.type,
+            lowerBounds[V->index], upperBounds[V->index], V->semiBound);
+
+        reducedIndexes[V->index] = variable->index;
+        sourceIndexes.push_back(V->index);
+        reducedVariables.emplace(V.get(), variable);
+        variables.push_back(variable);
+    }
+
+    reducedProblem->add(std::move(variables));
+
+    numberOfRemovedVariables = sourceProblem->allVariables.size() - sourceIndexes.size();
+
+    auto direction = sourceProblem->objectiveFunction->direction;
+
+    if(objective.nonlinearExpression || objective.monomialTerms.size() > 0 || objective.signomialTerms.size() > 0)
+    {
+        auto reducedObjective = std::make_shared<NonlinearObjectiveFunction>(direction);
+        reducedObjective->constant = objective.constant + addTerms(objective, reducedObjective);
+        reducedProblem->add(std::move(reducedObjective));
+    }
+    else if(objective.quadraticTerms.size() > 0)
+    {
+        auto reducedObjective = std::make_shared<QuadraticObjectiveFunction>(direction);
+        reducedObjective->constant = objective.constant + addTerms(objective, reducedObjective);
+        reducedProblem->add(std::move(reducedObjective));
+    }
+    else
+    {
+        auto reducedObjective = std::make_shared<LinearObjectiveFunction>(direction);
+        reducedObjective->constant = objective.constant + addTerms(objective, reducedObjective);
+        reducedProblem->add(std::move(reducedObjective));
+    }
+
+    for(auto& C : constraints)
+    {
+        int index = reducedProblem->numericConstraints.size();
+
+        if(C.nonlinearExpression || C.monomialTerms.size() > 0 || C.signomialTerms.size() > 0)
+        {
+            auto constraint = std::make_shared<NonlinearConstraint>(index, C.name, C.valueLHS, C.valueRHS);
+            constraint->constant = C.constant + addTerms(C, constraint);
+            reducedProblem->add(std::move(constraint));
+        }
+        else if(C.quadraticTerms.size() > 0)
+        {
+            auto constraint = std::make_shared<QuadraticConstraint>(index, C.name, C.valueLHS, C.valueRHS);
+            constraint->constant = C.constant + addTerms(C, constraint);
+            reducedProblem->add(std::move(constraint));
+        }
+        else
+        {
+            auto constraint = std::make_shared<LinearConstraint>(index, C.name, C.valueLHS, C.valueRHS);
+            constraint->constant = C.constant + addTerms(C, constraint);
+            reducedProblem->add(std::move(constraint));
+        }
+    }
+
+    // This also updates the properties
+    reducedProblem->finalize();
+}
+
+template <typename T>
+double FixedProblemReduction::addTerms(const ReducedFunction& function, const std::shared_ptr<T>& target)
+{
+    double removedValue = 0.0;
+
+    auto getVariable = [&](int index) { return (reducedProblem->getVariable(reducedIndexes[index])); };
+
+    // Only linear terms can have variables removed after the substitution, when their values are given by the point
+    for(auto& [index, coefficient] : function.linearTerms)
+    {
+        if(reducedIndexes[index] < 0)
+            removedValue += coefficient * sourceValues[index];
+        else
+            target->add(std::make_shared<LinearTerm>(coefficient, getVariable(index)));
+    }
+
+    if constexpr(std::is_base_of_v<QuadraticConstraint, T> || std::is_base_of_v<QuadraticObjectiveFunction, T>)
+    {
+        for(auto& [indexes, coefficient] : function.quadraticTerms)
+        {
+            target->add(
+                std::make_shared<QuadraticTerm>(coefficient, getVariable(indexes.first), getVariable(indexes.second)));
+        }
+    }
+
+    if constexpr(std::is_base_of_v<NonlinearConstraint, T> || std::is_base_of_v<NonlinearObjectiveFunction, T>)
+    {
+        for(auto& [coefficient, indexes] : function.monomialTerms)
+        {
+            Variables variables;
+
+            for(auto I : indexes)
+                variables.push_back(getVariable(I));
+
+            target->add(std::make_shared<MonomialTerm>(coefficient, variables));
+        }
+
+        for(auto& [coefficient, elements] : function.signomialTerms)
+        {
+            SignomialElements signomialElements;
+
+            for(auto& [index, power] : elements)
+                signomialElements.push_back(std::make_shared<SignomialElement>(getVariable(index), power));
+
+            target->add(std::make_shared<SignomialTerm>(coefficient, signomialElements));
+        }
+
+        if(function.nonlinearExpression)
+        {
+            substituteVariables(function.nonlinearExpression, reducedVariables);
+            target->add(function.nonlinearExpression);
+        }
+    }
+
+    return (removedValue);
+}
+} // namespace SHOT
@@ -0,0 +1,124 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Environment.h"
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include "Problem.h"
+
+#include <cmath>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// Creates a reduced problem from a finalized problem where some of the variables, e.g. the discrete ones in a fixed NLP
+// problem, are fixed. The fixed values are substituted into the terms and nonlinear expressions, the constraints that
+// become constant are removed after checking them, and the linear constraints with one remaining variable are turned
+// into bounds. The blocks of variables that are only connected to each other by linear constraints and are not in the
+// objective function are also removed if they are feasible in the given point, and get their values from it. The
+// variables are renumbered in the reduced problem, and its solution can be mapped back to the source problem.
+class FixedProblemReduction
+{
+public:
+    FixedProblemReduction(EnvironmentPtr envPtr, ProblemPtr sourceProblem);
+
+    // Returns false if the fixed values are infeasible in a removed constraint, then no reduced problem is created
+    bool createReducedProblem(
+        const VectorInteger& fixedVariableIndexes, const VectorDouble& fixedVariableValues, const VectorDouble& point);
+
+    ProblemPtr getReducedProblem() { return (reducedProblem); };
+
+    // Used instead of the bounds of these variables in the source problem, e.g. if they have been tightened since
+    std::map<int, PairDouble> variableBounds;
+
+    // The points are mapped between the variable spaces of the source and reduced problems
+    VectorDouble getSourcePoint(const VectorDouble& reducedPoint) const;
+    VectorDouble getReducedPoint(const VectorDouble& sourcePoint) const;
+
+    int numberOfRemovedVariables = 0;
+    int numberOfRemovedConstraints = 0;
+
+private:
+    // A constraint or objective function with the fixed values substituted, the variables are the source indexes
+    struct ReducedFunction
+    {
+        std::string name;
+        double valueLHS = SHOT_DBL_MIN;
+        double valueRHS = SHOT_DBL_MAX;
+        double constant = 0.0;
+
+        std::map<int, double> linearTerms;
+        std::map<std::pair<int, int>, double> quadraticTerms;
+        std::vector<std::pair<double, VectorInteger>> monomialTerms;
+        std::vector<std::pair<double, std::vector<std::pair<int, double>>>> signomialTerms;
+        NonlinearExpressionPtr nonlinearExpression;
+
+        // The variables in all terms, sorted and without duplicates
+        VectorInteger variables;
+
+        bool isLinear() const
+        {
+            return (quadraticTerms.empty() && monomialTerms.empty() && signomialTerms.empty() && !nonlinearExpression);
+        }
+    };
+
+    EnvironmentPtr env;
+    ProblemPtr sourceProblem;
+    ProblemPtr reducedProblem;
+
+    // The values of the fixed and removed variables in the source problem, NAN for the other variables
+    VectorDouble sourceValues;
+
+    // The index in the reduced problem of each variable in the source problem, -1 if removed
+    VectorInteger reducedIndexes;
+    VectorInteger sourceIndexes;
+
+    VectorDouble lowerBounds;
+    VectorDouble upperBounds;
+
+    std::unordered_map<const Variable*, double> substitutedValues;
+    std::unordered_map<const Variable*, VariablePtr> reducedVariables;
+
+    bool isFixed(int index) const { return (!std::isnan(sourceValues[index])); };
+
+    ReducedFunction substituteFixedValues(const NumericConstraintPtr& constraint);
+    ReducedFunction substituteFixedValues(const ObjectiveFunctionPtr& objective);
+
+    void substituteFixedValues(const LinearTerms& terms, ReducedFunction& function);
+    void substituteFixedValues(const QuadraticTerms& terms, ReducedFunction& function);
+    void substituteFixedValues(const MonomialTerms& terms, ReducedFunction& function);
+    void substituteFixedValues(const SignomialTerms& terms, ReducedFunction& function);
+    void substituteFixedValues(const NonlinearExpressionPtr& expression, ReducedFunction& function);
+
+    // Removes the terms with zero coefficients and updates the list of variables
+    void updateVariables(ReducedFunction& function);
+
+    // Returns false if the constraint is infeasible, isRemoved is set if it is constant or turned into a bound
+    bool reduceConstraint(const ReducedFunction& constraint, bool& isRemoved);
+
+    // Removes the linear blocks and the variables not in any constraint
+    void removeSeparableVariables(std::vector<ReducedFunction>& constraints, const ReducedFunction& objective,
+        const VectorDouble& point);
+
+    void createProblem(const std::vector<ReducedFunction>& constraints, const ReducedFunction& objective);
+
+    // Adds the terms to a constraint or objective function in the reduced problem, the returned value of the linear
+    // terms in the removed variables should be added to the constant
+    template <typename T> double addTerms(const ReducedFunction& function, const std::shared_ptr<T>& target);
+};
+} // namespace SHOT
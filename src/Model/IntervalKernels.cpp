@@ -0,0 +1,183 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "IntervalKernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace SHOT::IntervalKernels
+{
+
+// A bound on the relative rounding error of one operation, with some margin
+constexpr double roundingError = 2.0 * std::numeric_limits<double>::epsilon();
+
+// Covers the rounding error of results that underflow
+constexpr double absoluteRoundingError = std::numeric_limits<double>::min();
+
+// Widens the bounds of a result that has been rounded in numberOfOperations operations on values whose absolute values
+// sum to at most absoluteSum. Infinite results are kept as they are.
+static inline double roundDown(double value, double absoluteSum, double numberOfOperations)
+{
+    double error = numberOfOperations * roundingError * absoluteSum + absoluteRoundingError;
+    return (std::isfinite(value) ? value - error : value);
+}
+
+static inline double roundUp(double value, double absoluteSum, double numberOfOperations)
+{
+    double error = numberOfOperations * roundingError * absoluteSum + absoluteRoundingError;
+    return (std::isfinite(value) ? value + error : value);
+}
+
+void calculateLinearTermBounds(const double* coefficients, const double* lowerBounds, const double* upperBounds,
+    size_t size, IntervalArray& bounds)
+{
+    bounds.resize(size);
+
+    double* lower = bounds.lower.data();
+    double* upper = bounds.upper.data();
+
+    for(size_t i = 0; i < size; i++)
+    {
+        double first = coefficients[i] * lowerBounds[i];
+        double second = coefficients[i] * upperBounds[i];
+
+        lower[i] = std::min(first, second);
+        upper[i] = std::max(first, second);
+    }
+
+    for(size_t i = 0; i < size; i++)
+    {
+        lower[i] = roundDown(lower[i], std::abs(lower[i]), 1.0);
+        upper[i] = roundUp(upper[i], std::abs(upper[i]), 1.0);
+    }
+}
+
+void calculateQuadraticTermBounds(const double* coefficients, const double* firstLowerBounds,
+    const double* firstUpperBounds, const double* secondLowerBounds, const double* secondUpperBounds,
+    const std::vector<char>& isSquare, IntervalArray& bounds)
+{
+    size_t size = isSquare.size();
+    bounds.resize(size);
+
+    double* lower = bounds.lower.data();
+    double* upper = bounds.upper.data();
+
+    for(size_t i = 0; i < size; i++)
+    {
+        double lowerLower = firstLowerBounds[i] * secondLowerBounds[i];
+        double lowerUpper = firstLowerBounds[i] * secondUpperBounds[i];
+        double upperLower = firstUpperBounds[i] * secondLowerBounds[i];
+        double upperUpper = firstUpperBounds[i] * secondUpperBounds[i];
+
+        double productLower = std::min(std::min(lowerLower, lowerUpper), std::min(upperLower, upperUpper));
+        double productUpper = std::max(std::max(lowerLower, lowerUpper), std::max(upperLower, upperUpper));
+
+        // The square is zero at its minimum if the bounds contain zero, otherwise at the bound closest to zero
+        double closestToZero = std::max(std::max(firstLowerBounds[i], -firstUpperBounds[i]), 0.0);
+        productLower = isSquare[i] ? closestToZero * closestToZero : productLower;
+
+        double first = coefficients[i] * productLower;
+        double second = coefficients[i] * productUpper;
+
+        lower[i] = std::min(first, second);
+        upper[i] = std::max(first, second);
+    }
+
+    for(size_t i = 0; i < size; i++)
+    {
+        lower[i] = roundDown(lower[i], std::abs(lower[i]), 2.0);
+        upper[i] = roundUp(upper[i], std::abs(upper[i]), 2.0);
+    }
+}
+
+mc::Interval calculateSum(const IntervalArray& bounds)
+{
+    size_t size = bounds.size();
+
+    const double* lower = bounds.lower.data();
+    const double* upper = bounds.upper.data();
+
+    double lowerSum = 0.0;
+    double upperSum = 0.0;
+    double lowerAbsoluteSum = 0.0;
+    double upperAbsoluteSum = 0.0;
+
+    for(size_t i = 0; i < size; i++)
+    {
+        lowerSum += lower[i];
+        upperSum += upper[i];
+        lowerAbsoluteSum += std::abs(lower[i]);
+        upperAbsoluteSum += std::abs(upper[i]);
+    }
+
+    return (mc::Interval(
+        roundDown(lowerSum, lowerAbsoluteSum, size), roundUp(upperSum, upperAbsoluteSum, size)));
+}
+
+void calculateSumsOfOthers(const IntervalArray& bounds, IntervalArray& sums)
+{
+    size_t size = bounds.size();
+    sums.resize(size);
+
+    if(size == 0)
+        return;
+
+    const double* lower = bounds.lower.data();
+    const double* upper = bounds.upper.data();
+
+    // The sums of the bounds after each index, and the sums of their absolute values
+    thread_local VectorDouble lowerSuffix;
+    thread_local VectorDouble upperSuffix;
+    thread_local VectorDouble lowerAbsoluteSuffix;
+    thread_local VectorDouble upperAbsoluteSuffix;
+
+    lowerSuffix.resize(size);
+    upperSuffix.resize(size);
+    lowerAbsoluteSuffix.resize(size);
+    upperAbsoluteSuffix.resize(size);
+
+    lowerSuffix[size - 1] = 0.0;
+    upperSuffix[size - 1] = 0.0;
+    lowerAbsoluteSuffix[size - 1] = 0.0;
+    upperAbsoluteSuffix[size - 1] = 0.0;
+
+    for(size_t i = size - 1; i > 0; i--)
+    {
+        lowerSuffix[i - 1] = lowerSuffix[i] + lower[i];
+        upperSuffix[i - 1] = upperSuffix[i] + upper[i];
+        lowerAbsoluteSuffix[i - 1] = lowerAbsoluteSuffix[i] + std::abs(lower[i]);
+        upperAbsoluteSuffix[i - 1] = upperAbsoluteSuffix[i] + std::abs(upper[i]);
+    }
+
+    double lowerPrefix = 0.0;
+    double upperPrefix = 0.0;
+    double lowerAbsolutePrefix = 0.0;
+    double upperAbsolutePrefix = 0.0;
+
+    // Each sum is formed with at most size additions
+    double numberOfOperations = size;
+
+    for(size_t i = 0; i < size; i++)
+    {
+        sums.lower[i] = roundDown(
+            lowerPrefix + lowerSuffix[i], lowerAbsolutePrefix + lowerAbsoluteSuffix[i], numberOfOperations);
+        sums.upper[i] = roundUp(
+            upperPrefix + upperSuffix[i], upperAbsolutePrefix + upperAbsoluteSuffix[i], numberOfOperations);
+
+        lowerPrefix += lower[i];
+        upperPrefix += upper[i];
+        lowerAbsolutePrefix += std::abs(lower[i]);
+        upperAbsolutePrefix += std::abs(upper[i]);
+    }
+}
+
+} // namespace SHOT::IntervalKernels
@@ -0,0 +1,58 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Structs.h"
+
+#include <vector>
+
+#include "interval.hpp"
+
+// Interval arithmetic on arrays of lower and upper bounds, used when the bounds of many terms are needed at once, e.g.
+// in bound tightening. The loops do not branch on the signs of the bounds so that they can be vectorized by the
+// compiler. The floating point operations are rounded to nearest, so every result is widened outward by a bound on its
+// rounding error and always contains the exact result.
+namespace SHOT::IntervalKernels
+{
+
+struct IntervalArray
+{
+    VectorDouble lower;
+    VectorDouble upper;
+
+    inline size_t size() const { return (lower.size()); };
+
+    inline void resize(size_t size)
+    {
+        lower.resize(size);
+        upper.resize(size);
+    };
+
+    inline mc::Interval get(size_t i) const { return (mc::Interval(lower[i], upper[i])); };
+};
+
+// The bounds of coefficients[i] * [lowerBounds[i], upperBounds[i]]
+void calculateLinearTermBounds(const double* coefficients, const double* lowerBounds, const double* upperBounds,
+    size_t size, IntervalArray& bounds);
+
+// The bounds of coefficients[i] * [firstLowerBounds[i], firstUpperBounds[i]] * [secondLowerBounds[i],
+// secondUpperBounds[i]], where the terms with isSquare[i] are squares of one variable and have nonnegative products
+void calculateQuadraticTermBounds(const double* coefficients, const double* firstLowerBounds,
+    const double* firstUpperBounds, const double* secondLowerBounds, const double* secondUpperBounds,
+    const std::vector<char>& isSquare, IntervalArray& bounds);
+
+mc::Interval calculateSum(const IntervalArray& bounds);
+
+// For each i, the sum of all bounds except the one with index i. The sums are formed from prefix and suffix sums
+// instead of subtracting the bound from the total, which would lose precision and fail for infinite bounds.
+void calculateSumsOfOthers(const IntervalArray& bounds, IntervalArray& sums);
+
+} // namespace SHOT::IntervalKernels
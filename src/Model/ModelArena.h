@@ -0,0 +1,131 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace SHOT
+{
+
+// Memory blocks from which small objects are allocated by advancing a position in the current block. The memory is
+// only released when the resource is destroyed, so it is suited for objects that mostly live as long as the model.
+class ArenaResource
+{
+public:
+    ArenaResource(size_t blockSize = 65536) : blockSize(blockSize) { }
+
+    ArenaResource(const ArenaResource&) = delete;
+    ArenaResource& operator=(const ArenaResource&) = delete;
+
+    ~ArenaResource()
+    {
+        for(auto B : blocks)
+            ::operator delete(B);
+    }
+
+    void* allocate(size_t size, size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto address = align(position, alignment);
+
+        if(blocks.empty() || address + size > blockEnd)
+        {
+            // Objects larger than a block get a block of their own
+            size_t newBlockSize = std::max(blockSize, size + alignment);
+
+            blocks.push_back(::operator new(newBlockSize));
+            position = reinterpret_cast<std::uintptr_t>(blocks.back());
+            blockEnd = position + newBlockSize;
+
+            address = align(position, alignment);
+        }
+
+        position = address + size;
+        numberOfBytes += size;
+
+        return (reinterpret_cast<void*>(address));
+    }
+
+    size_t getNumberOfBytes()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return (numberOfBytes);
+    }
+
+private:
+    static std::uintptr_t align(std::uintptr_t address, size_t alignment)
+    {
+        return ((address + alignment - 1) & ~(std::uintptr_t)(alignment - 1));
+    }
+
+    size_t blockSize;
+    size_t numberOfBytes = 0;
+
+    std::mutex mutex;
+    std::vector<void*> blocks;
+    std::uintptr_t position = 0;
+    std::uintptr_t blockEnd = 0;
+};
+
+// Allocates from an arena resource, which is kept alive as long as an allocator copy, e.g. the one stored in the
+// control block of a shared pointer, refers to it. Deallocation does nothing.
+template <typename T> class ArenaAllocator
+{
+public:
+    using value_type = T;
+
+    ArenaAllocator(std::shared_ptr<ArenaResource> resource) : resource(std::move(resource)) { }
+
+    template <typename U> ArenaAllocator(const ArenaAllocator<U>& other) : resource(other.resource) { }
+
+    T* allocate(size_t number) { return (static_cast<T*>(resource->allocate(number * sizeof(T), alignof(T)))); }
+
+    void deallocate([[maybe_unused]] T* pointer, [[maybe_unused]] size_t number) { }
+
+    template <typename U> bool operator==(const ArenaAllocator<U>& other) const
+    {
+        return (resource == other.resource);
+    }
+
+    template <typename U> bool operator!=(const ArenaAllocator<U>& other) const
+    {
+        return (resource != other.resource);
+    }
+
+    std::shared_ptr<ArenaResource> resource;
+};
+
+// Creates the variables, terms and nonlinear expression nodes of a problem, so that the many small objects are
+// allocated together instead of separately on the heap. The objects are ordinary shared pointers, and since their
+// control blocks refer to the arena they can safely outlive the problem.
+class ModelArena
+{
+public:
+    ModelArena() : resource(std::make_shared<ArenaResource>()) { }
+
+    template <typename T, typename... Args> inline std::shared_ptr<T> create(Args&&... args)
+    {
+        return (std::allocate_shared<T>(ArenaAllocator<T>(resource), std::forward<Args>(args)...));
+    }
+
+    inline size_t getNumberOfBytes() { return (resource->getNumberOfBytes()); }
+
+private:
+    std::shared_ptr<ArenaResource> resource;
+};
+} // namespace SHOT
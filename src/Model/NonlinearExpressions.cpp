@@ -229,4 +229,194 @@ bool checkPerspectiveConvexity(std::shared_ptr<ExpressionProduct> expression, do
 
     return (false);
 }
+
+std::optional<UnivariateFunction> getUnivariateFunction(const NonlinearExpressionPtr& expression)
+{
+    std::optional<UnivariateFunction> result;
+
+    NonlinearExpressionPtr argument;
+    UnivariateFunction function;
+
+    switch(expression->getType())
+    {
+    case E_NonlinearExpressionTypes::Exp:
+        function.type = E_UnivariateFunctionType::Exp;
+        argument = std::dynamic_pointer_cast<ExpressionUnary>(expression)->child;
+        break;
+
+    case E_NonlinearExpressionTypes::Log:
+        function.type = E_UnivariateFunctionType::Log;
+        argument = std::dynamic_pointer_cast<ExpressionUnary>(expression)->child;
+        break;
+
+    case E_NonlinearExpressionTypes::Square:
+        function.type = E_UnivariateFunctionType::Power;
+        function.parameter = 2.0;
+        argument = std::dynamic_pointer_cast<ExpressionUnary>(expression)->child;
+        break;
+
+    case E_NonlinearExpressionTypes::SquareRoot:
+        function.type = E_UnivariateFunctionType::Power;
+        function.parameter = 0.5;
+        argument = std::dynamic_pointer_cast<ExpressionUnary>(expression)->child;
+        break;
+
+    case E_NonlinearExpressionTypes::Power:
+    {
+        auto power = std::dynamic_pointer_cast<ExpressionPower>(expression);
+
+        if(power->secondChild->getType() != E_NonlinearExpressionTypes::Constant)
+            return (result);
+
+        function.type = E_UnivariateFunctionType::Power;
+        function.parameter = std::dynamic_pointer_cast<ExpressionConstant>(power->secondChild)->constant;
+        argument = power->firstChild;
+        break;
+    }
+
+    case E_NonlinearExpressionTypes::Sin:
+        function.type = E_UnivariateFunctionType::Sin;
+        argument = std::dynamic_pointer_cast<ExpressionUnary>(expression)->child;
+        break;
+
+    case E_NonlinearExpressionTypes::Cos:
+        function.type = E_UnivariateFunctionType::Cos;
+        argument = std::dynamic_pointer_cast<ExpressionUnary>(expression)->child;
+        break;
+
+    case E_NonlinearExpressionTypes::Tan:
+        function.type = E_UnivariateFunctionType::Tan;
+        argument = std::dynamic_pointer_cast<ExpressionUnary>(expression)->child;
+        break;
+
+    default:
+        return (result);
+    }
+
+    if(argument->getType() != E_NonlinearExpressionTypes::Variable)
+        return (result);
+
+    auto variable = std::dynamic_pointer_cast<ExpressionVariable>(argument)->variable;
+    function.variableIndex = variable->index;
+
+    bool isDefined = true;
+
+    if(function.type == E_UnivariateFunctionType::Log)
+    {
+        isDefined = (variable->lowerBound > 0.0);
+    }
+    else if(function.type == E_UnivariateFunctionType::Power)
+    {
+        if(function.parameter < 0.0)
+            isDefined = (variable->lowerBound > 0.0);
+        else if(function.parameter != std::floor(function.parameter))
+            isDefined = (variable->lowerBound >= 0.0);
+    }
+    else if(function.type == E_UnivariateFunctionType::Tan)
+    {
+        isDefined = (variable->lowerBound > -M_PI / 2.0 && variable->upperBound < M_PI / 2.0);
+    }
+
+    if(isDefined)
+        result = function;
+
+    return (result);
+}
+
+NonlinearExpressionPtr CommonSubexpressionTable::share(const NonlinearExpressionPtr& expression)
+{
+    if(auto V = visited.find(expression.get()); V != visited.end())
+        return (V->second.second);
+
+    // The children are shared first, so that two expressions are equal if they are of the same type and have the same
+    // child instances
+    auto combineHash
+        = [](size_t hash, size_t value) { return (hash ^ (value + 0x9e3779b9 + (hash << 6) + (hash >> 2))); };
+
+    size_t hash = std::hash<int>()(static_cast<int>(expression->getType()));
+
+    if(auto constant = std::dynamic_pointer_cast<ExpressionConstant>(expression))
+    {
+        hash = combineHash(hash, std::hash<double>()(constant->constant));
+    }
+    else if(auto variable = std::dynamic_pointer_cast<ExpressionVariable>(expression))
+    {
+        hash = combineHash(hash, std::hash<Variable*>()(variable->variable.get()));
+    }
+    else if(auto unary = std::dynamic_pointer_cast<ExpressionUnary>(expression))
+    {
+        unary->child = share(unary->child);
+        hash = combineHash(hash, std::hash<NonlinearExpression*>()(unary->child.get()));
+    }
+    else if(auto binary = std::dynamic_pointer_cast<ExpressionBinary>(expression))
+    {
+        binary->firstChild = share(binary->firstChild);
+        binary->secondChild = share(binary->secondChild);
+        hash = combineHash(hash, std::hash<NonlinearExpression*>()(binary->firstChild.get()));
+        hash = combineHash(hash, std::hash<NonlinearExpression*>()(binary->secondChild.get()));
+    }
+    else if(auto general = std::dynamic_pointer_cast<ExpressionGeneral>(expression))
+    {
+        for(auto& C : general->children)
+        {
+            C = share(C);
+            hash = combineHash(hash, std::hash<NonlinearExpression*>()(C.get()));
+        }
+    }
+
+    auto isEqual = [&](const NonlinearExpressionPtr& other) {
+        if(other->getType() != expression->getType())
+            return (false);
+
+        if(auto constant = std::dynamic_pointer_cast<ExpressionConstant>(expression))
+            return (std::static_pointer_cast<ExpressionConstant>(other)->constant == constant->constant);
+
+        if(auto variable = std::dynamic_pointer_cast<ExpressionVariable>(expression))
+            return (std::static_pointer_cast<ExpressionVariable>(other)->variable == variable->variable);
+
+        if(auto unary = std::dynamic_pointer_cast<ExpressionUnary>(expression))
+            return (std::static_pointer_cast<ExpressionUnary>(other)->child == unary->child);
+
+        if(auto binary = std::dynamic_pointer_cast<ExpressionBinary>(expression))
+        {
+            auto otherBinary = std::static_pointer_cast<ExpressionBinary>(other);
+            return (otherBinary->firstChild == binary->firstChild && otherBinary->secondChild == binary->secondChild);
+        }
+
+        if(auto general = std::dynamic_pointer_cast<ExpressionGeneral>(expression))
+        {
+            auto otherGeneral = std::static_pointer_cast<ExpressionGeneral>(other);
+
+            if(otherGeneral->children.size() != general->children.size())
+                return (false);
+
+            for(size_t i = 0; i < general->children.size(); i++)
+            {
+                if(otherGeneral->children[i] != general->children[i])
+                    return (false);
+            }
+
+            return (true);
+        }
+
+        return (false);
+    };
+
+    auto candidates = expressions.equal_range(hash);
+
+    for(auto C = candidates.first; C != candidates.second; C++)
+    {
+        if(isEqual(C->second))
+        {
+            numberOfSharedExpressions++;
+            visited.emplace(expression.get(), std::make_pair(expression, C->second));
+            return (C->second);
+        }
+    }
+
+    expressions.emplace(hash, expression);
+    visited.emplace(expression.get(), std::make_pair(expression, expression));
+
+    return (expression);
+}
 }
\ No newline at end of file
@@ -22,6 +22,7 @@
 #include <memory>
 #include <optional>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace SHOT
@@ -134,7 +135,16 @@ public:
 
     virtual double calculate([[maybe_unused]] const VectorDouble& point) const = 0;
     virtual Interval calculate([[maybe_unused]] const IntervalVector& intervalVector) const = 0;
-    virtual Interval getBounds() const = 0;
+
+    // Calculated at most once for each expression while an ExpressionPropertyCacheScope is active in the thread
+    inline Interval getBounds() const;
+    inline E_Convexity getConvexity() const;
+    inline E_Monotonicity getMonotonicity() const;
+
+    // Calculated from the properties of the children given by the functions above
+    virtual Interval calculateBounds() const = 0;
+    virtual E_Convexity calculateConvexity() const = 0;
+    virtual E_Monotonicity calculateMonotonicity() const = 0;
 
     virtual bool tightenBounds(Interval bound) = 0;
 
@@ -144,9 +154,6 @@ public:
 
     virtual E_NonlinearExpressionTypes getType() const = 0;
 
-    virtual E_Convexity getConvexity() const = 0;
-    virtual E_Monotonicity getMonotonicity() const = 0;
-
     virtual int getNumberOfChildren() const = 0;
 
     virtual void appendNonlinearVariables([[maybe_unused]] Variables& nonlinearVariables) = 0;
@@ -171,6 +178,132 @@ inline std::ostream& operator<<(std::ostream& stream, NonlinearExpressionPtr exp
     return stream;
 }
 
+// While a cache is active in a thread, an expression shared by several parent expressions, e.g. after
+// shareCommonSubexpressions(), is recorded once on the CppAD tape
+using FactorableFunctionCache = std::unordered_map<const NonlinearExpression*, FactorableFunction>;
+inline thread_local FactorableFunctionCache* activeFactorableFunctionCache = nullptr;
+
+class FactorableFunctionCacheScope
+{
+public:
+    FactorableFunctionCacheScope() { activeFactorableFunctionCache = &cache; }
+    ~FactorableFunctionCacheScope() { activeFactorableFunctionCache = nullptr; }
+
+private:
+    FactorableFunctionCache cache;
+};
+
+inline FactorableFunction getSharedFactorableFunction(const NonlinearExpressionPtr& expression)
+{
+    // Expressions with only one parent are not shared
+    if(activeFactorableFunctionCache == nullptr || expression.use_count() < 2)
+        return (expression->getFactorableFunction());
+
+    if(auto cached = activeFactorableFunctionCache->find(expression.get());
+        cached != activeFactorableFunctionCache->end())
+        return (cached->second);
+
+    auto function = expression->getFactorableFunction();
+    activeFactorableFunctionCache->emplace(expression.get(), function);
+
+    return (function);
+}
+
+// While a cache is active in a thread, the bounds, convexity and monotonicity of an expression are calculated only
+// once, also when it is shared by several parent expressions. The variable bounds must not change within the scope.
+struct ExpressionProperties
+{
+    std::optional<Interval> bounds;
+    std::optional<E_Convexity> convexity;
+    std::optional<E_Monotonicity> monotonicity;
+};
+
+using ExpressionPropertyCache = std::unordered_map<const NonlinearExpression*, ExpressionProperties>;
+inline thread_local ExpressionPropertyCache* activeExpressionPropertyCache = nullptr;
+
+class ExpressionPropertyCacheScope
+{
+public:
+    // Scopes can be nested, e.g. when the convexity of a constraint is updated within the update of the problem
+    ExpressionPropertyCacheScope() : previousCache(activeExpressionPropertyCache)
+    {
+        if(previousCache == nullptr)
+            activeExpressionPropertyCache = &cache;
+    }
+
+    ~ExpressionPropertyCacheScope()
+    {
+        if(previousCache == nullptr)
+            activeExpressionPropertyCache = nullptr;
+    }
+
+private:
+    ExpressionPropertyCache* previousCache;
+    ExpressionPropertyCache cache;
+};
+
+inline Interval NonlinearExpression::getBounds() const
+{
+    if(activeExpressionPropertyCache == nullptr)
+        return (calculateBounds());
+
+    if(auto& cached = (*activeExpressionPropertyCache)[this].bounds; cached.has_value())
+        return (*cached);
+
+    // The reference into the map may be invalidated by the calculation of the children
+    auto bounds = calculateBounds();
+    (*activeExpressionPropertyCache)[this].bounds = bounds;
+
+    return (bounds);
+}
+
+inline E_Convexity NonlinearExpression::getConvexity() const
+{
+    if(activeExpressionPropertyCache == nullptr)
+        return (calculateConvexity());
+
+    if(auto& cached = (*activeExpressionPropertyCache)[this].convexity; cached.has_value())
+        return (*cached);
+
+    auto convexity = calculateConvexity();
+    (*activeExpressionPropertyCache)[this].convexity = convexity;
+
+    return (convexity);
+}
+
+inline E_Monotonicity NonlinearExpression::getMonotonicity() const
+{
+    if(activeExpressionPropertyCache == nullptr)
+        return (calculateMonotonicity());
+
+    if(auto& cached = (*activeExpressionPropertyCache)[this].monotonicity; cached.has_value())
+        return (*cached);
+
+    auto monotonicity = calculateMonotonicity();
+    (*activeExpressionPropertyCache)[this].monotonicity = monotonicity;
+
+    return (monotonicity);
+}
+
+// Replaces the structurally equal subexpressions in the expressions given to share() by one instance, so that the
+// expressions form a directed acyclic graph instead of separate trees
+class CommonSubexpressionTable
+{
+public:
+    NonlinearExpressionPtr share(const NonlinearExpressionPtr& expression);
+
+    inline int getNumberOfSharedExpressions() const { return (numberOfSharedExpressions); };
+
+private:
+    std::unordered_multimap<size_t, NonlinearExpressionPtr> expressions;
+
+    // The expressions already visited and their shared instances, the visited expressions are kept alive so that their
+    // addresses are not reused
+    std::unordered_map<const NonlinearExpression*, std::pair<NonlinearExpressionPtr, NonlinearExpressionPtr>> visited;
+
+    int numberOfSharedExpressions = 0;
+};
+
 bool checkPerspectiveConvexity(
     NonlinearExpressionPtr expression, double linearCoefficient, VariablePtr linearVariable, double constant);
 
@@ -217,7 +350,7 @@ public:
         return (Interval(constant));
     };
 
-    inline Interval getBounds() const override { return Interval(constant); };
+    inline Interval calculateBounds() const override { return Interval(constant); };
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return false; };
 
@@ -227,8 +360,8 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Constant; };
 
-    inline E_Convexity getConvexity() const override { return E_Convexity::Linear; };
-    inline E_Monotonicity getMonotonicity() const override { return E_Monotonicity::Constant; };
+    inline E_Convexity calculateConvexity() const override { return E_Convexity::Linear; };
+    inline E_Monotonicity calculateMonotonicity() const override { return E_Monotonicity::Constant; };
 
     inline int getNumberOfChildren() const override { return 0; }
 
@@ -265,7 +398,7 @@ public:
 
     inline FactorableFunction getFactorableFunction() override { return *(variable->factorableFunctionVariable); };
 
-    inline Interval getBounds() const override { return (variable->getBound()); };
+    inline Interval calculateBounds() const override { return (variable->getBound()); };
 
     inline bool tightenBounds(Interval bound) override { return (variable->tightenBounds(bound)); };
 
@@ -273,8 +406,8 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Variable; };
 
-    inline E_Convexity getConvexity() const override { return E_Convexity::Linear; };
-    inline E_Monotonicity getMonotonicity() const override { return E_Monotonicity::Nondecreasing; };
+    inline E_Convexity calculateConvexity() const override { return E_Convexity::Linear; };
+    inline E_Monotonicity calculateMonotonicity() const override { return E_Monotonicity::Nondecreasing; };
 
     inline int getNumberOfChildren() const override { return 0; }
 
@@ -390,11 +523,11 @@ public:
         return (-child->calculate(intervalVector));
     }
 
-    inline Interval getBounds() const override { return (-child->getBounds()); };
+    inline Interval calculateBounds() const override { return (-child->getBounds()); };
 
     inline bool tightenBounds(Interval bound) override { return (child->tightenBounds(-bound)); };
 
-    inline FactorableFunction getFactorableFunction() override { return (-child->getFactorableFunction()); }
+    inline FactorableFunction getFactorableFunction() override { return (-getSharedFactorableFunction(child)); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -404,7 +537,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Negate; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         E_Convexity resultConvexity;
@@ -439,7 +572,7 @@ public:
         return resultConvexity;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         E_Monotonicity resultMonotonicity = negateMonotonicity(childMonotonicity);
@@ -470,7 +603,7 @@ public:
         return (1.0 / child->calculate(intervalVector));
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         auto denominatorBounds = child->getBounds();
 
@@ -494,7 +627,7 @@ public:
         return (child->tightenBounds(1.0 / bound));
     };
 
-    inline FactorableFunction getFactorableFunction() override { return (1 / child->getFactorableFunction()); }
+    inline FactorableFunction getFactorableFunction() override { return (1 / getSharedFactorableFunction(child)); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -504,7 +637,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Invert; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto bounds = child->getBounds();
@@ -524,7 +657,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         auto bounds = child->getBounds();
@@ -567,7 +700,7 @@ public:
         return (sqrt(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         auto childBounds = child->getBounds();
 
@@ -587,7 +720,7 @@ public:
         return (child->tightenBounds(interval));
     };
 
-    inline FactorableFunction getFactorableFunction() override { return (sqrt(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (sqrt(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -597,7 +730,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::SquareRoot; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         NonlinearExpressions children;
         auto isValid = true;
@@ -637,7 +770,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         return childMonotonicity;
@@ -671,7 +804,7 @@ public:
         return (log(childValue));
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         auto childValue = child->getBounds();
 
@@ -683,7 +816,7 @@ public:
 
     inline bool tightenBounds(Interval bound) override { return (child->tightenBounds(exp(bound))); };
 
-    inline FactorableFunction getFactorableFunction() override { return (log(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (log(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -693,7 +826,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Log; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -704,7 +837,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         return childMonotonicity;
@@ -733,7 +866,7 @@ public:
         return (exp(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (exp(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (exp(child->getBounds())); }
 
     inline bool tightenBounds(Interval bound) override
     {
@@ -743,7 +876,7 @@ public:
         return (child->tightenBounds(log(bound)));
     };
 
-    inline FactorableFunction getFactorableFunction() override { return (exp(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (exp(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -753,7 +886,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Exp; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
 
@@ -763,7 +896,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         return childMonotonicity;
@@ -800,7 +933,7 @@ public:
         return (interval);
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         auto value = child->getBounds();
 
@@ -819,7 +952,8 @@ public:
 
     inline FactorableFunction getFactorableFunction() override
     {
-        return (child->getFactorableFunction() * child->getFactorableFunction());
+        auto function = getSharedFactorableFunction(child);
+        return (function * function);
     }
 
     inline std::ostream& print(std::ostream& stream) const override
@@ -830,7 +964,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Square; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto baseBounds = child->getBounds();
         auto baseConvexity = child->getConvexity();
@@ -847,7 +981,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
 
@@ -890,11 +1024,11 @@ public:
         return (sin(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (sin(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (sin(child->getBounds())); }
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return (false); };
 
-    inline FactorableFunction getFactorableFunction() override { return (sin(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (sin(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -904,7 +1038,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Sin; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -945,7 +1079,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         auto childBounds = child->getBounds();
@@ -990,11 +1124,11 @@ public:
         return (cos(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (cos(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (cos(child->getBounds())); }
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return (false); };
 
-    inline FactorableFunction getFactorableFunction() override { return (cos(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (cos(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -1004,7 +1138,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Cos; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -1045,7 +1179,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         auto childBounds = child->getBounds();
@@ -1090,11 +1224,11 @@ public:
         return (tan(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (tan(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (tan(child->getBounds())); }
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return (false); };
 
-    inline FactorableFunction getFactorableFunction() override { return (tan(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (tan(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -1104,7 +1238,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Tan; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -1128,7 +1262,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         return childMonotonicity;
@@ -1157,11 +1291,11 @@ public:
         return (asin(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (asin(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (asin(child->getBounds())); }
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return (false); };
 
-    inline FactorableFunction getFactorableFunction() override { return (asin(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (asin(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -1171,7 +1305,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::ArcSin; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -1185,7 +1319,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         return childMonotonicity;
@@ -1214,11 +1348,11 @@ public:
         return (acos(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (acos(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (acos(child->getBounds())); }
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return (false); };
 
-    inline FactorableFunction getFactorableFunction() override { return (acos(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (acos(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -1228,7 +1362,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::ArcCos; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -1242,7 +1376,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         auto resultMonotonicity = negateMonotonicity(childMonotonicity);
@@ -1272,11 +1406,11 @@ public:
         return (atan(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (atan(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (atan(child->getBounds())); }
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return (false); };
 
-    inline FactorableFunction getFactorableFunction() override { return (atan(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (atan(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -1286,7 +1420,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::ArcTan; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -1300,7 +1434,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         return childMonotonicity;
@@ -1329,11 +1463,11 @@ public:
         return (fabs(child->calculate(intervalVector)));
     }
 
-    inline Interval getBounds() const override { return (fabs(child->getBounds())); }
+    inline Interval calculateBounds() const override { return (fabs(child->getBounds())); }
 
     inline bool tightenBounds([[maybe_unused]] Interval bound) override { return (false); };
 
-    inline FactorableFunction getFactorableFunction() override { return (fabs(child->getFactorableFunction())); }
+    inline FactorableFunction getFactorableFunction() override { return (fabs(getSharedFactorableFunction(child))); }
 
     inline std::ostream& print(std::ostream& stream) const override
     {
@@ -1343,7 +1477,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Abs; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto childConvexity = child->getConvexity();
         auto childBounds = child->getBounds();
@@ -1371,7 +1505,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto childMonotonicity = child->getMonotonicity();
         auto childBounds = child->getBounds();
@@ -1423,7 +1557,7 @@ public:
         return (firstChild->calculate(intervalVector) / secondChild->calculate(intervalVector));
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         auto denominatorBounds = secondChild->getBounds();
 
@@ -1464,7 +1598,7 @@ public:
 
     inline FactorableFunction getFactorableFunction() override
     {
-        return (firstChild->getFactorableFunction() / secondChild->getFactorableFunction());
+        return (getSharedFactorableFunction(firstChild) / getSharedFactorableFunction(secondChild));
     }
 
     inline std::ostream& print(std::ostream& stream) const override
@@ -1475,7 +1609,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Divide; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto child1Monotonicity = firstChild->getMonotonicity();
         auto child2Monotonicity = secondChild->getMonotonicity();
@@ -1669,7 +1803,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto child1Monotonicity = firstChild->getMonotonicity();
         auto child2Monotonicity = secondChild->getMonotonicity();
@@ -1821,7 +1955,7 @@ public:
         return (pow(baseBounds, powerBounds));
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         auto baseBounds = firstChild->getBounds();
         auto powerBounds = secondChild->getBounds();
@@ -1920,11 +2054,11 @@ public:
             if(std::modf(constantValue, &intpart) == 0.0)
             {
                 int power = (int)constantValue;
-                return (CppAD::pow(firstChild->getFactorableFunction(), power));
+                return (CppAD::pow(getSharedFactorableFunction(firstChild), power));
             }
         }
 
-        return (pow(firstChild->getFactorableFunction(), secondChild->getFactorableFunction()));
+        return (pow(getSharedFactorableFunction(firstChild), getSharedFactorableFunction(secondChild)));
     }
 
     inline std::ostream& print(std::ostream& stream) const override
@@ -1935,7 +2069,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Power; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         auto baseMonotonicity = firstChild->getMonotonicity();
         auto exponentMonotonicity = secondChild->getMonotonicity();
@@ -1962,7 +2096,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         auto baseMonotonicity = firstChild->getMonotonicity();
         auto exponentMonotonicity = secondChild->getMonotonicity();
@@ -2255,7 +2389,7 @@ public:
         return (tmpInterval);
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         Interval tmpInterval(0.);
 
@@ -2297,7 +2431,7 @@ public:
 
         for(auto& C : children)
         {
-            funct += C->getFactorableFunction();
+            funct += getSharedFactorableFunction(C);
         }
 
         return (funct);
@@ -2325,7 +2459,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Sum; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         E_Convexity resultConvexity = E_Convexity::Linear;
 
@@ -2357,7 +2491,7 @@ public:
         return (true);
     }
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         bool areAllConstant = true;
         bool areAllZeroOrNondecreasing = true;
@@ -2461,7 +2595,7 @@ public:
         return (tmpInterval);
     }
 
-    inline Interval getBounds() const override
+    inline Interval calculateBounds() const override
     {
         Interval tmpInterval(1.);
 
@@ -2518,7 +2652,7 @@ public:
 
         for(size_t i = 0; i < children.size(); i++)
         {
-            factors[i] = children[i]->getFactorableFunction();
+            factors[i] = getSharedFactorableFunction(children[i]);
         }
 
         funct = factors[0];
@@ -2553,7 +2687,7 @@ public:
 
     inline E_NonlinearExpressionTypes getType() const override { return E_NonlinearExpressionTypes::Product; }
 
-    inline E_Convexity getConvexity() const override
+    inline E_Convexity calculateConvexity() const override
     {
         int numberOfChildren = getNumberOfChildren();
 
@@ -2742,7 +2876,7 @@ public:
         return E_Convexity::Unknown;
     };
 
-    inline E_Monotonicity getMonotonicity() const override
+    inline E_Monotonicity calculateMonotonicity() const override
     {
         int numberOfChildren = getNumberOfChildren();
 
@@ -2943,4 +3077,8 @@ bool checkPerspectiveConvexity(std::shared_ptr<ExpressionSquare> expression, dou
 bool checkPerspectiveConvexity(
     std::shared_ptr<ExpressionLog> expression, double linearCoefficient, VariablePtr linearVariable, double constant);
 
+// Returns the function if the expression is a univariate function of a variable that can be given to a MIP solver as a
+// function constraint, i.e. the function is defined on the domain of the variable
+std::optional<UnivariateFunction> getUnivariateFunction(const NonlinearExpressionPtr& expression);
+
 } // namespace SHOT
@@ -12,6 +12,7 @@
 
 #include "../Environment.h"
 #include "Problem.h"
+#include "../DebugWriter.h"
 #include "../Settings.h"
 #include "../Utilities.h"
 
@@ -218,6 +219,7 @@ void LinearObjectiveFunction::updateProperties()
 
     properties.classification = E_ObjectiveFunctionClassification::Linear;
     properties.convexity = E_Convexity::Linear;
+    properties.isConvexityFromSampling = false;
 
     ObjectiveFunction::updateProperties();
 }
@@ -657,6 +659,8 @@ void NonlinearObjectiveFunction::add(NonlinearExpressionPtr expression)
         nonlinearExpression = expression;
     }
 
+    nonlinearExpressionTape.reset();
+
     properties.isValid = false;
 }
 
@@ -667,6 +671,9 @@ void NonlinearObjectiveFunction::updateFactorableFunction()
 
 void NonlinearObjectiveFunction::updateProperties()
 {
+    // The subexpressions shared in the expression are analysed once
+    ExpressionPropertyCacheScope propertyCacheScope;
+
     QuadraticObjectiveFunction::updateProperties();
 
     properties.classification = E_ObjectiveFunctionClassification::Nonlinear;
@@ -758,7 +765,12 @@ double NonlinearObjectiveFunction::calculateValue(const VectorDouble& point)
     value += signomialTerms.calculate(point);
 
     if(this->properties.hasNonlinearExpression)
-        value += nonlinearExpression->calculate(point);
+    {
+        if(nonlinearExpressionTape)
+            value += nonlinearExpressionTape->calculate(point);
+        else
+            value += nonlinearExpression->calculate(point);
+    }
 
     return value;
 }
@@ -772,7 +784,12 @@ Interval NonlinearObjectiveFunction::calculateValue(const IntervalVector& interv
     try
     {
         if(this->properties.hasNonlinearExpression)
-            value += nonlinearExpression->calculate(intervalVector);
+        {
+            if(nonlinearExpressionTape)
+                value += nonlinearExpressionTape->calculate(intervalVector);
+            else
+                value += nonlinearExpression->calculate(intervalVector);
+        }
     }
     catch(const mc::Interval::Exceptions&)
     {
@@ -800,8 +817,10 @@ SparseVariableVector NonlinearObjectiveFunction::calculateGradient(const VectorD
             for(auto& VAR : sharedOwnerProblem->nonlinearExpressionVariables)
                 pointNonlinearSubset[VAR->properties.nonlinearVariableIndex] = point[VAR->index];
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             CppAD::sparse_rcv<std::vector<size_t>, std::vector<double>> subset(nonlinearGradientSparsityPattern);
-            sharedOwnerProblem->ADFunctions.subgraph_jac_rev(pointNonlinearSubset, subset);
+            sharedOwnerProblem->getADFunctions().subgraph_jac_rev(pointNonlinearSubset, subset);
 
             const std::vector<size_t>& col(subset.col());
             const std::vector<double>& value(subset.val());
@@ -931,9 +950,11 @@ void NonlinearObjectiveFunction::initializeGradientSparsityPattern()
 
             nonlinearFunctionMap[this->nonlinearExpressionIndex] = true;
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             CppAD::sparse_rc<std::vector<size_t>> pattern;
 
-            sharedOwnerProblem->ADFunctions.subgraph_sparsity(
+            sharedOwnerProblem->getADFunctions().subgraph_sparsity(
                 nonlinearVariablesInExpressionMap, nonlinearFunctionMap, false, pattern);
 
             // Save for later use when calculating gradients
@@ -972,13 +993,20 @@ void NonlinearObjectiveFunction::initializeGradientSparsityPattern()
 
         filename << ".txt";
 
-        Utilities::writeStringToFile(filename.str(), stream.str());
+        if(auto sharedOwnerProblem = ownerProblem.lock())
+            sharedOwnerProblem->env->debugWriter->write(filename.str(), stream.str());
     }
 
     nonlinearGradientSparsityMapGenerated = true;
 }
 
 SparseVariableMatrix NonlinearObjectiveFunction::calculateHessian(const VectorDouble& point, bool eraseZeroes = true)
+{
+    return (calculateHessian(point, eraseZeroes, true));
+}
+
+SparseVariableMatrix NonlinearObjectiveFunction::calculateHessian(
+    const VectorDouble& point, bool eraseZeroes, bool includeNonlinearExpression)
 {
     SparseVariableMatrix hessian = QuadraticObjectiveFunction::calculateHessian(point, eraseZeroes);
 
@@ -992,7 +1020,7 @@ SparseVariableMatrix NonlinearObjectiveFunction::calculateHessian(const VectorDo
         hessian = Utilities::combineSparseVariableMatrices(signomialTerms.calculateHessian(point), hessian);
     }
 
-    if(this->properties.hasNonlinearExpression)
+    if(includeNonlinearExpression && this->properties.hasNonlinearExpression)
     {
         if(!nonlinearHessianSparsityMapGenerated)
             initializeHessianSparsityPattern();
@@ -1009,9 +1037,11 @@ SparseVariableMatrix NonlinearObjectiveFunction::calculateHessian(const VectorDo
             for(auto& VAR : sharedOwnerProblem->nonlinearExpressionVariables)
                 pointNonlinearSubset[VAR->properties.nonlinearVariableIndex] = point[VAR->index];
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             CppAD::sparse_rcv<std::vector<size_t>, std::vector<double>> subset(nonlinearHessianSparsityPattern);
 
-            auto calculatedHessian = sharedOwnerProblem->ADFunctions.SparseHessian(pointNonlinearSubset, weights);
+            auto calculatedHessian = sharedOwnerProblem->getADFunctions().SparseHessian(pointNonlinearSubset, weights);
 
             for(auto& V1 : variablesInNonlinearExpression)
             {
@@ -1112,9 +1142,11 @@ void NonlinearObjectiveFunction::initializeHessianSparsityPattern()
 
             nonlinearFunctionMap[this->nonlinearExpressionIndex] = true;
 
+            auto cppADLock = Problem::lockCppADEvaluation();
+
             CppAD::sparse_rc<std::vector<size_t>> pattern;
 
-            sharedOwnerProblem->ADFunctions.for_hes_sparsity(
+            sharedOwnerProblem->getADFunctions().for_hes_sparsity(
                 nonlinearVariablesInExpressionMap, nonlinearFunctionMap, false, pattern);
 
             nonlinearHessianSparsityPattern = pattern;
@@ -14,6 +14,7 @@
 #include "Variables.h"
 #include "Terms.h"
 #include "NonlinearExpressions.h"
+#include "ExpressionTape.h"
 
 #include <vector>
 
@@ -54,6 +55,9 @@ struct ObjectiveFunctionProperties
 
     E_Convexity convexity = E_Convexity::Convex;
 
+    // The convexity was determined numerically since it was unknown, see Problem::updateConvexityBySampling()
+    bool isConvexityFromSampling = false;
+
     bool isReformulated = false;
 
     E_ObjectiveFunctionClassification classification = E_ObjectiveFunctionClassification::None;
@@ -344,6 +348,9 @@ public:
     NonlinearExpressionPtr nonlinearExpression;
     FactorableFunctionPtr factorableFunction;
 
+    // Compiled version of nonlinearExpression, created in Problem::finalize() if enabled
+    ExpressionTapePtr nonlinearExpressionTape;
+
     CppAD::sparse_rc<std::vector<size_t>> nonlinearGradientSparsityPattern;
     CppAD::sparse_rc<std::vector<size_t>> nonlinearHessianSparsityPattern;
 
@@ -384,6 +391,11 @@ public:
     SparseVariableVector calculateGradient(const VectorDouble& point, bool eraseZeroes) override;
     SparseVariableMatrix calculateHessian(const VectorDouble& point, bool eraseZeroes) override;
 
+    // The nonlinear expression can be left out if its Hessian is calculated elsewhere, see
+    // Problem::calculateLagrangianHessian()
+    SparseVariableMatrix calculateHessian(
+        const VectorDouble& point, bool eraseZeroes, bool includeNonlinearExpression);
+
     std::ostream& print(std::ostream& stream) const override;
 
 protected:
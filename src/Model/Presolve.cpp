@@ -0,0 +1,486 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "Presolve.h"
+
+#include "../Output.h"
+#include "../Settings.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+namespace SHOT
+{
+
+// Tolerance for when bounds are considered equal or crossing and coefficients are considered parallel
+static const double presolveTolerance = 1e-9;
+
+// Variables are not fixed at bounds with a larger absolute value, e.g. the default bounds of unbounded variables
+static const double maximumFixedValue = 1e10;
+
+static inline bool isFiniteBound(double bound) { return (bound > SHOT_DBL_MIN && bound < SHOT_DBL_MAX); }
+
+static inline bool isDiscrete(const VariablePtr& variable)
+{
+    return (variable->properties.type == E_VariableType::Binary
+        || variable->properties.type == E_VariableType::Integer);
+}
+
+Presolve::Presolve(EnvironmentPtr envPtr, ProblemPtr problem) : env(envPtr), problem(problem) { }
+
+void Presolve::run()
+{
+    isConstraintRemoved.assign(problem->linearConstraints.size(), false);
+
+    bool useDominatedVariables = env->settings->getSetting<bool>("Presolve.DominatedVariables.Use", "Model");
+    int maximumNumberOfPasses = env->settings->getSetting<int>("Presolve.MaxIterations", "Model");
+
+    int numberOfPasses = 0;
+
+    for(; numberOfPasses < maximumNumberOfPasses; numberOfPasses++)
+    {
+        bool isChanged = removeFixedVariables();
+        isChanged = presolveEmptyAndSingletonConstraints() || isChanged;
+        isChanged = presolveParallelConstraints() || isChanged;
+
+        if(useDominatedVariables)
+            isChanged = fixDominatedVariables() || isChanged;
+
+        if(!isChanged)
+            break;
+    }
+
+    updateProblemConstraints();
+
+    env->output->outputDebug(fmt::format("  Presolve removed {} linear constraints, tightened {} variable bounds and "
+                                         "fixed {} dominated variables in {} passes.",
+        numberOfRemovedConstraints, numberOfTightenedBounds, numberOfFixedVariables, numberOfPasses));
+}
+
+bool Presolve::removeFixedVariables()
+{
+    bool isChanged = false;
+
+    for(size_t i = 0; i < problem->linearConstraints.size(); i++)
+    {
+        if(isConstraintRemoved[i])
+            continue;
+
+        auto& constraint = problem->linearConstraints[i];
+        LinearTerms remainingTerms;
+
+        for(auto& T : constraint->linearTerms)
+        {
+            if(T->variable->lowerBound == T->variable->upperBound)
+                constraint->constant += T->coefficient * T->variable->lowerBound;
+            else if(T->coefficient != 0.0)
+                remainingTerms.push_back(T);
+        }
+
+        if(remainingTerms.size() != constraint->linearTerms.size())
+        {
+            constraint->linearTerms = std::move(remainingTerms);
+            isChanged = true;
+        }
+    }
+
+    return (isChanged);
+}
+
+bool Presolve::presolveEmptyAndSingletonConstraints()
+{
+    bool isChanged = false;
+
+    for(size_t i = 0; i < problem->linearConstraints.size(); i++)
+    {
+        if(isConstraintRemoved[i])
+            continue;
+
+        auto& constraint = problem->linearConstraints[i];
+
+        if(constraint->linearTerms.size() == 0)
+        {
+            // An infeasible constraint is kept, so that the infeasibility is detected when solving
+            if(constraint->constant < constraint->valueLHS - presolveTolerance
+                || constraint->constant > constraint->valueRHS + presolveTolerance)
+            {
+                env->output->outputDebug(
+                    fmt::format("  Presolve found infeasible empty constraint {}.", constraint->name));
+                continue;
+            }
+
+            removeConstraint(i);
+            isChanged = true;
+            continue;
+        }
+
+        if(constraint->linearTerms.size() != 1)
+            continue;
+
+        auto& variable = constraint->linearTerms[0]->variable;
+        double coefficient = constraint->linearTerms[0]->coefficient;
+
+        if(variable->properties.type == E_VariableType::Semicontinuous
+            || variable->properties.type == E_VariableType::Semiinteger)
+            continue;
+
+        double lowerBound = variable->lowerBound;
+        double upperBound = variable->upperBound;
+
+        double boundFromLHS = (constraint->valueLHS - constraint->constant) / coefficient;
+        double boundFromRHS = (constraint->valueRHS - constraint->constant) / coefficient;
+
+        if(coefficient > 0)
+        {
+            if(isFiniteBound(constraint->valueLHS))
+                lowerBound = std::max(lowerBound, boundFromLHS);
+
+            if(isFiniteBound(constraint->valueRHS))
+                upperBound = std::min(upperBound, boundFromRHS);
+        }
+        else
+        {
+            if(isFiniteBound(constraint->valueLHS))
+                upperBound = std::min(upperBound, boundFromLHS);
+
+            if(isFiniteBound(constraint->valueRHS))
+                lowerBound = std::max(lowerBound, boundFromRHS);
+        }
+
+        if(isDiscrete(variable))
+        {
+            lowerBound = std::ceil(lowerBound - presolveTolerance);
+            upperBound = std::floor(upperBound + presolveTolerance);
+        }
+
+        if(lowerBound > upperBound + presolveTolerance)
+        {
+            env->output->outputDebug(fmt::format("  Presolve found infeasible bounds for variable {} in constraint {}.",
+                variable->name, constraint->name));
+            continue;
+        }
+
+        if(lowerBound > upperBound)
+            lowerBound = upperBound = (lowerBound + upperBound) / 2.0;
+
+        if(lowerBound > variable->lowerBound)
+        {
+            variable->properties.hasLowerBoundBeenTightened = true;
+            numberOfTightenedBounds++;
+        }
+
+        if(upperBound < variable->upperBound)
+        {
+            variable->properties.hasUpperBoundBeenTightened = true;
+            numberOfTightenedBounds++;
+        }
+
+        problem->setVariableBounds(variable->index, lowerBound, upperBound);
+
+        removeConstraint(i);
+        isChanged = true;
+    }
+
+    return (isChanged);
+}
+
+bool Presolve::presolveParallelConstraints()
+{
+    bool isChanged = false;
+
+    // The constraints are grouped by their variables, so that only constraints with the same variables are compared
+    std::unordered_map<size_t, std::vector<size_t>> constraintsWithHash;
+
+    for(size_t i = 0; i < problem->linearConstraints.size(); i++)
+    {
+        if(isConstraintRemoved[i])
+            continue;
+
+        auto& constraint = problem->linearConstraints[i];
+        auto& terms = constraint->linearTerms;
+
+        if(terms.size() < 2)
+            continue;
+
+        std::sort(terms.begin(), terms.end(),
+            [](const LinearTermPtr& first, const LinearTermPtr& second)
+            { return (first->variable->index < second->variable->index); });
+
+        size_t hash = terms.size();
+
+        for(auto& T : terms)
+            hash ^= std::hash<int>()(T->variable->index) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+        auto& candidates = constraintsWithHash[hash];
+        bool isMerged = false;
+
+        for(auto j : candidates)
+        {
+            auto& otherConstraint = problem->linearConstraints[j];
+            auto& otherTerms = otherConstraint->linearTerms;
+
+            if(otherTerms.size() != terms.size())
+                continue;
+
+            // The constraint is the other constraint multiplied by the ratio
+            double ratio = terms[0]->coefficient / otherTerms[0]->coefficient;
+            bool isParallel = true;
+
+            for(size_t k = 0; k < terms.size(); k++)
+            {
+                if(terms[k]->variable != otherTerms[k]->variable
+                    || std::abs(terms[k]->coefficient - ratio * otherTerms[k]->coefficient)
+                        > presolveTolerance * std::max(1.0, std::abs(terms[k]->coefficient)))
+                {
+                    isParallel = false;
+                    break;
+                }
+            }
+
+            if(!isParallel)
+                continue;
+
+            // The bounds of the constraint are moved to the linear terms of the other constraint
+            double lowerBound = SHOT_DBL_MIN;
+            double upperBound = SHOT_DBL_MAX;
+
+            double lhs = (ratio > 0) ? constraint->valueLHS : constraint->valueRHS;
+            double rhs = (ratio > 0) ? constraint->valueRHS : constraint->valueLHS;
+
+            if(isFiniteBound(lhs))
+                lowerBound = (lhs - constraint->constant) / ratio + otherConstraint->constant;
+
+            if(isFiniteBound(rhs))
+                upperBound = (rhs - constraint->constant) / ratio + otherConstraint->constant;
+
+            lowerBound = std::max(lowerBound, otherConstraint->valueLHS);
+            upperBound = std::min(upperBound, otherConstraint->valueRHS);
+
+            // Infeasible constraints are kept, so that the infeasibility is detected when solving
+            if(lowerBound > upperBound + presolveTolerance * std::max(1.0, std::abs(upperBound)))
+                continue;
+
+            if(lowerBound > upperBound)
+                lowerBound = upperBound = (lowerBound + upperBound) / 2.0;
+
+            otherConstraint->valueLHS = lowerBound;
+            otherConstraint->valueRHS = upperBound;
+
+            removeConstraint(i);
+            isMerged = true;
+            isChanged = true;
+            break;
+        }
+
+        if(!isMerged)
+            candidates.push_back(i);
+    }
+
+    return (isChanged);
+}
+
+bool Presolve::fixDominatedVariables()
+{
+    bool isChanged = false;
+
+    size_t numberOfVariables = problem->allVariables.size();
+
+    // The number of constraints that may become violated if a variable is decreased or increased
+    std::vector<int> downLocks(numberOfVariables, 0);
+    std::vector<int> upLocks(numberOfVariables, 0);
+    std::vector<double> objectiveCoefficients(numberOfVariables, 0.0);
+    std::vector<bool> canBeFixed(numberOfVariables, true);
+
+    for(size_t i = 0; i < problem->linearConstraints.size(); i++)
+    {
+        if(isConstraintRemoved[i])
+            continue;
+
+        auto& constraint = problem->linearConstraints[i];
+        bool hasLHS = isFiniteBound(constraint->valueLHS);
+        bool hasRHS = isFiniteBound(constraint->valueRHS);
+
+        for(auto& T : constraint->linearTerms)
+        {
+            int index = T->variable->index;
+
+            if((T->coefficient > 0 && hasLHS) || (T->coefficient < 0 && hasRHS))
+                downLocks[index]++;
+
+            if((T->coefficient > 0 && hasRHS) || (T->coefficient < 0 && hasLHS))
+                upLocks[index]++;
+        }
+    }
+
+    // Variables in quadratic or nonlinear constraints or terms, and in special ordered sets, are not considered
+    auto excludeNonlinearParts = [&](const QuadraticTerms& quadraticTerms, const MonomialTerms& monomialTerms,
+                                     const SignomialTerms& signomialTerms,
+                                     const NonlinearExpressionPtr& nonlinearExpression) {
+        for(auto& T : quadraticTerms)
+        {
+            canBeFixed[T->firstVariable->index] = false;
+            canBeFixed[T->secondVariable->index] = false;
+        }
+
+        for(auto& T : monomialTerms)
+        {
+            for(auto& V : T->variables)
+                canBeFixed[V->index] = false;
+        }
+
+        for(auto& T : signomialTerms)
+        {
+            for(auto& E : T->elements)
+                canBeFixed[E->variable->index] = false;
+        }
+
+        if(nonlinearExpression)
+        {
+            Variables variables;
+            nonlinearExpression->appendNonlinearVariables(variables);
+
+            for(auto& V : variables)
+                canBeFixed[V->index] = false;
+        }
+    };
+
+    for(auto& C : problem->quadraticConstraints)
+    {
+        for(auto& T : C->linearTerms)
+            canBeFixed[T->variable->index] = false;
+
+        excludeNonlinearParts(C->quadraticTerms, MonomialTerms(), SignomialTerms(), nullptr);
+    }
+
+    for(auto& C : problem->nonlinearConstraints)
+    {
+        for(auto& T : C->linearTerms)
+            canBeFixed[T->variable->index] = false;
+
+        excludeNonlinearParts(C->quadraticTerms, C->monomialTerms, C->signomialTerms, C->nonlinearExpression);
+    }
+
+    for(auto& S : problem->specialOrderedSets)
+    {
+        for(auto& V : S->variables)
+            canBeFixed[V->index] = false;
+    }
+
+    auto objective = std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction);
+
+    if(!objective)
+        return (false);
+
+    // The coefficients are for a minimization problem
+    double objectiveSign = (objective->direction == E_ObjectiveFunctionDirection::Maximize) ? -1.0 : 1.0;
+
+    for(auto& T : objective->linearTerms)
+        objectiveCoefficients[T->variable->index] += objectiveSign * T->coefficient;
+
+    if(auto quadraticObjective = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(objective))
+        excludeNonlinearParts(quadraticObjective->quadraticTerms, MonomialTerms(), SignomialTerms(), nullptr);
+
+    if(auto nonlinearObjective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objective))
+    {
+        excludeNonlinearParts(nonlinearObjective->quadraticTerms, nonlinearObjective->monomialTerms,
+            nonlinearObjective->signomialTerms, nonlinearObjective->nonlinearExpression);
+    }
+
+    for(auto& V : problem->allVariables)
+    {
+        int index = V->index;
+
+        if(!canBeFixed[index] || V->lowerBound == V->upperBound
+            || V->properties.type == E_VariableType::Semicontinuous
+            || V->properties.type == E_VariableType::Semiinteger)
+            continue;
+
+        bool canBeDecreased = (objectiveCoefficients[index] >= 0.0 && downLocks[index] == 0
+            && std::abs(V->lowerBound) < maximumFixedValue);
+        bool canBeIncreased = (objectiveCoefficients[index] <= 0.0 && upLocks[index] == 0
+            && std::abs(V->upperBound) < maximumFixedValue);
+
+        // If both are possible, the value closest to zero is used
+        if(canBeDecreased && canBeIncreased)
+        {
+            if(std::abs(V->lowerBound) <= std::abs(V->upperBound))
+                canBeIncreased = false;
+            else
+                canBeDecreased = false;
+        }
+
+        if(canBeDecreased)
+        {
+            problem->setVariableBounds(index, V->lowerBound, V->lowerBound);
+            V->properties.hasUpperBoundBeenTightened = true;
+        }
+        else if(canBeIncreased)
+        {
+            problem->setVariableBounds(index, V->upperBound, V->upperBound);
+            V->properties.hasLowerBoundBeenTightened = true;
+        }
+        else
+        {
+            continue;
+        }
+
+        numberOfFixedVariables++;
+        isChanged = true;
+    }
+
+    return (isChanged);
+}
+
+void Presolve::removeConstraint(size_t constraintIndex)
+{
+    isConstraintRemoved[constraintIndex] = true;
+    numberOfRemovedConstraints++;
+}
+
+void Presolve::updateProblemConstraints()
+{
+    if(numberOfRemovedConstraints == 0)
+        return;
+
+    std::vector<const NumericConstraint*> removedConstraints;
+
+    LinearConstraints remainingConstraints;
+    remainingConstraints.reserve(problem->linearConstraints.size() - numberOfRemovedConstraints);
+
+    for(size_t i = 0; i < problem->linearConstraints.size(); i++)
+    {
+        if(isConstraintRemoved[i])
+            removedConstraints.push_back(problem->linearConstraints[i].get());
+        else
+            remainingConstraints.push_back(problem->linearConstraints[i]);
+    }
+
+    problem->linearConstraints = std::move(remainingConstraints);
+
+    std::sort(removedConstraints.begin(), removedConstraints.end());
+
+    NumericConstraints remainingNumericConstraints;
+    remainingNumericConstraints.reserve(problem->numericConstraints.size() - numberOfRemovedConstraints);
+
+    for(auto& C : problem->numericConstraints)
+    {
+        if(!std::binary_search(removedConstraints.begin(), removedConstraints.end(), C.get()))
+            remainingNumericConstraints.push_back(C);
+    }
+
+    problem->numericConstraints = std::move(remainingNumericConstraints);
+
+    for(size_t i = 0; i < problem->numericConstraints.size(); i++)
+        problem->numericConstraints[i]->index = i;
+}
+} // namespace SHOT
@@ -0,0 +1,55 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Environment.h"
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include "Problem.h"
+
+#include <vector>
+
+namespace SHOT
+{
+
+// Presolves the linear constraints of a problem that has not been finalized, e.g. the reformulated problem. Fixed
+// variables are removed from the linear constraints, empty and singleton constraints are replaced by variable bounds,
+// parallel constraints are merged, and variables that can be moved to a bound without making any constraint or the
+// objective worse are fixed. The variables are only fixed and not removed, so the solutions of the presolved problem
+// are also solutions of the problem before presolve and nothing needs to be mapped back.
+class Presolve
+{
+public:
+    Presolve(EnvironmentPtr envPtr, ProblemPtr problem);
+
+    void run();
+
+    int numberOfRemovedConstraints = 0;
+    int numberOfTightenedBounds = 0;
+    int numberOfFixedVariables = 0;
+
+private:
+    EnvironmentPtr env;
+    ProblemPtr problem;
+
+    // Indexed as the linear constraints in the problem, which are only removed at the end
+    std::vector<bool> isConstraintRemoved;
+
+    bool removeFixedVariables();
+    bool presolveEmptyAndSingletonConstraints();
+    bool presolveParallelConstraints();
+    bool fixDominatedVariables();
+
+    void removeConstraint(size_t constraintIndex);
+    void updateProblemConstraints();
+};
+} // namespace SHOT
@@ -9,18 +9,95 @@
 */
 
 #include "Problem.h"
+#include "../CancellationToken.h"
+#include "../DebugWriter.h"
 #include "../Enums.h"
+#include "../Metrics.h"
 #include "../Output.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 #include "../Model/Simplifications.h"
 
 #include "../Tasks/TaskReformulateProblem.h"
 
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <functional>
+#include <numeric>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <tuple>
+
 namespace SHOT
 {
 
+// CppAD keeps memory pools and tapes per thread and needs to know the number of the current thread. The numbers are
+// assigned on first use and released when the thread exits, so that short-lived worker threads reuse them. The last
+// number is shared by the threads started when all others are in use, and these threads evaluate the recorded
+// functions one at a time, see Problem::lockCppADEvaluation().
+static std::mutex cppADThreadMutex;
+static std::recursive_mutex sharedCppADThreadNumberMutex;
+static const size_t sharedCppADThreadNumber = CPPAD_MAX_NUM_THREADS - 1;
+static std::vector<bool> cppADThreadNumbersInUse(CPPAD_MAX_NUM_THREADS - 1, false);
+static std::atomic<int> numberOfCppADThreads(0);
+
+struct CppADThreadNumber
+{
+    size_t number = sharedCppADThreadNumber;
+
+    CppADThreadNumber()
+    {
+        std::lock_guard<std::mutex> lock(cppADThreadMutex);
+
+        auto freeNumber = std::find(cppADThreadNumbersInUse.begin(), cppADThreadNumbersInUse.end(), false);
+
+        if(freeNumber != cppADThreadNumbersInUse.end())
+        {
+            *freeNumber = true;
+            number = freeNumber - cppADThreadNumbersInUse.begin();
+        }
+
+        numberOfCppADThreads++;
+    }
+
+    ~CppADThreadNumber()
+    {
+        std::lock_guard<std::mutex> lock(cppADThreadMutex);
+
+        if(number != sharedCppADThreadNumber)
+            cppADThreadNumbersInUse[number] = false;
+
+        numberOfCppADThreads--;
+    }
+};
+
+static size_t getCppADThreadNumber()
+{
+    thread_local CppADThreadNumber threadNumber;
+    return (threadNumber.number);
+}
+
+static bool isCppADInParallel() { return (numberOfCppADThreads > 1); }
+
+// Must be called before CppAD is used for the first time, while only one thread is using it
+static void setupCppADThreads()
+{
+    static std::once_flag setupFlag;
+
+    std::call_once(setupFlag, [] {
+        // Registers the calling thread as number zero
+        getCppADThreadNumber();
+
+        CppAD::thread_alloc::parallel_setup(CPPAD_MAX_NUM_THREADS, isCppADInParallel, getCppADThreadNumber);
+        CppAD::thread_alloc::hold_memory(true);
+        CppAD::parallel_ad<double>();
+    });
+}
+
 void Problem::updateConstraints()
 {
     NumericConstraints auxConstraints;
@@ -41,6 +118,7 @@ void Problem::updateConstraints()
                 C->valueRHS = -C->valueLHS;
 
             C->valueLHS = SHOT_DBL_MIN;
+            C->isNegatedInStandardForm = !C->isNegatedInStandardForm;
 
             for(auto& T : C->linearTerms)
                 T->coefficient *= -1.0;
@@ -62,6 +140,7 @@ void Problem::updateConstraints()
                 C->valueRHS = -C->valueLHS;
 
             C->valueLHS = SHOT_DBL_MIN;
+            C->isNegatedInStandardForm = !C->isNegatedInStandardForm;
 
             for(auto& T : C->linearTerms)
                 T->coefficient *= -1.0;
@@ -98,20 +177,20 @@ void Problem::updateConstraints()
 
             auxConstraint->updateProperties();
             auxConstraints.push_back(auxConstraint);
+            C->standardFormLHSConstraint = auxConstraint;
         }
     }
 
     env->output->outputTrace(" Standardizing nonlinear constraints");
     for(auto& C : nonlinearConstraints)
     {
-        C->variablesInNonlinearExpression.clear();
-
         if(C->valueRHS == SHOT_DBL_MAX && C->valueLHS != SHOT_DBL_MIN)
         {
             if(C->valueRHS != 0.0)
                 C->valueRHS = -C->valueLHS;
 
             C->valueLHS = SHOT_DBL_MIN;
+            C->isNegatedInStandardForm = !C->isNegatedInStandardForm;
 
             for(auto& T : C->linearTerms)
                 T->coefficient *= -1.0;
@@ -270,6 +349,7 @@ void Problem::updateConstraints()
 
             auxConstraint->updateProperties();
             auxConstraints.push_back(auxConstraint);
+            C->standardFormLHSConstraint = auxConstraint;
         }
     }
 
@@ -279,18 +359,309 @@ void Problem::updateConstraints()
 
     this->objectiveFunction->takeOwnership(shared_from_this());
 
+    env->output->outputTrace(" Updating the convexity of the quadratic terms");
+    updateQuadraticConvexity();
+
     env->output->outputTrace(" Updating all constraints");
+
+    // The subexpressions shared by several constraints are analysed once
+    ExpressionPropertyCacheScope propertyCacheScope;
+
+    // The properties are kept for the constraints that have not changed since the problem was last updated, e.g.
+    // when the problem is finalized after the nonlinear expressions have been simplified
+    int numberOfUpdatedConstraints = 0;
+
     for(auto& C : numericConstraints)
     {
-        C->updateProperties();
+        if(C->updatePropertiesIfChanged())
+            numberOfUpdatedConstraints++;
+
         C->takeOwnership(shared_from_this());
     }
+
+    env->output->outputTrace(fmt::format("  Updated the properties of {} of {} constraints",
+        numberOfUpdatedConstraints, numericConstraints.size()));
+}
+
+void Problem::updateQuadraticConvexity()
+{
+    using TermsKey = std::vector<std::tuple<int, int, double>>;
+
+    std::map<TermsKey, size_t> analysedTermsPositions;
+    std::vector<QuadraticTerms*> analysedTerms;
+    std::vector<std::pair<QuadraticTerms*, size_t>> equalTerms;
+
+    for(auto& C : numericConstraints)
+    {
+        auto constraint = dynamic_cast<QuadraticConstraint*>(C.get());
+
+        if(!constraint || constraint->quadraticTerms.size() == 0)
+            continue;
+
+        TermsKey key;
+        key.reserve(constraint->quadraticTerms.size());
+
+        for(auto& T : constraint->quadraticTerms)
+            key.emplace_back(T->firstVariable->index, T->secondVariable->index, T->coefficient);
+
+        auto element = analysedTermsPositions.emplace(std::move(key), analysedTerms.size());
+
+        if(element.second)
+            analysedTerms.push_back(&constraint->quadraticTerms);
+        else
+            equalTerms.emplace_back(&constraint->quadraticTerms, element.first->second);
+    }
+
+    int numberOfThreads = env->settings->getSetting<int>("Convexity.Quadratics.NumberOfThreads", "Model");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    numberOfThreads = std::max(1, std::min(numberOfThreads, (int)analysedTerms.size()));
+
+    // The eigenvalue decompositions only use the terms themselves
+    std::atomic<size_t> nextTerms(0);
+
+    auto analyseTerms = [&]() {
+        for(size_t k = nextTerms++; k < analysedTerms.size(); k = nextTerms++)
+            analysedTerms[k]->getConvexity();
+    };
+
+    if(numberOfThreads == 1)
+    {
+        analyseTerms();
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+            threads.emplace_back(analyseTerms);
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    for(auto& [terms, position] : equalTerms)
+        terms->copyConvexity(*analysedTerms[position]);
+
+    env->output->outputTrace(fmt::format("  Analysed {} quadratic terms, {} were equal to earlier terms",
+        analysedTerms.size() + equalTerms.size(), equalTerms.size()));
+}
+
+void Problem::updateConvexityBySampling()
+{
+    struct SampledFunction
+    {
+        std::function<double(const VectorDouble&)> calculate;
+        Variables variables;
+        E_Convexity convexity = E_Convexity::Unknown;
+    };
+
+    std::vector<SampledFunction> functions;
+    std::vector<NumericConstraint*> sampledConstraints;
+
+    // The gradient sparsity patterns are created here, since they are not created in a thread safe way
+    for(auto& C : numericConstraints)
+    {
+        if(C->properties.convexity != E_Convexity::Unknown)
+            continue;
+
+        auto constraint = C.get();
+        auto calculate
+            = [constraint](const VectorDouble& point) { return (constraint->calculateFunctionValue(point)); };
+
+        functions.push_back({ calculate, *C->getGradientSparsityPattern() });
+        sampledConstraints.push_back(constraint);
+    }
+
+    bool isObjectiveSampled = (objectiveFunction->properties.convexity == E_Convexity::Unknown);
+
+    if(isObjectiveSampled)
+    {
+        auto objective = objectiveFunction.get();
+        auto calculate = [objective](const VectorDouble& point) { return (objective->calculateValue(point)); };
+
+        functions.push_back({ calculate, *objectiveFunction->getGradientSparsityPattern() });
+    }
+
+    if(functions.size() == 0)
+        return;
+
+    // Enough pairs to find a violation with the given confidence if it is shown by at least one percent of the pairs
+    double confidence = env->settings->getSetting<double>("Convexity.Sampling.Confidence", "Model");
+    int numberOfSamples = (int)std::ceil(std::log(1.0 - confidence) / std::log(0.99));
+
+    double tolerance = env->settings->getSetting<double>("Convexity.Sampling.Tolerance", "Model");
+
+    // The sampled interval of an unbounded variable
+    const double unboundedRange = 100.0;
+
+    // The step relative to the distance between the points for the second directional derivative
+    const double step = 1e-2;
+
+    auto sampleConvexity = [&](SampledFunction& function, unsigned int seed) {
+        std::mt19937 generator(seed);
+
+        std::vector<std::uniform_real_distribution<double>> distributions;
+        distributions.reserve(function.variables.size());
+
+        for(auto& V : function.variables)
+        {
+            double lowerBound = V->lowerBound;
+            double upperBound = V->upperBound;
+
+            bool hasLowerBound = (lowerBound > -1e10);
+            bool hasUpperBound = (upperBound < 1e10);
+
+            if(!hasLowerBound && !hasUpperBound)
+            {
+                lowerBound = -unboundedRange;
+                upperBound = unboundedRange;
+            }
+            else if(!hasLowerBound)
+            {
+                lowerBound = upperBound - 2 * unboundedRange;
+            }
+            else if(!hasUpperBound)
+            {
+                upperBound = lowerBound + 2 * unboundedRange;
+            }
+
+            distributions.emplace_back(lowerBound, upperBound);
+        }
+
+        // The variables not in the function are zero in all points
+        VectorDouble first(allVariables.size(), 0.0);
+        VectorDouble second(allVariables.size(), 0.0);
+        VectorDouble midpoint(allVariables.size(), 0.0);
+        VectorDouble forward(allVariables.size(), 0.0);
+        VectorDouble backward(allVariables.size(), 0.0);
+
+        bool canBeConvex = true;
+        bool canBeConcave = true;
+        int numberOfValidSamples = 0;
+
+        for(int s = 0; s < numberOfSamples && (canBeConvex || canBeConcave); s++)
+        {
+            for(size_t i = 0; i < function.variables.size(); i++)
+            {
+                int index = function.variables[i]->index;
+
+                first[index] = distributions[i](generator);
+                second[index] = distributions[i](generator);
+                midpoint[index] = 0.5 * (first[index] + second[index]);
+                forward[index] = midpoint[index] + step * (second[index] - midpoint[index]);
+                backward[index] = midpoint[index] - step * (second[index] - midpoint[index]);
+            }
+
+            double firstValue = function.calculate(first);
+            double secondValue = function.calculate(second);
+            double midpointValue = function.calculate(midpoint);
+            double forwardValue = function.calculate(forward);
+            double backwardValue = function.calculate(backward);
+
+            // The points may be outside the domain of the function
+            if(!std::isfinite(firstValue) || !std::isfinite(secondValue) || !std::isfinite(midpointValue)
+                || !std::isfinite(forwardValue) || !std::isfinite(backwardValue))
+                continue;
+
+            numberOfValidSamples++;
+
+            double midpointDifference = midpointValue - 0.5 * (firstValue + secondValue);
+            double midpointTolerance = tolerance * (1.0 + std::abs(firstValue) + std::abs(secondValue));
+
+            double secondDifference = forwardValue + backwardValue - 2 * midpointValue;
+            double secondDifferenceTolerance = tolerance * (1.0 + std::abs(midpointValue));
+
+            if(midpointDifference > midpointTolerance || secondDifference < -secondDifferenceTolerance)
+                canBeConvex = false;
+
+            if(midpointDifference < -midpointTolerance || secondDifference > secondDifferenceTolerance)
+                canBeConcave = false;
+        }
+
+        if(!canBeConvex && !canBeConcave)
+            function.convexity = E_Convexity::Nonconvex;
+        else if(2 * numberOfValidSamples < numberOfSamples)
+            function.convexity = E_Convexity::Unknown; // Mostly outside the domain
+        else if(canBeConvex)
+            function.convexity = E_Convexity::Convex;
+        else
+            function.convexity = E_Convexity::Concave;
+    };
+
+    int numberOfThreads = env->settings->getSetting<int>("Convexity.Sampling.NumberOfThreads", "Model");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    numberOfThreads = std::max(1, std::min(numberOfThreads, (int)functions.size()));
+
+    // The functions are only evaluated, and the seeds do not depend on the threads
+    std::atomic<size_t> nextFunction(0);
+
+    auto sampleFunctions = [&]() {
+        for(size_t k = nextFunction++; k < functions.size(); k = nextFunction++)
+            sampleConvexity(functions[k], (unsigned int)k);
+    };
+
+    if(numberOfThreads == 1)
+    {
+        sampleFunctions();
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+            threads.emplace_back(sampleFunctions);
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    int numberOfConvex = 0;
+    int numberOfConcave = 0;
+    int numberOfNonconvex = 0;
+
+    for(size_t k = 0; k < functions.size(); k++)
+    {
+        auto convexity = functions[k].convexity;
+
+        if(convexity == E_Convexity::Convex)
+            numberOfConvex++;
+        else if(convexity == E_Convexity::Concave)
+            numberOfConcave++;
+        else if(convexity == E_Convexity::Nonconvex)
+            numberOfNonconvex++;
+
+        bool isFromSampling = (convexity == E_Convexity::Convex || convexity == E_Convexity::Concave);
+
+        if(k < sampledConstraints.size())
+        {
+            sampledConstraints[k]->properties.convexity = convexity;
+            sampledConstraints[k]->properties.isConvexityFromSampling = isFromSampling;
+        }
+        else
+        {
+            objectiveFunction->properties.convexity = convexity;
+            objectiveFunction->properties.isConvexityFromSampling = isFromSampling;
+        }
+    }
+
+    env->output->outputDebug(fmt::format(" Sampled {} functions with unknown convexity using {} point pairs: {} "
+                                         "convex, {} concave and {} nonconvex.",
+        functions.size(), numberOfSamples, numberOfConvex, numberOfConcave, numberOfNonconvex));
 }
 
 void Problem::updateConvexity()
 {
     bool assumeConvex = env->settings->getSetting<bool>("Convexity.AssumeConvex", "Model");
 
+    if(!assumeConvex && env->settings->getSetting<bool>("Convexity.Sampling.Use", "Model"))
+        updateConvexityBySampling();
+
     if(assumeConvex && objectiveFunction->properties.convexity != E_Convexity::Linear)
         objectiveFunction->properties.convexity
             = (objectiveFunction->properties.isMinimize) ? E_Convexity::Convex : E_Convexity::Concave;
@@ -332,7 +703,8 @@ void Problem::updateConvexity()
         {
             for(auto& C : quadraticConstraints)
             {
-                if(C->properties.convexity != E_Convexity::Linear && C->properties.convexity != E_Convexity::Convex)
+                if(C->properties.convexity != E_Convexity::Linear && C->properties.convexity != E_Convexity::Convex
+                    && !C->properties.isSecondOrderCone)
                 {
                     properties.convexity = E_ProblemConvexity::Nonconvex;
                     break;
@@ -368,6 +740,12 @@ void Problem::updateVariableBounds()
     if(variableBounds.size() != numVariables)
         variableBounds.resize(numVariables);
 
+    if(variableTypes.size() != numVariables)
+        variableTypes.resize(numVariables);
+
+    if(variableSemiBounds.size() != numVariables)
+        variableSemiBounds.resize(numVariables);
+
     for(size_t i = 0; i < numVariables; i++)
     {
         if(allVariables[i]->properties.type == E_VariableType::Integer && allVariables[i]->lowerBound > -1
@@ -381,13 +759,15 @@ void Problem::updateVariableBounds()
         variableLowerBounds[i] = allVariables[i]->lowerBound;
         variableUpperBounds[i] = allVariables[i]->upperBound;
         variableBounds[i] = Interval(variableLowerBounds[i], variableUpperBounds[i]);
+        variableTypes[i] = allVariables[i]->properties.type;
+        variableSemiBounds[i] = allVariables[i]->semiBound;
     }
+
+    isIntervalScreeningUpdated = false;
 }
 
 void Problem::updateVariables()
 {
-    allVariables.sortByIndex();
-    allVariables.sortByIndex();
     allVariables.sortByIndex();
     realVariables.sortByIndex();
     binaryVariables.sortByIndex();
@@ -769,6 +1149,21 @@ void Problem::updateFactorableFunctions()
     if(properties.numberOfVariablesInNonlinearExpressions == 0)
         return;
 
+    setupCppADThreads();
+
+    {
+        // The thread copies are created and the Hessian calculation is initialized under the same lock
+        std::lock_guard<std::mutex> lock(cppADThreadMutex);
+
+        ADFunctionCopies.clear();
+        ADFunctionCopies.resize(CPPAD_MAX_NUM_THREADS);
+
+        constraintJacobianWorkspaces.clear();
+        constraintJacobianWorkspaces.resize(CPPAD_MAX_NUM_THREADS);
+
+        lagrangianHessianCalculationInitialized.store(false, std::memory_order_release);
+    }
+
     int nonlinearVariableCounter = 0;
 
     factorableFunctionVariables = std::vector<CppAD::AD<double>>(properties.numberOfVariablesInNonlinearExpressions);
@@ -786,13 +1181,16 @@ void Problem::updateFactorableFunctions()
 
     CppAD::Independent(factorableFunctionVariables);
 
+    // The subexpressions shared between the nonlinear expressions are recorded once
+    auto cacheScope = std::make_unique<FactorableFunctionCacheScope>();
+
     int nonlinearExpressionCounter = 0;
 
     for(auto& C : nonlinearConstraints)
     {
         if(C->properties.hasNonlinearExpression && C->variablesInNonlinearExpression.size() > 0)
         {
-            factorableFunctions.push_back(C->nonlinearExpression->getFactorableFunction());
+            factorableFunctions.push_back(getSharedFactorableFunction(C->nonlinearExpression));
             constraintsWithNonlinearExpressions.push_back(C);
             C->nonlinearExpressionIndex = nonlinearExpressionCounter;
             nonlinearExpressionCounter++;
@@ -807,18 +1205,175 @@ void Problem::updateFactorableFunctions()
         auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objectiveFunction);
 
         objective->updateFactorableFunction();
-        factorableFunctions.push_back(objective->nonlinearExpression->getFactorableFunction());
+        factorableFunctions.push_back(getSharedFactorableFunction(objective->nonlinearExpression));
 
         objective->nonlinearExpressionIndex = nonlinearExpressionCounter;
     }
 
+    cacheScope.reset();
+
     if(factorableFunctions.size() > 0)
     {
         ADFunctions.Dependent(factorableFunctionVariables, factorableFunctions);
         // ADFunctions.optimize();
+
+        // All variables in an expression are considered to be nonzero in the Jacobian
+        size_t numberOfNonzeros = 0;
+
+        for(auto& C : constraintsWithNonlinearExpressions)
+            numberOfNonzeros += C->variablesInNonlinearExpression.size();
+
+        nonlinearJacobianSparsityPattern.resize(ADFunctions.Range(), ADFunctions.Domain(), numberOfNonzeros);
+
+        size_t nonzero = 0;
+
+        for(auto& C : constraintsWithNonlinearExpressions)
+        {
+            for(auto& V : C->variablesInNonlinearExpression)
+            {
+                nonlinearJacobianSparsityPattern.set(
+                    nonzero, C->nonlinearExpressionIndex, V->properties.nonlinearVariableIndex);
+                nonzero++;
+            }
+        }
     }
 
     CppAD::AD<double>::abort_recording();
+
+    // The constraints are recorded when their gradients are first calculated, so constraints that are only evaluated
+    // are never recorded
+    if(env->settings->getSetting<bool>("NonlinearExpressions.RecordConstraintsSeparately", "Model"))
+    {
+        for(auto& C : nonlinearConstraints)
+        {
+            if(C->properties.hasNonlinearExpression && C->variablesInNonlinearExpression.size() > 0)
+                C->enableNonlinearExpressionADFunction();
+        }
+    }
+}
+
+CppAD::ADFun<double>& Problem::getADFunctions()
+{
+    if(ADFunctionCopies.empty()) // No nonlinear expressions
+        return (ADFunctions);
+
+    return (getThreadCopy(ADFunctions, ADFunctionCopies));
+}
+
+std::unique_lock<std::recursive_mutex> Problem::lockCppADEvaluation()
+{
+    if(getCppADThreadNumber() == sharedCppADThreadNumber)
+        return (std::unique_lock<std::recursive_mutex>(sharedCppADThreadNumberMutex));
+
+    return (std::unique_lock<std::recursive_mutex>());
+}
+
+CppAD::ADFun<double>& Problem::getThreadCopy(
+    CppAD::ADFun<double>& function, std::vector<std::unique_ptr<CppAD::ADFun<double>>>& copies)
+{
+    auto& copy = copies[getCppADThreadNumber()];
+
+    if(!copy)
+    {
+        // Other threads may be copying the function at the same time
+        std::lock_guard<std::mutex> lock(cppADThreadMutex);
+
+        copy = std::make_unique<CppAD::ADFun<double>>();
+        *copy = function;
+    }
+
+    return (*copy);
+}
+
+size_t Problem::getRecordingMemoryUsage(
+    const CppAD::ADFun<double>& function, const std::vector<std::unique_ptr<CppAD::ADFun<double>>>& copies)
+{
+    std::lock_guard<std::mutex> lock(cppADThreadMutex);
+
+    size_t numberOfCopies = std::count_if(copies.begin(), copies.end(), [](auto& F) { return (F != nullptr); });
+
+    return ((1 + numberOfCopies) * function.size_op_seq());
+}
+
+size_t Problem::getADFunctionsMemoryUsage() const { return (getRecordingMemoryUsage(ADFunctions, ADFunctionCopies)); }
+
+void Problem::updateExpressionTapes()
+{
+    int numberOfCompiledTapes = 0;
+
+    bool useTapeForGradients = env->settings->getSetting<bool>("NonlinearExpressions.UseTapeForGradients", "Model");
+    bool useTapeForHessians = env->settings->getSetting<bool>("NonlinearExpressions.UseTapeForHessians", "Model");
+
+    for(auto& C : nonlinearConstraints)
+    {
+        C->nonlinearExpressionTape.reset();
+        C->useTapeForGradient = false;
+        C->useTapeForHessian = false;
+
+        if(!C->properties.hasNonlinearExpression || !C->nonlinearExpression)
+            continue;
+
+        auto tape = std::make_shared<ExpressionTape>();
+
+        if(tape->compile(C->nonlinearExpression))
+        {
+            C->nonlinearExpressionTape = tape;
+            numberOfCompiledTapes++;
+        }
+        else
+        {
+            continue;
+        }
+
+        // The derivatives are given in the order of variablesInNonlinearExpression
+        if(tape->getVariableIndexes().size() == C->variablesInNonlinearExpression.size()
+            && std::equal(C->variablesInNonlinearExpression.begin(), C->variablesInNonlinearExpression.end(),
+                tape->getVariableIndexes().begin(),
+                [](const VariablePtr& variable, int index) { return (variable->index == index); }))
+        {
+            C->useTapeForGradient = useTapeForGradients;
+            C->useTapeForHessian = useTapeForHessians;
+        }
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objectiveFunction))
+    {
+        objective->nonlinearExpressionTape.reset();
+
+        if(objective->properties.hasNonlinearExpression && objective->nonlinearExpression)
+        {
+            auto tape = std::make_shared<ExpressionTape>();
+
+            if(tape->compile(objective->nonlinearExpression))
+            {
+                objective->nonlinearExpressionTape = tape;
+                numberOfCompiledTapes++;
+            }
+        }
+    }
+
+    env->output->outputTrace(
+        fmt::format(" Compiled {} nonlinear expressions into evaluation tapes", numberOfCompiledTapes));
+}
+
+void Problem::shareCommonSubexpressions()
+{
+    CommonSubexpressionTable table;
+
+    for(auto& C : nonlinearConstraints)
+    {
+        if(C->properties.hasNonlinearExpression && C->nonlinearExpression)
+            C->nonlinearExpression = table.share(C->nonlinearExpression);
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objectiveFunction))
+    {
+        if(objective->properties.hasNonlinearExpression && objective->nonlinearExpression)
+            objective->nonlinearExpression = table.share(objective->nonlinearExpression);
+    }
+
+    env->output->outputTrace(fmt::format(
+        " Shared {} common subexpressions in the nonlinear expressions", table.getNumberOfSharedExpressions()));
 }
 
 Problem::Problem(EnvironmentPtr env) : env(env) { }
@@ -850,15 +1405,51 @@ Problem::~Problem()
 
 void Problem::finalize()
 {
+    useCompactTermStorage = env->settings->getSetting<bool>("CompactTermStorage.Use", "Model");
+
     updateProperties();
+
+    if(env->settings->getSetting<bool>("ConstraintReordering.Use", "Model"))
+        reorderConstraints();
+
+    if(env->settings->getSetting<bool>("NonlinearExpressions.ShareCommonSubexpressions", "Model"))
+        shareCommonSubexpressions();
+
     updateFactorableFunctions();
-    assert(verifyOwnership());
 
-    if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
-        getConstraintsJacobianSparsityPattern();
+    if(env->settings->getSetting<bool>("NonlinearExpressions.UseTape", "Model"))
+        updateExpressionTapes();
 
-    if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
-        getLagrangianHessianSparsityPattern();
+    useSinglePrecisionScreening
+        = env->settings->getSetting<bool>("NonlinearExpressions.SinglePrecisionScreening", "Model")
+        && std::all_of(nonlinearConstraints.begin(), nonlinearConstraints.end(),
+            [](const NonlinearConstraintPtr& C) {
+                return (!C->properties.hasNonlinearExpression || C->nonlinearExpressionTape);
+            });
+
+    batchedEvaluationNumberOfThreads
+        = env->settings->getSetting<int>("NonlinearExpressions.BatchedEvaluation.NumberOfThreads", "Model");
+
+    batchedEvaluationNumberOfThreads
+        = ThreadPlacement::getNumberOfThreads(env->settings, batchedEvaluationNumberOfThreads);
+
+    singlePrecisionScreeningTolerance
+        = env->settings->getSetting<double>("NonlinearExpressions.SinglePrecisionScreening.Tolerance", "Model");
+
+    useIntervalScreening = env->settings->getSetting<bool>("NonlinearExpressions.IntervalScreening", "Model");
+    isIntervalScreeningUpdated = false;
+
+    if(properties.isReformulated)
+        updateAuxiliaryVariableLevels();
+
+    useEvaluationCache = env->settings->getSetting<bool>("EvaluationCache.Use", "Model");
+    evaluationCache.maxNumberOfPoints = env->settings->getSetting<int>("EvaluationCache.MaxPoints", "Model");
+    evaluationCache.clear();
+
+    assert(verifyOwnership());
+
+    updateSparsityPatterns();
+    updateLinearConstraintMatrix();
 }
 
 void Problem::add(Variables variables)
@@ -1138,12 +1729,14 @@ AuxiliaryVariables Problem::getAuxiliaryVariablesOfType(E_AuxiliaryVariableType
 void Problem::setVariableLowerBound(int variableIndex, double bound)
 {
     allVariables.at(variableIndex)->lowerBound = bound;
+    synchronizeVariableBounds(variableIndex);
     variablesUpdated = true;
 }
 
 void Problem::setVariableUpperBound(int variableIndex, double bound)
 {
     allVariables.at(variableIndex)->upperBound = bound;
+    synchronizeVariableBounds(variableIndex);
     variablesUpdated = true;
 }
 
@@ -1151,11 +1744,65 @@ void Problem::setVariableBounds(int variableIndex, double lowerBound, double upp
 {
     allVariables.at(variableIndex)->lowerBound = lowerBound;
     allVariables.at(variableIndex)->upperBound = upperBound;
+    synchronizeVariableBounds(variableIndex);
     variablesUpdated = true;
 }
 
-std::shared_ptr<std::vector<std::pair<NumericConstraintPtr, Variables>>>
-    Problem::getConstraintsJacobianSparsityPattern()
+void Problem::synchronizeVariableBounds(int variableIndex)
+{
+    // The vectors are created when the problem is finalized
+    if(variableIndex < 0 || variableIndex >= (int)variableLowerBounds.size()
+        || variableIndex >= (int)variableUpperBounds.size() || variableIndex >= (int)variableBounds.size())
+        return;
+
+    auto& variable = allVariables[variableIndex];
+
+    variableLowerBounds[variableIndex] = variable->lowerBound;
+    variableUpperBounds[variableIndex] = variable->upperBound;
+    variableBounds[variableIndex] = Interval(variable->lowerBound, variable->upperBound);
+
+    isIntervalScreeningUpdated = false;
+}
+
+bool Problem::projectToVariableBounds(VectorDouble& point)
+{
+    if(variableTypes.size() != allVariables.size())
+        updateVariableBounds();
+
+    bool isFulfilled = true;
+    size_t numberOfValues = std::min(point.size(), variableTypes.size());
+
+    for(size_t i = 0; i < numberOfValues; i++)
+    {
+        bool isAboveUpperBound = point[i] > variableUpperBounds[i];
+
+        if(!isAboveUpperBound && !(point[i] < variableLowerBounds[i]))
+            continue;
+
+        switch(variableTypes[i])
+        {
+        case E_VariableType::Real:
+            point[i] = isAboveUpperBound ? variableUpperBounds[i] : variableLowerBounds[i];
+            break;
+        case E_VariableType::Binary:
+            point[i] = isAboveUpperBound ? 1.0 : 0.0;
+            break;
+        case E_VariableType::Integer:
+            point[i] = isAboveUpperBound ? std::round(variableUpperBounds[i] - 0.5)
+                                         : std::round(variableLowerBounds[i] + 0.5);
+            break;
+        default:
+            continue;
+        }
+
+        isFulfilled = false;
+    }
+
+    return (isFulfilled);
+}
+
+std::shared_ptr<std::vector<std::pair<NumericConstraintPtr, Variables>>>
+    Problem::getConstraintsJacobianSparsityPattern()
 {
     if(constraintGradientSparsityPattern)
     {
@@ -1192,7 +1839,7 @@ std::shared_ptr<std::vector<std::pair<NumericConstraintPtr, Variables>>>
                 stream << "\t " << V->name << '\n';
         }
 
-        Utilities::writeStringToFile(filename.str(), stream.str());
+        env->debugWriter->write(filename.str(), stream.str());
     }
 
     return (constraintGradientSparsityPattern);
@@ -1283,7 +1930,7 @@ std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> Problem::getLa
             stream << P.first->name << "\t" << P.second->name << '\n';
         }
 
-        Utilities::writeStringToFile(filename.str(), stream.str());
+        env->debugWriter->write(filename.str(), stream.str());
     }
 
     // Sorts the elements
@@ -1304,6 +1951,417 @@ std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> Problem::getLa
     return (lagrangianHessianSparsityPattern);
 }
 
+void Problem::updateSparsityPatterns()
+{
+    jacobianSparsityPatternCSR.clear();
+    lagrangianHessianSparsityPatternCSR.clear();
+
+    auto jacobianPattern = getConstraintsJacobianSparsityPattern();
+
+    size_t numberOfNonzeros = 0;
+
+    for(auto& P : *jacobianPattern)
+        numberOfNonzeros += P.second.size();
+
+    jacobianSparsityPatternCSR.rowStarts.reserve(jacobianPattern->size() + 1);
+    jacobianSparsityPatternCSR.columns.reserve(numberOfNonzeros);
+
+    for(auto& P : *jacobianPattern)
+    {
+        for(auto& V : P.second)
+            jacobianSparsityPatternCSR.columns.push_back(V->index);
+
+        jacobianSparsityPatternCSR.rowStarts.push_back(jacobianSparsityPatternCSR.columns.size());
+    }
+
+    // The elements are sorted on the first and then the second variable index, so the rows are the first indexes
+    auto hessianPattern = getLagrangianHessianSparsityPattern();
+
+    lagrangianHessianSparsityPatternCSR.rowStarts.assign(allVariables.size() + 1, 0);
+    lagrangianHessianSparsityPatternCSR.columns.reserve(hessianPattern->size());
+
+    for(auto& E : *hessianPattern)
+    {
+        assert(E.first->index <= E.second->index);
+
+        lagrangianHessianSparsityPatternCSR.rowStarts[E.first->index + 1]++;
+        lagrangianHessianSparsityPatternCSR.columns.push_back(E.second->index);
+    }
+
+    for(size_t i = 0; i < allVariables.size(); i++)
+        lagrangianHessianSparsityPatternCSR.rowStarts[i + 1] += lagrangianHessianSparsityPatternCSR.rowStarts[i];
+}
+
+void Problem::initializeLagrangianHessianCalculation()
+{
+    auto pattern = getLagrangianHessianSparsityPattern();
+
+    lagrangianHessianPositions.clear();
+
+    for(size_t i = 0; i < pattern->size(); i++)
+    {
+        lagrangianHessianPositions.emplace(
+            std::make_pair(pattern->at(i).first->index, pattern->at(i).second->index), i);
+    }
+
+    lagrangianHessianWorkspaces.clear();
+    lagrangianHessianWorkspaces.resize(CPPAD_MAX_NUM_THREADS);
+
+    nonlinearLagrangianHessianSparsityPattern = CppAD::sparse_rc<std::vector<size_t>>();
+    nonlinearLagrangianHessianSubset = CppAD::sparse_rc<std::vector<size_t>>();
+    nonlinearLagrangianHessianPositions.clear();
+
+    if(properties.numberOfNonlinearExpressions > 0)
+    {
+        auto nonlinearVariablesMap = std::vector<bool>(properties.numberOfVariablesInNonlinearExpressions, true);
+        auto nonlinearFunctionMap = std::vector<bool>(properties.numberOfNonlinearExpressions, true);
+
+        ADFunctions.for_hes_sparsity(
+            nonlinearVariablesMap, nonlinearFunctionMap, false, nonlinearLagrangianHessianSparsityPattern);
+
+        const std::vector<size_t>& rowIndices(nonlinearLagrangianHessianSparsityPattern.row());
+        const std::vector<size_t>& colIndices(nonlinearLagrangianHessianSparsityPattern.col());
+
+        std::vector<std::pair<size_t, size_t>> subsetElements;
+
+        for(size_t k = 0; k < nonlinearLagrangianHessianSparsityPattern.nnz(); k++)
+        {
+            int firstIndex = nonlinearExpressionVariables[rowIndices[k]]->index;
+            int secondIndex = nonlinearExpressionVariables[colIndices[k]]->index;
+
+            // Only the elements above the diagonal since the Hessian is symmetric
+            if(firstIndex > secondIndex)
+                continue;
+
+            auto position = lagrangianHessianPositions.find(std::make_pair(firstIndex, secondIndex));
+
+            if(position == lagrangianHessianPositions.end())
+                continue;
+
+            subsetElements.emplace_back(rowIndices[k], colIndices[k]);
+            nonlinearLagrangianHessianPositions.push_back(position->second);
+        }
+
+        nonlinearLagrangianHessianSubset.resize(properties.numberOfVariablesInNonlinearExpressions,
+            properties.numberOfVariablesInNonlinearExpressions, subsetElements.size());
+
+        for(size_t k = 0; k < subsetElements.size(); k++)
+            nonlinearLagrangianHessianSubset.set(k, subsetElements[k].first, subsetElements[k].second);
+    }
+
+    lagrangianHessianCalculationInitialized.store(true, std::memory_order_release);
+}
+
+void Problem::calculateLagrangianHessian(
+    const VectorDouble& point, double objectiveFactor, const double* multipliers, double* values)
+{
+    if(!lagrangianHessianCalculationInitialized.load(std::memory_order_acquire))
+    {
+        // Other threads may be copying the recording at the same time
+        std::lock_guard<std::mutex> lock(cppADThreadMutex);
+
+        if(!lagrangianHessianCalculationInitialized.load(std::memory_order_relaxed))
+            initializeLagrangianHessianCalculation();
+    }
+
+    std::fill(values, values + lagrangianHessianPositions.size(), 0.0);
+
+    auto addHessian = [&](const SparseVariableMatrix& hessian, double factor) {
+        for(auto& E : hessian)
+        {
+            auto position
+                = lagrangianHessianPositions.find(std::make_pair(E.first.first->index, E.first.second->index));
+
+            assert(position != lagrangianHessianPositions.end());
+
+            if(position != lagrangianHessianPositions.end())
+                values[position->second] += factor * E.second;
+        }
+    };
+
+    // The terms that are not part of the nonlinear expressions
+    if(objectiveFactor != 0.0)
+    {
+        if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objectiveFunction))
+            addHessian(objective->calculateHessian(point, false, false), objectiveFactor);
+        else
+            addHessian(objectiveFunction->calculateHessian(point, false), objectiveFactor);
+    }
+
+    for(auto& C : numericConstraints)
+    {
+        if(C->properties.classification == E_ConstraintClassification::Linear)
+            continue;
+
+        if(multipliers[C->index] == 0.0)
+            continue;
+
+        // The Hessians calculated on the tapes include the nonlinear expressions
+        if(auto constraint = std::dynamic_pointer_cast<NonlinearConstraint>(C))
+            addHessian(constraint->calculateHessian(point, false, constraint->useTapeForHessian),
+                multipliers[C->index]);
+        else
+            addHessian(C->calculateHessian(point, false), multipliers[C->index]);
+    }
+
+    if(nonlinearLagrangianHessianSubset.nnz() == 0)
+        return;
+
+    auto cppADLock = lockCppADEvaluation();
+
+    auto& workspace = lagrangianHessianWorkspaces[getCppADThreadNumber()];
+
+    if(!workspace)
+    {
+        workspace = std::make_unique<LagrangianHessianWorkspace>();
+        workspace->subset = CppAD::sparse_rcv<std::vector<size_t>, VectorDouble>(nonlinearLagrangianHessianSubset);
+        workspace->point.resize(properties.numberOfVariablesInNonlinearExpressions);
+        workspace->weights.resize(properties.numberOfNonlinearExpressions);
+    }
+
+    for(auto& V : nonlinearExpressionVariables)
+        workspace->point[V->properties.nonlinearVariableIndex] = point[V->index];
+
+    std::fill(workspace->weights.begin(), workspace->weights.end(), 0.0);
+
+    bool hasNonzeroWeights = false;
+
+    for(auto& C : constraintsWithNonlinearExpressions)
+    {
+        if(C->useTapeForHessian)
+            continue;
+
+        workspace->weights[C->nonlinearExpressionIndex] = multipliers[C->index];
+        hasNonzeroWeights = hasNonzeroWeights || multipliers[C->index] != 0.0;
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objectiveFunction);
+        objective && objective->nonlinearExpressionIndex >= 0)
+    {
+        workspace->weights[objective->nonlinearExpressionIndex] = objectiveFactor;
+        hasNonzeroWeights = hasNonzeroWeights || objectiveFactor != 0.0;
+    }
+
+    // All remaining nonlinear expressions have been differentiated on the tapes
+    if(!hasNonzeroWeights)
+        return;
+
+    getADFunctions().sparse_hes(workspace->point, workspace->weights, workspace->subset,
+        nonlinearLagrangianHessianSparsityPattern, "cppad.symmetric", workspace->work);
+
+    const VectorDouble& hessianValues(workspace->subset.val());
+
+    for(size_t k = 0; k < nonlinearLagrangianHessianPositions.size(); k++)
+        values[nonlinearLagrangianHessianPositions[k]] += hessianValues[k];
+}
+
+std::vector<SparseGradient> Problem::calculateConstraintGradients(
+    const VectorDouble& point, const NumericConstraints& constraints)
+{
+    std::vector<SparseGradient> gradients(constraints.size());
+
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::GradientEvaluations, constraints.size());
+
+    // The constraints whose nonlinear expressions are differentiated using the recording of the whole problem
+    std::vector<std::pair<size_t, NonlinearConstraint*>> expressionConstraints;
+
+    for(size_t i = 0; i < constraints.size(); i++)
+    {
+        if(!constraints[i]->properties.hasNonlinearExpression)
+            continue;
+
+        auto constraint = dynamic_cast<NonlinearConstraint*>(constraints[i].get());
+
+        if(constraint != nullptr && constraint->nonlinearExpressionIndex >= 0
+            && !constraint->hasSeparateNonlinearExpressionDerivatives())
+            expressionConstraints.emplace_back(i, constraint);
+    }
+
+    // A single expression is differentiated faster by the constraint itself
+    if(expressionConstraints.size() < 2)
+        expressionConstraints.clear();
+
+    std::vector<bool> calculateExpressionSeparately(constraints.size(), true);
+
+    for(auto& E : expressionConstraints)
+        calculateExpressionSeparately[E.first] = false;
+
+    for(size_t i = 0; i < constraints.size(); i++)
+        constraints[i]->calculateSparseGradient(point, gradients[i], calculateExpressionSeparately[i]);
+
+    if(expressionConstraints.size() == 0)
+        return (gradients);
+
+    size_t numberOfNonzeros = 0;
+
+    for(auto& E : expressionConstraints)
+        numberOfNonzeros += E.second->variablesInNonlinearExpression.size();
+
+    CppAD::sparse_rc<std::vector<size_t>> subsetPattern(
+        nonlinearJacobianSparsityPattern.nr(), nonlinearJacobianSparsityPattern.nc(), numberOfNonzeros);
+
+    // The constraint index and its gradient position for each nonzero in the subset
+    std::vector<std::pair<size_t, int>> nonzeroPositions(numberOfNonzeros);
+    size_t nonzero = 0;
+
+    for(auto& E : expressionConstraints)
+    {
+        auto& indexes = gradients[E.first].indexes;
+
+        for(auto& V : E.second->variablesInNonlinearExpression)
+        {
+            subsetPattern.set(nonzero, E.second->nonlinearExpressionIndex, V->properties.nonlinearVariableIndex);
+
+            auto position = std::lower_bound(indexes.begin(), indexes.end(), V->index);
+
+            if(position != indexes.end() && *position == V->index)
+                nonzeroPositions[nonzero] = std::make_pair(E.first, (int)(position - indexes.begin()));
+            else
+                nonzeroPositions[nonzero] = std::make_pair(E.first, -1);
+
+            nonzero++;
+        }
+    }
+
+    VectorDouble pointNonlinearSubset(properties.numberOfVariablesInNonlinearExpressions, 0.0);
+
+    for(auto& V : nonlinearExpressionVariables)
+        pointNonlinearSubset[V->properties.nonlinearVariableIndex] = point[V->index];
+
+    CppAD::sparse_rcv<std::vector<size_t>, VectorDouble> subset(subsetPattern);
+
+    auto cppADLock = lockCppADEvaluation();
+
+    auto& function = getADFunctions();
+    auto& workspace = constraintJacobianWorkspaces[getCppADThreadNumber()];
+
+    if(!workspace)
+        workspace = std::make_unique<ConstraintJacobianWorkspace>();
+
+    // The subset only depends on the nonlinear expressions, and the coloring is recalculated when they change
+    VectorInteger nonlinearExpressionIndexes(expressionConstraints.size());
+
+    for(size_t i = 0; i < expressionConstraints.size(); i++)
+        nonlinearExpressionIndexes[i] = expressionConstraints[i].second->nonlinearExpressionIndex;
+
+    if(nonlinearExpressionIndexes != workspace->nonlinearExpressionIndexes)
+    {
+        workspace->work.clear();
+        workspace->nonlinearExpressionIndexes = std::move(nonlinearExpressionIndexes);
+    }
+
+    function.sparse_jac_rev(pointNonlinearSubset, subset, nonlinearJacobianSparsityPattern, "cppad", workspace->work);
+
+    const VectorDouble& values(subset.val());
+
+    for(size_t k = 0; k < subset.nnz(); k++)
+    {
+        if(nonzeroPositions[k].second >= 0)
+            gradients[nonzeroPositions[k].first].values[nonzeroPositions[k].second] += values[k];
+    }
+
+    return (gradients);
+}
+
+double ConstraintEvaluations::calculateFunctionValue(NumericConstraint* constraint)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(auto value = functionValues.find(constraint); value != functionValues.end())
+            return (value->second);
+    }
+
+    // Calculated outside the lock, if two threads calculate the same value both get the same result
+    double value = constraint->calculateFunctionValue(point);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    functionValues.emplace(constraint, value);
+
+    return (value);
+}
+
+void ConstraintEvaluations::calculateSparseGradient(NumericConstraint* constraint, SparseGradient& gradient)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(auto cachedGradient = gradients.find(constraint); cachedGradient != gradients.end())
+        {
+            gradient = cachedGradient->second;
+            return;
+        }
+    }
+
+    constraint->calculateSparseGradient(point, gradient);
+
+    std::lock_guard<std::mutex> lock(mutex);
+    gradients.emplace(constraint, gradient);
+}
+
+ConstraintEvaluationsPtr ConstraintEvaluationCache::get(const VectorDouble& point, uint64_t pointHash)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto range = points.equal_range(pointHash);
+
+    for(auto P = range.first; P != range.second; P++)
+    {
+        if(P->second->point == point)
+            return (P->second);
+    }
+
+    if(points.size() >= maxNumberOfPoints)
+        points.clear();
+
+    auto evaluations = std::make_shared<ConstraintEvaluations>();
+    evaluations->point = point;
+    points.emplace(pointHash, evaluations);
+
+    return (evaluations);
+}
+
+void ConstraintEvaluationCache::clear()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    points.clear();
+}
+
+ConstraintEvaluationsPtr Problem::getConstraintEvaluations(
+    const VectorDouble& point, std::optional<uint64_t> pointHash)
+{
+    if(!useEvaluationCache)
+        return (nullptr);
+
+    return (evaluationCache.get(point, pointHash ? *pointHash : Utilities::calculateHash(point)));
+}
+
+NumericConstraintValue Problem::calculateNumericValue(NumericConstraint* constraint, const VectorDouble& point,
+    const ConstraintEvaluationsPtr& evaluations, double correction)
+{
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::ConstraintEvaluations);
+
+    // Only the uncorrected values are cached
+    if(!evaluations || correction != 0.0)
+        return (constraint->calculateNumericValue(point, correction));
+
+    return (constraint->createNumericValue(evaluations->calculateFunctionValue(constraint)));
+}
+
+void Problem::calculateSparseGradient(NumericConstraint* constraint, const VectorDouble& point,
+    SparseGradient& gradient, const ConstraintEvaluationsPtr& evaluations)
+{
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::GradientEvaluations);
+
+    if(evaluations)
+        evaluations->calculateSparseGradient(constraint, gradient);
+    else
+        constraint->calculateSparseGradient(point, gradient);
+}
+
 std::optional<NumericConstraintValue> Problem::getMostDeviatingNumericConstraint(const VectorDouble& point)
 {
     return (this->getMostDeviatingNumericConstraint(point, numericConstraints));
@@ -1342,12 +2400,14 @@ template <typename T>
 std::optional<NumericConstraintValue> Problem::getMostDeviatingNumericConstraint(
     const VectorDouble& point, std::vector<T> constraintSelection)
 {
+    auto evaluations = getConstraintEvaluations(point);
+
     std::optional<NumericConstraintValue> optional;
     double error = 0;
 
     for(auto& C : constraintSelection)
     {
-        auto constraintValue = C->calculateNumericValue(point);
+        auto constraintValue = calculateNumericValue(C.get(), point, evaluations);
 
         if(constraintValue.isFulfilled)
             continue;
@@ -1373,12 +2433,14 @@ std::optional<NumericConstraintValue> Problem::getMostDeviatingNumericConstraint
 {
     assert(activeConstraints.size() == 0);
 
+    auto evaluations = getConstraintEvaluations(point);
+
     std::optional<NumericConstraintValue> optional;
     double error = -1;
 
     for(auto& C : constraintSelection)
     {
-        auto constraintValue = C->calculateNumericValue(point);
+        auto constraintValue = calculateNumericValue(C.get(), point, evaluations);
 
         if(constraintValue.isFulfilled)
             continue;
@@ -1406,12 +2468,14 @@ std::optional<NumericConstraintValue> Problem::getMostDeviatingNumericConstraint
 {
     assert(activeConstraints.size() == 0);
 
+    auto evaluations = getConstraintEvaluations(point);
+
     std::optional<NumericConstraintValue> optional;
     double error = -1;
 
     for(auto& C : constraintSelection)
     {
-        auto constraintValue = C->calculateNumericValue(point);
+        auto constraintValue = calculateNumericValue(C.get(), point, evaluations);
 
         if(constraintValue.isFulfilled)
             continue;
@@ -1466,11 +2530,13 @@ NumericConstraintValue Problem::getMaxNumericConstraintValue(
 {
     assert(constraintSelection.size() > 0);
 
-    auto value = constraintSelection[0]->calculateNumericValue(point);
+    auto evaluations = getConstraintEvaluations(point);
+
+    auto value = calculateNumericValue(constraintSelection[0].get(), point, evaluations);
 
     for(size_t i = 1; i < constraintSelection.size(); i++)
     {
-        auto tmpValue = constraintSelection[i]->calculateNumericValue(point);
+        auto tmpValue = calculateNumericValue(constraintSelection[i].get(), point, evaluations);
 
         if(tmpValue.normalizedValue > value.normalizedValue)
         {
@@ -1486,11 +2552,13 @@ NumericConstraintValue Problem::getMaxNumericConstraintValue(
 {
     assert(constraintSelection.size() > 0);
 
-    auto value = constraintSelection[0]->calculateNumericValue(point);
+    auto evaluations = getConstraintEvaluations(point);
+
+    auto value = calculateNumericValue(constraintSelection[0].get(), point, evaluations);
 
     for(size_t i = 1; i < constraintSelection.size(); i++)
     {
-        auto tmpValue = constraintSelection[i]->calculateNumericValue(point);
+        auto tmpValue = calculateNumericValue(constraintSelection[i].get(), point, evaluations);
 
         if(tmpValue.normalizedValue > value.normalizedValue)
         {
@@ -1506,11 +2574,13 @@ NumericConstraintValue Problem::getMaxNumericConstraintValue(
 {
     assert(constraintSelection.size() > 0);
 
-    auto value = constraintSelection[0]->calculateNumericValue(point, correction);
+    auto evaluations = getConstraintEvaluations(point);
+
+    auto value = calculateNumericValue(constraintSelection[0].get(), point, evaluations, correction);
 
     for(size_t i = 1; i < constraintSelection.size(); i++)
     {
-        auto tmpValue = constraintSelection[i]->calculateNumericValue(point, correction);
+        auto tmpValue = calculateNumericValue(constraintSelection[i].get(), point, evaluations, correction);
 
         if(tmpValue.normalizedValue > value.normalizedValue)
         {
@@ -1526,11 +2596,13 @@ NumericConstraintValue Problem::getMaxNumericConstraintValue(
 {
     assert(constraintSelection.size() > 0);
 
-    auto value = constraintSelection[0]->calculateNumericValue(point);
+    auto evaluations = getConstraintEvaluations(point);
+
+    auto value = calculateNumericValue(constraintSelection[0].get(), point, evaluations);
 
     for(size_t i = 1; i < constraintSelection.size(); i++)
     {
-        auto tmpValue = constraintSelection[i]->calculateNumericValue(point);
+        auto tmpValue = calculateNumericValue(constraintSelection[i].get(), point, evaluations);
 
         if(tmpValue.normalizedValue > value.normalizedValue)
         {
@@ -1547,14 +2619,16 @@ NumericConstraintValue Problem::getMaxNumericConstraintValue(const VectorDouble&
     assert(activeConstraints.size() == 0);
     assert(constraintSelection.size() > 0);
 
-    auto value = constraintSelection[0]->calculateNumericValue(point);
+    auto evaluations = getConstraintEvaluations(point);
+
+    auto value = calculateNumericValue(constraintSelection[0], point, evaluations);
 
     if(value.normalizedValue > 0)
         activeConstraints.push_back(constraintSelection[0]);
 
     for(size_t i = 1; i < constraintSelection.size(); i++)
     {
-        auto tmpValue = constraintSelection[i]->calculateNumericValue(point);
+        auto tmpValue = calculateNumericValue(constraintSelection[i], point, evaluations);
 
         if(tmpValue.normalizedValue > value.normalizedValue)
         {
@@ -1568,36 +2642,251 @@ NumericConstraintValue Problem::getMaxNumericConstraintValue(const VectorDouble&
     return value;
 }
 
-template <typename T>
-NumericConstraintValues Problem::getAllDeviatingConstraints(
-    const VectorDouble& point, double tolerance, std::vector<T> constraintSelection, double correction)
+void Problem::updateLinearConstraintMatrix()
 {
-    NumericConstraintValues constraintValues;
-    for(auto& C : constraintSelection)
+    linearConstraintMatrix.clear();
+
+    if(useCompactTermStorage)
     {
-        NumericConstraintValue constraintValue = C->calculateNumericValue(point, correction);
-        if(constraintValue.normalizedValue > tolerance)
-            constraintValues.push_back(constraintValue);
+        linearConstraintMatrix.pattern.rowStarts.shrink_to_fit();
+        linearConstraintMatrix.pattern.columns.shrink_to_fit();
+        linearConstraintMatrix.coefficients.shrink_to_fit();
+        return;
     }
 
-    return constraintValues;
-}
-
-NumericConstraintValues Problem::getFractionOfDeviatingNonlinearConstraints(
-    const VectorDouble& point, double tolerance, double fraction, double correction)
-{
-    if(fraction > 1)
-        fraction = 1;
-    else if(fraction < 0)
-        fraction = 0;
-
-    int fractionNumbers = std::max(1, (int)ceil(fraction * this->nonlinearConstraints.size()));
+    size_t numberOfNonzeros = 0;
 
-    auto values = getAllDeviatingConstraints(point, tolerance, this->nonlinearConstraints, correction);
+    for(auto& C : linearConstraints)
+        numberOfNonzeros += C->linearTerms.size();
 
-    std::sort(values.begin(), values.end(), std::greater<NumericConstraintValue>());
+    linearConstraintMatrix.pattern.rowStarts.reserve(linearConstraints.size() + 1);
+    linearConstraintMatrix.pattern.columns.reserve(numberOfNonzeros);
+    linearConstraintMatrix.coefficients.reserve(numberOfNonzeros);
 
-    if((int)values.size() <= fractionNumbers) // Not enough elements to need truncating
+    for(auto& C : linearConstraints)
+    {
+        for(auto& T : C->linearTerms)
+        {
+            linearConstraintMatrix.pattern.columns.push_back(T->variable->index);
+            linearConstraintMatrix.coefficients.push_back(T->coefficient);
+        }
+
+        linearConstraintMatrix.pattern.rowStarts.push_back(linearConstraintMatrix.pattern.columns.size());
+    }
+}
+
+// Returns the constraints in reverse Cuthill-McKee order of the graph where two constraints are adjacent if they
+// share a variable. Each variable is expanded once, i.e. all its constraints are added when it is first reached, so
+// that the time is linear in the number of nonzeros also if some variables are in many constraints.
+template <typename T>
+static std::vector<std::shared_ptr<T>> getReverseCuthillMcKeeOrder(
+    const std::vector<std::shared_ptr<T>>& constraints, size_t numberOfVariables)
+{
+    size_t numberOfConstraints = constraints.size();
+
+    std::vector<std::vector<int>> constraintVariables(numberOfConstraints);
+    std::vector<std::vector<size_t>> variableConstraints(numberOfVariables);
+
+    for(size_t i = 0; i < numberOfConstraints; i++)
+    {
+        for(auto& V : *constraints[i]->getGradientSparsityPattern())
+        {
+            constraintVariables[i].push_back(V->index);
+            variableConstraints[V->index].push_back(i);
+        }
+    }
+
+    // The number of other constraints sharing a variable, counted with multiplicity
+    std::vector<size_t> degrees(numberOfConstraints, 0);
+
+    for(size_t i = 0; i < numberOfConstraints; i++)
+    {
+        for(auto V : constraintVariables[i])
+            degrees[i] += variableConstraints[V].size() - 1;
+    }
+
+    // The searches are started in the unvisited constraint with the lowest degree
+    std::vector<size_t> startOrder(numberOfConstraints);
+    std::iota(startOrder.begin(), startOrder.end(), 0);
+    std::stable_sort(startOrder.begin(), startOrder.end(),
+        [&](size_t first, size_t second) { return (degrees[first] < degrees[second]); });
+
+    std::vector<bool> isConstraintVisited(numberOfConstraints, false);
+    std::vector<bool> isVariableExpanded(numberOfVariables, false);
+
+    std::vector<size_t> order;
+    order.reserve(numberOfConstraints);
+
+    for(auto S : startOrder)
+    {
+        if(isConstraintVisited[S])
+            continue;
+
+        isConstraintVisited[S] = true;
+        order.push_back(S);
+
+        for(size_t k = order.size() - 1; k < order.size(); k++)
+        {
+            size_t firstNeighbor = order.size();
+
+            for(auto V : constraintVariables[order[k]])
+            {
+                if(isVariableExpanded[V])
+                    continue;
+
+                isVariableExpanded[V] = true;
+
+                for(auto C : variableConstraints[V])
+                {
+                    if(isConstraintVisited[C])
+                        continue;
+
+                    isConstraintVisited[C] = true;
+                    order.push_back(C);
+                }
+            }
+
+            std::stable_sort(order.begin() + firstNeighbor, order.end(),
+                [&](size_t first, size_t second) { return (degrees[first] < degrees[second]); });
+        }
+    }
+
+    std::vector<std::shared_ptr<T>> orderedConstraints;
+    orderedConstraints.reserve(numberOfConstraints);
+
+    for(auto I = order.rbegin(); I != order.rend(); I++)
+        orderedConstraints.push_back(constraints[*I]);
+
+    return (orderedConstraints);
+}
+
+void Problem::reorderConstraints()
+{
+    linearConstraints = getReverseCuthillMcKeeOrder(linearConstraints, allVariables.size());
+    quadraticConstraints = getReverseCuthillMcKeeOrder(quadraticConstraints, allVariables.size());
+    nonlinearConstraints = getReverseCuthillMcKeeOrder(nonlinearConstraints, allVariables.size());
+
+    env->output->outputDebug("        Constraints reordered for locality.");
+}
+
+NumericConstraintValue Problem::getMaxLinearConstraintValueOrFirstViolation(const VectorDouble& point, double tolerance)
+{
+    assert(linearConstraints.size() > 0);
+
+    const auto& pattern = linearConstraintMatrix.pattern;
+    bool isMatrixValid = (pattern.numberOfRows() == linearConstraints.size());
+
+    size_t maxIndex = 0;
+    double maxValue = SHOT_DBL_MIN;
+    size_t numberOfEvaluations = 0;
+
+    for(size_t i = 0; i < linearConstraints.size(); i++)
+    {
+        auto& C = linearConstraints[i];
+        double value;
+
+        if(isMatrixValid && pattern.rowSize(i) == C->linearTerms.size())
+        {
+            const double* coefficient = linearConstraintMatrix.coefficients.data() + pattern.rowStarts[i];
+            const int* column = pattern.rowBegin(i);
+            size_t numberOfTerms = pattern.rowSize(i);
+
+            value = C->constant;
+
+            for(size_t j = 0; j < numberOfTerms; j++)
+                value += coefficient[j] * point[column[j]];
+        }
+        else
+        {
+            value = C->calculateFunctionValue(point);
+        }
+
+        numberOfEvaluations++;
+
+        double normalizedValue = std::max(value - C->valueRHS, C->valueLHS - value);
+
+        if(i == 0 || normalizedValue > maxValue)
+        {
+            maxIndex = i;
+            maxValue = normalizedValue;
+        }
+
+        if(normalizedValue > tolerance)
+            break;
+    }
+
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::ConstraintEvaluations, numberOfEvaluations);
+
+    // Only the returned constraint is evaluated again to get all the values
+    return (linearConstraints[maxIndex]->calculateNumericValue(point));
+}
+
+NumericConstraintValue Problem::getMaxNumericConstraintValueOrFirstViolation(
+    const VectorDouble& point, const QuadraticConstraints& constraintSelection, double tolerance)
+{
+    return (getMaxNumericConstraintValueOrFirstViolation<QuadraticConstraint>(point, constraintSelection, tolerance));
+}
+
+NumericConstraintValue Problem::getMaxNumericConstraintValueOrFirstViolation(
+    const VectorDouble& point, const NonlinearConstraints& constraintSelection, double tolerance)
+{
+    return (getMaxNumericConstraintValueOrFirstViolation<NonlinearConstraint>(point, constraintSelection, tolerance));
+}
+
+template <typename T>
+NumericConstraintValue Problem::getMaxNumericConstraintValueOrFirstViolation(
+    const VectorDouble& point, const std::vector<std::shared_ptr<T>>& constraintSelection, double tolerance)
+{
+    assert(constraintSelection.size() > 0);
+
+    auto evaluations = getConstraintEvaluations(point);
+
+    auto value = calculateNumericValue(constraintSelection[0].get(), point, evaluations);
+
+    for(size_t i = 1; i < constraintSelection.size() && value.error <= tolerance; i++)
+    {
+        auto tmpValue = calculateNumericValue(constraintSelection[i].get(), point, evaluations);
+
+        if(tmpValue.normalizedValue > value.normalizedValue)
+            value = tmpValue;
+    }
+
+    return value;
+}
+
+template <typename T>
+NumericConstraintValues Problem::getAllDeviatingConstraints(
+    const VectorDouble& point, double tolerance, std::vector<T> constraintSelection, double correction)
+{
+    auto evaluations = getConstraintEvaluations(point);
+
+    NumericConstraintValues constraintValues;
+    for(auto& C : constraintSelection)
+    {
+        NumericConstraintValue constraintValue = calculateNumericValue(C.get(), point, evaluations, correction);
+        if(constraintValue.normalizedValue > tolerance)
+            constraintValues.push_back(constraintValue);
+    }
+
+    return constraintValues;
+}
+
+NumericConstraintValues Problem::getFractionOfDeviatingNonlinearConstraints(
+    const VectorDouble& point, double tolerance, double fraction, double correction)
+{
+    if(fraction > 1)
+        fraction = 1;
+    else if(fraction < 0)
+        fraction = 0;
+
+    int fractionNumbers = std::max(1, (int)ceil(fraction * this->nonlinearConstraints.size()));
+
+    auto values = getAllDeviatingConstraints(point, tolerance, this->nonlinearConstraints, correction);
+
+    std::sort(values.begin(), values.end(), std::greater<NumericConstraintValue>());
+
+    if((int)values.size() <= fractionNumbers) // Not enough elements to need truncating
     {
         return values;
     }
@@ -1606,6 +2895,284 @@ NumericConstraintValues Problem::getFractionOfDeviatingNonlinearConstraints(
     return values;
 }
 
+void Problem::updateIntervalScreening()
+{
+    if(variableBounds.size() != allVariables.size())
+        updateVariableBounds();
+
+    // The margin covers the points from the dual solver, which may be slightly outside of the bounds
+    auto getMargin = [](double bound) { return (1e-6 * std::max(1.0, std::abs(bound))); };
+
+    auto numberOfVariables = allVariables.size();
+    intervalScreeningLowerBounds.resize(numberOfVariables);
+    intervalScreeningUpperBounds.resize(numberOfVariables);
+
+    IntervalVector bounds(numberOfVariables);
+
+    for(size_t i = 0; i < numberOfVariables; i++)
+    {
+        intervalScreeningLowerBounds[i] = variableLowerBounds[i] - getMargin(variableLowerBounds[i]);
+        intervalScreeningUpperBounds[i] = variableUpperBounds[i] + getMargin(variableUpperBounds[i]);
+        bounds[i] = Interval(intervalScreeningLowerBounds[i], intervalScreeningUpperBounds[i]);
+    }
+
+    nonlinearConstraintIntervalValues.assign(nonlinearConstraints.size(), Interval(SHOT_DBL_MIN, SHOT_DBL_MAX));
+
+    for(size_t k = 0; k < nonlinearConstraints.size(); k++)
+    {
+        try
+        {
+            nonlinearConstraintIntervalValues[k] = nonlinearConstraints[k]->calculateFunctionValue(bounds);
+        }
+        catch(const mc::Interval::Exceptions&)
+        {
+        }
+    }
+
+    isIntervalScreeningUpdated = true;
+}
+
+std::vector<bool> Problem::getNonDeviatingNonlinearConstraints(
+    const std::vector<VectorDouble>& points, double tolerance, double correction)
+{
+    std::vector<bool> isNonDeviating;
+
+    if(!useIntervalScreening)
+        return (isNonDeviating);
+
+    if(!isIntervalScreeningUpdated)
+        updateIntervalScreening();
+
+    for(auto& P : points)
+    {
+        if(P.size() < intervalScreeningLowerBounds.size())
+            return (isNonDeviating);
+
+        for(size_t i = 0; i < intervalScreeningLowerBounds.size(); i++)
+        {
+            if(!(P[i] >= intervalScreeningLowerBounds[i] && P[i] <= intervalScreeningUpperBounds[i]))
+                return (isNonDeviating);
+        }
+    }
+
+    isNonDeviating.resize(nonlinearConstraints.size(), false);
+    int numberOfNonDeviating = 0;
+
+    for(size_t k = 0; k < nonlinearConstraints.size(); k++)
+    {
+        auto& value = nonlinearConstraintIntervalValues[k];
+
+        // The same comparisons as for the normalized values of the points, a NaN bound is never skipped
+        isNonDeviating[k] = (value.u() - correction - nonlinearConstraints[k]->valueRHS <= tolerance
+            && nonlinearConstraints[k]->valueLHS - (value.l() - correction) <= tolerance);
+
+        if(isNonDeviating[k])
+            numberOfNonDeviating++;
+    }
+
+    if(numberOfNonDeviating == 0)
+        isNonDeviating.clear();
+
+    return (isNonDeviating);
+}
+
+void Problem::calculateNonlinearConstraintFunctionValues(const PointBlock& pointBlock,
+    const PointBlockFloat* singlePrecisionPointBlock, const std::vector<bool>& isSkipped, VectorDouble& functionValues)
+{
+    size_t numberOfPoints = pointBlock.numberOfPoints;
+    functionValues.resize(nonlinearConstraints.size() * numberOfPoints);
+
+    std::atomic<size_t> nextConstraint(0);
+
+    auto calculateValues = [&]() {
+        for(size_t k = nextConstraint++; k < nonlinearConstraints.size(); k = nextConstraint++)
+        {
+            if(!isSkipped.empty() && isSkipped[k])
+                continue;
+
+            double* values = functionValues.data() + k * numberOfPoints;
+
+            if(singlePrecisionPointBlock)
+                nonlinearConstraints[k]->calculateApproximateFunctionValues(
+                    pointBlock, *singlePrecisionPointBlock, values);
+            else
+                nonlinearConstraints[k]->calculateFunctionValues(pointBlock, values);
+        }
+    };
+
+    // Starting the threads is only worth it if there is enough work for each of them, the tapes use thread local
+    // buffers so the constraints can be evaluated concurrently
+    constexpr size_t minimumNumberOfValuesPerThread = 10000;
+
+    int numberOfThreads = std::min((size_t)batchedEvaluationNumberOfThreads,
+        std::min(nonlinearConstraints.size(), functionValues.size() / minimumNumberOfValuesPerThread));
+
+    if(numberOfThreads <= 1)
+    {
+        calculateValues();
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads);
+
+    for(int t = 0; t < numberOfThreads; t++)
+    {
+        threads.emplace_back([&, t]() {
+            ThreadPlacement::pinThread(env->settings, t);
+            calculateValues();
+        });
+    }
+
+    for(auto& T : threads)
+        T.join();
+}
+
+void Problem::screenDeviatingNonlinearConstraints(const std::vector<VectorDouble>& points,
+    const PointBlock& pointBlock, double tolerance, size_t numberOfSelected, double correction,
+    const std::vector<bool>& isSkipped, std::vector<NumericConstraintValues>& values)
+{
+    // The buffers are kept between the calls, which are made for the solution points in each iteration
+    thread_local PointBlockFloat singlePrecisionPointBlock;
+    thread_local VectorDouble functionValues;
+    singlePrecisionPointBlock.assign(points);
+
+    calculateNonlinearConstraintFunctionValues(pointBlock, &singlePrecisionPointBlock, isSkipped, functionValues);
+
+    // The approximate normalized values and positions in nonlinearConstraints of the possibly deviating constraints
+    thread_local std::vector<std::vector<std::pair<double, size_t>>> candidates;
+
+    if(candidates.size() < points.size())
+        candidates.resize(points.size());
+
+    for(size_t p = 0; p < points.size(); p++)
+        candidates[p].clear();
+
+    auto getMargin = [&](double value) { return (singlePrecisionScreeningTolerance * std::max(1.0, std::abs(value))); };
+
+    for(size_t k = 0; k < nonlinearConstraints.size(); k++)
+    {
+        if(!isSkipped.empty() && isSkipped[k])
+            continue;
+
+        const double* constraintValues = functionValues.data() + k * points.size();
+
+        for(size_t p = 0; p < points.size(); p++)
+        {
+            double value
+                = nonlinearConstraints[k]->createNumericValue(constraintValues[p] - correction).normalizedValue;
+
+            // Values that are not finite in single precision are always evaluated again
+            if(!std::isfinite(value))
+                value = SHOT_DBL_MAX;
+            else if(value + getMargin(value) <= tolerance)
+                continue;
+
+            candidates[p].emplace_back(value, k);
+        }
+    }
+
+    int numberOfReevaluations = 0;
+
+    for(size_t p = 0; p < points.size(); p++)
+    {
+        auto& pointCandidates = candidates[p];
+
+        // Only the constraints that can be among the selected ones are evaluated in double precision
+        double cutoff = SHOT_DBL_MIN;
+
+        if(pointCandidates.size() > numberOfSelected)
+        {
+            std::nth_element(pointCandidates.begin(), pointCandidates.begin() + numberOfSelected - 1,
+                pointCandidates.end(), std::greater<std::pair<double, size_t>>());
+
+            cutoff = pointCandidates[numberOfSelected - 1].first;
+        }
+
+        for(auto& [value, k] : pointCandidates)
+        {
+            if(value + getMargin(value) < cutoff - getMargin(cutoff))
+                continue;
+
+            auto constraintValue = nonlinearConstraints[k]->calculateNumericValue(points[p], correction);
+            numberOfReevaluations++;
+
+            if(constraintValue.normalizedValue > tolerance)
+                values[p].push_back(constraintValue);
+        }
+    }
+
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::ConstraintEvaluations, numberOfReevaluations);
+}
+
+std::vector<NumericConstraintValues> Problem::getFractionOfDeviatingNonlinearConstraints(
+    const std::vector<VectorDouble>& points, double tolerance, double fraction, double correction)
+{
+    if(fraction > 1)
+        fraction = 1;
+    else if(fraction < 0)
+        fraction = 0;
+
+    int fractionNumbers = std::max(1, (int)ceil(fraction * this->nonlinearConstraints.size()));
+
+    std::vector<NumericConstraintValues> values(points.size());
+
+    if(points.size() == 0)
+        return values;
+
+    // Kept between the calls as the buffers in screenDeviatingNonlinearConstraints()
+    thread_local PointBlock pointBlock;
+    pointBlock.assign(points);
+
+    // The constraints that cannot deviate anywhere within the variable bounds are not evaluated
+    auto isSkipped = getNonDeviatingNonlinearConstraints(points, tolerance, correction);
+    size_t numberOfEvaluatedConstraints = isSkipped.empty()
+        ? this->nonlinearConstraints.size()
+        : (size_t)std::count(isSkipped.begin(), isSkipped.end(), false);
+
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::ConstraintEvaluations, points.size() * numberOfEvaluatedConstraints);
+
+    if(useSinglePrecisionScreening)
+    {
+        screenDeviatingNonlinearConstraints(
+            points, pointBlock, tolerance, fractionNumbers, correction, isSkipped, values);
+    }
+    else
+    {
+        thread_local VectorDouble functionValues;
+        calculateNonlinearConstraintFunctionValues(pointBlock, nullptr, isSkipped, functionValues);
+
+        for(size_t k = 0; k < this->nonlinearConstraints.size(); k++)
+        {
+            if(!isSkipped.empty() && isSkipped[k])
+                continue;
+
+            const double* constraintValues = functionValues.data() + k * points.size();
+
+            for(size_t p = 0; p < points.size(); p++)
+            {
+                auto constraintValue
+                    = this->nonlinearConstraints[k]->createNumericValue(constraintValues[p] - correction);
+
+                if(constraintValue.normalizedValue > tolerance)
+                    values[p].push_back(constraintValue);
+            }
+        }
+    }
+
+    for(auto& V : values)
+    {
+        std::sort(V.begin(), V.end(), std::greater<NumericConstraintValue>());
+
+        if((int)V.size() > fractionNumbers)
+            V.resize(fractionNumbers);
+    }
+
+    return values;
+}
+
 NumericConstraintValues Problem::getAllDeviatingNumericConstraints(const VectorDouble& point, double tolerance)
 {
     return getAllDeviatingConstraints(point, tolerance, numericConstraints);
@@ -1638,220 +3205,757 @@ bool Problem::areQuadraticConstraintsFulfilled(VectorDouble point, double tolera
     return (deviatingConstraints.size() == 0);
 }
 
-bool Problem::areNonlinearConstraintsFulfilled(VectorDouble point, double tolerance)
-{
-    auto deviatingConstraints = getAllDeviatingNonlinearConstraints(point, tolerance);
-    return (deviatingConstraints.size() == 0);
+bool Problem::areNonlinearConstraintsFulfilled(VectorDouble point, double tolerance)
+{
+    auto deviatingConstraints = getAllDeviatingNonlinearConstraints(point, tolerance);
+    return (deviatingConstraints.size() == 0);
+}
+
+bool Problem::areNumericConstraintsFulfilled(VectorDouble point, double tolerance)
+{
+    auto deviatingConstraints = getAllDeviatingNumericConstraints(point, tolerance);
+    return (deviatingConstraints.size() == 0);
+}
+
+bool Problem::areIntegralityConstraintsFulfilled(VectorDouble point, double tolerance)
+{
+    for(auto& V : integerVariables)
+    {
+        if(abs(point.at(V->index) - round(point.at(V->index))) > tolerance)
+            return false;
+    }
+
+    for(auto& V : semiintegerVariables)
+    {
+        if(abs(point.at(V->index) - round(point.at(V->index))) > tolerance)
+            return false;
+    }
+
+    return true;
+}
+
+bool Problem::areVariableBoundsFulfilled(const VectorDouble& point, double tolerance)
+{
+    if(variableLowerBounds.size() != allVariables.size())
+        updateVariableBounds();
+
+    for(int i = 0; i < properties.numberOfVariables; ++i)
+    {
+        if(point.at(i) - tolerance > variableUpperBounds[i])
+        {
+            return false;
+        }
+        if(point.at(i) + tolerance < variableLowerBounds[i])
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Problem::areSpecialOrderedSetsFulfilled(VectorDouble point, double tolerance)
+{
+    for(auto& S : specialOrderedSets)
+    {
+        if(S->type == E_SOSType::One)
+        {
+            bool found = false;
+
+            for(auto& V : S->variables)
+            {
+                if(abs(point.at(V->index)) > tolerance)
+                {
+                    if(found)
+                        return false;
+
+                    found = true;
+                }
+            }
+        }
+        else if(S->type == E_SOSType::Two)
+        {
+            int numFound = 0;
+            size_t firstIndex = 0;
+
+            for(size_t i = 0; i < S->variables.size(); i++)
+            {
+                if(abs(point.at(S->variables[i]->index)) > tolerance)
+                {
+                    if(numFound == 0)
+                    {
+                        firstIndex = i;
+                        numFound = 1;
+                    }
+                    else if(numFound == 1 && firstIndex == i - 1)
+                    {
+                        numFound = 2;
+                    }
+                    else
+                        return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+void Problem::saveProblemToFile(std::string filename)
+{
+    std::stringstream stream;
+    stream << this;
+
+    if(!Utilities::writeStringToFile(filename, stream.str()))
+    {
+        env->output->outputError("Error when writing to file " + filename);
+    }
+}
+
+void Problem::doFBBT()
+{
+    env->timing->startTimer("BoundTightening");
+
+    double startTime = env->timing->getElapsedTime("BoundTightening");
+
+    if(properties.isReformulated)
+    {
+        env->timing->startTimer("BoundTighteningFBBTReformulated");
+        env->output->outputInfo("");
+        env->output->outputInfo(" Performing bound tightening on reformulated problem.");
+    }
+    else
+    {
+        env->timing->startTimer("BoundTighteningFBBTOriginal");
+        env->output->outputInfo("");
+        env->output->outputInfo(" Performing bound tightening on original problem.");
+    }
+
+    int numberOfIterations = env->settings->getSetting<int>("BoundTightening.FeasibilityBased.MaxIterations", "Model");
+    double timeLimit = env->settings->getSetting<double>("BoundTightening.FeasibilityBased.TimeLimit", "Model");
+    bool useNonlinearBoundTightening
+        = env->settings->getSetting<bool>("BoundTightening.FeasibilityBased.UseNonlinear", "Model");
+
+    double timeEnd = startTime + timeLimit;
+
+    int numberOfTightenedVariablesBefore = std::count_if(allVariables.begin(), allVariables.end(),
+        [](auto V) { return (V->properties.hasLowerBoundBeenTightened || V->properties.hasUpperBoundBeenTightened); });
+
+    FBBTPropagation propagation;
+    propagation.maxNumberOfPasses = numberOfIterations;
+    propagation.minimumImprovement
+        = env->settings->getSetting<double>("BoundTightening.FeasibilityBased.MinimumImprovement", "Model");
+    propagation.timeEnd = timeEnd;
+
+    initializeFBBTPropagation(propagation, useNonlinearBoundTightening);
+
+    auto& constraints = propagation.constraints;
+
+    int numberOfThreads = env->settings->getSetting<int>("BoundTightening.FeasibilityBased.NumberOfThreads", "Model");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    // Constraints without common variables can be tightened independently, so each group of constraints connected by
+    // their variables can be propagated separately
+    auto& components = propagation.components;
+
+    if(numberOfThreads > 1)
+    {
+        components = getFBBTComponents(propagation);
+    }
+    else
+    {
+        components.resize(1);
+        components[0].resize(constraints.size());
+        std::iota(components[0].begin(), components[0].end(), 0);
+    }
+
+    propagation.positionInComponent.resize(constraints.size());
+
+    for(auto& component : components)
+    {
+        for(size_t k = 0; k < component.size(); k++)
+            propagation.positionInComponent[component[k]] = k;
+    }
+
+    numberOfThreads = std::min(numberOfThreads, (int)components.size());
+
+    int numberOfPasses = 0;
+
+    if(numberOfThreads <= 1)
+    {
+        for(size_t k = 0; k < components.size(); k++)
+            numberOfPasses = std::max(numberOfPasses, doFBBTOnComponent(propagation, k, true));
+    }
+    else
+    {
+        // The largest components are started first. The bounds in the original problem are updated afterwards, since
+        // the components would otherwise update them at the same time.
+        std::vector<size_t> componentOrder(components.size());
+        std::iota(componentOrder.begin(), componentOrder.end(), 0);
+        std::stable_sort(componentOrder.begin(), componentOrder.end(),
+            [&](size_t first, size_t second) { return (components[first].size() > components[second].size()); });
+
+        std::atomic<size_t> nextComponent(0);
+        std::vector<int> componentPasses(components.size(), 0);
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+        {
+            threads.emplace_back([&, t]() {
+                ThreadPlacement::pinThread(env->settings, t);
+
+                for(size_t k = nextComponent++; k < componentOrder.size(); k = nextComponent++)
+                    componentPasses[componentOrder[k]] = doFBBTOnComponent(propagation, componentOrder[k], false);
+            });
+        }
+
+        for(auto& T : threads)
+            T.join();
+
+        numberOfPasses = *std::max_element(componentPasses.begin(), componentPasses.end());
+
+        if(properties.isReformulated)
+            updateOriginalProblemBounds();
+
+        env->output->outputDebug(
+            fmt::format("  Bound tightening performed on {} independent constraint groups using {} threads.",
+                components.size(), numberOfThreads));
+    }
+
+    env->output->outputDebug(
+        fmt::format("  Bound tightening visited {} constraints.", propagation.numberOfVisitedConstraints.load()));
+
+    int numberOfTightenedVariablesAfter = std::count_if(allVariables.begin(), allVariables.end(),
+        [](auto V) { return (V->properties.hasLowerBoundBeenTightened || V->properties.hasUpperBoundBeenTightened); });
+
+    if(properties.isReformulated)
+    {
+        env->timing->stopTimer("BoundTighteningFBBTReformulated");
+        env->output->outputInfo(fmt::format("  - Bounds for {} variables tightened in {:.2f} s and {} passes.",
+            numberOfTightenedVariablesAfter - numberOfTightenedVariablesBefore,
+            env->timing->getElapsedTime("BoundTighteningFBBTReformulated"), numberOfPasses));
+    }
+    else
+    {
+        env->timing->stopTimer("BoundTighteningFBBTOriginal");
+        env->output->outputInfo(fmt::format("  - Bounds for {} variables tightened in {:.2f} s and {} passes.",
+            numberOfTightenedVariablesAfter - numberOfTightenedVariablesBefore,
+            env->timing->getElapsedTime("BoundTighteningFBBTOriginal"), numberOfPasses));
+    }
+
+    env->timing->stopTimer("BoundTightening");
+}
+
+Variables Problem::doIncrementalFBBT(NumericConstraintPtr constraint, double timeLimit)
+{
+    env->timing->startTimer("BoundTightening");
+
+    double timeEnd = env->timing->getElapsedTime("BoundTightening") + timeLimit;
+
+    auto& propagation = getIncrementalFBBTPropagation();
+
+    VectorDouble lowerBoundsBefore(allVariables.size());
+    VectorDouble upperBoundsBefore(allVariables.size());
+
+    for(size_t i = 0; i < allVariables.size(); i++)
+    {
+        lowerBoundsBefore[i] = allVariables[i]->lowerBound;
+        upperBoundsBefore[i] = allVariables[i]->upperBound;
+    }
+
+    FBBTQueue queue;
+    queue.isInQueue.assign(propagation.constraints.size(), false);
+
+    tightenAndQueueFBBTConstraints(constraint, getFBBTVariables(constraint), queue, timeEnd);
+    propagateFBBTQueue(queue, timeEnd);
+
+    Variables tightenedVariables;
+
+    for(size_t i = 0; i < allVariables.size(); i++)
+    {
+        if(allVariables[i]->lowerBound != lowerBoundsBefore[i] || allVariables[i]->upperBound != upperBoundsBefore[i])
+            tightenedVariables.push_back(allVariables[i]);
+    }
+
+    env->output->outputDebug(fmt::format("  Incremental bound tightening visited {} constraints and tightened the "
+                                         "bounds of {} variables.",
+        queue.numberOfVisits + 1, tightenedVariables.size()));
+
+    env->timing->stopTimer("BoundTightening");
+
+    return (tightenedVariables);
+}
+
+bool Problem::propagateVariableBounds(const Variables& variables, double timeLimit)
+{
+    env->timing->startTimer("BoundTightening");
+
+    double timeEnd = env->timing->getElapsedTime("BoundTightening") + timeLimit;
+
+    auto& propagation = getIncrementalFBBTPropagation();
+
+    FBBTQueue queue;
+    queue.isInQueue.assign(propagation.constraints.size(), false);
+    queue.checkFeasibility = true;
+    queue.feasibilityTolerance = env->settings->getSetting<double>("Tolerance.LinearConstraint", "Primal");
+    queue.updateOriginalProblem = false;
+
+    for(auto& V : variables)
+        queueFBBTConstraints(V, queue);
+
+    bool isFeasible = propagateFBBTQueue(queue, timeEnd);
+
+    env->timing->stopTimer("BoundTightening");
+
+    return (isFeasible);
+}
+
+Problem::FBBTPropagation& Problem::getIncrementalFBBTPropagation()
+{
+    // The incidence index is reused between the calls
+    if(!incrementalFBBTPropagation)
+    {
+        incrementalFBBTPropagation = std::make_unique<FBBTPropagation>();
+        initializeFBBTPropagation(*incrementalFBBTPropagation,
+            env->settings->getSetting<bool>("BoundTightening.FeasibilityBased.UseNonlinear", "Model"));
+    }
+
+    incrementalFBBTPropagation->minimumImprovement
+        = env->settings->getSetting<double>("BoundTightening.FeasibilityBased.MinimumImprovement", "Model");
+    incrementalFBBTPropagation->maxNumberOfPasses
+        = env->settings->getSetting<int>("BoundTightening.FeasibilityBased.MaxIterations", "Model");
+
+    return (*incrementalFBBTPropagation);
+}
+
+void Problem::queueFBBTConstraints(const VariablePtr& variable, FBBTQueue& queue)
+{
+    for(auto k : incrementalFBBTPropagation->variableConstraints[variable->index])
+    {
+        if(queue.isInQueue[k])
+            continue;
+
+        queue.isInQueue[k] = true;
+        queue.constraints.push_back(k);
+    }
+}
+
+bool Problem::tightenAndQueueFBBTConstraints(
+    const NumericConstraintPtr& constraint, const Variables& variables, FBBTQueue& queue, double timeEnd)
+{
+    thread_local VectorDouble variableLowerBounds;
+    thread_local VectorDouble variableUpperBounds;
+
+    variableLowerBounds.resize(variables.size());
+    variableUpperBounds.resize(variables.size());
+
+    for(size_t j = 0; j < variables.size(); j++)
+    {
+        variableLowerBounds[j] = variables[j]->lowerBound;
+        variableUpperBounds[j] = variables[j]->upperBound;
+    }
+
+    bool boundsUpdated = doFBBTOnConstraint(constraint, timeEnd, queue.updateOriginalProblem);
+
+    if(queue.checkFeasibility)
+    {
+        // The variable bounds are never crossed when tightened, so a conflict shows in the function bounds
+        auto functionBounds = constraint->getConstraintFunctionBounds();
+
+        double toleranceLHS = queue.feasibilityTolerance * std::max(1.0, std::abs(constraint->valueLHS));
+        double toleranceRHS = queue.feasibilityTolerance * std::max(1.0, std::abs(constraint->valueRHS));
+
+        if(functionBounds.l() > constraint->valueRHS + toleranceRHS
+            || functionBounds.u() < constraint->valueLHS - toleranceLHS)
+            return (false);
+    }
+
+    if(!boundsUpdated)
+        return (true);
+
+    double minimumImprovement = incrementalFBBTPropagation->minimumImprovement;
+
+    for(size_t j = 0; j < variables.size(); j++)
+    {
+        double width = variableUpperBounds[j] - variableLowerBounds[j];
+        double threshold = minimumImprovement * std::max(1.0, std::isfinite(width) ? width : 1.0);
+
+        bool isImproved = (std::isinf(variableLowerBounds[j]) && !std::isinf(variables[j]->lowerBound))
+            || (std::isinf(variableUpperBounds[j]) && !std::isinf(variables[j]->upperBound))
+            || variables[j]->lowerBound - variableLowerBounds[j] > threshold
+            || variableUpperBounds[j] - variables[j]->upperBound > threshold;
+
+        if(isImproved)
+            queueFBBTConstraints(variables[j], queue);
+    }
+
+    return (true);
+}
+
+bool Problem::propagateFBBTQueue(FBBTQueue& queue, double timeEnd)
+{
+    auto& propagation = *incrementalFBBTPropagation;
+
+    size_t maxNumberOfVisits = propagation.constraints.size() * propagation.maxNumberOfPasses;
+
+    while(!queue.constraints.empty() && queue.numberOfVisits < maxNumberOfVisits
+        && env->timing->getElapsedTime("BoundTightening") < timeEnd && !env->cancellationToken->isCancelled())
+    {
+        auto k = queue.constraints.front();
+        queue.constraints.pop_front();
+        queue.isInQueue[k] = false;
+
+        queue.numberOfVisits++;
+
+        if(!tightenAndQueueFBBTConstraints(
+               propagation.constraints[k], propagation.constraintVariables[k], queue, timeEnd))
+            return (false);
+    }
+
+    return (true);
+}
+
+void Problem::initializeFBBTPropagation(FBBTPropagation& propagation, bool useNonlinearBoundTightening)
+{
+    // The constraints in the order they are visited in each pass
+    auto& constraints = propagation.constraints;
+    constraints.clear();
+    constraints.reserve(linearConstraints.size() + quadraticConstraints.size() + nonlinearConstraints.size());
+
+    for(auto& C : linearConstraints)
+        constraints.push_back(C);
+
+    for(auto& C : quadraticConstraints)
+        constraints.push_back(C);
+
+    if(useNonlinearBoundTightening)
+    {
+        for(auto& C : nonlinearConstraints)
+            constraints.push_back(C);
+    }
+
+    // The variables in each constraint, and for each variable the constraints it is in, so that only the constraints
+    // with a tightened variable are visited again
+    propagation.constraintVariables.assign(constraints.size(), Variables());
+    propagation.variableConstraints.assign(allVariables.size(), std::vector<size_t>());
+
+    for(size_t k = 0; k < constraints.size(); k++)
+    {
+        propagation.constraintVariables[k] = getFBBTVariables(constraints[k]);
+
+        for(auto& V : propagation.constraintVariables[k])
+            propagation.variableConstraints[V->index].push_back(k);
+    }
+}
+
+int Problem::doFBBTOnComponent(FBBTPropagation& propagation, size_t componentIndex, bool updateOriginalProblem)
+{
+    auto& component = propagation.components[componentIndex];
+
+    // All constraints are visited in the first pass
+    std::vector<bool> isConstraintInPass(component.size(), true);
+    std::vector<bool> isConstraintInNextPass(component.size(), false);
+
+    VectorDouble lowerBoundsBefore;
+    VectorDouble upperBoundsBefore;
+
+    int numberOfPasses = 0;
+
+    while(numberOfPasses < propagation.maxNumberOfPasses)
+    {
+        bool boundsUpdated = false;
+        numberOfPasses++;
+
+        if(propagation.components.size() == 1)
+            env->output->outputDebug(fmt::format(
+                "  Bound tightening pass {} of {}.", numberOfPasses, propagation.maxNumberOfPasses));
+
+        for(size_t k = 0; k < component.size(); k++)
+        {
+            if(!isConstraintInPass[k])
+                continue;
+
+            if(propagation.stopTightening || env->cancellationToken->isCancelled()
+                || env->timing->getElapsedTime("BoundTightening") > propagation.timeEnd)
+            {
+                propagation.stopTightening = true;
+                return (numberOfPasses);
+            }
+
+            auto& constraint = propagation.constraints[component[k]];
+            auto& variables = propagation.constraintVariables[component[k]];
+
+            lowerBoundsBefore.resize(variables.size());
+            upperBoundsBefore.resize(variables.size());
+
+            for(size_t j = 0; j < variables.size(); j++)
+            {
+                lowerBoundsBefore[j] = variables[j]->lowerBound;
+                upperBoundsBefore[j] = variables[j]->upperBound;
+            }
+
+            propagation.numberOfVisitedConstraints++;
+
+            if(!doFBBTOnConstraint(constraint, propagation.timeEnd, updateOriginalProblem))
+                continue;
+
+            boundsUpdated = true;
+
+            for(size_t j = 0; j < variables.size(); j++)
+            {
+                double width = upperBoundsBefore[j] - lowerBoundsBefore[j];
+                double threshold = propagation.minimumImprovement * std::max(1.0, std::isfinite(width) ? width : 1.0);
+
+                bool isImproved = (std::isinf(lowerBoundsBefore[j]) && !std::isinf(variables[j]->lowerBound))
+                    || (std::isinf(upperBoundsBefore[j]) && !std::isinf(variables[j]->upperBound))
+                    || variables[j]->lowerBound - lowerBoundsBefore[j] > threshold
+                    || upperBoundsBefore[j] - variables[j]->upperBound > threshold;
+
+                if(!isImproved)
+                    continue;
+
+                // The constraints not yet visited in this pass use the new bound directly
+                for(auto l : propagation.variableConstraints[variables[j]->index])
+                {
+                    auto position = propagation.positionInComponent[l];
+
+                    if(position > k)
+                        isConstraintInPass[position] = true;
+                    else
+                        isConstraintInNextPass[position] = true;
+                }
+            }
+        }
+
+        if(!boundsUpdated)
+            break;
+
+        isConstraintInPass.swap(isConstraintInNextPass);
+        std::fill(isConstraintInNextPass.begin(), isConstraintInNextPass.end(), false);
+
+        if(std::none_of(isConstraintInPass.begin(), isConstraintInPass.end(), [](bool B) { return (B); }))
+            break;
+    }
+
+    return (numberOfPasses);
 }
 
-bool Problem::areNumericConstraintsFulfilled(VectorDouble point, double tolerance)
+std::vector<std::vector<size_t>> Problem::getFBBTComponents(const FBBTPropagation& propagation)
 {
-    auto deviatingConstraints = getAllDeviatingNumericConstraints(point, tolerance);
-    return (deviatingConstraints.size() == 0);
-}
+    // Union-find over the constraints, where the constraints with a common variable are joined
+    std::vector<size_t> parents(propagation.constraints.size());
+    std::iota(parents.begin(), parents.end(), 0);
 
-bool Problem::areIntegralityConstraintsFulfilled(VectorDouble point, double tolerance)
-{
-    for(auto& V : integerVariables)
+    auto findRoot = [&](size_t k) {
+        while(parents[k] != k)
+        {
+            parents[k] = parents[parents[k]];
+            k = parents[k];
+        }
+
+        return (k);
+    };
+
+    for(auto& constraintIndexes : propagation.variableConstraints)
     {
-        if(abs(point.at(V->index) - round(point.at(V->index))) > tolerance)
-            return false;
+        for(size_t k = 1; k < constraintIndexes.size(); k++)
+        {
+            auto first = findRoot(constraintIndexes[0]);
+            auto second = findRoot(constraintIndexes[k]);
+
+            if(first != second)
+                parents[std::max(first, second)] = std::min(first, second);
+        }
     }
 
-    for(auto& V : semiintegerVariables)
+    // The constraints keep their order within the components
+    std::vector<std::vector<size_t>> components;
+    std::vector<int> componentIndexes(propagation.constraints.size(), -1);
+
+    for(size_t k = 0; k < propagation.constraints.size(); k++)
     {
-        if(abs(point.at(V->index) - round(point.at(V->index))) > tolerance)
-            return false;
+        auto root = findRoot(k);
+
+        if(componentIndexes[root] < 0)
+        {
+            componentIndexes[root] = components.size();
+            components.emplace_back();
+        }
+
+        components[componentIndexes[root]].push_back(k);
     }
 
-    return true;
+    return (components);
 }
 
-bool Problem::areVariableBoundsFulfilled(VectorDouble point, double tolerance)
+std::vector<NonlinearConstraintBlock> Problem::getNonlinearConstraintBlocks(int linkingVariableThreshold)
 {
-    for(int i = 0; i < properties.numberOfVariables; ++i)
+    std::vector<Variables> constraintVariables;
+    constraintVariables.reserve(nonlinearConstraints.size());
+
+    for(auto& C : nonlinearConstraints)
+        constraintVariables.push_back(*C->getGradientSparsityPattern());
+
+    // The indexes of the nonlinear constraints with each variable
+    std::vector<std::vector<size_t>> variableConstraints(allVariables.size());
+
+    for(size_t k = 0; k < constraintVariables.size(); k++)
     {
-        if(point.at(i) - tolerance > allVariables.at(i)->upperBound)
+        for(auto& V : constraintVariables[k])
+            variableConstraints[V->index].push_back(k);
+    }
+
+    // Union-find over the constraints as in getFBBTComponents(), but the linking variables do not join them
+    std::vector<size_t> parents(nonlinearConstraints.size());
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto findRoot = [&](size_t k) {
+        while(parents[k] != k)
         {
-            return false;
+            parents[k] = parents[parents[k]];
+            k = parents[k];
         }
-        if(point.at(i) + tolerance < allVariables.at(i)->lowerBound)
+
+        return (k);
+    };
+
+    for(auto& constraintIndexes : variableConstraints)
+    {
+        if(linkingVariableThreshold > 0 && (int)constraintIndexes.size() > linkingVariableThreshold)
+            continue;
+
+        for(size_t k = 1; k < constraintIndexes.size(); k++)
         {
-            return false;
+            auto first = findRoot(constraintIndexes[0]);
+            auto second = findRoot(constraintIndexes[k]);
+
+            if(first != second)
+                parents[std::max(first, second)] = std::min(first, second);
         }
     }
 
-    return true;
-}
+    std::vector<NonlinearConstraintBlock> blocks;
+    std::vector<int> blockIndexes(nonlinearConstraints.size(), -1);
+    std::vector<int> constraintBlocks(nonlinearConstraints.size());
 
-bool Problem::areSpecialOrderedSetsFulfilled(VectorDouble point, double tolerance)
-{
-    for(auto& S : specialOrderedSets)
+    for(size_t k = 0; k < nonlinearConstraints.size(); k++)
     {
-        if(S->type == E_SOSType::One)
+        auto root = findRoot(k);
+
+        if(blockIndexes[root] < 0)
         {
-            bool found = false;
+            blockIndexes[root] = blocks.size();
+            blocks.emplace_back();
+        }
 
-            for(auto& V : S->variables)
-            {
-                if(abs(point.at(V->index)) > tolerance)
-                {
-                    if(found)
-                        return false;
+        constraintBlocks[k] = blockIndexes[root];
+        blocks[blockIndexes[root]].constraints.push_back(nonlinearConstraints[k]);
+    }
 
-                    found = true;
-                }
-            }
-        }
-        else if(S->type == E_SOSType::Two)
+    // Since the variables are visited in index order, the variables of the blocks are also sorted
+    for(size_t i = 0; i < variableConstraints.size(); i++)
+    {
+        int previousBlock = -1;
+        bool isLinkingVariable = false;
+
+        for(auto k : variableConstraints[i])
         {
-            int numFound = 0;
-            size_t firstIndex = 0;
+            if(constraintBlocks[k] == previousBlock)
+                continue;
 
-            for(size_t i = 0; i < S->variables.size(); i++)
-            {
-                if(abs(point.at(S->variables[i]->index)) > tolerance)
-                {
-                    if(numFound == 0)
-                    {
-                        firstIndex = i;
-                        numFound = 1;
-                    }
-                    else if(numFound == 1 && firstIndex == i - 1)
-                    {
-                        numFound = 2;
-                    }
-                    else
-                        return false;
-                }
-            }
+            isLinkingVariable = isLinkingVariable || previousBlock >= 0;
+
+            auto& variables = blocks[constraintBlocks[k]].variables;
+
+            if(variables.size() == 0 || variables[variables.size() - 1]->index != (int)i)
+                variables.push_back(allVariables[i]);
+
+            previousBlock = constraintBlocks[k];
         }
+
+        if(!isLinkingVariable)
+            continue;
+
+        for(auto k : variableConstraints[i])
+            blocks[constraintBlocks[k]].hasLinkingVariables = true;
     }
 
-    return true;
+    return (blocks);
 }
 
-void Problem::saveProblemToFile(std::string filename)
+void Problem::updateOriginalProblemBounds()
 {
-    std::stringstream stream;
-    stream << this;
-
-    if(!Utilities::writeStringToFile(filename, stream.str()))
+    for(size_t i = 0; i < env->problem->allVariables.size(); i++)
     {
-        env->output->outputError("Error when writing to file " + filename);
+        if(allVariables[i]->lowerBound > env->problem->allVariables[i]->lowerBound)
+            env->problem->allVariables[i]->lowerBound = allVariables[i]->lowerBound;
+
+        if(allVariables[i]->upperBound < env->problem->allVariables[i]->upperBound)
+            env->problem->allVariables[i]->upperBound = allVariables[i]->upperBound;
+
+        env->problem->synchronizeVariableBounds(i);
     }
 }
 
-void Problem::doFBBT()
+Variables Problem::getFBBTVariables(const NumericConstraintPtr& constraint)
 {
-    env->timing->startTimer("BoundTightening");
-
-    double startTime = env->timing->getElapsedTime("BoundTightening");
+    Variables variables;
 
-    if(properties.isReformulated)
+    if(constraint->properties.hasLinearTerms)
     {
-        env->timing->startTimer("BoundTighteningFBBTReformulated");
-        env->output->outputInfo("");
-        env->output->outputInfo(" Performing bound tightening on reformulated problem.");
+        for(auto& T : std::dynamic_pointer_cast<LinearConstraint>(constraint)->linearTerms)
+            variables.push_back(T->variable);
     }
-    else
+
+    if(constraint->properties.hasQuadraticTerms)
     {
-        env->timing->startTimer("BoundTighteningFBBTOriginal");
-        env->output->outputInfo("");
-        env->output->outputInfo(" Performing bound tightening on original problem.");
+        for(auto& T : std::dynamic_pointer_cast<QuadraticConstraint>(constraint)->quadraticTerms)
+        {
+            variables.push_back(T->firstVariable);
+            variables.push_back(T->secondVariable);
+        }
     }
 
-    int numberOfIterations = env->settings->getSetting<int>("BoundTightening.FeasibilityBased.MaxIterations", "Model");
-    double timeLimit = env->settings->getSetting<double>("BoundTightening.FeasibilityBased.TimeLimit", "Model");
-    bool useNonlinearBoundTightening
-        = env->settings->getSetting<bool>("BoundTightening.FeasibilityBased.UseNonlinear", "Model");
-
-    bool stopTightening = false;
-
-    double timeEnd = startTime + timeLimit;
-
-    int numberOfTightenedVariablesBefore = std::count_if(allVariables.begin(), allVariables.end(),
-        [](auto V) { return (V->properties.hasLowerBoundBeenTightened || V->properties.hasUpperBoundBeenTightened); });
-
-    int i = 0;
-
-    for(i = 0; i < numberOfIterations; i++)
+    if(auto nonlinearConstraint = std::dynamic_pointer_cast<NonlinearConstraint>(constraint))
     {
-        bool boundsUpdated = false;
-
-        env->output->outputDebug(fmt::format("  Bound tightening pass {} of {}.", i + 1, numberOfIterations));
-
-        for(auto& C : linearConstraints)
+        if(constraint->properties.hasMonomialTerms)
         {
-            if(env->timing->getElapsedTime("BoundTightening") > timeEnd)
+            for(auto& T : nonlinearConstraint->monomialTerms)
             {
-                stopTightening = true;
-                break;
+                for(auto& V : T->variables)
+                    variables.push_back(V);
             }
-
-            boundsUpdated
-                = doFBBTOnConstraint(C, timeEnd - env->timing->getElapsedTime("BoundTightening")) || boundsUpdated;
         }
 
-        if(stopTightening)
-            break;
-
-        for(auto& C : quadraticConstraints)
+        if(constraint->properties.hasSignomialTerms)
         {
-            if(env->timing->getElapsedTime("BoundTightening") > timeEnd)
+            for(auto& T : nonlinearConstraint->signomialTerms)
             {
-                stopTightening = true;
-                break;
+                for(auto& E : T->elements)
+                    variables.push_back(E->variable);
             }
-
-            boundsUpdated
-                = doFBBTOnConstraint(C, timeEnd - env->timing->getElapsedTime("BoundTightening")) || boundsUpdated;
         }
 
-        if(stopTightening)
-            break;
-
-        if(useNonlinearBoundTightening)
+        if(constraint->properties.hasNonlinearExpression)
         {
-            for(auto& C : nonlinearConstraints)
-            {
-                if(env->timing->getElapsedTime("BoundTightening") > timeEnd)
-                {
-                    stopTightening = true;
-                    break;
-                }
-
-                boundsUpdated
-                    = doFBBTOnConstraint(C, timeEnd - env->timing->getElapsedTime("BoundTightening")) || boundsUpdated;
-            }
+            for(auto& V : nonlinearConstraint->variablesInNonlinearExpression)
+                variables.push_back(V);
         }
-
-        if(stopTightening || !boundsUpdated)
-            break;
     }
 
-    int numberOfTightenedVariablesAfter = std::count_if(allVariables.begin(), allVariables.end(),
-        [](auto V) { return (V->properties.hasLowerBoundBeenTightened || V->properties.hasUpperBoundBeenTightened); });
+    std::sort(variables.begin(), variables.end(),
+        [](const VariablePtr& variableOne, const VariablePtr& variableTwo) {
+            return (variableOne->index < variableTwo->index);
+        });
 
-    if(properties.isReformulated)
-    {
-        env->timing->stopTimer("BoundTighteningFBBTReformulated");
-        env->output->outputInfo(fmt::format("  - Bounds for {} variables tightened in {:.2f} s and {} passes.",
-            numberOfTightenedVariablesAfter - numberOfTightenedVariablesBefore,
-            env->timing->getElapsedTime("BoundTighteningFBBTReformulated"), i + 1));
-    }
-    else
-    {
-        env->timing->stopTimer("BoundTighteningFBBTOriginal");
-        env->output->outputInfo(fmt::format("  - Bounds for {} variables tightened in {:.2f} s and {} passes.",
-            numberOfTightenedVariablesAfter - numberOfTightenedVariablesBefore,
-            env->timing->getElapsedTime("BoundTighteningFBBTOriginal"), i + 1));
-    }
+    variables.erase(std::unique(variables.begin(), variables.end()), variables.end());
 
-    env->timing->stopTimer("BoundTightening");
+    return (variables);
 }
 
-bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLimit)
+bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeEnd, bool updateOriginalProblem)
 {
     bool boundsUpdated = false;
 
@@ -1877,25 +3981,26 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
                 otherTermsBound
                     += std::dynamic_pointer_cast<NonlinearConstraint>(constraint)->nonlinearExpression->getBounds();
 
-            auto terms = std::dynamic_pointer_cast<LinearConstraint>(constraint)->linearTerms;
+            auto& terms = std::dynamic_pointer_cast<LinearConstraint>(constraint)->linearTerms;
 
-            for(auto& T : terms)
+            // The bounds of all the other linear terms for each term, calculated once with the bounds before this pass
+            thread_local IntervalKernels::IntervalArray termBounds;
+            thread_local IntervalKernels::IntervalArray otherTermBounds;
+
+            terms.calculateTermBounds(termBounds);
+            IntervalKernels::calculateSumsOfOthers(termBounds, otherTermBounds);
+
+            for(size_t i = 0; i < terms.size(); i++)
             {
-                if(env->timing->getElapsedTime("BoundTightening") > timeLimit)
+                auto& T = terms[i];
+
+                if(env->timing->getElapsedTime("BoundTightening") > timeEnd)
                     break;
 
                 if(Utilities::isAlmostZero(T->coefficient))
                     continue;
 
-                Interval newBound = otherTermsBound;
-
-                for(auto& T2 : terms)
-                {
-                    if(T2 == T)
-                        continue;
-
-                    newBound += T2->getBounds();
-                }
+                Interval newBound = otherTermsBound + otherTermBounds.get(i);
 
                 Interval termBound = Interval(constraint->valueLHS, constraint->valueRHS) - newBound;
 
@@ -1910,7 +4015,7 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
             }
         }
 
-        if(constraint->properties.hasQuadraticTerms && env->timing->getElapsedTime("BoundTightening") < timeLimit)
+        if(constraint->properties.hasQuadraticTerms && env->timing->getElapsedTime("BoundTightening") < timeEnd)
         {
             Interval otherTermsBound(constraint->constant);
 
@@ -1929,25 +4034,26 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
                 otherTermsBound
                     += std::dynamic_pointer_cast<NonlinearConstraint>(constraint)->nonlinearExpression->getBounds();
 
-            auto terms = std::dynamic_pointer_cast<QuadraticConstraint>(constraint)->quadraticTerms;
+            auto& terms = std::dynamic_pointer_cast<QuadraticConstraint>(constraint)->quadraticTerms;
 
-            for(auto& T : terms)
+            // The bounds of all the other quadratic terms for each term, as for the linear terms above
+            thread_local IntervalKernels::IntervalArray termBounds;
+            thread_local IntervalKernels::IntervalArray otherTermBounds;
+
+            terms.calculateTermBounds(termBounds);
+            IntervalKernels::calculateSumsOfOthers(termBounds, otherTermBounds);
+
+            for(size_t i = 0; i < terms.size(); i++)
             {
-                if(env->timing->getElapsedTime("BoundTightening") > timeLimit)
+                auto& T = terms[i];
+
+                if(env->timing->getElapsedTime("BoundTightening") > timeEnd)
                     break;
 
                 if(Utilities::isAlmostZero(T->coefficient))
                     continue;
 
-                Interval newBound = otherTermsBound;
-
-                for(auto& T2 : terms)
-                {
-                    if(T2 == T)
-                        continue;
-
-                    newBound += T2->getBounds();
-                }
+                Interval newBound = otherTermsBound + otherTermBounds.get(i);
 
                 Interval termBound = Interval(constraint->valueLHS, constraint->valueRHS) - newBound;
 
@@ -1989,7 +4095,7 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
             }
         }
 
-        if(constraint->properties.hasMonomialTerms && env->timing->getElapsedTime("BoundTightening") < timeLimit)
+        if(constraint->properties.hasMonomialTerms && env->timing->getElapsedTime("BoundTightening") < timeEnd)
         {
             Interval otherTermsBound(constraint->constant);
 
@@ -2012,7 +4118,7 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
 
             for(auto& T : terms)
             {
-                if(env->timing->getElapsedTime("BoundTightening") > timeLimit)
+                if(env->timing->getElapsedTime("BoundTightening") > timeEnd)
                     break;
 
                 if(Utilities::isAlmostZero(T->coefficient))
@@ -2059,7 +4165,7 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
             }
         }
 
-        if(constraint->properties.hasSignomialTerms && env->timing->getElapsedTime("BoundTightening") < timeLimit)
+        if(constraint->properties.hasSignomialTerms && env->timing->getElapsedTime("BoundTightening") < timeEnd)
         {
             Interval otherTermsBound(constraint->constant);
 
@@ -2082,7 +4188,7 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
 
             for(auto& T : terms)
             {
-                if(env->timing->getElapsedTime("BoundTightening") > timeLimit)
+                if(env->timing->getElapsedTime("BoundTightening") > timeEnd)
                     break;
 
                 if(Utilities::isAlmostZero(T->coefficient))
@@ -2130,7 +4236,7 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
             }
         }
 
-        if(constraint->properties.hasNonlinearExpression && env->timing->getElapsedTime("BoundTightening") < timeLimit)
+        if(constraint->properties.hasNonlinearExpression && env->timing->getElapsedTime("BoundTightening") < timeEnd)
         {
             Interval otherTermsBound(constraint->constant);
 
@@ -2167,17 +4273,8 @@ bool Problem::doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLim
     }
 
     // Update variable bounds for original variables also in original problem if tightened in reformulated one
-    if(boundsUpdated && this->properties.isReformulated)
-    {
-        for(size_t i = 0; i < env->problem->allVariables.size(); i++)
-        {
-            if(allVariables[i]->lowerBound > env->problem->allVariables[i]->lowerBound)
-                env->problem->allVariables[i]->lowerBound = allVariables[i]->lowerBound;
-
-            if(allVariables[i]->upperBound < env->problem->allVariables[i]->upperBound)
-                env->problem->allVariables[i]->upperBound = allVariables[i]->upperBound;
-        }
-    }
+    if(boundsUpdated && updateOriginalProblem && this->properties.isReformulated)
+        updateOriginalProblemBounds();
 
     return (boundsUpdated);
 }
@@ -2402,8 +4499,8 @@ bool Problem::verifyOwnership()
     return (true);
 }
 
-ProblemPtr Problem::createCopy(
-    EnvironmentPtr destinationEnv, bool integerRelaxed, bool convexityRelaxed, bool copyAuxiliary)
+ProblemPtr Problem::createCopy(EnvironmentPtr destinationEnv, bool integerRelaxed, bool convexityRelaxed,
+    bool copyAuxiliary, bool withoutObjective)
 {
     auto destinationProblem = std::make_shared<Problem>(destinationEnv);
 
@@ -2412,7 +4509,12 @@ ProblemPtr Problem::createCopy(
     double minLBInt = destinationEnv->settings->getSetting<double>("Variables.Integer.MinimumLowerBound", "Model");
     double maxUBInt = destinationEnv->settings->getSetting<double>("Variables.Integer.MaximumUpperBound", "Model");
 
+    // The shared expression nodes, e.g. the common subexpressions, are copied once and remain shared in the copy
+    NonlinearExpressionCopies expressionCopies;
+
     // Copying variables
+    destinationProblem->allVariables.reserve(this->allVariables.size());
+
     for(auto& V : this->allVariables)
     {
         auto variableType = integerRelaxed ? E_VariableType::Real : V->properties.type;
@@ -2421,7 +4523,7 @@ ProblemPtr Problem::createCopy(
 
         if(V->properties.isAuxiliary && copyAuxiliary)
         {
-            variable = std::make_shared<AuxiliaryVariable>(
+            variable = destinationProblem->arena.create<AuxiliaryVariable>(
                 V->name, V->index, variableType, V->lowerBound, V->upperBound, V->semiBound);
             destinationProblem->add(variable);
 
@@ -2429,7 +4531,7 @@ ProblemPtr Problem::createCopy(
         }
         else
         {
-            variable = std::make_shared<Variable>(
+            variable = destinationProblem->arena.create<Variable>(
                 V->name, V->index, variableType, V->lowerBound, V->upperBound, V->semiBound);
 
             destinationProblem->add(variable);
@@ -2468,7 +4570,7 @@ ProblemPtr Problem::createCopy(
     {
         auto variableType = integerRelaxed ? E_VariableType::Real : this->auxiliaryObjectiveVariable->properties.type;
 
-        auto variable = std::make_shared<AuxiliaryVariable>(this->auxiliaryObjectiveVariable->name,
+        auto variable = destinationProblem->arena.create<AuxiliaryVariable>(this->auxiliaryObjectiveVariable->name,
             this->auxiliaryObjectiveVariable->index, variableType, this->auxiliaryObjectiveVariable->lowerBound,
             this->auxiliaryObjectiveVariable->upperBound);
 
@@ -2507,9 +4609,10 @@ ProblemPtr Problem::createCopy(
     ObjectiveFunctionPtr destinationObjective;
 
     // Copying the objective function
-    if(convexityRelaxed && this->objectiveFunction->properties.convexity > E_Convexity::Convex)
+    if(withoutObjective
+        || (convexityRelaxed && this->objectiveFunction->properties.convexity > E_Convexity::Convex))
     {
-        // Linear objective function if convexity relaxation
+        // Linear objective function if convexity relaxation or no objective
         destinationObjective = std::make_shared<LinearObjectiveFunction>();
     }
     else
@@ -2548,7 +4651,7 @@ ProblemPtr Problem::createCopy(
                 auto variable = destinationProblem->getVariable(LT->variable->index);
 
                 std::dynamic_pointer_cast<LinearObjectiveFunction>(destinationObjective)
-                    ->add(std::make_shared<LinearTerm>(LT->coefficient, variable));
+                    ->add(destinationProblem->arena.create<LinearTerm>(LT->coefficient, variable));
             }
         }
 
@@ -2562,7 +4665,8 @@ ProblemPtr Problem::createCopy(
                 auto secondVariable = destinationProblem->getVariable(QT->secondVariable->index);
 
                 std::dynamic_pointer_cast<QuadraticObjectiveFunction>(destinationObjective)
-                    ->add(std::make_shared<QuadraticTerm>(QT->coefficient, firstVariable, secondVariable));
+                    ->add(destinationProblem->arena.create<QuadraticTerm>(
+                        QT->coefficient, firstVariable, secondVariable));
             }
         }
 
@@ -2578,7 +4682,7 @@ ProblemPtr Problem::createCopy(
                     variables.push_back(destinationProblem->getVariable(V->index));
 
                 std::dynamic_pointer_cast<NonlinearObjectiveFunction>(destinationObjective)
-                    ->add(std::make_shared<MonomialTerm>(MT->coefficient, variables));
+                    ->add(destinationProblem->arena.create<MonomialTerm>(MT->coefficient, variables));
             }
         }
 
@@ -2591,11 +4695,11 @@ ProblemPtr Problem::createCopy(
                 SignomialElements elements;
 
                 for(auto& E : ST->elements)
-                    elements.push_back(std::make_shared<SignomialElement>(
+                    elements.push_back(destinationProblem->arena.create<SignomialElement>(
                         destinationProblem->getVariable(E->variable->index), E->power));
 
                 std::dynamic_pointer_cast<NonlinearObjectiveFunction>(destinationObjective)
-                    ->add(std::make_shared<SignomialTerm>(ST->coefficient, elements));
+                    ->add(destinationProblem->arena.create<SignomialTerm>(ST->coefficient, elements));
             }
         }
 
@@ -2605,7 +4709,7 @@ ProblemPtr Problem::createCopy(
                 ->add(copyNonlinearExpression(
                     std::dynamic_pointer_cast<NonlinearObjectiveFunction>(this->objectiveFunction)
                         ->nonlinearExpression.get(),
-                    destinationProblem));
+                    destinationProblem.get(), &expressionCopies));
     }
 
     destinationProblem->add(std::move(destinationObjective));
@@ -2660,25 +4764,33 @@ ProblemPtr Problem::createCopy(
             // Copy linear terms
             if(C->properties.hasLinearTerms)
             {
-                for(auto& LT : std::dynamic_pointer_cast<LinearConstraint>(C)->linearTerms)
+                auto& sourceTerms = std::dynamic_pointer_cast<LinearConstraint>(C)->linearTerms;
+                auto destinationLinearConstraint = std::dynamic_pointer_cast<LinearConstraint>(destinationConstraint);
+                destinationLinearConstraint->linearTerms.reserve(sourceTerms.size());
+
+                for(auto& LT : sourceTerms)
                 {
                     auto variable = destinationProblem->getVariable(LT->variable->index);
-
-                    std::dynamic_pointer_cast<LinearConstraint>(destinationConstraint)
-                        ->add(std::make_shared<LinearTerm>(LT->coefficient, variable));
+                    destinationLinearConstraint->add(
+                        destinationProblem->arena.create<LinearTerm>(LT->coefficient, variable));
                 }
             }
 
             // Copy quadratic terms
             if(C->properties.hasQuadraticTerms)
             {
-                for(auto& QT : std::dynamic_pointer_cast<QuadraticConstraint>(C)->quadraticTerms)
+                auto& sourceTerms = std::dynamic_pointer_cast<QuadraticConstraint>(C)->quadraticTerms;
+                auto destinationQuadraticConstraint
+                    = std::dynamic_pointer_cast<QuadraticConstraint>(destinationConstraint);
+                destinationQuadraticConstraint->quadraticTerms.reserve(sourceTerms.size());
+
+                for(auto& QT : sourceTerms)
                 {
                     auto firstVariable = destinationProblem->getVariable(QT->firstVariable->index);
                     auto secondVariable = destinationProblem->getVariable(QT->secondVariable->index);
 
-                    std::dynamic_pointer_cast<QuadraticConstraint>(destinationConstraint)
-                        ->add(std::make_shared<QuadraticTerm>(QT->coefficient, firstVariable, secondVariable));
+                    destinationQuadraticConstraint->add(destinationProblem->arena.create<QuadraticTerm>(
+                        QT->coefficient, firstVariable, secondVariable));
                 }
             }
 
@@ -2693,7 +4805,7 @@ ProblemPtr Problem::createCopy(
                         variables.push_back(destinationProblem->getVariable(V->index));
 
                     std::dynamic_pointer_cast<NonlinearConstraint>(destinationConstraint)
-                        ->add(std::make_shared<MonomialTerm>(MT->coefficient, variables));
+                        ->add(destinationProblem->arena.create<MonomialTerm>(MT->coefficient, variables));
                 }
             }
 
@@ -2705,11 +4817,11 @@ ProblemPtr Problem::createCopy(
                     SignomialElements elements;
 
                     for(auto& E : ST->elements)
-                        elements.push_back(std::make_shared<SignomialElement>(
+                        elements.push_back(destinationProblem->arena.create<SignomialElement>(
                             destinationProblem->getVariable(E->variable->index), E->power));
 
                     std::dynamic_pointer_cast<NonlinearConstraint>(destinationConstraint)
-                        ->add(std::make_shared<SignomialTerm>(ST->coefficient, elements));
+                        ->add(destinationProblem->arena.create<SignomialTerm>(ST->coefficient, elements));
                 }
             }
 
@@ -2718,7 +4830,7 @@ ProblemPtr Problem::createCopy(
                 std::dynamic_pointer_cast<NonlinearConstraint>(destinationConstraint)
                     ->add(copyNonlinearExpression(
                         std::dynamic_pointer_cast<NonlinearConstraint>(C)->nonlinearExpression.get(),
-                        destinationProblem));
+                        destinationProblem.get(), &expressionCopies));
         }
 
         destinationProblem->add(std::move(destinationConstraint));
@@ -2737,24 +4849,132 @@ ProblemPtr Problem::createCopy(
         destinationProblem->add(std::move(SOS));
     }
 
-    destinationProblem->updateProperties();
+    // This also updates the properties
     destinationProblem->finalize();
 
     return (destinationProblem);
 }
 
+void Problem::updateAuxiliaryVariableLevels()
+{
+    auxiliaryVariableLevels.clear();
+    numberOfLeveledAuxiliaryVariables = auxiliaryVariables.size();
+
+    auxiliaryVariableNumberOfThreads
+        = env->settings->getSetting<int>("AuxiliaryVariables.NumberOfThreads", "Model");
+
+    auxiliaryVariableNumberOfThreads
+        = ThreadPlacement::getNumberOfThreads(env->settings, auxiliaryVariableNumberOfThreads);
+
+    // The values of the auxiliary variables are stored after the original variables in the point
+    int firstIndex = properties.numberOfVariables - properties.numberOfAuxiliaryVariables;
+    VectorInteger levels(auxiliaryVariables.size(), 0);
+
+    for(size_t k = 0; k < auxiliaryVariables.size(); k++)
+    {
+        auto& V = auxiliaryVariables[k];
+        int level = 0;
+
+        auto addDependency = [&](const VariablePtr& dependency) {
+            int position = dependency->index - firstIndex;
+
+            if(position >= 0 && position < (int)k)
+                level = std::max(level, levels[position] + 1);
+        };
+
+        for(auto& T : V->linearTerms)
+            addDependency(T->variable);
+
+        for(auto& T : V->quadraticTerms)
+        {
+            addDependency(T->firstVariable);
+            addDependency(T->secondVariable);
+        }
+
+        for(auto& T : V->monomialTerms)
+        {
+            for(auto& TV : T->variables)
+                addDependency(TV);
+        }
+
+        for(auto& T : V->signomialTerms)
+        {
+            for(auto& E : T->elements)
+                addDependency(E->variable);
+        }
+
+        if(V->nonlinearExpression)
+        {
+            Variables nonlinearVariables;
+            V->nonlinearExpression->appendNonlinearVariables(nonlinearVariables);
+
+            for(auto& NV : nonlinearVariables)
+                addDependency(NV);
+        }
+
+        levels[k] = level;
+
+        if(level >= (int)auxiliaryVariableLevels.size())
+            auxiliaryVariableLevels.resize(level + 1);
+
+        auxiliaryVariableLevels[level].push_back(k);
+    }
+
+    env->output->outputDebug("  Auxiliary variables evaluated in {} levels.", auxiliaryVariableLevels.size());
+}
+
 void Problem::augmentAuxiliaryVariableValues(VectorDouble& point)
 {
     if(!this->properties.isReformulated)
         return;
 
-    assert(point.size() == this->properties.numberOfVariables - this->properties.numberOfAuxiliaryVariables);
+    size_t firstIndex = this->properties.numberOfVariables - this->properties.numberOfAuxiliaryVariables;
 
-    for(auto& V : this->auxiliaryVariables)
+    assert(point.size() == firstIndex);
+
+    // The levels are not known for auxiliary variables added after the problem was finalized
+    if(numberOfLeveledAuxiliaryVariables != auxiliaryVariables.size())
+    {
+        for(auto& V : this->auxiliaryVariables)
+            point.push_back(V->calculate(point));
+    }
+    else
     {
-        double value = V->calculate(point);
-        point.push_back(value); // Need to add the values of the auxiliary variables in case these are needed by
-                                // subsequent aux. variables
+        point.resize(firstIndex + auxiliaryVariables.size());
+
+        // Only the levels with enough variables are worth evaluating in parallel
+        constexpr size_t minVariablesPerThread = 1000;
+
+        for(auto& L : auxiliaryVariableLevels)
+        {
+            int numberOfThreads
+                = std::min(auxiliaryVariableNumberOfThreads, (int)(L.size() / minVariablesPerThread));
+
+            if(numberOfThreads <= 1)
+            {
+                for(auto K : L)
+                    point[firstIndex + K] = auxiliaryVariables[K]->calculate(point);
+
+                continue;
+            }
+
+            // The variables in the same level do not depend on each other, so each value is only written once
+            std::vector<std::thread> threads;
+            threads.reserve(numberOfThreads);
+
+            for(int i = 0; i < numberOfThreads; i++)
+            {
+                threads.emplace_back([&, i]() {
+                    size_t end = L.size() * (i + 1) / numberOfThreads;
+
+                    for(size_t k = L.size() * i / numberOfThreads; k < end; k++)
+                        point[firstIndex + L[k]] = auxiliaryVariables[L[k]]->calculate(point);
+                });
+            }
+
+            for(auto& T : threads)
+                T.join();
+        }
     }
 
     if(this->auxiliaryObjectiveVariable)
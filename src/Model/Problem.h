@@ -18,10 +18,16 @@
 #include "AuxiliaryVariables.h"
 #include "ObjectiveFunction.h"
 #include "Constraints.h"
+#include "ModelArena.h"
 
+#include <atomic>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "cppad/cppad.hpp"
@@ -77,6 +83,14 @@ struct ProblemProperties
     bool isReformulated = false; // True if this is the reformulated problem
 };
 
+// A group of nonlinear constraints that has no variables in common with the other groups, except linking variables
+struct NonlinearConstraintBlock
+{
+    NonlinearConstraints constraints;
+    Variables variables; // The variables in the constraints sorted on index, including the linking variables
+    bool hasLinkingVariables = false;
+};
+
 struct SpecialOrderedSet
 {
     E_SOSType type = E_SOSType::One;
@@ -99,6 +113,76 @@ struct SpecialOrderedSet
 using SpecialOrderedSetPtr = std::shared_ptr<SpecialOrderedSet>;
 using SpecialOrderedSets = std::vector<SpecialOrderedSetPtr>;
 
+// The function values and gradients of the numeric constraints calculated in one point
+struct ConstraintEvaluations
+{
+    VectorDouble point;
+
+    std::mutex mutex;
+    std::unordered_map<const NumericConstraint*, double> functionValues;
+    std::unordered_map<const NumericConstraint*, SparseGradient> gradients;
+
+    // These calculate the value or gradient if it is not already stored
+    double calculateFunctionValue(NumericConstraint* constraint);
+    void calculateSparseGradient(NumericConstraint* constraint, SparseGradient& gradient);
+};
+
+using ConstraintEvaluationsPtr = std::shared_ptr<ConstraintEvaluations>;
+
+// A sparsity pattern in compressed sparse row format, where the column indexes of row i are stored in
+// columns[rowStarts[i]], ..., columns[rowStarts[i + 1] - 1], and the nonzero k of the pattern is element k in columns
+struct SparsityPatternCSR
+{
+    std::vector<int> rowStarts { 0 };
+    std::vector<int> columns;
+
+    inline size_t numberOfRows() const { return (rowStarts.size() - 1); };
+    inline size_t numberOfNonzeros() const { return (columns.size()); };
+
+    inline const int* rowBegin(size_t row) const { return (columns.data() + rowStarts[row]); };
+    inline const int* rowEnd(size_t row) const { return (columns.data() + rowStarts[row + 1]); };
+    inline size_t rowSize(size_t row) const { return (rowStarts[row + 1] - rowStarts[row]); };
+
+    void clear()
+    {
+        rowStarts.assign(1, 0);
+        columns.clear();
+    };
+};
+
+// The linear terms of Problem::linearConstraints as a matrix, where row i is constraint i and the coefficients are in
+// the order of the columns of the pattern, so that all the linear constraints are evaluated in one pass over the arrays
+struct LinearConstraintMatrixCSR
+{
+    SparsityPatternCSR pattern;
+    VectorDouble coefficients;
+
+    void clear()
+    {
+        pattern.clear();
+        coefficients.clear();
+    };
+};
+
+// The constraint evaluations in the points checked during the current iteration, so that a point used by several
+// tasks, e.g. when checking the termination criteria and then when creating a hyperplane, is only evaluated once. The
+// points are found by their hashes and then compared to the given point, so a hash collision cannot give wrong values.
+class ConstraintEvaluationCache
+{
+public:
+    // Returns the evaluations in the point, which are empty if the point has not been evaluated since the last clear
+    ConstraintEvaluationsPtr get(const VectorDouble& point, uint64_t pointHash);
+
+    void clear();
+
+    // The cache is cleared when this number of points is reached
+    size_t maxNumberOfPoints = 1000;
+
+private:
+    std::mutex mutex;
+    std::unordered_multimap<uint64_t, ConstraintEvaluationsPtr> points;
+};
+
 class DllExport Problem : public std::enable_shared_from_this<Problem>
 {
 private:
@@ -110,16 +194,189 @@ private:
     std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> constraintsHessianSparsityPattern;
     std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> lagrangianHessianSparsityPattern;
 
+    // Created in finalize() from the patterns above
+    SparsityPatternCSR jacobianSparsityPatternCSR;
+    SparsityPatternCSR lagrangianHessianSparsityPatternCSR;
+    void updateSparsityPatterns();
+
+    // Created in finalize() unless compact term storage is used, a row is not used if the terms of its constraint have
+    // been changed after that
+    LinearConstraintMatrixCSR linearConstraintMatrix;
+    void updateLinearConstraintMatrix();
+
+    // Orders the linear, quadratic and nonlinear constraint lists by the reverse Cuthill-McKee algorithm, so that
+    // constraints evaluated after each other share variables. The constraint indexes are not changed, so the results
+    // are given in the order of the original problem.
+    void reorderConstraints();
+
+    // Finds the deviating nonlinear constraints in the points with the nonlinear expressions first evaluated in single
+    // precision. Only the constraints that may be among the numberOfSelected most deviating ones in a point are
+    // evaluated again in double precision, and only these values are returned.
+    void screenDeviatingNonlinearConstraints(const std::vector<VectorDouble>& points, const PointBlock& pointBlock,
+        double tolerance, size_t numberOfSelected, double correction, const std::vector<bool>& isSkipped,
+        std::vector<NumericConstraintValues>& values);
+
+    // Returns which of the nonlinear constraints cannot deviate more than the tolerance in any of the points according
+    // to their interval values over the variable bounds, or an empty vector if a point is not within the bounds
+    std::vector<bool> getNonDeviatingNonlinearConstraints(
+        const std::vector<VectorDouble>& points, double tolerance, double correction);
+
+    template <typename T>
+    NumericConstraintValue getMaxNumericConstraintValueOrFirstViolation(
+        const VectorDouble& point, const std::vector<std::shared_ptr<T>>& constraintSelection, double tolerance);
+
     NonlinearConstraints constraintsWithNonlinearExpressions;
 
     void updateVariableBounds(); // This is called by updateVariables()
     void updateVariables();
     void updateConstraints();
+
+    // Analyses the convexity of the quadratic terms in the constraints in parallel, the terms that are equal to terms
+    // in an earlier constraint are not analysed again
+    void updateQuadraticConvexity();
+
+    // Determines the convexity of the constraints and objective function with unknown convexity numerically, by
+    // checking midpoint convexity and the second directional derivatives between random pairs of points within the
+    // variable bounds. The functions are analysed in parallel.
+    void updateConvexityBySampling();
+
     void updateConvexity();
     void updateFactorableFunctions();
+    void updateExpressionTapes();
+
+    // Replaces the structurally equal subexpressions in the nonlinear constraints and objective with shared instances
+    void shareCommonSubexpressions();
+
+    // The variables whose bounds doFBBTOnConstraint() can use or tighten, sorted on index
+    Variables getFBBTVariables(const NumericConstraintPtr& constraint);
+
+    // The constraints used in doFBBT() and how they are connected by their variables
+    struct FBBTPropagation
+    {
+        NumericConstraints constraints;
+        std::vector<Variables> constraintVariables;
+        std::vector<std::vector<size_t>> variableConstraints; // Indexes of the constraints with each variable
+        std::vector<std::vector<size_t>> components; // Groups of constraints without common variables
+        std::vector<size_t> positionInComponent;
+
+        int maxNumberOfPasses = 1;
+        double minimumImprovement = 0.0;
+        double timeEnd = 0.0;
+
+        std::atomic<bool> stopTightening { false };
+        std::atomic<int> numberOfVisitedConstraints { 0 };
+    };
+
+    void initializeFBBTPropagation(FBBTPropagation& propagation, bool useNonlinearBoundTightening);
+    std::vector<std::vector<size_t>> getFBBTComponents(const FBBTPropagation& propagation);
+
+    // Performs bound tightening passes on one component, returns the number of passes
+    int doFBBTOnComponent(FBBTPropagation& propagation, size_t componentIndex, bool updateOriginalProblem);
+
+    // Copies the tightened bounds of the original variables in the reformulated problem to the original problem
+    void updateOriginalProblemBounds();
+
+    std::unique_ptr<FBBTPropagation> incrementalFBBTPropagation;
+
+    // The constraints in incrementalFBBTPropagation that are still to be visited in an incremental bound tightening
+    struct FBBTQueue
+    {
+        std::deque<size_t> constraints;
+        std::vector<bool> isInQueue;
+        size_t numberOfVisits = 0;
+
+        bool checkFeasibility = false;
+        double feasibilityTolerance = 0.0;
+        bool updateOriginalProblem = true;
+    };
+
+    FBBTPropagation& getIncrementalFBBTPropagation();
+    void queueFBBTConstraints(const VariablePtr& variable, FBBTQueue& queue);
+
+    // Tightens the bounds using the constraint, and adds the constraints with an improved variable to the queue.
+    // Returns false if the feasibility is checked and the constraint cannot be fulfilled within the tightened bounds.
+    bool tightenAndQueueFBBTConstraints(
+        const NumericConstraintPtr& constraint, const Variables& variables, FBBTQueue& queue, double timeEnd);
+
+    // Visits the constraints in the queue until it is empty or the limits are reached, returns false on a conflict
+    bool propagateFBBTQueue(FBBTQueue& queue, double timeEnd);
+
+    // Rows are nonlinear expressions and columns nonlinear variables, created in updateFactorableFunctions()
+    CppAD::sparse_rc<std::vector<size_t>> nonlinearJacobianSparsityPattern;
+
+    // One copy of ADFunctions per CppAD thread number, created when first used by the thread
+    std::vector<std::unique_ptr<CppAD::ADFun<double>>> ADFunctionCopies;
+
+    // Used by calculateConstraintGradients() with the copy of ADFunctions of the same thread
+    struct ConstraintJacobianWorkspace
+    {
+        CppAD::sparse_jac_work work; // Caches the coloring while the same nonlinear expressions are differentiated
+        VectorInteger nonlinearExpressionIndexes;
+    };
+
+    // One workspace per CppAD thread number, cleared together with ADFunctionCopies
+    std::vector<std::unique_ptr<ConstraintJacobianWorkspace>> constraintJacobianWorkspaces;
+
+    // Used by calculateLagrangianHessian(), initialized on first use. The flag is set with release semantics after
+    // the positions and subsets have been written, so a thread that reads it as true with acquire semantics also sees
+    // them without taking the lock.
+    void initializeLagrangianHessianCalculation();
+    std::atomic<bool> lagrangianHessianCalculationInitialized { false };
+
+    // The position in the Lagrangian Hessian sparsity pattern of each pair of variable indexes
+    std::map<std::pair<int, int>, int> lagrangianHessianPositions;
+
+    // The Hessian of the weighted sum of all nonlinear expressions, and its upper triangular part which is calculated
+    CppAD::sparse_rc<std::vector<size_t>> nonlinearLagrangianHessianSparsityPattern;
+    CppAD::sparse_rc<std::vector<size_t>> nonlinearLagrangianHessianSubset;
+    std::vector<int> nonlinearLagrangianHessianPositions; // The position of each element of the subset
+
+    struct LagrangianHessianWorkspace
+    {
+        CppAD::sparse_hes_work work; // Caches the coloring between calls
+        CppAD::sparse_rcv<std::vector<size_t>, VectorDouble> subset;
+        VectorDouble point;
+        VectorDouble weights;
+    };
+
+    // One workspace per CppAD thread number
+    std::vector<std::unique_ptr<LagrangianHessianWorkspace>> lagrangianHessianWorkspaces;
 
     bool verifyOwnership();
 
+    bool useEvaluationCache = false; // Set in finalize()
+
+    // The positions in auxiliaryVariables grouped into levels, so that the variables in a level only depend on the
+    // original variables and the auxiliary variables in the earlier levels. Set in finalize().
+    std::vector<VectorInteger> auxiliaryVariableLevels;
+    size_t numberOfLeveledAuxiliaryVariables = 0;
+    int auxiliaryVariableNumberOfThreads = 1;
+    void updateAuxiliaryVariableLevels();
+
+    // Set in finalize(), the screening is only used if all nonlinear expressions in the constraints have tapes
+    bool useSinglePrecisionScreening = false;
+    double singlePrecisionScreeningTolerance = 1e-4;
+
+    // Set in finalize(), the threads are only started if there are enough points and constraints to evaluate
+    int batchedEvaluationNumberOfThreads = 1;
+
+    // Calculates the function values of the nonlinear constraints that are not skipped in all points of the block, the
+    // values of the constraint in position k in nonlinearConstraints are stored from functionValues[k * points]. If a
+    // single precision block is given, the approximate function values are calculated.
+    void calculateNonlinearConstraintFunctionValues(const PointBlock& pointBlock,
+        const PointBlockFloat* singlePrecisionPointBlock, const std::vector<bool>& isSkipped,
+        VectorDouble& functionValues);
+
+    // Set in finalize(), the interval values of the nonlinear constraints over the variable bounds, which are widened
+    // slightly so that points just outside of the bounds are also covered. Updated when needed after a bound change,
+    // which may be made by several threads at the same time, e.g. by the parallel FBBT on the components.
+    bool useIntervalScreening = false;
+    std::atomic<bool> isIntervalScreeningUpdated = false;
+    std::vector<Interval> nonlinearConstraintIntervalValues; // In the order of nonlinearConstraints
+    VectorDouble intervalScreeningLowerBounds;
+    VectorDouble intervalScreeningUpperBounds;
+    void updateIntervalScreening();
+
 public:
     EnvironmentPtr env;
 
@@ -130,6 +387,9 @@ public:
     ProblemProperties properties;
     std::string name = "";
 
+    // Used for creating the variables, terms and nonlinear expressions of the problem
+    ModelArena arena;
+
     Variables allVariables;
     Variables realVariables;
     Variables binaryVariables;
@@ -144,9 +404,14 @@ public:
 
     VariablePtr antiEpigraphObjectiveVariable; // This is the objective variable used before anti epigraph formulation
 
+    // The bounds and types of all variables in index order, used in the loops over all variables instead of the
+    // variable objects. They are updated by the functions below that set bounds, and synchronizeVariableBounds()
+    // must be called if the bounds of a variable object are changed directly.
     VectorDouble variableLowerBounds;
     VectorDouble variableUpperBounds;
     IntervalVector variableBounds;
+    std::vector<E_VariableType> variableTypes;
+    VectorDouble variableSemiBounds;
 
     ObjectiveFunctionPtr objectiveFunction;
 
@@ -157,10 +422,41 @@ public:
 
     SpecialOrderedSets specialOrderedSets;
 
+    // Whether the NLP solvers use a quasi-Newton approximation instead of the exact Lagrangian Hessian when this is
+    // selected automatically: -1 if not decided yet, 0 for the exact Hessian and 1 for the approximation. It is decided
+    // by the first solver instance that has measured the Hessian, and then used for all later solves of the problem.
+    std::atomic<int> useHessianApproximation = -1;
+
     std::vector<CppAD::AD<double>> factorableFunctionVariables;
     std::vector<CppAD::AD<double>> factorableFunctions;
     CppAD::ADFun<double> ADFunctions;
 
+    // The recordings of the nonlinear expressions of single constraints temporarily replace the factorable function
+    // variables of the problem, so they are made one at a time. CppAD records on a tape per thread, so the recordings
+    // in other problems, e.g. of other solvers in the same process, do not need to wait for these.
+    std::mutex nonlinearExpressionRecordingMutex;
+
+    // CppAD stores the Taylor coefficients of the last evaluation in the function object, so each thread evaluates and
+    // differentiates its own copy of ADFunctions, which is returned here. ADFunctions itself is only used for copying.
+    CppAD::ADFun<double>& getADFunctions();
+
+    // Returns the copy of a recorded function belonging to the calling thread, copies must have room for
+    // CPPAD_MAX_NUM_THREADS elements
+    static CppAD::ADFun<double>& getThreadCopy(
+        CppAD::ADFun<double>& function, std::vector<std::unique_ptr<CppAD::ADFun<double>>>& copies);
+
+    // Must be held while the calling thread uses CppAD for evaluations or sparsity patterns. It only locks if the
+    // thread shares its CppAD thread number with other threads, i.e. when more than CPPAD_MAX_NUM_THREADS - 1 threads
+    // are using CppAD at the same time.
+    static std::unique_lock<std::recursive_mutex> lockCppADEvaluation();
+
+    // The bytes of the operation sequence of a recorded function and of the copies made by getThreadCopy()
+    static size_t getRecordingMemoryUsage(
+        const CppAD::ADFun<double>& function, const std::vector<std::unique_ptr<CppAD::ADFun<double>>>& copies);
+
+    // As above for ADFunctions and its copies
+    size_t getADFunctionsMemoryUsage() const;
+
     void updateProperties();
 
     // This also updates the problem properties
@@ -203,10 +499,64 @@ public:
     void setVariableUpperBound(int variableIndex, double bound);
     void setVariableBounds(int variableIndex, double lowerBound, double upperBound);
 
+    // Copies the bounds of the variable object to the bound vectors
+    void synchronizeVariableBounds(int variableIndex);
+
+    // Projects the values of the real, binary and integer variables to their bounds, the integer values to the nearest
+    // integer within the bounds. The semicontinuous and semiinteger variables are not changed. Returns false if a value
+    // was projected.
+    bool projectToVariableBounds(VectorDouble& point);
+
+    // The connected components of the incidence graph of the nonlinear constraints and their variables. A variable in
+    // more constraints than the threshold is a linking variable that does not join constraints, with 0 there are no
+    // linking variables. The constraints keep their order within the blocks.
+    std::vector<NonlinearConstraintBlock> getNonlinearConstraintBlocks(int linkingVariableThreshold);
+
     std::shared_ptr<std::vector<std::pair<NumericConstraintPtr, Variables>>> getConstraintsJacobianSparsityPattern();
     std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> getConstraintsHessianSparsityPattern();
     std::shared_ptr<std::vector<std::pair<VariablePtr, VariablePtr>>> getLagrangianHessianSparsityPattern();
 
+    // The rows of the Jacobian are the numeric constraints, with the variable indexes in the order of
+    // NumericConstraint::calculateSparseGradient(). The rows of the Lagrangian Hessian are variable indexes, and only
+    // the upper triangular part is included, in the order of calculateLagrangianHessian(). Both are set in finalize().
+    inline const SparsityPatternCSR& getJacobianSparsityPatternCSR() const { return (jacobianSparsityPatternCSR); };
+    inline const SparsityPatternCSR& getLagrangianHessianSparsityPatternCSR() const
+    {
+        return (lagrangianHessianSparsityPatternCSR);
+    };
+
+    // Calculates the upper triangular part of the Hessian of objectiveFactor * f(x) + sum_i multipliers[i] * g_i(x),
+    // where the multipliers are indexed by the constraint indexes. The values are written in the order of
+    // getLagrangianHessianSparsityPattern(), and the nonlinear expressions are differentiated in one sweep.
+    void calculateLagrangianHessian(
+        const VectorDouble& point, double objectiveFactor, const double* multipliers, double* values);
+
+    // Calculates the gradients of several constraints in the same point, in the layout of calculateSparseGradient().
+    // The nonlinear expressions that are not recorded separately are differentiated together using a coloring of the
+    // rows of the Jacobian, so constraints without common nonlinear variables share the same reverse sweep.
+    std::vector<SparseGradient> calculateConstraintGradients(
+        const VectorDouble& point, const NumericConstraints& constraints);
+
+    // Cleared by TaskInitializeIteration at the start of each iteration
+    ConstraintEvaluationCache evaluationCache;
+
+    // Set in finalize() from CompactTermStorage.Use before the properties are updated. The packed terms of the
+    // constraints then use coefficient dictionaries, and the linear constraint matrix is not created since the linear
+    // constraints are evaluated from their packed terms.
+    bool useCompactTermStorage = false;
+
+    // Returns the cached evaluations in the point, or nullptr if the cache is not used. The hash should be calculated
+    // with Utilities::calculateHash(point) if given.
+    ConstraintEvaluationsPtr getConstraintEvaluations(
+        const VectorDouble& point, std::optional<uint64_t> pointHash = std::nullopt);
+
+    // As NumericConstraint::calculateNumericValue() and calculateSparseGradient(), but the values are taken from or
+    // stored in the evaluations if given
+    NumericConstraintValue calculateNumericValue(NumericConstraint* constraint, const VectorDouble& point,
+        const ConstraintEvaluationsPtr& evaluations, double correction = 0.0);
+    void calculateSparseGradient(NumericConstraint* constraint, const VectorDouble& point, SparseGradient& gradient,
+        const ConstraintEvaluationsPtr& evaluations);
+
     std::optional<NumericConstraintValue> getMostDeviatingNumericConstraint(const VectorDouble& point);
     std::optional<NumericConstraintValue> getMostDeviatingNonlinearOrQuadraticConstraint(const VectorDouble& point);
     std::optional<NumericConstraintValue> getMostDeviatingNonlinearConstraint(const VectorDouble& point);
@@ -239,6 +589,15 @@ public:
     NumericConstraintValue getMaxNumericConstraintValue(const VectorDouble& point,
         const std::vector<NumericConstraint*>& constraintSelection, std::vector<NumericConstraint*>& activeConstraints);
 
+    // As getMaxNumericConstraintValue(), but returns the first constraint with an error larger than the tolerance
+    // without evaluating the remaining ones, so that an infeasible point is rejected early. The linear constraints are
+    // evaluated with the matrix created in finalize(), or from their packed terms if it is not created.
+    NumericConstraintValue getMaxLinearConstraintValueOrFirstViolation(const VectorDouble& point, double tolerance);
+    NumericConstraintValue getMaxNumericConstraintValueOrFirstViolation(
+        const VectorDouble& point, const QuadraticConstraints& constraintSelection, double tolerance);
+    NumericConstraintValue getMaxNumericConstraintValueOrFirstViolation(
+        const VectorDouble& point, const NonlinearConstraints& constraintSelection, double tolerance);
+
     template <typename T>
     NumericConstraintValues getAllDeviatingConstraints(
         const VectorDouble& point, double tolerance, std::vector<T> constraintSelection, double correction = 0.0);
@@ -246,6 +605,11 @@ public:
     NumericConstraintValues getFractionOfDeviatingNonlinearConstraints(
         const VectorDouble& point, double tolerance, double fraction, double correction = 0.0);
 
+    // Batched version of the above, the constraints are evaluated in all points at once and one set of values is
+    // returned for each point
+    std::vector<NumericConstraintValues> getFractionOfDeviatingNonlinearConstraints(
+        const std::vector<VectorDouble>& points, double tolerance, double fraction, double correction = 0.0);
+
     virtual NumericConstraintValues getAllDeviatingNumericConstraints(const VectorDouble& point, double tolerance);
 
     virtual NumericConstraintValues getAllDeviatingLinearConstraints(const VectorDouble& point, double tolerance);
@@ -265,19 +629,31 @@ public:
 
     virtual bool areSpecialOrderedSetsFulfilled(VectorDouble point, double tolerance);
 
-    bool areVariableBoundsFulfilled(VectorDouble point, double tolerance);
+    bool areVariableBoundsFulfilled(const VectorDouble& point, double tolerance);
 
     void saveProblemToFile(std::string filename);
 
     void doFBBT();
-    bool doFBBTOnConstraint(NumericConstraintPtr constraint, double timeLimit);
+
+    // Tightens the bounds using a constraint not in the problem, e.g. an objective cutoff, and propagates the changes
+    // to the constraints in the problem. Returns the variables whose bounds have been tightened.
+    Variables doIncrementalFBBT(NumericConstraintPtr constraint, double timeLimit);
+
+    // Propagates the changed bounds of the variables, e.g. when they have been fixed in a heuristic, to the
+    // constraints in the problem without updating the original problem. Returns false if a constraint is found that
+    // cannot be fulfilled within the tightened bounds. The caller is responsible for restoring the bounds.
+    bool propagateVariableBounds(const Variables& variables, double timeLimit);
+
+    // The time end is a deadline on the BoundTightening timer, which accumulates over all bound tightening calls
+    bool doFBBTOnConstraint(NumericConstraintPtr constraint, double timeEnd, bool updateOriginalProblem = true);
 
     void augmentAuxiliaryVariableValues(VectorDouble& point);
 
     friend std::ostream& operator<<(std::ostream& stream, const Problem& problem);
 
+    // If withoutObjective is set, the copy gets an empty linear objective function, e.g. to be replaced later on
     ProblemPtr createCopy(EnvironmentPtr destinationEnv, bool integerRelaxed = false, bool convexityRelaxed = false,
-        bool copyAuxiliary = false);
+        bool copyAuxiliary = false, bool withoutObjective = false);
 };
 
 inline std::ostream& operator<<(std::ostream& stream, ProblemPtr problem)
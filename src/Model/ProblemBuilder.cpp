@@ -0,0 +1,361 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "ProblemBuilder.h"
+
+#include "../Output.h"
+#include "../Settings.h"
+
+#include "Constraints.h"
+#include "Problem.h"
+#include "Simplifications.h"
+#include "Terms.h"
+#include "Variables.h"
+
+#include "spdlog/fmt/fmt.h"
+
+namespace SHOT
+{
+
+void ProblemBuilder::setVariables(
+    VectorDouble lowerBounds, VectorDouble upperBounds, std::vector<E_VariableType> types, VectorString names)
+{
+    variableLowerBounds = std::move(lowerBounds);
+    variableUpperBounds = std::move(upperBounds);
+    variableTypes = std::move(types);
+    variableNames = std::move(names);
+}
+
+void ProblemBuilder::setConstraints(VectorDouble lowerBounds, VectorDouble upperBounds, VectorString names)
+{
+    constraintLowerBounds = std::move(lowerBounds);
+    constraintUpperBounds = std::move(upperBounds);
+    constraintNames = std::move(names);
+}
+
+void ProblemBuilder::setLinearTerms(VectorInteger rowStarts, VectorInteger variableIndexes, VectorDouble coefficients)
+{
+    linearRowStarts = std::move(rowStarts);
+    linearVariableIndexes = std::move(variableIndexes);
+    linearCoefficients = std::move(coefficients);
+}
+
+void ProblemBuilder::setObjective(
+    E_ObjectiveFunctionDirection direction, VectorInteger variableIndexes, VectorDouble coefficients, double constant)
+{
+    objectiveDirection = direction;
+    objectiveVariableIndexes = std::move(variableIndexes);
+    objectiveCoefficients = std::move(coefficients);
+    objectiveConstant = constant;
+}
+
+void ProblemBuilder::setQuadraticTerms(VectorInteger rows, VectorInteger firstVariableIndexes,
+    VectorInteger secondVariableIndexes, VectorDouble coefficients)
+{
+    quadraticRows = std::move(rows);
+    quadraticFirstVariableIndexes = std::move(firstVariableIndexes);
+    quadraticSecondVariableIndexes = std::move(secondVariableIndexes);
+    quadraticCoefficients = std::move(coefficients);
+}
+
+void ProblemBuilder::setNonlinearExpressions(VectorInteger rows, VectorInteger expressionStarts,
+    std::vector<E_NonlinearExpressionTypes> opcodes, VectorDouble operands)
+{
+    nonlinearRows = std::move(rows);
+    nonlinearExpressionStarts = std::move(expressionStarts);
+    nonlinearOpcodes = std::move(opcodes);
+    nonlinearOperands = std::move(operands);
+}
+
+ProblemPtr ProblemBuilder::build(std::string name)
+{
+    size_t numberOfVariables = variableTypes.size();
+    int numberOfConstraints = constraintLowerBounds.size();
+
+    if(numberOfVariables == 0)
+        throw Exception("No variables defined.");
+
+    if(variableLowerBounds.size() != numberOfVariables || variableUpperBounds.size() != numberOfVariables
+        || (!variableNames.empty() && variableNames.size() != numberOfVariables))
+        throw Exception("The variable bounds, types and names are not of the same size.");
+
+    if(constraintUpperBounds.size() != constraintLowerBounds.size()
+        || (!constraintNames.empty() && (int)constraintNames.size() != numberOfConstraints))
+        throw Exception("The constraint bounds and names are not of the same size.");
+
+    auto checkVariableIndex = [&](int index) {
+        if(index < 0 || index >= (int)numberOfVariables)
+            throw Exception(fmt::format("Variable index {} out of range.", index));
+    };
+
+    auto checkRow = [&](int row) {
+        if(row < -1 || row >= numberOfConstraints)
+            throw Exception(fmt::format("Constraint index {} out of range.", row));
+    };
+
+    auto problem = std::make_shared<Problem>(env);
+    problem->name = name;
+
+    Variables variables;
+    variables.reserve(numberOfVariables);
+
+    for(size_t i = 0; i < numberOfVariables; i++)
+    {
+        variables.push_back(problem->arena.create<Variable>(
+            variableNames.empty() ? fmt::format("x{}", i) : variableNames[i], (int)i, variableTypes[i],
+            variableLowerBounds[i], variableUpperBounds[i]));
+    }
+
+    problem->add(std::move(variables));
+
+    // The nonlinear expressions decide the types of the constraints and the objective function
+    if(nonlinearRows.size() > 0 && nonlinearExpressionStarts.size() != nonlinearRows.size() + 1)
+        throw Exception("There should be one more start index than rows of the nonlinear expressions.");
+
+    std::vector<NonlinearExpressionPtr> nonlinearExpressions(numberOfConstraints + 1);
+
+    for(size_t k = 0; k < nonlinearRows.size(); k++)
+    {
+        checkRow(nonlinearRows[k]);
+
+        auto expression = createNonlinearExpression(
+            problem, nonlinearExpressionStarts[k], nonlinearExpressionStarts[k + 1]);
+        auto& rowExpression = nonlinearExpressions[nonlinearRows[k] + 1];
+
+        if(rowExpression)
+            rowExpression = problem->arena.create<ExpressionSum>(rowExpression, expression);
+        else
+            rowExpression = expression;
+    }
+
+    if(quadraticFirstVariableIndexes.size() != quadraticRows.size()
+        || quadraticSecondVariableIndexes.size() != quadraticRows.size()
+        || quadraticCoefficients.size() != quadraticRows.size())
+        throw Exception("The quadratic term arrays are not of the same size.");
+
+    std::vector<bool> containsQuadraticTerms(numberOfConstraints + 1, false);
+
+    for(auto R : quadraticRows)
+    {
+        checkRow(R);
+        containsQuadraticTerms[R + 1] = true;
+    }
+
+    for(int i = 0; i < numberOfConstraints; i++)
+    {
+        auto constraintName = constraintNames.empty() ? fmt::format("c{}", i) : constraintNames[i];
+        auto& nonlinearExpression = nonlinearExpressions[i + 1];
+
+        if(nonlinearExpression)
+            problem->add(std::make_shared<NonlinearConstraint>(
+                i, constraintName, nonlinearExpression, constraintLowerBounds[i], constraintUpperBounds[i]));
+        else if(containsQuadraticTerms[i + 1])
+            problem->add(std::make_shared<QuadraticConstraint>(
+                i, constraintName, constraintLowerBounds[i], constraintUpperBounds[i]));
+        else
+            problem->add(std::make_shared<LinearConstraint>(
+                i, constraintName, constraintLowerBounds[i], constraintUpperBounds[i]));
+    }
+
+    if(nonlinearExpressions[0])
+        problem->add(std::make_shared<NonlinearObjectiveFunction>(
+            objectiveDirection, nonlinearExpressions[0], objectiveConstant));
+    else if(containsQuadraticTerms[0])
+        problem->add(std::make_shared<QuadraticObjectiveFunction>(objectiveDirection, objectiveConstant));
+    else
+        problem->add(std::make_shared<LinearObjectiveFunction>(objectiveDirection, objectiveConstant));
+
+    if(objectiveCoefficients.size() != objectiveVariableIndexes.size())
+        throw Exception("The objective function coefficients and variable indexes are not of the same size.");
+
+    auto objective = std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction);
+
+    for(size_t k = 0; k < objectiveVariableIndexes.size(); k++)
+    {
+        checkVariableIndex(objectiveVariableIndexes[k]);
+        objective->add(problem->arena.create<LinearTerm>(
+            objectiveCoefficients[k], problem->allVariables[objectiveVariableIndexes[k]]));
+    }
+
+    for(size_t k = 0; k < quadraticRows.size(); k++)
+    {
+        checkVariableIndex(quadraticFirstVariableIndexes[k]);
+        checkVariableIndex(quadraticSecondVariableIndexes[k]);
+
+        auto term = problem->arena.create<QuadraticTerm>(quadraticCoefficients[k],
+            problem->allVariables[quadraticFirstVariableIndexes[k]],
+            problem->allVariables[quadraticSecondVariableIndexes[k]]);
+
+        if(quadraticRows[k] == -1)
+            std::dynamic_pointer_cast<QuadraticObjectiveFunction>(problem->objectiveFunction)->add(term);
+        else
+            std::dynamic_pointer_cast<QuadraticConstraint>(problem->numericConstraints[quadraticRows[k]])->add(term);
+    }
+
+    if(linearVariableIndexes.size() != linearCoefficients.size()
+        || (linearVariableIndexes.size() > 0 && (int)linearRowStarts.size() != numberOfConstraints + 1))
+        throw Exception("The linear terms are not in compressed sparse row format.");
+
+    for(int i = 0; i < numberOfConstraints && linearVariableIndexes.size() > 0; i++)
+    {
+        if(linearRowStarts[i] < 0 || linearRowStarts[i] > linearRowStarts[i + 1]
+            || linearRowStarts[i + 1] > (int)linearVariableIndexes.size())
+            throw Exception(fmt::format("The start index of the linear terms in constraint {} is not valid.", i));
+
+        auto constraint = std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[i]);
+
+        for(int k = linearRowStarts[i]; k < linearRowStarts[i + 1]; k++)
+        {
+            checkVariableIndex(linearVariableIndexes[k]);
+            constraint->add(problem->arena.create<LinearTerm>(
+                linearCoefficients[k], problem->allVariables[linearVariableIndexes[k]]));
+        }
+    }
+
+    problem->updateProperties();
+
+    bool extractMonomialTerms = env->settings->getSetting<bool>("Reformulation.Monomials.Extract", "Model");
+    bool extractSignomialTerms = env->settings->getSetting<bool>("Reformulation.Signomials.Extract", "Model");
+    bool extractQuadraticTerms = (env->settings->getSetting<int>("Reformulation.Quadratics.ExtractStrategy", "Model")
+        >= static_cast<int>(ES_QuadraticTermsExtractStrategy::ExtractTermsToSame));
+
+    simplifyNonlinearExpressions(problem, extractMonomialTerms, extractSignomialTerms, extractQuadraticTerms);
+
+    problem->finalize();
+
+    return (problem);
+}
+
+NonlinearExpressionPtr ProblemBuilder::createNonlinearExpression(ProblemPtr problem, int start, int end)
+{
+    if(start < 0 || start >= end || end > (int)nonlinearOpcodes.size()
+        || nonlinearOperands.size() != nonlinearOpcodes.size())
+        throw Exception(fmt::format("The nonlinear expression instructions {} to {} are not valid.", start, end - 1));
+
+    std::vector<NonlinearExpressionPtr> stack;
+
+    auto pop = [&]() {
+        if(stack.empty())
+            throw Exception("Too few arguments in nonlinear expression.");
+
+        auto expression = stack.back();
+        stack.pop_back();
+
+        return (expression);
+    };
+
+    auto& arena = problem->arena;
+
+    for(int k = start; k < end; k++)
+    {
+        double operand = nonlinearOperands[k];
+
+        switch(nonlinearOpcodes[k])
+        {
+        case E_NonlinearExpressionTypes::Constant:
+            stack.push_back(arena.create<ExpressionConstant>(operand));
+            break;
+        case E_NonlinearExpressionTypes::Variable:
+        {
+            int index = (int)operand;
+
+            if(index < 0 || index >= (int)problem->allVariables.size())
+                throw Exception(fmt::format("Variable index {} out of range in nonlinear expression.", index));
+
+            stack.push_back(arena.create<ExpressionVariable>(problem->allVariables[index]));
+            break;
+        }
+        case E_NonlinearExpressionTypes::Negate:
+            stack.push_back(arena.create<ExpressionNegate>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Invert:
+            stack.push_back(arena.create<ExpressionInvert>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::SquareRoot:
+            stack.push_back(arena.create<ExpressionSquareRoot>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Log:
+            stack.push_back(arena.create<ExpressionLog>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Exp:
+            stack.push_back(arena.create<ExpressionExp>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Square:
+            stack.push_back(arena.create<ExpressionSquare>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Cos:
+            stack.push_back(arena.create<ExpressionCos>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Sin:
+            stack.push_back(arena.create<ExpressionSin>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Tan:
+            stack.push_back(arena.create<ExpressionTan>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::ArcCos:
+            stack.push_back(arena.create<ExpressionArcCos>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::ArcSin:
+            stack.push_back(arena.create<ExpressionArcSin>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::ArcTan:
+            stack.push_back(arena.create<ExpressionArcTan>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Abs:
+            stack.push_back(arena.create<ExpressionAbs>(pop()));
+            break;
+        case E_NonlinearExpressionTypes::Divide:
+        {
+            auto denominator = pop();
+            auto numerator = pop();
+            stack.push_back(arena.create<ExpressionDivide>(numerator, denominator));
+            break;
+        }
+        case E_NonlinearExpressionTypes::Power:
+        {
+            auto exponent = pop();
+            auto base = pop();
+            stack.push_back(arena.create<ExpressionPower>(base, exponent));
+            break;
+        }
+        case E_NonlinearExpressionTypes::Sum:
+        case E_NonlinearExpressionTypes::Product:
+        {
+            int numberOfArguments = (int)operand;
+
+            if(numberOfArguments < 0 || numberOfArguments > (int)stack.size())
+                throw Exception("Too few arguments in nonlinear expression.");
+
+            NonlinearExpressions arguments;
+            arguments.reserve(numberOfArguments);
+
+            for(auto E = stack.end() - numberOfArguments; E != stack.end(); E++)
+                arguments.push_back(*E);
+
+            stack.resize(stack.size() - numberOfArguments);
+
+            if(nonlinearOpcodes[k] == E_NonlinearExpressionTypes::Sum)
+                stack.push_back(arena.create<ExpressionSum>(arguments));
+            else
+                stack.push_back(arena.create<ExpressionProduct>(arguments));
+
+            break;
+        }
+        default:
+            throw Exception("Unknown instruction in nonlinear expression.");
+        }
+    }
+
+    if(stack.size() != 1)
+        throw Exception("The instructions of a nonlinear expression do not give one expression.");
+
+    return (stack.back());
+}
+} // namespace SHOT
@@ -0,0 +1,96 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Environment.h"
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include "NonlinearExpressions.h"
+#include "ObjectiveFunction.h"
+
+#include <string>
+#include <vector>
+
+namespace SHOT
+{
+
+// Creates a problem from arrays in one pass, e.g. when a model is generated by another program, so that neither a
+// problem file nor the objects for each variable, constraint and term need to be created by the caller. The data is
+// given with the set methods, after which build() creates, simplifies and finalizes the problem in the same way as
+// when it is read from a file. The index -1 denotes the objective function when a row is given.
+class ProblemBuilder
+{
+public:
+    ProblemBuilder(EnvironmentPtr envPtr) : env(envPtr) { }
+
+    // The variables get the indexes 0,...,n-1 in the given order, and the names x0, x1, ... if no names are given
+    void setVariables(VectorDouble lowerBounds, VectorDouble upperBounds, std::vector<E_VariableType> types,
+        VectorString names = {});
+
+    // The constraints lowerBound <= g(x) <= upperBound, with the names c0, c1, ... if no names are given
+    void setConstraints(VectorDouble lowerBounds, VectorDouble upperBounds, VectorString names = {});
+
+    // The linear terms of the constraints in compressed sparse row format, i.e. the terms of constraint i are
+    // rowStarts[i] to rowStarts[i + 1] - 1 in the other arrays
+    void setLinearTerms(VectorInteger rowStarts, VectorInteger variableIndexes, VectorDouble coefficients);
+
+    void setObjective(E_ObjectiveFunctionDirection direction, VectorInteger variableIndexes, VectorDouble coefficients,
+        double constant = 0.0);
+
+    // The quadratic terms in coordinate format, i.e. term k is coefficients[k] * x[firstVariableIndexes[k]] *
+    // x[secondVariableIndexes[k]] in row rows[k]
+    void setQuadraticTerms(VectorInteger rows, VectorInteger firstVariableIndexes, VectorInteger secondVariableIndexes,
+        VectorDouble coefficients);
+
+    // The nonlinear expressions in postfix order, i.e. the instructions of the expression in row rows[k] are
+    // expressionStarts[k] to expressionStarts[k + 1] - 1. The operand is the value of a constant, the index of a
+    // variable and the number of arguments of a sum or a product, and not used for other instructions.
+    void setNonlinearExpressions(VectorInteger rows, VectorInteger expressionStarts,
+        std::vector<E_NonlinearExpressionTypes> opcodes, VectorDouble operands);
+
+    // Throws an exception if the data is inconsistent
+    ProblemPtr build(std::string name = "");
+
+private:
+    EnvironmentPtr env;
+
+    VectorDouble variableLowerBounds;
+    VectorDouble variableUpperBounds;
+    std::vector<E_VariableType> variableTypes;
+    VectorString variableNames;
+
+    VectorDouble constraintLowerBounds;
+    VectorDouble constraintUpperBounds;
+    VectorString constraintNames;
+
+    VectorInteger linearRowStarts;
+    VectorInteger linearVariableIndexes;
+    VectorDouble linearCoefficients;
+
+    E_ObjectiveFunctionDirection objectiveDirection = E_ObjectiveFunctionDirection::Minimize;
+    VectorInteger objectiveVariableIndexes;
+    VectorDouble objectiveCoefficients;
+    double objectiveConstant = 0.0;
+
+    VectorInteger quadraticRows;
+    VectorInteger quadraticFirstVariableIndexes;
+    VectorInteger quadraticSecondVariableIndexes;
+    VectorDouble quadraticCoefficients;
+
+    VectorInteger nonlinearRows;
+    VectorInteger nonlinearExpressionStarts;
+    std::vector<E_NonlinearExpressionTypes> nonlinearOpcodes;
+    VectorDouble nonlinearOperands;
+
+    NonlinearExpressionPtr createNonlinearExpression(ProblemPtr problem, int start, int end);
+};
+} // namespace SHOT
@@ -13,6 +13,8 @@
 
 #include "spdlog/fmt/fmt.h"
 
+#include <iterator>
+
 namespace SHOT
 {
 
@@ -371,12 +373,23 @@ void simplifyNonlinearExpressions(
     }
 }
 
+// Creates the expression node in the arena of the destination problem, if there is one
+template <typename T, typename... Args> std::shared_ptr<T> createExpression(Problem* destination, Args&&... args)
+{
+    if(destination != nullptr)
+        return (destination->arena.create<T>(std::forward<Args>(args)...));
+
+    return (std::make_shared<T>(std::forward<Args>(args)...));
+}
+
 NonlinearExpressionPtr copyNonlinearExpression(NonlinearExpression* expression, const ProblemPtr destination)
 {
     return copyNonlinearExpression(expression, destination.get());
 }
 
-NonlinearExpressionPtr copyNonlinearExpression(NonlinearExpression* expression, Problem* destination)
+// Copies the node itself, the children are copied using copyNonlinearExpression()
+NonlinearExpressionPtr copyNonlinearExpressionNode(
+    NonlinearExpression* expression, Problem* destination, NonlinearExpressionCopies* copies)
 {
     std::ostringstream outStr;
     int numChildren;
@@ -391,38 +404,39 @@ NonlinearExpressionPtr copyNonlinearExpression(NonlinearExpression* expression,
         {
         case 0:
         {
-            return std::make_shared<ExpressionConstant>(0.);
+            return createExpression<ExpressionConstant>(destination, 0.);
         }
         case 1:
         {
-            return copyNonlinearExpression(((ExpressionSum*)expression)->children[0].get(), destination);
+            return copyNonlinearExpression(((ExpressionSum*)expression)->children[0].get(), destination, copies);
         }
         default:
         {
             NonlinearExpressions terms;
             for(int i = 0; i < numChildren; i++)
-                terms.push_back(copyNonlinearExpression(((ExpressionSum*)expression)->children[i].get(), destination));
+                terms.push_back(
+                    copyNonlinearExpression(((ExpressionSum*)expression)->children[i].get(), destination, copies));
 
-            return std::make_shared<ExpressionSum>(terms);
+            return createExpression<ExpressionSum>(destination, terms);
         }
         }
     }
     case E_NonlinearExpressionTypes::Negate:
     {
-        return std::make_shared<ExpressionNegate>(
-            copyNonlinearExpression(((ExpressionNegate*)expression)->child.get(), destination));
+        return createExpression<ExpressionNegate>(destination,
+            copyNonlinearExpression(((ExpressionNegate*)expression)->child.get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Divide:
     {
-        return std::make_shared<ExpressionDivide>(
-            copyNonlinearExpression(((ExpressionDivide*)expression)->firstChild.get(), destination),
-            copyNonlinearExpression(((ExpressionDivide*)expression)->secondChild.get(), destination));
+        return createExpression<ExpressionDivide>(destination,
+            copyNonlinearExpression(((ExpressionDivide*)expression)->firstChild.get(), destination, copies),
+            copyNonlinearExpression(((ExpressionDivide*)expression)->secondChild.get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Power:
     {
-        return std::make_shared<ExpressionPower>(
-            copyNonlinearExpression(((ExpressionPower*)expression)->firstChild.get(), destination),
-            copyNonlinearExpression(((ExpressionPower*)expression)->secondChild.get(), destination));
+        return createExpression<ExpressionPower>(destination,
+            copyNonlinearExpression(((ExpressionPower*)expression)->firstChild.get(), destination, copies),
+            copyNonlinearExpression(((ExpressionPower*)expression)->secondChild.get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Product:
     {
@@ -431,86 +445,87 @@ NonlinearExpressionPtr copyNonlinearExpression(NonlinearExpression* expression,
         {
         case 0:
         {
-            return std::make_shared<ExpressionConstant>(0.);
+            return createExpression<ExpressionConstant>(destination, 0.);
         }
         case 1:
         {
-            return copyNonlinearExpression(((ExpressionProduct*)expression)->children[0].get(), destination);
+            return copyNonlinearExpression(((ExpressionProduct*)expression)->children[0].get(), destination, copies);
         }
         default:
         {
             NonlinearExpressions factors;
             for(int i = 0; i < numChildren; i++)
                 factors.push_back(
-                    copyNonlinearExpression(((ExpressionProduct*)expression)->children[i].get(), destination));
+                    copyNonlinearExpression(((ExpressionProduct*)expression)->children[i].get(), destination, copies));
 
-            return std::make_shared<ExpressionProduct>(factors);
+            return createExpression<ExpressionProduct>(destination, factors);
         }
         }
     }
     case E_NonlinearExpressionTypes::Abs:
     {
-        return std::make_shared<ExpressionAbs>(
-            copyNonlinearExpression((((ExpressionAbs*)expression)->child).get(), destination));
+        return createExpression<ExpressionAbs>(destination,
+            copyNonlinearExpression((((ExpressionAbs*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Square:
     {
-        return std::make_shared<ExpressionSquare>(
-            copyNonlinearExpression((((ExpressionSquare*)expression)->child).get(), destination));
+        return createExpression<ExpressionSquare>(destination,
+            copyNonlinearExpression((((ExpressionSquare*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::SquareRoot:
     {
-        return std::make_shared<ExpressionSquareRoot>(
-            copyNonlinearExpression((((ExpressionSquareRoot*)expression)->child).get(), destination));
+        return createExpression<ExpressionSquareRoot>(destination,
+            copyNonlinearExpression((((ExpressionSquareRoot*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Invert:
     {
-        return std::make_shared<ExpressionInvert>(
-            copyNonlinearExpression((((ExpressionInvert*)expression)->child).get(), destination));
+        return createExpression<ExpressionInvert>(destination,
+            copyNonlinearExpression((((ExpressionInvert*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Log:
     {
-        return std::make_shared<ExpressionLog>(
-            copyNonlinearExpression((((ExpressionLog*)expression)->child).get(), destination));
+        return createExpression<ExpressionLog>(destination,
+            copyNonlinearExpression((((ExpressionLog*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Exp:
     {
-        return std::make_shared<ExpressionExp>(
-            copyNonlinearExpression((((ExpressionExp*)expression)->child).get(), destination));
+        return createExpression<ExpressionExp>(destination,
+            copyNonlinearExpression((((ExpressionExp*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Sin:
     {
-        return std::make_shared<ExpressionSin>(
-            copyNonlinearExpression((((ExpressionSin*)expression)->child).get(), destination));
+        return createExpression<ExpressionSin>(destination,
+            copyNonlinearExpression((((ExpressionSin*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Cos:
     {
-        return std::make_shared<ExpressionCos>(
-            copyNonlinearExpression((((ExpressionCos*)expression)->child).get(), destination));
+        return createExpression<ExpressionCos>(destination,
+            copyNonlinearExpression((((ExpressionCos*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Tan:
     {
-        return std::make_shared<ExpressionTan>(
-            copyNonlinearExpression((((ExpressionTan*)expression)->child).get(), destination));
+        return createExpression<ExpressionTan>(destination,
+            copyNonlinearExpression((((ExpressionTan*)expression)->child).get(), destination, copies));
     }
     case E_NonlinearExpressionTypes::Constant:
     {
-        return std::make_shared<ExpressionConstant>((((ExpressionConstant*)expression)->constant));
+        return createExpression<ExpressionConstant>(destination, (((ExpressionConstant*)expression)->constant));
     }
     case E_NonlinearExpressionTypes::Variable:
     {
         if(destination == nullptr)
         {
-            return std::make_shared<ExpressionVariable>(((ExpressionVariable*)expression)->variable);
+            return createExpression<ExpressionVariable>(destination, ((ExpressionVariable*)expression)->variable);
         }
         else
         {
             auto exprVariable = (ExpressionVariable*)(expression);
 
             if(exprVariable->variable->lowerBound == exprVariable->variable->upperBound)
-                return std::make_shared<ExpressionConstant>(exprVariable->variable->lowerBound);
+                return createExpression<ExpressionConstant>(destination, exprVariable->variable->lowerBound);
             else
-                return std::make_shared<ExpressionVariable>(destination->getVariable(exprVariable->variable->index));
+                return createExpression<ExpressionVariable>(
+                    destination, destination->getVariable(exprVariable->variable->index));
         }
     }
     default:
@@ -524,4 +539,121 @@ NonlinearExpressionPtr copyNonlinearExpression(NonlinearExpression* expression,
     return nullptr;
 }
 
+NonlinearExpressionPtr copyNonlinearExpression(
+    NonlinearExpression* expression, Problem* destination, NonlinearExpressionCopies* copies)
+{
+    // Constants and variables are cheaper to copy again than to look up
+    if(copies == nullptr || expression->getNumberOfChildren() == 0)
+        return (copyNonlinearExpressionNode(expression, destination, copies));
+
+    if(auto copy = copies->find(expression); copy != copies->end())
+        return (copy->second);
+
+    auto copy = copyNonlinearExpressionNode(expression, destination, copies);
+    copies->emplace(expression, copy);
+
+    return (copy);
+}
+
+namespace
+{
+void appendStructuralSignature(const NonlinearExpression* expression, fmt::memory_buffer& signature,
+    std::unordered_map<const Variable*, size_t>& positions, Variables& variables)
+{
+    fmt::format_to(std::back_inserter(signature), "{}", static_cast<int>(expression->getType()));
+
+    if(auto constant = dynamic_cast<const ExpressionConstant*>(expression))
+    {
+        fmt::format_to(std::back_inserter(signature), ":{} ", constant->constant);
+    }
+    else if(auto variable = dynamic_cast<const ExpressionVariable*>(expression))
+    {
+        auto [position, isAdded] = positions.emplace(variable->variable.get(), variables.size());
+
+        if(isAdded)
+            variables.push_back(variable->variable);
+
+        fmt::format_to(std::back_inserter(signature), "#{} ", position->second);
+    }
+    else if(auto unary = dynamic_cast<const ExpressionUnary*>(expression))
+    {
+        signature.push_back('(');
+        appendStructuralSignature(unary->child.get(), signature, positions, variables);
+        signature.push_back(')');
+    }
+    else if(auto binary = dynamic_cast<const ExpressionBinary*>(expression))
+    {
+        signature.push_back('(');
+        appendStructuralSignature(binary->firstChild.get(), signature, positions, variables);
+        appendStructuralSignature(binary->secondChild.get(), signature, positions, variables);
+        signature.push_back(')');
+    }
+    else if(auto general = dynamic_cast<const ExpressionGeneral*>(expression))
+    {
+        signature.push_back('(');
+
+        for(auto& C : general->children)
+            appendStructuralSignature(C.get(), signature, positions, variables);
+
+        signature.push_back(')');
+    }
+}
+} // namespace
+
+std::string getStructuralSignature(const NonlinearExpression* expression, Variables& variables)
+{
+    fmt::memory_buffer signature;
+    std::unordered_map<const Variable*, size_t> positions;
+
+    appendStructuralSignature(expression, signature, positions, variables);
+
+    return (fmt::to_string(signature));
+}
+
+void substituteVariables(const NonlinearExpressionPtr& expression, const VariableSubstitutions& substitutions)
+{
+    if(auto variable = std::dynamic_pointer_cast<ExpressionVariable>(expression))
+    {
+        if(auto substitute = substitutions.find(variable->variable.get()); substitute != substitutions.end())
+            variable->variable = substitute->second;
+    }
+    else if(auto unary = std::dynamic_pointer_cast<ExpressionUnary>(expression))
+    {
+        substituteVariables(unary->child, substitutions);
+    }
+    else if(auto binary = std::dynamic_pointer_cast<ExpressionBinary>(expression))
+    {
+        substituteVariables(binary->firstChild, substitutions);
+        substituteVariables(binary->secondChild, substitutions);
+    }
+    else if(auto general = std::dynamic_pointer_cast<ExpressionGeneral>(expression))
+    {
+        for(auto& C : general->children)
+            substituteVariables(C, substitutions);
+    }
+}
+
+void substituteVariableValues(NonlinearExpressionPtr& expression, const VariableValues& values)
+{
+    if(auto variable = std::dynamic_pointer_cast<ExpressionVariable>(expression))
+    {
+        if(auto value = values.find(variable->variable.get()); value != values.end())
+            expression = std::make_shared<ExpressionConstant>(value->second);
+    }
+    else if(auto unary = std::dynamic_pointer_cast<ExpressionUnary>(expression))
+    {
+        substituteVariableValues(unary->child, values);
+    }
+    else if(auto binary = std::dynamic_pointer_cast<ExpressionBinary>(expression))
+    {
+        substituteVariableValues(binary->firstChild, values);
+        substituteVariableValues(binary->secondChild, values);
+    }
+    else if(auto general = std::dynamic_pointer_cast<ExpressionGeneral>(expression))
+    {
+        for(auto& C : general->children)
+            substituteVariableValues(C, values);
+    }
+}
+
 } // namespace SHOT
@@ -23,15 +23,46 @@
 #include "../Model/Problem.h"
 
 #include <optional>
+#include <unordered_map>
 
 namespace SHOT
 {
 
 NonlinearExpressionPtr copyNonlinearExpression(NonlinearExpression* expression, const ProblemPtr destination);
-NonlinearExpressionPtr copyNonlinearExpression(NonlinearExpression* expression, Problem* destination = nullptr);
 
+// The copies of the expression nodes with several children, so that nodes shared by the source expressions, e.g. common
+// subexpressions, are also shared by the copies instead of being copied once for each parent
+using NonlinearExpressionCopies = std::unordered_map<const NonlinearExpression*, NonlinearExpressionPtr>;
+
+NonlinearExpressionPtr copyNonlinearExpression(
+    NonlinearExpression* expression, Problem* destination = nullptr, NonlinearExpressionCopies* copies = nullptr);
+
+// The structure of the expression with each variable replaced by its position in the order of first appearance, the
+// variables are appended to variables in that order. Two expressions with the same signature are equal when the
+// variables of one are replaced by the variables at the same positions of the other.
+std::string getStructuralSignature(const NonlinearExpression* expression, Variables& variables);
+
+// Replaces the variables of the expression in place, e.g. in a copy where no nodes are shared. The variables not in
+// substitutions are kept.
+using VariableSubstitutions = std::unordered_map<const Variable*, VariablePtr>;
+void substituteVariables(const NonlinearExpressionPtr& expression, const VariableSubstitutions& substitutions);
+
+// Replaces the variables of the expression with the given values by constants, e.g. in a copy where no nodes are
+// shared. The expression itself is replaced if it is such a variable.
+using VariableValues = std::unordered_map<const Variable*, double>;
+void substituteVariableValues(NonlinearExpressionPtr& expression, const VariableValues& values);
+
+// Each node is visited once per call. The nodes are changed in place and no new nodes are created if no rule applies to
+// them, in which case the same expression is returned.
 inline NonlinearExpressionPtr simplify(NonlinearExpressionPtr expression);
 
+// As above, but also tells whether any rule was applied
+inline NonlinearExpressionPtr simplify(NonlinearExpressionPtr expression, bool& isChanged);
+
+// The number of nodes replaced by simplify() in this thread. A node that is only changed in place is not counted, but
+// the replacement of its child is.
+inline thread_local unsigned long numberOfSimplificationRewrites = 0;
+
 inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionConstant> expression)
 {
     return (expression);
@@ -515,7 +546,9 @@ inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionDivid
         }
     }
 
-    return (std::make_shared<ExpressionDivide>(firstChild, secondChild));
+    expression->firstChild = firstChild;
+    expression->secondChild = secondChild;
+    return (expression);
 }
 
 inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionPower> expression)
@@ -665,7 +698,88 @@ inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionPower
         }
     }
 
-    return (std::make_shared<ExpressionPower>(firstChild, secondChild));
+    expression->firstChild = firstChild;
+    expression->secondChild = secondChild;
+    return (expression);
+}
+
+// The variable of a child of a sum that is a variable or a linear term, otherwise nullptr
+inline Variable* getLinearVariableInSum(const NonlinearExpressionPtr& child, double& coefficient)
+{
+    if(child->getType() == E_NonlinearExpressionTypes::Variable)
+    {
+        coefficient = 1.0;
+        return (std::dynamic_pointer_cast<ExpressionVariable>(child)->variable.get());
+    }
+
+    if(child->getType() == E_NonlinearExpressionTypes::Product)
+    {
+        auto product = std::dynamic_pointer_cast<ExpressionProduct>(child);
+
+        if(!product->isLinearTerm())
+            return (nullptr);
+
+        if(auto linearTerm = product->getLinearTerm(); linearTerm)
+        {
+            coefficient = std::get<0>(*linearTerm);
+            return (std::get<1>(*linearTerm).get());
+        }
+    }
+
+    return (nullptr);
+}
+
+// Whether a rule applies to a sum with simplified children: nested sums are flattened, the constants are added and the
+// linear terms in the same variable are combined. Sums with many linear children are always rewritten, since finding
+// the duplicates would otherwise need a lookup structure.
+inline bool isSumRewritten(const ExpressionSum& sum)
+{
+    constexpr int maxComparedLinearChildren = 32;
+
+    int numberOfConstants = 0;
+    int numberOfLinearChildren = 0;
+
+    for(size_t i = 0; i < sum.children.size(); i++)
+    {
+        auto& C = sum.children[i];
+
+        if(C->getType() == E_NonlinearExpressionTypes::Sum)
+            return (true);
+
+        if(C->getType() == E_NonlinearExpressionTypes::Constant)
+        {
+            numberOfConstants++;
+
+            if(numberOfConstants > 1 || std::dynamic_pointer_cast<ExpressionConstant>(C)->constant == 0.0)
+                return (true);
+
+            continue;
+        }
+
+        double coefficient = 0.0;
+        auto variable = getLinearVariableInSum(C, coefficient);
+
+        if(variable == nullptr)
+            continue;
+
+        if(coefficient == 0.0 || (coefficient == 1.0 && C->getType() == E_NonlinearExpressionTypes::Product))
+            return (true);
+
+        numberOfLinearChildren++;
+
+        if(numberOfLinearChildren > maxComparedLinearChildren)
+            return (true);
+
+        for(size_t j = 0; j < i; j++)
+        {
+            double otherCoefficient = 0.0;
+
+            if(getLinearVariableInSum(sum.children[j], otherCoefficient) == variable)
+                return (true);
+        }
+    }
+
+    return (false);
 }
 
 inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionSum> expression)
@@ -673,6 +787,13 @@ inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionSum>
     if(expression->getNumberOfChildren() == 1)
         return (expression->children[0]);
 
+    for(auto& C : expression->children)
+        C = simplify(C);
+
+    // Nothing is allocated if no rule applies
+    if(!isSumRewritten(*expression))
+        return (expression);
+
     double constant = 0.0;
 
     NonlinearExpressions children;
@@ -691,15 +812,13 @@ inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionSum>
                 }
                 else
                 {
-                    children.add(simplify(CC));
+                    children.add(CC);
                 }
             }
 
             continue;
         }
 
-        C = simplify(C);
-
         if(C->getType() == E_NonlinearExpressionTypes::Constant)
         {
             constant += std::dynamic_pointer_cast<ExpressionConstant>(C)->constant;
@@ -768,11 +887,48 @@ inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionSum>
     return (sum);
 }
 
+// Whether a rule applies to a product with simplified children: nested products are flattened, the constants are
+// multiplied and put first, and a product with one sum is expanded
+inline bool isProductRewritten(const ExpressionProduct& product)
+{
+    int numberOfSums = 0;
+
+    for(size_t i = 0; i < product.children.size(); i++)
+    {
+        auto& C = product.children[i];
+
+        if(C->getType() == E_NonlinearExpressionTypes::Product)
+            return (true);
+
+        if(C->getType() == E_NonlinearExpressionTypes::Constant)
+        {
+            double constant = std::dynamic_pointer_cast<ExpressionConstant>(C)->constant;
+
+            if(i > 0 || constant == 1.0 || constant == 0.0)
+                return (true);
+        }
+        else if(C->getType() == E_NonlinearExpressionTypes::Sum)
+        {
+            numberOfSums++;
+        }
+    }
+
+    return (numberOfSums == 1);
+}
+
 inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionProduct> expression)
 {
     if(expression->getNumberOfChildren() == 1)
         return (expression->children[0]);
 
+    // Can now assume there are no Times types in the children
+    for(auto& C : expression->children)
+        C = simplify(C);
+
+    // Nothing is allocated if no rule applies
+    if(!isProductRewritten(*expression))
+        return (expression);
+
     double constant = 1.0;
 
     NonlinearExpressions children;
@@ -780,9 +936,6 @@ inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionProdu
 
     for(auto& C : expression->children)
     {
-        C = simplify(C);
-        // Can now assume there are no Times types in the child
-
         if(C->getType() == E_NonlinearExpressionTypes::Constant)
         {
             constant *= std::dynamic_pointer_cast<ExpressionConstant>(C)->constant;
@@ -864,72 +1017,9 @@ inline NonlinearExpressionPtr simplifyExpression(std::shared_ptr<ExpressionProdu
 
 inline NonlinearExpressionPtr simplify(NonlinearExpressionPtr expression)
 {
-    std::stringstream ss;
+    auto original = expression.get();
     auto type = expression->getType();
 
-    /*switch(type)
-    {
-    case E_NonlinearExpressionTypes::Constant:
-        ss << "\nBefore simplification of constant: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Variable:
-        ss << "\nBefore simplification of variable: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Negate:
-        ss << "\nBefore simplification of negate: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Invert:
-        ss << "\nBefore simplification of invert: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::SquareRoot:
-        ss << "\nBefore simplification of square root: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Square:
-        ss << "\nBefore simplification of square: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Log:
-        ss << "\nBefore simplification of log: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Exp:
-        ss << "\nBefore simplification of exp: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Cos:
-        ss << "\nBefore simplification of cos: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::ArcCos:
-        ss << "\nBefore simplification of arccos: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Sin:
-        ss << "\nBefore simplification of sin: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::ArcSin:
-        ss << "\nBefore simplification of arcsin: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Tan:
-        ss << "\nBefore simplification of tan: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::ArcTan:
-        ss << "\nBefore simplification of arctan: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Abs:
-        ss << "\nBefore simplification of abs: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Divide:
-        ss << "\nBefore simplification of divide: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Power:
-        ss << "\nBefore simplification of power: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Sum:
-        ss << "\nBefore simplification of sum: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Product:
-        ss << "\nBefore simplification of product: " << *expression << std::endl;
-        break;
-    default:
-        assert(false);
-    }*/
-
     switch(type)
     {
     case E_NonlinearExpressionTypes::Constant:
@@ -992,70 +1082,29 @@ inline NonlinearExpressionPtr simplify(NonlinearExpressionPtr expression)
         assert(false);
     }
 
-    /*switch(type)
-    {
-    case E_NonlinearExpressionTypes::Constant:
-        ss << " After simplification of constant: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Variable:
-        ss << " After simplification of variable: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Negate:
-        ss << " After simplification of negate: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Invert:
-        ss << " After simplification of invert: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::SquareRoot:
-        ss << " After simplification of square root: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Square:
-        ss << " After simplification of square: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Log:
-        ss << " After simplification of log: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Exp:
-        ss << " After simplification of exp: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Cos:
-        ss << " After simplification of cos: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::ArcCos:
-        ss << " After simplification of arccos: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Sin:
-        ss << " After simplification of sin: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::ArcSin:
-        ss << " After simplification of arcsin: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Tan:
-        ss << " After simplification of tan: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::ArcTan:
-        ss << " After simplification of arctan: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Abs:
-        ss << " After simplification of abs: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Divide:
-        ss << " After simplification of divide: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Power:
-        ss << " After simplification of power: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Sum:
-        ss << " After simplification of sum: " << *expression << std::endl;
-        break;
-    case E_NonlinearExpressionTypes::Product:
-        ss << " After simplification of product: " << *expression << std::endl;
-        break;
-    default:
-        assert(false);
-    }
+    if(expression.get() != original)
+        numberOfSimplificationRewrites++;
+
+    return (expression);
+}
+
+inline NonlinearExpressionPtr simplify(NonlinearExpressionPtr expression, bool& isChanged)
+{
+    auto numberOfRewrites = numberOfSimplificationRewrites;
+
+    expression = simplify(expression);
+    isChanged = (numberOfSimplificationRewrites != numberOfRewrites);
+
+    return (expression);
+}
+
+// Simplifies the expression until no rule applies, or at most the given number of passes
+inline NonlinearExpressionPtr simplifyToFixedPoint(NonlinearExpressionPtr expression, int maxPasses = 10)
+{
+    bool isChanged = true;
 
-    std::cout << ss.str() << std::endl;*/
+    for(int i = 0; i < maxPasses && isChanged; i++)
+        expression = simplify(expression, isChanged);
 
     return (expression);
 }
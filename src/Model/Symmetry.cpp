@@ -0,0 +1,274 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "Symmetry.h"
+
+#include "../Output.h"
+#include "../Utilities.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <map>
+
+namespace SHOT
+{
+
+SymmetryDetection::SymmetryDetection(EnvironmentPtr envPtr, ProblemPtr problem) : env(envPtr), problem(problem) { }
+
+std::vector<VectorInteger> SymmetryDetection::findInterchangeableVariables()
+{
+    std::vector<VectorInteger> groups;
+
+    createRows();
+
+    // The candidates can only be interchangeable if they have the same key
+    std::map<VectorDouble, VectorInteger> candidates;
+
+    for(auto& V : problem->allVariables)
+    {
+        if(!isCandidate(V))
+            continue;
+
+        VectorDouble key = { (double)V->properties.type, V->lowerBound, V->upperBound, V->semiBound, 0.0 };
+
+        for(auto& [index, coefficient] : objectiveRow.linearTerms)
+        {
+            if(index == V->index)
+                key[4] = coefficient;
+        }
+
+        std::vector<std::tuple<double, double, double, double>> occurrences;
+
+        for(auto R : rowsWithVariable[V->index])
+        {
+            auto& row = rows[R];
+
+            for(auto& [index, coefficient] : row.linearTerms)
+            {
+                if(index == V->index)
+                    occurrences.emplace_back(coefficient, row.valueLHS, row.valueRHS, (double)row.linearTerms.size());
+            }
+        }
+
+        std::sort(occurrences.begin(), occurrences.end());
+
+        for(auto& [coefficient, valueLHS, valueRHS, size] : occurrences)
+            key.insert(key.end(), { coefficient, valueLHS, valueRHS, size });
+
+        candidates[key].push_back(V->index);
+    }
+
+    for(auto& [key, indexes] : candidates)
+    {
+        if(indexes.size() < 2)
+            continue;
+
+        std::sort(indexes.begin(), indexes.end());
+
+        // The swaps of the first variable in a group with each of the others generate all permutations of the group,
+        // so only these need to be verified
+        std::vector<VectorInteger> keyGroups;
+
+        for(auto I : indexes)
+        {
+            auto group = std::find_if(keyGroups.begin(), keyGroups.end(),
+                [&](const VectorInteger& G) { return (isInterchangeable(G.front(), I)); });
+
+            if(group != keyGroups.end())
+                group->push_back(I);
+            else
+                keyGroups.push_back({ I });
+        }
+
+        for(auto& G : keyGroups)
+        {
+            if(G.size() > 1)
+                groups.push_back(G);
+        }
+    }
+
+    size_t numberOfVariables = 0;
+
+    for(auto& G : groups)
+        numberOfVariables += G.size();
+
+    env->output->outputDebug(fmt::format("  Found {} groups of interchangeable variables with {} variables in total.",
+        groups.size(), numberOfVariables));
+
+    return (groups);
+}
+
+void SymmetryDetection::createRows()
+{
+    rows.clear();
+    rowPositions.clear();
+    rowsWithVariable.assign(problem->allVariables.size(), {});
+
+    for(auto& C : problem->linearConstraints)
+    {
+        Row row;
+        row.valueLHS = C->valueLHS;
+        row.valueRHS = C->valueRHS;
+        row.constant = C->constant;
+
+        for(auto& T : C->linearTerms)
+            row.linearTerms.emplace_back(T->variable->index, T->coefficient);
+
+        addRow(std::move(row));
+    }
+
+    for(auto& C : problem->quadraticConstraints)
+    {
+        Row row;
+        row.valueLHS = C->valueLHS;
+        row.valueRHS = C->valueRHS;
+        row.constant = C->constant;
+
+        for(auto& T : C->linearTerms)
+            row.linearTerms.emplace_back(T->variable->index, T->coefficient);
+
+        for(auto& T : C->quadraticTerms)
+            row.quadraticTerms.emplace_back(T->firstVariable->index, T->secondVariable->index, T->coefficient);
+
+        addRow(std::move(row));
+    }
+
+    objectiveRow = Row();
+    objectiveRow.constant = problem->objectiveFunction->constant;
+
+    if(auto objective = std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction))
+    {
+        for(auto& T : objective->linearTerms)
+            objectiveRow.linearTerms.emplace_back(T->variable->index, T->coefficient);
+    }
+
+    if(auto objective = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(problem->objectiveFunction))
+    {
+        for(auto& T : objective->quadraticTerms)
+            objectiveRow.quadraticTerms.emplace_back(
+                T->firstVariable->index, T->secondVariable->index, T->coefficient);
+    }
+
+    sortTerms(objectiveRow);
+}
+
+void SymmetryDetection::addRow(Row row)
+{
+    sortTerms(row);
+
+    size_t position = rows.size();
+
+    for(auto& [index, coefficient] : row.linearTerms)
+        rowsWithVariable[index].push_back(position);
+
+    for(auto& [firstIndex, secondIndex, coefficient] : row.quadraticTerms)
+    {
+        rowsWithVariable[firstIndex].push_back(position);
+
+        if(secondIndex != firstIndex)
+            rowsWithVariable[secondIndex].push_back(position);
+    }
+
+    rowPositions.emplace(calculateHash(row), position);
+    rows.push_back(std::move(row));
+}
+
+bool SymmetryDetection::isCandidate(const VariablePtr& variable) const
+{
+    if(variable->properties.type != E_VariableType::Binary && variable->properties.type != E_VariableType::Integer)
+        return (false);
+
+    if(variable->properties.isAuxiliary || variable->properties.inNonlinearConstraints)
+        return (false);
+
+    if(problem->objectiveFunction->properties.classification > E_ObjectiveFunctionClassification::Quadratic
+        && variable->properties.inObjectiveFunction)
+        return (false);
+
+    for(auto& S : problem->specialOrderedSets)
+    {
+        if(std::find(S->variables.begin(), S->variables.end(), variable) != S->variables.end())
+            return (false);
+    }
+
+    return (true);
+}
+
+bool SymmetryDetection::isInterchangeable(int firstIndex, int secondIndex) const
+{
+    if(!(swapVariables(objectiveRow, firstIndex, secondIndex) == objectiveRow))
+        return (false);
+
+    // The rows without the variables are mapped onto themselves
+    for(auto index : { firstIndex, secondIndex })
+    {
+        for(auto R : rowsWithVariable[index])
+        {
+            auto swappedRow = swapVariables(rows[R], firstIndex, secondIndex);
+            auto range = rowPositions.equal_range(calculateHash(swappedRow));
+
+            if(std::none_of(range.first, range.second, [&](auto& P) { return (rows[P.second] == swappedRow); }))
+                return (false);
+        }
+    }
+
+    return (true);
+}
+
+SymmetryDetection::Row SymmetryDetection::swapVariables(const Row& row, int firstIndex, int secondIndex)
+{
+    auto swap = [&](int index) {
+        return (index == firstIndex ? secondIndex : (index == secondIndex ? firstIndex : index));
+    };
+
+    Row swappedRow = row;
+
+    for(auto& [index, coefficient] : swappedRow.linearTerms)
+        index = swap(index);
+
+    for(auto& [first, second, coefficient] : swappedRow.quadraticTerms)
+    {
+        first = swap(first);
+        second = swap(second);
+    }
+
+    sortTerms(swappedRow);
+
+    return (swappedRow);
+}
+
+void SymmetryDetection::sortTerms(Row& row)
+{
+    std::sort(row.linearTerms.begin(), row.linearTerms.end());
+
+    for(auto& [first, second, coefficient] : row.quadraticTerms)
+    {
+        if(first > second)
+            std::swap(first, second);
+    }
+
+    std::sort(row.quadraticTerms.begin(), row.quadraticTerms.end());
+}
+
+size_t SymmetryDetection::calculateHash(const Row& row)
+{
+    VectorDouble values = { row.valueLHS, row.valueRHS, row.constant };
+    values.reserve(3 + 2 * row.linearTerms.size() + 3 * row.quadraticTerms.size());
+
+    for(auto& [index, coefficient] : row.linearTerms)
+        values.insert(values.end(), { (double)index, coefficient });
+
+    for(auto& [first, second, coefficient] : row.quadraticTerms)
+        values.insert(values.end(), { (double)first, (double)second, coefficient });
+
+    return (Utilities::calculateHash(values));
+}
+} // namespace SHOT
@@ -0,0 +1,77 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Environment.h"
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include "Problem.h"
+
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// Finds groups of discrete variables that are interchangeable in a finalized problem, e.g. the reformulated problem,
+// i.e. where swapping the values of any two variables in a group maps each linear and quadratic constraint and the
+// objective onto a constraint in the problem. The candidates are grouped on their bounds and on the coefficients and
+// constraints they appear in, and the swaps with the first variable in a group are then verified. The variables in
+// nonlinear constraints and SOS are not considered. Since the swaps of all pairs in a group are symmetries, some
+// optimal solution has nonincreasing values within each group, which can be added as constraints to the MIP problem.
+class SymmetryDetection
+{
+public:
+    SymmetryDetection(EnvironmentPtr envPtr, ProblemPtr problem);
+
+    // Each group is sorted on the variable indexes and has at least two variables
+    std::vector<VectorInteger> findInterchangeableVariables();
+
+private:
+    // A linear or quadratic constraint, or the objective, with the terms sorted on the variable indexes
+    struct Row
+    {
+        double valueLHS = 0.0;
+        double valueRHS = 0.0;
+        double constant = 0.0;
+        std::vector<std::pair<int, double>> linearTerms;
+        std::vector<std::tuple<int, int, double>> quadraticTerms;
+
+        bool operator==(const Row& other) const
+        {
+            return (valueLHS == other.valueLHS && valueRHS == other.valueRHS && constant == other.constant
+                && linearTerms == other.linearTerms && quadraticTerms == other.quadraticTerms);
+        }
+    };
+
+    EnvironmentPtr env;
+    ProblemPtr problem;
+
+    std::vector<Row> rows;
+    Row objectiveRow;
+    std::unordered_multimap<size_t, size_t> rowPositions;
+
+    // The positions in rows of the rows with each variable
+    std::vector<std::vector<size_t>> rowsWithVariable;
+
+    void createRows();
+    void addRow(Row row);
+    bool isCandidate(const VariablePtr& variable) const;
+    bool isInterchangeable(int firstIndex, int secondIndex) const;
+
+    static Row swapVariables(const Row& row, int firstIndex, int secondIndex);
+    static void sortTerms(Row& row);
+    static size_t calculateHash(const Row& row);
+};
+} // namespace SHOT
@@ -13,9 +13,22 @@
 #include "../Settings.h"
 
 #include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
+#include <numeric>
 
 namespace SHOT
 {
+// Whether scale * matrix + shift * I is positive definite, where only the lower triangular part of the matrix is given
+static bool isShiftedMatrixPositiveDefinite(const Eigen::SparseMatrix<double>& matrix, double shift, double scale)
+{
+    Eigen::SimplicialLLT<Eigen::SparseMatrix<double>, Eigen::Lower> cholesky;
+    cholesky.setShift(shift, scale);
+    cholesky.compute(matrix);
+
+    return (cholesky.info() == Eigen::Success);
+}
+
 Interval Term::getBounds()
 {
     IntervalVector variableBounds;
@@ -30,6 +43,119 @@ Interval Term::getBounds()
     return (interval);
 }
 
+void LinearTerms::calculateTermBounds(IntervalKernels::IntervalArray& bounds) const
+{
+    // Reused between calls
+    thread_local VectorDouble coefficients;
+    thread_local VectorDouble lowerBounds;
+    thread_local VectorDouble upperBounds;
+
+    coefficients.resize(size());
+    lowerBounds.resize(size());
+    upperBounds.resize(size());
+
+    for(size_t i = 0; i < size(); i++)
+    {
+        coefficients[i] = (*this)[i]->coefficient;
+        lowerBounds[i] = (*this)[i]->variable->lowerBound;
+        upperBounds[i] = (*this)[i]->variable->upperBound;
+    }
+
+    IntervalKernels::calculateLinearTermBounds(
+        coefficients.data(), lowerBounds.data(), upperBounds.data(), size(), bounds);
+}
+
+Interval LinearTerms::getBounds() const
+{
+    thread_local IntervalKernels::IntervalArray bounds;
+
+    calculateTermBounds(bounds);
+    return (IntervalKernels::calculateSum(bounds));
+}
+
+void QuadraticTerms::calculateTermBounds(IntervalKernels::IntervalArray& bounds) const
+{
+    // Reused between calls
+    thread_local VectorDouble coefficients;
+    thread_local VectorDouble firstLowerBounds;
+    thread_local VectorDouble firstUpperBounds;
+    thread_local VectorDouble secondLowerBounds;
+    thread_local VectorDouble secondUpperBounds;
+    thread_local std::vector<char> isSquare;
+
+    coefficients.resize(size());
+    firstLowerBounds.resize(size());
+    firstUpperBounds.resize(size());
+    secondLowerBounds.resize(size());
+    secondUpperBounds.resize(size());
+    isSquare.resize(size());
+
+    for(size_t i = 0; i < size(); i++)
+    {
+        auto& T = (*this)[i];
+
+        coefficients[i] = T->coefficient;
+        firstLowerBounds[i] = T->firstVariable->lowerBound;
+        firstUpperBounds[i] = T->firstVariable->upperBound;
+        secondLowerBounds[i] = T->secondVariable->lowerBound;
+        secondUpperBounds[i] = T->secondVariable->upperBound;
+        isSquare[i] = (T->firstVariable == T->secondVariable);
+    }
+
+    IntervalKernels::calculateQuadraticTermBounds(coefficients.data(), firstLowerBounds.data(),
+        firstUpperBounds.data(), secondLowerBounds.data(), secondUpperBounds.data(), isSquare, bounds);
+}
+
+Interval QuadraticTerms::getBounds() const
+{
+    thread_local IntervalKernels::IntervalArray bounds;
+
+    calculateTermBounds(bounds);
+    return (IntervalKernels::calculateSum(bounds));
+}
+
+bool QuadraticTerms::isSecondOrderCone() const
+{
+    QuadraticTerm* coneTerm = nullptr;
+    int numberOfSquares = 0;
+
+    for(auto& T : (*this))
+    {
+        if(T->coefficient == 0.0)
+            continue;
+
+        if(T->coefficient < 0.0)
+        {
+            if(coneTerm != nullptr)
+                return (false);
+
+            coneTerm = T.get();
+        }
+        else if(T->firstVariable != T->secondVariable)
+        {
+            return (false);
+        }
+        else
+        {
+            numberOfSquares++;
+        }
+    }
+
+    if(coneTerm == nullptr || numberOfSquares == 0 || coneTerm->firstVariable->lowerBound < 0.0
+        || coneTerm->secondVariable->lowerBound < 0.0)
+        return (false);
+
+    // The variables of the cone cannot also be in the sum of squares
+    for(auto& T : (*this))
+    {
+        if(T.get() != coneTerm && T->coefficient != 0.0
+            && (T->firstVariable == coneTerm->firstVariable || T->firstVariable == coneTerm->secondVariable))
+            return (false);
+    }
+
+    return (true);
+}
+
 void QuadraticTerms::updateConvexity()
 {
     if(size() == 0)
@@ -41,6 +167,11 @@ void QuadraticTerms::updateConvexity()
     std::vector<Eigen::Triplet<double>> elements;
     elements.reserve(2 * size());
 
+    minEigenValue = SHOT_DBL_MAX;
+    maxEigenValue = SHOT_DBL_MIN;
+    minEigenValueWithinTolerance = false;
+    maxEigenValueWithinTolerance = false;
+
     allSquares = true;
     allPositive = true;
     allNegative = true;
@@ -150,33 +281,8 @@ void QuadraticTerms::updateConvexity()
 
     int numberOfVariables = variableMap.size();
 
-    Eigen::SparseMatrix<double> matrix(numberOfVariables, numberOfVariables);
-    matrix.setFromTriplets(elements.begin(), elements.end());
-
-    // std::cout << matrix.toDense() << std::endl;
-
-    Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigenSolver(
-        matrix, Eigen::DecompositionOptions::ComputeEigenvectors);
-
-    if(eigenSolver.info() != Eigen::Success)
-    {
-        convexity = E_Convexity::Unknown;
-        minEigenValueWithinTolerance = false;
-        maxEigenValueWithinTolerance = false;
-        return;
-    }
-
-    eigenvalues = eigenSolver.eigenvalues();
-    eigenvectors = eigenSolver.eigenvectors();
-
-    // std::cout << eigenvalues << std::endl;
-
-    // std::cout << eigenvectors << std::endl;
-
-    bool areAllPositiveOrZero = true;
-    bool areAllNegativeOrZero = true;
-
     double eigenvalueTolerance = 0.0;
+    int maxDenseBlockSize = 1000;
 
     if(auto sharedOwnerProblem = ownerProblem.lock())
     {
@@ -184,6 +290,8 @@ void QuadraticTerms::updateConvexity()
         {
             eigenvalueTolerance = sharedOwnerProblem->env->settings->getSetting<double>(
                 "Convexity.Quadratics.EigenValueTolerance", "Model");
+            maxDenseBlockSize = sharedOwnerProblem->env->settings->getSetting<int>(
+                "Convexity.Quadratics.MaxDenseBlockSize", "Model");
         }
         else
         {
@@ -191,20 +299,132 @@ void QuadraticTerms::updateConvexity()
         }
     }
 
+    // Variables in different connected components of the graph given by the terms belong to different diagonal blocks
+    // of the matrix, and the blocks are handled separately
+    std::vector<int> parents(numberOfVariables);
+    std::iota(parents.begin(), parents.end(), 0);
+
+    auto findRoot = [&parents](int index)
+    {
+        while(parents[index] != index)
+        {
+            parents[index] = parents[parents[index]];
+            index = parents[index];
+        }
+
+        return (index);
+    };
+
+    for(auto& E : elements)
+    {
+        int firstRoot = findRoot(E.row());
+        int secondRoot = findRoot(E.col());
+
+        if(firstRoot != secondRoot)
+            parents[std::max(firstRoot, secondRoot)] = std::min(firstRoot, secondRoot);
+    }
+
+    std::vector<VectorInteger> blockVariables;
+    VectorInteger rootBlocks(numberOfVariables, -1);
+    VectorInteger variableBlocks(numberOfVariables);
+    VectorInteger variablePositions(numberOfVariables);
+
     for(int i = 0; i < numberOfVariables; i++)
     {
-        double eigenvalue = eigenSolver.eigenvalues()[i];
+        int root = findRoot(i);
 
-        this->minEigenValue = std::min(this->minEigenValue, eigenvalue);
-        this->maxEigenValue = std::max(this->maxEigenValue, eigenvalue);
+        if(rootBlocks[root] == -1)
+        {
+            rootBlocks[root] = blockVariables.size();
+            blockVariables.emplace_back();
+        }
+
+        variableBlocks[i] = rootBlocks[root];
+        variablePositions[i] = blockVariables[variableBlocks[i]].size();
+        blockVariables[variableBlocks[i]].push_back(i);
+    }
 
-        areAllNegativeOrZero = areAllNegativeOrZero && eigenvalue <= eigenvalueTolerance;
-        areAllPositiveOrZero = areAllPositiveOrZero && eigenvalue >= -eigenvalueTolerance;
+    // The positions within a block are in the same order as the indexes, so the elements remain lower triangular
+    std::vector<std::vector<Eigen::Triplet<double>>> blockElements(blockVariables.size());
+
+    for(auto& E : elements)
+    {
+        blockElements[variableBlocks[E.row()]].emplace_back(
+            variablePositions[E.row()], variablePositions[E.col()], E.value());
     }
 
-    if(areAllPositiveOrZero)
+    VectorDouble eigenvalueList;
+    std::vector<Eigen::Triplet<double>> eigenvectorElements;
+    isEigenvalueDecompositionComplete = true;
+
+    for(size_t b = 0; b < blockVariables.size(); b++)
+    {
+        int blockSize = blockVariables[b].size();
+
+        Eigen::SparseMatrix<double> matrix(blockSize, blockSize);
+        matrix.setFromTriplets(blockElements[b].begin(), blockElements[b].end());
+
+        if(blockSize > maxDenseBlockSize)
+        {
+            // Only the convexity is determined for large blocks, which follows from whether the shifted matrices have
+            // Cholesky factorizations. The eigenvalues are then only bounded.
+            isEigenvalueDecompositionComplete = false;
+
+            if(isShiftedMatrixPositiveDefinite(matrix, eigenvalueTolerance, 1.0))
+                minEigenValue = std::min(
+                    minEigenValue, isShiftedMatrixPositiveDefinite(matrix, 0.0, 1.0) ? 0.0 : -eigenvalueTolerance);
+            else
+                minEigenValue = SHOT_DBL_MIN;
+
+            if(isShiftedMatrixPositiveDefinite(matrix, eigenvalueTolerance, -1.0))
+                maxEigenValue = std::max(
+                    maxEigenValue, isShiftedMatrixPositiveDefinite(matrix, 0.0, -1.0) ? 0.0 : eigenvalueTolerance);
+            else
+                maxEigenValue = SHOT_DBL_MAX;
+
+            continue;
+        }
+
+        // Only the lower triangular part is used by the solver
+        Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigenSolver(
+            Eigen::MatrixXd(matrix), Eigen::DecompositionOptions::ComputeEigenvectors);
+
+        if(eigenSolver.info() != Eigen::Success)
+        {
+            convexity = E_Convexity::Unknown;
+            minEigenValueWithinTolerance = false;
+            maxEigenValueWithinTolerance = false;
+            isEigenvalueDecompositionComplete = false;
+            return;
+        }
+
+        for(int k = 0; k < blockSize; k++)
+        {
+            double eigenvalue = eigenSolver.eigenvalues()[k];
+
+            this->minEigenValue = std::min(this->minEigenValue, eigenvalue);
+            this->maxEigenValue = std::max(this->maxEigenValue, eigenvalue);
+
+            for(int j = 0; j < blockSize; j++)
+            {
+                if(eigenSolver.eigenvectors()(j, k) != 0.0)
+                {
+                    eigenvectorElements.emplace_back(
+                        blockVariables[b][j], eigenvalueList.size(), eigenSolver.eigenvectors()(j, k));
+                }
+            }
+
+            eigenvalueList.push_back(eigenvalue);
+        }
+    }
+
+    eigenvalues = Eigen::Map<Eigen::VectorXd>(eigenvalueList.data(), eigenvalueList.size());
+    eigenvectors.resize(numberOfVariables, eigenvalueList.size());
+    eigenvectors.setFromTriplets(eigenvectorElements.begin(), eigenvectorElements.end());
+
+    if(this->minEigenValue >= -eigenvalueTolerance)
         convexity = E_Convexity::Convex;
-    else if(areAllNegativeOrZero)
+    else if(this->maxEigenValue <= eigenvalueTolerance)
         convexity = E_Convexity::Concave;
     else
         convexity = E_Convexity::Nonconvex;
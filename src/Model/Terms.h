@@ -15,8 +15,14 @@
 #include "../Utilities.h"
 
 #include "Variables.h"
+#include "IntervalKernels.h"
 
 #include <Eigen/Eigenvalues>
+#include <Eigen/Sparse>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
 #include <vector>
 
 namespace SHOT
@@ -38,6 +44,9 @@ public:
 
     virtual Interval calculate(const IntervalVector& intervalVector) const = 0;
 
+    // Adds the value of the term in each of the points to values, which must have room for points.numberOfPoints
+    virtual void calculate(const PointBlock& points, double* values) const = 0;
+
     virtual Interval getBounds();
 
     virtual void takeOwnership(ProblemPtr owner) = 0;
@@ -73,6 +82,14 @@ public:
         return value;
     }
 
+    inline void calculate(const PointBlock& points, double* values) const override
+    {
+        const double* variableValues = points.getVariableValues(variable->index);
+
+        for(int p = 0; p < points.numberOfPoints; p++)
+            values[p] += coefficient * variableValues[p];
+    }
+
     inline void takeOwnership(ProblemPtr owner) override
     {
         assert(ownerProblem.expired() || (ownerProblem.lock().get() == owner.get()));
@@ -182,6 +199,15 @@ public:
         return value;
     }
 
+    // Adds the values of the terms in all points to values
+    void calculate(const PointBlock& points, double* values) const
+    {
+        for(auto& TERM : *this)
+        {
+            TERM->calculate(points, values);
+        }
+    }
+
     Interval getBounds() const
     {
         Interval bounds(0.0, 0.0);
@@ -281,6 +307,12 @@ public:
         }
     }
 
+    // The bounds of each term with the current bounds of the variables
+    void calculateTermBounds(IntervalKernels::IntervalArray& bounds) const;
+
+    // Uses the current bounds of the variables instead of the bounds stored in the owner problem
+    Interval getBounds() const;
+
     SparseVariableVector calculateGradient([[maybe_unused]] const VectorDouble& point) const
     {
         SparseVariableVector gradient;
@@ -360,6 +392,15 @@ public:
         return value;
     }
 
+    inline void calculate(const PointBlock& points, double* values) const override
+    {
+        const double* firstValues = points.getVariableValues(firstVariable->index);
+        const double* secondValues = points.getVariableValues(secondVariable->index);
+
+        for(int p = 0; p < points.numberOfPoints; p++)
+            values[p] += coefficient * firstValues[p] * secondValues[p];
+    }
+
     inline void takeOwnership(ProblemPtr owner) override
     {
         assert(ownerProblem.expired() || (ownerProblem.lock().get() == owner.get()));
@@ -454,8 +495,11 @@ public:
     bool allNegative = false;
     bool allBilinear = false;
 
-    Eigen::VectorXcd eigenvalues;
-    Eigen::MatrixXcd eigenvectors;
+    // Column k of the eigenvectors, with rows given by the variable map, has the eigenvalue k. The variables in the
+    // blocks too large for the dense eigenvalue solver are not included.
+    Eigen::VectorXd eigenvalues;
+    Eigen::SparseMatrix<double> eigenvectors;
+    bool isEigenvalueDecompositionComplete = false;
     std::map<VariablePtr, int> variableMap;
 
     using std::vector<QuadraticTermPtr>::operator[];
@@ -472,6 +516,25 @@ public:
 
     QuadraticTerms() = default;
 
+    // Takes the convexity and eigenvalue decomposition of terms with the same variables and coefficients in the same
+    // order, which are then not analysed again
+    void copyConvexity(const QuadraticTerms& terms)
+    {
+        convexity = terms.convexity;
+        minEigenValue = terms.minEigenValue;
+        maxEigenValue = terms.maxEigenValue;
+        minEigenValueWithinTolerance = terms.minEigenValueWithinTolerance;
+        maxEigenValueWithinTolerance = terms.maxEigenValueWithinTolerance;
+        allSquares = terms.allSquares;
+        allPositive = terms.allPositive;
+        allNegative = terms.allNegative;
+        allBilinear = terms.allBilinear;
+        eigenvalues = terms.eigenvalues;
+        eigenvectors = terms.eigenvectors;
+        isEigenvalueDecompositionComplete = terms.isEigenvalueDecompositionComplete;
+        variableMap = terms.variableMap;
+    }
+
     void add(QuadraticTermPtr term)
     {
         auto firstVariable = term->firstVariable;
@@ -512,6 +575,16 @@ public:
         }
     }
 
+    // The bounds of each term with the current bounds of the variables
+    void calculateTermBounds(IntervalKernels::IntervalArray& bounds) const;
+
+    // Uses the current bounds of the variables instead of the bounds stored in the owner problem
+    Interval getBounds() const;
+
+    // True if the terms are sum(a_i*x_i^2) - b*y^2 or sum(a_i*x_i^2) - b*y*z with a_i, b > 0 and y, z nonnegative, so
+    // that the terms <= 0 is a (rotated) second-order cone. The set is convex even though the terms are not.
+    bool isSecondOrderCone() const;
+
     SparseVariableVector calculateGradient(const VectorDouble& point) const
     {
         SparseVariableVector gradient;
@@ -559,6 +632,243 @@ public:
     };
 };
 
+// Packed copies of the linear and quadratic terms, where the coefficients and variable indexes are stored in
+// contiguous arrays in the same order as the terms. The evaluation loops then do not need to follow the term and
+// variable pointers, and can be vectorized by the compiler. The copies are updated by the constraints and are only
+// valid as long as the terms are not changed.
+//
+// With compact storage, the coefficients are instead stored once in a dictionary and each term has the one-byte
+// position of its coefficient in it, which is possible if the terms have at most 256 different coefficients, e.g.
+// in generated models where most of them are 1 or -1.
+class PackedCoefficients
+{
+public:
+    VectorDouble values; // Empty if the dictionary is used
+    VectorDouble dictionary;
+    std::vector<uint8_t> codes;
+
+    template <typename T> void update(const T& terms, bool useCompactStorage)
+    {
+        values.clear();
+        dictionary.clear();
+        codes.clear();
+
+        if(!useCompactStorage || !updateDictionary(terms))
+        {
+            dictionary.clear();
+            codes.clear();
+
+            values.resize(terms.size());
+
+            for(size_t i = 0; i < terms.size(); i++)
+                values[i] = terms[i]->coefficient;
+        }
+
+        values.shrink_to_fit();
+        dictionary.shrink_to_fit();
+        codes.shrink_to_fit();
+    }
+
+    inline bool isCompact() const { return (!codes.empty()); }
+
+    inline double operator[](size_t i) const { return (codes.empty() ? values[i] : dictionary[codes[i]]); }
+
+private:
+    template <typename T> bool updateDictionary(const T& terms)
+    {
+        // The coefficients are compared by their bits, so that e.g. 0.0 and -0.0 are kept apart
+        std::unordered_map<uint64_t, uint8_t> positions;
+
+        codes.resize(terms.size());
+
+        for(size_t i = 0; i < terms.size(); i++)
+        {
+            double coefficient = terms[i]->coefficient;
+
+            uint64_t bits;
+            std::memcpy(&bits, &coefficient, sizeof(bits));
+
+            auto position = positions.find(bits);
+
+            if(position == positions.end())
+            {
+                if(dictionary.size() == 256)
+                    return (false);
+
+                position = positions.emplace(bits, (uint8_t)dictionary.size()).first;
+                dictionary.push_back(coefficient);
+            }
+
+            codes[i] = position->second;
+        }
+
+        return (true);
+    }
+};
+
+class PackedLinearTerms
+{
+public:
+    PackedCoefficients coefficients;
+    VectorInteger variableIndexes;
+
+    void update(const LinearTerms& terms, bool useCompactStorage = false)
+    {
+        coefficients.update(terms, useCompactStorage);
+        variableIndexes.resize(terms.size());
+
+        for(size_t i = 0; i < terms.size(); i++)
+            variableIndexes[i] = terms[i]->variable->index;
+    }
+
+    inline size_t size() const { return (variableIndexes.size()); }
+
+    inline double calculate(const VectorDouble& point) const
+    {
+        const int* index = variableIndexes.data();
+        size_t numberOfTerms = variableIndexes.size();
+
+        double value = 0.0;
+
+        if(coefficients.isCompact())
+        {
+            const double* dictionary = coefficients.dictionary.data();
+            const uint8_t* code = coefficients.codes.data();
+
+            for(size_t i = 0; i < numberOfTerms; i++)
+                value += dictionary[code[i]] * point[index[i]];
+
+            return (value);
+        }
+
+        const double* coefficient = coefficients.values.data();
+
+        for(size_t i = 0; i < numberOfTerms; i++)
+            value += coefficient[i] * point[index[i]];
+
+        return (value);
+    }
+
+    inline Interval calculate(const IntervalVector& intervalVector) const
+    {
+        Interval value = Interval(0.0, 0.0);
+
+        for(size_t i = 0; i < variableIndexes.size(); i++)
+            value += coefficients[i] * intervalVector[variableIndexes[i]];
+
+        return (value);
+    }
+
+    // Adds the values of the terms in all points to values
+    inline void calculate(const PointBlock& points, double* values) const
+    {
+        for(size_t i = 0; i < variableIndexes.size(); i++)
+        {
+            const double* variableValues = points.getVariableValues(variableIndexes[i]);
+            double coefficient = coefficients[i];
+
+            for(int p = 0; p < points.numberOfPoints; p++)
+                values[p] += coefficient * variableValues[p];
+        }
+    }
+};
+
+class PackedQuadraticTerms
+{
+public:
+    PackedCoefficients coefficients;
+    VectorInteger firstVariableIndexes;
+    VectorInteger secondVariableIndexes;
+
+    void update(const QuadraticTerms& terms, bool useCompactStorage = false)
+    {
+        coefficients.update(terms, useCompactStorage);
+        firstVariableIndexes.resize(terms.size());
+        secondVariableIndexes.resize(terms.size());
+
+        for(size_t i = 0; i < terms.size(); i++)
+        {
+            firstVariableIndexes[i] = terms[i]->firstVariable->index;
+            secondVariableIndexes[i] = terms[i]->secondVariable->index;
+        }
+    }
+
+    inline size_t size() const { return (firstVariableIndexes.size()); }
+
+    inline double calculate(const VectorDouble& point) const
+    {
+        const int* firstIndex = firstVariableIndexes.data();
+        const int* secondIndex = secondVariableIndexes.data();
+        size_t numberOfTerms = firstVariableIndexes.size();
+
+        double value = 0.0;
+
+        if(coefficients.isCompact())
+        {
+            const double* dictionary = coefficients.dictionary.data();
+            const uint8_t* code = coefficients.codes.data();
+
+            for(size_t i = 0; i < numberOfTerms; i++)
+                value += dictionary[code[i]] * point[firstIndex[i]] * point[secondIndex[i]];
+
+            return (value);
+        }
+
+        const double* coefficient = coefficients.values.data();
+
+        for(size_t i = 0; i < numberOfTerms; i++)
+            value += coefficient[i] * point[firstIndex[i]] * point[secondIndex[i]];
+
+        return (value);
+    }
+
+    inline Interval calculate(const IntervalVector& intervalVector) const
+    {
+        Interval value = Interval(0.0, 0.0);
+
+        for(size_t i = 0; i < firstVariableIndexes.size(); i++)
+        {
+            value += coefficients[i] * intervalVector[firstVariableIndexes[i]]
+                * intervalVector[secondVariableIndexes[i]];
+        }
+
+        return (value);
+    }
+
+    // Adds the coefficients of the terms as a polynomial in lambda along the segment
+    // lambda * firstPoint + (1 - lambda) * secondPoint, i.e. c[0] + c[1] * lambda + c[2] * lambda^2
+    inline void calculateSegmentCoefficients(
+        const VectorDouble& firstPoint, const VectorDouble& secondPoint, double* c) const
+    {
+        for(size_t i = 0; i < firstVariableIndexes.size(); i++)
+        {
+            double coefficient = coefficients[i];
+            double firstValue = secondPoint[firstVariableIndexes[i]];
+            double secondValue = secondPoint[secondVariableIndexes[i]];
+            double firstDirection = firstPoint[firstVariableIndexes[i]] - firstValue;
+            double secondDirection = firstPoint[secondVariableIndexes[i]] - secondValue;
+
+            c[0] += coefficient * firstValue * secondValue;
+            c[1] += coefficient * (firstValue * secondDirection + firstDirection * secondValue);
+            c[2] += coefficient * firstDirection * secondDirection;
+        }
+    }
+
+    // Adds the values of the terms in all points to values
+    inline void calculate(const PointBlock& points, double* values) const
+    {
+        for(size_t i = 0; i < firstVariableIndexes.size(); i++)
+        {
+            const double* firstValues = points.getVariableValues(firstVariableIndexes[i]);
+            const double* secondValues = points.getVariableValues(secondVariableIndexes[i]);
+            double coefficient = coefficients[i];
+
+            for(int p = 0; p < points.numberOfPoints; p++)
+                values[p] += coefficient * firstValues[p] * secondValues[p];
+        }
+    }
+};
+
 class MonomialTerm : public Term
 {
 public:
@@ -621,6 +931,22 @@ public:
         return value;
     }
 
+    inline void calculate(const PointBlock& points, double* values) const override
+    {
+        VectorDouble termValues(points.numberOfPoints, coefficient);
+
+        for(auto& V : variables)
+        {
+            const double* variableValues = points.getVariableValues(V->index);
+
+            for(int p = 0; p < points.numberOfPoints; p++)
+                termValues[p] *= variableValues[p];
+        }
+
+        for(int p = 0; p < points.numberOfPoints; p++)
+            values[p] += termValues[p];
+    }
+
     inline void takeOwnership(ProblemPtr owner) override
     {
         assert(ownerProblem.expired() || (ownerProblem.lock().get() == owner.get()));
@@ -731,7 +1057,7 @@ public:
 
             for(auto& V1 : T->variables)
             {
-                double value = 1.0;
+                double value = T->coefficient;
 
                 for(auto& V2 : T->variables)
                 {
@@ -741,7 +1067,13 @@ public:
                     value *= V2->calculate(point);
                 }
 
-                gradient.emplace(V1, value);
+                auto element = gradient.emplace(V1, value);
+
+                if(!element.second)
+                {
+                    // Element already exists for the variable
+                    element.first->second += value;
+                }
             }
         };
 
@@ -791,6 +1123,44 @@ public:
     };
 };
 
+// Calculates base^exponent for a nonnegative integer exponent by repeated squaring
+inline double calculateIntegerPower(double base, unsigned int exponent)
+{
+    double result = 1.0;
+
+    while(exponent > 0)
+    {
+        if(exponent & 1)
+            result *= base;
+
+        base *= base;
+        exponent >>= 1;
+    }
+
+    return (result);
+}
+
+// Calculates base^exponent with multiplications, square roots and reciprocals for the integer and half-integer
+// exponents common in signomial terms, and with pow for the others
+inline double calculatePower(double base, double exponent)
+{
+    // Larger integer exponents lose accuracy with repeated multiplications
+    const double maxExponent = 16.0;
+
+    double twiceExponent = 2.0 * exponent;
+
+    if(twiceExponent != std::trunc(twiceExponent) || std::abs(exponent) > maxExponent)
+        return (pow(base, exponent));
+
+    auto twiceAbsoluteExponent = (unsigned int)std::abs(twiceExponent);
+    double value = calculateIntegerPower(base, twiceAbsoluteExponent / 2);
+
+    if(twiceAbsoluteExponent % 2 == 1)
+        value *= std::sqrt(base);
+
+    return ((exponent < 0.0) ? 1.0 / value : value);
+}
+
 class SignomialElement
 {
 private:
@@ -800,7 +1170,10 @@ public:
 
     SignomialElement(VariablePtr variable, double power) : variable(variable), power(power) {};
 
-    inline double calculate(const VectorDouble& point) const { return pow(variable->calculate(point), power); }
+    inline double calculate(const VectorDouble& point) const
+    {
+        return (calculatePower(variable->calculate(point), power));
+    }
 
     inline Interval calculate(const IntervalVector& intervalVector) const
     {
@@ -986,6 +1359,46 @@ public:
         return value;
     }
 
+    inline void calculate(const PointBlock& points, double* values) const override
+    {
+        VectorDouble termValues(points.numberOfPoints, coefficient);
+
+        for(auto& E : elements)
+        {
+            const double* variableValues = points.getVariableValues(E->variable->index);
+
+            // The most common exponents are handled outside the loop over the points
+            if(E->power == 1.0)
+            {
+                for(int p = 0; p < points.numberOfPoints; p++)
+                    termValues[p] *= variableValues[p];
+            }
+            else if(E->power == 2.0)
+            {
+                for(int p = 0; p < points.numberOfPoints; p++)
+                    termValues[p] *= variableValues[p] * variableValues[p];
+            }
+            else if(E->power == 0.5)
+            {
+                for(int p = 0; p < points.numberOfPoints; p++)
+                    termValues[p] *= std::sqrt(variableValues[p]);
+            }
+            else if(E->power == -1.0)
+            {
+                for(int p = 0; p < points.numberOfPoints; p++)
+                    termValues[p] /= variableValues[p];
+            }
+            else
+            {
+                for(int p = 0; p < points.numberOfPoints; p++)
+                    termValues[p] *= calculatePower(variableValues[p], E->power);
+            }
+        }
+
+        for(int p = 0; p < points.numberOfPoints; p++)
+            values[p] += termValues[p];
+    }
+
     inline void takeOwnership(ProblemPtr owner) override
     {
         assert(ownerProblem.expired() || (ownerProblem.lock().get() == owner.get()));
@@ -1195,29 +1608,40 @@ public:
     {
         SparseVariableVector gradient;
 
+        // The powers of the elements in a term are calculated once and used for the partial derivatives of all of them
+        VectorDouble elementValues;
+
         for(auto& T : (*this))
         {
             if(T->coefficient == 0.0)
                 continue;
 
-            for(auto& E1 : T->elements)
+            elementValues.resize(T->elements.size());
+
+            for(size_t j = 0; j < T->elements.size(); j++)
+                elementValues[j] = T->elements[j]->calculate(point);
+
+            for(size_t i = 0; i < T->elements.size(); i++)
             {
+                auto& E1 = T->elements[i];
                 double value = 1.0;
 
-                for(auto& E2 : T->elements)
+                for(size_t j = 0; j < T->elements.size(); j++)
                 {
-                    if(E1 == E2)
+                    if(i == j)
                     {
-                        if(E2->power != 1.0)
-                            value *= E2->power * pow(E2->variable->calculate(point), E2->power - 1.0);
+                        if(E1->power != 1.0)
+                            value *= E1->power * calculatePower(E1->variable->calculate(point), E1->power - 1.0);
                     }
                     else
                     {
-                        value *= E2->calculate(point);
+                        value *= elementValues[j];
                     }
                 }
 
-                auto element = gradient.emplace(E1->variable, T->coefficient * value);
+                value *= T->coefficient;
+
+                auto element = gradient.emplace(E1->variable, value);
 
                 if(!element.second)
                 {
@@ -78,6 +78,8 @@ bool Variable::tightenBounds(const Interval bound)
     {
         if(auto sharedOwnerProblem = ownerProblem.lock())
         {
+            sharedOwnerProblem->synchronizeVariableBounds(index);
+
             if(sharedOwnerProblem->env->output)
             {
                 sharedOwnerProblem->env->output->outputDebug(
@@ -175,11 +175,15 @@ public:
         }
     }
 
+    // The variables are usually added in the order of their indexes, and are then only checked
     inline void sortByIndex()
     {
-        std::sort(this->begin(), this->end(), [](const VariablePtr& variableOne, const VariablePtr& variableTwo) {
+        auto isBefore = [](const VariablePtr& variableOne, const VariablePtr& variableTwo) {
             return (variableOne->index < variableTwo->index);
-        });
+        };
+
+        if(!std::is_sorted(this->begin(), this->end(), isBefore))
+            std::sort(this->begin(), this->end(), isBefore);
     }
 };
 
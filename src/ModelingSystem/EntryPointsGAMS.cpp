@@ -38,6 +38,7 @@ extern "C"
     typedef struct
     {
         gmoHandle_t gmo;
+        GAMSProblemCache* problemCache; // The problem of the previous call, e.g. in a GAMS solve loop
     } gamsshot;
 
     // old+new API
@@ -110,6 +111,9 @@ extern "C"
         assert(Cptr != nullptr);
         assert(*Cptr != nullptr);
 
+        gamsshot* gs = (gamsshot*)*Cptr;
+        delete gs->problemCache;
+
         free(*Cptr);
         *Cptr = nullptr;
 
@@ -161,6 +165,11 @@ extern "C"
             std::shared_ptr<ModelingSystemGAMS> modelingSystem = std::make_shared<SHOT::ModelingSystemGAMS>(env);
             modelingSystem->setModelingObject(gs->gmo);
 
+            if(gs->problemCache == nullptr)
+                gs->problemCache = new GAMSProblemCache();
+
+            modelingSystem->setProblemCache(gs->problemCache);
+
 #if PALAPIVERSION >= 3
             /* print auditline */
             palSetSystemName(modelingSystem->auditLicensing, "SHOT");
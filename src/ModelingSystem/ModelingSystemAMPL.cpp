@@ -13,6 +13,7 @@
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 
@@ -21,6 +22,8 @@
 #include "../Model/Simplifications.h"
 #include "../Model/Variables.h"
 
+#include "XMLStreamReader.h"
+
 #include "mp/nl.h"
 #include "mp/problem.h"
 #include "mp/nl-reader.h"
@@ -39,9 +42,12 @@ namespace fs = std;
 namespace fs = std::experimental;
 #endif
 
+#include <atomic>
+#include <exception>
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 namespace SHOT
 {
@@ -49,12 +55,134 @@ namespace SHOT
 using MPProblem = mp::Problem;
 using MPProblemPtr = std::shared_ptr<MPProblem>;
 
-class AMPLProblemHandler : public mp::NullNLHandler<NonlinearExpressionPtr>
+// Creates the nonlinear expressions from the expression callbacks of the .nl reader
+class AMPLExpressionHandler : public mp::NullNLHandler<NonlinearExpressionPtr>
 {
-private:
+protected:
     EnvironmentPtr env;
     ProblemPtr destination;
 
+    // Fixed variables are replaced by their values, which is only done if the bounds have been read
+    bool foldFixedVariables = true;
+
+public:
+    AMPLExpressionHandler(EnvironmentPtr envPtr, ProblemPtr problem) : env(envPtr), destination(problem) { }
+
+    NonlinearExpressionPtr OnNumber(double value) { return std::make_shared<ExpressionConstant>(value); }
+
+    NonlinearExpressionPtr OnVariableRef(int variableIndex)
+    {
+        auto variable = destination->getVariable(variableIndex);
+
+        if(foldFixedVariables && variable->lowerBound == variable->upperBound)
+            return std::make_shared<ExpressionConstant>(variable->lowerBound);
+
+        return std::make_shared<ExpressionVariable>(variable);
+    }
+
+    NonlinearExpressionPtr OnUnary(mp::expr::Kind kind, NonlinearExpressionPtr child)
+    {
+        switch(kind)
+        {
+
+        case mp::expr::MINUS:
+            return std::make_shared<ExpressionNegate>(child);
+
+        case mp::expr::ABS:
+            return std::make_shared<ExpressionAbs>(child);
+
+        case mp::expr::POW2:
+            return std::make_shared<ExpressionSquare>(child);
+
+        case mp::expr::SQRT:
+            return std::make_shared<ExpressionSquareRoot>(child);
+
+        case mp::expr::LOG:
+            return std::make_shared<ExpressionLog>(child);
+
+        case mp::expr::LOG10:
+            return std::make_shared<ExpressionProduct>(
+                std::make_shared<ExpressionConstant>(1.0 / log(10.0)), std::make_shared<ExpressionLog>(child));
+
+        case mp::expr::EXP:
+            return std::make_shared<ExpressionExp>(child);
+
+        case mp::expr::SIN:
+            return std::make_shared<ExpressionSin>(child);
+
+        case mp::expr::COS:
+            return std::make_shared<ExpressionCos>(child);
+
+        case mp::expr::TAN:
+            return std::make_shared<ExpressionTan>(child);
+
+        case mp::expr::ASIN:
+            return std::make_shared<ExpressionArcSin>(child);
+
+        case mp::expr::ACOS:
+            return std::make_shared<ExpressionArcCos>(child);
+
+        case mp::expr::ATAN:
+            return std::make_shared<ExpressionArcTan>(child);
+
+        default:
+            throw OperationNotImplementedException(fmt::format("Error: Unsupported AMPL function {}", kind));
+            break;
+        }
+
+        return nullptr;
+    }
+
+    NonlinearExpressionPtr OnBinary(
+        mp::expr::Kind kind, NonlinearExpressionPtr firstChild, NonlinearExpressionPtr secondChild)
+    {
+        switch(kind)
+        {
+        case mp::expr::ADD:
+            return std::make_shared<ExpressionSum>(firstChild, secondChild);
+
+        case mp::expr::SUB:
+            return std::make_shared<ExpressionSum>(firstChild, std::make_shared<ExpressionNegate>(secondChild));
+
+        case mp::expr::MUL:
+            return std::make_shared<ExpressionProduct>(firstChild, secondChild);
+
+        case mp::expr::DIV:
+            return std::make_shared<ExpressionDivide>(firstChild, secondChild);
+
+        case mp::expr::POW:
+            return std::make_shared<ExpressionPower>(firstChild, secondChild);
+
+        case mp::expr::POW_CONST_BASE:
+            return std::make_shared<ExpressionPower>(firstChild, secondChild);
+
+        case mp::expr::POW_CONST_EXP:
+            return std::make_shared<ExpressionPower>(firstChild, secondChild);
+
+        default:
+            throw OperationNotImplementedException(fmt::format("Error: Unsupported AMPL function {}", kind));
+            break;
+        }
+
+        return nullptr;
+    }
+
+    // Used for creating a list of terms in a sum
+    struct NumericArgHandler
+    {
+        NonlinearExpressions terms;
+
+        void AddArg(NonlinearExpressionPtr term) { terms.add(term); }
+    };
+
+    NumericArgHandler BeginSum(int) { return NumericArgHandler(); }
+
+    NonlinearExpressionPtr EndSum(NumericArgHandler handler) { return std::make_shared<ExpressionSum>(handler.terms); }
+};
+
+class AMPLProblemHandler : public AMPLExpressionHandler
+{
+private:
     NonlinearExpressions nonlinearExpressions;
 
     double minLBCont;
@@ -72,7 +200,9 @@ private:
     void reset() { nonlinearExpressions.clear(); }
 
 public:
-    AMPLProblemHandler(EnvironmentPtr envPtr, ProblemPtr problem) : env(envPtr), destination(problem)
+    mp::NLHeader header;
+
+    AMPLProblemHandler(EnvironmentPtr envPtr, ProblemPtr problem) : AMPLExpressionHandler(envPtr, problem)
     {
         this->minLBCont = env->settings->getSetting<double>("Variables.Continuous.MinimumLowerBound", "Model");
         this->maxUBCont = env->settings->getSetting<double>("Variables.Continuous.MaximumUpperBound", "Model");
@@ -82,6 +212,8 @@ public:
 
     void OnHeader(const mp::NLHeader& h)
     {
+        header = h;
+
         destination->allVariables.reserve(h.num_vars);
         destination->integerVariables.reserve(h.num_integer_vars());
         destination->realVariables.reserve(h.num_continuous_vars());
@@ -222,117 +354,6 @@ public:
         }
     }
 
-    NonlinearExpressionPtr OnNumber(double value) { return std::make_shared<ExpressionConstant>(value); }
-
-    NonlinearExpressionPtr OnVariableRef(int variableIndex)
-    {
-        auto variable = destination->getVariable(variableIndex);
-
-        if(variable->lowerBound == variable->upperBound)
-            return std::make_shared<ExpressionConstant>(variable->lowerBound);
-
-        return std::make_shared<ExpressionVariable>(variable);
-    }
-
-    NonlinearExpressionPtr OnUnary(mp::expr::Kind kind, NonlinearExpressionPtr child)
-    {
-        switch(kind)
-        {
-
-        case mp::expr::MINUS:
-            return std::make_shared<ExpressionNegate>(child);
-
-        case mp::expr::ABS:
-            return std::make_shared<ExpressionAbs>(child);
-
-        case mp::expr::POW2:
-            return std::make_shared<ExpressionSquare>(child);
-
-        case mp::expr::SQRT:
-            return std::make_shared<ExpressionSquareRoot>(child);
-
-        case mp::expr::LOG:
-            return std::make_shared<ExpressionLog>(child);
-
-        case mp::expr::LOG10:
-            return std::make_shared<ExpressionProduct>(
-                std::make_shared<ExpressionConstant>(1.0 / log(10.0)), std::make_shared<ExpressionLog>(child));
-
-        case mp::expr::EXP:
-            return std::make_shared<ExpressionExp>(child);
-
-        case mp::expr::SIN:
-            return std::make_shared<ExpressionSin>(child);
-
-        case mp::expr::COS:
-            return std::make_shared<ExpressionCos>(child);
-
-        case mp::expr::TAN:
-            return std::make_shared<ExpressionTan>(child);
-
-        case mp::expr::ASIN:
-            return std::make_shared<ExpressionArcSin>(child);
-
-        case mp::expr::ACOS:
-            return std::make_shared<ExpressionArcCos>(child);
-
-        case mp::expr::ATAN:
-            return std::make_shared<ExpressionArcTan>(child);
-
-        default:
-            throw OperationNotImplementedException(fmt::format("Error: Unsupported AMPL function {}", kind));
-            break;
-        }
-
-        return nullptr;
-    }
-
-    NonlinearExpressionPtr OnBinary(
-        mp::expr::Kind kind, NonlinearExpressionPtr firstChild, NonlinearExpressionPtr secondChild)
-    {
-        switch(kind)
-        {
-        case mp::expr::ADD:
-            return std::make_shared<ExpressionSum>(firstChild, secondChild);
-
-        case mp::expr::SUB:
-            return std::make_shared<ExpressionSum>(firstChild, std::make_shared<ExpressionNegate>(secondChild));
-
-        case mp::expr::MUL:
-            return std::make_shared<ExpressionProduct>(firstChild, secondChild);
-
-        case mp::expr::DIV:
-            return std::make_shared<ExpressionDivide>(firstChild, secondChild);
-
-        case mp::expr::POW:
-            return std::make_shared<ExpressionPower>(firstChild, secondChild);
-
-        case mp::expr::POW_CONST_BASE:
-            return std::make_shared<ExpressionPower>(firstChild, secondChild);
-
-        case mp::expr::POW_CONST_EXP:
-            return std::make_shared<ExpressionPower>(firstChild, secondChild);
-
-        default:
-            throw OperationNotImplementedException(fmt::format("Error: Unsupported AMPL function {}", kind));
-            break;
-        }
-
-        return nullptr;
-    }
-
-    // Used for creating a list of terms in a sum
-    struct NumericArgHandler
-    {
-        NonlinearExpressions terms;
-
-        void AddArg(NonlinearExpressionPtr term) { terms.add(term); }
-    };
-
-    NumericArgHandler BeginSum(int) { return NumericArgHandler(); }
-
-    NonlinearExpressionPtr EndSum(NumericArgHandler handler) { return std::make_shared<ExpressionSum>(handler.terms); }
-
     void OnObj([[maybe_unused]] int objectiveIndex, mp::obj::Type type, NonlinearExpressionPtr nonlinearExpression)
     {
         if(type == mp::obj::Type::MAX)
@@ -642,6 +663,218 @@ public:
     }
 };
 
+// The parts of the constraints read from some of the C and J segments of a .nl file
+struct AMPLConstraintParts
+{
+    NonlinearExpressionPtr nonlinearExpression;
+    LinearTerms linearTerms;
+    double constant = 0.0;
+};
+
+// Reads C and J segments into the constraint parts instead of the problem, so that several segments can be read at
+// the same time after the variables have been created
+class AMPLConstraintSegmentHandler : public AMPLExpressionHandler
+{
+private:
+    std::vector<AMPLConstraintParts>& constraintParts;
+
+public:
+    AMPLConstraintSegmentHandler(EnvironmentPtr envPtr, ProblemPtr problem,
+        std::vector<AMPLConstraintParts>& constraintParts, bool foldFixedVariables)
+        : AMPLExpressionHandler(envPtr, problem), constraintParts(constraintParts)
+    {
+        this->foldFixedVariables = foldFixedVariables;
+    }
+
+    void OnAlgebraicCon(int constraintIndex, NonlinearExpressionPtr nonlinearExpression)
+    {
+        constraintParts[constraintIndex].nonlinearExpression = nonlinearExpression;
+    }
+
+    class LinearPartHandler
+    {
+    private:
+        AMPLConstraintSegmentHandler& handler;
+        AMPLConstraintParts& parts;
+
+    public:
+        LinearPartHandler(AMPLConstraintSegmentHandler& handler, AMPLConstraintParts& parts)
+            : handler(handler), parts(parts)
+        {
+        }
+
+        void AddTerm(int variableIndex, double coefficient)
+        {
+            if(coefficient == 0.0)
+                return;
+
+            auto variable = handler.destination->getVariable(variableIndex);
+
+            if(handler.foldFixedVariables && variable->lowerBound == variable->upperBound)
+                parts.constant += coefficient * variable->lowerBound;
+            else
+                parts.linearTerms.add(std::make_shared<LinearTerm>(coefficient, variable));
+        }
+    };
+
+    typedef LinearPartHandler LinearConHandler;
+
+    LinearConHandler OnLinearConExpr(int constraintIndex, [[maybe_unused]] int numLinearTerms)
+    {
+        return LinearConHandler(*this, constraintParts[constraintIndex]);
+    }
+};
+
+// Reads a text .nl file where the C and J segments, i.e. the nonlinear and linear parts of the constraints, are read
+// in chunks by several threads. The other segments are first read as usual, so that the variables and their bounds
+// exist when the constraints are read. Returns false without reading anything if the file is not suited for this,
+// e.g. if it is binary, has defined variables or is too small.
+static bool readNLFileInParallel(
+    EnvironmentPtr env, ProblemPtr problem, const std::string& filename, AMPLProblemHandler& handler)
+{
+    int numberOfThreads = env->settings->getSetting<int>("AMPL.NumberOfThreads", "ModelingSystem");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    if(numberOfThreads <= 1)
+        return (false);
+
+    MappedFile file;
+
+    if(!file.open(filename))
+        return (false);
+
+    auto contents = file.getContents();
+
+    if(contents.empty() || contents[0] != 'g')
+        return (false);
+
+    struct Segment
+    {
+        std::string_view text;
+        bool isAfterVariableBounds;
+    };
+
+    // Segments start with their type at the beginning of a line, which is not the case for the lines in the header or
+    // within the segments. Strings, which could contain line breaks, are only used with imported functions.
+    const char* segmentTypes = "CLOVFGJSbrKkxd";
+    std::vector<size_t> segmentStarts;
+
+    for(size_t position = contents.find('\n'); position != std::string_view::npos && position + 1 < contents.size();
+        position = contents.find('\n', position + 1))
+    {
+        char type = contents[position + 1];
+
+        if(type != '\0' && std::strchr(segmentTypes, type) != nullptr)
+            segmentStarts.push_back(position + 1);
+    }
+
+    if(segmentStarts.empty())
+        return (false);
+
+    segmentStarts.push_back(contents.size());
+
+    std::vector<Segment> constraintSegments;
+    std::string otherSegments(contents.substr(0, segmentStarts[0]));
+    bool isAfterVariableBounds = false;
+
+    for(size_t i = 0; i + 1 < segmentStarts.size(); i++)
+    {
+        auto text = contents.substr(segmentStarts[i], segmentStarts[i + 1] - segmentStarts[i]);
+        char type = text[0];
+
+        if(type == 'V' || type == 'L' || type == 'F')
+            return (false);
+
+        if(type == 'C' || type == 'J')
+            constraintSegments.push_back({ text, isAfterVariableBounds });
+        else
+            otherSegments.append(text);
+
+        if(type == 'b')
+            isAfterVariableBounds = true;
+    }
+
+    // Each chunk has segments that are either all before or all after the variable bounds
+    const size_t maximumSegmentsPerChunk = 1000;
+    std::vector<std::pair<std::string, bool>> chunks;
+
+    for(size_t i = 0; i < constraintSegments.size(); i++)
+    {
+        if(i % maximumSegmentsPerChunk == 0
+            || constraintSegments[i].isAfterVariableBounds != constraintSegments[i - 1].isAfterVariableBounds)
+            chunks.emplace_back(std::string(), constraintSegments[i].isAfterVariableBounds);
+
+        chunks.back().first.append(constraintSegments[i].text);
+    }
+
+    numberOfThreads = std::min(numberOfThreads, (int)chunks.size());
+
+    if(numberOfThreads <= 1)
+        return (false);
+
+    mp::ReadNLString(mp::NLStringRef(otherSegments.c_str(), otherSegments.size()), handler, filename, 0);
+
+    std::vector<AMPLConstraintParts> constraintParts(handler.header.num_algebraic_cons);
+    std::vector<std::exception_ptr> exceptions(chunks.size());
+    std::atomic<size_t> nextChunk(0);
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads);
+
+    for(int t = 0; t < numberOfThreads; t++)
+    {
+        threads.emplace_back([&]() {
+            for(size_t k = nextChunk++; k < chunks.size(); k = nextChunk++)
+            {
+                try
+                {
+                    AMPLConstraintSegmentHandler segmentHandler(env, problem, constraintParts, chunks[k].second);
+                    mp::internal::TextReader<> reader(
+                        mp::NLStringRef(chunks[k].first.c_str(), chunks[k].first.size()), filename);
+
+                    // The bound reader is given since the chunk has no bounds segment
+                    mp::internal::NLReader<mp::internal::TextReader<>, AMPLConstraintSegmentHandler>(
+                        reader, handler.header, segmentHandler, 0)
+                        .Read(&reader);
+                }
+                catch(...)
+                {
+                    exceptions[k] = std::current_exception();
+                }
+            }
+        });
+    }
+
+    for(auto& T : threads)
+        T.join();
+
+    for(auto& E : exceptions)
+    {
+        if(E)
+            std::rethrow_exception(E);
+    }
+
+    // The parts are added in the order of the constraints, so that the problem is the same as when read sequentially
+    for(size_t i = 0; i < constraintParts.size(); i++)
+    {
+        auto& parts = constraintParts[i];
+        auto constraint = std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[i]);
+
+        if(parts.nonlinearExpression)
+            std::dynamic_pointer_cast<NonlinearConstraint>(constraint)->add(parts.nonlinearExpression);
+
+        for(auto& T : parts.linearTerms)
+            constraint->add(T);
+
+        constraint->constant += parts.constant;
+    }
+
+    env->output->outputDebug(fmt::format(
+        "  Constraints in AMPL model read in {} chunks using {} threads.", chunks.size(), numberOfThreads));
+
+    return (true);
+}
+
 ModelingSystemAMPL::ModelingSystemAMPL(EnvironmentPtr envPtr) : IModelingSystem(envPtr) { }
 
 ModelingSystemAMPL::~ModelingSystemAMPL() = default;
@@ -652,6 +885,8 @@ void ModelingSystemAMPL::augmentSettings(SettingsPtr settings)
         "The AMPL options header for the solution file", true);
     settings->createSetting("AMPL.NumberOfOriginalConstraints", "ModelingSystem", 0,
         "The number of constraints in the original problem submitted to SHOT", 0, SHOT_INT_MAX, true);
+    settings->createSetting("AMPL.NumberOfThreads", "ModelingSystem", 0,
+        "Number of threads to use when reading the constraints in text .nl files: 0: Automatic", 0, 999);
 }
 
 void ModelingSystemAMPL::updateSettings([[maybe_unused]] SettingsPtr settings) { }
@@ -674,7 +909,9 @@ E_ProblemCreationStatus ModelingSystemAMPL::createProblem(ProblemPtr& problem, c
     try
     {
         AMPLProblemHandler handler(env, problem);
-        mp::ReadNLFile(filename, handler);
+
+        if(!readNLFileInParallel(env, problem, filename, handler))
+            mp::ReadNLFile(filename, handler);
     }
     catch(const std::exception& e)
     {
@@ -14,6 +14,7 @@
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 #include "../Enums.h"
@@ -32,8 +33,14 @@
 
 #include <cstdio> // for tmpnam()
 #include <cstdlib> // for mkdtemp()
+#include <algorithm>
+#include <atomic>
 #include <climits>
+#include <cstring>
+#include <exception>
 #include <fstream>
+#include <thread>
+#include <vector>
 
 #ifdef HAS_STD_FILESYSTEM
 #include <filesystem>
@@ -48,6 +55,27 @@ namespace fs = std::experimental;
 namespace SHOT
 {
 
+namespace
+{
+
+template <typename T> void addToFingerprint(uint64_t& fingerprint, T value)
+{
+    uint64_t word = 0;
+    std::memcpy(&word, &value, std::min(sizeof(value), sizeof(word)));
+
+    fingerprint ^= word + 0x9e3779b97f4a7c15ULL + (fingerprint << 6) + (fingerprint >> 2);
+}
+
+template <typename T> void addToFingerprint(uint64_t& fingerprint, const T* values, int numberOfValues)
+{
+    addToFingerprint(fingerprint, numberOfValues);
+
+    for(int i = 0; i < numberOfValues; i++)
+        addToFingerprint(fingerprint, values[i]);
+}
+
+} // namespace
+
 ModelingSystemGAMS::ModelingSystemGAMS(EnvironmentPtr envPtr)
     : IModelingSystem(envPtr)
     , modelingObject(nullptr)
@@ -91,6 +119,9 @@ void ModelingSystemGAMS::augmentSettings([[maybe_unused]] SettingsPtr settings)
     std::string solver = "auto";
     settings->createSetting("GAMS.NLP.Solver", "Subsolver", solver, "NLP solver to use in GAMS (auto: SHOT chooses)");
 
+    settings->createSetting("GAMS.NLP.WarmStart", "Subsolver", true,
+        "Start the NLP solver from the marginals and basis of the last solved fixed NLP problem");
+
 #if GMOAPIVERSION >= 21
     settings->createSettingGroup(
         "ModelingSystem", "GAMS", "GAMS interface", "These settings control functionality used in the GAMS interface.");
@@ -105,6 +136,16 @@ void ModelingSystemGAMS::augmentSettings([[maybe_unused]] SettingsPtr settings)
     settings->createSetting("GAMS.QExtractAlg", "ModelingSystem", 0,
         "Extraction algorithm for quadratic equations in GAMS interface", enumQExtractAlg);
 #endif
+
+    settings->createSetting("GAMS.ConversionCache.Directory", "ModelingSystem", std::string(),
+        "Directory where the GAMS conversions of .gms files are kept and reused for files with the same contents: "
+        "empty: not used");
+
+    settings->createSetting("GAMS.NumberOfThreads", "ModelingSystem", 0,
+        "Number of threads to use when decoding the nonlinear equations: 0: Automatic", 0, 999);
+
+    settings->createSetting("GAMS.ReuseProblem", "ModelingSystem", true,
+        "Reuse the problem created in an earlier solve of the model if only the variable bounds have changed");
 }
 
 void ModelingSystemGAMS::updateSettings(SettingsPtr settings)
@@ -318,6 +359,27 @@ E_ProblemCreationStatus ModelingSystemGAMS::createProblem(ProblemPtr& problem)
         gmoNameInput(modelingObject, buffer);
         problem->name = buffer;
 
+        uint64_t fingerprint = 0;
+
+        if(problemCache != nullptr && env->settings->getSetting<bool>("GAMS.ReuseProblem", "ModelingSystem"))
+        {
+            fingerprint = getModelFingerprint();
+
+            // The copy is created with the settings and bounds of this solve, and the cached problem is not modified by
+            // the solver
+            if(problemCache->problem && problemCache->fingerprint == fingerprint
+                && updateVariableBounds(problemCache->problem))
+            {
+                problem = problemCache->problem->createCopy(env);
+                problem->name = buffer;
+
+                env->output->outputDebug(" Problem reused from an earlier solve of the GAMS model.");
+
+                env->timing->stopTimer("ProblemInitialization");
+                return (E_ProblemCreationStatus::NormalCompletion);
+            }
+        }
+
         /* copyVariables and copyConstraints only return false if there was an unsupported variable or equation type
          * or there were no variables or no equations all cases are SHOT capability problems
          */
@@ -375,6 +437,12 @@ E_ProblemCreationStatus ModelingSystemGAMS::createProblem(ProblemPtr& problem)
         simplifyNonlinearExpressions(problem, extractMonomialTerms, extractSignomialTerms, extractQuadraticTerms);
 
         problem->finalize();
+
+        if(problemCache != nullptr && env->settings->getSetting<bool>("GAMS.ReuseProblem", "ModelingSystem"))
+        {
+            problemCache->fingerprint = fingerprint;
+            problemCache->problem = problem->createCopy(env);
+        }
     }
     catch(const OperationNotImplementedException& e)
     {
@@ -403,16 +471,50 @@ void ModelingSystemGAMS::createModelFromProblemFile(const std::string& filename)
     assert(modelingObject == nullptr);
     assert(modelingEnvironment == nullptr);
 
-    if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
-        tmpdirname = Utilities::createTemporaryDirectory(
-            "SHOT_GAMS_", env->settings->getSetting<std::string>("Debug.Path", "Output"));
+    std::string cacheDirectory
+        = env->settings->getSetting<std::string>("GAMS.ConversionCache.Directory", "ModelingSystem");
+
+    fs::filesystem::path conversionMarker;
+
+    if(!cacheDirectory.empty())
+    {
+        // The conversion is done in a directory named by the hash of the contents of the model file, and is kept
+        // there since the control file refers to the other files in it. The marker file is written when the conversion
+        // is complete. Files included in the model are not part of the hash.
+        std::string contents = Utilities::getFileAsString(filename);
+
+        uint64_t hash = 0;
+        addToFingerprint(hash, contents.data(), (int)contents.size());
+
+        tmpdirname = (fs::filesystem::path(cacheDirectory) / fmt::format("{:016x}", hash)).string();
+        conversionMarker = fs::filesystem::path(tmpdirname) / "shotconversion.done";
+
+        if(fs::filesystem::exists(conversionMarker))
+        {
+            env->output->outputDebug(" Reusing the GAMS conversion of the model in " + tmpdirname);
+
+            createModelFromConversion();
+            return;
+        }
+
+        fs::filesystem::remove_all(tmpdirname);
+
+        if(!fs::filesystem::create_directories(tmpdirname))
+            throw std::logic_error("Could not create directory " + tmpdirname + " for the GAMS conversion.");
+    }
     else
-        tmpdirname = Utilities::createTemporaryDirectory("SHOT_GAMS_");
+    {
+        if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
+            tmpdirname = Utilities::createTemporaryDirectory(
+                "SHOT_GAMS_", env->settings->getSetting<std::string>("Debug.Path", "Output"));
+        else
+            tmpdirname = Utilities::createTemporaryDirectory("SHOT_GAMS_");
 
-    if(tmpdirname == "")
-        throw std::logic_error("Could not create temporary directory.");
+        if(tmpdirname == "")
+            throw std::logic_error("Could not create temporary directory.");
 
-    createdtmpdir = true;
+        createdtmpdir = true;
+    }
 
     /* create empty convert options file */
     std::ofstream convertopt((fs::filesystem::path(tmpdirname) / "convert.opt").string(), std::ios::out);
@@ -533,6 +635,17 @@ void ModelingSystemGAMS::createModelFromProblemFile(const std::string& filename)
     }
     }
 
+    if(!conversionMarker.empty())
+    {
+        std::ofstream marker(conversionMarker.string(), std::ios::out);
+        marker << filename << std::endl;
+    }
+
+    createModelFromConversion();
+}
+
+void ModelingSystemGAMS::createModelFromConversion()
+{
     createModelFromGAMSModel((fs::filesystem::path(tmpdirname) / "gamscntr.dat").string());
 
     /* since we ran convert with options file, GMO now stores convert.opt as options file, which we don't want to
@@ -967,14 +1080,14 @@ bool ModelingSystemGAMS::copyVariables(ProblemPtr destination)
 
             if(isSemi)
             {
-                auto variable = std::make_shared<SHOT::Variable>(
+                auto variable = destination->arena.create<Variable>(
                     variableName, i, variableType, variableLBs[i], variableUBs[i], semiBound);
                 destination->add(std::move(variable));
             }
             else
             {
-                auto variable
-                    = std::make_shared<SHOT::Variable>(variableName, i, variableType, variableLBs[i], variableUBs[i]);
+                auto variable = destination->arena.create<Variable>(
+                    variableName, i, variableType, variableLBs[i], variableUBs[i]);
                 destination->add(std::move(variable));
             }
         }
@@ -1063,7 +1176,7 @@ bool ModelingSystemGAMS::copyObjectiveFunction(ProblemPtr destination)
                 else
                 {
                     (std::static_pointer_cast<LinearObjectiveFunction>(objectiveFunction))
-                        ->add(std::make_shared<LinearTerm>(coefficients[i], variable));
+                        ->add(destination->arena.create<LinearTerm>(coefficients[i], variable));
                 }
             }
             catch(const VariableNotFoundException&)
@@ -1172,54 +1285,51 @@ bool ModelingSystemGAMS::copyLinearTerms(ProblemPtr destination)
 {
     env->output->outputTrace(" Starting to copy linear terms between GAMS modeling and SHOT problem objects.");
 
-    double* linearCoefficients = new double[gmoNZ(modelingObject) + gmoN(modelingObject)];
-    int* variableIndexes = new int[gmoNZ(modelingObject) + gmoN(modelingObject)];
-    int* nonlinearFlags = new int[gmoN(modelingObject)];
-
     int numConstraints = gmoM(modelingObject);
-    int nz = 0;
-    for(int row = 0; row < numConstraints; ++row)
-    {
-        int rownz;
-        int nlnz;
+    int numNonzeros = gmoNZ(modelingObject);
 
-        gmoGetRowSparse(
-            modelingObject, row, &variableIndexes[nz], &linearCoefficients[nz], nonlinearFlags, &rownz, &nlnz);
+    std::vector<int> rowStarts(numConstraints + 1);
+    std::vector<int> variableIndexes(numNonzeros + 1);
+    std::vector<double> linearCoefficients(numNonzeros + 1);
+    std::vector<int> nonlinearFlags(numNonzeros + 1);
 
-        try
+    // The whole Jacobian is fetched at once instead of row by row
+    gmoGetMatrixRow(
+        modelingObject, rowStarts.data(), variableIndexes.data(), linearCoefficients.data(), nonlinearFlags.data());
+
+    try
+    {
+        for(int row = 0; row < numConstraints; ++row)
         {
             LinearConstraintPtr constraint
                 = std::static_pointer_cast<LinearConstraint>(destination->getConstraint(row));
 
-            for(int j = 0; j < rownz; j++)
+            // The variables in a row are unique, so the terms are added at once without checking for duplicates
+            LinearTerms terms;
+            terms.reserve(rowStarts[row + 1] - rowStarts[row]);
+
+            for(int j = rowStarts[row]; j < rowStarts[row + 1]; j++)
             {
                 auto variable = destination->getVariable(variableIndexes[j]);
 
                 if(variable->lowerBound == variable->upperBound)
                     constraint->constant += variable->lowerBound * linearCoefficients[j];
                 else
-                    constraint->add(std::make_shared<LinearTerm>(linearCoefficients[j], variable));
+                    terms.push_back(destination->arena.create<LinearTerm>(linearCoefficients[j], variable));
             }
-        }
-        catch(const VariableNotFoundException&)
-        {
-            delete[] linearCoefficients;
-            delete[] variableIndexes;
-            delete[] nonlinearFlags;
-            return (false);
-        }
-        catch(const ConstraintNotFoundException&)
-        {
-            delete[] linearCoefficients;
-            delete[] variableIndexes;
-            delete[] nonlinearFlags;
-            return (false);
+
+            if(terms.size() > 0)
+                constraint->add(std::move(terms));
         }
     }
-
-    delete[] linearCoefficients;
-    delete[] variableIndexes;
-    delete[] nonlinearFlags;
+    catch(const VariableNotFoundException&)
+    {
+        return (false);
+    }
+    catch(const ConstraintNotFoundException&)
+    {
+        return (false);
+    }
 
     env->output->outputTrace(" Finished copying linear terms between GAMS modeling and SHOT problem objects.");
 
@@ -1270,19 +1380,20 @@ bool ModelingSystemGAMS::copyQuadraticTerms(ProblemPtr destination)
                 else if(firstVariableFixed)
                 {
                     (std::static_pointer_cast<LinearObjectiveFunction>(destination->objectiveFunction))
-                        ->add(std::make_shared<LinearTerm>(
+                        ->add(destination->arena.create<LinearTerm>(
                             quadraticCoefficients[j] * firstVariable->lowerBound, secondVariable));
                 }
                 else if(secondVariableFixed)
                 {
                     (std::static_pointer_cast<LinearObjectiveFunction>(destination->objectiveFunction))
-                        ->add(std::make_shared<LinearTerm>(
+                        ->add(destination->arena.create<LinearTerm>(
                             quadraticCoefficients[j] * secondVariable->lowerBound, firstVariable));
                 }
                 else
                 {
                     (std::static_pointer_cast<QuadraticObjectiveFunction>(destination->objectiveFunction))
-                        ->add(std::make_shared<QuadraticTerm>(quadraticCoefficients[j], firstVariable, secondVariable));
+                        ->add(destination->arena.create<QuadraticTerm>(
+                            quadraticCoefficients[j], firstVariable, secondVariable));
                 }
             }
             catch(const VariableNotFoundException&)
@@ -1301,84 +1412,85 @@ bool ModelingSystemGAMS::copyQuadraticTerms(ProblemPtr destination)
     }
 
     int numberOfConstraints = gmoM(modelingObject);
+    int maxNumQuadraticTerms = 0;
 
     for(int i = 0; i < numberOfConstraints; ++i)
     {
         if(gmoGetEquOrderOne(modelingObject, i) == gmoorder_Q)
-        {
-            // handle quadratic equation
+            maxNumQuadraticTerms = std::max(maxNumQuadraticTerms, gmoGetRowQNZOne(modelingObject, i));
+    }
 
-            int numQuadraticTerms = gmoGetRowQNZOne(modelingObject, i);
+    // The arrays are allocated once for all quadratic equations
+    std::vector<int> variableOneIndexes(maxNumQuadraticTerms);
+    std::vector<int> variableTwoIndexes(maxNumQuadraticTerms);
+    std::vector<double> quadraticCoefficients(maxNumQuadraticTerms);
 
-            int* variableOneIndexes = new int[numQuadraticTerms];
-            int* variableTwoIndexes = new int[numQuadraticTerms];
-            double* quadraticCoefficients = new double[numQuadraticTerms];
+    for(int i = 0; i < numberOfConstraints; ++i)
+    {
+        if(gmoGetEquOrderOne(modelingObject, i) != gmoorder_Q)
+            continue;
+
+        int numQuadraticTerms = gmoGetRowQNZOne(modelingObject, i);
 
 #if GMOAPIVERSION <= 19
-            gmoGetRowQ(modelingObject, i, variableOneIndexes, variableTwoIndexes, quadraticCoefficients);
+        gmoGetRowQ(modelingObject, i, variableOneIndexes.data(), variableTwoIndexes.data(),
+            quadraticCoefficients.data());
 #else
-            gmoGetRowQMat(modelingObject, i, variableOneIndexes, variableTwoIndexes, quadraticCoefficients);
+        gmoGetRowQMat(modelingObject, i, variableOneIndexes.data(), variableTwoIndexes.data(),
+            quadraticCoefficients.data());
 #endif
 
+        try
+        {
+            auto constraint = std::static_pointer_cast<QuadraticConstraint>(destination->getConstraint(i));
+
+            QuadraticTerms terms;
+            terms.reserve(numQuadraticTerms);
+
             for(int j = 0; j < numQuadraticTerms; ++j)
             {
                 if(variableOneIndexes[j] == variableTwoIndexes[j])
                     quadraticCoefficients[j] /= 2.0; /* for some strange reason, the coefficients on the diagonal
                                                         are multiplied by 2 in GMO */
 
-                try
-                {
-                    VariablePtr firstVariable = destination->getVariable(variableOneIndexes[j]);
-                    VariablePtr secondVariable = destination->getVariable(variableTwoIndexes[j]);
+                VariablePtr firstVariable = destination->getVariable(variableOneIndexes[j]);
+                VariablePtr secondVariable = destination->getVariable(variableTwoIndexes[j]);
 
-                    bool firstVariableFixed = firstVariable->lowerBound == firstVariable->upperBound;
-                    bool secondVariableFixed = secondVariable->lowerBound == secondVariable->upperBound;
+                bool firstVariableFixed = firstVariable->lowerBound == firstVariable->upperBound;
+                bool secondVariableFixed = secondVariable->lowerBound == secondVariable->upperBound;
 
-                    if(firstVariableFixed && secondVariableFixed)
-                    {
-                        (std::static_pointer_cast<LinearConstraint>(destination->getConstraint(i)))->constant
-                            += quadraticCoefficients[j] * firstVariable->lowerBound * secondVariable->lowerBound;
-                    }
-                    else if(firstVariableFixed)
-                    {
-                        (std::static_pointer_cast<LinearConstraint>(destination->getConstraint(i)))
-                            ->add(std::make_shared<LinearTerm>(
-                                quadraticCoefficients[j] * firstVariable->lowerBound, secondVariable));
-                    }
-                    else if(secondVariableFixed)
-                    {
-                        (std::static_pointer_cast<LinearConstraint>(destination->getConstraint(i)))
-                            ->add(std::make_shared<LinearTerm>(
-                                quadraticCoefficients[j] * secondVariable->lowerBound, firstVariable));
-                    }
-                    else
-                    {
-                        (std::static_pointer_cast<QuadraticConstraint>(destination->getConstraint(i)))
-                            ->add(std::make_shared<QuadraticTerm>(
-                                quadraticCoefficients[j], firstVariable, secondVariable));
-                    }
+                if(firstVariableFixed && secondVariableFixed)
+                {
+                    constraint->constant
+                        += quadraticCoefficients[j] * firstVariable->lowerBound * secondVariable->lowerBound;
                 }
-                catch(const VariableNotFoundException&)
+                else if(firstVariableFixed)
                 {
-                    delete[] variableOneIndexes;
-                    delete[] variableTwoIndexes;
-                    delete[] quadraticCoefficients;
-
-                    return (false);
+                    constraint->add(destination->arena.create<LinearTerm>(
+                        quadraticCoefficients[j] * firstVariable->lowerBound, secondVariable));
+                }
+                else if(secondVariableFixed)
+                {
+                    constraint->add(destination->arena.create<LinearTerm>(
+                        quadraticCoefficients[j] * secondVariable->lowerBound, firstVariable));
                 }
-                catch(const ConstraintNotFoundException&)
+                else
                 {
-                    delete[] variableOneIndexes;
-                    delete[] variableTwoIndexes;
-                    delete[] quadraticCoefficients;
-
-                    return (false);
+                    terms.push_back(destination->arena.create<QuadraticTerm>(
+                        quadraticCoefficients[j], firstVariable, secondVariable));
                 }
             }
 
-            delete[] variableOneIndexes;
-            delete[] variableTwoIndexes;
-            delete[] quadraticCoefficients;
+            if(terms.size() > 0)
+                constraint->add(std::move(terms));
+        }
+        catch(const VariableNotFoundException&)
+        {
+            return (false);
+        }
+        catch(const ConstraintNotFoundException&)
+        {
+            return (false);
         }
     }
 
@@ -1405,8 +1517,8 @@ bool ModelingSystemGAMS::copyNonlinearExpressions(ProblemPtr destination)
 
         try
         {
-            auto destinationExpression
-                = parseGamsInstructions(codelen, opcodes, fields, constantlen, constants, destination);
+            auto destinationExpression = parseGamsInstructions(
+                codelen, opcodes, fields, constantlen, constants, destination, destination->arena, true);
 
             if(codelen > 0)
             {
@@ -1414,13 +1526,13 @@ bool ModelingSystemGAMS::copyNonlinearExpressions(ProblemPtr destination)
                 if(objjacval == 1.0)
                 {
                     // scale by -1/objjacval = negate
-                    destinationExpression = std::make_shared<ExpressionNegate>(destinationExpression);
+                    destinationExpression = destination->arena.create<ExpressionNegate>(destinationExpression);
                 }
                 else if(objjacval != -1.0)
                 {
                     // scale by -1/objjacval
-                    destinationExpression = std::make_shared<ExpressionProduct>(
-                        std::make_shared<ExpressionConstant>(-1 / objjacval), destinationExpression);
+                    destinationExpression = destination->arena.create<ExpressionProduct>(
+                        destination->arena.create<ExpressionConstant>(-1 / objjacval), destinationExpression);
                 }
 
                 auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(destination->objectiveFunction);
@@ -1436,9 +1548,28 @@ bool ModelingSystemGAMS::copyNonlinearExpressions(ProblemPtr destination)
         }
     }
 
+    std::vector<int> nonlinearRows;
+
     for(int i = 0; i < gmoM(modelingObject); ++i)
     {
         if(gmoGetEquOrderOne(modelingObject, i) == gmoorder_NL)
+            nonlinearRows.push_back(i);
+    }
+
+    int numberOfThreads = env->settings->getSetting<int>("GAMS.NumberOfThreads", "ModelingSystem");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    // Decoding in parallel only pays off for many rows, and the debug output is only written when decoding sequentially
+    const int minimumRowsPerThread = 100;
+    numberOfThreads = std::min(numberOfThreads, (int)nonlinearRows.size() / minimumRowsPerThread);
+
+    if(gevGetIntOpt(modelingEnvironment, gevInteger1) & 0x4)
+        numberOfThreads = 1;
+
+    if(numberOfThreads <= 1)
+    {
+        for(int i : nonlinearRows)
         {
             gmoDirtyGetRowFNLInstr(modelingObject, i, &codelen, opcodes, fields);
             if(codelen == 0)
@@ -1446,8 +1577,8 @@ bool ModelingSystemGAMS::copyNonlinearExpressions(ProblemPtr destination)
 
             try
             {
-                auto destinationExpression
-                    = parseGamsInstructions(codelen, opcodes, fields, constantlen, constants, destination);
+                auto destinationExpression = parseGamsInstructions(
+                    codelen, opcodes, fields, constantlen, constants, destination, destination->arena, true);
 
                 auto constraint = std::dynamic_pointer_cast<NonlinearConstraint>(destination->getConstraint(i));
 
@@ -1462,6 +1593,102 @@ bool ModelingSystemGAMS::copyNonlinearExpressions(ProblemPtr destination)
             }
         }
     }
+    else
+    {
+        // All instructions are fetched first and the variables translated to solver indexes, since GMO is only used
+        // from this thread
+        std::vector<std::vector<int>> rowOpcodes(nonlinearRows.size());
+        std::vector<std::vector<int>> rowFields(nonlinearRows.size());
+
+        for(size_t k = 0; k < nonlinearRows.size(); k++)
+        {
+            gmoDirtyGetRowFNLInstr(modelingObject, nonlinearRows[k], &codelen, opcodes, fields);
+
+            rowOpcodes[k].assign(opcodes, opcodes + codelen);
+            rowFields[k].assign(fields, fields + codelen);
+
+            for(int j = 0; j < codelen; j++)
+            {
+                switch((GamsOpCode)opcodes[j])
+                {
+                case nlPushV:
+                case nlAddV:
+                case nlSubV:
+                case nlMulV:
+                case nlDivV:
+                case nlUMinV:
+                    rowFields[k][j] = gmoGetjSolver(modelingObject, fields[j] - 1) + 1;
+                    break;
+
+                default:
+                    break;
+                }
+            }
+        }
+
+        // The expressions of each thread are created in an arena of its own, which the expressions keep alive
+        std::vector<NonlinearExpressionPtr> expressions(nonlinearRows.size());
+        std::vector<std::exception_ptr> exceptions(numberOfThreads);
+        std::atomic<size_t> nextRow(0);
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+        {
+            threads.emplace_back([&, t]() {
+                ModelArena arena;
+
+                try
+                {
+                    for(size_t k = nextRow++; k < nonlinearRows.size(); k = nextRow++)
+                    {
+                        if(rowOpcodes[k].empty())
+                            continue;
+
+                        expressions[k] = parseGamsInstructions(rowOpcodes[k].size(), rowOpcodes[k].data(),
+                            rowFields[k].data(), constantlen, constants, destination, arena, false);
+                    }
+                }
+                catch(...)
+                {
+                    exceptions[t] = std::current_exception();
+                }
+            });
+        }
+
+        for(auto& T : threads)
+            T.join();
+
+        for(auto& E : exceptions)
+        {
+            if(E)
+                std::rethrow_exception(E);
+        }
+
+        try
+        {
+            for(size_t k = 0; k < nonlinearRows.size(); k++)
+            {
+                if(!expressions[k])
+                    continue;
+
+                auto constraint
+                    = std::dynamic_pointer_cast<NonlinearConstraint>(destination->getConstraint(nonlinearRows[k]));
+
+                constraint->add(std::move(expressions[k]));
+            }
+        }
+        catch(const ConstraintNotFoundException&)
+        {
+            delete[] opcodes;
+            delete[] fields;
+            delete[] constants;
+            return (false);
+        }
+
+        env->output->outputDebug(fmt::format(
+            "  Nonlinear expressions in {} rows decoded using {} threads.", nonlinearRows.size(), numberOfThreads));
+    }
 
     delete[] opcodes;
     delete[] fields;
@@ -1515,14 +1742,267 @@ bool ModelingSystemGAMS::copySOS(ProblemPtr destination)
     return true;
 }
 
+uint64_t ModelingSystemGAMS::getModelFingerprint()
+{
+    uint64_t fingerprint = 0;
+
+    // The settings used when creating the problem that are not applied again when it is copied
+    addToFingerprint(fingerprint, env->settings->getSetting<bool>("Reformulation.Monomials.Extract", "Model"));
+    addToFingerprint(fingerprint, env->settings->getSetting<bool>("Reformulation.Signomials.Extract", "Model"));
+    addToFingerprint(
+        fingerprint, env->settings->getSetting<int>("Reformulation.Quadratics.ExtractStrategy", "Model"));
+#if GMOAPIVERSION >= 21
+    addToFingerprint(fingerprint, env->settings->getSetting<int>("GAMS.QExtractAlg", "ModelingSystem"));
+#endif
+
+    int numberOfVariables = gmoN(modelingObject);
+    int numberOfConstraints = gmoM(modelingObject);
+    int numberOfNonzeros = gmoNZ(modelingObject);
+
+    addToFingerprint(fingerprint, gmoModelType(modelingObject));
+    addToFingerprint(fingerprint, gmoSense(modelingObject));
+    addToFingerprint(fingerprint, gmoObjConst(modelingObject));
+    addToFingerprint(fingerprint, numberOfVariables);
+    addToFingerprint(fingerprint, numberOfConstraints);
+    addToFingerprint(fingerprint, numberOfNonzeros);
+
+    // The linear terms of fixed variables are added to the constants, so the fixed variables and their values must be
+    // the same
+    std::vector<double> variableLBs(numberOfVariables);
+    std::vector<double> variableUBs(numberOfVariables);
+    gmoGetVarLower(modelingObject, variableLBs.data());
+    gmoGetVarUpper(modelingObject, variableUBs.data());
+
+    for(int i = 0; i < numberOfVariables; i++)
+    {
+        int variableType = gmoGetVarTypeOne(modelingObject, i);
+        addToFingerprint(fingerprint, variableType);
+
+        if(variableType == gmovar_SC || variableType == gmovar_SI)
+        {
+            addToFingerprint(fingerprint, variableLBs[i]);
+            addToFingerprint(fingerprint, variableUBs[i]);
+        }
+        else if(variableLBs[i] == variableUBs[i])
+        {
+            addToFingerprint(fingerprint, i);
+            addToFingerprint(fingerprint, variableLBs[i]);
+        }
+    }
+
+    for(int i = 0; i < numberOfConstraints; i++)
+    {
+        addToFingerprint(fingerprint, gmoGetEquTypeOne(modelingObject, i));
+        addToFingerprint(fingerprint, gmoGetEquOrderOne(modelingObject, i));
+        addToFingerprint(fingerprint, gmoGetRhsOne(modelingObject, i));
+    }
+
+    std::vector<int> rowStarts(numberOfConstraints + 1);
+    std::vector<int> variableIndexes(numberOfNonzeros + 1);
+    std::vector<double> coefficients(numberOfNonzeros + 1);
+    std::vector<int> nonlinearFlags(numberOfNonzeros + 1);
+
+    gmoGetMatrixRow(
+        modelingObject, rowStarts.data(), variableIndexes.data(), coefficients.data(), nonlinearFlags.data());
+
+    addToFingerprint(fingerprint, rowStarts.data(), numberOfConstraints + 1);
+    addToFingerprint(fingerprint, variableIndexes.data(), numberOfNonzeros);
+    addToFingerprint(fingerprint, coefficients.data(), numberOfNonzeros);
+    addToFingerprint(fingerprint, nonlinearFlags.data(), numberOfNonzeros);
+
+    // The objective function
+    int numberOfObjectiveNonzeros = gmoObjNZ(modelingObject);
+    int numberOfNonlinearObjectiveNonzeros;
+
+    variableIndexes.resize(numberOfObjectiveNonzeros + 1);
+    coefficients.resize(numberOfObjectiveNonzeros + 1);
+    nonlinearFlags.resize(numberOfObjectiveNonzeros + 1);
+
+    addToFingerprint(fingerprint, gmoGetObjOrder(modelingObject));
+
+    gmoGetObjSparse(modelingObject, variableIndexes.data(), coefficients.data(), nonlinearFlags.data(),
+        &numberOfObjectiveNonzeros, &numberOfNonlinearObjectiveNonzeros);
+
+    addToFingerprint(fingerprint, variableIndexes.data(), numberOfObjectiveNonzeros);
+    addToFingerprint(fingerprint, coefficients.data(), numberOfObjectiveNonzeros);
+    addToFingerprint(fingerprint, nonlinearFlags.data(), numberOfObjectiveNonzeros);
+
+    // The quadratic terms
+    if(gmoGetObjOrder(modelingObject) == gmoorder_Q)
+    {
+#if GMOAPIVERSION <= 19
+        int numberOfQuadraticTerms = gmoObjQNZ(modelingObject);
+#else
+        int numberOfQuadraticTerms = gmoObjQMatNZ(modelingObject);
+#endif
+
+        std::vector<int> variableOneIndexes(numberOfQuadraticTerms);
+        std::vector<int> variableTwoIndexes(numberOfQuadraticTerms);
+        std::vector<double> quadraticCoefficients(numberOfQuadraticTerms);
+
+#if GMOAPIVERSION <= 19
+        gmoGetObjQ(modelingObject, variableOneIndexes.data(), variableTwoIndexes.data(), quadraticCoefficients.data());
+#else
+        gmoGetObjQMat(
+            modelingObject, variableOneIndexes.data(), variableTwoIndexes.data(), quadraticCoefficients.data());
+#endif
+
+        addToFingerprint(fingerprint, variableOneIndexes.data(), numberOfQuadraticTerms);
+        addToFingerprint(fingerprint, variableTwoIndexes.data(), numberOfQuadraticTerms);
+        addToFingerprint(fingerprint, quadraticCoefficients.data(), numberOfQuadraticTerms);
+    }
+
+    for(int i = 0; i < numberOfConstraints; i++)
+    {
+        if(gmoGetEquOrderOne(modelingObject, i) != gmoorder_Q)
+            continue;
+
+        int numberOfQuadraticTerms = gmoGetRowQNZOne(modelingObject, i);
+
+        std::vector<int> variableOneIndexes(numberOfQuadraticTerms);
+        std::vector<int> variableTwoIndexes(numberOfQuadraticTerms);
+        std::vector<double> quadraticCoefficients(numberOfQuadraticTerms);
+
+#if GMOAPIVERSION <= 19
+        gmoGetRowQ(modelingObject, i, variableOneIndexes.data(), variableTwoIndexes.data(),
+            quadraticCoefficients.data());
+#else
+        gmoGetRowQMat(modelingObject, i, variableOneIndexes.data(), variableTwoIndexes.data(),
+            quadraticCoefficients.data());
+#endif
+
+        addToFingerprint(fingerprint, i);
+        addToFingerprint(fingerprint, variableOneIndexes.data(), numberOfQuadraticTerms);
+        addToFingerprint(fingerprint, variableTwoIndexes.data(), numberOfQuadraticTerms);
+        addToFingerprint(fingerprint, quadraticCoefficients.data(), numberOfQuadraticTerms);
+    }
+
+    // The nonlinear expressions, given as GAMS instructions with the constants in a separate pool
+    std::vector<int> opcodes(gmoNLCodeSizeMaxRow(modelingObject) + 1);
+    std::vector<int> fields(gmoNLCodeSizeMaxRow(modelingObject) + 1);
+    int codelen;
+
+    addToFingerprint(fingerprint, (double*)gmoPPool(modelingObject), gmoNLConst(modelingObject));
+
+    if(gmoObjNLNZ(modelingObject) > 0 && gmoGetObjOrder(modelingObject) == gmoorder_NL)
+    {
+        gmoDirtyGetObjFNLInstr(modelingObject, &codelen, opcodes.data(), fields.data());
+
+        addToFingerprint(fingerprint, gmoObjJacVal(modelingObject));
+        addToFingerprint(fingerprint, opcodes.data(), codelen);
+        addToFingerprint(fingerprint, fields.data(), codelen);
+    }
+
+    for(int i = 0; i < numberOfConstraints; i++)
+    {
+        if(gmoGetEquOrderOne(modelingObject, i) != gmoorder_NL)
+            continue;
+
+        gmoDirtyGetRowFNLInstr(modelingObject, i, &codelen, opcodes.data(), fields.data());
+
+        addToFingerprint(fingerprint, i);
+        addToFingerprint(fingerprint, opcodes.data(), codelen);
+        addToFingerprint(fingerprint, fields.data(), codelen);
+    }
+
+    // The special ordered sets
+    int numSos1;
+    int numSos2;
+    int nzSos;
+    gmoGetSosCounts(modelingObject, &numSos1, &numSos2, &nzSos);
+
+    addToFingerprint(fingerprint, numSos1);
+    addToFingerprint(fingerprint, numSos2);
+
+    if(nzSos > 0)
+    {
+        int numSos = numSos1 + numSos2;
+        std::vector<int> sostype(numSos);
+        std::vector<int> sosbeg(numSos + 1);
+        std::vector<int> sosind(nzSos);
+        std::vector<double> soswt(nzSos);
+
+        (void)gmoGetSosConstraints(modelingObject, sostype.data(), sosbeg.data(), sosind.data(), soswt.data());
+
+        addToFingerprint(fingerprint, sostype.data(), numSos);
+        addToFingerprint(fingerprint, sosbeg.data(), numSos + 1);
+        addToFingerprint(fingerprint, sosind.data(), nzSos);
+        addToFingerprint(fingerprint, soswt.data(), nzSos);
+    }
+
+    return (fingerprint);
+}
+
+bool ModelingSystemGAMS::updateVariableBounds(ProblemPtr destination)
+{
+    int numVariables = gmoN(modelingObject);
+
+    if((int)destination->allVariables.size() != numVariables)
+        return (false);
+
+    double minLBCont = env->settings->getSetting<double>("Variables.Continuous.MinimumLowerBound", "Model");
+    double maxUBCont = env->settings->getSetting<double>("Variables.Continuous.MaximumUpperBound", "Model");
+    double minLBInt = env->settings->getSetting<double>("Variables.Integer.MinimumLowerBound", "Model");
+    double maxUBInt = env->settings->getSetting<double>("Variables.Integer.MaximumUpperBound", "Model");
+
+    std::vector<double> variableLBs(numVariables);
+    std::vector<double> variableUBs(numVariables);
+    gmoGetVarLower(modelingObject, variableLBs.data());
+    gmoGetVarUpper(modelingObject, variableUBs.data());
+
+    // The bounds are limited in the same way as in copyVariables(), the semicontinuous variables are not changed
+    for(int i = 0; i < numVariables; i++)
+    {
+        switch(gmoGetVarTypeOne(modelingObject, i))
+        {
+        case gmovar_X:
+        case gmovar_S1:
+        case gmovar_S2:
+            variableLBs[i] = std::max(variableLBs[i], minLBCont);
+            variableUBs[i] = std::min(variableUBs[i], maxUBCont);
+            break;
+
+        case gmovar_B:
+            variableLBs[i] = std::max(variableLBs[i], 0.0);
+            variableUBs[i] = std::min(variableUBs[i], 1.0);
+            break;
+
+        case gmovar_I:
+            variableLBs[i] = std::max(variableLBs[i], minLBInt);
+            variableUBs[i] = std::min(variableUBs[i], maxUBInt);
+            break;
+
+        default:
+            variableLBs[i] = destination->allVariables[i]->lowerBound;
+            variableUBs[i] = destination->allVariables[i]->upperBound;
+            break;
+        }
+
+        auto& variable = destination->allVariables[i];
+
+        if((variableLBs[i] == variableUBs[i]) != (variable->lowerBound == variable->upperBound))
+            return (false);
+    }
+
+    for(int i = 0; i < numVariables; i++)
+    {
+        destination->allVariables[i]->lowerBound = variableLBs[i];
+        destination->allVariables[i]->upperBound = variableUBs[i];
+    }
+
+    env->output->outputDebug(" Bounds of the cached problem updated from the GAMS model.");
+
+    return (true);
+}
+
 NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /**< length of GAMS instructions */
     int* opcodes, /**< opcodes of GAMS instructions */
     int* fields, /**< fields of GAMS instructions */
     [[maybe_unused]] int constantlen, /**< length of GAMS constants pool */
     double* constants, /**< GAMS constants pool */
-    const ProblemPtr& destination)
+    const ProblemPtr& destination, ModelArena& arena, bool useModelingObject)
 {
-    bool debugoutput = gevGetIntOpt(modelingEnvironment, gevInteger1) & 0x4;
+    bool debugoutput = useModelingObject && (gevGetIntOpt(modelingEnvironment, gevInteger1) & 0x4);
 #define debugout                                                                                                       \
     if(debugoutput)                                                                                                    \
     std::clog
@@ -1549,20 +2029,22 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlPushV: // push variable
         {
-            address = gmoGetjSolver(modelingObject, address);
-            stack.push_back(std::make_shared<ExpressionVariable>(destination->getVariable(address)));
+            if(useModelingObject)
+                address = gmoGetjSolver(modelingObject, address);
+
+            stack.push_back(arena.create<ExpressionVariable>(destination->getVariable(address)));
             break;
         }
 
         case nlPushI: // push constant
         {
-            stack.push_back(std::make_shared<ExpressionConstant>(constants[address]));
+            stack.push_back(arena.create<ExpressionConstant>(constants[address]));
             break;
         }
 
         case nlPushZero: // push zero
         {
-            stack.push_back(std::make_shared<ExpressionConstant>(0.0));
+            stack.push_back(arena.create<ExpressionConstant>(0.0));
             break;
         }
 
@@ -1593,7 +2075,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             }
             else // Create a new sum and add the two last elements on the stack to this
             {
-                auto sum = std::make_shared<ExpressionSum>();
+                auto sum = arena.create<ExpressionSum>();
                 sum->children.add(std::move(stack.rbegin()[1]));
                 sum->children.add(std::move(stack.rbegin()[0]));
                 stack.pop_back();
@@ -1606,7 +2088,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlAddV: // add variable
         {
-            address = gmoGetjSolver(modelingObject, address);
+            if(useModelingObject)
+                address = gmoGetjSolver(modelingObject, address);
 
             auto variable = destination->getVariable(address);
 
@@ -1617,12 +2100,12 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
                 if(mainIsSum)
                 {
                     std::static_pointer_cast<ExpressionSum>(stack.rbegin()[0])
-                        ->children.add(std::make_shared<ExpressionConstant>(variable->lowerBound));
+                        ->children.add(arena.create<ExpressionConstant>(variable->lowerBound));
                 }
                 else
                 {
-                    auto expression = std::make_shared<ExpressionSum>(
-                        std::make_shared<ExpressionConstant>(variable->lowerBound), std::move(stack.rbegin()[0]));
+                    auto expression = arena.create<ExpressionSum>(
+                        arena.create<ExpressionConstant>(variable->lowerBound), std::move(stack.rbegin()[0]));
                     stack.pop_back();
                     stack.push_back(std::move(expression));
                 }
@@ -1632,12 +2115,12 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
                 if(mainIsSum)
                 {
                     std::static_pointer_cast<ExpressionSum>(stack.rbegin()[0])
-                        ->children.add(std::make_shared<ExpressionVariable>(variable));
+                        ->children.add(arena.create<ExpressionVariable>(variable));
                 }
                 else
                 {
-                    auto expression = std::make_shared<ExpressionSum>(
-                        std::make_shared<ExpressionVariable>(variable), std::move(stack.rbegin()[0]));
+                    auto expression = arena.create<ExpressionSum>(
+                        arena.create<ExpressionVariable>(variable), std::move(stack.rbegin()[0]));
                     stack.pop_back();
                     stack.push_back(std::move(expression));
                 }
@@ -1648,8 +2131,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlAddI: // add immediate
         {
-            auto expression = std::make_shared<ExpressionSum>(
-                std::make_shared<ExpressionConstant>(constants[address]), stack.rbegin()[0]);
+            auto expression = arena.create<ExpressionSum>(
+                arena.create<ExpressionConstant>(constants[address]), stack.rbegin()[0]);
             stack.pop_back();
             stack.push_back(std::move(expression));
             break;
@@ -1662,13 +2145,13 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             if(mainIsSum)
             {
                 std::static_pointer_cast<ExpressionSum>(stack.rbegin()[1])
-                    ->children.add(std::make_shared<ExpressionNegate>(std::move(stack.rbegin()[0])));
+                    ->children.add(arena.create<ExpressionNegate>(std::move(stack.rbegin()[0])));
                 stack.pop_back();
             }
             else
             {
-                auto expression = std::make_shared<ExpressionSum>(
-                    std::move(stack.rbegin()[1]), std::make_shared<ExpressionNegate>(std::move(stack.rbegin()[0])));
+                auto expression = arena.create<ExpressionSum>(
+                    std::move(stack.rbegin()[1]), arena.create<ExpressionNegate>(std::move(stack.rbegin()[0])));
                 stack.pop_back();
                 stack.pop_back();
                 stack.push_back(expression);
@@ -1679,21 +2162,22 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlSubV: // subtract variable
         {
-            address = gmoGetjSolver(modelingObject, address);
+            if(useModelingObject)
+                address = gmoGetjSolver(modelingObject, address);
 
             auto variable = destination->getVariable(address);
 
             if(variable->lowerBound == variable->upperBound)
             {
-                auto expression = std::make_shared<ExpressionSum>(
-                    std::move(stack.rbegin()[0]), std::make_shared<ExpressionConstant>(-variable->lowerBound));
+                auto expression = arena.create<ExpressionSum>(
+                    std::move(stack.rbegin()[0]), arena.create<ExpressionConstant>(-variable->lowerBound));
                 stack.pop_back();
                 stack.push_back(expression);
             }
             else
             {
-                auto expression = std::make_shared<ExpressionSum>(std::move(stack.rbegin()[0]),
-                    std::make_shared<ExpressionNegate>(std::make_shared<ExpressionVariable>(variable)));
+                auto expression = arena.create<ExpressionSum>(std::move(stack.rbegin()[0]),
+                    arena.create<ExpressionNegate>(arena.create<ExpressionVariable>(variable)));
                 stack.pop_back();
                 stack.push_back(expression);
             }
@@ -1703,8 +2187,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlSubI: // subtract immediate
         {
-            auto expression = std::make_shared<ExpressionSum>(std::move(stack.rbegin()[0]),
-                std::make_shared<ExpressionNegate>(std::make_shared<ExpressionConstant>(constants[address])));
+            auto expression = arena.create<ExpressionSum>(std::move(stack.rbegin()[0]),
+                arena.create<ExpressionNegate>(arena.create<ExpressionConstant>(constants[address])));
             stack.pop_back();
             stack.push_back(expression);
             break;
@@ -1738,7 +2222,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             }
             else // Create a new product and add the two last elements on the stack to this
             {
-                auto prod = std::make_shared<ExpressionProduct>();
+                auto prod = arena.create<ExpressionProduct>();
                 prod->children.add(std::move(stack.rbegin()[1]));
                 prod->children.add(std::move(stack.rbegin()[0]));
                 stack.pop_back();
@@ -1751,7 +2235,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlMulV: // multiply variable
         {
-            address = gmoGetjSolver(modelingObject, address);
+            if(useModelingObject)
+                address = gmoGetjSolver(modelingObject, address);
 
             auto variable = destination->getVariable(address);
 
@@ -1762,12 +2247,12 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
                 if(mainIsProd)
                 {
                     std::static_pointer_cast<ExpressionProduct>(stack.rbegin()[0])
-                        ->children.add(std::make_shared<ExpressionConstant>(variable->lowerBound));
+                        ->children.add(arena.create<ExpressionConstant>(variable->lowerBound));
                 }
                 else
                 {
-                    auto expression = std::make_shared<ExpressionProduct>(
-                        std::make_shared<ExpressionConstant>(variable->lowerBound), std::move(stack.rbegin()[0]));
+                    auto expression = arena.create<ExpressionProduct>(
+                        arena.create<ExpressionConstant>(variable->lowerBound), std::move(stack.rbegin()[0]));
                     stack.pop_back();
                     stack.push_back(std::move(expression));
                 }
@@ -1777,12 +2262,12 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
                 if(mainIsProd)
                 {
                     std::static_pointer_cast<ExpressionProduct>(stack.rbegin()[0])
-                        ->children.add(std::make_shared<ExpressionVariable>(variable));
+                        ->children.add(arena.create<ExpressionVariable>(variable));
                 }
                 else
                 {
-                    auto expression = std::make_shared<ExpressionProduct>(
-                        std::make_shared<ExpressionVariable>(variable), std::move(stack.rbegin()[0]));
+                    auto expression = arena.create<ExpressionProduct>(
+                        arena.create<ExpressionVariable>(variable), std::move(stack.rbegin()[0]));
                     stack.pop_back();
                     stack.push_back(std::move(expression));
                 }
@@ -1798,12 +2283,12 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             if(mainIsProd)
             {
                 std::static_pointer_cast<ExpressionProduct>(stack.rbegin()[0])
-                    ->children.add(std::make_shared<ExpressionConstant>(constants[address]));
+                    ->children.add(arena.create<ExpressionConstant>(constants[address]));
             }
             else
             {
-                auto expression = std::make_shared<ExpressionProduct>(
-                    std::make_shared<ExpressionConstant>(constants[address]), std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionProduct>(
+                    arena.create<ExpressionConstant>(constants[address]), std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(expression);
             }
@@ -1813,8 +2298,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlMulIAdd: // multiply immediate and add
         {
-            auto expressionProduct = std::make_shared<ExpressionProduct>(
-                std::make_shared<ExpressionConstant>(constants[address]), std::move(stack.rbegin()[0]));
+            auto expressionProduct = arena.create<ExpressionProduct>(
+                arena.create<ExpressionConstant>(constants[address]), std::move(stack.rbegin()[0]));
             stack.pop_back();
             stack.push_back(std::move(expressionProduct));
 
@@ -1828,7 +2313,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             else
             {
                 auto expressionSum
-                    = std::make_shared<ExpressionSum>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
+                    = arena.create<ExpressionSum>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.pop_back();
                 stack.push_back(std::move(expressionSum));
@@ -1840,7 +2325,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
         case nlDiv: // divide
         {
             auto expression
-                = std::make_shared<ExpressionDivide>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
+                = arena.create<ExpressionDivide>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
             stack.pop_back();
             stack.pop_back();
             stack.push_back(std::move(expression));
@@ -1849,21 +2334,22 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlDivV: // divide variable
         {
-            address = gmoGetjSolver(modelingObject, address);
+            if(useModelingObject)
+                address = gmoGetjSolver(modelingObject, address);
 
             auto variable = destination->getVariable(address);
 
             if(variable->lowerBound == variable->upperBound)
             {
-                auto expression = std::make_shared<ExpressionDivide>(
-                    std::move(stack.rbegin()[0]), std::make_shared<ExpressionConstant>(variable->lowerBound));
+                auto expression = arena.create<ExpressionDivide>(
+                    std::move(stack.rbegin()[0]), arena.create<ExpressionConstant>(variable->lowerBound));
                 stack.pop_back();
                 stack.push_back(std::move(expression));
             }
             else
             {
-                auto expression = std::make_shared<ExpressionDivide>(std::move(stack.rbegin()[0]),
-                    std::make_shared<ExpressionVariable>(destination->getVariable(address)));
+                auto expression = arena.create<ExpressionDivide>(std::move(stack.rbegin()[0]),
+                    arena.create<ExpressionVariable>(destination->getVariable(address)));
                 stack.pop_back();
                 stack.push_back(std::move(expression));
             }
@@ -1873,8 +2359,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlDivI: // divide immediate
         {
-            auto expression = std::make_shared<ExpressionDivide>(
-                std::move(stack.rbegin()[0]), std::make_shared<ExpressionConstant>(constants[address]));
+            auto expression = arena.create<ExpressionDivide>(
+                std::move(stack.rbegin()[0]), arena.create<ExpressionConstant>(constants[address]));
             stack.pop_back();
             stack.push_back(std::move(expression));
             break;
@@ -1882,7 +2368,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlUMin: // unary minus
         {
-            auto expression = std::make_shared<ExpressionNegate>(std::move(stack.rbegin()[0]));
+            auto expression = arena.create<ExpressionNegate>(std::move(stack.rbegin()[0]));
             stack.pop_back();
             stack.push_back(std::move(expression));
             break;
@@ -1890,18 +2376,19 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
         case nlUMinV: // unary minus variable
         {
-            address = gmoGetjSolver(modelingObject, address);
+            if(useModelingObject)
+                address = gmoGetjSolver(modelingObject, address);
 
             auto variable = destination->getVariable(address);
 
             if(variable->lowerBound == variable->upperBound)
             {
-                stack.push_back(std::make_shared<ExpressionConstant>(-variable->lowerBound));
+                stack.push_back(arena.create<ExpressionConstant>(-variable->lowerBound));
             }
             else
             {
-                stack.push_back(std::make_shared<ExpressionNegate>(
-                    std::make_shared<ExpressionVariable>(destination->getVariable(address))));
+                stack.push_back(arena.create<ExpressionNegate>(
+                    arena.create<ExpressionVariable>(destination->getVariable(address))));
             }
 
             break;
@@ -1924,7 +2411,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fnsqr:
             {
-                auto expression = std::make_shared<ExpressionSquare>(std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionSquare>(std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(std::move(expression));
                 break;
@@ -1932,7 +2419,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fnexp:
             {
-                auto expression = std::make_shared<ExpressionExp>(std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionExp>(std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(std::move(expression));
                 break;
@@ -1940,7 +2427,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fnlog:
             {
-                auto expression = std::make_shared<ExpressionLog>(std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionLog>(std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(std::move(expression));
                 break;
@@ -1949,8 +2436,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             case fnlog10:
             {
                 auto expression
-                    = std::make_shared<ExpressionProduct>(std::make_shared<ExpressionConstant>(1.0 / log(10.0)),
-                        std::make_shared<ExpressionLog>(std::move(stack.rbegin()[0])));
+                    = arena.create<ExpressionProduct>(arena.create<ExpressionConstant>(1.0 / log(10.0)),
+                        arena.create<ExpressionLog>(std::move(stack.rbegin()[0])));
 
                 stack.pop_back();
                 stack.push_back(expression);
@@ -1960,8 +2447,8 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             case fnlog2:
             {
                 auto expression
-                    = std::make_shared<ExpressionProduct>(std::make_shared<ExpressionConstant>(1.0 / log(2.0)),
-                        std::make_shared<ExpressionLog>(std::move(stack.rbegin()[0])));
+                    = arena.create<ExpressionProduct>(arena.create<ExpressionConstant>(1.0 / log(2.0)),
+                        arena.create<ExpressionLog>(std::move(stack.rbegin()[0])));
                 stack.pop_back();
                 stack.push_back(expression);
                 break;
@@ -1969,7 +2456,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fnsqrt:
             {
-                auto expression = std::make_shared<ExpressionSquareRoot>(std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionSquareRoot>(std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(expression);
                 break;
@@ -1977,7 +2464,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fnabs:
             {
-                auto expression = std::make_shared<ExpressionAbs>(std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionAbs>(std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(expression);
                 break;
@@ -1985,7 +2472,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fncos:
             {
-                auto expression = std::make_shared<ExpressionCos>(std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionCos>(std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(expression);
                 break;
@@ -1993,7 +2480,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fnsin:
             {
-                auto expression = std::make_shared<ExpressionSin>(std::move(stack.rbegin()[0]));
+                auto expression = arena.create<ExpressionSin>(std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.push_back(expression);
                 break;
@@ -2005,7 +2492,7 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             case fnvcpower: // x ^ constant
             {
                 auto expression
-                    = std::make_shared<ExpressionPower>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
+                    = arena.create<ExpressionPower>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.pop_back();
                 stack.push_back(expression);
@@ -2014,14 +2501,14 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
 
             case fnpi:
             {
-                stack.push_back(std::make_shared<ExpressionConstant>(3.14159265));
+                stack.push_back(arena.create<ExpressionConstant>(3.14159265));
                 break;
             }
 
             case fndiv:
             {
                 auto expression
-                    = std::make_shared<ExpressionDivide>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
+                    = arena.create<ExpressionDivide>(std::move(stack.rbegin()[1]), std::move(stack.rbegin()[0]));
                 stack.pop_back();
                 stack.pop_back();
                 stack.push_back(expression);
@@ -2087,7 +2574,10 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
                 debugout << "nr. " << address + 1 << " - unsupported. Error." << std::endl;
                 char buffer[256];
                 sprintf(buffer, "Error: Unsupported GAMS function %s.\n", GamsFuncCodeName[address + 1]);
-                gevLogStatPChar(modelingEnvironment, buffer);
+
+                if(useModelingObject)
+                    gevLogStatPChar(modelingEnvironment, buffer);
+
                 throw OperationNotImplementedException(fmt::format("Error: Unsupported GAMS function {}", GamsFuncCodeName[address + 1]));
             }
             default:
@@ -2095,7 +2585,10 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
                 debugout << "nr. " << address + 1 << " - unsupported. Error." << std::endl;
                 char buffer[256];
                 sprintf(buffer, "Error: Unsupported new GAMS function %d.\n", address + 1);
-                gevLogStatPChar(modelingEnvironment, buffer);
+
+                if(useModelingObject)
+                    gevLogStatPChar(modelingEnvironment, buffer);
+
                 throw OperationNotImplementedException(fmt::format("Error: Unsupported new GAMS function {}", address));
             }
             }
@@ -2107,7 +2600,10 @@ NonlinearExpressionPtr ModelingSystemGAMS::parseGamsInstructions(int codelen, /*
             debugout << "opcode " << opcode << " - unsuppored. Error." << std::endl;
             char buffer[256];
             sprintf(buffer, "Error: Unsupported GAMS opcode %s.\n", GamsOpCodeName[opcode]);
-            gevLogStatPChar(modelingEnvironment, buffer);
+
+            if(useModelingObject)
+                gevLogStatPChar(modelingEnvironment, buffer);
+
             throw OperationNotImplementedException(fmt::format("Error: Unsupported GAMS opcode {}", buffer));
         }
         }
@@ -19,12 +19,14 @@
 #include "spdlog/spdlog.h"
 #include "spdlog/sinks/base_sink.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
 namespace SHOT
 {
 
+class ModelArena;
 class NonlinearExpression;
 using NonlinearExpressionPtr = std::shared_ptr<NonlinearExpression>;
 
@@ -34,6 +36,14 @@ enum class E_GAMSInputSource
     GAMSModel
 };
 
+// The problem created from a GAMS model in an earlier call with the same model instance object, e.g. in a GAMS solve
+// loop, together with the fingerprint of the model it was created from
+struct GAMSProblemCache
+{
+    uint64_t fingerprint = 0;
+    ProblemPtr problem;
+};
+
 class ModelingSystemGAMS : public IModelingSystem
 {
 public:
@@ -42,6 +52,9 @@ public:
 
     void setModelingObject(gmoHandle_t gmo);
 
+    // If set, createProblem() reuses the cached problem if only the bounds of the variables not fixed have changed
+    void setProblemCache(GAMSProblemCache* cache) { problemCache = cache; }
+
     // Adds modeling system specific settings
     static void augmentSettings(SettingsPtr settings);
 
@@ -67,9 +80,13 @@ private:
     std::string tmpdirname;
     bool createdgmo;
     char buffer[GMS_SSSIZE];
+    GAMSProblemCache* problemCache = nullptr;
 
     void createModelFromProblemFile(const std::string& filename);
     void createModelFromGAMSModel(const std::string& filename);
+
+    // Loads the converted model in tmpdirname, which is created by GAMS in createModelFromProblemFile()
+    void createModelFromConversion();
     void createAuditLicensing();
 
     void clearGAMSObjects();
@@ -82,6 +99,12 @@ private:
     bool copyNonlinearExpressions(ProblemPtr destination);
     bool copySOS(ProblemPtr destination);
 
+    // Covers all data of the model except the bounds of the variables that are not fixed or semicontinuous
+    uint64_t getModelFingerprint();
+
+    // Returns false if a variable becomes fixed or is no longer fixed, since the fixed variables are removed
+    bool updateVariableBounds(ProblemPtr destination);
+
     static void applyOperation(std::vector<NonlinearExpressionPtr>& stack, NonlinearExpressionPtr op, int nargs);
 
     NonlinearExpressionPtr parseGamsInstructions(int codelen, /**< length of GAMS instructions */
@@ -89,7 +112,11 @@ private:
         int* fields, /**< fields of GAMS instructions */
         int constantlen, /**< length of GAMS constants pool */
         double* constants, /**< GAMS constants pool */
-        const ProblemPtr& destination);
+        const ProblemPtr& destination, /**< problem with the variables */
+        ModelArena& arena, /**< arena in which the expressions are created */
+        bool useModelingObject /**< if false, GMO is not used, e.g. when called from several threads, and the
+                                  variable fields must already be solver indexes */
+    );
 };
 
 using ModelingSystemGAMSPtr = std::shared_ptr<ModelingSystemGAMS>;
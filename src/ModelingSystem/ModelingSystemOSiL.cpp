@@ -17,7 +17,10 @@
 
 #include "../Model/Simplifications.h"
 
-#include "tinyxml2.h"
+#include "XMLStreamReader.h"
+
+#include <map>
+#include <string_view>
 
 #ifdef HAS_STD_FILESYSTEM
 #include <filesystem>
@@ -40,561 +43,886 @@ void ModelingSystemOSiL::augmentSettings([[maybe_unused]] SettingsPtr settings)
 
 void ModelingSystemOSiL::updateSettings([[maybe_unused]] SettingsPtr settings) { }
 
-E_ProblemCreationStatus ModelingSystemOSiL::createProblem(ProblemPtr& problem, const std::string& filename)
+namespace
 {
-    if(false && !fs::filesystem::exists(fs::filesystem::path(filename)))
-    {
-        env->output->outputError("Problem file \"" + filename + "\" does not exist.");
+// The parts of the instance that are stored while reading, since the type of a constraint or objective is given by
+// quadratic terms and nonlinear expressions that come after it in the file
+struct ConstraintData
+{
+    std::string name;
+    double lowerBound;
+    double upperBound;
+};
 
-        return (E_ProblemCreationStatus::FileDoesNotExist);
-    }
+struct ObjectiveData
+{
+    bool isDefined = false;
+    E_ObjectiveFunctionDirection direction = E_ObjectiveFunctionDirection::Minimize;
+    double constant = 0.0;
+    std::vector<std::pair<int, double>> coefficients;
+};
 
-    env->timing->startTimer("ProblemInitialization");
+struct QuadraticTermData
+{
+    int placementIndex; // -1 for the objective
+    int firstVariableIndex;
+    int secondVariableIndex;
+    double coefficient;
+};
+
+struct LinearCoefficientData
+{
+    bool isRowFormat = false;
+    VectorInteger startIndices;
+    VectorInteger indices;
+    VectorDouble coefficients;
+};
 
-    fs::filesystem::path problemFile(filename);
-    fs::filesystem::path problemPath = problemFile.parent_path();
+struct VariableBoundLimits
+{
+    double minLBCont;
+    double maxUBCont;
+    double minLBInt;
+    double maxUBInt;
+};
 
-    using namespace tinyxml2;
+using E_Event = XMLStreamReader::E_Event;
 
-    XMLDocument osilDocument;
+template <typename T> T parseValue(std::string_view value);
 
-    auto result = osilDocument.LoadFile(filename.c_str());
+template <> int parseValue<int>(std::string_view value) { return (XMLStreamReader::parseInteger(value)); }
 
-    if(result != XML_SUCCESS)
-    {
-        env->output->outputError(
-            fmt::format("Could not read problem from OSiL file {}:", filename), std::to_string(result));
-        env->timing->stopTimer("ProblemInitialization");
-        return (E_ProblemCreationStatus::ErrorInFile);
-    }
+template <> double parseValue<double>(std::string_view value) { return (XMLStreamReader::parseDouble(value)); }
 
-    // Read the problem name if it exists
-    if(osilDocument.FirstChildElement("osil")->FirstChildElement("instanceHeader")->FirstChildElement("name") != NULL)
+double getDoubleAttribute(const XMLStreamReader& reader, std::string_view name, double defaultValue)
+{
+    auto value = reader.getAttribute(name);
+    return (value ? XMLStreamReader::parseDouble(*value) : defaultValue);
+}
+
+int getIntegerAttribute(const XMLStreamReader& reader, std::string_view name)
+{
+    auto value = reader.getAttribute(name);
+
+    if(!value)
+        throw Exception(fmt::format("Missing attribute {} in element {}.", name, reader.getName()));
+
+    return (XMLStreamReader::parseInteger(*value));
+}
+
+// Reads the el elements of an array up to its end element, where an element with the attributes mult and incr gives
+// mult values starting from its value with the increment incr
+template <typename T> void readArray(XMLStreamReader& reader, std::vector<T>& values)
+{
+    for(auto event = reader.next(); event != E_Event::EndElement; event = reader.next())
     {
-        problem->name = osilDocument.FirstChildElement("osil")
-                            ->FirstChildElement("instanceHeader")
-                            ->FirstChildElement("name")
-                            ->GetText();
+        if(event != E_Event::StartElement)
+            continue;
+
+        if(reader.getName() != "el")
+            throw Exception(fmt::format("Unsupported element {} in array.", reader.getName()));
+
+        auto multAttribute = reader.getAttribute("mult");
+        auto incrAttribute = reader.getAttribute("incr");
+
+        int mult = multAttribute ? XMLStreamReader::parseInteger(*multAttribute) : 1;
+        T incr = incrAttribute ? parseValue<T>(*incrAttribute) : 0;
+        T value = parseValue<T>(reader.readElementText());
+
+        for(int i = 0; i < mult; i++)
+            values.push_back(value + i * incr);
     }
+}
 
-    auto variablesNodes
-        = osilDocument.FirstChildElement("osil")->FirstChildElement("instanceData")->FirstChildElement("variables");
+void readVariable(XMLStreamReader& reader, const ProblemPtr& problem, const VariableBoundLimits& limits, int index)
+{
+    auto variableName = reader.getAttributeString("name");
 
-    double minLBCont = env->settings->getSetting<double>("Variables.Continuous.MinimumLowerBound", "Model");
-    double maxUBCont = env->settings->getSetting<double>("Variables.Continuous.MaximumUpperBound", "Model");
-    double minLBInt = env->settings->getSetting<double>("Variables.Integer.MinimumLowerBound", "Model");
-    double maxUBInt = env->settings->getSetting<double>("Variables.Integer.MaximumUpperBound", "Model");
+    if(!variableName)
+        throw Exception(fmt::format("Variable with index {} has no name.", index));
 
-    int variableIndex = 0;
+    auto typeAttribute = reader.getAttribute("type");
+    char type = (typeAttribute && !typeAttribute->empty()) ? typeAttribute->front() : 'C';
+
+    double variableLB = getDoubleAttribute(reader, "lb", 0.0); // By OSiL definition
+    double variableUB = getDoubleAttribute(reader, "ub", SHOT_DBL_MAX);
+    double semiBound = NAN;
 
-    // Read the variables
-    for(auto V = variablesNodes->FirstChildElement("var"); V != nullptr; V = V->NextSiblingElement("var"))
+    E_VariableType variableType;
+
+    switch(type)
     {
-        if(V->Attribute("name") == NULL)
-        {
-            env->timing->stopTimer("ProblemInitialization");
-            return (E_ProblemCreationStatus::ErrorInVariables);
-        }
+    case 'C':
+        variableType = E_VariableType::Real;
 
-        auto variableName = (V->Attribute("name") != NULL) ? V->Attribute("name") : "x" + std::to_string(variableIndex);
+        if(variableLB < limits.minLBCont)
+            variableLB = limits.minLBCont;
 
-        char type = (V->Attribute("type") != NULL) ? V->Attribute("type")[0] : 'C';
+        if(variableUB > limits.maxUBCont)
+            variableUB = limits.maxUBCont;
 
-        double variableLB = (V->Attribute("lb") != NULL) ? std::stod(V->Attribute("lb")) : 0.0; // By OSiL definition
-        double variableUB = (V->Attribute("ub") != NULL) ? std::stod(V->Attribute("ub")) : SHOT_DBL_MAX;
-        double semiBound = NAN;
+        break;
 
-        E_VariableType variableType;
+    case 'B':
+        variableType = E_VariableType::Binary;
 
-        switch(type)
-        {
-        case 'C':
-            variableType = E_VariableType::Real;
+        if(variableLB < 0.0)
+            variableLB = 0.0;
+
+        if(variableUB > 1.0)
+            variableUB = 1.0;
+
+        break;
+
+    case 'I':
+        variableType = E_VariableType::Integer;
+
+        if(variableLB < limits.minLBInt)
+            variableLB = limits.minLBInt;
 
-            if(variableLB < minLBCont)
-                variableLB = minLBCont;
+        if(variableUB > limits.maxUBInt)
+            variableUB = limits.maxUBInt;
 
-            if(variableUB > maxUBCont)
-                variableUB = maxUBCont;
+        break;
 
-            break;
+    case 'D':
+
+        if(variableLB < limits.minLBCont)
+            variableLB = limits.minLBCont;
+
+        if(variableUB > limits.maxUBCont)
+            variableUB = limits.maxUBCont;
+
+        if(variableLB > 0.0)
+        {
+            semiBound = variableLB;
+            variableLB = 0.0;
+            variableType = E_VariableType::Semicontinuous;
+        }
+        else if(variableUB < 0.0)
+        {
+            semiBound = variableUB;
+            variableUB = 0.0;
+            variableType = E_VariableType::Semicontinuous;
+        }
+        else
+        {
+            variableType = E_VariableType::Real;
+        }
 
-        case 'B':
-            variableType = E_VariableType::Binary;
+        break;
 
-            if(variableLB < 0.0)
-                variableLB = 0.0;
+    case 'J':
+        variableType = E_VariableType::Semiinteger;
 
-            if(variableUB > 1.0)
-                variableUB = 1.0;
+        if(variableLB < limits.minLBInt)
+            variableLB = limits.minLBInt;
 
-            break;
+        if(variableUB > limits.maxUBInt)
+            variableUB = limits.maxUBInt;
 
-        case 'I':
+        if(variableLB > 0.0)
+        {
+            semiBound = variableLB;
+            variableLB = 0.0;
+            variableType = E_VariableType::Semiinteger;
+        }
+        else if(variableUB < 0.0)
+        {
+            semiBound = variableUB;
+            variableUB = 0.0;
+            variableType = E_VariableType::Semiinteger;
+        }
+        else
+        {
             variableType = E_VariableType::Integer;
+        }
 
-            if(variableLB < minLBInt)
-                variableLB = minLBInt;
+        break;
 
-            if(variableUB > maxUBInt)
-                variableUB = maxUBInt;
+    default:
+        throw Exception(fmt::format("Variable {} has the unknown type {}.", *variableName, type));
+    }
 
-            break;
+    problem->add(
+        problem->arena.create<Variable>(*variableName, index, variableType, variableLB, variableUB, semiBound));
+}
 
-        case 'D':
+void readObjectives(XMLStreamReader& reader, ObjectiveData& objective)
+{
+    for(auto event = reader.next(); event != E_Event::EndElement; event = reader.next())
+    {
+        if(event != E_Event::StartElement)
+            continue;
 
-            if(variableLB < minLBCont)
-                variableLB = minLBCont;
+        if(reader.getName() != "obj")
+        {
+            reader.skipElement();
+            continue;
+        }
 
-            if(variableUB > maxUBCont)
-                variableUB = maxUBCont;
+        if(objective.isDefined)
+            throw Exception("Only one objective function is supported.");
 
-            if(variableLB > 0.0)
-            {
-                semiBound = variableLB;
-                variableLB = 0.0;
-                variableType = E_VariableType::Semicontinuous;
-            }
-            else if(variableUB < 0.0)
-            {
-                semiBound = variableUB;
-                variableUB = 0.0;
-                variableType = E_VariableType::Semicontinuous;
-            }
-            else
-            {
-                variableType = E_VariableType::Real;
-            }
+        auto direction = reader.getAttribute("maxOrMin");
 
-            break;
+        if(!direction)
+            throw Exception("The objective function has no direction.");
 
-        case 'J':
-            variableType = E_VariableType::Semiinteger;
+        objective.isDefined = true;
+        objective.direction
+            = (*direction == "min") ? E_ObjectiveFunctionDirection::Minimize : E_ObjectiveFunctionDirection::Maximize;
+        objective.constant = getDoubleAttribute(reader, "constant", 0.0);
 
-            if(variableLB < minLBInt)
-                variableLB = minLBInt;
+        if(auto numberOfCoefficients = reader.getAttribute("numberOfObjCoef"))
+            objective.coefficients.reserve(XMLStreamReader::parseInteger(*numberOfCoefficients));
 
-            if(variableUB > maxUBInt)
-                variableUB = maxUBInt;
+        for(event = reader.next(); event != E_Event::EndElement; event = reader.next())
+        {
+            if(event != E_Event::StartElement)
+                continue;
 
-            if(variableLB > 0.0)
+            if(reader.getName() != "coef")
             {
-                semiBound = variableLB;
-                variableLB = 0.0;
-                variableType = E_VariableType::Semiinteger;
-            }
-            else if(variableUB < 0.0)
-            {
-                semiBound = variableUB;
-                variableUB = 0.0;
-                variableType = E_VariableType::Semiinteger;
-            }
-            else
-            {
-                variableType = E_VariableType::Integer;
+                reader.skipElement();
+                continue;
             }
 
-            break;
+            int index = getIntegerAttribute(reader, "idx");
+            double coefficient = XMLStreamReader::parseDouble(reader.readElementText());
 
-        default:
-            return (E_ProblemCreationStatus::ErrorInVariables);
-            break;
+            objective.coefficients.emplace_back(index, coefficient);
         }
+    }
+}
 
-        problem->add(std::make_shared<SHOT::Variable>(
-            variableName, variableIndex, variableType, variableLB, variableUB, semiBound));
+void readConstraints(XMLStreamReader& reader, std::vector<ConstraintData>& constraints)
+{
+    if(auto numberOfConstraints = reader.getAttribute("numberOfConstraints"))
+        constraints.reserve(XMLStreamReader::parseInteger(*numberOfConstraints));
 
-        variableIndex++;
+    for(auto event = reader.next(); event != E_Event::EndElement; event = reader.next())
+    {
+        if(event != E_Event::StartElement)
+            continue;
+
+        if(reader.getName() != "con")
+        {
+            reader.skipElement();
+            continue;
+        }
+
+        auto name = reader.getAttributeString("name");
+
+        constraints.push_back(ConstraintData { name ? *name : "con" + std::to_string(constraints.size()),
+            getDoubleAttribute(reader, "lb", SHOT_DBL_MIN), getDoubleAttribute(reader, "ub", SHOT_DBL_MAX) });
+
+        reader.skipElement();
     }
+}
 
-    if(variableIndex == 0)
+void readLinearConstraintCoefficients(XMLStreamReader& reader, LinearCoefficientData& coefficients)
+{
+    if(auto numberOfValues = reader.getAttribute("numberOfValues"))
     {
-        env->output->outputError(fmt::format("No variables defined."));
-        env->timing->stopTimer("ProblemInitialization");
-        return (E_ProblemCreationStatus::ErrorInVariables);
+        size_t size = XMLStreamReader::parseInteger(*numberOfValues);
+        coefficients.indices.reserve(size);
+        coefficients.coefficients.reserve(size);
     }
 
-    auto quadraticCoeffNodes = osilDocument.FirstChildElement("osil")
-                                   ->FirstChildElement("instanceData")
-                                   ->FirstChildElement("quadraticCoefficients");
+    for(auto event = reader.next(); event != E_Event::EndElement; event = reader.next())
+    {
+        if(event != E_Event::StartElement)
+            continue;
 
-    // Flag constraints (and objective) with quadratic terms, will add the terms themselves later on after objetive
-    // and constraint have been created
-    std::map<int, bool> containsQuadraticTerms;
+        auto name = reader.getName();
 
-    try
-    {
-        if(quadraticCoeffNodes != NULL)
+        if(name == "start")
         {
-            for(auto QT = quadraticCoeffNodes->FirstChildElement("qTerm"); QT != nullptr;
-                QT = QT->NextSiblingElement("qTerm"))
-            {
-                int constraintIndex = std::stoi(QT->Attribute("idx"));
-                containsQuadraticTerms.emplace(constraintIndex, true);
-            }
+            readArray(reader, coefficients.startIndices);
+        }
+        else if(name == "rowIdx" || name == "colIdx")
+        {
+            coefficients.isRowFormat = (name == "colIdx");
+            readArray(reader, coefficients.indices);
+        }
+        else if(name == "value")
+        {
+            readArray(reader, coefficients.coefficients);
+        }
+        else
+        {
+            reader.skipElement();
         }
     }
-    catch(const std::exception&)
+
+    if(coefficients.indices.size() != coefficients.coefficients.size())
+        throw Exception("The number of indices and values of the linear terms differ.");
+}
+
+void readQuadraticCoefficients(XMLStreamReader& reader, std::vector<QuadraticTermData>& terms)
+{
+    if(auto numberOfTerms = reader.getAttribute("numberOfQuadraticTerms"))
+        terms.reserve(XMLStreamReader::parseInteger(*numberOfTerms));
+
+    for(auto event = reader.next(); event != E_Event::EndElement; event = reader.next())
     {
-        env->output->outputError(fmt::format("Error when parsing quadratic terms."));
-        env->timing->stopTimer("ProblemInitialization");
-        return (E_ProblemCreationStatus::ErrorInConstraints);
+        if(event != E_Event::StartElement)
+            continue;
+
+        if(reader.getName() == "qTerm")
+        {
+            terms.push_back(QuadraticTermData { getIntegerAttribute(reader, "idx"),
+                getIntegerAttribute(reader, "idxOne"), getIntegerAttribute(reader, "idxTwo"),
+                getDoubleAttribute(reader, "coef", 1.0) });
+        }
+
+        reader.skipElement();
     }
+}
 
-    auto nonlinearExprNodes = osilDocument.FirstChildElement("osil")
-                                  ->FirstChildElement("instanceData")
-                                  ->FirstChildElement("nonlinearExpressions");
+// Returns nullptr if the element is not a constant or variable
+NonlinearExpressionPtr createLeafExpression(
+    const XMLStreamReader& reader, std::string_view type, const ProblemPtr& destination)
+{
+    auto& arena = destination->arena;
 
-    // Flag constraints (and objective) with nonlinear expressions, will add the expressions when creating the
-    // objects
-    std::map<int, NonlinearExpressionPtr> nonlinearConstraints;
+    if(type == "number")
+        return arena.create<ExpressionConstant>(getDoubleAttribute(reader, "value", 0.0));
 
-    try
+    if(type == "pi")
+        return arena.create<ExpressionConstant>(3.14159265);
+
+    if(type != "variable")
+        return (nullptr);
+
+    double coefficient = getDoubleAttribute(reader, "coef", 1.0);
+
+    if(coefficient == 0.)
+        return arena.create<ExpressionConstant>(0.);
+
+    auto variable = destination->getVariable(getIntegerAttribute(reader, "idx"));
+
+    if(variable->lowerBound == variable->upperBound)
+        return arena.create<ExpressionConstant>(coefficient * variable->lowerBound);
+
+    if(coefficient == 1.)
+        return arena.create<ExpressionVariable>(variable);
+
+    if(coefficient == -1.)
+        return arena.create<ExpressionNegate>(arena.create<ExpressionVariable>(variable));
+
+    return arena.create<ExpressionProduct>(
+        arena.create<ExpressionConstant>(coefficient), arena.create<ExpressionVariable>(variable));
+}
+
+NonlinearExpressionPtr createExpression(
+    std::string_view type, NonlinearExpressions& children, const ProblemPtr& destination)
+{
+    auto& arena = destination->arena;
+
+    auto checkNumberOfChildren = [&](size_t number)
     {
-        if(nonlinearExprNodes != NULL)
+        if(children.size() != number)
+            throw Exception(fmt::format("Wrong number of arguments to OSiL function {}.", type));
+    };
+
+    if(type == "plus")
+    {
+        checkNumberOfChildren(2);
+        return arena.create<ExpressionSum>(children[0], children[1]);
+    }
+    else if(type == "sum")
+    {
+        switch(children.size())
         {
-            for(auto EXPR = nonlinearExprNodes->FirstChildElement("nl"); EXPR != nullptr;
-                EXPR = EXPR->NextSiblingElement("nl"))
-            {
-                int constraintIndex = std::stoi(EXPR->Attribute("idx"));
-                nonlinearConstraints.emplace(constraintIndex, convertNonlinearNode(EXPR->FirstChildElement(), problem));
-            }
+        case 0:
+            return arena.create<ExpressionConstant>(0.);
+        case 1:
+            return children[0];
+        default:
+            return arena.create<ExpressionSum>(children);
         }
     }
-    catch(const std::exception&)
+    else if(type == "minus")
     {
-        env->output->outputError(fmt::format("Error when parsing nonlinear expressions."));
-        env->timing->stopTimer("ProblemInitialization");
-        return (E_ProblemCreationStatus::ErrorInConstraints);
+        checkNumberOfChildren(2);
+        return arena.create<ExpressionSum>(children[0], arena.create<ExpressionNegate>(children[1]));
+    }
+    else if(type == "negate")
+    {
+        checkNumberOfChildren(1);
+        return arena.create<ExpressionNegate>(children[0]);
+    }
+    else if(type == "times")
+    {
+        checkNumberOfChildren(2);
+        return arena.create<ExpressionProduct>(children[0], children[1]);
+    }
+    else if(type == "divide")
+    {
+        checkNumberOfChildren(2);
+        return arena.create<ExpressionDivide>(children[0], children[1]);
+    }
+    else if(type == "power")
+    {
+        checkNumberOfChildren(2);
+        return arena.create<ExpressionPower>(children[0], children[1]);
+    }
+    else if(type == "product")
+    {
+        switch(children.size())
+        {
+        case 0:
+            return arena.create<ExpressionConstant>(0.);
+        case 1:
+            return children[0];
+        default:
+            return arena.create<ExpressionProduct>(children);
+        }
     }
 
-    // Read constraints
-    auto constraintsNodes
-        = osilDocument.FirstChildElement("osil")->FirstChildElement("instanceData")->FirstChildElement("constraints");
+    checkNumberOfChildren(1);
+
+    if(type == "abs")
+        return arena.create<ExpressionAbs>(children[0]);
+    else if(type == "square")
+        return arena.create<ExpressionSquare>(children[0]);
+    else if(type == "sqrt")
+        return arena.create<ExpressionSquareRoot>(children[0]);
+    else if(type == "ln")
+        return arena.create<ExpressionLog>(children[0]);
+    else if(type == "exp")
+        return arena.create<ExpressionExp>(children[0]);
+    else if(type == "sin")
+        return arena.create<ExpressionSin>(children[0]);
+    else if(type == "cos")
+        return arena.create<ExpressionCos>(children[0]);
+
+    throw OperationNotImplementedException(fmt::format("Error: Unsupported OSiL function {}", type));
+}
+
+// Reads the expression starting at the current start element. The elements whose children have not all been read yet
+// are kept on an explicit stack, so deeply nested expressions do not cause a deep recursion.
+NonlinearExpressionPtr readNonlinearExpression(XMLStreamReader& reader, const ProblemPtr& destination)
+{
+    struct ExpressionElement
+    {
+        std::string_view type;
+        NonlinearExpressionPtr expression;
+        NonlinearExpressions children;
+    };
 
-    int constraintCounter = 0;
+    std::vector<ExpressionElement> elements;
 
-    try
+    for(auto event = E_Event::StartElement;; event = reader.next())
     {
-        if(constraintsNodes != NULL)
+        if(event == E_Event::StartElement)
         {
-            for(auto C = constraintsNodes->FirstChildElement("con"); C != nullptr; C = C->NextSiblingElement("con"))
-            {
-                double lowerBound = (C->Attribute("lb") != NULL) ? std::stod(C->Attribute("lb")) : SHOT_DBL_MIN;
-                double upperBound = (C->Attribute("ub") != NULL) ? std::stod(C->Attribute("ub")) : SHOT_DBL_MAX;
+            auto type = reader.getName();
+            elements.push_back(ExpressionElement { type, createLeafExpression(reader, type, destination), {} });
+        }
+        else if(event == E_Event::EndElement)
+        {
+            auto& element = elements.back();
 
-                auto name
-                    = (C->Attribute("name") != NULL) ? C->Attribute("name") : "con" + std::to_string(constraintCounter);
+            auto expression = element.expression
+                ? element.expression
+                : createExpression(element.type, element.children, destination);
 
-                auto nonlinearExpression = nonlinearConstraints.find(constraintCounter);
-                auto hasQuadraticTerms = containsQuadraticTerms.find(constraintCounter);
+            elements.pop_back();
 
-                if(nonlinearExpression != nonlinearConstraints.end())
-                    problem->add(std::make_shared<NonlinearConstraint>(
-                        constraintCounter, name, nonlinearExpression->second, lowerBound, upperBound));
-                else if(hasQuadraticTerms != containsQuadraticTerms.end())
-                    problem->add(
-                        std::make_shared<QuadraticConstraint>(constraintCounter, name, lowerBound, upperBound));
-                else
-                    problem->add(std::make_shared<LinearConstraint>(constraintCounter, name, lowerBound, upperBound));
+            if(elements.empty())
+                return (expression);
 
-                constraintCounter++;
-            }
+            elements.back().children.push_back(std::move(expression));
         }
     }
-    catch(const std::exception&)
-    {
-        env->output->outputError(fmt::format("Error when parsing constraints."));
-        env->timing->stopTimer("ProblemInitialization");
-        return (E_ProblemCreationStatus::ErrorInConstraints);
-    }
+}
 
-    try
+void readNonlinearExpressions(
+    XMLStreamReader& reader, const ProblemPtr& problem, std::map<int, NonlinearExpressionPtr>& expressions)
+{
+    for(auto event = reader.next(); event != E_Event::EndElement; event = reader.next())
     {
-        auto objectivesNodes = osilDocument.FirstChildElement("osil")
-                                   ->FirstChildElement("instanceData")
-                                   ->FirstChildElement("objectives");
+        if(event != E_Event::StartElement)
+            continue;
 
-        if(objectivesNodes->FirstChild()->NextSibling() != NULL)
+        if(reader.getName() != "nl")
         {
-            // Error message here
-            env->timing->stopTimer("ProblemInitialization");
-            return (E_ProblemCreationStatus::ErrorInObjective);
+            reader.skipElement();
+            continue;
         }
 
-        auto objective = objectivesNodes->FirstChildElement("obj");
+        int constraintIndex = getIntegerAttribute(reader, "idx");
+        NonlinearExpressionPtr expression;
 
-        if(objective->Attribute("maxOrMin") == NULL)
+        for(event = reader.next(); event != E_Event::EndElement; event = reader.next())
         {
-            env->timing->stopTimer("ProblemInitialization");
-            return (E_ProblemCreationStatus::ErrorInObjective);
+            if(event == E_Event::StartElement && !expression)
+                expression = readNonlinearExpression(reader, problem);
+            else if(event == E_Event::StartElement)
+                throw Exception(fmt::format("Several nonlinear expressions with index {}.", constraintIndex));
         }
 
-        E_ObjectiveFunctionDirection direction = (std::string("min").compare(objective->Attribute("maxOrMin")) == 0)
-            ? E_ObjectiveFunctionDirection::Minimize
-            : E_ObjectiveFunctionDirection::Maximize;
+        if(expression)
+            expressions.emplace(constraintIndex, expression);
+    }
+}
 
-        double constant
-            = (objective->Attribute("constant") != NULL) ? std::stod(objective->Attribute("constant")) : 0.0;
+void readSpecialOrderedSets(XMLStreamReader& reader, const ProblemPtr& problem)
+{
+    for(auto event = reader.next(); event != E_Event::EndElement; event = reader.next())
+    {
+        if(event != E_Event::StartElement)
+            continue;
 
-        auto nonlinearObjectiveExpression = nonlinearConstraints.find(-1);
-        auto objectiveHasQuadraticTerms = containsQuadraticTerms.find(-1);
+        if(reader.getName() != "sos")
+        {
+            reader.skipElement();
+            continue;
+        }
 
-        if(nonlinearObjectiveExpression != nonlinearConstraints.end())
-            problem->add(std::make_shared<NonlinearObjectiveFunction>(
-                direction, nonlinearObjectiveExpression->second, constant));
-        else if(objectiveHasQuadraticTerms != containsQuadraticTerms.end())
-            problem->add(std::make_shared<QuadraticObjectiveFunction>(direction, constant));
-        else
-            problem->add(std::make_shared<LinearObjectiveFunction>(direction, constant));
+        auto typeAttribute = reader.getAttribute("type");
+        int SOSType = typeAttribute ? XMLStreamReader::parseInteger(*typeAttribute) : 1;
 
-        for(auto C = objective->FirstChildElement("coef"); C != nullptr; C = C->NextSiblingElement("coef"))
+        Variables variables;
+
+        if(auto numberOfVariables = reader.getAttribute("numberOfVar"))
+            variables.reserve(XMLStreamReader::parseInteger(*numberOfVariables));
+
+        for(event = reader.next(); event != E_Event::EndElement; event = reader.next())
         {
-            if(C->Attribute("idx") == NULL)
-            {
-                env->timing->stopTimer("ProblemInitialization");
-                return (E_ProblemCreationStatus::ErrorInObjective);
-            }
+            if(event != E_Event::StartElement)
+                continue;
 
-            double coefficient = std::stod(C->GetText());
-            int index = std::stoi(C->Attribute("idx"));
+            if(reader.getName() == "var")
+                variables.push_back(problem->getVariable(getIntegerAttribute(reader, "idx")));
 
-            std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction)
-                ->add(std::make_shared<LinearTerm>(coefficient, problem->allVariables[index]));
+            reader.skipElement();
         }
+
+        problem->add(std::make_shared<SpecialOrderedSet>((SOSType == 1) ? E_SOSType::One : E_SOSType::Two, variables));
+    }
+}
+} // namespace
+
+E_ProblemCreationStatus ModelingSystemOSiL::createProblem(ProblemPtr& problem, const std::string& filename)
+{
+    if(false && !fs::filesystem::exists(fs::filesystem::path(filename)))
+    {
+        env->output->outputError("Problem file \"" + filename + "\" does not exist.");
+
+        return (E_ProblemCreationStatus::FileDoesNotExist);
     }
-    catch(const std::exception&)
+
+    env->timing->startTimer("ProblemInitialization");
+
+    // The file is read in one pass without creating a document tree
+    MappedFile osilFile;
+
+    if(!osilFile.open(filename))
     {
-        env->output->outputError(fmt::format("Error when parsing objective function."));
+        env->output->outputError(fmt::format("Could not read problem from OSiL file {}.", filename));
         env->timing->stopTimer("ProblemInitialization");
-        return (E_ProblemCreationStatus::ErrorInObjective);
+        return (E_ProblemCreationStatus::ErrorInFile);
     }
 
+    XMLStreamReader reader(osilFile.getContents());
+
+    VariableBoundLimits limits { env->settings->getSetting<double>("Variables.Continuous.MinimumLowerBound", "Model"),
+        env->settings->getSetting<double>("Variables.Continuous.MaximumUpperBound", "Model"),
+        env->settings->getSetting<double>("Variables.Integer.MinimumLowerBound", "Model"),
+        env->settings->getSetting<double>("Variables.Integer.MaximumUpperBound", "Model") };
+
+    ObjectiveData objective;
+    std::vector<ConstraintData> constraints;
+    LinearCoefficientData linearCoefficients;
+    std::vector<QuadraticTermData> quadraticTerms;
+    std::map<int, NonlinearExpressionPtr> nonlinearExpressions;
+
+    int variableIndex = 0;
+
+    // The status and description used if there is an error in the current section
+    auto status = E_ProblemCreationStatus::ErrorInFile;
+    std::string section = "file";
+
     try
     {
-        if(quadraticCoeffNodes != NULL)
+        bool isInHeader = false;
+
+        for(auto event = reader.next(); event != E_Event::EndOfDocument; event = reader.next())
         {
-            for(auto QT = quadraticCoeffNodes->FirstChildElement("qTerm"); QT != nullptr;
-                QT = QT->NextSiblingElement("qTerm"))
-            {
-                int placementIndex = std::stoi(QT->Attribute("idx"));
-                double coefficient = (QT->Attribute("coef") != NULL) ? std::stod(QT->Attribute("coef")) : 1.0;
-                int firstVariableIndex = std::stoi(QT->Attribute("idxOne"));
-                int secondVariableIndex = std::stoi(QT->Attribute("idxTwo"));
+            if(event == E_Event::EndElement && reader.getName() == "instanceHeader")
+                isInHeader = false;
 
-                VariablePtr firstVariable = problem->getVariable(firstVariableIndex);
-                VariablePtr secondVariable = problem->getVariable(secondVariableIndex);
+            if(event != E_Event::StartElement)
+                continue;
 
-                bool firstVariableFixed = firstVariable->lowerBound == firstVariable->upperBound;
-                bool secondVariableFixed = secondVariable->lowerBound == secondVariable->upperBound;
+            auto name = reader.getName();
 
-                if(placementIndex == -1)
-                {
-                    if(firstVariableFixed && secondVariableFixed)
-                    {
-                        (std::static_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction))->constant
-                            += coefficient * firstVariable->lowerBound * secondVariable->lowerBound;
-                    }
-                    else if(firstVariableFixed)
-                    {
-                        std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction)
-                            ->add(
-                                std::make_shared<LinearTerm>(coefficient * firstVariable->lowerBound, secondVariable));
-                    }
-                    else if(secondVariableFixed)
-                    {
-                        std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction)
-                            ->add(
-                                std::make_shared<LinearTerm>(coefficient * secondVariable->lowerBound, firstVariable));
-                    }
-                    else
-                    {
-                        std::dynamic_pointer_cast<QuadraticObjectiveFunction>(problem->objectiveFunction)
-                            ->add(std::make_shared<QuadraticTerm>(coefficient, firstVariable, secondVariable));
-                    }
-                }
-                else
+            if(name == "osil" || name == "instanceData")
+            {
+                // The sections are read as children
+            }
+            else if(name == "instanceHeader")
+            {
+                isInHeader = true;
+            }
+            else if(name == "name" && isInHeader)
+            {
+                problem->name = XMLStreamReader::replaceEntities(reader.readElementText());
+            }
+            else if(name == "variables")
+            {
+                status = E_ProblemCreationStatus::ErrorInVariables;
+                section = "variables";
+
+                for(event = reader.next(); event != E_Event::EndElement; event = reader.next())
                 {
-                    if(firstVariableFixed && secondVariableFixed)
-                    {
-                        std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[placementIndex])
-                            ->constant
-                            += coefficient * firstVariable->lowerBound * secondVariable->lowerBound;
-                    }
-                    else if(firstVariableFixed)
-                    {
-                        std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[placementIndex])
-                            ->add(
-                                std::make_shared<LinearTerm>(coefficient * firstVariable->lowerBound, secondVariable));
-                    }
-                    else if(secondVariableFixed)
-                    {
-                        std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[placementIndex])
-                            ->add(
-                                std::make_shared<LinearTerm>(coefficient * secondVariable->lowerBound, firstVariable));
-                    }
-                    else
+                    if(event != E_Event::StartElement)
+                        continue;
+
+                    if(reader.getName() == "var")
                     {
-                        std::dynamic_pointer_cast<QuadraticConstraint>(problem->numericConstraints[placementIndex])
-                            ->add(std::make_shared<QuadraticTerm>(coefficient, firstVariable, secondVariable));
+                        readVariable(reader, problem, limits, variableIndex);
+                        variableIndex++;
                     }
+
+                    reader.skipElement();
                 }
             }
+            else if(name == "objectives")
+            {
+                status = E_ProblemCreationStatus::ErrorInObjective;
+                section = "objective function";
+                readObjectives(reader, objective);
+            }
+            else if(name == "constraints")
+            {
+                status = E_ProblemCreationStatus::ErrorInConstraints;
+                section = "constraints";
+                readConstraints(reader, constraints);
+            }
+            else if(name == "linearConstraintCoefficients")
+            {
+                status = E_ProblemCreationStatus::ErrorInConstraints;
+                section = "linear terms in constraints";
+                readLinearConstraintCoefficients(reader, linearCoefficients);
+            }
+            else if(name == "quadraticCoefficients")
+            {
+                status = E_ProblemCreationStatus::ErrorInConstraints;
+                section = "quadratic terms";
+                readQuadraticCoefficients(reader, quadraticTerms);
+            }
+            else if(name == "nonlinearExpressions")
+            {
+                status = E_ProblemCreationStatus::ErrorInConstraints;
+                section = "nonlinear expressions";
+                readNonlinearExpressions(reader, problem, nonlinearExpressions);
+            }
+            else if(name == "specialOrderedSets")
+            {
+                status = E_ProblemCreationStatus::ErrorInConstraints;
+                section = "special ordered sets";
+                readSpecialOrderedSets(reader, problem);
+            }
+            else
+            {
+                reader.skipElement();
+            }
         }
     }
-    catch(const std::exception&)
+    catch(const std::exception& e)
     {
-        env->output->outputError(fmt::format("Error when parsing quadratic terms."));
+        env->output->outputError(
+            fmt::format(
+                "Error when parsing {} at position {} in OSiL file {}:", section, reader.getPosition(), filename),
+            e.what());
         env->timing->stopTimer("ProblemInitialization");
-        return (E_ProblemCreationStatus::ErrorInConstraints);
+        return (status);
     }
 
-    try
+    if(variableIndex == 0)
     {
-        auto linConCoeffNodes = osilDocument.FirstChildElement("osil")
-                                    ->FirstChildElement("instanceData")
-                                    ->FirstChildElement("linearConstraintCoefficients");
-
-        int numberOfCoeffs = (linConCoeffNodes == NULL) ? 0 : std::stoi(linConCoeffNodes->Attribute("numberOfValues"));
+        env->output->outputError(fmt::format("No variables defined."));
+        env->timing->stopTimer("ProblemInitialization");
+        return (E_ProblemCreationStatus::ErrorInVariables);
+    }
 
-        if(numberOfCoeffs > 0)
-        {
-            VectorInteger startIndices;
-            VectorInteger indices(numberOfCoeffs);
-            VectorDouble coefficients(numberOfCoeffs);
+    // Flag constraints (and objective) with quadratic terms, the terms themselves are added after the objective and
+    // constraints have been created
+    std::vector<bool> containsQuadraticTerms(constraints.size(), false);
+    bool objectiveContainsQuadraticTerms = false;
 
-            bool isRowFormat = (linConCoeffNodes->FirstChildElement("colIdx") != NULL) ? true : false;
+    for(auto& QT : quadraticTerms)
+    {
+        if(QT.placementIndex == -1)
+            objectiveContainsQuadraticTerms = true;
+        else if(QT.placementIndex >= 0 && QT.placementIndex < (int)constraints.size())
+            containsQuadraticTerms[QT.placementIndex] = true;
+    }
 
-            for(auto E = linConCoeffNodes->FirstChildElement("start")->FirstChildElement("el"); E != nullptr;
-                E = E->NextSiblingElement("el"))
-            {
-                int mult = (E->Attribute("mult") != NULL) ? std::stoi(E->Attribute("mult")) : 1;
-                int incr = (E->Attribute("incr") != NULL) ? std::stoi(E->Attribute("incr")) : 0;
-                int value = std::stoi(E->GetText());
+    for(size_t i = 0; i < constraints.size(); i++)
+    {
+        auto& C = constraints[i];
+        auto nonlinearExpression = nonlinearExpressions.find(i);
 
-                for(int i = 0; i < mult; i++)
-                    startIndices.push_back(value + i * incr);
-            }
+        if(nonlinearExpression != nonlinearExpressions.end())
+            problem->add(std::make_shared<NonlinearConstraint>(
+                i, C.name, nonlinearExpression->second, C.lowerBound, C.upperBound));
+        else if(containsQuadraticTerms[i])
+            problem->add(std::make_shared<QuadraticConstraint>(i, C.name, C.lowerBound, C.upperBound));
+        else
+            problem->add(std::make_shared<LinearConstraint>(i, C.name, C.lowerBound, C.upperBound));
+    }
 
-            std::string rowOrColIdx = isRowFormat ? "colIdx" : "rowIdx";
+    // The stored constraint data is not needed anymore
+    constraints = std::vector<ConstraintData>();
 
-            int counter = 0;
+    try
+    {
+        if(!objective.isDefined)
+            throw Exception("No objective function defined.");
 
-            for(auto E = linConCoeffNodes->FirstChildElement(rowOrColIdx.c_str())->FirstChildElement("el");
-                E != nullptr; E = E->NextSiblingElement("el"))
-            {
-                int mult = (E->Attribute("mult") != NULL) ? std::stoi(E->Attribute("mult")) : 1;
-                int incr = (E->Attribute("incr") != NULL) ? std::stoi(E->Attribute("incr")) : 0;
-                int value = std::stoi(E->GetText());
+        auto nonlinearObjectiveExpression = nonlinearExpressions.find(-1);
 
-                for(int i = 0; i < mult; i++)
-                {
-                    indices[counter] = value + i * incr;
-                    counter++;
-                }
-            }
+        if(nonlinearObjectiveExpression != nonlinearExpressions.end())
+            problem->add(std::make_shared<NonlinearObjectiveFunction>(
+                objective.direction, nonlinearObjectiveExpression->second, objective.constant));
+        else if(objectiveContainsQuadraticTerms)
+            problem->add(std::make_shared<QuadraticObjectiveFunction>(objective.direction, objective.constant));
+        else
+            problem->add(std::make_shared<LinearObjectiveFunction>(objective.direction, objective.constant));
 
-            counter = 0;
+        for(auto& [index, coefficient] : objective.coefficients)
+        {
+            std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction)
+                ->add(problem->arena.create<LinearTerm>(coefficient, problem->getVariable(index)));
+        }
+    }
+    catch(const std::exception& e)
+    {
+        env->output->outputError(fmt::format("Error when parsing objective function:"), e.what());
+        env->timing->stopTimer("ProblemInitialization");
+        return (E_ProblemCreationStatus::ErrorInObjective);
+    }
 
-            for(auto E = linConCoeffNodes->FirstChildElement("value")->FirstChildElement("el"); E != nullptr;
-                E = E->NextSiblingElement("el"))
-            {
-                int mult = (E->Attribute("mult") != NULL) ? std::stoi(E->Attribute("mult")) : 1;
-                int incr = (E->Attribute("incr") != NULL) ? std::stoi(E->Attribute("incr")) : 0;
-                double value = std::stod(E->GetText());
+    try
+    {
+        for(auto& QT : quadraticTerms)
+        {
+            int placementIndex = QT.placementIndex;
+            double coefficient = QT.coefficient;
 
-                for(int i = 0; i < mult; i++)
-                {
-                    coefficients[counter] = value + i * incr;
-                    counter++;
-                }
-            }
+            VariablePtr firstVariable = problem->getVariable(QT.firstVariableIndex);
+            VariablePtr secondVariable = problem->getVariable(QT.secondVariableIndex);
 
-            counter = 0;
+            bool firstVariableFixed = firstVariable->lowerBound == firstVariable->upperBound;
+            bool secondVariableFixed = secondVariable->lowerBound == secondVariable->upperBound;
 
-            if(isRowFormat)
+            if(placementIndex == -1)
             {
-                for(size_t i = 0; i < problem->numericConstraints.size(); i++)
+                if(firstVariableFixed && secondVariableFixed)
                 {
-                    while(counter < startIndices[i + 1])
-                    {
-                        auto variable = problem->allVariables[indices[counter]];
-
-                        if(variable->lowerBound == variable->upperBound)
-                            std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[i])->constant
-                                += coefficients[counter] * variable->lowerBound;
-                        else
-                            std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[i])
-                                ->add(std::make_shared<LinearTerm>(coefficients[counter], variable));
-
-                        counter++;
-                    }
+                    (std::static_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction))->constant
+                        += coefficient * firstVariable->lowerBound * secondVariable->lowerBound;
+                }
+                else if(firstVariableFixed)
+                {
+                    std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction)
+                        ->add(problem->arena.create<LinearTerm>(
+                            coefficient * firstVariable->lowerBound, secondVariable));
+                }
+                else if(secondVariableFixed)
+                {
+                    std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction)
+                        ->add(problem->arena.create<LinearTerm>(
+                            coefficient * secondVariable->lowerBound, firstVariable));
+                }
+                else
+                {
+                    std::dynamic_pointer_cast<QuadraticObjectiveFunction>(problem->objectiveFunction)
+                        ->add(problem->arena.create<QuadraticTerm>(coefficient, firstVariable, secondVariable));
                 }
             }
             else
             {
-                for(size_t i = 0; i < problem->allVariables.size(); i++)
-                {
-                    while(counter < startIndices[i + 1])
-                    {
-                        auto variable = problem->allVariables[i];
-
-                        if(variable->lowerBound == variable->upperBound)
-                            std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[indices[counter]])
-                                ->constant
-                                += coefficients[counter] * variable->lowerBound;
-                        else
-                            std::dynamic_pointer_cast<LinearConstraint>(problem->numericConstraints[indices[counter]])
-                                ->add(std::make_shared<LinearTerm>(coefficients[counter], variable));
+                auto constraint = problem->numericConstraints.at(placementIndex);
 
-                        counter++;
-                    }
+                if(firstVariableFixed && secondVariableFixed)
+                {
+                    std::dynamic_pointer_cast<LinearConstraint>(constraint)->constant
+                        += coefficient * firstVariable->lowerBound * secondVariable->lowerBound;
+                }
+                else if(firstVariableFixed)
+                {
+                    std::dynamic_pointer_cast<LinearConstraint>(constraint)
+                        ->add(problem->arena.create<LinearTerm>(
+                            coefficient * firstVariable->lowerBound, secondVariable));
+                }
+                else if(secondVariableFixed)
+                {
+                    std::dynamic_pointer_cast<LinearConstraint>(constraint)
+                        ->add(problem->arena.create<LinearTerm>(
+                            coefficient * secondVariable->lowerBound, firstVariable));
+                }
+                else
+                {
+                    std::dynamic_pointer_cast<QuadraticConstraint>(constraint)
+                        ->add(problem->arena.create<QuadraticTerm>(coefficient, firstVariable, secondVariable));
                 }
             }
         }
     }
-    catch(const std::exception&)
+    catch(const std::exception& e)
     {
-        env->output->outputError(fmt::format("Error when parsing linear terms in constraints."));
+        env->output->outputError(fmt::format("Error when parsing quadratic terms:"), e.what());
         env->timing->stopTimer("ProblemInitialization");
         return (E_ProblemCreationStatus::ErrorInConstraints);
     }
 
-    // Read the SOS
+    quadraticTerms = std::vector<QuadraticTermData>();
+
     try
     {
-        auto SOSNodes = osilDocument.FirstChildElement("osil")
-                            ->FirstChildElement("instanceData")
-                            ->FirstChildElement("specialOrderedSets");
+        auto& startIndices = linearCoefficients.startIndices;
+        auto& indices = linearCoefficients.indices;
+        auto& coefficients = linearCoefficients.coefficients;
 
-        if(SOSNodes != NULL)
-        {
-            for(auto S = SOSNodes->FirstChildElement("sos"); S != nullptr; S = S->NextSiblingElement("sos"))
-            {
-                int SOSType = (S->Attribute("type") != NULL) ? std::stoi(S->Attribute("type")) : 1;
-                int numVariables = (S->Attribute("numberOfVar") != NULL) ? std::stoi(S->Attribute("numberOfVar")) : 1;
+        size_t numberOfVectors
+            = linearCoefficients.isRowFormat ? problem->numericConstraints.size() : problem->allVariables.size();
 
-                Variables variables;
-                variables.reserve(numVariables);
+        if(indices.size() > 0 && startIndices.size() <= numberOfVectors)
+            throw Exception("Too few start indices for the linear terms.");
 
-                for(auto VAR = S->FirstChildElement("var"); VAR != nullptr; VAR = VAR->NextSiblingElement("var"))
-                {
-                    int variableIndex = std::stoi(VAR->Attribute("idx"));
-                    variables.push_back(problem->getVariable(variableIndex));
-                }
+        int counter = 0;
 
-                problem->add(
-                    std::make_shared<SpecialOrderedSet>((SOSType == 1) ? E_SOSType::One : E_SOSType::Two, variables));
+        for(size_t i = 0; i < numberOfVectors && indices.size() > 0; i++)
+        {
+            for(; counter < startIndices[i + 1] && counter < (int)indices.size(); counter++)
+            {
+                auto variable = problem->getVariable(linearCoefficients.isRowFormat ? indices[counter] : i);
+                auto constraint = std::dynamic_pointer_cast<LinearConstraint>(
+                    problem->numericConstraints.at(linearCoefficients.isRowFormat ? i : indices[counter]));
+
+                if(variable->lowerBound == variable->upperBound)
+                    constraint->constant += coefficients[counter] * variable->lowerBound;
+                else
+                    constraint->add(problem->arena.create<LinearTerm>(coefficients[counter], variable));
             }
         }
     }
-    catch(const std::exception&)
+    catch(const std::exception& e)
     {
-        env->output->outputError(fmt::format("Error when parsing special ordered sets."));
+        env->output->outputError(fmt::format("Error when parsing linear terms in constraints:"), e.what());
         env->timing->stopTimer("ProblemInitialization");
         return (E_ProblemCreationStatus::ErrorInConstraints);
     }
 
+    linearCoefficients = LinearCoefficientData();
+
     problem->updateProperties();
 
     bool extractMonomialTerms = env->settings->getSetting<bool>("Reformulation.Monomials.Extract", "Model");
@@ -610,166 +938,6 @@ E_ProblemCreationStatus ModelingSystemOSiL::createProblem(ProblemPtr& problem, c
     return (E_ProblemCreationStatus::NormalCompletion);
 }
 
-NonlinearExpressionPtr ModelingSystemOSiL::convertNonlinearNode(tinyxml2::XMLNode* node, const ProblemPtr& destination)
-{
-    std::string expressionType = node->ToElement()->Name();
-
-    if(expressionType.compare("plus") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        auto secondChildNode = firstChildNode->NextSibling();
-
-        return std::make_shared<ExpressionSum>(
-            convertNonlinearNode(firstChildNode, destination), convertNonlinearNode(secondChildNode, destination));
-    }
-    else if(expressionType.compare("sum") == 0)
-    {
-        NonlinearExpressions terms;
-
-        for(auto C = node->FirstChildElement(); C != nullptr; C = C->NextSiblingElement())
-            terms.push_back(convertNonlinearNode(C, destination));
-
-        switch(terms.size())
-        {
-        case 0:
-            return std::make_shared<ExpressionConstant>(0.);
-        case 1:
-            return terms[1];
-        default:
-            return std::make_shared<ExpressionSum>(terms);
-        }
-    }
-    else if(expressionType.compare("minus") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        auto secondChildNode = firstChildNode->NextSibling();
-
-        return std::make_shared<ExpressionSum>(convertNonlinearNode(firstChildNode, destination),
-            std::make_shared<ExpressionNegate>(convertNonlinearNode(secondChildNode, destination)));
-    }
-    else if(expressionType.compare("negate") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-
-        return std::make_shared<ExpressionNegate>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("times") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        auto secondChildNode = firstChildNode->NextSibling();
-
-        return std::make_shared<ExpressionProduct>(
-            convertNonlinearNode(firstChildNode, destination), convertNonlinearNode(secondChildNode, destination));
-    }
-    else if(expressionType.compare("divide") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        auto secondChildNode = firstChildNode->NextSibling();
-
-        return std::make_shared<ExpressionDivide>(
-            convertNonlinearNode(firstChildNode, destination), convertNonlinearNode(secondChildNode, destination));
-    }
-    else if(expressionType.compare("power") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        auto secondChildNode = firstChildNode->NextSibling();
-
-        return std::make_shared<ExpressionPower>(
-            convertNonlinearNode(firstChildNode, destination), convertNonlinearNode(secondChildNode, destination));
-    }
-    else if(expressionType.compare("product") == 0)
-    {
-        NonlinearExpressions factors;
-
-        for(auto C = node->FirstChildElement(); C != nullptr; C = C->NextSiblingElement())
-            factors.push_back(convertNonlinearNode(C, destination));
-
-        switch(factors.size())
-        {
-        case 0:
-            return std::make_shared<ExpressionConstant>(0.);
-        case 1:
-            return factors[1];
-        default:
-            return std::make_shared<ExpressionProduct>(factors);
-        }
-    }
-    else if(expressionType.compare("abs") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-
-        return std::make_shared<ExpressionAbs>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("square") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        return std::make_shared<ExpressionSquare>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("sqrt") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        return std::make_shared<ExpressionSquareRoot>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("ln") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        return std::make_shared<ExpressionLog>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("exp") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        return std::make_shared<ExpressionExp>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("sin") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        return std::make_shared<ExpressionSin>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("cos") == 0)
-    {
-        auto firstChildNode = node->FirstChild();
-        return std::make_shared<ExpressionCos>(convertNonlinearNode(firstChildNode, destination));
-    }
-    else if(expressionType.compare("number") == 0)
-    {
-        return std::make_shared<ExpressionConstant>(std::stod(node->ToElement()->Attribute("value")));
-    }
-    else if(expressionType.compare("pi") == 0)
-    {
-        return std::make_shared<ExpressionConstant>(3.14159265);
-    }
-    else if(expressionType.compare("variable") == 0)
-    {
-        double coefficient
-            = (node->ToElement()->Attribute("coef") != NULL) ? std::stod(node->ToElement()->Attribute("coef")) : 1.0;
-
-        if(coefficient == 0.)
-            return std::make_shared<ExpressionConstant>(0.);
-
-        int variableIndex = std::stoi(node->ToElement()->Attribute("idx"));
-        auto variable = destination->getVariable(variableIndex);
-
-        if(variable->lowerBound == variable->upperBound)
-            return std::make_shared<ExpressionConstant>(coefficient * variable->lowerBound);
-
-        if(coefficient == 1.)
-            return std::make_shared<ExpressionVariable>(variable);
-
-        if(coefficient == -1.)
-            return std::make_shared<ExpressionNegate>(
-                std::make_shared<ExpressionVariable>(destination->getVariable(variableIndex)));
-
-        return std::make_shared<ExpressionProduct>(std::make_shared<ExpressionConstant>(coefficient),
-            std::make_shared<ExpressionVariable>(destination->getVariable(variableIndex)));
-    }
-    else
-    {
-        throw OperationNotImplementedException(fmt::format("Error: Unsupported OSiL function {}", expressionType));
-    }
-
-    return nullptr;
-}
-
 void ModelingSystemOSiL::finalizeSolution() { }
 
 } // Namespace SHOT
\ No newline at end of file
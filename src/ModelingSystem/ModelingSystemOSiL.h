@@ -18,17 +18,9 @@
 #include <memory>
 #include <string>
 
-namespace tinyxml2
-{
-class XMLNode;
-}
-
 namespace SHOT
 {
 
-class NonlinearExpression;
-using NonlinearExpressionPtr = std::shared_ptr<NonlinearExpression>;
-
 class ModelingSystemOSiL : public IModelingSystem
 {
 public:
@@ -46,9 +38,6 @@ public:
 
     // Move the solution and statistics from SHOT to the modeling system
     void finalizeSolution() override;
-
-private:
-    NonlinearExpressionPtr convertNonlinearNode(tinyxml2::XMLNode* node, const ProblemPtr& destination);
 };
 
 } // namespace SHOT
\ No newline at end of file
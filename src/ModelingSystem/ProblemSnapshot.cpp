@@ -0,0 +1,980 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "ProblemSnapshot.h"
+
+#include "../Output.h"
+#include "../Results.h"
+#include "../Settings.h"
+
+#include "../Model/AuxiliaryVariables.h"
+#include "../Model/Constraints.h"
+#include "../Model/NonlinearExpressions.h"
+#include "../Model/ObjectiveFunction.h"
+#include "../Model/Problem.h"
+#include "../Model/Terms.h"
+#include "../Model/Variables.h"
+
+#include "XMLStreamReader.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+namespace SHOT
+{
+
+namespace
+{
+
+constexpr char snapshotMagic[8] = { 'S', 'H', 'O', 'T', 'S', 'N', 'A', 'P' };
+constexpr uint32_t snapshotVersion = 1;
+constexpr uint32_t snapshotByteOrderMark = 0x01020304;
+
+// The property structs are stored as they are, so their layout must be the same when reading
+constexpr uint32_t snapshotLayout[] = { sizeof(VariableProperties), sizeof(ObjectiveFunctionProperties),
+    sizeof(ConstraintProperties), sizeof(E_VariableType), sizeof(int), sizeof(double) };
+
+enum class E_SnapshotFunctionKind : uint8_t
+{
+    Linear,
+    Quadratic,
+    Nonlinear
+};
+
+class SnapshotWriter
+{
+public:
+    template <typename T> void operator()(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void operator()(const std::string& value)
+    {
+        (*this)(static_cast<uint64_t>(value.size()));
+        buffer.append(value);
+    }
+
+    std::string buffer;
+};
+
+class SnapshotReader
+{
+public:
+    SnapshotReader(std::string_view contents) : contents(contents) { }
+
+    template <typename T> void operator()(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::memcpy(&value, take(sizeof(T)).data(), sizeof(T));
+    }
+
+    void operator()(std::string& value)
+    {
+        auto size = read<uint64_t>();
+        value = std::string(take(size));
+    }
+
+    template <typename T> T read()
+    {
+        T value;
+        (*this)(value);
+        return (value);
+    }
+
+private:
+    std::string_view contents;
+    size_t position = 0;
+
+    std::string_view take(uint64_t size)
+    {
+        if(size > contents.size() - position)
+            throw Exception("Unexpected end of problem snapshot.");
+
+        auto result = contents.substr(position, size);
+        position += size;
+
+        return (result);
+    }
+};
+
+// Used both when writing and reading, so that the order of the fields is the same
+template <typename Archive, typename Properties> void serializeProperties(Archive& archive, Properties& properties)
+{
+    archive(properties.isValid);
+    archive(properties.convexity);
+    archive(properties.isNonlinear);
+    archive(properties.isDiscrete);
+    archive(properties.isMINLPProblem);
+    archive(properties.isNLPProblem);
+    archive(properties.isMIQPProblem);
+    archive(properties.isQPProblem);
+    archive(properties.isMIQCQPProblem);
+    archive(properties.isQCQPProblem);
+    archive(properties.isMILPProblem);
+    archive(properties.isLPProblem);
+    archive(properties.numberOfVariables);
+    archive(properties.numberOfRealVariables);
+    archive(properties.numberOfDiscreteVariables);
+    archive(properties.numberOfBinaryVariables);
+    archive(properties.numberOfIntegerVariables);
+    archive(properties.numberOfSemicontinuousVariables);
+    archive(properties.numberOfSemiintegerVariables);
+    archive(properties.numberOfNonlinearVariables);
+    archive(properties.numberOfVariablesInNonlinearExpressions);
+    archive(properties.numberOfAuxiliaryVariables);
+    archive(properties.numberOfNumericConstraints);
+    archive(properties.numberOfLinearConstraints);
+    archive(properties.numberOfQuadraticConstraints);
+    archive(properties.numberOfConvexQuadraticConstraints);
+    archive(properties.numberOfNonconvexQuadraticConstraints);
+    archive(properties.numberOfNonlinearConstraints);
+    archive(properties.numberOfConvexNonlinearConstraints);
+    archive(properties.numberOfNonconvexNonlinearConstraints);
+    archive(properties.numberOfNonlinearExpressions);
+    archive(properties.numberOfSpecialOrderedSets);
+    archive(properties.numberOfAddedLinearizations);
+    archive(properties.name);
+    archive(properties.description);
+    archive(properties.isReformulated);
+}
+
+std::string getModelSettings(SettingsPtr settings)
+{
+    std::string result;
+
+    for(auto& S : settings->getChangedSettings())
+    {
+        if(S.compare(0, 6, "Model.") == 0)
+            result += S + '\n';
+    }
+
+    return (result);
+}
+
+bool isUnaryExpression(E_NonlinearExpressionTypes type)
+{
+    return (type >= E_NonlinearExpressionTypes::Negate && type <= E_NonlinearExpressionTypes::Abs);
+}
+
+bool isBinaryExpression(E_NonlinearExpressionTypes type)
+{
+    return (type == E_NonlinearExpressionTypes::Divide || type == E_NonlinearExpressionTypes::Power);
+}
+
+class ProblemWriter
+{
+public:
+    ProblemWriter(SnapshotWriter& writer) : writer(writer) { }
+
+    void write(Problem* problem)
+    {
+        writer(problem->name);
+        serializeProperties(writer, problem->properties);
+
+        writer(static_cast<uint64_t>(problem->allVariables.size()));
+
+        for(auto& V : problem->allVariables)
+        {
+            writer(V->name);
+            writer(static_cast<int32_t>(V->index));
+            writer(V->lowerBound);
+            writer(V->upperBound);
+            writer(V->semiBound);
+            writer(V->properties);
+        }
+
+        // The expression nodes are written before the functions referring to them
+        for(auto& V : problem->allVariables)
+        {
+            if(V->properties.isAuxiliary)
+                addExpression(std::static_pointer_cast<AuxiliaryVariable>(V)->nonlinearExpression.get());
+        }
+
+        if(auto objective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(problem->objectiveFunction))
+            addExpression(objective->nonlinearExpression.get());
+
+        for(auto& C : problem->nonlinearConstraints)
+            addExpression(C->nonlinearExpression.get());
+
+        writer(static_cast<uint64_t>(expressions.size()));
+
+        for(auto E : expressions)
+            writeExpression(E);
+
+        for(auto& V : problem->allVariables)
+        {
+            if(!V->properties.isAuxiliary)
+                continue;
+
+            auto auxiliaryVariable = std::static_pointer_cast<AuxiliaryVariable>(V);
+
+            writer(auxiliaryVariable->constant);
+            writeTerms(auxiliaryVariable->linearTerms);
+            writeTerms(auxiliaryVariable->quadraticTerms);
+            writeTerms(auxiliaryVariable->monomialTerms);
+            writeTerms(auxiliaryVariable->signomialTerms);
+            writeExpressionReference(auxiliaryVariable->nonlinearExpression.get());
+        }
+
+        writeObjective(problem->objectiveFunction);
+
+        for(auto& C : problem->linearConstraints)
+            constraintLists.emplace(C.get(), E_SnapshotFunctionKind::Linear);
+
+        for(auto& C : problem->quadraticConstraints)
+            constraintLists.emplace(C.get(), E_SnapshotFunctionKind::Quadratic);
+
+        for(auto& C : problem->nonlinearConstraints)
+            constraintLists.emplace(C.get(), E_SnapshotFunctionKind::Nonlinear);
+
+        writer(static_cast<uint64_t>(problem->numericConstraints.size()));
+
+        for(auto& C : problem->numericConstraints)
+            writeConstraint(C);
+
+        writer(static_cast<uint64_t>(problem->specialOrderedSets.size()));
+
+        for(auto& S : problem->specialOrderedSets)
+        {
+            writer(S->type);
+            writer(static_cast<uint64_t>(S->variables.size()));
+
+            for(auto& V : S->variables)
+                writer(static_cast<int32_t>(V->index));
+
+            writer(static_cast<uint64_t>(S->weights.size()));
+
+            for(auto W : S->weights)
+                writer(W);
+        }
+
+        writer(static_cast<int32_t>(
+            problem->antiEpigraphObjectiveVariable ? problem->antiEpigraphObjectiveVariable->index : -1));
+    }
+
+private:
+    SnapshotWriter& writer;
+
+    // The nodes in post-order, so that the children of a node are created before it when reading
+    std::vector<const NonlinearExpression*> expressions;
+    std::unordered_map<const NonlinearExpression*, int64_t> expressionIds;
+
+    // Which of the constraint lists in the problem that each constraint is in
+    std::unordered_map<const NumericConstraint*, E_SnapshotFunctionKind> constraintLists;
+
+    void addExpression(const NonlinearExpression* expression)
+    {
+        if(expression == nullptr || expressionIds.count(expression) > 0)
+            return;
+
+        auto type = expression->getType();
+
+        if(isUnaryExpression(type))
+        {
+            addExpression(static_cast<const ExpressionUnary*>(expression)->child.get());
+        }
+        else if(isBinaryExpression(type))
+        {
+            addExpression(static_cast<const ExpressionBinary*>(expression)->firstChild.get());
+            addExpression(static_cast<const ExpressionBinary*>(expression)->secondChild.get());
+        }
+        else if(type == E_NonlinearExpressionTypes::Sum || type == E_NonlinearExpressionTypes::Product)
+        {
+            for(auto& C : static_cast<const ExpressionGeneral*>(expression)->children)
+                addExpression(C.get());
+        }
+
+        expressionIds.emplace(expression, expressions.size());
+        expressions.push_back(expression);
+    }
+
+    void writeExpressionReference(const NonlinearExpression* expression)
+    {
+        writer(expression == nullptr ? static_cast<int64_t>(-1) : expressionIds.at(expression));
+    }
+
+    void writeExpression(const NonlinearExpression* expression)
+    {
+        auto type = expression->getType();
+        writer(type);
+
+        if(type == E_NonlinearExpressionTypes::Constant)
+        {
+            writer(static_cast<const ExpressionConstant*>(expression)->constant);
+        }
+        else if(type == E_NonlinearExpressionTypes::Variable)
+        {
+            writer(static_cast<int32_t>(static_cast<const ExpressionVariable*>(expression)->variable->index));
+        }
+        else if(isUnaryExpression(type))
+        {
+            writeExpressionReference(static_cast<const ExpressionUnary*>(expression)->child.get());
+        }
+        else if(isBinaryExpression(type))
+        {
+            writeExpressionReference(static_cast<const ExpressionBinary*>(expression)->firstChild.get());
+            writeExpressionReference(static_cast<const ExpressionBinary*>(expression)->secondChild.get());
+        }
+        else
+        {
+            auto& children = static_cast<const ExpressionGeneral*>(expression)->children;
+            writer(static_cast<uint64_t>(children.size()));
+
+            for(auto& C : children)
+                writeExpressionReference(C.get());
+        }
+    }
+
+    void writeTerms(const LinearTerms& terms)
+    {
+        writer(static_cast<uint64_t>(terms.size()));
+
+        for(auto& T : terms)
+        {
+            writer(T->coefficient);
+            writer(static_cast<int32_t>(T->variable->index));
+        }
+    }
+
+    void writeTerms(const QuadraticTerms& terms)
+    {
+        writer(static_cast<uint64_t>(terms.size()));
+
+        for(auto& T : terms)
+        {
+            writer(T->coefficient);
+            writer(static_cast<int32_t>(T->firstVariable->index));
+            writer(static_cast<int32_t>(T->secondVariable->index));
+        }
+    }
+
+    void writeTerms(const MonomialTerms& terms)
+    {
+        writer(static_cast<uint64_t>(terms.size()));
+
+        for(auto& T : terms)
+        {
+            writer(T->coefficient);
+            writer(static_cast<uint64_t>(T->variables.size()));
+
+            for(auto& V : T->variables)
+                writer(static_cast<int32_t>(V->index));
+        }
+    }
+
+    void writeTerms(const SignomialTerms& terms)
+    {
+        writer(static_cast<uint64_t>(terms.size()));
+
+        for(auto& T : terms)
+        {
+            writer(T->coefficient);
+            writer(static_cast<uint64_t>(T->elements.size()));
+
+            for(auto& E : T->elements)
+            {
+                writer(static_cast<int32_t>(E->variable->index));
+                writer(E->power);
+            }
+        }
+    }
+
+    void writeObjective(const ObjectiveFunctionPtr& objective)
+    {
+        auto linearObjective = std::dynamic_pointer_cast<LinearObjectiveFunction>(objective);
+        auto quadraticObjective = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(objective);
+        auto nonlinearObjective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objective);
+
+        if(nonlinearObjective)
+            writer(E_SnapshotFunctionKind::Nonlinear);
+        else if(quadraticObjective)
+            writer(E_SnapshotFunctionKind::Quadratic);
+        else if(linearObjective)
+            writer(E_SnapshotFunctionKind::Linear);
+        else
+            throw Exception("Objective function type not supported in problem snapshot.");
+
+        writer(objective->direction);
+        writer(objective->constant);
+        writer(objective->properties);
+
+        writeTerms(linearObjective->linearTerms);
+
+        if(quadraticObjective)
+            writeTerms(quadraticObjective->quadraticTerms);
+
+        if(nonlinearObjective)
+        {
+            writeTerms(nonlinearObjective->monomialTerms);
+            writeTerms(nonlinearObjective->signomialTerms);
+            writeExpressionReference(nonlinearObjective->nonlinearExpression.get());
+        }
+    }
+
+    void writeConstraint(const NumericConstraintPtr& constraint)
+    {
+        auto linearConstraint = std::dynamic_pointer_cast<LinearConstraint>(constraint);
+        auto quadraticConstraint = std::dynamic_pointer_cast<QuadraticConstraint>(constraint);
+        auto nonlinearConstraint = std::dynamic_pointer_cast<NonlinearConstraint>(constraint);
+
+        if(nonlinearConstraint)
+            writer(E_SnapshotFunctionKind::Nonlinear);
+        else if(quadraticConstraint)
+            writer(E_SnapshotFunctionKind::Quadratic);
+        else if(linearConstraint)
+            writer(E_SnapshotFunctionKind::Linear);
+        else
+            throw Exception("Constraint type not supported in problem snapshot.");
+
+        writer(constraintLists.at(constraint.get()));
+        writer(constraint->name);
+        writer(constraint->valueLHS);
+        writer(constraint->valueRHS);
+        writer(constraint->constant);
+        writer(constraint->properties);
+
+        writeTerms(linearConstraint->linearTerms);
+
+        if(quadraticConstraint)
+            writeTerms(quadraticConstraint->quadraticTerms);
+
+        if(nonlinearConstraint)
+        {
+            writeTerms(nonlinearConstraint->monomialTerms);
+            writeTerms(nonlinearConstraint->signomialTerms);
+            writeExpressionReference(nonlinearConstraint->nonlinearExpression.get());
+        }
+    }
+};
+
+class ProblemReader
+{
+public:
+    ProblemReader(SnapshotReader& reader, ProblemPtr problem) : reader(reader), problem(problem) { }
+
+    void read()
+    {
+        reader(problem->name);
+
+        ProblemProperties properties;
+        serializeProperties(reader, properties);
+
+        auto numberOfVariables = reader.read<uint64_t>();
+        std::vector<VariableProperties> variableProperties(numberOfVariables);
+
+        for(uint64_t i = 0; i < numberOfVariables; i++)
+        {
+            auto name = reader.read<std::string>();
+            auto index = reader.read<int32_t>();
+            auto lowerBound = reader.read<double>();
+            auto upperBound = reader.read<double>();
+            auto semiBound = reader.read<double>();
+            reader(variableProperties[i]);
+
+            if(index != static_cast<int32_t>(i))
+                throw Exception(fmt::format("Wrong index for variable {} in problem snapshot.", name));
+
+            auto type = variableProperties[i].type;
+
+            if(variableProperties[i].isAuxiliary)
+            {
+                auto variable = problem->arena.create<AuxiliaryVariable>(name, index, type, lowerBound, upperBound);
+                variable->semiBound = semiBound;
+                variable->properties.auxiliaryType = variableProperties[i].auxiliaryType;
+                problem->add(std::move(variable));
+            }
+            else
+            {
+                auto variable
+                    = problem->arena.create<Variable>(name, index, type, lowerBound, upperBound, semiBound);
+                problem->add(std::move(variable));
+            }
+
+            // The bounds are not kept for binary variables by the constructors
+            problem->allVariables[i]->lowerBound = lowerBound;
+            problem->allVariables[i]->upperBound = upperBound;
+        }
+
+        auto numberOfExpressions = reader.read<uint64_t>();
+
+        if(numberOfExpressions > SIZE_MAX / sizeof(NonlinearExpressionPtr))
+            throw Exception("Too many nonlinear expressions in problem snapshot.");
+
+        expressions.reserve(numberOfExpressions);
+
+        for(uint64_t i = 0; i < numberOfExpressions; i++)
+            expressions.push_back(readExpression());
+
+        for(auto& V : problem->allVariables)
+        {
+            if(!V->properties.isAuxiliary)
+                continue;
+
+            auto auxiliaryVariable = std::static_pointer_cast<AuxiliaryVariable>(V);
+
+            reader(auxiliaryVariable->constant);
+            auxiliaryVariable->linearTerms = readLinearTerms();
+            auxiliaryVariable->quadraticTerms = readQuadraticTerms();
+            auxiliaryVariable->monomialTerms = readMonomialTerms();
+            auxiliaryVariable->signomialTerms = readSignomialTerms();
+            auxiliaryVariable->nonlinearExpression = readExpressionReference();
+        }
+
+        ObjectiveFunctionProperties objectiveProperties;
+        readObjective(objectiveProperties);
+
+        auto numberOfConstraints = reader.read<uint64_t>();
+        std::vector<ConstraintProperties> constraintProperties(numberOfConstraints);
+
+        for(uint64_t i = 0; i < numberOfConstraints; i++)
+            readConstraint(i, constraintProperties[i]);
+
+        auto numberOfSpecialOrderedSets = reader.read<uint64_t>();
+
+        for(uint64_t i = 0; i < numberOfSpecialOrderedSets; i++)
+        {
+            auto orderedSet = std::make_shared<SpecialOrderedSet>();
+            reader(orderedSet->type);
+
+            auto numberOfSetVariables = reader.read<uint64_t>();
+
+            for(uint64_t j = 0; j < numberOfSetVariables; j++)
+                orderedSet->variables.push_back(readVariable());
+
+            auto numberOfWeights = reader.read<uint64_t>();
+
+            for(uint64_t j = 0; j < numberOfWeights; j++)
+                orderedSet->weights.push_back(reader.read<double>());
+
+            problem->add(std::move(orderedSet));
+        }
+
+        if(auto index = reader.read<int32_t>(); index != -1)
+            problem->antiEpigraphObjectiveVariable = problem->getVariable(index);
+
+        problem->properties.isReformulated = properties.isReformulated;
+
+        // This also creates the factorable functions and tapes, which refer to the new objects
+        problem->finalize();
+
+        // The properties are restored, since they were e.g. determined before the bounds were tightened
+        problem->properties = properties;
+        problem->objectiveFunction->properties = objectiveProperties;
+
+        for(uint64_t i = 0; i < numberOfVariables; i++)
+        {
+            auto& variable = problem->allVariables[i];
+
+            variable->properties.type = variableProperties[i].type;
+            variable->properties.hasLowerBoundBeenTightened = variableProperties[i].hasLowerBoundBeenTightened;
+            variable->properties.hasUpperBoundBeenTightened = variableProperties[i].hasUpperBoundBeenTightened;
+        }
+
+        for(uint64_t i = 0; i < numberOfConstraints; i++)
+            problem->numericConstraints[i]->properties = constraintProperties[i];
+    }
+
+private:
+    SnapshotReader& reader;
+    ProblemPtr problem;
+
+    std::vector<NonlinearExpressionPtr> expressions;
+
+    VariablePtr readVariable()
+    {
+        auto index = reader.read<int32_t>();
+
+        if(index < 0 || index >= static_cast<int32_t>(problem->allVariables.size()))
+            throw Exception(fmt::format("Variable index {} out of range in problem snapshot.", index));
+
+        return (problem->allVariables[index]);
+    }
+
+    NonlinearExpressionPtr readExpressionReference()
+    {
+        auto id = reader.read<int64_t>();
+
+        if(id == -1)
+            return (nullptr);
+
+        if(id < 0 || id >= static_cast<int64_t>(expressions.size()))
+            throw Exception(fmt::format("Nonlinear expression {} out of range in problem snapshot.", id));
+
+        return (expressions[id]);
+    }
+
+    NonlinearExpressionPtr readExpression()
+    {
+        auto type = reader.read<E_NonlinearExpressionTypes>();
+
+        switch(type)
+        {
+        case E_NonlinearExpressionTypes::Constant:
+            return (problem->arena.create<ExpressionConstant>(reader.read<double>()));
+        case E_NonlinearExpressionTypes::Variable:
+            return (problem->arena.create<ExpressionVariable>(readVariable()));
+        case E_NonlinearExpressionTypes::Negate:
+            return (problem->arena.create<ExpressionNegate>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Invert:
+            return (problem->arena.create<ExpressionInvert>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::SquareRoot:
+            return (problem->arena.create<ExpressionSquareRoot>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Log:
+            return (problem->arena.create<ExpressionLog>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Exp:
+            return (problem->arena.create<ExpressionExp>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Square:
+            return (problem->arena.create<ExpressionSquare>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Cos:
+            return (problem->arena.create<ExpressionCos>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Sin:
+            return (problem->arena.create<ExpressionSin>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Tan:
+            return (problem->arena.create<ExpressionTan>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::ArcCos:
+            return (problem->arena.create<ExpressionArcCos>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::ArcSin:
+            return (problem->arena.create<ExpressionArcSin>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::ArcTan:
+            return (problem->arena.create<ExpressionArcTan>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Abs:
+            return (problem->arena.create<ExpressionAbs>(readExpressionReference()));
+        case E_NonlinearExpressionTypes::Divide:
+        {
+            auto firstChild = readExpressionReference();
+            return (problem->arena.create<ExpressionDivide>(firstChild, readExpressionReference()));
+        }
+        case E_NonlinearExpressionTypes::Power:
+        {
+            auto firstChild = readExpressionReference();
+            return (problem->arena.create<ExpressionPower>(firstChild, readExpressionReference()));
+        }
+        case E_NonlinearExpressionTypes::Sum:
+            return (problem->arena.create<ExpressionSum>(readExpressionReferences()));
+        case E_NonlinearExpressionTypes::Product:
+            return (problem->arena.create<ExpressionProduct>(readExpressionReferences()));
+        default:
+            throw Exception("Unknown nonlinear expression type in problem snapshot.");
+        }
+    }
+
+    NonlinearExpressions readExpressionReferences()
+    {
+        NonlinearExpressions children;
+        auto numberOfChildren = reader.read<uint64_t>();
+
+        for(uint64_t i = 0; i < numberOfChildren; i++)
+            children.push_back(readExpressionReference());
+
+        return (children);
+    }
+
+    LinearTerms readLinearTerms()
+    {
+        LinearTerms terms;
+        auto numberOfTerms = reader.read<uint64_t>();
+
+        for(uint64_t i = 0; i < numberOfTerms; i++)
+        {
+            auto coefficient = reader.read<double>();
+            terms.add(problem->arena.create<LinearTerm>(coefficient, readVariable()));
+        }
+
+        return (terms);
+    }
+
+    QuadraticTerms readQuadraticTerms()
+    {
+        QuadraticTerms terms;
+        auto numberOfTerms = reader.read<uint64_t>();
+
+        for(uint64_t i = 0; i < numberOfTerms; i++)
+        {
+            auto coefficient = reader.read<double>();
+            auto firstVariable = readVariable();
+            auto secondVariable = readVariable();
+
+            terms.add(problem->arena.create<QuadraticTerm>(coefficient, firstVariable, secondVariable));
+        }
+
+        return (terms);
+    }
+
+    MonomialTerms readMonomialTerms()
+    {
+        MonomialTerms terms;
+        auto numberOfTerms = reader.read<uint64_t>();
+
+        for(uint64_t i = 0; i < numberOfTerms; i++)
+        {
+            auto coefficient = reader.read<double>();
+            auto numberOfVariables = reader.read<uint64_t>();
+
+            Variables variables;
+
+            for(uint64_t j = 0; j < numberOfVariables; j++)
+                variables.push_back(readVariable());
+
+            terms.add(problem->arena.create<MonomialTerm>(coefficient, variables));
+        }
+
+        return (terms);
+    }
+
+    SignomialTerms readSignomialTerms()
+    {
+        SignomialTerms terms;
+        auto numberOfTerms = reader.read<uint64_t>();
+
+        for(uint64_t i = 0; i < numberOfTerms; i++)
+        {
+            auto coefficient = reader.read<double>();
+            auto numberOfElements = reader.read<uint64_t>();
+
+            SignomialElements elements;
+
+            for(uint64_t j = 0; j < numberOfElements; j++)
+            {
+                auto variable = readVariable();
+                elements.push_back(problem->arena.create<SignomialElement>(variable, reader.read<double>()));
+            }
+
+            terms.add(problem->arena.create<SignomialTerm>(coefficient, elements));
+        }
+
+        return (terms);
+    }
+
+    void readObjective(ObjectiveFunctionProperties& properties)
+    {
+        auto kind = reader.read<E_SnapshotFunctionKind>();
+
+        std::shared_ptr<LinearObjectiveFunction> objective;
+
+        if(kind == E_SnapshotFunctionKind::Linear)
+            objective = std::make_shared<LinearObjectiveFunction>();
+        else if(kind == E_SnapshotFunctionKind::Quadratic)
+            objective = std::make_shared<QuadraticObjectiveFunction>();
+        else if(kind == E_SnapshotFunctionKind::Nonlinear)
+            objective = std::make_shared<NonlinearObjectiveFunction>();
+        else
+            throw Exception("Unknown objective function type in problem snapshot.");
+
+        reader(objective->direction);
+        reader(objective->constant);
+        reader(properties);
+
+        objective->add(readLinearTerms());
+
+        if(auto quadraticObjective = std::dynamic_pointer_cast<QuadraticObjectiveFunction>(objective))
+            quadraticObjective->add(readQuadraticTerms());
+
+        if(auto nonlinearObjective = std::dynamic_pointer_cast<NonlinearObjectiveFunction>(objective))
+        {
+            nonlinearObjective->add(readMonomialTerms());
+            nonlinearObjective->add(readSignomialTerms());
+
+            if(auto expression = readExpressionReference())
+                nonlinearObjective->add(expression);
+        }
+
+        problem->add(std::dynamic_pointer_cast<ObjectiveFunction>(objective));
+    }
+
+    void readConstraint(uint64_t index, ConstraintProperties& properties)
+    {
+        auto kind = reader.read<E_SnapshotFunctionKind>();
+        auto list = reader.read<E_SnapshotFunctionKind>();
+        auto name = reader.read<std::string>();
+        auto valueLHS = reader.read<double>();
+        auto valueRHS = reader.read<double>();
+
+        std::shared_ptr<LinearConstraint> constraint;
+
+        if(kind == E_SnapshotFunctionKind::Linear)
+            constraint = std::make_shared<LinearConstraint>(index, name, valueLHS, valueRHS);
+        else if(kind == E_SnapshotFunctionKind::Quadratic)
+            constraint = std::make_shared<QuadraticConstraint>(index, name, valueLHS, valueRHS);
+        else if(kind == E_SnapshotFunctionKind::Nonlinear)
+            constraint = std::make_shared<NonlinearConstraint>(index, name, valueLHS, valueRHS);
+        else
+            throw Exception(fmt::format("Unknown type of constraint {} in problem snapshot.", name));
+
+        auto quadraticConstraint = std::dynamic_pointer_cast<QuadraticConstraint>(constraint);
+        auto nonlinearConstraint = std::dynamic_pointer_cast<NonlinearConstraint>(constraint);
+
+        reader(constraint->constant);
+        reader(properties);
+
+        constraint->add(readLinearTerms());
+
+        if(quadraticConstraint)
+            quadraticConstraint->add(readQuadraticTerms());
+
+        if(nonlinearConstraint)
+        {
+            nonlinearConstraint->add(readMonomialTerms());
+            nonlinearConstraint->add(readSignomialTerms());
+
+            if(auto expression = readExpressionReference())
+                nonlinearConstraint->add(expression);
+        }
+
+        // Added to the same list as before, which does not only depend on the type of the constraint
+        if(list == E_SnapshotFunctionKind::Linear)
+            problem->add(constraint);
+        else if(list == E_SnapshotFunctionKind::Quadratic && quadraticConstraint)
+            problem->add(quadraticConstraint);
+        else if(list == E_SnapshotFunctionKind::Nonlinear && nonlinearConstraint)
+            problem->add(nonlinearConstraint);
+        else
+            throw Exception(fmt::format("Wrong type of constraint {} in problem snapshot.", name));
+    }
+};
+} // namespace
+
+ProblemSnapshot::ProblemSnapshot(EnvironmentPtr envPtr) : env(envPtr) { }
+
+bool ProblemSnapshot::write(const std::string& filename)
+{
+    if(!env->problem || !env->reformulatedProblem)
+    {
+        env->output->outputError(" Cannot write problem snapshot, since there is no reformulated problem.");
+        return (false);
+    }
+
+    try
+    {
+        SnapshotWriter writer;
+
+        writer.buffer.append(snapshotMagic, sizeof(snapshotMagic));
+        writer(snapshotVersion);
+        writer(snapshotByteOrderMark);
+        writer(snapshotLayout);
+
+        writer(getModelSettings(env->settings));
+
+        ProblemWriter(writer).write(env->problem.get());
+
+        // The problem is not reformulated if they are the same
+        bool isSameProblem = (env->problem == env->reformulatedProblem);
+        writer(isSameProblem);
+
+        if(!isSameProblem)
+            ProblemWriter(writer).write(env->reformulatedProblem.get());
+
+        writer(static_cast<uint64_t>(env->results->auxiliaryVariablesIntroduced.size()));
+
+        for(auto& [type, number] : env->results->auxiliaryVariablesIntroduced)
+        {
+            writer(type);
+            writer(static_cast<int32_t>(number));
+        }
+
+        std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+        file.write(writer.buffer.data(), writer.buffer.size());
+
+        if(!file)
+        {
+            env->output->outputError(fmt::format(" Could not write problem snapshot to file {}.", filename));
+            return (false);
+        }
+    }
+    catch(const std::exception& e)
+    {
+        env->output->outputError(fmt::format(" Error when writing problem snapshot: {}", e.what()));
+        return (false);
+    }
+
+    env->output->outputDebug(fmt::format(" Problem snapshot written to file {}.", filename));
+
+    return (true);
+}
+
+bool ProblemSnapshot::read(const std::string& filename)
+{
+    MappedFile file;
+
+    if(!file.open(filename))
+    {
+        env->output->outputError(fmt::format(" Could not open problem snapshot {}.", filename));
+        return (false);
+    }
+
+    try
+    {
+        auto contents = file.getContents();
+
+        if(contents.size() < sizeof(snapshotMagic)
+            || contents.compare(0, sizeof(snapshotMagic), std::string_view(snapshotMagic, sizeof(snapshotMagic)))
+                != 0)
+            throw Exception("The file is not a problem snapshot.");
+
+        SnapshotReader reader(contents.substr(sizeof(snapshotMagic)));
+
+        if(auto version = reader.read<uint32_t>(); version != snapshotVersion)
+            throw Exception(
+                fmt::format("Snapshot version {} is not supported, expected {}.", version, snapshotVersion));
+
+        if(reader.read<uint32_t>() != snapshotByteOrderMark)
+            throw Exception("The snapshot was written on a platform with a different byte order.");
+
+        uint32_t layout[std::size(snapshotLayout)];
+        reader(layout);
+
+        if(std::memcmp(layout, snapshotLayout, sizeof(snapshotLayout)) != 0)
+            throw Exception("The snapshot was written by an incompatible build of SHOT.");
+
+        auto modelSettings = reader.read<std::string>();
+
+        if(modelSettings != getModelSettings(env->settings))
+            env->output->outputWarning(" The model settings differ from those used when writing the problem snapshot.");
+
+        auto readProblem = std::make_shared<Problem>(env);
+        ProblemReader(reader, readProblem).read();
+
+        ProblemPtr readReformulatedProblem = readProblem;
+
+        if(!reader.read<bool>())
+        {
+            readReformulatedProblem = std::make_shared<Problem>(env);
+            ProblemReader(reader, readReformulatedProblem).read();
+        }
+
+        std::map<E_AuxiliaryVariableType, int> readAuxiliaryVariables;
+        auto numberOfTypes = reader.read<uint64_t>();
+
+        for(uint64_t i = 0; i < numberOfTypes; i++)
+        {
+            auto type = reader.read<E_AuxiliaryVariableType>();
+            readAuxiliaryVariables[type] = reader.read<int32_t>();
+        }
+
+        problem = readProblem;
+        reformulatedProblem = readReformulatedProblem;
+        auxiliaryVariablesIntroduced = readAuxiliaryVariables;
+    }
+    catch(const std::exception& e)
+    {
+        env->output->outputError(fmt::format(" Error when reading problem snapshot {}: {}", filename, e.what()));
+        return (false);
+    }
+
+    return (true);
+}
+} // namespace SHOT
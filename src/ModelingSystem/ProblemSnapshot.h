@@ -0,0 +1,52 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "../Environment.h"
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace SHOT
+{
+
+// A binary file with the original and the reformulated problem after the reformulation and bound tightening, so that
+// a model that is solved many times only needs to be parsed and reformulated once. Reading the snapshot recreates the
+// problems from the memory-mapped file and finalizes them, after which the stored properties, e.g. the convexity, are
+// restored. The format is versioned and only read by a build of SHOT with the same version and byte order.
+class ProblemSnapshot
+{
+public:
+    ProblemSnapshot(EnvironmentPtr envPtr);
+
+    // Writes the original and the reformulated problem in the environment
+    bool write(const std::string& filename);
+
+    // Reads the problems, which are not set in the environment, e.g. use Solver::setProblem(ProblemSnapshotPtr)
+    bool read(const std::string& filename);
+
+    ProblemPtr problem;
+    ProblemPtr reformulatedProblem;
+
+    std::map<E_AuxiliaryVariableType, int> auxiliaryVariablesIntroduced;
+
+    static constexpr const char* fileExtension = ".shotsnap";
+
+private:
+    EnvironmentPtr env;
+};
+
+using ProblemSnapshotPtr = std::shared_ptr<ProblemSnapshot>;
+
+} // namespace SHOT
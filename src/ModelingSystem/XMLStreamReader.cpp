@@ -0,0 +1,408 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "XMLStreamReader.h"
+
+#include "../Structs.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace SHOT
+{
+
+static inline bool isWhitespace(char character)
+{
+    return (character == ' ' || character == '\t' || character == '\n' || character == '\r');
+}
+
+static std::string_view trimWhitespace(std::string_view value)
+{
+    while(!value.empty() && isWhitespace(value.front()))
+        value.remove_prefix(1);
+
+    while(!value.empty() && isWhitespace(value.back()))
+        value.remove_suffix(1);
+
+    return (value);
+}
+
+MappedFile::~MappedFile()
+{
+#ifndef _WIN32
+    if(isMapped)
+        munmap(const_cast<char*>(data), size);
+#endif
+}
+
+bool MappedFile::open(const std::string& filename)
+{
+#ifndef _WIN32
+    int fileDescriptor = ::open(filename.c_str(), O_RDONLY);
+
+    if(fileDescriptor == -1)
+        return (false);
+
+    struct stat fileStatus;
+
+    if(fstat(fileDescriptor, &fileStatus) == 0 && fileStatus.st_size > 0)
+    {
+        void* address = mmap(nullptr, fileStatus.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+        if(address != MAP_FAILED)
+        {
+            // The file is read from the beginning to the end
+            madvise(address, fileStatus.st_size, MADV_SEQUENTIAL);
+
+            data = static_cast<const char*>(address);
+            size = fileStatus.st_size;
+            isMapped = true;
+        }
+    }
+
+    close(fileDescriptor);
+
+    if(isMapped)
+        return (true);
+#endif
+
+    std::ifstream file(filename, std::ios::binary);
+
+    if(!file)
+        return (false);
+
+    std::ostringstream stream;
+    stream << file.rdbuf();
+    buffer = stream.str();
+
+    data = buffer.data();
+    size = buffer.size();
+
+    return (true);
+}
+
+XMLStreamReader::E_Event XMLStreamReader::next()
+{
+    if(isEndOfEmptyElementPending)
+    {
+        isEndOfEmptyElementPending = false;
+        depth--;
+        return (E_Event::EndElement);
+    }
+
+    while(position < contents.size())
+    {
+        if(contents[position] != '<')
+        {
+            size_t end = contents.find('<', position);
+
+            if(end == std::string_view::npos)
+                end = contents.size();
+
+            text = trimWhitespace(contents.substr(position, end - position));
+            position = end;
+
+            if(!text.empty())
+                return (E_Event::Text);
+
+            continue;
+        }
+
+        auto remaining = contents.substr(position);
+
+        if(remaining.compare(0, 2, "<?") == 0)
+        {
+            skipPast("?>");
+        }
+        else if(remaining.compare(0, 4, "<!--") == 0)
+        {
+            skipPast("-->");
+        }
+        else if(remaining.compare(0, 9, "<![CDATA[") == 0)
+        {
+            size_t start = position + 9;
+            skipPast("]]>");
+            text = trimWhitespace(contents.substr(start, position - 3 - start));
+
+            if(!text.empty())
+                return (E_Event::Text);
+        }
+        else if(remaining.compare(0, 2, "<!") == 0)
+        {
+            skipPast(">");
+        }
+        else if(remaining.compare(0, 2, "</") == 0)
+        {
+            position += 2;
+            name = readName();
+            skipPast(">");
+            depth--;
+
+            return (E_Event::EndElement);
+        }
+        else
+        {
+            position += 1;
+            name = readName();
+            readAttributes();
+            depth++;
+
+            return (E_Event::StartElement);
+        }
+    }
+
+    if(depth > 0)
+        throw Exception("Unexpected end of XML file.");
+
+    return (E_Event::EndOfDocument);
+}
+
+std::optional<std::string_view> XMLStreamReader::getAttribute(std::string_view attributeName) const
+{
+    for(auto& A : attributes)
+    {
+        if(A.first == attributeName)
+            return (A.second);
+    }
+
+    return (std::nullopt);
+}
+
+std::optional<std::string> XMLStreamReader::getAttributeString(std::string_view attributeName) const
+{
+    if(auto value = getAttribute(attributeName))
+        return (replaceEntities(*value));
+
+    return (std::nullopt);
+}
+
+std::string_view XMLStreamReader::readElementText()
+{
+    std::string_view elementText;
+
+    for(auto event = next(); event != E_Event::EndElement; event = next())
+    {
+        if(event == E_Event::Text)
+            elementText = text;
+        else
+            throw Exception(fmt::format("Unexpected element in text at position {} in XML file.", position));
+    }
+
+    return (elementText);
+}
+
+void XMLStreamReader::skipElement()
+{
+    // The current element is included in the depth
+    int elementDepth = depth;
+
+    while(depth >= elementDepth)
+        next();
+}
+
+std::string XMLStreamReader::replaceEntities(std::string_view value)
+{
+    if(value.find('&') == std::string_view::npos)
+        return (std::string(value));
+
+    std::string result;
+    result.reserve(value.size());
+
+    for(size_t i = 0; i < value.size(); i++)
+    {
+        size_t end = (value[i] == '&') ? value.find(';', i) : std::string_view::npos;
+
+        if(end == std::string_view::npos)
+        {
+            result.push_back(value[i]);
+            continue;
+        }
+
+        auto entity = value.substr(i + 1, end - i - 1);
+
+        if(entity == "amp")
+            result.push_back('&');
+        else if(entity == "lt")
+            result.push_back('<');
+        else if(entity == "gt")
+            result.push_back('>');
+        else if(entity == "quot")
+            result.push_back('"');
+        else if(entity == "apos")
+            result.push_back('\'');
+        else if(entity.size() > 1 && entity[0] == '#')
+        {
+            unsigned int code = 0;
+            bool isHexadecimal = entity[1] == 'x';
+            auto digits = entity.substr(isHexadecimal ? 2 : 1);
+
+            std::from_chars(digits.data(), digits.data() + digits.size(), code, isHexadecimal ? 16 : 10);
+
+            // Encoded as UTF-8
+            if(code < 0x80)
+            {
+                result.push_back(static_cast<char>(code));
+            }
+            else if(code < 0x800)
+            {
+                result.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else if(code < 0x10000)
+            {
+                result.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+            else
+            {
+                result.push_back(static_cast<char>(0xF0 | (code >> 18)));
+                result.push_back(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                result.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+            }
+        }
+        else
+        {
+            // Not an entity that is known, so it is kept as is
+            result.append(value.substr(i, end - i + 1));
+        }
+
+        i = end;
+    }
+
+    return (result);
+}
+
+double XMLStreamReader::parseDouble(std::string_view value)
+{
+    value = trimWhitespace(value);
+
+    // Not accepted by std::from_chars
+    if(!value.empty() && value.front() == '+')
+        value.remove_prefix(1);
+
+    double result = 0.0;
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+
+    // Rare, so the value is converted again to get the infinite or denormalized value instead
+    if(error == std::errc::result_out_of_range && end == value.data() + value.size())
+        return (std::strtod(std::string(value).c_str(), nullptr));
+
+    if(error != std::errc() || end != value.data() + value.size() || value.empty())
+        throw Exception(fmt::format("Could not parse the number \"{}\" in XML file.", value));
+
+    return (result);
+}
+
+int XMLStreamReader::parseInteger(std::string_view value)
+{
+    value = trimWhitespace(value);
+
+    if(!value.empty() && value.front() == '+')
+        value.remove_prefix(1);
+
+    int result = 0;
+    auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), result);
+
+    if(error != std::errc() || end != value.data() + value.size() || value.empty())
+        throw Exception(fmt::format("Could not parse the integer \"{}\" in XML file.", value));
+
+    return (result);
+}
+
+void XMLStreamReader::skipPast(std::string_view delimiter)
+{
+    size_t end = contents.find(delimiter, position);
+
+    if(end == std::string_view::npos)
+        throw Exception("Unexpected end of XML file.");
+
+    position = end + delimiter.size();
+}
+
+void XMLStreamReader::skipWhitespace()
+{
+    while(position < contents.size() && isWhitespace(contents[position]))
+        position++;
+}
+
+std::string_view XMLStreamReader::readName()
+{
+    size_t start = position;
+
+    while(position < contents.size() && !isWhitespace(contents[position]) && contents[position] != '>'
+        && contents[position] != '/' && contents[position] != '=')
+        position++;
+
+    if(position == start)
+        throw Exception(fmt::format("Missing name at position {} in XML file.", start));
+
+    return (contents.substr(start, position - start));
+}
+
+void XMLStreamReader::readAttributes()
+{
+    attributes.clear();
+
+    while(true)
+    {
+        skipWhitespace();
+
+        if(position >= contents.size())
+            throw Exception("Unexpected end of XML file.");
+
+        if(contents[position] == '>')
+        {
+            position++;
+            return;
+        }
+
+        if(contents[position] == '/')
+        {
+            skipPast(">");
+            isEndOfEmptyElementPending = true;
+            return;
+        }
+
+        auto attributeName = readName();
+        skipWhitespace();
+
+        if(position >= contents.size() || contents[position] != '=')
+            throw Exception(fmt::format("Missing value for attribute at position {} in XML file.", position));
+
+        position++;
+        skipWhitespace();
+
+        if(position >= contents.size() || (contents[position] != '"' && contents[position] != '\''))
+            throw Exception(fmt::format("Missing quote for attribute at position {} in XML file.", position));
+
+        char quote = contents[position];
+        size_t end = contents.find(quote, position + 1);
+
+        if(end == std::string_view::npos)
+            throw Exception("Unexpected end of XML file.");
+
+        attributes.emplace_back(attributeName, contents.substr(position + 1, end - position - 1));
+        position = end + 1;
+    }
+}
+} // namespace SHOT
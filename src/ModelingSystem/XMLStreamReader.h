@@ -0,0 +1,108 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// A read-only view of the contents of a file. The file is memory-mapped where supported, so that the operating system
+// pages it in as it is read instead of the whole file being copied into memory.
+class MappedFile
+{
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& filename);
+
+    inline std::string_view getContents() const { return (std::string_view(data, size)); }
+
+private:
+    const char* data = nullptr;
+    size_t size = 0;
+    bool isMapped = false;
+
+    std::string buffer; // Used if the file cannot be mapped
+};
+
+// A pull parser for XML that reads one element start, element end or text at a time from a buffer, without building a
+// document tree. Names, attributes and texts are views into the buffer, so they are valid as long as the buffer is.
+// Self-closing elements give both a start and an end event, and the end of the document is only given after the end
+// of all elements. Throws SHOT::Exception if the document is malformed.
+class XMLStreamReader
+{
+public:
+    enum class E_Event
+    {
+        StartElement,
+        EndElement,
+        Text,
+        EndOfDocument
+    };
+
+    XMLStreamReader(std::string_view contents) : contents(contents) { }
+
+    E_Event next();
+
+    // The name of the current start or end element
+    inline std::string_view getName() const { return (name); }
+
+    // The raw value of an attribute of the current start element, with the entities not replaced
+    std::optional<std::string_view> getAttribute(std::string_view attributeName) const;
+
+    // The value of an attribute of the current start element with the entities replaced
+    std::optional<std::string> getAttributeString(std::string_view attributeName) const;
+
+    // The current text, with surrounding whitespace removed
+    inline std::string_view getText() const { return (text); }
+
+    // Reads the text of the current start element up to its end element, which must not have child elements
+    std::string_view readElementText();
+
+    // Reads past the end of the current start element, including all of its children
+    void skipElement();
+
+    // The position in the buffer, e.g. for error messages
+    inline size_t getPosition() const { return (position); }
+
+    static std::string replaceEntities(std::string_view value);
+
+    // Parse numbers with std::from_chars, which neither allocates nor depends on the locale. Surrounding whitespace
+    // is allowed, and throws SHOT::Exception if the whole value is not a number.
+    static double parseDouble(std::string_view value);
+    static int parseInteger(std::string_view value);
+
+private:
+    std::string_view contents;
+    size_t position = 0;
+    int depth = 0;
+
+    std::string_view name;
+    std::string_view text;
+    std::vector<std::pair<std::string_view, std::string_view>> attributes;
+    bool isEndOfEmptyElementPending = false;
+
+    void skipPast(std::string_view delimiter);
+    void skipWhitespace();
+    std::string_view readName();
+    void readAttributes();
+};
+} // namespace SHOT
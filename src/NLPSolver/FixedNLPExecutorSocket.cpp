@@ -0,0 +1,204 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "FixedNLPExecutorSocket.h"
+
+#include "../Output.h"
+#include "../Utilities.h"
+
+#include "../Model/Problem.h"
+
+#include "spdlog/fmt/fmt.h"
+
+namespace SHOT
+{
+
+FixedNLPExecutorSocket::FixedNLPExecutorSocket(EnvironmentPtr envPtr, std::string workerAddresses) : env(envPtr)
+{
+    for(auto& A : Utilities::splitStringByCharacter(workerAddresses, ','))
+    {
+        auto address = A;
+        address = Utilities::trim(address);
+
+        if(address != "")
+            addresses.push_back(address);
+    }
+}
+
+FixedNLPExecutorSocket::~FixedNLPExecutorSocket() { stopWorkers(); }
+
+bool FixedNLPExecutorSocket::initialize(ProblemPtr sourceProblem, bool isReformulatedProblem)
+{
+    stopWorkers();
+
+    isStopped = false;
+
+    auto hello = FixedNLPProtocol::createHello(sourceProblem->properties.numberOfVariables, isReformulatedProblem);
+
+    for(auto& A : addresses)
+    {
+        auto worker = std::make_unique<Worker>();
+        worker->address = A;
+
+        std::string reply;
+
+        if(!worker->connection.connect(A) || !worker->connection.sendLine(hello)
+            || !worker->connection.readLine(reply))
+        {
+            env->output->outputWarning(fmt::format("        Could not connect to fixed NLP worker {}.", A));
+            continue;
+        }
+
+        if(reply != "OK")
+        {
+            env->output->outputWarning(fmt::format("        Fixed NLP worker {} not used: {}", A, reply));
+            continue;
+        }
+
+        worker->isConnected = true;
+        numberOfConnectedWorkers++;
+
+        worker->thread = std::thread(&FixedNLPExecutorSocket::runWorker, this, std::ref(*worker));
+        workers.push_back(std::move(worker));
+    }
+
+    env->output->outputInfo(
+        fmt::format("        Connected to {} of {} fixed NLP workers.", numberOfConnectedWorkers, addresses.size()));
+
+    return (numberOfConnectedWorkers > 0);
+}
+
+void FixedNLPExecutorSocket::updateVariableBounds(const std::map<int, PairDouble>& variableBounds)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for(auto& W : workers)
+    {
+        for(auto& B : variableBounds)
+            W->pendingVariableBounds[B.first] = B.second;
+    }
+}
+
+bool FixedNLPExecutorSocket::submit(uint64_t ID, const VectorDouble& point)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if(numberOfConnectedWorkers == 0)
+            return (false);
+
+        requests.emplace_back(ID, point);
+    }
+
+    requestAvailable.notify_one();
+    return (true);
+}
+
+std::vector<std::pair<uint64_t, FixedNLPResult>> FixedNLPExecutorSocket::getFinishedResults()
+{
+    std::vector<std::pair<uint64_t, FixedNLPResult>> finishedResults;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    finishedResults.swap(results);
+
+    return (finishedResults);
+}
+
+void FixedNLPExecutorSocket::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    requests.clear();
+}
+
+void FixedNLPExecutorSocket::runWorker(Worker& worker)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    while(true)
+    {
+        requestAvailable.wait(lock, [&] { return (isStopped || !requests.empty()); });
+
+        if(isStopped)
+            break;
+
+        auto request = std::move(requests.front());
+        requests.pop_front();
+
+        std::map<int, PairDouble> variableBounds;
+        variableBounds.swap(worker.pendingVariableBounds);
+        lock.unlock();
+
+        FixedNLPResult result;
+        uint64_t ID = 0;
+        std::string reply;
+
+        bool isSolved = (variableBounds.empty()
+                            || worker.connection.sendLine(FixedNLPProtocol::createBounds(variableBounds)))
+            && worker.connection.sendLine(FixedNLPProtocol::createSolve(request.first, request.second))
+            && worker.connection.readLine(reply) && FixedNLPProtocol::parseResult(reply, ID, result)
+            && ID == request.first;
+
+        lock.lock();
+
+        if(isSolved)
+        {
+            results.emplace_back(ID, std::move(result));
+            continue;
+        }
+
+        if(isStopped)
+            break;
+
+        worker.isConnected = false;
+        numberOfConnectedWorkers--;
+
+        env->output->outputWarning(fmt::format("        Lost connection to fixed NLP worker {}.", worker.address));
+
+        // The problem is solved by another worker, or returned as not solved if there are none left
+        requests.push_front(std::move(request));
+
+        if(numberOfConnectedWorkers == 0)
+        {
+            for(auto& R : requests)
+                results.emplace_back(R.first, FixedNLPResult());
+
+            requests.clear();
+        }
+
+        requestAvailable.notify_one();
+        break;
+    }
+}
+
+void FixedNLPExecutorSocket::stopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        isStopped = true;
+        requests.clear();
+
+        // Makes the threads waiting for results return
+        for(auto& W : workers)
+            W->connection.shutdown();
+    }
+
+    requestAvailable.notify_all();
+
+    for(auto& W : workers)
+    {
+        if(W->thread.joinable())
+            W->thread.join();
+    }
+
+    workers.clear();
+    numberOfConnectedWorkers = 0;
+}
+
+} // namespace SHOT
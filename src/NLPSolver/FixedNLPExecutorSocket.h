@@ -0,0 +1,75 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "IFixedNLPExecutor.h"
+#include "FixedNLPProtocol.h"
+
+#include "../Environment.h"
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace SHOT
+{
+
+// Sends the fixed NLP problems to the workers started with SHOT --worker, given in FixedInteger.RemoteWorkers. Every
+// worker has a thread in the solver sending it one problem at a time, and the problems of a worker that is
+// disconnected are solved by the others.
+class FixedNLPExecutorSocket : public IFixedNLPExecutor
+{
+public:
+    // The workers are given as host:port separated by commas
+    FixedNLPExecutorSocket(EnvironmentPtr envPtr, std::string workerAddresses);
+    ~FixedNLPExecutorSocket() override;
+
+    bool initialize(ProblemPtr sourceProblem, bool isReformulatedProblem) override;
+
+    void updateVariableBounds(const std::map<int, PairDouble>& variableBounds) override;
+
+    bool submit(uint64_t ID, const VectorDouble& point) override;
+
+    std::vector<std::pair<uint64_t, FixedNLPResult>> getFinishedResults() override;
+
+    void cancel() override;
+
+private:
+    struct Worker
+    {
+        std::string address;
+        FixedNLPConnection connection;
+        std::thread thread;
+
+        // The bounds not yet sent to the worker
+        std::map<int, PairDouble> pendingVariableBounds;
+        bool isConnected = false;
+    };
+
+    void runWorker(Worker& worker);
+    void stopWorkers();
+
+    EnvironmentPtr env;
+    std::vector<std::string> addresses;
+    std::vector<std::unique_ptr<Worker>> workers;
+
+    std::mutex mutex;
+    std::condition_variable requestAvailable;
+    std::deque<std::pair<uint64_t, VectorDouble>> requests;
+    std::vector<std::pair<uint64_t, FixedNLPResult>> results;
+    int numberOfConnectedWorkers = 0;
+    bool isStopped = false;
+};
+
+} // namespace SHOT
@@ -0,0 +1,470 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "FixedNLPProtocol.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+
+#ifndef _WIN32
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+#endif
+
+namespace SHOT
+{
+
+namespace
+{
+
+// Reads the space separated values of a message, strtod also reads the inf and nan written by fmt
+class MessageReader
+{
+public:
+    MessageReader(const std::string& line) : position(line.c_str()) { }
+
+    bool readWord(std::string& word)
+    {
+        while(*position == ' ')
+            position++;
+
+        const char* start = position;
+
+        while(*position != ' ' && *position != '\0')
+            position++;
+
+        word.assign(start, position);
+        return (!word.empty());
+    }
+
+    bool readDouble(double& value)
+    {
+        char* end;
+        value = std::strtod(position, &end);
+
+        if(end == position)
+            return (false);
+
+        position = end;
+        return (true);
+    }
+
+    bool readInteger(long long& value)
+    {
+        char* end;
+        value = std::strtoll(position, &end, 10);
+
+        if(end == position)
+            return (false);
+
+        position = end;
+        return (true);
+    }
+
+    bool readSize(size_t& size)
+    {
+        long long value;
+
+        // The number of values is bounded by the size of the remaining message
+        if(!readInteger(value) || value < 0 || (size_t)value > std::strlen(position))
+            return (false);
+
+        size = value;
+        return (true);
+    }
+
+    bool readValues(VectorDouble& values)
+    {
+        size_t size;
+
+        if(!readSize(size))
+            return (false);
+
+        values.resize(size);
+
+        for(auto& V : values)
+        {
+            if(!readDouble(V))
+                return (false);
+        }
+
+        return (true);
+    }
+
+    bool readType(const char* type)
+    {
+        std::string word;
+        return (readWord(word) && word == type);
+    }
+
+private:
+    const char* position;
+};
+
+void appendValues(fmt::memory_buffer& buffer, const VectorDouble& values)
+{
+    fmt::format_to(std::back_inserter(buffer), " {}", values.size());
+
+    for(auto& V : values)
+        fmt::format_to(std::back_inserter(buffer), " {}", V);
+}
+
+} // namespace
+
+namespace FixedNLPProtocol
+{
+
+std::string createHello(int numberOfVariables, bool isReformulatedProblem)
+{
+    return (fmt::format("{} {} {} {}", header, version, numberOfVariables, isReformulatedProblem ? 1 : 0));
+}
+
+std::string createBounds(const std::map<int, PairDouble>& variableBounds)
+{
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "BOUNDS {}", variableBounds.size());
+
+    for(auto& [index, bounds] : variableBounds)
+        fmt::format_to(std::back_inserter(buffer), " {} {} {}", index, bounds.first, bounds.second);
+
+    return (fmt::to_string(buffer));
+}
+
+std::string createSolve(uint64_t ID, const VectorDouble& point)
+{
+    fmt::memory_buffer buffer;
+    fmt::format_to(std::back_inserter(buffer), "SOLVE {}", ID);
+    appendValues(buffer, point);
+
+    return (fmt::to_string(buffer));
+}
+
+std::string createResult(uint64_t ID, const FixedNLPResult& result)
+{
+    fmt::memory_buffer buffer;
+    fmt::format_to(
+        std::back_inserter(buffer), "RESULT {} {} {}", ID, static_cast<int>(result.status), result.objectiveValue);
+    appendValues(buffer, result.solution);
+
+    return (fmt::to_string(buffer));
+}
+
+bool parseHello(const std::string& line, int& numberOfVariables, bool& isReformulatedProblem)
+{
+    MessageReader reader(line);
+    long long messageVersion, size, isReformulated;
+
+    if(!reader.readType(header) || !reader.readInteger(messageVersion) || messageVersion != version
+        || !reader.readInteger(size) || !reader.readInteger(isReformulated))
+        return (false);
+
+    numberOfVariables = size;
+    isReformulatedProblem = (isReformulated == 1);
+
+    return (true);
+}
+
+bool parseBounds(const std::string& line, std::map<int, PairDouble>& variableBounds)
+{
+    MessageReader reader(line);
+    size_t size;
+
+    if(!reader.readType("BOUNDS") || !reader.readSize(size))
+        return (false);
+
+    for(size_t i = 0; i < size; i++)
+    {
+        long long index;
+        PairDouble bounds;
+
+        if(!reader.readInteger(index) || !reader.readDouble(bounds.first) || !reader.readDouble(bounds.second))
+            return (false);
+
+        variableBounds[index] = bounds;
+    }
+
+    return (true);
+}
+
+bool parseSolve(const std::string& line, uint64_t& ID, VectorDouble& point)
+{
+    MessageReader reader(line);
+    long long messageID;
+
+    if(!reader.readType("SOLVE") || !reader.readInteger(messageID) || !reader.readValues(point))
+        return (false);
+
+    ID = messageID;
+    return (true);
+}
+
+bool parseResult(const std::string& line, uint64_t& ID, FixedNLPResult& result)
+{
+    MessageReader reader(line);
+    long long messageID, status;
+
+    if(!reader.readType("RESULT") || !reader.readInteger(messageID) || !reader.readInteger(status)
+        || !reader.readDouble(result.objectiveValue) || !reader.readValues(result.solution))
+        return (false);
+
+    ID = messageID;
+    result.status = static_cast<E_NLPSolutionStatus>(status);
+
+    return (true);
+}
+
+std::string getType(const std::string& line) { return (line.substr(0, line.find(' '))); }
+
+} // namespace FixedNLPProtocol
+
+FixedNLPConnection::~FixedNLPConnection()
+{
+#ifndef _WIN32
+    if(socket != -1)
+        ::close(socket);
+#endif
+}
+
+bool FixedNLPConnection::connect(const std::string& address)
+{
+#ifndef _WIN32
+    auto separator = address.rfind(':');
+
+    if(separator == std::string::npos)
+        return (false);
+
+    auto host = address.substr(0, separator);
+    auto port = address.substr(separator + 1);
+
+    addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+
+    addrinfo* addresses;
+
+    if(getaddrinfo(host.c_str(), port.c_str(), &hints, &addresses) != 0)
+        return (false);
+
+    for(auto* A = addresses; A != nullptr; A = A->ai_next)
+    {
+        socket = ::socket(A->ai_family, A->ai_socktype, A->ai_protocol);
+
+        if(socket == -1)
+            continue;
+
+        if(::connect(socket, A->ai_addr, A->ai_addrlen) == 0)
+            break;
+
+        ::close(socket);
+        socket = -1;
+    }
+
+    freeaddrinfo(addresses);
+
+    if(socket == -1)
+        return (false);
+
+    // The messages are small and answered one at a time
+    int noDelay = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+bool FixedNLPConnection::sendLine(const std::string& line)
+{
+#ifndef _WIN32
+    if(socket == -1)
+        return (false);
+
+    std::string message = line + '\n';
+
+#ifdef MSG_NOSIGNAL
+    int flags = MSG_NOSIGNAL;
+#else
+    int flags = 0;
+#endif
+
+    for(size_t sent = 0; sent < message.size();)
+    {
+        auto size = ::send(socket, message.data() + sent, message.size() - sent, flags);
+
+        if(size < 0 && errno == EINTR)
+            continue;
+
+        if(size <= 0)
+            return (false);
+
+        sent += size;
+    }
+
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+bool FixedNLPConnection::readLine(std::string& line)
+{
+#ifndef _WIN32
+    if(socket == -1)
+        return (false);
+
+    while(true)
+    {
+        auto end = buffer.find('\n');
+
+        if(end != std::string::npos)
+        {
+            line.assign(buffer, 0, end);
+            buffer.erase(0, end + 1);
+            return (true);
+        }
+
+        char data[65536];
+        auto size = ::recv(socket, data, sizeof(data), 0);
+
+        if(size < 0 && errno == EINTR)
+            continue;
+
+        if(size <= 0)
+            return (false);
+
+        if(buffer.size() + size > maxLineLength)
+        {
+            buffer.clear();
+            ::close(socket);
+            socket = -1;
+            return (false);
+        }
+
+        buffer.append(data, size);
+    }
+#else
+    return (false);
+#endif
+}
+
+void FixedNLPConnection::shutdown()
+{
+#ifndef _WIN32
+    if(socket != -1)
+        ::shutdown(socket, SHUT_RDWR);
+#endif
+}
+
+bool FixedNLPListener::listen(int listenPort, const std::string& host)
+{
+#ifndef _WIN32
+    close();
+
+    addrinfo hints {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE | AI_NUMERICSERV;
+
+    addrinfo* addresses;
+    auto service = std::to_string(listenPort);
+
+    if(getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses) != 0)
+        return (false);
+
+    for(auto* A = addresses; A != nullptr; A = A->ai_next)
+    {
+        socket = ::socket(A->ai_family, A->ai_socktype, A->ai_protocol);
+
+        if(socket == -1)
+            continue;
+
+        int value = 1;
+        setsockopt(socket, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+
+        // Listening on :: also accepts the IPv4 connections
+        if(A->ai_family == AF_INET6)
+        {
+            value = 0;
+            setsockopt(socket, IPPROTO_IPV6, IPV6_V6ONLY, &value, sizeof(value));
+        }
+
+        if(bind(socket, A->ai_addr, A->ai_addrlen) == 0 && ::listen(socket, 16) == 0)
+            break;
+
+        ::close(socket);
+        socket = -1;
+    }
+
+    freeaddrinfo(addresses);
+
+    if(socket == -1)
+        return (false);
+
+    sockaddr_storage address {};
+    socklen_t length = sizeof(address);
+    getsockname(socket, (sockaddr*)&address, &length);
+
+    if(address.ss_family == AF_INET6)
+        port = ntohs(((sockaddr_in6*)&address)->sin6_port);
+    else
+        port = ntohs(((sockaddr_in*)&address)->sin_port);
+
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+std::unique_ptr<FixedNLPConnection> FixedNLPListener::accept(int timeoutMilliseconds)
+{
+#ifndef _WIN32
+    if(socket == -1)
+        return (nullptr);
+
+    pollfd descriptor { socket, POLLIN, 0 };
+
+    if(poll(&descriptor, 1, timeoutMilliseconds) <= 0)
+        return (nullptr);
+
+    int connection = ::accept(socket, nullptr, nullptr);
+
+    if(connection == -1)
+        return (nullptr);
+
+    int noDelay = 1;
+    setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    return (std::make_unique<FixedNLPConnection>(connection));
+#else
+    return (nullptr);
+#endif
+}
+
+void FixedNLPListener::close()
+{
+#ifndef _WIN32
+    if(socket != -1)
+        ::close(socket);
+#endif
+
+    socket = -1;
+}
+
+} // namespace SHOT
@@ -0,0 +1,103 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "IFixedNLPExecutor.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace SHOT
+{
+
+// The messages between the solver and the fixed NLP workers are lines of text separated by spaces, with the values
+// written in their shortest representation that is read back to the same value:
+//   SHOTFIXEDNLP <version> <number of variables> <1 if the reformulated problem>   sent by the solver when connecting
+//   OK | ERROR <message>                                                            reply from the worker
+//   BOUNDS <number of bounds> (<variable index> <lower bound> <upper bound>)...     new variable bounds
+//   SOLVE <ID> <number of values> <values of the candidate point>...               solves a fixed NLP problem
+//   RESULT <ID> <status> <objective value> <number of values> <values of the solution>...   reply from the worker
+namespace FixedNLPProtocol
+{
+constexpr const char* header = "SHOTFIXEDNLP";
+constexpr int version = 1;
+
+std::string createHello(int numberOfVariables, bool isReformulatedProblem);
+std::string createBounds(const std::map<int, PairDouble>& variableBounds);
+std::string createSolve(uint64_t ID, const VectorDouble& point);
+std::string createResult(uint64_t ID, const FixedNLPResult& result);
+
+bool parseHello(const std::string& line, int& numberOfVariables, bool& isReformulatedProblem);
+bool parseBounds(const std::string& line, std::map<int, PairDouble>& variableBounds);
+bool parseSolve(const std::string& line, uint64_t& ID, VectorDouble& point);
+bool parseResult(const std::string& line, uint64_t& ID, FixedNLPResult& result);
+
+// The first word of the message
+std::string getType(const std::string& line);
+} // namespace FixedNLPProtocol
+
+// A TCP connection sending and receiving the messages as lines, not available on Windows
+class FixedNLPConnection
+{
+public:
+    FixedNLPConnection() = default;
+    explicit FixedNLPConnection(int socket) : socket(socket) {};
+    ~FixedNLPConnection();
+
+    FixedNLPConnection(const FixedNLPConnection&) = delete;
+    FixedNLPConnection& operator=(const FixedNLPConnection&) = delete;
+
+    // The address is given as host:port
+    bool connect(const std::string& address);
+
+    bool sendLine(const std::string& line);
+
+    // Waits until a full line is received, returns false if the connection is closed. A line longer than
+    // maxLineLength is not a message of the protocol, and closes the connection.
+    bool readLine(std::string& line);
+
+    // Allows the values of points with millions of variables
+    static constexpr size_t maxLineLength = 256 * 1024 * 1024;
+
+    // Makes the send and read calls in other threads return
+    void shutdown();
+
+    bool isOpen() const { return (socket != -1); };
+
+private:
+    int socket = -1;
+    std::string buffer;
+};
+
+// Listens for connections from the solver in a fixed NLP worker
+class FixedNLPListener
+{
+public:
+    ~FixedNLPListener() { close(); };
+
+    // A port of 0 uses any free port, see getPort(). Only the connections to the host, e.g. 127.0.0.1 for the local
+    // machine or :: for all addresses, are accepted.
+    bool listen(int port, const std::string& host = "127.0.0.1");
+
+    int getPort() const { return (port); };
+
+    // Returns nullptr if no connection was made within the timeout
+    std::unique_ptr<FixedNLPConnection> accept(int timeoutMilliseconds);
+
+    void close();
+
+private:
+    int socket = -1;
+    int port = 0;
+};
+
+} // namespace SHOT
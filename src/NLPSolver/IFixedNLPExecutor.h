@@ -0,0 +1,62 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "../Enums.h"
+#include "../Structs.h"
+
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+struct FixedNLPResult
+{
+    E_NLPSolutionStatus status = E_NLPSolutionStatus::Error;
+    double objectiveValue = NAN;
+    VectorDouble solution;
+
+    // The problem was not solved since it cannot give a better primal solution
+    bool isAbandoned = false;
+};
+
+// Solves the fixed NLP problems outside of the solver, e.g. in worker processes on other nodes, while the solver
+// continues with the dual problem. The problems are the candidate points with the discrete variables fixed, and the
+// results are used the next time the primal NLP task is run. Set with Solver::setFixedNLPExecutor().
+class IFixedNLPExecutor
+{
+public:
+    virtual ~IFixedNLPExecutor() = default;
+
+    // Called before the first problem is submitted with the problem the candidate points are for, if it returns false
+    // the problems are solved locally instead
+    virtual bool initialize(ProblemPtr sourceProblem, bool isReformulatedProblem) = 0;
+
+    // The bounds are used in all problems submitted after this
+    virtual void updateVariableBounds(const std::map<int, PairDouble>& variableBounds) = 0;
+
+    // Should not wait for the problem to be solved, returns false if it could not be submitted
+    virtual bool submit(uint64_t ID, const VectorDouble& point) = 0;
+
+    // The results of the problems finished since the last call
+    virtual std::vector<std::pair<uint64_t, FixedNLPResult>> getFinishedResults() = 0;
+
+    // Discards the problems that have not been started
+    virtual void cancel() = 0;
+};
+
+using FixedNLPExecutorPtr = std::shared_ptr<IFixedNLPExecutor>;
+
+} // namespace SHOT
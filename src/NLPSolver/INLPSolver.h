@@ -47,6 +47,16 @@ public:
 
     virtual std::string getSolverDescription() = 0;
 
+    // Solves the following problems with a looser relative tolerance and iteration limit until resetTolerances() is
+    // called, e.g. when screening candidates. Returns false if the solver does not support this.
+    virtual bool setScreeningTolerances(
+        [[maybe_unused]] double relativeTolerance, [[maybe_unused]] int iterationLimit)
+    {
+        return (false);
+    };
+
+    virtual void resetTolerances() {};
+
 protected:
     virtual E_NLPSolutionStatus solveProblemInstance() = 0;
 };
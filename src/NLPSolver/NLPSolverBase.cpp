@@ -10,6 +10,8 @@
 
 #include "NLPSolverBase.h"
 
+#include "../Metrics.h"
+
 namespace SHOT
 {
 
@@ -17,6 +19,11 @@ NLPSolverBase::NLPSolverBase() = default;
 
 E_NLPSolutionStatus NLPSolverBase::solveProblem()
 {
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::NLPProblems);
+
+    MetricsTimer timer(env->metrics.get(), E_MetricsHistogram::NLPSolveTime);
+
     auto solStatus = solveProblemInstance();
 
     return (solStatus);
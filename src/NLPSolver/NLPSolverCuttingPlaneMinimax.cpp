@@ -10,6 +10,8 @@
 
 #include "NLPSolverCuttingPlaneMinimax.h"
 
+#include "../CancellationToken.h"
+#include "../DebugWriter.h"
 #include "../Output.h"
 #include "../Report.h"
 #include "../Settings.h"
@@ -18,6 +20,7 @@
 #include "../DualSolver.h"
 #include "../MIPSolver/IMIPSolver.h"
 
+#include <algorithm>
 #include <functional>
 #include <map>
 
@@ -120,6 +123,8 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
     int maxIterSubsolver
         = env->settings->getSetting<int>("ESH.InteriorPoint.CuttingPlane.IterationLimitSubsolver", "Dual");
     int bitPrecision = env->settings->getSetting<int>("ESH.InteriorPoint.CuttingPlane.BitPrecision", "Dual");
+    double maxStepLength
+        = env->settings->getSetting<double>("ESH.InteriorPoint.CuttingPlane.LineSearchMaxStep", "Dual");
 
     // currSol is the current LP solution, and prevSol the previous one
     VectorDouble currSol, prevSol;
@@ -155,7 +160,7 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
 
         // Solves the problem and obtains the solution
         auto solStatus = LPSolver->solveProblem();
-        env->solutionStatistics.numberOfProblemsMinimaxLP++;
+        numberOfSolvedLPProblems++;
 
         if(solStatus == E_ProblemSolutionStatus::Infeasible)
         {
@@ -194,7 +199,7 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
             auto filename = fmt::format(
                 "{}/minimax{}_solpt.txt", env->settings->getSetting<std::string>("Debug.Path", "Output"), i);
 
-            Utilities::saveVariablePointVectorToFile(LPVarSol, variableNames, filename);
+            env->debugWriter->writePoint(LPVarSol, variableNames, filename);
         }
 
         if(std::isnan(LPObjVar))
@@ -208,15 +213,21 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
             currSol = LPVarSol;
             lambda = -1; // For reporting purposes only
             mu = LPObjVar;
-            env->report->outputIterationDetailHeaderMinimax();
+
+            if(isIterationOutputUsed)
+                env->report->outputIterationDetailHeaderMinimax();
         }
         else
         {
             MinimizationFunction funct(LPVarSol, prevSol, sourceProblem);
 
-            // Solves the minimization problem wrt lambda in [0, 1]
+            // The line search continues past the LP solution in its direction as long as the point is feasible in the
+            // linear constraints, since the cuts are generated in the line search point
+            double maxLambda = std::min(maxStepLength, getMaximalStepLength(prevSol, LPVarSol));
+
+            // Solves the minimization problem wrt lambda in [0, maxLambda]
             auto minimizationResult
-                = boost::math::tools::brent_find_minima(funct, 0.0, 1.0, bitPrecision, maxIterSubsolverTmp);
+                = boost::math::tools::brent_find_minima(funct, 0.0, maxLambda, bitPrecision, maxIterSubsolverTmp);
 
             lambda = minimizationResult.first; // The value for the line search parameter
             mu = minimizationResult.second; // The objective value
@@ -237,12 +248,15 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
                 auto filename = fmt::format(
                     "{}/minimax{}_lsearchsolpt.txt", env->settings->getSetting<std::string>("Debug.Path", "Output"), i);
 
-                Utilities::saveVariablePointVectorToFile(currSol, variableNames, filename);
+                env->debugWriter->writePoint(currSol, variableNames, filename);
             }
         }
 
-        env->report->outputIterationDetailMinimax((i + 1), "LP", env->timing->getElapsedTime("Total"), numHyperAdded,
-            numHyperTot, LPObjVar, mu, maxObjDiffAbs, maxObjDiffRel);
+        if(isIterationOutputUsed)
+        {
+            env->report->outputIterationDetailMinimax((i + 1), "LP", env->timing->getElapsedTime("Total"),
+                numHyperAdded, numHyperTot, LPObjVar, mu, maxObjDiffAbs, maxObjDiffRel);
+        }
 
         if(mu < 0 && (maxObjDiffAbs < termObjTolAbs || maxObjDiffRel < termObjTolRel))
         {
@@ -250,12 +264,22 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
             break;
         }
 
+        if(i > 0 && mu < 0 && mu <= earlyTerminationDeviation)
+        {
+            statusCode = E_NLPSolutionStatus::Feasible;
+            break;
+        }
+
         // Gets the most deviated constraints
         auto constraintValues = sourceProblem->getFractionOfDeviatingNonlinearConstraints(
             currSol, SHOT_DBL_MIN, constrSelFactor, LPObjVar);
 
         numHyperAdded = 0;
 
+        // The cuts are added to the LP problem at once, so that it is only modified once per iteration
+        LinearConstraintBlock cuts;
+        std::vector<NumericConstraintValue> cutSources;
+
         for(auto& NCV : constraintValues)
         {
             // Contains the coefficient and variable index for the terms in the generated cut
@@ -319,20 +343,30 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
                 }
             }
 
-            // Adds the linear constraint
-            if(cutHasNoNaNsorInfs
-                && LPSolver->addLinearConstraint(elements, constant,
-                       "minimax_" + std::to_string(NCV.constraint->index) + "_" + std::to_string(numHyperTot))
-                    >= 0)
+            if(cutHasNoNaNsorInfs)
+            {
+                cuts.add(elements, constant,
+                    "minimax_" + std::to_string(NCV.constraint->index) + "_"
+                        + std::to_string(numHyperTot + cuts.size()),
+                    true);
+                cutSources.push_back(NCV);
+            }
+        }
+
+        if(cuts.size() > 0 && LPSolver->addLinearConstraints(cuts) >= 0)
+        {
+            numHyperTot += cuts.size();
+            numHyperAdded = cuts.size();
+
+            if(mu >= 0 && env->settings->getSetting<bool>("ESH.InteriorPoint.CuttingPlane.Reuse", "Dual"))
             {
-                numHyperTot++;
-                numHyperAdded++;
+                auto tmpPoint = currSol;
+                tmpPoint.pop_back();
 
-                if(mu >= 0 && env->settings->getSetting<bool>("ESH.InteriorPoint.CuttingPlane.Reuse", "Dual")
-                    && NCV.constraint->properties.convexity == E_Convexity::Convex)
+                for(auto& NCV : cutSources)
                 {
-                    auto tmpPoint = currSol;
-                    tmpPoint.pop_back();
+                    if(NCV.constraint->properties.convexity != E_Convexity::Convex)
+                        continue;
 
                     Hyperplane hyperplane;
                     hyperplane.sourceConstraint = NCV.constraint;
@@ -341,7 +375,7 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
                     hyperplane.source = E_HyperplaneSource::InteriorPointSearch;
                     hyperplane.isSourceConvex = true;
 
-                    env->dualSolver->addHyperplane(hyperplane);
+                    reusableHyperplanes.push_back(hyperplane);
                 }
             }
         }
@@ -355,7 +389,8 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
         }
 
         if(env->timing->getElapsedTime("InteriorPointSearch")
-            > env->settings->getSetting<double>("ESH.InteriorPoint.CuttingPlane.TimeLimit", "Dual"))
+                > env->settings->getSetting<double>("ESH.InteriorPoint.CuttingPlane.TimeLimit", "Dual")
+            || env->cancellationToken->isCancelled())
         {
             statusCode = E_NLPSolutionStatus::TimeLimit;
             break;
@@ -380,6 +415,41 @@ E_NLPSolutionStatus NLPSolverCuttingPlaneMinimax::solveProblemInstance()
     return (statusCode);
 }
 
+double NLPSolverCuttingPlaneMinimax::getMaximalStepLength(const VectorDouble& point, const VectorDouble& LPPoint)
+{
+    // Both points fulfill the linear constraints and variable bounds, so the step to the LP point is always feasible
+    double maxLambda = SHOT_DBL_MAX;
+
+    for(auto& V : sourceProblem->allVariables)
+    {
+        double direction = LPPoint.at(V->index) - point.at(V->index);
+
+        if(direction > 0)
+            maxLambda = std::min(maxLambda, (V->upperBound - point.at(V->index)) / direction);
+        else if(direction < 0)
+            maxLambda = std::min(maxLambda, (V->lowerBound - point.at(V->index)) / direction);
+    }
+
+    for(auto& C : sourceProblem->linearConstraints)
+    {
+        double value = C->constant;
+        double direction = 0.0;
+
+        for(auto& T : C->linearTerms)
+        {
+            value += T->coefficient * point.at(T->variable->index);
+            direction += T->coefficient * (LPPoint.at(T->variable->index) - point.at(T->variable->index));
+        }
+
+        if(direction > 0)
+            maxLambda = std::min(maxLambda, (C->valueRHS - value) / direction);
+        else if(direction < 0)
+            maxLambda = std::min(maxLambda, (C->valueLHS - value) / direction);
+    }
+
+    return (std::max(1.0, maxLambda));
+}
+
 double NLPSolverCuttingPlaneMinimax::getSolution(int i) { return (solution.at(i)); }
 
 VectorDouble NLPSolverCuttingPlaneMinimax::getSolution() { return (solution); }
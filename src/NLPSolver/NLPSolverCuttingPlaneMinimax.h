@@ -49,17 +49,29 @@ public:
 
     void saveProblemToFile(std::string fileName) override;
 
+    double getSolution(int i) override;
+    VectorDouble getSolution() override;
+    double getObjectiveValue() override;
+
     std::string getSolverDescription() override { return ("Built in minmax solver"); };
 
+    // Terminates the solver as soon as a point with a maximal constraint deviation not larger than the given value is
+    // found, used when several minimax problems are solved at once
+    void setEarlyTerminationDeviation(double deviation) { earlyTerminationDeviation = deviation; };
+
+    // The iteration output is disabled when several problems are solved in parallel
+    void setIterationOutput(bool useOutput) { isIterationOutputUsed = useOutput; };
+
+    // The solver does not modify the environment while solving, so that several instances can be solved in parallel.
+    // The number of solved LP problems and the cutting planes to reuse in the dual problem are instead collected here.
+    int numberOfSolvedLPProblems = 0;
+    std::vector<Hyperplane> reusableHyperplanes;
+
 private:
     std::unique_ptr<IMIPSolver> LPSolver;
     ProblemPtr sourceProblem;
     VectorString variableNames;
 
-    double getSolution(int i) override;
-    VectorDouble getSolution() override;
-    double getObjectiveValue() override;
-
     void fixVariables(VectorInteger variableIndexes, VectorDouble variableValues) override;
 
     void unfixVariables() override;
@@ -71,6 +83,13 @@ private:
     VectorDouble solution;
     double objectiveValue = NAN;
 
+    double earlyTerminationDeviation = SHOT_DBL_MIN;
+    bool isIterationOutputUsed = true;
+
     bool createProblem(IMIPSolver* destinationProblem, ProblemPtr sourceProblem);
+
+    // The largest step from point in the direction of the LP point for which the linear constraints and variable
+    // bounds are fulfilled, but at least the step to the LP point
+    double getMaximalStepLength(const VectorDouble& point, const VectorDouble& LPPoint);
 };
 } // namespace SHOT
\ No newline at end of file
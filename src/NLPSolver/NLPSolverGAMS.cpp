@@ -102,6 +102,7 @@ NLPSolverGAMS::NLPSolverGAMS(EnvironmentPtr envPtr, gmoHandle_t modelingObject,
     }
 
     showlog = env->settings->getSetting<bool>("Console.PrimalSolver.Show", "Output");
+    useWarmStart = env->settings->getSetting<bool>("GAMS.NLP.WarmStart", "Subsolver");
 }
 
 NLPSolverGAMS::~NLPSolverGAMS() = default;
@@ -221,6 +222,9 @@ E_NLPSolutionStatus NLPSolverGAMS::solveProblemInstance()
     if(showlog)
         gevSwitchLogStat(modelingEnvironment, 3, nullptr, 0, nullptr, 0, gevwritecallback, &cbdata, &cbdata.orighandle);
 
+    if(useWarmStart && hasWarmStart)
+        applyWarmStart();
+
     if(gevCallSolver(modelingEnvironment, modelingObject, "", nlpsolver.c_str(), solvelink,
            showlog ? gevSolverSameStreams : gevSolverQuiet, nullptr, nullptr, timelimit, iterlimit, 0, 0.0, 0.0,
            nullptr, msg)
@@ -241,6 +245,17 @@ E_NLPSolutionStatus NLPSolverGAMS::solveProblemInstance()
     gmoAltBoundsSet(modelingObject, 0);
     gmoForceContSet(modelingObject, 0);
 
+    auto status = getSolutionStatus();
+
+    // The solution of a failed call is not used as warm start, instead the last solution is applied again
+    if(useWarmStart && (status == E_NLPSolutionStatus::Optimal || status == E_NLPSolutionStatus::Feasible))
+        saveWarmStart();
+
+    return (status);
+}
+
+E_NLPSolutionStatus NLPSolverGAMS::getSolutionStatus()
+{
     switch(gmoModelStat(modelingObject))
     {
     case gmoModelStat_OptimalGlobal:
@@ -285,6 +300,51 @@ E_NLPSolutionStatus NLPSolverGAMS::solveProblemInstance()
     }
 }
 
+void NLPSolverGAMS::saveWarmStart()
+{
+    int numberOfVariables = gmoN(modelingObject);
+    int numberOfEquations = gmoM(modelingObject);
+
+    warmStartVariableMarginals.resize(numberOfVariables);
+    warmStartVariableStatuses.resize(numberOfVariables);
+
+    for(int i = 0; i < numberOfVariables; ++i)
+    {
+        warmStartVariableMarginals[i] = gmoGetVarMOne(modelingObject, i);
+        warmStartVariableStatuses[i] = gmoGetVarStatOne(modelingObject, i);
+    }
+
+    warmStartEquationLevels.resize(numberOfEquations);
+    warmStartEquationMarginals.resize(numberOfEquations);
+    warmStartEquationStatuses.resize(numberOfEquations);
+
+    for(int i = 0; i < numberOfEquations; ++i)
+    {
+        warmStartEquationLevels[i] = gmoGetEquLOne(modelingObject, i);
+        warmStartEquationMarginals[i] = gmoGetEquMOne(modelingObject, i);
+        warmStartEquationStatuses[i] = gmoGetEquStatOne(modelingObject, i);
+    }
+
+    hasWarmStart = true;
+}
+
+void NLPSolverGAMS::applyWarmStart()
+{
+    // The variable levels are given by the starting point, and are otherwise the ones of the last call
+    for(int i = 0; i < (int)warmStartVariableMarginals.size(); ++i)
+    {
+        gmoSetVarMOne(modelingObject, i, warmStartVariableMarginals[i]);
+        gmoSetVarStatOne(modelingObject, i, warmStartVariableStatuses[i]);
+    }
+
+    for(int i = 0; i < (int)warmStartEquationLevels.size(); ++i)
+    {
+        gmoSetEquLOne(modelingObject, i, warmStartEquationLevels[i]);
+        gmoSetEquMOne(modelingObject, i, warmStartEquationMarginals[i]);
+        gmoSetEquStatOne(modelingObject, i, warmStartEquationStatuses[i]);
+    }
+}
+
 VectorDouble NLPSolverGAMS::getVariableLowerBounds()
 {
     assert(modelingObject != nullptr);
@@ -30,6 +30,21 @@ private:
     bool showlog;
     int solvelink;
 
+    // The marginals and basis statuses of the last fixed NLP problem with a solution, given to the NLP solver in the
+    // next call so that it can start from the previous basis instead of from scratch
+    bool useWarmStart;
+    bool hasWarmStart = false;
+    VectorDouble warmStartVariableMarginals;
+    std::vector<int> warmStartVariableStatuses;
+    VectorDouble warmStartEquationLevels;
+    VectorDouble warmStartEquationMarginals;
+    std::vector<int> warmStartEquationStatuses;
+
+    E_NLPSolutionStatus getSolutionStatus();
+
+    void saveWarmStart();
+    void applyWarmStart();
+
 public:
     NLPSolverGAMS(EnvironmentPtr envPtr, gmoHandle_t modelingObject, palHandle_t auditLicensing);
 
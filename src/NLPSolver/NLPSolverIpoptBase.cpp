@@ -10,8 +10,12 @@
 
 #include "NLPSolverIpoptBase.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cstdio>
+#include <mutex>
 
+#include "../CancellationToken.h"
 #include "../Output.h"
 #include "../Settings.h"
 #include "../Utilities.h"
@@ -21,6 +25,9 @@ namespace SHOT
 
 using namespace Ipopt;
 
+// Held during the solves when the linear solver is not thread-safe
+static std::mutex linearSolverMutex;
+
 void IpoptJournal::PrintImpl(Ipopt::EJournalCategory category, Ipopt::EJournalLevel level, const char* str)
 {
     auto lines = Utilities::splitStringByCharacter(str, '\n');
@@ -98,14 +105,10 @@ bool IpoptProblem::get_nlp_info(Index& n, Index& m, Index& nnz_jac_g, Index& nnz
     n = sourceProblem->properties.numberOfVariables;
     m = sourceProblem->properties.numberOfNumericConstraints;
 
-    nnz_jac_g = 0;
-
-    for(auto& E : *sourceProblem->getConstraintsJacobianSparsityPattern())
-    {
-        nnz_jac_g += E.second.size();
-    }
+    linearJacobianValues = nullptr;
 
-    nnz_h_lag = sourceProblem->getLagrangianHessianSparsityPattern()->size();
+    nnz_jac_g = sourceProblem->getJacobianSparsityPatternCSR().numberOfNonzeros();
+    nnz_h_lag = sourceProblem->getLagrangianHessianSparsityPatternCSR().numberOfNonzeros();
 
     // use the C style indexing (0-based)
     index_style = TNLP::C_STYLE;
@@ -197,8 +200,35 @@ bool IpoptProblem::get_starting_point(Index n, [[maybe_unused]] bool init_x, [[m
     [[maybe_unused]] bool init_lambda, [[maybe_unused]] Number* lambda)
 {
     assert(init_x == true);
-    assert(init_z == false);
-    assert(init_lambda == false);
+
+    // Multipliers are only requested if a warm start has been enabled in solveProblemInstance()
+    if(init_z || init_lambda)
+    {
+        if(selectedWarmStartPoint < 0)
+            return (false);
+
+        auto& warmStartPoint = warmStartPoints[selectedWarmStartPoint];
+
+        for(int i = 0; i < n; i++)
+        {
+            // Fixed variables keep their new values
+            x[i] = (lowerBounds[i] == upperBounds[i]) ? lowerBounds[i] : warmStartPoint.variableValues[i];
+
+            if(init_z)
+            {
+                z_L[i] = warmStartPoint.lowerBoundMultipliers[i];
+                z_U[i] = warmStartPoint.upperBoundMultipliers[i];
+            }
+        }
+
+        if(init_lambda)
+        {
+            for(int i = 0; i < m; i++)
+                lambda[i] = warmStartPoint.constraintMultipliers[i];
+        }
+
+        return (true);
+    }
 
     std::vector<bool> isInitialized(n, false);
 
@@ -353,24 +383,17 @@ bool IpoptProblem::eval_jac_g(Index n, const Number* x, [[maybe_unused]] bool ne
     // The structure
     if(values == nullptr)
     {
-        int counter = 0;
+        auto& pattern = sourceProblem->getJacobianSparsityPatternCSR();
 
-        jacobianCounterPlacement.clear();
+        assert(pattern.numberOfNonzeros() == (size_t)nele_jac);
 
-        for(auto& C : sourceProblem->numericConstraints)
+        for(size_t i = 0; i < pattern.numberOfRows(); i++)
         {
-            auto jacobian = C->getGradientSparsityPattern();
-
-            for(auto& G : *jacobian)
+            for(int k = pattern.rowStarts[i]; k < pattern.rowStarts[i + 1]; k++)
             {
-                iRow[counter] = C->index;
-                jCol[counter] = G->index;
-
-                jacobianCounterPlacement.emplace(std::make_pair(C->index, G->index), counter);
-                counter++;
+                iRow[k] = i;
+                jCol[k] = pattern.columns[k];
             }
-
-            assert(counter <= nele_jac);
         }
 
         return (true);
@@ -378,53 +401,52 @@ bool IpoptProblem::eval_jac_g(Index n, const Number* x, [[maybe_unused]] bool ne
 
     // The values
 
-    VectorDouble vectorPoint(n);
+    auto startTime = std::chrono::steady_clock::now();
 
-    for(int i = 0; i < n; i++)
-        vectorPoint[i] = x[i];
+    jacobianPoint.assign(x, x + n);
 
-    for(int i = 0; i < nele_jac; i++)
-        values[i] = 0.0;
+    bool updateLinear = (values != linearJacobianValues);
 
     for(auto& C : sourceProblem->numericConstraints)
     {
-        auto jacobian = C->calculateGradient(vectorPoint, false);
+        if(!updateLinear && C->properties.classification == E_ConstraintClassification::Linear)
+            continue;
 
-        for(auto& G : jacobian)
-        {
-            int location = jacobianCounterPlacement[std::make_pair(C->index, G.first->index)];
+        // The elements of a constraint follow its gradient sparsity pattern, so the gradient is written directly
+        auto& pattern = sourceProblem->getJacobianSparsityPatternCSR();
 
-            values[location] += G.second;
+        assert(pattern.rowStarts[C->index + 1] <= nele_jac);
+        assert(pattern.rowSize(C->index) == C->getGradientSparsityPattern()->size());
 
-            assert(location < nele_jac);
-            assert(location >= 0);
-        }
+        C->calculateSparseGradient(jacobianPoint, values + pattern.rowStarts[C->index]);
     }
 
+    linearJacobianValues = values;
+
+    if(firstJacobianEvaluationTime < 0)
+        firstJacobianEvaluationTime
+            = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
     return (true);
 }
 
 // Return the structure or values of the Hessian of the Langragian
 bool IpoptProblem::eval_h(Index n, const Number* x, [[maybe_unused]] bool new_x, Number obj_factor,
-    [[maybe_unused]] Index m, const Number* lambda, [[maybe_unused]] bool new_lambda, Index nele_hess, Index* iRow,
-    Index* jCol, Number* values)
+    [[maybe_unused]] Index m, const Number* lambda, [[maybe_unused]] bool new_lambda,
+    [[maybe_unused]] Index nele_hess, Index* iRow, Index* jCol, Number* values)
 {
     // The structure
     if(values == nullptr)
     {
-        int counter = 0;
-        lagrangianHessianCounterPlacement.clear();
+        auto& pattern = sourceProblem->getLagrangianHessianSparsityPatternCSR();
 
-        for(auto& E : *sourceProblem->getLagrangianHessianSparsityPattern())
+        for(size_t i = 0; i < pattern.numberOfRows(); i++)
         {
-            assert(E.first->index <= E.second->index);
-
-            iRow[counter] = E.first->index;
-            jCol[counter] = E.second->index;
-
-            lagrangianHessianCounterPlacement.emplace(std::make_pair(E.first->index, E.second->index), counter);
-
-            counter++;
+            for(int k = pattern.rowStarts[i]; k < pattern.rowStarts[i + 1]; k++)
+            {
+                iRow[k] = i;
+                jCol[k] = pattern.columns[k];
+            }
         }
 
         return (true);
@@ -432,47 +454,17 @@ bool IpoptProblem::eval_h(Index n, const Number* x, [[maybe_unused]] bool new_x,
 
     // The values
 
-    VectorDouble vectorPoint(n);
+    auto startTime = std::chrono::steady_clock::now();
 
-    for(int i = 0; i < n; i++)
-        vectorPoint[i] = x[i];
+    VectorDouble vectorPoint(x, x + n);
 
-    for(int i = 0; i < nele_hess; i++)
-        values[i] = 0.0;
+    assert((size_t)nele_hess == sourceProblem->getLagrangianHessianSparsityPatternCSR().numberOfNonzeros());
 
-    if(obj_factor != 0.0)
-    {
-        for(auto& E : sourceProblem->objectiveFunction->calculateHessian(vectorPoint, false))
-        {
-            int location
-                = lagrangianHessianCounterPlacement[std::make_pair(E.first.first->index, E.first.second->index)];
+    sourceProblem->calculateLagrangianHessian(vectorPoint, obj_factor, lambda, values);
 
-            assert(location < nele_hess);
-            assert(location >= 0);
-
-            values[location] = obj_factor * E.second;
-        }
-    }
-
-    for(auto& C : sourceProblem->numericConstraints)
-    {
-        if(C->properties.classification == E_ConstraintClassification::Linear)
-            continue;
-
-        if(lambda[C->index] == 0.0)
-            continue;
-
-        for(auto& E : C->calculateHessian(vectorPoint, false))
-        {
-            int location
-                = lagrangianHessianCounterPlacement[std::make_pair(E.first.first->index, E.first.second->index)];
-
-            assert(location < nele_hess);
-            assert(location >= 0);
-
-            values[location] += lambda[C->index] * E.second;
-        }
-    }
+    if(firstHessianEvaluationTime < 0)
+        firstHessianEvaluationTime
+            = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
 
     return (true);
 }
@@ -490,6 +482,15 @@ bool IpoptProblem::get_scaling_parameters(Number& obj_scaling, [[maybe_unused]]
     return (true);
 }*/
 
+bool IpoptProblem::intermediate_callback([[maybe_unused]] AlgorithmMode mode, [[maybe_unused]] Index iter,
+    [[maybe_unused]] Number obj_value, [[maybe_unused]] Number inf_pr, [[maybe_unused]] Number inf_du,
+    [[maybe_unused]] Number mu, [[maybe_unused]] Number d_norm, [[maybe_unused]] Number regularization_size,
+    [[maybe_unused]] Number alpha_du, [[maybe_unused]] Number alpha_pr, [[maybe_unused]] Index ls_trials,
+    [[maybe_unused]] const IpoptData* ip_data, [[maybe_unused]] IpoptCalculatedQuantities* ip_cq)
+{
+    return (!env->cancellationToken->isCancelled());
+}
+
 void IpoptProblem::finalize_solution(SolverReturn status, [[maybe_unused]] Index n, const Number* x,
     [[maybe_unused]] const Number* z_L, [[maybe_unused]] const Number* z_U, [[maybe_unused]] Index m,
     [[maybe_unused]] const Number* g, [[maybe_unused]] const Number* lambda, Number obj_value,
@@ -690,9 +691,59 @@ void IpoptProblem::finalize_solution(SolverReturn status, [[maybe_unused]] Index
         solutionStatus = E_NLPSolutionStatus::Error;
     }
 
+    if(hasSolution && lambda != nullptr)
+        constraintMultipliers.assign(lambda, lambda + m);
+    else
+        constraintMultipliers.clear();
+
+    if(maxNumberOfWarmStartPoints > 0 && (status == SUCCESS || status == STOP_AT_ACCEPTABLE_POINT))
+    {
+        WarmStartPoint warmStartPoint;
+        warmStartPoint.fixedVariableIndexes = fixedVariableIndexes;
+        warmStartPoint.fixedVariableValues = fixedVariableValues;
+        warmStartPoint.variableValues.assign(x, x + n);
+        warmStartPoint.lowerBoundMultipliers.assign(z_L, z_L + n);
+        warmStartPoint.upperBoundMultipliers.assign(z_U, z_U + n);
+        warmStartPoint.constraintMultipliers.assign(lambda, lambda + m);
+
+        warmStartPoints.push_front(std::move(warmStartPoint));
+
+        if(warmStartPoints.size() > maxNumberOfWarmStartPoints)
+            warmStartPoints.pop_back();
+    }
+
+    selectedWarmStartPoint = -1;
+
     env->output->outputDebug("        Ipopt terminated with status: " + solutionDescription);
 }
 
+bool IpoptProblem::selectWarmStartPoint()
+{
+    selectedWarmStartPoint = -1;
+    double smallestDistance = SHOT_DBL_INF;
+
+    for(size_t i = 0; i < warmStartPoints.size(); i++)
+    {
+        auto& warmStartPoint = warmStartPoints[i];
+
+        if(warmStartPoint.fixedVariableIndexes != fixedVariableIndexes)
+            continue;
+
+        double distance = 0.0;
+
+        for(size_t k = 0; k < fixedVariableValues.size(); k++)
+            distance += std::abs(warmStartPoint.fixedVariableValues[k] - fixedVariableValues[k]);
+
+        if(distance < smallestDistance)
+        {
+            smallestDistance = distance;
+            selectedWarmStartPoint = i;
+        }
+    }
+
+    return (selectedWarmStartPoint >= 0);
+}
+
 E_NLPSolutionStatus NLPSolverIpoptBase::solveProblemInstance()
 {
     env->output->outputDebug("        Starting solution of Ipopt problem.");
@@ -704,16 +755,69 @@ E_NLPSolutionStatus NLPSolverIpoptBase::solveProblemInstance()
     {
         Ipopt::ApplicationReturnStatus ipoptStatus;
 
-        if(!hasBeenSolved)
+        updateHessianApproximation();
+
+        bool useWarmStart = (ipoptProblem->maxNumberOfWarmStartPoints > 0 && ipoptProblem->selectWarmStartPoint());
+
+        // The configured values, or the defaults of Ipopt if not set, are restored after the warm-started solve
+        double initialBarrierParameter;
+        double boundPush;
+        double multiplierBoundPush;
+
+        if(useWarmStart)
         {
-            ipoptStatus = ipoptApplication->OptimizeTNLP(ipoptProblem);
+            env->output->outputDebug("        Warm starting Ipopt from an earlier solution.");
+
+            ipoptApplication->Options()->GetNumericValue("mu_init", initialBarrierParameter, "");
+            ipoptApplication->Options()->GetNumericValue("warm_start_bound_push", boundPush, "");
+            ipoptApplication->Options()->GetNumericValue("warm_start_mult_bound_push", multiplierBoundPush, "");
+
+            ipoptApplication->Options()->SetStringValue("warm_start_init_point", "yes");
+            ipoptApplication->Options()->SetNumericValue("warm_start_bound_push", 1e-6);
+            ipoptApplication->Options()->SetNumericValue("warm_start_mult_bound_push", 1e-6);
+            ipoptApplication->Options()->SetNumericValue("mu_init", 1e-4);
         }
-        else
+
+        // With fixed variables treated as parameters, the internal problem size depends on which variables are fixed
+        VectorInteger fixedVariables;
+
+        for(size_t i = 0; i < ipoptProblem->lowerBounds.size(); i++)
+        {
+            if(ipoptProblem->lowerBounds[i] == ipoptProblem->upperBounds[i])
+                fixedVariables.push_back(i);
+        }
+
+        std::unique_lock<std::mutex> linearSolverLock(linearSolverMutex, std::defer_lock);
+
+        if(!isLinearSolverThreadSafe(env))
+            linearSolverLock.lock();
+
+        if(hasBeenSolved && ipoptProblem->maxNumberOfWarmStartPoints > 0 && fixedVariables == previouslyFixedVariables)
         {
             ipoptStatus = ipoptApplication->ReOptimizeTNLP(ipoptProblem);
+        }
+        else
+        {
+            ipoptStatus = ipoptApplication->OptimizeTNLP(ipoptProblem);
             hasBeenSolved = true;
         }
 
+        if(linearSolverLock.owns_lock())
+            linearSolverLock.unlock();
+
+        previouslyFixedVariables = std::move(fixedVariables);
+
+        // Makes the decision from the evaluation times in this solve if not made before
+        updateHessianApproximation();
+
+        if(useWarmStart)
+        {
+            ipoptApplication->Options()->SetStringValue("warm_start_init_point", "no");
+            ipoptApplication->Options()->SetNumericValue("mu_init", initialBarrierParameter);
+            ipoptApplication->Options()->SetNumericValue("warm_start_bound_push", boundPush);
+            ipoptApplication->Options()->SetNumericValue("warm_start_mult_bound_push", multiplierBoundPush);
+        }
+
         switch(ipoptStatus)
         {
         case Ipopt::ApplicationReturnStatus::Solve_Succeeded:
@@ -742,6 +846,11 @@ E_NLPSolutionStatus NLPSolverIpoptBase::solveProblemInstance()
             env->output->outputDebug("        No solution found to problem with Ipopt: Time limit exceeded.");
             break;
 
+        case Ipopt::ApplicationReturnStatus::User_Requested_Stop:
+            status = E_NLPSolutionStatus::TimeLimit;
+            env->output->outputDebug("        No solution found to problem with Ipopt: Solver was cancelled.");
+            break;
+
         case Ipopt::ApplicationReturnStatus::Diverging_Iterates:
             status = E_NLPSolutionStatus::Unbounded;
             env->output->outputDebug("        No solution found to problem with Ipopt: Diverging iterates.");
@@ -848,6 +957,19 @@ VectorDouble NLPSolverIpoptBase::getVariableUpperBounds() { return (ipoptProblem
 
 VectorDouble NLPSolverIpoptBase::getSolution() { return (ipoptProblem->variableSolution); }
 
+VectorDouble NLPSolverIpoptBase::getConstraintMultipliers() { return (ipoptProblem->constraintMultipliers); }
+
+bool NLPSolverIpoptBase::setScreeningTolerances(double relativeTolerance, int iterationLimit)
+{
+    // The constraint violation tolerance is kept, so that the solutions can still be primal solutions
+    ipoptApplication->Options()->SetNumericValue("tol", relativeTolerance);
+    ipoptApplication->Options()->SetIntegerValue("max_iter", iterationLimit);
+
+    return (true);
+}
+
+void NLPSolverIpoptBase::resetTolerances() { setSolverSpecificInitialSettings(); }
+
 void NLPSolverIpoptBase::setInitialSettings()
 {
     std::string subsolver = "";
@@ -915,9 +1037,105 @@ void NLPSolverIpoptBase::setInitialSettings()
     if(sourceProblem->properties.isMIQPProblem)
         ipoptApplication->Options()->SetStringValue("hessian_constant", "yes", true, true);
 
+    if(env->settings->getSetting<bool>("Ipopt.WarmStart.Use", "Subsolver"))
+    {
+        ipoptProblem->maxNumberOfWarmStartPoints
+            = env->settings->getSetting<int>("Ipopt.WarmStart.NumberOfPoints", "Subsolver");
+    }
+    else
+    {
+        ipoptProblem->maxNumberOfWarmStartPoints = 0;
+        ipoptProblem->warmStartPoints.clear();
+    }
+
+    switch(static_cast<ES_IpoptHessianApproximation>(
+        env->settings->getSetting<int>("Ipopt.HessianApproximation", "Subsolver")))
+    {
+    case(ES_IpoptHessianApproximation::LimitedMemory):
+        setHessianApproximation(true);
+        break;
+
+    case(ES_IpoptHessianApproximation::Automatic):
+        // The Hessian is constant for quadratic problems, and not needed for linear ones
+        useAutomaticHessianApproximation
+            = sourceProblem->properties.isNonlinear && !sourceProblem->properties.isMIQPProblem;
+        break;
+
+    case(ES_IpoptHessianApproximation::Exact):
+    default:
+        break;
+    }
+
     setSolverSpecificInitialSettings();
 }
 
+void NLPSolverIpoptBase::setHessianApproximation(bool useApproximation)
+{
+    ipoptApplication->Options()->SetStringValue(
+        "hessian_approximation", useApproximation ? "limited-memory" : "exact");
+
+    isHessianApproximated = useApproximation;
+}
+
+void NLPSolverIpoptBase::updateHessianApproximation()
+{
+    if(!useAutomaticHessianApproximation)
+        return;
+
+    if(sourceProblem->useHessianApproximation < 0)
+    {
+        auto& pattern = sourceProblem->getLagrangianHessianSparsityPatternCSR();
+        double numberOfNonlinearVariables = sourceProblem->nonlinearVariables.size();
+        double density = (numberOfNonlinearVariables > 0)
+            ? pattern.numberOfNonzeros() / (numberOfNonlinearVariables * (numberOfNonlinearVariables + 1) / 2)
+            : 0.0;
+
+        bool useApproximation;
+
+        // A dense Hessian in many variables is expensive to factorize, so this is decided before the first solve
+        if(numberOfNonlinearVariables
+                >= env->settings->getSetting<int>("Ipopt.HessianApproximation.NonlinearVariables", "Subsolver")
+            && density >= env->settings->getSetting<double>("Ipopt.HessianApproximation.Density", "Subsolver"))
+        {
+            useApproximation = true;
+        }
+        else if(ipoptProblem->firstHessianEvaluationTime >= 0 && ipoptProblem->firstJacobianEvaluationTime >= 0)
+        {
+            // Otherwise the approximation is used if evaluating the Hessian is much more expensive than the Jacobian
+            useApproximation = ipoptProblem->firstHessianEvaluationTime
+                > env->settings->getSetting<double>("Ipopt.HessianApproximation.TimeRatio", "Subsolver")
+                    * std::max(ipoptProblem->firstJacobianEvaluationTime, 1e-4);
+        }
+        else
+        {
+            // Not measured yet
+            return;
+        }
+
+        int undecided = -1;
+
+        if(sourceProblem->useHessianApproximation.compare_exchange_strong(undecided, useApproximation ? 1 : 0))
+        {
+            env->output->outputDebug(fmt::format(
+                "        Using the {} Hessian in Ipopt: {} nonzeros with density {} in {} nonlinear variables, first "
+                "evaluation times {} s (Hessian) and {} s (Jacobian).",
+                useApproximation ? "limited-memory approximation of the" : "exact", pattern.numberOfNonzeros(),
+                density, numberOfNonlinearVariables, ipoptProblem->firstHessianEvaluationTime,
+                ipoptProblem->firstJacobianEvaluationTime));
+        }
+    }
+
+    bool useApproximation = (sourceProblem->useHessianApproximation == 1);
+
+    if(useApproximation != isHessianApproximated)
+    {
+        setHessianApproximation(useApproximation);
+
+        // Ipopt must be set up again for the changed option
+        hasBeenSolved = false;
+    }
+}
+
 void NLPSolverIpoptBase::fixVariables(VectorInteger variableIndexes, VectorDouble variableValues)
 {
     ipoptProblem->fixedVariableIndexes = variableIndexes;
@@ -1045,6 +1263,21 @@ void NLPSolverIpoptBase::saveOptionsToFile([[maybe_unused]] std::string fileName
 
 void NLPSolverIpoptBase::saveProblemToFile([[maybe_unused]] std::string fileName) { }
 
+bool NLPSolverIpoptBase::isLinearSolverThreadSafe(EnvironmentPtr env)
+{
+    switch(static_cast<ES_IpoptSolver>(env->settings->getSetting<int>("Ipopt.LinearSolver", "Subsolver")))
+    {
+    case(ES_IpoptSolver::ma27):
+    case(ES_IpoptSolver::ma57):
+    case(ES_IpoptSolver::ma86):
+    case(ES_IpoptSolver::ma97):
+        return (true);
+
+    default:
+        return (false);
+    }
+}
+
 std::string NLPSolverIpoptBase::getSolverDescription()
 {
     std::string linearSolver = "";
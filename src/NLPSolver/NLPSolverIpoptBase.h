@@ -17,6 +17,8 @@
 
 #include "../Model/Problem.h"
 
+#include <deque>
+
 namespace SHOT
 {
 
@@ -64,11 +66,36 @@ public:
     VectorDouble variableSolution;
     double objectiveValue;
 
+    // The multipliers of the constraints in the Lagrangian f + lambda^T g, empty if there is no solution
+    VectorDouble constraintMultipliers;
+
     E_NLPSolutionStatus solutionStatus;
     std::string solutionDescription;
 
     double divergingIterativesTolerance = 1e20;
 
+    // The times in seconds of the first evaluations of the Jacobian and the Lagrangian Hessian, negative if not made
+    double firstJacobianEvaluationTime = -1.0;
+    double firstHessianEvaluationTime = -1.0;
+
+    // A primal-dual solution of an earlier solve, used to warm start a solve with nearby fixed variable values
+    struct WarmStartPoint
+    {
+        VectorInteger fixedVariableIndexes;
+        VectorDouble fixedVariableValues;
+        VectorDouble variableValues;
+        VectorDouble lowerBoundMultipliers;
+        VectorDouble upperBoundMultipliers;
+        VectorDouble constraintMultipliers;
+    };
+
+    std::deque<WarmStartPoint> warmStartPoints;
+    size_t maxNumberOfWarmStartPoints = 0; // No points are saved if zero
+    int selectedWarmStartPoint = -1; // The point used by get_starting_point(), -1 if none
+
+    // Selects the saved point with the same fixed variables and the nearest fixed values, returns false if none
+    bool selectWarmStartPoint();
+
     /** the IpoptProblemclass constructor */
     IpoptProblem(EnvironmentPtr envPtr, ProblemPtr problem);
     ~IpoptProblem() override = default;
@@ -131,13 +158,21 @@ public:
         const Ipopt::Number* z_U, Ipopt::Index m, const Ipopt::Number* g, const Ipopt::Number* lambda,
         Ipopt::Number obj_value, const Ipopt::IpoptData* ip_data, Ipopt::IpoptCalculatedQuantities* ip_cq) override;
 
+    /** This method is called in each iteration, the algorithm is stopped if the solver has been cancelled */
+    bool intermediate_callback(Ipopt::AlgorithmMode mode, Ipopt::Index iter, Ipopt::Number obj_value,
+        Ipopt::Number inf_pr, Ipopt::Number inf_du, Ipopt::Number mu, Ipopt::Number d_norm,
+        Ipopt::Number regularization_size, Ipopt::Number alpha_du, Ipopt::Number alpha_pr, Ipopt::Index ls_trials,
+        const Ipopt::IpoptData* ip_data, Ipopt::IpoptCalculatedQuantities* ip_cq) override;
+
 private:
     EnvironmentPtr env;
 
     ProblemPtr sourceProblem;
 
-    std::map<std::pair<int, int>, int> lagrangianHessianCounterPlacement;
-    std::map<std::pair<int, int>, int> jacobianCounterPlacement;
+    // The Jacobian elements of the linear constraints are constant and written only once to the values array
+    const Ipopt::Number* linearJacobianValues = nullptr;
+
+    VectorDouble jacobianPoint;
 };
 
 class NLPSolverIpoptBase : virtual public INLPSolver
@@ -161,6 +196,14 @@ protected:
     virtual void setSolverSpecificInitialSettings() = 0;
     virtual void updateSettings();
 
+    bool useAutomaticHessianApproximation = false;
+    bool isHessianApproximated = false;
+
+    // Uses the exact Hessian or the limited-memory approximation according to the decision for the problem, and
+    // makes the decision from the measured evaluation times after the first solve if it has not been made
+    void updateHessianApproximation();
+    void setHessianApproximation(bool useApproximation);
+
     VectorDouble getVariableLowerBounds() override;
     VectorDouble getVariableUpperBounds() override;
 
@@ -170,6 +213,9 @@ protected:
     VectorDouble lowerBoundsBeforeFix;
     VectorDouble upperBoundsBeforeFix;
 
+    // The variables with equal bounds in the last solve, Ipopt can only be reoptimized if these are unchanged
+    VectorInteger previouslyFixedVariables;
+
     std::vector<E_VariableType> originalVariableType;
 
 public:
@@ -182,9 +228,20 @@ public:
     double getSolution(int i) override;
     double getObjectiveValue() override;
 
+    // The multipliers of the constraints at the solution from the last solve, in the order of the numeric constraints
+    VectorDouble getConstraintMultipliers();
+
+    bool setScreeningTolerances(double relativeTolerance, int iterationLimit) override;
+    void resetTolerances() override;
+
     void saveOptionsToFile(std::string fileName) override;
     void saveProblemToFile(std::string fileName) override;
 
     std::string getSolverDescription() override;
+
+    // Whether Ipopt can be used by several threads at the same time with the linear solver in Ipopt.LinearSolver. Only
+    // the HSL solvers are known to be thread-safe, not the MUMPS used by default. Otherwise the solves of all Ipopt
+    // solvers are made one at a time.
+    static bool isLinearSolverThreadSafe(EnvironmentPtr env);
 };
 } // namespace SHOT
\ No newline at end of file
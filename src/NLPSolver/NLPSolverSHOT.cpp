@@ -10,6 +10,7 @@
 
 #include "NLPSolverSHOT.h"
 
+#include "../CancellationToken.h"
 #include "../DualSolver.h"
 #include "../Environment.h"
 #include "../Iteration.h"
@@ -219,8 +220,13 @@ E_NLPSolutionStatus NLPSolverSHOT::solveProblemInstance()
         problemInfoPrinted = true;
     }
 
-    if(!solver->solveProblem())
-        return E_NLPSolutionStatus::Error;
+    // After the first problem only the bounds have changed, so the polyhedral approximation is kept
+    {
+        ScopedCancellationCallback cancelSubsolver(env->cancellationToken, [this] { solver->cancel(); });
+
+        if(!solver->resolveProblem())
+            return E_NLPSolutionStatus::Error;
+    }
 
     solver->getEnvironment()->report->outputSolutionReport();
 
@@ -228,18 +234,27 @@ E_NLPSolutionStatus NLPSolverSHOT::solveProblemInstance()
 
     int hyperplaneCounter = 0;
 
+    auto& generatedHyperplanes = solver->getEnvironment()->dualSolver->generatedHyperplanes;
+
     if(env->settings->getSetting<bool>("SHOT.ReuseHyperplanes.Use", "Subsolver"))
     {
-        int numHyperplanesToCopy = solver->getEnvironment()->dualSolver->generatedHyperplanes.size()
+        // Only the hyperplanes generated for this problem are copied, since the earlier ones are kept in the solver
+        int numHyperplanesToCopy = (generatedHyperplanes.size() - numberOfCopiedHyperplanes)
             * env->settings->getSetting<double>("SHOT.ReuseHyperplanes.Fraction", "Subsolver");
 
-        for(auto& HP : solver->getEnvironment()->dualSolver->generatedHyperplanes)
+        for(size_t i = numberOfCopiedHyperplanes; i < generatedHyperplanes.size(); i++)
         {
+            auto& HP = generatedHyperplanes[i];
+
             if(hyperplaneCounter >= numHyperplanesToCopy)
                 break;
 
+            if(!HP.generatedPoint)
+                continue;
+
+            auto generatedPoint = HP.generatedPoint->getValues();
             std::vector<double> tmpSolPt(
-                HP.generatedPoint.begin(), HP.generatedPoint.begin() + env->problem->properties.numberOfVariables);
+                generatedPoint.begin(), generatedPoint.begin() + env->problem->properties.numberOfVariables);
 
             if((int)tmpSolPt.size() < env->reformulatedProblem->properties.numberOfVariables)
                 env->reformulatedProblem->augmentAuxiliaryVariableValues(tmpSolPt);
@@ -272,12 +287,12 @@ E_NLPSolutionStatus NLPSolverSHOT::solveProblemInstance()
             hyperplaneCounter++;
         }
 
-        solver->getEnvironment()->dualSolver->generatedHyperplanes.clear();
-
         solver->getEnvironment()->output->outputInfo(
             fmt::format(" Added {} hyperplanes generated by SHOT primal NLP solver.", hyperplaneCounter));
     }
 
+    numberOfCopiedHyperplanes = generatedHyperplanes.size();
+
     E_NLPSolutionStatus status;
 
     auto terminationReason = solver->getEnvironment()->results->terminationReason;
@@ -26,6 +26,9 @@ private:
 
     bool problemInfoPrinted = false;
 
+    // The hyperplanes in the dual solver of the inner solver that have already been considered for the outer one
+    size_t numberOfCopiedHyperplanes = 0;
+
     void initializeMIPProblem();
 
 public:
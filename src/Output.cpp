@@ -24,11 +24,8 @@ Output::Output()
     SetConsoleOutputCP(CP_UTF8); // For correct output of special characters on Windows
 #endif
 
-    consoleSink = std::make_shared<spdlog::sinks::stdout_sink_st>();
-    std::vector<spdlog::sink_ptr> sinks { consoleSink };
-    logger = std::make_shared<spdlog::logger>("multi_sink", sinks.begin(), sinks.end());
-
-    logger->set_pattern("%v");
+    consoleSink = std::make_shared<spdlog::sinks::stdout_sink_mt>();
+    createLogger();
 
     // The maximum level of logging to use by all sinks
     logger->set_level(spdlog::level::info);
@@ -36,7 +33,55 @@ Output::Output()
 
 Output::~Output() = default;
 
-void Output::setPrefix(std::string prefix) { logger->set_pattern(prefix + "%v"); }
+void Output::createLogger()
+{
+    std::vector<spdlog::sink_ptr> sinks { consoleSink };
+
+    if(fileSink)
+        sinks.push_back(fileSink);
+
+    auto level = logger ? logger->level() : spdlog::level::info;
+
+    if(threadPool)
+    {
+        logger = std::make_shared<spdlog::async_logger>(
+            "multi_sink", sinks.begin(), sinks.end(), threadPool, spdlog::async_overflow_policy::block);
+    }
+    else
+    {
+        logger = std::make_shared<spdlog::logger>("multi_sink", sinks.begin(), sinks.end());
+    }
+
+    logger->set_pattern(pattern);
+    logger->set_level(level);
+}
+
+void Output::setPrefix(std::string prefix)
+{
+    pattern = prefix + "%v";
+    logger->set_pattern(pattern);
+}
+
+void Output::setAsynchronous(bool useAsynchronous, size_t queueSize)
+{
+    if(useAsynchronous == (threadPool != nullptr))
+        return;
+
+    logger->flush();
+
+    if(useAsynchronous)
+    {
+        threadPool = std::make_shared<spdlog::details::thread_pool>(std::max((size_t)1, queueSize), 1);
+        createLogger();
+    }
+    else
+    {
+        createLogger();
+
+        // Writes the remaining queued messages and stops the logging thread
+        threadPool.reset();
+    }
+}
 
 void Output::outputCritical(std::string message) { logger->critical(message); }
 
@@ -159,14 +204,11 @@ void Output::setConsoleSink(std::shared_ptr<spdlog::sinks::sink> newSink)
 
 void Output::setFileSink(std::string filename)
 {
-    fileSink = std::make_shared<spdlog::sinks::basic_file_sink_st>(filename, true);
+    fileSink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(filename, true);
     fileSink->set_pattern("%v");
     fileSink->set_level(consoleSink->level());
 
-    std::vector<spdlog::sink_ptr> sinks { consoleSink, fileSink };
-    logger = std::make_shared<spdlog::logger>("multi_sink", sinks.begin(), sinks.end());
-
-    logger->set_pattern("%v");
+    createLogger();
 }
 
 int OutputStream::overflow(int c)
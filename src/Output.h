@@ -14,6 +14,7 @@
 #include <memory>
 
 #include "spdlog/spdlog.h"
+#include "spdlog/async.h"
 #include "spdlog/sinks/stdout_sinks.h"
 #include "spdlog/sinks/basic_file_sink.h"
 
@@ -34,6 +35,37 @@ public:
     void outputDebug(std::string message);
     void outputTrace(std::string message);
 
+    // As above, but the message is only formatted if it will be logged, e.g. outputDebug("Cut {} added.", index). These
+    // should be used instead of formatting the message in the caller on the hot paths, since debug and trace messages
+    // are not logged on the default log level.
+    template <typename Arg, typename... Args>
+    inline void outputDebug(const char* format, const Arg& argument, const Args&... arguments)
+    {
+        if(logger->should_log(spdlog::level::debug))
+            logger->debug(format, argument, arguments...);
+    }
+
+    template <typename Arg, typename... Args>
+    inline void outputTrace([[maybe_unused]] const char* format, [[maybe_unused]] const Arg& argument,
+        [[maybe_unused]] const Args&... arguments)
+    {
+#ifndef NDEBUG
+        if(logger->should_log(spdlog::level::trace))
+            logger->trace(format, argument, arguments...);
+#endif
+    }
+
+    inline bool isDebugEnabled() const { return (logger->should_log(spdlog::level::debug)); }
+
+    inline bool isTraceEnabled() const
+    {
+#ifndef NDEBUG
+        return (logger->should_log(spdlog::level::trace));
+#else
+        return (false);
+#endif
+    }
+
     void setLogLevels(E_LogLevel consoleLogLevel, E_LogLevel fileLogLevel);
 
     void setConsoleSink(std::shared_ptr<spdlog::sinks::sink> newSink);
@@ -44,11 +76,24 @@ public:
 
     void setPrefix(std::string prefix);
 
+    // If enabled, the messages are put in a bounded queue and written to the sinks by a separate thread, so that the
+    // solver threads do not wait for the console or file output. The thread logging a message waits if the queue is
+    // full, so no messages are lost.
+    void setAsynchronous(bool useAsynchronous, size_t queueSize);
+
 private:
+    // Recreates the logger with the current sinks, keeping the log level and pattern
+    void createLogger();
+
     std::shared_ptr<spdlog::sinks::sink> consoleSink;
-    std::shared_ptr<spdlog::sinks::basic_file_sink_st> fileSink;
+    std::shared_ptr<spdlog::sinks::basic_file_sink_mt> fileSink;
+
+    // Declared before the logger so that the queued messages are written before the thread pool is destroyed
+    std::shared_ptr<spdlog::details::thread_pool> threadPool;
 
     std::shared_ptr<spdlog::logger> logger;
+
+    std::string pattern = "%v";
 };
 
 class Environment;
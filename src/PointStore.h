@@ -0,0 +1,202 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Structs.h"
+#include "CutStore.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// An immutable point created by a PointStore. The values that are zero or at one of the reference bounds of the store
+// are kept as two bits each, and only the other values are kept as doubles. A point created by a CutStore is only kept
+// in its file.
+class StoredPoint
+{
+public:
+    size_t size() const { return (numberOfValues); }
+
+    VectorDouble getValues() const
+    {
+        if(cutStore)
+            return (cutStore->readPoint(cutStoreOffset));
+
+        VectorDouble values(numberOfValues);
+        size_t nextExplicitValue = 0;
+
+        for(size_t i = 0; i < numberOfValues; i++)
+        {
+            switch(getCode(i))
+            {
+            case Code::Zero:
+                values[i] = 0.0;
+                break;
+            case Code::LowerBound:
+                values[i] = bounds->first[i];
+                break;
+            case Code::UpperBound:
+                values[i] = bounds->second[i];
+                break;
+            default:
+                values[i] = explicitValues[nextExplicitValue++];
+                break;
+            }
+        }
+
+        return (values);
+    }
+
+    // The number of bytes allocated for the values, the reference bounds are shared by the points and not included
+    size_t getMemoryUsage() const
+    {
+        return (sizeof(StoredPoint) + codes.capacity() * sizeof(uint64_t) + explicitValues.capacity() * sizeof(double));
+    }
+
+    bool isEqual(const VectorDouble& point) const
+    {
+        if(point.size() != numberOfValues)
+            return (false);
+
+        return (getValues() == point);
+    }
+
+private:
+    friend class PointStore;
+    friend class CutStore;
+
+    enum class Code : uint64_t
+    {
+        Explicit = 0,
+        Zero = 1,
+        LowerBound = 2,
+        UpperBound = 3
+    };
+
+    Code getCode(size_t index) const { return (static_cast<Code>((codes[index / 32] >> (2 * (index % 32))) & 3)); }
+
+    size_t numberOfValues = 0;
+    std::vector<uint64_t> codes; // 32 values in each word
+    VectorDouble explicitValues;
+
+    std::shared_ptr<const std::pair<VectorDouble, VectorDouble>> bounds;
+
+    std::shared_ptr<CutStore> cutStore;
+    int64_t cutStoreOffset = -1;
+};
+
+// Stores each point once, e.g. the points of the generated cuts when several cuts are generated in the same point, and
+// returns a shared handle to it. The points are compressed against the reference bounds, which are usually the variable
+// bounds when the first point is stored, since many values in the points are at a bound.
+class PointStore
+{
+public:
+    PointStore() = default;
+
+    bool hasReferenceBounds() const { return (bounds != nullptr); }
+
+    // The bounds are kept by the points already stored, so they can be changed at any time
+    void setReferenceBounds(VectorDouble lowerBounds, VectorDouble upperBounds)
+    {
+        bounds = std::make_shared<const std::pair<VectorDouble, VectorDouble>>(
+            std::move(lowerBounds), std::move(upperBounds));
+    }
+
+    // The hash is e.g. Utilities::calculateHash(point), the values of points with another size than the reference
+    // bounds are all kept as doubles
+    StoredPointPtr add(const VectorDouble& point, uint64_t hash)
+    {
+        auto& pointsWithHash = points[hash];
+
+        for(auto& P : pointsWithHash)
+        {
+            if(P->isEqual(point))
+                return (P);
+        }
+
+        auto storedPoint = std::make_shared<StoredPoint>();
+        storedPoint->numberOfValues = point.size();
+
+        bool useBounds = (bounds && bounds->first.size() == point.size() && bounds->second.size() == point.size());
+
+        if(useBounds)
+        {
+            storedPoint->bounds = bounds;
+            storedPoint->codes.resize((point.size() + 31) / 32, 0);
+        }
+        else
+        {
+            storedPoint->explicitValues = point;
+        }
+
+        for(size_t i = 0; useBounds && i < point.size(); i++)
+        {
+            auto code = StoredPoint::Code::Explicit;
+
+            if(point[i] == 0.0)
+                code = StoredPoint::Code::Zero;
+            else if(point[i] == bounds->first[i])
+                code = StoredPoint::Code::LowerBound;
+            else if(point[i] == bounds->second[i])
+                code = StoredPoint::Code::UpperBound;
+
+            if(code == StoredPoint::Code::Explicit)
+                storedPoint->explicitValues.push_back(point[i]);
+            else
+                storedPoint->codes[i / 32] |= (static_cast<uint64_t>(code) << (2 * (i % 32)));
+        }
+
+        storedPoint->explicitValues.shrink_to_fit();
+
+        pointsWithHash.push_back(storedPoint);
+        numberOfPoints++;
+
+        return (pointsWithHash.back());
+    }
+
+    size_t size() const { return (numberOfPoints); }
+
+    size_t getMemoryUsage() const
+    {
+        size_t bytes = 0;
+
+        if(bounds)
+            bytes += (bounds->first.capacity() + bounds->second.capacity()) * sizeof(double);
+
+        for(auto& [hash, pointsWithHash] : points)
+        {
+            bytes += sizeof(hash) + pointsWithHash.capacity() * sizeof(StoredPointPtr);
+
+            for(auto& P : pointsWithHash)
+                bytes += P->getMemoryUsage();
+        }
+
+        return (bytes);
+    }
+
+    // The points already returned are not affected
+    void clear()
+    {
+        points.clear();
+        bounds.reset();
+        numberOfPoints = 0;
+    }
+
+private:
+    std::shared_ptr<const std::pair<VectorDouble, VectorDouble>> bounds;
+    std::unordered_map<uint64_t, std::vector<StoredPointPtr>> points;
+    size_t numberOfPoints = 0;
+};
+} // namespace SHOT
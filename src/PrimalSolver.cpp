@@ -22,7 +22,7 @@
 namespace SHOT
 {
 
-void PrimalSolver::addPrimalSolutionCandidate(VectorDouble pt, E_PrimalSolutionSource source, int iter)
+void PrimalSolver::addPrimalSolutionCandidate(const VectorDouble& pt, E_PrimalSolutionSource source, int iter)
 {
     PrimalSolution sol;
 
@@ -30,6 +30,7 @@ void PrimalSolver::addPrimalSolutionCandidate(VectorDouble pt, E_PrimalSolutionS
     sol.sourceType = source;
     sol.objValue = env->problem->objectiveFunction->calculateValue(pt);
     sol.iterFound = iter;
+    sol.areLinearConstraintsTrusted = areLinearConstraintsTrusted(source);
 
     if(env->problem->properties.numberOfNonlinearConstraints > 0)
     {
@@ -38,7 +39,7 @@ void PrimalSolver::addPrimalSolutionCandidate(VectorDouble pt, E_PrimalSolutionS
             = PairIndexValue(maxDevNonlinear.constraint->index, maxDevNonlinear.normalizedValue);
     }
 
-    if(env->problem->properties.numberOfLinearConstraints > 0)
+    if(env->problem->properties.numberOfLinearConstraints > 0 && !sol.areLinearConstraintsTrusted)
     {
         auto maxDevLinear = env->problem->getMaxNumericConstraintValue(pt, env->problem->linearConstraints);
         sol.maxDevatingConstraintLinear = PairIndexValue(maxDevLinear.constraint->index, maxDevLinear.normalizedValue);
@@ -49,7 +50,8 @@ void PrimalSolver::addPrimalSolutionCandidate(VectorDouble pt, E_PrimalSolutionS
     this->checkPrimalSolutionCandidates();
 }
 
-void PrimalSolver::addPrimalSolutionCandidates(std::vector<VectorDouble> pts, E_PrimalSolutionSource source, int iter)
+void PrimalSolver::addPrimalSolutionCandidates(
+    const std::vector<VectorDouble>& pts, E_PrimalSolutionSource source, int iter)
 {
     for(auto& PT : pts)
     {
@@ -57,7 +59,7 @@ void PrimalSolver::addPrimalSolutionCandidates(std::vector<VectorDouble> pts, E_
     }
 }
 
-void PrimalSolver::addPrimalSolutionCandidate(SolutionPoint pt, E_PrimalSolutionSource source)
+void PrimalSolver::addPrimalSolutionCandidate(const SolutionPoint& pt, E_PrimalSolutionSource source)
 {
     PrimalSolution sol;
 
@@ -65,13 +67,14 @@ void PrimalSolver::addPrimalSolutionCandidate(SolutionPoint pt, E_PrimalSolution
     sol.sourceType = source;
     sol.objValue = pt.objectiveValue;
     sol.iterFound = pt.iterFound;
+    sol.areLinearConstraintsTrusted = areLinearConstraintsTrusted(source);
 
     env->primalSolver->primalSolutionCandidates.push_back(sol);
 
     this->checkPrimalSolutionCandidates();
 }
 
-void PrimalSolver::addPrimalSolutionCandidates(std::vector<SolutionPoint> pts, E_PrimalSolutionSource source)
+void PrimalSolver::addPrimalSolutionCandidates(const std::vector<SolutionPoint>& pts, E_PrimalSolutionSource source)
 {
     for(auto& PT : pts)
     {
@@ -85,7 +88,7 @@ void PrimalSolver::checkPrimalSolutionCandidates()
 
     for(auto& cand : env->primalSolver->primalSolutionCandidates)
     {
-        this->checkPrimalSolutionPoint(cand);
+        this->checkPrimalSolutionPoint(std::move(cand));
     }
 
     env->primalSolver->primalSolutionCandidates.clear();
@@ -97,8 +100,9 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
 {
     std::string sourceDesc;
 
-    VectorDouble tmpPoint(
-        primalSol.point.begin(), primalSol.point.begin() + env->problem->properties.numberOfVariables);
+    // The point is checked and modified in place, without any auxiliary variable values
+    primalSol.point.resize(env->problem->properties.numberOfVariables);
+    auto& tmpPoint = primalSol.point;
 
     double tmpObjVal = primalSol.objValue;
 
@@ -127,6 +131,12 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
     case E_PrimalSolutionSource::InteriorPointSearch:
         sourceDesc = "Interior point search";
         break;
+    case E_PrimalSolutionSource::WarmStart:
+        sourceDesc = "warm start";
+        break;
+    case E_PrimalSolutionSource::FeasibilityPump:
+        sourceDesc = "feasibility pump";
+        break;
     default:
         sourceDesc = "other";
         break;
@@ -144,21 +154,9 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
     // Check that solution fulfills bounds, project back otherwise
     bool reCalculateObjective = false;
 
-    for(auto& V : env->problem->realVariables)
-    {
-        auto value = V->calculate(tmpPoint);
-
-        if(value > V->upperBound)
-        {
-            isVariableBoundsFulfilled = false;
-            tmpPoint.at(V->index) = V->upperBound;
-        }
-        else if(value < V->lowerBound)
-        {
-            isVariableBoundsFulfilled = false;
-            tmpPoint.at(V->index) = V->lowerBound;
-        }
-    }
+    // The real, binary and integer variables are projected using the bound vectors of the problem
+    if(!env->problem->projectToVariableBounds(tmpPoint))
+        isVariableBoundsFulfilled = false;
 
     for(auto& V : env->problem->semicontinuousVariables)
     {
@@ -259,38 +257,6 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
         }
     }
 
-    for(auto& V : env->problem->integerVariables)
-    {
-        auto value = V->calculate(tmpPoint);
-
-        if(value > V->upperBound)
-        {
-            isVariableBoundsFulfilled = false;
-            tmpPoint.at(V->index) = round(V->upperBound - 0.5);
-        }
-        else if(value < V->lowerBound)
-        {
-            isVariableBoundsFulfilled = false;
-            tmpPoint.at(V->index) = round(V->lowerBound + 0.5);
-        }
-    }
-
-    for(auto& V : env->problem->binaryVariables)
-    {
-        auto value = V->calculate(tmpPoint);
-
-        if(value > V->upperBound)
-        {
-            isVariableBoundsFulfilled = false;
-            tmpPoint.at(V->index) = 1.0;
-        }
-        else if(value < V->lowerBound)
-        {
-            isVariableBoundsFulfilled = false;
-            tmpPoint.at(V->index) = 0.0;
-        }
-    }
-
     if(!isVariableBoundsFulfilled)
     {
         reCalculateObjective = true;
@@ -310,8 +276,6 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
     {
         bool isRounded = false;
 
-        VectorDouble ptRounded(tmpPoint);
-
         double maxIntegerError = 0.0;
 
         for(auto& V : env->problem->integerVariables)
@@ -326,7 +290,7 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
 
             if(error > integerTol)
             {
-                ptRounded.at(index) = rounded;
+                tmpPoint.at(index) = rounded;
                 isRounded = true;
             }
         }
@@ -343,7 +307,7 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
 
             if(error > integerTol)
             {
-                ptRounded.at(index) = rounded;
+                tmpPoint.at(index) = rounded;
                 isRounded = true;
             }
         }
@@ -360,7 +324,7 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
 
             if(error > integerTol)
             {
-                ptRounded.at(index) = rounded;
+                tmpPoint.at(index) = rounded;
                 isRounded = true;
             }
         }
@@ -368,8 +332,6 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
         if(isRounded)
         {
             reCalculateObjective = true;
-            tmpPoint = ptRounded;
-
             auto tmpLine = fmt::format(
                 "         Discrete variables were not fulfilled to tolerance {}. Rounding performed...", integerTol);
             env->output->outputDebug(tmpLine);
@@ -394,24 +356,14 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
         return (false);
     }
 
-    // Recalculate the objective if rounding or projection has been performed
-    if(reCalculateObjective)
-    {
-        tmpObjVal = env->problem->objectiveFunction->calculateValue(tmpPoint);
-    }
-
-    // For example rootsearches may violate linear constraints
-    bool acceptableType = (primalSol.sourceType == E_PrimalSolutionSource::MIPSolutionPool
-        || primalSol.sourceType == E_PrimalSolutionSource::NLPFixedIntegers
-        || primalSol.sourceType == E_PrimalSolutionSource::LPFixedIntegers
-        || primalSol.sourceType == E_PrimalSolutionSource::MIPCallback
-        || primalSol.sourceType == E_PrimalSolutionSource::InteriorPointSearch);
-
-    if(!primalSol.integerRoundingPerformed && !primalSol.boundProjectionPerformed && acceptableType
-        && env->settings->getSetting<bool>("Tolerance.TrustLinearConstraintValues", "Primal"))
+    if(!primalSol.integerRoundingPerformed && !primalSol.boundProjectionPerformed
+        && primalSol.areLinearConstraintsTrusted)
     {
         env->output->outputDebug(
             "         Assuming that linear constraints are fulfilled since solution is from a subsolver.");
+
+        if(env->problem->properties.numberOfLinearConstraints > 0)
+            primalSol.maxDevatingConstraintLinear = PairIndexValue(-1, 0.0);
     }
     else
     {
@@ -419,17 +371,17 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
 
         if(env->problem->properties.numberOfLinearConstraints > 0)
         {
+            auto linTol = env->settings->getSetting<double>("Tolerance.LinearConstraint", "Primal");
+
             auto maxLinearConstraintValue
-                = env->problem->getMaxNumericConstraintValue(tmpPoint, env->problem->linearConstraints);
+                = env->problem->getMaxLinearConstraintValueOrFirstViolation(tmpPoint, linTol);
 
             mostDevLinearConstraints.index = maxLinearConstraintValue.constraint->index;
             mostDevLinearConstraints.value = maxLinearConstraintValue.normalizedValue;
 
-            auto linTol = env->settings->getSetting<double>("Tolerance.LinearConstraint", "Primal");
-
             if(maxLinearConstraintValue.error > linTol)
             {
-                auto tmpLine = fmt::format("         Linear constraints are not fulfilled. Most deviating {}: {} > {}.",
+                auto tmpLine = fmt::format("         Linear constraints are not fulfilled. Violated {}: {} > {}.",
                     maxLinearConstraintValue.constraint->name, maxLinearConstraintValue.error, linTol);
                 env->output->outputDebug(tmpLine);
 
@@ -451,17 +403,17 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
     {
         PairIndexValue mostDevQuadraticConstraints;
 
-        auto maxQuadraticConstraintValue
-            = env->problem->getMaxNumericConstraintValue(tmpPoint, env->problem->quadraticConstraints);
+        auto nonlinTol = env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal");
+
+        auto maxQuadraticConstraintValue = env->problem->getMaxNumericConstraintValueOrFirstViolation(
+            tmpPoint, env->problem->quadraticConstraints, nonlinTol);
 
         mostDevQuadraticConstraints.index = maxQuadraticConstraintValue.constraint->index;
         mostDevQuadraticConstraints.value = maxQuadraticConstraintValue.normalizedValue;
 
-        auto nonlinTol = env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal");
-
         if(mostDevQuadraticConstraints.value > nonlinTol)
         {
-            auto tmpLine = fmt::format("         Quadratic constraints are not fulfilled. Most deviating {}: {} > {}.",
+            auto tmpLine = fmt::format("         Quadratic constraints are not fulfilled. Violated {}: {} > {}.",
                 maxQuadraticConstraintValue.constraint->index, maxQuadraticConstraintValue.error, nonlinTol);
             env->output->outputDebug(tmpLine);
 
@@ -482,17 +434,17 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
     {
         PairIndexValue mostDevNonlinearConstraints;
 
-        auto maxNonlinearConstraintValue
-            = env->problem->getMaxNumericConstraintValue(tmpPoint, env->problem->nonlinearConstraints);
+        auto nonlinTol = env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal");
+
+        auto maxNonlinearConstraintValue = env->problem->getMaxNumericConstraintValueOrFirstViolation(
+            tmpPoint, env->problem->nonlinearConstraints, nonlinTol);
 
         mostDevNonlinearConstraints.index = maxNonlinearConstraintValue.constraint->index;
         mostDevNonlinearConstraints.value = maxNonlinearConstraintValue.normalizedValue;
 
-        auto nonlinTol = env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal");
-
         if(mostDevNonlinearConstraints.value > nonlinTol)
         {
-            auto tmpLine = fmt::format("         Nonlinear constraints are not fulfilled. Most deviating {}: {} > {}.",
+            auto tmpLine = fmt::format("         Nonlinear constraints are not fulfilled. Violated {}: {} > {}.",
                 maxNonlinearConstraintValue.constraint->index, mostDevNonlinearConstraints.value, nonlinTol);
             env->output->outputDebug(tmpLine);
 
@@ -508,21 +460,32 @@ bool PrimalSolver::checkPrimalSolutionPoint(PrimalSolution primalSol)
         primalSol.maxDevatingConstraintNonlinear = mostDevNonlinearConstraints;
     }
 
+    // Recalculated only for accepted points if rounding or projection has been performed, since the objective may be
+    // more expensive to evaluate than the constraints
+    if(reCalculateObjective)
+    {
+        tmpObjVal = env->problem->objectiveFunction->calculateValue(tmpPoint);
+    }
+
     primalSol.objValue = tmpObjVal;
 
-    // Make sure no extra (auxiliary) values are in the vector
-    if((int)tmpPoint.size() > env->problem->properties.numberOfVariables)
-        tmpPoint.resize(env->problem->properties.numberOfVariables);
+    env->results->addPrimalSolution(std::move(primalSol));
 
-    primalSol.point = tmpPoint;
+    return (true);
+}
 
-    env->results->addPrimalSolution(primalSol);
+bool PrimalSolver::areLinearConstraintsTrusted(E_PrimalSolutionSource source)
+{
+    // For example rootsearches may violate linear constraints
+    bool isTrustedSource = (source == E_PrimalSolutionSource::MIPSolutionPool
+        || source == E_PrimalSolutionSource::NLPFixedIntegers || source == E_PrimalSolutionSource::LPFixedIntegers
+        || source == E_PrimalSolutionSource::MIPCallback || source == E_PrimalSolutionSource::InteriorPointSearch);
 
-    return (true);
+    return (isTrustedSource && env->settings->getSetting<bool>("Tolerance.TrustLinearConstraintValues", "Primal"));
 }
 
 void PrimalSolver::addFixedNLPCandidate(
-    VectorDouble pt, E_PrimalNLPSource source, double objVal, int iter, PairIndexValue maxConstrDev)
+    const VectorDouble& pt, E_PrimalNLPSource source, double objVal, int iter, PairIndexValue maxConstrDev)
 {
     VectorDouble candidate(pt);
 
@@ -531,48 +494,85 @@ void PrimalSolver::addFixedNLPCandidate(
 
     assert((int)candidate.size() == env->reformulatedProblem->properties.numberOfVariables);
 
-    VectorInteger discretVariableValues;
-    discretVariableValues.reserve(env->reformulatedProblem->properties.numberOfDiscreteVariables);
-
-    for(auto& VAR : env->reformulatedProblem->allVariables)
-    {
-        if(VAR->properties.type == E_VariableType::Binary || VAR->properties.type == E_VariableType::Integer
-            || VAR->properties.type == E_VariableType::Semiinteger)
-            discretVariableValues.push_back(candidate[VAR->index]);
-    }
-
-    double pointHash;
+    uint64_t pointHash;
+    bool isTested;
 
     if(env->settings->getSetting<bool>("FixedInteger.OnlyUniqueIntegerCombinations", "Primal"))
     {
-        pointHash = Utilities::calculateHash(discretVariableValues);
+        initializeDiscreteVariables();
+
+        // The discrete variable values are rounded to the nearest integer
+        pointHash = Utilities::calculateHash(candidate, discreteVariableIndexes, 1.0);
+        isTested
+            = usedDiscreteAssignments.contains(discreteVariableIndexes, getDiscreteVariableValues(candidate));
     }
     else
     {
         pointHash = Utilities::calculateHash(candidate);
+        isTested = hasFixedNLPCandidateBeenTested(pointHash);
     }
 
-    if(!hasFixedNLPCandidateBeenTested(pointHash))
+    if(!isTested)
     {
         fixedPrimalNLPCandidates.push_back(
-            PrimalFixedNLPCandidate { candidate, source, objVal, iter, maxConstrDev, pointHash });
+            PrimalFixedNLPCandidate { std::move(candidate), source, objVal, iter, maxConstrDev, pointHash });
     }
     else
         env->output->outputDebug(
             fmt::format("        Candidate for fixed integer search with hash {} has been used already.", pointHash));
 }
 
-bool PrimalSolver::hasFixedNLPCandidateBeenTested(double hash)
+void PrimalSolver::addUsedFixedNLPCandidate(const PrimalFixedNLPCandidate& candidate)
 {
-    for(auto& IC : usedPrimalNLPCandidates)
+    usedPrimalNLPCandidates.push_back(candidate);
+    usedPrimalNLPCandidateHashes.add(candidate.discreteVariablePointHash);
+
+    if(env->settings->getSetting<bool>("FixedInteger.OnlyUniqueIntegerCombinations", "Primal"))
     {
-        if(Utilities::isAlmostEqual(IC.discreteVariablePointHash, hash, 1e-8))
-        {
-            return (true);
-        }
+        initializeDiscreteVariables();
+        usedDiscreteAssignments.add(discreteVariableIndexes, getDiscreteVariableValues(candidate.point));
+    }
+}
+
+bool PrimalSolver::hasFixedNLPCandidateBeenTested(uint64_t hash)
+{
+    return (usedPrimalNLPCandidateHashes.contains(hash));
+}
+
+
+void PrimalSolver::initializeDiscreteVariables()
+{
+    if(areDiscreteVariablesInitialized)
+        return;
+
+    auto& problem = env->reformulatedProblem;
+
+    std::vector<bool> isBinary(problem->properties.numberOfVariables, false);
+    discreteVariableIndexes.reserve(problem->properties.numberOfDiscreteVariables);
+
+    for(auto& VAR : problem->allVariables)
+    {
+        if(VAR->properties.type == E_VariableType::Binary || VAR->properties.type == E_VariableType::Integer
+            || VAR->properties.type == E_VariableType::Semiinteger)
+            discreteVariableIndexes.push_back(VAR->index);
+
+        if(VAR->properties.type == E_VariableType::Binary)
+            isBinary[VAR->index] = true;
     }
 
-    return (false);
+    usedDiscreteAssignments.setBinaryVariables(std::move(isBinary));
+    areDiscreteVariablesInitialized = true;
+}
+
+VectorDouble PrimalSolver::getDiscreteVariableValues(const VectorDouble& point)
+{
+    VectorDouble values;
+    values.reserve(discreteVariableIndexes.size());
+
+    for(auto I : discreteVariableIndexes)
+        values.push_back(point[I]);
+
+    return (values);
 }
 
 } // namespace SHOT
\ No newline at end of file
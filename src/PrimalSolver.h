@@ -12,6 +12,8 @@
 #include "Environment.h"
 #include "Enums.h"
 #include "Structs.h"
+#include "HashIndex.h"
+#include "DiscreteAssignmentSet.h"
 
 namespace SHOT
 {
@@ -27,20 +29,22 @@ public:
         fixedPrimalNLPCandidates.clear();
     }
 
-    void addPrimalSolutionCandidate(VectorDouble pt, E_PrimalSolutionSource source, int iter);
-    void addPrimalSolutionCandidates(std::vector<VectorDouble> pts, E_PrimalSolutionSource source, int iter);
+    void addPrimalSolutionCandidate(const VectorDouble& pt, E_PrimalSolutionSource source, int iter);
+    void addPrimalSolutionCandidates(const std::vector<VectorDouble>& pts, E_PrimalSolutionSource source, int iter);
 
-    void addPrimalSolutionCandidate(SolutionPoint pt, E_PrimalSolutionSource source);
-    void addPrimalSolutionCandidates(std::vector<SolutionPoint> pts, E_PrimalSolutionSource source);
+    void addPrimalSolutionCandidate(const SolutionPoint& pt, E_PrimalSolutionSource source);
+    void addPrimalSolutionCandidates(const std::vector<SolutionPoint>& pts, E_PrimalSolutionSource source);
 
     void checkPrimalSolutionCandidates();
 
+    // The solution is modified while checked and moved to the results, pass it with std::move when not used after
     bool checkPrimalSolutionPoint(PrimalSolution primalSol);
 
     void addFixedNLPCandidate(
-        VectorDouble pt, E_PrimalNLPSource source, double objVal, int iter, PairIndexValue maxConstrDev);
+        const VectorDouble& pt, E_PrimalNLPSource source, double objVal, int iter, PairIndexValue maxConstrDev);
 
-    bool hasFixedNLPCandidateBeenTested(double hash);
+    void addUsedFixedNLPCandidate(const PrimalFixedNLPCandidate& candidate);
+    bool hasFixedNLPCandidateBeenTested(uint64_t hash);
 
     std::vector<PrimalSolution> primalSolutionCandidates;
     std::vector<PrimalFixedNLPCandidate> fixedPrimalNLPCandidates;
@@ -48,6 +52,22 @@ public:
 
 private:
     EnvironmentPtr env;
+
+    HashIndex usedPrimalNLPCandidateHashes;
+
+    // The discrete variable values of the used candidates, checked instead of the hashes with
+    // FixedInteger.OnlyUniqueIntegerCombinations since the hashes may coincide for different combinations
+    DiscreteAssignmentSet usedDiscreteAssignments;
+
+    // The discrete variables of the reformulated problem, set on first use
+    VectorInteger discreteVariableIndexes;
+    bool areDiscreteVariablesInitialized = false;
+
+    // Whether the solutions from the source fulfill the linear constraints, so that these need not be checked
+    bool areLinearConstraintsTrusted(E_PrimalSolutionSource source);
+
+    void initializeDiscreteVariables();
+    VectorDouble getDiscreteVariableValues(const VectorDouble& point);
 };
 
 } // namespace SHOT
\ No newline at end of file
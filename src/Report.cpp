@@ -12,6 +12,7 @@
 
 #include "DualSolver.h"
 #include "Iteration.h"
+#include "MemoryMonitor.h"
 #include "MIPSolver/IMIPSolver.h"
 #include "Output.h"
 #include "PrimalSolver.h"
@@ -410,6 +411,9 @@ void Report::outputOptionsReport()
     case(E_SolutionStrategy::MIQCQP):
         env->output->outputInfo(" Dual strategy:              MIQCQP version");
         break;
+    case(E_SolutionStrategy::Decomposition):
+        env->output->outputInfo(" Dual strategy:              Benders decomposition");
+        break;
     default:
         break;
     }
@@ -886,6 +890,10 @@ void Report::outputProblemInstanceReport()
             value > 0)
             env->output->outputInfo(fmt::format(" {:56s}{:d}", " - continuous bilinear term extraction:", value));
 
+        if(auto value = env->results->getAuxiliaryVariableCounter(E_AuxiliaryVariableType::BilinearPartitioning);
+            value > 0)
+            env->output->outputInfo(fmt::format(" {:56s}{:d}", " - continuous bilinear term partitioning:", value));
+
         if(auto value = env->results->getAuxiliaryVariableCounter(E_AuxiliaryVariableType::BinaryBilinear); value > 0)
             env->output->outputInfo(fmt::format(" {:56s}{:d}", " - binary bilinear term reformulation:", value));
 
@@ -1227,6 +1235,12 @@ void Report::outputSolutionReport()
             case E_PrimalSolutionSource::InteriorPointSearch:
                 sourceDesc = "Interior point search";
                 break;
+            case E_PrimalSolutionSource::WarmStart:
+                sourceDesc = "warm start";
+                break;
+            case E_PrimalSolutionSource::FeasibilityPump:
+                sourceDesc = "feasibility pump";
+                break;
             default:
                 sourceDesc = "other";
                 break;
@@ -1239,13 +1253,56 @@ void Report::outputSolutionReport()
     }
 
     for(auto& T : env->timing->timers)
-    {
         T.stop();
+
+    // The timers are shown as a nested breakdown, where each timer is directly followed by its children
+    for(auto ID : env->timing->getTimerHierarchy())
+    {
+        auto& T = env->timing->timers[ID];
         auto elapsed = T.elapsed();
 
-        if(elapsed > 0)
-            env->output->outputInfo(fmt::format(" {:<48}{:g}", T.description + ':', elapsed));
+        if(elapsed <= 0)
+            continue;
+
+        std::string prefix = (T.depth > 0) ? std::string(2 * (T.depth - 1), ' ') + "- " : "";
+        env->output->outputInfo(fmt::format(" {:<48}{:g}", prefix + T.description + ':', elapsed));
     }
+
+    if(!env->memoryMonitor)
+        return;
+
+    env->memoryMonitor->update(false);
+    auto& usage = env->memoryMonitor->getUsage();
+
+    // Not available on all platforms
+    if(usage.peakResidentMemory == 0)
+        return;
+
+    const double megabyte = 1024.0 * 1024.0;
+
+    env->output->outputInfo("");
+    env->output->outputInfo(
+        fmt::format(" {:<48}{:.1f}", "Peak resident memory (MB):", usage.peakResidentMemory / megabyte));
+
+    // The largest memory sampled when the phases started and stopped, or the peak if it was reached during the phase
+    for(auto ID : env->timing->getTimerHierarchy())
+    {
+        auto& T = env->timing->timers[ID];
+
+        if(T.depth == 1 && T.peakResidentMemory > 0)
+        {
+            env->output->outputInfo(
+                fmt::format(" - {:<46}{:.1f}", T.description + ':', T.peakResidentMemory / megabyte));
+        }
+    }
+
+    env->output->outputInfo("");
+    env->output->outputInfo(fmt::format(" {:<48}{:.1f}", "Estimated memory of solver data (MB):",
+        (usage.modelMemory + usage.cutPoolMemory + usage.iterationHistoryMemory + usage.tapeMemory) / megabyte));
+    env->output->outputInfo(fmt::format(" - {:<46}{:.1f}", "problems:", usage.modelMemory / megabyte));
+    env->output->outputInfo(fmt::format(" - {:<46}{:.1f}", "cuts:", usage.cutPoolMemory / megabyte));
+    env->output->outputInfo(fmt::format(" - {:<46}{:.1f}", "iterations:", usage.iterationHistoryMemory / megabyte));
+    env->output->outputInfo(fmt::format(" - {:<46}{:.1f}", "expression tapes:", usage.tapeMemory / megabyte));
 }
 
 void Report::outputInteriorPointPreReport()
@@ -11,13 +11,18 @@
 #include "Results.h"
 
 #include <algorithm>
+#include <fstream>
+#include <iterator>
 #include <limits>
+#include <sstream>
 
 #include "EventHandler.h"
 #include "Iteration.h"
+#include "MemoryMonitor.h"
 #include "Output.h"
 #include "Results.h"
 #include "Settings.h"
+#include "TraceRecorder.h"
 #include "Timing.h"
 #include "Utilities.h"
 
@@ -43,92 +48,113 @@ void Results::addDualSolution(DualSolution solution)
     }
 }
 
+bool Results::isBetterPrimalSolution(const PrimalSolution& firstSolution, const PrimalSolution& secondSolution) const
+{
+    if(env->problem->objectiveFunction->properties.isMinimize)
+        return (firstSolution.objValue < secondSolution.objValue);
+
+    return (firstSolution.objValue > secondSolution.objValue);
+}
+
 void Results::addPrimalSolution(PrimalSolution solution)
 {
-    bool isDifferent = true;
+    auto hash = Utilities::calculateHash(solution.point);
+    auto maxDeviation = [](const PrimalSolution& S) {
+        return (std::max({ S.maxDevatingConstraintLinear.value, S.maxDevatingConstraintQuadratic.value,
+            S.maxDevatingConstraintNonlinear.value }));
+    };
 
-    for(auto& S : this->primalSolutions)
-    {
-        if(Utilities::isDifferent(S.point, solution.point))
-            continue;
+    size_t poolSize = std::max(1, env->settings->getSetting<int>("SaveNumberOfSolutions", "Output"));
 
-        isDifferent = false;
-        break;
-    }
+    std::unique_lock<std::mutex> lock(primalSolutionsMutex);
 
-    if(!isDifferent) // The same solution point is already saved
+    // Only the solutions with the same fingerprint need to be compared
+    if(primalSolutionHashes.count(hash) > 0
+        && std::any_of(primalSolutions.begin(), primalSolutions.end(),
+            [&](const PrimalSolution& S) { return (!Utilities::isDifferent(S.point, solution.point)); }))
     {
+        lock.unlock();
+
         env->output->outputDebug(fmt::format(
             "         Primal solution candidate with objective value {} already known.", solution.objValue));
         return;
     }
 
-    if(this->primalSolutions.size() == 0)
+    // The pool is sorted with the best solution first, and a solution with the same objective value as the best one
+    // but with a smaller constraint error replaces it as the best
+    bool isFirst = primalSolutions.empty();
+    bool isNewBest = isFirst || isBetterPrimalSolution(solution, primalSolutions.front())
+        || (Utilities::isAlmostEqual(solution.objValue, primalSolutions.front().objValue, 1e-10)
+            && maxDeviation(solution) < maxDeviation(primalSolutions.front()));
+
+    auto position = isNewBest ? primalSolutions.begin()
+                              : std::upper_bound(primalSolutions.begin(), primalSolutions.end(), solution,
+                                  [&](const PrimalSolution& firstSolution, const PrimalSolution& secondSolution)
+                                  { return (isBetterPrimalSolution(firstSolution, secondSolution)); });
+
+    if(primalSolutions.size() >= poolSize && position == primalSolutions.end())
     {
-        // This is the first solution, save it
-        this->primalSolutions.push_back(solution);
-        this->primalSolution = solution.point;
-        this->setPrimalBound(solution.objValue);
+        double bestObjectiveValue = primalSolutions.front().objValue;
+        lock.unlock();
 
         env->output->outputDebug(fmt::format(
-            "        First primal solution {} from {} found.", solution.objValue, solution.sourceDescription));
+            "        Primal solution {} from {} is not an improvement of the current value {} or the solution "
+            "pool is full, so it will not be saved.",
+            solution.objValue, solution.sourceDescription, bestObjectiveValue));
+        // Will not save this solution
+        return;
     }
-    else if(auto primalsol = this->primalSolutions.back();
-            (env->problem->objectiveFunction->properties.isMinimize && solution.objValue < primalsol.objValue)
-            || (!env->problem->objectiveFunction->properties.isMinimize && solution.objValue > primalsol.objValue))
-    {
-        // Have a solution which is better than the worst one in the solution pool
-        this->primalSolutions.back() = solution;
-        this->primalSolution = solution.point;
-        this->setPrimalBound(solution.objValue);
 
-        env->output->outputDebug(fmt::format("        New (currently best) primal solution {} from {} found.",
-            solution.objValue, solution.sourceDescription));
-    }
-    else if(Utilities::isAlmostEqual(solution.objValue, primalsol.objValue, 1e-10)
-        && (std::max({ solution.maxDevatingConstraintLinear.value, solution.maxDevatingConstraintQuadratic.value,
-                solution.maxDevatingConstraintNonlinear.value })
-            < std::max({ primalsol.maxDevatingConstraintLinear.value, primalsol.maxDevatingConstraintQuadratic.value,
-                primalsol.maxDevatingConstraintNonlinear.value })))
-    {
-        // Have a solution which is similar to the best known, but with smaller constraint error
-        this->primalSolutions.back() = solution;
-        this->primalSolution = solution.point;
-        this->setPrimalBound(solution.objValue);
+    size_t index = position - primalSolutions.begin();
+    auto solutions = *sharedPrimalSolutions;
 
-        env->output->outputDebug(fmt::format("        New (currently best) primal solution {} from {} found.",
-            solution.objValue, solution.sourceDescription));
+    if(primalSolutions.size() >= poolSize)
+    {
+        // Removes the worst solution from the full pool
+        primalSolutionHashes.erase(primalSolutionHashes.find(Utilities::calculateHash(primalSolutions.back().point)));
+        primalSolutions.pop_back();
+        solutions.pop_back();
     }
-    else if((int)this->primalSolutions.size() < env->settings->getSetting<int>("SaveNumberOfSolutions", "Output"))
+
+    // The removal invalidates the position in the pool
+    auto& addedSolution = *primalSolutions.insert(primalSolutions.begin() + index, std::move(solution));
+    primalSolutionHashes.insert(hash);
+
+    // The views taken earlier keep the previous solutions
+    solutions.insert(solutions.begin() + index, std::make_shared<const PrimalSolution>(addedSolution));
+    sharedPrimalSolutions = std::make_shared<const PrimalSolutionsView::Solutions>(std::move(solutions));
+    primalSolutionsGeneration++;
+
+    if(isNewBest)
     {
-        // The solution pool is not yet full, save the solution
-        this->primalSolutions.push_back(solution);
+        this->primalSolution = addedSolution.point;
+        this->setPrimalBound(addedSolution.objValue);
+    }
 
-        env->output->outputDebug(fmt::format("        New primal solution {} from {} found and added to solution pool.",
-            solution.objValue, solution.sourceDescription));
+    {
+        std::lock_guard<std::mutex> progressLock(progressMutex);
+        progress.numberOfPrimalSolutions = primalSolutions.size();
+        progress.primalSolutionsGeneration = primalSolutionsGeneration;
     }
-    else
+
+    // A copy, since the pool may change when the lock is released
+    auto newSolution = addedSolution;
+    lock.unlock();
+
+    if(isFirst)
     {
         env->output->outputDebug(fmt::format(
-            "        Primal solution {} from {} is not an improvement of the current value {} or the solution "
-            "pool is full, so it will not be saved.",
-            solution.objValue, solution.sourceDescription, primalsol.objValue));
-        // Will not save this solution
-        return;
+            "        First primal solution {} from {} found.", newSolution.objValue, newSolution.sourceDescription));
     }
-
-    // Sorts the solutions so that the best one is at the first position
-    if(env->problem->objectiveFunction->properties.isMinimize)
+    else if(isNewBest)
     {
-        std::sort(this->primalSolutions.begin(), this->primalSolutions.end(),
-            [](const PrimalSolution& firstSolution, const PrimalSolution& secondSolution)
-            { return (firstSolution.objValue < secondSolution.objValue); });
+        env->output->outputDebug(fmt::format("        New (currently best) primal solution {} from {} found.",
+            newSolution.objValue, newSolution.sourceDescription));
     }
     else
     {
-        std::sort(this->primalSolutions.begin(), this->primalSolutions.end(),
-            [](const PrimalSolution& firstSolution, const PrimalSolution& secondSolution)
-            { return (firstSolution.objValue > secondSolution.objValue); });
+        env->output->outputDebug(fmt::format("        New primal solution {} from {} found and added to solution pool.",
+            newSolution.objValue, newSolution.sourceDescription));
     }
 
     env->solutionStatistics.numberOfFoundPrimalSolutions++;
@@ -146,7 +172,7 @@ void Results::addPrimalSolution(PrimalSolution solution)
     }
 
     // Saves statistics for the sources of primal solutions
-    auto element = this->primalSolutionSourceStatistics.emplace(solution.sourceType, 1);
+    auto element = this->primalSolutionSourceStatistics.emplace(newSolution.sourceType, 1);
 
     if(!element.second)
     {
@@ -161,7 +187,7 @@ void Results::addPrimalSolution(PrimalSolution solution)
             = fmt::format("{}/primal_solpt{}.txt", env->settings->getSetting<std::string>("Debug.Path", "Output"),
                 env->solutionStatistics.numberOfFoundPrimalSolutions);
 
-        savePrimalSolutionToFile(solution, env->problem->allVariables, filename);
+        savePrimalSolutionToFile(newSolution, env->problem->allVariables, filename);
     }
 
     // TODO: Add primal objective cut
@@ -195,7 +221,29 @@ void Results::addPrimalSolution(PrimalSolution solution)
         env->output->outputCritical("        Primal objective cut added.");
     }*/
 
-    env->events->notify(E_EventType::NewPrimalSolution);
+    env->events->notify(E_EventType::NewPrimalSolution, newSolution);
+}
+
+std::vector<PrimalSolution> Results::getPrimalSolutions()
+{
+    std::lock_guard<std::mutex> lock(primalSolutionsMutex);
+    return (primalSolutions);
+}
+
+PrimalSolutionsView Results::getPrimalSolutionsView()
+{
+    std::lock_guard<std::mutex> lock(primalSolutionsMutex);
+    return (PrimalSolutionsView(sharedPrimalSolutions, primalSolutionsGeneration));
+}
+
+std::pair<VectorDouble, double> Results::getBestPrimalSolution()
+{
+    std::lock_guard<std::mutex> lock(primalSolutionsMutex);
+
+    if(primalSolutions.empty())
+        return (std::make_pair(VectorDouble(), getPrimalBound()));
+
+    return (std::make_pair(primalSolutions.front().point, primalSolutions.front().objValue));
 }
 
 bool Results::isRelativeObjectiveGapToleranceMet()
@@ -231,168 +279,98 @@ Results::~Results()
     iterations.clear();
     primalSolution.clear();
     primalSolutions.clear();
+    primalSolutionHashes.clear();
     dualSolutions.clear();
 }
 
-std::string Results::getResultsOSrL()
+void Results::writeResultsOSrL(std::ostream& stream)
 {
     using namespace tinyxml2;
 
-    XMLDocument osrlDocument;
+    // The document is printed element by element, and the printer's memory buffer is emptied to the stream whenever it
+    // exceeds this size, so the document is never stored in full in memory
+    constexpr int maxBufferSize = 1 << 16;
 
-    auto osrlNode = osrlDocument.NewElement("osrl");
-    osrlNode->SetAttribute("xmlns", "os.optimizationservices.org");
-    osrlNode->SetAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
-    osrlNode->SetAttribute(
-        "xmlns:schemaLocation", "os.optimizationservices.org http://www.optimizationservices.org/schemas/2.0/OSrL.xsd");
+    XMLPrinter printer;
 
-    osrlDocument.InsertFirstChild(osrlNode);
+    auto flushPrinter = [&](bool force)
+    {
+        if(!force && printer.CStrSize() < maxBufferSize)
+            return;
+
+        stream.write(printer.CStr(), printer.CStrSize() - 1);
+        printer.ClearBuffer(false);
+    };
 
-    auto generalNode = osrlDocument.NewElement("general");
+    auto pushOther = [&](const char* name, auto value, const char* description)
+    {
+        printer.OpenElement("other");
+        printer.PushAttribute("name", name);
+        printer.PushAttribute("value", value);
+        printer.PushAttribute("description", description);
+        printer.CloseElement();
+    };
 
-    auto instanceNameNode = osrlDocument.NewElement("instanceName");
-    instanceNameNode->SetText(env->settings->getSetting<std::string>("ProblemName", "Input").c_str());
-    generalNode->InsertFirstChild(instanceNameNode);
+    printer.OpenElement("osrl");
+    printer.PushAttribute("xmlns", "os.optimizationservices.org");
+    printer.PushAttribute("xmlns:xsi", "http://www.w3.org/2001/XMLSchema-instance");
+    printer.PushAttribute(
+        "xmlns:schemaLocation", "os.optimizationservices.org http://www.optimizationservices.org/schemas/2.0/OSrL.xsd");
 
-    std::stringstream ssSolver;
-    ssSolver << "Supporting Hyperplane Optimization Toolkit, version ";
-    ssSolver << SHOT_VERSION_MAJOR << "." << SHOT_VERSION_MINOR << "." << SHOT_VERSION_PATCH;
-    auto solver = ssSolver.str();
-
-    auto solverInvoked = osrlDocument.NewElement("solverInvoked");
-    solverInvoked->SetText(solver.c_str());
-    generalNode->InsertFirstChild(solverInvoked);
-
-    auto otherResultsNode = osrlDocument.NewElement("otherResults");
-    otherResultsNode->SetAttribute("numberOfOtherResults", "1");
-    auto otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "UsedOptions");
-    otherNode->SetText(env->settings->getSettingsAsString(false, true).c_str());
-    otherResultsNode->InsertFirstChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "DualObjectiveBound");
-    otherNode->SetAttribute("value", globalDualBound);
-    otherNode->SetAttribute("description", "The dual bound for the objective");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "PrimalObjectiveBound");
-    otherNode->SetAttribute("value", currentPrimalBound);
-    otherNode->SetAttribute("description", "The primal bound for the objective");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "MaxConstraintError");
-    otherNode->SetAttribute("value", getCurrentIteration()->maxDeviation);
-    otherNode->SetAttribute("description", "The maximal constraint error");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "AbsoluteOptimalityGap");
-    otherNode->SetAttribute("value", getAbsoluteGlobalObjectiveGap());
-    otherNode->SetAttribute("description", "The absolute optimality gap");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "RelativeOptimalityGap");
-    otherNode->SetAttribute("value", getRelativeGlobalObjectiveGap());
-    otherNode->SetAttribute("description", "The relative optimality gap");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfLPProblems");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfProblemsLP);
-    otherNode->SetAttribute("description", "The number of LP problems solved in the dual strategy");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfQPProblems");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfProblemsQP);
-    otherNode->SetAttribute("description", "The number of QP problems solved in the dual strategy");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfFeasibleMILPProblems");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfProblemsFeasibleMILP);
-    otherNode->SetAttribute("description", "The number of MILP problems solved to feasibility in the dual strategy");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfFeasibleMIQPProblems");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfProblemsFeasibleMIQP);
-    otherNode->SetAttribute("description", "The number of MIQP problems solved to feasibility in the dual strategy");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfOptimalMILPProblems");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfProblemsOptimalMILP);
-    otherNode->SetAttribute("description", "The number of MILP problems solved to optimality in the dual strategy");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfOptimalMIQPProblems");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfProblemsOptimalMIQP);
-    otherNode->SetAttribute("description", "The number of MIQP problems solved to optimality in the dual strategy");
-    otherResultsNode->InsertEndChild(otherNode);
+    printer.OpenElement("general");
+
+    printer.OpenElement("otherResults");
+    printer.PushAttribute("numberOfOtherResults", "1");
+
+    printer.OpenElement("other");
+    printer.PushAttribute("name", "UsedOptions");
+    printer.PushText(env->settings->getSettingsAsString(false, true).c_str());
+    printer.CloseElement();
+
+    pushOther("DualObjectiveBound", globalDualBound, "The dual bound for the objective");
+    pushOther("PrimalObjectiveBound", currentPrimalBound, "The primal bound for the objective");
+    pushOther("MaxConstraintError", getCurrentIteration()->maxDeviation, "The maximal constraint error");
+    pushOther("AbsoluteOptimalityGap", getAbsoluteGlobalObjectiveGap(), "The absolute optimality gap");
+    pushOther("RelativeOptimalityGap", getRelativeGlobalObjectiveGap(), "The relative optimality gap");
+    pushOther("NumberOfLPProblems", env->solutionStatistics.numberOfProblemsLP,
+        "The number of LP problems solved in the dual strategy");
+    pushOther("NumberOfQPProblems", env->solutionStatistics.numberOfProblemsQP,
+        "The number of QP problems solved in the dual strategy");
+    pushOther("NumberOfFeasibleMILPProblems", env->solutionStatistics.numberOfProblemsFeasibleMILP,
+        "The number of MILP problems solved to feasibility in the dual strategy");
+    pushOther("NumberOfFeasibleMIQPProblems", env->solutionStatistics.numberOfProblemsFeasibleMIQP,
+        "The number of MIQP problems solved to feasibility in the dual strategy");
+    pushOther("NumberOfOptimalMILPProblems", env->solutionStatistics.numberOfProblemsOptimalMILP,
+        "The number of MILP problems solved to optimality in the dual strategy");
+    pushOther("NumberOfOptimalMIQPProblems", env->solutionStatistics.numberOfProblemsOptimalMIQP,
+        "The number of MIQP problems solved to optimality in the dual strategy");
 
     int totalNumberOfProblems = env->solutionStatistics.numberOfProblemsLP
         + env->solutionStatistics.numberOfProblemsFeasibleMILP + env->solutionStatistics.numberOfProblemsOptimalMILP
         + env->solutionStatistics.numberOfProblemsQP + env->solutionStatistics.numberOfProblemsFeasibleMIQP
         + env->solutionStatistics.numberOfProblemsOptimalMIQP;
 
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "TotalNumberOfDualProblems");
-    otherNode->SetAttribute("value", totalNumberOfProblems);
-    otherNode->SetAttribute("description", "The total number of problems solved in the dual strategy");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfNLPProblems");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfProblemsFixedNLP);
-    otherNode->SetAttribute("description", "The number of NLP problems solved in the primal strategy");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFound");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfFoundPrimalSolutions);
-    otherNode->SetAttribute("description", "The number of primal solutions found");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfSuccesfulInfeasibilityRepairsPerformed");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfSuccessfulDualRepairsPerformed);
-    otherNode->SetAttribute(
-        "description", "The number of sucessful infeasibility repairs performed for nonconvex problems");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfUnsuccesfulInfeasibilityRepairsPerformed");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfUnsuccessfulDualRepairsPerformed);
-    otherNode->SetAttribute(
-        "description", "The number of unsucessful infeasibility repairs performed for nonconvex problems");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "NumberOfReductionCutStepsPerformed");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfPrimalReductionsPerformed);
-    otherNode->SetAttribute("description", "The number of reduction cut steps performed for nonconvex problems");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "numberOfPrimalImprovementsAfterInfeasibilityRepair");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfPrimalImprovementsAfterInfeasibilityRepair);
-    otherNode->SetAttribute("description",
+    pushOther("TotalNumberOfDualProblems", totalNumberOfProblems,
+        "The total number of problems solved in the dual strategy");
+    pushOther("NumberOfNLPProblems", env->solutionStatistics.numberOfProblemsFixedNLP,
+        "The number of NLP problems solved in the primal strategy");
+    pushOther("NumberOfPrimalSolutionsFound", env->solutionStatistics.numberOfFoundPrimalSolutions,
+        "The number of primal solutions found");
+    pushOther("NumberOfSuccesfulInfeasibilityRepairsPerformed",
+        env->solutionStatistics.numberOfSuccessfulDualRepairsPerformed,
+        "The number of sucessful infeasibility repairs performed for nonconvex problems");
+    pushOther("NumberOfUnsuccesfulInfeasibilityRepairsPerformed",
+        env->solutionStatistics.numberOfUnsuccessfulDualRepairsPerformed,
+        "The number of unsucessful infeasibility repairs performed for nonconvex problems");
+    pushOther("NumberOfReductionCutStepsPerformed", env->solutionStatistics.numberOfPrimalReductionsPerformed,
+        "The number of reduction cut steps performed for nonconvex problems");
+    pushOther("numberOfPrimalImprovementsAfterInfeasibilityRepair",
+        env->solutionStatistics.numberOfPrimalImprovementsAfterInfeasibilityRepair,
         "The number of cases where the repairing of infeasibilities for nonconvex problems has directly resulted in "
         "improved primal solutions");
-    otherResultsNode->InsertEndChild(otherNode);
-
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "numberOfPrimalImprovementsAfterReductionCut");
-    otherNode->SetAttribute("value", env->solutionStatistics.numberOfPrimalImprovementsAfterReductionCut);
-    otherNode->SetAttribute("description",
+    pushOther("numberOfPrimalImprovementsAfterReductionCut",
+        env->solutionStatistics.numberOfPrimalImprovementsAfterReductionCut,
         "The number of cases where the primal reduction cut has directly resulted in improved primal solutions");
-    otherResultsNode->InsertEndChild(otherNode);
 
     auto dualSolver = static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual"));
     std::string dualSolverName;
@@ -418,450 +396,359 @@ std::string Results::getResultsOSrL()
     }
 #endif
 
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "DualSolver");
-    otherNode->SetAttribute("value", (dualSolverName + " " + env->dualSolver->MIPSolver->getSolverVersion()).c_str());
-    otherNode->SetAttribute("description", "The dual solver used");
-    otherResultsNode->InsertEndChild(otherNode);
+    auto dualSolverDescription = dualSolverName + " " + env->dualSolver->MIPSolver->getSolverVersion();
 
-    otherNode = osrlDocument.NewElement("other");
-    otherNode->SetAttribute("name", "FixedNLPSolver");
-    otherNode->SetAttribute("value", (dualSolverName + " " + env->dualSolver->MIPSolver->getSolverVersion()).c_str());
-    otherNode->SetAttribute("description", "The dual solver used");
-    otherResultsNode->InsertEndChild(otherNode);
+    pushOther("DualSolver", dualSolverDescription.c_str(), "The dual solver used");
+    pushOther("FixedNLPSolver", dualSolverDescription.c_str(), "The dual solver used");
 
     for(auto& S : this->primalSolutionSourceStatistics)
     {
-        otherNode = osrlDocument.NewElement("other");
+        const char* name;
+        const char* description;
 
         switch(S.first)
         {
         case E_PrimalSolutionSource::Rootsearch:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundRootSearch");
-            otherNode->SetAttribute("description", "The number of primal solutions found with root search");
+            name = "NumberOfPrimalSolutionsFoundRootSearch";
+            description = "The number of primal solutions found with root search";
             break;
         case E_PrimalSolutionSource::RootsearchFixedIntegers:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundRootSearchFixedIntegers");
-            otherNode->SetAttribute(
-                "description", "The number of primal solutions found with root search and fixed integers");
+            name = "NumberOfPrimalSolutionsFoundRootSearchFixedIntegers";
+            description = "The number of primal solutions found with root search and fixed integers";
             break;
         case E_PrimalSolutionSource::NLPFixedIntegers:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundNLPFixedIntegers");
-            otherNode->SetAttribute(
-                "description", "The number of primal solutions found by solving integer-fixed NLP problems");
+            name = "NumberOfPrimalSolutionsFoundNLPFixedIntegers";
+            description = "The number of primal solutions found by solving integer-fixed NLP problems";
             break;
         case E_PrimalSolutionSource::MIPSolutionPool:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundMIPSolutionPool");
-            otherNode->SetAttribute("description", "The number of primal solutions found from the MIP solution pool");
+            name = "NumberOfPrimalSolutionsFoundMIPSolutionPool";
+            description = "The number of primal solutions found from the MIP solution pool";
             break;
         case E_PrimalSolutionSource::LPFixedIntegers:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundLPFixedIntegers");
-            otherNode->SetAttribute(
-                "description", "The number of primal solutions found by solving integer-fixed LP problems");
+            name = "NumberOfPrimalSolutionsFoundLPFixedIntegers";
+            description = "The number of primal solutions found by solving integer-fixed LP problems";
             break;
         case E_PrimalSolutionSource::MIPCallback:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundMIPCallback");
-            otherNode->SetAttribute("description", "The number of primal solutions found in MIP callbacks");
+            name = "NumberOfPrimalSolutionsFoundMIPCallback";
+            description = "The number of primal solutions found in MIP callbacks";
             break;
         case E_PrimalSolutionSource::InteriorPointSearch:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundInteriorPointSearch");
-            otherNode->SetAttribute(
-                "description", "The number of primal solutions found when searching for interior point");
+            name = "NumberOfPrimalSolutionsFoundInteriorPointSearch";
+            description = "The number of primal solutions found when searching for interior point";
+            break;
+        case E_PrimalSolutionSource::WarmStart:
+            name = "NumberOfPrimalSolutionsFoundWarmStart";
+            description = "The number of primal solutions given in a warm start";
+            break;
+        case E_PrimalSolutionSource::FeasibilityPump:
+            name = "NumberOfPrimalSolutionsFoundFeasibilityPump";
+            description = "The number of primal solutions found with the feasibility pump";
             break;
         default:
-            otherNode->SetAttribute("name", "NumberOfPrimalSolutionsFoundOther");
-            otherNode->SetAttribute("description", "The number of primal solutions found with unknown method");
+            name = "NumberOfPrimalSolutionsFoundOther";
+            description = "The number of primal solutions found with unknown method";
             break;
         }
 
-        otherNode->SetAttribute("value", S.second);
-        otherResultsNode->InsertEndChild(otherNode);
+        printer.OpenElement("other");
+        printer.PushAttribute("name", name);
+        printer.PushAttribute("description", description);
+        printer.PushAttribute("value", S.second);
+        printer.CloseElement();
     }
 
-    generalNode->InsertFirstChild(otherResultsNode);
+    printer.CloseElement(); // otherResults
 
-    osrlNode->InsertFirstChild(generalNode);
+    std::stringstream ssSolver;
+    ssSolver << "Supporting Hyperplane Optimization Toolkit, version ";
+    ssSolver << SHOT_VERSION_MAJOR << "." << SHOT_VERSION_MINOR << "." << SHOT_VERSION_PATCH;
+
+    printer.OpenElement("solverInvoked");
+    printer.PushText(ssSolver.str().c_str());
+    printer.CloseElement();
 
-    auto jobNode = osrlDocument.NewElement("job");
+    printer.OpenElement("instanceName");
+    printer.PushText(env->settings->getSetting<std::string>("ProblemName", "Input").c_str());
+    printer.CloseElement();
 
-    auto timingInformationNode = osrlDocument.NewElement("timingInformation");
-    int numberOfTimes = 0;
+    printer.CloseElement(); // general
+
+    printer.OpenElement("job");
+    printer.OpenElement("timingInformation");
+    printer.PushAttribute("numberOfTimes", (int)env->timing->timers.size());
 
     for(auto& T : env->timing->timers)
     {
-        auto timeNode = osrlDocument.NewElement("time");
-        timeNode->SetText(T.elapsed());
-        timeNode->SetAttribute("type", T.name.c_str());
-        timeNode->SetAttribute("unit", "second");
-        timeNode->SetAttribute("description", T.description.c_str());
-        timingInformationNode->InsertEndChild(timeNode);
-        numberOfTimes++;
-    }
+        printer.OpenElement("time");
+        printer.PushAttribute("type", T.name.c_str());
+        printer.PushAttribute("unit", "second");
+        printer.PushAttribute("description", T.description.c_str());
 
-    timingInformationNode->SetAttribute("numberOfTimes", numberOfTimes);
-    jobNode->InsertEndChild(timingInformationNode);
+        if(T.parent >= 0)
+            printer.PushAttribute("category", env->timing->timers[T.parent].name.c_str());
 
-    osrlNode->InsertEndChild(jobNode);
+        printer.PushText(T.elapsed());
+        printer.CloseElement();
+    }
 
-    auto optimizationNode = osrlDocument.NewElement("optimization");
-    optimizationNode->SetAttribute("numberOfSolutions", (int)primalSolutions.size());
-    optimizationNode->SetAttribute("numberOfVariables", env->problem->properties.numberOfVariables);
-    optimizationNode->SetAttribute("numberOfConstraints",
-        env->problem->properties.numberOfNumericConstraints - env->problem->properties.numberOfAddedLinearizations);
-    optimizationNode->SetAttribute("numberOfObjectives", 1);
+    printer.CloseElement(); // timingInformation
+    printer.CloseElement(); // job
 
-    auto solutionNode = osrlDocument.NewElement("solution");
+    printer.OpenElement("optimization");
+    printer.PushAttribute("numberOfSolutions", (int)primalSolutions.size());
+    printer.PushAttribute("numberOfVariables", env->problem->properties.numberOfVariables);
+    printer.PushAttribute("numberOfConstraints",
+        env->problem->properties.numberOfNumericConstraints - env->problem->properties.numberOfAddedLinearizations);
+    printer.PushAttribute("numberOfObjectives", 1);
 
     int numPrimalSols = primalSolutions.size();
 
     int numSaveSolutions = std::min(env->settings->getSetting<int>("SaveNumberOfSolutions", "Output"), numPrimalSols);
 
-    auto statusNode = osrlDocument.NewElement("status");
+    std::string statusType;
+    std::string statusDescription;
+    std::string substatusType = "stoppedByLimit";
+
+    // The substatus is only given if there is a description of the termination reason, except for optimal solutions
+    bool hasSubstatus = (terminationReasonDescription != "");
 
     if(this->terminationReason == E_TerminationReason::AbsoluteGap
         || this->terminationReason == E_TerminationReason::RelativeGap)
     {
-        statusNode->SetAttribute("type", "globallyOptimal");
-        statusNode->SetAttribute("description", "Solved to global optimality");
-
-        statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-        auto substatusNode = osrlDocument.NewElement("substatus");
-        substatusNode->SetAttribute("type", "stoppedByBounds");
-        substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-        statusNode->InsertFirstChild(substatusNode);
+        statusType = "globallyOptimal";
+        statusDescription = "Solved to global optimality";
+        substatusType = "stoppedByBounds";
+        hasSubstatus = true;
     }
     else if(this->terminationReason == E_TerminationReason::ConstraintTolerance)
     {
-        statusNode->SetAttribute("type", "locallyOptimal");
-        statusNode->SetAttribute("description", "Solved to local optimality");
-
-        statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-        auto substatusNode = osrlDocument.NewElement("substatus");
-        substatusNode->SetAttribute("type", "stoppedByBounds");
-        substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-        statusNode->InsertFirstChild(substatusNode);
+        statusType = "locallyOptimal";
+        statusDescription = "Solved to local optimality";
+        substatusType = "stoppedByBounds";
+        hasSubstatus = true;
     }
     else if(hasPrimalSolution())
     {
-        statusNode->SetAttribute("type", "feasible");
-        statusNode->SetAttribute("description", "Feasible solution found");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "other");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
+        statusType = "feasible";
+        statusDescription = "Feasible solution found";
+        substatusType = "other";
     }
     else if(this->terminationReason == E_TerminationReason::InfeasibleProblem)
     {
-        statusNode->SetAttribute("type", "infeasible");
-        statusNode->SetAttribute("description", "No solution found since dual problem is infeasible");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "other");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
+        statusType = "infeasible";
+        statusDescription = "No solution found since dual problem is infeasible";
+        substatusType = "other";
     }
     else if(this->terminationReason == E_TerminationReason::UnboundedProblem)
     {
-        statusNode->SetAttribute("type", "unbounded");
-        statusNode->SetAttribute("description", "No solution found since dual problem is unbounded");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "other");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
-    }
-    else if(this->terminationReason == E_TerminationReason::ObjectiveStagnation)
-    {
-        statusNode->SetAttribute("type", "other");
-        statusNode->SetAttribute("description", "No solution found");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
-    }
-    else if(this->terminationReason == E_TerminationReason::NoDualCutsAdded)
-    {
-        statusNode->SetAttribute("type", "other");
-        statusNode->SetAttribute("description", "No solution found");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
-    }
-    else if(this->terminationReason == E_TerminationReason::IterationLimit)
-    {
-        statusNode->SetAttribute("type", "other");
-        statusNode->SetAttribute("description", "No solution found");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
+        statusType = "unbounded";
+        statusDescription = "No solution found since dual problem is unbounded";
+        substatusType = "other";
     }
-    else if(this->terminationReason == E_TerminationReason::TimeLimit)
+    else if(this->terminationReason == E_TerminationReason::ObjectiveStagnation
+        || this->terminationReason == E_TerminationReason::NoDualCutsAdded
+        || this->terminationReason == E_TerminationReason::IterationLimit
+        || this->terminationReason == E_TerminationReason::TimeLimit)
     {
-        statusNode->SetAttribute("type", "other");
-        statusNode->SetAttribute("description", "No solution found");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
+        statusType = "other";
+        statusDescription = "No solution found";
     }
-    else if(this->terminationReason == E_TerminationReason::NumericIssues)
+    else if(this->terminationReason == E_TerminationReason::NumericIssues
+        || this->terminationReason == E_TerminationReason::Error)
     {
-        statusNode->SetAttribute("type", "error");
-        statusNode->SetAttribute("description", "No solution found since an error occured");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
+        statusType = "error";
+        statusDescription = "No solution found since an error occured";
     }
     else if(this->terminationReason == E_TerminationReason::UserAbort)
     {
-        statusNode->SetAttribute("type", "other");
-        statusNode->SetAttribute("description", "No solution found due to user abort");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
-    }
-    else if(this->terminationReason == E_TerminationReason::Error)
-    {
-        statusNode->SetAttribute("type", "error");
-        statusNode->SetAttribute("description", "No solution found since an error occured");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
+        statusType = "other";
+        statusDescription = "No solution found due to user abort";
     }
     else
     {
-        statusNode->SetAttribute("type", "other");
-        statusNode->SetAttribute("description", "Unknown return code obtained from solver");
-
-        if(terminationReasonDescription != "")
-        {
-            statusNode->SetAttribute("numberOfSubstatuses", 1);
-
-            auto substatusNode = osrlDocument.NewElement("substatus");
-            substatusNode->SetAttribute("type", "stoppedByLimit");
-            substatusNode->SetAttribute("description", terminationReasonDescription.c_str());
-            statusNode->InsertFirstChild(substatusNode);
-        }
+        statusType = "other";
+        statusDescription = "Unknown return code obtained from solver";
 
         env->output->outputError(
             fmt::format(" Unknown return code {} obtained from solver.", static_cast<int>(this->terminationReason)));
     }
 
-    solutionNode->InsertFirstChild(statusNode);
-
     for(int i = 0; i < numSaveSolutions; i++)
     {
-        if(i > 0)
-        {
-            solutionNode = osrlDocument.NewElement("solution");
-            statusNode = osrlDocument.NewElement("status");
-            statusNode->SetAttribute("type", "feasible");
-            statusNode->SetAttribute("description", "Additional primal solution");
-            solutionNode->InsertFirstChild(statusNode);
-        }
+        printer.OpenElement("solution");
+
+        auto& solution = primalSolutions.at(i);
 
-        auto objectivesNode = osrlDocument.NewElement("objectives");
+        printer.OpenElement("constraints");
+        printer.OpenElement("dualValues");
+        printer.PushAttribute("numberOfCon", (int)env->problem->properties.numberOfNumericConstraints);
 
-        auto objectiveValueNode = osrlDocument.NewElement("values");
-        objectiveValueNode->SetAttribute("numberOfObj", 1);
+        for(size_t j = 0; j < env->problem->numericConstraints.size(); j++)
+        {
+            auto& constraint = env->problem->numericConstraints.at(j);
 
-        auto objectiveSolutionNode = osrlDocument.NewElement("obj");
-        objectiveSolutionNode->SetAttribute("idx", -1);
-        objectiveSolutionNode->SetText(std::to_string(primalSolutions.at(i).objValue).c_str());
-        objectiveValueNode->InsertFirstChild(objectiveSolutionNode);
+            printer.OpenElement("con");
+            printer.PushAttribute("idx", (int)j);
+            printer.PushAttribute("name", constraint->name.c_str());
+            printer.PushText(
+                std::to_string(constraint->calculateNumericValue(solution.point).normalizedValue).c_str());
+            printer.CloseElement();
 
-        objectivesNode->InsertFirstChild(objectiveValueNode);
-        solutionNode->InsertFirstChild(objectivesNode);
+            flushPrinter(false);
+        }
 
-        auto variablesNode = osrlDocument.NewElement("variables");
+        printer.CloseElement(); // dualValues
+        printer.CloseElement(); // constraints
 
-        auto variableValueNode = osrlDocument.NewElement("values");
-        variableValueNode->SetAttribute("numberOfVar", (int)primalSolutions.at(i).point.size());
+        printer.OpenElement("variables");
+        printer.OpenElement("values");
+        printer.PushAttribute("numberOfVar", (int)solution.point.size());
 
-        for(size_t j = 0; j < primalSolutions.at(i).point.size(); j++)
+        for(size_t j = 0; j < solution.point.size(); j++)
         {
-            auto variableSolutionNode = osrlDocument.NewElement("var");
-            variableSolutionNode->SetAttribute("idx", (int)j);
-            variableSolutionNode->SetAttribute("name", env->problem->allVariables.at(j)->name.c_str());
-            variableSolutionNode->SetText(std::to_string(primalSolutions.at(i).point.at(j)).c_str());
-            variableValueNode->InsertEndChild(variableSolutionNode);
+            printer.OpenElement("var");
+            printer.PushAttribute("idx", (int)j);
+            printer.PushAttribute("name", env->problem->allVariables.at(j)->name.c_str());
+            printer.PushText(std::to_string(solution.point.at(j)).c_str());
+            printer.CloseElement();
+
+            flushPrinter(false);
         }
 
-        variablesNode->InsertFirstChild(variableValueNode);
-        solutionNode->InsertFirstChild(variablesNode);
+        printer.CloseElement(); // values
+        printer.CloseElement(); // variables
 
-        auto constraintsNode = osrlDocument.NewElement("constraints");
+        printer.OpenElement("objectives");
+        printer.OpenElement("values");
+        printer.PushAttribute("numberOfObj", 1);
+        printer.OpenElement("obj");
+        printer.PushAttribute("idx", -1);
+        printer.PushText(std::to_string(solution.objValue).c_str());
+        printer.CloseElement(); // obj
+        printer.CloseElement(); // values
+        printer.CloseElement(); // objectives
 
-        auto dualValuesNode = osrlDocument.NewElement("dualValues");
-        dualValuesNode->SetAttribute("numberOfCon", (int)env->problem->properties.numberOfNumericConstraints);
+        printer.OpenElement("status");
 
-        for(size_t j = 0; j < env->problem->numericConstraints.size(); j++)
+        if(i == 0)
         {
-            auto dualValueNode = osrlDocument.NewElement("con");
-            dualValueNode->SetAttribute("idx", (int)j);
-            dualValueNode->SetAttribute("name", env->problem->numericConstraints.at(j)->name.c_str());
-            dualValueNode->SetText(std::to_string(env->problem->numericConstraints.at(j)
-                                                      ->calculateNumericValue(primalSolutions.at(i).point)
-                                                      .normalizedValue)
-                                       .c_str());
-            dualValuesNode->InsertEndChild(dualValueNode);
+            printer.PushAttribute("type", statusType.c_str());
+            printer.PushAttribute("description", statusDescription.c_str());
+
+            if(hasSubstatus)
+            {
+                printer.PushAttribute("numberOfSubstatuses", 1);
+                printer.OpenElement("substatus");
+                printer.PushAttribute("type", substatusType.c_str());
+                printer.PushAttribute("description", terminationReasonDescription.c_str());
+                printer.CloseElement();
+            }
+        }
+        else
+        {
+            printer.PushAttribute("type", "feasible");
+            printer.PushAttribute("description", "Additional primal solution");
         }
 
-        constraintsNode->InsertFirstChild(dualValuesNode);
-        solutionNode->InsertFirstChild(constraintsNode);
-
-        optimizationNode->InsertEndChild(solutionNode);
+        printer.CloseElement(); // status
+        printer.CloseElement(); // solution
     }
 
-    osrlNode->InsertEndChild(optimizationNode);
-
-    XMLPrinter printer;
-    osrlDocument.Print(&printer);
+    printer.CloseElement(); // optimization
+    printer.CloseElement(); // osrl
 
-    return (printer.CStr());
+    flushPrinter(true);
 }
 
-std::string Results::getResultsTrace()
+std::string Results::getResultsOSrL()
 {
     std::stringstream ss;
-    ss << env->problem->name << ",";
+    writeResultsOSrL(ss);
+    return (ss.str());
+}
+
+bool Results::writeResultsOSrL(const std::string& fileName)
+{
+    return (writeResultsToFile(fileName, [this](std::ostream& stream) { writeResultsOSrL(stream); }));
+}
+
+void Results::writeResultsTrace(std::ostream& stream)
+{
+    auto precision = stream.precision();
+
+    stream << env->problem->name << ",";
 
     if(env->problem->properties.isLPProblem)
-        ss << "LP";
+        stream << "LP";
     else if(env->problem->properties.isMILPProblem)
-        ss << "MIP";
+        stream << "MIP";
     else if(env->problem->properties.isQPProblem)
-        ss << "QCP";
+        stream << "QCP";
     else if(env->problem->properties.isQCQPProblem)
-        ss << "QCP";
+        stream << "QCP";
     else if(env->problem->properties.isMIQPProblem)
-        ss << "MIQCP";
+        stream << "MIQCP";
     else if(env->problem->properties.isMIQCQPProblem)
-        ss << "MIQCP";
+        stream << "MIQCP";
     else if(env->problem->properties.isNLPProblem)
-        ss << "NLP";
+        stream << "NLP";
     else if(env->problem->properties.isMINLPProblem)
-        ss << "MINLP";
+        stream << "MINLP";
     else
-        ss << "UNKNOWN";
+        stream << "UNKNOWN";
 
-    ss << ",";
-    ss << "SHOT"
-       << ",";
+    stream << ",";
+    stream << "SHOT"
+           << ",";
 
     switch(static_cast<ES_PrimalNLPSolver>(this->usedPrimalNLPSolver))
     {
     case(ES_PrimalNLPSolver::None):
-        ss << "NONE";
+        stream << "NONE";
         break;
     case(ES_PrimalNLPSolver::GAMS):
-        ss << env->settings->getSetting<std::string>("GAMS.NLP.Solver", "Subsolver");
+        stream << env->settings->getSetting<std::string>("GAMS.NLP.Solver", "Subsolver");
         break;
     case(ES_PrimalNLPSolver::Ipopt):
-        ss << "Ipopt";
+        stream << "Ipopt";
         break;
     default:
-        ss << "NONE";
+        stream << "NONE";
         break;
     }
 
-    ss << ",";
+    stream << ",";
 
     switch(static_cast<ES_MIPSolver>(this->usedMIPSolver))
     {
     case(ES_MIPSolver::Cplex):
-        ss << "CPLEX";
+        stream << "CPLEX";
         break;
     case(ES_MIPSolver::Gurobi):
-        ss << "GUROBI";
+        stream << "GUROBI";
         break;
     case(ES_MIPSolver::Cbc):
-        ss << "CBC";
+        stream << "CBC";
         break;
     default:
-        ss << "NONE";
+        stream << "NONE";
         break;
     }
 
-    ss << ",";
+    stream << ",";
 
-    ss << Utilities::toStringFormat(Utilities::getJulianFractionalDate(), "{:.5f}", false);
-    ss << ",";
-    ss << (env->problem->objectiveFunction->properties.isMinimize ? "0" : "1") << ",";
-    ss << env->problem->properties.numberOfNumericConstraints - env->problem->properties.numberOfAddedLinearizations
-       << ",";
-    ss << env->problem->properties.numberOfVariables << ",";
-    ss << env->problem->properties.numberOfDiscreteVariables << ",";
+    stream << Utilities::toStringFormat(Utilities::getJulianFractionalDate(), "{:.5f}", false);
+    stream << ",";
+    stream << (env->problem->objectiveFunction->properties.isMinimize ? "0" : "1") << ",";
+    stream << env->problem->properties.numberOfNumericConstraints - env->problem->properties.numberOfAddedLinearizations
+           << ",";
+    stream << env->problem->properties.numberOfVariables << ",";
+    stream << env->problem->properties.numberOfDiscreteVariables << ",";
 
-    ss << '0' << ","; // TODO: Number of nonzeroes
-    ss << '0' << ","; // TODO: Number of nonlinear nonzeroes
-    ss << "1"
-       << ",";
+    stream << '0' << ","; // TODO: Number of nonzeroes
+    stream << '0' << ","; // TODO: Number of nonlinear nonzeroes
+    stream << "1"
+           << ",";
 
     std::string solverStatus = "";
     std::string modelStatus = "";
@@ -931,25 +818,37 @@ std::string Results::getResultsTrace()
         modelStatus = "13";
     };
 
-    ss << modelStatus << ",";
-    ss << solverStatus << ",";
+    stream << modelStatus << ",";
+    stream << solverStatus << ",";
 
-    ss << std::setprecision(std::numeric_limits<double>::digits10 + 1);
-    ss << this->getPrimalBound() << ",";
+    stream << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+    stream << this->getPrimalBound() << ",";
     ;
-    ss << this->getGlobalDualBound() << ",";
+    stream << this->getGlobalDualBound() << ",";
     ;
-    ss << env->timing->getElapsedTime("Total") << ",";
-    ss << env->solutionStatistics.numberOfIterations << ",";
-    ss << "0"
-       << ",";
-    ss << env->solutionStatistics.numberOfExploredNodes << ",";
-    ss << "#";
+    stream << env->timing->getElapsedTime("Total") << ",";
+    stream << env->solutionStatistics.numberOfIterations << ",";
+    stream << "0"
+           << ",";
+    stream << env->solutionStatistics.numberOfExploredNodes << ",";
+    stream << "#";
+
+    stream.precision(precision);
+}
 
+std::string Results::getResultsTrace()
+{
+    std::stringstream ss;
+    writeResultsTrace(ss);
     return (ss.str());
 }
 
-std::string Results::getResultsSol()
+bool Results::writeResultsTrace(const std::string& fileName)
+{
+    return (writeResultsToFile(fileName, [this](std::ostream& stream) { writeResultsTrace(stream); }));
+}
+
+void Results::writeResultsSol(std::ostream& stream)
 {
     std::string status = "";
     std::string description = "";
@@ -1016,44 +915,189 @@ std::string Results::getResultsSol()
         description = "No solution found since an error occured";
     }
 
-    std::stringstream ss;
-
-    ss << fmt::format("SHOT: {}\n", description);
+    stream << fmt::format("SHOT: {}\n", description);
 
-    ss << "\nOptions\n";
+    stream << "\nOptions\n";
 
-    ss << env->settings->getSetting<std::string>("AMPL.OptionsHeader", "ModelingSystem");
+    stream << env->settings->getSetting<std::string>("AMPL.OptionsHeader", "ModelingSystem");
 
-    ss << fmt::format("{0}\n{1}\n{2}\n{3}\n",
+    stream << fmt::format("{0}\n{1}\n{2}\n{3}\n",
         env->settings->getSetting<int>("AMPL.NumberOfOriginalConstraints", "ModelingSystem"), 0,
         env->problem->properties.numberOfVariables, env->problem->properties.numberOfVariables);
 
+    // The variable values are formatted into a buffer that is written to the stream when full
+    fmt::memory_buffer buffer;
+
+    auto writeValue = [&](double value)
+    {
+        fmt::format_to(std::back_inserter(buffer), "{}\n", value);
+
+        if(buffer.size() > 1 << 16)
+        {
+            stream.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    };
+
     if(this->primalSolution.size() > 0)
     {
         for(auto const& V : this->primalSolution)
-            ss << fmt::format("{}\n", V);
+            writeValue(V);
+    }
+    else
+    {
+        for(int i = 0; i < env->problem->properties.numberOfVariables; i++)
+            writeValue(0);
+    }
+
+    stream.write(buffer.data(), buffer.size());
+
+    stream << fmt::format("objno 0 {}", status);
+}
+
+std::string Results::getResultsSol()
+{
+    std::stringstream ss;
+    writeResultsSol(ss);
+    return (ss.str());
+}
+
+bool Results::writeResultsSol(const std::string& fileName)
+{
+    return (writeResultsToFile(fileName, [this](std::ostream& stream) { writeResultsSol(stream); }));
+}
+
+bool Results::writeResultsToFile(const std::string& fileName, const std::function<void(std::ostream&)>& writer)
+{
+    // A larger buffer than the default one of the file stream to reduce the number of writes for large results
+    std::vector<char> buffer(1 << 16);
+
+    std::ofstream file;
+    file.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    file.open(fileName, std::ios::binary);
+
+    if(!file)
+        return (false);
+
+    writer(file);
+    file.close();
+
+    return (!file.fail());
+}
+
+void Results::createIteration()
+{
+    if(iterations.size() > 0)
+    {
+        iterationSummaries.push_back(createIterationSummary(*iterations.back()));
+        env->events->notify(E_EventType::IterationFinished, iterationSummaries.back());
+    }
+
+    if(recycledIterations.empty())
+    {
+        iterations.push_back(std::make_shared<Iteration>(env));
     }
     else
     {
+        // Reset before it is added, since the new iteration is initialized from the current one
+        auto iteration = std::move(recycledIterations.back());
+        recycledIterations.pop_back();
+
+        iteration->reset();
+        iterations.push_back(std::move(iteration));
+    }
+
+    numberOfIterations++;
+
+    {
+        std::lock_guard<std::mutex> lock(progressMutex);
+        progress.iterationNumber = numberOfIterations;
+    }
+
+    updateProgress();
+
+    // May decrease the number of retained iterations if the memory limit has been exceeded
+    if(env->memoryMonitor)
+        env->memoryMonitor->update();
+
+    retireIterations();
+
+    if(env->traceRecorder)
+        env->traceRecorder->setIteration(iterations.back()->iterationNumber);
+}
+
+void Results::retireIterations()
+{
+    size_t numberOfRetained = env->settings->getSetting<int>("Iterations.Retained", "Output");
+
+    // The previous iteration is always needed
+    if(numberOfRetained > 0)
+        numberOfRetained = std::max((size_t)2, numberOfRetained);
+
+    if(!env->settings->getSetting<bool>("Iterations.KeepPointData", "Output") && iterations.size() > 2)
+    {
+        auto& iteration = iterations[iterations.size() - 3];
+
+        if(iteration->solutionPoints.size() > 0)
         {
-            for(int i = 0; i < env->problem->properties.numberOfVariables; i++)
-                ss << fmt::format("{}\n", 0);
+            // Keeps the solution points of the last feasible iteration since they may be needed in a repair
+            if(lastRetiredFeasibleIteration)
+                lastRetiredFeasibleIteration->solutionPoints.clear();
+
+            lastRetiredFeasibleIteration = iteration;
         }
+
+        iteration->hyperplanePoints.clear();
+        iteration->hyperplanePoints.shrink_to_fit();
+        iteration->constraintDeviations.clear();
+        iteration->constraintDeviations.shrink_to_fit();
     }
 
-    ss << fmt::format("objno 0 {}", status);
+    while(numberOfRetained > 0 && iterations.size() > numberOfRetained)
+    {
+        if(iterations.front()->solutionPoints.size() > 0 && iterations.front() != lastRetiredFeasibleIteration)
+        {
+            if(lastRetiredFeasibleIteration)
+                lastRetiredFeasibleIteration->solutionPoints.clear();
+
+            lastRetiredFeasibleIteration = iterations.front();
+        }
 
-    return (ss.str());
+        auto iteration = std::move(iterations.front());
+        iterations.pop_front();
+
+        // A few are enough, since at most one iteration is retired each time a new one is created
+        if(iteration.use_count() == 1 && recycledIterations.size() < 2)
+            recycledIterations.push_back(std::move(iteration));
+    }
 }
 
-void Results::createIteration() { iterations.push_back(std::make_shared<Iteration>(env)); }
+IterationSummary Results::createIterationSummary(const Iteration& iteration)
+{
+    IterationSummary summary;
+
+    summary.iterationNumber = iteration.iterationNumber;
+    summary.dualProblemClass = iteration.dualProblemClass;
+    summary.solutionStatus = iteration.solutionStatus;
+    summary.objectiveValue = iteration.objectiveValue;
+    summary.objectiveBounds = iteration.currentObjectiveBounds;
+    summary.maxDeviation = iteration.maxDeviation;
+    summary.maxDeviationConstraint = iteration.maxDeviationConstraint;
+    summary.numberOfSolutionPoints = iteration.solutionPoints.size();
+    summary.numberOfHyperplanesAdded = iteration.numHyperplanesAdded;
+    summary.totalNumberOfHyperplanes = iteration.totNumHyperplanes;
+    summary.numberOfExploredNodes = iteration.numberOfExploredNodes;
+    summary.solutionTime = iteration.solutionTime;
+
+    return (summary);
+}
 
 IterationPtr Results::getCurrentIteration() { return (iterations.back()); }
 
 IterationPtr Results::getPreviousIteration()
 {
-    if(getNumberOfIterations() > 1)
-        return (iterations[getNumberOfIterations() - 2]);
+    if(iterations.size() > 1)
+        return (iterations[iterations.size() - 2]);
     else
         throw Exception("Only one iteration!");
 }
@@ -1071,10 +1115,62 @@ std::optional<IterationPtr> Results::getLastFeasibleIteration()
         }
     }
 
+    if(!iteration && lastRetiredFeasibleIteration && lastRetiredFeasibleIteration->solutionPoints.size() > 0)
+        iteration = lastRetiredFeasibleIteration;
+
     return iteration;
 }
 
-int Results::getNumberOfIterations() { return (iterations.size()); }
+IterationPtr Results::getIteration(int iterationNumber)
+{
+    // The retained iterations have consecutive numbers
+    if(iterations.size() == 0)
+        return (nullptr);
+
+    int index = iterationNumber - iterations.front()->iterationNumber;
+
+    if(index < 0 || index >= (int)iterations.size())
+        return (nullptr);
+
+    return (iterations[index]);
+}
+
+int Results::getNumberOfIterations() { return (numberOfIterations); }
+
+std::vector<IterationSummary> Results::getIterationSummaries()
+{
+    auto summaries = iterationSummaries;
+
+    if(iterations.size() > 0)
+        summaries.push_back(createIterationSummary(*iterations.back()));
+
+    return (summaries);
+}
+
+SolverProgress Results::getProgress()
+{
+    std::lock_guard<std::mutex> lock(progressMutex);
+    return (progress);
+}
+
+void Results::updateProgress()
+{
+    // The pool and iteration values are updated where they are changed, since this may be called with the pool locked
+    double primalBound = getPrimalBound();
+    double dualBound = getGlobalDualBound();
+    double absoluteGap = getAbsoluteGlobalObjectiveGap();
+    double relativeGap = getRelativeGlobalObjectiveGap();
+    double elapsedTime = env->timing ? env->timing->getElapsedTime("Total") : 0.0;
+
+    std::lock_guard<std::mutex> lock(progressMutex);
+
+    progress.primalBound = primalBound;
+    progress.dualBound = dualBound;
+    progress.absoluteGap = absoluteGap;
+    progress.relativeGap = relativeGap;
+    progress.elapsedTime = elapsedTime;
+    progress.terminationReason = terminationReason;
+}
 
 double Results::getPrimalBound()
 {
@@ -1129,6 +1225,8 @@ void Results::setPrimalBound(double value)
     env->solutionStatistics.lastIterationWithSignificantPrimalUpdate = getNumberOfIterations() - 1;
     env->solutionStatistics.numberOfPrimalReductionCutsUpdatesWithoutEffect = 0;
     env->solutionStatistics.numberOfDualRepairsSinceLastPrimalUpdate = 0;
+
+    updateProgress();
 }
 
 double Results::getCurrentDualBound() { return (this->currentDualBound); }
@@ -1158,6 +1256,8 @@ void Results::setDualBound(double value)
     env->solutionStatistics.numberOfIterationsWithDualStagnation = 0;
 
     env->solutionStatistics.lastIterationWithSignificantDualUpdate = getNumberOfIterations() - 1;
+
+    updateProgress();
 }
 
 double Results::getAbsoluteGlobalObjectiveGap()
@@ -10,10 +10,16 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
 #include <map>
 #include <memory>
-#include <vector>
+#include <mutex>
 #include <optional>
+#include <ostream>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "Environment.h"
 #include "Iteration.h"
@@ -34,11 +40,22 @@ public:
     ~Results();
 
     VectorDouble primalSolution;
+
+    // Sorted with the best solution first, only changed by addPrimalSolution
     std::vector<PrimalSolution> primalSolutions;
     std::map<E_PrimalSolutionSource, int> primalSolutionSourceStatistics;
     std::map<E_AuxiliaryVariableType, int> auxiliaryVariablesIntroduced;
 
     void addPrimalSolution(PrimalSolution solution);
+
+    // A copy of the solution pool that can be taken while other threads add solutions
+    std::vector<PrimalSolution> getPrimalSolutions();
+
+    // The solution pool without copying the solutions, can also be taken while other threads add solutions
+    PrimalSolutionsView getPrimalSolutionsView();
+
+    // The point and objective value of the best solution taken together, the point is empty if there is no solution
+    std::pair<VectorDouble, double> getBestPrimalSolution();
     double getPrimalBound();
     void setPrimalBound(double value);
 
@@ -67,10 +84,27 @@ public:
     void createIteration();
     IterationPtr getCurrentIteration();
     IterationPtr getPreviousIteration();
+
+    // Returns the last iteration with solution points, also if it is no longer retained
     std::optional<IterationPtr> getLastFeasibleIteration();
-    std::vector<IterationPtr> iterations;
+
+    // Returns nullptr if the iteration is no longer retained
+    IterationPtr getIteration(int iterationNumber);
+
+    // Only the last Iterations.Retained iterations are kept, and unless Iterations.KeepPointData is true the point data
+    // (solution points, hyperplane points and constraint deviations) is only kept for the current and previous one
+    std::deque<IterationPtr> iterations;
+
+    // The total number of iterations, including the ones no longer retained
     int getNumberOfIterations();
 
+    // Summaries of all iterations, including the current one
+    std::vector<IterationSummary> getIterationSummaries();
+
+    // Can be called from any thread, updateProgress() is called when an iteration is created and the bounds change
+    SolverProgress getProgress();
+    void updateProgress();
+
     E_TerminationReason terminationReason = E_TerminationReason::None;
     std::string terminationReasonDescription;
 
@@ -89,6 +123,15 @@ public:
     std::string getResultsTrace();
     std::string getResultsSol();
 
+    // Writes the results directly to the stream or file without building them in memory first; the file versions
+    // return false if the file could not be written
+    void writeResultsOSrL(std::ostream& stream);
+    void writeResultsTrace(std::ostream& stream);
+    void writeResultsSol(std::ostream& stream);
+    bool writeResultsOSrL(const std::string& fileName);
+    bool writeResultsTrace(const std::string& fileName);
+    bool writeResultsSol(const std::string& fileName);
+
     void savePrimalSolutionToFile(
         const PrimalSolution& solution, const VectorString& variables, const std::string& fileName);
     void savePrimalSolutionToFile(
@@ -99,6 +142,37 @@ public:
 
 private:
     EnvironmentPtr env;
+
+    int numberOfIterations = 0;
+
+    std::vector<IterationSummary> iterationSummaries;
+
+    // The last iteration with solution points whose point data would otherwise have been removed
+    IterationPtr lastRetiredFeasibleIteration;
+
+    // The retired iterations that are no longer referenced, reused when creating new iterations
+    std::vector<IterationPtr> recycledIterations;
+
+    // Guards the solution pool, the fingerprints are Utilities::calculateHash of the points in the pool
+    std::mutex primalSolutionsMutex;
+    std::unordered_multiset<uint64_t> primalSolutionHashes;
+
+    // The solutions in the pool shared with the views, replaced when the pool changes
+    std::shared_ptr<const PrimalSolutionsView::Solutions> sharedPrimalSolutions
+        = std::make_shared<const PrimalSolutionsView::Solutions>();
+    uint64_t primalSolutionsGeneration = 0;
+
+    std::mutex progressMutex;
+    SolverProgress progress;
+
+    bool isBetterPrimalSolution(const PrimalSolution& firstSolution, const PrimalSolution& secondSolution) const;
+
+    IterationSummary createIterationSummary(const Iteration& iteration);
+
+    bool writeResultsToFile(const std::string& fileName, const std::function<void(std::ostream&)>& writer);
+
+    // Removes the iterations, and the point data of the iterations, that are no longer retained
+    void retireIterations();
 };
 
 } // namespace SHOT
\ No newline at end of file
@@ -37,6 +37,16 @@ public:
         double lambdaTol, double constrTol, ObjectiveFunctionPtr objectiveFunction)
         = 0;
 
+    // As above, but with the objective function value in the point already calculated
+    virtual std::pair<double, double> findZero(const VectorDouble& pt, double objectiveLB, double objectiveUB, int Nmax,
+        double lambdaTol, double constrTol, double objectiveValue)
+        = 0;
+
+    // Called after a batch of parallel root searches. With Parallel.Deterministic, the information from the root
+    // searches used to warm start the following ones is only used after this, so that the root searches in the batch
+    // do not depend on the order in which they are performed.
+    virtual void updateWarmStarts() {};
+
 protected:
     EnvironmentPtr env;
 };
@@ -15,15 +15,17 @@
 #include "../Results.h"
 #include "../PrimalSolver.h"
 #include "../Iteration.h"
+#include "../Metrics.h"
+#include "../ThreadPlacement.h"
+#include "../Utilities.h"
+
+#include <algorithm>
 
 #include "boost/math/tools/roots.hpp"
 #include "boost/cstdint.hpp"
 
 namespace SHOT
 {
-std::vector<NumericConstraint*> activeConstraints;
-double lastActiveConstraintUpdateValue;
-
 Test::Test(EnvironmentPtr envPtr) : env(envPtr) {}
 
 Test::~Test()
@@ -32,47 +34,198 @@ Test::~Test()
     secondPt.clear();
 }
 
-void Test::addActiveConstraint(NumericConstraint* constraint) { activeConstraints.push_back(constraint); }
+void Test::addActiveConstraint(NumericConstraint* constraint)
+{
+    ActiveConstraint activeConstraint;
+    activeConstraint.constraint = constraint;
+    activeConstraint.affineValueFirstPt = constraint->calculateAffineFunctionValue(firstPt);
+    activeConstraint.affineValueSecondPt = constraint->calculateAffineFunctionValue(secondPt);
+    activeConstraint.quadraticCoefficients = constraint->calculateQuadraticSegmentCoefficients(firstPt, secondPt);
+    activeConstraint.hasNonquadraticTerms = constraint->hasNonquadraticTerms();
+
+    if(activeConstraint.hasNonquadraticTerms)
+    {
+        activeConstraint.nonquadraticTerms = constraint->getNonquadraticSegmentTerms(firstPt, secondPt);
+
+        activeConstraint.hasNonquadraticTerms = activeConstraint.nonquadraticTerms.hasRemainingTerms
+            || activeConstraint.nonquadraticTerms.movingTerms.size() > 0;
+
+        // All the terms are constant along the segment
+        if(!activeConstraint.hasNonquadraticTerms)
+        {
+            activeConstraint.affineValueFirstPt += activeConstraint.nonquadraticTerms.constantValue;
+            activeConstraint.affineValueSecondPt += activeConstraint.nonquadraticTerms.constantValue;
+        }
+    }
+
+    if(activeConstraint.hasNonquadraticTerms)
+        isPointUsed = true;
+
+    activeConstraints.push_back(activeConstraint);
+}
 
 void Test::clearActiveConstraints() { activeConstraints.clear(); }
 
 void Test::setActiveConstraints(const std::vector<NumericConstraint*>& constraints)
 {
     clearActiveConstraints();
+    activeConstraints.reserve(constraints.size());
 
     for(auto& C : constraints)
         addActiveConstraint(C);
+
+    updateVariableSubset();
+}
+
+void Test::updateVariableSubset()
+{
+    isVariableSubsetUsed = false;
+    variableSubset.clear();
+    fixedVariableSubset.clear();
+
+    isPointUsed = std::any_of(activeConstraints.begin(), activeConstraints.end(),
+        [](const ActiveConstraint& C) { return (C.hasNonquadraticTerms); });
+
+    if(!useVariableSubset)
+        return;
+
+    std::vector<bool> isInSubset(firstPt.size(), false);
+
+    for(auto& C : activeConstraints)
+    {
+        for(auto& V : *C.constraint->getGradientSparsityPattern())
+        {
+            if(!isInSubset[V->index])
+            {
+                isInSubset[V->index] = true;
+
+                // The value in point is already the same as in both end points
+                if(firstPt[V->index] == secondPt[V->index])
+                    fixedVariableSubset.push_back(V->index);
+                else
+                    variableSubset.push_back(V->index);
+            }
+        }
+    }
+
+    // Not worth it if most of the variables are interpolated
+    if(variableSubset.size() > firstPt.size() / 2)
+    {
+        variableSubset.clear();
+        fixedVariableSubset.clear();
+        return;
+    }
+
+    std::sort(variableSubset.begin(), variableSubset.end());
+
+    // The other coordinates are never read by the constraints or have the same value in both end points
+    point = secondPt;
+    isVariableSubsetUsed = true;
 }
 
-std::vector<NumericConstraint*> Test::getActiveConstraints() { return (activeConstraints); }
+size_t Test::getNumberOfActiveConstraints() const { return (activeConstraints.size()); }
 
 double Test::operator()(const double x)
 {
-    auto length = firstPt.size();
-    VectorDouble ptNew(length);
-
-    for(size_t i = 0; i < length; i++)
+    if(isPointUsed && isVariableSubsetUsed)
     {
-        ptNew.at(i) = x * firstPt.at(i) + (1 - x) * secondPt.at(i);
+        for(auto i : variableSubset)
+            point[i] = x * firstPt[i] + (1 - x) * secondPt[i];
     }
+    else if(isPointUsed)
+    {
+        auto length = firstPt.size();
+        point.resize(length);
+
+        for(size_t i = 0; i < length; i++)
+            point[i] = x * firstPt[i] + (1 - x) * secondPt[i];
+    }
+
+    double calculatedValue = SHOT_DBL_MIN;
+    violatedConstraints.clear();
+    numberOfFunctionEvaluations += activeConstraints.size();
+
+    for(size_t j = 0; j < activeConstraints.size(); j++)
+    {
+        auto& C = activeConstraints[j];
 
-    auto currentConstraints = getActiveConstraints();
+        double value = x * C.affineValueFirstPt + (1 - x) * C.affineValueSecondPt + C.quadraticCoefficients[0]
+            + x * (C.quadraticCoefficients[1] + x * C.quadraticCoefficients[2]);
 
-    std::vector<NumericConstraint*> activeConstraints;
+        if(C.hasNonquadraticTerms)
+            value += C.constraint->calculateNonquadraticSegmentValue(C.nonquadraticTerms, point);
 
-    auto constraintValue = problem->getMaxNumericConstraintValue(ptNew, currentConstraints, activeConstraints);
-    double calculatedValue = constraintValue.normalizedValue;
+        double normalizedValue = std::max(value - C.constraint->valueRHS, C.constraint->valueLHS - value);
 
-    if(!constraintValue.isFulfilled && calculatedValue <= lastActiveConstraintUpdateValue
-        && activeConstraints.size() < currentConstraints.size())
+        if(normalizedValue > calculatedValue)
+            calculatedValue = normalizedValue;
+
+        if(normalizedValue > 0)
+            violatedConstraints.push_back(j);
+    }
+
+    if(calculatedValue > 0 && calculatedValue <= lastActiveConstraintUpdateValue
+        && violatedConstraints.size() < activeConstraints.size())
     {
-        setActiveConstraints(activeConstraints);
+        // Only keeps the violated constraints, the order is preserved
+        for(size_t j = 0; j < violatedConstraints.size(); j++)
+            activeConstraints[j] = activeConstraints[violatedConstraints[j]];
+
+        activeConstraints.resize(violatedConstraints.size());
         lastActiveConstraintUpdateValue = calculatedValue;
     }
 
     return (calculatedValue);
 }
 
+void Test::operator()(const VectorDouble& x, VectorDouble& values)
+{
+    int numberOfPoints = x.size();
+    int length = firstPt.size();
+
+    block.numberOfPoints = numberOfPoints;
+    block.numberOfVariables = length;
+    block.values.resize(numberOfPoints * length);
+
+    auto interpolate = [&](int i) {
+        double* variableValues = block.values.data() + i * numberOfPoints;
+
+        for(int p = 0; p < numberOfPoints; p++)
+            variableValues[p] = x[p] * firstPt[i] + (1 - x[p]) * secondPt[i];
+    };
+
+    if(isVariableSubsetUsed)
+    {
+        for(auto i : variableSubset)
+            interpolate(i);
+
+        for(auto i : fixedVariableSubset)
+            std::fill_n(block.values.data() + i * numberOfPoints, numberOfPoints, secondPt[i]);
+    }
+    else
+    {
+        for(int i = 0; i < length; i++)
+            interpolate(i);
+    }
+
+    values.assign(numberOfPoints, SHOT_DBL_MIN);
+    constraintValues.resize(numberOfPoints);
+    numberOfFunctionEvaluations += activeConstraints.size() * numberOfPoints;
+
+    for(auto& C : activeConstraints)
+    {
+        C.constraint->calculateFunctionValues(block, constraintValues.data());
+
+        for(int p = 0; p < numberOfPoints; p++)
+        {
+            double normalizedValue = std::max(
+                constraintValues[p] - C.constraint->valueRHS, C.constraint->valueLHS - constraintValues[p]);
+
+            values[p] = std::max(values[p], normalizedValue);
+        }
+    }
+}
+
 TestObjective::TestObjective(EnvironmentPtr envPtr) : env(envPtr) {}
 
 TestObjective::~TestObjective() = default;
@@ -87,13 +240,149 @@ double TestObjective::operator()(const double x)
     return (calculatedValue);
 }
 
+void TestObjective::operator()(const VectorDouble& x, VectorDouble& values)
+{
+    values.resize(x.size());
+
+    for(size_t p = 0; p < x.size(); p++)
+        values[p] = cachedObjectiveValue - (x[p] * firstPt + (1 - x[p]) * secondPt);
+}
+
 RootsearchMethodBoost::RootsearchMethodBoost(EnvironmentPtr envPtr) : env(envPtr)
 {
-    test = std::make_unique<Test>(env);
     testObjective = std::make_unique<TestObjective>(env);
 }
 
-RootsearchMethodBoost::~RootsearchMethodBoost() { activeConstraints.clear(); }
+RootsearchMethodBoost::~RootsearchMethodBoost() = default;
+
+template <typename F>
+PairDouble RootsearchMethodBoost::findZeroKSection(F& function, double a, double b, int numberOfPoints,
+    TerminationCondition termination, boost::uintmax_t& maxIterations)
+{
+    VectorDouble x = { a, b };
+    VectorDouble values;
+
+    function(x, values);
+
+    double valueA = values[0];
+
+    if(valueA == 0.0)
+    {
+        maxIterations = 0;
+        return (PairDouble(a, a));
+    }
+
+    if(values[1] == 0.0)
+    {
+        maxIterations = 0;
+        return (PairDouble(b, b));
+    }
+
+    if((valueA > 0) == (values[1] > 0))
+        throw std::runtime_error("No change of sign in k-section root search.");
+
+    x.resize(numberOfPoints);
+    boost::uintmax_t iterations = 0;
+
+    while(iterations < maxIterations && !termination(a, b))
+    {
+        double step = (b - a) / (numberOfPoints + 1);
+
+        for(int j = 0; j < numberOfPoints; j++)
+            x[j] = a + (j + 1) * step;
+
+        function(x, values);
+        iterations++;
+
+        // The root is in the last subinterval if no change of sign is found among the interior points
+        double newA = x[numberOfPoints - 1];
+        double newB = b;
+        double newValueA = values[numberOfPoints - 1];
+
+        for(int j = 0; j < numberOfPoints; j++)
+        {
+            if(values[j] == 0.0)
+            {
+                maxIterations = iterations;
+                return (PairDouble(x[j], x[j]));
+            }
+
+            double previousValue = (j == 0) ? valueA : values[j - 1];
+
+            if((values[j] > 0) != (previousValue > 0))
+            {
+                newA = (j == 0) ? a : x[j - 1];
+                newB = x[j];
+                newValueA = previousValue;
+                break;
+            }
+        }
+
+        // The interval cannot be divided further in floating point arithmetic
+        if(newA == a && newB == b)
+            break;
+
+        a = newA;
+        b = newB;
+        valueA = newValueA;
+    }
+
+    maxIterations = iterations;
+
+    return (PairDouble(a, b));
+}
+
+PairDouble RootsearchMethodBoost::getWarmStartBracket(Test& function, const std::pair<uint64_t, int>& rootKey)
+{
+    double predictedRoot;
+
+    {
+        std::lock_guard<std::mutex> lock(previousRootsMutex);
+
+        auto previousRoot = previousRoots.find(rootKey);
+
+        if(previousRoot == previousRoots.end())
+            return (PairDouble(0.0, 1.0));
+
+        predictedRoot = previousRoot->second;
+    }
+
+    double width = env->settings->getSetting<double>("Rootsearch.WarmStart.BracketWidth", "Subsolver");
+    double lower = std::max(0.0, predictedRoot - width);
+    double upper = std::min(1.0, predictedRoot + width);
+
+    // The sign of the function is opposite at 0 and 1. If the sign does not change in the bracket, the root is in one
+    // of the remaining parts of [0, 1], which is still smaller. The function is evaluated at 0 since it only includes
+    // the active constraints, so its sign there may differ from that of valSecondPt.
+    bool isPositiveAtZero = (function(0.0) > 0);
+
+    if(lower > 0.0 && (function(lower) > 0) != isPositiveAtZero)
+        return (PairDouble(0.0, lower));
+
+    if(upper < 1.0 && (function(upper) > 0) == isPositiveAtZero)
+        return (PairDouble(upper, 1.0));
+
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::RootsearchWarmStarts);
+
+    return (PairDouble(lower, upper));
+}
+
+void RootsearchMethodBoost::updateWarmStarts()
+{
+    std::lock_guard<std::mutex> lock(previousRootsMutex);
+
+    if(pendingRoots.empty())
+        return;
+
+    if(previousRoots.size() + pendingRoots.size() >= maxNumberOfPreviousRoots)
+        previousRoots.clear();
+
+    for(auto& [key, root] : pendingRoots)
+        previousRoots[key] = root.second;
+
+    pendingRoots.clear();
+}
 
 std::pair<VectorDouble, VectorDouble> RootsearchMethodBoost::findZero(const VectorDouble& ptA, const VectorDouble& ptB,
     int Nmax, double lambdaTol, double constrTol, const NonlinearConstraints constraints,
@@ -125,6 +414,9 @@ std::pair<VectorDouble, VectorDouble> RootsearchMethodBoost::findZero(const Vect
         env->output->outputError("        No constraints selected for root search");
     }
 
+    // A local function object is used so that several root searches can be performed in parallel
+    auto test = std::make_unique<Test>(env);
+
     if(auto sharedProblem = constraints[0]->ownerProblem.lock())
     {
         test->problem = sharedProblem.get();
@@ -138,21 +430,23 @@ std::pair<VectorDouble, VectorDouble> RootsearchMethodBoost::findZero(const Vect
 
     test->firstPt = ptA;
     test->secondPt = ptB;
+    test->useVariableSubset = env->settings->getSetting<bool>("Rootsearch.UseConstraintVariables", "Subsolver");
 
     std::vector<NumericConstraint*> firstActiveConstraints;
     std::vector<NumericConstraint*> secondActiveConstraints;
 
     test->valFirstPt
         = test->problem->getMaxNumericConstraintValue(ptA, constraints, firstActiveConstraints).normalizedValue;
-    test->valSecondPt
-        = test->problem->getMaxNumericConstraintValue(ptB, constraints, secondActiveConstraints).normalizedValue;
+
+    auto maxValueSecondPt = test->problem->getMaxNumericConstraintValue(ptB, constraints, secondActiveConstraints);
+    test->valSecondPt = maxValueSecondPt.normalizedValue;
 
     if(test->valFirstPt > 0)
         test->setActiveConstraints(firstActiveConstraints);
     else
         test->setActiveConstraints(secondActiveConstraints);
 
-    if(test->getActiveConstraints().size() == 0) // All constraints are fulfilled.
+    if(test->getNumberOfActiveConstraints() == 0) // All constraints are fulfilled.
     {
         if(test->valFirstPt > test->valSecondPt)
         {
@@ -166,21 +460,74 @@ std::pair<VectorDouble, VectorDouble> RootsearchMethodBoost::findZero(const Vect
         return (tmpPair);
     }
 
-    int tempFEvals = env->solutionStatistics.numberOfFunctionEvalutions;
+    MetricsTimer timer(env->metrics.get(), E_MetricsHistogram::RootsearchTime);
 
     PairDouble r1;
+    PairDouble bracket(0.0, 1.0);
+
+    bool useWarmStart = env->settings->getSetting<bool>("Rootsearch.WarmStart.Use", "Subsolver");
+    std::pair<uint64_t, int> rootKey;
+
+    if(useWarmStart)
+    {
+        rootKey = std::make_pair(
+            Utilities::calculateHash(ptA), maxValueSecondPt.constraint ? maxValueSecondPt.constraint->index : -1);
+
+        bracket = getWarmStartBracket(*test, rootKey);
+    }
 
-    if(static_cast<ES_RootsearchMethod>(env->settings->getSetting<int>("Rootsearch.Method", "Subsolver"))
-        == ES_RootsearchMethod::BoostTOMS748)
+    auto rootsearchMethod
+        = static_cast<ES_RootsearchMethod>(env->settings->getSetting<int>("Rootsearch.Method", "Subsolver"));
+
+    if(rootsearchMethod == ES_RootsearchMethod::BoostTOMS748)
     {
-        r1 = boost::math::tools::toms748_solve(*test, 0.0, 1.0, TerminationCondition(lambdaTol), max_iter);
+        r1 = boost::math::tools::toms748_solve(
+            *test, bracket.first, bracket.second, TerminationCondition(lambdaTol), max_iter);
+    }
+    else if(rootsearchMethod == ES_RootsearchMethod::KSection)
+    {
+        r1 = findZeroKSection(*test, bracket.first, bracket.second,
+            env->settings->getSetting<int>("Rootsearch.KSection.NumberOfPoints", "Subsolver"),
+            TerminationCondition(lambdaTol), max_iter);
     }
     else
     {
-        r1 = boost::math::tools::bisect(*test, 0.0, 1.0, TerminationCondition(lambdaTol), max_iter);
+        r1 = boost::math::tools::bisect(
+            *test, bracket.first, bracket.second, TerminationCondition(lambdaTol), max_iter);
+    }
+
+    if(useWarmStart)
+    {
+        std::lock_guard<std::mutex> lock(previousRootsMutex);
+
+        double root = 0.5 * (r1.first + r1.second);
+
+        if(ThreadPlacement::isDeterministic(env->settings))
+        {
+            uint64_t exteriorPointHash = Utilities::calculateHash(ptB);
+            auto pendingRoot = pendingRoots.emplace(rootKey, std::make_pair(exteriorPointHash, root));
+
+            if(!pendingRoot.second && exteriorPointHash < pendingRoot.first->second.first)
+                pendingRoot.first->second = std::make_pair(exteriorPointHash, root);
+        }
+        else
+        {
+            if(previousRoots.size() >= maxNumberOfPreviousRoots)
+                previousRoots.clear();
+
+            previousRoots[rootKey] = root;
+        }
+    }
+
+    auto resFVals = test->numberOfFunctionEvaluations;
+
+    if(env->metrics)
+    {
+        env->metrics->increment(E_MetricsCounter::RootsearchCalls);
+        env->metrics->increment(E_MetricsCounter::RootsearchIterations, max_iter);
+        env->metrics->increment(E_MetricsCounter::ConstraintEvaluations, resFVals);
     }
 
-    int resFVals = env->solutionStatistics.numberOfFunctionEvalutions - tempFEvals;
     if((int)max_iter == Nmax)
     {
         env->output->outputDebug(
@@ -225,32 +572,50 @@ std::pair<VectorDouble, VectorDouble> RootsearchMethodBoost::findZero(const Vect
 }
 
 std::pair<double, double> RootsearchMethodBoost::findZero(const VectorDouble& pt, double objectiveLB,
-    double objectiveUB, int Nmax, double lambdaTol, [[maybe_unused]] double constrTol,
-    ObjectiveFunctionPtr objectiveFunction)
+    double objectiveUB, int Nmax, double lambdaTol, double constrTol, ObjectiveFunctionPtr objectiveFunction)
+{
+    return (findZero(pt, objectiveLB, objectiveUB, Nmax, lambdaTol, constrTol, objectiveFunction->calculateValue(pt)));
+}
+
+std::pair<double, double> RootsearchMethodBoost::findZero(const VectorDouble& pt, double objectiveLB,
+    double objectiveUB, int Nmax, double lambdaTol, [[maybe_unused]] double constrTol, double objectiveValue)
 {
     testObjective->solutionPoint = pt;
     testObjective->firstPt = objectiveLB;
     testObjective->secondPt = objectiveUB;
 
-    testObjective->cachedObjectiveValue = objectiveFunction->calculateValue(pt);
+    testObjective->cachedObjectiveValue = objectiveValue;
 
     boost::uintmax_t max_iter = Nmax;
 
-    int tempFEvals = env->solutionStatistics.numberOfFunctionEvalutions;
+    MetricsTimer timer(env->metrics.get(), E_MetricsHistogram::RootsearchTime);
 
     PairDouble r1;
 
-    if(static_cast<ES_RootsearchMethod>(env->settings->getSetting<int>("Rootsearch.Method", "Subsolver"))
-        == ES_RootsearchMethod::BoostTOMS748)
+    auto rootsearchMethod
+        = static_cast<ES_RootsearchMethod>(env->settings->getSetting<int>("Rootsearch.Method", "Subsolver"));
+
+    if(rootsearchMethod == ES_RootsearchMethod::BoostTOMS748)
     {
         r1 = boost::math::tools::toms748_solve(*testObjective, 0.0, 1.0, TerminationCondition(lambdaTol), max_iter);
     }
+    else if(rootsearchMethod == ES_RootsearchMethod::KSection)
+    {
+        r1 = findZeroKSection(*testObjective, 0.0, 1.0,
+            env->settings->getSetting<int>("Rootsearch.KSection.NumberOfPoints", "Subsolver"),
+            TerminationCondition(lambdaTol), max_iter);
+    }
     else
     {
         r1 = boost::math::tools::bisect(*testObjective, 0.0, 1.0, TerminationCondition(lambdaTol), max_iter);
     }
 
-    int resFVals = env->solutionStatistics.numberOfFunctionEvalutions - tempFEvals;
+    if(env->metrics)
+    {
+        env->metrics->increment(E_MetricsCounter::RootsearchCalls);
+        env->metrics->increment(E_MetricsCounter::RootsearchIterations, max_iter);
+    }
+
     if((int)max_iter == Nmax)
     {
         env->output->outputDebug(
@@ -258,8 +623,7 @@ std::pair<double, double> RootsearchMethodBoost::findZero(const VectorDouble& pt
     }
     else
     {
-        env->output->outputTrace("        Line search iterations: " + std::to_string(max_iter)
-            + ". Function evaluations: " + std::to_string(resFVals));
+        env->output->outputTrace("        Line search iterations: " + std::to_string(max_iter) + ".");
     }
 
     double ptNew = r1.first * objectiveLB + (1 - r1.first) * objectiveUB;
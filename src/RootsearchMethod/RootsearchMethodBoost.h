@@ -12,13 +12,54 @@
 #include "IRootsearchMethod.h"
 #include "../Environment.h"
 
+#include "boost/cstdint.hpp"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <utility>
+
 namespace SHOT
 {
+// The function used in the root search. All state is kept in the object, so root searches using separate instances can
+// be performed concurrently. The point buffer and the active set are reused between the evaluations, and the affine
+// parts of the active constraints are only calculated in the end points and then interpolated along the segment. The
+// quadratic terms are a quadratic polynomial along the segment, so the point is only needed for the other terms. Of
+// these, the monomial and signomial terms whose variables are equal in the end points are only calculated once.
 class Test
 {
 private:
     EnvironmentPtr env;
 
+    struct ActiveConstraint
+    {
+        NumericConstraint* constraint;
+        double affineValueFirstPt;
+        double affineValueSecondPt;
+        std::array<double, 3> quadraticCoefficients;
+        bool hasNonquadraticTerms;
+        NonquadraticSegmentTerms nonquadraticTerms;
+    };
+
+    std::vector<ActiveConstraint> activeConstraints;
+    std::vector<size_t> violatedConstraints;
+    double lastActiveConstraintUpdateValue = 0.0;
+
+    VectorDouble point;
+
+    // The variables in the active constraints that differ between the end points, only these coordinates of point are
+    // interpolated if the subset is used
+    VectorInteger variableSubset;
+
+    // The variables in the active constraints with the same value in both end points
+    VectorInteger fixedVariableSubset;
+    bool isVariableSubsetUsed = false;
+
+    // Whether some active constraint has other nonaffine terms than quadratic ones, otherwise no point is needed
+    bool isPointUsed = true;
+
+    void updateVariableSubset();
+
 public:
     Problem* problem;
 
@@ -28,15 +69,30 @@ public:
     double valFirstPt;
     double valSecondPt;
 
+    // Whether to only interpolate the variables in the active constraints if they are fewer than all variables
+    bool useVariableSubset = false;
+
+    // The number of evaluated constraint functions, it is added to the metrics once the root search is finished
+    size_t numberOfFunctionEvaluations = 0;
+
     Test(EnvironmentPtr envPtr);
     ~Test();
 
+    // The end points must be set before the active constraints
     void setActiveConstraints(const std::vector<NumericConstraint*>& constraints);
-    std::vector<NumericConstraint*> getActiveConstraints();
+    size_t getNumberOfActiveConstraints() const;
     void clearActiveConstraints();
     void addActiveConstraint(NumericConstraint* constraint);
 
     double operator()(const double x);
+
+    // Calculates the function value for all values in x simultaneously using the batched constraint evaluation. The
+    // active set is not updated.
+    void operator()(const VectorDouble& x, VectorDouble& values);
+
+private:
+    PointBlock block;
+    VectorDouble constraintValues;
 };
 
 class TestObjective
@@ -55,6 +111,7 @@ public:
     ~TestObjective();
 
     double operator()(const double x);
+    void operator()(const VectorDouble& x, VectorDouble& values);
 };
 
 class TerminationCondition
@@ -84,9 +141,36 @@ public:
     std::pair<double, double> findZero(const VectorDouble& pt, double objectiveLB, double objectiveUB, int Nmax,
         double lambdaTol, double constrTol, ObjectiveFunctionPtr objectiveFunction) override;
 
+    std::pair<double, double> findZero(const VectorDouble& pt, double objectiveLB, double objectiveUB, int Nmax,
+        double lambdaTol, double constrTol, double objectiveValue) override;
+
+    void updateWarmStarts() override;
+
 private:
-    std::unique_ptr<Test> test;
     std::unique_ptr<TestObjective> testObjective;
     EnvironmentPtr env;
+
+    // The last root found between an interior point and an exterior point for the same constraint, identified by the
+    // hash of the interior point and the index of the most violated constraint in the exterior point. The roots change
+    // slowly between the iterations, so the next search starts with a small bracket around the previous root.
+    std::map<std::pair<uint64_t, int>, double> previousRoots;
+    std::mutex previousRootsMutex;
+
+    // With Parallel.Deterministic, the roots found since the last call to updateWarmStarts(). If several root searches
+    // have the same key, the root is taken from the one with the smallest hash of the exterior point.
+    std::map<std::pair<uint64_t, int>, std::pair<uint64_t, double>> pendingRoots;
+
+    static constexpr size_t maxNumberOfPreviousRoots = 100000;
+
+    // Returns the bracket of the given width around the previous root if the function changes sign in it, otherwise
+    // the part of [0, 1] on the side of it that contains the root, or [0, 1] if there is no previous root
+    PairDouble getWarmStartBracket(Test& function, const std::pair<uint64_t, int>& rootKey);
+
+    // Brackets the root in [a, b] by evaluating the function in numberOfPoints equidistant interior points in each
+    // iteration, and keeping the subinterval where the sign changes. On return maxIterations contains the number of
+    // iterations performed.
+    template <typename F>
+    PairDouble findZeroKSection(F& function, double a, double b, int numberOfPoints, TerminationCondition termination,
+        boost::uintmax_t& maxIterations);
 };
 } // namespace SHOT
\ No newline at end of file
@@ -10,8 +10,11 @@
 
 #include "Environment.h"
 #include "Solver.h"
+#include "SolverPortfolio.h"
+#include "FixedNLPWorker.h"
 #include "Report.h"
 #include "Utilities.h"
+#include "WarmStart.h"
 #include "Output.h"
 #include "Settings.h"
 #include "Problem.h"
@@ -46,6 +49,11 @@ int main(int argc, char* argv[])
     cmdl.add_params({ "--sol" });
     cmdl.add_params({ "--docs" });
     cmdl.add_params({ "--debug" });
+    cmdl.add_params({ "--timeline" });
+    cmdl.add_params({ "--checkpoint", "--resume" });
+    cmdl.add_params({ "--initialsol" });
+    cmdl.add_params({ "--portfolio" });
+    cmdl.add_params({ "--worker" });
 
     cmdl.parse(argc, argv);
 
@@ -109,6 +117,26 @@ int main(int argc, char* argv[])
         env->output->outputCritical("   --osrl FILE              Sets the filename for the OSrL result file");
         env->output->outputCritical(
             "   --trc [FILE]             Prints a trace file to <problemname>.trc or specified filename");
+        env->output->outputCritical(
+            "   --timeline FILE          Writes a timeline of the solver phases to FILE in Chrome trace format");
+        env->output->outputCritical(
+            "   --initialsol FILE        Starts with the primal solution in FILE, an AMPL sol file or a text file");
+        env->output->outputCritical(
+            "                            with a value or a variable name and value on each line");
+        env->output->outputCritical(
+            "   --checkpoint FILE        Periodically writes a checkpoint of the solver state to FILE");
+        env->output->outputCritical(
+            "   --resume FILE            Resumes a stopped run from the checkpoint in FILE and continues to update it");
+        env->output->outputCritical(
+            "   --portfolio [FILE]       Solves with several configurations in parallel, FILE is an options file");
+        env->output->outputCritical(
+            "                            with one configuration per section starting with a line [NAME]");
+        env->output->outputCritical(
+            "   --worker PORT            Solves fixed NLP problems for solvers with FixedInteger.RemoteWorkers");
+        env->output->outputCritical(
+            "                            set, the problem and options must be the same as in the solver");
+        env->output->outputCritical(
+            "                            the connections are accepted on FixedInteger.WorkerAddress (127.0.0.1)");
         env->output->outputCritical("");
         env->output->outputCritical("");
         env->output->outputCritical("  It is possible to specify options directly using the the command line:");
@@ -387,6 +415,14 @@ int main(int argc, char* argv[])
         solver.updateSetting("Debug.Path", "Output", debugPath);
     }
 
+    if(cmdl("--timeline"))
+        solver.updateSetting("Timeline.File", "Output", cmdl("--timeline").str());
+
+    if(cmdl("--checkpoint"))
+        solver.updateSetting("Checkpoint.File", "Output", cmdl("--checkpoint").str());
+    else if(cmdl("--resume"))
+        solver.updateSetting("Checkpoint.File", "Output", cmdl("--resume").str());
+
     std::string argValue;
 
     if(cmdl("--mip") >> argValue)
@@ -648,6 +684,19 @@ int main(int argc, char* argv[])
         return (0);
     }
 
+    if(cmdl("--resume"))
+    {
+        auto checkpoint = std::make_shared<WarmStart>(env);
+
+        if(!checkpoint->read(cmdl("--resume").str()))
+            return (0);
+
+        solver.setWarmStart(checkpoint);
+    }
+
+    if(cmdl("--initialsol") && !solver.readPrimalSolutionHint(cmdl("--initialsol").str()))
+        return (0);
+
     // Check if we want to use the ASL calling format
     if(useASL && !((ES_SourceFormat)env->settings->getSetting<int>("SourceFormat", "Input") == ES_SourceFormat::NL))
     {
@@ -655,6 +704,25 @@ int main(int argc, char* argv[])
         return (0);
     }
 
+    // Solves the fixed NLP problems of other solvers instead of the problem
+    if(cmdl("--worker"))
+    {
+        FixedNLPWorker worker(env);
+        int port;
+
+        if(!(cmdl("--worker") >> port))
+        {
+            env->output->outputCritical(" Cannot read value for parameter 'worker'");
+            return (0);
+        }
+
+        if(!worker.listen(port))
+            return (0);
+
+        worker.serve();
+        return (0);
+    }
+
     // Define result file locations
 
     std::string osrlFilename;
@@ -691,12 +759,42 @@ int main(int argc, char* argv[])
     env->report->outputProblemInstanceReport();
     env->report->outputOptionsReport();
 
-    if(!solver.solveProblem()) // Solve the problem
+    // The solver whose results are reported and written
+    Solver* resultSolver = &solver;
+    std::unique_ptr<SolverPortfolio> portfolio;
+
+    if(cmdl["--portfolio"] || cmdl("--portfolio"))
+    {
+        portfolio = std::make_unique<SolverPortfolio>(env->output);
+        portfolio->setBaseOptions(solver.getOptions());
+
+        if(cmdl("--portfolio"))
+        {
+            if(!portfolio->addConfigurationsFromFile(cmdl("--portfolio").str()))
+                return (0);
+        }
+        else
+        {
+            portfolio->addDefaultConfigurations();
+        }
+
+        if(!portfolio->setProblem(filename) || !portfolio->solveProblem())
+            return (0);
+
+        resultSolver = &portfolio->getBestSolver();
+
+        // The configurations are solved without output
+        resultSolver->getEnvironment()->output->setLogLevels(
+            static_cast<E_LogLevel>(env->settings->getSetting<int>("Console.LogLevel", "Output")), E_LogLevel::Off);
+
+        env = resultSolver->getEnvironment();
+    }
+    else if(!solver.solveProblem()) // Solve the problem
     {
         return (0);
     }
 
-    solver.finalizeSolution();
+    resultSolver->finalizeSolution();
     env->report->outputSolutionReport();
 
 #ifdef SIMPLE_OUTPUT_CHARS
@@ -709,22 +807,20 @@ int main(int argc, char* argv[])
 
     env->output->outputInfo("");
 
-    std::string osrl = solver.getResultsOSrL();
-
     if(resultFile.empty())
     {
         fs::filesystem::path resultPath(env->settings->getSetting<std::string>("ResultPath", "Output"));
         resultPath /= env->settings->getSetting<std::string>("ProblemName", "Input");
         resultPath = resultPath.replace_extension(".osrl");
 
-        if(!Utilities::writeStringToFile(resultPath.string(), osrl))
+        if(!resultSolver->writeResultsOSrL(resultPath.string()))
             env->output->outputCritical(" Error when writing OSrL file to: " + resultPath.string());
         else
             env->output->outputInfo(" Results written to: " + resultPath.string());
     }
     else
     {
-        if(!Utilities::writeStringToFile(resultFile.string(), osrl))
+        if(!resultSolver->writeResultsOSrL(resultFile.string()))
             env->output->outputCritical(" Error when writing OSrL file to: " + resultFile.string());
         else
             env->output->outputInfo(" Results written to: " + resultFile.string());
@@ -735,22 +831,20 @@ int main(int argc, char* argv[])
 
     if(cmdl["--trc"] || cmdl("--trc"))
     {
-        std::string trace = solver.getResultsTrace();
-
         if(traceFile.empty())
         {
             fs::filesystem::path tracePath(env->settings->getSetting<std::string>("ResultPath", "Output"));
             tracePath /= env->settings->getSetting<std::string>("ProblemName", "Input");
             tracePath = tracePath.replace_extension(".trc");
 
-            if(!Utilities::writeStringToFile(tracePath.string(), trace))
+            if(!resultSolver->writeResultsTrace(tracePath.string()))
                 env->output->outputCritical(" Error when writing trace file: " + tracePath.string());
             else
                 env->output->outputInfo("                     " + tracePath.string());
         }
         else
         {
-            if(!Utilities::writeStringToFile(traceFile.string(), trace))
+            if(!resultSolver->writeResultsTrace(traceFile.string()))
                 env->output->outputCritical(" Error when writing trace file: " + traceFile.string());
             else
                 env->output->outputInfo("                     " + traceFile.string());
@@ -759,21 +853,19 @@ int main(int argc, char* argv[])
 
     if(cmdl["--sol"] || cmdl("--sol") || useASL)
     {
-        std::string sol = solver.getResultsSol();
-
         if(solFile.empty())
         {
             fs::filesystem::path solPath(filename);
             solPath = solPath.replace_extension(".sol");
 
-            if(!Utilities::writeStringToFile(solPath.string(), sol))
+            if(!resultSolver->writeResultsSol(solPath.string()))
                 env->output->outputCritical(" Error when writing AMPL sol file: " + solPath.string());
             else
                 env->output->outputInfo("                     " + solPath.string());
         }
         else
         {
-            if(!Utilities::writeStringToFile(solFile.string(), sol))
+            if(!resultSolver->writeResultsSol(solFile.string()))
                 env->output->outputCritical(" Error when writing AMPL sol file: " + solFile.string());
             else
                 env->output->outputInfo("                     " + solFile.string());
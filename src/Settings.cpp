@@ -33,40 +33,68 @@ void Settings::createBaseSetting(
 
     PairString key = make_pair(category, name);
 
+    auto& mutableSchema = getMutableSchema();
+    auto& values = getSettingValues<T>();
+
+    auto identifier = mutableSchema.identifiers.find(key);
+
+    if(identifier == mutableSchema.identifiers.end())
+    {
+        identifier = mutableSchema.identifiers.emplace(key, mutableSchema.definitions.size()).first;
+        mutableSchema.definitions.emplace_back();
+        settingIsDefaultValue.push_back(true);
+    }
+
+    auto& definition = mutableSchema.definitions[identifier->second];
+
+    if(definition.name.empty() || definition.type != getSettingType<T>())
+    {
+        // The old value of a setting that is created again with another type is not used anymore
+        definition.valueIndex = values.size();
+        values.emplace_back();
+    }
+
+    definition = SettingDefinition { name, category, description, getSettingType<T>(), isPrivate, false,
+        { 0.0, 0.0 }, {}, definition.valueIndex };
+
+    values[definition.valueIndex] = value;
+    settingIsDefaultValue[identifier->second] = true;
+
     std::string tempValue;
 
     if constexpr(std::is_same_v<T, std::string>)
     {
-        stringSettings[key] = value;
-        settingTypes[key] = E_SettingType::String;
         tempValue = Utilities::trim(value);
         output->outputTrace(" String setting " + category + "." + name + " = " + tempValue + " created.");
     }
     else if constexpr(std::is_same_v<T, int>)
     {
-        integerSettings[key] = value;
-        settingTypes[key] = E_SettingType::Integer;
         tempValue = std::to_string(value);
         output->outputTrace(" Integer setting " + category + "." + name + " = " + tempValue + " created.");
     }
     else if constexpr(std::is_same_v<T, double>)
     {
-        doubleSettings[key] = value;
-        settingTypes[key] = E_SettingType::Double;
         tempValue = std::to_string(value);
         output->outputTrace(" Double setting " + category + "." + name + " = " + tempValue + " created.");
     }
     else if constexpr(std::is_same_v<T, bool>)
     {
-        booleanSettings[key] = value;
-        settingTypes[key] = E_SettingType::Boolean;
         tempValue = std::to_string(value);
         output->outputTrace(" Boolean " + category + "." + name + " = " + tempValue + " created.");
     }
+}
+
+void Settings::assignSettings(const Settings& other)
+{
+    schema = other.schema;
 
-    settingDescriptions[key] = description;
-    settingIsPrivate[key] = isPrivate;
-    settingIsDefaultValue[key] = true;
+    stringSettings = other.stringSettings;
+    doubleSettings = other.doubleSettings;
+    integerSettings = other.integerSettings;
+    booleanSettings = other.booleanSettings;
+
+    settingIsDefaultValue = other.settingIsDefaultValue;
+    settingsInitialized = other.settingsInitialized;
 }
 
 template void Settings::updateSetting(std::string name, std::string category, std::string value);
@@ -83,103 +111,63 @@ template <typename T> void Settings::updateSetting(std::string name, std::string
 
     PairString key = make_pair(category, name);
 
-    typename std::map<PairString, T>::iterator oldValue;
-    typename std::map<PairString, T>::iterator end;
+    auto identifier = schema->identifiers.find(key);
 
-    if constexpr(std::is_same_v<T, std::string>)
+    if(identifier == schema->identifiers.end() || schema->definitions[identifier->second].type != getSettingType<T>())
     {
-        oldValue = stringSettings.find(key);
-        end = stringSettings.end();
+        output->outputError("Cannot update setting " + category + "." + name + " since it has not been defined.");
+
+        throw SettingKeyNotFoundException(name, category);
     }
-    else if constexpr(std::is_same_v<T, int>)
-    {
-        if(settingBounds[key].first > value || settingBounds[key].second < value)
-        {
-            output->outputError(" Cannot update setting " + category + "." + name + ": Not in interval ["
-                + std::to_string(settingBounds[key].first) + "," + std::to_string(settingBounds[key].second) + "].");
 
-            throw SettingOutsideBoundsException(
-                name, category, (double)value, settingBounds[key].first, settingBounds[key].second);
-        }
+    auto& definition = schema->definitions[identifier->second];
+    auto& oldValue = getSettingValues<T>()[definition.valueIndex];
 
-        oldValue = integerSettings.find(key);
-        end = integerSettings.end();
-    }
-    else if constexpr(std::is_same_v<T, double>)
+    if constexpr(std::is_same_v<T, int> || std::is_same_v<T, double>)
     {
-        if(settingBounds[key].first > value || settingBounds[key].second < value)
+        auto& bounds = definition.bounds;
+
+        if(bounds.first > value || bounds.second < value)
         {
             output->outputError(" Cannot update setting " + category + "." + name + ": Not in interval ["
-                + std::to_string(settingBounds[key].first) + "," + std::to_string(settingBounds[key].second) + "].");
+                + std::to_string(bounds.first) + "," + std::to_string(bounds.second) + "].");
 
-            throw SettingOutsideBoundsException(
-                name, category, (double)value, settingBounds[key].first, settingBounds[key].second);
+            throw SettingOutsideBoundsException(name, category, (double)value, bounds.first, bounds.second);
         }
-
-        oldValue = doubleSettings.find(key);
-        end = doubleSettings.end();
-    }
-    else if constexpr(std::is_same_v<T, bool>)
-    {
-        oldValue = booleanSettings.find(key);
-        end = booleanSettings.end();
-    }
-
-    if(oldValue == end)
-    {
-        output->outputError("Cannot update setting " + category + "." + name + " since it has not been defined.");
-
-        throw SettingKeyNotFoundException(name, category);
     }
 
     if constexpr(std::is_same_v<T, std::string>)
     {
-        if(Utilities::trim(oldValue->second) == Utilities::trim(value))
+        if(Utilities::trim(oldValue) == Utilities::trim(value))
         {
             output->outputTrace(
                 " Setting " + key.first + "." + key.second + " not updated since the same value was given.");
             return;
         }
+
+        oldValue = Utilities::trim(value);
+
+        output->outputTrace(" Setting " + key.first + "." + key.second + " updated. New value = " + value + ".");
     }
     else
     {
-        if(oldValue->second == value)
+        if(oldValue == value)
         {
             output->outputTrace(
                 " Setting " + key.first + "." + key.second + " not updated since the same value was given.");
             return;
         }
-    }
-
-    if constexpr(std::is_same_v<T, std::string>)
-    {
-        stringSettings[key] = Utilities::trim(value);
 
-        output->outputTrace(" Setting " + key.first + "." + key.second + " updated. New value = " + value + ".");
-    }
-    else if constexpr(std::is_same_v<T, int>)
-    {
-        integerSettings[key] = value;
-
-        output->outputTrace(
-            " Setting " + key.first + "." + key.second + " updated. New value = " + std::to_string(value) + ".");
-    }
-    else if constexpr(std::is_same_v<T, double>)
-    {
-        doubleSettings[key] = value;
+        oldValue = value;
 
         output->outputTrace(
             " Setting " + key.first + "." + key.second + " updated. New value = " + std::to_string(value) + ".");
     }
-    else if constexpr(std::is_same_v<T, bool>)
-    {
-        booleanSettings[key] = value;
 
-        output->outputTrace(
-            " Setting " + key.first + "." + key.second + " updated. New value = " + std::to_string(value) + ".");
-    }
+    settingIsDefaultValue[identifier->second] = false;
 
-    settingIsDefaultValue[key] = false;
+    for(auto& C : settingChangedCallbacks)
+        C.second(name, category);
 }
 
 // String settings ===============================================================
@@ -196,7 +184,7 @@ void Settings::createSetting(std::string name, std::string category, int value,
     double maxVal, bool isPrivate)
 {
     createBaseSetting<int>(name, category, value, description, isPrivate);
-    settingBounds[make_pair(category, name)] = std::make_pair(minVal, maxVal);
+    schema->definitions[schema->identifiers.at(make_pair(category, name))].bounds = std::make_pair(minVal, maxVal);
 }
 
 // Double settings ===============================================================
@@ -205,7 +193,7 @@ void Settings::createSetting(std::string name, std::string category, double valu
     double minVal, double maxVal, bool isPrivate)
 {
     createBaseSetting<double>(name, category, value, description, isPrivate);
-    settingBounds[make_pair(category, name)] = std::make_pair(minVal, maxVal);
+    schema->definitions[schema->identifiers.at(make_pair(category, name))].bounds = std::make_pair(minVal, maxVal);
 }
 
 // Boolean settings ==============================================================
@@ -222,31 +210,31 @@ void Settings::createSetting(std::string name, std::string category, int value,
     VectorString enumDesc, int startValue, bool isPrivate)
 {
     createBaseSetting<int>(name, category, value, description, isPrivate);
-    settingBounds[make_pair(category, name)]
-        = std::make_pair((double)startValue, (double)(startValue + enumDesc.size() - 1));
+
+    // The schema is not shared after a setting has been created
+    auto& definition = schema->definitions[schema->identifiers.at(make_pair(category, name))];
+    definition.bounds = std::make_pair((double)startValue, (double)(startValue + enumDesc.size() - 1));
 
     size_t counter = 0;
 
     for(int i = startValue; i < (int)(startValue + enumDesc.size()); i++)
     {
-        enumDescriptions[make_tuple(category, name, i)] = enumDesc.at(counter);
+        definition.enumDescriptions.emplace_back(i, enumDesc.at(counter));
         output->outputTrace(" Enum value " + std::to_string(i) + ": " + enumDesc.at(counter));
         counter++;
     }
 
-    settingEnums[make_pair(category, name)] = true;
+    definition.isEnum = true;
 }
 
 std::string Settings::getEnumDescriptionList(std::string name, std::string category)
 {
     std::stringstream desc;
 
-    for(auto& E : enumDescriptions)
+    if(auto definition = findSettingDefinition(name, category))
     {
-        if(name == std::get<1>(E.first) && category == std::get<0>(E.first))
-        {
-            desc << std::get<2>(E.first) << ": " << E.second << ". ";
-        }
+        for(auto& E : definition->enumDescriptions)
+            desc << E.first << ": " << E.second << ". ";
     }
 
     return desc.str();
@@ -256,12 +244,10 @@ std::string Settings::getEnumDescriptionListMarkup(std::string name, std::string
 {
     std::stringstream desc;
 
-    for(auto& E : enumDescriptions)
+    if(auto definition = findSettingDefinition(name, category))
     {
-        if(name == std::get<1>(E.first) && category == std::get<0>(E.first))
-        {
-            desc << std::get<2>(E.first) << ": " << E.second << " ";
-        }
+        for(auto& E : definition->enumDescriptions)
+            desc << E.first << ": " << E.second << " ";
     }
 
     return desc.str();
@@ -269,17 +255,10 @@ std::string Settings::getEnumDescriptionListMarkup(std::string name, std::string
 
 std::vector<std::pair<int, std::string>> Settings::getEnumDescription(std::string name, std::string category)
 {
-    std::vector<std::pair<int, std::string>> r;
-
-    for(auto& E : enumDescriptions)
-    {
-        if(name == std::get<1>(E.first) && category == std::get<0>(E.first))
-        {
-            r.push_back(std::pair<int, std::string>(std::get<2>(E.first), E.second));
-        }
-    }
+    if(auto definition = findSettingDefinition(name, category))
+        return (definition->enumDescriptions);
 
-    return r;
+    return {};
 }
 
 // General methods ================================================================
@@ -305,19 +284,20 @@ std::string Settings::getSettingsAsOSoL()
 
     solverOptionsNode->SetAttribute("numberOfSolverOptions", numberOfIncludedOptions);
 
-    for(auto& T : settingTypes)
+    for(auto& I : schema->identifiers)
     {
-        auto key = T.first;
-        std::string name = T.first.second;
-        std::string category = T.first.first;
+        auto key = I.first;
+        auto& definition = schema->definitions[I.second];
+        std::string name = key.second;
+        std::string category = key.first;
 
-        if(settingIsPrivate[key])
+        if(definition.isPrivate)
             continue; // Do not include an internal setting
 
         std::stringstream type;
         std::string value;
 
-        switch(settingTypes[key])
+        switch(definition.type)
         {
         case E_SettingType::String:
             type << "string";
@@ -342,13 +322,13 @@ std::string Settings::getSettingsAsOSoL()
 
         std::stringstream desc;
 
-        if(settingEnums[key] == true)
+        if(definition.isEnum)
         {
-            desc << settingDescriptions[key] << ": " << getEnumDescriptionList(name, category);
+            desc << definition.description << ": " << getEnumDescriptionList(name, category);
         }
         else
         {
-            desc << settingDescriptions[key] << ". ";
+            desc << definition.description << ". ";
         }
 
         auto solverOptionNode = osolDocument.NewElement("solverOption");
@@ -386,22 +366,23 @@ std::string Settings::getSettingsAsString(bool hideUnchanged = false, bool hideD
     const std::string divider = "**************************************************************************************"
                                 "****************************************************";
 
-    for(auto& T : settingTypes)
+    for(auto& I : schema->identifiers)
     {
-        auto key = T.first;
-        std::string name = T.first.second;
-        std::string category = T.first.first;
+        auto key = I.first;
+        auto& definition = schema->definitions[I.second];
+        std::string name = key.second;
+        std::string category = key.first;
 
-        if(settingIsPrivate[key])
+        if(definition.isPrivate)
             continue; // Do not include an internal setting
 
-        if(hideUnchanged && settingIsDefaultValue[key])
+        if(hideUnchanged && settingIsDefaultValue[I.second])
             continue; // Hide setting with default value
 
         if(!hideDescriptions)
         {
-            std::string name = T.first.second;
-            std::string category = T.first.first;
+            std::string name = key.second;
+            std::string category = key.first;
             std::string fullname = fmt::format("{}.{}", category, name);
             std::string subCategory = "";
 
@@ -420,7 +401,7 @@ std::string Settings::getSettingsAsString(bool hideUnchanged = false, bool hideD
             {
                 // This is a first level group
 
-                auto [header, description] = settingGroupDescriptions[std::make_pair(category, "")];
+                auto [header, description] = getGroupDescription(category, "");
 
                 ss << '\n' << '\n' << divider << '\n';
                 ss << divider << '\n';
@@ -436,12 +417,11 @@ std::string Settings::getSettingsAsString(bool hideUnchanged = false, bool hideD
             }
 
             if(subCategory != currentSubCategory
-                && (settingGroupDescriptions.find(std::make_pair(category, subCategory))
-                    != settingGroupDescriptions.end()))
+                && schema->groupDescriptions.count(std::make_pair(category, subCategory)) > 0)
             {
                 // This is a second level group
 
-                auto [header, description] = settingGroupDescriptions[std::make_pair(category, subCategory)];
+                auto [header, description] = getGroupDescription(category, subCategory);
 
                 ss << '\n' << '\n' << divider << '\n';
                 ss << fmt::format("* {}\n", header);
@@ -456,13 +436,13 @@ std::string Settings::getSettingsAsString(bool hideUnchanged = false, bool hideD
 
             std::stringstream desc;
 
-            if(settingEnums[key] == true)
+            if(definition.isEnum)
             {
-                desc << settingDescriptions[key] << ": " << getEnumDescriptionList(name, category);
+                desc << definition.description << ": " << getEnumDescriptionList(name, category);
             }
             else
             {
-                desc << settingDescriptions[key] << ". ";
+                desc << definition.description << ". ";
             }
 
             if(((int)desc.tellp()) != 0)
@@ -471,7 +451,7 @@ std::string Settings::getSettingsAsString(bool hideUnchanged = false, bool hideD
             }
         }
 
-        switch(T.second)
+        switch(definition.type)
         {
         case(E_SettingType::String):
             ss << fmt::format("{}.{} = {}\n", category, name, getSetting<std::string>(name, category));
@@ -507,15 +487,16 @@ std::string Settings::getSettingsAsMarkup()
     std::string currentCategory = "";
     std::string currentSubCategory = "";
 
-    for(auto& T : settingTypes)
+    for(auto& I : schema->identifiers)
     {
-        auto key = T.first;
+        auto key = I.first;
+        auto& definition = schema->definitions[I.second];
 
-        if(settingIsPrivate[key])
+        if(definition.isPrivate)
             continue; // Do not include an internal setting
 
-        std::string name = T.first.second;
-        std::string category = T.first.first;
+        std::string name = key.second;
+        std::string category = key.first;
         std::string fullname = fmt::format("{}.{}", category, name);
         std::string subCategory = "";
 
@@ -536,7 +517,7 @@ std::string Settings::getSettingsAsMarkup()
         {
             // This is a first level group
 
-            auto [header, description] = settingGroupDescriptions[std::make_pair(category, "")];
+            auto [header, description] = getGroupDescription(category, "");
 
             ss << '\n' << fmt::format("# {}\n", header) << '\n';
 
@@ -549,11 +530,11 @@ std::string Settings::getSettingsAsMarkup()
         }
 
         if(subCategory != currentSubCategory
-            && (settingGroupDescriptions.find(std::make_pair(category, subCategory)) != settingGroupDescriptions.end()))
+            && schema->groupDescriptions.count(std::make_pair(category, subCategory)) > 0)
         {
             // This is a second level group
 
-            auto [header, description] = settingGroupDescriptions[std::make_pair(category, subCategory)];
+            auto [header, description] = getGroupDescription(category, subCategory);
 
             ss << '\n' << fmt::format("## {}\n", header) << '\n';
 
@@ -570,19 +551,19 @@ std::string Settings::getSettingsAsMarkup()
             ss << fmt::format("|-|:-:|:-:|\n");
         }
 
-        if(settingEnums[key] == true)
+        if(definition.isEnum)
         {
             description = fmt::format(
-                "**{}**<br>{}<br>{}", fullname, settingDescriptions[key], getEnumDescriptionListMarkup(name, category));
+                "**{}**<br>{}<br>{}", fullname, definition.description, getEnumDescriptionListMarkup(name, category));
         }
         else
         {
-            description = fmt::format("**{}**<br>{}", fullname, settingDescriptions[key]);
+            description = fmt::format("**{}**<br>{}", fullname, definition.description);
         }
 
         PairDouble bounds;
 
-        switch(T.second)
+        switch(definition.type)
         {
         case(E_SettingType::String):
             validValues = fmt::format("string");
@@ -590,14 +571,14 @@ std::string Settings::getSettingsAsMarkup()
             break;
 
         case(E_SettingType::Double):
-            bounds = settingBounds[key];
+            bounds = definition.bounds;
             validValues = fmt::format("[{},{}]", Utilities::toStringFormat(bounds.first, "{}", true, "∞"),
                 Utilities::toStringFormat(bounds.second, "{}", true, "∞"));
             defaultValue = fmt::format("{}", getSetting<double>(name, category));
             break;
 
         case(E_SettingType::Integer):
-            bounds = settingBounds[key];
+            bounds = definition.bounds;
 
             if(std::round(bounds.second) == std::round(bounds.first) + 1)
             {
@@ -616,7 +597,7 @@ std::string Settings::getSettingsAsMarkup()
             break;
 
         case(E_SettingType::Enum):
-            bounds = settingBounds[key];
+            bounds = definition.bounds;
 
             if(std::round(bounds.second) == std::round(bounds.first) + 1)
             {
@@ -653,19 +634,20 @@ VectorString Settings::getChangedSettings()
 {
     VectorString result;
 
-    for(auto& T : settingTypes)
+    for(auto& I : schema->identifiers)
     {
-        auto key = T.first;
-        std::string name = T.first.second;
-        std::string category = T.first.first;
+        auto key = I.first;
+        auto& definition = schema->definitions[I.second];
+        std::string name = key.second;
+        std::string category = key.first;
 
-        if(settingIsPrivate[key])
+        if(definition.isPrivate)
             continue; // Do not include an internal setting
 
-        if(settingIsDefaultValue[key])
+        if(settingIsDefaultValue[I.second])
             continue; // Hide setting with default value
 
-        switch(T.second)
+        switch(definition.type)
         {
         case(E_SettingType::String):
             result.push_back(fmt::format("{}.{} = {}", category, name, getSetting<std::string>(name, category)));
@@ -698,16 +680,17 @@ VectorString Settings::getSettingIdentifiers(E_SettingType type)
 {
     VectorString names;
 
-    for(auto& T : settingTypes)
+    for(auto& I : schema->identifiers)
     {
-        auto key = T.first;
-        std::string name = T.first.second;
-        std::string category = T.first.first;
+        auto key = I.first;
+        auto& definition = schema->definitions[I.second];
+        std::string name = key.second;
+        std::string category = key.first;
 
-        if(settingIsPrivate[key])
+        if(definition.isPrivate)
             continue; // Do not include an internal setting
 
-        if(T.second == type)
+        if(definition.type == type)
             names.push_back(fmt::format("{}.{}", category, name));
     }
 
@@ -718,17 +701,18 @@ VectorPairString Settings::getSettingSplitIdentifiers(E_SettingType type)
 {
     VectorPairString names;
 
-    for(auto& T : settingTypes)
+    for(auto& I : schema->identifiers)
     {
-        auto key = T.first;
-        std::string name = T.first.second;
-        std::string category = T.first.first;
+        auto key = I.first;
+        auto& definition = schema->definitions[I.second];
+        std::string name = key.second;
+        std::string category = key.first;
 
-        if(settingIsPrivate[key])
+        if(definition.isPrivate)
             continue; // Do not include an internal setting
 
-        if(T.second == type)
-            names.push_back(T.first);
+        if(definition.type == type)
+            names.push_back(key);
     }
 
     return (names);
@@ -778,9 +762,9 @@ bool Settings::readSettingsFromOSoL(std::string osol)
 
             std::string category = N->Attribute("category");
 
-            PairString key = make_pair(category, name);
+            auto definition = findSettingDefinition(name, category);
 
-            if(settingTypes.find(key) == settingTypes.end())
+            if(definition == nullptr)
             {
                 output->outputError(
                     "  Cannot update setting <" + category + "," + name + "> since it has not been defined.");
@@ -790,7 +774,7 @@ bool Settings::readSettingsFromOSoL(std::string osol)
 
             std::string::size_type convertedChars = value.length();
 
-            switch(settingTypes[key])
+            switch(definition->type)
             {
             case E_SettingType::String:
                 updateSetting(name, category, value);
@@ -877,9 +861,9 @@ bool Settings::readSettingsFromString(std::string options)
         name = Utilities::trim(name);
         value = Utilities::trim(value);
 
-        PairString keyPair = make_pair(category, name);
+        auto definition = findSettingDefinition(name, category);
 
-        if(settingTypes.find(keyPair) == settingTypes.end())
+        if(definition == nullptr)
         {
             output->outputError(
                 "  Cannot update setting <" + name + "," + category + "> since it has not been defined.");
@@ -889,7 +873,7 @@ bool Settings::readSettingsFromString(std::string options)
 
         std::string::size_type convertedChars = value.length();
 
-        switch(settingTypes[keyPair])
+        switch(definition->type)
         {
         case E_SettingType::String:
             updateSetting(name, category, value);
@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -61,6 +63,24 @@ public:
     }
 };
 
+// A handle to a setting obtained once with Settings::getSettingHandle, so that it can be read in hot loops without
+// any lookup. The handle points directly to the stored value, so it always gives the current value of the setting.
+template <typename T> class SettingHandle
+{
+public:
+    SettingHandle() = default;
+    explicit SettingHandle(const T* valuePtr) : value(valuePtr) {};
+
+    inline const T& get() const { return (*value); };
+
+    inline bool isValid() const { return (value != nullptr); };
+
+private:
+    const T* value = nullptr;
+};
+
+using SettingChangedCallback = std::function<void(const std::string& name, const std::string& category)>;
+
 class DllExport Settings
 {
 private:
@@ -75,22 +95,106 @@ private:
     using PairDouble = std::pair<double, double>;
     using VectorString = std::vector<std::string>;
 
-    std::map<PairString, std::string> stringSettings;
-    std::map<PairString, double> doubleSettings;
-    std::map<PairString, int> integerSettings;
-    std::map<PairString, bool> booleanSettings;
+    struct SettingDefinition
+    {
+        std::string name;
+        std::string category;
+        std::string description;
+        E_SettingType type = E_SettingType::String;
+        bool isPrivate = false;
+        bool isEnum = false;
+        PairDouble bounds = { 0.0, 0.0 };
+        std::vector<std::pair<int, std::string>> enumDescriptions;
+        size_t valueIndex = 0; // In the values of the same type
+    };
+
+    // The definitions of the settings never change after they have been created, so they are shared between the
+    // settings objects created with assignSettings, and copied only if another setting is created
+    struct SettingsSchema
+    {
+        std::vector<SettingDefinition> definitions; // Indexed by the setting identifier
+        std::map<PairString, size_t> identifiers; // Sorted by category and name
+        std::map<PairString, PairString> groupDescriptions;
+    };
+
+    std::shared_ptr<SettingsSchema> schema = std::make_shared<SettingsSchema>();
+
+    // The values are kept in deques so that the values referred to by handles are not moved when settings are added
+    std::deque<std::string> stringSettings;
+    std::deque<double> doubleSettings;
+    std::deque<int> integerSettings;
+    std::deque<bool> booleanSettings;
 
-    std::map<PairString, PairString> settingGroupDescriptions;
-    std::map<PairString, std::string> settingDescriptions;
+    std::vector<bool> settingIsDefaultValue; // Indexed by the setting identifier
 
-    std::map<PairString, E_SettingType> settingTypes;
-    std::map<PairString, bool> settingIsPrivate;
-    std::map<PairString, bool> settingIsDefaultValue;
-    std::map<PairString, PairDouble> settingBounds;
-    std::map<PairString, bool> settingEnums;
+    std::map<int, SettingChangedCallback> settingChangedCallbacks;
+    int nextSettingChangedCallbackId = 0;
 
-    using TupleStringPairInt = std::tuple<std::string, std::string, int>;
-    std::map<TupleStringPairInt, std::string> enumDescriptions;
+    template <typename T> std::deque<T>& getSettingValues()
+    {
+        if constexpr(std::is_same_v<T, std::string>)
+            return (stringSettings);
+        else if constexpr(std::is_same_v<T, int>)
+            return (integerSettings);
+        else if constexpr(std::is_same_v<T, double>)
+            return (doubleSettings);
+        else
+            return (booleanSettings);
+    }
+
+    template <typename T> static constexpr E_SettingType getSettingType()
+    {
+        if constexpr(std::is_same_v<T, std::string>)
+            return (E_SettingType::String);
+        else if constexpr(std::is_same_v<T, int>)
+            return (E_SettingType::Integer);
+        else if constexpr(std::is_same_v<T, double>)
+            return (E_SettingType::Double);
+        else
+            return (E_SettingType::Boolean);
+    }
+
+    // Returns nullptr if the setting has not been defined
+    const SettingDefinition* findSettingDefinition(const std::string& name, const std::string& category) const
+    {
+        auto identifier = schema->identifiers.find(make_pair(category, name));
+
+        if(identifier == schema->identifiers.end())
+            return (nullptr);
+
+        return (&schema->definitions[identifier->second]);
+    }
+
+    const SettingDefinition& getSettingDefinition(const std::string& name, const std::string& category) const
+    {
+        return (schema->definitions[schema->identifiers.at(make_pair(category, name))]);
+    }
+
+    // Also returns nullptr if the setting is not of the given type
+    template <typename T> T* findSettingValue(const std::string& name, const std::string& category)
+    {
+        auto definition = findSettingDefinition(name, category);
+
+        if(definition == nullptr || definition->type != getSettingType<T>())
+            return (nullptr);
+
+        return (&getSettingValues<T>()[definition->valueIndex]);
+    }
+
+    // Returns empty header and description if the group has not been created
+    PairString getGroupDescription(const std::string& mainLevel, const std::string& subLevel) const
+    {
+        auto group = schema->groupDescriptions.find(make_pair(mainLevel, subLevel));
+        return (group != schema->groupDescriptions.end() ? group->second : PairString());
+    }
+
+    SettingsSchema& getMutableSchema()
+    {
+        if(schema.use_count() > 1)
+            schema = std::make_shared<SettingsSchema>(*schema);
+
+        return (*schema);
+    }
 
 public:
     bool settingsInitialized = false;
@@ -114,52 +218,69 @@ public:
                     || std::is_same<int, T>::value || std::is_same<bool, T>::value,
                 T>::type;
 
-        PairString key = make_pair(category, name);
+        auto value = findSettingValue<T>(name, category);
 
-        typename std::map<PairString, T>::iterator value;
-        typename std::map<PairString, T>::iterator end;
-
-        if constexpr(std::is_same_v<T, std::string>)
-        {
-            value = stringSettings.find(key);
-            end = stringSettings.end();
-        }
-        else if constexpr(std::is_same_v<T, int>)
+        if(value == nullptr)
         {
-            value = integerSettings.find(key);
-            end = integerSettings.end();
-        }
-        else if constexpr(std::is_same_v<T, double>)
-        {
-            value = doubleSettings.find(key);
-            end = doubleSettings.end();
-        }
-        else if constexpr(std::is_same_v<T, bool>)
-        {
-            value = booleanSettings.find(key);
-            end = booleanSettings.end();
+            output->outputError("Cannot get setting " + category + "." + name + " since it has not been defined.");
+
+            throw SettingKeyNotFoundException(name, category);
         }
 
-        if(value == end)
+        return (*value);
+    }
+
+    // Resolves the setting once, the handle stays valid as long as the settings object exists since settings are
+    // never removed
+    template <typename T> SettingHandle<T> getSettingHandle(std::string name, std::string category)
+    {
+        using value_type
+#ifndef _MSC_VER
+            [[maybe_unused]]
+#endif
+            = typename std::enable_if<std::is_same<std::string, T>::value || std::is_same<double, T>::value
+                    || std::is_same<int, T>::value || std::is_same<bool, T>::value,
+                T>::type;
+
+        auto value = findSettingValue<T>(name, category);
+
+        if(value == nullptr)
         {
-            output->outputError("Cannot get setting " + category + "." + name + " since it has not been defined.");
+            output->outputError(
+                "Cannot get handle to setting " + category + "." + name + " since it has not been defined.");
 
             throw SettingKeyNotFoundException(name, category);
         }
 
-        return (value->second);
+        return (SettingHandle<T>(value));
+    }
+
+    // The callback is called with the name and category of a setting whenever its value is changed by updateSetting.
+    // Returns an identifier that is used for removing the callback.
+    int addSettingChangedCallback(SettingChangedCallback callback)
+    {
+        settingChangedCallbacks.emplace(nextSettingChangedCallbackId, callback);
+        return (nextSettingChangedCallbackId++);
     }
 
+    void removeSettingChangedCallback(int callbackId) { settingChangedCallbacks.erase(callbackId); }
+
     std::string getSettingDescription(std::string name, std::string category)
     {
-        return settingDescriptions.at(PairString(category, name));
+        return getSettingDefinition(name, category).description;
     }
 
     PairDouble getSettingBounds(std::string name, std::string category)
     {
-        return settingBounds.at(PairString(category, name));
+        return getSettingDefinition(name, category).bounds;
     }
 
+    // Shares the definitions and copies the current values of all settings in the other settings object, e.g. a
+    // settings object with the default values, which is much faster than creating the settings again
+    void assignSettings(const Settings& other);
+
+    size_t getNumberOfSettings() const { return (schema->definitions.size()); }
+
     void createSetting(
         std::string name, std::string category, std::string value, std::string description, bool isPrivate = false);
 
@@ -177,12 +298,15 @@ public:
 
     void createSettingGroup(std::string mainLevel, std::string subLevel, std::string header, std::string description)
     {
-        settingGroupDescriptions.emplace(make_pair(mainLevel, subLevel), make_pair(header, description));
+        if(schema->groupDescriptions.count(make_pair(mainLevel, subLevel)) > 0)
+            return;
+
+        getMutableSchema().groupDescriptions.emplace(make_pair(mainLevel, subLevel), make_pair(header, description));
     }
 
     PairString getCategoryDescription(std::string category)
     {
-        return settingGroupDescriptions.at(PairString(category, ""));
+        return schema->groupDescriptions.at(PairString(category, ""));
     }
 
     std::string getEnumDescriptionList(std::string name, std::string category);
@@ -0,0 +1,135 @@
+/**
+        The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+        @author Andreas Lundell, Åbo Akademi University
+
+        @section LICENSE
+        This software is licensed under the Eclipse Public License 2.0.
+        Please see the README and LICENSE files for more information.
+*/
+
+#include "SolutionStrategyDecomposition.h"
+
+#include "../TaskHandler.h"
+
+#include "../Tasks/TaskBase.h"
+#include "../Tasks/TaskSequential.h"
+#include "../Tasks/TaskGoto.h"
+
+#include "../Tasks/TaskInitializeIteration.h"
+#include "../Tasks/TaskTerminate.h"
+
+#include "../Tasks/TaskInitializeDualSolver.h"
+#include "../Tasks/TaskCreateBendersMasterProblem.h"
+#include "../Tasks/TaskSolveBendersMasterProblem.h"
+#include "../Tasks/TaskSolveBendersSubproblems.h"
+
+#include "../Tasks/TaskPrintIterationReport.h"
+
+#include "../Tasks/TaskCheckAbsoluteGap.h"
+#include "../Tasks/TaskCheckIterationError.h"
+#include "../Tasks/TaskCheckIterationLimit.h"
+#include "../Tasks/TaskCheckRelativeGap.h"
+#include "../Tasks/TaskCheckTimeLimit.h"
+#include "../Tasks/TaskCheckUserTermination.h"
+
+#include "../Output.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+namespace SHOT
+{
+
+SolutionStrategyDecomposition::SolutionStrategyDecomposition(
+    EnvironmentPtr envPtr, BlockDecompositionPtr decomposition)
+    : decomposition(decomposition)
+{
+    env = envPtr;
+
+    env->timing->createTimer("DualStrategy", "dual strategy", "Total");
+    env->timing->createTimer("DualProblemsDiscrete", "solving MIP problems", "DualStrategy");
+
+    env->timing->createTimer("PrimalStrategy", "primal strategy", "Total");
+    env->timing->createTimer("PrimalBoundStrategyNLP", "solving NLP problems", "PrimalStrategy");
+
+    auto tFinalizeSolution = std::make_shared<TaskSequential>(env);
+
+    auto tInitMIPSolver = std::make_shared<TaskInitializeDualSolver>(env, false);
+    env->tasks->addTask(tInitMIPSolver, "InitMIPSolver");
+
+    // The lower bounds of the block objective values are needed in the master problem
+    auto tSolveSubproblems = std::make_shared<TaskSolveBendersSubproblems>(env, decomposition);
+
+    auto tCreateMasterProblem = std::make_shared<TaskCreateBendersMasterProblem>(env, decomposition);
+    env->tasks->addTask(tCreateMasterProblem, "CreateMasterProblem");
+
+    auto tInitializeIteration = std::make_shared<TaskInitializeIteration>(env);
+    env->tasks->addTask(tInitializeIteration, "InitIter");
+
+    auto tSolveMasterProblem = std::make_shared<TaskSolveBendersMasterProblem>(env);
+    env->tasks->addTask(tSolveMasterProblem, "SolveIter");
+
+    auto tCheckIterError = std::make_shared<TaskCheckIterationError>(env, "FinalizeSolution");
+    env->tasks->addTask(tCheckIterError, "CheckIterError");
+
+    env->tasks->addTask(tSolveSubproblems, "SolveSubproblems");
+
+    auto tPrintIterReport = std::make_shared<TaskPrintIterationReport>(env);
+    env->tasks->addTask(tPrintIterReport, "PrintIterReport");
+
+    auto tCheckAbsGap = std::make_shared<TaskCheckAbsoluteGap>(env, "FinalizeSolution");
+    env->tasks->addTask(tCheckAbsGap, "CheckAbsGap");
+
+    auto tCheckRelGap = std::make_shared<TaskCheckRelativeGap>(env, "FinalizeSolution");
+    env->tasks->addTask(tCheckRelGap, "CheckRelGap");
+
+    auto tCheckIterLim = std::make_shared<TaskCheckIterationLimit>(env, "FinalizeSolution");
+    env->tasks->addTask(tCheckIterLim, "CheckIterLim");
+
+    auto tCheckTimeLim = std::make_shared<TaskCheckTimeLimit>(env, "FinalizeSolution");
+    env->tasks->addTask(tCheckTimeLim, "CheckTimeLim");
+
+    auto tCheckUserTerm = std::make_shared<TaskCheckUserTermination>(env, "FinalizeSolution");
+    env->tasks->addTask(tCheckUserTerm, "CheckUserTermination");
+
+    auto tGoto = std::make_shared<TaskGoto>(env, "InitIter");
+    env->tasks->addTask(tGoto, "Goto");
+
+    env->tasks->addTask(tFinalizeSolution, "FinalizeSolution");
+
+    auto tTerminate = std::make_shared<TaskTerminate>(env);
+    env->tasks->addTask(tTerminate, "Terminate");
+}
+
+SolutionStrategyDecomposition::~SolutionStrategyDecomposition() = default;
+
+bool SolutionStrategyDecomposition::solveProblem()
+{
+    TaskPtr nextTask;
+
+    try
+    {
+        while(env->tasks->getNextTask(nextTask))
+        {
+#ifdef SIMPLE_OUTPUT_CHARS
+            env->output->outputTrace("---- Started task:  " + nextTask->getType());
+            nextTask->run();
+            env->output->outputTrace("---- Finished task: " + nextTask->getType());
+#else
+            env->output->outputTrace("┌─── Started task:  " + nextTask->getType());
+            nextTask->run();
+            env->output->outputTrace("└─── Finished task: " + nextTask->getType());
+#endif
+        }
+    }
+    catch(Exception& e)
+    {
+        env->output->outputCritical(fmt::format(" Cannot solve problem:  {}", e.what()));
+        return (false);
+    }
+
+    return (true);
+}
+
+void SolutionStrategyDecomposition::initializeStrategy() { }
+} // namespace SHOT
@@ -0,0 +1,35 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "ISolutionStrategy.h"
+#include "../Environment.h"
+
+#include "../Model/BlockDecomposition.h"
+
+namespace SHOT
+{
+// Generalized Benders decomposition for convex problems where the continuous variables form independent blocks when the
+// discrete variables are fixed. The master MIP problem in the discrete variables gets one cut per block and iteration
+// from the NLP problem of the block with the discrete variables fixed to the master solution.
+class SolutionStrategyDecomposition : public ISolutionStrategy
+{
+public:
+    SolutionStrategyDecomposition(EnvironmentPtr envPtr, BlockDecompositionPtr decomposition);
+    virtual ~SolutionStrategyDecomposition();
+
+    bool solveProblem() override;
+    void initializeStrategy() override;
+
+protected:
+    BlockDecompositionPtr decomposition;
+};
+} // namespace SHOT
\ No newline at end of file
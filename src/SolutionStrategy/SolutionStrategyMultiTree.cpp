@@ -18,6 +18,8 @@
 #include "../Tasks/TaskFindInteriorPoint.h"
 #include "../Tasks/TaskBase.h"
 #include "../Tasks/TaskSequential.h"
+#include "../Tasks/TaskParallel.h"
+#include "../Tasks/TaskScheduled.h"
 #include "../Tasks/TaskGoto.h"
 #include "../Tasks/TaskConditional.h"
 
@@ -31,9 +33,11 @@
 #include "../Tasks/TaskExecuteRelaxationStrategy.h"
 
 #include "../Tasks/TaskPrintIterationReport.h"
+#include "../Tasks/TaskWriteCheckpoint.h"
 
 #include "../Tasks/TaskSolveIteration.h"
 #include "../Tasks/TaskPresolve.h"
+#include "../Tasks/TaskPerformRootCutLoop.h"
 
 #include "../Tasks/TaskRepairInfeasibleDualProblem.h"
 
@@ -51,16 +55,24 @@
 #include "../Tasks/TaskSelectHyperplanePointsESH.h"
 #include "../Tasks/TaskSelectHyperplanePointsECP.h"
 #include "../Tasks/TaskAddHyperplanes.h"
+#include "../Tasks/TaskAddInitialTangents.h"
 #include "../Tasks/TaskAddPrimalReductionCut.h"
+#include "../Tasks/TaskManageHyperplaneCuts.h"
 #include "../Tasks/TaskCheckMaxNumberOfPrimalReductionCuts.h"
 
 #include "../Tasks/TaskSelectPrimalCandidatesFromSolutionPool.h"
 #include "../Tasks/TaskSelectPrimalCandidatesFromRootsearch.h"
+#include "../Tasks/TaskFinishAsynchronousRootsearches.h"
 #include "../Tasks/TaskSelectPrimalCandidatesFromNLP.h"
+#include "../Tasks/TaskSelectPrimalCandidatesFromFeasibilityPump.h"
+#include "../Tasks/TaskSelectPrimalFixedNLPPointsFromFixAndPropagate.h"
 #include "../Tasks/TaskSelectPrimalFixedNLPPointsFromSolutionPool.h"
 #include "../Tasks/TaskClearFixedPrimalCandidates.h"
 
 #include "../Tasks/TaskUpdateInteriorPoint.h"
+#include "../Tasks/TaskPerformIncrementalBoundTightening.h"
+#include "../Tasks/TaskPerformReducedCostFixing.h"
+#include "../Tasks/TaskUpdateMIPGap.h"
 
 #include "../Tasks/TaskSelectHyperplanePointsObjectiveFunction.h"
 
@@ -79,21 +91,35 @@ SolutionStrategyMultiTree::SolutionStrategyMultiTree(EnvironmentPtr envPtr)
 {
     env = envPtr;
 
-    env->timing->createTimer("InteriorPointSearch", "- interior point search");
+    env->timing->createTimer("InteriorPointSearch", "interior point search", "Total");
 
-    env->timing->createTimer("DualStrategy", "- dual strategy");
-    env->timing->createTimer("DualProblemsRelaxed", "  - solving relaxed problems");
-    env->timing->createTimer("DualProblemsIntegerFixed", "  - solving integer-fixed problems");
-    env->timing->createTimer("DualProblemsDiscrete", "  - solving MIP problems");
-    env->timing->createTimer("DualCutGenerationRootSearch", "  - root search for constraint cuts");
-    env->timing->createTimer("DualObjectiveRootSearch", "  - root search for objective cut");
+    env->timing->createTimer("DualStrategy", "dual strategy", "Total");
+    env->timing->createTimer("DualProblemsRelaxed", "solving relaxed problems", "DualStrategy");
+    env->timing->createTimer("DualProblemsIntegerFixed", "solving integer-fixed problems", "DualStrategy");
+    env->timing->createTimer("DualProblemsDiscrete", "solving MIP problems", "DualStrategy");
+    env->timing->createTimer("DualCutGenerationRootSearch", "root search for constraint cuts", "DualStrategy");
+    env->timing->createTimer("DualObjectiveRootSearch", "root search for objective cut", "DualStrategy");
 
-    env->timing->createTimer("PrimalStrategy", "- primal strategy");
-    env->timing->createTimer("PrimalBoundStrategyNLP", "  - solving NLP problems");
-    env->timing->createTimer("PrimalBoundStrategyRootSearch", "  - performing root searches");
+    env->timing->createTimer("PrimalStrategy", "primal strategy", "Total");
+    env->timing->createTimer("PrimalBoundStrategyNLP", "solving NLP problems", "PrimalStrategy");
+    env->timing->createTimer("PrimalBoundStrategyRootSearch", "performing root searches", "PrimalStrategy");
+    env->timing->createTimer("PrimalBoundStrategyFeasibilityPump", "feasibility pump", "PrimalStrategy");
 
     auto tFinalizeSolution = std::make_shared<TaskSequential>(env);
 
+    // Decides in which iterations the primal tasks are run, they are always run when finalizing the solution
+    std::shared_ptr<TaskScheduler> taskScheduler;
+
+    if(env->settings->getSetting<bool>("Scheduler.Use", "Strategy"))
+        taskScheduler = std::make_shared<TaskScheduler>(env);
+
+    auto addScheduledTask = [&](TaskPtr task, std::string taskID) {
+        if(taskScheduler)
+            env->tasks->addTask(std::make_shared<TaskScheduled>(env, taskScheduler, task, taskID), taskID);
+        else
+            env->tasks->addTask(task, taskID);
+    };
+
     auto tInitMIPSolver = std::make_shared<TaskInitializeDualSolver>(env, false);
     env->tasks->addTask(tInitMIPSolver, "InitMIPSolver");
 
@@ -119,12 +145,40 @@ SolutionStrategyMultiTree::SolutionStrategyMultiTree(EnvironmentPtr envPtr)
     auto tAddHPs = std::make_shared<TaskAddHyperplanes>(env);
     env->tasks->addTask(tAddHPs, "AddHPs");
 
+    if(env->settings->getSetting<bool>("HyperplaneCuts.InitialTangents.Use", "Dual")
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0
+        && !env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"))
+    {
+        auto tAddInitialTangents = std::make_shared<TaskAddInitialTangents>(env);
+        env->tasks->addTask(tAddInitialTangents, "AddInitialTangents");
+    }
+
+    // The feasibility pump uses outer approximation cuts, which are only valid for convex problems
+    if(env->settings->getSetting<bool>("FeasibilityPump.Use", "Primal")
+        && env->reformulatedProblem->properties.isDiscrete
+        && env->reformulatedProblem->properties.convexity == E_ProblemConvexity::Convex
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        auto tSelectPrimFeasibilityPump = std::make_shared<TaskSelectPrimalCandidatesFromFeasibilityPump>(env);
+        env->tasks->addTask(tSelectPrimFeasibilityPump, "SelectPrimFeasibilityPump");
+    }
+
     if(env->settings->getSetting<bool>("Relaxation.Use", "Dual")
         && env->reformulatedProblem->properties.numberOfSemicontinuousVariables == 0
         && env->reformulatedProblem->properties.numberOfSemiintegerVariables == 0)
     {
         auto tExecuteRelaxStrategy = std::make_shared<TaskExecuteRelaxationStrategy>(env);
         env->tasks->addTask(tExecuteRelaxStrategy, "ExecRelaxStrategyInitial");
+
+        // The waiting list is needed when reinitializing, and it is emptied by the cut loop
+        if(env->settings->getSetting<bool>("Relaxation.RootCutLoop.Use", "Dual")
+            && static_cast<ES_HyperplaneCutStrategy>(env->settings->getSetting<int>("CutStrategy", "Dual"))
+                == ES_HyperplaneCutStrategy::ESH
+            && !env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"))
+        {
+            auto tPerformRootCutLoop = std::make_shared<TaskPerformRootCutLoop>(env);
+            env->tasks->addTask(tPerformRootCutLoop, "PerformRootCutLoop");
+        }
     }
 
     if(static_cast<ES_MIPPresolveStrategy>(env->settings->getSetting<int>("MIP.Presolve.Frequency", "Dual"))
@@ -137,20 +191,72 @@ SolutionStrategyMultiTree::SolutionStrategyMultiTree(EnvironmentPtr envPtr)
     auto tSolveIteration = std::make_shared<TaskSolveIteration>(env);
     env->tasks->addTask(tSolveIteration, "SolveIter");
 
+    // The reduced costs are read directly after the relaxation has been solved, before the problem is modified. The
+    // relaxation only gives valid bounds in the convex case, since the cuts may remove feasible solutions otherwise.
+    std::shared_ptr<TaskPerformReducedCostFixing> tReducedCostFixing;
+
+    if(env->settings->getSetting<bool>("MIP.ReducedCostFixing.Use", "Dual")
+        && env->settings->getSetting<bool>("Relaxation.Use", "Dual") && env->reformulatedProblem->properties.isDiscrete
+        && env->reformulatedProblem->properties.convexity == E_ProblemConvexity::Convex)
+    {
+        tReducedCostFixing = std::make_shared<TaskPerformReducedCostFixing>(env);
+        env->tasks->addTask(tReducedCostFixing, "ReducedCostFixing");
+    }
+
+    if(env->settings->getSetting<bool>("HyperplaneCuts.Aging.Use", "Dual")
+        && !env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"))
+    {
+        auto tManageHPs = std::make_shared<TaskManageHyperplaneCuts>(env);
+        env->tasks->addTask(tManageHPs, "ManageHPs");
+    }
+
+    std::shared_ptr<TaskSelectPrimalCandidatesFromRootsearch> tSelectPrimRootsearch;
+
+    if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        tSelectPrimRootsearch = std::make_shared<TaskSelectPrimalCandidatesFromRootsearch>(env);
+
+        // The root searches started in the iteration where the termination criteria are fulfilled are finished
+        // before any other primal heuristic is used when finalizing the solution
+        if(env->settings->getSetting<bool>("Rootsearch.Asynchronous", "Primal"))
+        {
+            auto tFinishRootsearches = std::make_shared<TaskFinishAsynchronousRootsearches>(env, tSelectPrimRootsearch);
+            std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tFinishRootsearches);
+        }
+    }
+
     auto tSelectPrimSolPool = std::make_shared<TaskSelectPrimalCandidatesFromSolutionPool>(env);
     env->tasks->addTask(tSelectPrimSolPool, "SelectPrimSolPool");
     std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tSelectPrimSolPool);
 
-    if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
-        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    if(tSelectPrimRootsearch)
     {
-        auto tSelectPrimRootsearch = std::make_shared<TaskSelectPrimalCandidatesFromRootsearch>(env);
-        env->tasks->addTask(tSelectPrimRootsearch, "SelectPrimRootsearch");
+        addScheduledTask(tSelectPrimRootsearch, "SelectPrimRootsearch");
         std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tSelectPrimRootsearch);
     }
 
     auto tPrintIterReport = std::make_shared<TaskPrintIterationReport>(env);
-    env->tasks->addTask(tPrintIterReport, "PrintIterReport");
+    bool writeCheckpoint = env->settings->getSetting<std::string>("Checkpoint.File", "Output") != "";
+
+    if(writeCheckpoint && env->settings->getSetting<bool>("TaskGraph.Use", "Strategy"))
+    {
+        // Both tasks only read the results, so the checkpoint is written while the report is printed
+        auto tReportAndCheckpoint = std::make_shared<TaskParallel>(env);
+        tReportAndCheckpoint->addTask(tPrintIterReport);
+        tReportAndCheckpoint->addTask(std::make_shared<TaskWriteCheckpoint>(env));
+        env->tasks->addTask(tReportAndCheckpoint, "PrintIterReport");
+    }
+    else
+    {
+        env->tasks->addTask(tPrintIterReport, "PrintIterReport");
+
+        if(writeCheckpoint)
+        {
+            auto tWriteCheckpoint = std::make_shared<TaskWriteCheckpoint>(env);
+            env->tasks->addTask(tWriteCheckpoint, "WriteCheckpoint");
+        }
+    }
 
     if(env->reformulatedProblem->properties.convexity != E_ProblemConvexity::Convex
         && env->settings->getSetting<bool>("MIP.InfeasibilityRepair.Use", "Dual"))
@@ -203,8 +309,20 @@ SolutionStrategyMultiTree::SolutionStrategyMultiTree(EnvironmentPtr envPtr)
         = std::make_shared<TaskCheckMaxNumberOfPrimalReductionCuts>(env, "FinalizeSolution");
     env->tasks->addTask(tCheckMaxNumberOfObjectiveCuts, "CheckMaxObjectiveCuts");
 
+    std::shared_ptr<TaskPerformIncrementalBoundTightening> tIncrementalBoundTightening;
+
+    if(env->settings->getSetting<bool>("BoundTightening.FeasibilityBased.Incremental.Use", "Model")
+        && env->settings->getSetting<bool>("BoundTightening.FeasibilityBased.Use", "Model"))
+        tIncrementalBoundTightening = std::make_shared<TaskPerformIncrementalBoundTightening>(env);
+
     if(env->settings->getSetting<bool>("FixedInteger.Use", "Primal") && env->reformulatedProblem->properties.isDiscrete)
     {
+        if(env->settings->getSetting<bool>("FixAndPropagate.Use", "Primal"))
+        {
+            auto tSelectPrimFixAndPropagate = std::make_shared<TaskSelectPrimalFixedNLPPointsFromFixAndPropagate>(env);
+            env->tasks->addTask(tSelectPrimFixAndPropagate, "SelectPrimFixAndPropagate");
+        }
+
         auto tSelectPrimFixedNLPSolPool = std::make_shared<TaskSelectPrimalFixedNLPPointsFromSolutionPool>(env);
         env->tasks->addTask(tSelectPrimFixedNLPSolPool, "SelectPrimFixedNLPSolPool");
         std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tSelectPrimFixedNLPSolPool);
@@ -215,17 +333,29 @@ SolutionStrategyMultiTree::SolutionStrategyMultiTree(EnvironmentPtr envPtr)
         if(NLPProblemSource == ES_PrimalNLPProblemSource::Both
             || NLPProblemSource == ES_PrimalNLPProblemSource::OriginalProblem)
         {
-            auto tSelectPrimNLPCheck = std::make_shared<TaskSelectPrimalCandidatesFromNLP>(env, false);
-            env->tasks->addTask(tSelectPrimNLPCheck, "SelectPrimNLPCheckOriginal");
+            auto tSelectPrimNLPCheck = std::make_shared<TaskSelectPrimalCandidatesFromNLP>(env, false, true);
+            addScheduledTask(tSelectPrimNLPCheck, "SelectPrimNLPCheckOriginal");
             std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tSelectPrimNLPCheck);
+
+            if(tIncrementalBoundTightening)
+                tIncrementalBoundTightening->addNLPTask(tSelectPrimNLPCheck);
+
+            if(tReducedCostFixing)
+                tReducedCostFixing->addNLPTask(tSelectPrimNLPCheck);
         }
 
         if(NLPProblemSource == ES_PrimalNLPProblemSource::Both
             || NLPProblemSource == ES_PrimalNLPProblemSource::ReformulatedProblem)
         {
-            auto tSelectPrimNLPCheck = std::make_shared<TaskSelectPrimalCandidatesFromNLP>(env, true);
-            env->tasks->addTask(tSelectPrimNLPCheck, "SelectPrimNLPCheckReformulated");
+            auto tSelectPrimNLPCheck = std::make_shared<TaskSelectPrimalCandidatesFromNLP>(env, true, true);
+            addScheduledTask(tSelectPrimNLPCheck, "SelectPrimNLPCheckReformulated");
             std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tSelectPrimNLPCheck);
+
+            if(tIncrementalBoundTightening)
+                tIncrementalBoundTightening->addNLPTask(tSelectPrimNLPCheck);
+
+            if(tReducedCostFixing)
+                tReducedCostFixing->addNLPTask(tSelectPrimNLPCheck);
         }
 
         auto tClearPrimNLPCands = std::make_shared<TaskClearFixedPrimalCandidates>(env);
@@ -238,6 +368,9 @@ SolutionStrategyMultiTree::SolutionStrategyMultiTree(EnvironmentPtr envPtr)
 
     env->tasks->addTask(tInitializeIteration, "InitIter2");
 
+    if(tIncrementalBoundTightening)
+        env->tasks->addTask(tIncrementalBoundTightening, "IncrementalBoundTightening");
+
     if(env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"))
     {
         env->tasks->addTask(tInitMIPSolver, "InitMIPSolver");
@@ -255,6 +388,14 @@ SolutionStrategyMultiTree::SolutionStrategyMultiTree(EnvironmentPtr envPtr)
     auto tExecuteSolLimStrategy = std::make_shared<TaskExecuteSolutionLimitStrategy>(env);
     env->tasks->addTask(tExecuteSolLimStrategy, "ExecSolLimStrategy");
 
+    // The dual bounds of the MIP problems are only valid for the original problem in the convex case
+    if(env->settings->getSetting<bool>("MIP.DynamicGap.Use", "Dual") && env->reformulatedProblem->properties.isDiscrete
+        && env->reformulatedProblem->properties.convexity == E_ProblemConvexity::Convex)
+    {
+        auto tUpdateMIPGap = std::make_shared<TaskUpdateMIPGap>(env);
+        env->tasks->addTask(tUpdateMIPGap, "UpdateMIPGap");
+    }
+
     if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
     {
         if(static_cast<ES_HyperplaneCutStrategy>(env->settings->getSetting<int>("CutStrategy", "Dual"))
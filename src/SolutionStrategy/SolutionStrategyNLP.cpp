@@ -53,7 +53,11 @@
 
 #include "../Tasks/TaskSelectPrimalCandidatesFromSolutionPool.h"
 #include "../Tasks/TaskSelectPrimalCandidatesFromRootsearch.h"
+#include "../Tasks/TaskFinishAsynchronousRootsearches.h"
 #include "../Tasks/TaskSelectPrimalFixedNLPPointsFromSolutionPool.h"
+#include "../Tasks/TaskSelectPrimalCandidatesFromNLP.h"
+#include "../Tasks/TaskSelectPrimalNLPPolishPoint.h"
+#include "../Tasks/TaskClearFixedPrimalCandidates.h"
 
 #include "../Tasks/TaskUpdateInteriorPoint.h"
 
@@ -74,16 +78,17 @@ SolutionStrategyNLP::SolutionStrategyNLP(EnvironmentPtr envPtr)
 {
     env = envPtr;
 
-    env->timing->createTimer("InteriorPointSearch", "- interior point search");
+    env->timing->createTimer("InteriorPointSearch", "interior point search", "Total");
 
-    env->timing->createTimer("DualStrategy", "- dual strategy");
-    env->timing->createTimer("DualProblemsRelaxed", "  - solving relaxed problems");
-    env->timing->createTimer("DualProblemsDiscrete", "  - solving MIP problems");
-    env->timing->createTimer("DualCutGenerationRootSearch", "  - root search for constraint cuts");
-    env->timing->createTimer("DualObjectiveRootSearch", "  - root search for objective cut");
+    env->timing->createTimer("DualStrategy", "dual strategy", "Total");
+    env->timing->createTimer("DualProblemsRelaxed", "solving relaxed problems", "DualStrategy");
+    env->timing->createTimer("DualProblemsDiscrete", "solving MIP problems", "DualStrategy");
+    env->timing->createTimer("DualCutGenerationRootSearch", "root search for constraint cuts", "DualStrategy");
+    env->timing->createTimer("DualObjectiveRootSearch", "root search for objective cut", "DualStrategy");
 
-    env->timing->createTimer("PrimalStrategy", "- primal strategy");
-    env->timing->createTimer("PrimalBoundStrategyRootSearch", "  - performing root searches");
+    env->timing->createTimer("PrimalStrategy", "primal strategy", "Total");
+    env->timing->createTimer("PrimalBoundStrategyNLP", "solving NLP problems", "PrimalStrategy");
+    env->timing->createTimer("PrimalBoundStrategyRootSearch", "performing root searches", "PrimalStrategy");
 
     auto tFinalizeSolution = std::make_shared<TaskSequential>(env);
 
@@ -119,18 +124,52 @@ SolutionStrategyNLP::SolutionStrategyNLP(EnvironmentPtr envPtr)
     auto tSolveIteration = std::make_shared<TaskSolveIteration>(env);
     env->tasks->addTask(tSolveIteration, "SolveIter");
 
+    std::shared_ptr<TaskSelectPrimalCandidatesFromRootsearch> tSelectPrimRootsearch;
+
+    if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        tSelectPrimRootsearch = std::make_shared<TaskSelectPrimalCandidatesFromRootsearch>(env);
+
+        if(env->settings->getSetting<bool>("Rootsearch.Asynchronous", "Primal"))
+        {
+            auto tFinishRootsearches = std::make_shared<TaskFinishAsynchronousRootsearches>(env, tSelectPrimRootsearch);
+            std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tFinishRootsearches);
+        }
+    }
+
     auto tSelectPrimSolPool = std::make_shared<TaskSelectPrimalCandidatesFromSolutionPool>(env);
     env->tasks->addTask(tSelectPrimSolPool, "SelectPrimSolPool");
     std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tSelectPrimSolPool);
 
-    if(env->settings->getSetting<bool>("Rootsearch.Use", "Primal")
-        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    if(tSelectPrimRootsearch)
     {
-        auto tSelectPrimRootsearch = std::make_shared<TaskSelectPrimalCandidatesFromRootsearch>(env);
         env->tasks->addTask(tSelectPrimRootsearch, "SelectPrimRootsearch");
         std::dynamic_pointer_cast<TaskSequential>(tFinalizeSolution)->addTask(tSelectPrimRootsearch);
     }
 
+    // Solving the problem with SHOT as NLP solver would only repeat this solution process
+    if(env->settings->getSetting<bool>("FixedInteger.Use", "Primal")
+        && env->settings->getSetting<bool>("FixedInteger.Polish.Use", "Primal")
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0
+        && static_cast<ES_PrimalNLPSolver>(env->settings->getSetting<int>("FixedInteger.Solver", "Primal"))
+            != ES_PrimalNLPSolver::SHOT)
+    {
+        auto tSelectPrimNLPPolish = std::make_shared<TaskSelectPrimalNLPPolishPoint>(env);
+        env->tasks->addTask(tSelectPrimNLPPolish, "SelectPrimNLPPolish");
+
+        bool useReformulatedProblem = (static_cast<ES_PrimalNLPProblemSource>(env->settings->getSetting<int>(
+                                           "FixedInteger.SourceProblem", "Primal"))
+            == ES_PrimalNLPProblemSource::ReformulatedProblem);
+
+        auto tSelectPrimNLPCheck
+            = std::make_shared<TaskSelectPrimalCandidatesFromNLP>(env, useReformulatedProblem, false);
+        env->tasks->addTask(tSelectPrimNLPCheck, "SelectPrimNLPCheck");
+
+        auto tClearPrimNLPCands = std::make_shared<TaskClearFixedPrimalCandidates>(env);
+        env->tasks->addTask(tClearPrimNLPCands, "SelectClearNLPCandidates");
+    }
+
     auto tPrintIterReport = std::make_shared<TaskPrintIterationReport>(env);
     env->tasks->addTask(tPrintIterReport, "PrintIterReport");
 
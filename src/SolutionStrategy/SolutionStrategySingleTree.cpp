@@ -51,6 +51,7 @@
 #include "../Tasks/TaskSelectHyperplanePointsESH.h"
 #include "../Tasks/TaskSelectHyperplanePointsECP.h"
 #include "../Tasks/TaskAddHyperplanes.h"
+#include "../Tasks/TaskAddInitialTangents.h"
 #include "../Tasks/TaskAddPrimalReductionCut.h"
 #include "../Tasks/TaskCheckMaxNumberOfPrimalReductionCuts.h"
 
@@ -79,17 +80,17 @@ SolutionStrategySingleTree::SolutionStrategySingleTree(EnvironmentPtr envPtr)
 {
     env = envPtr;
 
-    env->timing->createTimer("InteriorPointSearch", "- interior point search");
+    env->timing->createTimer("InteriorPointSearch", "interior point search", "Total");
 
-    env->timing->createTimer("DualProblemsRelaxed", "  - solving relaxed problems");
-    env->timing->createTimer("DualStrategy", "- dual strategy");
-    env->timing->createTimer("DualProblemsDiscrete", "  - solving MIP problems");
-    env->timing->createTimer("DualCutGenerationRootSearch", "  - root search for constraint cuts");
-    env->timing->createTimer("DualObjectiveRootSearch", "  - root search for objective cut");
+    env->timing->createTimer("DualStrategy", "dual strategy", "Total");
+    env->timing->createTimer("DualProblemsRelaxed", "solving relaxed problems", "DualStrategy");
+    env->timing->createTimer("DualProblemsDiscrete", "solving MIP problems", "DualStrategy");
+    env->timing->createTimer("DualCutGenerationRootSearch", "root search for constraint cuts", "DualStrategy");
+    env->timing->createTimer("DualObjectiveRootSearch", "root search for objective cut", "DualStrategy");
 
-    env->timing->createTimer("PrimalStrategy", "- primal strategy");
-    env->timing->createTimer("PrimalBoundStrategyNLP", "  - solving NLP problems");
-    env->timing->createTimer("PrimalBoundStrategyRootSearch", "  - performing root searches");
+    env->timing->createTimer("PrimalStrategy", "primal strategy", "Total");
+    env->timing->createTimer("PrimalBoundStrategyNLP", "solving NLP problems", "PrimalStrategy");
+    env->timing->createTimer("PrimalBoundStrategyRootSearch", "performing root searches", "PrimalStrategy");
 
     auto tFinalizeSolution = std::make_shared<TaskSequential>(env);
 
@@ -115,6 +116,13 @@ SolutionStrategySingleTree::SolutionStrategySingleTree(EnvironmentPtr envPtr)
     auto tAddHPs = std::make_shared<TaskAddHyperplanes>(env);
     env->tasks->addTask(tAddHPs, "AddHPs");
 
+    if(env->settings->getSetting<bool>("HyperplaneCuts.InitialTangents.Use", "Dual")
+        && env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+    {
+        auto tAddInitialTangents = std::make_shared<TaskAddInitialTangents>(env);
+        env->tasks->addTask(tAddInitialTangents, "AddInitialTangents");
+    }
+
     if(env->settings->getSetting<bool>("Relaxation.Use", "Dual")
         && env->reformulatedProblem->properties.numberOfSemicontinuousVariables == 0
         && env->reformulatedProblem->properties.numberOfSemiintegerVariables == 0)
@@ -10,14 +10,20 @@
 
 #include "Solver.h"
 
+#include "CancellationToken.h"
+#include "DebugWriter.h"
 #include "DualSolver.h"
+#include "MemoryMonitor.h"
+#include "Metrics.h"
 #include "PrimalSolver.h"
 #include "Report.h"
 #include "Results.h"
 #include "Settings.h"
 #include "TaskHandler.h"
 #include "Timing.h"
+#include "TraceRecorder.h"
 #include "Utilities.h"
+#include "WarmStart.h"
 
 #ifdef HAS_GAMS
 #include "ModelingSystem/ModelingSystemGAMS.h"
@@ -27,15 +33,22 @@
 #endif
 #include "ModelingSystem/ModelingSystemOSiL.h"
 
+#include "MIPSolver/IMIPSolver.h"
+
 #include "SolutionStrategy/SolutionStrategySingleTree.h"
 #include "SolutionStrategy/SolutionStrategyMultiTree.h"
 #include "SolutionStrategy/SolutionStrategyMIQCQP.h"
 #include "SolutionStrategy/SolutionStrategyNLP.h"
+#include "SolutionStrategy/SolutionStrategyDecomposition.h"
 
 #include "../Tasks/TaskPerformBoundTightening.h"
 #include "../Tasks/TaskReformulateProblem.h"
 
+#include <algorithm>
+#include <fstream>
 #include <map>
+#include <mutex>
+#include <sstream>
 
 #ifdef HAS_STD_FILESYSTEM
 #include <filesystem>
@@ -62,16 +75,23 @@ Solver::Solver()
 
     env->results = std::make_shared<Results>(env);
     env->timing = std::make_shared<Timing>(env);
+    env->metrics = std::make_shared<Metrics>();
+    env->memoryMonitor = std::make_shared<MemoryMonitor>(env);
+    env->debugWriter = std::make_shared<DebugWriter>(env);
+    env->cancellationToken = std::make_shared<CancellationToken>();
 
     env->timing->createTimer("Total", "Total solution time");
     env->timing->startTimer("Total");
 
-    env->timing->createTimer("ProblemInitialization", "- problem initialization");
-    env->timing->createTimer("ProblemReformulation", "- problem reformulation");
-    env->timing->createTimer("BoundTightening", "- bound tightening");
-    env->timing->createTimer("BoundTighteningPOA", "  - initial outer approximation");
-    env->timing->createTimer("BoundTighteningFBBTOriginal", "  - feasibility based (original problem)");
-    env->timing->createTimer("BoundTighteningFBBTReformulated", "  - feasibility based (reformulated problem)");
+    env->timing->createTimer("ProblemInitialization", "problem initialization", "Total");
+    env->timing->createTimer("ProblemReformulation", "problem reformulation", "Total");
+    env->timing->createTimer("BoundTightening", "bound tightening", "Total");
+    env->timing->createTimer("BoundTighteningPOA", "initial outer approximation", "BoundTightening");
+    env->timing->createTimer(
+        "BoundTighteningFBBTOriginal", "feasibility based (original problem)", "BoundTightening");
+    env->timing->createTimer(
+        "BoundTighteningFBBTReformulated", "feasibility based (reformulated problem)", "BoundTightening");
+    env->timing->createTimer("BoundTighteningOBBT", "optimization based", "BoundTightening");
 
     env->settings = std::make_shared<Settings>(env->output);
     env->tasks = std::make_shared<TaskHandler>(env);
@@ -93,16 +113,23 @@ Solver::Solver(std::shared_ptr<spdlog::sinks::sink> consoleSink)
 
     env->results = std::make_shared<Results>(env);
     env->timing = std::make_shared<Timing>(env);
+    env->metrics = std::make_shared<Metrics>();
+    env->memoryMonitor = std::make_shared<MemoryMonitor>(env);
+    env->debugWriter = std::make_shared<DebugWriter>(env);
+    env->cancellationToken = std::make_shared<CancellationToken>();
 
     env->timing->createTimer("Total", "Total solution time");
     env->timing->startTimer("Total");
 
-    env->timing->createTimer("ProblemInitialization", "- problem initialization");
-    env->timing->createTimer("ProblemReformulation", "- problem reformulation");
-    env->timing->createTimer("BoundTightening", "- bound tightening");
-    env->timing->createTimer("BoundTighteningFBBT", "  - feasibility based");
-    env->timing->createTimer("BoundTighteningFBBTOriginal", "  - feasibility based (original problem");
-    env->timing->createTimer("BoundTighteningFBBTReformulated", "  - feasibility based (reformulated problem");
+    env->timing->createTimer("ProblemInitialization", "problem initialization", "Total");
+    env->timing->createTimer("ProblemReformulation", "problem reformulation", "Total");
+    env->timing->createTimer("BoundTightening", "bound tightening", "Total");
+    env->timing->createTimer("BoundTighteningFBBT", "feasibility based", "BoundTightening");
+    env->timing->createTimer(
+        "BoundTighteningFBBTOriginal", "feasibility based (original problem)", "BoundTightening");
+    env->timing->createTimer(
+        "BoundTighteningFBBTReformulated", "feasibility based (reformulated problem)", "BoundTightening");
+    env->timing->createTimer("BoundTighteningOBBT", "optimization based", "BoundTightening");
 
     env->settings = std::make_shared<Settings>(env->output);
     env->tasks = std::make_shared<TaskHandler>(env);
@@ -281,6 +308,16 @@ bool Solver::setProblem(std::string fileName)
     }
 #endif
 
+    if(problemExtension == ProblemSnapshot::fileExtension)
+    {
+        auto snapshot = std::make_shared<ProblemSnapshot>(env);
+
+        if(!snapshot->read(fileName))
+            return (false);
+
+        return (setProblem(snapshot));
+    }
+
     try
     {
         if(problemExtension == ".osil" || problemExtension == ".xml")
@@ -346,71 +383,346 @@ bool Solver::setProblem(std::string fileName)
         if(env->problem->name == "")
             env->problem->name = problemName.string();
 
-#ifdef SIMPLE_OUTPUT_CHARS
-        env->output->outputInfo(
-            "- Bound tightening "
-            "----------------------------------------------------------------------------------------------------");
-#else
-        env->output->outputInfo(
-            "- Bound tightening "
-            "───────────────────────────────────────────────────────────────────────────────────────────────────╴");
-#endif
+        saveOriginalVariableBounds();
+        tightenBoundsAndReformulateProblem();
 
-        if(env->settings->getSetting<bool>("MIP.CutOff.UseInitialValue", "Dual")
-            && std::abs(env->settings->getSetting<double>("MIP.CutOff.InitialValue", "Dual")) < SHOT_DBL_MAX)
-        {
-            env->dualSolver->cutOffToUse = env->settings->getSetting<double>("MIP.CutOff.InitialValue", "Dual");
-            env->dualSolver->useCutOff = true;
-            env->output->outputDebug(
-                fmt::format("  Setting user defined cutoff value to {}.", env->dualSolver->cutOffToUse));
-        }
-        else
+        if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
         {
-            env->dualSolver->cutOffToUse = env->results->getPrimalBound();
+            fs::filesystem::path problemFilename(env->settings->getSetting<std::string>("Debug.Path", "Output"));
+            problemFilename /= "originalproblem.txt";
+
+            std::stringstream problemText;
+            problemText << env->problem;
+
+            env->debugWriter->write(problemFilename.string(), problemText.str());
         }
+    }
+    catch(const std::exception& e)
+    {
+        env->output->outputError(fmt::format(" Error when reading problem from \"{0}\"", e.what()));
 
-        auto taskPerformBoundTightening = std::make_unique<TaskPerformBoundTightening>(env, env->problem);
-        taskPerformBoundTightening->run();
+        return (false);
+    }
 
-        setConvexityBasedSettingsPreReformulation();
-        verifySettings();
+    setConvexityBasedSettings();
+    verifySettings();
 
-        auto taskReformulateProblem = std::make_unique<TaskReformulateProblem>(env);
-        taskReformulateProblem->run();
+    return (this->selectStrategy());
+}
 
-        if(env->reformulatedProblem->objectiveFunction->properties.isMinimize)
+bool Solver::setProblem(ProblemSnapshotPtr snapshot)
+{
+    // The parsing, reformulation and bound tightening were done before the snapshot was written
+    env->results->auxiliaryVariablesIntroduced = snapshot->auxiliaryVariablesIntroduced;
+
+    return (setProblem(snapshot->problem, snapshot->reformulatedProblem));
+}
+
+bool Solver::writeProblemSnapshot(std::string fileName)
+{
+    return (ProblemSnapshot(env).write(fileName));
+}
+
+bool Solver::updateProblemData(const ProblemDataUpdate& update)
+{
+    if(!env->problem || !env->reformulatedProblem)
+    {
+        env->output->outputError(" Cannot update the problem data since no problem has been set.");
+        return (false);
+    }
+
+    auto& problem = env->problem;
+
+    for(auto& [index, lowerBound, upperBound] : update.variableBounds)
+    {
+        if(index < 0 || index >= (int)originalVariableLowerBounds.size())
         {
-            env->results->setDualBound(SHOT_DBL_MIN);
-            env->results->setPrimalBound(SHOT_DBL_MAX);
+            env->output->outputError(fmt::format(" Cannot update the bounds of variable with index {}.", index));
+            return (false);
         }
-        else
+    }
+
+    for(auto& [index, lowerBound, upperBound] : update.constraintBounds)
+    {
+        if(index < 0 || index >= (int)problem->numericConstraints.size())
         {
-            env->results->setDualBound(SHOT_DBL_MAX);
-            env->results->setPrimalBound(SHOT_DBL_MIN);
+            env->output->outputError(fmt::format(" Cannot update the bounds of constraint with index {}.", index));
+            return (false);
         }
+    }
 
-        if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
+    auto objective = std::dynamic_pointer_cast<LinearObjectiveFunction>(problem->objectiveFunction);
+
+    for(auto& [index, coefficient] : update.linearObjectiveCoefficients)
+    {
+        if(!objective || index < 0 || index >= (int)originalVariableLowerBounds.size())
         {
-            fs::filesystem::path problemFilename(env->settings->getSetting<std::string>("Debug.Path", "Output"));
-            problemFilename /= "originalproblem.txt";
+            env->output->outputError(
+                fmt::format(" Cannot update the objective coefficient of variable with index {}.", index));
+            return (false);
+        }
+    }
 
-            std::stringstream problemText;
-            problemText << env->problem;
+    // The interior points and primal solutions are checked again when used, while the cuts are only reused if wanted
+    auto previousSolution = std::make_shared<WarmStart>(env);
+
+    if(isProblemSolved)
+    {
+        previousSolution->collect();
+
+        if(!env->settings->getSetting<bool>("HyperplaneCuts.ReuseOnResolve", "Dual"))
+            previousSolution->cuts.clear();
+    }
+
+    // The bounds have been tightened previously based on the old data, so the bounds given originally are used
+    for(size_t i = 0; i < originalVariableLowerBounds.size(); i++)
+    {
+        problem->setVariableBounds(i, originalVariableLowerBounds[i], originalVariableUpperBounds[i]);
+        problem->allVariables[i]->properties.hasLowerBoundBeenTightened = false;
+        problem->allVariables[i]->properties.hasUpperBoundBeenTightened = false;
+    }
 
-            Utilities::writeStringToFile(problemFilename.string(), problemText.str());
+    for(auto& [index, lowerBound, upperBound] : update.variableBounds)
+    {
+        originalVariableLowerBounds[index] = lowerBound;
+        originalVariableUpperBounds[index] = upperBound;
+        problem->setVariableBounds(index, lowerBound, upperBound);
+    }
+
+    // The bounds are given for the constraint function as in the original problem, which may have been negated or split
+    // into two constraints when the constraint was standardized
+    for(auto& [index, lowerBound, upperBound] : update.constraintBounds)
+    {
+        auto& constraint = problem->numericConstraints[index];
+        double valueLHS = constraint->isNegatedInStandardForm ? -upperBound : lowerBound;
+        double valueRHS = constraint->isNegatedInStandardForm ? -lowerBound : upperBound;
+
+        if(auto& LHSConstraint = constraint->standardFormLHSConstraint)
+        {
+            // The added constraint is the negation of the constraint, and the split is kept
+            LHSConstraint->valueLHS = SHOT_DBL_MIN;
+            LHSConstraint->valueRHS = -valueLHS;
+            valueLHS = SHOT_DBL_MIN;
         }
+
+        constraint->valueLHS = valueLHS;
+        constraint->valueRHS = valueRHS;
     }
-    catch(const std::exception& e)
+
+    for(auto& [index, coefficient] : update.linearObjectiveCoefficients)
     {
-        env->output->outputError(fmt::format(" Error when reading problem from \"{0}\"", e.what()));
+        auto term = std::find_if(objective->linearTerms.begin(), objective->linearTerms.end(),
+            [index = index](const LinearTermPtr& T) { return (T->variable->index == index); });
+
+        if(term != objective->linearTerms.end())
+            (*term)->coefficient = coefficient;
+        else
+            objective->add(std::make_shared<LinearTerm>(coefficient, problem->getVariable(index)));
+    }
+
+    // Only the properties are updated, the nonlinear expressions and their tapes are unchanged
+    problem->updateProperties();
+    problem->evaluationCache.clear();
 
+    // The settings and the callbacks are kept, while everything depending on the previous solution is recreated
+    solutionStrategy.reset();
+    env->results = std::make_shared<Results>(env);
+    env->tasks = std::make_shared<TaskHandler>(env);
+    env->dualSolver = std::make_shared<DualSolver>(env);
+    env->primalSolver = std::make_shared<PrimalSolver>(env);
+    env->solutionStatistics = SolutionStatistics();
+
+    env->timing->resetTimers();
+    env->timing->startTimer("Total");
+
+    isProblemInitialized = false;
+    isProblemSolved = false;
+
+    try
+    {
+        tightenBoundsAndReformulateProblem();
+    }
+    catch(const std::exception& e)
+    {
+        env->output->outputError(fmt::format(" Error when updating the problem data: {}", e.what()));
         return (false);
     }
 
     setConvexityBasedSettings();
     verifySettings();
 
-    return (this->selectStrategy());
+    if(!selectStrategy())
+        return (false);
+
+    // A warm start given by the user is used instead of the previous solution
+    if(!warmStart)
+        warmStart = previousSolution;
+
+    return (true);
+}
+
+WarmStartPtr Solver::getWarmStart()
+{
+    auto collected = std::make_shared<WarmStart>(env);
+    collected->collect();
+
+    return (collected);
+}
+
+void Solver::setWarmStart(WarmStartPtr warmStartPtr) { warmStart = warmStartPtr; }
+
+void Solver::addPrimalSolutionHint(VectorDouble point) { primalSolutionHints.push_back(std::move(point)); }
+
+bool Solver::readPrimalSolutionHint(const std::string& fileName)
+{
+    if(!env->problem)
+    {
+        env->output->outputError(" Cannot read a primal solution hint before the problem has been set.");
+        return (false);
+    }
+
+    int numberOfVariables = env->problem->properties.numberOfVariables;
+    VectorDouble point;
+
+    std::ifstream file(fileName);
+
+    if(!file)
+    {
+        env->output->outputError(fmt::format(" Could not open primal solution hint {}.", fileName));
+        return (false);
+    }
+
+    bool isValid = true;
+
+    if(fs::filesystem::path(fileName).extension() == ".sol")
+    {
+        // The variable values follow the options and sizes, and the dual values of the constraints
+        std::string line;
+
+        while(std::getline(file, line) && line.rfind("Options", 0) != 0) { }
+
+        int numberOfOptions = 0, numberOfConstraints, numberOfDualValues, numberOfSolutionVariables, numberOfValues;
+        isValid = (bool)(file >> numberOfOptions);
+
+        for(int i = 0, option; isValid && i < numberOfOptions; i++)
+            isValid = (bool)(file >> option);
+
+        isValid = isValid
+            && (file >> numberOfConstraints >> numberOfDualValues >> numberOfSolutionVariables >> numberOfValues);
+
+        for(int i = 0; isValid && i < numberOfDualValues; i++)
+        {
+            double value;
+            isValid = (bool)(file >> value);
+        }
+
+        point.resize(isValid ? numberOfValues : 0);
+
+        for(int i = 0; isValid && i < numberOfValues; i++)
+            isValid = (bool)(file >> point[i]);
+    }
+    else
+    {
+        // Either a value on each line in the order of the variables, or a variable name and value on each line
+        std::map<std::string, int> variableIndexes;
+
+        for(auto& V : env->problem->allVariables)
+            variableIndexes.emplace(V->name, V->index);
+
+        std::string line;
+
+        while(isValid && std::getline(file, line))
+        {
+            std::istringstream lineStream(line);
+            std::string first, second;
+
+            if(!(lineStream >> first) || first[0] == '#')
+                continue;
+
+            try
+            {
+                if(!(lineStream >> second))
+                {
+                    point.push_back(std::stod(first));
+                    continue;
+                }
+
+                auto variable = variableIndexes.find(first);
+
+                if(variable == variableIndexes.end())
+                {
+                    env->output->outputWarning(
+                        fmt::format(" Variable {} in primal solution hint not found in the problem.", first));
+                    continue;
+                }
+
+                // Variables without a value are projected to their bounds when the point is checked
+                point.resize(numberOfVariables, 0.0);
+                point[variable->second] = std::stod(second);
+            }
+            catch(const std::exception&)
+            {
+                isValid = false;
+            }
+        }
+    }
+
+    if(!isValid || (int)point.size() != numberOfVariables)
+    {
+        env->output->outputError(fmt::format(
+            " Error when reading primal solution hint {}, expected values for {} variables.", fileName,
+            numberOfVariables));
+        return (false);
+    }
+
+    addPrimalSolutionHint(std::move(point));
+    return (true);
+}
+
+void Solver::applyPrimalSolutionHints()
+{
+    for(auto& P : primalSolutionHints)
+    {
+        if((int)P.size() != env->problem->properties.numberOfVariables)
+        {
+            env->output->outputWarning(
+                fmt::format(" Primal solution hint with {} values not used since the problem has {} variables.",
+                    P.size(), env->problem->properties.numberOfVariables));
+            continue;
+        }
+
+        // The point is checked directly, and is then the MIP start and cutoff of the first dual problem if feasible
+        double previousPrimalBound = env->results->getPrimalBound();
+        env->primalSolver->addPrimalSolutionCandidate(P, E_PrimalSolutionSource::WarmStart, 0);
+
+        if(env->results->getPrimalBound() != previousPrimalBound)
+            env->output->outputInfo(fmt::format(
+                " Primal solution hint accepted with objective value {}.", env->results->getPrimalBound()));
+        else
+            env->output->outputInfo(" Primal solution hint not accepted as a new primal solution.");
+
+        // Only strictly feasible points are used as interior points
+        if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+        {
+            auto interiorPoint = std::make_shared<InteriorPoint>();
+            interiorPoint->point = P;
+            env->dualSolver->interiorPointCandidates.push_back(interiorPoint);
+        }
+    }
+
+    primalSolutionHints.clear();
+}
+
+void Solver::saveOriginalVariableBounds()
+{
+    originalVariableLowerBounds.clear();
+    originalVariableUpperBounds.clear();
+
+    for(auto& V : env->problem->allVariables)
+    {
+        originalVariableLowerBounds.push_back(V->lowerBound);
+        originalVariableUpperBounds.push_back(V->upperBound);
+    }
 }
 
 bool Solver::setProblem(
@@ -419,6 +731,8 @@ bool Solver::setProblem(
     env->modelingSystem = modelingSystem;
     env->problem = problem;
 
+    saveOriginalVariableBounds();
+
     env->settings->updateSetting("ProblemName", "Input", problem->name);
 
     // Sets the debug path if not already set
@@ -446,7 +760,7 @@ bool Solver::setProblem(
         std::stringstream problem;
         problem << env->problem;
 
-        Utilities::writeStringToFile(filename.string(), problem.str());
+        env->debugWriter->write(filename.string(), problem.str());
     }
 
     // Do not do convexifying reformulations if the problem is assumed to be convex
@@ -498,11 +812,80 @@ bool Solver::setProblem(
     return (this->selectStrategy());
 }
 
+void Solver::tightenBoundsAndReformulateProblem()
+{
+#ifdef SIMPLE_OUTPUT_CHARS
+    env->output->outputInfo(
+        "- Bound tightening "
+        "----------------------------------------------------------------------------------------------------");
+#else
+    env->output->outputInfo(
+        "- Bound tightening "
+        "───────────────────────────────────────────────────────────────────────────────────────────────────╴");
+#endif
+
+    if(env->settings->getSetting<bool>("MIP.CutOff.UseInitialValue", "Dual")
+        && std::abs(env->settings->getSetting<double>("MIP.CutOff.InitialValue", "Dual")) < SHOT_DBL_MAX)
+    {
+        env->dualSolver->cutOffToUse = env->settings->getSetting<double>("MIP.CutOff.InitialValue", "Dual");
+        env->dualSolver->useCutOff = true;
+        env->output->outputDebug(
+            fmt::format("  Setting user defined cutoff value to {}.", env->dualSolver->cutOffToUse));
+    }
+    else
+    {
+        env->dualSolver->cutOffToUse = env->results->getPrimalBound();
+    }
+
+    auto taskPerformBoundTightening = std::make_unique<TaskPerformBoundTightening>(env, env->problem);
+    taskPerformBoundTightening->run();
+
+    setConvexityBasedSettingsPreReformulation();
+    verifySettings();
+
+    auto taskReformulateProblem = std::make_unique<TaskReformulateProblem>(env);
+    taskReformulateProblem->run();
+
+    if(env->reformulatedProblem->objectiveFunction->properties.isMinimize)
+    {
+        env->results->setDualBound(SHOT_DBL_MIN);
+        env->results->setPrimalBound(SHOT_DBL_MAX);
+    }
+    else
+    {
+        env->results->setDualBound(SHOT_DBL_MAX);
+        env->results->setPrimalBound(SHOT_DBL_MIN);
+    }
+}
+
 bool Solver::selectStrategy()
 {
     try
     {
-        if(static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual")) == ES_MIPSolver::Cbc)
+        auto usedMIPSolver = static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual"));
+
+#ifdef HAS_IPOPT
+        // The NLP problems of the blocks are solved with Ipopt
+        if(env->settings->getSetting<bool>("Decomposition.Use", "Strategy"))
+        {
+            auto decomposition = std::make_shared<BlockDecomposition>(env, env->reformulatedProblem);
+
+            if(decomposition->createBlocks())
+            {
+                env->output->outputDebug(" Using Benders decomposition solution strategy.");
+                solutionStrategy = std::make_unique<SolutionStrategyDecomposition>(env, decomposition);
+                isProblemInitialized = true;
+                env->results->usedSolutionStrategy = E_SolutionStrategy::Decomposition;
+
+                return (true);
+            }
+
+            env->output->outputDebug(" Problem cannot be decomposed, using the default solution strategy.");
+        }
+#endif
+
+        // The quadratic strategies are not available in Cbc
+        if(usedMIPSolver == ES_MIPSolver::Cbc)
         {
             if(env->problem->properties.numberOfDiscreteVariables == 0
                 && env->problem->properties.numberOfSemicontinuousVariables == 0)
@@ -511,6 +894,15 @@ bool Solver::selectStrategy()
                 solutionStrategy = std::make_unique<SolutionStrategyNLP>(env);
                 env->results->usedSolutionStrategy = E_SolutionStrategy::NLP;
             }
+            else if(static_cast<ES_TreeStrategy>(env->settings->getSetting<int>("TreeStrategy", "Dual"))
+                == ES_TreeStrategy::SingleTree)
+            {
+                env->output->outputDebug(" Using single-tree solution strategy.");
+                solutionStrategy = std::make_unique<SolutionStrategySingleTree>(env);
+                isProblemInitialized = true;
+                env->results->usedSolutionStrategy = E_SolutionStrategy::SingleTree;
+                env->dualSolver->isSingleTree = true;
+            }
             else
             {
                 solutionStrategy = std::make_unique<SolutionStrategyMultiTree>(env);
@@ -628,6 +1020,12 @@ bool Solver::selectStrategy()
 
 bool Solver::solveProblem()
 {
+    // The timers are measured directly in the thread solving the problem, and per thread in the other threads
+    env->timing->setOwnerThread();
+
+    // The settings may have been changed after the problem was set
+    setCancellationDeadline();
+
     if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
     {
         fs::filesystem::path filename(env->settings->getSetting<std::string>("Debug.Path", "Output"));
@@ -635,7 +1033,7 @@ bool Solver::solveProblem()
 
         auto usedSettings = env->settings->getSettingsAsString(false, false);
 
-        Utilities::writeStringToFile(filename.string(), usedSettings);
+        env->debugWriter->write(filename.string(), usedSettings);
     }
 
     if(env->problem->objectiveFunction->properties.isMinimize)
@@ -649,12 +1047,122 @@ bool Solver::solveProblem()
         env->results->setPrimalBound(SHOT_DBL_MIN);
     }
 
+    auto timelineFile = env->settings->getSetting<std::string>("Timeline.File", "Output");
+
+    if(timelineFile != "")
+    {
+        env->traceRecorder
+            = std::make_shared<TraceRecorder>(env->settings->getSetting<int>("Timeline.BufferSize", "Output"));
+    }
+
     assert(solutionStrategy != nullptr); /* would be NULL if setProblem failed */
+
+    // Applied after the bounds have been reset, so that the primal bound of the warm start solutions is kept
+    if(warmStart)
+    {
+        warmStart->apply();
+        warmStart.reset();
+    }
+
+    applyPrimalSolutionHints();
+
     isProblemSolved = solutionStrategy->solveProblem();
 
+    // The cancellation only applies to this solution, and the watchdog should not cancel the token after it
+    env->cancellationToken->reset();
+
+    // All events have been dispatched when the solver returns
+    env->events->flush();
+
+    // As are the debug files
+    env->debugWriter->flush();
+
+    // With the final termination reason
+    env->results->updateProgress();
+
+    if(env->traceRecorder)
+    {
+        if(env->traceRecorder->write(timelineFile))
+            env->output->outputDebug(" Timeline written to: " + timelineFile);
+        else
+            env->output->outputError(" Error when writing timeline to: " + timelineFile);
+    }
+
     return (isProblemSolved);
 }
 
+bool Solver::resolveProblem()
+{
+    if(!isProblemSolved)
+        return (solveProblem());
+
+    auto& MIPSolver = env->dualSolver->MIPSolver;
+
+    // The objective variable was restricted by the dual and primal bounds of the previous problem
+    if(MIPSolver->hasDualAuxiliaryObjectiveVariable())
+    {
+        Interval objectiveBound;
+
+        if(env->reformulatedProblem->auxiliaryObjectiveVariable)
+        {
+            objectiveBound = Interval(env->reformulatedProblem->auxiliaryObjectiveVariable->lowerBound,
+                env->reformulatedProblem->auxiliaryObjectiveVariable->upperBound);
+        }
+        else
+        {
+            double objVarBound
+                = env->settings->getSetting<double>("Variables.NonlinearObjectiveVariable.Bound", "Model");
+
+            try
+            {
+                objectiveBound = env->reformulatedProblem->objectiveFunction->getBounds();
+            }
+            catch(mc::Interval::Exceptions&)
+            {
+                objectiveBound = Interval(-objVarBound, objVarBound);
+            }
+        }
+
+        MIPSolver->updateVariableBound(
+            MIPSolver->getDualAuxiliaryObjectiveVariableIndex(), objectiveBound.l(), objectiveBound.u());
+    }
+
+    // The cutoff may have been tightened by the primal solutions of the previous problem
+    if(env->settings->getSetting<bool>("MIP.CutOff.UseInitialValue", "Dual")
+        && std::abs(env->settings->getSetting<double>("MIP.CutOff.InitialValue", "Dual")) < SHOT_DBL_MAX)
+    {
+        env->dualSolver->cutOffToUse = env->settings->getSetting<double>("MIP.CutOff.InitialValue", "Dual");
+        env->dualSolver->useCutOff = true;
+    }
+    else
+    {
+        env->dualSolver->cutOffToUse
+            = env->problem->objectiveFunction->properties.isMinimize ? SHOT_DBL_MAX : SHOT_DBL_MIN;
+    }
+
+    // The dual solver and the tasks are kept, while the results depend on the previous bounds
+    env->results = std::make_shared<Results>(env);
+    env->primalSolver = std::make_shared<PrimalSolver>(env);
+    env->solutionStatistics = SolutionStatistics();
+
+    env->timing->resetTimers();
+    env->timing->startTimer("Total");
+
+    isProblemSolved = false;
+
+    try
+    {
+        env->tasks->setNextTask("InitIter");
+    }
+    catch(const std::exception& e)
+    {
+        env->output->outputError(fmt::format(" Cannot resolve the problem: {}", e.what()));
+        return (false);
+    }
+
+    return (solveProblem());
+}
+
 void Solver::finalizeSolution()
 {
     if(env->modelingSystem)
@@ -683,6 +1191,18 @@ std::string Solver::getResultsTrace() { return (env->results->getResultsTrace())
 
 std::string Solver::getResultsSol() { return (env->results->getResultsSol()); }
 
+bool Solver::writeResultsOSrL(const std::string& fileName) { return (env->results->writeResultsOSrL(fileName)); }
+
+bool Solver::writeResultsTrace(const std::string& fileName) { return (env->results->writeResultsTrace(fileName)); }
+
+bool Solver::writeResultsSol(const std::string& fileName) { return (env->results->writeResultsSol(fileName)); }
+
+MetricsPtr Solver::getMetrics() { return (env->metrics); }
+
+std::string Solver::getMetricsPrometheus() { return (env->metrics ? env->metrics->getPrometheusFormat() : ""); }
+
+std::string Solver::getMetricsJSON() { return (env->metrics ? env->metrics->getJSONFormat() : ""); }
+
 void Solver::initializeSettings()
 {
     if(env->settings->settingsInitialized)
@@ -691,6 +1211,21 @@ void Solver::initializeSettings()
         return;
     }
 
+    // The settings only depend on how SHOT is built, so they are created once and the definitions shared by all
+    // solvers. Settings that have been created in the environment before are kept by creating them all again.
+    static std::mutex defaultSettingsMutex;
+    static std::shared_ptr<Settings> defaultSettings;
+
+    std::lock_guard<std::mutex> lock(defaultSettingsMutex);
+    bool isEmpty = (env->settings->getNumberOfSettings() == 0);
+
+    if(isEmpty && defaultSettings)
+    {
+        env->settings->assignSettings(*defaultSettings);
+        env->output->outputDebug(" Settings initialized from the default settings.");
+        return;
+    }
+
     std::string empty; // Used to create empty string options
 
     env->output->outputDebug(" Starting initialization of settings:");
@@ -714,6 +1249,12 @@ void Solver::initializeSettings()
 
     // Dual strategy settings: Interior point search strategy
 
+    env->settings->createSetting("ESH.InteriorPoint.Adaptive.MaxPoints", "Dual", 5,
+        "Max number of interior points in the adaptive strategy", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("ESH.InteriorPoint.Adaptive.MinDistance", "Dual", 1e-3,
+        "Min relative distance between the interior points in the adaptive strategy", 0.0, SHOT_DBL_MAX);
+
     env->settings->createSetting("ESH.InteriorPoint.CuttingPlane.BitPrecision", "Dual", 8,
         "Required termination bit precision for minimization subsolver", 1, 64, true);
 
@@ -726,6 +1267,9 @@ void Solver::initializeSettings()
     env->settings->createSetting("ESH.InteriorPoint.CuttingPlane.IterationLimitSubsolver", "Dual", 100,
         "Iteration limit for minimization subsolver", 0, SHOT_INT_MAX);
 
+    env->settings->createSetting("ESH.InteriorPoint.CuttingPlane.LineSearchMaxStep", "Dual", 2.0,
+        "Max step length in the line search relative to the step to the LP solution", 1.0, SHOT_DBL_MAX);
+
     env->settings->createSetting(
         "ESH.InteriorPoint.CuttingPlane.TimeLimit", "Dual", 10.0, "Time limit for minimax solver", 0.0, SHOT_DBL_MAX);
 
@@ -744,19 +1288,45 @@ void Solver::initializeSettings()
     env->settings->createSetting("ESH.InteriorPoint.MinimaxObjectiveUpperBound", "Dual", 0.1,
         "Upper bound for minimax objective variable", SHOT_DBL_MIN, SHOT_DBL_MAX);
 
+    env->settings->createSetting("ESH.InteriorPoint.MultiStart.BoundFraction", "Dual", 0.5,
+        "Fraction of the variable bound ranges kept in the restricted minimax problems", 0.0, 1.0);
+
+    env->settings->createSetting("ESH.InteriorPoint.MultiStart.MaxPoints", "Dual", 1,
+        "Max number of interior points to keep from the minimax problems", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("ESH.InteriorPoint.MultiStart.NumberOfStarts", "Dual", 1,
+        "Number of minimax problems to solve, all but the first with restricted variable bounds", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("ESH.InteriorPoint.MultiStart.NumberOfThreads", "Dual", 0,
+        "Number of threads to use for the minimax problems: 0: Automatic", 0, 999);
+
+    env->settings->createSetting("ESH.InteriorPoint.MultiStart.TerminationDeviation", "Dual", -0.1,
+        "A minimax problem is terminated when a point with at most this maximal deviation is found", SHOT_DBL_MIN,
+        0.0);
+
     VectorString enumAddPrimalPointAsInteriorPoint;
     enumAddPrimalPointAsInteriorPoint.push_back("No");
     enumAddPrimalPointAsInteriorPoint.push_back("Add as new");
     enumAddPrimalPointAsInteriorPoint.push_back("Replace old");
     enumAddPrimalPointAsInteriorPoint.push_back("Use avarage");
+    enumAddPrimalPointAsInteriorPoint.push_back("Keep an adaptive set");
     env->settings->createSetting("ESH.InteriorPoint.UsePrimalSolution", "Dual",
         static_cast<int>(ES_AddPrimalPointAsInteriorPoint::KeepBoth), "Utilize primal solution as interior point",
         enumAddPrimalPointAsInteriorPoint, 0);
     enumAddPrimalPointAsInteriorPoint.clear();
 
+    env->settings->createSetting("ESH.Rootsearch.Blocks.LinkingVariableThreshold", "Dual", 0,
+        "Variables in more nonlinear constraints than this do not join blocks: 0: no limit", 0, SHOT_INT_MAX);
+
+    env->settings->createSetting("ESH.Rootsearch.Blocks.Use", "Dual", false,
+        "Perform the root searches separately for each block of nonlinear constraints without common variables");
+
     env->settings->createSetting("ESH.Rootsearch.ConstraintTolerance", "Dual", 1e-8,
         "Constraint tolerance for when not to add individual hyperplanes", 0, SHOT_DBL_MAX);
 
+    env->settings->createSetting("ESH.Rootsearch.NumberOfThreads", "Dual", 0,
+        "Number of threads to use for the root searches: 0: Automatic", 0, 999);
+
     env->settings->createSetting(
         "ESH.Rootsearch.UniqueConstraints", "Dual", false, "Allow only one hyperplane per constraint per iteration");
 
@@ -768,21 +1338,74 @@ void Solver::initializeSettings()
     env->settings->createSettingGroup("Dual", "HyperplaneCuts", "Generated hyperplane cuts",
         "These settings control how the cutting planes or supporting hyperplanes are generated.");
 
+    env->settings->createSetting("HyperplaneCuts.Aging.ActivityTolerance", "Dual", 1e-6,
+        "A hyperplane cut is active if its slack in a MIP solution is smaller than this value", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("HyperplaneCuts.Aging.MaxInactiveIterations", "Dual", 20,
+        "Hyperplane cuts inactive for more than this many iterations are removed", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("HyperplaneCuts.Aging.MinRemovedCuts", "Dual", 100,
+        "Inactive hyperplane cuts are only removed once there are at least this many of them", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("HyperplaneCuts.Aging.Use", "Dual", false,
+        "Remove inactive hyperplane cuts from the multi-tree MIP problem and add them back when violated");
+
+    env->settings->createSetting("HyperplaneCuts.Cleanup.CoefficientTolerance", "Dual", 1e-9,
+        "Coefficients smaller than this times the largest one in a cut are removed if possible", 0.0, 1.0);
+
+    env->settings->createSetting("HyperplaneCuts.Cleanup.MaxDynamism", "Dual", 1e9,
+        "Cuts where the ratio of the largest and smallest coefficients is larger are not added", 1.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("HyperplaneCuts.Cleanup.MaxRelaxation", "Dual", 1e-6,
+        "Maximal weakening of a cut on the variable bounds when removing coefficients", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("HyperplaneCuts.Cleanup.Use", "Dual", false,
+        "Remove negligible coefficients, scale and check the dynamism of the cuts before adding them");
+
     env->settings->createSetting("HyperplaneCuts.ConstraintSelectionFactor", "Dual", 0.5,
         "The fraction of violated constraints to generate supporting hyperplanes / cutting planes for", 0.0, 1.0);
 
     env->settings->createSetting(
         "HyperplaneCuts.Delay", "Dual", true, "Add hyperplane cuts to model only after optimal MIP solution");
 
+    env->settings->createSetting("HyperplaneCuts.ECP.NumberOfThreads", "Dual", 0,
+        "Number of threads for calculating the gradients of the cutting planes in the ECP method: 0: Automatic", 0,
+        999);
+
+    env->settings->createSetting("HyperplaneCuts.Filter.MaxParallelism", "Dual", 0.999,
+        "Hyperplane cuts more parallel than this to a cut with larger efficacy are discarded", 0.0, 1.0);
+
+    env->settings->createSetting("HyperplaneCuts.Filter.Use", "Dual", true,
+        "Select the hyperplane cuts to add by their efficacy and parallelism in the last MIP solution");
+
+    env->settings->createSetting("HyperplaneCuts.InitialTangents.NumberOfPoints", "Dual", 5,
+        "Number of tangents added over the variable bounds for each univariate convex constraint", 1, 1000);
+
+    env->settings->createSetting("HyperplaneCuts.InitialTangents.NumberOfThreads", "Dual", 0,
+        "Number of threads used for calculating the initial tangents: 0: Automatic", 0, 999);
+
+    env->settings->createSetting("HyperplaneCuts.InitialTangents.Use", "Dual", true,
+        "Add tangents to convex constraints nonlinear in one variable before the first dual problem is solved");
+
     env->settings->createSetting("HyperplaneCuts.MaxConstraintFactor", "Dual", 0.1,
         "Rootsearch performed on constraints with values larger than this factor times the maximum value", 1e-6, 1.0);
 
     env->settings->createSetting("HyperplaneCuts.MaxPerIteration", "Dual", 200,
         "Maximal number of hyperplanes to add per iteration", 0, SHOT_INT_MAX);
 
+    env->settings->createSetting("HyperplaneCuts.DiskStore.File", "Dual", empty,
+        "File in which the points of the generated hyperplane cuts are kept instead of in memory, it can be read as a "
+        "warm start to resume a stopped run");
+
+    env->settings->createSetting("HyperplaneCuts.ReuseOnResolve", "Dual", false,
+        "Reuse the hyperplane cuts for convex constraints when solving the problem again after updating its data");
+
     env->settings->createSetting("HyperplaneCuts.UseIntegerCuts", "Dual", false,
         "Add integer cuts for infeasible integer-combinations for binary problems");
 
+    env->settings->createSetting("HyperplaneCuts.CombineIntegerCuts", "Dual", true,
+        "Combine integer cuts for binary problems that differ in one variable into one cut without it");
+
     env->settings->createSetting("HyperplaneCuts.SaveHyperplanePoints", "Dual", false,
         "Whether to save the points in the generated hyperplanes list", false);
 
@@ -814,6 +1437,18 @@ void Solver::initializeSettings()
         "An extra tolerance for the objective cutoff value (to prevent infeasible subproblems)", SHOT_DBL_MIN,
         SHOT_DBL_MAX);
 
+    env->settings->createSetting("MIP.DynamicGap.Factor", "Dual", 0.1,
+        "Initial fraction of the global relative gap used as relative gap in the MIP solver", 0.0, 1.0);
+
+    env->settings->createSetting("MIP.DynamicGap.MaxGap", "Dual", 0.05,
+        "Maximal relative gap used in the MIP solver with the dynamic gap", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("MIP.DynamicGap.StagnationIterations", "Dual", 2,
+        "Number of iterations with stagnated dual bound after which the dynamic gap is tightened", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("MIP.DynamicGap.Use", "Dual", false,
+        "Solve the intermediate MIP problems to a relative gap depending on the global gap (convex problems)");
+
     env->settings->createSetting(
         "MIP.InfeasibilityRepair.IntegerCuts", "Dual", true, "Allow feasibility repair of integer cuts");
 
@@ -826,6 +1461,10 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "MIP.InfeasibilityRepair.Use", "Dual", true, "Enable the infeasibility repair strategy for nonconvex problems");
 
+    env->settings->createSetting("MIP.InfeasibilityRepair.UseConflict", "Dual", false,
+        "Only relax the cuts in an IIS or Farkas certificate of the infeasible LP relaxation if one is found (Cbc "
+        "and Gurobi)");
+
     env->settings->createSetting("MIP.OptimalityTolerance", "Dual", 1e-6,
         "The reduced-cost tolerance for optimality in the MIP solver", 1e-9, 1e-2);
 
@@ -849,6 +1488,12 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "MIP.Presolve.UpdateObtainedBounds", "Dual", true, "Update bounds (from presolve) to the MIP model");
 
+    env->settings->createSetting("MIP.ReducedCostFixing.Tolerance", "Dual", 1e-6,
+        "Tolerance for the reduced costs and bound values, and relative for the gap, in reduced cost fixing", 0.0, 1.0);
+
+    env->settings->createSetting("MIP.ReducedCostFixing.Use", "Dual", false,
+        "Tighten the bounds of discrete variables using the reduced costs of the relaxations and the primal bound");
+
     env->settings->createSetting("MIP.SolutionLimit.ForceOptimal.Iteration", "Dual", 10000,
         "Iterations without dual bound updates for forcing optimal MIP solution", 0, SHOT_INT_MAX);
 
@@ -860,9 +1505,31 @@ void Solver::initializeSettings()
 
     env->settings->createSetting("MIP.SolutionLimit.Initial", "Dual", 1, "Initial MIP solution limit", 1, SHOT_INT_MAX);
 
+    env->settings->createSetting("MIP.SolutionLimit.Profile.TimeLimitFactor", "Dual", 5.0,
+        "MIP time limit as a factor of the measured solution time for the selected solution limit in the time profile "
+        "strategy: 0: no limit",
+        0.0, SHOT_DBL_MAX);
+
+    VectorString enumSolutionLimitStrategy;
+    enumSolutionLimitStrategy.push_back("Increase");
+    enumSolutionLimitStrategy.push_back("Adaptive");
+    enumSolutionLimitStrategy.push_back("Unlimited");
+    enumSolutionLimitStrategy.push_back("Time profile");
+    env->settings->createSetting("MIP.SolutionLimit.Strategy", "Dual",
+        static_cast<int>(ES_MIPSolutionLimitStrategy::Increase), "How to update the MIP solution limit",
+        enumSolutionLimitStrategy, 0);
+    enumSolutionLimitStrategy.clear();
+
     env->settings->createSetting("MIP.SolutionLimit.UpdateTolerance", "Dual", 0.001,
         "The constraint tolerance for when to update MIP solution limit", 0, SHOT_DBL_MAX);
 
+    env->settings->createSetting("MIP.SolutionStreaming.InterruptAfter", "Dual", 0,
+        "Interrupt the MIP solver after this many incumbents violating the nonlinear constraints (0: never)", 0,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("MIP.SolutionStreaming.Use", "Dual", false,
+        "Check the incumbents as primal solutions already while the multi-tree MIP problem is solved");
+
     env->settings->createSetting("MIP.SolutionPool.Capacity", "Dual", 100,
         "The maximum number of solutions in the solution pool", 0, SHOT_INT_MAX);
 
@@ -887,9 +1554,15 @@ void Solver::initializeSettings()
         "MIP.Solver", "Dual", static_cast<int>(usedMIPSolver), "Which MIP solver to use", enumMIPSolver, 0);
     enumMIPSolver.clear();
 
+    env->settings->createSetting("MIP.SymmetryBreaking.Use", "Dual", false,
+        "Add constraints that order the values of interchangeable binary and integer variables to the MIP problem");
+
     env->settings->createSetting(
         "MIP.UpdateObjectiveBounds", "Dual", false, "Update nonlinear objective variable bounds to primal/dual bounds");
 
+    env->settings->createSetting("MIP.UseNames", "Dual", true,
+        "Give the names of the variables, constraints and cuts to the MIP solver, faster without on large problems");
+
     // Primal settings: reduction cuts for nonconvex problems
 
     env->settings->createSettingGroup("Dual", "ReductionCut", "Dual reduction cut",
@@ -899,6 +1572,20 @@ void Solver::initializeSettings()
     env->settings->createSetting("ReductionCut.MaxIterations", "Dual", 5,
         "Max number of primal cut reduction without primal improvement", 0, SHOT_INT_MAX);
 
+    env->settings->createSetting("ReductionCut.Probing.NumberOfProbes", "Dual", 4,
+        "Number of reductions of the cutoff probed at the same time, the reduction factor is doubled for each", 2,
+        100);
+
+    env->settings->createSetting("ReductionCut.Probing.NumberOfThreads", "Dual", 0,
+        "Number of threads for solving the probes: 0: Automatic", 0, 999);
+
+    env->settings->createSetting("ReductionCut.Probing.TimeLimit", "Dual", 2.0,
+        "Time limit (s) for solving each probe", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("ReductionCut.Probing.Use", "Dual", false,
+        "Solve copies of the dual problem with different reductions of the cutoff in parallel, and use the largest "
+        "reduction that is feasible");
+
     env->settings->createSetting(
         "ReductionCut.ReductionFactor", "Dual", 0.001, "The factor used to reduce the cutoff value", 0, 1.0);
 
@@ -921,6 +1608,32 @@ void Solver::initializeSettings()
     env->settings->createSetting("Relaxation.MaxLazyConstraints", "Dual", 0,
         "Max number of lazy constraints to add in relaxed solutions in single-tree strategy", 0, SHOT_INT_MAX);
 
+    env->settings->createSetting("Relaxation.Node.CacheSize", "Dual", 1000,
+        "Number of relaxed solutions remembered by each thread to not generate cuts twice: 0: Disable", 0,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("Relaxation.Node.MaxCutsPerDepth", "Dual", 0,
+        "Max number of relaxed solutions used for cuts at each depth of the tree in single-tree strategy: 0: No limit",
+        0, SHOT_INT_MAX);
+
+    env->settings->createSetting("Relaxation.Node.MaxCutsPerSecond", "Dual", 0.0,
+        "Max number of relaxed solutions used for cuts per second in single-tree strategy: 0: No limit", 0.0,
+        SHOT_DBL_MAX);
+
+    env->settings->createSetting("Relaxation.Node.MinViolation", "Dual", 0.0,
+        "Min normalized violation of a relaxed solution to be used for cuts in single-tree strategy", 0.0,
+        SHOT_DBL_MAX);
+
+    env->settings->createSetting("Relaxation.RootCutLoop.MaxRounds", "Dual", 50,
+        "Max number of LP solve and cut rounds in the initial root cut loop", 0, SHOT_INT_MAX);
+
+    env->settings->createSetting("Relaxation.RootCutLoop.MinImprovement", "Dual", 1e-4,
+        "The root cut loop is terminated when the relative objective improvement in a round is smaller than this", 0.0,
+        SHOT_DBL_MAX);
+
+    env->settings->createSetting("Relaxation.RootCutLoop.Use", "Dual", false,
+        "Tighten the initial LP relaxation with ESH cuts in a loop without creating iterations");
+
     env->settings->createSetting(
         "Relaxation.TerminationTolerance", "Dual", 0.5, "Time limit (s) when solving LP problems initially");
 
@@ -944,12 +1657,91 @@ void Solver::initializeSettings()
     env->settings->createSetting("TreeStrategy.Multi.Reinitialize", "Dual", false,
         "Reinitialize the dual model in the subsolver each iteration", true);
 
+    env->settings->createSetting("TreeStrategy.Single.BackgroundPrimal", "Dual", false,
+        "Perform the primal root searches and fixed NLP problems in a separate thread instead of in the callback "
+        "(Cplex and Gurobi only)");
+
+    env->settings->createSetting("TreeStrategy.Single.ShareCuts", "Dual", true,
+        "Add the cuts for convex constraints created by one thread of the MIP solver as user cuts in the other threads "
+        "(Cplex only)");
+
+    env->settings->createSetting("TreeStrategy.Single.SpatialBranching.Tolerance", "Dual", 1e-6,
+        "A continuous bilinear term is branched on if it is violated more than this", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("TreeStrategy.Single.SpatialBranching.Use", "Dual", false,
+        "Branch on the variables in violated continuous bilinear terms and add local McCormick envelopes in the nodes "
+        "(Cplex only)");
+
     // Optimization model settings
 
     env->settings->createSettingGroup("Model", "", "Optimization model",
         "These settings control various aspects of SHOT's representation  for and handling of the provided "
         "optimization model.");
 
+    // Auxiliary variable evaluation
+
+    env->settings->createSetting("AuxiliaryVariables.NumberOfThreads", "Model", 1,
+        "Number of threads for calculating the auxiliary variable values in a point, the variables that do not depend "
+        "on each other are calculated at the same time: 0: Automatic",
+        0, 999);
+
+    // Compact term storage
+
+    env->settings->createSetting("CompactTermStorage.Use", "Model", false,
+        "Store the coefficients of the packed linear and quadratic terms in a dictionary per constraint if there are "
+        "at most 256 different ones, and do not create the linear constraint matrix, to reduce the memory usage");
+
+    // Constraint ordering
+
+    env->settings->createSetting("ConstraintReordering.Use", "Model", false,
+        "Evaluate the constraints and create the dual problem rows in reverse Cuthill-McKee order, so that "
+        "consecutive constraints share variables");
+
+    // Evaluation cache
+
+    env->settings->createSetting("EvaluationCache.MaxPoints", "Model", 1000,
+        "Maximal number of points with cached constraint evaluations, the cache is cleared when reached", 1,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("EvaluationCache.Use", "Model", true,
+        "Cache the constraint values and gradients calculated in a point during an iteration");
+
+    // Nonlinear expression evaluation
+
+    env->settings->createSetting("NonlinearExpressions.IntervalScreening", "Model", true,
+        "Skip the nonlinear constraints that cannot be violated within the variable bounds according to interval "
+        "arithmetic when finding the deviating constraints in the solution points");
+
+    env->settings->createSetting("NonlinearExpressions.ShareCommonSubexpressions", "Model", true,
+        "Share structurally equal subexpressions between the nonlinear expressions, which are then recorded once");
+
+    env->settings->createSetting("NonlinearExpressions.BatchedEvaluation.NumberOfThreads", "Model", 1,
+        "Number of threads for evaluating the nonlinear constraints in many points at once, e.g. in the solution pool, "
+        "the constraints are divided between the threads: 0: Automatic",
+        0, 999);
+
+    env->settings->createSetting("NonlinearExpressions.SinglePrecisionScreening", "Model", false,
+        "Screen the nonlinear constraints for violations in the solution points by first evaluating the tapes in "
+        "single precision, only the possibly most deviating constraints are evaluated again");
+
+    env->settings->createSetting("NonlinearExpressions.SinglePrecisionScreening.Tolerance", "Model", 1e-4,
+        "Relative margin for the single precision errors when screening the nonlinear constraints", 0.0, 1.0);
+
+    env->settings->createSetting("NonlinearExpressions.UseTape", "Model", true,
+        "Evaluate nonlinear expressions using compiled instruction tapes instead of the expression trees");
+
+    env->settings->createSetting("NonlinearExpressions.UseTapeForGradients", "Model", false,
+        "Calculate the gradients of the nonlinear expressions in the constraints by reverse differentiation on the "
+        "compiled tapes instead of with CppAD");
+
+    env->settings->createSetting("NonlinearExpressions.UseTapeForHessians", "Model", false,
+        "Calculate the Hessians of the nonlinear expressions in the constraints by forward-over-reverse "
+        "differentiation on the compiled tapes instead of with CppAD");
+
+    env->settings->createSetting("NonlinearExpressions.RecordConstraintsSeparately", "Model", true,
+        "Record the nonlinear expression of each constraint separately for automatic differentiation of gradients, "
+        "when the gradient is first needed");
+
     // Bound tightening
 
     env->settings->createSettingGroup("Model", "BoundTightening", "Bound tightening",
@@ -958,9 +1750,21 @@ void Solver::initializeSettings()
 
     // Bound tightening: feasibility based
 
+    env->settings->createSetting("BoundTightening.FeasibilityBased.Incremental.TimeLimit", "Model", 0.1,
+        "Time limit for each bound tightening with the objective cutoff", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("BoundTightening.FeasibilityBased.Incremental.Use", "Model", false,
+        "Perform bound tightening with the objective cutoff when the primal bound has been updated");
+
     env->settings->createSetting(
         "BoundTightening.FeasibilityBased.MaxIterations", "Model", 5, "Maximal number of bound tightening iterations");
 
+    env->settings->createSetting("BoundTightening.FeasibilityBased.MinimumImprovement", "Model", 1e-3,
+        "Minimum relative bound change for a variable for its constraints to be used again", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("BoundTightening.FeasibilityBased.NumberOfThreads", "Model", 1,
+        "Number of threads used for tightening independent groups of constraints: 0: Automatic", 0, 999);
+
     env->settings->createSetting("BoundTightening.FeasibilityBased.TimeLimit", "Model", 2.0,
         "Time limit for bound tightening", 0.0, SHOT_DBL_MAX);
 
@@ -970,6 +1774,17 @@ void Solver::initializeSettings()
     env->settings->createSetting("BoundTightening.FeasibilityBased.UseNonlinear", "Model", true,
         "Peform feasibility-based bound tightening on nonlinear expressions");
 
+    // Bound tightening: optimization based
+
+    env->settings->createSetting("BoundTightening.OptimizationBased.NumberOfThreads", "Model", 1,
+        "Number of threads solving the bound tightening LP problems: 0: Automatic", 0, 999);
+
+    env->settings->createSetting("BoundTightening.OptimizationBased.TimeLimit", "Model", 5.0,
+        "Time limit for optimization-based bound tightening", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("BoundTightening.OptimizationBased.Use", "Model", false,
+        "Minimize and maximize the nonlinear variables over the linear constraints to tighten their bounds");
+
     // Bound tightening: initial POA
 
     env->settings->createSetting(
@@ -1014,6 +1829,41 @@ void Solver::initializeSettings()
     env->settings->createSetting("Convexity.Quadratics.EigenValueTolerance", "Model", 1e-5,
         "Convexity tolerance for the eigenvalues of the Hessian matrix for quadratic terms", 0.0, SHOT_DBL_MAX);
 
+    env->settings->createSetting("Convexity.Quadratics.MaxDenseBlockSize", "Model", 1000,
+        "Larger blocks of quadratic terms are checked by Cholesky factorization instead of eigenvalue decomposition", 1,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("Convexity.Quadratics.NumberOfThreads", "Model", 0,
+        "Number of threads for analysing the convexity of the quadratic terms in the constraints: 0: Automatic", 0,
+        999);
+
+    env->settings->createSetting("Convexity.Sampling.Confidence", "Model", 0.99,
+        "Confidence that less than one percent of the point pairs would show that a function is not convex", 0.5,
+        0.999999);
+
+    env->settings->createSetting("Convexity.Sampling.NumberOfThreads", "Model", 0,
+        "Number of threads for sampling the functions with unknown convexity: 0: Automatic", 0, 999);
+
+    env->settings->createSetting("Convexity.Sampling.Tolerance", "Model", 1e-8,
+        "Relative tolerance for the convexity conditions in the sampled points", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("Convexity.Sampling.Use", "Model", false,
+        "Determine the convexity of functions with unknown convexity numerically by sampling");
+
+    // Presolve settings
+
+    env->settings->createSettingGroup("Model", "Presolve", "Presolve",
+        "These settings control the presolve of the linear constraints in the reformulated problem.");
+
+    env->settings->createSetting("Presolve.DominatedVariables.Use", "Model", true,
+        "Fix variables at a bound if this does not make any constraint or the objective worse");
+
+    env->settings->createSetting(
+        "Presolve.MaxIterations", "Model", 10, "Maximal number of presolve passes", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("Presolve.Use", "Model", true,
+        "Remove redundant linear constraints from the reformulated problem and fix variables");
+
     // Variable settings
 
     env->settings->createSettingGroup("Model", "Variables", "Variables",
@@ -1054,16 +1904,37 @@ void Solver::initializeSettings()
         enumBilinearIntegerReformulation, 0);
     enumBilinearIntegerReformulation.clear();
 
+    VectorString enumBilinearIntegerEncoding;
+    enumBilinearIntegerEncoding.push_back("One binary per value");
+    enumBilinearIntegerEncoding.push_back("Logarithmic");
+    env->settings->createSetting("Reformulation.Bilinear.IntegerFormulation.Encoding", "Model",
+        static_cast<int>(ES_BilinearIntegerEncoding::Unary),
+        "How the integer variable in a reformulated bilinear term is expressed with binaries",
+        enumBilinearIntegerEncoding, 0);
+    enumBilinearIntegerEncoding.clear();
+
     env->settings->createSetting("Reformulation.Bilinear.IntegerFormulation.MaxDomain", "Model", 100,
         "Do not reformulate integer variables in bilinear terms which can assume more than this number of discrete "
-        "values",
+        "values (the logarithmic encoding allows much larger values)",
         2, SHOT_INT_MAX);
 
+    env->settings->createSetting("Reformulation.Bilinear.Partitioning.MaxPartitions", "Model", 4,
+        "Maximal number of partitions of a variable in continuous bilinear terms", 2, 100);
+
+    env->settings->createSetting("Reformulation.Bilinear.Partitioning.MaxTerms", "Model", 100,
+        "Maximal number of continuous bilinear terms with partitioned McCormick envelopes", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("Reformulation.Bilinear.Partitioning.Use", "Model", false,
+        "Add McCormick envelopes to continuous bilinear terms, partitioned for the terms with the largest gaps");
+
     // Reformulations for constraints
     VectorString enumNonlinearTermPartitioning;
     enumNonlinearTermPartitioning.push_back("Always");
     enumNonlinearTermPartitioning.push_back("If result is convex");
     enumNonlinearTermPartitioning.push_back("Never");
+    env->settings->createSetting("Reformulation.Constraint.NumberOfThreads", "Model", 0,
+        "Number of threads copying the constraints that are not reformulated: 0: Automatic", 0, 999);
+
     env->settings->createSetting("Reformulation.Constraint.PartitionNonlinearTerms", "Model",
         static_cast<int>(ES_PartitionNonlinearSums::IfConvex), "When to partition nonlinear sums in constraints",
         enumNonlinearTermPartitioning, 0);
@@ -1072,6 +1943,10 @@ void Solver::initializeSettings()
         static_cast<int>(ES_PartitionNonlinearSums::IfConvex), "When to partition quadratic sums in constraints",
         enumNonlinearTermPartitioning, 0);
 
+    env->settings->createSetting("Reformulation.Constraint.ReuseExpressionReformulations", "Model", true,
+        "Reuse the reformulation of a nonlinear expression for the expressions with the same structure, variable types "
+        "and bounds");
+
     // Reformulations for monomials
 
     env->settings->createSetting(
@@ -1159,6 +2034,10 @@ void Solver::initializeSettings()
 
     env->settings->createSetting("Console.DualSolver.Show", "Output", false, "Show output from dual solver on console");
 
+    env->settings->createSetting("Console.Iteration.CallbackRate", "Output", 10.0,
+        "Maximum number of iteration lines per second from the callbacks of the MIP solver, 0: print in the callbacks",
+        0.0, 1000.0);
+
     VectorString enumIterationDetail;
     enumIterationDetail.push_back("Full");
     enumIterationDetail.push_back("On objective gap update");
@@ -1182,11 +2061,20 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "Console.PrimalSolver.Show", "Output", false, "Show output from primal solver on console");
 
+    env->settings->createSetting("Debug.Asynchronous", "Output", true,
+        "Write the debug files from a background thread, so that the solver does not wait for the disk");
+
+    env->settings->createSetting(
+        "Debug.Compress", "Output", false, "Compress the debug files with gzip (requires zlib)");
+
     env->settings->createSetting("Debug.Enable", "Output", false, "Use debug functionality");
 
     env->settings->createSetting(
         "Debug.Path", "Output", empty, "The folder where to save the debug information", false);
 
+    env->settings->createSetting("Debug.QueueSize", "Output", 256.0,
+        "Size of the debug files waiting to be written before the solver blocks (MB)", 0.0, SHOT_DBL_MAX);
+
     env->settings->createSetting(
         "File.LogLevel", "Output", static_cast<int>(E_LogLevel::Info), "Log level for file output", enumLogLevel, 0);
     enumLogLevel.clear();
@@ -1194,6 +2082,19 @@ void Solver::initializeSettings()
     env->settings->createSetting("GAMS.AlternateSolutionsFile", "Output", std::string(),
         "Name of GAMS GDX file to write alternative solutions to", false);
 
+    env->settings->createSetting("Iterations.KeepPointData", "Output", false,
+        "Keep the solution and hyperplane points of all retained iterations, not only the last two");
+
+    env->settings->createSetting("Iterations.Retained", "Output", 100,
+        "Max number of iterations kept in the results (0: all), summaries are kept for all iterations", 0,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("Log.Asynchronous", "Output", false,
+        "Write the console and file output in a separate thread, so that the solver does not wait for it");
+
+    env->settings->createSetting("Log.QueueSize", "Output", 8192,
+        "Max number of messages waiting to be written with asynchronous output", 1, SHOT_INT_MAX);
+
     VectorString enumOutputDirectory;
     enumOutputDirectory.push_back("Problem directory");
     enumOutputDirectory.push_back("Program directory");
@@ -1201,12 +2102,52 @@ void Solver::initializeSettings()
         "Where to save the output files", enumOutputDirectory, 0);
     enumOutputDirectory.clear();
 
+    env->settings->createSetting("Checkpoint.File", "Output", empty,
+        "File where to periodically write a checkpoint to resume a stopped run from, not used if empty", false);
+
+    env->settings->createSetting("Checkpoint.Frequency.Time", "Output", 600.0,
+        "Time in seconds between the checkpoints", 0.0, SHOT_DBL_MAX);
+
     env->settings->createSetting(
         "SaveNumberOfSolutions", "Output", 1, "Save max this number of primal solutions to OSrL or GDX file");
 
+    env->settings->createSetting("Timeline.BufferSize", "Output", 100000,
+        "Max number of timeline events kept per thread, the oldest events are overwritten", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("Timeline.File", "Output", empty,
+        "Chrome trace file where to write a timeline of the solver phases, not used if empty", false);
+
     env->settings->createSettingGroup(
         "Primal", "", "Primal heuristics", "These settings control the primal heuristics used in SHOT.");
 
+    env->settings->createSettingGroup("Primal", "FeasibilityPump", "Feasibility pump",
+        "For convex problems, a feasibility pump can be run before the first MIP problem is solved. It alternates "
+        "between rounding the relaxed point with a MIP problem and projecting the rounded point onto the continuous "
+        "relaxation with an NLP problem.");
+
+    env->settings->createSetting("FeasibilityPump.IterationLimit", "Primal", 50,
+        "Maximal number of roundings in the feasibility pump", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("FeasibilityPump.Perturbation.NumberOfFlips", "Primal", 10,
+        "Maximal number of binary variables flipped when the feasibility pump cycles", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting(
+        "FeasibilityPump.TimeLimit", "Primal", 10.0, "Time limit (s) for the feasibility pump", 0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("FeasibilityPump.Use", "Primal", false,
+        "Use the feasibility pump in the multi-tree strategy for convex problems, requires Ipopt");
+
+    env->settings->createSettingGroup("Primal", "FixAndPropagate", "Fix-and-propagate heuristic",
+        "Until a primal solution has been found, the discrete variables are fixed to the rounded values in the "
+        "relaxed or MIP solution and the bounds are propagated after each fixing. If no conflict is found, an "
+        "integer-fixed NLP problem is solved.");
+
+    env->settings->createSetting("FixAndPropagate.TimeLimit", "Primal", 1.0,
+        "Time limit (s) for fixing and propagating the variables in one call", 0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("FixAndPropagate.Use", "Primal", false,
+        "Use the fix-and-propagate heuristic in the multi-tree strategy, requires the fixed integer strategy");
+
     env->settings->createSettingGroup("Primal", "FixedInteger", "Fixed-integer (NLP) strategy",
         "The main primal strategy in SHOT is to solve integer-fixed NLP problems. These settings control, e.g., how "
         "often NLP problems are solved.");
@@ -1242,10 +2183,40 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "FixedInteger.IterationLimit", "Primal", 10000000, "Max number of iterations per call", 0, SHOT_INT_MAX);
 
+    env->settings->createSetting("FixedInteger.Asynchronous", "Primal", false,
+        "Solve the fixed NLP problems with Ipopt in a separate thread while the MIP problems are solved");
+
+    env->settings->createSetting("FixedInteger.NumberOfThreads", "Primal", 1,
+        "Number of fixed NLP problems to solve at the same time with Ipopt: 0: Automatic. Requires a thread-safe Ipopt "
+        "linear solver (HSL), otherwise one is used",
+        0, 999);
+
+    env->settings->createSetting("FixedInteger.RemoteWorkers", "Primal", empty,
+        "Workers started with SHOT --worker solving the fixed NLP problems, as host:port separated by commas", false);
+
+    env->settings->createSetting("FixedInteger.WorkerAddress", "Primal", std::string("127.0.0.1"),
+        "Address a worker started with SHOT --worker accepts connections on, e.g. :: for all addresses");
+
     env->settings->createSetting("FixedInteger.OnlyUniqueIntegerCombinations", "Primal", true,
         "Whether to resolve with the same integer combination, e.g. for nonconvex problems with different continuous "
         "variable starting points");
 
+    env->settings->createSetting("FixedInteger.SolutionPool.MaxPoints", "Primal", 10,
+        "Max number of additional solution pool points used per iteration, the most promising are selected: 0: all", 0,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("FixedInteger.Polish.ConstraintTolerance", "Primal", 1e-2,
+        "Max constraint deviation of the LP solution of a continuous problem for using it as starting point for the "
+        "NLP solver",
+        0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("FixedInteger.Polish.Use", "Primal", true,
+        "Solve continuous problems once with the NLP solver starting from an LP solution close to feasible");
+
+    env->settings->createSetting("FixedInteger.ReduceProblem", "Primal", false,
+        "Substitute the fixed values and remove the constant constraints and separable linear blocks before solving "
+        "with Ipopt");
+
     VectorString enumPrimalNLPSolver;
     enumPrimalNLPSolver.push_back("Ipopt");
     enumPrimalNLPSolver.push_back("GAMS");
@@ -1278,6 +2249,19 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "FixedInteger.TimeLimit", "Primal", 10.0, "Time limit (s) per NLP problem", 0, SHOT_DBL_MAX);
 
+    env->settings->createSetting("FixedInteger.ToleranceSchedule.GapLimit", "Primal", 0.1,
+        "Solve the NLP problems with looser tolerances while the relative objective gap is larger than this", 0.0,
+        SHOT_DBL_MAX);
+
+    env->settings->createSetting("FixedInteger.ToleranceSchedule.MaxIterations", "Primal", 100,
+        "Iteration limit for the NLP problems solved with looser tolerances", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("FixedInteger.ToleranceSchedule.RelativeTolerance", "Primal", 1e-3,
+        "Relative convergence tolerance for the NLP problems solved with looser tolerances", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("FixedInteger.ToleranceSchedule.Use", "Primal", false,
+        "Use looser NLP tolerances while the gap is large, and skip problems that cannot improve the primal bound");
+
     env->settings->createSetting("FixedInteger.Use", "Primal", true, "Use the fixed integer primal strategy");
 
     env->settings->createSetting("FixedInteger.UsePresolveBounds", "Primal", false,
@@ -1291,6 +2275,22 @@ void Solver::initializeSettings()
         "SHOT can utilize root searches between the dual solution point and an integer-fixed interior point. This "
         "setting controls whether this strategy is used.");
 
+    env->settings->createSetting("Rootsearch.Asynchronous", "Primal", false,
+        "Perform the primal root searches in a separate thread while the cuts are generated and the next MIP problem "
+        "is solved, the candidates are added in the next iteration (multi-tree strategy only)");
+
+    env->settings->createSetting("Rootsearch.NumberOfThreads", "Primal", 0,
+        "Number of threads to use for the root searches in the multi-tree strategy: 0: Automatic", 0, 999);
+
+    env->settings->createSetting("Rootsearch.SolutionPool.MaxPoints", "Primal", 10,
+        "Max number of solution pool points used per iteration, the most promising are selected: 0: all", 0,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("Rootsearch.StopAtRelativeImprovement", "Primal", 0.1,
+        "Skip the remaining root searches of an iteration when a point improves the primal bound by this relative "
+        "amount: 0: never skip",
+        0.0, SHOT_DBL_MAX);
+
     env->settings->createSetting("Rootsearch.Use", "Primal", true, "Use a rootsearch to find primal solutions");
 
     // Primal settings: tolerances for accepting primal solutions
@@ -1317,6 +2317,74 @@ void Solver::initializeSettings()
     env->settings->createSetting("UseRecommendedSettings", "Strategy", true,
         "Modifies some settings to their recommended values based on the strategy");
 
+    env->settings->createSettingGroup("Strategy", "Decomposition", "Benders decomposition",
+        "Convex problems where the continuous variables form independent blocks when the discrete variables are "
+        "fixed can be solved with a master MIP problem in the discrete variables and generalized Benders cuts from "
+        "the NLP problems of the blocks.");
+
+    env->settings->createSetting("Decomposition.CutTolerance", "Strategy", 1e-6,
+        "A Benders cut is only added if it is violated by more than this in the master solution", 0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("Decomposition.MinimumNumberOfBlocks", "Strategy", 2,
+        "The decomposition is only used if there are at least this many blocks", 1, SHOT_INT_MAX);
+
+    env->settings->createSetting("Decomposition.NumberOfThreads", "Strategy", 1,
+        "Number of threads for solving the block problems: 0: Automatic. Requires a thread-safe Ipopt linear solver "
+        "(HSL), otherwise the problems are solved one at a time",
+        0, 999);
+
+    env->settings->createSetting("Decomposition.Use", "Strategy", false,
+        "Use the Benders decomposition strategy if the problem can be decomposed");
+
+    env->settings->createSettingGroup("Strategy", "Memory", "Memory use",
+        "These settings control what is done when the solver uses much memory.");
+
+    env->settings->createSetting("Memory.Limit", "Strategy", SHOT_DBL_MAX,
+        "Resident memory (MB) above which the points of new cuts are kept in a file and fewer iterations are retained",
+        0.0, SHOT_DBL_MAX);
+
+    env->settings->createSetting("Memory.RetainedIterations", "Strategy", 10,
+        "Number of iterations retained after the memory limit has been exceeded", 2, SHOT_INT_MAX);
+
+    env->settings->createSetting("Memory.SpillFile", "Strategy", empty,
+        "File for the points of new cuts after the memory limit has been exceeded, a temporary file is used if empty");
+
+    env->settings->createSettingGroup("Strategy", "Parallel", "Parallel threads",
+        "The parallel phases of SHOT and the MIP solver share the same cores, the MIP solver is given the cores not "
+        "used by SHOT at the same time as it if its number of threads is automatic.");
+
+    env->settings->createSetting("Parallel.Deterministic", "Strategy", false,
+        "Give the same cuts and solutions whatever the timing of the threads, e.g. by using the results of the "
+        "parallel phases in a fixed order and disabling the asynchronous phases (time limits still apply)");
+
+    env->settings->createSetting("Parallel.NumberOfThreads", "Strategy", 0,
+        "Number of cores shared by the parallel phases and the MIP solver: 0: All", 0, 999);
+
+    env->settings->createSetting("Parallel.PinThreads", "Strategy", false,
+        "Pin the worker threads of the parallel phases to consecutive cores (Linux only)");
+
+    env->settings->createSettingGroup("Strategy", "Scheduler", "Task scheduler",
+        "In the multi-tree strategy, the primal root searches and fixed-integer NLP problems can be skipped in the "
+        "iterations where their measured improvement of the objective bounds per second is below that of the whole "
+        "solution process.");
+
+    env->settings->createSetting("Scheduler.ExplorationFactor", "Strategy", 1.0,
+        "How much less measured improvement is accepted for the tasks that have been run fewer times", 0.0,
+        SHOT_DBL_MAX);
+
+    env->settings->createSetting("Scheduler.MaxSkippedIterations", "Strategy", 10,
+        "A skipped task is run again after this many skipped iterations", 0, SHOT_INT_MAX);
+
+    env->settings->createSetting("Scheduler.Use", "Strategy", false,
+        "Skip the primal root searches and fixed-integer NLP problems when they do not improve the bounds enough");
+
+    env->settings->createSettingGroup("Strategy", "TaskGraph", "Task graph",
+        "In the multi-tree strategy, the tasks of an iteration that do not modify the parts of the environment used by "
+        "each other can be run at the same time.");
+
+    env->settings->createSetting("TaskGraph.Use", "Strategy", false,
+        "Run independent tasks at the same time, e.g. write the checkpoint while the iteration report is printed");
+
     // Subsolver settings: Cplex
 
     env->settings->createSettingGroup("Subsolver", "", "Subsolver functionality",
@@ -1432,6 +2500,9 @@ void Solver::initializeSettings()
 
     env->settings->createSettingGroup("Subsolver", "Gurobi", "Gurobi", "");
 
+    env->settings->createSetting("Gurobi.FunctionConstraints.Use", "Subsolver", false,
+        "Give univariate nonlinear terms in partitioned sums to Gurobi as function constraints (Gurobi 11 or later)");
+
     env->settings->createSetting(
         "Gurobi.Heuristics", "Subsolver", 0.05, "The relative amount of time spent in MIP heuristics.", 0.0, 1.0);
 
@@ -1497,6 +2568,15 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "Cbc.DeterministicParallelMode", "Subsolver", false, "Run Cbc with multiple threads in deterministic mode");
 
+    env->settings->createSetting("Cbc.Persistent", "Subsolver", false,
+        "Keep the Cbc model, its LP basis and pseudo-costs between iterations instead of creating a new one");
+
+    env->settings->createSetting("Cbc.RelaxationWarmStart", "Subsolver", true,
+        "Solve the LP relaxations directly in Clp with the dual simplex method warm-started from the previous basis");
+
+    env->settings->createSetting("Cbc.SingleTree", "Subsolver", false,
+        "Allow the single-tree strategy with lazy constraints in Cbc (experimental), otherwise multi-tree is used");
+
     VectorString enumCbcScaling;
     enumCbcScaling.push_back("automatic");
     enumCbcScaling.push_back("dynamic");
@@ -1532,6 +2612,28 @@ void Solver::initializeSettings()
     enumIPOptSolver.push_back("MA86");
     enumIPOptSolver.push_back("MA97");
     enumIPOptSolver.push_back("MUMPS");
+    VectorString enumIpoptHessianApproximation;
+    enumIpoptHessianApproximation.push_back("Exact");
+    enumIpoptHessianApproximation.push_back("Limited-memory quasi-Newton");
+    enumIpoptHessianApproximation.push_back("Automatic");
+    env->settings->createSetting("Ipopt.HessianApproximation", "Subsolver",
+        static_cast<int>(ES_IpoptHessianApproximation::Automatic),
+        "Whether to use the exact Lagrangian Hessian or a limited-memory approximation in Ipopt",
+        enumIpoptHessianApproximation, 0);
+    enumIpoptHessianApproximation.clear();
+
+    env->settings->createSetting("Ipopt.HessianApproximation.Density", "Subsolver", 0.5,
+        "Automatic: Hessian density in the nonlinear variables above which the approximation is used", 0.0, 1.0);
+
+    env->settings->createSetting("Ipopt.HessianApproximation.NonlinearVariables", "Subsolver", 200,
+        "Automatic: Minimum number of nonlinear variables for using the approximation due to the density", 0,
+        SHOT_INT_MAX);
+
+    env->settings->createSetting("Ipopt.HessianApproximation.TimeRatio", "Subsolver", 50.0,
+        "Automatic: Use the approximation if the first Hessian evaluation takes this many times longer than the "
+        "Jacobian one",
+        1.0, SHOT_DBL_MAX);
+
     env->settings->createSetting("Ipopt.LinearSolver", "Subsolver", static_cast<int>(ES_IpoptSolver::IpoptDefault),
         "Ipopt linear subsolver", enumIPOptSolver, 0);
     enumIPOptSolver.clear();
@@ -1541,6 +2643,12 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "Ipopt.RelativeConvergenceTolerance", "Subsolver", 1E-8, "Relative convergence tolerance");
 
+    env->settings->createSetting("Ipopt.WarmStart.Use", "Subsolver", true,
+        "Warm start from the solution with the nearest fixed values, and reuse Ipopt's setup between solves");
+
+    env->settings->createSetting("Ipopt.WarmStart.NumberOfPoints", "Subsolver", 20,
+        "Number of earlier primal-dual solutions saved for warm starts", 1, 1000);
+
 #endif
 
     env->settings->createSettingGroup("Subsolver", "SHOT", "SHOT primal NLP solver", "");
@@ -1566,13 +2674,27 @@ void Solver::initializeSettings()
     VectorString enumRootsearchMethod;
     enumRootsearchMethod.push_back("TOMS748");
     enumRootsearchMethod.push_back("Bisection");
+    enumRootsearchMethod.push_back("K-section");
     env->settings->createSetting("Rootsearch.Method", "Subsolver", static_cast<int>(ES_RootsearchMethod::BoostTOMS748),
         "Root search method to use", enumRootsearchMethod, 0);
     enumRootsearchMethod.clear();
 
+    env->settings->createSetting("Rootsearch.KSection.NumberOfPoints", "Subsolver", 8,
+        "Number of points evaluated simultaneously in each iteration of the k-section root search", 1, 1000);
+
     env->settings->createSetting("Rootsearch.TerminationTolerance", "Subsolver", 1e-16,
         "Epsilon lambda tolerance for root search", 0.0, SHOT_DBL_MAX);
 
+    env->settings->createSetting("Rootsearch.UseConstraintVariables", "Subsolver", true,
+        "Only interpolate the variables in the constraints in the root searches");
+
+    env->settings->createSetting("Rootsearch.WarmStart.BracketWidth", "Subsolver", 0.05,
+        "Half width of the bracket around the previous root when warm starting a root search", 0.0, 1.0);
+
+    env->settings->createSetting("Rootsearch.WarmStart.Use", "Subsolver", true,
+        "Start the root searches between an interior point and the same constraint in a bracket around the previous "
+        "root");
+
     // Termination settings
 
     env->settings->createSettingGroup(
@@ -1606,6 +2728,9 @@ void Solver::initializeSettings()
     env->settings->createSetting(
         "TimeLimit", "Termination", SHOT_DBL_MAX, "Time limit (s) for solver", 0.0, SHOT_DBL_MAX);
 
+    env->settings->createSetting("TimeLimit.Hard", "Termination", false,
+        "Stop all work of the solver, including the subsolvers and the preprocessing, at the time limit");
+
     // Hidden settings for problem information
 
     VectorString enumFileFormat;
@@ -1637,6 +2762,12 @@ void Solver::initializeSettings()
 
     env->settings->settingsInitialized = true;
 
+    if(isEmpty)
+    {
+        defaultSettings = std::make_shared<Settings>(nullptr);
+        defaultSettings->assignSettings(*env->settings);
+    }
+
     env->output->outputDebug(" Initialization of settings complete.");
 }
 
@@ -1683,6 +2814,12 @@ void Solver::verifySettings()
     env->output->setLogLevels(static_cast<E_LogLevel>(env->settings->getSetting<int>("Console.LogLevel", "Output")),
         static_cast<E_LogLevel>(env->settings->getSetting<int>("File.LogLevel", "Output")));
 
+    env->output->setAsynchronous(env->settings->getSetting<bool>("Log.Asynchronous", "Output"),
+        env->settings->getSetting<int>("Log.QueueSize", "Output"));
+
+    env->events->setAsynchronous(env->settings->getSetting<bool>("Events.Asynchronous", "Output"),
+        env->settings->getSetting<int>("Events.QueueSize", "Output"));
+
     // Checking for errors in NLP solver selection
 
     bool NLPSolverDefined = true;
@@ -1778,7 +2915,9 @@ void Solver::verifySettings()
         unboundedVariableBound = 1e50;
 
         // Some features are not available in Cbc
-        env->settings->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::MultiTree));
+        if(!env->settings->getSetting<bool>("Cbc.SingleTree", "Subsolver"))
+            env->settings->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::MultiTree));
+
         env->settings->updateSetting(
             "Reformulation.Quadratics.Strategy", "Model", static_cast<int>(ES_QuadraticProblemStrategy::Nonlinear));
         env->settings->updateSetting(
@@ -1825,6 +2964,34 @@ void Solver::verifySettings()
     if(env->settings->getSetting<double>("ObjectiveGap.Absolute", "Termination") < 1e-8)
         (env->settings->updateSetting("ObjectiveGap.Absolute", "Termination", 1e-10));
 
+    // The probes are limited by their time limit instead of by the iterations
+    if(env->settings->getSetting<bool>("Parallel.Deterministic", "Strategy"))
+        env->settings->updateSetting("ReductionCut.Probing.Use", "Dual", false);
+
+    // The cuts are recreated in the probes from their points
+    if(env->settings->getSetting<bool>("ReductionCut.Probing.Use", "Dual"))
+        env->settings->updateSetting("HyperplaneCuts.SaveHyperplanePoints", "Dual", true);
+
+    // The phases whose results are used when they are finished are not run asynchronously, and the MIP solvers are
+    // run in their deterministic modes
+    if(env->settings->getSetting<bool>("Parallel.Deterministic", "Strategy"))
+    {
+        env->settings->updateSetting("FixedInteger.Asynchronous", "Primal", false);
+        env->settings->updateSetting("Rootsearch.Asynchronous", "Primal", false);
+        env->settings->updateSetting("TreeStrategy.Single.BackgroundPrimal", "Dual", false);
+
+        // The skipped tasks depend on the measured times
+        env->settings->updateSetting("Scheduler.Use", "Strategy", false);
+
+#ifdef HAS_CBC
+        env->settings->updateSetting("Cbc.DeterministicParallelMode", "Subsolver", true);
+#endif
+
+#ifdef HAS_CPLEX
+        env->settings->updateSetting("Cplex.ParallelMode", "Subsolver", 1);
+#endif
+    }
+
     // Set correct iteration detail output when showing dual solver output
     if(env->settings->getSetting<bool>("Console.DualSolver.Show", "Output"))
         env->settings->updateSetting(
@@ -1834,8 +3001,23 @@ void Solver::verifySettings()
     if(env->settings->getSetting<bool>("Console.PrimalSolver.Show", "Output"))
         env->settings->updateSetting(
             "Console.Iteration.Detail", "Output", static_cast<int>(ES_IterationOutputDetail::Full));
+
+    setCancellationDeadline();
 }
 
+void Solver::setCancellationDeadline()
+{
+    auto timeLimit = env->settings->getSetting<double>("TimeLimit", "Termination");
+
+    // The time limit is measured from when the solver was created, as in TaskCheckTimeLimit
+    if(env->settings->getSetting<bool>("TimeLimit.Hard", "Termination") && timeLimit < SHOT_DBL_MAX)
+        env->cancellationToken->setDeadline(timeLimit - env->timing->getElapsedTime("Total"));
+    else
+        env->cancellationToken->clearDeadline();
+}
+
+void Solver::cancel() { env->cancellationToken->cancel(E_TerminationReason::UserAbort); }
+
 void Solver::setConvexityBasedSettingsPreReformulation()
 {
     if(env->settings->getSetting<bool>("UseRecommendedSettings", "Strategy"))
@@ -2000,12 +3182,16 @@ bool Solver::hasPrimalSolution() { return (isProblemSolved && env->results->hasP
 PrimalSolution Solver::getPrimalSolution()
 {
     if(hasPrimalSolution())
-        return (env->results->primalSolutions[0]);
+        return (env->results->getPrimalSolutions()[0]);
 
     throw NoPrimalSolutionException("Can not get primal solution since none has been found.");
 }
 
-std::vector<PrimalSolution> Solver::getPrimalSolutions() { return (env->results->primalSolutions); }
+std::vector<PrimalSolution> Solver::getPrimalSolutions() { return (env->results->getPrimalSolutions()); }
+
+PrimalSolutionsView Solver::getPrimalSolutionsView() { return (env->results->getPrimalSolutionsView()); }
+
+SolverProgress Solver::getProgress() { return (env->results->getProgress()); }
 
 E_TerminationReason Solver::getTerminationReason() { return (env->results->terminationReason); }
 
@@ -17,8 +17,10 @@
 #include "Enums.h"
 #include "EventHandler.h"
 #include "Structs.h"
+#include "WarmStart.h"
 
 #include "ModelingSystem/IModelingSystem.h"
+#include "ModelingSystem/ProblemSnapshot.h"
 #include "SolutionStrategy/ISolutionStrategy.h"
 
 #include "spdlog/spdlog.h"
@@ -27,6 +29,12 @@
 
 namespace SHOT
 {
+// Each solver has its own environment with the settings, output, timing and results, and several solvers can be used
+// at the same time in different threads of one process. A solver itself should only be used by one thread at a time.
+// The state shared by all solvers is the read-only copy of the default settings, and the thread numbers of CppAD.
+// When more than CPPAD_MAX_NUM_THREADS - 1 threads in the whole process use CppAD at the same time, the remaining ones
+// share a thread number and evaluate the nonlinear functions one at a time, so the number of threads used by each
+// solver should be limited, e.g. with MIP.NumberOfThreads, when many solvers run at the same time. Files given by the settings, e.g. the debug directory, should also be different for each solver.
 class DllExport Solver
 {
 private:
@@ -35,6 +43,9 @@ private:
     void initializeSettings();
     void verifySettings();
 
+    // Sets the deadline of the cancellation token to the time limit if TimeLimit.Hard is true
+    void setCancellationDeadline();
+
     void setConvexityBasedSettingsPreReformulation();
     void setConvexityBasedSettings();
 
@@ -42,6 +53,19 @@ private:
 
     bool selectStrategy();
 
+    void tightenBoundsAndReformulateProblem();
+
+    // The variable bounds before bound tightening, restored when the problem data is updated
+    void saveOriginalVariableBounds();
+
+    void applyPrimalSolutionHints();
+    VectorDouble originalVariableLowerBounds;
+    VectorDouble originalVariableUpperBounds;
+
+    // Applied and removed when the problem is solved
+    WarmStartPtr warmStart;
+    std::vector<VectorDouble> primalSolutionHints;
+
     bool isProblemInitialized = false;
     bool isProblemSolved = false;
 
@@ -68,16 +92,58 @@ public:
         return setProblem(problem, nullptr, modelingSystem);
     };
 
+    // Uses the already reformulated problems in a snapshot, also used for files with the snapshot extension
+    bool setProblem(ProblemSnapshotPtr snapshot);
+
+    // Writes the original and reformulated problem after they have been set, to be read again with setProblem()
+    bool writeProblemSnapshot(std::string fileName);
+
     ProblemPtr getOriginalProblem() { return (env->problem); };
     ProblemPtr getReformulatedProblem() { return (env->reformulatedProblem); };
 
     bool solveProblem();
 
+    // Solves the problem again after only the variable bounds have been changed, both in the reformulated problem and
+    // in the dual MIP solver, e.g. when other values of the discrete variables are fixed. The dual problem with its
+    // cuts and the interior points are kept, and the solution continues from the first iteration with the polyhedral
+    // approximation of the previous solution. The primal solutions and termination criteria are reset.
+    bool resolveProblem();
+
+    // Updates the data of a problem that has already been set, so that it can be solved again with solveProblem()
+    // without recreating the solver and its settings. The reformulation and bound tightening are redone, and the
+    // interior points and primal solutions of the previous solution are used as a warm start, as well as the cuts for
+    // convex constraints if HyperplaneCuts.ReuseOnResolve is true
+    bool updateProblemData(const ProblemDataUpdate& update);
+
+    // The cuts, interior points and primal solutions of the solved problem, the cuts are only included if
+    // HyperplaneCuts.SaveHyperplanePoints or HyperplaneCuts.ReuseOnResolve is true
+    WarmStartPtr getWarmStart();
+
+    // Used the next time the problem is solved, which must have the same variables and constraints
+    void setWarmStart(WarmStartPtr warmStart);
+
+    // A known solution of the original problem, e.g. of a previous run, that is checked when the problem is solved and
+    // used as the first primal solution, MIP start and cutoff if feasible, as well as an interior point candidate
+    void addPrimalSolutionHint(VectorDouble point);
+
+    // Reads the hint from an AMPL sol file, or a text file with a value or a variable name and value on each line,
+    // after the problem has been set
+    bool readPrimalSolutionHint(const std::string& fileName);
+
     void finalizeSolution();
 
+    // Stops the solution as soon as possible with the termination reason UserAbort, can be called from another thread
+    // while the problem is being set or solved. The best solution found so far is returned.
+    void cancel();
+
+    // Solves the fixed NLP problems outside of the solver, instead of the workers in FixedInteger.RemoteWorkers
+    void setFixedNLPExecutor(std::shared_ptr<IFixedNLPExecutor> executor) { env->fixedNLPExecutor = executor; };
+
+    // The callback takes no arguments, or the PrimalSolution or IterationSummary of NewPrimalSolution and
+    // IterationFinished events
     template <typename Callback> inline void registerCallback(const E_EventType& event, Callback&& callback)
     {
-        env->events->registerCallback(event, callback);
+        env->events->registerCallback(event, std::forward<Callback>(callback));
     }
 
     std::string getOptionsOSoL();
@@ -87,6 +153,16 @@ public:
     std::string getResultsTrace();
     std::string getResultsSol();
 
+    // Writes the results directly to a file, returns false if it could not be written
+    bool writeResultsOSrL(const std::string& fileName);
+    bool writeResultsTrace(const std::string& fileName);
+    bool writeResultsSol(const std::string& fileName);
+
+    // The counters and latency histograms collected during the solution process
+    MetricsPtr getMetrics();
+    std::string getMetricsPrometheus();
+    std::string getMetricsJSON();
+
     void updateSetting(std::string name, std::string category, int value);
     void updateSetting(std::string name, std::string category, std::string value);
     void updateSetting(std::string name, std::string category, double value);
@@ -103,6 +179,12 @@ public:
     PrimalSolution getPrimalSolution();
     std::vector<PrimalSolution> getPrimalSolutions();
 
+    // The solution pool without copying the solutions, which can be used while the problem is solved in another thread
+    PrimalSolutionsView getPrimalSolutionsView();
+
+    // The bounds, gaps, iteration and time, which can be read often while the problem is solved in another thread
+    SolverProgress getProgress();
+
     E_TerminationReason getTerminationReason();
     E_ModelReturnStatus getModelReturnStatus();
 };
@@ -0,0 +1,361 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "SolverPortfolio.h"
+
+#include "DualSolver.h"
+#include "EventHandler.h"
+#include "Output.h"
+#include "Results.h"
+#include "Settings.h"
+#include "TaskHandler.h"
+#include "Timing.h"
+#include "Utilities.h"
+#include "WarmStart.h"
+
+#include "Model/ObjectiveFunction.h"
+#include "Model/Problem.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace SHOT
+{
+
+SolverPortfolio::SolverPortfolio() : output(std::make_shared<Output>()) { }
+
+SolverPortfolio::SolverPortfolio(OutputPtr output) : output(output) { }
+
+SolverPortfolio::~SolverPortfolio() = default;
+
+void SolverPortfolio::setBaseOptions(std::string options) { baseOptions = options; }
+
+void SolverPortfolio::addConfiguration(std::string name, std::string options)
+{
+    Configuration configuration;
+    configuration.name = name;
+    configuration.options = options;
+
+    configurations.push_back(std::move(configuration));
+}
+
+bool SolverPortfolio::addConfigurationsFromFile(std::string fileName)
+{
+    std::ifstream file(fileName);
+
+    if(!file)
+    {
+        output->outputError(fmt::format(" Could not open portfolio configurations file {}.", fileName));
+        return (false);
+    }
+
+    std::string line, name, options;
+    bool hasConfiguration = false;
+    size_t numberOfConfigurations = configurations.size();
+
+    while(std::getline(file, line))
+    {
+        auto trimmedLine = Utilities::trim(line);
+
+        if(trimmedLine.size() > 2 && trimmedLine.front() == '[' && trimmedLine.back() == ']')
+        {
+            if(hasConfiguration)
+                addConfiguration(name, options);
+
+            name = trimmedLine.substr(1, trimmedLine.size() - 2);
+            options.clear();
+            hasConfiguration = true;
+        }
+        else if(hasConfiguration)
+        {
+            options += line + '\n';
+        }
+    }
+
+    if(hasConfiguration)
+        addConfiguration(name, options);
+
+    if(configurations.size() == numberOfConfigurations)
+    {
+        output->outputError(fmt::format(" No configurations found in portfolio configurations file {}.", fileName));
+        return (false);
+    }
+
+    return (true);
+}
+
+void SolverPortfolio::addDefaultConfigurations()
+{
+    addConfiguration("multi-tree ESH",
+        fmt::format("Dual.TreeStrategy = {}\nDual.CutStrategy = {}\n", static_cast<int>(ES_TreeStrategy::MultiTree),
+            static_cast<int>(ES_HyperplaneCutStrategy::ESH)));
+
+    addConfiguration("multi-tree ECP",
+        fmt::format("Dual.TreeStrategy = {}\nDual.CutStrategy = {}\n", static_cast<int>(ES_TreeStrategy::MultiTree),
+            static_cast<int>(ES_HyperplaneCutStrategy::ECP)));
+
+#if defined(HAS_CPLEX) || defined(HAS_GUROBI)
+    addConfiguration("single-tree ESH",
+        fmt::format("Dual.TreeStrategy = {}\nDual.CutStrategy = {}\n", static_cast<int>(ES_TreeStrategy::SingleTree),
+            static_cast<int>(ES_HyperplaneCutStrategy::ESH)));
+#endif
+
+    addConfiguration("multi-tree ESH nonlinear quadratics",
+        fmt::format("Dual.TreeStrategy = {}\nModel.Reformulation.Quadratics.Strategy = {}\n",
+            static_cast<int>(ES_TreeStrategy::MultiTree), static_cast<int>(ES_QuadraticProblemStrategy::Nonlinear)));
+}
+
+bool SolverPortfolio::setProblem(std::string fileName)
+{
+    if(configurations.empty())
+        addDefaultConfigurations();
+
+    // The threads of the MIP solver are divided between the configurations
+    int numberOfThreads = std::max(1, (int)std::thread::hardware_concurrency() / (int)configurations.size());
+
+    for(size_t i = 0; i < configurations.size(); i++)
+    {
+        auto& configuration = configurations[i];
+        configuration.solver = std::make_unique<Solver>();
+
+        auto& solver = *configuration.solver;
+        auto env = solver.getEnvironment();
+
+        solver.setOptionsFromString(baseOptions);
+        solver.setOptionsFromString(configuration.options);
+
+        solver.updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+        solver.updateSetting("File.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+        // The points are needed to share the cuts
+        solver.updateSetting("HyperplaneCuts.SaveHyperplanePoints", "Dual", true);
+
+        if(env->settings->getSetting<int>("MIP.NumberOfThreads", "Dual") == 0)
+            solver.updateSetting("MIP.NumberOfThreads", "Dual", numberOfThreads);
+
+        solver.registerCallback(E_EventType::NewPrimalSolution,
+            [this, i](const PrimalSolution& solution)
+            {
+                // Solutions from the other configurations are already shared
+                if(solution.sourceType == E_PrimalSolutionSource::WarmStart)
+                    return;
+
+                std::lock_guard<std::mutex> lock(exchangeMutex);
+                sharedSolutions.emplace_back(i, solution.point);
+            });
+
+        solver.registerCallback(E_EventType::UserTerminationCheck, [this, i] { exchange(i); });
+
+        if(!solver.setProblem(fileName))
+        {
+            output->outputError(
+                fmt::format(" Could not set the problem for the portfolio configuration {}.", configuration.name));
+            return (false);
+        }
+
+        configuration.numberOfVariables = env->reformulatedProblem->properties.numberOfVariables;
+        configuration.numberOfConstraints = env->reformulatedProblem->properties.numberOfNumericConstraints;
+    }
+
+    output->outputInfo(
+        fmt::format(" Solving the problem with a portfolio of {} configurations.", configurations.size()));
+
+    return (true);
+}
+
+bool SolverPortfolio::solveProblem()
+{
+    if(configurations.empty() || !configurations[0].solver)
+    {
+        output->outputError(" The problem has not been set for the portfolio.");
+        return (false);
+    }
+
+    isFinished = false;
+    finishedConfiguration = -1;
+
+    sharedSolutions.clear();
+    sharedCuts.clear();
+
+    std::vector<char> isSolved(configurations.size(), false);
+    std::vector<std::thread> threads;
+
+    for(size_t i = 0; i < configurations.size(); i++)
+    {
+        configurations[i].numberOfImportedSolutions = 0;
+        configurations[i].numberOfImportedCuts = 0;
+        configurations[i].numberOfExportedHyperplanes = 0;
+
+        threads.emplace_back(
+            [this, i, &isSolved]
+            {
+                auto& configuration = configurations[i];
+                configuration.threadID = std::this_thread::get_id();
+
+                try
+                {
+                    isSolved[i] = configuration.solver->solveProblem();
+                }
+                catch(const std::exception& e)
+                {
+                    output->outputError(
+                        fmt::format(" Error when solving with portfolio configuration {}:", configuration.name),
+                        e.what());
+                }
+
+                if(!isSolved[i] || !isSolvedToCompletion(*configuration.solver))
+                    return;
+
+                int noConfiguration = -1;
+
+                if(finishedConfiguration.compare_exchange_strong(noConfiguration, (int)i))
+                    isFinished = true;
+            });
+    }
+
+    for(auto& T : threads)
+        T.join();
+
+    for(size_t i = 0; i < configurations.size(); i++)
+    {
+        auto env = configurations[i].solver->getEnvironment();
+
+        output->outputInfo(fmt::format(" Configuration {}: {}, primal bound {}, dual bound {}, {:.2f} s.",
+            configurations[i].name, env->results->terminationReasonDescription, env->results->getPrimalBound(),
+            env->results->getCurrentDualBound(), env->timing->getElapsedTime("Total")));
+    }
+
+    output->outputInfo(
+        fmt::format(" Using the results of configuration {}.", configurations[getBestConfiguration()].name));
+
+    return (std::find(isSolved.begin(), isSolved.end(), true) != isSolved.end());
+}
+
+size_t SolverPortfolio::getBestConfiguration()
+{
+    if(finishedConfiguration >= 0)
+        return (finishedConfiguration);
+
+    size_t bestConfiguration = 0;
+    bool hasBestSolution = false;
+
+    for(size_t i = 0; i < configurations.size(); i++)
+    {
+        auto& solver = *configurations[i].solver;
+
+        if(!solver.hasPrimalSolution())
+            continue;
+
+        bool isMinimize = solver.getOriginalProblem()->objectiveFunction->properties.isMinimize;
+        double primalBound = solver.getPrimalBound();
+        double bestPrimalBound = configurations[bestConfiguration].solver->getPrimalBound();
+
+        if(!hasBestSolution || (isMinimize && primalBound < bestPrimalBound)
+            || (!isMinimize && primalBound > bestPrimalBound))
+        {
+            bestConfiguration = i;
+            hasBestSolution = true;
+        }
+    }
+
+    return (bestConfiguration);
+}
+
+void SolverPortfolio::exchange(size_t index)
+{
+    auto& configuration = configurations[index];
+    auto env = configuration.solver->getEnvironment();
+
+    if(isFinished)
+    {
+        configuration.solver->cancel();
+        return;
+    }
+
+    // The solutions and cuts are only added in the thread of the configuration itself, and not from the MIP solver
+    // callbacks that may be called from other threads
+    if(std::this_thread::get_id() != configuration.threadID || !env->dualSolver || env->dualSolver->isSingleTree)
+        return;
+
+    WarmStart warmStart(env);
+    warmStart.numberOfVariables = configuration.numberOfVariables;
+    warmStart.numberOfConstraints = configuration.numberOfConstraints;
+
+    std::vector<SharedCut> exportedCuts;
+    auto& hyperplanes = env->dualSolver->generatedHyperplanes;
+
+    for(; configuration.numberOfExportedHyperplanes < hyperplanes.size(); configuration.numberOfExportedHyperplanes++)
+    {
+        auto& HP = hyperplanes[configuration.numberOfExportedHyperplanes];
+
+        if(HP.isRemoved || !HP.isSourceConvex || !HP.generatedPoint
+            || (int)HP.generatedPoint->size() != warmStart.numberOfVariables)
+            continue;
+
+        bool isObjectiveCut = (HP.source == E_HyperplaneSource::ObjectiveRootsearch
+            || HP.source == E_HyperplaneSource::ObjectiveCuttingPlane);
+
+        exportedCuts.push_back(
+            { index, { isObjectiveCut ? -1 : HP.sourceConstraintIndex, HP.source, HP.generatedPoint->getValues() } });
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(exchangeMutex);
+
+        sharedCuts.insert(sharedCuts.end(), exportedCuts.begin(), exportedCuts.end());
+
+        for(; configuration.numberOfImportedSolutions < sharedSolutions.size();
+            configuration.numberOfImportedSolutions++)
+        {
+            auto& [source, point] = sharedSolutions[configuration.numberOfImportedSolutions];
+
+            if(source != index)
+                warmStart.primalSolutions.push_back(point);
+        }
+
+        // The cuts are only valid for the same reformulated problem
+        for(; configuration.numberOfImportedCuts < sharedCuts.size(); configuration.numberOfImportedCuts++)
+        {
+            auto& C = sharedCuts[configuration.numberOfImportedCuts];
+
+            if(C.configuration == index)
+                continue;
+
+            auto& source = configurations[C.configuration];
+
+            if(source.numberOfVariables == configuration.numberOfVariables
+                && source.numberOfConstraints == configuration.numberOfConstraints)
+                warmStart.cuts.push_back(C.cut);
+        }
+    }
+
+    if(warmStart.cuts.empty() && warmStart.primalSolutions.empty())
+        return;
+
+    warmStart.apply();
+}
+
+bool SolverPortfolio::isSolvedToCompletion(Solver& solver)
+{
+    switch(solver.getModelReturnStatus())
+    {
+    case E_ModelReturnStatus::OptimalGlobal:
+    case E_ModelReturnStatus::InfeasibleGlobal:
+    case E_ModelReturnStatus::Unbounded:
+    case E_ModelReturnStatus::UnboundedNoSolution:
+        return (true);
+    default:
+        return (false);
+    }
+}
+
+} // namespace SHOT
@@ -0,0 +1,110 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "Environment.h"
+#include "Solver.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace SHOT
+{
+
+// Solves a problem with several configurations of the strategies and settings in parallel, each in its own thread with
+// its own Solver and Environment. The configurations share their primal solutions, and the cuts for convex
+// constraints with the configurations that have the same reformulated problem. The first configuration to terminate
+// with the problem solved to the objective gap tolerances, or proven infeasible or unbounded, terminates the others.
+class DllExport SolverPortfolio
+{
+public:
+    SolverPortfolio();
+
+    // The messages of the portfolio are written to the output, while the configurations themselves do not write any
+    SolverPortfolio(OutputPtr output);
+
+    ~SolverPortfolio();
+
+    // The options in the format of an options file that are used by all configurations, before their own options
+    void setBaseOptions(std::string options);
+
+    // The options are in the format of an options file
+    void addConfiguration(std::string name, std::string options);
+
+    // The file is in the format of an options file, with one configuration per section starting with a line [NAME]
+    bool addConfigurationsFromFile(std::string fileName);
+
+    // Multi-tree with ESH and ECP cuts, single-tree if available and multi-tree without quadratic reformulations
+    void addDefaultConfigurations();
+
+    // The problem is read separately by every configuration, since it is reformulated based on their settings
+    bool setProblem(std::string fileName);
+
+    bool solveProblem();
+
+    size_t getNumberOfConfigurations() { return (configurations.size()); };
+
+    std::string getConfigurationName(size_t index) { return (configurations.at(index).name); };
+    Solver& getSolver(size_t index) { return (*configurations.at(index).solver); };
+
+    // The configuration that terminated the others, or otherwise the one with the best primal bound
+    size_t getBestConfiguration();
+    Solver& getBestSolver() { return (getSolver(getBestConfiguration())); };
+
+private:
+    struct Configuration
+    {
+        std::string name;
+        std::string options;
+
+        std::unique_ptr<Solver> solver;
+        std::thread::id threadID;
+
+        // The size of the reformulated problem, the cuts are only shared between problems of the same size
+        int numberOfVariables = 0;
+        int numberOfConstraints = 0;
+
+        // The number of shared solutions and cuts already exchanged with the other configurations
+        size_t numberOfImportedSolutions = 0;
+        size_t numberOfImportedCuts = 0;
+        size_t numberOfExportedHyperplanes = 0;
+    };
+
+    struct SharedCut
+    {
+        size_t configuration;
+        WarmStart::Cut cut;
+    };
+
+    // Called in the termination checks of a configuration
+    void exchange(size_t index);
+
+    bool isSolvedToCompletion(Solver& solver);
+
+    OutputPtr output;
+
+    std::string baseOptions;
+    std::vector<Configuration> configurations;
+
+    std::mutex exchangeMutex;
+    std::vector<std::pair<size_t, VectorDouble>> sharedSolutions;
+    std::vector<SharedCut> sharedCuts;
+
+    std::atomic<bool> isFinished = false;
+    std::atomic<int> finishedConfiguration = -1;
+};
+
+} // namespace SHOT
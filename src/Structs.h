@@ -12,10 +12,13 @@
 
 #include "Enums.h"
 
+#include <cstdint>
 #include <limits>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 // For DLL support in Windows
@@ -71,6 +74,11 @@ class Report;
 class TaskHandler;
 class EventHandler;
 class Timing;
+class Metrics;
+class MemoryMonitor;
+class DebugWriter;
+class CancellationToken;
+class TraceRecorder;
 class Iteration;
 class DualSolver;
 class PrimalSolver;
@@ -78,6 +86,8 @@ class PrimalSolver;
 class Constraint;
 class NumericConstraint;
 
+class StoredPoint;
+
 using ResultsPtr = std::shared_ptr<Results>;
 using SettingsPtr = std::shared_ptr<Settings>;
 using ModelPtr = std::shared_ptr<Model>;
@@ -90,6 +100,11 @@ using EventHandlerPtr = std::shared_ptr<EventHandler>;
 using ReportPtr = std::shared_ptr<Report>;
 using TaskHandlerPtr = std::shared_ptr<TaskHandler>;
 using TimingPtr = std::shared_ptr<Timing>;
+using MetricsPtr = std::shared_ptr<Metrics>;
+using MemoryMonitorPtr = std::shared_ptr<MemoryMonitor>;
+using DebugWriterPtr = std::shared_ptr<DebugWriter>;
+using CancellationTokenPtr = std::shared_ptr<CancellationToken>;
+using TraceRecorderPtr = std::shared_ptr<TraceRecorder>;
 using DualSolverPtr = std::shared_ptr<DualSolver>;
 using PrimalSolverPtr = std::shared_ptr<PrimalSolver>;
 using IterationPtr = std::shared_ptr<Iteration>;
@@ -97,6 +112,11 @@ using IterationPtr = std::shared_ptr<Iteration>;
 using ConstraintPtr = std::shared_ptr<Constraint>;
 using NumericConstraintPtr = std::shared_ptr<NumericConstraint>;
 
+using StoredPointPtr = std::shared_ptr<const StoredPoint>;
+
+// A handle to a registered timer, it can be used instead of the name to avoid the name lookup in the hot paths
+using TimerID = int;
+
 using PairInteger = std::pair<int, int>;
 using PairDouble = std::pair<double, double>;
 using PairString = std::pair<std::string, std::string>;
@@ -122,6 +142,53 @@ struct PairCoordinateValue
     double value;
 };
 
+// A set of points stored variable-major, i.e. the values of one variable in all points are contiguous, so that the
+// batched evaluation routines can loop over the points with unit stride. The single precision version is used for
+// screening evaluations, where twice as many points fit in a vector register.
+template <typename T> struct BasicPointBlock
+{
+    int numberOfPoints = 0;
+    int numberOfVariables = 0;
+    std::vector<T> values;
+
+    BasicPointBlock() = default;
+
+    BasicPointBlock(const std::vector<VectorDouble>& points) { assign(points); };
+
+    // Replaces the points, the storage is reused if the block is kept between calls
+    void assign(const std::vector<VectorDouble>& points)
+    {
+        numberOfPoints = points.size();
+        numberOfVariables = (numberOfPoints > 0) ? points[0].size() : 0;
+        values.resize(numberOfPoints * numberOfVariables);
+
+        for(int p = 0; p < numberOfPoints; p++)
+        {
+            for(int i = 0; i < numberOfVariables; i++)
+                values[i * numberOfPoints + p] = (T)points[p][i];
+        }
+    };
+
+    inline const T* getVariableValues(int variableIndex) const
+    {
+        return (values.data() + variableIndex * numberOfPoints);
+    };
+};
+
+using PointBlock = BasicPointBlock<double>;
+using PointBlockFloat = BasicPointBlock<float>;
+
+// A gradient in compressed form, values[k] is the partial derivative with respect to the variable with index
+// indexes[k]. The layout is given by the gradient sparsity pattern of the function, so the indexes are sorted and the
+// buffer can be reused between evaluations of the same function without reallocation.
+struct SparseGradient
+{
+    VectorInteger indexes;
+    VectorDouble values;
+
+    inline size_t size() const { return (indexes.size()); };
+};
+
 struct SolutionPoint
 {
     VectorDouble point;
@@ -129,13 +196,18 @@ struct SolutionPoint
     int iterFound;
     PairIndexValue maxDeviation;
     bool isRelaxedPoint = false;
-    double hashValue;
+    uint64_t hashValue;
 };
 
 struct InteriorPoint
 {
     VectorDouble point;
     PairIndexValue maxDevatingConstraint;
+
+    // Moving average of the fraction of the root search segments that lies outside the feasible region, used to
+    // select and replace the points in the adaptive strategy
+    double score = 0.0;
+    int iterationLastUsed = 0;
 };
 
 struct PrimalSolution
@@ -151,6 +223,7 @@ struct PrimalSolution
     double maxIntegerToleranceError; // The maximum integer error before rounding
     bool boundProjectionPerformed = false; // Has the variable bounds been corrected to either upper or lower bounds?
     bool integerRoundingPerformed = false; // Has the integers been rounded?
+    bool areLinearConstraintsTrusted = false; // Are the linear constraints fulfilled by the source, e.g. a MIP solver?
     bool displayed = false; // Has the primal solution been displayed on console?
 };
 
@@ -161,7 +234,7 @@ struct PrimalFixedNLPCandidate
     double objValue;
     int iterFound;
     PairIndexValue maxDevatingConstraint;
-    double discreteVariablePointHash;
+    uint64_t discreteVariablePointHash;
 };
 
 struct DualSolution
@@ -173,6 +246,66 @@ struct DualSolution
     bool displayed; // Has the dual solution been displayed on console?
 };
 
+// A compact record of a finished iteration, kept for all iterations also when the iteration itself is not retained
+struct IterationSummary
+{
+    int iterationNumber;
+    E_DualProblemClass dualProblemClass;
+    E_ProblemSolutionStatus solutionStatus;
+    double objectiveValue;
+    PairDouble objectiveBounds;
+    double maxDeviation;
+    int maxDeviationConstraint;
+    int numberOfSolutionPoints;
+    int numberOfHyperplanesAdded;
+    int totalNumberOfHyperplanes;
+    int numberOfExploredNodes;
+    double solutionTime;
+};
+
+// The progress of the solution process when it was last updated, i.e. when an iteration was created or the bounds
+// changed, which can be read from other threads without accessing the solutions
+struct SolverProgress
+{
+    double primalBound = SHOT_DBL_MAX;
+    double dualBound = SHOT_DBL_MIN;
+    double absoluteGap = SHOT_DBL_MAX;
+    double relativeGap = SHOT_DBL_MAX;
+    int iterationNumber = 0;
+    int numberOfPrimalSolutions = 0;
+    uint64_t primalSolutionsGeneration = 0;
+    double elapsedTime = 0.0; // The total solution time at the update
+    E_TerminationReason terminationReason = E_TerminationReason::None;
+};
+
+// A read-only view of the solution pool as it was when the view was taken, with the best solution first. The
+// solutions are shared with the pool instead of copied, and remain valid as long as the view is kept.
+class PrimalSolutionsView
+{
+public:
+    using Solutions = std::vector<std::shared_ptr<const PrimalSolution>>;
+
+    PrimalSolutionsView() = default;
+
+    PrimalSolutionsView(std::shared_ptr<const Solutions> solutions, uint64_t generation)
+        : solutions(std::move(solutions)), generation(generation)
+    {
+    }
+
+    inline size_t size() const { return (solutions->size()); }
+    inline bool empty() const { return (size() == 0); }
+
+    inline const PrimalSolution& operator[](size_t index) const { return (*(*solutions)[index]); }
+    inline const PrimalSolution& at(size_t index) const { return (*solutions->at(index)); }
+
+    // Increased every time the pool changes, so views with the same generation contain the same solutions
+    inline uint64_t getGeneration() const { return (generation); }
+
+private:
+    std::shared_ptr<const Solutions> solutions = std::make_shared<const Solutions>();
+    uint64_t generation = 0;
+};
+
 struct Hyperplane
 {
     NumericConstraintPtr sourceConstraint;
@@ -182,20 +315,21 @@ struct Hyperplane
     E_HyperplaneSource source;
     bool isObjectiveHyperplane = false;
     bool isSourceConvex = false;
-    double pointHash;
+    uint64_t pointHash;
+    std::optional<SparseGradient> sourceGradient; // If already calculated, e.g. together with other constraints
 };
 
 struct GeneratedHyperplane
 {
     NumericConstraintPtr sourceConstraint;
     int sourceConstraintIndex; // -1 if objective function
-    VectorDouble generatedPoint;
+    StoredPointPtr generatedPoint; // Only if saved, see DualSolver::hyperplanePointStore
     E_HyperplaneSource source = E_HyperplaneSource::None;
     bool isLazy = false;
     bool isRemoved = false;
     bool isSourceConvex = false;
     int iterationGenerated = -1;
-    double pointHash;
+    uint64_t pointHash;
 };
 
 struct IntegerCut
@@ -205,7 +339,29 @@ struct IntegerCut
     E_IntegerCutSource source = E_IntegerCutSource::None;
     bool areAllVariablesBinary = false;
     int iterationGenerated = -1;
-    double pointHash;
+    uint64_t pointHash;
+};
+
+// The function f(x) = exp(x), log(x), x^parameter, sin(x), cos(x) or tan(x) of the variable x
+struct UnivariateFunction
+{
+    E_UnivariateFunctionType type;
+    int variableIndex;
+    double parameter = 0.0;
+};
+
+// Changes to the data of a problem that do not change its structure, used when solving the problem again
+struct ProblemDataUpdate
+{
+    // The variable index and its new lower and upper bounds
+    std::vector<std::tuple<int, double, double>> variableBounds;
+
+    // The constraint index and its new lower and upper bounds, i.e., the values of the LHS and RHS as in the problem
+    // before its constraints were standardized
+    std::vector<std::tuple<int, double, double>> constraintBounds;
+
+    // The variable index and its new coefficient in the linear part of the objective function
+    std::vector<std::pair<int, double>> linearObjectiveCoefficients;
 };
 
 struct SolutionStatistics
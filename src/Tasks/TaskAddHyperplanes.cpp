@@ -15,11 +15,15 @@
 
 #include "../DualSolver.h"
 #include "../MIPSolver/IMIPSolver.h"
+#include "../Metrics.h"
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
 #include "../Timing.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace SHOT
 {
 
@@ -43,38 +47,52 @@ void TaskAddHyperplanes::run()
         || !currIter->MIPSolutionLimitUpdated || itersWithoutAddedHPs > 5)
     {
         int addedHyperplanes = 0;
+        int maxHyperplanes = env->settings->getSetting<int>("HyperplaneCuts.MaxPerIteration", "Dual");
 
-        for(auto k = env->dualSolver->hyperplaneWaitingList.size(); k > 0; k--)
-        {
-            if(addedHyperplanes >= env->settings->getSetting<int>("HyperplaneCuts.MaxPerIteration", "Dual"))
-                break;
+        // The waiting list is kept when reinitializing, so no hyperplanes can be discarded
+        if(env->settings->getSetting<bool>("HyperplaneCuts.Filter.Use", "Dual")
+            && !env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"))
+            filterHyperplanes(maxHyperplanes);
 
-            auto tmpItem = env->dualSolver->hyperplaneWaitingList.at(k - 1);
+        auto k = env->dualSolver->hyperplaneWaitingList.size();
 
-            bool cutAddedSuccessfully = false;
+        // The cuts are added in batches, so that the MIP model is only updated once unless some of the cuts fail
+        while(k > 0 && addedHyperplanes < maxHyperplanes)
+        {
+            std::vector<Hyperplane> hyperplanes;
 
-            if(tmpItem.source == E_HyperplaneSource::PrimalSolutionSearchInteriorObjective)
+            for(; k > 0 && addedHyperplanes + (int)hyperplanes.size() < maxHyperplanes; k--)
             {
-                cutAddedSuccessfully = env->dualSolver->MIPSolver->createInteriorHyperplane(tmpItem);
-            }
-            else
-            {
-                cutAddedSuccessfully = env->dualSolver->MIPSolver->createHyperplane(tmpItem);
+                auto& tmpItem = env->dualSolver->hyperplaneWaitingList.at(k - 1);
+
+                if(tmpItem.source != E_HyperplaneSource::PrimalSolutionSearchInteriorObjective)
+                {
+                    hyperplanes.push_back(tmpItem);
+                }
+                else if(env->dualSolver->MIPSolver->createInteriorHyperplane(tmpItem))
+                {
+                    addHyperplane(tmpItem);
+                    addedHyperplanes++;
+                }
             }
 
-            if(cutAddedSuccessfully)
-            {
-                env->dualSolver->addGeneratedHyperplane(tmpItem);
-                addedHyperplanes++;
-                this->itersWithoutAddedHPs = 0;
+            if(hyperplanes.size() == 0)
+                continue;
 
-                env->output->outputDebug(
-                    fmt::format("        Cut added successfully for constraint {}.", tmpItem.sourceConstraintIndex));
-            }
-            else
+            auto isCreated = env->dualSolver->MIPSolver->createHyperplanes(hyperplanes);
+
+            for(size_t i = 0; i < hyperplanes.size(); i++)
             {
-                env->output->outputDebug(fmt::format(
-                    "        Cut not added successfully for constraint {}.", tmpItem.sourceConstraintIndex));
+                if(isCreated[i])
+                {
+                    addHyperplane(hyperplanes[i]);
+                    addedHyperplanes++;
+                }
+                else
+                {
+                    env->output->outputDebug(fmt::format(
+                        "        Cut not added successfully for constraint {}.", hyperplanes[i].sourceConstraintIndex));
+                }
             }
         }
 
@@ -91,6 +109,159 @@ void TaskAddHyperplanes::run()
     env->timing->stopTimer("DualStrategy");
 }
 
+void TaskAddHyperplanes::addHyperplane(Hyperplane& hyperplane)
+{
+    env->dualSolver->addGeneratedHyperplane(hyperplane);
+    this->itersWithoutAddedHPs = 0;
+
+    env->output->outputDebug(
+        fmt::format("        Cut added successfully for constraint {}.", hyperplane.sourceConstraintIndex));
+}
+
+void TaskAddHyperplanes::filterHyperplanes(int maxHyperplanes)
+{
+    auto& waitingList = env->dualSolver->hyperplaneWaitingList;
+
+    if(waitingList.size() < 2 || env->results->getNumberOfIterations() < 2)
+        return;
+
+    auto prevIter = env->results->getPreviousIteration();
+
+    if(prevIter->solutionPoints.size() == 0)
+        return;
+
+    auto& point = prevIter->solutionPoints.at(0).point;
+    double maxParallelism = env->settings->getSetting<double>("HyperplaneCuts.Filter.MaxParallelism", "Dual");
+
+    struct FilteredHyperplane
+    {
+        size_t index;
+        std::map<int, double> terms;
+        double norm;
+        double efficacy;
+    };
+
+    std::vector<Hyperplane> keptHyperplanes;
+    std::vector<FilteredHyperplane> candidates;
+
+    for(size_t i = 0; i < waitingList.size(); i++)
+    {
+        auto& hyperplane = waitingList[i];
+
+        // Objective and interior hyperplanes are always added
+        if(hyperplane.isObjectiveHyperplane || !hyperplane.sourceConstraint
+            || hyperplane.source == E_HyperplaneSource::PrimalSolutionSearchInteriorObjective)
+        {
+            keptHyperplanes.push_back(hyperplane);
+            continue;
+        }
+
+        // The gradient is stored in the hyperplane so that it is not calculated again when the cut is created
+        if(!hyperplane.sourceGradient)
+        {
+            auto evaluations
+                = env->reformulatedProblem->getConstraintEvaluations(hyperplane.generatedPoint, hyperplane.pointHash);
+
+            SparseGradient gradient;
+            env->reformulatedProblem->calculateSparseGradient(
+                hyperplane.sourceConstraint.get(), hyperplane.generatedPoint, gradient, evaluations);
+
+            hyperplane.sourceGradient = gradient;
+        }
+
+        auto terms = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane);
+
+        if(!terms)
+        {
+            keptHyperplanes.push_back(hyperplane);
+            continue;
+        }
+
+        double norm = 0.0;
+        double value = terms->second;
+
+        for(auto& T : terms->first)
+        {
+            norm += T.second * T.second;
+
+            if(T.first < (int)point.size())
+                value += T.second * point[T.first];
+        }
+
+        norm = std::sqrt(norm);
+
+        if(norm == 0.0)
+        {
+            keptHyperplanes.push_back(hyperplane);
+            continue;
+        }
+
+        candidates.push_back({ i, terms->first, norm, value / norm });
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](const FilteredHyperplane& first, const FilteredHyperplane& second) {
+            return (first.efficacy > second.efficacy);
+        });
+
+    int maxSelected = std::max(0, maxHyperplanes - (int)keptHyperplanes.size());
+    std::vector<FilteredHyperplane*> selected;
+
+    for(auto& C : candidates)
+    {
+        if((int)selected.size() >= maxSelected)
+            break;
+
+        bool isParallel = false;
+
+        for(auto S : selected)
+        {
+            // The sparse dot product of the coefficients
+            double product = 0.0;
+            auto first = C.terms.begin();
+            auto second = S->terms.begin();
+
+            while(first != C.terms.end() && second != S->terms.end())
+            {
+                if(first->first < second->first)
+                    first++;
+                else if(second->first < first->first)
+                    second++;
+                else
+                {
+                    product += (first++)->second * (second++)->second;
+                }
+            }
+
+            if(product / (C.norm * S->norm) > maxParallelism)
+            {
+                isParallel = true;
+                break;
+            }
+        }
+
+        if(!isParallel)
+            selected.push_back(&C);
+    }
+
+    int numberOfDiscarded = (int)(candidates.size() - selected.size());
+
+    if(numberOfDiscarded == 0)
+        return;
+
+    // The hyperplanes are added from the end of the list, so the ones with the largest efficacy are put last
+    for(auto S = selected.rbegin(); S != selected.rend(); S++)
+        keptHyperplanes.push_back(waitingList[(*S)->index]);
+
+    waitingList = keptHyperplanes;
+
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::CutsFiltered, numberOfDiscarded);
+
+    env->output->outputDebug(
+        fmt::format("        Discarded {} almost parallel or low efficacy hyperplanes.", numberOfDiscarded));
+}
+
 std::string TaskAddHyperplanes::getType()
 {
     std::string type = typeid(this).name();
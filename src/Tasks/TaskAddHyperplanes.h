@@ -25,5 +25,11 @@ public:
 
 private:
     int itersWithoutAddedHPs;
+
+    void addHyperplane(Hyperplane& hyperplane);
+
+    // Keeps only the hyperplanes with the largest efficacy in the last MIP solution that are not almost parallel to
+    // another kept hyperplane
+    void filterHyperplanes(int maxHyperplanes);
 };
 } // namespace SHOT
\ No newline at end of file
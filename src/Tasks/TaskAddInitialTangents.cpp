@@ -0,0 +1,219 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskAddInitialTangents.h"
+
+#include "../DualSolver.h"
+#include "../Output.h"
+#include "../Settings.h"
+#include "../ThreadPlacement.h"
+#include "../Timing.h"
+#include "../Utilities.h"
+
+#include "../MIPSolver/IMIPSolver.h"
+
+#include "../Model/Constraints.h"
+#include "../Model/Problem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace SHOT
+{
+
+namespace
+{
+
+// Tangents over wider bounds than this are too far apart to be of use
+constexpr double maxBoundRange = 1e10;
+
+// Returns the only variable the constraint depends nonlinearly on, or nullptr if there are several
+VariablePtr getUnivariateVariable(const NonlinearConstraint& constraint)
+{
+    VariablePtr variable;
+
+    auto isSameVariable = [&](const VariablePtr& V) {
+        if(!variable)
+            variable = V;
+
+        return (variable == V);
+    };
+
+    for(auto& V : constraint.variablesInNonlinearExpression)
+    {
+        if(!isSameVariable(V))
+            return (nullptr);
+    }
+
+    for(auto& V : constraint.variablesInMonomialTerms)
+    {
+        if(!isSameVariable(V))
+            return (nullptr);
+    }
+
+    for(auto& V : constraint.variablesInSignomialTerms)
+    {
+        if(!isSameVariable(V))
+            return (nullptr);
+    }
+
+    for(auto& T : constraint.quadraticTerms)
+    {
+        if(!isSameVariable(T->firstVariable) || !isSameVariable(T->secondVariable))
+            return (nullptr);
+    }
+
+    return (variable);
+}
+
+} // namespace
+
+TaskAddInitialTangents::TaskAddInitialTangents(EnvironmentPtr envPtr) : TaskBase(envPtr) { }
+
+TaskAddInitialTangents::~TaskAddInitialTangents() = default;
+
+void TaskAddInitialTangents::run()
+{
+    if(isPerformed)
+        return;
+
+    isPerformed = true;
+
+    env->timing->startTimer("DualStrategy");
+
+    struct Tangent
+    {
+        NonlinearConstraintPtr constraint;
+        VariablePtr variable;
+        std::vector<Hyperplane> hyperplanes;
+    };
+
+    std::vector<Tangent> tangents;
+
+    for(auto& C : env->reformulatedProblem->nonlinearConstraints)
+    {
+        // Tangents are only valid outer approximations of convex constraints of the form f(x) <= b
+        if(C->properties.convexity != E_Convexity::Convex || C->valueLHS > SHOT_DBL_MIN)
+            continue;
+
+        auto variable = getUnivariateVariable(*C);
+
+        if(!variable || variable->lowerBound <= SHOT_DBL_MIN || variable->upperBound >= SHOT_DBL_MAX
+            || variable->upperBound - variable->lowerBound > maxBoundRange
+            || variable->upperBound - variable->lowerBound <= 0.0)
+            continue;
+
+        C->initializeGradientCalculation();
+        tangents.push_back({ C, variable, {} });
+    }
+
+    if(tangents.size() == 0)
+    {
+        env->timing->stopTimer("DualStrategy");
+        return;
+    }
+
+    int numberOfPoints = env->settings->getSetting<int>("HyperplaneCuts.InitialTangents.NumberOfPoints", "Dual");
+    auto numberOfVariables = env->reformulatedProblem->properties.numberOfVariables;
+
+    // Only the nonlinear variable affects the value and gradient of the nonlinear part, and the other terms are linear
+    auto createTangents = [&](Tangent& tangent) {
+        double lowerBound = tangent.variable->lowerBound;
+        double upperBound = tangent.variable->upperBound;
+
+        for(int k = 0; k < numberOfPoints; k++)
+        {
+            VectorDouble point(numberOfVariables, 0.0);
+            point[tangent.variable->index] = lowerBound + (k + 0.5) / numberOfPoints * (upperBound - lowerBound);
+
+            if(!std::isfinite(tangent.constraint->calculateFunctionValue(point)))
+                continue;
+
+            SparseGradient gradient;
+            tangent.constraint->calculateSparseGradient(point, gradient);
+
+            Hyperplane hyperplane;
+            hyperplane.sourceConstraint = tangent.constraint;
+            hyperplane.sourceConstraintIndex = tangent.constraint->index;
+            hyperplane.source = E_HyperplaneSource::InitialTangent;
+            hyperplane.isSourceConvex = true;
+            hyperplane.pointHash = Utilities::calculateHash(point);
+            hyperplane.generatedPoint = std::move(point);
+            hyperplane.sourceGradient = std::move(gradient);
+
+            tangent.hyperplanes.push_back(std::move(hyperplane));
+        }
+    };
+
+    int numberOfThreads = env->settings->getSetting<int>("HyperplaneCuts.InitialTangents.NumberOfThreads", "Dual");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    numberOfThreads = std::min(numberOfThreads, (int)tangents.size());
+
+    if(numberOfThreads <= 1)
+    {
+        for(auto& T : tangents)
+            createTangents(T);
+    }
+    else
+    {
+        // The constraint evaluations only use local and thread-local data
+        std::atomic<size_t> nextTangent(0);
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int i = 0; i < numberOfThreads; i++)
+        {
+            threads.emplace_back([&]() {
+                for(size_t k = nextTangent++; k < tangents.size(); k = nextTangent++)
+                    createTangents(tangents[k]);
+            });
+        }
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    std::vector<Hyperplane> hyperplanes;
+
+    for(auto& T : tangents)
+    {
+        for(auto& HP : T.hyperplanes)
+            hyperplanes.push_back(std::move(HP));
+    }
+
+    // All tangents are added at once and not limited by HyperplaneCuts.MaxPerIteration
+    int addedHyperplanes = 0;
+    auto isCreated = env->dualSolver->MIPSolver->createHyperplanes(hyperplanes);
+
+    for(size_t i = 0; i < hyperplanes.size(); i++)
+    {
+        if(!isCreated[i])
+            continue;
+
+        env->dualSolver->addGeneratedHyperplane(hyperplanes[i]);
+        addedHyperplanes++;
+    }
+
+    env->output->outputDebug("        Added {} initial tangents to {} univariate convex constraints.", addedHyperplanes,
+        tangents.size());
+
+    env->timing->stopTimer("DualStrategy");
+}
+
+std::string TaskAddInitialTangents::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
@@ -0,0 +1,32 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+namespace SHOT
+{
+
+// Adds tangents at evenly spaced points over the variable bounds for the convex nonlinear constraints that only depend
+// nonlinearly on one variable, e.g. the terms of a convex sum partitioned with auxiliary variables. This gives a good
+// initial outer approximation of separable problems before the first dual problem is solved.
+class TaskAddInitialTangents : public TaskBase
+{
+public:
+    TaskAddInitialTangents(EnvironmentPtr envPtr);
+    ~TaskAddInitialTangents() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    bool isPerformed = false;
+};
+} // namespace SHOT
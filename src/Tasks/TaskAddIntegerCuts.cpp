@@ -49,6 +49,9 @@ void TaskAddIntegerCuts::run()
     {
         int numAdded = 0;
 
+        if(env->settings->getSetting<bool>("HyperplaneCuts.CombineIntegerCuts", "Dual"))
+            env->dualSolver->combineIntegerCuts();
+
         for(auto& IC : env->dualSolver->integerCutWaitingList)
         {
             if(env->dualSolver->MIPSolver->createIntegerCut(IC))
@@ -9,19 +9,39 @@
 */
 
 #include "TaskAddPrimalReductionCut.h"
+#include "TaskCreateDualProblem.h"
 
+#include "../CancellationToken.h"
 #include "../DualSolver.h"
 #include "../Enums.h"
+#include "../Output.h"
+#include "../PrimalSolver.h"
 #include "../Report.h"
 #include "../Results.h"
 #include "../Settings.h"
 #include "../TaskHandler.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 
 #include "../MIPSolver/IMIPSolver.h"
 
 #include "../Model/Problem.h"
 
+#ifdef HAS_CPLEX
+#include "../MIPSolver/MIPSolverCplex.h"
+#endif
+
+#ifdef HAS_GUROBI
+#include "../MIPSolver/MIPSolverGurobi.h"
+#endif
+
+#ifdef HAS_CBC
+#include "../MIPSolver/MIPSolverCbc.h"
+#endif
+
+#include <cmath>
+#include <thread>
+
 namespace SHOT
 {
 
@@ -92,6 +112,30 @@ void TaskAddPrimalReductionCut::run()
             env->results->currentDualBound = SHOT_DBL_MAX;
         }
     }
+    else if(env->settings->getSetting<bool>("ReductionCut.Probing.Use", "Dual"))
+    {
+        double reductionFactor = env->settings->getSetting<double>("ReductionCut.ReductionFactor", "Dual");
+        int numberOfProbes = env->settings->getSetting<int>("ReductionCut.Probing.NumberOfProbes", "Dual");
+        bool isMinimize = env->reformulatedProblem->objectiveFunction->properties.isMinimize;
+
+        // The reduction factor is doubled for each probe, so the cutoffs are increasingly tighter
+        VectorDouble cutOffs;
+
+        for(int k = 0; k < numberOfProbes; k++)
+        {
+            double factor = std::min(1.0, reductionFactor * std::pow(2.0, k));
+            double reduction = factor * std::abs(env->dualSolver->cutOffToUse);
+
+            cutOffs.push_back(
+                isMinimize ? env->dualSolver->cutOffToUse - reduction : env->dualSolver->cutOffToUse + reduction);
+        }
+
+        // If no probe has a solution within the time limit, the smallest reduction is used as without probing
+        auto probe = probeCutOffs(cutOffs);
+        env->dualSolver->cutOffToUse = cutOffs[probe.value_or(0)];
+
+        env->results->currentDualBound = isMinimize ? SHOT_DBL_MIN : SHOT_DBL_MAX;
+    }
     else
     {
         double reductionFactor = env->settings->getSetting<double>("ReductionCut.ReductionFactor", "Dual");
@@ -125,6 +169,177 @@ void TaskAddPrimalReductionCut::run()
     env->tasks->setNextTask(taskIDIfTrue);
 }
 
+std::optional<size_t> TaskAddPrimalReductionCut::probeCutOffs(const VectorDouble& cutOffs)
+{
+    double timeLimit = std::min({ env->settings->getSetting<double>("ReductionCut.Probing.TimeLimit", "Dual"),
+        env->settings->getSetting<double>("TimeLimit", "Termination") - env->timing->getElapsedTime("Total"),
+        env->cancellationToken->getRemainingTime() });
+
+    if(timeLimit <= 0)
+        return (std::nullopt);
+
+    env->output->outputDebug(fmt::format("        Probing {} reduction cutoffs.", cutOffs.size()));
+
+    auto cuts = createProbeCuts();
+
+    int numberOfThreads = env->settings->getSetting<int>("ReductionCut.Probing.NumberOfThreads", "Dual");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    // Cbc cannot solve several problems at the same time
+    if(static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual")) == ES_MIPSolver::Cbc)
+        numberOfThreads = 1;
+
+    numberOfThreads = std::max(1, std::min(numberOfThreads, (int)cutOffs.size()));
+
+    std::vector<std::vector<SolutionPoint>> solutions(cutOffs.size());
+
+    ThreadPlacement::WorkQueue probeQueue(env->settings, cutOffs.size(), numberOfThreads);
+
+    // The solutions of the probes should not be streamed to the primal solver from the MIP solver callbacks
+    bool isSolutionStreamingUsed = env->dualSolver->isSolutionStreamingUsed;
+    env->dualSolver->isSolutionStreamingUsed = false;
+
+    // Each probe is a separate copy of the dual problem, which is only solved until it has a solution
+    auto solveProbes = [&](int threadNumber) {
+        for(size_t k; probeQueue.getNextItem(threadNumber, k);)
+        {
+            if(env->cancellationToken->isCancelled())
+                return;
+
+            auto solver = createProbeSolver(cuts);
+
+            if(!solver)
+                return;
+
+            solver->setCutOffAsConstraint(cutOffs[k]);
+            solver->setSolutionLimit(1);
+            solver->setTimeLimit(timeLimit);
+
+            auto status = solver->solveProblem();
+
+            if(status != E_ProblemSolutionStatus::Infeasible && status != E_ProblemSolutionStatus::Error)
+                solutions[k] = solver->getAllVariableSolutions();
+        }
+    };
+
+    if(numberOfThreads == 1)
+    {
+        solveProbes(0);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+        {
+            threads.emplace_back([&, t]() {
+                ThreadPlacement::pinThread(env->settings, t);
+                solveProbes(t);
+            });
+        }
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    env->dualSolver->isSolutionStreamingUsed = isSolutionStreamingUsed;
+
+    std::optional<size_t> tightestProbe;
+
+    for(size_t k = 0; k < cutOffs.size(); k++)
+    {
+        if(solutions[k].empty())
+            continue;
+
+        env->primalSolver->addPrimalSolutionCandidates(solutions[k], E_PrimalSolutionSource::MIPSolutionPool);
+        tightestProbe = k;
+    }
+
+    if(tightestProbe)
+    {
+        env->output->outputDebug(fmt::format("        Tightest reduction cutoff with a solution: {} (probe {} of {}).",
+            cutOffs[*tightestProbe], *tightestProbe + 1, cutOffs.size()));
+    }
+    else
+    {
+        env->output->outputDebug("        No reduction cutoff probe has a solution.");
+    }
+
+    return (tightestProbe);
+}
+
+LinearConstraintBlock TaskAddPrimalReductionCut::createProbeCuts()
+{
+    LinearConstraintBlock cuts;
+
+    for(auto& HP : env->dualSolver->generatedHyperplanes)
+    {
+        if(HP.isRemoved || !HP.generatedPoint)
+            continue;
+
+        Hyperplane hyperplane;
+        hyperplane.source = HP.source;
+        hyperplane.sourceConstraint = HP.sourceConstraint;
+        hyperplane.sourceConstraintIndex = HP.sourceConstraintIndex;
+        hyperplane.generatedPoint = HP.generatedPoint->getValues();
+        hyperplane.isObjectiveHyperplane = (HP.sourceConstraintIndex == -1);
+        hyperplane.isSourceConvex = HP.isSourceConvex;
+        hyperplane.pointHash = HP.pointHash;
+
+        if(hyperplane.isObjectiveHyperplane)
+        {
+            hyperplane.objectiveFunctionValue
+                = env->reformulatedProblem->objectiveFunction->calculateValue(hyperplane.generatedPoint);
+        }
+
+        if(auto terms = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane))
+            cuts.add(terms->first, terms->second, fmt::format("probe_hp_{}", cuts.size()), false);
+    }
+
+    for(auto& IC : env->dualSolver->generatedIntegerCuts)
+    {
+        if(auto terms = env->dualSolver->getBinaryIntegerCutTerms(IC))
+            cuts.add(terms->first, terms->second, fmt::format("probe_ic_{}", cuts.size()), false);
+    }
+
+    return (cuts);
+}
+
+MIPSolverPtr TaskAddPrimalReductionCut::createProbeSolver(const LinearConstraintBlock& cuts)
+{
+    MIPSolverPtr solver;
+
+    [[maybe_unused]] auto solverType = static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual"));
+
+#ifdef HAS_CPLEX
+    if(solverType == ES_MIPSolver::Cplex)
+        solver = std::make_shared<MIPSolverCplex>(env);
+#endif
+
+#ifdef HAS_GUROBI
+    if(solverType == ES_MIPSolver::Gurobi)
+        solver = std::make_shared<MIPSolverGurobi>(env);
+#endif
+
+#ifdef HAS_CBC
+    if(!solver)
+        solver = std::make_shared<MIPSolverCbc>(env);
+#endif
+
+    if(!solver || !solver->initializeProblem()
+        || !TaskCreateDualProblem::createProblem(env, solver, env->reformulatedProblem))
+        return (nullptr);
+
+    solver->initializeSolverSettings();
+
+    if(cuts.size() > 0 && solver->addLinearConstraints(cuts) < 0)
+        return (nullptr);
+
+    return (solver);
+}
+
 std::string TaskAddPrimalReductionCut::getType()
 {
     std::string type = typeid(this).name();
@@ -11,6 +11,10 @@
 #pragma once
 #include "TaskBase.h"
 
+#include "../MIPSolver/IMIPSolver.h"
+
+#include <optional>
+
 namespace SHOT
 {
 class TaskAddPrimalReductionCut : public TaskBase
@@ -27,5 +31,14 @@ private:
     std::string taskIDIfTrue;
     std::string taskIDIfFalse;
     int totalReductionCutUpdates = 0;
+
+    // Solves copies of the dual problem with the cutoffs in parallel, and returns the index of the tightest cutoff for
+    // which a copy has a solution, or empty if no copy has one within the time limit
+    std::optional<size_t> probeCutOffs(const VectorDouble& cutOffs);
+
+    // The hyperplanes and binary integer cuts in the dual problem, created again from the generated cuts
+    LinearConstraintBlock createProbeCuts();
+
+    MIPSolverPtr createProbeSolver(const LinearConstraintBlock& cuts);
 };
 } // namespace SHOT
\ No newline at end of file
@@ -26,6 +26,10 @@ void TaskBase::initialize() {}
 
 void TaskBase::run() {}
 
+std::vector<E_TaskEnvironmentState> TaskBase::getReadStates() { return { E_TaskEnvironmentState::All }; }
+
+std::vector<E_TaskEnvironmentState> TaskBase::getModifiedStates() { return { E_TaskEnvironmentState::All }; }
+
 std::string TaskBase::getType()
 {
     std::string type = typeid(this).name();
@@ -13,6 +13,7 @@
 #include "../Environment.h"
 
 #include <string>
+#include <vector>
 
 namespace SHOT
 {
@@ -30,6 +31,11 @@ public:
 
     virtual void run();
 
+    // The parts of the environment that the task reads and modifies, used by TaskParallel to find the tasks that can
+    // be run at the same time. By default a task may use everything, and is never run together with other tasks.
+    virtual std::vector<E_TaskEnvironmentState> getReadStates();
+    virtual std::vector<E_TaskEnvironmentState> getModifiedStates();
+
     TaskBase(EnvironmentPtr envPtr);
     virtual ~TaskBase() = default;
 
@@ -14,6 +14,7 @@
 #include "../Results.h"
 #include "../Settings.h"
 #include "../TaskHandler.h"
+#include "../Utilities.h"
 
 namespace SHOT
 {
@@ -39,22 +40,21 @@ void TaskCalculateSolutionChangeNorm::run()
         return;
     }
 
-    auto currIterSol = env->results->getCurrentIteration()->hyperplanePoints.at(0);
+    auto& currIterSol = env->results->getCurrentIteration()->hyperplanePoints.at(0);
 
-    for(int i = env->results->getNumberOfIterations() - 2; i >= 1; i--)
+    // Only the retained iterations with point data can be used, and the first iteration is not used
+    for(int i = env->results->getNumberOfIterations() - 1; i >= 2; i--)
     {
-        if(env->results->getNumberOfIterations() > 0 && !env->results->iterations.at(i)->isMIP())
-        {
-            auto prevIterSol = env->results->iterations.at(i)->hyperplanePoints.at(0);
+        auto prevIter = env->results->getIteration(i);
 
-            double distance = 0;
+        if(!prevIter)
+            break;
 
-            for(size_t j = 0; j < currIterSol.size(); j++)
-            {
-                distance = distance + (currIterSol.at(j) - prevIterSol.at(j)) * (currIterSol.at(j) - prevIterSol.at(j));
-            }
+        if(!prevIter->isMIP() && prevIter->hyperplanePoints.size() > 0)
+        {
+            auto& prevIterSol = prevIter->hyperplanePoints.at(0);
 
-            distance = sqrt(distance + 0.001);
+            double distance = sqrt(Utilities::L2NormSquared(currIterSol, prevIterSol) + 0.001);
 
             if(std::isnan(distance)) // Checks for INF, do not remove!
             {
@@ -70,6 +70,16 @@ void TaskCalculateSolutionChangeNorm::run()
     }
 }
 
+std::vector<E_TaskEnvironmentState> TaskCalculateSolutionChangeNorm::getReadStates()
+{
+    return { E_TaskEnvironmentState::Results };
+}
+
+std::vector<E_TaskEnvironmentState> TaskCalculateSolutionChangeNorm::getModifiedStates()
+{
+    return { E_TaskEnvironmentState::Results };
+}
+
 std::string TaskCalculateSolutionChangeNorm::getType()
 {
     std::string type = typeid(this).name();
@@ -23,6 +23,9 @@ public:
 
     std::string getType() override;
 
+    std::vector<E_TaskEnvironmentState> getReadStates() override;
+    std::vector<E_TaskEnvironmentState> getModifiedStates() override;
+
 private:
 };
 } // namespace SHOT
\ No newline at end of file
@@ -95,6 +95,16 @@ void TaskCheckConstraintTolerance::run()
     return;
 }
 
+std::vector<E_TaskEnvironmentState> TaskCheckConstraintTolerance::getReadStates()
+{
+    return { E_TaskEnvironmentState::Problem, E_TaskEnvironmentState::Results };
+}
+
+std::vector<E_TaskEnvironmentState> TaskCheckConstraintTolerance::getModifiedStates()
+{
+    return { E_TaskEnvironmentState::Results, E_TaskEnvironmentState::TaskHandler };
+}
+
 std::string TaskCheckConstraintTolerance::getType()
 {
     std::string type = typeid(this).name();
@@ -10,6 +10,7 @@
 
 #include "TaskCheckTimeLimit.h"
 
+#include "../CancellationToken.h"
 #include "../Results.h"
 #include "../Settings.h"
 #include "../TaskHandler.h"
@@ -29,7 +30,9 @@ void TaskCheckTimeLimit::run()
 {
     auto currIter = env->results->getCurrentIteration();
 
-    if(env->timing->getElapsedTime("Total") >= env->settings->getSetting<double>("TimeLimit", "Termination"))
+    if(env->timing->getElapsedTime("Total") >= env->settings->getSetting<double>("TimeLimit", "Termination")
+        || (env->cancellationToken->isCancelled()
+            && env->cancellationToken->getReason() == E_TerminationReason::TimeLimit))
     {
         env->results->terminationReason = E_TerminationReason::TimeLimit;
         env->tasks->setNextTask(taskIDIfTrue);
@@ -10,6 +10,7 @@
 
 #include "TaskCheckUserTermination.h"
 
+#include "../CancellationToken.h"
 #include "../EventHandler.h"
 #include "../Results.h"
 #include "../TaskHandler.h"
@@ -28,12 +29,24 @@ void TaskCheckUserTermination::run()
 {
     env->events->notify(E_EventType::UserTerminationCheck);
 
+    bool isCancelled = env->cancellationToken->isCancelled();
+
     if(env->tasks->isTerminated()
-        || env->results->getCurrentIteration()->solutionStatus == E_ProblemSolutionStatus::Abort)
+        || env->results->getCurrentIteration()->solutionStatus == E_ProblemSolutionStatus::Abort || isCancelled)
     {
-        env->results->terminationReason = E_TerminationReason::UserAbort;
+        // The MIP solver is also aborted when the token is cancelled at the hard time limit
+        if(isCancelled && env->cancellationToken->getReason() == E_TerminationReason::TimeLimit)
+        {
+            env->results->terminationReason = E_TerminationReason::TimeLimit;
+            env->results->terminationReasonDescription = "Terminated since time limit was reached.";
+        }
+        else
+        {
+            env->results->terminationReason = E_TerminationReason::UserAbort;
+            env->results->terminationReasonDescription = "Terminated by user.";
+        }
+
         env->tasks->setNextTask(taskIDIfTrue);
-        env->results->terminationReasonDescription = "Terminated by user.";
     }
 }
 
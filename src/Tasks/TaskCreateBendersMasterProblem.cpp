@@ -0,0 +1,127 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskCreateBendersMasterProblem.h"
+
+#include "../DualSolver.h"
+#include "../Output.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+#include "../MIPSolver/IMIPSolver.h"
+
+#include "../Model/Problem.h"
+
+namespace SHOT
+{
+
+TaskCreateBendersMasterProblem::TaskCreateBendersMasterProblem(
+    EnvironmentPtr envPtr, BlockDecompositionPtr decomposition)
+    : TaskBase(envPtr), decomposition(decomposition)
+{
+    env->timing->startTimer("DualStrategy");
+
+    env->output->outputDebug(" Creating Benders master problem");
+
+    auto sourceProblem = decomposition->getSourceProblem();
+    auto& destination = env->dualSolver->MIPSolver;
+
+    // The variables have the same indexes as in the source problem, so that the solutions can be used directly
+    bool problemInitialized = true;
+
+    for(auto& V : sourceProblem->allVariables)
+    {
+        problemInitialized = problemInitialized
+            && destination->addVariable(
+                V->name.c_str(), V->properties.type, V->lowerBound, V->upperBound, V->semiBound);
+    }
+
+    for(size_t k = 0; k < decomposition->blocks.size(); k++)
+    {
+        auto& block = decomposition->blocks[k];
+        block.masterVariableIndex = sourceProblem->properties.numberOfVariables + k;
+
+        problemInitialized = problemInitialized
+            && destination->addVariable(fmt::format("shot_benders_eta_{}", k), E_VariableType::Real,
+                block.objectiveLowerBound, SHOT_DBL_MAX, 0.0);
+    }
+
+    problemInitialized = problemInitialized && destination->initializeObjective();
+
+    for(auto& [index, coefficient] : decomposition->masterLinearTerms)
+        problemInitialized = problemInitialized && destination->addLinearTermToObjective(coefficient, index);
+
+    for(auto& B : decomposition->blocks)
+    {
+        problemInitialized = problemInitialized
+            && destination->addLinearTermToObjective(decomposition->objectiveSign, B.masterVariableIndex);
+    }
+
+    if(decomposition->masterQuadraticTerms.size() > 0)
+    {
+        VectorDouble coefficients;
+        VectorInteger firstVariableIndexes, secondVariableIndexes;
+
+        for(auto& [indexes, coefficient] : decomposition->masterQuadraticTerms)
+        {
+            coefficients.push_back(coefficient);
+            firstVariableIndexes.push_back(indexes.first);
+            secondVariableIndexes.push_back(indexes.second);
+        }
+
+        problemInitialized = problemInitialized
+            && destination->addQuadraticTermsToObjective(coefficients, firstVariableIndexes, secondVariableIndexes);
+    }
+
+    problemInitialized = problemInitialized
+        && destination->finalizeObjective(decomposition->isMinimize, decomposition->masterConstant);
+
+    for(auto& C : decomposition->masterConstraints)
+    {
+        problemInitialized = problemInitialized && destination->initializeConstraint();
+
+        for(auto& T : C->linearTerms)
+        {
+            problemInitialized
+                = problemInitialized && destination->addLinearTermToConstraint(T->coefficient, T->variable->index);
+        }
+
+        problemInitialized
+            = problemInitialized && destination->finalizeConstraint(C->name, C->valueLHS, C->valueRHS, C->constant);
+    }
+
+    if(!problemInitialized)
+        throw Exception("Could not create the Benders master problem in the MIP solver.");
+
+    destination->finalizeProblem();
+    destination->initializeSolverSettings();
+
+    if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
+    {
+        destination->writeProblemToFile(
+            env->settings->getSetting<std::string>("Debug.Path", "Output") + "/dualiter0_problem.lp");
+    }
+
+    env->output->outputDebug(fmt::format(" Benders master problem created with {} block variables and {} constraints",
+        decomposition->blocks.size(), decomposition->masterConstraints.size()));
+
+    env->timing->stopTimer("DualStrategy");
+}
+
+TaskCreateBendersMasterProblem::~TaskCreateBendersMasterProblem() = default;
+
+void TaskCreateBendersMasterProblem::run() { }
+
+std::string TaskCreateBendersMasterProblem::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
@@ -0,0 +1,33 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include "../Model/BlockDecomposition.h"
+
+namespace SHOT
+{
+// Creates the master problem of the decomposition in the MIP solver of the dual solver. It has the variables of the
+// source problem, where only the discrete ones are constrained, and a variable for the objective value of each block,
+// bounded below by the lower bound of the block. The lower bounds are calculated when the subproblem task is created.
+class TaskCreateBendersMasterProblem : public TaskBase
+{
+public:
+    TaskCreateBendersMasterProblem(EnvironmentPtr envPtr, BlockDecompositionPtr decomposition);
+    ~TaskCreateBendersMasterProblem() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    BlockDecompositionPtr decomposition;
+};
+} // namespace SHOT
@@ -16,20 +16,51 @@
 #include "../Timing.h"
 
 #include "../MIPSolver/IMIPSolver.h"
+#include "../Model/Symmetry.h"
 
 namespace SHOT
 {
 
+namespace
+{
+
+// The terms in the form used for adding them to the MIP solver at once
+void getQuadraticTerms(const QuadraticTerms& terms, VectorDouble& coefficients, VectorInteger& firstVariableIndexes,
+    VectorInteger& secondVariableIndexes)
+{
+    coefficients.reserve(terms.size());
+    firstVariableIndexes.reserve(terms.size());
+    secondVariableIndexes.reserve(terms.size());
+
+    for(auto& T : terms)
+    {
+        coefficients.push_back(T->coefficient);
+        firstVariableIndexes.push_back(T->firstVariable->index);
+        secondVariableIndexes.push_back(T->secondVariable->index);
+    }
+}
+
+} // namespace
+
 TaskCreateDualProblem::TaskCreateDualProblem(EnvironmentPtr envPtr) : TaskBase(envPtr)
 {
     env->timing->startTimer("DualStrategy");
 
     env->output->outputDebug(" Creating dual problem");
 
-    createProblem(env->dualSolver->MIPSolver, env->reformulatedProblem);
+    if(env->settings->getSetting<bool>("MIP.SymmetryBreaking.Use", "Dual"))
+    {
+        SymmetryDetection symmetryDetection(env, env->reformulatedProblem);
+        symmetricVariableGroups = symmetryDetection.findInterchangeableVariables();
+    }
+
+    createProblem(env, env->dualSolver->MIPSolver, env->reformulatedProblem, symmetricVariableGroups);
 
     env->dualSolver->MIPSolver->finalizeProblem();
 
+    if(env->settings->getSetting<bool>("TreeStrategy.Multi.Reinitialize", "Dual"))
+        env->dualSolver->MIPSolver->saveBaseProblem();
+
     env->dualSolver->MIPSolver->initializeSolverSettings();
 
     if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
@@ -51,9 +82,17 @@ void TaskCreateDualProblem::run()
     {
         env->timing->startTimer("DualStrategy");
 
-        env->output->outputDebug("        Recreating dual problem");
+        // The hyperplanes are kept in the waiting list and are added again to the restored problem in one call
+        if(env->dualSolver->MIPSolver->restoreBaseProblem())
+        {
+            env->output->outputDebug("        Restoring dual problem");
+        }
+        else
+        {
+            env->output->outputDebug("        Recreating dual problem");
 
-        createProblem(env->dualSolver->MIPSolver, env->reformulatedProblem);
+            createProblem(env, env->dualSolver->MIPSolver, env->reformulatedProblem, symmetricVariableGroups);
+        }
 
         env->dualSolver->MIPSolver->finalizeProblem();
 
@@ -65,12 +104,13 @@ void TaskCreateDualProblem::run()
                 env->settings->getSetting<std::string>("Debug.Path", "Output") + "/lp0.lp");
         }
 
-        env->output->outputDebug("        Dual problem recreated");
+        env->output->outputDebug("        Dual problem reinitialized");
         env->timing->stopTimer("DualStrategy");
     }
 }
 
-bool TaskCreateDualProblem::createProblem(MIPSolverPtr destination, ProblemPtr sourceProblem)
+bool TaskCreateDualProblem::createProblem(EnvironmentPtr env, MIPSolverPtr destination, ProblemPtr sourceProblem,
+    const std::vector<VectorInteger>& symmetricVariableGroups)
 {
     // Now creating the variables
 
@@ -140,13 +180,15 @@ bool TaskCreateDualProblem::createProblem(MIPSolverPtr destination, ProblemPtr s
         // Quadratic terms
         if(sourceProblem->objectiveFunction->properties.hasQuadraticTerms)
         {
-            for(auto& T :
-                std::dynamic_pointer_cast<QuadraticObjectiveFunction>(sourceProblem->objectiveFunction)->quadraticTerms)
-            {
-                objectiveInitialized = objectiveInitialized
-                    && destination->addQuadraticTermToObjective(
-                        T->coefficient, T->firstVariable->index, T->secondVariable->index);
-            }
+            VectorDouble coefficients;
+            VectorInteger firstVariableIndexes, secondVariableIndexes;
+
+            getQuadraticTerms(
+                std::dynamic_pointer_cast<QuadraticObjectiveFunction>(sourceProblem->objectiveFunction)->quadraticTerms,
+                coefficients, firstVariableIndexes, secondVariableIndexes);
+
+            objectiveInitialized = objectiveInitialized
+                && destination->addQuadraticTermsToObjective(coefficients, firstVariableIndexes, secondVariableIndexes);
         }
 
         objectiveInitialized = objectiveInitialized
@@ -193,18 +235,64 @@ bool TaskCreateDualProblem::createProblem(MIPSolverPtr destination, ProblemPtr s
 
         if(C->properties.hasQuadraticTerms)
         {
-            for(auto& T : C->quadraticTerms)
-            {
-                constraintsInitialized = constraintsInitialized
-                    && destination->addQuadraticTermToConstraint(
-                        T->coefficient, T->firstVariable->index, T->secondVariable->index);
-            }
+            VectorDouble coefficients;
+            VectorInteger firstVariableIndexes, secondVariableIndexes;
+
+            getQuadraticTerms(C->quadraticTerms, coefficients, firstVariableIndexes, secondVariableIndexes);
+
+            constraintsInitialized = constraintsInitialized
+                && destination->addQuadraticTermsToConstraint(
+                    coefficients, firstVariableIndexes, secondVariableIndexes);
         }
 
         constraintsInitialized
             = constraintsInitialized && destination->finalizeConstraint(C->name, C->valueLHS, C->valueRHS, C->constant);
     }
 
+    // The auxiliary variable s in f(x) - s <= 0 can be fixed to s = f(x), since it replaces f(x) in a partitioned sum.
+    // The cuts for these constraints are still created if the MIP solutions violate them.
+    int numberOfFunctionConstraints = 0;
+
+    for(auto& C : sourceProblem->nonlinearConstraints)
+    {
+        if(!C->properties.isFunctionConstraint || C->linearTerms.size() != 1)
+            continue;
+
+        if(auto function = getUnivariateFunction(C->nonlinearExpression);
+            function && destination->addFunctionConstraint(*function, C->linearTerms[0]->variable->index, C->name))
+            numberOfFunctionConstraints++;
+    }
+
+    if(numberOfFunctionConstraints > 0)
+    {
+        env->output->outputDebug(fmt::format(
+            "         Added {} function constraints to the dual problem.", numberOfFunctionConstraints));
+    }
+
+    // Some optimal solution has nonincreasing values of the variables in each group, since the variables can be
+    // permuted freely within a group
+    int numberOfSymmetryConstraints = 0;
+
+    for(auto& G : symmetricVariableGroups)
+    {
+        for(size_t k = 0; k + 1 < G.size(); k++)
+        {
+            constraintsInitialized = constraintsInitialized && destination->initializeConstraint()
+                && destination->addLinearTermToConstraint(1.0, G[k])
+                && destination->addLinearTermToConstraint(-1.0, G[k + 1])
+                && destination->finalizeConstraint(
+                    fmt::format("shot_symmetry_{}", numberOfSymmetryConstraints), 0.0, SHOT_DBL_MAX, 0.0);
+
+            numberOfSymmetryConstraints++;
+        }
+    }
+
+    if(numberOfSymmetryConstraints > 0)
+    {
+        env->output->outputDebug(fmt::format(
+            "         Added {} symmetry-breaking constraints to the dual problem.", numberOfSymmetryConstraints));
+    }
+
     if(!constraintsInitialized)
         return false;
 
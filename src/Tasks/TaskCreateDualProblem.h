@@ -26,7 +26,13 @@ public:
     void run() override;
     std::string getType() override;
 
+    // Also used for the separate copies of the dual problem, e.g. in the probing for the primal reduction cut
+    static bool createProblem(EnvironmentPtr env, MIPSolverPtr destinationProblem, ProblemPtr sourceProblem,
+        const std::vector<VectorInteger>& symmetricVariableGroups = {});
+
 private:
-    bool createProblem(MIPSolverPtr destinationProblem, ProblemPtr sourceProblem);
+
+    // The groups of interchangeable variables in the reformulated problem, found once when the task is created
+    std::vector<VectorInteger> symmetricVariableGroups;
 };
 } // namespace SHOT
\ No newline at end of file
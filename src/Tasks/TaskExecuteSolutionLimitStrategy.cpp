@@ -25,6 +25,7 @@
 #include "../MIPSolver/MIPSolutionLimitStrategyUnlimited.h"
 #include "../MIPSolver/MIPSolutionLimitStrategyIncrease.h"
 #include "../MIPSolver/MIPSolutionLimitStrategyAdaptive.h"
+#include "../MIPSolver/MIPSolutionLimitStrategyTimeProfile.h"
 
 namespace SHOT
 {
@@ -36,7 +37,25 @@ TaskExecuteSolutionLimitStrategy::TaskExecuteSolutionLimitStrategy(EnvironmentPt
     isInitialized = false;
     temporaryOptLimitUsed = false;
 
-    solutionLimitStrategy = std::make_unique<MIPSolutionLimitStrategyIncrease>(env);
+    auto strategy = static_cast<ES_MIPSolutionLimitStrategy>(
+        env->settings->getSetting<int>("MIP.SolutionLimit.Strategy", "Dual"));
+
+    switch(strategy)
+    {
+    case ES_MIPSolutionLimitStrategy::Adaptive:
+        solutionLimitStrategy = std::make_unique<MIPSolutionLimitStrategyAdaptive>(env);
+        break;
+    case ES_MIPSolutionLimitStrategy::Unlimited:
+        solutionLimitStrategy = std::make_unique<MIPSolutionLimitStrategyUnlimited>(env);
+        break;
+    case ES_MIPSolutionLimitStrategy::TimeProfile:
+        solutionLimitStrategy = std::make_unique<MIPSolutionLimitStrategyTimeProfile>(env);
+        break;
+    default:
+        solutionLimitStrategy = std::make_unique<MIPSolutionLimitStrategyIncrease>(env);
+        break;
+    }
+
     auto initLim = solutionLimitStrategy->getInitialLimit();
     env->dualSolver->MIPSolver->setSolutionLimit(initLim);
     previousSolLimit = initLim;
@@ -57,6 +76,9 @@ void TaskExecuteSolutionLimitStrategy::run()
     auto currIter = env->results->getCurrentIteration();
     auto prevIter = env->results->getPreviousIteration();
 
+    // The forced optimal iterations are solved without a time limit of their own
+    env->dualSolver->MIPIterationTimeLimit = SHOT_DBL_MAX;
+
     if(env->reformulatedProblem->properties.convexity != E_ProblemConvexity::Convex)
     {
         if(temporaryOptLimitUsed)
@@ -112,6 +134,7 @@ void TaskExecuteSolutionLimitStrategy::run()
     }
 
     currIter->MIPSolutionLimitUpdated = solutionLimitStrategy->updateLimit();
+    env->dualSolver->MIPIterationTimeLimit = solutionLimitStrategy->getTimeLimit();
 
     if(currIter->MIPSolutionLimitUpdated)
     {
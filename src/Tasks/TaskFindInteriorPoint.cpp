@@ -10,16 +10,25 @@
 
 #include "TaskFindInteriorPoint.h"
 
+#include "../CancellationToken.h"
+#include "../DebugWriter.h"
 #include "../DualSolver.h"
 #include "../PrimalSolver.h"
 #include "../Report.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 
 #include "../NLPSolver/NLPSolverCuttingPlaneMinimax.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <thread>
+
 namespace SHOT
 {
 
@@ -72,7 +81,7 @@ void TaskFindInteriorPoint::run()
                 {
                     std::string filename = env->settings->getSetting<std::string>("Debug.Path", "Output")
                         + "/interiorpoint_provided_notused_" + std::to_string(i) + ".txt";
-                    Utilities::saveVariablePointVectorToFile(tmpIP->point, variableNames, filename);
+                    env->debugWriter->writePoint(tmpIP->point, variableNames, filename);
                 }
             }
             else
@@ -86,7 +95,7 @@ void TaskFindInteriorPoint::run()
                 {
                     std::string filename = env->settings->getSetting<std::string>("Debug.Path", "Output")
                         + "/interiorpoint_provided" + std::to_string(i) + ".txt";
-                    Utilities::saveVariablePointVectorToFile(tmpIP->point, variableNames, filename);
+                    env->debugWriter->writePoint(tmpIP->point, variableNames, filename);
                 }
             }
 
@@ -101,9 +110,28 @@ void TaskFindInteriorPoint::run()
     if(env->dualSolver->interiorPts.size() > 0)
         return;
 
-    NLPSolvers.emplace_back(std::make_unique<NLPSolverCuttingPlaneMinimax>(env, env->reformulatedProblem));
+    int numberOfStarts = env->settings->getSetting<int>("ESH.InteriorPoint.MultiStart.NumberOfStarts", "Dual");
+
+    for(int i = 0; i < numberOfStarts; i++)
+    {
+        auto NLPSolver = std::make_unique<NLPSolverCuttingPlaneMinimax>(env, env->reformulatedProblem);
+
+        if(numberOfStarts > 1)
+        {
+            NLPSolver->setIterationOutput(false);
+            NLPSolver->setEarlyTerminationDeviation(
+                env->settings->getSetting<double>("ESH.InteriorPoint.MultiStart.TerminationDeviation", "Dual"));
+        }
+
+        // The first problem uses the original bounds
+        if(i > 0)
+            restrictVariableBounds(NLPSolver.get(), i);
+
+        NLPSolvers.push_back(std::move(NLPSolver));
+    }
 
-    env->output->outputDebug(" Cutting plane minimax selected as NLP solver.");
+    env->output->outputDebug(
+        fmt::format(" Cutting plane minimax selected as NLP solver with {} starts.", numberOfStarts));
 
     if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
     {
@@ -121,18 +149,25 @@ void TaskFindInteriorPoint::run()
 
     env->output->outputDebug(" Solving NLP problem.");
 
-    bool foundNLPPoint = false;
+    solveProblems();
+
+    std::vector<std::shared_ptr<InteriorPoint>> foundInteriorPoints;
 
     for(size_t i = 0; i < NLPSolvers.size(); i++)
     {
-        NLPSolvers.at(i)->solveProblem();
+        auto& NLPSolver = NLPSolvers.at(i);
+
+        env->solutionStatistics.numberOfProblemsMinimaxLP += NLPSolver->numberOfSolvedLPProblems;
+
+        for(auto& HP : NLPSolver->reusableHyperplanes)
+            env->dualSolver->addHyperplane(HP);
 
-        if(NLPSolvers.at(i)->getSolution().size() == 0)
+        if(NLPSolver->getSolution().size() == 0)
             continue;
 
         auto tmpIP = std::make_shared<InteriorPoint>();
 
-        tmpIP->point = NLPSolvers.at(i)->getSolution();
+        tmpIP->point = NLPSolver->getSolution();
         assert((int)tmpIP->point.size() == env->reformulatedProblem->properties.numberOfVariables);
 
         auto maxDev = env->reformulatedProblem->getMaxNumericConstraintValue(
@@ -149,7 +184,7 @@ void TaskFindInteriorPoint::run()
             {
                 std::string filename = env->settings->getSetting<std::string>("Debug.Path", "Output")
                     + "/interiorpoint_notused_" + std::to_string(i) + ".txt";
-                Utilities::saveVariablePointVectorToFile(tmpIP->point, variableNames, filename);
+                env->debugWriter->writePoint(tmpIP->point, variableNames, filename);
             }
         }
         else
@@ -158,19 +193,33 @@ void TaskFindInteriorPoint::run()
             env->output->outputInfo(" Valid interior point with constraint deviation "
                 + Utilities::toString(maxDev.normalizedValue) + " found.");
 
-            env->dualSolver->interiorPts.push_back(tmpIP);
+            foundInteriorPoints.push_back(tmpIP);
 
             if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
             {
                 std::string filename = env->settings->getSetting<std::string>("Debug.Path", "Output")
                     + "/interiorpoint_" + std::to_string(i) + ".txt";
-                Utilities::saveVariablePointVectorToFile(tmpIP->point, variableNames, filename);
+                env->debugWriter->writePoint(tmpIP->point, variableNames, filename);
             }
         }
-
-        foundNLPPoint = (foundNLPPoint || (maxDev.normalizedValue <= 0));
     }
 
+    bool foundNLPPoint = (foundInteriorPoints.size() > 0);
+
+    // Only the points with the most negative deviations are kept
+    std::stable_sort(foundInteriorPoints.begin(), foundInteriorPoints.end(),
+        [](const auto& first, const auto& second) {
+            return (first->maxDevatingConstraint.value < second->maxDevatingConstraint.value);
+        });
+
+    size_t maxInteriorPoints = env->settings->getSetting<int>("ESH.InteriorPoint.MultiStart.MaxPoints", "Dual");
+
+    if(foundInteriorPoints.size() > maxInteriorPoints)
+        foundInteriorPoints.resize(maxInteriorPoints);
+
+    for(auto& IP : foundInteriorPoints)
+        env->dualSolver->interiorPts.push_back(IP);
+
     if(!foundNLPPoint)
     {
         env->output->outputError("");
@@ -192,6 +241,73 @@ void TaskFindInteriorPoint::run()
     env->timing->stopTimer("InteriorPointSearch");
 }
 
+void TaskFindInteriorPoint::solveProblems()
+{
+    int numberOfThreads = env->settings->getSetting<int>("ESH.InteriorPoint.MultiStart.NumberOfThreads", "Dual");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    numberOfThreads = std::min(numberOfThreads, (int)NLPSolvers.size());
+
+    if(numberOfThreads <= 1)
+    {
+        for(auto& S : NLPSolvers)
+        {
+            if(env->cancellationToken->isCancelled())
+                break;
+
+            S->solveProblem();
+        }
+
+        return;
+    }
+
+    // The minimax solvers are independent of each other and of the environment while solving, so they are distributed
+    // over the threads as they become available
+    std::atomic<size_t> nextSolver(0);
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads);
+
+    for(int i = 0; i < numberOfThreads; i++)
+    {
+        threads.emplace_back([&, i]() {
+            ThreadPlacement::pinThread(env->settings, i);
+
+            for(size_t k = nextSolver++; k < NLPSolvers.size() && !env->cancellationToken->isCancelled();
+                k = nextSolver++)
+                NLPSolvers[k]->solveProblem();
+        });
+    }
+
+    for(auto& T : threads)
+        T.join();
+
+    env->output->outputDebug(
+        fmt::format(" Solved {} minimax problems using {} threads.", NLPSolvers.size(), numberOfThreads));
+}
+
+void TaskFindInteriorPoint::restrictVariableBounds(NLPSolverCuttingPlaneMinimax* NLPSolver, int seed)
+{
+    // A fixed seed for each start makes the search reproducible
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> distribution(0.0, 1.0);
+
+    double fraction = env->settings->getSetting<double>("ESH.InteriorPoint.MultiStart.BoundFraction", "Dual");
+
+    for(auto& V : env->reformulatedProblem->allVariables)
+    {
+        // Every other variable is restricted on average, and only variables with reasonable bounds are restricted
+        if(distribution(generator) < 0.5 || std::abs(V->lowerBound) > 1e15 || std::abs(V->upperBound) > 1e15)
+            continue;
+
+        double width = fraction * (V->upperBound - V->lowerBound);
+        double lowerBound = V->lowerBound + distribution(generator) * (V->upperBound - V->lowerBound - width);
+
+        NLPSolver->updateVariableLowerBound(V->index, lowerBound);
+        NLPSolver->updateVariableUpperBound(V->index, lowerBound + width);
+    }
+}
+
 std::string TaskFindInteriorPoint::getType()
 {
     std::string type = typeid(this).name();
@@ -17,7 +17,7 @@
 namespace SHOT
 {
 
-class INLPSolver;
+class NLPSolverCuttingPlaneMinimax;
 
 class TaskFindInteriorPoint : public TaskBase
 {
@@ -29,7 +29,13 @@ public:
     std::string getType() override;
 
 private:
-    std::vector<std::unique_ptr<INLPSolver>> NLPSolvers;
+    std::vector<std::unique_ptr<NLPSolverCuttingPlaneMinimax>> NLPSolvers;
+
+    // Solves the minimax problems, in parallel if more than one thread is used
+    void solveProblems();
+
+    // Restricts the bounds of a random subset of the variables, so that the minimax problems give different points
+    void restrictVariableBounds(NLPSolverCuttingPlaneMinimax* NLPSolver, int seed);
 
     VectorString variableNames;
 };
@@ -0,0 +1,32 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskFinishAsynchronousRootsearches.h"
+#include "TaskSelectPrimalCandidatesFromRootsearch.h"
+
+namespace SHOT
+{
+
+TaskFinishAsynchronousRootsearches::TaskFinishAsynchronousRootsearches(
+    EnvironmentPtr envPtr, std::shared_ptr<TaskSelectPrimalCandidatesFromRootsearch> rootsearchTask)
+    : TaskBase(envPtr), rootsearchTask(rootsearchTask)
+{
+}
+
+TaskFinishAsynchronousRootsearches::~TaskFinishAsynchronousRootsearches() = default;
+
+void TaskFinishAsynchronousRootsearches::run() { rootsearchTask->finishAsynchronousRootsearches(); }
+
+std::string TaskFinishAsynchronousRootsearches::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
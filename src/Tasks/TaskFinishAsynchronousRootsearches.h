@@ -0,0 +1,36 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include <memory>
+
+namespace SHOT
+{
+class TaskSelectPrimalCandidatesFromRootsearch;
+
+// Waits for the asynchronous primal root searches started in the last iteration and adds their candidates, so that
+// they are not lost when the solution process terminates in a task after the one that started them
+class TaskFinishAsynchronousRootsearches : public TaskBase
+{
+public:
+    TaskFinishAsynchronousRootsearches(
+        EnvironmentPtr envPtr, std::shared_ptr<TaskSelectPrimalCandidatesFromRootsearch> rootsearchTask);
+    ~TaskFinishAsynchronousRootsearches() override;
+
+    void run() override;
+
+    std::string getType() override;
+
+private:
+    std::shared_ptr<TaskSelectPrimalCandidatesFromRootsearch> rootsearchTask;
+};
+} // namespace SHOT
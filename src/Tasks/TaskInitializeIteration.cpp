@@ -15,6 +15,8 @@
 
 #include "../MIPSolver/IMIPSolver.h"
 
+#include "../Model/Problem.h"
+
 namespace SHOT
 {
 
@@ -24,6 +26,12 @@ TaskInitializeIteration::~TaskInitializeIteration() = default;
 
 void TaskInitializeIteration::run()
 {
+    // The cached evaluations are only kept for the points of one iteration
+    env->problem->evaluationCache.clear();
+
+    if(env->reformulatedProblem != env->problem)
+        env->reformulatedProblem->evaluationCache.clear();
+
     env->results->createIteration();
     env->results->getCurrentIteration()->isDualProblemDiscrete
         = env->dualSolver->MIPSolver->getDiscreteVariableStatus();
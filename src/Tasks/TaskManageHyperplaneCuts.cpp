@@ -0,0 +1,59 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskManageHyperplaneCuts.h"
+
+#include "../DualSolver.h"
+#include "../Iteration.h"
+#include "../MIPSolver/IMIPSolver.h"
+#include "../Output.h"
+#include "../Results.h"
+#include "../Timing.h"
+
+namespace SHOT
+{
+
+TaskManageHyperplaneCuts::TaskManageHyperplaneCuts(EnvironmentPtr envPtr) : TaskBase(envPtr) { }
+
+TaskManageHyperplaneCuts::~TaskManageHyperplaneCuts() = default;
+
+void TaskManageHyperplaneCuts::run()
+{
+    auto currIter = env->results->getCurrentIteration();
+
+    if(currIter->solutionPoints.size() == 0)
+        return;
+
+    env->timing->startTimer("DualStrategy");
+
+    auto [numberOfAddedCuts, numberOfRemovedCuts]
+        = env->dualSolver->MIPSolver->manageHyperplaneCuts(currIter->solutionPoints);
+
+    if(numberOfRemovedCuts > 0)
+    {
+        env->output->outputDebug(
+            fmt::format("        Removed {} inactive hyperplane cuts from the dual problem.", numberOfRemovedCuts));
+    }
+
+    if(numberOfAddedCuts > 0)
+    {
+        env->output->outputDebug(
+            fmt::format("        Added back {} violated hyperplane cuts to the dual problem.", numberOfAddedCuts));
+    }
+
+    env->timing->stopTimer("DualStrategy");
+}
+
+std::string TaskManageHyperplaneCuts::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
@@ -0,0 +1,29 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+namespace SHOT
+{
+// Removes the hyperplane cuts that have been inactive in the MIP solutions for many iterations from the dual problem,
+// and adds back the removed cuts that are violated by the current solutions
+class TaskManageHyperplaneCuts : public TaskBase
+{
+public:
+    TaskManageHyperplaneCuts(EnvironmentPtr envPtr);
+    ~TaskManageHyperplaneCuts() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+};
+} // namespace SHOT
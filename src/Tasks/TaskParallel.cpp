@@ -0,0 +1,173 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskParallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "../Output.h"
+#include "../ThreadPlacement.h"
+
+namespace SHOT
+{
+
+static bool areStatesShared(
+    const std::vector<E_TaskEnvironmentState>& first, const std::vector<E_TaskEnvironmentState>& second)
+{
+    for(auto& S : first)
+    {
+        for(auto& T : second)
+        {
+            if(S == T || S == E_TaskEnvironmentState::All || T == E_TaskEnvironmentState::All)
+                return (true);
+        }
+    }
+
+    return (false);
+}
+
+TaskParallel::TaskParallel(EnvironmentPtr envPtr, int numberOfThreads)
+    : TaskBase(envPtr), m_numberOfThreads(numberOfThreads)
+{
+}
+
+TaskParallel::~TaskParallel() = default;
+
+void TaskParallel::run()
+{
+    int maxNumberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, m_numberOfThreads);
+
+    for(auto& level : getTaskLevels())
+    {
+        int numberOfThreads = std::min(maxNumberOfThreads, (int)level.size());
+        m_maxNumberOfConcurrentTasks = std::max(m_maxNumberOfConcurrentTasks, numberOfThreads);
+
+        if(numberOfThreads <= 1)
+        {
+            for(auto& T : level)
+                runTask(T);
+
+            continue;
+        }
+
+        // The tasks are picked by the threads as they become available, this thread is one of them. Exceptions are
+        // rethrown afterwards in the order of the tasks, so that the same exception is given as when run sequentially.
+        std::atomic<size_t> nextTask(0);
+        std::vector<std::exception_ptr> exceptions(level.size());
+
+        auto runTasks = [&]() {
+            for(size_t k = nextTask++; k < level.size(); k = nextTask++)
+            {
+                try
+                {
+                    runTask(level[k]);
+                }
+                catch(...)
+                {
+                    exceptions[k] = std::current_exception();
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads - 1);
+
+        for(int i = 1; i < numberOfThreads; i++)
+        {
+            threads.emplace_back([&, i]() {
+                ThreadPlacement::pinThread(env->settings, i);
+                runTasks();
+            });
+        }
+
+        runTasks();
+
+        for(auto& T : threads)
+            T.join();
+
+        for(auto& E : exceptions)
+        {
+            if(E)
+                std::rethrow_exception(E);
+        }
+    }
+}
+
+std::vector<std::vector<TaskPtr>> TaskParallel::getTaskLevels()
+{
+    std::vector<std::vector<TaskPtr>> levels;
+    std::vector<int> taskLevels(m_tasks.size(), 0);
+
+    std::vector<std::vector<E_TaskEnvironmentState>> readStates;
+    std::vector<std::vector<E_TaskEnvironmentState>> modifiedStates;
+
+    readStates.reserve(m_tasks.size());
+    modifiedStates.reserve(m_tasks.size());
+
+    for(auto& T : m_tasks)
+    {
+        readStates.push_back(T->getReadStates());
+        modifiedStates.push_back(T->getModifiedStates());
+    }
+
+    for(size_t i = 0; i < m_tasks.size(); i++)
+    {
+        // A task depends on an earlier task if one of them modifies something the other uses
+        for(size_t j = 0; j < i; j++)
+        {
+            if(taskLevels[j] < taskLevels[i])
+                continue;
+
+            if(areStatesShared(modifiedStates[i], modifiedStates[j])
+                || areStatesShared(modifiedStates[i], readStates[j])
+                || areStatesShared(readStates[i], modifiedStates[j]))
+                taskLevels[i] = taskLevels[j] + 1;
+        }
+
+        if(taskLevels[i] >= (int)levels.size())
+            levels.resize(taskLevels[i] + 1);
+
+        levels[taskLevels[i]].push_back(m_tasks[i]);
+    }
+
+    return (levels);
+}
+
+void TaskParallel::runTask(TaskPtr task)
+{
+#ifdef SIMPLE_OUTPUT_CHARS
+    env->output->outputTrace("---- Started task:  " + task->getType());
+    task->run();
+    env->output->outputTrace("---- Finished task: " + task->getType());
+#else
+    env->output->outputTrace("┌─── Started task:  " + task->getType());
+    task->run();
+    env->output->outputTrace("└─── Finished task: " + task->getType());
+#endif
+}
+
+void TaskParallel::addTasks(std::vector<TaskPtr> tasks)
+{
+    for(auto& T : tasks)
+        addTask(T);
+}
+
+void TaskParallel::addTask(TaskPtr task) { m_tasks.emplace_back(task); }
+
+std::string TaskParallel::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
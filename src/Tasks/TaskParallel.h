@@ -0,0 +1,45 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+namespace SHOT
+{
+// Runs the tasks in the order they are added, except that tasks that do not use the same parts of the environment (as
+// given by TaskBase::getReadStates() and TaskBase::getModifiedStates()) are run at the same time. Since a task is
+// only started after all earlier tasks it depends on have finished, the result is the same as with TaskSequential.
+class TaskParallel : public TaskBase
+{
+public:
+    TaskParallel(EnvironmentPtr envPtr, int numberOfThreads = 0);
+
+    ~TaskParallel() override;
+
+    void addTasks(std::vector<TaskPtr> tasks);
+    void addTask(TaskPtr task);
+
+    void run() override;
+    std::string getType() override;
+
+    // The largest number of tasks that have been run at the same time
+    int getMaxNumberOfConcurrentTasks() const { return (m_maxNumberOfConcurrentTasks); };
+
+private:
+    // Splits the tasks into levels, where the tasks in a level only depend on tasks in earlier levels
+    std::vector<std::vector<TaskPtr>> getTaskLevels();
+
+    void runTask(TaskPtr task);
+
+    std::vector<TaskPtr> m_tasks;
+    int m_numberOfThreads;
+    int m_maxNumberOfConcurrentTasks = 0;
+};
+} // namespace SHOT
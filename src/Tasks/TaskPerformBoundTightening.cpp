@@ -10,6 +10,7 @@
 
 #include "TaskPerformBoundTightening.h"
 
+#include "../CancellationToken.h"
 #include "../DualSolver.h"
 #include "../MIPSolver/IMIPSolver.h"
 #include "../Output.h"
@@ -18,6 +19,7 @@
 #include "../Results.h"
 #include "../Settings.h"
 #include "../Solver.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 
@@ -29,6 +31,21 @@
 
 #include "../NLPSolver/NLPSolverSHOT.h"
 
+#ifdef HAS_CPLEX
+#include "../MIPSolver/MIPSolverCplex.h"
+#endif
+
+#ifdef HAS_GUROBI
+#include "../MIPSolver/MIPSolverGurobi.h"
+#endif
+
+#ifdef HAS_CBC
+#include "../MIPSolver/MIPSolverCbc.h"
+#endif
+
+#include <atomic>
+#include <thread>
+
 namespace SHOT
 {
 
@@ -165,6 +182,11 @@ void TaskPerformBoundTightening::run()
         }
     }
 
+    if(env->settings->getSetting<bool>("BoundTightening.OptimizationBased.Use", "Model")
+        && sourceProblem->nonlinearVariables.size() > 0 && sourceProblem->semicontinuousVariables.size() == 0
+        && sourceProblem->semiintegerVariables.size() == 0)
+        performOBBT();
+
     env->timing->stopTimer("BoundTightening");
 }
 
@@ -196,14 +218,14 @@ void TaskPerformBoundTightening::createPOA()
         Hyperplane newHP;
 
         if(HP.source == E_HyperplaneSource::ObjectiveCuttingPlane
-            || HP.source == E_HyperplaneSource::ObjectiveRootsearch)
+            || HP.source == E_HyperplaneSource::ObjectiveRootsearch || !HP.generatedPoint)
             continue;
 
         newHP.source = HP.source;
         newHP.sourceConstraintIndex = HP.sourceConstraintIndex;
         newHP.sourceConstraint
             = std::dynamic_pointer_cast<NumericConstraint>(sourceProblem->getConstraint(HP.sourceConstraintIndex));
-        newHP.generatedPoint = HP.generatedPoint;
+        newHP.generatedPoint = HP.generatedPoint->getValues();
         newHP.isSourceConvex = HP.isSourceConvex;
         newHP.objectiveFunctionValue = sourceProblem->objectiveFunction->calculateValue(newHP.generatedPoint);
 
@@ -276,4 +298,215 @@ void TaskPerformBoundTightening::createPOA()
         env->timing->getElapsedTime("BoundTighteningPOA")));
 }
 
+MIPSolverPtr TaskPerformBoundTightening::createOBBTSolver()
+{
+    MIPSolverPtr solver;
+
+    [[maybe_unused]] auto solverType = static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual"));
+
+#ifdef HAS_CPLEX
+    if(solverType == ES_MIPSolver::Cplex)
+        solver = std::make_shared<MIPSolverCplex>(env);
+#endif
+
+#ifdef HAS_GUROBI
+    if(solverType == ES_MIPSolver::Gurobi)
+        solver = std::make_shared<MIPSolverGurobi>(env);
+#endif
+
+#ifdef HAS_CBC
+    if(!solver)
+        solver = std::make_shared<MIPSolverCbc>(env);
+#endif
+
+    if(!solver || !solver->initializeProblem())
+        return (nullptr);
+
+    // All variables are continuous, so that the problems are LP problems
+    bool problemCreated = true;
+
+    for(auto& V : sourceProblem->allVariables)
+    {
+        problemCreated = problemCreated
+            && solver->addVariable(V->name.c_str(), E_VariableType::Real, V->lowerBound, V->upperBound, 0.0);
+    }
+
+    problemCreated = problemCreated && solver->initializeObjective() && solver->finalizeObjective(true);
+
+    for(auto& C : sourceProblem->linearConstraints)
+    {
+        problemCreated = problemCreated && solver->initializeConstraint();
+
+        for(auto& T : C->linearTerms)
+            problemCreated = problemCreated && solver->addLinearTermToConstraint(T->coefficient, T->variable->index);
+
+        problemCreated
+            = problemCreated && solver->finalizeConstraint(C->name, C->valueLHS, C->valueRHS, C->constant);
+    }
+
+    problemCreated = problemCreated && solver->finalizeProblem();
+
+    if(!problemCreated)
+        return (nullptr);
+
+    solver->initializeSolverSettings();
+
+    return (solver);
+}
+
+void TaskPerformBoundTightening::performOBBT()
+{
+    env->timing->startTimer("BoundTighteningOBBT");
+
+    env->output->outputInfo("");
+    env->output->outputInfo(" Performing optimization-based bound tightening.");
+
+    Variables variables;
+
+    for(auto& V : sourceProblem->nonlinearVariables)
+    {
+        if(V->properties.type == E_VariableType::Real && V->lowerBound < V->upperBound)
+            variables.push_back(V);
+    }
+
+    double timeEnd = env->timing->getElapsedTime("BoundTighteningOBBT")
+        + env->settings->getSetting<double>("BoundTightening.OptimizationBased.TimeLimit", "Model");
+
+    int numberOfThreads = env->settings->getSetting<int>("BoundTightening.OptimizationBased.NumberOfThreads", "Model");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    // Cbc cannot solve several problems at the same time
+    if(static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual")) == ES_MIPSolver::Cbc)
+        numberOfThreads = 1;
+
+    numberOfThreads = std::max(1, std::min(numberOfThreads, (int)variables.size()));
+
+    // The new bounds for each variable, NAN if not found
+    VectorDouble lowerBounds(variables.size(), NAN);
+    VectorDouble upperBounds(variables.size(), NAN);
+
+    ThreadPlacement::WorkQueue variableQueue(env->settings, variables.size(), numberOfThreads);
+    std::atomic<int> numberOfSolvedProblems(0);
+
+    // Each thread has its own LP problem, in which the objective function is changed for each variable. The bounds
+    // found by a thread are also used in its following problems.
+    auto solveProblems = [&](int threadNumber) {
+        auto solver = createOBBTSolver();
+
+        if(!solver)
+            return;
+
+        double unboundedValue = solver->getUnboundedVariableBoundValue();
+
+        for(size_t k; variableQueue.getNextItem(threadNumber, k);)
+        {
+            int index = variables[k]->index;
+
+            for(bool isMinimize : { true, false })
+            {
+                double remainingTime = std::min(timeEnd - env->timing->getElapsedTime("BoundTighteningOBBT"),
+                    env->cancellationToken->getRemainingTime());
+
+                if(remainingTime <= 0)
+                    return;
+
+                solver->setTimeLimit(remainingTime);
+
+                if(!solver->replaceObjective({ { index, 1.0 } }, isMinimize))
+                    return;
+
+                auto status = solver->solveProblem();
+                numberOfSolvedProblems++;
+
+                if(status != E_ProblemSolutionStatus::Optimal)
+                    continue;
+
+                double value = solver->getVariableSolution(0).at(index);
+
+                if(std::isnan(value) || std::abs(value) >= unboundedValue)
+                    continue;
+
+                // A small margin for the tolerances in the LP solver
+                double margin = 1e-6 * std::max(1.0, std::abs(value));
+
+                if(isMinimize)
+                {
+                    lowerBounds[k] = value - margin;
+                    solver->updateVariableLowerBound(index, lowerBounds[k]);
+                }
+                else
+                {
+                    upperBounds[k] = value + margin;
+                    solver->updateVariableUpperBound(index, upperBounds[k]);
+                }
+            }
+        }
+    };
+
+    if(numberOfThreads == 1)
+    {
+        solveProblems(0);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+        {
+            threads.emplace_back([&, t]() {
+                ThreadPlacement::pinThread(env->settings, t);
+                solveProblems(t);
+            });
+        }
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    int numberOfTightenedVariables = 0;
+
+    for(size_t k = 0; k < variables.size(); k++)
+    {
+        auto& V = variables[k];
+
+        double lowerBound = std::isnan(lowerBounds[k]) ? V->lowerBound : std::max(V->lowerBound, lowerBounds[k]);
+        double upperBound = std::isnan(upperBounds[k]) ? V->upperBound : std::min(V->upperBound, upperBounds[k]);
+
+        // The margins may cross for a fixed variable
+        if(lowerBound > upperBound)
+            continue;
+
+        if(V->tightenBounds(Interval(lowerBound, upperBound)))
+            numberOfTightenedVariables++;
+    }
+
+    // Update variable bounds for original variables also in original problem if tightened in reformulated one
+    if(numberOfTightenedVariables > 0 && sourceProblem->properties.isReformulated)
+    {
+        for(auto& V : variables)
+        {
+            if(V->index >= (int)env->problem->allVariables.size())
+                continue;
+
+            auto& originalVariable = env->problem->allVariables[V->index];
+
+            if(V->lowerBound > originalVariable->lowerBound)
+                originalVariable->lowerBound = V->lowerBound;
+
+            if(V->upperBound < originalVariable->upperBound)
+                originalVariable->upperBound = V->upperBound;
+
+            env->problem->synchronizeVariableBounds(V->index);
+        }
+    }
+
+    env->timing->stopTimer("BoundTighteningOBBT");
+
+    env->output->outputInfo(fmt::format("  - Bounds for {} variables tightened in {:.2f} s by solving {} LP problems.",
+        numberOfTightenedVariables, env->timing->getElapsedTime("BoundTighteningOBBT"),
+        numberOfSolvedProblems.load()));
+}
+
 } // namespace SHOT
\ No newline at end of file
@@ -34,6 +34,11 @@ public:
 private:
     virtual void createPOA();
 
+    // Minimizes and maximizes the continuous nonlinear variables over the linear constraints, which include the POA
+    // if it has been created
+    void performOBBT();
+    MIPSolverPtr createOBBTSolver();
+
     std::shared_ptr<TaskBase> taskSelectHPPts;
 
     ProblemPtr sourceProblem;
@@ -0,0 +1,107 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskPerformIncrementalBoundTightening.h"
+#include "TaskSelectPrimalCandidatesFromNLP.h"
+
+#include "../DualSolver.h"
+#include "../MIPSolver/IMIPSolver.h"
+#include "../Output.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+#include "../Model/Problem.h"
+
+namespace SHOT
+{
+
+TaskPerformIncrementalBoundTightening::TaskPerformIncrementalBoundTightening(EnvironmentPtr envPtr)
+    : TaskBase(envPtr)
+{
+}
+
+TaskPerformIncrementalBoundTightening::~TaskPerformIncrementalBoundTightening() = default;
+
+void TaskPerformIncrementalBoundTightening::run()
+{
+    if(!env->results->hasPrimalSolution())
+        return;
+
+    double primalBound = env->results->getPrimalBound();
+
+    if(primalBound == lastPrimalBound)
+        return;
+
+    lastPrimalBound = primalBound;
+
+    auto cutoffConstraint = createObjectiveCutoffConstraint(primalBound);
+
+    if(!cutoffConstraint)
+        return;
+
+    auto tightenedVariables = env->reformulatedProblem->doIncrementalFBBT(cutoffConstraint,
+        env->settings->getSetting<double>("BoundTightening.FeasibilityBased.Incremental.TimeLimit", "Model"));
+
+    if(tightenedVariables.size() == 0)
+        return;
+
+    VectorInteger variableIndexes;
+    variableIndexes.reserve(tightenedVariables.size());
+
+    for(auto& V : tightenedVariables)
+    {
+        env->dualSolver->MIPSolver->updateVariableBound(V->index, V->lowerBound, V->upperBound);
+        variableIndexes.push_back(V->index);
+    }
+
+    for(auto& T : NLPTasks)
+        T->updateVariableBounds(variableIndexes);
+
+    env->output->outputDebug(fmt::format(
+        "        Bounds for {} variables tightened using the primal bound {}.", variableIndexes.size(), primalBound));
+}
+
+std::string TaskPerformIncrementalBoundTightening::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+
+void TaskPerformIncrementalBoundTightening::addNLPTask(std::shared_ptr<TaskSelectPrimalCandidatesFromNLP> task)
+{
+    NLPTasks.push_back(task);
+}
+
+NumericConstraintPtr TaskPerformIncrementalBoundTightening::createObjectiveCutoffConstraint(double primalBound)
+{
+    auto objective = env->reformulatedProblem->objectiveFunction;
+
+    if(objective->properties.classification > E_ObjectiveFunctionClassification::Quadratic)
+        return (nullptr);
+
+    if(!objective->properties.hasLinearTerms && !objective->properties.hasQuadraticTerms)
+        return (nullptr);
+
+    double valueLHS = objective->properties.isMinimize ? SHOT_DBL_MIN : primalBound;
+    double valueRHS = objective->properties.isMinimize ? primalBound : SHOT_DBL_MAX;
+
+    auto constraint = std::make_shared<QuadraticConstraint>(-1, "objective_cutoff", valueLHS, valueRHS);
+    constraint->constant = objective->constant;
+
+    if(objective->properties.hasLinearTerms)
+        constraint->add(std::dynamic_pointer_cast<LinearObjectiveFunction>(objective)->linearTerms);
+
+    if(objective->properties.hasQuadraticTerms)
+        constraint->add(std::dynamic_pointer_cast<QuadraticObjectiveFunction>(objective)->quadraticTerms);
+
+    return (constraint);
+}
+} // namespace SHOT
@@ -0,0 +1,44 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Structs.h"
+
+namespace SHOT
+{
+class TaskSelectPrimalCandidatesFromNLP;
+
+// Tightens the variable bounds in the reformulated problem when the primal bound has been improved, using the
+// objective function bounded by the primal bound as an extra constraint. The tightened bounds are updated in the MIP
+// solver and in the fixed NLP solvers.
+class TaskPerformIncrementalBoundTightening : public TaskBase
+{
+public:
+    TaskPerformIncrementalBoundTightening(EnvironmentPtr envPtr);
+    ~TaskPerformIncrementalBoundTightening() override;
+    void run() override;
+    std::string getType() override;
+
+    void addNLPTask(std::shared_ptr<TaskSelectPrimalCandidatesFromNLP> task);
+
+private:
+    NumericConstraintPtr createObjectiveCutoffConstraint(double primalBound);
+
+    std::vector<std::shared_ptr<TaskSelectPrimalCandidatesFromNLP>> NLPTasks;
+
+    double lastPrimalBound = NAN;
+};
+} // namespace SHOT
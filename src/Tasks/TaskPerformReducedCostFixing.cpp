@@ -0,0 +1,131 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskPerformReducedCostFixing.h"
+#include "TaskSelectPrimalCandidatesFromNLP.h"
+
+#include "../DualSolver.h"
+#include "../Iteration.h"
+#include "../MIPSolver/IMIPSolver.h"
+#include "../Output.h"
+#include "../Results.h"
+#include "../Settings.h"
+
+#include "../Model/Problem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+namespace SHOT
+{
+
+TaskPerformReducedCostFixing::TaskPerformReducedCostFixing(EnvironmentPtr envPtr) : TaskBase(envPtr) { }
+
+TaskPerformReducedCostFixing::~TaskPerformReducedCostFixing() = default;
+
+void TaskPerformReducedCostFixing::run()
+{
+    if(!env->results->hasPrimalSolution())
+        return;
+
+    auto currIter = env->results->getCurrentIteration();
+
+    if(currIter->isMIP() || currIter->solutionStatus != E_ProblemSolutionStatus::Optimal
+        || currIter->solutionPoints.size() == 0)
+        return;
+
+    auto& MIPSolver = env->dualSolver->MIPSolver;
+
+    // The bounds from the reduced costs are only valid for a linear objective function
+    auto problemClass = MIPSolver->getProblemClass();
+
+    if(problemClass != E_DualProblemClass::LP && problemClass != E_DualProblemClass::MIP)
+        return;
+
+    bool isMinimize = env->reformulatedProblem->objectiveFunction->properties.isMinimize;
+
+    double tolerance = env->settings->getSetting<double>("MIP.ReducedCostFixing.Tolerance", "Dual");
+    double primalBound = env->results->getPrimalBound();
+
+    // How much the objective can worsen from the relaxation value in a solution better than the primal bound
+    double gap = (isMinimize ? primalBound - currIter->objectiveValue : currIter->objectiveValue - primalBound)
+        + tolerance * std::max(1.0, std::abs(primalBound));
+
+    if(gap <= 0)
+        return;
+
+    auto reducedCosts = MIPSolver->getReducedCosts();
+
+    if(reducedCosts.size() == 0)
+        return;
+
+    auto& point = currIter->solutionPoints[0].point;
+
+    std::map<int, PairDouble> variableBounds;
+
+    for(auto& V : env->reformulatedProblem->allVariables)
+    {
+        if(V->properties.type != E_VariableType::Binary && V->properties.type != E_VariableType::Integer)
+            continue;
+
+        if(V->index >= (int)reducedCosts.size() || V->index >= (int)point.size())
+            continue;
+
+        // The reduced costs are for a minimization problem here, i.e. positive at a lower bound in an optimal point
+        double reducedCost = isMinimize ? reducedCosts[V->index] : -reducedCosts[V->index];
+
+        if(std::abs(reducedCost) <= tolerance)
+            continue;
+
+        auto bounds = MIPSolver->getCurrentVariableBounds(V->index);
+        double lowerBound = bounds.first;
+        double upperBound = bounds.second;
+
+        double value = point[V->index];
+
+        // Only the integer steps that do not exceed the gap are allowed
+        double steps = std::floor(gap / std::abs(reducedCost));
+
+        if(reducedCost > 0 && std::abs(value - lowerBound) <= tolerance && lowerBound + steps < upperBound)
+            upperBound = lowerBound + steps;
+        else if(reducedCost < 0 && std::abs(value - upperBound) <= tolerance && upperBound - steps > lowerBound)
+            lowerBound = upperBound - steps;
+        else
+            continue;
+
+        MIPSolver->updateVariableBound(V->index, lowerBound, upperBound);
+        env->reformulatedProblem->setVariableBounds(V->index, lowerBound, upperBound);
+        variableBounds[V->index] = PairDouble(lowerBound, upperBound);
+    }
+
+    if(variableBounds.size() == 0)
+        return;
+
+    // The original and reformulated problems have the same indexes for the original variables
+    for(auto& T : NLPTasks)
+        T->updateVariableBounds(variableBounds);
+
+    env->output->outputDebug(fmt::format(
+        "        Bounds for {} discrete variables tightened using reduced costs and the primal bound {}.",
+        variableBounds.size(), primalBound));
+}
+
+std::string TaskPerformReducedCostFixing::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+
+void TaskPerformReducedCostFixing::addNLPTask(std::shared_ptr<TaskSelectPrimalCandidatesFromNLP> task)
+{
+    NLPTasks.push_back(task);
+}
+} // namespace SHOT
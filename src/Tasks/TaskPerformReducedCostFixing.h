@@ -0,0 +1,42 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../Structs.h"
+
+namespace SHOT
+{
+class TaskSelectPrimalCandidatesFromNLP;
+
+// Tightens the bounds of the discrete variables using the reduced costs of the continuous relaxation solved in the
+// current iteration. A variable at a bound with a reduced cost d can be moved at most (primal bound - relaxation
+// objective) / d units from it in a solution better than the primal bound, since the relaxation is a valid lower
+// bound for any solution of the MIP problem. The tightened bounds are updated in the MIP solver, the reformulated
+// problem and the fixed NLP solvers.
+class TaskPerformReducedCostFixing : public TaskBase
+{
+public:
+    TaskPerformReducedCostFixing(EnvironmentPtr envPtr);
+    ~TaskPerformReducedCostFixing() override;
+    void run() override;
+    std::string getType() override;
+
+    void addNLPTask(std::shared_ptr<TaskSelectPrimalCandidatesFromNLP> task);
+
+private:
+    std::vector<std::shared_ptr<TaskSelectPrimalCandidatesFromNLP>> NLPTasks;
+};
+} // namespace SHOT
@@ -0,0 +1,205 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskPerformRootCutLoop.h"
+
+#include "TaskSelectHyperplanePointsESH.h"
+#include "TaskSelectHyperplanePointsObjectiveFunction.h"
+
+#include "../DualSolver.h"
+#include "../Iteration.h"
+#include "../Metrics.h"
+#include "../Output.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+#include "../MIPSolver/IMIPSolver.h"
+
+#include "../Model/ObjectiveFunction.h"
+#include "../Model/Problem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SHOT
+{
+
+TaskPerformRootCutLoop::TaskPerformRootCutLoop(EnvironmentPtr envPtr) : TaskBase(envPtr)
+{
+    env->timing->startTimer("DualStrategy");
+
+    tSelectHPPts = std::make_unique<TaskSelectHyperplanePointsESH>(env);
+
+    if(env->reformulatedProblem->objectiveFunction->properties.classification
+        > E_ObjectiveFunctionClassification::Quadratic)
+        tSelectObjectiveHPPts = std::make_unique<TaskSelectHyperplanePointsObjectiveFunction>(env);
+
+    env->timing->stopTimer("DualStrategy");
+}
+
+TaskPerformRootCutLoop::~TaskPerformRootCutLoop() = default;
+
+void TaskPerformRootCutLoop::run()
+{
+    // The loop is only performed while the discrete variables are relaxed
+    if(env->dualSolver->MIPSolver->getDiscreteVariableStatus())
+        return;
+
+    env->timing->startTimer("DualStrategy");
+
+    auto currIter = env->results->getCurrentIteration();
+
+    int maxRounds = env->settings->getSetting<int>("Relaxation.RootCutLoop.MaxRounds", "Dual");
+    double minImprovement = env->settings->getSetting<double>("Relaxation.RootCutLoop.MinImprovement", "Dual");
+    double relaxationTimeLimit = env->settings->getSetting<double>("Relaxation.TimeLimit", "Dual");
+    double constraintTolerance = env->settings->getSetting<double>("ConstraintTolerance", "Termination");
+
+    int solvedRounds = 0;
+    int totalAddedHyperplanes = 0;
+    double previousObjectiveValue = SHOT_DBL_MAX;
+
+    for(int round = 0; round < maxRounds; round++)
+    {
+        auto timeLim
+            = env->settings->getSetting<double>("TimeLimit", "Termination") - env->timing->getElapsedTime("Total");
+
+        if(timeLim <= 0 || env->timing->getElapsedTime("DualProblemsRelaxed") >= relaxationTimeLimit)
+        {
+            env->output->outputDebug("        Root cut loop terminated since the time limit was reached.");
+            break;
+        }
+
+        env->dualSolver->MIPSolver->setTimeLimit(timeLim);
+
+        // After the first round, the LP is reoptimized from the previous basis by the dual simplex method
+        E_ProblemSolutionStatus solStatus;
+
+        {
+            MetricsTimer timer(env->metrics.get(), E_MetricsHistogram::MIPSolveTime);
+            solStatus = env->dualSolver->MIPSolver->solveProblem();
+        }
+
+        env->solutionStatistics.numberOfProblemsLP++;
+
+        if(env->metrics)
+            env->metrics->increment(E_MetricsCounter::MIPProblems);
+        solvedRounds++;
+
+        if(solStatus != E_ProblemSolutionStatus::Optimal)
+        {
+            env->output->outputDebug(
+                fmt::format("        Root cut loop terminated since the LP returned status {}.", (int)solStatus));
+            break;
+        }
+
+        auto sols = env->dualSolver->MIPSolver->getAllVariableSolutions();
+
+        if(sols.size() == 0)
+            break;
+
+        double objectiveValue = env->dualSolver->MIPSolver->getObjectiveValue();
+
+        if(env->reformulatedProblem->antiEpigraphObjectiveVariable)
+        {
+            for(auto& SOL : sols)
+                SOL.point.at(env->reformulatedProblem->antiEpigraphObjectiveVariable->index) = objectiveValue;
+        }
+
+        DualSolution sol = { sols.at(0).point, E_DualSolutionSource::LPSolution,
+            env->dualSolver->MIPSolver->getDualObjectiveValue(), currIter->iterationNumber, false };
+        env->dualSolver->addDualSolutionCandidate(sol);
+
+        double improvement = SHOT_DBL_MAX;
+
+        if(round > 0)
+            improvement = std::abs(objectiveValue - previousObjectiveValue) / std::max(1.0, std::abs(objectiveValue));
+
+        env->output->outputDebug(
+            fmt::format("        Root cut loop round {}: objective value {}.", round + 1, objectiveValue));
+
+        previousObjectiveValue = objectiveValue;
+
+        if(improvement < minImprovement)
+            break;
+
+        if(env->reformulatedProblem->properties.numberOfNonlinearConstraints > 0)
+        {
+            auto maxDeviation = env->reformulatedProblem->getMaxNumericConstraintValue(
+                sols.at(0).point, env->reformulatedProblem->nonlinearConstraints);
+
+            if(maxDeviation.normalizedValue <= constraintTolerance && !tSelectObjectiveHPPts)
+                break;
+
+            tSelectHPPts->run(sols);
+        }
+
+        if(tSelectObjectiveHPPts)
+            tSelectObjectiveHPPts->run(sols);
+
+        int addedHyperplanes = addHyperplanes();
+        totalAddedHyperplanes += addedHyperplanes;
+
+        if(addedHyperplanes == 0)
+            break;
+    }
+
+    env->output->outputInfo(fmt::format("        Root cut loop finished after {} rounds with {} added cuts.",
+        solvedRounds, totalAddedHyperplanes));
+
+    env->timing->stopTimer("DualStrategy");
+}
+
+int TaskPerformRootCutLoop::addHyperplanes()
+{
+    auto& waitingList = env->dualSolver->hyperplaneWaitingList;
+
+    std::vector<Hyperplane> hyperplanes;
+    int addedHyperplanes = 0;
+
+    for(auto& HP : waitingList)
+    {
+        if(HP.source != E_HyperplaneSource::PrimalSolutionSearchInteriorObjective)
+        {
+            hyperplanes.push_back(HP);
+        }
+        else if(env->dualSolver->MIPSolver->createInteriorHyperplane(HP))
+        {
+            env->dualSolver->addGeneratedHyperplane(HP);
+            addedHyperplanes++;
+        }
+    }
+
+    // All cuts are added at once, so that the LP is only modified once per round
+    if(hyperplanes.size() > 0)
+    {
+        auto isCreated = env->dualSolver->MIPSolver->createHyperplanes(hyperplanes);
+
+        for(size_t i = 0; i < hyperplanes.size(); i++)
+        {
+            if(!isCreated[i])
+                continue;
+
+            env->dualSolver->addGeneratedHyperplane(hyperplanes[i]);
+            addedHyperplanes++;
+        }
+    }
+
+    waitingList.clear();
+
+    return (addedHyperplanes);
+}
+
+std::string TaskPerformRootCutLoop::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
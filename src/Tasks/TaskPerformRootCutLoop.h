@@ -0,0 +1,39 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+namespace SHOT
+{
+
+class TaskSelectHyperplanePointsESH;
+class TaskSelectHyperplanePointsObjectiveFunction;
+
+// Repeatedly solves the LP relaxation, generates ESH cuts in its solution and adds them as one batch before the LP is
+// reoptimized. No iterations are created, so the relaxation is tightened at a much lower cost than when each LP goes
+// through the main iteration loop. The loop stops when the bound improvement in a round becomes too small.
+class TaskPerformRootCutLoop : public TaskBase
+{
+public:
+    TaskPerformRootCutLoop(EnvironmentPtr envPtr);
+    ~TaskPerformRootCutLoop() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    std::unique_ptr<TaskSelectHyperplanePointsESH> tSelectHPPts;
+    std::unique_ptr<TaskSelectHyperplanePointsObjectiveFunction> tSelectObjectiveHPPts;
+
+    // Adds the hyperplanes in the waiting list to the dual problem, returns the number of added hyperplanes
+    int addHyperplanes();
+};
+} // namespace SHOT
@@ -119,6 +119,16 @@ void TaskPrintIterationReport::run()
         currIter->maxDeviation, E_IterationLineType::DualSolution, forcePrint);
 }
 
+std::vector<E_TaskEnvironmentState> TaskPrintIterationReport::getReadStates()
+{
+    return { E_TaskEnvironmentState::Results, E_TaskEnvironmentState::DualSolver };
+}
+
+std::vector<E_TaskEnvironmentState> TaskPrintIterationReport::getModifiedStates()
+{
+    return { E_TaskEnvironmentState::Report };
+}
+
 std::string TaskPrintIterationReport::getType()
 {
     std::string type = typeid(this).name();
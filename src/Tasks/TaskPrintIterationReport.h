@@ -22,6 +22,9 @@ public:
     void run() override;
     std::string getType() override;
 
+    std::vector<E_TaskEnvironmentState> getReadStates() override;
+    std::vector<E_TaskEnvironmentState> getModifiedStates() override;
+
 private:
     int lastNumHyperplane;
 };
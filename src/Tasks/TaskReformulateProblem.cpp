@@ -10,17 +10,25 @@
 
 #include "TaskReformulateProblem.h"
 
+#include "../DebugWriter.h"
 #include "../DualSolver.h"
 #include "../MIPSolver/IMIPSolver.h"
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Utilities.h"
 #include "../Timing.h"
 
+#include "../Model/Presolve.h"
 #include "../Model/Simplifications.h"
 #include "TaskPerformBoundTightening.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
 #ifdef HAS_GUROBI
 #include "gurobi_c.h"
 #endif
@@ -146,6 +154,12 @@ TaskReformulateProblem::TaskReformulateProblem(EnvironmentPtr envPtr) : TaskBase
         default:
             break;
         }
+
+#ifdef HAS_GUROBI
+#if GRB_VERSION_MAJOR >= 11
+        useFunctionConstraints = env->settings->getSetting<bool>("Gurobi.FunctionConstraints.Use", "Subsolver");
+#endif
+#endif
     }
     else if(env->settings->getSetting<int>("MIP.Solver", "Dual") == (int)ES_MIPSolver::Cbc)
     {
@@ -187,6 +201,13 @@ TaskReformulateProblem::TaskReformulateProblem(EnvironmentPtr envPtr) : TaskBase
     maxBilinearIntegerReformulationDomain
         = env->settings->getSetting<int>("Reformulation.Bilinear.IntegerFormulation.MaxDomain", "Model");
 
+    useLogarithmicIntegerEncoding
+        = (env->settings->getSetting<int>("Reformulation.Bilinear.IntegerFormulation.Encoding", "Model")
+            == static_cast<int>(ES_BilinearIntegerEncoding::Logarithmic));
+
+    reuseReformulatedExpressions
+        = env->settings->getSetting<bool>("Reformulation.Constraint.ReuseExpressionReformulations", "Model");
+
     auxVariableCounter = env->problem->properties.numberOfVariables;
     auxConstraintCounter = env->problem->properties.numberOfNumericConstraints;
 
@@ -208,10 +229,52 @@ TaskReformulateProblem::TaskReformulateProblem(EnvironmentPtr envPtr) : TaskBase
         reformulatedProblem->add(std::move(variable));
     }
 
-    // Reformulating constraints
-    for(auto& C : env->problem->numericConstraints)
+    // Copying the linear and quadratic constraints that are not reformulated, which can be done in parallel since
+    // no auxiliary variables are created for them
+    auto& sourceConstraints = env->problem->numericConstraints;
+    std::vector<NumericConstraintPtr> copiedConstraints(sourceConstraints.size());
+
+    int numberOfThreads = env->settings->getSetting<int>("Reformulation.Constraint.NumberOfThreads", "Model");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    // Not worth starting a thread for fewer than a thousand constraints
+    numberOfThreads = std::max(1, std::min(numberOfThreads, (int)(sourceConstraints.size() / 1000)));
+
+    std::atomic<size_t> nextConstraint(0);
+
+    auto copyConstraints = [&]() {
+        for(size_t k = nextConstraint++; k < sourceConstraints.size(); k = nextConstraint++)
+            copiedConstraints[k] = copyConstraint(sourceConstraints[k]);
+    };
+
+    if(numberOfThreads == 1)
     {
-        auto reformulatedConstraints = reformulateConstraint(C);
+        copyConstraints();
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+            threads.emplace_back(copyConstraints);
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    // Reformulating the remaining constraints in the original order, so that the auxiliary variables and constraints
+    // are always created in the same order
+    for(size_t k = 0; k < sourceConstraints.size(); k++)
+    {
+        if(copiedConstraints[k])
+        {
+            reformulatedProblem->add(std::move(copiedConstraints[k]));
+            continue;
+        }
+
+        auto reformulatedConstraints = reformulateConstraint(sourceConstraints[k]);
 
         for(auto& RC : reformulatedConstraints)
         {
@@ -241,6 +304,12 @@ TaskReformulateProblem::TaskReformulateProblem(EnvironmentPtr envPtr) : TaskBase
     // Creating expressions for the bilinear reformulations
     createBilinearReformulations();
 
+    if(env->settings->getSetting<bool>("Presolve.Use", "Model"))
+    {
+        Presolve presolve(env, reformulatedProblem);
+        presolve.run();
+    }
+
     reformulatedProblem->properties.isReformulated = true;
     reformulatedProblem->properties.numberOfAddedLinearizations = env->problem->properties.numberOfAddedLinearizations;
     reformulatedProblem->finalize();
@@ -275,7 +344,7 @@ TaskReformulateProblem::TaskReformulateProblem(EnvironmentPtr envPtr) : TaskBase
         std::stringstream problem;
         problem << env->reformulatedProblem;
 
-        Utilities::writeStringToFile(filename.str(), problem.str());
+        env->debugWriter->write(filename.str(), problem.str());
     }
 
     auto taskPerformBoundTightening = std::make_unique<TaskPerformBoundTightening>(env, reformulatedProblem);
@@ -905,11 +974,11 @@ void TaskReformulateProblem::createEpigraphConstraint()
     reformulatedProblem->add(std::move(objective));
 }
 
-NumericConstraints TaskReformulateProblem::reformulateConstraint(NumericConstraintPtr C)
+NumericConstraintPtr TaskReformulateProblem::copyConstraint(NumericConstraintPtr C)
 {
-    double valueLHS = std::dynamic_pointer_cast<NumericConstraint>(C)->valueLHS;
-    double valueRHS = std::dynamic_pointer_cast<NumericConstraint>(C)->valueRHS;
-    double constant = std::dynamic_pointer_cast<NumericConstraint>(C)->constant;
+    double valueLHS = C->valueLHS;
+    double valueRHS = C->valueRHS;
+    double constant = C->constant;
 
     if(C->properties.classification == E_ConstraintClassification::Linear
         || (!C->properties.hasNonlinearExpression && !C->properties.hasQuadraticTerms && !C->properties.hasMonomialTerms
@@ -924,7 +993,7 @@ NumericConstraints TaskReformulateProblem::reformulateConstraint(NumericConstrai
         copyLinearTermsToConstraint(sourceConstraint->linearTerms, constraint);
         constraint->constant += constant;
 
-        return (NumericConstraints({ constraint }));
+        return (constraint);
     }
 
     bool isQuadraticConstraint = C->properties.classification == E_ConstraintClassification::Quadratic
@@ -932,12 +1001,14 @@ NumericConstraints TaskReformulateProblem::reformulateConstraint(NumericConstrai
             && !C->properties.hasSignomialTerms);
 
     if(isQuadraticConstraint
-        && (C->properties.convexity == E_Convexity::Convex
-            && ((useConvexQuadraticConstraints
-                    && std::dynamic_pointer_cast<QuadraticConstraint>(C)->quadraticTerms.minEigenValue >= 0.0)
-                || (useConvexQuadraticConstraintsWithinTolerance
-                    && std::dynamic_pointer_cast<QuadraticConstraint>(C)->quadraticTerms.minEigenValueWithinTolerance)
-                || useNonconvexQuadraticConstraints)))
+        && ((C->properties.convexity == E_Convexity::Convex
+                && ((useConvexQuadraticConstraints
+                        && std::dynamic_pointer_cast<QuadraticConstraint>(C)->quadraticTerms.minEigenValue >= 0.0)
+                    || (useConvexQuadraticConstraintsWithinTolerance
+                        && std::dynamic_pointer_cast<QuadraticConstraint>(C)
+                               ->quadraticTerms.minEigenValueWithinTolerance)
+                    || useNonconvexQuadraticConstraints))
+            || (C->properties.isSecondOrderCone && useConvexQuadraticConstraints)))
     {
         // Quadratic constraint (not considered as nonlinear)
         QuadraticConstraintPtr constraint
@@ -951,9 +1022,72 @@ NumericConstraints TaskReformulateProblem::reformulateConstraint(NumericConstrai
 
         constraint->constant += constant;
 
-        return (NumericConstraints({ constraint }));
+        return (constraint);
+    }
+
+    return (nullptr);
+}
+
+NumericConstraintPtr TaskReformulateProblem::reformulateSecondOrderCone(std::shared_ptr<QuadraticConstraint> C)
+{
+    // sum(a_i*x_i^2) <= b*y^2 is written as sqrt(sum(a_i*x_i^2)) - sqrt(b)*y <= 0, and the rotated cone
+    // sum(a_i*x_i^2) <= b*y*z as sqrt(sum(a_i*x_i^2) + b/4*(y-z)^2) - sqrt(b)/2*(y+z) <= 0
+    auto constraint = std::make_shared<NonlinearConstraint>(C->index, C->name, SHOT_DBL_MIN, 0.0);
+    constraint->properties.classification = E_ConstraintClassification::Nonlinear;
+    constraint->ownerProblem = reformulatedProblem;
+
+    auto sumOfSquares = std::make_shared<ExpressionSum>();
+
+    for(auto& T : C->quadraticTerms)
+    {
+        if(T->coefficient == 0.0)
+            continue;
+
+        auto firstVariable = reformulatedProblem->getVariable(T->firstVariable->index);
+
+        if(T->coefficient > 0.0)
+        {
+            sumOfSquares->children.add(
+                std::make_shared<ExpressionProduct>(std::make_shared<ExpressionConstant>(T->coefficient),
+                    std::make_shared<ExpressionSquare>(std::make_shared<ExpressionVariable>(firstVariable))));
+        }
+        else if(T->firstVariable == T->secondVariable)
+        {
+            constraint->add(std::make_shared<LinearTerm>(-std::sqrt(-T->coefficient), firstVariable));
+        }
+        else
+        {
+            auto secondVariable = reformulatedProblem->getVariable(T->secondVariable->index);
+
+            sumOfSquares->children.add(std::make_shared<ExpressionProduct>(
+                std::make_shared<ExpressionConstant>(-T->coefficient / 4.0),
+                std::make_shared<ExpressionSquare>(
+                    std::make_shared<ExpressionSum>(std::make_shared<ExpressionVariable>(firstVariable),
+                        std::make_shared<ExpressionNegate>(std::make_shared<ExpressionVariable>(secondVariable))))));
+
+            constraint->add(std::make_shared<LinearTerm>(-std::sqrt(-T->coefficient) / 2.0, firstVariable));
+            constraint->add(std::make_shared<LinearTerm>(-std::sqrt(-T->coefficient) / 2.0, secondVariable));
+        }
     }
 
+    constraint->add(simplify(std::make_shared<ExpressionSquareRoot>(sumOfSquares)));
+
+    return (constraint);
+}
+
+NumericConstraints TaskReformulateProblem::reformulateConstraint(NumericConstraintPtr C)
+{
+    if(auto constraint = copyConstraint(C))
+        return (NumericConstraints({ constraint }));
+
+    // Otherwise the cone would be regarded as a nonconvex quadratic constraint
+    if(C->properties.isSecondOrderCone)
+        return (NumericConstraints({ reformulateSecondOrderCone(std::dynamic_pointer_cast<QuadraticConstraint>(C)) }));
+
+    double valueLHS = C->valueLHS;
+    double valueRHS = C->valueRHS;
+    double constant = C->constant;
+
     // Constraint is to be regarded as nonlinear
 
     bool copyOriginalNonlinearExpression = false;
@@ -1095,8 +1229,7 @@ NumericConstraints TaskReformulateProblem::reformulateConstraint(NumericConstrai
         auto sourceConstraint = std::dynamic_pointer_cast<NonlinearConstraint>(C);
 
         // Now trying to reformulate the nonlinear expression
-        auto reformulatedExpression = simplify(reformulateNonlinearExpression(
-            copyNonlinearExpression(sourceConstraint->nonlinearExpression.get(), reformulatedProblem)));
+        auto reformulatedExpression = getReformulatedNonlinearExpression(sourceConstraint->nonlinearExpression.get());
 
         auto [tmpLinearTerms, tmpQuadraticTerms, tmpMonomialTerms, tmpSignomialTerms, tmpNonlinearExpression,
             tmpConstant]
@@ -1555,6 +1688,11 @@ LinearTerms TaskReformulateProblem::partitionNonlinearSum(
 
                 auxVariable->nonlinearExpression = auxConstraint->nonlinearExpression;
 
+                // The multivariate terms are still only handled by the cuts
+                if(useFunctionConstraints && !reversedSigns
+                    && getUnivariateFunction(auxConstraint->nonlinearExpression))
+                    auxConstraint->properties.isFunctionConstraint = true;
+
                 reformulatedProblem->add(std::move(auxVariable));
                 reformulatedProblem->add(std::move(auxConstraint));
             }
@@ -1759,7 +1897,8 @@ std::tuple<LinearTerms, QuadraticTerms> TaskReformulateProblem::reformulateAndPa
 
     if(env->settings->getSetting<bool>("Reformulation.Quadratics.EigenValueDecomposition.Use", "Model")
         && partitionStrategy <= ES_PartitionNonlinearSums::IfConvex && quadraticSumConvex
-        && !quadraticTerms.allSquares) // Use the eigenvalue decomposition reformulation
+        && !quadraticTerms.allSquares
+        && quadraticTerms.isEigenvalueDecompositionComplete) // Use the eigenvalue decomposition reformulation
     {
         auto linearTerms = doEigenvalueDecomposition(quadraticTerms);
         resultLinearTerms.add(linearTerms);
@@ -2228,9 +2367,16 @@ LinearTerms TaskReformulateProblem::doEigenvalueDecomposition(QuadraticTerms qua
     LinearTerms resultLinearTerms;
     resultLinearTerms.takeOwnership(reformulatedProblem);
 
-    for(size_t i = 0; i < quadraticTerms.variableMap.size(); i++)
+    std::vector<VariablePtr> mappedVariables(quadraticTerms.variableMap.size());
+
+    for(auto [VAR, j] : quadraticTerms.variableMap)
+        mappedVariables[j] = VAR;
+
+    for(int i = 0; i < quadraticTerms.eigenvalues.size(); i++)
     {
-        if(std::abs(quadraticTerms.eigenvalues[i].real())
+        double eigenvalue = quadraticTerms.eigenvalues[i];
+
+        if(std::abs(eigenvalue)
             < env->settings->getSetting<double>("Reformulation.Quadratics.EigenValueDecomposition.Tolerance", "Model"))
             continue;
 
@@ -2238,11 +2384,9 @@ LinearTerms TaskReformulateProblem::doEigenvalueDecomposition(QuadraticTerms qua
             auxConstraintCounter, "q_evd" + std::to_string(auxConstraintCounter), 0, 0);
         auxConstraintCounter++;
 
-        for(auto [VAR, j] : quadraticTerms.variableMap)
-        {
-            if(quadraticTerms.eigenvectors(j, i).real() != 0.0)
-                auxConstraint->add(std::make_shared<LinearTerm>(quadraticTerms.eigenvectors(j, i).real(), VAR));
-        }
+        // Only the variables in the same block as the eigenvector have nonzero elements
+        for(Eigen::SparseMatrix<double>::InnerIterator it(quadraticTerms.eigenvectors, i); it; ++it)
+            auxConstraint->add(std::make_shared<LinearTerm>(it.value(), mappedVariables[it.row()]));
 
         auto bounds = auxConstraint->linearTerms.calculate(env->problem->getVariableBounds());
 
@@ -2257,16 +2401,15 @@ LinearTerms TaskReformulateProblem::doEigenvalueDecomposition(QuadraticTerms qua
         if(env->settings->getSetting<int>("Reformulation.Quadratics.EigenValueDecomposition.Formulation", "Model")
             == static_cast<int>(ES_EigenValueDecompositionFormulation::CoefficientReformulated))
         {
-            auto [auxVariable, newVariable] = getSquareAuxiliaryVariable(auxQuadVariable,
-                quadraticTerms.eigenvalues[i].real(), E_AuxiliaryVariableType::EigenvalueDecomposition);
+            auto [auxVariable, newVariable] = getSquareAuxiliaryVariable(
+                auxQuadVariable, eigenvalue, E_AuxiliaryVariableType::EigenvalueDecomposition);
             resultLinearTerms.add(std::make_shared<LinearTerm>(0.5, auxVariable));
         }
         else
         {
             auto [auxVariable, newVariable]
                 = getSquareAuxiliaryVariable(auxQuadVariable, 1.0, E_AuxiliaryVariableType::EigenvalueDecomposition);
-            resultLinearTerms.add(
-                std::make_shared<LinearTerm>(0.5 * quadraticTerms.eigenvalues[i].real(), auxVariable));
+            resultLinearTerms.add(std::make_shared<LinearTerm>(0.5 * eigenvalue, auxVariable));
         }
 
         auxConstraint->add(std::make_shared<LinearTerm>(-1.0, auxQuadVariable));
@@ -2276,6 +2419,67 @@ LinearTerms TaskReformulateProblem::doEigenvalueDecomposition(QuadraticTerms qua
     return (resultLinearTerms);
 }
 
+NonlinearExpressionPtr TaskReformulateProblem::getReformulatedNonlinearExpression(NonlinearExpression* source)
+{
+    if(!reuseReformulatedExpressions)
+        return (simplify(reformulateNonlinearExpression(copyNonlinearExpression(source, reformulatedProblem))));
+
+    // The reformulation also depends on the variable bounds, e.g. through the convexity of the subexpressions
+    Variables variables;
+    auto key = getStructuralSignature(source, variables);
+
+    for(auto& V : variables)
+        key += fmt::format(" {}:{}:{}", static_cast<int>(V->properties.type), V->lowerBound, V->upperBound);
+
+    if(auto pattern = reformulatedExpressionPatterns.find(key);
+        pattern != reformulatedExpressionPatterns.end() && pattern->second.expression)
+    {
+        VariableSubstitutions substitutions;
+
+        for(size_t i = 0; i < variables.size(); i++)
+        {
+            substitutions.emplace(
+                pattern->second.variables[i].get(), reformulatedProblem->getVariable(variables[i]->index));
+        }
+
+        auto expression = copyNonlinearExpression(pattern->second.expression.get(), reformulatedProblem);
+        substituteVariables(expression, substitutions);
+
+        return (expression);
+    }
+    else if(pattern != reformulatedExpressionPatterns.end())
+    {
+        return (simplify(reformulateNonlinearExpression(copyNonlinearExpression(source, reformulatedProblem))));
+    }
+
+    int numberOfAuxiliaryVariables = auxVariableCounter;
+    int numberOfAuxiliaryConstraints = auxConstraintCounter;
+
+    auto reformulatedExpression
+        = simplify(reformulateNonlinearExpression(copyNonlinearExpression(source, reformulatedProblem)));
+
+    ReformulatedExpressionPattern pattern;
+
+    for(auto& V : variables)
+        pattern.variables.push_back(reformulatedProblem->getVariable(V->index));
+
+    // An existing auxiliary variable can also be used in the reformulation without new ones being created
+    Variables reformulatedVariables;
+    reformulatedExpression->appendNonlinearVariables(reformulatedVariables);
+
+    bool containsOnlyPatternVariables = std::all_of(reformulatedVariables.begin(), reformulatedVariables.end(),
+        [&](auto& V) { return (std::find(pattern.variables.begin(), pattern.variables.end(), V)
+                                  != pattern.variables.end()); });
+
+    if(numberOfAuxiliaryVariables == auxVariableCounter && numberOfAuxiliaryConstraints == auxConstraintCounter
+        && containsOnlyPatternVariables)
+        pattern.expression = copyNonlinearExpression(reformulatedExpression.get(), reformulatedProblem);
+
+    reformulatedExpressionPatterns.emplace(key, std::move(pattern));
+
+    return (reformulatedExpression);
+}
+
 NonlinearExpressionPtr TaskReformulateProblem::reformulateNonlinearExpression(NonlinearExpressionPtr source)
 {
     switch(source->getType())
@@ -2722,6 +2926,9 @@ void TaskReformulateProblem::createSquareReformulations()
 
 void TaskReformulateProblem::createBilinearReformulations()
 {
+    if(env->settings->getSetting<bool>("Reformulation.Bilinear.Partitioning.Use", "Model"))
+        selectBilinearPartitioning();
+
     for(const auto& [VARS, AUXVAR] : bilinearAuxVariables)
     {
         auto firstVariable = std::get<0>(VARS);
@@ -2744,7 +2951,11 @@ void TaskReformulateProblem::createBilinearReformulations()
         else if(firstVariableType == E_VariableType::Integer || firstVariableType == E_VariableType::Semiinteger
             || secondVariableType == E_VariableType::Integer || secondVariableType == E_VariableType::Semiinteger)
         {
-            reformulateIntegerBilinearTerm(firstVariable, secondVariable, AUXVAR);
+            if(useLogarithmicIntegerEncoding)
+                reformulateIntegerBilinearTermLogarithmic(firstVariable, secondVariable, AUXVAR);
+            else
+                reformulateIntegerBilinearTerm(firstVariable, secondVariable, AUXVAR);
+
             AUXVAR->properties.auxiliaryType = E_AuxiliaryVariableType::IntegerBilinear;
         }
         else if(firstVariableType == E_VariableType::Real && secondVariableType == E_VariableType::Real)
@@ -2979,6 +3190,141 @@ void TaskReformulateProblem::reformulateIntegerBilinearTerm(
     }
 }
 
+void TaskReformulateProblem::reformulateIntegerBilinearTermLogarithmic(
+    VariablePtr firstVariable, VariablePtr secondVariable, AuxiliaryVariablePtr auxVariable)
+{
+    firstVariable = reformulatedProblem->getVariable(firstVariable->index);
+    secondVariable = reformulatedProblem->getVariable(secondVariable->index);
+    auto usedAuxVariable = reformulatedProblem->getVariable(auxVariable->index);
+
+    auto isEncodable = [&](const VariablePtr& variable) {
+        return ((variable->properties.type == E_VariableType::Integer
+                    || variable->properties.type == E_VariableType::Semiinteger)
+            && variable->upperBound - variable->lowerBound < maxBilinearIntegerReformulationDomain);
+    };
+
+    auto hasBits = [&](const VariablePtr& variable) {
+        return (integerAuxiliaryBitVariables.find(variable) != integerAuxiliaryBitVariables.end());
+    };
+
+    bool firstVariableSmallerDomain = (firstVariable->upperBound - firstVariable->lowerBound
+        < secondVariable->upperBound - secondVariable->lowerBound);
+
+    // An integer variable that is already encoded is preferred, otherwise the one with the smallest domain
+    VariablePtr encodedVariable;
+
+    if(isEncodable(firstVariable) && isEncodable(secondVariable))
+    {
+        if(hasBits(firstVariable) != hasBits(secondVariable))
+            encodedVariable = hasBits(firstVariable) ? firstVariable : secondVariable;
+        else
+            encodedVariable = firstVariableSmallerDomain ? firstVariable : secondVariable;
+    }
+    else
+    {
+        encodedVariable = isEncodable(firstVariable) ? firstVariable : secondVariable;
+    }
+
+    auto otherVariable = (encodedVariable == firstVariable) ? secondVariable : firstVariable;
+
+    double lowerBound = encodedVariable->lowerBound;
+    Variables bits;
+
+    if(hasBits(encodedVariable))
+    {
+        bits = integerAuxiliaryBitVariables[encodedVariable];
+    }
+    else
+    {
+        int numberOfBits = std::max(
+            1, (int)std::ceil(std::log2(encodedVariable->upperBound - encodedVariable->lowerBound + 1.0)));
+
+        // x - sum(2^k * b_k) = l
+        auto auxEncoding = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_blle" + std::to_string(auxConstraintCounter), lowerBound, lowerBound);
+        auxConstraintCounter++;
+
+        auxEncoding->add(std::make_shared<LinearTerm>(1.0, encodedVariable));
+
+        for(int k = 0; k < numberOfBits; k++)
+        {
+            auto auxBinary = std::make_shared<AuxiliaryVariable>("s_bllb" + std::to_string(auxVariableCounter + 1),
+                auxVariableCounter, E_VariableType::Binary, 0.0, 1.0);
+
+            auxEncoding->add(std::make_shared<LinearTerm>(-std::ldexp(1.0, k), auxBinary));
+
+            bits.push_back(auxBinary);
+            reformulatedProblem->add(auxBinary);
+            auxVariableCounter++;
+        }
+
+        reformulatedProblem->add(std::move(auxEncoding));
+
+        integerAuxiliaryBitVariables.emplace(encodedVariable, bits);
+    }
+
+    double otherLowerBound = otherVariable->lowerBound;
+    double otherUpperBound = otherVariable->upperBound;
+
+    // w - l * y - sum(2^k * z_k) = 0 where z_k = b_k * y
+    auto auxProduct = std::make_shared<LinearConstraint>(
+        auxConstraintCounter, "s_bllw" + std::to_string(auxConstraintCounter), 0.0, 0.0);
+    auxConstraintCounter++;
+
+    auxProduct->add(std::make_shared<LinearTerm>(1.0, usedAuxVariable));
+
+    if(lowerBound != 0.0)
+        auxProduct->add(std::make_shared<LinearTerm>(-lowerBound, otherVariable));
+
+    auto productType = (otherVariable->properties.type == E_VariableType::Real) ? E_VariableType::Real
+                                                                                 : E_VariableType::Integer;
+
+    for(size_t k = 0; k < bits.size(); k++)
+    {
+        auto auxBitProduct = std::make_shared<AuxiliaryVariable>("s_bllz" + std::to_string(auxVariableCounter + 1),
+            auxVariableCounter, productType, std::min(0.0, otherLowerBound), std::max(0.0, otherUpperBound));
+        auxBitProduct->properties.auxiliaryType = E_AuxiliaryVariableType::IntegerBilinear;
+        reformulatedProblem->add(auxBitProduct);
+        auxVariableCounter++;
+
+        auxProduct->add(std::make_shared<LinearTerm>(-std::ldexp(1.0, k), auxBitProduct));
+
+        // z <= u * b, l * b <= z, z <= y - l * (1 - b) and y - u * (1 - b) <= z
+        auto auxConstraint1 = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_bllz" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, 0.0);
+        auxConstraintCounter++;
+        auxConstraint1->add(std::make_shared<LinearTerm>(1.0, auxBitProduct));
+        auxConstraint1->add(std::make_shared<LinearTerm>(-otherUpperBound, bits[k]));
+
+        auto auxConstraint2 = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_bllz" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, 0.0);
+        auxConstraintCounter++;
+        auxConstraint2->add(std::make_shared<LinearTerm>(-1.0, auxBitProduct));
+        auxConstraint2->add(std::make_shared<LinearTerm>(otherLowerBound, bits[k]));
+
+        auto auxConstraint3 = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_bllz" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, -otherLowerBound);
+        auxConstraintCounter++;
+        auxConstraint3->add(std::make_shared<LinearTerm>(1.0, auxBitProduct));
+        auxConstraint3->add(std::make_shared<LinearTerm>(-1.0, otherVariable));
+        auxConstraint3->add(std::make_shared<LinearTerm>(-otherLowerBound, bits[k]));
+
+        auto auxConstraint4 = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_bllz" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, otherUpperBound);
+        auxConstraintCounter++;
+        auxConstraint4->add(std::make_shared<LinearTerm>(-1.0, auxBitProduct));
+        auxConstraint4->add(std::make_shared<LinearTerm>(1.0, otherVariable));
+        auxConstraint4->add(std::make_shared<LinearTerm>(otherUpperBound, bits[k]));
+
+        reformulatedProblem->add(std::move(auxConstraint1));
+        reformulatedProblem->add(std::move(auxConstraint2));
+        reformulatedProblem->add(std::move(auxConstraint3));
+        reformulatedProblem->add(std::move(auxConstraint4));
+    }
+
+    reformulatedProblem->add(std::move(auxProduct));
+}
+
 void TaskReformulateProblem::reformulateSquareTerm(
     VariablePtr variable, AuxiliaryVariablePtr auxVariable, double coefficient)
 {
@@ -3012,6 +3358,8 @@ void TaskReformulateProblem::reformulateSquareTerm(
 void TaskReformulateProblem::reformulateRealBilinearTerm(
     VariablePtr firstVariable, VariablePtr secondVariable, AuxiliaryVariablePtr auxVariable)
 {
+    auto partitionedTerm = partitionedBilinearTerms.find(std::make_tuple(firstVariable, secondVariable));
+
     firstVariable = reformulatedProblem->getVariable(firstVariable->index);
     secondVariable = reformulatedProblem->getVariable(secondVariable->index);
     auto usedAuxVariable = reformulatedProblem->getVariable(auxVariable->index);
@@ -3040,7 +3388,15 @@ void TaskReformulateProblem::reformulateRealBilinearTerm(
 
         reformulatedProblem->add(std::move(auxConstraint));
 
-        if(env->settings->getSetting<bool>("Reformulation.Bilinear.AddConvexEnvelope", "Model"))
+        if(partitionedTerm != partitionedBilinearTerms.end())
+        {
+            auto partitionedVariable = partitionedTerm->second;
+
+            addBilinearPiecewiseMcCormickEnvelope(usedAuxVariable, partitionedVariable,
+                (partitionedVariable == firstVariable) ? secondVariable : firstVariable);
+        }
+        else if(env->settings->getSetting<bool>("Reformulation.Bilinear.AddConvexEnvelope", "Model")
+            || env->settings->getSetting<bool>("Reformulation.Bilinear.Partitioning.Use", "Model"))
         {
             addBilinearMcCormickEnvelope(usedAuxVariable, firstVariable, secondVariable);
         }
@@ -3092,6 +3448,268 @@ void TaskReformulateProblem::addBilinearMcCormickEnvelope(
     reformulatedProblem->add(std::move(auxConstraintU4));
 }
 
+void TaskReformulateProblem::selectBilinearPartitioning()
+{
+    // The bilinear terms are only written as linear and nonlinear constraints if the MIP solver does not support them
+    if(useNonconvexQuadraticConstraints)
+        return;
+
+    int maxPartitions = env->settings->getSetting<int>("Reformulation.Bilinear.Partitioning.MaxPartitions", "Model");
+    int maxTerms = env->settings->getSetting<int>("Reformulation.Bilinear.Partitioning.MaxTerms", "Model");
+
+    struct PartitioningCandidate
+    {
+        std::tuple<VariablePtr, VariablePtr> term;
+        VariablePtr partitionedVariable;
+        double envelopeGap;
+    };
+
+    std::vector<PartitioningCandidate> candidates;
+    std::map<VariablePtr, int> numberOfTerms;
+
+    auto isBounded = [](const VariablePtr& variable) {
+        return (variable->lowerBound > SHOT_DBL_MIN && variable->upperBound < SHOT_DBL_MAX
+            && variable->upperBound > variable->lowerBound);
+    };
+
+    for(const auto& [VARS, AUXVAR] : bilinearAuxVariables)
+    {
+        auto firstVariable = reformulatedProblem->getVariable(std::get<0>(VARS)->index);
+        auto secondVariable = reformulatedProblem->getVariable(std::get<1>(VARS)->index);
+
+        if(firstVariable == secondVariable || firstVariable->properties.type != E_VariableType::Real
+            || secondVariable->properties.type != E_VariableType::Real || !isBounded(firstVariable)
+            || !isBounded(secondVariable))
+            continue;
+
+        numberOfTerms[firstVariable]++;
+        numberOfTerms[secondVariable]++;
+
+        // The largest difference between the bilinear term and its McCormick envelope
+        double envelopeGap = 0.25 * (firstVariable->upperBound - firstVariable->lowerBound)
+            * (secondVariable->upperBound - secondVariable->lowerBound);
+
+        candidates.push_back({ VARS, firstVariable, envelopeGap });
+    }
+
+    if(candidates.size() == 0)
+        return;
+
+    // The binaries of a variable are shared by all its partitioned terms, so the variable in the most terms is chosen
+    for(auto& C : candidates)
+    {
+        auto firstVariable = C.partitionedVariable;
+        auto secondVariable = reformulatedProblem->getVariable(std::get<1>(C.term)->index);
+
+        if(numberOfTerms[secondVariable] > numberOfTerms[firstVariable]
+            || (numberOfTerms[secondVariable] == numberOfTerms[firstVariable]
+                && secondVariable->upperBound - secondVariable->lowerBound
+                    > firstVariable->upperBound - firstVariable->lowerBound))
+            C.partitionedVariable = secondVariable;
+    }
+
+    std::sort(candidates.begin(), candidates.end(),
+        [](const PartitioningCandidate& first, const PartitioningCandidate& second) {
+            return (first.envelopeGap > second.envelopeGap);
+        });
+
+    if((int)candidates.size() > maxTerms)
+        candidates.resize(maxTerms);
+
+    double maxEnvelopeGap = candidates[0].envelopeGap;
+
+    // The gap decreases linearly with the number of partitions, so the partitions are divided such that the remaining
+    // gaps of the terms are about the same
+    for(auto& C : candidates)
+    {
+        int numberOfPartitions
+            = std::min(maxPartitions, (int)std::ceil(maxPartitions * C.envelopeGap / maxEnvelopeGap - 1e-9));
+
+        if(numberOfPartitions < 2)
+            continue;
+
+        auto& partitioning = bilinearPartitionings[C.partitionedVariable];
+        partitioning.numberOfPartitions = std::max(partitioning.numberOfPartitions, numberOfPartitions);
+
+        partitionedBilinearTerms.emplace(C.term, C.partitionedVariable);
+    }
+
+    env->output->outputDebug("        Partitioning {} variables in {} continuous bilinear terms.",
+        bilinearPartitionings.size(), partitionedBilinearTerms.size());
+}
+
+TaskReformulateProblem::BilinearPartitioning& TaskReformulateProblem::getBilinearPartitioning(VariablePtr variable)
+{
+    auto& partitioning = bilinearPartitionings[variable];
+
+    if(partitioning.binaries.size() > 0)
+        return (partitioning);
+
+    int numberOfPartitions = partitioning.numberOfPartitions;
+    double lowerBound = variable->lowerBound;
+    double upperBound = variable->upperBound;
+
+    for(int n = 0; n < numberOfPartitions; n++)
+        partitioning.breakpoints.push_back(lowerBound + n * (upperBound - lowerBound) / numberOfPartitions);
+
+    partitioning.breakpoints.push_back(upperBound);
+
+    auto auxBinarySum = std::make_shared<LinearConstraint>(
+        auxConstraintCounter, "s_blpb_" + std::to_string(auxConstraintCounter), 1.0, 1.0);
+    auxConstraintCounter++;
+
+    auto auxPartSum = std::make_shared<LinearConstraint>(
+        auxConstraintCounter, "s_blpx_" + std::to_string(auxConstraintCounter), 0.0, 0.0);
+    auxConstraintCounter++;
+
+    auxPartSum->add(std::make_shared<LinearTerm>(-1.0, variable));
+
+    for(int n = 0; n < numberOfPartitions; n++)
+    {
+        double partitionLowerBound = partitioning.breakpoints[n];
+        double partitionUpperBound = partitioning.breakpoints[n + 1];
+
+        auto auxBinary = std::make_shared<AuxiliaryVariable>(
+            "s_blpb_" + std::to_string(auxVariableCounter + 1), auxVariableCounter, E_VariableType::Binary, 0.0, 1.0);
+        auxBinary->properties.auxiliaryType = E_AuxiliaryVariableType::BilinearPartitioning;
+        auxVariableCounter++;
+        env->results->increaseAuxiliaryVariableCounter(E_AuxiliaryVariableType::BilinearPartitioning);
+
+        auto auxPart = std::make_shared<AuxiliaryVariable>("s_blpx_" + std::to_string(auxVariableCounter + 1),
+            auxVariableCounter, E_VariableType::Real, std::min(0.0, partitionLowerBound),
+            std::max(0.0, partitionUpperBound));
+        auxPart->properties.auxiliaryType = E_AuxiliaryVariableType::BilinearPartitioning;
+        auxVariableCounter++;
+        env->results->increaseAuxiliaryVariableCounter(E_AuxiliaryVariableType::BilinearPartitioning);
+
+        reformulatedProblem->add(auxBinary);
+        reformulatedProblem->add(auxPart);
+
+        auxBinarySum->add(std::make_shared<LinearTerm>(1.0, auxBinary));
+        auxPartSum->add(std::make_shared<LinearTerm>(1.0, auxPart));
+
+        // The part is within the bounds of the partition if it is active and zero otherwise
+        auto auxPartLowerBound = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_blpl_" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, 0.0);
+        auxConstraintCounter++;
+
+        auxPartLowerBound->add(std::make_shared<LinearTerm>(-1.0, auxPart));
+        auxPartLowerBound->add(std::make_shared<LinearTerm>(partitionLowerBound, auxBinary));
+
+        auto auxPartUpperBound = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_blpu_" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, 0.0);
+        auxConstraintCounter++;
+
+        auxPartUpperBound->add(std::make_shared<LinearTerm>(1.0, auxPart));
+        auxPartUpperBound->add(std::make_shared<LinearTerm>(-partitionUpperBound, auxBinary));
+
+        reformulatedProblem->add(std::move(auxPartLowerBound));
+        reformulatedProblem->add(std::move(auxPartUpperBound));
+
+        partitioning.binaries.push_back(auxBinary);
+        partitioning.parts.push_back(auxPart);
+    }
+
+    reformulatedProblem->add(std::move(auxBinarySum));
+    reformulatedProblem->add(std::move(auxPartSum));
+
+    return (partitioning);
+}
+
+void TaskReformulateProblem::addBilinearPiecewiseMcCormickEnvelope(
+    VariablePtr auxVariable, VariablePtr partitionedVariable, VariablePtr otherVariable)
+{
+    auto usedAuxVariable = reformulatedProblem->getVariable(auxVariable->index);
+    auto& partitioning = getBilinearPartitioning(partitionedVariable);
+
+    double lowerBound = otherVariable->lowerBound;
+    double upperBound = otherVariable->upperBound;
+
+    // The other variable is also disaggregated over the partitions
+    auto auxPartSum = std::make_shared<LinearConstraint>(
+        auxConstraintCounter, "s_blpy_" + std::to_string(auxConstraintCounter), 0.0, 0.0);
+    auxConstraintCounter++;
+
+    auxPartSum->add(std::make_shared<LinearTerm>(-1.0, otherVariable));
+
+    // The McCormick envelope of the active partition, with the partition bounds of the partitioned variable
+    std::vector<std::shared_ptr<LinearConstraint>> envelopes;
+
+    for(int i = 0; i < 4; i++)
+    {
+        auto envelope = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_blpmc_" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, 0.0);
+        auxConstraintCounter++;
+
+        envelope->add(std::make_shared<LinearTerm>((i < 2) ? -1.0 : 1.0, usedAuxVariable));
+        envelopes.push_back(envelope);
+    }
+
+    auto addTerm = [](std::shared_ptr<LinearConstraint>& constraint, double coefficient, const VariablePtr& variable) {
+        if(coefficient != 0.0)
+            constraint->add(std::make_shared<LinearTerm>(coefficient, variable));
+    };
+
+    for(int n = 0; n < partitioning.numberOfPartitions; n++)
+    {
+        double partitionLowerBound = partitioning.breakpoints[n];
+        double partitionUpperBound = partitioning.breakpoints[n + 1];
+        auto& binary = partitioning.binaries[n];
+        auto& part = partitioning.parts[n];
+
+        auto auxPart = std::make_shared<AuxiliaryVariable>("s_blpy_" + std::to_string(auxVariableCounter + 1),
+            auxVariableCounter, E_VariableType::Real, std::min(0.0, lowerBound), std::max(0.0, upperBound));
+        auxPart->properties.auxiliaryType = E_AuxiliaryVariableType::BilinearPartitioning;
+        auxVariableCounter++;
+        env->results->increaseAuxiliaryVariableCounter(E_AuxiliaryVariableType::BilinearPartitioning);
+
+        reformulatedProblem->add(auxPart);
+        auxPartSum->add(std::make_shared<LinearTerm>(1.0, auxPart));
+
+        auto auxPartLowerBound = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_blpl_" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, 0.0);
+        auxConstraintCounter++;
+
+        auxPartLowerBound->add(std::make_shared<LinearTerm>(-1.0, auxPart));
+        addTerm(auxPartLowerBound, lowerBound, binary);
+
+        auto auxPartUpperBound = std::make_shared<LinearConstraint>(
+            auxConstraintCounter, "s_blpu_" + std::to_string(auxConstraintCounter), SHOT_DBL_MIN, 0.0);
+        auxConstraintCounter++;
+
+        auxPartUpperBound->add(std::make_shared<LinearTerm>(1.0, auxPart));
+        addTerm(auxPartUpperBound, -upperBound, binary);
+
+        reformulatedProblem->add(std::move(auxPartLowerBound));
+        reformulatedProblem->add(std::move(auxPartUpperBound));
+
+        // w >= xL y + yL x - xL yL
+        addTerm(envelopes[0], partitionLowerBound, auxPart);
+        addTerm(envelopes[0], lowerBound, part);
+        addTerm(envelopes[0], -partitionLowerBound * lowerBound, binary);
+
+        // w >= xU y + yU x - xU yU
+        addTerm(envelopes[1], partitionUpperBound, auxPart);
+        addTerm(envelopes[1], upperBound, part);
+        addTerm(envelopes[1], -partitionUpperBound * upperBound, binary);
+
+        // w <= xL y + yU x - xL yU
+        addTerm(envelopes[2], -partitionLowerBound, auxPart);
+        addTerm(envelopes[2], -upperBound, part);
+        addTerm(envelopes[2], partitionLowerBound * upperBound, binary);
+
+        // w <= xU y + yL x - xU yL
+        addTerm(envelopes[3], -partitionUpperBound, auxPart);
+        addTerm(envelopes[3], -lowerBound, part);
+        addTerm(envelopes[3], partitionUpperBound * lowerBound, binary);
+    }
+
+    reformulatedProblem->add(std::move(auxPartSum));
+
+    for(auto& E : envelopes)
+        reformulatedProblem->add(std::move(E));
+}
+
 std::optional<QuadraticTermPtr> TaskReformulateProblem::reformulateProductToQuadraticTerm(
     std::shared_ptr<ExpressionProduct> product)
 {
@@ -13,6 +13,7 @@
 
 #include <map>
 #include <tuple>
+#include <unordered_map>
 
 #include "../Model/AuxiliaryVariables.h"
 #include "../Model/Constraints.h"
@@ -61,13 +62,26 @@ private:
 
     int maxBilinearIntegerReformulationDomain = 2;
 
+    // The integer variable is x = l + sum(2^k * b_k) and each product b_k * y is linearized exactly
+    bool useLogarithmicIntegerEncoding = false;
+
     bool useIntegerBilinearTermReformulation = false; // integer term i1*i2 or i1*x2
 
+    bool useFunctionConstraints = false;
+
     void reformulateObjectiveFunction();
     void createEpigraphConstraint();
 
     NumericConstraints reformulateConstraint(NumericConstraintPtr constraint);
 
+    // Returns the copy of a linear or quadratic constraint that is not reformulated, otherwise nullptr. Does not
+    // modify the reformulated problem, so it can be called from several threads at the same time.
+    NumericConstraintPtr copyConstraint(NumericConstraintPtr constraint);
+
+    // Writes a second-order cone as a constraint with a convex nonlinear function, for the MIP solvers that do not
+    // support quadratic constraints, see QuadraticTerms::isSecondOrderCone()
+    NumericConstraintPtr reformulateSecondOrderCone(std::shared_ptr<QuadraticConstraint> constraint);
+
     template <class T> void copyLinearTermsToConstraint(LinearTerms terms, T destination, bool reversedSigns = false);
 
     template <class T>
@@ -104,6 +118,10 @@ private:
 
     LinearTerms doEigenvalueDecomposition(QuadraticTerms quadraticTerms);
 
+    // Copies and reformulates the nonlinear expression of a constraint, or instantiates the reformulation of an earlier
+    // expression with the same structure, variable types and bounds if no auxiliary variables were needed for it
+    NonlinearExpressionPtr getReformulatedNonlinearExpression(NonlinearExpression* source);
+
     NonlinearExpressionPtr reformulateNonlinearExpression(NonlinearExpressionPtr source);
     NonlinearExpressionPtr reformulateNonlinearExpression(std::shared_ptr<ExpressionAbs> source);
     NonlinearExpressionPtr reformulateNonlinearExpression(std::shared_ptr<ExpressionSquare> source);
@@ -128,11 +146,32 @@ private:
         VariablePtr firstVariable, VariablePtr secondVariable, AuxiliaryVariablePtr auxVariable);
     void reformulateIntegerBilinearTerm(
         VariablePtr firstVariable, VariablePtr secondVariable, AuxiliaryVariablePtr auxVariable);
+    void reformulateIntegerBilinearTermLogarithmic(
+        VariablePtr firstVariable, VariablePtr secondVariable, AuxiliaryVariablePtr auxVariable);
     void reformulateRealBilinearTerm(
         VariablePtr firstVariable, VariablePtr secondVariable, AuxiliaryVariablePtr auxVariable);
 
     void addBilinearMcCormickEnvelope(VariablePtr auxVariable, VariablePtr firstVariable, VariablePtr secondVariable);
 
+    // Selects the continuous bilinear terms whose McCormick envelopes are refined by partitioning the domain of one of
+    // the variables, and the number of partitions of each partitioned variable
+    void selectBilinearPartitioning();
+
+    // Adds the convex hull of the McCormick envelopes over the partitions of partitionedVariable
+    void addBilinearPiecewiseMcCormickEnvelope(
+        VariablePtr auxVariable, VariablePtr partitionedVariable, VariablePtr otherVariable);
+
+    struct BilinearPartitioning
+    {
+        int numberOfPartitions = 1;
+        VectorDouble breakpoints; // The bounds of the partitions, numberOfPartitions + 1 values
+        Variables binaries; // Exactly one is nonzero, the partition containing the value of the variable
+        Variables parts; // The value of the variable in the active partition and zero in the others
+    };
+
+    // Creates the binaries and the disaggregated variable, these are shared by all partitioned terms with the variable
+    BilinearPartitioning& getBilinearPartitioning(VariablePtr variable);
+
     std::optional<QuadraticTermPtr> reformulateProductToQuadraticTerm(std::shared_ptr<ExpressionProduct> product);
     std::optional<MonomialTermPtr> reformulateProductToMonomialTerm(std::shared_ptr<ExpressionProduct> product);
 
@@ -140,13 +179,31 @@ private:
     int auxConstraintCounter = 0;
 
     std::map<VariablePtr, Variables> integerAuxiliaryBinaryVariables;
+    std::map<VariablePtr, Variables> integerAuxiliaryBitVariables;
 
     std::map<std::pair<VariablePtr, double>, AuxiliaryVariablePtr> squareAuxVariables;
 
     std::map<std::tuple<VariablePtr, VariablePtr>, AuxiliaryVariablePtr> bilinearAuxVariables;
 
+    std::map<VariablePtr, BilinearPartitioning> bilinearPartitionings;
+
+    // The partitioned variable of the bilinear terms selected in selectBilinearPartitioning()
+    std::map<std::tuple<VariablePtr, VariablePtr>, VariablePtr> partitionedBilinearTerms;
+
     std::map<std::string, AuxiliaryVariablePtr> absoluteExpressionsAuxVariables;
 
+    struct ReformulatedExpressionPattern
+    {
+        // Not set if the reformulation cannot be reused, since it contains auxiliary variables
+        NonlinearExpressionPtr expression;
+
+        // The variables in the order of the structural signature
+        Variables variables;
+    };
+
+    bool reuseReformulatedExpressions = false;
+    std::unordered_map<std::string, ReformulatedExpressionPattern> reformulatedExpressionPatterns;
+
     ProblemPtr reformulatedProblem;
 };
 } // namespace SHOT
\ No newline at end of file
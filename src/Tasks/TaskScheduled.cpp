@@ -0,0 +1,165 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskScheduled.h"
+
+#include "../Output.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+#include "../Model/Problem.h"
+#include "../Model/ObjectiveFunction.h"
+
+#include <cmath>
+
+namespace SHOT
+{
+
+TaskScheduler::TaskScheduler(EnvironmentPtr envPtr) : env(envPtr) { }
+
+int TaskScheduler::addActivity(std::string name)
+{
+    Activity activity;
+    activity.name = name;
+    activities.push_back(activity);
+
+    return (activities.size() - 1);
+}
+
+bool TaskScheduler::shouldRun(int activity)
+{
+    updateTotalImprovement();
+    numberOfDecisions++;
+
+    auto& A = activities[activity];
+
+    if(A.numberOfRuns == 0
+        || A.numberOfSkippedIterations >= env->settings->getSetting<int>("Scheduler.MaxSkippedIterations", "Strategy"))
+        return (true);
+
+    double elapsedTime = env->timing->getElapsedTime("Total");
+    double referenceRate = totalImprovement / std::max(1e-10, elapsedTime);
+
+    // The exploration term is scaled with the reference rate so that it does not depend on the objective scale
+    double rate = A.totalImprovement / std::max(1e-10, A.totalTime);
+    double explorationFactor = env->settings->getSetting<double>("Scheduler.ExplorationFactor", "Strategy");
+    double upperBound
+        = rate + explorationFactor * referenceRate * std::sqrt(std::log(numberOfDecisions) / A.numberOfRuns);
+
+    if(upperBound >= referenceRate)
+        return (true);
+
+    A.numberOfSkippedIterations++;
+
+    env->output->outputDebug("        Skipping {} with improvement rate {} below {} for the solution process.", A.name,
+        rate, referenceRate);
+
+    return (false);
+}
+
+void TaskScheduler::startRun(int activity)
+{
+    auto& A = activities[activity];
+
+    A.startTime = env->timing->getElapsedTime("Total");
+    A.startBounds = getCurrentBounds();
+}
+
+void TaskScheduler::finishRun(int activity)
+{
+    auto& A = activities[activity];
+
+    A.numberOfRuns++;
+    A.numberOfSkippedIterations = 0;
+    A.totalTime += env->timing->getElapsedTime("Total") - A.startTime;
+    A.totalImprovement += getImprovement(A.startBounds, getCurrentBounds());
+}
+
+PairDouble TaskScheduler::getCurrentBounds()
+{
+    return (PairDouble(env->results->getCurrentDualBound(), env->results->getPrimalBound()));
+}
+
+double TaskScheduler::getImprovement(const PairDouble& previousBounds, const PairDouble& currentBounds)
+{
+    double sign = (env->reformulatedProblem->objectiveFunction->direction == E_ObjectiveFunctionDirection::Minimize)
+        ? 1.0
+        : -1.0;
+
+    bool isPreviousDualBoundFinite = std::abs(previousBounds.first) < SHOT_DBL_MAX;
+    bool isPreviousPrimalBoundFinite = std::abs(previousBounds.second) < SHOT_DBL_MAX;
+    bool isCurrentDualBoundFinite = std::abs(currentBounds.first) < SHOT_DBL_MAX;
+    bool isCurrentPrimalBoundFinite = std::abs(currentBounds.second) < SHOT_DBL_MAX;
+
+    double scale = 1.0;
+
+    if(isCurrentPrimalBoundFinite)
+        scale = std::max(scale, std::abs(currentBounds.second));
+    else if(isCurrentDualBoundFinite)
+        scale = std::max(scale, std::abs(currentBounds.first));
+
+    double improvement = 0.0;
+
+    // Finding the first bound counts as closing the whole gap
+    if(isCurrentDualBoundFinite && !isPreviousDualBoundFinite)
+        improvement += 1.0;
+    else if(isCurrentDualBoundFinite)
+        improvement += std::max(0.0, sign * (currentBounds.first - previousBounds.first)) / scale;
+
+    if(isCurrentPrimalBoundFinite && !isPreviousPrimalBoundFinite)
+        improvement += 1.0;
+    else if(isCurrentPrimalBoundFinite)
+        improvement += std::max(0.0, sign * (previousBounds.second - currentBounds.second)) / scale;
+
+    return (improvement);
+}
+
+void TaskScheduler::updateTotalImprovement()
+{
+    auto bounds = getCurrentBounds();
+
+    if(areLastBoundsSet)
+        totalImprovement += getImprovement(lastBounds, bounds);
+
+    lastBounds = bounds;
+    areLastBoundsSet = true;
+}
+
+TaskScheduled::TaskScheduled(EnvironmentPtr envPtr, std::shared_ptr<TaskScheduler> taskScheduler,
+    TaskPtr scheduledTask, std::string activityName)
+    : TaskBase(envPtr), scheduler(taskScheduler), task(scheduledTask)
+{
+    activity = scheduler->addActivity(activityName);
+}
+
+TaskScheduled::~TaskScheduled() = default;
+
+void TaskScheduled::run()
+{
+    if(!scheduler->shouldRun(activity))
+        return;
+
+    scheduler->startRun(activity);
+    task->run();
+    scheduler->finishRun(activity);
+}
+
+std::string TaskScheduled::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+
+std::vector<E_TaskEnvironmentState> TaskScheduled::getReadStates() { return (task->getReadStates()); }
+
+std::vector<E_TaskEnvironmentState> TaskScheduled::getModifiedStates() { return (task->getModifiedStates()); }
+
+} // namespace SHOT
@@ -0,0 +1,85 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SHOT
+{
+
+// Decides when the scheduled tasks are run, based on the measured time of their runs and the relative improvement of
+// the primal and dual bounds during them. This is a multi-armed bandit where a task is run if an upper confidence bound
+// of its improvement per second is at least the improvement per second of the whole solution process so far. A task
+// that is skipped is still run after Scheduler.MaxSkippedIterations skipped iterations, so that its rate is updated.
+class TaskScheduler
+{
+public:
+    TaskScheduler(EnvironmentPtr envPtr);
+
+    // Returns the index of the new activity
+    int addActivity(std::string name);
+
+    bool shouldRun(int activity);
+
+    void startRun(int activity);
+    void finishRun(int activity);
+
+private:
+    struct Activity
+    {
+        std::string name;
+        int numberOfRuns = 0;
+        int numberOfSkippedIterations = 0;
+        double totalTime = 0.0;
+        double totalImprovement = 0.0;
+
+        double startTime = 0.0;
+        PairDouble startBounds;
+    };
+
+    EnvironmentPtr env;
+    std::vector<Activity> activities;
+
+    int numberOfDecisions = 0;
+
+    // The improvement of the bounds over the whole solution process, updated when the scheduler is called
+    double totalImprovement = 0.0;
+    PairDouble lastBounds;
+    bool areLastBoundsSet = false;
+
+    PairDouble getCurrentBounds();
+    double getImprovement(const PairDouble& previousBounds, const PairDouble& currentBounds);
+    void updateTotalImprovement();
+};
+
+// Runs the task only when the scheduler decides so, and passes the time and bound improvement of the run to it
+class TaskScheduled : public TaskBase
+{
+public:
+    TaskScheduled(EnvironmentPtr envPtr, std::shared_ptr<TaskScheduler> taskScheduler, TaskPtr scheduledTask,
+        std::string activityName);
+    ~TaskScheduled() override;
+
+    void run() override;
+    std::string getType() override;
+
+    std::vector<E_TaskEnvironmentState> getReadStates() override;
+    std::vector<E_TaskEnvironmentState> getModifiedStates() override;
+
+private:
+    std::shared_ptr<TaskScheduler> scheduler;
+    TaskPtr task;
+    int activity;
+};
+} // namespace SHOT
@@ -14,11 +14,14 @@
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Utilities.h"
 #include "../Timing.h"
 
 #include "../Model/Problem.h"
 
+#include <thread>
+
 namespace SHOT
 {
 
@@ -32,7 +35,7 @@ TaskSelectHyperplanePointsECP::~TaskSelectHyperplanePointsECP() = default;
 
 void TaskSelectHyperplanePointsECP::run() { this->run(env->results->getPreviousIteration()->solutionPoints); }
 
-void TaskSelectHyperplanePointsECP::run(std::vector<SolutionPoint> solPoints)
+void TaskSelectHyperplanePointsECP::run(const std::vector<SolutionPoint>& solPoints)
 {
     if(env->reformulatedProblem->properties.numberOfNonlinearConstraints == 0)
         return;
@@ -64,6 +67,8 @@ void TaskSelectHyperplanePointsECP::run(std::vector<SolutionPoint> solPoints)
         auto numericConstraintValues = env->reformulatedProblem->getFractionOfDeviatingNonlinearConstraints(
             solPoints.at(i).point, 0.0, constraintSelectionFactor);
 
+        auto hash = Utilities::calculateHash(solPoints.at(i).point);
+
         for(auto& NCV : numericConstraintValues)
         {
             if(addedHyperplanes >= maxHyperplanesPerIter)
@@ -90,8 +95,6 @@ void TaskSelectHyperplanePointsECP::run(std::vector<SolutionPoint> solPoints)
                 continue;
             }
 
-            double hash = Utilities::calculateHash(solPoints.at(i).point);
-
             if(env->dualSolver->hasHyperplaneBeenAdded(hash, NCV.constraint->index))
             {
                 env->output->outputDebug("         Hyperplane already added for constraint "
@@ -109,16 +112,84 @@ void TaskSelectHyperplanePointsECP::run(std::vector<SolutionPoint> solPoints)
         }
     }
 
-    for(auto& values : selectedNumericValues)
+    // The gradients of all selected constraints in the same solution point are calculated together, and the points
+    // are distributed over the threads, each of which differentiates its own copy of the recorded expressions
+    std::vector<SparseGradient> gradients(selectedNumericValues.size());
+    std::vector<std::pair<size_t, size_t>> pointRanges;
+
+    for(size_t first = 0; first < selectedNumericValues.size();)
+    {
+        size_t last = first;
+
+        while(last < selectedNumericValues.size()
+            && std::get<0>(selectedNumericValues[last]) == std::get<0>(selectedNumericValues[first]))
+            last++;
+
+        pointRanges.emplace_back(first, last);
+        first = last;
+    }
+
+    auto calculateGradients = [&](size_t range) {
+        auto [first, last] = pointRanges[range];
+        NumericConstraints constraints;
+
+        for(size_t k = first; k < last; k++)
+            constraints.push_back(std::get<1>(selectedNumericValues[k]).constraint);
+
+        auto pointGradients = env->reformulatedProblem->calculateConstraintGradients(
+            solPoints.at(std::get<0>(selectedNumericValues[first])).point, constraints);
+
+        for(size_t k = first; k < last; k++)
+            gradients[k] = std::move(pointGradients[k - first]);
+    };
+
+    int numberOfThreads = env->settings->getSetting<int>("HyperplaneCuts.ECP.NumberOfThreads", "Dual");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    numberOfThreads = std::min(numberOfThreads, (int)pointRanges.size());
+
+    if(numberOfThreads <= 1)
+    {
+        for(size_t k = 0; k < pointRanges.size(); k++)
+            calculateGradients(k);
+    }
+    else
+    {
+        // The same constraints are usually selected in several points, so their gradient calculations are initialized
+        // before the threads are started
+        for(auto& SNV : selectedNumericValues)
+            std::get<1>(SNV).constraint->initializeGradientCalculation();
+
+        ThreadPlacement::WorkQueue pointQueue(env->settings, pointRanges.size(), numberOfThreads);
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+        {
+            threads.emplace_back([&, t]() {
+                ThreadPlacement::pinThread(env->settings, t);
+
+                for(size_t k; pointQueue.getNextItem(t, k);)
+                    calculateGradients(k);
+            });
+        }
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    for(size_t k = 0; k < selectedNumericValues.size(); k++)
     {
-        int i = std::get<0>(values);
-        auto NCV = std::get<1>(values);
+        int i = std::get<0>(selectedNumericValues[k]);
+        auto NCV = std::get<1>(selectedNumericValues[k]);
 
         Hyperplane hyperplane;
         hyperplane.sourceConstraint = NCV.constraint;
         hyperplane.sourceConstraintIndex = NCV.constraint->index;
         hyperplane.generatedPoint = solPoints.at(i).point;
         hyperplane.isSourceConvex = (NCV.constraint->properties.convexity <= E_Convexity::Convex);
+        hyperplane.sourceGradient = std::move(gradients[k]);
 
         if(solPoints.at(i).isRelaxedPoint)
         {
@@ -187,7 +258,7 @@ void TaskSelectHyperplanePointsECP::run(std::vector<SolutionPoint> solPoints)
 
             bool cutsAwayPrimalSolution = false;
 
-            for(auto& P : env->results->primalSolutions)
+            for(auto& P : env->results->getPrimalSolutions())
             {
                 if(auto terms = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane))
                 {
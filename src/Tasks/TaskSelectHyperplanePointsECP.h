@@ -22,7 +22,7 @@ public:
     ~TaskSelectHyperplanePointsECP() override;
 
     void run() override;
-    virtual void run(std::vector<SolutionPoint> solPoints);
+    virtual void run(const std::vector<SolutionPoint>& solPoints);
 
     std::string getType() override;
 
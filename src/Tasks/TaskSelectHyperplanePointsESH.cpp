@@ -10,40 +10,91 @@
 
 #include "TaskSelectHyperplanePointsESH.h"
 
+#include "../CancellationToken.h"
 #include "../DualSolver.h"
 #include "../MIPSolver/IMIPSolver.h"
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Utilities.h"
 #include "../Timing.h"
 
+#include "../PrimalSolver.h"
+
 #include "../Model/Problem.h"
 
 #include "TaskSelectHyperplanePointsECP.h"
 #include "../RootsearchMethod/IRootsearchMethod.h"
 
+#include <algorithm>
+#include <map>
+#include <thread>
+
 namespace SHOT
 {
 
+namespace
+{
+
+// Measures the distance in the given variables, or in all variables if none are given
+int selectClosestInteriorPoint(const std::vector<std::shared_ptr<InteriorPoint>>& interiorPoints,
+    const VectorDouble& solutionPoint, const Variables* variables)
+{
+    int selectedIndex = 0;
+    double selectedCost = SHOT_DBL_MAX;
+
+    for(size_t j = 0; j < interiorPoints.size(); j++)
+    {
+        auto& point = interiorPoints[j]->point;
+        double distance = 0.0;
+
+        if(variables)
+        {
+            for(auto& V : *variables)
+            {
+                double difference = point[V->index] - solutionPoint[V->index];
+                distance += difference * difference;
+            }
+        }
+        else
+        {
+            distance = Utilities::L2NormSquared(point, solutionPoint);
+        }
+
+        // A close point gives a cut close to the solution point, and the score favors the points that have given
+        // deep cuts before
+        double cost = std::sqrt(distance) * (1.0 - 0.5 * interiorPoints[j]->score);
+
+        if(cost < selectedCost)
+        {
+            selectedCost = cost;
+            selectedIndex = j;
+        }
+    }
+
+    return (selectedIndex);
+}
+
+} // namespace
+
 TaskSelectHyperplanePointsESH::TaskSelectHyperplanePointsESH(EnvironmentPtr envPtr) : TaskBase(envPtr)
 {
-    env->timing->startTimer("DualCutGenerationRootSearch");
-    env->timing->stopTimer("DualCutGenerationRootSearch");
+    rootsearchTimerID = env->timing->getTimerID("DualCutGenerationRootSearch");
 }
 
 TaskSelectHyperplanePointsESH::~TaskSelectHyperplanePointsESH() = default;
 
 void TaskSelectHyperplanePointsESH::run() { this->run(env->results->getPreviousIteration()->solutionPoints); }
 
-void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
+void TaskSelectHyperplanePointsESH::run(const std::vector<SolutionPoint>& solPoints)
 {
     if(env->reformulatedProblem->properties.numberOfNonlinearConstraints == 0)
         return;
 
     env->output->outputDebug("        Selecting separating hyperplanes using the ESH method:");
 
-    env->timing->startTimer("DualCutGenerationRootSearch");
+    ScopedTimer timer(env->timing, rootsearchTimerID);
 
     if(env->dualSolver->interiorPts.size() == 0)
     {
@@ -53,7 +104,6 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
         env->output->outputDebug("         Adding cutting plane since no interior point is known.");
         tSelectHPPts->run(solPoints);
 
-        env->timing->stopTimer("DualCutGenerationRootSearch");
         return;
     }
     else if(env->solutionStatistics.numberOfIterationsWithDualStagnation > 2
@@ -65,10 +115,16 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
         env->output->outputDebug("         Adding cutting plane since the dual has stagnated.");
         tSelectHPPts->run(solPoints);
 
-        env->timing->stopTimer("DualCutGenerationRootSearch");
         return;
     }
 
+    if(!areConstraintBlocksInitialized)
+        initializeConstraintBlocks();
+
+    // The other constraints are used as usual if no hyperplanes can be added for the convex constraints of the blocks
+    if(constraintBlocks.size() > 1 && runWithConstraintBlocks(solPoints) > 0)
+        return;
+
     int addedHyperplanes = 0;
     auto currIter = env->results->getCurrentIteration(); // The unsolved new iteration
 
@@ -76,10 +132,6 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
         = env->settings->getSetting<double>("HyperplaneCuts.ConstraintSelectionFactor", "Dual");
     bool useUniqueConstraints = env->settings->getSetting<bool>("ESH.Rootsearch.UniqueConstraints", "Dual");
 
-    int rootMaxIter = env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver");
-    double rootTerminationTolerance = env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver");
-    double rootActiveConstraintTolerance
-        = env->settings->getSetting<double>("Rootsearch.ActiveConstraintTolerance", "Subsolver");
     int maxHyperplanesPerIter = env->settings->getSetting<int>("HyperplaneCuts.MaxPerIteration", "Dual");
     double rootsearchConstraintTolerance
         = env->settings->getSetting<double>("ESH.Rootsearch.ConstraintTolerance", "Dual");
@@ -95,14 +147,27 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
 
     bool useMaxFunction = env->settings->getSetting<bool>("ESH.Rootsearch.UseMaxFunction", "Dual");
 
+    // With an adaptive set of interior points, only the most suitable interior point is used for each constraint
+    bool useAdaptiveInteriorPoints = env->settings->getSetting<int>("ESH.InteriorPoint.UsePrimalSolution", "Dual")
+            == static_cast<int>(ES_AddPrimalPointAsInteriorPoint::Adaptive)
+        && env->dualSolver->interiorPts.size() > 1;
+
     if(useMaxFunction)
         constraintSelectionFactor = 1.0;
 
+    std::vector<VectorDouble> points;
+    points.reserve(solPoints.size());
+
+    for(auto& SOLPT : solPoints)
+        points.push_back(SOLPT.point);
+
+    auto allNumericConstraintValues = env->reformulatedProblem->getFractionOfDeviatingNonlinearConstraints(
+        points, 0.0, constraintSelectionFactor);
+
     // First find the interior point - solution point - constraint combination that will be used for root search
     for(size_t i = 0; i < solPoints.size(); i++)
     {
-        auto numericConstraintValues = env->reformulatedProblem->getFractionOfDeviatingNonlinearConstraints(
-            solPoints.at(i).point, 0.0, constraintSelectionFactor);
+        auto& numericConstraintValues = allNumericConstraintValues.at(i);
 
         if(numericConstraintValues.size() == 0)
             continue;
@@ -110,14 +175,19 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
         if(addedHyperplanes >= maxHyperplanesPerIter)
         {
             env->output->outputDebug("        Not generating hyperplane using ESH: Max number already added.");         
-            env->timing->stopTimer("DualCutGenerationRootSearch");
             break;
         }
 
         if(useMaxFunction)
         {
+            int selectedInteriorPoint
+                = useAdaptiveInteriorPoints ? selectInteriorPoint(solPoints[i].point, nullptr) : -1;
+
             for(size_t j = 0; j < env->dualSolver->interiorPts.size(); j++)
             {
+                if(selectedInteriorPoint >= 0 && (int)j != selectedInteriorPoint)
+                    continue;
+
                 auto numericConstraintValuesConvex = NumericConstraintValues();
                 auto numericConstraintValuesAll = NumericConstraintValues();
 
@@ -152,10 +222,23 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
         }
         else
         {
-            for(size_t j = 0; j < env->dualSolver->interiorPts.size(); j++)
+            VectorInteger selectedInteriorPoints;
+
+            if(useAdaptiveInteriorPoints)
             {
                 for(auto& NCV : numericConstraintValues)
+                    selectedInteriorPoints.push_back(selectInteriorPoint(solPoints[i].point, NCV.constraint.get()));
+            }
+
+            for(size_t j = 0; j < env->dualSolver->interiorPts.size(); j++)
+            {
+                for(size_t l = 0; l < numericConstraintValues.size(); l++)
                 {
+                    auto& NCV = numericConstraintValues[l];
+
+                    if(useAdaptiveInteriorPoints && selectedInteriorPoints[l] != (int)j)
+                        continue;
+
                     // Do not add hyperplane if one has been added for this constraint already
                     if(useUniqueConstraints && hyperplaneAddedToConstraint.at(NCV.constraint->index))
                     {
@@ -202,39 +285,47 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
         }
     }
 
-    // First try to do root search on convex constraints only
-    for(auto& values : selectedNumericValues)
+    // First try to do root search on convex constraints only. Each combination gives at most one hyperplane, so the
+    // root searches are performed in batches of the number of hyperplanes that can still be added in the iteration.
+    std::vector<std::vector<RootsearchResult>> rootsearchResults(selectedNumericValues.size());
+    size_t numberOfSearched = 0;
+
+    for(size_t k = 0; k < selectedNumericValues.size(); k++)
     {
+        auto& values = selectedNumericValues.at(k);
         int solutionPtIndex = std::get<0>(values);
-        int interiorPtIndex = std::get<1>(values);
 
         if(addedHyperplanes > maxHyperplanesPerIter)
             break;
 
+        if(k == numberOfSearched)
+        {
+            numberOfSearched
+                = std::min(selectedNumericValues.size(), k + (size_t)(maxHyperplanesPerIter + 1 - addedHyperplanes));
+            performRootsearches(
+                solPoints, selectedNumericValues, useMaxFunction, k, numberOfSearched, rootsearchResults);
+
+            if(useAdaptiveInteriorPoints)
+                updateInteriorPointScores(solPoints, selectedNumericValues, k, numberOfSearched, rootsearchResults);
+        }
+
         if(useMaxFunction)
         {
             VectorDouble externalPoint;
             VectorDouble internalPoint;
 
-            std::vector<NumericConstraint*> currentConstraints;
-
-            for(auto& NCV : std::get<2>(values))
-                currentConstraints.push_back(NCV.constraint.get());
+            auto& rootsearchResult = rootsearchResults.at(k).front();
 
-            try
+            if(rootsearchResult.isFound)
             {
-                env->timing->startTimer("DualCutGenerationRootSearch");
-                auto xNewc = env->rootsearchMethod->findZero(env->dualSolver->interiorPts.at(interiorPtIndex)->point,
-                    solPoints.at(solutionPtIndex).point, rootMaxIter, rootTerminationTolerance,
-                    rootActiveConstraintTolerance, currentConstraints, true);
-
-                env->timing->stopTimer("DualCutGenerationRootSearch");
-                internalPoint = xNewc.first;
-                externalPoint = xNewc.second;
+                internalPoint = rootsearchResult.internalPoint;
+                externalPoint = rootsearchResult.externalPoint;
+
+                env->primalSolver->addPrimalSolutionCandidate(
+                    internalPoint, E_PrimalSolutionSource::Rootsearch, currIter->iterationNumber);
             }
-            catch(std::exception&)
+            else
             {
-                env->timing->stopTimer("DualCutGenerationRootSearch");
                 externalPoint = solPoints.at(solutionPtIndex).point;
 
                 env->output->outputDebug(
@@ -246,13 +337,12 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
 
             if(externalConstraintValue.normalizedValue >= 0)
             {
-                double hash = Utilities::calculateHash(externalPoint);
+                auto hash = Utilities::calculateHash(externalPoint);
 
                 if(env->dualSolver->hasHyperplaneBeenAdded(hash, externalConstraintValue.constraint->index))
                 {
-                    env->output->outputDebug("         Hyperplane already added for constraint "
-                        + std::to_string(externalConstraintValue.constraint->index) + " and hash "
-                        + std::to_string(hash));
+                    env->output->outputDebug("         Hyperplane already added for constraint {} and hash {}",
+                        externalConstraintValue.constraint->index, hash);
                     continue;
                 }
 
@@ -283,8 +373,8 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
 
                 hyperplaneAddedToConstraint.at(externalConstraintValue.constraint->index) = true;
 
-                env->output->outputDebug("         Added hyperplane to waiting list with deviation: "
-                    + Utilities::toString(externalConstraintValue.error));
+                env->output->outputDebug(
+                    "         Added hyperplane to waiting list with deviation: {}", externalConstraintValue.error);
 
                 hyperplane.generatedPoint.clear();
 
@@ -292,54 +382,52 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
             }
             else
             {
-                env->output->outputDebug("         Could not add hyperplane to waiting list since constraint value is "
-                    + std::to_string(externalConstraintValue.normalizedValue));
+                env->output->outputDebug(
+                    "         Could not add hyperplane to waiting list since constraint value is {}",
+                    externalConstraintValue.normalizedValue);
             }
         }
         else
         {
-            for(auto& NCV : std::get<2>(values))
+            for(size_t l = 0; l < std::get<2>(values).size(); l++)
             {
+                auto& NCV = std::get<2>(values).at(l);
+
                 if(NCV.error <= 0.0)
                     continue;
 
                 VectorDouble externalPoint;
                 VectorDouble internalPoint;
 
-                std::vector<NumericConstraint*> currentConstraint;
-                currentConstraint.push_back(std::dynamic_pointer_cast<NumericConstraint>(NCV.constraint).get());
+                auto& rootsearchResult = rootsearchResults.at(k).at(l);
 
-                try
+                if(rootsearchResult.isFound)
                 {
-                    env->timing->startTimer("DualCutGenerationRootSearch");
-                    auto xNewc = env->rootsearchMethod->findZero(
-                        env->dualSolver->interiorPts.at(interiorPtIndex)->point, solPoints.at(solutionPtIndex).point,
-                        rootMaxIter, rootTerminationTolerance, rootActiveConstraintTolerance, currentConstraint, true);
-
-                    env->timing->stopTimer("DualCutGenerationRootSearch");
-                    internalPoint = xNewc.first;
-                    externalPoint = xNewc.second;
+                    internalPoint = rootsearchResult.internalPoint;
+                    externalPoint = rootsearchResult.externalPoint;
+
+                    env->primalSolver->addPrimalSolutionCandidate(
+                        internalPoint, E_PrimalSolutionSource::Rootsearch, currIter->iterationNumber);
                 }
-                catch(std::exception&)
+                else
                 {
-                    env->timing->stopTimer("DualCutGenerationRootSearch");
                     externalPoint = solPoints.at(solutionPtIndex).point;
 
                     env->output->outputDebug(
                         "         Cannot find solution with rootsearch, using solution point instead.");
                 }
 
-                auto externalConstraintValue = NCV.constraint->calculateNumericValue(externalPoint);
+                auto hash = Utilities::calculateHash(externalPoint);
+
+                auto externalConstraintValue = env->reformulatedProblem->calculateNumericValue(NCV.constraint.get(),
+                    externalPoint, env->reformulatedProblem->getConstraintEvaluations(externalPoint, hash));
 
                 if(externalConstraintValue.normalizedValue >= 0)
                 {
-                    double hash = Utilities::calculateHash(externalPoint);
-
                     if(env->dualSolver->hasHyperplaneBeenAdded(hash, externalConstraintValue.constraint->index))
                     {
-                        env->output->outputDebug("         Hyperplane already added for constraint "
-                            + std::to_string(externalConstraintValue.constraint->index) + " and hash "
-                            + std::to_string(hash));
+                        env->output->outputDebug("         Hyperplane already added for constraint {} and hash {}",
+                            externalConstraintValue.constraint->index, hash);
                         continue;
                     }
 
@@ -371,8 +459,8 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
 
                     hyperplaneAddedToConstraint.at(externalConstraintValue.constraint->index) = true;
 
-                    env->output->outputDebug("         Added hyperplane to waiting list with deviation: "
-                        + Utilities::toString(externalConstraintValue.error));
+                    env->output->outputDebug(
+                        "         Added hyperplane to waiting list with deviation: {}", externalConstraintValue.error);
 
                     hyperplane.generatedPoint.clear();
 
@@ -381,8 +469,8 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
                 else
                 {
                     env->output->outputDebug(
-                        "         Could not add hyperplane to waiting list since constraint value is "
-                        + std::to_string(externalConstraintValue.normalizedValue));
+                        "         Could not add hyperplane to waiting list since constraint value is {}",
+                        externalConstraintValue.normalizedValue);
                 }
             }
         }
@@ -395,38 +483,48 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
     {
         env->output->outputDebug("         Could not add hyperplane for convex constraints");
 
-        for(auto& values : nonconvexSelectedNumericValues)
+        rootsearchResults.assign(nonconvexSelectedNumericValues.size(), std::vector<RootsearchResult>());
+        numberOfSearched = 0;
+
+        for(size_t k = 0; k < nonconvexSelectedNumericValues.size(); k++)
         {
+            auto& values = nonconvexSelectedNumericValues.at(k);
             int solutionPtIndex = std::get<0>(values);
-            int interiorPtIndex = std::get<1>(values);
 
             if(addedHyperplanes > maxHyperplanesPerIter)
                 break;
 
+            if(k == numberOfSearched)
+            {
+                numberOfSearched = std::min(nonconvexSelectedNumericValues.size(),
+                    k + (size_t)(maxHyperplanesPerIter + 1 - addedHyperplanes));
+                performRootsearches(solPoints, nonconvexSelectedNumericValues, useMaxFunction, k, numberOfSearched,
+                    rootsearchResults);
+
+                if(useAdaptiveInteriorPoints)
+                {
+                    updateInteriorPointScores(
+                        solPoints, nonconvexSelectedNumericValues, k, numberOfSearched, rootsearchResults);
+                }
+            }
+
             if(useMaxFunction)
             {
                 VectorDouble externalPoint;
                 VectorDouble internalPoint;
 
-                std::vector<NumericConstraint*> currentConstraints;
-
-                for(auto& NCV : std::get<2>(values))
-                    currentConstraints.push_back(NCV.constraint.get());
+                auto& rootsearchResult = rootsearchResults.at(k).front();
 
-                try
+                if(rootsearchResult.isFound)
                 {
-                    env->timing->startTimer("DualCutGenerationRootSearch");
-                    auto xNewc = env->rootsearchMethod->findZero(
-                        env->dualSolver->interiorPts.at(interiorPtIndex)->point, solPoints.at(solutionPtIndex).point,
-                        rootMaxIter, rootTerminationTolerance, rootActiveConstraintTolerance, currentConstraints, true);
-
-                    env->timing->stopTimer("DualCutGenerationRootSearch");
-                    internalPoint = xNewc.first;
-                    externalPoint = xNewc.second;
+                    internalPoint = rootsearchResult.internalPoint;
+                    externalPoint = rootsearchResult.externalPoint;
+
+                    env->primalSolver->addPrimalSolutionCandidate(
+                        internalPoint, E_PrimalSolutionSource::Rootsearch, currIter->iterationNumber);
                 }
-                catch(std::exception&)
+                else
                 {
-                    env->timing->stopTimer("DualCutGenerationRootSearch");
                     externalPoint = solPoints.at(solutionPtIndex).point;
 
                     env->output->outputDebug(
@@ -438,13 +536,12 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
 
                 if(externalConstraintValue.normalizedValue >= 0)
                 {
-                    double hash = Utilities::calculateHash(externalPoint);
+                    auto hash = Utilities::calculateHash(externalPoint);
 
                     if(env->dualSolver->hasHyperplaneBeenAdded(hash, externalConstraintValue.constraint->index))
                     {
-                        env->output->outputDebug("         Hyperplane already added for constraint "
-                            + std::to_string(externalConstraintValue.constraint->index) + " and hash "
-                            + std::to_string(hash));
+                        env->output->outputDebug("         Hyperplane already added for constraint {} and hash {}",
+                            externalConstraintValue.constraint->index, hash);
                         continue;
                     }
 
@@ -472,12 +569,12 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
                         hyperplane.source = E_HyperplaneSource::LPRelaxedRootsearch;
                     }
 
-                    env->output->outputDebug("         Added hyperplane to waiting list with deviation: "
-                        + Utilities::toString(externalConstraintValue.error));
+                    env->output->outputDebug(
+                        "         Added hyperplane to waiting list with deviation: {}", externalConstraintValue.error);
 
                     bool cutsAwayPrimalSolution = false;
 
-                    for(auto& P : env->results->primalSolutions)
+                    for(auto& P : env->results->getPrimalSolutions())
                     {
                         if(auto terms = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane))
                         {
@@ -511,55 +608,51 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
                 else
                 {
                     env->output->outputDebug(
-                        "         Could not add hyperplane to waiting list since constraint value is "
-                        + std::to_string(externalConstraintValue.normalizedValue));
+                        "         Could not add hyperplane to waiting list since constraint value is {}",
+                        externalConstraintValue.normalizedValue);
                 }
             }
             else
             {
-                for(auto& NCV : std::get<2>(values))
+                for(size_t l = 0; l < std::get<2>(values).size(); l++)
                 {
+                    auto& NCV = std::get<2>(values).at(l);
+
                     if(NCV.error <= 0.0)
                         continue;
 
                     VectorDouble externalPoint;
                     VectorDouble internalPoint;
 
-                    std::vector<NumericConstraint*> currentConstraint;
-                    currentConstraint.push_back(std::dynamic_pointer_cast<NumericConstraint>(NCV.constraint).get());
+                    auto& rootsearchResult = rootsearchResults.at(k).at(l);
 
-                    try
+                    if(rootsearchResult.isFound)
                     {
-                        env->timing->startTimer("DualCutGenerationRootSearch");
-                        auto xNewc
-                            = env->rootsearchMethod->findZero(env->dualSolver->interiorPts.at(interiorPtIndex)->point,
-                                solPoints.at(solutionPtIndex).point, rootMaxIter, rootTerminationTolerance,
-                                rootActiveConstraintTolerance, currentConstraint, true);
-
-                        env->timing->stopTimer("DualCutGenerationRootSearch");
-                        internalPoint = xNewc.first;
-                        externalPoint = xNewc.second;
+                        internalPoint = rootsearchResult.internalPoint;
+                        externalPoint = rootsearchResult.externalPoint;
+
+                        env->primalSolver->addPrimalSolutionCandidate(
+                            internalPoint, E_PrimalSolutionSource::Rootsearch, currIter->iterationNumber);
                     }
-                    catch(std::exception&)
+                    else
                     {
-                        env->timing->stopTimer("DualCutGenerationRootSearch");
                         externalPoint = solPoints.at(solutionPtIndex).point;
 
                         env->output->outputDebug(
                             "         Cannot find solution with rootsearch, using solution point instead.");
                     }
 
-                    auto externalConstraintValue = NCV.constraint->calculateNumericValue(externalPoint);
+                    auto hash = Utilities::calculateHash(externalPoint);
+
+                    auto externalConstraintValue = env->reformulatedProblem->calculateNumericValue(NCV.constraint.get(),
+                        externalPoint, env->reformulatedProblem->getConstraintEvaluations(externalPoint, hash));
 
                     if(externalConstraintValue.normalizedValue >= 0)
                     {
-                        double hash = Utilities::calculateHash(externalPoint);
-
                         if(env->dualSolver->hasHyperplaneBeenAdded(hash, externalConstraintValue.constraint->index))
                         {
-                            env->output->outputTrace("         Hyperplane already added for constraint "
-                                + std::to_string(externalConstraintValue.constraint->index) + " and hash "
-                                + std::to_string(hash));
+                            env->output->outputTrace("         Hyperplane already added for constraint {} and hash {}",
+                                externalConstraintValue.constraint->index, hash);
                             continue;
                         }
 
@@ -586,12 +679,12 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
                             hyperplane.source = E_HyperplaneSource::LPRelaxedRootsearch;
                         }
 
-                        env->output->outputDebug("         Added hyperplane to waiting list with deviation: "
-                            + Utilities::toString(externalConstraintValue.error));
+                        env->output->outputDebug("         Added hyperplane to waiting list with deviation: {}",
+                            externalConstraintValue.error);
 
                         bool cutsAwayPrimalSolution = false;
 
-                        for(auto& P : env->results->primalSolutions)
+                        for(auto& P : env->results->getPrimalSolutions())
                         {
                             if(auto terms = env->dualSolver->MIPSolver->createHyperplaneTerms(hyperplane))
                             {
@@ -621,8 +714,8 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
                     else
                     {
                         env->output->outputDebug(
-                            "         Could not add hyperplane to waiting list since constraint value is "
-                            + std::to_string(externalConstraintValue.normalizedValue));
+                            "         Could not add hyperplane to waiting list since constraint value is {}",
+                            externalConstraintValue.normalizedValue);
                     }
                 }
             }
@@ -639,21 +732,21 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
 
         for(auto& HP : hyperplanesCuttingAwayPrimals)
         {
-            double hash = Utilities::calculateHash(HP.first.generatedPoint);
+            auto hash = Utilities::calculateHash(HP.first.generatedPoint);
 
             if(env->dualSolver->hasHyperplaneBeenAdded(hash, HP.first.sourceConstraintIndex))
             {
-                env->output->outputTrace("         Hyperplane already added for constraint "
-                    + std::to_string(HP.first.sourceConstraintIndex) + " and hash " + std::to_string(hash));
+                env->output->outputTrace("         Hyperplane already added for constraint {} and hash {}",
+                    HP.first.sourceConstraintIndex, hash);
                 continue;
             }
 
             env->dualSolver->addHyperplane(HP.first);
             hyperplaneAddedToConstraint.at(HP.first.sourceConstraint->index) = true;
             addedHyperplanes++;
-            env->output->outputDebug(fmt::format("         Selected hyperplane cut for constraint {} that cuts away "
-                                                 "previous primal solution with error {}",
-                HP.first.sourceConstraint->index, HP.second));
+            env->output->outputDebug("         Selected hyperplane cut for constraint {} that cuts away previous "
+                                     "primal solution with error {}",
+                HP.first.sourceConstraint->index, HP.second);
 
             addedHyperplanes++;
 
@@ -666,8 +759,388 @@ void TaskSelectHyperplanePointsESH::run(std::vector<SolutionPoint> solPoints)
     {
         env->output->outputDebug("         All nonlinear constraints fulfilled, so no constraint cuts added.");
     }
+}
+
+void TaskSelectHyperplanePointsESH::initializeConstraintBlocks()
+{
+    areConstraintBlocksInitialized = true;
+
+    if(!env->settings->getSetting<bool>("ESH.Rootsearch.Blocks.Use", "Dual"))
+        return;
+
+    constraintBlocks = env->reformulatedProblem->getNonlinearConstraintBlocks(
+        env->settings->getSetting<int>("ESH.Rootsearch.Blocks.LinkingVariableThreshold", "Dual"));
+
+    if(constraintBlocks.size() <= 1)
+    {
+        env->output->outputDebug("        Nonlinear constraints not separable into blocks for the root searches.");
+        constraintBlocks.clear();
+        return;
+    }
+
+    constraintBlockIndexes.assign(env->reformulatedProblem->properties.numberOfNumericConstraints, -1);
+
+    for(size_t b = 0; b < constraintBlocks.size(); b++)
+    {
+        for(auto& C : constraintBlocks[b].constraints)
+            constraintBlockIndexes.at(C->index) = b;
+    }
+
+    env->output->outputInfo(fmt::format("        Performing the root searches in {} blocks of nonlinear constraints.",
+        constraintBlocks.size()));
+}
+
+int TaskSelectHyperplanePointsESH::runWithConstraintBlocks(const std::vector<SolutionPoint>& solPoints)
+{
+    auto currIter = env->results->getCurrentIteration(); // The unsolved new iteration
+
+    int maxHyperplanesPerIter = env->settings->getSetting<int>("HyperplaneCuts.MaxPerIteration", "Dual");
+    double rootsearchConstraintTolerance
+        = env->settings->getSetting<double>("ESH.Rootsearch.ConstraintTolerance", "Dual");
+
+    int rootMaxIter = env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver");
+    double rootTerminationTolerance = env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver");
+    double rootActiveConstraintTolerance
+        = env->settings->getSetting<double>("Rootsearch.ActiveConstraintTolerance", "Subsolver");
+
+    bool useAdaptiveInteriorPoints = env->settings->getSetting<int>("ESH.InteriorPoint.UsePrimalSolution", "Dual")
+            == static_cast<int>(ES_AddPrimalPointAsInteriorPoint::Adaptive)
+        && env->dualSolver->interiorPts.size() > 1;
+
+    struct BlockRootsearch
+    {
+        size_t solutionPointIndex;
+        size_t interiorPointIndex;
+        size_t blockIndex;
+        std::vector<NumericConstraint*> constraints;
+        RootsearchResult result;
+    };
+
+    std::vector<BlockRootsearch> rootsearches;
+
+    std::vector<VectorDouble> points;
+    points.reserve(solPoints.size());
+
+    for(auto& SOLPT : solPoints)
+        points.push_back(SOLPT.point);
+
+    auto allNumericConstraintValues = env->reformulatedProblem->getFractionOfDeviatingNonlinearConstraints(
+        points, rootsearchConstraintTolerance, 1.0);
+
+    for(size_t i = 0; i < solPoints.size() && (int)rootsearches.size() < maxHyperplanesPerIter; i++)
+    {
+        // The violated convex constraints of each block
+        std::vector<std::vector<NumericConstraint*>> blockConstraints(constraintBlocks.size());
+
+        for(auto& NCV : allNumericConstraintValues.at(i))
+        {
+            if(std::isnan(NCV.error) || std::isnan(NCV.normalizedValue)
+                || NCV.constraint->properties.convexity != E_Convexity::Convex)
+                continue;
+
+            blockConstraints.at(constraintBlockIndexes.at(NCV.constraint->index)).push_back(NCV.constraint.get());
+        }
+
+        for(size_t b = 0; b < constraintBlocks.size(); b++)
+        {
+            if(blockConstraints[b].empty() || (int)rootsearches.size() >= maxHyperplanesPerIter)
+                continue;
+
+            // Each block uses the interior point most suitable for its own variables
+            int selectedInteriorPoint = useAdaptiveInteriorPoints
+                ? selectInteriorPoint(solPoints[i].point, constraintBlocks[b].variables)
+                : -1;
+
+            for(size_t j = 0; j < env->dualSolver->interiorPts.size(); j++)
+            {
+                if(selectedInteriorPoint >= 0 && (int)j != selectedInteriorPoint)
+                    continue;
+
+                rootsearches.push_back({ i, j, b, blockConstraints[b], RootsearchResult() });
+            }
+        }
+    }
+
+    performInParallel(rootsearches.size(), [&](size_t k) {
+        auto& rootsearch = rootsearches[k];
+        auto& solutionPoint = solPoints.at(rootsearch.solutionPointIndex).point;
+        auto& interiorPoint = env->dualSolver->interiorPts.at(rootsearch.interiorPointIndex)->point;
+
+        // The constraints of the block only depend on its variables, so the constraints are fulfilled in the
+        // interior point when only these are taken from it
+        VectorDouble internalPoint = solutionPoint;
+
+        for(auto& V : constraintBlocks[rootsearch.blockIndex].variables)
+            internalPoint[V->index] = interiorPoint[V->index];
+
+        try
+        {
+            auto xNewc = env->rootsearchMethod->findZero(internalPoint, solutionPoint, rootMaxIter,
+                rootTerminationTolerance, rootActiveConstraintTolerance, rootsearch.constraints, false);
+
+            rootsearch.result.internalPoint = xNewc.first;
+            rootsearch.result.externalPoint = xNewc.second;
+            rootsearch.result.isFound = true;
+        }
+        catch(std::exception&)
+        {
+            rootsearch.result.isFound = false;
+        }
+    });
+
+    // Without linking variables, the internal points of the blocks can be combined to a point fulfilling all the
+    // nonlinear constraints, one for each solution point and interior point
+    bool canCombineInternalPoints = std::none_of(
+        constraintBlocks.begin(), constraintBlocks.end(), [](const auto& B) { return (B.hasLinkingVariables); });
+
+    std::map<std::pair<size_t, size_t>, VectorDouble> combinedInternalPoints;
+
+    int addedHyperplanes = 0;
+
+    for(auto& R : rootsearches)
+    {
+        auto& externalPoint = R.result.isFound ? R.result.externalPoint : solPoints.at(R.solutionPointIndex).point;
+
+        if(R.result.isFound && canCombineInternalPoints)
+        {
+            auto combinedPoint = combinedInternalPoints.try_emplace(
+                { R.solutionPointIndex, R.interiorPointIndex }, solPoints.at(R.solutionPointIndex).point);
+
+            for(auto& V : constraintBlocks[R.blockIndex].variables)
+                combinedPoint.first->second[V->index] = R.result.internalPoint[V->index];
+        }
+
+        std::vector<NumericConstraint*> activeConstraints;
+        auto externalConstraintValue
+            = env->reformulatedProblem->getMaxNumericConstraintValue(externalPoint, R.constraints, activeConstraints);
+
+        if(externalConstraintValue.normalizedValue < 0)
+        {
+            env->output->outputDebug(
+                "         Could not add hyperplane to waiting list since constraint value is {}",
+                externalConstraintValue.normalizedValue);
+            continue;
+        }
+
+        auto hash = Utilities::calculateHash(externalPoint);
+
+        if(env->dualSolver->hasHyperplaneBeenAdded(hash, externalConstraintValue.constraint->index))
+        {
+            env->output->outputDebug("         Hyperplane already added for constraint {} and hash {}",
+                externalConstraintValue.constraint->index, hash);
+            continue;
+        }
+
+        Hyperplane hyperplane;
+        hyperplane.sourceConstraint = externalConstraintValue.constraint;
+        hyperplane.sourceConstraintIndex = externalConstraintValue.constraint->index;
+        hyperplane.generatedPoint = externalPoint;
+        hyperplane.isSourceConvex = true; // Only convex constraints are used in the blocks
+
+        if(solPoints.at(R.solutionPointIndex).isRelaxedPoint)
+        {
+            hyperplane.source = E_HyperplaneSource::MIPCallbackRelaxed;
+        }
+        else if(R.solutionPointIndex == 0 && currIter->isMIP())
+        {
+            hyperplane.source = E_HyperplaneSource::MIPOptimalRootsearch;
+        }
+        else if(currIter->isMIP())
+        {
+            hyperplane.source = E_HyperplaneSource::MIPSolutionPoolRootsearch;
+        }
+        else
+        {
+            hyperplane.source = E_HyperplaneSource::LPRelaxedRootsearch;
+        }
+
+        env->dualSolver->addHyperplane(hyperplane);
+
+        env->output->outputDebug("         Added hyperplane to waiting list for block {} with deviation: {}",
+            R.blockIndex, externalConstraintValue.error);
+
+        addedHyperplanes++;
+    }
+
+    // The blocks without violated constraints keep the values in the solution point
+    for(auto& [indexes, point] : combinedInternalPoints)
+    {
+        env->primalSolver->addPrimalSolutionCandidate(
+            point, E_PrimalSolutionSource::Rootsearch, currIter->iterationNumber);
+    }
+
+    env->output->outputDebug("         Added {} hyperplanes using {} root searches in blocks of nonlinear constraints.",
+        addedHyperplanes, rootsearches.size());
+
+    return (addedHyperplanes);
+}
+
+void TaskSelectHyperplanePointsESH::performRootsearches(const std::vector<SolutionPoint>& solPoints,
+    const std::vector<std::tuple<int, int, NumericConstraintValues>>& selectedNumericValues, bool useMaxFunction,
+    size_t first, size_t last, std::vector<std::vector<RootsearchResult>>& results)
+{
+    int rootMaxIter = env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver");
+    double rootTerminationTolerance = env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver");
+    double rootActiveConstraintTolerance
+        = env->settings->getSetting<double>("Rootsearch.ActiveConstraintTolerance", "Subsolver");
+
+    // Each root search is identified by the index of the selected combination and the index of the constraint in it
+    std::vector<std::pair<size_t, size_t>> rootsearches;
+
+    for(size_t k = first; k < last; k++)
+    {
+        auto& values = std::get<2>(selectedNumericValues.at(k));
+
+        if(useMaxFunction)
+        {
+            results.at(k).resize(1);
+            rootsearches.emplace_back(k, 0);
+            continue;
+        }
+
+        results.at(k).resize(values.size());
+
+        for(size_t l = 0; l < values.size(); l++)
+        {
+            if(values.at(l).error > 0.0)
+                rootsearches.emplace_back(k, l);
+        }
+    }
+
+    auto performRootsearch = [&](const std::pair<size_t, size_t>& rootsearch) {
+        auto& values = selectedNumericValues.at(rootsearch.first);
+
+        std::vector<NumericConstraint*> currentConstraints;
+
+        if(useMaxFunction)
+        {
+            for(auto& NCV : std::get<2>(values))
+                currentConstraints.push_back(NCV.constraint.get());
+        }
+        else
+        {
+            currentConstraints.push_back(std::get<2>(values).at(rootsearch.second).constraint.get());
+        }
+
+        auto& result = results.at(rootsearch.first).at(rootsearch.second);
+
+        try
+        {
+            // The primal candidates are added by the caller to keep their order independent of the threads
+            auto xNewc = env->rootsearchMethod->findZero(env->dualSolver->interiorPts.at(std::get<1>(values))->point,
+                solPoints.at(std::get<0>(values)).point, rootMaxIter, rootTerminationTolerance,
+                rootActiveConstraintTolerance, currentConstraints, false);
+
+            result.internalPoint = xNewc.first;
+            result.externalPoint = xNewc.second;
+            result.isFound = true;
+        }
+        catch(std::exception&)
+        {
+            result.isFound = false;
+        }
+    };
+
+    performInParallel(rootsearches.size(), [&](size_t k) { performRootsearch(rootsearches[k]); });
+}
+
+void TaskSelectHyperplanePointsESH::performInParallel(
+    size_t numberOfRootsearches, const std::function<void(size_t)>& performRootsearch)
+{
+    int numberOfThreads = env->settings->getSetting<int>("ESH.Rootsearch.NumberOfThreads", "Dual");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    numberOfThreads = std::min(numberOfThreads, (int)numberOfRootsearches);
+
+    if(numberOfThreads <= 1)
+    {
+        for(size_t k = 0; k < numberOfRootsearches && !env->cancellationToken->isCancelled(); k++)
+            performRootsearch(k);
+
+        env->rootsearchMethod->updateWarmStarts();
+        return;
+    }
 
-    env->timing->stopTimer("DualCutGenerationRootSearch");
+    // The root searches are independent, so they are distributed over the threads as they become available. Since
+    // every result has its own slot, the order in which they are used afterwards is deterministic.
+    ThreadPlacement::WorkQueue rootsearchQueue(env->settings, numberOfRootsearches, numberOfThreads);
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads);
+
+    for(int i = 0; i < numberOfThreads; i++)
+    {
+        threads.emplace_back([&, i]() {
+            ThreadPlacement::pinThread(env->settings, i);
+
+            for(size_t k; !env->cancellationToken->isCancelled() && rootsearchQueue.getNextItem(i, k);)
+                performRootsearch(k);
+        });
+    }
+
+    for(auto& T : threads)
+        T.join();
+
+    env->rootsearchMethod->updateWarmStarts();
+
+    env->output->outputTrace(
+        "        Performed {} root searches using {} threads", numberOfRootsearches, numberOfThreads);
+}
+
+int TaskSelectHyperplanePointsESH::selectInteriorPoint(const VectorDouble& solutionPoint, NumericConstraint* constraint)
+{
+    // The distance is only measured in the variables of the constraint, since the other variables do not affect where
+    // the root search segment intersects its boundary
+    if(constraint)
+        return (selectInteriorPoint(solutionPoint, *constraint->getGradientSparsityPattern()));
+
+    return (selectClosestInteriorPoint(env->dualSolver->interiorPts, solutionPoint, nullptr));
+}
+
+int TaskSelectHyperplanePointsESH::selectInteriorPoint(const VectorDouble& solutionPoint, const Variables& variables)
+{
+    return (selectClosestInteriorPoint(env->dualSolver->interiorPts, solutionPoint, &variables));
+}
+
+void TaskSelectHyperplanePointsESH::updateInteriorPointScores(const std::vector<SolutionPoint>& solPoints,
+    const std::vector<std::tuple<int, int, NumericConstraintValues>>& selectedNumericValues, size_t first,
+    size_t last, const std::vector<std::vector<RootsearchResult>>& rootsearchResults)
+{
+    int iterationNumber = env->results->getCurrentIteration()->iterationNumber;
+
+    for(size_t k = first; k < last; k++)
+    {
+        auto& solutionPoint = solPoints.at(std::get<0>(selectedNumericValues[k])).point;
+        auto& interiorPoint = env->dualSolver->interiorPts.at(std::get<1>(selectedNumericValues[k]));
+
+        double segmentLength = Utilities::L2Norm(solutionPoint, interiorPoint->point);
+
+        if(segmentLength <= 0.0)
+            continue;
+
+        for(auto& R : rootsearchResults[k])
+        {
+            if(!R.isFound)
+                continue;
+
+            // The fraction of the segment that is cut away, a larger fraction gives a deeper cut
+            double depth = std::min(1.0, Utilities::L2Norm(solutionPoint, R.externalPoint) / segmentLength);
+
+            interiorPoint->score = 0.8 * interiorPoint->score + 0.2 * depth;
+            interiorPoint->iterationLastUsed = iterationNumber;
+        }
+    }
+}
+
+std::vector<E_TaskEnvironmentState> TaskSelectHyperplanePointsESH::getReadStates()
+{
+    return { E_TaskEnvironmentState::Problem, E_TaskEnvironmentState::Results, E_TaskEnvironmentState::DualSolver };
+}
+
+std::vector<E_TaskEnvironmentState> TaskSelectHyperplanePointsESH::getModifiedStates()
+{
+    return { E_TaskEnvironmentState::DualSolver, E_TaskEnvironmentState::PrimalSolver,
+        E_TaskEnvironmentState::Results };
 }
 
 std::string TaskSelectHyperplanePointsESH::getType()
@@ -11,6 +11,12 @@
 #pragma once
 #include "TaskBase.h"
 
+#include "../Model/Constraints.h"
+#include "../Model/Problem.h"
+
+#include <functional>
+#include <tuple>
+
 namespace SHOT
 {
 
@@ -24,12 +30,58 @@ public:
     ~TaskSelectHyperplanePointsESH() override;
 
     void run() override;
-    virtual void run(std::vector<SolutionPoint> solPoints);
+    virtual void run(const std::vector<SolutionPoint>& solPoints);
 
     std::string getType() override;
 
+    std::vector<E_TaskEnvironmentState> getReadStates() override;
+    std::vector<E_TaskEnvironmentState> getModifiedStates() override;
+
 private:
+    struct RootsearchResult
+    {
+        VectorDouble internalPoint;
+        VectorDouble externalPoint;
+        bool isFound = false;
+    };
+
     std::unique_ptr<TaskSelectHyperplanePointsECP> tSelectHPPts;
     std::vector<Constraint*> nonlinearConstraints;
+
+    TimerID rootsearchTimerID = -1;
+
+    // The blocks of nonlinear constraints used if ESH.Rootsearch.Blocks.Use is enabled and there are several
+    std::vector<NonlinearConstraintBlock> constraintBlocks;
+    std::vector<int> constraintBlockIndexes; // The block of each constraint index, -1 if not nonlinear
+    bool areConstraintBlocksInitialized = false;
+
+    void initializeConstraintBlocks();
+
+    // Performs one root search on the max function of the violated convex constraints of each block, where only the
+    // variables of the block are moved from the interior point. Returns the number of added hyperplanes.
+    int runWithConstraintBlocks(const std::vector<SolutionPoint>& solPoints);
+
+    // Calls the function with the indexes 0 to numberOfRootsearches - 1, distributed over the threads
+    void performInParallel(size_t numberOfRootsearches, const std::function<void(size_t)>& performRootsearch);
+
+    // Performs the root searches for the selected (solution point, interior point, constraints) combinations first to
+    // last - 1, using several threads if enabled. The results are written to the positions of the combinations in
+    // results, which has one element per combination.
+    void performRootsearches(const std::vector<SolutionPoint>& solPoints,
+        const std::vector<std::tuple<int, int, NumericConstraintValues>>& selectedNumericValues, bool useMaxFunction,
+        size_t first, size_t last, std::vector<std::vector<RootsearchResult>>& results);
+
+    // Selects the interior point closest to the solution point in the variables of the constraint, or in all
+    // variables if no constraint is given, weighted by the scores of the interior points
+    int selectInteriorPoint(const VectorDouble& solutionPoint, NumericConstraint* constraint);
+
+    // As above, but measured in the given variables
+    int selectInteriorPoint(const VectorDouble& solutionPoint, const Variables& variables);
+
+    // Updates the scores of the used interior points with the depths of the roots found for the combinations first to
+    // last - 1
+    void updateInteriorPointScores(const std::vector<SolutionPoint>& solPoints,
+        const std::vector<std::tuple<int, int, NumericConstraintValues>>& selectedNumericValues, size_t first,
+        size_t last, const std::vector<std::vector<RootsearchResult>>& rootsearchResults);
 };
 } // namespace SHOT
\ No newline at end of file
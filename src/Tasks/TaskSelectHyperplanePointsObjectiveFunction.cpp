@@ -21,6 +21,8 @@
 
 #include "../RootsearchMethod/IRootsearchMethod.h"
 
+#include <set>
+
 namespace SHOT
 {
 
@@ -36,7 +38,7 @@ void TaskSelectHyperplanePointsObjectiveFunction::run()
     this->run(env->results->getPreviousIteration()->solutionPoints);
 }
 
-void TaskSelectHyperplanePointsObjectiveFunction::run(std::vector<SolutionPoint> sourcePoints)
+void TaskSelectHyperplanePointsObjectiveFunction::run(const std::vector<SolutionPoint>& sourcePoints)
 {
     if(sourcePoints.size() == 0)
         return;
@@ -90,46 +92,57 @@ void TaskSelectHyperplanePointsObjectiveFunction::run(std::vector<SolutionPoint>
         && env->reformulatedProblem->properties.convexity > E_ProblemConvexity::Convex)
         useRootsearch = false;
 
+    auto objectiveFunction = env->reformulatedProblem->objectiveFunction;
+
+    int rootMaxIter = env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver");
+    double rootTerminationTolerance = env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver");
+
+    // The solution pool often contains the same point several times, so the objective function value and gradient are
+    // only calculated once per unique point. The cuts are then added to the dual problem in one batch.
+    std::set<uint64_t> evaluatedPointHashes;
+
     for(auto& SOLPT : sourcePoints)
     {
+        auto pointHash = Utilities::calculateHash(SOLPT.point);
+
+        if(!evaluatedPointHashes.insert(pointHash).second)
+            continue;
+
+        double exactValue = objectiveFunction->calculateValue(SOLPT.point);
+
+        Hyperplane hyperplane;
+        hyperplane.isObjectiveHyperplane = true;
+        hyperplane.sourceConstraintIndex = -1;
+        hyperplane.generatedPoint = SOLPT.point;
+        hyperplane.pointHash = pointHash;
+        hyperplane.isSourceConvex = isConvex;
+        hyperplane.sourceGradient = calculateObjectiveGradient(SOLPT.point);
+
         if(useRootsearch)
         {
             env->timing->startTimer("DualObjectiveRootSearch");
 
-            auto exactValue = env->reformulatedProblem->objectiveFunction->calculateValue(SOLPT.point);
-
             double factor = std::min(0.01, 1 / std::abs(SOLPT.objectiveValue));
             double objectiveLB = SOLPT.objectiveValue;
-            double objectiveUB = (exactValue < 0)
-                ? (1 - factor) * env->reformulatedProblem->objectiveFunction->calculateValue(SOLPT.point)
-                : (1 + factor) * env->reformulatedProblem->objectiveFunction->calculateValue(SOLPT.point);
+            double objectiveUB = (exactValue < 0) ? (1 - factor) * exactValue : (1 + factor) * exactValue;
 
             try
             {
                 PairDouble rootBound;
 
-                if(env->reformulatedProblem->objectiveFunction->properties.isMinimize)
+                if(objectiveFunction->properties.isMinimize)
                 {
-                    rootBound = env->rootsearchMethod->findZero(SOLPT.point, objectiveLB, objectiveUB,
-                        env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver"),
-                        env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver"), 0,
-                        env->reformulatedProblem->objectiveFunction);
+                    rootBound = env->rootsearchMethod->findZero(SOLPT.point, objectiveLB, objectiveUB, rootMaxIter,
+                        rootTerminationTolerance, 0, exactValue);
                 }
                 else
                 {
-                    rootBound = env->rootsearchMethod->findZero(SOLPT.point, objectiveUB, objectiveLB,
-                        env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver"),
-                        env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver"), 0,
-                        env->reformulatedProblem->objectiveFunction);
+                    rootBound = env->rootsearchMethod->findZero(SOLPT.point, objectiveUB, objectiveLB, rootMaxIter,
+                        rootTerminationTolerance, 0, exactValue);
                 }
 
-                Hyperplane hyperplane;
-                hyperplane.isObjectiveHyperplane = true;
                 hyperplane.source = E_HyperplaneSource::ObjectiveRootsearch;
-                hyperplane.sourceConstraintIndex = -1;
-                hyperplane.generatedPoint = SOLPT.point;
                 hyperplane.objectiveFunctionValue = rootBound.second;
-                hyperplane.isSourceConvex = isConvex;
 
                 env->dualSolver->addHyperplane(hyperplane);
                 numHyperplaneAdded++;
@@ -147,15 +160,8 @@ void TaskSelectHyperplanePointsObjectiveFunction::run(std::vector<SolutionPoint>
             }
         }
 
-        Hyperplane hyperplane;
-        hyperplane.isObjectiveHyperplane = true;
-        hyperplane.sourceConstraintIndex = -1;
-        hyperplane.generatedPoint = SOLPT.point;
         hyperplane.source = E_HyperplaneSource::ObjectiveCuttingPlane;
-        hyperplane.isSourceConvex = isConvex;
-
-        hyperplane.objectiveFunctionValue
-            = env->reformulatedProblem->objectiveFunction->calculateValue(hyperplane.generatedPoint);
+        hyperplane.objectiveFunctionValue = exactValue;
 
         env->dualSolver->addHyperplane(hyperplane);
         numHyperplaneAdded++;
@@ -172,6 +178,23 @@ void TaskSelectHyperplanePointsObjectiveFunction::run(std::vector<SolutionPoint>
     }
 }
 
+SparseGradient TaskSelectHyperplanePointsObjectiveFunction::calculateObjectiveGradient(const VectorDouble& point)
+{
+    auto objectiveGradient = env->reformulatedProblem->objectiveFunction->calculateGradient(point, true);
+
+    SparseGradient gradient;
+    gradient.indexes.reserve(objectiveGradient.size());
+    gradient.values.reserve(objectiveGradient.size());
+
+    for(auto const& G : objectiveGradient)
+    {
+        gradient.indexes.push_back(G.first->index);
+        gradient.values.push_back(G.second);
+    }
+
+    return (gradient);
+}
+
 std::string TaskSelectHyperplanePointsObjectiveFunction::getType()
 {
     std::string type = typeid(this).name();
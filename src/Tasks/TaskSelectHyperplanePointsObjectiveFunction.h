@@ -24,7 +24,10 @@ public:
     ~TaskSelectHyperplanePointsObjectiveFunction() override;
 
     void run() override;
-    virtual void run(std::vector<SolutionPoint> solPoints);
+    virtual void run(const std::vector<SolutionPoint>& solPoints);
     std::string getType() override;
+
+private:
+    SparseGradient calculateObjectiveGradient(const VectorDouble& point);
 };
 } // namespace SHOT
\ No newline at end of file
@@ -0,0 +1,402 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskSelectPrimalCandidatesFromFeasibilityPump.h"
+
+#include "../DualSolver.h"
+#include "../Iteration.h"
+#include "../MIPSolver/IMIPSolver.h"
+#include "../Output.h"
+#include "../PrimalSolver.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../Timing.h"
+#include "../Utilities.h"
+
+#include "../Model/Problem.h"
+#include "../NLPSolver/INLPSolver.h"
+
+#ifdef HAS_IPOPT
+#include "../NLPSolver/NLPSolverIpoptRelaxed.h"
+#endif
+
+#ifdef HAS_CPLEX
+#include "../MIPSolver/MIPSolverCplex.h"
+#endif
+
+#ifdef HAS_GUROBI
+#include "../MIPSolver/MIPSolverGurobi.h"
+#endif
+
+#ifdef HAS_CBC
+#include "../MIPSolver/MIPSolverCbc.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <unordered_set>
+#include <utility>
+
+namespace SHOT
+{
+
+TaskSelectPrimalCandidatesFromFeasibilityPump::TaskSelectPrimalCandidatesFromFeasibilityPump(EnvironmentPtr envPtr)
+    : TaskBase(envPtr)
+{
+}
+
+TaskSelectPrimalCandidatesFromFeasibilityPump::~TaskSelectPrimalCandidatesFromFeasibilityPump() = default;
+
+void TaskSelectPrimalCandidatesFromFeasibilityPump::run()
+{
+    if(hasRun || env->results->hasPrimalSolution())
+        return;
+
+    hasRun = true;
+
+    auto currIter = env->results->getCurrentIteration();
+
+    env->timing->startTimer("PrimalStrategy");
+    env->timing->startTimer("PrimalBoundStrategyFeasibilityPump");
+
+    env->output->outputDebug("        Starting feasibility pump.");
+
+    discreteVariableIndexes.clear();
+
+    for(auto& V : env->problem->allVariables)
+    {
+        if(V->properties.type == E_VariableType::Binary || V->properties.type == E_VariableType::Integer)
+            discreteVariableIndexes.push_back(V->index);
+    }
+
+    if(discreteVariableIndexes.size() == 0 || !createNLPSolver() || !createMIPSolver())
+    {
+        env->output->outputDebug("        Feasibility pump could not be initialized.");
+
+        env->timing->stopTimer("PrimalBoundStrategyFeasibilityPump");
+        env->timing->stopTimer("PrimalStrategy");
+        return;
+    }
+
+    double timeEnd = env->timing->getElapsedTime("Total")
+        + env->settings->getSetting<double>("FeasibilityPump.TimeLimit", "Primal");
+
+    int iterationLimit = env->settings->getSetting<int>("FeasibilityPump.IterationLimit", "Primal");
+    int numberOfFlips = env->settings->getSetting<int>("FeasibilityPump.Perturbation.NumberOfFlips", "Primal");
+
+    size_t numberOfVariables = env->problem->properties.numberOfVariables;
+
+    // The NLP point is initially the interior point, or otherwise a feasible point of the continuous relaxation
+    std::optional<VectorDouble> relaxedPoint;
+
+    if(env->dualSolver->interiorPts.size() > 0
+        && env->dualSolver->interiorPts[0]->point.size() >= numberOfVariables)
+    {
+        relaxedPoint = env->dualSolver->interiorPts[0]->point;
+        relaxedPoint->resize(numberOfVariables);
+    }
+    else
+    {
+        relaxedPoint = solveProjectionProblem(VectorDouble(numberOfVariables, 0.0), false);
+    }
+
+    // The fingerprints of the discrete values in the rounded points, to detect cycles
+    std::unordered_set<uint64_t> roundedPointHashes;
+
+    // A fixed seed makes the perturbations reproducible
+    std::mt19937 generator(0);
+
+    int iteration = 0;
+    bool isFound = false;
+
+    for(; relaxedPoint && iteration < iterationLimit; iteration++)
+    {
+        if(isIntegral(*relaxedPoint))
+        {
+            env->primalSolver->addPrimalSolutionCandidate(
+                *relaxedPoint, E_PrimalSolutionSource::FeasibilityPump, currIter->iterationNumber);
+
+            isFound = true;
+            break;
+        }
+
+        addOuterApproximationCuts(*relaxedPoint);
+
+        double timeLeft = timeEnd - env->timing->getElapsedTime("Total");
+
+        if(timeLeft <= 0.0)
+            break;
+
+        auto roundedPoint = solveRoundingProblem(*relaxedPoint, timeLeft);
+
+        // The rounding problem is infeasible if the linear constraints and cuts cannot be fulfilled
+        if(!roundedPoint)
+            break;
+
+        env->primalSolver->addPrimalSolutionCandidate(
+            *roundedPoint, E_PrimalSolutionSource::FeasibilityPump, currIter->iterationNumber);
+
+        if(env->results->hasPrimalSolution())
+        {
+            isFound = true;
+            break;
+        }
+
+        auto hash = Utilities::calculateHash(*roundedPoint, discreteVariableIndexes, 1.0);
+
+        if(!roundedPointHashes.insert(hash).second)
+        {
+            // The binary variables furthest away from the relaxed point are flipped to break the cycle
+            std::vector<std::pair<double, int>> distances;
+
+            for(auto I : discreteVariableIndexes)
+            {
+                if(env->problem->allVariables[I]->properties.type == E_VariableType::Binary)
+                    distances.emplace_back(std::abs(roundedPoint->at(I) - relaxedPoint->at(I)), I);
+            }
+
+            if(distances.size() == 0)
+                break;
+
+            std::sort(distances.begin(), distances.end(), std::greater<>());
+
+            std::uniform_int_distribution<int> distribution((numberOfFlips + 1) / 2, numberOfFlips);
+            size_t flips = std::min((size_t)distribution(generator), distances.size());
+
+            for(size_t k = 0; k < flips; k++)
+            {
+                int index = distances[k].second;
+                roundedPoint->at(index) = 1.0 - std::round(roundedPoint->at(index));
+            }
+
+            env->output->outputDebug(
+                fmt::format("        Feasibility pump cycled in iteration {}, flipped {} binary variables.",
+                    iteration + 1, flips));
+        }
+
+        if(env->timing->getElapsedTime("Total") >= timeEnd)
+            break;
+
+        relaxedPoint = solveProjectionProblem(*roundedPoint, true);
+    }
+
+    env->output->outputDebug(fmt::format("        Feasibility pump terminated after {} iterations, {}.", iteration,
+        isFound ? "a primal solution was found" : "no primal solution was found"));
+
+    // The solvers are not needed anymore
+    MIPSolver.reset();
+    NLPSolver.reset();
+    projectionProblem.reset();
+
+    env->timing->stopTimer("PrimalBoundStrategyFeasibilityPump");
+    env->timing->stopTimer("PrimalStrategy");
+}
+
+std::string TaskSelectPrimalCandidatesFromFeasibilityPump::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+
+bool TaskSelectPrimalCandidatesFromFeasibilityPump::createMIPSolver()
+{
+    [[maybe_unused]] auto solverType = static_cast<ES_MIPSolver>(env->settings->getSetting<int>("MIP.Solver", "Dual"));
+
+#ifdef HAS_CPLEX
+    if(solverType == ES_MIPSolver::Cplex)
+        MIPSolver = std::make_shared<MIPSolverCplex>(env);
+#endif
+
+#ifdef HAS_GUROBI
+    if(solverType == ES_MIPSolver::Gurobi)
+        MIPSolver = std::make_shared<MIPSolverGurobi>(env);
+#endif
+
+#ifdef HAS_CBC
+    if(!MIPSolver)
+        MIPSolver = std::make_shared<MIPSolverCbc>(env);
+#endif
+
+    if(!MIPSolver || !MIPSolver->initializeProblem())
+        return (false);
+
+    auto& sourceProblem = env->reformulatedProblem;
+    bool problemCreated = true;
+
+    for(auto& V : sourceProblem->allVariables)
+    {
+        problemCreated = problemCreated
+            && MIPSolver->addVariable(V->name.c_str(), V->properties.type, V->lowerBound, V->upperBound, V->semiBound);
+    }
+
+    problemCreated = problemCreated && MIPSolver->initializeObjective() && MIPSolver->finalizeObjective(true);
+
+    for(auto& C : sourceProblem->linearConstraints)
+    {
+        problemCreated = problemCreated && MIPSolver->initializeConstraint();
+
+        for(auto& T : C->linearTerms)
+            problemCreated = problemCreated && MIPSolver->addLinearTermToConstraint(T->coefficient, T->variable->index);
+
+        problemCreated
+            = problemCreated && MIPSolver->finalizeConstraint(C->name, C->valueLHS, C->valueRHS, C->constant);
+    }
+
+    problemCreated = problemCreated && MIPSolver->finalizeProblem();
+
+    if(!problemCreated)
+    {
+        MIPSolver.reset();
+        return (false);
+    }
+
+    MIPSolver->initializeSolverSettings();
+    MIPSolver->setSolutionLimit(2100000000);
+
+    // The cuts that have not yet been added to the dual problem are also valid outer approximations
+    for(auto& H : env->dualSolver->hyperplaneWaitingList)
+    {
+        if(!H.isObjectiveHyperplane && H.sourceConstraint)
+            MIPSolver->createHyperplane(H);
+    }
+
+    return (true);
+}
+
+bool TaskSelectPrimalCandidatesFromFeasibilityPump::createNLPSolver()
+{
+#ifdef HAS_IPOPT
+    // The objective function is replaced by the distance in each projection
+    projectionProblem = env->problem->createCopy(env, true, false, false, true);
+    NLPSolver = std::make_shared<NLPSolverIpoptRelaxed>(env, projectionProblem);
+
+    return (true);
+#else
+    return (false);
+#endif
+}
+
+void TaskSelectPrimalCandidatesFromFeasibilityPump::addOuterApproximationCuts(const VectorDouble& point)
+{
+    VectorDouble reformulatedPoint(point);
+
+    if(reformulatedPoint.size() < env->reformulatedProblem->allVariables.size())
+        env->reformulatedProblem->augmentAuxiliaryVariableValues(reformulatedPoint);
+
+    auto pointHash = Utilities::calculateHash(reformulatedPoint);
+
+    for(auto& C : env->reformulatedProblem->numericConstraints)
+    {
+        if(C->properties.classification <= E_ConstraintClassification::Linear)
+            continue;
+
+        Hyperplane hyperplane;
+        hyperplane.sourceConstraint = C;
+        hyperplane.sourceConstraintIndex = C->index;
+        hyperplane.generatedPoint = reformulatedPoint;
+        hyperplane.source = E_HyperplaneSource::PrimalSolutionSearch;
+        hyperplane.isSourceConvex = (C->properties.convexity <= E_Convexity::Convex);
+        hyperplane.pointHash = pointHash;
+
+        MIPSolver->createHyperplane(hyperplane);
+        env->dualSolver->addHyperplane(hyperplane);
+    }
+}
+
+std::optional<VectorDouble> TaskSelectPrimalCandidatesFromFeasibilityPump::solveRoundingProblem(
+    const VectorDouble& point, double timeLimit)
+{
+    MIPSolver->setTimeLimit(timeLimit);
+
+    if(!MIPSolver->replaceObjective(getDistanceTerms(point), true))
+        return (std::nullopt);
+
+    auto status = MIPSolver->solveProblem();
+
+    if(status != E_ProblemSolutionStatus::Optimal && status != E_ProblemSolutionStatus::Feasible
+        && status != E_ProblemSolutionStatus::SolutionLimit && status != E_ProblemSolutionStatus::TimeLimit)
+        return (std::nullopt);
+
+    if(MIPSolver->getNumberOfSolutions() == 0)
+        return (std::nullopt);
+
+    auto solution = MIPSolver->getVariableSolution(0);
+    solution.resize(env->problem->properties.numberOfVariables);
+
+    return (solution);
+}
+
+std::optional<VectorDouble> TaskSelectPrimalCandidatesFromFeasibilityPump::solveProjectionProblem(
+    const VectorDouble& point, bool useDistance)
+{
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+
+    if(useDistance)
+    {
+        for(auto& [index, coefficient] : getDistanceTerms(point))
+            objective->add(std::make_shared<LinearTerm>(coefficient, projectionProblem->getVariable(index)));
+    }
+
+    projectionProblem->add(objective);
+
+    VectorInteger startingPointIndexes(point.size());
+
+    for(size_t i = 0; i < point.size(); i++)
+        startingPointIndexes[i] = i;
+
+    NLPSolver->clearStartingPoint();
+    NLPSolver->setStartingPoint(startingPointIndexes, point);
+
+    auto status = NLPSolver->solveProblem();
+
+    if(status != E_NLPSolutionStatus::Optimal && status != E_NLPSolutionStatus::Feasible)
+    {
+        env->output->outputDebug("        Projection problem in feasibility pump could not be solved.");
+        return (std::nullopt);
+    }
+
+    auto solution = NLPSolver->getSolution();
+    solution.resize(env->problem->properties.numberOfVariables);
+
+    return (solution);
+}
+
+std::map<int, double> TaskSelectPrimalCandidatesFromFeasibilityPump::getDistanceTerms(const VectorDouble& point)
+{
+    std::map<int, double> terms;
+
+    double integerTolerance = env->settings->getSetting<double>("Tolerance.Integer", "Primal");
+
+    for(auto I : discreteVariableIndexes)
+    {
+        auto& V = env->problem->allVariables[I];
+        double value = point[I];
+
+        // |x - v| = v + (1 - 2v) x for a binary variable x
+        if(V->properties.type == E_VariableType::Binary)
+            terms.emplace(I, 1.0 - 2.0 * std::min(std::max(value, 0.0), 1.0));
+        else if(value <= V->lowerBound + integerTolerance)
+            terms.emplace(I, 1.0);
+        else if(value >= V->upperBound - integerTolerance)
+            terms.emplace(I, -1.0);
+    }
+
+    return (terms);
+}
+
+bool TaskSelectPrimalCandidatesFromFeasibilityPump::isIntegral(const VectorDouble& point)
+{
+    double integerTolerance = env->settings->getSetting<double>("Tolerance.Integer", "Primal");
+
+    return (std::all_of(discreteVariableIndexes.begin(), discreteVariableIndexes.end(),
+        [&](int I) { return (std::abs(point[I] - std::round(point[I])) <= integerTolerance); }));
+}
+} // namespace SHOT
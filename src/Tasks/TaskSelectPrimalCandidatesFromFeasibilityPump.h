@@ -0,0 +1,65 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include "../Structs.h"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace SHOT
+{
+class INLPSolver;
+
+// A feasibility pump for convex problems, run once before the first MIP problem is solved. It alternates between
+// rounding the relaxed point with a MIP problem over the linear constraints and the outer approximation cuts generated
+// in the relaxed points, and projecting the rounded point onto the continuous relaxation of the original problem with
+// an NLP problem. Both use the L1 distance in the discrete variables as objective. A cycle, i.e. a rounded point with
+// the same discrete values as an earlier one, is broken by flipping some of the binary variables at random. The
+// points found are given to the primal solver as solution candidates.
+class TaskSelectPrimalCandidatesFromFeasibilityPump : public TaskBase
+{
+public:
+    TaskSelectPrimalCandidatesFromFeasibilityPump(EnvironmentPtr envPtr);
+    ~TaskSelectPrimalCandidatesFromFeasibilityPump() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    bool createMIPSolver();
+    bool createNLPSolver();
+
+    // The point is in the variable space of the reformulated problem, and the cuts are also given to the dual solver
+    void addOuterApproximationCuts(const VectorDouble& point);
+
+    // The points are in the variable space of the original problem, and nothing is returned if the problem could not
+    // be solved. Without the distance, the projection problem finds a point in the continuous relaxation.
+    std::optional<VectorDouble> solveRoundingProblem(const VectorDouble& point, double timeLimit);
+    std::optional<VectorDouble> solveProjectionProblem(const VectorDouble& point, bool useDistance);
+
+    // The linear terms of the L1 distance to the point in the binary variables, and in the integer variables at one of
+    // their bounds, in the original problem. Other integer variables are not included.
+    std::map<int, double> getDistanceTerms(const VectorDouble& point);
+
+    bool isIntegral(const VectorDouble& point);
+
+    MIPSolverPtr MIPSolver;
+    std::shared_ptr<INLPSolver> NLPSolver;
+    ProblemPtr projectionProblem;
+
+    VectorInteger discreteVariableIndexes;
+    bool hasRun = false;
+};
+} // namespace SHOT
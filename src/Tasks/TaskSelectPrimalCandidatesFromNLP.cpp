@@ -10,6 +10,8 @@
 
 #include "TaskSelectPrimalCandidatesFromNLP.h"
 
+#include "../CancellationToken.h"
+#include "../DebugWriter.h"
 #include "../DualSolver.h"
 #include "../MIPSolver/IMIPSolver.h"
 #include "../Output.h"
@@ -18,11 +20,14 @@
 #include "../Results.h"
 #include "../Settings.h"
 #include "../Solver.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 #include "../Utilities.h"
 
+#include "../Model/FixedProblemReduction.h"
 #include "../Model/Problem.h"
 #include "../NLPSolver/INLPSolver.h"
+#include "../NLPSolver/FixedNLPExecutorSocket.h"
 
 #include "../Tasks/TaskSelectHyperplanePointsESH.h"
 #include "../Tasks/TaskSelectHyperplanePointsECP.h"
@@ -38,10 +43,19 @@
 
 #include "../NLPSolver/NLPSolverSHOT.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
 namespace SHOT
 {
 
-TaskSelectPrimalCandidatesFromNLP::TaskSelectPrimalCandidatesFromNLP(EnvironmentPtr envPtr, bool useReformulatedProblem)
+TaskSelectPrimalCandidatesFromNLP::TaskSelectPrimalCandidatesFromNLP(
+    EnvironmentPtr envPtr, bool useReformulatedProblem, bool allowAsynchronousSolves)
     : TaskBase(envPtr)
 {
     env->timing->startTimer("PrimalStrategy");
@@ -119,6 +133,31 @@ TaskSelectPrimalCandidatesFromNLP::TaskSelectPrimalCandidatesFromNLP(Environment
 
     env->results->usedPrimalNLPSolverDescription = NLPSolver->getSolverDescription();
 
+    // The executor also needs the results to be used later
+    if(allowAsynchronousSolves)
+    {
+        fixedNLPExecutor = env->fixedNLPExecutor;
+        auto remoteWorkers = env->settings->getSetting<std::string>("FixedInteger.RemoteWorkers", "Primal");
+
+        if(!fixedNLPExecutor && remoteWorkers != "")
+            fixedNLPExecutor = std::make_shared<FixedNLPExecutorSocket>(env, remoteWorkers);
+
+        if(fixedNLPExecutor && !fixedNLPExecutor->initialize(sourceProblem, sourceIsReformulatedProblem))
+        {
+            env->output->outputWarning("        Fixed NLP executor not available, the problems are solved locally.");
+            fixedNLPExecutor.reset();
+        }
+    }
+
+    // Only the Ipopt interface can be used from another thread
+    useAsynchronousSolves = allowAsynchronousSolves && !fixedNLPExecutor
+        && env->settings->getSetting<bool>("FixedInteger.Asynchronous", "Primal")
+        && env->results->usedPrimalNLPSolver == ES_PrimalNLPSolver::Ipopt;
+
+    // The reduced problems are solved with a new Ipopt solver each time
+    useReducedProblem = env->settings->getSetting<bool>("FixedInteger.ReduceProblem", "Primal")
+        && env->results->usedPrimalNLPSolver == ES_PrimalNLPSolver::Ipopt;
+
     this->originalIterFrequency = env->settings->getSetting<int>("FixedInteger.Frequency.Iteration", "Primal");
     this->originalTimeFrequency = env->settings->getSetting<double>("FixedInteger.Frequency.Time", "Primal");
 
@@ -155,10 +194,22 @@ TaskSelectPrimalCandidatesFromNLP::TaskSelectPrimalCandidatesFromNLP(Environment
     env->timing->stopTimer("PrimalStrategy");
 }
 
-TaskSelectPrimalCandidatesFromNLP::~TaskSelectPrimalCandidatesFromNLP() = default;
+TaskSelectPrimalCandidatesFromNLP::~TaskSelectPrimalCandidatesFromNLP() { stopAsynchronousSolver(); }
 
 void TaskSelectPrimalCandidatesFromNLP::run()
 {
+    if(fixedNLPExecutor)
+    {
+        runWithExecutor();
+        return;
+    }
+
+    if(useAsynchronousSolves)
+    {
+        runAsynchronously();
+        return;
+    }
+
     if(env->primalSolver->fixedPrimalNLPCandidates.size() == 0)
     {
         env->solutionStatistics.numberOfIterationsWithoutNLPCallMIP++;
@@ -188,12 +239,45 @@ std::string TaskSelectPrimalCandidatesFromNLP::getType()
     return (type);
 }
 
-bool TaskSelectPrimalCandidatesFromNLP::solveFixedNLP()
+void TaskSelectPrimalCandidatesFromNLP::updateVariableBounds(const VectorInteger& variableIndexes)
 {
-    auto currIter = env->results->getCurrentIteration();
+    std::lock_guard<std::mutex> lock(asynchronousMutex);
+
+    for(auto I : variableIndexes)
+    {
+        if(I >= (int)sourceProblem->allVariables.size())
+            continue;
+
+        auto& variable = sourceProblem->allVariables[I];
+        pendingVariableBounds[I] = PairDouble(variable->lowerBound, variable->upperBound);
+    }
+}
+
+void TaskSelectPrimalCandidatesFromNLP::updateVariableBounds(const std::map<int, PairDouble>& variableBounds)
+{
+    std::lock_guard<std::mutex> lock(asynchronousMutex);
 
-    std::vector<PrimalFixedNLPCandidate> testPts;
+    for(auto& B : variableBounds)
+    {
+        if(B.first >= 0 && B.first < (int)sourceProblem->allVariables.size())
+            pendingVariableBounds[B.first] = B.second;
+    }
+}
+
+void TaskSelectPrimalCandidatesFromNLP::updateVariableBounds(
+    INLPSolver& solver, const std::map<int, PairDouble>& variableBounds)
+{
+    for(auto& B : variableBounds)
+    {
+        solver.updateVariableLowerBound(B.first, B.second.first);
+        solver.updateVariableUpperBound(B.first, B.second.second);
 
+        updatedVariableBounds[B.first] = B.second;
+    }
+}
+
+bool TaskSelectPrimalCandidatesFromNLP::solveFixedNLP()
+{
     env->output->outputDebug("        Solving fixed NLP problem:");
 
     if(env->primalSolver->fixedPrimalNLPCandidates.size() == 0)
@@ -203,304 +287,925 @@ bool TaskSelectPrimalCandidatesFromNLP::solveFixedNLP()
         return (false);
     }
 
+    updateToleranceSchedule();
+
+    // The other thread is not running here, so all solvers can be updated
+    std::map<int, PairDouble> variableBounds;
+
+    {
+        std::lock_guard<std::mutex> lock(asynchronousMutex);
+        variableBounds.swap(pendingVariableBounds);
+    }
+
+    if(variableBounds.size() > 0)
+    {
+        updateVariableBounds(*NLPSolver, variableBounds);
+
+        for(auto& S : workerNLPSolvers)
+            updateVariableBounds(*S, variableBounds);
+    }
+
+    int numberOfThreads = 1;
+
+    if(env->results->usedPrimalNLPSolver == ES_PrimalNLPSolver::Ipopt)
+    {
+        numberOfThreads = env->settings->getSetting<int>("FixedInteger.NumberOfThreads", "Primal");
+
+        numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+#ifdef HAS_IPOPT
+        // The solves would be made one at a time anyway
+        if(numberOfThreads > 1 && !NLPSolverIpoptBase::isLinearSolverThreadSafe(env))
+            numberOfThreads = 1;
+#endif
+    }
+
+    if(numberOfThreads > 1 && env->primalSolver->fixedPrimalNLPCandidates.size() > 1)
+    {
+        // The candidates may be modified while the problems are solved
+        auto candidates = env->primalSolver->fixedPrimalNLPCandidates;
+        solveFixedNLPsInParallel(candidates, numberOfThreads);
+
+        return (true);
+    }
+
     int counter = 0;
 
     for(auto& CAND : env->primalSolver->fixedPrimalNLPCandidates)
     {
-        VectorDouble fixedVariableValues(discreteVariableIndexes.size());
+        if(env->cancellationToken->isCancelled())
+            break;
 
-        int sizeOfVariableVector = sourceProblem->properties.numberOfVariables;
+        auto result = solveFixedNLP(*NLPSolver, CAND, counter);
+        processFixedNLPResult(CAND, result);
+        env->primalSolver->addUsedFixedNLPCandidate(CAND);
+        updateFixedNLPFrequency(result);
 
-        // TODO: remove?
-        if(env->settings->getSetting<bool>("FixedInteger.UsePresolveBounds", "Primal"))
-        {
-            env->output->outputDebug("         Updating variable bounds from MIP presolve.");
-            for(auto& V : env->reformulatedProblem->allVariables)
-            {
-                if(V->index > sizeOfVariableVector)
-                    continue;
+        counter++;
+    }
 
-                if(V->properties.hasUpperBoundBeenTightened)
-                {
-                    NLPSolver->updateVariableUpperBound(V->index, V->upperBound);
-                }
+    return (true);
+}
 
-                if(V->properties.hasLowerBoundBeenTightened)
-                {
-                    NLPSolver->updateVariableLowerBound(V->index, V->upperBound);
-                }
-            }
+void TaskSelectPrimalCandidatesFromNLP::runAsynchronously()
+{
+    env->timing->startTimer("PrimalStrategy");
+    env->timing->startTimer("PrimalBoundStrategyNLP");
+
+    // When terminating, the problem currently being solved is finished and the candidates not started are discarded
+    bool isTerminating = (env->results->terminationReason != E_TerminationReason::None);
+
+    if(isTerminating)
+        stopAsynchronousSolver();
+
+    processAsynchronousResults();
+    updateToleranceSchedule();
+
+    if(env->primalSolver->fixedPrimalNLPCandidates.size() == 0
+        || env->results->getRelativeGlobalObjectiveGap() < 1e-10)
+    {
+        env->solutionStatistics.numberOfIterationsWithoutNLPCallMIP++;
+    }
+    else if(isTerminating || !asynchronousThread.joinable())
+    {
+        // The first candidates are solved by this thread, which also initializes the data that is shared with the
+        // other thread, e.g. the sparsity patterns of the problem
+        solveFixedNLP();
+
+        if(!isTerminating)
+            startAsynchronousSolver();
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(asynchronousMutex);
+
+        for(auto& CAND : env->primalSolver->fixedPrimalNLPCandidates)
+        {
+            asynchronousCandidates.push_back(CAND);
+
+            // So that the same candidate is not added again before it has been solved
+            env->primalSolver->addUsedFixedNLPCandidate(CAND);
         }
 
-        VectorInteger startingPointIndexes(sizeOfVariableVector);
-        VectorDouble startingPointValues(sizeOfVariableVector);
+        env->output->outputDebug(fmt::format("        Added {} candidates for fixed NLP problems, {} waiting.",
+            env->primalSolver->fixedPrimalNLPCandidates.size(), asynchronousCandidates.size()));
+
+        asynchronousCandidateAvailable.notify_one();
+    }
+
+    env->timing->stopTimer("PrimalBoundStrategyNLP");
+    env->timing->stopTimer("PrimalStrategy");
+}
+
+void TaskSelectPrimalCandidatesFromNLP::runWithExecutor()
+{
+    env->timing->startTimer("PrimalStrategy");
+    env->timing->startTimer("PrimalBoundStrategyNLP");
+
+    for(auto& [ID, result] : fixedNLPExecutor->getFinishedResults())
+    {
+        auto candidate = submittedCandidates.find(ID);
+
+        if(candidate == submittedCandidates.end())
+            continue;
+
+        processFixedNLPResult(candidate->second, result);
+        updateFixedNLPFrequency(result);
+        submittedCandidates.erase(candidate);
+    }
 
-        // Sets the fixed values for discrete variables
-        for(size_t k = 0; k < discreteVariableIndexes.size(); k++)
+    updateToleranceSchedule();
+
+    if(env->results->terminationReason != E_TerminationReason::None)
+    {
+        // The candidates not yet solved are discarded when terminating
+        fixedNLPExecutor->cancel();
+    }
+    else if(env->primalSolver->fixedPrimalNLPCandidates.size() == 0
+        || env->results->getRelativeGlobalObjectiveGap() < 1e-10)
+    {
+        env->solutionStatistics.numberOfIterationsWithoutNLPCallMIP++;
+    }
+    else
+    {
+        std::map<int, PairDouble> variableBounds;
+
+        {
+            std::lock_guard<std::mutex> lock(asynchronousMutex);
+            variableBounds.swap(pendingVariableBounds);
+        }
+
+        // The local solver is used for the candidates that cannot be submitted
+        if(variableBounds.size() > 0)
         {
-            int currVarIndex = discreteVariableIndexes.at(k);
+            fixedNLPExecutor->updateVariableBounds(variableBounds);
+            updateVariableBounds(*NLPSolver, variableBounds);
+        }
 
-            auto tmpSolPt = std::round(CAND.point.at(currVarIndex));
+        bool isSubmitted = true;
+        int counter = 0;
 
-            fixedVariableValues.at(k) = tmpSolPt;
+        for(auto& CAND : env->primalSolver->fixedPrimalNLPCandidates)
+        {
+            // So that the same candidate is not added again before it has been solved
+            env->primalSolver->addUsedFixedNLPCandidate(CAND);
 
-            // Sets the starting point to the fixed value
-            if(env->settings->getSetting<bool>("FixedInteger.Warmstart", "Primal"))
+            if(isSubmitted && (isSubmitted = fixedNLPExecutor->submit(nextSubmittedCandidateID, CAND.point)))
             {
-                startingPointIndexes.at(currVarIndex) = currVarIndex;
-                startingPointValues.at(currVarIndex) = tmpSolPt;
+                submittedCandidates.emplace(nextSubmittedCandidateID++, CAND);
+                continue;
             }
+
+            auto result = solveFixedNLP(*NLPSolver, CAND, counter);
+            processFixedNLPResult(CAND, result);
+            updateFixedNLPFrequency(result);
+
+            counter++;
         }
 
-        if(env->settings->getSetting<bool>("FixedInteger.Warmstart", "Primal"))
+        env->output->outputDebug("        Submitted fixed NLP problems, {} waiting for results.",
+            submittedCandidates.size());
+    }
+
+    env->timing->stopTimer("PrimalBoundStrategyNLP");
+    env->timing->stopTimer("PrimalStrategy");
+}
+
+void TaskSelectPrimalCandidatesFromNLP::startAsynchronousSolver()
+{
+    stopAsynchronousThread = false;
+
+    asynchronousThread = std::thread([this]() {
+        int counter = 0;
+
+        while(true)
         {
-            env->output->outputDebug(
-                "         Setting warm start for continuous variable to candidate solution value.");
+            std::unique_lock<std::mutex> lock(asynchronousMutex);
+            asynchronousCandidateAvailable.wait(
+                lock, [&] { return (stopAsynchronousThread || !asynchronousCandidates.empty()); });
 
-            for(auto& V : sourceProblem->realVariables)
+            if(stopAsynchronousThread)
+                break;
+
+            auto candidate = std::move(asynchronousCandidates.front());
+            asynchronousCandidates.pop_front();
+
+            std::map<int, PairDouble> variableBounds;
+            variableBounds.swap(pendingVariableBounds);
+            lock.unlock();
+
+            updateVariableBounds(*NLPSolver, variableBounds);
+
+            FixedNLPResult result;
+
+            try
             {
-                startingPointIndexes.at(V->index) = V->index;
-                startingPointValues.at(V->index) = CAND.point.at(V->index);
+                result = solveFixedNLP(*NLPSolver, candidate, counter);
             }
-
-            if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
+            catch(std::exception& e)
             {
-                auto filename = fmt::format("{}/primalnlp{}_warmstart_{}.txt",
-                    env->settings->getSetting<std::string>("Debug.Path", "Output"),
-                    env->results->getCurrentIteration()->iterationNumber - 1, counter);
-
-                Utilities::saveVariablePointVectorToFile(startingPointValues, variableNames, filename);
+                env->output->outputError("        Error when solving fixed NLP problem:", e.what());
             }
 
-            NLPSolver->setStartingPoint(startingPointIndexes, startingPointValues);
+            counter++;
+
+            lock.lock();
+            asynchronousResults.emplace_back(std::move(candidate), std::move(result));
         }
+    });
+}
 
-        NLPSolver->fixVariables(discreteVariableIndexes, fixedVariableValues);
+void TaskSelectPrimalCandidatesFromNLP::stopAsynchronousSolver()
+{
+    if(!asynchronousThread.joinable())
+        return;
 
-        if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
-        {
-            std::string filename = env->settings->getSetting<std::string>("Debug.Path", "Output") + "/primalnlp"
-                + std::to_string(currIter->iterationNumber) + "_" + std::to_string(counter);
-            NLPSolver->saveProblemToFile(filename + ".txt");
-            NLPSolver->saveOptionsToFile(filename + ".osrl");
-        }
+    {
+        std::lock_guard<std::mutex> lock(asynchronousMutex);
+        stopAsynchronousThread = true;
+        asynchronousCandidates.clear();
+    }
 
-        auto solvestatus = NLPSolver->solveProblem();
+    asynchronousCandidateAvailable.notify_one();
+    asynchronousThread.join();
+}
 
-        NLPSolver->unfixVariables();
-        env->solutionStatistics.numberOfProblemsFixedNLP++;
+void TaskSelectPrimalCandidatesFromNLP::processAsynchronousResults()
+{
+    std::deque<std::pair<PrimalFixedNLPCandidate, FixedNLPResult>> finishedResults;
 
-        std::string source = (sourceIsReformulatedProblem) ? "R" : "O";
+    {
+        std::lock_guard<std::mutex> lock(asynchronousMutex);
+        finishedResults.swap(asynchronousResults);
+    }
+
+    // The candidates have already been marked as used when they were added
+    for(auto& [candidate, result] : finishedResults)
+    {
+        processFixedNLPResult(candidate, result);
+        updateFixedNLPFrequency(result);
+    }
+}
 
-        std::string sourceDesc;
-        switch(CAND.sourceType)
+void TaskSelectPrimalCandidatesFromNLP::solveFixedNLPsInParallel(
+    const std::vector<PrimalFixedNLPCandidate>& candidates, int numberOfThreads)
+{
+    // The first problem is solved by this thread, which also initializes the data that is shared by the solvers, e.g.
+    // the sparsity patterns of the problem
+    auto firstResult = solveFixedNLP(*NLPSolver, candidates[0], 0);
+    processFixedNLPResult(candidates[0], firstResult);
+    env->primalSolver->addUsedFixedNLPCandidate(candidates[0]);
+
+    std::vector<FixedNLPResult> results { firstResult };
+
+    numberOfThreads = std::min(numberOfThreads, (int)candidates.size() - 1);
+
+#ifdef HAS_IPOPT
+    while((int)workerNLPSolvers.size() < numberOfThreads)
+    {
+        std::shared_ptr<INLPSolver> solver = std::make_shared<NLPSolverIpoptRelaxed>(env, sourceProblem);
+
+        for(auto& V : sourceProblem->allVariables)
         {
-        case E_PrimalNLPSource::FirstSolution:
-            env->output->outputDebug("         Source from candidate point is first MIP solution point.");
-            sourceDesc = "SOLPT-" + source;
-            break;
-        case E_PrimalNLPSource::FeasibleSolution:
-            env->output->outputDebug("         Source from candidate point is MIP solution pool.");
-            sourceDesc = "FEASP-" + source;
-            break;
-        case E_PrimalNLPSource::InfeasibleSolution:
-            env->output->outputDebug("         Source from candidate point is infeasible MIP solution.");
-            sourceDesc = "UNFEA-" + source;
-            break;
-        case E_PrimalNLPSource::SmallestDeviationSolution:
-            env->output->outputDebug(
-                "         Source from candidate point is MIP solution with smallest nonlinear error.");
-            sourceDesc = "SMDEV-" + source;
-            break;
-        case E_PrimalNLPSource::FirstSolutionNewDualBound:
-            env->output->outputDebug(
-                "         Source from candidate point is first MIP solution point which gave dual bound update.");
-            sourceDesc = "NEWDB-" + source;
-            break;
-        default:
-            break;
+            solver->updateVariableLowerBound(V->index, V->lowerBound);
+            solver->updateVariableUpperBound(V->index, V->upperBound);
         }
 
-        switch(solvestatus)
+        workerNLPSolvers.push_back(solver);
+    }
+#endif
+
+    numberOfThreads = std::min(numberOfThreads, (int)workerNLPSolvers.size());
+
+    if(numberOfThreads == 0)
+    {
+        for(size_t k = 1; k < candidates.size(); k++)
         {
-        case E_NLPSolutionStatus::Optimal:
-            env->output->outputDebug(fmt::format(
-                "         Optimal solution {} found to fixed NLP problem.", NLPSolver->getObjectiveValue()));
-            break;
+            auto result = solveFixedNLP(*NLPSolver, candidates[k], k);
+            processFixedNLPResult(candidates[k], result);
+            env->primalSolver->addUsedFixedNLPCandidate(candidates[k]);
+            updateFixedNLPFrequency(result);
+        }
 
-        case E_NLPSolutionStatus::Feasible:
-            env->output->outputDebug(fmt::format(
-                "         Feasible solution {} found to fixed NLP problem.", NLPSolver->getObjectiveValue()));
-            break;
+        updateFixedNLPFrequency(firstResult);
+        return;
+    }
 
-        case E_NLPSolutionStatus::Infeasible:
-            env->output->outputDebug("         Fixed NLP problem is infeasible.");
-            break;
+    std::mutex resultMutex;
+    std::condition_variable resultAvailable;
+    std::deque<std::pair<size_t, FixedNLPResult>> finishedResults;
+    int activeThreads = numberOfThreads;
 
-        case E_NLPSolutionStatus::Unbounded:
-            env->output->outputDebug("         Fixed NLP problem is unbounded.");
-            break;
+    // With Parallel.Deterministic, each worker solves the same candidates whatever the timing, and the results are used
+    // in the order of the candidates. All the problems are then solved, since the states of the workers would
+    // otherwise depend on how many problems they had solved when the gap tolerance was met.
+    bool isDeterministic = ThreadPlacement::isDeterministic(env->settings);
+    ThreadPlacement::WorkQueue candidateQueue(env->settings, candidates.size(), numberOfThreads, 1);
 
-        case E_NLPSolutionStatus::TimeLimit:
-            env->output->outputDebug("         Time limit hit when solving fixed NLP problem.");
-            break;
+    std::atomic<bool> stopSolving(
+        env->results->isRelativeObjectiveGapToleranceMet() || env->results->isAbsoluteObjectiveGapToleranceMet());
 
-        case E_NLPSolutionStatus::IterationLimit:
-            env->output->outputDebug("         Iteration limit hit when solving fixed NLP problem.");
-            break;
+    std::vector<std::thread> threads;
+    threads.reserve(numberOfThreads);
 
-        case E_NLPSolutionStatus::Error:
-            env->output->outputDebug("         Error ocurred when solving fixed NLP problem.");
-            break;
+    for(int i = 0; i < numberOfThreads; i++)
+    {
+        threads.emplace_back([&, i]() {
+            ThreadPlacement::pinThread(env->settings, i);
+
+            for(size_t k;
+                 !stopSolving && !env->cancellationToken->isCancelled() && candidateQueue.getNextItem(i, k);)
+            {
+                FixedNLPResult result;
 
-        default:
+                try
+                {
+                    result = solveFixedNLP(*workerNLPSolvers[i], candidates[k], k);
+                }
+                catch(std::exception& e)
+                {
+                    env->output->outputError("        Error when solving fixed NLP problem:", e.what());
+                }
+
+                std::lock_guard<std::mutex> lock(resultMutex);
+                finishedResults.emplace_back(k, std::move(result));
+                resultAvailable.notify_one();
+            }
 
+            std::lock_guard<std::mutex> lock(resultMutex);
+            activeThreads--;
+            resultAvailable.notify_one();
+        });
+    }
+
+    bool isGapToleranceMet = false;
+
+    auto useResult = [&](size_t k, FixedNLPResult& result) {
+        processFixedNLPResult(candidates[k], result);
+        env->primalSolver->addUsedFixedNLPCandidate(candidates[k]);
+        results.push_back(std::move(result));
+
+        isGapToleranceMet = env->results->isRelativeObjectiveGapToleranceMet()
+            || env->results->isAbsoluteObjectiveGapToleranceMet();
+
+        // The problems that have not been started yet are not needed anymore
+        if(isGapToleranceMet && !isDeterministic)
+            stopSolving = true;
+    };
+
+    std::map<size_t, FixedNLPResult> waitingResults;
+    size_t nextResult = 1;
+
+    // The results are used by this thread in the order they are finished
+    while(true)
+    {
+        std::unique_lock<std::mutex> lock(resultMutex);
+        resultAvailable.wait(lock, [&] { return (!finishedResults.empty() || activeThreads == 0); });
+
+        if(finishedResults.empty())
             break;
+
+        auto finished = std::move(finishedResults.front());
+        finishedResults.pop_front();
+        lock.unlock();
+
+        if(!isDeterministic)
+        {
+            useResult(finished.first, finished.second);
+            continue;
         }
 
-        if(solvestatus == E_NLPSolutionStatus::Feasible || solvestatus == E_NLPSolutionStatus::Optimal)
+        waitingResults.emplace(finished.first, std::move(finished.second));
+
+        while(!isGapToleranceMet && !waitingResults.empty() && waitingResults.begin()->first == nextResult)
         {
-            double tmpObj = NLPSolver->getObjectiveValue();
-            auto variableSolution = NLPSolver->getSolution();
+            useResult(nextResult, waitingResults.begin()->second);
+            waitingResults.erase(waitingResults.begin());
+            nextResult++;
+        }
+    }
 
-            env->primalSolver->addPrimalSolutionCandidate(
-                variableSolution, E_PrimalSolutionSource::NLPFixedIntegers, currIter->iterationNumber);
+    for(auto& T : threads)
+        T.join();
 
-            if(sourceProblem->properties.numberOfNonlinearConstraints > 0
-                || sourceProblem->properties.numberOfQuadraticConstraints > 0)
-            {
-                auto mostDevConstr = sourceProblem->getMostDeviatingNonlinearOrQuadraticConstraint(variableSolution);
+    env->output->outputDebug(fmt::format("        Solved {} fixed NLP problems of {} using {} additional threads",
+        results.size(), candidates.size(), numberOfThreads));
+
+    // Changes the settings only after the other threads have finished, since they read the settings
+    for(auto& R : results)
+        updateFixedNLPFrequency(R);
+}
+
+FixedNLPResult TaskSelectPrimalCandidatesFromNLP::solveFixedNLPCandidate(const PrimalFixedNLPCandidate& candidate)
+{
+    std::map<int, PairDouble> variableBounds;
+
+    {
+        std::lock_guard<std::mutex> lock(asynchronousMutex);
+        variableBounds.swap(pendingVariableBounds);
+    }
+
+    updateVariableBounds(*NLPSolver, variableBounds);
+    updateToleranceSchedule();
+
+    return (solveFixedNLP(*NLPSolver, candidate, numberOfSingleCandidatesSolved++));
+}
+
+void TaskSelectPrimalCandidatesFromNLP::useFixedNLPResult(
+    const PrimalFixedNLPCandidate& candidate, const FixedNLPResult& result)
+{
+    processFixedNLPResult(candidate, result);
+    updateFixedNLPFrequency(result);
+}
+
+FixedNLPResult TaskSelectPrimalCandidatesFromNLP::solveFixedNLP(
+    INLPSolver& solver, const PrimalFixedNLPCandidate& candidate, int counter)
+{
+    if(useReducedProblem)
+        return (solveReducedFixedNLP(candidate));
+
+    VectorDouble fixedVariableValues(discreteVariableIndexes.size());
 
-                env->output->outputDebug(fmt::format("         Max error {} from nonlinear or quadratic constraint {}.",
-                    mostDevConstr->normalizedValue, mostDevConstr->constraint->name));
+    int sizeOfVariableVector = sourceProblem->properties.numberOfVariables;
 
-                env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
-                    ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
-                    currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
-                    env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(),
-                    tmpObj, mostDevConstr->constraint->index, mostDevConstr->normalizedValue,
-                    E_IterationLineType::PrimalNLP);
+    // TODO: remove?
+    if(env->settings->getSetting<bool>("FixedInteger.UsePresolveBounds", "Primal"))
+    {
+        env->output->outputDebug("         Updating variable bounds from MIP presolve.");
+        for(auto& V : env->reformulatedProblem->allVariables)
+        {
+            if(V->index > sizeOfVariableVector)
+                continue;
+
+            if(V->properties.hasUpperBoundBeenTightened)
+            {
+                solver.updateVariableUpperBound(V->index, V->upperBound);
             }
-            else
+
+            if(V->properties.hasLowerBoundBeenTightened)
             {
-                env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
-                    ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
-                    currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
-                    env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(),
-                    tmpObj,
-                    -1, // Not shown
-                    0.0, // Not shown
-                    E_IterationLineType::PrimalNLP);
+                solver.updateVariableLowerBound(V->index, V->upperBound);
             }
+        }
+    }
 
-            // Add integer cut.
-            if(env->settings->getSetting<bool>("HyperplaneCuts.UseIntegerCuts", "Dual")
-                && sourceProblem->properties.numberOfDiscreteVariables > 0)
-                createIntegerCut(CAND.point);
+    VectorInteger startingPointIndexes(sizeOfVariableVector);
+    VectorDouble startingPointValues(sizeOfVariableVector);
 
-            if(env->settings->getSetting<bool>("FixedInteger.CreateInfeasibilityCut", "Primal"))
-                createInfeasibilityCut(variableSolution);
+    // Sets the fixed values for discrete variables
+    for(size_t k = 0; k < discreteVariableIndexes.size(); k++)
+    {
+        int currVarIndex = discreteVariableIndexes.at(k);
+
+        auto tmpSolPt = std::round(candidate.point.at(currVarIndex));
+
+        fixedVariableValues.at(k) = tmpSolPt;
+
+        // Sets the starting point to the fixed value
+        if(env->settings->getSetting<bool>("FixedInteger.Warmstart", "Primal"))
+        {
+            startingPointIndexes.at(currVarIndex) = currVarIndex;
+            startingPointValues.at(currVarIndex) = tmpSolPt;
+        }
+    }
+
+    if(env->settings->getSetting<bool>("FixedInteger.Warmstart", "Primal"))
+    {
+        env->output->outputDebug(
+            "         Setting warm start for continuous variable to candidate solution value.");
+
+        for(auto& V : sourceProblem->realVariables)
+        {
+            startingPointIndexes.at(V->index) = V->index;
+            startingPointValues.at(V->index) = candidate.point.at(V->index);
         }
-        else if(solvestatus == E_NLPSolutionStatus::Error || solvestatus == E_NLPSolutionStatus::Unbounded
-            || solvestatus == E_NLPSolutionStatus::Infeasible)
+
+        if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
         {
-            env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP, ("NLP" + sourceDesc),
-                env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded, currIter->totNumHyperplanes,
-                env->results->getCurrentDualBound(), env->results->getPrimalBound(),
-                env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(), NAN, -1,
-                NAN, E_IterationLineType::PrimalNLP);
+            auto filename = fmt::format("{}/primalnlp{}_warmstart_{}.txt",
+                env->settings->getSetting<std::string>("Debug.Path", "Output"),
+                candidate.iterFound, counter);
+
+            env->debugWriter->writePoint(startingPointValues, variableNames, filename);
         }
-        else if(sourceProblem->properties.numberOfNonlinearConstraints > 0
-            || sourceProblem->properties.numberOfQuadraticConstraints > 0)
+
+        solver.setStartingPoint(startingPointIndexes, startingPointValues);
+    }
+
+    FixedNLPResult result;
+
+    bool useToleranceSchedule = env->settings->getSetting<bool>("FixedInteger.ToleranceSchedule.Use", "Primal");
+
+    // The objective is bounded over the variable bounds with the discrete variables fixed, and if it cannot be better
+    // than the primal bound, neither can the solution of the problem
+    if(useToleranceSchedule && !std::isnan(scheduledPrimalBound))
+    {
+        auto lowerBounds = solver.getVariableLowerBounds();
+        auto upperBounds = solver.getVariableUpperBounds();
+
+        if((int)lowerBounds.size() >= sizeOfVariableVector && (int)upperBounds.size() >= sizeOfVariableVector)
         {
-            double tmpObj = NLPSolver->getObjectiveValue();
+            IntervalVector variableBounds(sizeOfVariableVector);
+
+            for(int i = 0; i < sizeOfVariableVector; i++)
+                variableBounds[i] = Interval(lowerBounds[i], upperBounds[i]);
 
-            auto variableSolution = NLPSolver->getSolution();
+            for(size_t k = 0; k < discreteVariableIndexes.size(); k++)
+                variableBounds[discreteVariableIndexes[k]] = Interval(fixedVariableValues[k]);
 
-            if(variableSolution.size() > 0)
+            try
             {
-                auto mostDevConstr = sourceProblem->getMostDeviatingNonlinearOrQuadraticConstraint(variableSolution);
+                auto objectiveBounds = sourceProblem->objectiveFunction->calculateValue(variableBounds);
 
-                if(env->settings->getSetting<bool>("FixedInteger.CreateInfeasibilityCut", "Primal"))
-                    createInfeasibilityCut(variableSolution);
+                double objectiveBound = (sourceProblem->objectiveFunction->properties.isMinimize)
+                    ? objectiveBounds.l()
+                    : objectiveBounds.u();
+
+                if(!canImprovePrimalBound(objectiveBound, 0.0))
+                {
+                    env->output->outputDebug(fmt::format(
+                        "         Objective bound {} of fixed NLP problem cannot improve primal bound {}.",
+                        objectiveBound, scheduledPrimalBound.load()));
 
-                env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
-                    ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
-                    currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
-                    env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(),
-                    tmpObj, mostDevConstr->constraint->index, mostDevConstr->normalizedValue,
-                    E_IterationLineType::PrimalNLP);
+                    result.isAbandoned = true;
+                    return (result);
+                }
             }
-            else
+            catch(const mc::Interval::Exceptions&)
             {
-                env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
-                    ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
-                    currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
-                    env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(), NAN,
-                    -1, NAN, E_IterationLineType::PrimalNLP);
             }
         }
-        else
+    }
+
+    solver.fixVariables(discreteVariableIndexes, fixedVariableValues);
+
+    if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
+    {
+        std::string filename = env->settings->getSetting<std::string>("Debug.Path", "Output") + "/primalnlp"
+            + std::to_string(candidate.iterFound) + "_" + std::to_string(counter);
+        solver.saveProblemToFile(filename + ".txt");
+        solver.saveOptionsToFile(filename + ".osrl");
+    }
+
+    bool isLooseSolve = useToleranceSchedule && useLooseTolerances
+        && solver.setScreeningTolerances(
+            env->settings->getSetting<double>("FixedInteger.ToleranceSchedule.RelativeTolerance", "Primal"),
+            env->settings->getSetting<int>("FixedInteger.ToleranceSchedule.MaxIterations", "Primal"));
+
+    result.status = solver.solveProblem();
+    result.objectiveValue = solver.getObjectiveValue();
+    result.solution = solver.getSolution();
+
+    if(isLooseSolve)
+    {
+        solver.resetTolerances();
+
+        // Only the solutions that may improve the primal bound are solved again with the normal tolerances, starting
+        // from the solution found
+        double tolerance
+            = env->settings->getSetting<double>("FixedInteger.ToleranceSchedule.RelativeTolerance", "Primal")
+            * std::max(1.0, std::abs(result.objectiveValue));
+
+        if((result.status == E_NLPSolutionStatus::Optimal || result.status == E_NLPSolutionStatus::Feasible)
+            && (int)result.solution.size() == sizeOfVariableVector
+            && canImprovePrimalBound(result.objectiveValue, tolerance))
         {
+            env->output->outputDebug(fmt::format(
+                "         Solving fixed NLP problem with solution {} again with normal tolerances.",
+                result.objectiveValue));
 
-            auto variableSolution = NLPSolver->getSolution();
+            VectorInteger solutionIndexes(sizeOfVariableVector);
+            std::iota(solutionIndexes.begin(), solutionIndexes.end(), 0);
+            solver.setStartingPoint(solutionIndexes, result.solution);
 
-            if(variableSolution.size() > 0)
+            auto status = solver.solveProblem();
+
+            // The solution from the looser tolerances is used if the problem could not be solved again
+            if(status == E_NLPSolutionStatus::Optimal || status == E_NLPSolutionStatus::Feasible)
             {
-                env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
-                    ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
-                    currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
-                    env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(), NAN,
-                    -1, NAN, E_IterationLineType::PrimalNLP);
+                result.status = status;
+                result.objectiveValue = solver.getObjectiveValue();
+                result.solution = solver.getSolution();
             }
         }
+    }
+
+    solver.unfixVariables();
+
+    return (result);
+}
+
+FixedNLPResult TaskSelectPrimalCandidatesFromNLP::solveReducedFixedNLP(const PrimalFixedNLPCandidate& candidate)
+{
+    FixedNLPResult result;
+
+    VectorDouble fixedVariableValues(discreteVariableIndexes.size());
+
+    for(size_t k = 0; k < discreteVariableIndexes.size(); k++)
+        fixedVariableValues[k] = std::round(candidate.point.at(discreteVariableIndexes[k]));
+
+    FixedProblemReduction reduction(env, sourceProblem);
+    reduction.variableBounds = updatedVariableBounds;
+
+    if(!reduction.createReducedProblem(discreteVariableIndexes, fixedVariableValues, candidate.point))
+    {
+        result.status = E_NLPSolutionStatus::Infeasible;
+        return (result);
+    }
+
+    auto reducedProblem = reduction.getReducedProblem();
+
+    // All variables have been fixed or removed, and the point fulfills the constraints
+    if(reducedProblem->properties.numberOfVariables == 0)
+    {
+        result.solution = reduction.getSourcePoint(VectorDouble());
+        result.objectiveValue = sourceProblem->objectiveFunction->calculateValue(result.solution);
+        result.status = E_NLPSolutionStatus::Optimal;
+
+        return (result);
+    }
+
+#ifdef HAS_IPOPT
+    auto solver = std::make_shared<NLPSolverIpoptRelaxed>(env, reducedProblem);
+
+    if(env->settings->getSetting<bool>("FixedInteger.Warmstart", "Primal"))
+    {
+        VectorInteger startingPointIndexes(reducedProblem->properties.numberOfVariables);
+        std::iota(startingPointIndexes.begin(), startingPointIndexes.end(), 0);
 
-        if(env->settings->getSetting<bool>("FixedInteger.Frequency.Dynamic", "Primal"))
+        solver->setStartingPoint(startingPointIndexes, reduction.getReducedPoint(candidate.point));
+    }
+
+    result.status = solver->solveProblem();
+    result.objectiveValue = solver->getObjectiveValue();
+
+    if(auto solution = solver->getSolution(); solution.size() > 0)
+        result.solution = reduction.getSourcePoint(solution);
+#endif
+
+    return (result);
+}
+
+void TaskSelectPrimalCandidatesFromNLP::processFixedNLPResult(
+    const PrimalFixedNLPCandidate& candidate, const FixedNLPResult& result)
+{
+    if(result.isAbandoned)
+    {
+        env->output->outputDebug("         Fixed NLP problem not solved since it cannot improve the primal bound.");
+        return;
+    }
+
+    auto currIter = env->results->getCurrentIteration();
+
+    env->solutionStatistics.numberOfProblemsFixedNLP++;
+
+    std::string source = (sourceIsReformulatedProblem) ? "R" : "O";
+
+    std::string sourceDesc;
+    switch(candidate.sourceType)
+    {
+    case E_PrimalNLPSource::FirstSolution:
+        env->output->outputDebug("         Source from candidate point is first MIP solution point.");
+        sourceDesc = "SOLPT-" + source;
+        break;
+    case E_PrimalNLPSource::FeasibleSolution:
+        env->output->outputDebug("         Source from candidate point is MIP solution pool.");
+        sourceDesc = "FEASP-" + source;
+        break;
+    case E_PrimalNLPSource::InfeasibleSolution:
+        env->output->outputDebug("         Source from candidate point is infeasible MIP solution.");
+        sourceDesc = "UNFEA-" + source;
+        break;
+    case E_PrimalNLPSource::SmallestDeviationSolution:
+        env->output->outputDebug(
+            "         Source from candidate point is MIP solution with smallest nonlinear error.");
+        sourceDesc = "SMDEV-" + source;
+        break;
+    case E_PrimalNLPSource::FirstSolutionNewDualBound:
+        env->output->outputDebug(
+            "         Source from candidate point is first MIP solution point which gave dual bound update.");
+        sourceDesc = "NEWDB-" + source;
+        break;
+    case E_PrimalNLPSource::FixAndPropagate:
+        env->output->outputDebug("         Source from candidate point is the fix-and-propagate heuristic.");
+        sourceDesc = "FIXPR-" + source;
+        break;
+    default:
+        break;
+    }
+
+    switch(result.status)
+    {
+    case E_NLPSolutionStatus::Optimal:
+        env->output->outputDebug(fmt::format(
+            "         Optimal solution {} found to fixed NLP problem.", result.objectiveValue));
+        break;
+
+    case E_NLPSolutionStatus::Feasible:
+        env->output->outputDebug(fmt::format(
+            "         Feasible solution {} found to fixed NLP problem.", result.objectiveValue));
+        break;
+
+    case E_NLPSolutionStatus::Infeasible:
+        env->output->outputDebug("         Fixed NLP problem is infeasible.");
+        break;
+
+    case E_NLPSolutionStatus::Unbounded:
+        env->output->outputDebug("         Fixed NLP problem is unbounded.");
+        break;
+
+    case E_NLPSolutionStatus::TimeLimit:
+        env->output->outputDebug("         Time limit hit when solving fixed NLP problem.");
+        break;
+
+    case E_NLPSolutionStatus::IterationLimit:
+        env->output->outputDebug("         Iteration limit hit when solving fixed NLP problem.");
+        break;
+
+    case E_NLPSolutionStatus::Error:
+        env->output->outputDebug("         Error ocurred when solving fixed NLP problem.");
+        break;
+
+    default:
+
+        break;
+    }
+
+    if(result.status == E_NLPSolutionStatus::Feasible || result.status == E_NLPSolutionStatus::Optimal)
+    {
+        double tmpObj = result.objectiveValue;
+        auto& variableSolution = result.solution;
+
+        env->primalSolver->addPrimalSolutionCandidate(
+            variableSolution, E_PrimalSolutionSource::NLPFixedIntegers, currIter->iterationNumber);
+
+        if(sourceProblem->properties.numberOfNonlinearConstraints > 0
+            || sourceProblem->properties.numberOfQuadraticConstraints > 0)
         {
-            if(solvestatus == E_NLPSolutionStatus::Optimal || solvestatus == E_NLPSolutionStatus::Feasible)
-            {
-                int iters = std::max(
-                    std::ceil(env->settings->getSetting<int>("FixedInteger.Frequency.Iteration", "Primal") * 0.98),
-                    originalNLPIter);
+            auto mostDevConstr = sourceProblem->getMostDeviatingNonlinearOrQuadraticConstraint(variableSolution);
 
-                if(iters > std::max(0.1 * this->originalIterFrequency, 1.0))
-                    env->settings->updateSetting("FixedInteger.Frequency.Iteration", "Primal", iters);
+            env->output->outputDebug(fmt::format("         Max error {} from nonlinear or quadratic constraint {}.",
+                mostDevConstr->normalizedValue, mostDevConstr->constraint->name));
 
-                double interval = std::max(
-                    0.9 * env->settings->getSetting<double>("FixedInteger.Frequency.Time", "Primal"), originalNLPTime);
+            env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
+                ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
+                currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
+                env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(),
+                tmpObj, mostDevConstr->constraint->index, mostDevConstr->normalizedValue,
+                E_IterationLineType::PrimalNLP);
+        }
+        else
+        {
+            env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
+                ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
+                currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
+                env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(),
+                tmpObj,
+                -1, // Not shown
+                0.0, // Not shown
+                E_IterationLineType::PrimalNLP);
+        }
 
-                if(interval > 0.1 * this->originalTimeFrequency)
-                    env->settings->updateSetting("FixedInteger.Frequency.Time", "Primal", interval);
+        // Add integer cut.
+        if(env->settings->getSetting<bool>("HyperplaneCuts.UseIntegerCuts", "Dual")
+            && sourceProblem->properties.numberOfDiscreteVariables > 0)
+            createIntegerCut(candidate.point);
 
-                env->output->outputDebug(fmt::format(
-                    "         Iteration frequency updated to {} and time frequency updated to {} ", iters, interval));
-            }
-            else
-            {
-                int iters
-                    = std::ceil(env->settings->getSetting<int>("FixedInteger.Frequency.Iteration", "Primal") * 1.02);
+        if(env->settings->getSetting<bool>("FixedInteger.CreateInfeasibilityCut", "Primal"))
+            createInfeasibilityCut(variableSolution);
+    }
+    else if(result.status == E_NLPSolutionStatus::Error || result.status == E_NLPSolutionStatus::Unbounded
+        || result.status == E_NLPSolutionStatus::Infeasible)
+    {
+        env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP, ("NLP" + sourceDesc),
+            env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded, currIter->totNumHyperplanes,
+            env->results->getCurrentDualBound(), env->results->getPrimalBound(),
+            env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(), NAN, -1,
+            NAN, E_IterationLineType::PrimalNLP);
+    }
+    else if(sourceProblem->properties.numberOfNonlinearConstraints > 0
+        || sourceProblem->properties.numberOfQuadraticConstraints > 0)
+    {
+        double tmpObj = result.objectiveValue;
 
-                if(iters < 10 * this->originalIterFrequency)
-                    env->settings->updateSetting("FixedInteger.Frequency.Iteration", "Primal", iters);
+        auto& variableSolution = result.solution;
 
-                double interval = 1.1 * env->settings->getSetting<double>("FixedInteger.Frequency.Time", "Primal");
+        if(variableSolution.size() > 0)
+        {
+            auto mostDevConstr = sourceProblem->getMostDeviatingNonlinearOrQuadraticConstraint(variableSolution);
 
-                if(interval < 10 * this->originalTimeFrequency)
-                    env->settings->updateSetting("FixedInteger.Frequency.Time", "Primal", interval);
+            if(env->settings->getSetting<bool>("FixedInteger.CreateInfeasibilityCut", "Primal"))
+                createInfeasibilityCut(variableSolution);
 
-                env->output->outputDebug(fmt::format(
-                    "         Iteration frequency updated to {} and time frequency updated to {} ", iters, interval));
-            }
+            env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
+                ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
+                currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
+                env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(),
+                tmpObj, mostDevConstr->constraint->index, mostDevConstr->normalizedValue,
+                E_IterationLineType::PrimalNLP);
         }
+        else
+        {
+            env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
+                ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
+                currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
+                env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(), NAN,
+                -1, NAN, E_IterationLineType::PrimalNLP);
+        }
+    }
+    else
+    {
 
-        env->solutionStatistics.numberOfIterationsWithoutNLPCallMIP = 0;
-        env->solutionStatistics.timeLastFixedNLPCall = env->timing->getElapsedTime("Total");
-        counter++;
+        auto& variableSolution = result.solution;
 
-        env->primalSolver->usedPrimalNLPCandidates.push_back(CAND);
+        if(variableSolution.size() > 0)
+        {
+            env->report->outputIterationDetail(env->solutionStatistics.numberOfProblemsFixedNLP,
+                ("NLP" + sourceDesc), env->timing->getElapsedTime("Total"), currIter->numHyperplanesAdded,
+                currIter->totNumHyperplanes, env->results->getCurrentDualBound(), env->results->getPrimalBound(),
+                env->results->getAbsoluteGlobalObjectiveGap(), env->results->getRelativeGlobalObjectiveGap(), NAN,
+                -1, NAN, E_IterationLineType::PrimalNLP);
+        }
     }
 
-    return (true);
+    env->solutionStatistics.numberOfIterationsWithoutNLPCallMIP = 0;
+    env->solutionStatistics.timeLastFixedNLPCall = env->timing->getElapsedTime("Total");
+}
+
+void TaskSelectPrimalCandidatesFromNLP::updateFixedNLPFrequency(const FixedNLPResult& result)
+{
+// A problem that was not solved says nothing about how useful the problems are
+if(result.isAbandoned)
+    return;
+
+if(env->settings->getSetting<bool>("FixedInteger.Frequency.Dynamic", "Primal"))
+{
+    if(result.status == E_NLPSolutionStatus::Optimal || result.status == E_NLPSolutionStatus::Feasible)
+    {
+        int iters = std::max(
+            std::ceil(env->settings->getSetting<int>("FixedInteger.Frequency.Iteration", "Primal") * 0.98),
+            originalNLPIter);
+
+        if(iters > std::max(0.1 * this->originalIterFrequency, 1.0))
+            env->settings->updateSetting("FixedInteger.Frequency.Iteration", "Primal", iters);
+
+        double interval = std::max(
+            0.9 * env->settings->getSetting<double>("FixedInteger.Frequency.Time", "Primal"), originalNLPTime);
+
+        if(interval > 0.1 * this->originalTimeFrequency)
+            env->settings->updateSetting("FixedInteger.Frequency.Time", "Primal", interval);
+
+        env->output->outputDebug(fmt::format(
+            "         Iteration frequency updated to {} and time frequency updated to {} ", iters, interval));
+    }
+    else
+    {
+        int iters
+            = std::ceil(env->settings->getSetting<int>("FixedInteger.Frequency.Iteration", "Primal") * 1.02);
+
+        if(iters < 10 * this->originalIterFrequency)
+            env->settings->updateSetting("FixedInteger.Frequency.Iteration", "Primal", iters);
+
+        double interval = 1.1 * env->settings->getSetting<double>("FixedInteger.Frequency.Time", "Primal");
+
+        if(interval < 10 * this->originalTimeFrequency)
+            env->settings->updateSetting("FixedInteger.Frequency.Time", "Primal", interval);
+
+        env->output->outputDebug(fmt::format(
+            "         Iteration frequency updated to {} and time frequency updated to {} ", iters, interval));
+    }
+}
+
+}
+
+void TaskSelectPrimalCandidatesFromNLP::updateToleranceSchedule()
+{
+    if(!env->settings->getSetting<bool>("FixedInteger.ToleranceSchedule.Use", "Primal"))
+        return;
+
+    if(!env->results->hasPrimalSolution())
+    {
+        scheduledPrimalBound = NAN;
+        useLooseTolerances = true;
+        return;
+    }
+
+    scheduledPrimalBound = env->results->getPrimalBound();
+    useLooseTolerances = (env->results->getRelativeGlobalObjectiveGap()
+        > env->settings->getSetting<double>("FixedInteger.ToleranceSchedule.GapLimit", "Primal"));
+}
+
+bool TaskSelectPrimalCandidatesFromNLP::canImprovePrimalBound(double objectiveValue, double tolerance)
+{
+    double primalBound = scheduledPrimalBound;
+
+    if(std::isnan(primalBound) || std::isnan(objectiveValue))
+        return (true);
+
+    if(sourceProblem->objectiveFunction->properties.isMinimize)
+        return (objectiveValue < primalBound + tolerance);
+
+    return (objectiveValue > primalBound - tolerance);
 }
 
 void TaskSelectPrimalCandidatesFromNLP::createInfeasibilityCut(const VectorDouble variableSolution)
@@ -597,7 +1302,7 @@ void TaskSelectPrimalCandidatesFromNLP::createIntegerCut(VectorDouble variableSo
     for(auto& I : discreteVariableIndexes)
         integerCut.variableValues.push_back(round(variableSolution.at(I)));
 
-    env->dualSolver->addIntegerCut(integerCut);
+    env->dualSolver->addIntegerCut(std::move(integerCut));
 }
 
 } // namespace SHOT
\ No newline at end of file
@@ -11,11 +11,18 @@
 #pragma once
 #include "TaskBase.h"
 
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #include "../Structs.h"
+#include "../NLPSolver/IFixedNLPExecutor.h"
 
 namespace SHOT
 {
@@ -24,14 +31,90 @@ class INLPSolver;
 class TaskSelectPrimalCandidatesFromNLP : public TaskBase
 {
 public:
-    TaskSelectPrimalCandidatesFromNLP(EnvironmentPtr envPtr, bool useReformulatedProblem);
+    TaskSelectPrimalCandidatesFromNLP(
+        EnvironmentPtr envPtr, bool useReformulatedProblem, bool allowAsynchronousSolves = false);
     ~TaskSelectPrimalCandidatesFromNLP() override;
     void run() override;
     std::string getType() override;
 
+    // Uses the current bounds of the variables in the source problem in the next fixed NLP problems
+    void updateVariableBounds(const VectorInteger& variableIndexes);
+
+    // Uses the given bounds in the next fixed NLP problems, e.g. in a fixed NLP worker
+    void updateVariableBounds(const std::map<int, PairDouble>& variableBounds);
+
+    // Solves the fixed NLP problem for a single candidate without using the result, e.g. in a fixed NLP worker
+    FixedNLPResult solveFixedNLPCandidate(const PrimalFixedNLPCandidate& candidate);
+
+    // Uses the result from solveFixedNLPCandidate() as if the problem was solved in run(), should not be called at the
+    // same time as run()
+    void useFixedNLPResult(const PrimalFixedNLPCandidate& candidate, const FixedNLPResult& result);
+
+    // The problem the candidate points are for, either the original or the reformulated problem
+    ProblemPtr getSourceProblem() { return (sourceProblem); };
+    bool isSourceReformulatedProblem() { return (sourceIsReformulatedProblem); };
+
 private:
     virtual bool solveFixedNLP();
 
+    // Fixes the discrete variables to the values in the candidate and solves the problem, can be called from any
+    // thread as long as each thread uses its own solver
+    FixedNLPResult solveFixedNLP(INLPSolver& solver, const PrimalFixedNLPCandidate& candidate, int counter);
+
+    // As above, but a reduced problem with the fixed values substituted is created and solved with its own solver
+    FixedNLPResult solveReducedFixedNLP(const PrimalFixedNLPCandidate& candidate);
+    bool useReducedProblem = false;
+
+    // The bounds given to the solvers after they were created, which are also used in the reduced problems
+    std::map<int, PairDouble> updatedVariableBounds;
+
+    // These use the results of the fixed NLP problems and should only be called from the main thread
+    void processFixedNLPResult(const PrimalFixedNLPCandidate& candidate, const FixedNLPResult& result);
+    void updateFixedNLPFrequency(const FixedNLPResult& result);
+
+    // With FixedInteger.ToleranceSchedule.Use, the problems are solved with looser tolerances while the gap is large,
+    // and the problems whose objective cannot improve the primal bound are not solved. The values are updated by the
+    // main thread, since the other threads cannot access the results
+    void updateToleranceSchedule();
+    bool canImprovePrimalBound(double objectiveValue, double tolerance);
+
+    std::atomic<bool> useLooseTolerances = false;
+    std::atomic<double> scheduledPrimalBound = NAN;
+
+    void solveFixedNLPsInParallel(const std::vector<PrimalFixedNLPCandidate>& candidates, int numberOfThreads);
+
+    // Additional solvers used when solving several problems at the same time, only with Ipopt
+    std::vector<std::shared_ptr<INLPSolver>> workerNLPSolvers;
+
+    // When solving asynchronously, the candidates are solved by a separate thread while the dual problem is solved,
+    // and the results are used the next time the task is run
+    void runAsynchronously();
+    void startAsynchronousSolver();
+    void stopAsynchronousSolver();
+    void processAsynchronousResults();
+
+    bool useAsynchronousSolves = false;
+    bool stopAsynchronousThread = false;
+    std::thread asynchronousThread;
+    std::mutex asynchronousMutex;
+    std::condition_variable asynchronousCandidateAvailable;
+    std::deque<PrimalFixedNLPCandidate> asynchronousCandidates;
+    std::deque<std::pair<PrimalFixedNLPCandidate, FixedNLPResult>> asynchronousResults;
+
+    // The variable bounds not yet updated in the solvers, also guarded by the mutex above
+    std::map<int, PairDouble> pendingVariableBounds;
+    void updateVariableBounds(INLPSolver& solver, const std::map<int, PairDouble>& variableBounds);
+
+    // With an executor, e.g. for FixedInteger.RemoteWorkers, the candidates are solved outside of the solver and the
+    // results are used the next time the task is run
+    void runWithExecutor();
+
+    FixedNLPExecutorPtr fixedNLPExecutor;
+    std::map<uint64_t, PrimalFixedNLPCandidate> submittedCandidates;
+    uint64_t nextSubmittedCandidateID = 0;
+
+    int numberOfSingleCandidatesSolved = 0;
+
     void createInfeasibilityCut(const VectorDouble point);
     void createIntegerCut(VectorDouble point);
 
@@ -10,17 +10,23 @@
 
 #include "TaskSelectPrimalCandidatesFromRootsearch.h"
 
+#include "../CancellationToken.h"
 #include "../DualSolver.h"
 #include "../Iteration.h"
 #include "../Results.h"
 #include "../PrimalSolver.h"
 #include "../Settings.h"
+#include "../ThreadPlacement.h"
 #include "../Timing.h"
 
 #include "../Model/Problem.h"
 
 #include "../RootsearchMethod/IRootsearchMethod.h"
 
+#include <atomic>
+#include <optional>
+#include <thread>
+
 namespace SHOT
 {
 
@@ -29,9 +35,41 @@ TaskSelectPrimalCandidatesFromRootsearch::TaskSelectPrimalCandidatesFromRootsear
 {
 }
 
-TaskSelectPrimalCandidatesFromRootsearch::~TaskSelectPrimalCandidatesFromRootsearch() = default;
+TaskSelectPrimalCandidatesFromRootsearch::~TaskSelectPrimalCandidatesFromRootsearch()
+{
+    if(asynchronousThread.joinable())
+        asynchronousThread.join();
+}
+
+void TaskSelectPrimalCandidatesFromRootsearch::run()
+{
+    auto currIter = env->results->getCurrentIteration();
+
+    if(currIter->solutionPoints.size() <= 1)
+    {
+        this->run(currIter->solutionPoints);
+        return;
+    }
+
+    std::vector<SolutionPoint> solutionPoints;
+
+    for(auto I : currIter->getPrescreenedSolutionPointIndexes(
+            env->settings->getSetting<int>("Rootsearch.SolutionPool.MaxPoints", "Primal")))
+        solutionPoints.push_back(currIter->solutionPoints[I]);
+
+    this->run(solutionPoints);
+}
+
+std::vector<E_TaskEnvironmentState> TaskSelectPrimalCandidatesFromRootsearch::getReadStates()
+{
+    return { E_TaskEnvironmentState::Problem, E_TaskEnvironmentState::Results, E_TaskEnvironmentState::DualSolver };
+}
 
-void TaskSelectPrimalCandidatesFromRootsearch::run() { this->run(env->results->getCurrentIteration()->solutionPoints); }
+std::vector<E_TaskEnvironmentState> TaskSelectPrimalCandidatesFromRootsearch::getModifiedStates()
+{
+    return { E_TaskEnvironmentState::PrimalSolver, E_TaskEnvironmentState::Results,
+        E_TaskEnvironmentState::DualSolver };
+}
 
 std::string TaskSelectPrimalCandidatesFromRootsearch::getType()
 {
@@ -39,73 +77,219 @@ std::string TaskSelectPrimalCandidatesFromRootsearch::getType()
     return (type);
 }
 
-void TaskSelectPrimalCandidatesFromRootsearch::run(std::vector<SolutionPoint> solPoints)
+void TaskSelectPrimalCandidatesFromRootsearch::run(const std::vector<SolutionPoint>& solPoints)
 {
     auto currIter = env->results->getCurrentIteration();
 
-    if((currIter->isMIP() && env->results->getRelativeGlobalObjectiveGap() > 1e-10)
-        || env->results->usedSolutionStrategy == E_SolutionStrategy::NLP)
+    // The candidates from the root searches started in the previous iteration are added first
+    finishAsynchronousRootsearches();
+
+    if(!((currIter->isMIP() && env->results->getRelativeGlobalObjectiveGap() > 1e-10)
+           || env->results->usedSolutionStrategy == E_SolutionStrategy::NLP))
+        return;
+
+    if(solPoints.empty() || env->dualSolver->interiorPts.empty())
+        return;
+
+    env->timing->startTimer("PrimalStrategy");
+    env->timing->startTimer("PrimalBoundStrategyRootSearch");
+
+    auto batch = std::make_unique<RootsearchBatch>();
+    batch->solutionPoints = solPoints;
+    batch->interiorPoints = env->dualSolver->interiorPts;
+    batch->iterationNumber = currIter->iterationNumber;
+    batch->primalBound = env->results->getPrimalBound();
+
+    // In the single-tree strategy this is called from the MIP solver callbacks, and when terminating the candidates
+    // are needed at once
+    bool useAsynchronousRootsearch = env->settings->getSetting<bool>("Rootsearch.Asynchronous", "Primal")
+        && !env->dualSolver->isSingleTree && env->results->terminationReason == E_TerminationReason::None;
+
+    if(useAsynchronousRootsearch)
     {
-        env->timing->startTimer("PrimalStrategy");
-        env->timing->startTimer("PrimalBoundStrategyRootSearch");
+        env->output->outputDebug("        Started {} primal root searches in a separate thread.",
+            batch->solutionPoints.size() * batch->interiorPoints.size());
 
-        for(auto& P : solPoints)
-        {
-            for(auto& IP : env->dualSolver->interiorPts)
-            {
-                auto xNLP = IP->point;
+        // The batch only refers to copies of the points, so the interior points can be updated meanwhile
+        asynchronousBatch = std::move(batch);
+        asynchronousThread = std::thread([this]() { performRootsearches(*asynchronousBatch); });
+        numberOfStartedAsynchronousBatches++;
+    }
+    else
+    {
+        performRootsearches(*batch);
+        addCandidates(*batch);
+    }
 
-                auto solPoint = P.point;
+    env->timing->stopTimer("PrimalStrategy");
+    env->timing->stopTimer("PrimalBoundStrategyRootSearch");
+}
 
-                assert(xNLP.size() == solPoint.size());
+void TaskSelectPrimalCandidatesFromRootsearch::performRootsearches(RootsearchBatch& batch)
+{
+    int rootMaxIter = env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver");
+    double rootTerminationTolerance = env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver");
+    double stopImprovement = env->settings->getSetting<double>("Rootsearch.StopAtRelativeImprovement", "Primal");
 
-                for(auto& V : env->reformulatedProblem->binaryVariables)
-                {
-                    xNLP.at(V->index) = P.point.at(V->index);
-                }
+    double primalBound = batch.primalBound;
+    bool isMinimization = env->problem->objectiveFunction->properties.isMinimize;
+    bool hasPrimalBound = std::abs(primalBound) < SHOT_DBL_MAX;
 
-                for(auto& V : env->reformulatedProblem->integerVariables)
-                {
-                    xNLP.at(V->index) = P.point.at(V->index);
-                }
+    auto& solPoints = batch.solutionPoints;
+    auto& interiorPoints = batch.interiorPoints;
+    size_t numberOfRootsearches = solPoints.size() * interiorPoints.size();
 
-                for(auto& V : env->reformulatedProblem->semiintegerVariables)
-                {
-                    xNLP.at(V->index) = P.point.at(V->index);
-                }
+    // Every root search has its own slot, so that the candidates are added in the same order as when performed
+    // sequentially. The primal solver is only called afterwards from the thread running the task.
+    auto& candidates = batch.candidates;
+    candidates.assign(numberOfRootsearches, std::nullopt);
+
+    // The root searches after the first one that improves the primal bound enough are skipped. With
+    // Parallel.Deterministic the earlier ones are still performed, and the candidates of the later ones that were
+    // already performed are not used, so that the candidates do not depend on the timing of the threads.
+    bool isDeterministic = ThreadPlacement::isDeterministic(env->settings);
+    std::atomic<size_t> firstImprovingRootsearch(SIZE_MAX);
+    std::atomic<int> numberOfFailedRootsearches(0);
+
+    auto performRootsearch = [&](size_t k) {
+        if(isDeterministic ? k > firstImprovingRootsearch : firstImprovingRootsearch != SIZE_MAX)
+            return;
+
+        auto& P = solPoints[k / interiorPoints.size()];
+        auto xNLP = interiorPoints[k % interiorPoints.size()]->point;
+
+        assert(xNLP.size() == P.point.size());
+
+        for(auto& V : env->reformulatedProblem->binaryVariables)
+            xNLP.at(V->index) = P.point.at(V->index);
+
+        for(auto& V : env->reformulatedProblem->integerVariables)
+            xNLP.at(V->index) = P.point.at(V->index);
+
+        for(auto& V : env->reformulatedProblem->semiintegerVariables)
+            xNLP.at(V->index) = P.point.at(V->index);
 
-                auto maxDevNLP2 = env->reformulatedProblem->getMaxNumericConstraintValue(
-                    xNLP, env->reformulatedProblem->numericConstraints);
-                auto maxDevMIP = env->reformulatedProblem->getMaxNumericConstraintValue(
-                    P.point, env->reformulatedProblem->numericConstraints);
+        auto maxDevNLP2 = env->reformulatedProblem->getMaxNumericConstraintValue(
+            xNLP, env->reformulatedProblem->numericConstraints);
+        auto maxDevMIP = env->reformulatedProblem->getMaxNumericConstraintValue(
+            P.point, env->reformulatedProblem->numericConstraints);
 
-                if(maxDevNLP2.normalizedValue < 0 && maxDevMIP.normalizedValue > 0)
+        if(!(maxDevNLP2.normalizedValue < 0 && maxDevMIP.normalizedValue > 0))
+            return;
+
+        try
+        {
+            auto xNewc = env->rootsearchMethod->findZero(xNLP, P.point, rootMaxIter, rootTerminationTolerance, 0,
+                env->reformulatedProblem->nonlinearConstraints, false);
+
+            if(stopImprovement > 0 && hasPrimalBound)
+            {
+                double objectiveValue = env->problem->objectiveFunction->calculateValue(xNewc.first);
+                double improvement = (isMinimization ? primalBound - objectiveValue : objectiveValue - primalBound)
+                    / std::max(1e-10, std::abs(primalBound));
+
+                if(improvement > stopImprovement)
                 {
-                    std::pair<VectorDouble, VectorDouble> xNewc;
-
-                    try
-                    {
-                        env->timing->startTimer("PrimalBoundStrategyRootSearch");
-                        xNewc = env->rootsearchMethod->findZero(xNLP, P.point,
-                            env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver"),
-                            env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver"), 0,
-                            env->reformulatedProblem->nonlinearConstraints, false);
-
-                        env->timing->stopTimer("PrimalBoundStrategyRootSearch");
-
-                        env->primalSolver->addPrimalSolutionCandidate(xNewc.first, E_PrimalSolutionSource::Rootsearch,
-                            env->results->getCurrentIteration()->iterationNumber);
-                    }
-                    catch(std::exception&)
-                    {
-                        env->output->outputDebug("        Cannot find solution with primal rootsearch.");
-                    }
+                    // The smallest index is kept
+                    size_t firstImproving = firstImprovingRootsearch;
+
+                    while(k < firstImproving && !firstImprovingRootsearch.compare_exchange_weak(firstImproving, k))
+                        ;
                 }
             }
 
-            env->timing->stopTimer("PrimalStrategy");
-            env->timing->stopTimer("PrimalBoundStrategyRootSearch");
+            candidates[k] = std::move(xNewc.first);
+        }
+        catch(std::exception&)
+        {
+            numberOfFailedRootsearches++;
+        }
+    };
+
+    int numberOfThreads = env->settings->getSetting<int>("Rootsearch.NumberOfThreads", "Primal");
+
+    numberOfThreads = ThreadPlacement::getNumberOfThreads(env->settings, numberOfThreads);
+
+    // In the single-tree strategy this is called from the MIP solver callbacks, whose threads are already busy
+    if(env->dualSolver->isSingleTree)
+        numberOfThreads = 1;
+
+    numberOfThreads = std::min(numberOfThreads, (int)numberOfRootsearches);
+
+    if(numberOfThreads <= 1)
+    {
+        for(size_t k = 0; k < numberOfRootsearches && !env->cancellationToken->isCancelled(); k++)
+            performRootsearch(k);
+    }
+    else
+    {
+        // The root searches and constraint evaluations only use local and thread-local data
+        ThreadPlacement::WorkQueue rootsearchQueue(env->settings, numberOfRootsearches, numberOfThreads);
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int i = 0; i < numberOfThreads; i++)
+        {
+            threads.emplace_back([&, i]() {
+                ThreadPlacement::pinThread(env->settings, i);
+
+                for(size_t k; !env->cancellationToken->isCancelled() && rootsearchQueue.getNextItem(i, k);)
+                    performRootsearch(k);
+            });
         }
+
+        for(auto& T : threads)
+            T.join();
     }
+
+    env->rootsearchMethod->updateWarmStarts();
+
+    size_t firstImproving = firstImprovingRootsearch;
+
+    if(isDeterministic && firstImproving < numberOfRootsearches)
+    {
+        for(size_t k = firstImproving + 1; k < numberOfRootsearches; k++)
+            candidates[k].reset();
+    }
+
+    batch.numberOfFailedRootsearches = numberOfFailedRootsearches;
+    batch.isImproved = (firstImproving != SIZE_MAX);
+}
+
+void TaskSelectPrimalCandidatesFromRootsearch::addCandidates(const RootsearchBatch& batch)
+{
+    if(batch.numberOfFailedRootsearches > 0)
+        env->output->outputDebug(
+            "        Cannot find solution with {} primal rootsearches.", batch.numberOfFailedRootsearches);
+
+    if(batch.isImproved)
+        env->output->outputDebug("        Remaining primal root searches skipped since the primal bound is improved.");
+
+    for(auto& C : batch.candidates)
+    {
+        if(C)
+        {
+            env->primalSolver->addPrimalSolutionCandidate(
+                *C, E_PrimalSolutionSource::Rootsearch, batch.iterationNumber);
+        }
+    }
+}
+
+void TaskSelectPrimalCandidatesFromRootsearch::finishAsynchronousRootsearches()
+{
+    if(!asynchronousThread.joinable())
+        return;
+
+    asynchronousThread.join();
+
+    env->timing->startTimer("PrimalStrategy");
+    env->timing->startTimer("PrimalBoundStrategyRootSearch");
+
+    addCandidates(*asynchronousBatch);
+    asynchronousBatch.reset();
+    numberOfFinishedAsynchronousBatches++;
+
+    env->timing->stopTimer("PrimalStrategy");
+    env->timing->stopTimer("PrimalBoundStrategyRootSearch");
 }
-} // namespace SHOT
\ No newline at end of file
+} // namespace SHOT
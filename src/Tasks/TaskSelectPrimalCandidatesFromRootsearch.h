@@ -13,6 +13,11 @@
 
 #include "../Structs.h"
 
+#include <memory>
+#include <optional>
+#include <thread>
+#include <vector>
+
 namespace SHOT
 {
 class TaskSelectPrimalCandidatesFromRootsearch : public TaskBase
@@ -21,10 +26,43 @@ public:
     TaskSelectPrimalCandidatesFromRootsearch(EnvironmentPtr envPtr);
     ~TaskSelectPrimalCandidatesFromRootsearch() override;
     void run() override;
-    virtual void run(std::vector<SolutionPoint> solPoints);
+    virtual void run(const std::vector<SolutionPoint>& solPoints);
 
     std::string getType() override;
 
+    std::vector<E_TaskEnvironmentState> getReadStates() override;
+    std::vector<E_TaskEnvironmentState> getModifiedStates() override;
+
+    // With Rootsearch.Asynchronous, the root searches of an iteration are performed in a separate thread while the cuts
+    // are generated and the next dual problem is solved. The candidates are then added in the next call, or when this
+    // is called at termination, so that the candidates of the last iteration are used before the solution is reported.
+    void finishAsynchronousRootsearches();
+
+    int getNumberOfStartedAsynchronousRootsearches() { return (numberOfStartedAsynchronousBatches); };
+    int getNumberOfFinishedAsynchronousRootsearches() { return (numberOfFinishedAsynchronousBatches); };
+
 private:
+    struct RootsearchBatch
+    {
+        std::vector<SolutionPoint> solutionPoints;
+        std::vector<std::shared_ptr<InteriorPoint>> interiorPoints;
+        int iterationNumber = 0;
+        double primalBound = SHOT_DBL_MAX;
+
+        std::vector<std::optional<VectorDouble>> candidates;
+        int numberOfFailedRootsearches = 0;
+        bool isImproved = false;
+    };
+
+    // Only uses the batch and the problem, so it can be called from another thread
+    void performRootsearches(RootsearchBatch& batch);
+
+    void addCandidates(const RootsearchBatch& batch);
+
+    std::thread asynchronousThread;
+    std::unique_ptr<RootsearchBatch> asynchronousBatch;
+
+    int numberOfStartedAsynchronousBatches = 0;
+    int numberOfFinishedAsynchronousBatches = 0;
 };
 } // namespace SHOT
\ No newline at end of file
@@ -0,0 +1,176 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskSelectPrimalFixedNLPPointsFromFixAndPropagate.h"
+
+#include "../Iteration.h"
+#include "../Output.h"
+#include "../Results.h"
+#include "../PrimalSolver.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+#include "../Model/Problem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace SHOT
+{
+
+TaskSelectPrimalFixedNLPPointsFromFixAndPropagate::TaskSelectPrimalFixedNLPPointsFromFixAndPropagate(
+    EnvironmentPtr envPtr)
+    : TaskBase(envPtr)
+{
+}
+
+TaskSelectPrimalFixedNLPPointsFromFixAndPropagate::~TaskSelectPrimalFixedNLPPointsFromFixAndPropagate() = default;
+
+void TaskSelectPrimalFixedNLPPointsFromFixAndPropagate::run()
+{
+    if(env->results->hasPrimalSolution())
+        return;
+
+    auto currIter = env->results->getCurrentIteration();
+
+    if(currIter->solutionPoints.size() == 0)
+        return;
+
+    env->timing->startTimer("PrimalStrategy");
+
+    auto& solution = currIter->solutionPoints.at(0);
+    auto fixedPoint = fixAndPropagate(solution.point);
+
+    if(fixedPoint.size() > 0)
+    {
+        env->primalSolver->addFixedNLPCandidate(fixedPoint, E_PrimalNLPSource::FixAndPropagate,
+            solution.objectiveValue, solution.iterFound, solution.maxDeviation);
+    }
+
+    env->timing->stopTimer("PrimalStrategy");
+}
+
+std::string TaskSelectPrimalFixedNLPPointsFromFixAndPropagate::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+
+VectorDouble TaskSelectPrimalFixedNLPPointsFromFixAndPropagate::fixAndPropagate(const VectorDouble& point)
+{
+    auto& problem = env->reformulatedProblem;
+
+    VectorDouble fixedPoint(point);
+
+    if(fixedPoint.size() < problem->allVariables.size())
+        problem->augmentAuxiliaryVariableValues(fixedPoint);
+
+    // The distance to the nearest integer for each discrete variable
+    std::vector<std::pair<double, VariablePtr>> fractionalities;
+
+    for(auto& V : problem->allVariables)
+    {
+        if(V->properties.type != E_VariableType::Binary && V->properties.type != E_VariableType::Integer)
+            continue;
+
+        double value = fixedPoint[V->index];
+        fractionalities.emplace_back(std::abs(value - std::round(value)), V);
+    }
+
+    if(fractionalities.size() == 0)
+        return (VectorDouble());
+
+    std::stable_sort(fractionalities.begin(), fractionalities.end(),
+        [](const auto& first, const auto& second) { return (first.first < second.first); });
+
+    double timeEnd = env->timing->getElapsedTime("Total")
+        + env->settings->getSetting<double>("FixAndPropagate.TimeLimit", "Primal");
+
+    saveVariableBounds();
+
+    bool isFeasible = true;
+    int numberOfFixedVariables = 0;
+
+    for(auto& [fractionality, V] : fractionalities)
+    {
+        double timeLeft = timeEnd - env->timing->getElapsedTime("Total");
+
+        if(timeLeft <= 0.0)
+        {
+            env->output->outputDebug("        Fix-and-propagate heuristic terminated due to the time limit.");
+            isFeasible = false;
+            break;
+        }
+
+        // The propagation of the earlier fixings may have tightened the bounds of the variable
+        double value = std::min(std::max(std::round(fixedPoint[V->index]), V->lowerBound), V->upperBound);
+        fixedPoint[V->index] = value;
+
+        if(V->lowerBound == value && V->upperBound == value)
+            continue;
+
+        V->lowerBound = value;
+        V->upperBound = value;
+        numberOfFixedVariables++;
+
+        if(!problem->propagateVariableBounds({ V }, timeLeft))
+        {
+            env->output->outputDebug(fmt::format(
+                "        Fix-and-propagate heuristic found a conflict after fixing {} of {} discrete variables.",
+                numberOfFixedVariables, fractionalities.size()));
+
+            isFeasible = false;
+            break;
+        }
+    }
+
+    if(isFeasible)
+    {
+        for(auto& V : problem->allVariables)
+            fixedPoint[V->index] = std::min(std::max(fixedPoint[V->index], V->lowerBound), V->upperBound);
+
+        env->output->outputDebug(fmt::format(
+            "        Fix-and-propagate heuristic fixed {} discrete variables without a conflict, the others were fixed "
+            "by the propagation.",
+            numberOfFixedVariables));
+    }
+
+    restoreVariableBounds();
+
+    return (isFeasible ? fixedPoint : VectorDouble());
+}
+
+void TaskSelectPrimalFixedNLPPointsFromFixAndPropagate::saveVariableBounds()
+{
+    savedVariableBounds.clear();
+    savedVariableBounds.reserve(env->reformulatedProblem->allVariables.size());
+
+    for(auto& V : env->reformulatedProblem->allVariables)
+    {
+        savedVariableBounds.emplace_back(V->lowerBound, V->upperBound, V->properties.hasLowerBoundBeenTightened,
+            V->properties.hasUpperBoundBeenTightened);
+    }
+}
+
+void TaskSelectPrimalFixedNLPPointsFromFixAndPropagate::restoreVariableBounds()
+{
+    auto& variables = env->reformulatedProblem->allVariables;
+
+    for(size_t i = 0; i < savedVariableBounds.size(); i++)
+    {
+        auto& V = variables[i];
+
+        std::tie(V->lowerBound, V->upperBound, V->properties.hasLowerBoundBeenTightened,
+            V->properties.hasUpperBoundBeenTightened)
+            = savedVariableBounds[i];
+    }
+}
+} // namespace SHOT
@@ -0,0 +1,45 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include "../Structs.h"
+
+#include <tuple>
+#include <vector>
+
+namespace SHOT
+{
+
+// A fix-and-propagate heuristic used until a primal solution has been found. The discrete variables in the reformulated
+// problem are fixed to the rounded values in the current LP or MIP solution point, the least fractional first, and
+// the bounds are propagated after each fixing to detect a conflict early. Only if all variables have been fixed
+// without a conflict, the point is added as a candidate for the fixed NLP problem. The bounds are restored afterwards.
+class TaskSelectPrimalFixedNLPPointsFromFixAndPropagate : public TaskBase
+{
+public:
+    TaskSelectPrimalFixedNLPPointsFromFixAndPropagate(EnvironmentPtr envPtr);
+    ~TaskSelectPrimalFixedNLPPointsFromFixAndPropagate() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    // Returns the point with the fixed values, or an empty vector on a conflict
+    VectorDouble fixAndPropagate(const VectorDouble& point);
+
+    void saveVariableBounds();
+    void restoreVariableBounds();
+
+    // The bounds and whether they have been tightened for each variable
+    std::vector<std::tuple<double, double, bool, bool>> savedVariableBounds;
+};
+} // namespace SHOT
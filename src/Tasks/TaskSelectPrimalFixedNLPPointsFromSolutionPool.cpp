@@ -16,6 +16,8 @@
 #include "../Settings.h"
 #include "../Timing.h"
 
+#include <algorithm>
+
 namespace SHOT
 {
 
@@ -32,7 +34,7 @@ void TaskSelectPrimalFixedNLPPointsFromSolutionPool::run()
     env->timing->startTimer("PrimalBoundStrategyNLP");
 
     auto currIter = env->results->getCurrentIteration();
-    auto allSolutions = env->results->getCurrentIteration()->solutionPoints;
+    auto& allSolutions = currIter->solutionPoints;
 
     bool callNLPSolver = false;
     bool useFeasibleSolutionExtra = false;
@@ -130,9 +132,9 @@ void TaskSelectPrimalFixedNLPPointsFromSolutionPool::run()
         env->primalSolver->addFixedNLPCandidate(tmpSol.point, E_PrimalNLPSource::FirstSolution, tmpSol.objectiveValue,
             tmpSol.iterFound, tmpSol.maxDeviation);
 
-        for(size_t i = 1; i < allSolutions.size(); i++)
+        for(auto I : getPrescreenedSolutionPointIndexes())
         {
-            auto tmpSol = allSolutions.at(i);
+            auto& tmpSol = allSolutions.at(I);
 
             if(tmpSol.maxDeviation.value
                 <= env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal"))
@@ -149,9 +151,9 @@ void TaskSelectPrimalFixedNLPPointsFromSolutionPool::run()
         env->primalSolver->addFixedNLPCandidate(tmpSol.point, E_PrimalNLPSource::FirstSolution, tmpSol.objectiveValue,
             tmpSol.iterFound, tmpSol.maxDeviation);
 
-        for(size_t i = 1; i < allSolutions.size(); i++)
+        for(auto I : getPrescreenedSolutionPointIndexes())
         {
-            tmpSol = allSolutions.at(i);
+            tmpSol = allSolutions.at(I);
 
             if(tmpSol.maxDeviation.value
                 <= env->settings->getSetting<double>("Tolerance.NonlinearConstraint", "Primal"))
@@ -173,6 +175,17 @@ void TaskSelectPrimalFixedNLPPointsFromSolutionPool::run()
     }
 }
 
+std::vector<int> TaskSelectPrimalFixedNLPPointsFromSolutionPool::getPrescreenedSolutionPointIndexes()
+{
+    auto indexes = env->results->getCurrentIteration()->getPrescreenedSolutionPointIndexes(
+        env->settings->getSetting<int>("FixedInteger.SolutionPool.MaxPoints", "Primal"));
+
+    // The first point is always used separately
+    indexes.erase(std::remove(indexes.begin(), indexes.end(), 0), indexes.end());
+
+    return (indexes);
+}
+
 std::string TaskSelectPrimalFixedNLPPointsFromSolutionPool::getType()
 {
     std::string type = typeid(this).name();
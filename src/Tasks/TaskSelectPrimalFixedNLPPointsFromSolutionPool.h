@@ -23,5 +23,7 @@ public:
     std::string getType() override;
 
 private:
+    // The prescreened solution pool points used in addition to the first one
+    std::vector<int> getPrescreenedSolutionPointIndexes();
 };
 } // namespace SHOT
\ No newline at end of file
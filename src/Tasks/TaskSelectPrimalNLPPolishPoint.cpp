@@ -0,0 +1,65 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskSelectPrimalNLPPolishPoint.h"
+
+#include "../Iteration.h"
+#include "../Output.h"
+#include "../PrimalSolver.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+namespace SHOT
+{
+
+TaskSelectPrimalNLPPolishPoint::TaskSelectPrimalNLPPolishPoint(EnvironmentPtr envPtr) : TaskBase(envPtr) { }
+
+TaskSelectPrimalNLPPolishPoint::~TaskSelectPrimalNLPPolishPoint() = default;
+
+void TaskSelectPrimalNLPPolishPoint::run()
+{
+    // Without discrete variables, all starting points give the same NLP problem, so it is only solved once
+    if(isPerformed)
+        return;
+
+    auto currIter = env->results->getCurrentIteration();
+
+    if(currIter->isMIP() || currIter->solutionPoints.size() == 0
+        || currIter->solutionStatus != E_ProblemSolutionStatus::Optimal)
+        return;
+
+    auto& solution = currIter->solutionPoints.at(0);
+    auto tolerance = env->settings->getSetting<double>("FixedInteger.Polish.ConstraintTolerance", "Primal");
+
+    if(solution.maxDeviation.value > tolerance)
+        return;
+
+    env->timing->startTimer("PrimalStrategy");
+    env->timing->startTimer("PrimalBoundStrategyNLP");
+
+    env->output->outputDebug("        Using LP solution with constraint deviation {} as starting point for NLP solver.",
+        solution.maxDeviation.value);
+
+    env->primalSolver->addFixedNLPCandidate(solution.point, E_PrimalNLPSource::FirstSolution,
+        solution.objectiveValue, solution.iterFound, solution.maxDeviation);
+
+    isPerformed = true;
+
+    env->timing->stopTimer("PrimalBoundStrategyNLP");
+    env->timing->stopTimer("PrimalStrategy");
+}
+
+std::string TaskSelectPrimalNLPPolishPoint::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
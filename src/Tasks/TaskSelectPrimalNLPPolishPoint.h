@@ -0,0 +1,32 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+namespace SHOT
+{
+
+// Selects the LP solution of a continuous problem as starting point for solving the problem with the NLP solver,
+// once the solution is close to feasible. The problem is then solved by TaskSelectPrimalCandidatesFromNLP, which
+// normally gives an optimal primal solution closing the gap to the dual bound of the outer approximation.
+class TaskSelectPrimalNLPPolishPoint : public TaskBase
+{
+public:
+    TaskSelectPrimalNLPPolishPoint(EnvironmentPtr envPtr);
+    ~TaskSelectPrimalNLPPolishPoint() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    bool isPerformed = false;
+};
+} // namespace SHOT
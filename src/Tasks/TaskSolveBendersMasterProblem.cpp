@@ -0,0 +1,99 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskSolveBendersMasterProblem.h"
+
+#include "../DualSolver.h"
+#include "../Iteration.h"
+#include "../Output.h"
+#include "../Report.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../Timing.h"
+
+#include "../MIPSolver/IMIPSolver.h"
+
+namespace SHOT
+{
+
+TaskSolveBendersMasterProblem::TaskSolveBendersMasterProblem(EnvironmentPtr envPtr) : TaskBase(envPtr) { }
+
+TaskSolveBendersMasterProblem::~TaskSolveBendersMasterProblem() = default;
+
+void TaskSolveBendersMasterProblem::run()
+{
+    if(!env->report->firstIterationHeaderPrinted)
+    {
+        env->report->outputPreReport();
+        env->report->outputIterationDetailHeader();
+    }
+
+    env->timing->startTimer("DualStrategy");
+    auto currIter = env->results->getCurrentIteration();
+
+    auto timeLim = env->settings->getSetting<double>("TimeLimit", "Termination") - env->timing->getElapsedTime("Total");
+    env->dualSolver->MIPSolver->setTimeLimit(std::min(timeLim, env->dualSolver->MIPIterationTimeLimit));
+
+    // The objective bound of the master problem is only tight if it is solved to optimality
+    env->dualSolver->MIPSolver->setSolutionLimit(2100000000);
+
+    if(env->settings->getSetting<bool>("Debug.Enable", "Output"))
+    {
+        env->dualSolver->MIPSolver->writeProblemToFile(fmt::format("{}/dualiter{}_problem.lp",
+            env->settings->getSetting<std::string>("Debug.Path", "Output"), currIter->iterationNumber - 1));
+    }
+
+    env->output->outputDebug("        Solving Benders master problem.");
+
+    double solveStartTime = env->timing->getElapsedTime("Total");
+
+    auto solStatus = env->dualSolver->MIPSolver->solveProblem();
+
+    currIter->solutionStatus = solStatus;
+    currIter->solutionTime = env->timing->getElapsedTime("Total") - solveStartTime;
+    currIter->numberOfExploredNodes = env->dualSolver->MIPSolver->getNumberOfExploredNodes();
+    env->solutionStatistics.numberOfExploredNodes += currIter->numberOfExploredNodes;
+
+    env->output->outputDebug(fmt::format("        Master problem solved with return code: {}", (int)solStatus));
+
+    auto sols = env->dualSolver->MIPSolver->getAllVariableSolutions();
+
+    if(sols.size() > 0)
+    {
+        currIter->objectiveValue = env->dualSolver->MIPSolver->getObjectiveValue();
+        currIter->solutionPoints = sols;
+        currIter->maxDeviationConstraint = -1;
+        currIter->maxDeviation = 0.0;
+
+        DualSolution sol = { sols.at(0).point, E_DualSolutionSource::MIPSolverBound,
+            env->dualSolver->MIPSolver->getDualObjectiveValue(), currIter->iterationNumber, false };
+        env->dualSolver->addDualSolutionCandidate(sol);
+
+        if(solStatus == E_ProblemSolutionStatus::Optimal)
+            env->solutionStatistics.numberOfProblemsOptimalMILP++;
+        else
+            env->solutionStatistics.numberOfProblemsFeasibleMILP++;
+    }
+    else
+    {
+        env->output->outputDebug("        Master problem has no solutions.");
+    }
+
+    currIter->usedMIPSolutionLimit = env->dualSolver->MIPSolver->getSolutionLimit();
+
+    env->timing->stopTimer("DualStrategy");
+}
+
+std::string TaskSolveBendersMasterProblem::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
@@ -0,0 +1,29 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include "../Structs.h"
+
+namespace SHOT
+{
+// Solves the master problem to optimality, its objective bound is a dual bound since the Benders cuts are valid for the
+// source problem
+class TaskSolveBendersMasterProblem : public TaskBase
+{
+public:
+    TaskSolveBendersMasterProblem(EnvironmentPtr envPtr);
+    ~TaskSolveBendersMasterProblem() override;
+
+    void run() override;
+    std::string getType() override;
+};
+} // namespace SHOT
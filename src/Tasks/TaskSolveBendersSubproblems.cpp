@@ -0,0 +1,375 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskSolveBendersSubproblems.h"
+
+#include "../DualSolver.h"
+#include "../Iteration.h"
+#include "../Output.h"
+#include "../PrimalSolver.h"
+#include "../Results.h"
+#include "../Settings.h"
+#include "../TaskHandler.h"
+#include "../ThreadPlacement.h"
+#include "../Timing.h"
+
+#include "../MIPSolver/IMIPSolver.h"
+
+#include "../Model/Problem.h"
+
+#ifdef HAS_IPOPT
+#include "../NLPSolver/NLPSolverIpoptRelaxed.h"
+#endif
+
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+namespace SHOT
+{
+
+TaskSolveBendersSubproblems::TaskSolveBendersSubproblems(EnvironmentPtr envPtr, BlockDecompositionPtr decomposition)
+    : TaskBase(envPtr), decomposition(decomposition)
+{
+    env->timing->startTimer("PrimalBoundStrategyNLP");
+
+    double objectiveVariableBound
+        = env->settings->getSetting<double>("Variables.NonlinearObjectiveVariable.Bound", "Model");
+
+    for(auto& B : decomposition->blocks)
+    {
+#ifdef HAS_IPOPT
+        solvers.push_back(std::make_shared<NLPSolverIpoptRelaxed>(env, B.problem));
+        feasibilitySolvers.push_back(std::make_shared<NLPSolverIpoptRelaxed>(env, B.feasibilityProblem));
+
+        // The block problem is convex, so its optimal value with relaxed discrete variables is a valid bound
+        auto status = solvers.back()->solveProblem();
+
+        if(status == E_NLPSolutionStatus::Optimal)
+        {
+            double value = solvers.back()->getObjectiveValue();
+            B.objectiveLowerBound = value - 1e-6 * std::max(1.0, std::abs(value));
+            continue;
+        }
+#endif
+
+        try
+        {
+            B.objectiveLowerBound = std::max(-objectiveVariableBound, B.problem->objectiveFunction->getBounds().l());
+        }
+        catch(mc::Interval::Exceptions&)
+        {
+            B.objectiveLowerBound = -objectiveVariableBound;
+        }
+    }
+
+    env->timing->stopTimer("PrimalBoundStrategyNLP");
+}
+
+TaskSolveBendersSubproblems::~TaskSolveBendersSubproblems() = default;
+
+void TaskSolveBendersSubproblems::run()
+{
+    auto currIter = env->results->getCurrentIteration();
+
+    if(currIter->solutionPoints.size() == 0)
+        return;
+
+    env->timing->startTimer("PrimalBoundStrategyNLP");
+
+    auto masterSolution = currIter->solutionPoints.at(0).point;
+
+    std::vector<BlockResult> results(decomposition->blocks.size());
+
+    int numberOfThreads = ThreadPlacement::getNumberOfThreads(
+        env->settings, env->settings->getSetting<int>("Decomposition.NumberOfThreads", "Strategy"));
+    numberOfThreads = std::max(1, std::min(numberOfThreads, (int)results.size()));
+
+    // Each block has its own solvers, so the blocks can be solved at the same time
+    std::atomic<size_t> nextBlock(0);
+
+    auto solveBlocks = [&]() {
+        for(size_t k = nextBlock++; k < results.size(); k = nextBlock++)
+            solveBlock(k, masterSolution, results[k]);
+    };
+
+    if(numberOfThreads == 1)
+    {
+        solveBlocks();
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(numberOfThreads);
+
+        for(int t = 0; t < numberOfThreads; t++)
+            threads.emplace_back(solveBlocks);
+
+        for(auto& T : threads)
+            T.join();
+    }
+
+    env->solutionStatistics.numberOfProblemsFixedNLP += results.size();
+
+    double cutTolerance = env->settings->getSetting<double>("Decomposition.CutTolerance", "Strategy");
+
+    bool isFeasible = true;
+    int numberOfAddedCuts = 0;
+
+    for(size_t k = 0; k < results.size(); k++)
+    {
+        auto& R = results[k];
+
+        isFeasible = isFeasible && R.isFeasible;
+
+        if(R.isInfeasibleForAllValues)
+        {
+            env->output->outputDebug(
+                fmt::format("        Block {} is infeasible for all values of the discrete variables.", k));
+
+            env->results->terminationReason = E_TerminationReason::InfeasibleProblem;
+            env->results->terminationReasonDescription = "Terminated since a block of the problem is infeasible.";
+            env->tasks->setNextTask("FinalizeSolution");
+
+            env->timing->stopTimer("PrimalBoundStrategyNLP");
+            return;
+        }
+
+        if(!R.hasCut)
+            continue;
+
+        double violation = R.cutConstant;
+
+        for(auto& [index, coefficient] : R.cutElements)
+            violation += coefficient * masterSolution[index];
+
+        if(violation <= cutTolerance)
+            continue;
+
+        if(env->dualSolver->MIPSolver->addLinearConstraint(
+               R.cutElements, R.cutConstant, fmt::format("shot_benders_{}", currIter->totNumHyperplanes), false)
+            >= 0)
+        {
+            numberOfAddedCuts++;
+            currIter->totNumHyperplanes++;
+        }
+    }
+
+    currIter->numHyperplanesAdded = numberOfAddedCuts;
+
+    if(numberOfAddedCuts > 0)
+        env->solutionStatistics.iterationLastDualCutAdded = currIter->iterationNumber;
+
+    env->output->outputDebug(fmt::format("        Added {} Benders cuts to the master problem.", numberOfAddedCuts));
+
+    if(isFeasible)
+    {
+        int numberOfVariables = decomposition->getSourceProblem()->properties.numberOfVariables;
+
+        VectorDouble point(masterSolution.begin(), masterSolution.begin() + numberOfVariables);
+
+        for(auto& V : decomposition->getSourceProblem()->allVariables)
+        {
+            if(V->properties.type == E_VariableType::Binary || V->properties.type == E_VariableType::Integer)
+                point[V->index] = std::round(point[V->index]);
+        }
+
+        for(size_t k = 0; k < results.size(); k++)
+        {
+            auto& block = decomposition->blocks[k];
+            size_t numberOfContinuousVariables = block.sourceIndexes.size() - block.linkingPositions.size();
+
+            for(size_t i = 0; i < numberOfContinuousVariables; i++)
+                point[block.sourceIndexes[i]] = results[k].solution[i];
+        }
+
+        env->primalSolver->addPrimalSolutionCandidate(
+            point, E_PrimalSolutionSource::NLPFixedIntegers, currIter->iterationNumber);
+    }
+
+    // The master problem would give the same solution again
+    if(numberOfAddedCuts == 0)
+    {
+        env->results->terminationReason = E_TerminationReason::NoDualCutsAdded;
+        env->results->terminationReasonDescription
+            = "Terminated since no Benders cuts are violated by the master solution.";
+        env->tasks->setNextTask("FinalizeSolution");
+    }
+
+    env->timing->stopTimer("PrimalBoundStrategyNLP");
+}
+
+void TaskSolveBendersSubproblems::solveBlock(int blockIndex, const VectorDouble& masterSolution, BlockResult& result)
+{
+    auto& block = decomposition->blocks[blockIndex];
+
+    VectorDouble linkingValues(block.linkingPositions.size());
+
+    for(size_t k = 0; k < block.linkingPositions.size(); k++)
+        linkingValues[k] = std::round(masterSolution[block.sourceIndexes[block.linkingPositions[k]]]);
+
+#ifdef HAS_IPOPT
+    // The variables are fixed through the interface, where the methods are public
+    INLPSolver& solver = *solvers[blockIndex];
+
+    solver.fixVariables(block.linkingPositions, linkingValues);
+    auto status = solver.solveProblem();
+    solver.unfixVariables();
+
+    if(status == E_NLPSolutionStatus::Optimal || status == E_NLPSolutionStatus::Feasible)
+    {
+        result.isFeasible = true;
+        result.objectiveValue = solver.getObjectiveValue();
+        result.solution = solver.getSolution();
+
+        auto derivatives = getLinkingDerivatives(
+            block.problem, block, result.solution, solvers[blockIndex]->getConstraintMultipliers(), true);
+
+        // eta_b >= v_b + mu^T (y - y_k)
+        result.cutConstant = result.objectiveValue;
+
+        for(size_t k = 0; k < derivatives.size(); k++)
+        {
+            if(derivatives[k] == 0.0)
+                continue;
+
+            int index = block.sourceIndexes[block.linkingPositions[k]];
+            result.cutElements[index] = derivatives[k];
+            result.cutConstant -= derivatives[k] * linkingValues[k];
+        }
+
+        result.cutElements[block.masterVariableIndex] = -1.0;
+        result.hasCut = true;
+
+        return;
+    }
+
+    INLPSolver& feasibilitySolver = *feasibilitySolvers[blockIndex];
+
+    feasibilitySolver.fixVariables(block.linkingPositions, linkingValues);
+    status = feasibilitySolver.solveProblem();
+    feasibilitySolver.unfixVariables();
+
+    if(status != E_NLPSolutionStatus::Optimal && status != E_NLPSolutionStatus::Feasible)
+    {
+        env->output->outputDebug(fmt::format("        Feasibility problem of block {} not solved.", blockIndex));
+        createNoGoodCut(block, linkingValues, result);
+        return;
+    }
+
+    double infeasibility = feasibilitySolver.getObjectiveValue();
+
+    auto derivatives = getLinkingDerivatives(block.feasibilityProblem, block, feasibilitySolver.getSolution(),
+        feasibilitySolvers[blockIndex]->getConstraintMultipliers(), false);
+
+    // w_b + mu^T (y - y_k) <= 0
+    result.cutConstant = infeasibility;
+
+    for(size_t k = 0; k < derivatives.size(); k++)
+    {
+        if(derivatives[k] == 0.0)
+            continue;
+
+        int index = block.sourceIndexes[block.linkingPositions[k]];
+        result.cutElements[index] = derivatives[k];
+        result.cutConstant -= derivatives[k] * linkingValues[k];
+    }
+
+    if(infeasibility <= env->settings->getSetting<double>("Decomposition.CutTolerance", "Strategy"))
+    {
+        // The block problem was not solved even though it is feasible
+        result.cutElements.clear();
+        createNoGoodCut(block, linkingValues, result);
+    }
+    else if(result.cutElements.size() > 0)
+    {
+        result.hasCut = true;
+    }
+    else
+    {
+        result.isInfeasibleForAllValues = true;
+    }
+#else
+    createNoGoodCut(block, linkingValues, result);
+#endif
+}
+
+VectorDouble TaskSolveBendersSubproblems::getLinkingDerivatives(const ProblemPtr& problem,
+    const BlockDecomposition::Block& block, const VectorDouble& solution, const VectorDouble& multipliers,
+    bool includeObjective)
+{
+    VectorDouble derivatives(block.linkingPositions.size(), 0.0);
+
+    if(solution.size() == 0)
+        return (derivatives);
+
+    int firstLinkingPosition = block.linkingPositions.size() > 0 ? block.linkingPositions.front() : 0;
+
+    auto addGradient = [&](const SparseVariableVector& gradient, double factor) {
+        for(auto& [variable, value] : gradient)
+        {
+            int position = variable->index - firstLinkingPosition;
+
+            if(position >= 0 && position < (int)derivatives.size())
+                derivatives[position] += factor * value;
+        }
+    };
+
+    if(includeObjective)
+        addGradient(problem->objectiveFunction->calculateGradient(solution, true), 1.0);
+
+    for(size_t i = 0; i < multipliers.size() && i < problem->numericConstraints.size(); i++)
+    {
+        if(multipliers[i] != 0.0)
+            addGradient(problem->numericConstraints[i]->calculateGradient(solution, true), multipliers[i]);
+    }
+
+    return (derivatives);
+}
+
+bool TaskSolveBendersSubproblems::createNoGoodCut(
+    const BlockDecomposition::Block& block, const VectorDouble& linkingValues, BlockResult& result)
+{
+    auto sourceProblem = decomposition->getSourceProblem();
+
+    // sum_{y_k = 0} y_k + sum_{y_k = 1} (1 - y_k) >= 1
+    result.cutConstant = 1.0;
+
+    for(size_t k = 0; k < linkingValues.size(); k++)
+    {
+        int index = block.sourceIndexes[block.linkingPositions[k]];
+
+        if(sourceProblem->allVariables[index]->properties.type != E_VariableType::Binary)
+        {
+            result.cutElements.clear();
+            return (false);
+        }
+
+        if(linkingValues[k] > 0.5)
+        {
+            result.cutElements[index] = 1.0;
+            result.cutConstant -= 1.0;
+        }
+        else
+        {
+            result.cutElements[index] = -1.0;
+        }
+    }
+
+    result.hasCut = result.cutElements.size() > 0;
+    return (result.hasCut);
+}
+
+std::string TaskSolveBendersSubproblems::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
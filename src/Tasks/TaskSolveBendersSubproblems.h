@@ -0,0 +1,69 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include "../Structs.h"
+
+#include "../Model/BlockDecomposition.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace SHOT
+{
+class NLPSolverIpoptRelaxed;
+
+// Solves the problems of the blocks with the discrete variables fixed to the values in the master solution, and adds
+// the generalized Benders cuts for the blocks to the master problem. The solution is a primal solution candidate if all
+// the blocks are feasible.
+class TaskSolveBendersSubproblems : public TaskBase
+{
+public:
+    // Solves the blocks once with the discrete variables relaxed for the lower bounds on their objective values
+    TaskSolveBendersSubproblems(EnvironmentPtr envPtr, BlockDecompositionPtr decomposition);
+    ~TaskSolveBendersSubproblems() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    BlockDecompositionPtr decomposition;
+
+    std::vector<std::shared_ptr<NLPSolverIpoptRelaxed>> solvers;
+    std::vector<std::shared_ptr<NLPSolverIpoptRelaxed>> feasibilitySolvers;
+
+    // The cut elements * x + constant <= 0 for the master problem, where x are the master variables
+    struct BlockResult
+    {
+        bool isFeasible = false;
+        bool hasCut = false;
+        bool isInfeasibleForAllValues = false;
+
+        double objectiveValue = 0.0;
+        VectorDouble solution;
+
+        std::map<int, double> cutElements;
+        double cutConstant = 0.0;
+    };
+
+    void solveBlock(int blockIndex, const VectorDouble& masterSolution, BlockResult& result);
+
+    // The derivatives of the Lagrangian of the solved block problem with respect to the discrete variables
+    VectorDouble getLinkingDerivatives(const ProblemPtr& problem, const BlockDecomposition::Block& block,
+        const VectorDouble& solution, const VectorDouble& multipliers, bool includeObjective);
+
+    // Excludes the values of binary discrete variables from the master problem, if all of them are binary
+    bool createNoGoodCut(
+        const BlockDecomposition::Block& block, const VectorDouble& linkingValues, BlockResult& result);
+};
+} // namespace SHOT
@@ -10,8 +10,10 @@
 
 #include "TaskSolveIteration.h"
 
+#include "../DebugWriter.h"
 #include "../DualSolver.h"
 #include "../Iteration.h"
+#include "../Metrics.h"
 #include "../Output.h"
 #include "../Report.h"
 #include "../Results.h"
@@ -55,7 +57,7 @@ void TaskSolveIteration::run()
 
     // Sets the iteration time limit
     auto timeLim = env->settings->getSetting<double>("TimeLimit", "Termination") - env->timing->getElapsedTime("Total");
-    env->dualSolver->MIPSolver->setTimeLimit(timeLim);
+    env->dualSolver->MIPSolver->setTimeLimit(std::min(timeLim, env->dualSolver->MIPIterationTimeLimit));
 
     if(env->dualSolver->useCutOff && !currIter->MIPSolutionLimitUpdated)
     {
@@ -123,8 +125,34 @@ void TaskSolveIteration::run()
         env->dualSolver->MIPSolver->setSolutionLimit(2100000000);
     }
 
+    env->dualSolver->isSolutionStreamingUsed = !env->dualSolver->isSingleTree && currIter->isMIP()
+        && env->settings->getSetting<bool>("MIP.SolutionStreaming.Use", "Dual");
+    env->dualSolver->numberOfStreamedViolatedSolutions = 0;
+    env->dualSolver->isMIPSolveInterrupted = false;
+
+    // The MIP is not interrupted if it should be solved to optimality
+    if(env->dualSolver->isSolutionStreamingUsed && env->dualSolver->MIPSolver->getSolutionLimit() < 2100000000)
+    {
+        env->dualSolver->maxStreamedViolatedSolutions
+            = env->settings->getSetting<int>("MIP.SolutionStreaming.InterruptAfter", "Dual");
+    }
+    else
+    {
+        env->dualSolver->maxStreamedViolatedSolutions = 0;
+    }
+
     env->output->outputDebug("        Solving dual problem.");
-    auto solStatus = env->dualSolver->MIPSolver->solveProblem();
+    E_ProblemSolutionStatus solStatus;
+
+    double solveStartTime = env->timing->getElapsedTime("Total");
+
+    {
+        MetricsTimer timer(env->metrics.get(), E_MetricsHistogram::MIPSolveTime);
+        solStatus = env->dualSolver->MIPSolver->solveProblem();
+    }
+
+    if(env->metrics)
+        env->metrics->increment(E_MetricsCounter::MIPProblems);
 
     // Must update the pointer to the current iteration if we use the lazy
     // strategy since new iterations have been created when solving
@@ -142,6 +170,7 @@ void TaskSolveIteration::run()
     }
 
     currIter->solutionStatus = solStatus;
+    currIter->solutionTime = env->timing->getElapsedTime("Total") - solveStartTime;
 
     env->output->outputDebug(fmt::format("        Dual problem solved with return code: {}", (int)solStatus));
 
@@ -158,7 +187,7 @@ void TaskSolveIteration::run()
             for(size_t i = 0; i < sols.size(); i++)
             {
                 auto filename = fmt::format("{}/dualiter{}_solpt_{}.txt", debugPath, currIter->iterationNumber - 1, i);
-                Utilities::saveVariablePointVectorToFile(sols.at(i).point, variableNames, filename);
+                env->debugWriter->writePoint(sols.at(i).point, variableNames, filename);
             }
 
             for(size_t i = 0; i < sols.size(); i++)
@@ -168,7 +197,7 @@ void TaskSolveIteration::run()
                 auto filecontents
                     = fmt::format("objective function value\t\t{}\nmax constr. dev. ([index]: value)\t[{}]: {}\n",
                         sols.at(i).objectiveValue, sols.at(i).maxDeviation.index, sols.at(i).maxDeviation.value);
-                Utilities::writeStringToFile(filename, filecontents);
+                env->debugWriter->write(filename, filecontents);
             }
         }
 
@@ -197,7 +226,7 @@ void TaskSolveIteration::run()
                 auto filecontents = fmt::format("most dev. constraint ([index]: value)\t[{}]: {}\n",
                     currIter->maxDeviationConstraint, currIter->maxDeviation);
 
-                Utilities::writeStringToFile(filename, filecontents);
+                env->debugWriter->write(filename, filecontents);
             }
         }
         else
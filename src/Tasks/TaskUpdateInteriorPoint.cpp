@@ -11,13 +11,17 @@
 #include "TaskUpdateInteriorPoint.h"
 
 #include "../DualSolver.h"
+#include "../Iteration.h"
 #include "../Output.h"
 #include "../Results.h"
 #include "../Settings.h"
 #include "../Timing.h"
+#include "../Utilities.h"
 
 #include "../Model/Problem.h"
 
+#include <algorithm>
+
 namespace SHOT
 {
 
@@ -84,6 +88,16 @@ void TaskUpdateInteriorPoint::run()
         tmpIP->point, env->reformulatedProblem->nonlinearConstraints);
     tmpIP->maxDevatingConstraint = PairIndexValue(maxDev.constraint->index, maxDev.normalizedValue);
 
+    if(env->settings->getSetting<int>("ESH.InteriorPoint.UsePrimalSolution", "Dual")
+        == static_cast<int>(ES_AddPrimalPointAsInteriorPoint::Adaptive))
+    {
+        if(maxDev.normalizedValue < 0)
+            updateAdaptiveInteriorPoints(tmpIP);
+
+        env->timing->stopTimer("InteriorPointSearch");
+        return;
+    }
+
     // Replace the current point with the new point if it is deeper within the feasible region
     if(maxDev.normalizedValue < env->dualSolver->interiorPts.at(0)->maxDevatingConstraint.value)
     {
@@ -146,6 +160,61 @@ void TaskUpdateInteriorPoint::run()
     env->timing->stopTimer("InteriorPointSearch");
 }
 
+void TaskUpdateInteriorPoint::updateAdaptiveInteriorPoints(std::shared_ptr<InteriorPoint> interiorPoint)
+{
+    auto& interiorPoints = env->dualSolver->interiorPts;
+
+    double minDistance = env->settings->getSetting<double>("ESH.InteriorPoint.Adaptive.MinDistance", "Dual");
+    size_t maxPoints = env->settings->getSetting<int>("ESH.InteriorPoint.Adaptive.MaxPoints", "Dual");
+
+    double averageScore = 0.0;
+
+    for(auto& IP : interiorPoints)
+    {
+        // The same primal solution is normally used in several iterations, and close points give similar cuts
+        if(Utilities::L2Norm(IP->point, interiorPoint->point)
+            <= minDistance * std::max(1.0, Utilities::L2Norm(IP->point)))
+            return;
+
+        averageScore += IP->score / interiorPoints.size();
+    }
+
+    // The new point gets the average score so that it is used before it is replaced
+    interiorPoint->score = averageScore;
+    interiorPoint->iterationLastUsed = env->results->getCurrentIteration()->iterationNumber;
+
+    if(interiorPoints.size() < maxPoints)
+    {
+        env->output->outputDebug("        Primal solution point added to the adaptive set of interior points.");
+        interiorPoints.push_back(interiorPoint);
+        return;
+    }
+
+    // The original interior points are kept unless there are only original points
+    size_t firstReplaceable = env->solutionStatistics.numberOfOriginalInteriorPoints;
+
+    if(firstReplaceable >= interiorPoints.size())
+        firstReplaceable = 0;
+
+    size_t worstIndex = firstReplaceable;
+
+    for(size_t i = firstReplaceable + 1; i < interiorPoints.size(); i++)
+    {
+        auto& IP = interiorPoints[i];
+        auto& worst = interiorPoints[worstIndex];
+
+        if(IP->score < worst->score
+            || (IP->score == worst->score && IP->iterationLastUsed < worst->iterationLastUsed))
+            worstIndex = i;
+    }
+
+    env->output->outputDebug(fmt::format(
+        "        Interior point {} with score {} replaced with primal solution point.", worstIndex,
+        interiorPoints[worstIndex]->score));
+
+    interiorPoints[worstIndex] = interiorPoint;
+}
+
 std::string TaskUpdateInteriorPoint::getType()
 {
     std::string type = typeid(this).name();
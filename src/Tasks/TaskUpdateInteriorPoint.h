@@ -11,6 +11,8 @@
 #pragma once
 #include "TaskBase.h"
 
+#include <memory>
+
 namespace SHOT
 {
 class TaskUpdateInteriorPoint : public TaskBase
@@ -22,5 +24,8 @@ public:
     std::string getType() override;
 
 private:
+    // Adds the point to the set of interior points if it differs enough from the others, replacing the point with the
+    // lowest score if the set is full
+    void updateAdaptiveInteriorPoints(std::shared_ptr<InteriorPoint> interiorPoint);
 };
 } // namespace SHOT
\ No newline at end of file
@@ -0,0 +1,91 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskUpdateMIPGap.h"
+
+#include "../DualSolver.h"
+#include "../Iteration.h"
+#include "../MIPSolver/IMIPSolver.h"
+#include "../Output.h"
+#include "../Results.h"
+#include "../Settings.h"
+
+#include "../Model/Problem.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace SHOT
+{
+
+TaskUpdateMIPGap::TaskUpdateMIPGap(EnvironmentPtr envPtr) : TaskBase(envPtr)
+{
+    gapFactor = env->settings->getSetting<double>("MIP.DynamicGap.Factor", "Dual");
+}
+
+TaskUpdateMIPGap::~TaskUpdateMIPGap() = default;
+
+void TaskUpdateMIPGap::run()
+{
+    if(!env->results->hasPrimalSolution())
+        return;
+
+    auto currIter = env->results->getCurrentIteration();
+
+    double terminationGap = env->settings->getSetting<double>("ObjectiveGap.Relative", "Termination");
+    double primalBound = env->results->getPrimalBound();
+
+    int stagnatedIterations = env->solutionStatistics.numberOfIterationsWithDualStagnation;
+    int stagnationLimit = env->settings->getSetting<int>("MIP.DynamicGap.StagnationIterations", "Dual");
+
+    // Tightened once for each period of stagnated iterations
+    if(stagnatedIterations > 0 && stagnatedIterations % stagnationLimit == 0
+        && currIter->iterationNumber != lastTightenedIteration)
+    {
+        gapFactor /= 2.0;
+        lastTightenedIteration = currIter->iterationNumber;
+
+        env->output->outputDebug(
+            fmt::format("        Dual bound stagnated, MIP gap factor decreased to {}.", gapFactor));
+    }
+
+    double gap = std::clamp(gapFactor * env->results->getRelativeGlobalObjectiveGap(), terminationGap,
+        env->settings->getSetting<double>("MIP.DynamicGap.MaxGap", "Dual"));
+
+    if(!std::isnan(currentGap))
+        gap = std::min(gap, currentGap);
+
+    if(gap != currentGap)
+    {
+        env->dualSolver->MIPSolver->setRelativeGap(gap);
+        currentGap = gap;
+    }
+
+    // When the dual bound of the MIP problem reaches this, the global gap is closed
+    double tolerance = std::max(env->settings->getSetting<double>("ObjectiveGap.Absolute", "Termination"),
+        terminationGap * std::abs(primalBound));
+
+    double dualBoundStop = env->reformulatedProblem->objectiveFunction->properties.isMinimize
+        ? primalBound - tolerance
+        : primalBound + tolerance;
+
+    if(dualBoundStop != currentDualBoundStop)
+    {
+        env->dualSolver->MIPSolver->setDualBoundStop(dualBoundStop);
+        currentDualBoundStop = dualBoundStop;
+    }
+}
+
+std::string TaskUpdateMIPGap::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
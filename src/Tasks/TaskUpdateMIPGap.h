@@ -0,0 +1,39 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+#include <cmath>
+#include <string>
+
+namespace SHOT
+{
+// Sets the relative gap of the MIP solver for the next iteration from the current global gap, since the MIP problems
+// do not need to be solved to optimality while the relaxation is far from the primal bound. The fraction of the
+// global gap is halved each time the dual bound has stagnated, and the gap is never larger than in the last iteration
+// or smaller than the termination gap. The MIP solver also stops when its dual bound reaches the termination gap.
+class TaskUpdateMIPGap : public TaskBase
+{
+public:
+    TaskUpdateMIPGap(EnvironmentPtr envPtr);
+    ~TaskUpdateMIPGap() override;
+
+    void run() override;
+    std::string getType() override;
+
+private:
+    double gapFactor;
+    double currentGap = NAN;
+    double currentDualBoundStop = NAN;
+
+    int lastTightenedIteration = -1;
+};
+} // namespace SHOT
@@ -0,0 +1,73 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "TaskWriteCheckpoint.h"
+
+#include "../Output.h"
+#include "../Settings.h"
+#include "../Timing.h"
+#include "../WarmStart.h"
+
+#include <cstdio>
+
+namespace SHOT
+{
+
+TaskWriteCheckpoint::TaskWriteCheckpoint(EnvironmentPtr envPtr) : TaskBase(envPtr) { }
+
+TaskWriteCheckpoint::~TaskWriteCheckpoint() = default;
+
+void TaskWriteCheckpoint::run()
+{
+    auto filename = env->settings->getSetting<std::string>("Checkpoint.File", "Output");
+
+    if(filename == "")
+        return;
+
+    double currentTime = env->timing->getElapsedTime("Total");
+
+    if(currentTime - timeLastCheckpoint < env->settings->getSetting<double>("Checkpoint.Frequency.Time", "Output"))
+        return;
+
+    timeLastCheckpoint = currentTime;
+
+    WarmStart checkpoint(env);
+    checkpoint.collect(true);
+
+    std::string temporaryFilename = filename + ".tmp";
+
+    if(!checkpoint.write(temporaryFilename))
+        return;
+
+    // The rename does not replace an existing file on all platforms
+    if(std::rename(temporaryFilename.c_str(), filename.c_str()) != 0
+        && (std::remove(filename.c_str()) != 0 || std::rename(temporaryFilename.c_str(), filename.c_str()) != 0))
+    {
+        env->output->outputWarning(fmt::format("        Could not write checkpoint to file {}.", filename));
+        return;
+    }
+
+    env->output->outputDebug("        Checkpoint written to file {} in {:.3f} s.", filename,
+        env->timing->getElapsedTime("Total") - currentTime);
+}
+
+std::vector<E_TaskEnvironmentState> TaskWriteCheckpoint::getReadStates()
+{
+    return { E_TaskEnvironmentState::Problem, E_TaskEnvironmentState::Results, E_TaskEnvironmentState::DualSolver };
+}
+
+std::vector<E_TaskEnvironmentState> TaskWriteCheckpoint::getModifiedStates() { return {}; }
+
+std::string TaskWriteCheckpoint::getType()
+{
+    std::string type = typeid(this).name();
+    return (type);
+}
+} // namespace SHOT
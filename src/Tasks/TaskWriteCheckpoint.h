@@ -0,0 +1,36 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "TaskBase.h"
+
+namespace SHOT
+{
+
+// Writes a checkpoint of the solver state to Checkpoint.File at most every Checkpoint.Frequency.Time seconds, from
+// which a stopped run can be resumed with SHOT --resume. The checkpoint is first written to a temporary file, so that
+// the previous checkpoint remains valid if the run is stopped while it is written.
+class TaskWriteCheckpoint : public TaskBase
+{
+public:
+    TaskWriteCheckpoint(EnvironmentPtr envPtr);
+    ~TaskWriteCheckpoint() override;
+
+    void run() override;
+    std::string getType() override;
+
+    // Only reads the environment, and can be written while the iteration report is printed
+    std::vector<E_TaskEnvironmentState> getReadStates() override;
+    std::vector<E_TaskEnvironmentState> getModifiedStates() override;
+
+private:
+    double timeLastCheckpoint = 0.0;
+};
+} // namespace SHOT
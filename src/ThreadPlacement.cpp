@@ -0,0 +1,111 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "ThreadPlacement.h"
+
+#include "Enums.h"
+#include "Settings.h"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace SHOT::ThreadPlacement
+{
+
+int getNumberOfThreads(SettingsPtr settings, int requestedNumberOfThreads)
+{
+    if(requestedNumberOfThreads > 0)
+        return (requestedNumberOfThreads);
+
+    int numberOfThreads = settings->getSetting<int>("Parallel.NumberOfThreads", "Strategy");
+
+    if(numberOfThreads > 0)
+        return (numberOfThreads);
+
+    return (std::max(1, (int)std::thread::hardware_concurrency()));
+}
+
+int getNumberOfMIPThreads(SettingsPtr settings)
+{
+    int numberOfThreads = settings->getSetting<int>("MIP.NumberOfThreads", "Dual");
+
+    if(numberOfThreads > 0)
+        return (numberOfThreads);
+
+    numberOfThreads = settings->getSetting<int>("Parallel.NumberOfThreads", "Strategy");
+
+    if(numberOfThreads == 0)
+        return (0);
+
+    // The background primal thread runs at the same time as the MIP solver
+    if(static_cast<ES_TreeStrategy>(settings->getSetting<int>("TreeStrategy", "Dual")) == ES_TreeStrategy::SingleTree
+        && settings->getSetting<bool>("TreeStrategy.Single.BackgroundPrimal", "Dual"))
+        numberOfThreads--;
+
+    return (std::max(1, numberOfThreads));
+}
+
+void pinThread([[maybe_unused]] SettingsPtr settings, [[maybe_unused]] int threadNumber)
+{
+#ifdef __linux__
+    if(!settings->getSetting<bool>("Parallel.PinThreads", "Strategy"))
+        return;
+
+    int numberOfCores = std::max(1, (int)std::thread::hardware_concurrency());
+
+    cpu_set_t cores;
+    CPU_ZERO(&cores);
+    CPU_SET(threadNumber % numberOfCores, &cores);
+
+    // The thread is left where it is if the core cannot be used, e.g. if it is outside of the allowed cores
+    pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cores);
+#endif
+}
+
+bool isDeterministic(SettingsPtr settings)
+{
+    return (settings->getSetting<bool>("Parallel.Deterministic", "Strategy"));
+}
+
+WorkQueue::WorkQueue(SettingsPtr settings, size_t numberOfItems, int numberOfThreads, size_t firstItem)
+    : numberOfItems(numberOfItems),
+      numberOfThreads(std::max(1, numberOfThreads)),
+      isDeterministic(ThreadPlacement::isDeterministic(settings)),
+      nextItem(firstItem)
+{
+    if(isDeterministic)
+    {
+        for(size_t t = 0; t < this->numberOfThreads; t++)
+            nextThreadItems.push_back(firstItem + t);
+    }
+}
+
+bool WorkQueue::getNextItem(int threadNumber, size_t& item)
+{
+    if(isDeterministic)
+    {
+        // Each worker only changes its own entry
+        item = nextThreadItems.at(threadNumber);
+        nextThreadItems[threadNumber] += numberOfThreads;
+    }
+    else
+    {
+        item = nextItem++;
+    }
+
+    return (item < numberOfItems);
+}
+
+} // namespace SHOT::ThreadPlacement
@@ -0,0 +1,58 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+#include "Structs.h"
+
+#include <atomic>
+#include <vector>
+
+namespace SHOT::ThreadPlacement
+{
+
+// The parallel phases of SHOT, e.g. the root searches and bound tightening, and the MIP solver share the cores given
+// by Parallel.NumberOfThreads. The phases are mostly run between the MIP solves, so the MIP solver is given all of
+// them except those used by SHOT at the same time as it.
+
+// The number of threads of a phase with the given thread setting, where 0 means all of the shared cores
+int getNumberOfThreads(SettingsPtr settings, int requestedNumberOfThreads);
+
+// The number of threads of the MIP solver, where 0 lets the MIP solver decide
+int getNumberOfMIPThreads(SettingsPtr settings);
+
+// Pins the calling thread to a core if Parallel.PinThreads is used. The workers of a phase are numbered from zero, and
+// since their buffers are allocated by the workers themselves they are then placed in the memory of the same node.
+void pinThread(SettingsPtr settings, int threadNumber);
+
+// Whether Parallel.Deterministic is used, i.e. whether the parallel phases should give the same results whatever the
+// timing of their threads
+bool isDeterministic(SettingsPtr settings);
+
+// Distributes the items 0, 1, ... to the worker threads of a phase. The items are normally taken by the threads as they
+// become available. With Parallel.Deterministic, worker t is given the items t, t + numberOfThreads, ... in order, so
+// that the items are solved by the same worker, e.g. with the same warm-started solver, whatever the timing.
+class WorkQueue
+{
+public:
+    WorkQueue(SettingsPtr settings, size_t numberOfItems, int numberOfThreads, size_t firstItem = 0);
+
+    // Returns false when there are no more items for the worker
+    bool getNextItem(int threadNumber, size_t& item);
+
+private:
+    size_t numberOfItems;
+    size_t numberOfThreads;
+    bool isDeterministic;
+
+    std::atomic<size_t> nextItem;
+    std::vector<size_t> nextThreadItems;
+};
+
+} // namespace SHOT::ThreadPlacement
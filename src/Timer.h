@@ -9,7 +9,10 @@
 */
 
 #pragma once
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 class Timer
@@ -34,6 +37,16 @@ public:
         name = timerName;
     }
 
+    Timer(std::string timerName, std::string desc, int parentIndex, int timerDepth)
+    {
+        restart();
+        isRunning = false;
+        description = desc;
+        name = timerName;
+        parent = parentIndex;
+        depth = timerDepth;
+    }
+
     std::chrono::time_point<std::chrono::high_resolution_clock> lastStart;
 
     inline double elapsed()
@@ -42,18 +55,28 @@ public:
         {
             std::chrono::duration<double> dur = std::chrono::high_resolution_clock::now() - lastStart;
             double tmpTime = dur.count();
-            return (timeElapsed + tmpTime);
+            return (timeElapsed + tmpTime + getThreadTime());
         }
-        return (timeElapsed);
+        return (timeElapsed + getThreadTime());
     }
 
     inline void restart()
     {
         isRunning = true;
         timeElapsed = 0.0;
+        threadNanoseconds.store(0, std::memory_order_relaxed);
         lastStart = std::chrono::high_resolution_clock::now();
     }
 
+    // Stops the timer and sets the elapsed time to zero
+    inline void reset()
+    {
+        isRunning = false;
+        timeElapsed = 0.0;
+        threadNanoseconds.store(0, std::memory_order_relaxed);
+        peakResidentMemory = 0;
+    }
+
     inline void stop()
     {
         if(!isRunning)
@@ -76,10 +99,32 @@ public:
         lastStart = std::chrono::high_resolution_clock::now();
     }
 
+    // Adds time measured in a thread other than the one owning the timer, may be called concurrently
+    inline void addThreadTime(std::chrono::high_resolution_clock::duration duration)
+    {
+        threadNanoseconds.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count(), std::memory_order_relaxed);
+    }
+
+    inline bool isStarted() const { return (isRunning); }
+
+    inline double getThreadTime() const { return (threadNanoseconds.load(std::memory_order_relaxed) * 1e-9); }
+
     std::string description;
     std::string name;
 
+    // The index of the parent timer in the timing breakdown, -1 for a top level timer
+    int parent = -1;
+    int depth = 0;
+
+    // The largest resident memory in bytes seen while the timer was running, see MemoryMonitor. Only sampled for the
+    // timers at depth 0 and 1 when they are started and stopped by the thread owning the timers.
+    size_t peakResidentMemory = 0;
+    size_t processPeakResidentMemoryAtStart = 0;
+
 private:
+    std::atomic<int64_t> threadNanoseconds { 0 };
+
     double timeElapsed;
     bool isRunning;
 };
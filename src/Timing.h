@@ -10,79 +10,258 @@
 
 #pragma once
 #include "Environment.h"
+#include "MemoryMonitor.h"
 #include "Timer.h"
+#include "TraceRecorder.h"
 
 #include <algorithm>
+#include <deque>
+#include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace SHOT
 {
 
+// The timers are stored in the order they are created, and each timer can have a parent timer so that the report can
+// show a nested breakdown of the solution time. Timers are normally started and stopped from the thread that created
+// the Timing object. When started and stopped from another thread (e.g. in the callbacks of the MIP solver), the
+// elapsed time is instead measured per thread and accumulated in the timer when it is stopped, so the time of a timer
+// may exceed the wall clock time if several threads use it simultaneously. If a trace recorder is active, the start and
+// stop of each timer is also recorded as an event in the timeline. The resident memory is sampled when the top level
+// phases start and stop, so that the report can show the peak memory of each phase.
 class Timing
 {
 public:
-    inline Timing(EnvironmentPtr envPtr) { env = envPtr; };
+    inline Timing(EnvironmentPtr envPtr) : ownerThread(std::this_thread::get_id()) { env = envPtr; };
 
-    inline ~Timing() { timers.clear(); }
+    inline ~Timing()
+    {
+        timers.clear();
+        timerIDs.clear();
+    }
+
+    // Creates a new timer, or returns the existing one with the same name. The parent timer must have been created
+    // before its children, and if it does not exist the timer is created at the top level.
+    inline TimerID createTimer(std::string name, std::string description, std::string parent = "")
+    {
+        auto existing = timerIDs.find(name);
+
+        if(existing != timerIDs.end())
+            return (existing->second);
 
-    inline void createTimer(std::string name, std::string description) { timers.emplace_back(name, description); }
+        TimerID parentID = getTimerID(parent);
+        int depth = (parentID >= 0) ? timers[parentID].depth + 1 : 0;
 
-    inline void startTimer(std::string name)
+        TimerID ID = (TimerID)timers.size();
+        timers.emplace_back(name, description, parentID, depth);
+        timerIDs.emplace(name, ID);
+
+        return (ID);
+    }
+
+    // Timers started and stopped from other threads than this one are measured per thread
+    inline void setOwnerThread() { ownerThread = std::this_thread::get_id(); }
+
+    // Returns -1 if the timer does not exist
+    inline TimerID getTimerID(const std::string& name) const
     {
-        auto timer = std::find_if(timers.begin(), timers.end(), [name](Timer const& T) { return (T.name == name); });
+        auto timer = timerIDs.find(name);
 
-        if(timer == timers.end())
-        {
-            // env->output->outputError("Timer with name  \"" + name + "\" not found!");
-            return;
-        }
+        if(timer == timerIDs.end())
+            return (-1);
 
-        timer->start();
+        return (timer->second);
     }
 
-    inline void stopTimer(std::string name)
+    inline void startTimer(TimerID ID)
     {
-        auto timer = std::find_if(timers.begin(), timers.end(), [name](Timer const& T) { return (T.name == name); });
+        if(ID < 0 || ID >= (TimerID)timers.size())
+            return;
 
-        if(timer == timers.end())
+        if(std::this_thread::get_id() == ownerThread)
         {
-            // env->output->outputError("Timer with name  \"" + name + "\" not found!");
-            return;
+            if(timers[ID].isStarted())
+                return;
+
+            timers[ID].start();
+
+            if(timers[ID].depth <= 1 && env && env->memoryMonitor)
+            {
+                auto [residentMemory, peakResidentMemory] = env->memoryMonitor->sample();
+                timers[ID].peakResidentMemory = std::max(timers[ID].peakResidentMemory, residentMemory);
+                timers[ID].processPeakResidentMemoryAtStart = peakResidentMemory;
+            }
         }
+        else
+        {
+            auto& runningTimers = getThreadRunningTimers();
 
-        timer->stop();
+            // As for the owning thread, starting an already running timer has no effect
+            for(auto& T : runningTimers)
+            {
+                if(T.timing == this && T.ID == ID)
+                    return;
+            }
+
+            runningTimers.push_back({ this, ID, std::chrono::high_resolution_clock::now() });
+        }
+
+        if(env && env->traceRecorder)
+            env->traceRecorder->begin(timers[ID].name.c_str());
     }
 
-    inline void restartTimer(std::string name)
+    inline void stopTimer(TimerID ID)
     {
-        auto timer = std::find_if(timers.begin(), timers.end(), [name](Timer const& T) { return (T.name == name); });
+        if(ID < 0 || ID >= (TimerID)timers.size())
+            return;
 
-        if(timer == timers.end())
+        if(std::this_thread::get_id() == ownerThread)
         {
-            // env->output->outputError("Timer with name  \"" + name + "\" not found!");
-            return;
+            if(!timers[ID].isStarted())
+                return;
+
+            timers[ID].stop();
+
+            if(timers[ID].depth <= 1 && env && env->memoryMonitor)
+            {
+                auto [residentMemory, peakResidentMemory] = env->memoryMonitor->sample();
+                auto& T = timers[ID];
+
+                // A new peak of the process was reached while the timer was running
+                if(peakResidentMemory > T.processPeakResidentMemoryAtStart)
+                    residentMemory = std::max(residentMemory, peakResidentMemory);
+
+                T.peakResidentMemory = std::max(T.peakResidentMemory, residentMemory);
+            }
+        }
+        else
+        {
+            auto& runningTimers = getThreadRunningTimers();
+
+            auto T = std::find_if(runningTimers.begin(), runningTimers.end(),
+                [&](const ThreadRunningTimer& R) { return (R.timing == this && R.ID == ID); });
+
+            if(T == runningTimers.end())
+                return;
+
+            timers[ID].addThreadTime(std::chrono::high_resolution_clock::now() - T->start);
+            runningTimers.erase(T);
         }
 
-        timer->restart();
+        if(env && env->traceRecorder)
+            env->traceRecorder->end(timers[ID].name.c_str());
     }
 
-    inline double getElapsedTime(std::string name)
+    inline void restartTimer(TimerID ID)
     {
-        auto timer = std::find_if(timers.begin(), timers.end(), [name](Timer const& T) { return (T.name == name); });
+        if(ID < 0 || ID >= (TimerID)timers.size())
+            return;
 
-        if(timer == timers.end())
-        {
-            // env->output->outputError("Timer with name  \"" + name + "\" not found!");
+        timers[ID].restart();
+    }
+
+    // Stops all timers and sets their elapsed times to zero, e.g., before solving a problem again
+    inline void resetTimers()
+    {
+        for(auto& T : timers)
+            T.reset();
+    }
+
+    inline double getElapsedTime(TimerID ID)
+    {
+        if(ID < 0 || ID >= (TimerID)timers.size())
             return (0.0);
+
+        return (timers[ID].elapsed());
+    }
+
+    inline void startTimer(const std::string& name) { startTimer(getTimerID(name)); }
+
+    inline void stopTimer(const std::string& name) { stopTimer(getTimerID(name)); }
+
+    inline void restartTimer(const std::string& name) { restartTimer(getTimerID(name)); }
+
+    inline double getElapsedTime(const std::string& name) { return (getElapsedTime(getTimerID(name))); }
+
+    // Returns the timer indexes in depth-first order, i.e., every timer is directly followed by its children
+    inline std::vector<TimerID> getTimerHierarchy() const
+    {
+        std::vector<std::vector<TimerID>> children(timers.size());
+        std::vector<TimerID> roots;
+
+        for(TimerID i = 0; i < (TimerID)timers.size(); i++)
+        {
+            if(timers[i].parent >= 0)
+                children[timers[i].parent].push_back(i);
+            else
+                roots.push_back(i);
         }
 
-        return (timer->elapsed());
+        std::vector<TimerID> order;
+        order.reserve(timers.size());
+
+        std::vector<TimerID> stack(roots.rbegin(), roots.rend());
+
+        while(!stack.empty())
+        {
+            TimerID ID = stack.back();
+            stack.pop_back();
+            order.push_back(ID);
+
+            for(auto C = children[ID].rbegin(); C != children[ID].rend(); C++)
+                stack.push_back(*C);
+        }
+
+        return (order);
     }
 
-    std::vector<Timer> timers;
+    // A deque is used since the timers cannot be moved, and the references must stay valid when timers are added
+    std::deque<Timer> timers;
 
 private:
+    struct ThreadRunningTimer
+    {
+        const Timing* timing;
+        TimerID ID;
+        std::chrono::time_point<std::chrono::high_resolution_clock> start;
+    };
+
+    inline static std::vector<ThreadRunningTimer>& getThreadRunningTimers()
+    {
+        thread_local std::vector<ThreadRunningTimer> runningTimers;
+        return (runningTimers);
+    }
+
     EnvironmentPtr env;
+
+    std::thread::id ownerThread;
+    std::unordered_map<std::string, TimerID> timerIDs;
+};
+
+// Starts a timer when created and stops it when it goes out of scope
+class ScopedTimer
+{
+public:
+    inline ScopedTimer(const TimingPtr& timingPtr, TimerID timerID) : timing(timingPtr), ID(timerID)
+    {
+        timing->startTimer(ID);
+    }
+
+    inline ScopedTimer(const TimingPtr& timingPtr, const std::string& name)
+        : ScopedTimer(timingPtr, timingPtr->getTimerID(name))
+    {
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    inline ~ScopedTimer() { timing->stopTimer(ID); }
+
+private:
+    TimingPtr timing;
+    TimerID ID;
 };
 
-} // namespace SHOT
\ No newline at end of file
+} // namespace SHOT
@@ -0,0 +1,214 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace SHOT
+{
+
+// Records begin and end events of the solver phases to be shown as a timeline in a Chrome trace viewer (e.g.
+// chrome://tracing or Perfetto). Each thread writes to its own ring buffer, which it allocates the first time it
+// records an event, so recording an event is lock-free and only touches memory owned by the thread. When a buffer is
+// full, the oldest events of the thread are overwritten. The names of the events are not copied and must stay valid
+// until the trace has been written.
+class TraceRecorder
+{
+public:
+    inline TraceRecorder(size_t eventsPerThread)
+        : capacity(std::max((size_t)1, eventsPerThread)), recorderID(getNextRecorderID()),
+          startTime(std::chrono::steady_clock::now())
+    {
+    }
+
+    inline ~TraceRecorder()
+    {
+        auto buffer = buffers.load(std::memory_order_acquire);
+
+        while(buffer)
+        {
+            auto next = buffer->next;
+            delete buffer;
+            buffer = next;
+        }
+    }
+
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    inline void setIteration(int iteration) { currentIteration.store(iteration, std::memory_order_relaxed); }
+
+    inline void begin(const char* name) { record(name, 'B'); }
+
+    inline void end(const char* name) { record(name, 'E'); }
+
+    // A value shown as a graph in the timeline, e.g. the memory use
+    inline void counter(const char* name, int64_t value) { record(name, 'C', value); }
+
+    // Writes the recorded events in the Chrome trace event format, should not be called while events are recorded
+    inline bool write(const std::string& filename) const
+    {
+        std::ofstream file(filename);
+
+        if(!file)
+            return (false);
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+        bool isFirst = true;
+
+        for(auto buffer = buffers.load(std::memory_order_acquire); buffer; buffer = buffer->next)
+        {
+            uint64_t count = buffer->count.load(std::memory_order_acquire);
+            uint64_t first = (count > capacity) ? count - capacity : 0;
+
+            file << fmt::format("{}{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},"
+                                "\"args\":{{\"name\":\"thread {}\"}}}}",
+                isFirst ? "" : ",\n", buffer->threadIndex, buffer->threadIndex);
+
+            isFirst = false;
+
+            // The end events whose begin event has been overwritten are skipped
+            int numberOfOpenEvents = 0;
+
+            for(uint64_t i = first; i < count; i++)
+            {
+                auto& E = buffer->events[i % capacity];
+
+                if(E.phase == 'C')
+                {
+                    file << fmt::format(",\n{{\"name\":\"{}\",\"ph\":\"C\",\"ts\":{:.3f},\"pid\":1,\"tid\":{},"
+                                        "\"args\":{{\"value\":{}}}}}",
+                        E.name, E.timestamp * 1e-3, buffer->threadIndex, E.value);
+                    continue;
+                }
+
+                if(E.phase == 'B')
+                    numberOfOpenEvents++;
+                else if(numberOfOpenEvents == 0)
+                    continue;
+                else
+                    numberOfOpenEvents--;
+
+                file << fmt::format(",\n{{\"name\":\"{}\",\"ph\":\"{}\",\"ts\":{:.3f},\"pid\":1,\"tid\":{},"
+                                    "\"args\":{{\"iteration\":{}}}}}",
+                    E.name, E.phase, E.timestamp * 1e-3, buffer->threadIndex, E.iteration);
+            }
+        }
+
+        file << "\n]}\n";
+
+        return (file.good());
+    }
+
+private:
+    struct TraceEvent
+    {
+        const char* name;
+        int64_t timestamp; // In nanoseconds since the recorder was created
+        int iteration;
+        char phase;
+        int64_t value; // Only for counter events
+    };
+
+    struct ThreadBuffer
+    {
+        inline ThreadBuffer(size_t capacity, int index) : events(capacity), threadIndex(index) {}
+
+        std::vector<TraceEvent> events;
+        std::atomic<uint64_t> count { 0 };
+        int threadIndex;
+        ThreadBuffer* next = nullptr;
+    };
+
+    const size_t capacity;
+    const uint64_t recorderID;
+    const std::chrono::steady_clock::time_point startTime;
+
+    std::atomic<ThreadBuffer*> buffers { nullptr };
+    std::atomic<int> numberOfThreads { 0 };
+    std::atomic<int> currentIteration { 0 };
+
+    inline static uint64_t getNextRecorderID()
+    {
+        static std::atomic<uint64_t> nextID { 1 };
+        return (nextID.fetch_add(1, std::memory_order_relaxed));
+    }
+
+    inline ThreadBuffer* getThreadBuffer()
+    {
+        // The recorder is identified by its ID, since a new recorder may be created at the address of a deleted one
+        thread_local uint64_t cachedRecorderID = 0;
+        thread_local ThreadBuffer* cachedBuffer = nullptr;
+
+        if(cachedRecorderID == recorderID)
+            return (cachedBuffer);
+
+        auto buffer = new ThreadBuffer(capacity, numberOfThreads.fetch_add(1, std::memory_order_relaxed));
+
+        // Lock-free push to the front of the list of buffers
+        buffer->next = buffers.load(std::memory_order_relaxed);
+
+        while(!buffers.compare_exchange_weak(
+            buffer->next, buffer, std::memory_order_release, std::memory_order_relaxed))
+            ;
+
+        cachedRecorderID = recorderID;
+        cachedBuffer = buffer;
+
+        return (buffer);
+    }
+
+    inline void record(const char* name, char phase, int64_t value = 0)
+    {
+        auto buffer = getThreadBuffer();
+        uint64_t index = buffer->count.load(std::memory_order_relaxed);
+
+        buffer->events[index % capacity] = { name,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count(),
+            currentIteration.load(std::memory_order_relaxed), phase, value };
+
+        buffer->count.store(index + 1, std::memory_order_release);
+    }
+};
+
+// Records a begin event when created and an end event when it goes out of scope, does nothing without a recorder
+class TraceScope
+{
+public:
+    inline TraceScope(TraceRecorder* recorderPtr, const char* eventName) : recorder(recorderPtr), name(eventName)
+    {
+        if(recorder)
+            recorder->begin(name);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+    inline ~TraceScope()
+    {
+        if(recorder)
+            recorder->end(name);
+    }
+
+private:
+    TraceRecorder* recorder;
+    const char* name;
+};
+} // namespace SHOT
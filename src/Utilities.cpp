@@ -8,7 +8,9 @@
    Please see the README and LICENSE files for more information.
 */
 
+#include <cassert>
 #include <chrono>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
@@ -32,11 +34,25 @@ namespace fs = std;
 namespace fs = std::experimental;
 #endif
 
+#if defined(__linux__) || defined(__APPLE__)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#endif
+
 namespace SHOT::Utilities
 {
 
 void saveVariablePointVectorToFile(
     const VectorDouble& point, const VectorString& variables, const std::string& fileName)
+{
+    writeStringToFile(fileName, getVariablePointVectorString(point, variables));
+}
+
+std::string getVariablePointVectorString(const VectorDouble& point, const VectorString& variables)
 {
     if(point.size() > variables.size())
     {
@@ -57,7 +73,7 @@ void saveVariablePointVectorToFile(
         str << '\n';
     }
 
-    writeStringToFile(fileName, str.str());
+    return (str.str());
 }
 
 void displayVector(const VectorDouble& point)
@@ -251,23 +267,64 @@ void displayVector(const std::vector<VectorString>& points)
     std::cout << str.str() << '\n';
 }
 
-double L2Norm(const VectorDouble& ptA, const VectorDouble& ptB)
+double L2NormSquared(const VectorDouble& ptA, const VectorDouble& ptB)
 {
-    double norm = 0.0;
+    assert(ptA.size() == ptB.size());
+
+    auto length = ptA.size();
+    const double* a = ptA.data();
+    const double* b = ptB.data();
+
+    // Four partial sums, since a single one is a dependency chain that prevents vectorization without fast math
+    double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+    size_t i = 0;
 
+    for(; i + 4 <= length; i += 4)
+    {
+        for(size_t k = 0; k < 4; k++)
+        {
+            double difference = a[i + k] - b[i + k];
+            sums[k] += difference * difference;
+        }
+    }
+
+    for(; i < length; i++)
+    {
+        double difference = a[i] - b[i];
+        sums[0] += difference * difference;
+    }
+
+    return ((sums[0] + sums[1]) + (sums[2] + sums[3]));
+}
+
+double L2Norm(const VectorDouble& ptA, const VectorDouble& ptB)
+{
     if(ptA.size() != ptB.size())
     {
         return (-1.0);
     }
 
-    for(size_t i = 0; i < ptA.size(); i++)
+    return (sqrt(L2NormSquared(ptA, ptB)));
+}
+
+double L2Norm(const VectorDouble& pt)
+{
+    auto length = pt.size();
+    const double* a = pt.data();
+
+    double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+    size_t i = 0;
+
+    for(; i + 4 <= length; i += 4)
     {
-        norm = norm + pow(ptA.at(i) - ptB.at(i), 2.0);
+        for(size_t k = 0; k < 4; k++)
+            sums[k] += a[i + k] * a[i + k];
     }
 
-    norm = sqrt(norm);
+    for(; i < length; i++)
+        sums[0] += a[i] * a[i];
 
-    return (norm);
+    return (sqrt((sums[0] + sums[1]) + (sums[2] + sums[3])));
 }
 
 VectorDouble L2Norms(const std::vector<VectorDouble>& ptsA, const VectorDouble& ptB)
@@ -276,28 +333,86 @@ VectorDouble L2Norms(const std::vector<VectorDouble>& ptsA, const VectorDouble&
 
     for(size_t i = 0; i < ptsA.size(); i++)
     {
-        norms.at(i) = L2Norm(ptsA.at(i), ptB);
+        norms[i] = L2Norm(ptsA[i], ptB);
+    }
+
+    return (norms);
+}
+
+VectorDouble L2Norms(const PointBlock& ptsA, const VectorDouble& ptB)
+{
+    assert(ptsA.numberOfVariables == (int)ptB.size());
+
+    VectorDouble norms(ptsA.numberOfPoints, 0.0);
+    double* sums = norms.data();
+
+    // The squared distances of all points are updated with unit stride for one variable at a time
+    for(int i = 0; i < ptsA.numberOfVariables; i++)
+    {
+        const double* values = ptsA.getVariableValues(i);
+        double value = ptB[i];
+
+        for(int p = 0; p < ptsA.numberOfPoints; p++)
+        {
+            double difference = values[p] - value;
+            sums[p] += difference * difference;
+        }
     }
 
+    for(auto& N : norms)
+        N = sqrt(N);
+
     return (norms);
 }
 
 VectorDouble calculateCenterPoint(const std::vector<VectorDouble>& pts)
 {
-    int ptSize = pts.at(0).size();
-    int numPts = pts.size();
+    size_t ptSize = pts.at(0).size();
+    size_t numPts = pts.size();
 
     VectorDouble newPt(ptSize, 0.0);
+    double* sums = newPt.data();
 
-    for(int i = 0; i < ptSize; i++)
+    // Adds one point at a time, so that the values are read contiguously
+    for(auto& P : pts)
     {
+        assert(P.size() == ptSize);
+        const double* values = P.data();
+
+        for(size_t i = 0; i < ptSize; i++)
+            sums[i] += values[i];
+    }
+
+    for(size_t i = 0; i < ptSize; i++)
+        sums[i] /= numPts;
+
+    return (newPt);
+}
+
+VectorDouble calculateCenterPoint(const PointBlock& pts)
+{
+    VectorDouble newPt(pts.numberOfVariables, 0.0);
+
+    if(pts.numberOfPoints == 0)
+        return (newPt);
 
-        for(int j = 0; j < numPts; j++)
+    for(int i = 0; i < pts.numberOfVariables; i++)
+    {
+        const double* values = pts.getVariableValues(i);
+
+        double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+        int p = 0;
+
+        for(; p + 4 <= pts.numberOfPoints; p += 4)
         {
-            newPt.at(i) += pts.at(j).at(i);
+            for(int k = 0; k < 4; k++)
+                sums[k] += values[p + k];
         }
 
-        newPt.at(i) = newPt.at(i) / numPts;
+        for(; p < pts.numberOfPoints; p++)
+            sums[0] += values[p];
+
+        newPt[i] = ((sums[0] + sums[1]) + (sums[2] + sums[3])) / pts.numberOfPoints;
     }
 
     return (newPt);
@@ -346,9 +461,28 @@ bool isDifferent(const VectorDouble& firstPt, const VectorDouble& secondPt)
 {
     assert(firstPt.size() == secondPt.size());
 
-    for(size_t i = 0; i < firstPt.size(); i++)
+    auto length = firstPt.size();
+    const double* a = firstPt.data();
+    const double* b = secondPt.data();
+
+    // The comparisons in a chunk are combined without branches, so only one exit test is needed per chunk
+    constexpr size_t chunkSize = 8;
+    size_t i = 0;
+
+    for(; i + chunkSize <= length; i += chunkSize)
+    {
+        bool isChunkDifferent = false;
+
+        for(size_t k = 0; k < chunkSize; k++)
+            isChunkDifferent |= (a[i + k] != b[i + k]);
+
+        if(isChunkDifferent)
+            return (true);
+    }
+
+    for(; i < length; i++)
     {
-        if(firstPt.at(i) != secondPt.at(i))
+        if(a[i] != b[i])
             return (true);
     }
 
@@ -500,32 +634,71 @@ VectorString getLinesInFile(const std::string& fileName)
     return (lines);
 }
 
-auto randomNumberBetween = [](double low, double high) {
-    auto randomFunc = [distribution_ = std::uniform_real_distribution<double>(low, high),
-                          random_engine_ = std::mt19937 { std::random_device {}() }]() mutable {
-        return distribution_(random_engine_);
-    };
-    return randomFunc;
-};
+// The finalizer of the SplitMix64 generator, used for mixing the bits of the coordinates into the fingerprint
+inline uint64_t mixHashBits(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15ULL;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111ebULL;
+    return (value ^ (value >> 31));
+}
+
+inline uint64_t getQuantizedBits(double value, double quantum)
+{
+    double quantized = std::round(value / quantum);
+
+    // Makes sure that both signs of zero give the same fingerprint
+    if(quantized == 0.0)
+        quantized = 0.0;
+
+    uint64_t bits;
+    std::memcpy(&bits, &quantized, sizeof(bits));
+
+    return (bits);
+}
+
+constexpr uint64_t hashSeed = 0xcbf29ce484222325ULL;
+
+template <typename T> uint64_t calculateHash(std::vector<T> const& point, double quantum)
+{
+    uint64_t hash = hashSeed;
+
+    for(auto& V : point)
+        hash = mixHashBits(hash ^ getQuantizedBits((double)V, quantum));
+
+    return (hash);
+}
+
+template uint64_t calculateHash(VectorDouble const& point, double quantum);
+template uint64_t calculateHash(VectorInteger const& point, double quantum);
 
-VectorDouble hashComparisonVector;
+uint64_t calculateHash(const VectorDouble& point, const VectorInteger& variableIndexes, double quantum)
+{
+    uint64_t hash = hashSeed;
+
+    for(auto I : variableIndexes)
+        hash = mixHashBits(hash ^ getQuantizedBits(point[I], quantum));
 
-template double calculateHash(VectorDouble const& point);
-template double calculateHash(VectorInteger const& point);
+    return (hash);
+}
 
-template <typename T> double calculateHash(std::vector<T> const& point)
+uint64_t calculateExactHash(const VectorDouble& values)
 {
-    auto length = point.size();
+    uint64_t hash = hashSeed;
 
-    if(hashComparisonVector.size() < length)
+    for(auto V : values)
     {
-        std::generate_n(std::back_inserter(hashComparisonVector), length - hashComparisonVector.size(),
-            randomNumberBetween(1.0, 101.0));
-    }
+        // Makes sure that both signs of zero give the same fingerprint
+        if(V == 0.0)
+            V = 0.0;
+
+        uint64_t bits;
+        std::memcpy(&bits, &V, sizeof(bits));
 
-    double scalarProduct = std::inner_product(point.begin(), point.end(), hashComparisonVector.begin(), 0.0);
+        hash = mixHashBits(hash ^ bits);
+    }
 
-    return (scalarProduct);
+    return (hash);
 }
 
 bool isAlmostEqual(double x, double y, const double epsilon) { return std::abs(x - y) <= epsilon * std::abs(x); }
@@ -784,4 +957,47 @@ std::string createTemporaryDirectory(std::string filePrefix, std::string folder)
     return (path.string());
 }
 
-} // namespace SHOT::Utilities
\ No newline at end of file
+size_t getResidentMemory()
+{
+#if defined(__linux__)
+    // The second value is the number of resident pages
+    std::ifstream file("/proc/self/statm");
+    size_t totalPages = 0, residentPages = 0;
+
+    if(!(file >> totalPages >> residentPages))
+        return (0);
+
+    return (residentPages * (size_t)sysconf(_SC_PAGESIZE));
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+
+    if(task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS)
+        return (0);
+
+    return ((size_t)info.resident_size);
+#else
+    return (0);
+#endif
+}
+
+size_t getPeakResidentMemory()
+{
+#if defined(__linux__) || defined(__APPLE__)
+    struct rusage usage;
+
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+        return (0);
+
+#ifdef __APPLE__
+    return ((size_t)usage.ru_maxrss);
+#else
+    // In kilobytes on Linux
+    return ((size_t)usage.ru_maxrss * 1024);
+#endif
+#else
+    return (0);
+#endif
+}
+
+} // namespace SHOT::Utilities
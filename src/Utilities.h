@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -38,6 +39,9 @@ using VectorInteger = std::vector<int>;
 void saveVariablePointVectorToFile(
     const VectorDouble& point, const VectorString& variables, const std::string& fileName);
 
+// The variable names and values as written by saveVariablePointVectorToFile()
+std::string getVariablePointVectorString(const VectorDouble& point, const VectorString& variables);
+
 void displayVector(const VectorDouble& point);
 void displayVector(const VectorDouble& point1, const VectorDouble& point2);
 void displayVector(const VectorDouble& point1, const VectorDouble& point2, const VectorDouble& point3);
@@ -52,10 +56,17 @@ void displayVector(const std::vector<VectorString>& points);
 
 void displayDifferencesInVector(const VectorDouble& point1, const VectorDouble& point2, double tol);
 
+// The loops are written without bounds checks and with independent accumulators, so that they are vectorized
 double L2Norm(const VectorDouble& ptA, const VectorDouble& ptB);
+double L2Norm(const VectorDouble& pt);
+double L2NormSquared(const VectorDouble& ptA, const VectorDouble& ptB);
 VectorDouble L2Norms(const std::vector<VectorDouble>& ptsA, const VectorDouble& ptB);
 VectorDouble calculateCenterPoint(const std::vector<VectorDouble>& pts);
 
+// As above but for points in a block, where the values of each variable are contiguous
+VectorDouble L2Norms(const PointBlock& ptsA, const VectorDouble& ptB);
+VectorDouble calculateCenterPoint(const PointBlock& pts);
+
 int numDifferentRoundedSelectedElements(
     const VectorDouble& firstPt, const VectorDouble& secondPt, const VectorInteger& indexes);
 bool isDifferentRoundedSelectedElements(
@@ -107,7 +118,16 @@ template <typename K, typename V> inline void erase_if(std::map<K, V>& mapOfElem
     }
 }
 
-template <typename T> double calculateHash(std::vector<T> const& point);
+// Returns a 64-bit fingerprint of the point, where each coordinate is first rounded to a multiple of quantum, so that
+// points that are equal after rounding get the same fingerprint. No state is shared between calls, so it is safe to
+// use from several threads.
+template <typename T> uint64_t calculateHash(std::vector<T> const& point, double quantum = 1e-8);
+
+// Same as above, but only the coordinates in variableIndexes are used, e.g. to fingerprint the discrete variables only
+uint64_t calculateHash(const VectorDouble& point, const VectorInteger& variableIndexes, double quantum = 1e-8);
+
+// Same as above, but without rounding, so that any change of a value changes the fingerprint
+uint64_t calculateExactHash(const VectorDouble& values);
 
 bool isAlmostEqual(double x, double y, const double epsilon);
 
@@ -134,6 +154,10 @@ E_Monotonicity combineMonotonicity(const E_Monotonicity first, const E_Monotonic
 
 std::vector<std::string> splitStringByCharacter(const std::string& source, char character);
 
+// The current and peak resident memory of the process in bytes, or 0 if it is not available on the platform
+size_t getResidentMemory();
+size_t getPeakResidentMemory();
+
 // Creates a unique directory in the specified folder (or system temporary folder if folder is an empty string).
 // Returns an empty string if the directory could not be created.
 std::string createTemporaryDirectory(std::string filePrefix, std::string folder = "");
@@ -0,0 +1,458 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "WarmStart.h"
+
+#include "CutStore.h"
+#include "DualSolver.h"
+#include "Output.h"
+#include "PrimalSolver.h"
+#include "Results.h"
+
+#include "Model/Constraints.h"
+#include "Model/ObjectiveFunction.h"
+#include "Model/Problem.h"
+
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+
+namespace SHOT
+{
+
+namespace
+{
+
+constexpr const char* warmStartHeader = "SHOTWARMSTART";
+constexpr int warmStartVersion = 2;
+
+// The counters that are accumulated over a resumed run
+constexpr int SolutionStatistics::*checkpointStatistics[] = { &SolutionStatistics::numberOfProblemsLP,
+    &SolutionStatistics::numberOfProblemsQP, &SolutionStatistics::numberOfProblemsQCQP,
+    &SolutionStatistics::numberOfProblemsFeasibleMILP, &SolutionStatistics::numberOfProblemsOptimalMILP,
+    &SolutionStatistics::numberOfProblemsFeasibleMIQP, &SolutionStatistics::numberOfProblemsOptimalMIQP,
+    &SolutionStatistics::numberOfProblemsFeasibleMIQCQP, &SolutionStatistics::numberOfProblemsOptimalMIQCQP,
+    &SolutionStatistics::numberOfProblemsFixedNLP, &SolutionStatistics::numberOfFunctionEvalutions,
+    &SolutionStatistics::numberOfGradientEvaluations };
+
+template <typename T> void writePoint(std::ostream& stream, const std::vector<T>& point)
+{
+    fmt::memory_buffer buffer;
+
+    fmt::format_to(std::back_inserter(buffer), "{}", point.size());
+
+    // The shortest representation that is read back to the same value
+    for(auto& V : point)
+        fmt::format_to(std::back_inserter(buffer), " {}", V);
+
+    buffer.push_back('\n');
+    stream.write(buffer.data(), buffer.size());
+}
+
+template <typename T> bool readPoint(std::istream& stream, std::vector<T>& point)
+{
+    size_t size;
+
+    if(!(stream >> size))
+        return (false);
+
+    point.resize(size);
+
+    for(auto& V : point)
+    {
+        if(!(stream >> V))
+            return (false);
+    }
+
+    return (true);
+}
+
+} // namespace
+
+WarmStart::WarmStart(EnvironmentPtr envPtr) : env(envPtr) { }
+
+void WarmStart::collect(bool isCheckpoint)
+{
+    cuts.clear();
+    interiorPoints.clear();
+    primalSolutions.clear();
+    integerCuts.clear();
+    variableLowerBounds.clear();
+    variableUpperBounds.clear();
+    dualBound = NAN;
+    statistics.clear();
+
+    this->isCheckpoint = isCheckpoint;
+
+    if(!env->reformulatedProblem)
+        return;
+
+    numberOfVariables = env->reformulatedProblem->properties.numberOfVariables;
+    numberOfConstraints = env->reformulatedProblem->properties.numberOfNumericConstraints;
+
+    if(env->dualSolver)
+    {
+        for(auto& HP : env->dualSolver->generatedHyperplanes)
+        {
+            if(HP.isRemoved || !HP.generatedPoint || (int)HP.generatedPoint->size() != numberOfVariables)
+                continue;
+
+            bool isObjectiveCut = (HP.source == E_HyperplaneSource::ObjectiveRootsearch
+                || HP.source == E_HyperplaneSource::ObjectiveCuttingPlane);
+
+            cuts.push_back(
+                { isObjectiveCut ? -1 : HP.sourceConstraintIndex, HP.source, HP.generatedPoint->getValues() });
+        }
+
+        for(auto& IP : env->dualSolver->interiorPts)
+            interiorPoints.push_back(IP->point);
+
+        if(isCheckpoint)
+        {
+            integerCuts = env->dualSolver->generatedIntegerCuts;
+            integerCuts.insert(integerCuts.end(), env->dualSolver->integerCutWaitingList.begin(),
+                env->dualSolver->integerCutWaitingList.end());
+        }
+    }
+
+    for(auto& S : env->results->getPrimalSolutions())
+        primalSolutions.push_back(S.point);
+
+    if(isCheckpoint)
+    {
+        variableLowerBounds = env->reformulatedProblem->getVariableLowerBounds();
+        variableUpperBounds = env->reformulatedProblem->getVariableUpperBounds();
+
+        if(env->results->solutionIsGlobal)
+            dualBound = env->results->getGlobalDualBound();
+
+        for(auto& S : checkpointStatistics)
+            statistics.push_back(env->solutionStatistics.*S);
+    }
+
+    env->output->outputDebug(" Warm start with {} cuts, {} interior points and {} primal solutions collected.",
+        cuts.size(), interiorPoints.size(), primalSolutions.size());
+}
+
+void WarmStart::apply()
+{
+    auto& reformulatedProblem = env->reformulatedProblem;
+
+    bool isSameProblem = (reformulatedProblem->properties.numberOfVariables == numberOfVariables
+        && reformulatedProblem->properties.numberOfNumericConstraints == numberOfConstraints);
+
+    int numberOfAppliedCuts = 0;
+
+    if(!isSameProblem)
+    {
+        env->output->outputDebug(
+            " Warm start cuts and interior points not used since the reformulated problem has changed.");
+    }
+    else
+    {
+        for(auto& C : cuts)
+        {
+            Hyperplane hyperplane;
+            hyperplane.generatedPoint = C.point;
+            hyperplane.source = C.source;
+            hyperplane.isSourceConvex = true;
+
+            // The cuts are only valid for convex functions, since they are recreated from the current functions
+            if(C.sourceConstraintIndex == -1)
+            {
+                if(reformulatedProblem->objectiveFunction->properties.convexity > E_Convexity::Convex)
+                    continue;
+
+                hyperplane.isObjectiveHyperplane = true;
+                hyperplane.sourceConstraintIndex = -1;
+                hyperplane.objectiveFunctionValue = reformulatedProblem->objectiveFunction->calculateValue(C.point);
+            }
+            else
+            {
+                if(C.sourceConstraintIndex < 0 || C.sourceConstraintIndex >= numberOfConstraints)
+                    continue;
+
+                auto constraint = std::dynamic_pointer_cast<NumericConstraint>(
+                    reformulatedProblem->getConstraint(C.sourceConstraintIndex));
+
+                if(!constraint || constraint->properties.convexity > E_Convexity::Convex)
+                    continue;
+
+                hyperplane.sourceConstraintIndex = C.sourceConstraintIndex;
+                hyperplane.sourceConstraint = constraint;
+            }
+
+            env->dualSolver->addHyperplane(hyperplane);
+            numberOfAppliedCuts++;
+        }
+
+        // The interior points are checked before they are used
+        for(auto& P : interiorPoints)
+        {
+            auto interiorPoint = std::make_shared<InteriorPoint>();
+            interiorPoint->point = P;
+            env->dualSolver->interiorPointCandidates.push_back(interiorPoint);
+        }
+    }
+
+    if(isCheckpoint && isSameProblem)
+        applyCheckpoint();
+
+    int numberOfAppliedSolutions = 0;
+
+    for(auto& P : primalSolutions)
+    {
+        if((int)P.size() != env->problem->properties.numberOfVariables)
+            continue;
+
+        env->primalSolver->addPrimalSolutionCandidate(P, E_PrimalSolutionSource::WarmStart, 0);
+        numberOfAppliedSolutions++;
+    }
+
+    env->output->outputInfo(fmt::format(" Warm start with {} cuts, {} interior point candidates and {} primal "
+                                        "solution candidates applied.",
+        numberOfAppliedCuts, isSameProblem ? interiorPoints.size() : 0, numberOfAppliedSolutions));
+}
+
+void WarmStart::applyCheckpoint()
+{
+    auto& reformulatedProblem = env->reformulatedProblem;
+
+    // The bounds are only tightened, since the bounds of the problem may have been tightened further in the new run
+    int numberOfTightenedBounds = 0;
+
+    for(int i = 0; i < numberOfVariables && i < (int)variableLowerBounds.size() && i < (int)variableUpperBounds.size();
+        i++)
+    {
+        auto& variable = reformulatedProblem->allVariables[i];
+
+        double lowerBound = std::max(variable->lowerBound, variableLowerBounds[i]);
+        double upperBound = std::min(variable->upperBound, variableUpperBounds[i]);
+
+        if(lowerBound > upperBound)
+            continue;
+
+        if(lowerBound != variable->lowerBound || upperBound != variable->upperBound)
+        {
+            reformulatedProblem->setVariableBounds(i, lowerBound, upperBound);
+            numberOfTightenedBounds++;
+        }
+    }
+
+    // The cuts are added to the dual problem in the first iteration
+    for(auto& IC : integerCuts)
+        env->dualSolver->addIntegerCut(IC);
+
+    if(!std::isnan(dualBound) && env->results->solutionIsGlobal)
+        env->results->setDualBound(dualBound);
+
+    for(size_t i = 0; i < statistics.size() && i < std::size(checkpointStatistics); i++)
+        env->solutionStatistics.*checkpointStatistics[i] += statistics[i];
+
+    env->output->outputInfo(
+        fmt::format(" Resumed from checkpoint with {} integer cuts and {} tightened variable bounds.",
+            integerCuts.size(), numberOfTightenedBounds));
+}
+
+bool WarmStart::write(const std::string& filename) const
+{
+    std::ofstream file(filename, std::ios::binary);
+
+    if(!file)
+    {
+        env->output->outputError(fmt::format(" Could not write warm start to file {}.", filename));
+        return (false);
+    }
+
+    file << warmStartHeader << ' ' << warmStartVersion << '\n';
+    file << numberOfVariables << ' ' << numberOfConstraints << '\n';
+
+    file << cuts.size() << '\n';
+
+    for(auto& C : cuts)
+    {
+        file << C.sourceConstraintIndex << ' ' << static_cast<int>(C.source) << ' ';
+        writePoint(file, C.point);
+    }
+
+    file << interiorPoints.size() << '\n';
+
+    for(auto& P : interiorPoints)
+        writePoint(file, P);
+
+    file << primalSolutions.size() << '\n';
+
+    for(auto& P : primalSolutions)
+        writePoint(file, P);
+
+    file << (isCheckpoint ? 1 : 0) << '\n';
+
+    if(isCheckpoint)
+    {
+        file << integerCuts.size() << '\n';
+
+        for(auto& IC : integerCuts)
+        {
+            file << static_cast<int>(IC.source) << ' ';
+            writePoint(file, IC.variableIndexes);
+            writePoint(file, IC.variableValues);
+        }
+
+        writePoint(file, variableLowerBounds);
+        writePoint(file, variableUpperBounds);
+
+        // The bound is NAN if not valid, which cannot be read back
+        file << (std::isnan(dualBound) ? 0 : 1) << ' ' << fmt::format("{}", std::isnan(dualBound) ? 0.0 : dualBound)
+             << '\n';
+
+        writePoint(file, statistics);
+    }
+
+    return (file.good());
+}
+
+bool WarmStart::read(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+
+    if(!file)
+    {
+        env->output->outputError(fmt::format(" Could not open warm start {}.", filename));
+        return (false);
+    }
+
+    std::string header;
+    int version;
+
+    if(file >> header >> version && header == CutStore::header && version == CutStore::version)
+        return (readCutStore(file, filename));
+
+    // Version 1 is the same as version 2 without the checkpoint
+    if(!file || header != warmStartHeader || version < 1 || version > warmStartVersion)
+    {
+        env->output->outputError(fmt::format(" The file {} is not a warm start of a supported version.", filename));
+        return (false);
+    }
+
+    cuts.clear();
+    interiorPoints.clear();
+    primalSolutions.clear();
+    integerCuts.clear();
+    variableLowerBounds.clear();
+    variableUpperBounds.clear();
+    dualBound = NAN;
+    statistics.clear();
+    isCheckpoint = false;
+
+    size_t size;
+    bool isValid = (bool)(file >> numberOfVariables >> numberOfConstraints >> size);
+
+    for(size_t i = 0; isValid && i < size; i++)
+    {
+        Cut cut;
+        int source;
+
+        isValid = (file >> cut.sourceConstraintIndex >> source) && readPoint(file, cut.point);
+        cut.source = static_cast<E_HyperplaneSource>(source);
+
+        cuts.push_back(std::move(cut));
+    }
+
+    for(auto* points : { &interiorPoints, &primalSolutions })
+    {
+        isValid = isValid && (file >> size);
+
+        for(size_t i = 0; isValid && i < size; i++)
+        {
+            VectorDouble point;
+            isValid = readPoint(file, point);
+            points->push_back(std::move(point));
+        }
+    }
+
+    int checkpoint = 0;
+
+    if(isValid && version >= 2)
+        isValid = (bool)(file >> checkpoint);
+
+    isCheckpoint = (checkpoint == 1);
+
+    if(isValid && isCheckpoint)
+    {
+        isValid = (bool)(file >> size);
+
+        for(size_t i = 0; isValid && i < size; i++)
+        {
+            IntegerCut integerCut;
+            int source;
+
+            isValid = (file >> source) && readPoint(file, integerCut.variableIndexes)
+                && readPoint(file, integerCut.variableValues);
+            integerCut.source = static_cast<E_IntegerCutSource>(source);
+
+            integerCuts.push_back(std::move(integerCut));
+        }
+
+        int hasDualBound = 0;
+        double bound = 0.0;
+
+        isValid = isValid && readPoint(file, variableLowerBounds) && readPoint(file, variableUpperBounds)
+            && (file >> hasDualBound >> bound) && readPoint(file, statistics);
+
+        if(hasDualBound == 1)
+            dualBound = bound;
+    }
+
+    if(!isValid)
+    {
+        env->output->outputError(fmt::format(" Error when reading warm start {}.", filename));
+        return (false);
+    }
+
+    return (true);
+}
+
+bool WarmStart::readCutStore(std::istream& file, const std::string& filename)
+{
+    cuts.clear();
+    interiorPoints.clear();
+    primalSolutions.clear();
+    isCheckpoint = false;
+
+    if(!(file >> numberOfVariables >> numberOfConstraints))
+    {
+        env->output->outputError(fmt::format(" Error when reading cut store {}.", filename));
+        return (false);
+    }
+
+    // The last record is incomplete if the run was stopped while it was written
+    while(true)
+    {
+        Cut cut;
+        int source;
+
+        if(!(file >> cut.sourceConstraintIndex >> source) || !readPoint(file, cut.point)
+            || (int)cut.point.size() != numberOfVariables)
+            break;
+
+        cut.source = static_cast<E_HyperplaneSource>(source);
+        cuts.push_back(std::move(cut));
+    }
+
+    env->output->outputDebug(" Read {} cuts from cut store {}.", cuts.size(), filename);
+
+    return (true);
+}
+
+} // namespace SHOT
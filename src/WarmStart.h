@@ -0,0 +1,87 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#pragma once
+
+#include "Enums.h"
+#include "Environment.h"
+#include "Structs.h"
+
+#include <cmath>
+#include <istream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace SHOT
+{
+
+// The cuts, interior points and primal solutions from the solution of a problem, used to warm start a later solution
+// of the same problem, e.g. after its data has been updated. The cuts are stored as the points they were generated
+// in, and are recreated from the current constraints when applied, so that the cuts for convex constraints remain
+// valid also if the bounds of the constraints have changed. The cut and interior points are in the space of the
+// reformulated problem, and are only used if it has the same number of variables and constraints. The interior points
+// and primal solutions are checked before they are used. A checkpoint also contains the integer cuts, the tightened
+// variable bounds, the bounds on the objective and some statistics, so that a stopped run can be resumed.
+class WarmStart
+{
+public:
+    WarmStart(EnvironmentPtr envPtr);
+
+    // Collects the cuts, interior points and primal solutions after the problem has been solved, the cuts are only
+    // available if HyperplaneCuts.SaveHyperplanePoints or HyperplaneCuts.ReuseOnResolve is true. A checkpoint can be
+    // collected while the problem is solved, and is applied to the same problem only.
+    void collect(bool isCheckpoint = false);
+
+    // Adds the cuts, interior points and primal solutions to the dual and primal solvers before the problem is solved
+    void apply();
+
+    bool write(const std::string& filename) const;
+
+    // Also reads the cuts from a file written by a CutStore, e.g. to resume a stopped run
+    bool read(const std::string& filename);
+
+    struct Cut
+    {
+        int sourceConstraintIndex; // -1 if objective function
+        E_HyperplaneSource source;
+        VectorDouble point;
+    };
+
+    std::vector<Cut> cuts;
+    std::vector<VectorDouble> interiorPoints;
+    std::vector<VectorDouble> primalSolutions;
+
+    bool isCheckpoint = false;
+
+    // Only used if a checkpoint
+    std::vector<IntegerCut> integerCuts;
+    VectorDouble variableLowerBounds;
+    VectorDouble variableUpperBounds;
+    double dualBound = NAN; // NAN if not a valid global bound
+    std::vector<int> statistics; // The counters in checkpointStatistics in WarmStart.cpp
+
+    // The size of the reformulated problem the cuts and interior points were generated for
+    int numberOfVariables = 0;
+    int numberOfConstraints = 0;
+
+    static constexpr const char* fileExtension = ".shotwarm";
+
+private:
+    EnvironmentPtr env;
+
+    void applyCheckpoint();
+
+    bool readCutStore(std::istream& file, const std::string& filename);
+};
+
+using WarmStartPtr = std::shared_ptr<WarmStart>;
+
+} // namespace SHOT
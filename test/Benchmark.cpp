@@ -0,0 +1,315 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+// Benchmark harness that solves a set of instances with fixed settings a number of times, and writes the solution
+// times, iterations and timings of the solver phases to CSV and JSON files. The median wall times can be compared
+// against a CSV file from an earlier run to detect performance regressions.
+
+#include "BenchmarkHarness.h"
+
+#include "../src/Utilities.h"
+
+#include "argh.h"
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace SHOT;
+
+// Returns the median wall time of the solved runs of each instance
+std::map<std::string, double> getMedianWallTimes(const std::vector<BenchmarkRun>& runs)
+{
+    std::map<std::string, std::vector<double>> wallTimes;
+
+    for(auto& R : runs)
+    {
+        if(R.isSolved)
+            wallTimes[R.instance].push_back(R.wallTime);
+    }
+
+    std::map<std::string, double> medians;
+
+    for(auto& W : wallTimes)
+        medians[W.first] = getMedian(W.second);
+
+    return (medians);
+}
+
+bool writeCSV(const std::string& filename, const std::vector<BenchmarkRun>& runs)
+{
+    std::set<std::string> phases;
+
+    for(auto& R : runs)
+    {
+        for(auto& P : R.phaseTimes)
+            phases.insert(P.first);
+    }
+
+    std::stringstream output;
+    output << "instance,repetition,solved,wall_time,time_to_first_primal,time_to_gap,iterations,primal_bound,"
+              "dual_bound,termination";
+
+    for(auto& P : phases)
+        output << ",time_" << P;
+
+    output << '\n';
+
+    for(auto& R : runs)
+    {
+        output << fmt::format("{},{},{},{},{},{},{},{},{},{}", R.instance, R.repetition, R.isSolved ? 1 : 0,
+            R.wallTime, R.timeToFirstPrimal, R.timeToGap, R.iterations, R.primalBound, R.dualBound,
+            R.terminationReason);
+
+        for(auto& P : phases)
+        {
+            auto phase = R.phaseTimes.find(P);
+            output << ',' << (phase != R.phaseTimes.end() ? phase->second : 0.0);
+        }
+
+        output << '\n';
+    }
+
+    return (Utilities::writeStringToFile(filename, output.str()));
+}
+
+bool writeJSON(const std::string& filename, const std::vector<BenchmarkRun>& runs)
+{
+    std::stringstream output;
+    output << "{\n  \"runs\": [";
+
+    for(size_t i = 0; i < runs.size(); i++)
+    {
+        auto& R = runs[i];
+
+        output << (i > 0 ? "," : "") << "\n    {";
+        output << fmt::format("\"instance\": \"{}\", \"repetition\": {}, \"solved\": {}, \"wall_time\": {}, "
+                              "\"time_to_first_primal\": {}, \"time_to_gap\": {}, \"iterations\": {}, ",
+            R.instance, R.repetition, R.isSolved ? "true" : "false", R.wallTime, R.timeToFirstPrimal, R.timeToGap,
+            R.iterations);
+
+        // The bounds are infinite if no solution has been found, which cannot be represented in JSON
+        output << fmt::format("\"primal_bound\": {}, \"dual_bound\": {}, \"termination\": \"{}\", \"phases\": {{",
+            std::abs(R.primalBound) < SHOT_DBL_MAX ? fmt::format("{}", R.primalBound) : "null",
+            std::abs(R.dualBound) < SHOT_DBL_MAX ? fmt::format("{}", R.dualBound) : "null", R.terminationReason);
+
+        bool isFirst = true;
+
+        for(auto& P : R.phaseTimes)
+        {
+            output << fmt::format("{}\"{}\": {}", isFirst ? "" : ", ", P.first, P.second);
+            isFirst = false;
+        }
+
+        output << "}}";
+    }
+
+    output << "\n  ]\n}\n";
+
+    return (Utilities::writeStringToFile(filename, output.str()));
+}
+
+// Reads the wall times from a CSV file written by this program
+std::vector<BenchmarkRun> readBaseline(const std::string& filename)
+{
+    std::vector<BenchmarkRun> runs;
+    std::ifstream file(filename);
+    std::string line;
+
+    if(!file || !std::getline(file, line)) // The header
+        return (runs);
+
+    while(std::getline(file, line))
+    {
+        std::vector<std::string> fields;
+        std::stringstream stream(line);
+        std::string field;
+
+        while(std::getline(stream, field, ','))
+            fields.push_back(field);
+
+        if(fields.size() < 4)
+            continue;
+
+        BenchmarkRun run;
+        run.instance = fields[0];
+        run.isSolved = (fields[2] == "1");
+        run.wallTime = std::stod(fields[3]);
+        runs.push_back(run);
+    }
+
+    return (runs);
+}
+
+// Returns the number of instances that are slower than in the baseline by more than the tolerance
+int compareToBaseline(const std::vector<BenchmarkRun>& runs, const std::vector<BenchmarkRun>& baselineRuns,
+    double tolerance, double minTime)
+{
+    auto current = getMedianWallTimes(runs);
+    auto baseline = getMedianWallTimes(baselineRuns);
+
+    int numberOfRegressions = 0;
+
+    std::cout << std::endl
+              << fmt::format("{:<32}{:>14}{:>14}{:>10}", "Instance", "Baseline (s)", "Current (s)", "Ratio")
+              << std::endl;
+
+    for(auto& C : current)
+    {
+        auto base = baseline.find(C.first);
+
+        if(base == baseline.end())
+        {
+            std::cout << fmt::format("{:<32}{:>14}{:>14.3f}", C.first, "-", C.second) << std::endl;
+            continue;
+        }
+
+        double ratio = C.second / std::max(base->second, 1e-9);
+
+        // Very short solution times are not considered, since they mostly measure noise
+        bool isRegression = ratio > 1.0 + tolerance && C.second - base->second > minTime;
+
+        if(isRegression)
+            numberOfRegressions++;
+
+        std::cout << fmt::format("{:<32}{:>14.3f}{:>14.3f}{:>10.2f}{}", C.first, base->second, C.second, ratio,
+                         isRegression ? "  REGRESSION" : "")
+                  << std::endl;
+    }
+
+    for(auto& B : baseline)
+    {
+        if(current.find(B.first) == current.end())
+            std::cout << fmt::format("{:<32}{:>14.3f}{:>14}  not solved", B.first, B.second, "-") << std::endl;
+    }
+
+    return (numberOfRegressions);
+}
+
+int main(int argc, char* argv[])
+{
+    argh::parser cmdl;
+    cmdl.add_params({ "--instances", "--dir", "--opt", "--repetitions", "--csv", "--json" });
+    cmdl.add_params({ "--baseline", "--tolerance", "--mintime", "--gap" });
+    cmdl.parse(argc, argv);
+
+    if(cmdl["--help"])
+    {
+        std::cout << "Usage: shot_bench [INSTANCES] [OPTIONS] [OPTIONNAME=VALUE ...]" << std::endl
+                  << std::endl
+                  << "  --instances FILE     File with one instance per line" << std::endl
+                  << "  --dir DIRECTORY      Use the OSiL files in DIRECTORY (default: data)" << std::endl
+                  << "  --opt FILE           Reads in the SHOT options from FILE in GAMS format" << std::endl
+                  << "  --repetitions N      Number of times each instance is solved (default: 1)" << std::endl
+                  << "  --csv FILE           Writes the results to FILE (default: benchmark.csv)" << std::endl
+                  << "  --json FILE          Writes the results to FILE (default: benchmark.json)" << std::endl
+                  << "  --gap VALUE          Relative gap used for the time-to-gap (default: 0.01)" << std::endl
+                  << "  --baseline FILE      Compares the median wall times with a CSV file from an earlier run"
+                  << std::endl
+                  << "  --tolerance VALUE    Relative slowdown reported as a regression (default: 0.1)" << std::endl
+                  << "  --mintime VALUE      Slowdowns less than this (s) are not regressions (default: 0.1)"
+                  << std::endl;
+
+        return (0);
+    }
+
+    std::vector<std::string> instances;
+    std::vector<std::string> options;
+
+    for(size_t i = 1; i < cmdl.pos_args().size(); i++)
+    {
+        auto& arg = cmdl.pos_args()[i];
+
+        if(arg.find('=') != std::string::npos)
+            options.push_back(arg);
+        else
+            instances.push_back(arg);
+    }
+
+    if(cmdl("--instances"))
+    {
+        auto listed = readInstanceList(cmdl("--instances").str());
+        instances.insert(instances.end(), listed.begin(), listed.end());
+    }
+
+    if(instances.size() == 0)
+        instances = findInstances(cmdl("--dir", "data").str(), { ".osil", ".xml" });
+
+    if(instances.size() == 0)
+    {
+        std::cout << "No instances to benchmark." << std::endl;
+        return (1);
+    }
+
+    int repetitions = 1;
+    double gapTarget = 0.01;
+    double tolerance = 0.1;
+    double minTime = 0.1;
+
+    cmdl("--repetitions", 1) >> repetitions;
+    cmdl("--gap", 0.01) >> gapTarget;
+    cmdl("--tolerance", 0.1) >> tolerance;
+    cmdl("--mintime", 0.1) >> minTime;
+
+    std::string optionsFile = cmdl("--opt", "").str();
+
+    std::vector<BenchmarkRun> runs;
+
+    for(auto& I : instances)
+    {
+        for(int r = 0; r < std::max(1, repetitions); r++)
+        {
+            auto run = runInstance(I, r + 1, optionsFile, options, gapTarget);
+
+            std::cout << fmt::format("{:<32} run {:>3}: {:>10.3f} s, {:>6} iterations, {}", run.instance,
+                             run.repetition, run.wallTime, run.iterations,
+                             run.isSolved ? run.terminationReason : "failed")
+                      << std::endl;
+
+            runs.push_back(run);
+        }
+    }
+
+    auto csvFile = cmdl("--csv", "benchmark.csv").str();
+    auto jsonFile = cmdl("--json", "benchmark.json").str();
+
+    if(!writeCSV(csvFile, runs))
+        std::cout << "Could not write results to " << csvFile << std::endl;
+
+    if(!writeJSON(jsonFile, runs))
+        std::cout << "Could not write results to " << jsonFile << std::endl;
+
+    if(cmdl("--baseline"))
+    {
+        auto baselineRuns = readBaseline(cmdl("--baseline").str());
+
+        if(baselineRuns.size() == 0)
+        {
+            std::cout << "Could not read baseline " << cmdl("--baseline").str() << std::endl;
+            return (1);
+        }
+
+        int numberOfRegressions = compareToBaseline(runs, baselineRuns, tolerance, minTime);
+
+        if(numberOfRegressions > 0)
+        {
+            std::cout << std::endl << numberOfRegressions << " instances are slower than the baseline." << std::endl;
+            return (1);
+        }
+    }
+
+    return (0);
+}
@@ -0,0 +1,203 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+#include "BenchmarkHarness.h"
+
+#include "../src/Solver.h"
+#include "../src/Environment.h"
+#include "../src/Results.h"
+#include "../src/Settings.h"
+#include "../src/Timing.h"
+
+#ifdef HAS_STD_FILESYSTEM
+#include <filesystem>
+namespace fs = std;
+#endif
+
+#ifdef HAS_STD_EXPERIMENTAL_FILESYSTEM
+#include <experimental/filesystem>
+namespace fs = std::experimental;
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+using namespace SHOT;
+
+std::vector<std::string> readInstanceList(const std::string& filename)
+{
+    std::vector<std::string> instances;
+    std::ifstream file(filename);
+
+    if(!file)
+    {
+        std::cout << "Could not read instance list " << filename << std::endl;
+        return (instances);
+    }
+
+    auto directory = fs::filesystem::path(filename).parent_path();
+    std::string line;
+
+    while(std::getline(file, line))
+    {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+
+        if(line.empty() || line[0] == '#')
+            continue;
+
+        fs::filesystem::path path(line);
+
+        if(path.is_relative() && !fs::filesystem::exists(path))
+            path = directory / path;
+
+        instances.push_back(path.string());
+    }
+
+    return (instances);
+}
+
+std::vector<std::string> findInstances(const std::string& directory, const std::set<std::string>& extensions)
+{
+    std::vector<std::string> instances;
+
+    if(!fs::filesystem::is_directory(directory))
+        return (instances);
+
+    for(auto& entry : fs::filesystem::directory_iterator(directory))
+    {
+        if(extensions.count(entry.path().extension().string()) > 0)
+            instances.push_back(entry.path().string());
+    }
+
+    std::sort(instances.begin(), instances.end());
+
+    return (instances);
+}
+
+std::string getTerminationReasonName(E_TerminationReason reason)
+{
+    switch(reason)
+    {
+    case E_TerminationReason::ConstraintTolerance:
+        return ("ConstraintTolerance");
+    case E_TerminationReason::ObjectiveStagnation:
+        return ("ObjectiveStagnation");
+    case E_TerminationReason::IterationLimit:
+        return ("IterationLimit");
+    case E_TerminationReason::TimeLimit:
+        return ("TimeLimit");
+    case E_TerminationReason::InfeasibleProblem:
+        return ("InfeasibleProblem");
+    case E_TerminationReason::UnboundedProblem:
+        return ("UnboundedProblem");
+    case E_TerminationReason::Error:
+        return ("Error");
+    case E_TerminationReason::AbsoluteGap:
+        return ("AbsoluteGap");
+    case E_TerminationReason::RelativeGap:
+        return ("RelativeGap");
+    case E_TerminationReason::NumericIssues:
+        return ("NumericIssues");
+    case E_TerminationReason::UserAbort:
+        return ("UserAbort");
+    case E_TerminationReason::NoDualCutsAdded:
+        return ("NoDualCutsAdded");
+    default:
+        return ("None");
+    }
+}
+
+BenchmarkRun runInstance(const std::string& instance, int repetition, const std::string& optionsFile,
+    const std::vector<std::string>& options, double gapTarget)
+{
+    BenchmarkRun run;
+    run.instance = fs::filesystem::path(instance).filename().string();
+    run.repetition = repetition;
+
+    auto startTime = std::chrono::steady_clock::now();
+
+    auto solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+
+    if(optionsFile != "" && !solver->setOptionsFromFile(optionsFile))
+    {
+        std::cout << "Could not read options file " << optionsFile << std::endl;
+        return (run);
+    }
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    // The options given as name=value pairs are set in the same way as from the options file
+    if(options.size() > 0)
+    {
+        std::string optionsString;
+
+        for(auto& O : options)
+            optionsString += O + '\n';
+
+        solver->setOptionsFromString(optionsString);
+    }
+
+    auto elapsed = [&]() {
+        return (std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+    };
+
+    auto checkGap = [&]() {
+        if(run.timeToGap < 0 && env->results->getRelativeGlobalObjectiveGap() <= gapTarget)
+            run.timeToGap = elapsed();
+    };
+
+    solver->registerCallback(E_EventType::NewPrimalSolution, [&]() {
+        if(run.timeToFirstPrimal < 0)
+            run.timeToFirstPrimal = elapsed();
+
+        checkGap();
+    });
+
+    solver->registerCallback(E_EventType::UserTerminationCheck, checkGap);
+
+    if(!solver->setProblem(instance))
+    {
+        std::cout << "Could not read instance " << instance << std::endl;
+        return (run);
+    }
+
+    run.isSolved = solver->solveProblem();
+    run.wallTime = elapsed();
+
+    checkGap();
+
+    run.iterations = env->results->getNumberOfIterations();
+    run.primalBound = solver->getPrimalBound();
+    run.dualBound = solver->getCurrentDualBound();
+    run.terminationReason = getTerminationReasonName(solver->getTerminationReason());
+
+    for(auto& T : env->timing->timers)
+    {
+        if(T.elapsed() > 0)
+            run.phaseTimes[T.name] = T.elapsed();
+    }
+
+    return (run);
+}
+
+double getMedian(std::vector<double> values)
+{
+    if(values.size() == 0)
+        return (0.0);
+
+    std::sort(values.begin(), values.end());
+    size_t middle = values.size() / 2;
+
+    return (values.size() % 2 == 1 ? values[middle] : 0.5 * (values[middle - 1] + values[middle]));
+}
@@ -0,0 +1,54 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+// The parts of the benchmark harness that are shared between shot_bench and shot_tune: finding the instances and
+// solving an instance with given settings while measuring the times to the first primal solution and to a gap.
+
+#pragma once
+
+#include "../src/Structs.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+struct BenchmarkRun
+{
+    std::string instance;
+    int repetition = 0;
+    bool isSolved = false;
+
+    double wallTime = 0.0;
+    double timeToFirstPrimal = -1.0; // -1 if no primal solution was found
+    double timeToGap = -1.0; // -1 if the gap was not reached
+
+    int iterations = 0;
+    double primalBound = SHOT::SHOT_DBL_MAX;
+    double dualBound = SHOT::SHOT_DBL_MIN;
+    std::string terminationReason;
+
+    std::map<std::string, double> phaseTimes;
+};
+
+// Reads a list with one instance file per line, empty lines and lines starting with # are ignored. Relative paths
+// are relative to the directory of the list.
+std::vector<std::string> readInstanceList(const std::string& filename);
+
+// The instances in the directory with the given extensions, sorted by name
+std::vector<std::string> findInstances(const std::string& directory, const std::set<std::string>& extensions);
+
+std::string getTerminationReasonName(SHOT::E_TerminationReason reason);
+
+// Solves the instance with the settings in the options file, followed by the options given as name=value pairs
+BenchmarkRun runInstance(const std::string& instance, int repetition, const std::string& optionsFile,
+    const std::vector<std::string>& options, double gapTarget);
+
+double getMedian(std::vector<double> values);
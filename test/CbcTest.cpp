@@ -151,6 +151,52 @@ bool CbcTerminationCallbackTest(std::string filename)
     return (true);
 }
 
+bool CbcSingleTreeTest(std::string filename, double correctObjectiveValue)
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("MIP.Solver", "Dual", static_cast<int>(ES_MIPSolver::Cbc));
+    solver->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::SingleTree));
+
+    std::cout << "Reading problem:  " << filename << '\n';
+
+    if(!solver->setProblem(filename))
+    {
+        std::cout << "Error while reading problem";
+        return (false);
+    }
+
+    if(!solver->solveProblem())
+    {
+        std::cout << "Error while solving problem\n";
+        return (false);
+    }
+
+    if(env->results->usedSolutionStrategy != E_SolutionStrategy::SingleTree)
+    {
+        std::cout << "The single-tree strategy was not used with Cbc\n";
+        return (false);
+    }
+
+    if(solver->getPrimalSolutions().size() == 0)
+    {
+        std::cout << "No primal solution found\n";
+        return (false);
+    }
+
+    std::cout << std::endl << "Objective value: " << solver->getPrimalSolution().objValue << std::endl;
+
+    if(correctObjectiveValue > solver->getPrimalBound() + 1e-5
+        || correctObjectiveValue < solver->getCurrentDualBound() - 1e-5)
+    {
+        std::cout << "Global objective value is not within dual and primal bounds for minimization problem.\n";
+        return (false);
+    }
+
+    return (true);
+}
+
 int CbcTest(int argc, char* argv[])
 {
     int defaultchoice = 1;
@@ -205,6 +251,11 @@ int CbcTest(int argc, char* argv[])
         passed = CbcTest1("data/ncvx_min_ndiv.nl", -13.0);
         std::cout << "Finished test to solve nonconvex maximization problem 'ncvx_min_ndiv.nl'." << std::endl;
         break;
+    case 8:
+        std::cout << "Starting test to solve a MINLP problem with the single-tree strategy in Cbc:" << std::endl;
+        passed = CbcSingleTreeTest("data/tls2.osil", 5.3);
+        std::cout << "Finished test to solve a MINLP problem with the single-tree strategy in Cbc." << std::endl;
+        break;
     default:
         passed = false;
         std::cout << "Test #" << choice << " does not exist!\n";
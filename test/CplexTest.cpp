@@ -11,9 +11,18 @@
 #include "../src/Utilities.h"
 #include "../src/TaskHandler.h"
 
+#include "../src/DualSolver.h"
+#include "../src/MIPSolver/IMIPSolver.h"
+
+#include "../src/Model/Constraints.h"
+#include "../src/Model/NonlinearExpressions.h"
 #include "../src/Model/Problem.h"
 #include "../src/Model/ObjectiveFunction.h"
+#include "../src/Model/Terms.h"
+#include "../src/Model/Variables.h"
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 using namespace SHOT;
@@ -149,6 +158,155 @@ bool CplexTerminationCallbackTest(std::string filename)
     return (true);
 }
 
+// max x + y s.t. 1 <= x - y <= 3, x^2 + y^2 <= 10, exp(x) <= 15, with the optimal solution x = ln(15), y = 1. If the
+// lower bound of the ranged constraint is lost, x = 2.45, y = 2 gives a larger dual bound.
+ProblemPtr createCplexTestProblem(EnvironmentPtr env)
+{
+    auto problem = std::make_shared<SHOT::Problem>(env);
+    problem->name = "rangedconstraint";
+
+    auto x = std::make_shared<Variable>("x", 0, E_VariableType::Real, 0.0, 5.0);
+    auto y = std::make_shared<Variable>("y", 1, E_VariableType::Integer, 0.0, 5.0);
+    problem->add({ x, y });
+
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Maximize);
+    objective->add(std::make_shared<LinearTerm>(1.0, x));
+    objective->add(std::make_shared<LinearTerm>(1.0, y));
+    problem->add(objective);
+
+    auto c0 = std::make_shared<LinearConstraint>(0, "c0", 1.0, 3.0);
+    c0->add(std::make_shared<LinearTerm>(1.0, x));
+    c0->add(std::make_shared<LinearTerm>(-1.0, y));
+    problem->add(c0);
+
+    auto c1 = std::make_shared<QuadraticConstraint>(1, "c1", SHOT_DBL_MIN, 10.0);
+    c1->add(std::make_shared<QuadraticTerm>(1.0, x, x));
+    c1->add(std::make_shared<QuadraticTerm>(1.0, y, y));
+    problem->add(c1);
+
+    auto c2 = std::make_shared<NonlinearConstraint>(2, "c2", SHOT_DBL_MIN, 15.0);
+    c2->add(std::make_shared<ExpressionExp>(std::make_shared<ExpressionVariable>(x)));
+    problem->add(c2);
+
+    problem->updateProperties();
+    problem->finalize();
+
+    return (problem);
+}
+
+bool CplexReinitializeTest()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Error));
+    solver->updateSetting("MIP.Solver", "Dual", static_cast<int>(ES_MIPSolver::Cplex));
+    solver->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::MultiTree));
+    solver->updateSetting("TreeStrategy.Multi.Reinitialize", "Dual", true);
+
+    // The quadratic constraint is given to Cplex, so that it is part of the base problem together with the two rows of
+    // the ranged constraint
+    solver->updateSetting("Reformulation.Quadratics.Strategy", "Model",
+        static_cast<int>(ES_QuadraticProblemStrategy::ConvexQuadraticallyConstrained));
+
+    if(!solver->setProblem(createCplexTestProblem(env)) || !solver->solveProblem())
+    {
+        std::cout << "Error while solving problem\n";
+        return (false);
+    }
+
+    bool passed = true;
+
+    if(env->results->getNumberOfIterations() < 2)
+    {
+        std::cout << "The dual problem was never reinitialized.\n";
+        passed = false;
+    }
+
+    double optimalObjectiveValue = 1.0 + std::log(15.0);
+
+    if(!solver->hasPrimalSolution() || std::abs(solver->getPrimalBound() - optimalObjectiveValue) > 1e-3
+        || solver->getCurrentDualBound() < optimalObjectiveValue - 1e-5
+        || solver->getCurrentDualBound() > optimalObjectiveValue + 1e-2)
+    {
+        std::cout << "The bounds " << solver->getPrimalBound() << " and " << solver->getCurrentDualBound()
+                  << " do not match the optimal objective value " << optimalObjectiveValue << ".\n";
+        passed = false;
+    }
+
+    // All the constraints added during the solution process can still be identified
+    if(!env->dualSolver->MIPSolver->restoreBaseProblem())
+    {
+        std::cout << "The base problem could not be restored after the solution process.\n";
+        passed = false;
+    }
+
+    return (passed);
+}
+
+bool CplexRemoveConstraintsTest()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Error));
+    solver->updateSetting("MIP.Solver", "Dual", static_cast<int>(ES_MIPSolver::Cplex));
+    solver->updateSetting("MIP.UseNames", "Dual", true);
+    solver->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::MultiTree));
+
+    // The quadratic constraint given to Cplex is stored together with the linear constraints, but is not a row
+    solver->updateSetting("Reformulation.Quadratics.Strategy", "Model",
+        static_cast<int>(ES_QuadraticProblemStrategy::ConvexQuadraticallyConstrained));
+
+    if(!solver->setProblem(createCplexTestProblem(env)) || !solver->solveProblem())
+    {
+        std::cout << "Error while solving problem\n";
+        return (false);
+    }
+
+    auto MIPSolver = env->dualSolver->MIPSolver;
+    int numberOfConstraints = MIPSolver->getNumberOfConstraints();
+
+    // The constraints x <= 5, y <= 5 and x + y <= 10, which are added and then the second one removed
+    std::vector<int> indexes;
+    indexes.push_back(MIPSolver->addLinearConstraint({ { 0, 1.0 } }, -5.0, "removaltest0", false, false));
+    indexes.push_back(MIPSolver->addLinearConstraint({ { 1, 1.0 } }, -5.0, "removaltest1", false, false));
+    indexes.push_back(MIPSolver->addLinearConstraint({ { 0, 1.0 }, { 1, 1.0 } }, -10.0, "removaltest2", false, false));
+
+    if(std::any_of(indexes.begin(), indexes.end(), [](int I) { return (I < 0); }))
+    {
+        std::cout << "The constraints could not be added.\n";
+        return (false);
+    }
+
+    if(!MIPSolver->removeLinearConstraints({ indexes[1] }))
+    {
+        std::cout << "The constraint could not be removed.\n";
+        return (false);
+    }
+
+    bool passed = true;
+
+    if(MIPSolver->getNumberOfConstraints() != numberOfConstraints + 2)
+    {
+        std::cout << "There are " << MIPSolver->getNumberOfConstraints() << " constraints instead of "
+                  << numberOfConstraints + 2 << " after the removal.\n";
+        passed = false;
+    }
+
+    MIPSolver->writeProblemToFile("removal.lp");
+    auto problemText = Utilities::getFileAsString("removal.lp");
+
+    if(problemText.find("removaltest0") == std::string::npos || problemText.find("removaltest2") == std::string::npos
+        || problemText.find("removaltest1") != std::string::npos)
+    {
+        std::cout << "Another constraint than the given one was removed.\n";
+        passed = false;
+    }
+
+    return (passed);
+}
+
 int CplexTest(int argc, char* argv[])
 {
 
@@ -204,6 +362,16 @@ int CplexTest(int argc, char* argv[])
         passed = CplexTest1("data/ncvx_min_ndiv.nl", -13.0);
         std::cout << "Finished test to solve nonconvex maximization problem 'ncvx_min_ndiv.nl'." << std::endl;
         break;
+    case 8:
+        std::cout << "Starting test to restore the base problem with a ranged constraint in Cplex:" << std::endl;
+        passed = CplexReinitializeTest();
+        std::cout << "Finished test to restore the base problem with a ranged constraint in Cplex." << std::endl;
+        break;
+    case 9:
+        std::cout << "Starting test to remove a constraint in Cplex:" << std::endl;
+        passed = CplexRemoveConstraintsTest();
+        std::cout << "Finished test to remove a constraint in Cplex." << std::endl;
+        break;
     default:
         passed = false;
         std::cout << "Test #" << choice << " does not exist!\n";
@@ -0,0 +1,689 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+// Generates random MINLP instances of a given family and size for measuring how the solver scales with the model
+// size. The families are separable signomial knapsacks, facility location with quadratic transportation costs and
+// block-structured two-stage scenario models, each in a convex and a nonconvex version. The instances are written as
+// OSiL files that can be solved with shot_bench, or created in memory with ProblemBuilder and solved directly.
+
+#include "../src/Solver.h"
+#include "../src/Environment.h"
+#include "../src/Results.h"
+#include "../src/Settings.h"
+#include "../src/Utilities.h"
+
+#include "../src/Model/Problem.h"
+#include "../src/Model/ProblemBuilder.h"
+
+#include "argh.h"
+#include "spdlog/fmt/fmt.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+using namespace SHOT;
+
+struct GeneratedVariable
+{
+    std::string name;
+    E_VariableType type = E_VariableType::Real;
+    double lowerBound = 0.0;
+    double upperBound = 1.0;
+};
+
+// A sum of coefficient * x[i1]^p1 * x[i2]^p2 * ...
+struct GeneratedSignomialTerm
+{
+    double coefficient = 1.0;
+    std::vector<std::pair<int, double>> elements;
+};
+
+// The objective function is the row with index -1
+struct GeneratedRow
+{
+    std::string name;
+    double lowerBound = SHOT_DBL_MIN;
+    double upperBound = SHOT_DBL_MAX;
+    std::vector<std::pair<int, double>> linearTerms;
+    std::vector<std::tuple<int, int, double>> quadraticTerms;
+    std::vector<GeneratedSignomialTerm> signomialTerms;
+};
+
+struct GeneratedInstance
+{
+    std::string name;
+    std::vector<GeneratedVariable> variables;
+    GeneratedRow objective;
+    std::vector<GeneratedRow> constraints;
+
+    int addVariable(std::string name, E_VariableType type, double lowerBound, double upperBound)
+    {
+        variables.push_back({ std::move(name), type, lowerBound, upperBound });
+        return ((int)variables.size() - 1);
+    }
+
+    size_t getNumberOfNonzeros() const
+    {
+        size_t numberOfNonzeros = 0;
+
+        for(auto& C : constraints)
+        {
+            numberOfNonzeros += C.linearTerms.size() + C.quadraticTerms.size();
+
+            for(auto& T : C.signomialTerms)
+                numberOfNonzeros += T.elements.size();
+        }
+
+        return (numberOfNonzeros);
+    }
+};
+
+// max sum(profit_i * x_i) - sum(cost_i * y_i) s.t. sum(a_ki * x_i^p_ki) <= b_k for each k, x_i <= 10 y_i and
+// sum(y_i) <= n / 2. The powers are in [1.5, 3], or in [0.3, 0.8] in the nonconvex version.
+GeneratedInstance createSignomialInstance(int size, int termsPerConstraint, bool isNonconvex, std::mt19937& generator)
+{
+    GeneratedInstance instance;
+    std::uniform_real_distribution<double> coefficient(0.5, 2.0);
+    std::uniform_real_distribution<double> power(isNonconvex ? 0.3 : 1.5, isNonconvex ? 0.8 : 3.0);
+    std::uniform_int_distribution<int> variable(0, size - 1);
+
+    for(int i = 0; i < size; i++)
+        instance.addVariable(fmt::format("x{}", i), E_VariableType::Real, 0.0, 10.0);
+
+    for(int i = 0; i < size; i++)
+        instance.addVariable(fmt::format("y{}", i), E_VariableType::Binary, 0.0, 1.0);
+
+    instance.objective.upperBound = 1.0; // Maximization
+
+    for(int i = 0; i < size; i++)
+    {
+        instance.objective.linearTerms.emplace_back(i, coefficient(generator));
+        instance.objective.linearTerms.emplace_back(size + i, -5.0 * coefficient(generator));
+    }
+
+    for(int k = 0; k < size; k++)
+    {
+        GeneratedRow row;
+        row.name = fmt::format("sig{}", k);
+
+        double sum = 0.0;
+
+        for(int t = 0; t < termsPerConstraint; t++)
+        {
+            double a = coefficient(generator);
+            row.signomialTerms.push_back({ a, { { variable(generator), power(generator) } } });
+            sum += a;
+        }
+
+        // Every variable in the constraint can be about 2 and still be feasible
+        row.upperBound = 2.0 * sum;
+        instance.constraints.push_back(std::move(row));
+    }
+
+    for(int i = 0; i < size; i++)
+    {
+        GeneratedRow row;
+        row.name = fmt::format("link{}", i);
+        row.linearTerms = { { i, 1.0 }, { size + i, -10.0 } };
+        row.upperBound = 0.0;
+        instance.constraints.push_back(std::move(row));
+    }
+
+    GeneratedRow cardinality;
+    cardinality.name = "card";
+    cardinality.upperBound = size / 2;
+
+    for(int i = 0; i < size; i++)
+        cardinality.linearTerms.emplace_back(size + i, 1.0);
+
+    instance.constraints.push_back(std::move(cardinality));
+
+    return (instance);
+}
+
+// min sum(fixed_f * y_f) + sum(cost_fc * x_fc^2) s.t. sum_f(x_fc) = 1, x_fc <= y_f and sum_c(demand_c * x_fc) <=
+// capacity_f * y_f, where there are size facilities and 2 * size customers. In the nonconvex version, the
+// transportation costs have economies of scale, i.e. the squared terms have negative coefficients.
+GeneratedInstance createFacilityLocationInstance(int size, bool isNonconvex, std::mt19937& generator)
+{
+    GeneratedInstance instance;
+    std::uniform_real_distribution<double> cost(1.0, 10.0);
+    std::uniform_real_distribution<double> demand(1.0, 5.0);
+
+    int numberOfFacilities = size;
+    int numberOfCustomers = 2 * size;
+
+    VectorInteger open(numberOfFacilities);
+    std::vector<VectorInteger> flow(numberOfFacilities, VectorInteger(numberOfCustomers));
+
+    for(int f = 0; f < numberOfFacilities; f++)
+        open[f] = instance.addVariable(fmt::format("y{}", f), E_VariableType::Binary, 0.0, 1.0);
+
+    for(int f = 0; f < numberOfFacilities; f++)
+    {
+        for(int c = 0; c < numberOfCustomers; c++)
+            flow[f][c] = instance.addVariable(fmt::format("x{}_{}", f, c), E_VariableType::Real, 0.0, 1.0);
+    }
+
+    VectorDouble demands(numberOfCustomers);
+    double totalDemand = 0.0;
+
+    for(auto& D : demands)
+    {
+        D = demand(generator);
+        totalDemand += D;
+    }
+
+    instance.objective.lowerBound = 0.0; // Minimization
+
+    for(int f = 0; f < numberOfFacilities; f++)
+    {
+        instance.objective.linearTerms.emplace_back(open[f], 10.0 * cost(generator));
+
+        for(int c = 0; c < numberOfCustomers; c++)
+        {
+            double coefficient = cost(generator);
+
+            // With economies of scale the cost is still increasing in [0, 1]
+            if(isNonconvex)
+            {
+                instance.objective.linearTerms.emplace_back(flow[f][c], 2.0 * coefficient);
+                instance.objective.quadraticTerms.emplace_back(flow[f][c], flow[f][c], -coefficient);
+            }
+            else
+            {
+                instance.objective.quadraticTerms.emplace_back(flow[f][c], flow[f][c], coefficient);
+            }
+        }
+    }
+
+    for(int c = 0; c < numberOfCustomers; c++)
+    {
+        GeneratedRow row;
+        row.name = fmt::format("demand{}", c);
+        row.lowerBound = 1.0;
+        row.upperBound = 1.0;
+
+        for(int f = 0; f < numberOfFacilities; f++)
+            row.linearTerms.emplace_back(flow[f][c], 1.0);
+
+        instance.constraints.push_back(std::move(row));
+    }
+
+    // Half of the facilities are enough to serve all customers
+    double capacity = 2.0 * totalDemand / numberOfFacilities;
+
+    for(int f = 0; f < numberOfFacilities; f++)
+    {
+        GeneratedRow row;
+        row.name = fmt::format("capacity{}", f);
+        row.upperBound = 0.0;
+
+        for(int c = 0; c < numberOfCustomers; c++)
+            row.linearTerms.emplace_back(flow[f][c], demands[c]);
+
+        row.linearTerms.emplace_back(open[f], -capacity);
+        instance.constraints.push_back(std::move(row));
+
+        for(int c = 0; c < numberOfCustomers; c++)
+        {
+            GeneratedRow link;
+            link.name = fmt::format("open{}_{}", f, c);
+            link.upperBound = 0.0;
+            link.linearTerms = { { flow[f][c], 1.0 }, { open[f], -1.0 } };
+            instance.constraints.push_back(std::move(link));
+        }
+    }
+
+    return (instance);
+}
+
+// min sum(c_j * z_j) - 1/S sum_s sum_i(q_si * w_si) s.t. sum_i(a_si * w_si^2) <= r_s and w_si <= 10 z_(i mod n) for
+// each scenario s, with n = size first-stage binaries z_j, S = size scenarios and secondStageSize recourse
+// variables w_si in each scenario. The scenarios only share the first-stage variables. In the nonconvex version, the
+// quadratic constraints also contain products of consecutive recourse variables.
+GeneratedInstance createScenarioInstance(int size, int secondStageSize, bool isNonconvex, std::mt19937& generator)
+{
+    GeneratedInstance instance;
+    std::uniform_real_distribution<double> coefficient(0.5, 2.0);
+
+    int numberOfScenarios = size;
+    VectorInteger firstStage(size);
+
+    for(int j = 0; j < size; j++)
+        firstStage[j] = instance.addVariable(fmt::format("z{}", j), E_VariableType::Binary, 0.0, 1.0);
+
+    instance.objective.lowerBound = 0.0; // Minimization
+
+    for(int j = 0; j < size; j++)
+        instance.objective.linearTerms.emplace_back(firstStage[j], 5.0 * coefficient(generator));
+
+    for(int s = 0; s < numberOfScenarios; s++)
+    {
+        VectorInteger recourse(secondStageSize);
+
+        for(int i = 0; i < secondStageSize; i++)
+        {
+            recourse[i] = instance.addVariable(fmt::format("w{}_{}", s, i), E_VariableType::Real, 0.0, 10.0);
+            instance.objective.linearTerms.emplace_back(recourse[i], -coefficient(generator) / numberOfScenarios);
+        }
+
+        GeneratedRow row;
+        row.name = fmt::format("scenario{}", s);
+
+        for(int i = 0; i < secondStageSize; i++)
+        {
+            row.quadraticTerms.emplace_back(recourse[i], recourse[i], coefficient(generator));
+
+            if(isNonconvex && i + 1 < secondStageSize)
+                row.quadraticTerms.emplace_back(recourse[i], recourse[i + 1], coefficient(generator));
+        }
+
+        row.upperBound = 4.0 * secondStageSize;
+        instance.constraints.push_back(std::move(row));
+
+        for(int i = 0; i < secondStageSize; i++)
+        {
+            GeneratedRow link;
+            link.name = fmt::format("link{}_{}", s, i);
+            link.upperBound = 0.0;
+            link.linearTerms = { { recourse[i], 1.0 }, { firstStage[i % size], -10.0 } };
+            instance.constraints.push_back(std::move(link));
+        }
+    }
+
+    return (instance);
+}
+
+std::string getOSiLBound(double bound) { return (fmt::format("{:.17g}", bound)); }
+
+std::string getOSiLVariableType(E_VariableType type)
+{
+    switch(type)
+    {
+    case E_VariableType::Binary:
+        return ("B");
+    case E_VariableType::Integer:
+        return ("I");
+    default:
+        return ("C");
+    }
+}
+
+void writeOSiLSignomialTerms(std::stringstream& output, const std::vector<GeneratedSignomialTerm>& terms)
+{
+    output << "<sum>";
+
+    for(auto& T : terms)
+    {
+        output << fmt::format("<product><number value=\"{:.17g}\"/>", T.coefficient);
+
+        for(auto& [index, power] : T.elements)
+            output << fmt::format("<power><variable idx=\"{}\" coef=\"1\"/><number value=\"{:.17g}\"/></power>",
+                index, power);
+
+        output << "</product>";
+    }
+
+    output << "</sum>";
+}
+
+bool writeOSiL(const GeneratedInstance& instance, const std::string& filename)
+{
+    std::stringstream output;
+    bool isMaximization = (instance.objective.upperBound == 1.0);
+
+    output << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<osil xmlns=\"os.optimizationservices.org\">\n";
+    output << fmt::format("<instanceHeader><name>{}</name></instanceHeader>\n<instanceData>\n", instance.name);
+
+    output << fmt::format("<variables numberOfVariables=\"{}\">\n", instance.variables.size());
+
+    for(auto& V : instance.variables)
+        output << fmt::format("<var name=\"{}\" type=\"{}\" lb=\"{}\" ub=\"{}\"/>\n", V.name,
+            getOSiLVariableType(V.type), getOSiLBound(V.lowerBound), getOSiLBound(V.upperBound));
+
+    output << "</variables>\n";
+
+    output << fmt::format("<objectives numberOfObjectives=\"1\">\n<obj maxOrMin=\"{}\" numberOfObjCoef=\"{}\">",
+        isMaximization ? "max" : "min", instance.objective.linearTerms.size());
+
+    for(auto& [index, coefficient] : instance.objective.linearTerms)
+        output << fmt::format("<coef idx=\"{}\">{:.17g}</coef>", index, coefficient);
+
+    output << "</obj>\n</objectives>\n";
+
+    output << fmt::format("<constraints numberOfConstraints=\"{}\">\n", instance.constraints.size());
+
+    for(auto& C : instance.constraints)
+    {
+        output << fmt::format("<con name=\"{}\"", C.name);
+
+        if(C.lowerBound > SHOT_DBL_MIN)
+            output << fmt::format(" lb=\"{}\"", getOSiLBound(C.lowerBound));
+
+        if(C.upperBound < SHOT_DBL_MAX)
+            output << fmt::format(" ub=\"{}\"", getOSiLBound(C.upperBound));
+
+        output << "/>\n";
+    }
+
+    output << "</constraints>\n";
+
+    std::stringstream starts, indexes, values;
+    size_t numberOfValues = 0;
+
+    for(auto& C : instance.constraints)
+    {
+        starts << fmt::format("<el>{}</el>", numberOfValues);
+
+        for(auto& [index, coefficient] : C.linearTerms)
+        {
+            indexes << fmt::format("<el>{}</el>", index);
+            values << fmt::format("<el>{:.17g}</el>", coefficient);
+        }
+
+        numberOfValues += C.linearTerms.size();
+    }
+
+    starts << fmt::format("<el>{}</el>", numberOfValues);
+
+    output << fmt::format("<linearConstraintCoefficients numberOfValues=\"{}\">\n<start>{}</start>\n"
+                          "<colIdx>{}</colIdx>\n<value>{}</value>\n</linearConstraintCoefficients>\n",
+        numberOfValues, starts.str(), indexes.str(), values.str());
+
+    std::stringstream quadraticTerms;
+    size_t numberOfQuadraticTerms = 0;
+
+    auto addQuadraticTerms = [&](const GeneratedRow& row, int rowIndex) {
+        for(auto& [first, second, coefficient] : row.quadraticTerms)
+        {
+            quadraticTerms << fmt::format("<qTerm idx=\"{}\" idxOne=\"{}\" idxTwo=\"{}\" coef=\"{:.17g}\"/>\n",
+                rowIndex, first, second, coefficient);
+            numberOfQuadraticTerms++;
+        }
+    };
+
+    addQuadraticTerms(instance.objective, -1);
+
+    for(size_t k = 0; k < instance.constraints.size(); k++)
+        addQuadraticTerms(instance.constraints[k], k);
+
+    if(numberOfQuadraticTerms > 0)
+    {
+        output << fmt::format("<quadraticCoefficients numberOfQuadraticTerms=\"{}\">\n{}</quadraticCoefficients>\n",
+            numberOfQuadraticTerms, quadraticTerms.str());
+    }
+
+    std::stringstream expressions;
+    size_t numberOfExpressions = 0;
+
+    for(size_t k = 0; k < instance.constraints.size(); k++)
+    {
+        if(instance.constraints[k].signomialTerms.empty())
+            continue;
+
+        expressions << fmt::format("<nl idx=\"{}\">", k);
+        writeOSiLSignomialTerms(expressions, instance.constraints[k].signomialTerms);
+        expressions << "</nl>\n";
+        numberOfExpressions++;
+    }
+
+    if(numberOfExpressions > 0)
+    {
+        output << fmt::format("<nonlinearExpressions numberOfNonlinearExpressions=\"{}\">\n{}</nonlinearExpressions>\n",
+            numberOfExpressions, expressions.str());
+    }
+
+    output << "</instanceData>\n</osil>\n";
+
+    return (Utilities::writeStringToFile(filename, output.str()));
+}
+
+// Creates the problem in the environment with ProblemBuilder, i.e. in the same way as a program that generates its
+// models in memory
+ProblemPtr createProblem(EnvironmentPtr env, const GeneratedInstance& instance)
+{
+    ProblemBuilder builder(env);
+
+    VectorDouble lowerBounds, upperBounds;
+    std::vector<E_VariableType> types;
+    VectorString names;
+
+    for(auto& V : instance.variables)
+    {
+        lowerBounds.push_back(V.lowerBound);
+        upperBounds.push_back(V.upperBound);
+        types.push_back(V.type);
+        names.push_back(V.name);
+    }
+
+    builder.setVariables(lowerBounds, upperBounds, types, names);
+
+    VectorDouble constraintLowerBounds, constraintUpperBounds;
+    VectorString constraintNames;
+    VectorInteger rowStarts, variableIndexes;
+    VectorDouble coefficients;
+
+    VectorInteger quadraticRows, firstVariableIndexes, secondVariableIndexes;
+    VectorDouble quadraticCoefficients;
+
+    VectorInteger nonlinearRows, expressionStarts;
+    std::vector<E_NonlinearExpressionTypes> opcodes;
+    VectorDouble operands;
+
+    auto addQuadraticTerms = [&](const GeneratedRow& row, int rowIndex) {
+        for(auto& [first, second, coefficient] : row.quadraticTerms)
+        {
+            quadraticRows.push_back(rowIndex);
+            firstVariableIndexes.push_back(first);
+            secondVariableIndexes.push_back(second);
+            quadraticCoefficients.push_back(coefficient);
+        }
+    };
+
+    auto addInstruction = [&](E_NonlinearExpressionTypes opcode, double operand) {
+        opcodes.push_back(opcode);
+        operands.push_back(operand);
+    };
+
+    for(size_t k = 0; k < instance.constraints.size(); k++)
+    {
+        auto& C = instance.constraints[k];
+
+        constraintLowerBounds.push_back(C.lowerBound);
+        constraintUpperBounds.push_back(C.upperBound);
+        constraintNames.push_back(C.name);
+
+        rowStarts.push_back(variableIndexes.size());
+
+        for(auto& [index, coefficient] : C.linearTerms)
+        {
+            variableIndexes.push_back(index);
+            coefficients.push_back(coefficient);
+        }
+
+        addQuadraticTerms(C, k);
+
+        if(C.signomialTerms.empty())
+            continue;
+
+        // The signomial terms in postfix order
+        nonlinearRows.push_back(k);
+        expressionStarts.push_back(opcodes.size());
+
+        for(auto& T : C.signomialTerms)
+        {
+            addInstruction(E_NonlinearExpressionTypes::Constant, T.coefficient);
+
+            for(auto& [index, power] : T.elements)
+            {
+                addInstruction(E_NonlinearExpressionTypes::Variable, index);
+                addInstruction(E_NonlinearExpressionTypes::Constant, power);
+                addInstruction(E_NonlinearExpressionTypes::Power, 0.0);
+            }
+
+            addInstruction(E_NonlinearExpressionTypes::Product, T.elements.size() + 1);
+        }
+
+        addInstruction(E_NonlinearExpressionTypes::Sum, C.signomialTerms.size());
+    }
+
+    rowStarts.push_back(variableIndexes.size());
+
+    if(nonlinearRows.size() > 0)
+        expressionStarts.push_back(opcodes.size());
+
+    addQuadraticTerms(instance.objective, -1);
+
+    builder.setConstraints(constraintLowerBounds, constraintUpperBounds, constraintNames);
+    builder.setLinearTerms(rowStarts, variableIndexes, coefficients);
+    builder.setQuadraticTerms(quadraticRows, firstVariableIndexes, secondVariableIndexes, quadraticCoefficients);
+    builder.setNonlinearExpressions(nonlinearRows, expressionStarts, opcodes, operands);
+
+    VectorInteger objectiveIndexes;
+    VectorDouble objectiveCoefficients;
+
+    for(auto& [index, coefficient] : instance.objective.linearTerms)
+    {
+        objectiveIndexes.push_back(index);
+        objectiveCoefficients.push_back(coefficient);
+    }
+
+    bool isMaximization = (instance.objective.upperBound == 1.0);
+
+    auto direction = isMaximization ? E_ObjectiveFunctionDirection::Maximize : E_ObjectiveFunctionDirection::Minimize;
+    builder.setObjective(direction, objectiveIndexes, objectiveCoefficients);
+
+    return (builder.build(instance.name));
+}
+
+int main(int argc, char* argv[])
+{
+    argh::parser cmdl;
+    cmdl.add_params({ "--family", "--sizes", "--terms", "--seed", "--dir" });
+    cmdl.parse(argc, argv);
+
+    if(cmdl["--help"])
+    {
+        std::cout << "Usage: shot_generator [OPTIONS] [OPTIONNAME=VALUE ...]" << std::endl
+                  << std::endl
+                  << "  --family NAME        signomial, facility or scenario (default: signomial)" << std::endl
+                  << "  --sizes N,M,...      The sizes of the generated instances (default: 10,20,40,80)" << std::endl
+                  << "  --terms N            Terms per signomial constraint or recourse variables per scenario "
+                     "(default: 5)"
+                  << std::endl
+                  << "  --nonconvex          Generates the nonconvex version of the family" << std::endl
+                  << "  --seed N             Seed of the random number generator (default: 1)" << std::endl
+                  << "  --dir DIRECTORY      Writes the OSiL files to DIRECTORY (default: current directory)"
+                  << std::endl
+                  << "  --solve              Creates the instances in memory and solves them instead of writing them"
+                  << std::endl;
+
+        return (0);
+    }
+
+    std::string family = cmdl("--family", "signomial").str();
+    bool isNonconvex = cmdl["--nonconvex"];
+
+    int termsPerConstraint = 5;
+    unsigned int seed = 1;
+
+    cmdl("--terms", 5) >> termsPerConstraint;
+    cmdl("--seed", 1) >> seed;
+
+    std::vector<int> sizes;
+    std::stringstream sizeList(cmdl("--sizes", "10,20,40,80").str());
+    std::string size;
+
+    while(std::getline(sizeList, size, ','))
+        sizes.push_back(std::stoi(size));
+
+    std::vector<std::string> options;
+
+    for(size_t i = 1; i < cmdl.pos_args().size(); i++)
+        options.push_back(cmdl.pos_args()[i]);
+
+    for(auto N : sizes)
+    {
+        std::mt19937 generator(seed);
+        GeneratedInstance instance;
+
+        if(family == "signomial")
+            instance = createSignomialInstance(N, termsPerConstraint, isNonconvex, generator);
+        else if(family == "facility")
+            instance = createFacilityLocationInstance(N, isNonconvex, generator);
+        else if(family == "scenario")
+            instance = createScenarioInstance(N, termsPerConstraint, isNonconvex, generator);
+        else
+        {
+            std::cout << "Unknown family " << family << std::endl;
+            return (1);
+        }
+
+        instance.name = fmt::format("{}{}_{}", family, isNonconvex ? "_nonconvex" : "", N);
+
+        std::cout << fmt::format("{:<32} {:>8} variables, {:>8} constraints, {:>9} nonzeros", instance.name,
+                         instance.variables.size(), instance.constraints.size(), instance.getNumberOfNonzeros())
+                  << std::endl;
+
+        if(!cmdl["--solve"])
+        {
+            auto filename = cmdl("--dir", ".").str() + "/" + instance.name + ".osil";
+
+            if(!writeOSiL(instance, filename))
+            {
+                std::cout << "Could not write " << filename << std::endl;
+                return (1);
+            }
+
+            continue;
+        }
+
+        auto solver = std::make_unique<Solver>();
+        auto env = solver->getEnvironment();
+
+        solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+        if(options.size() > 0)
+        {
+            std::string optionsString;
+
+            for(auto& O : options)
+                optionsString += O + '\n';
+
+            solver->setOptionsFromString(optionsString);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+
+        if(!solver->setProblem(createProblem(env, instance)))
+        {
+            std::cout << "Could not create " << instance.name << std::endl;
+            return (1);
+        }
+
+        solver->solveProblem();
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << fmt::format("{:<32} {:>10.3f} s, {:>6} iterations, primal bound {}, dual bound {}", instance.name,
+                         elapsed.count(), env->results->getNumberOfIterations(), solver->getPrimalBound(),
+                         solver->getCurrentDualBound())
+                  << std::endl;
+    }
+
+    return (0);
+}
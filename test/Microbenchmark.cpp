@@ -0,0 +1,622 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+// Microbenchmarks of the model evaluation kernels using Google Benchmark. The workloads are random sparse linear,
+// quadratic, signomial and nonlinear expression models of varying size, and the instances in the data directory. The
+// evaluation cache is disabled so that every evaluation is measured.
+
+#include "../src/Solver.h"
+#include "../src/Environment.h"
+#include "../src/Settings.h"
+#include "../src/Utilities.h"
+
+#include "../src/Model/Problem.h"
+#include "../src/Model/Variables.h"
+#include "../src/Model/Terms.h"
+#include "../src/Model/NonlinearExpressions.h"
+#include "../src/Model/Constraints.h"
+#include "../src/Model/ObjectiveFunction.h"
+
+#include "../src/RootsearchMethod/RootsearchMethodBoost.h"
+
+#include <benchmark/benchmark.h>
+
+#ifdef HAS_STD_FILESYSTEM
+#include <filesystem>
+namespace fs = std;
+#endif
+
+#ifdef HAS_STD_EXPERIMENTAL_FILESYSTEM
+#include <experimental/filesystem>
+namespace fs = std::experimental;
+#endif
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace SHOT;
+
+enum class SyntheticModel
+{
+    Linear,
+    Quadratic,
+    Signomial,
+    Expression
+};
+
+// The evaluation points are cycled through, so that the same point is not evaluated in every iteration
+constexpr int NumberOfPoints = 16;
+
+struct Workload
+{
+    std::unique_ptr<Solver> solver;
+    EnvironmentPtr env;
+    ProblemPtr problem;
+
+    std::vector<VectorDouble> points;
+
+    // Points that are feasible and infeasible in all nonlinear constraints, used in the root searches
+    VectorDouble interiorPoint;
+    VectorDouble exteriorPoint;
+};
+
+std::unique_ptr<Solver> createSolver()
+{
+    auto solver = std::make_unique<Solver>();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+    solver->updateSetting("EvaluationCache.Use", "Model", false);
+
+    return (solver);
+}
+
+void createPoints(Workload& workload, std::mt19937& generator)
+{
+    auto bounds = workload.problem->getVariableBounds();
+
+    for(int i = 0; i < NumberOfPoints; i++)
+    {
+        VectorDouble point(bounds.size());
+
+        for(size_t j = 0; j < bounds.size(); j++)
+        {
+            // Infinite bounds are replaced with a finite box around zero
+            double lower = std::max(bounds[j].l(), -10.0);
+            double upper = std::min(bounds[j].u(), 10.0);
+
+            point[j] = (lower < upper) ? std::uniform_real_distribution<double>(lower, upper)(generator) : lower;
+        }
+
+        workload.points.push_back(point);
+    }
+}
+
+// Creates a random model with numberOfConstraints constraints of the given type, each with termsPerConstraint terms in
+// randomly selected variables. The coefficients are positive and the variables in [0.5, 10], so every constraint
+// function is increasing, and the right-hand sides are selected so that the root searches have a root to find.
+Workload createSyntheticWorkload(
+    SyntheticModel model, int numberOfVariables, int numberOfConstraints, int termsPerConstraint, unsigned int seed)
+{
+    Workload workload;
+    workload.solver = createSolver();
+    workload.env = workload.solver->getEnvironment();
+    workload.problem = std::make_shared<Problem>(workload.env);
+    workload.env->problem = workload.problem;
+    workload.env->reformulatedProblem = workload.problem;
+
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> coefficient(0.1, 2.0);
+    std::uniform_real_distribution<double> power(0.5, 2.5);
+    std::uniform_int_distribution<int> variableIndex(0, numberOfVariables - 1);
+
+    Variables variables;
+
+    for(int i = 0; i < numberOfVariables; i++)
+        variables.push_back(std::make_shared<Variable>("x" + std::to_string(i), i, E_VariableType::Real, 0.5, 10.0));
+
+    workload.problem->add(variables);
+
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+
+    for(auto& V : variables)
+        objective->add(std::make_shared<LinearTerm>(1.0, V));
+
+    workload.problem->add(objective);
+
+    auto getVariable = [&]() { return (variables[variableIndex(generator)]); };
+
+    for(int i = 0; i < numberOfConstraints; i++)
+    {
+        std::string name = "c" + std::to_string(i);
+
+        LinearTerms linearTerms;
+
+        for(int j = 0; j < termsPerConstraint; j++)
+            linearTerms.add(std::make_shared<LinearTerm>(coefficient(generator), getVariable()));
+
+        switch(model)
+        {
+        case SyntheticModel::Linear:
+            workload.problem->add(std::make_shared<LinearConstraint>(i, name, linearTerms, SHOT_DBL_MIN, 0.0));
+            break;
+
+        case SyntheticModel::Quadratic:
+        {
+            QuadraticTerms quadraticTerms;
+
+            for(int j = 0; j < termsPerConstraint; j++)
+            {
+                quadraticTerms.add(
+                    std::make_shared<QuadraticTerm>(coefficient(generator), getVariable(), getVariable()));
+            }
+
+            workload.problem->add(
+                std::make_shared<QuadraticConstraint>(i, name, linearTerms, quadraticTerms, SHOT_DBL_MIN, 0.0));
+            break;
+        }
+
+        case SyntheticModel::Signomial:
+        {
+            auto constraint = std::make_shared<NonlinearConstraint>(i, name, SHOT_DBL_MIN, 0.0);
+            constraint->add(linearTerms);
+
+            for(int j = 0; j < termsPerConstraint; j++)
+            {
+                SignomialElements elements;
+                elements.push_back(std::make_shared<SignomialElement>(getVariable(), power(generator)));
+                elements.push_back(std::make_shared<SignomialElement>(getVariable(), power(generator)));
+
+                constraint->add(std::make_shared<SignomialTerm>(coefficient(generator), elements));
+            }
+
+            workload.problem->add(constraint);
+            break;
+        }
+
+        case SyntheticModel::Expression:
+        {
+            // Sums of c * exp(a * x_i) * log(x_j + 1) and c * x_k^2 * sqrt(x_l)
+            NonlinearExpressions terms;
+
+            for(int j = 0; j < termsPerConstraint; j++)
+            {
+                auto x = [&]() { return (std::make_shared<ExpressionVariable>(getVariable())); };
+                auto constant = [](double value) { return (std::make_shared<ExpressionConstant>(value)); };
+
+                if(j % 2 == 0)
+                {
+                    terms.add(std::make_shared<ExpressionProduct>(constant(coefficient(generator)),
+                        std::make_shared<ExpressionExp>(
+                            std::make_shared<ExpressionProduct>(constant(0.1 * coefficient(generator)), x())),
+                        std::make_shared<ExpressionLog>(std::make_shared<ExpressionSum>(x(), constant(1.0)))));
+                }
+                else
+                {
+                    terms.add(std::make_shared<ExpressionProduct>(constant(coefficient(generator)),
+                        std::make_shared<ExpressionSquare>(x()), std::make_shared<ExpressionSquareRoot>(x())));
+                }
+            }
+
+            auto constraint = std::make_shared<NonlinearConstraint>(
+                i, name, std::make_shared<ExpressionSum>(terms), SHOT_DBL_MIN, 0.0);
+            constraint->add(linearTerms);
+
+            workload.problem->add(constraint);
+            break;
+        }
+        }
+    }
+
+    workload.problem->finalize();
+
+    workload.interiorPoint = VectorDouble(numberOfVariables, 1.0);
+    workload.exteriorPoint = VectorDouble(numberOfVariables, 9.0);
+
+    // Since the constraint functions are increasing, the root is in the interior of the line segment
+    for(auto& C : workload.problem->numericConstraints)
+    {
+        C->valueRHS = 0.5
+            * (C->calculateFunctionValue(workload.interiorPoint) + C->calculateFunctionValue(workload.exteriorPoint));
+    }
+
+    createPoints(workload, generator);
+
+    return (workload);
+}
+
+Workload createInstanceWorkload(const std::string& filename)
+{
+    Workload workload;
+    workload.solver = createSolver();
+    workload.env = workload.solver->getEnvironment();
+
+    if(!workload.solver->setProblem(filename))
+        return (workload);
+
+    workload.problem = workload.env->problem;
+
+    std::mt19937 generator(1);
+    createPoints(workload, generator);
+
+    return (workload);
+}
+
+const char* getModelName(SyntheticModel model)
+{
+    switch(model)
+    {
+    case SyntheticModel::Linear:
+        return ("Linear");
+    case SyntheticModel::Quadratic:
+        return ("Quadratic");
+    case SyntheticModel::Signomial:
+        return ("Signomial");
+    default:
+        return ("Expression");
+    }
+}
+
+// The synthetic models have one constraint per ten variables and ten terms per constraint
+Workload createSyntheticWorkload(SyntheticModel model, const benchmark::State& state)
+{
+    int numberOfVariables = (int)state.range(0);
+    return (createSyntheticWorkload(model, numberOfVariables, std::max(1, numberOfVariables / 10), 10, 42));
+}
+
+static void BM_NonlinearExpressionCalculate(benchmark::State& state, SyntheticModel model)
+{
+    auto workload = createSyntheticWorkload(model, state);
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload.points[pointIndex++ % NumberOfPoints];
+
+        for(auto& C : workload.problem->nonlinearConstraints)
+            benchmark::DoNotOptimize(C->nonlinearExpression->calculate(point));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload.problem->nonlinearConstraints.size());
+}
+
+static void BM_NonlinearExpressionCalculateInterval(benchmark::State& state, SyntheticModel model)
+{
+    auto workload = createSyntheticWorkload(model, state);
+    auto bounds = workload.problem->getVariableBounds();
+
+    for(auto _ : state)
+    {
+        for(auto& C : workload.problem->nonlinearConstraints)
+            benchmark::DoNotOptimize(C->nonlinearExpression->calculate(bounds));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload.problem->nonlinearConstraints.size());
+}
+
+static void BM_TermsCalculate(benchmark::State& state, SyntheticModel model)
+{
+    auto workload = createSyntheticWorkload(model, state);
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload.points[pointIndex++ % NumberOfPoints];
+
+        switch(model)
+        {
+        case SyntheticModel::Linear:
+            for(auto& C : workload.problem->linearConstraints)
+                benchmark::DoNotOptimize(C->linearTerms.calculate(point));
+            break;
+        case SyntheticModel::Quadratic:
+            for(auto& C : workload.problem->quadraticConstraints)
+                benchmark::DoNotOptimize(C->quadraticTerms.calculate(point));
+            break;
+        default:
+            for(auto& C : workload.problem->nonlinearConstraints)
+                benchmark::DoNotOptimize(C->signomialTerms.calculate(point));
+            break;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload.problem->numericConstraints.size());
+}
+
+static void BM_ConstraintGradient(benchmark::State& state, SyntheticModel model)
+{
+    auto workload = createSyntheticWorkload(model, state);
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload.points[pointIndex++ % NumberOfPoints];
+
+        for(auto& C : workload.problem->numericConstraints)
+            benchmark::DoNotOptimize(C->calculateGradient(point, true));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload.problem->numericConstraints.size());
+}
+
+static void BM_ConstraintHessian(benchmark::State& state, SyntheticModel model)
+{
+    auto workload = createSyntheticWorkload(model, state);
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload.points[pointIndex++ % NumberOfPoints];
+
+        for(auto& C : workload.problem->numericConstraints)
+            benchmark::DoNotOptimize(C->calculateHessian(point, true));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload.problem->numericConstraints.size());
+}
+
+static void BM_MaxNumericConstraintValue(benchmark::State& state, SyntheticModel model)
+{
+    auto workload = createSyntheticWorkload(model, state);
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload.points[pointIndex++ % NumberOfPoints];
+        benchmark::DoNotOptimize(
+            workload.problem->getMaxNumericConstraintValue(point, workload.problem->numericConstraints));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload.problem->numericConstraints.size());
+}
+
+static void BM_RootsearchFindZero(benchmark::State& state, SyntheticModel model)
+{
+    auto workload = createSyntheticWorkload(model, state);
+    RootsearchMethodBoost rootsearch(workload.env);
+
+    std::vector<NumericConstraint*> constraints;
+
+    for(auto& C : workload.problem->nonlinearConstraints)
+        constraints.push_back(C.get());
+
+    int maxIterations = workload.env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver");
+    double terminationTolerance
+        = workload.env->settings->getSetting<double>("Rootsearch.TerminationTolerance", "Subsolver");
+    double activeConstraintTolerance
+        = workload.env->settings->getSetting<double>("Rootsearch.ActiveConstraintTolerance", "Subsolver");
+
+    for(auto _ : state)
+    {
+        benchmark::DoNotOptimize(rootsearch.findZero(workload.interiorPoint, workload.exteriorPoint, maxIterations,
+            terminationTolerance, activeConstraintTolerance, constraints, false));
+    }
+}
+
+static void BM_CalculateHash(benchmark::State& state)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> value(-100.0, 100.0);
+
+    std::vector<VectorDouble> points(NumberOfPoints, VectorDouble(state.range(0)));
+
+    for(auto& P : points)
+        std::generate(P.begin(), P.end(), [&]() { return (value(generator)); });
+
+    int pointIndex = 0;
+
+    for(auto _ : state)
+        benchmark::DoNotOptimize(Utilities::calculateHash(points[pointIndex++ % NumberOfPoints]));
+
+    state.SetBytesProcessed(state.iterations() * state.range(0) * sizeof(double));
+}
+
+// The kernels that are benchmarked for the instances in the data directory
+static void BM_InstanceConstraintValues(benchmark::State& state, std::shared_ptr<Workload> workload)
+{
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload->points[pointIndex++ % NumberOfPoints];
+
+        for(auto& C : workload->problem->numericConstraints)
+            benchmark::DoNotOptimize(C->calculateNumericValue(point));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload->problem->numericConstraints.size());
+}
+
+static void BM_InstanceConstraintGradients(benchmark::State& state, std::shared_ptr<Workload> workload)
+{
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload->points[pointIndex++ % NumberOfPoints];
+
+        for(auto& C : workload->problem->numericConstraints)
+            benchmark::DoNotOptimize(C->calculateGradient(point, true));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload->problem->numericConstraints.size());
+}
+
+static void BM_InstanceConstraintHessians(benchmark::State& state, std::shared_ptr<Workload> workload)
+{
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload->points[pointIndex++ % NumberOfPoints];
+
+        for(auto& C : workload->problem->nonlinearConstraints)
+            benchmark::DoNotOptimize(C->calculateHessian(point, true));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload->problem->nonlinearConstraints.size());
+}
+
+static void BM_InstanceMaxNumericConstraintValue(benchmark::State& state, std::shared_ptr<Workload> workload)
+{
+    int pointIndex = 0;
+
+    for(auto _ : state)
+    {
+        auto& point = workload->points[pointIndex++ % NumberOfPoints];
+        benchmark::DoNotOptimize(
+            workload->problem->getMaxNumericConstraintValue(point, workload->problem->numericConstraints));
+    }
+}
+
+static void BM_InstanceIntervalValues(benchmark::State& state, std::shared_ptr<Workload> workload)
+{
+    auto bounds = workload->problem->getVariableBounds();
+
+    for(auto _ : state)
+    {
+        for(auto& C : workload->problem->numericConstraints)
+            benchmark::DoNotOptimize(C->calculateFunctionValue(bounds));
+    }
+
+    state.SetItemsProcessed(state.iterations() * workload->problem->numericConstraints.size());
+}
+
+void registerSyntheticBenchmarks()
+{
+    for(auto model : { SyntheticModel::Linear, SyntheticModel::Quadratic, SyntheticModel::Signomial,
+             SyntheticModel::Expression })
+    {
+        std::string name = getModelName(model);
+
+        if(model == SyntheticModel::Expression)
+        {
+            benchmark::RegisterBenchmark(("NonlinearExpression::calculate/" + name).c_str(),
+                BM_NonlinearExpressionCalculate, model)
+                ->RangeMultiplier(10)
+                ->Range(100, 10000);
+
+            benchmark::RegisterBenchmark(("NonlinearExpression::calculate(Interval)/" + name).c_str(),
+                BM_NonlinearExpressionCalculateInterval, model)
+                ->RangeMultiplier(10)
+                ->Range(100, 10000);
+        }
+        else
+        {
+            benchmark::RegisterBenchmark(("Terms::calculate/" + name).c_str(), BM_TermsCalculate, model)
+                ->RangeMultiplier(10)
+                ->Range(100, 10000);
+        }
+
+        benchmark::RegisterBenchmark(
+            ("NumericConstraint::calculateGradient/" + name).c_str(), BM_ConstraintGradient, model)
+            ->RangeMultiplier(10)
+            ->Range(100, 10000);
+
+        if(model != SyntheticModel::Linear)
+        {
+            benchmark::RegisterBenchmark(
+                ("NumericConstraint::calculateHessian/" + name).c_str(), BM_ConstraintHessian, model)
+                ->RangeMultiplier(10)
+                ->Range(100, 10000);
+        }
+
+        benchmark::RegisterBenchmark(
+            ("Problem::getMaxNumericConstraintValue/" + name).c_str(), BM_MaxNumericConstraintValue, model)
+            ->RangeMultiplier(10)
+            ->Range(100, 10000);
+
+        if(model == SyntheticModel::Signomial || model == SyntheticModel::Expression)
+        {
+            benchmark::RegisterBenchmark(
+                ("RootsearchMethodBoost::findZero/" + name).c_str(), BM_RootsearchFindZero, model)
+                ->RangeMultiplier(10)
+                ->Range(100, 10000);
+        }
+    }
+
+    benchmark::RegisterBenchmark("Utilities::calculateHash", BM_CalculateHash)->RangeMultiplier(8)->Range(8, 32768);
+}
+
+// The workloads are shared between the benchmarks of an instance, and are kept alive by the registered benchmarks
+void registerInstanceBenchmarks(const std::string& directory)
+{
+    if(!fs::filesystem::is_directory(directory))
+        return;
+
+    std::vector<std::string> instances;
+
+    for(auto& entry : fs::filesystem::directory_iterator(directory))
+    {
+        if(entry.path().extension() == ".osil")
+            instances.push_back(entry.path().string());
+    }
+
+    std::sort(instances.begin(), instances.end());
+
+    for(auto& I : instances)
+    {
+        auto workload = std::make_shared<Workload>(createInstanceWorkload(I));
+
+        if(!workload->problem || workload->problem->numericConstraints.size() == 0)
+            continue;
+
+        std::string name = fs::filesystem::path(I).stem().string();
+
+        benchmark::RegisterBenchmark(
+            ("Instance/" + name + "/calculateNumericValue").c_str(), BM_InstanceConstraintValues, workload);
+        benchmark::RegisterBenchmark(
+            ("Instance/" + name + "/calculateGradient").c_str(), BM_InstanceConstraintGradients, workload);
+        benchmark::RegisterBenchmark(("Instance/" + name + "/getMaxNumericConstraintValue").c_str(),
+            BM_InstanceMaxNumericConstraintValue, workload);
+        benchmark::RegisterBenchmark(
+            ("Instance/" + name + "/calculateFunctionValue(Interval)").c_str(), BM_InstanceIntervalValues, workload);
+
+        if(workload->problem->nonlinearConstraints.size() > 0)
+        {
+            benchmark::RegisterBenchmark(
+                ("Instance/" + name + "/calculateHessian").c_str(), BM_InstanceConstraintHessians, workload);
+        }
+    }
+}
+
+// Besides the options of Google Benchmark (e.g. --benchmark_filter), the directory with the instances can be given as
+// --data=DIRECTORY, the default is the data directory in the working directory
+int main(int argc, char* argv[])
+{
+    std::string directory = "data";
+    std::vector<char*> arguments;
+
+    for(int i = 0; i < argc; i++)
+    {
+        std::string argument = argv[i];
+
+        if(argument.rfind("--data=", 0) == 0)
+            directory = argument.substr(7);
+        else
+            arguments.push_back(argv[i]);
+    }
+
+    int numberOfArguments = (int)arguments.size();
+    benchmark::Initialize(&numberOfArguments, arguments.data());
+
+    if(benchmark::ReportUnrecognizedArguments(numberOfArguments, arguments.data()))
+        return (1);
+
+    registerSyntheticBenchmarks();
+    registerInstanceBenchmarks(directory);
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+
+    return (0);
+}
@@ -11,22 +11,178 @@
 #include "../src/Solver.h"
 #include "../src/Environment.h"
 #include "../src/Settings.h"
+#include "../src/Timing.h"
 
 #include "../src/Model/Variables.h"
 #include "../src/Model/Terms.h"
 #include "../src/Model/Constraints.h"
 #include "../src/Model/NonlinearExpressions.h"
 #include "../src/Model/Problem.h"
+#include "../src/Model/ProblemBuilder.h"
+#include "../src/Model/ExpressionTape.h"
+#include "../src/Model/Presolve.h"
+#include "../src/Model/Simplifications.h"
+#include "../src/Model/Symmetry.h"
+#include "../src/Model/FixedProblemReduction.h"
+#include "../src/Model/BlockDecomposition.h"
 
 #include "../src/Tasks/TaskReformulateProblem.h"
 
+#include <chrono>
 #include <sstream>
+#include <thread>
 
 using namespace SHOT;
 
 bool ModelTestVariables();
 bool ModelTestTerms();
 bool ModelTestNonlinearExpressions();
+bool ModelTestProblemBuilder();
+bool ModelTestSimplificationRewrites();
+bool ModelTestQuadraticSegmentCoefficients();
+bool ModelTestNonquadraticSegmentTerms();
+bool ModelTestSymmetryDetection();
+bool ModelTestIncrementalProperties();
+bool ModelTestPropagateVariableBounds();
+bool ModelTestFixedProblemReduction();
+bool ModelTestUnivariateFunctions();
+bool ModelTestBlockDecomposition();
+bool ModelTestLinearConstraintMatrix()
+{
+    bool passed = true;
+
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    SHOT::ProblemPtr problem = std::make_shared<SHOT::Problem>(env);
+    env->problem = problem;
+
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 10.0);
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Real, 0.0, 10.0);
+
+    SHOT::Variables variables = { var_x, var_y };
+    problem->add(variables);
+
+    auto objective = std::make_shared<SHOT::LinearObjectiveFunction>(SHOT::E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<SHOT::LinearTerm>(1.0, var_x));
+    problem->add(objective);
+
+    // x + y <= 4
+    SHOT::LinearTerms linearTerms1;
+    linearTerms1.add(std::make_shared<SHOT::LinearTerm>(1.0, var_x));
+    linearTerms1.add(std::make_shared<SHOT::LinearTerm>(1.0, var_y));
+    problem->add(std::make_shared<SHOT::LinearConstraint>(0, "c1", linearTerms1, SHOT_DBL_MIN, 4.0));
+
+    // 1 <= x - y + 1 <= 3
+    SHOT::LinearTerms linearTerms2;
+    linearTerms2.add(std::make_shared<SHOT::LinearTerm>(1.0, var_x));
+    linearTerms2.add(std::make_shared<SHOT::LinearTerm>(-1.0, var_y));
+    auto constraint2 = std::make_shared<SHOT::LinearConstraint>(1, "c2", linearTerms2, 1.0, 3.0);
+    constraint2->constant = 1.0;
+    problem->add(constraint2);
+
+    // 2x <= 1
+    SHOT::LinearTerms linearTerms3;
+    linearTerms3.add(std::make_shared<SHOT::LinearTerm>(2.0, var_x));
+    problem->add(std::make_shared<SHOT::LinearConstraint>(2, "c3", linearTerms3, SHOT_DBL_MIN, 1.0));
+
+    problem->finalize();
+
+    // Feasible in all constraints, so the values should be the same as when evaluating all of them
+    SHOT::VectorDouble point = { 0.5, 0.25 };
+
+    auto maxValue = problem->getMaxLinearConstraintValueOrFirstViolation(point, SHOT_DBL_MAX);
+    auto value = problem->getMaxLinearConstraintValueOrFirstViolation(point, 1e-6);
+
+    std::cout << "Most deviating linear constraint " << value.constraint->name << " with value "
+              << value.normalizedValue << " (should be " << maxValue.constraint->name << " with value "
+              << maxValue.normalizedValue << ").\n";
+
+    if(value.constraint != maxValue.constraint || value.normalizedValue != maxValue.normalizedValue)
+        passed = false;
+
+    // Violates c1 by 1 and c3 by 7, the first violated constraint should be returned
+    point = { 4.0, 1.0 };
+    value = problem->getMaxLinearConstraintValueOrFirstViolation(point, 1e-6);
+
+    std::cout << "First violated linear constraint " << value.constraint->name << " with error " << value.error
+              << " (should be c1 with error 1).\n";
+
+    if(value.constraint->index != 0 || std::abs(value.error - 1.0) > 1e-12)
+        passed = false;
+
+    // Violates only c2, below its lower bound
+    point = { 0.0, 1.0 };
+    value = problem->getMaxLinearConstraintValueOrFirstViolation(point, 1e-6);
+
+    std::cout << "Violated linear constraint " << value.constraint->name << " with error " << value.error
+              << " (should be c2 with error 1).\n";
+
+    if(value.constraint->index != 1 || std::abs(value.error - 1.0) > 1e-12 || value.isFulfilledLHS)
+        passed = false;
+
+    // A chain of constraints c_k with the variables z_k and z_(k+1), given in the order c0, c2, c3, c1
+    env->settings->updateSetting("ConstraintReordering.Use", "Model", true);
+
+    SHOT::ProblemPtr chainProblem = std::make_shared<SHOT::Problem>(env);
+
+    SHOT::Variables chainVariables;
+
+    for(int i = 0; i < 5; i++)
+        chainVariables.push_back(
+            std::make_shared<SHOT::Variable>("z" + std::to_string(i), i, SHOT::E_VariableType::Real, 0.0, 1.0));
+
+    chainProblem->add(chainVariables);
+
+    auto chainObjective = std::make_shared<SHOT::LinearObjectiveFunction>(SHOT::E_ObjectiveFunctionDirection::Minimize);
+    chainObjective->add(std::make_shared<SHOT::LinearTerm>(1.0, chainVariables[0]));
+    chainProblem->add(chainObjective);
+
+    for(int k : { 0, 2, 3, 1 })
+    {
+        SHOT::LinearTerms chainTerms;
+        chainTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, chainVariables[k]));
+        chainTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, chainVariables[k + 1]));
+        chainProblem->add(std::make_shared<SHOT::LinearConstraint>(
+            0, "c" + std::to_string(k), chainTerms, SHOT_DBL_MIN, 1.0));
+    }
+
+    chainProblem->finalize();
+
+    env->settings->updateSetting("ConstraintReordering.Use", "Model", false);
+
+    // The indexes are kept, and the constraints following each other share a variable
+    for(size_t i = 0; i < chainProblem->numericConstraints.size(); i++)
+    {
+        if(chainProblem->numericConstraints[i]->index != (int)i)
+            passed = false;
+    }
+
+    std::cout << "Reordered constraints:";
+
+    for(size_t i = 0; i < chainProblem->linearConstraints.size(); i++)
+    {
+        auto& constraint = chainProblem->linearConstraints[i];
+        std::cout << " " << constraint->name;
+
+        if(i > 0)
+        {
+            auto& previous = chainProblem->linearConstraints[i - 1];
+            auto k = std::stoi(constraint->name.substr(1));
+            auto previousK = std::stoi(previous->name.substr(1));
+
+            if(std::abs(k - previousK) != 1)
+                passed = false;
+        }
+    }
+
+    std::cout << "\n";
+
+    if(chainProblem->linearConstraints.size() != 4)
+        passed = false;
+
+    return passed;
+}
+
 bool ModelTestObjective();
 bool ModelTestConstraints();
 bool ModelTestCreateProblem();
@@ -34,6 +190,15 @@ bool ModelTestCreateProblem2();
 bool ModelTestCreateProblem3();
 bool ModelTestConvexity();
 bool ModelTestCopy();
+bool ModelTestExpressionTape();
+bool ModelTestCommonSubexpressions();
+bool ModelTestQuadraticBlocks();
+bool ModelTestPresolve();
+bool ModelTestSparsityPatterns();
+bool ModelTestLinearConstraintMatrix();
+bool ModelTestAuxiliaryVariables();
+bool ModelTestCompactTermStorage();
+bool ModelTestIncrementalFBBTAfterEarlierTightening();
 
 bool TestReadProblem(const std::string& problemFile);
 bool TestRootsearch(const std::string& problemFile);
@@ -89,6 +254,63 @@ int ModelTest(int argc, char* argv[])
     case 10:
         passed = ModelTestCopy();
         break;
+    case 11:
+        passed = ModelTestExpressionTape();
+        break;
+    case 12:
+        passed = ModelTestCommonSubexpressions();
+        break;
+    case 13:
+        passed = ModelTestQuadraticBlocks();
+        break;
+    case 14:
+        passed = ModelTestPresolve();
+        break;
+    case 15:
+        passed = ModelTestSparsityPatterns();
+        break;
+    case 16:
+        passed = ModelTestLinearConstraintMatrix();
+        break;
+    case 17:
+        passed = ModelTestAuxiliaryVariables();
+        break;
+    case 18:
+        passed = ModelTestProblemBuilder();
+        break;
+    case 19:
+        passed = ModelTestSimplificationRewrites();
+        break;
+    case 20:
+        passed = ModelTestQuadraticSegmentCoefficients();
+        break;
+    case 21:
+        passed = ModelTestNonquadraticSegmentTerms();
+        break;
+    case 22:
+        passed = ModelTestSymmetryDetection();
+        break;
+    case 23:
+        passed = ModelTestIncrementalProperties();
+        break;
+    case 24:
+        passed = ModelTestPropagateVariableBounds();
+        break;
+    case 25:
+        passed = ModelTestFixedProblemReduction();
+        break;
+    case 26:
+        passed = ModelTestUnivariateFunctions();
+        break;
+    case 27:
+        passed = ModelTestBlockDecomposition();
+        break;
+    case 28:
+        passed = ModelTestCompactTermStorage();
+        break;
+    case 29:
+        passed = ModelTestIncrementalFBBTAfterEarlierTightening();
+        break;
     default:
         passed = false;
         std::cout << "Test #" << choice << " does not exist!\n";
@@ -172,6 +394,50 @@ bool ModelTestTerms()
     if(value != realValue)
         passed = false;
 
+    // x^2 + 2*w^2 - y^2 is a second-order cone since y is nonnegative, but not x^2 - w^2 - y^2
+    SHOT::VariablePtr var_w = std::make_shared<SHOT::Variable>("w", 2, SHOT::E_VariableType::Real, -5.0, 5.0);
+
+    SHOT::QuadraticTerms coneTerms;
+    coneTerms.add(std::make_shared<SHOT::QuadraticTerm>(1, var_x, var_x));
+    coneTerms.add(std::make_shared<SHOT::QuadraticTerm>(2, var_w, var_w));
+    coneTerms.add(std::make_shared<SHOT::QuadraticTerm>(-1, var_y, var_y));
+
+    SHOT::QuadraticTerms nonconvexTerms;
+    nonconvexTerms.add(std::make_shared<SHOT::QuadraticTerm>(1, var_x, var_x));
+    nonconvexTerms.add(std::make_shared<SHOT::QuadraticTerm>(-1, var_w, var_w));
+    nonconvexTerms.add(std::make_shared<SHOT::QuadraticTerm>(-1, var_y, var_y));
+
+    std::cout << "Second-order cones: " << coneTerms.isSecondOrderCone() << " and "
+              << nonconvexTerms.isSecondOrderCone() << " (should be 1 and 0).\n";
+
+    if(!coneTerms.isSecondOrderCone() || nonconvexTerms.isSecondOrderCone())
+        passed = false;
+
+    // The integer and half-integer exponents are not calculated with pow
+    for(double power : { 0.0, 1.0, 2.0, 3.0, 0.5, 1.5, -1.0, -2.0, -0.5, 0.3, 20.0 })
+    {
+        SHOT::SignomialElements elements;
+        elements.push_back(std::make_shared<SHOT::SignomialElement>(var_x, power));
+        elements.push_back(std::make_shared<SHOT::SignomialElement>(var_y, 2.0));
+
+        SHOT::SignomialTerms signomialTerms;
+        signomialTerms.add(std::make_shared<SHOT::SignomialTerm>(2.0, elements));
+
+        value = signomialTerms[0]->calculate(point2);
+        realValue = 2.0 * std::pow(point2.at(0), power) * point2.at(1) * point2.at(1);
+
+        auto gradient = signomialTerms.calculateGradient(point2);
+        double derivative = gradient[var_x];
+        double realDerivative = 2.0 * power * std::pow(point2.at(0), power - 1.0) * point2.at(1) * point2.at(1);
+
+        std::cout << "Signomial term with x^" << power << ": " << value << " (should be equal to " << realValue
+                  << "), derivative " << derivative << " (should be equal to " << realDerivative << ").\n";
+
+        if(std::abs(value - realValue) > 1e-12 * std::abs(realValue)
+            || std::abs(derivative - realDerivative) > 1e-12 * std::abs(realDerivative))
+            passed = false;
+    }
+
     return passed;
 }
 
@@ -230,159 +496,267 @@ bool ModelTestNonlinearExpressions()
     return passed;
 }
 
-bool ModelTestObjective()
+bool ModelTestExpressionTape()
 {
     bool passed = true;
 
-    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 100.0);
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.5, 10.0);
     SHOT::ExpressionVariablePtr expressionVariable_x = std::make_shared<SHOT::ExpressionVariable>(var_x);
 
-    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Integer, 0.0, 1.0);
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Real, 1.0, 4.0);
     SHOT::ExpressionVariablePtr expressionVariable_y = std::make_shared<SHOT::ExpressionVariable>(var_y);
 
-    std::cout << "Creating linear terms\n";
-    SHOT::LinearTermPtr linearTerm1 = std::make_shared<SHOT::LinearTerm>(-1, var_x);
-    SHOT::LinearTermPtr linearTerm2 = std::make_shared<SHOT::LinearTerm>(1.2, var_y);
-    SHOT::LinearTerms linearTerms;
-    linearTerms.add(linearTerm1);
-    linearTerms.add(linearTerm2);
-    std::cout << "Linear terms " << linearTerms << " created\n";
+    // exp(x) * (log(y) + x^2.5) - sqrt(y) / (x + 3) + sin(x*y)
+    SHOT::NonlinearExpressionPtr exprProduct = std::make_shared<SHOT::ExpressionProduct>(
+        std::make_shared<SHOT::ExpressionExp>(expressionVariable_x),
+        std::make_shared<SHOT::ExpressionSum>(std::make_shared<SHOT::ExpressionLog>(expressionVariable_y),
+            std::make_shared<SHOT::ExpressionPower>(
+                expressionVariable_x, std::make_shared<SHOT::ExpressionConstant>(2.5))));
 
-    std::cout << "Creating quadratic terms\n";
-    SHOT::QuadraticTermPtr quadraticTerm1 = std::make_shared<SHOT::QuadraticTerm>(1, var_x, var_y);
-    SHOT::QuadraticTermPtr quadraticTerm2 = std::make_shared<SHOT::QuadraticTerm>(2, var_x, var_x);
-    SHOT::QuadraticTerms quadraticTerms;
-    quadraticTerms.add(quadraticTerm1);
-    quadraticTerms.add(quadraticTerm2);
-    std::cout << "Quadratic terms " << quadraticTerms << " created\n";
+    SHOT::NonlinearExpressionPtr exprDivide
+        = std::make_shared<SHOT::ExpressionDivide>(std::make_shared<SHOT::ExpressionSquareRoot>(expressionVariable_y),
+            std::make_shared<SHOT::ExpressionSum>(
+                expressionVariable_x, std::make_shared<SHOT::ExpressionConstant>(3.0)));
 
-    std::cout << "Creating nonlinear expression:\n";
-    SHOT::NonlinearExpressions expressions;
-    expressions.add(expressionVariable_x);
-    expressions.add(expressionVariable_x);
-    expressions.add(expressionVariable_y);
-    SHOT::NonlinearExpressionPtr exprProduct = std::make_shared<SHOT::ExpressionProduct>(expressions);
-    std::cout << "Nonlinear expression " << exprProduct << " created\n";
+    SHOT::NonlinearExpressionPtr exprSin = std::make_shared<SHOT::ExpressionSin>(
+        std::make_shared<SHOT::ExpressionProduct>(expressionVariable_x, expressionVariable_y));
 
-    SHOT::VectorDouble point;
-    point.push_back(2.0);
-    point.push_back(3.0);
+    SHOT::NonlinearExpressionPtr expression = std::make_shared<SHOT::ExpressionSum>(
+        exprProduct, std::make_shared<SHOT::ExpressionNegate>(exprDivide), exprSin);
 
-    std::cout << "Creating objective function:\n";
-    SHOT::NonlinearObjectiveFunctionPtr nonlinearObjective = std::make_shared<SHOT::NonlinearObjectiveFunction>(
-        SHOT::E_ObjectiveFunctionDirection::Minimize, linearTerms, quadraticTerms, exprProduct, 10.0);
+    std::cout << "Compiling expression " << expression << " into tape\n";
 
-    std::cout << "Objective function " << nonlinearObjective << " created\n";
-    double objectiveValue = nonlinearObjective->calculateValue(point);
-    double realValue = nonlinearObjective->constant + linearTerm1->coefficient * point.at(0)
-        + linearTerm2->coefficient * point.at(1) + quadraticTerm1->coefficient * point.at(0) * point.at(1)
-        + +quadraticTerm2->coefficient * point.at(0) * point.at(0) + point.at(0) * point.at(0) * point.at(1);
+    SHOT::ExpressionTape tape;
 
-    std::cout << "Calculating objective value: " << objectiveValue << " (should be equal to " << realValue << ").\n";
+    if(!tape.compile(expression))
+    {
+        std::cout << "Could not compile expression into tape.\n";
+        return (false);
+    }
 
-    if(objectiveValue != realValue)
+    std::cout << "Tape with " << tape.size() << " instructions created.\n";
+
+    std::vector<SHOT::VectorDouble> points = { { 2.0, 3.0 }, { 0.5, 1.0 }, { 7.3, 2.2 }, { 1.0, 4.0 } };
+
+    for(auto& P : points)
+    {
+        double value = tape.calculate(P);
+        double realValue = expression->calculate(P);
+
+        std::cout << "Calculating tape value: " << value << " (should be equal to " << realValue << ").\n";
+
+        if(std::abs(value - realValue) > 1e-12 * std::max(1.0, std::abs(realValue)))
+            passed = false;
+    }
+
+    SHOT::PointBlock pointBlock(points);
+    SHOT::VectorDouble blockValues(points.size(), 0.0);
+    tape.calculate(pointBlock, blockValues.data());
+
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        double realValue = expression->calculate(points[i]);
+
+        std::cout << "Calculating batched tape value: " << blockValues[i] << " (should be equal to " << realValue
+                  << ").\n";
+
+        if(std::abs(blockValues[i] - realValue) > 1e-12 * std::max(1.0, std::abs(realValue)))
+            passed = false;
+    }
+
+    SHOT::PointBlockFloat singlePrecisionPointBlock(points);
+    std::vector<float> singlePrecisionValues(points.size(), 0.0f);
+    tape.calculate(singlePrecisionPointBlock, singlePrecisionValues.data());
+
+    for(size_t i = 0; i < points.size(); i++)
+    {
+        std::cout << "Calculating single precision tape value: " << singlePrecisionValues[i]
+                  << " (should be close to " << blockValues[i] << ").\n";
+
+        if(std::abs(singlePrecisionValues[i] - blockValues[i]) > 1e-4 * std::max(1.0, std::abs(blockValues[i])))
+            passed = false;
+    }
+
+    SHOT::IntervalVector intervals = { SHOT::Interval(0.5, 10.0), SHOT::Interval(1.0, 4.0) };
+
+    auto intervalValue = tape.calculate(intervals);
+    auto realIntervalValue = expression->calculate(intervals);
+
+    std::cout << "Calculating tape interval: " << intervalValue << " (should be equal to " << realIntervalValue
+              << ").\n";
+
+    if(intervalValue.l() != realIntervalValue.l() || intervalValue.u() != realIntervalValue.u())
+        passed = false;
+
+    if(tape.getVariableIndexes() != std::vector<int> { 0, 1 })
+    {
+        std::cout << "Wrong variables in tape.\n";
         passed = false;
+    }
+
+    // The gradient is compared to central differences
+    for(auto& P : points)
+    {
+        SHOT::VectorDouble derivatives;
+        tape.calculateGradient(P, derivatives);
+
+        for(size_t i = 0; i < P.size(); i++)
+        {
+            double step = 1e-6;
+            SHOT::VectorDouble forwardPoint = P;
+            SHOT::VectorDouble backwardPoint = P;
+            forwardPoint[i] += step;
+            backwardPoint[i] -= step;
+
+            double realDerivative
+                = (expression->calculate(forwardPoint) - expression->calculate(backwardPoint)) / (2.0 * step);
+
+            std::cout << "Calculating tape derivative: " << derivatives[i] << " (should be close to "
+                      << realDerivative << ").\n";
+
+            if(std::abs(derivatives[i] - realDerivative) > 1e-5 * std::max(1.0, std::abs(realDerivative)))
+                passed = false;
+        }
+    }
+
+    // The Hessian is compared to central differences of the gradient
+    for(auto& P : points)
+    {
+        SHOT::VectorDouble hessian;
+        tape.calculateHessian(P, hessian);
+
+        for(size_t i = 0; i < P.size(); i++)
+        {
+            double step = 1e-6;
+            SHOT::VectorDouble forwardPoint = P;
+            SHOT::VectorDouble backwardPoint = P;
+            forwardPoint[i] += step;
+            backwardPoint[i] -= step;
+
+            SHOT::VectorDouble forwardDerivatives;
+            SHOT::VectorDouble backwardDerivatives;
+            tape.calculateGradient(forwardPoint, forwardDerivatives);
+            tape.calculateGradient(backwardPoint, backwardDerivatives);
+
+            for(size_t j = 0; j < P.size(); j++)
+            {
+                double realDerivative = (forwardDerivatives[j] - backwardDerivatives[j]) / (2.0 * step);
+
+                std::cout << "Calculating tape second derivative: " << hessian[j * P.size() + i]
+                          << " (should be close to " << realDerivative << ").\n";
+
+                if(std::abs(hessian[j * P.size() + i] - realDerivative)
+                    > 1e-5 * std::max(1.0, std::abs(realDerivative)))
+                    passed = false;
+            }
+        }
+
+        SHOT::VectorDouble direction = { 0.3, -1.2 };
+        SHOT::VectorDouble product;
+        tape.calculateHessianVectorProduct(P, direction, product);
+
+        for(size_t i = 0; i < P.size(); i++)
+        {
+            double realProduct = hessian[i * P.size()] * direction[0] + hessian[i * P.size() + 1] * direction[1];
+
+            std::cout << "Calculating tape Hessian-vector product: " << product[i] << " (should be equal to "
+                      << realProduct << ").\n";
+
+            if(std::abs(product[i] - realProduct) > 1e-10 * std::max(1.0, std::abs(realProduct)))
+                passed = false;
+        }
+    }
 
     return passed;
 }
 
-bool ModelTestConstraints()
+bool ModelTestCommonSubexpressions()
 {
     bool passed = true;
 
-    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 100.0);
-    SHOT::ExpressionVariablePtr expressionVariable_x = std::make_shared<SHOT::ExpressionVariable>(var_x);
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.5, 10.0);
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Real, 1.0, 4.0);
 
-    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Integer, 0.0, 1.0);
-    SHOT::ExpressionVariablePtr expressionVariable_y = std::make_shared<SHOT::ExpressionVariable>(var_y);
+    // exp(x*y) + log(y) and exp(x*y) * sqrt(x), created with separate nodes for the common subexpression
+    auto createExponential = [&]() {
+        return (std::make_shared<SHOT::ExpressionExp>(
+            std::make_shared<SHOT::ExpressionProduct>(std::make_shared<SHOT::ExpressionVariable>(var_x),
+                std::make_shared<SHOT::ExpressionVariable>(var_y))));
+    };
 
-    std::cout << "Creating linear terms\n";
-    SHOT::LinearTermPtr linearTerm1 = std::make_shared<SHOT::LinearTerm>(-1, var_x);
-    SHOT::LinearTermPtr linearTerm2 = std::make_shared<SHOT::LinearTerm>(1.2, var_y);
-    SHOT::LinearTerms linearTerms;
-    linearTerms.add(linearTerm1);
-    linearTerms.add(linearTerm2);
-    std::cout << "Linear terms " << linearTerms << " created\n";
+    SHOT::NonlinearExpressionPtr expression1 = std::make_shared<SHOT::ExpressionSum>(
+        createExponential(), std::make_shared<SHOT::ExpressionLog>(std::make_shared<SHOT::ExpressionVariable>(var_y)));
 
-    std::cout << "Creating quadratic terms\n";
-    SHOT::QuadraticTermPtr quadraticTerm1 = std::make_shared<SHOT::QuadraticTerm>(1, var_x, var_y);
-    SHOT::QuadraticTermPtr quadraticTerm2 = std::make_shared<SHOT::QuadraticTerm>(2, var_x, var_x);
-    SHOT::QuadraticTerms quadraticTerms;
-    quadraticTerms.add(quadraticTerm1);
-    quadraticTerms.add(quadraticTerm2);
-    std::cout << "Quadratic terms " << quadraticTerms << " created\n";
+    SHOT::NonlinearExpressionPtr expression2 = std::make_shared<SHOT::ExpressionProduct>(createExponential(),
+        std::make_shared<SHOT::ExpressionSquareRoot>(std::make_shared<SHOT::ExpressionVariable>(var_x)));
 
-    std::cout << "Creating quadratic constraint:\n";
-    SHOT::QuadraticConstraintPtr quadraticConstraint
-        = std::make_shared<SHOT::QuadraticConstraint>(0, "quadconstr", linearTerms, quadraticTerms, -10.0, 20.0);
-    std::cout << "Quadratic constraint created\n";
+    SHOT::VectorDouble point = { 2.0, 3.0 };
+    double value1 = expression1->calculate(point);
+    double value2 = expression2->calculate(point);
 
-    SHOT::VectorDouble point;
-    point.push_back(2.0);
-    point.push_back(3.0);
+    SHOT::CommonSubexpressionTable table;
+    auto sharedExpression1 = table.share(expression1);
+    auto sharedExpression2 = table.share(expression2);
 
-    auto constraintValue = quadraticConstraint->calculateNumericValue(point);
-    double realValue = linearTerm1->coefficient * point.at(0) + linearTerm2->coefficient * point.at(1)
-        + quadraticTerm1->coefficient * point.at(0) * point.at(1)
-        + +quadraticTerm2->coefficient * point.at(0) * point.at(0);
+    std::cout << "Number of shared subexpressions: " << table.getNumberOfSharedExpressions() << "\n";
 
-    std::cout << "Calculating constraint value: " << constraintValue.functionValue << " (should be equal to "
-              << realValue << ").\n";
+    auto child1 = std::dynamic_pointer_cast<SHOT::ExpressionSum>(sharedExpression1)->children[0];
+    auto child2 = std::dynamic_pointer_cast<SHOT::ExpressionProduct>(sharedExpression2)->children[0];
 
-    if(constraintValue.functionValue != realValue)
+    if(child1 != child2)
+    {
+        std::cout << "The common subexpression " << child1 << " is not shared.\n";
         passed = false;
+    }
 
-    std::cout << "Creating nonlinear expression:\n";
-    SHOT::NonlinearExpressions expressions;
-    expressions.add(expressionVariable_x);
-    expressions.add(expressionVariable_x);
-    expressions.add(expressionVariable_y);
-    SHOT::NonlinearExpressionPtr exprProduct = std::make_shared<SHOT::ExpressionProduct>(expressions);
-    std::cout << "Nonlinear expression " << exprProduct << " created\n";
+    std::cout << "Calculating shared values: " << sharedExpression1->calculate(point) << " and "
+              << sharedExpression2->calculate(point) << " (should be equal to " << value1 << " and " << value2
+              << ").\n";
 
-    std::cout << "Creating nonlinear constraint:\n";
-    SHOT::NonlinearConstraintPtr nonlinearConstraint = std::make_shared<SHOT::NonlinearConstraint>(
-        0, "nlconstr", linearTerms, quadraticTerms, exprProduct, -10.0, 20.0);
-    std::cout << "Nonlinear constraint " << nonlinearConstraint << " created\n";
+    if(sharedExpression1->calculate(point) != value1 || sharedExpression2->calculate(point) != value2)
+        passed = false;
 
-    constraintValue = nonlinearConstraint->calculateNumericValue(point);
-    realValue = linearTerm1->coefficient * point.at(0) + linearTerm2->coefficient * point.at(1)
-        + quadraticTerm1->coefficient * point.at(0) * point.at(1)
-        + quadraticTerm2->coefficient * point.at(0) * point.at(0) + point.at(0) * point.at(0) * point.at(1);
+    // The properties of the shared subexpression are calculated once and reused for the second expression
+    auto convexity = expression2->getConvexity();
+    auto monotonicity = expression2->getMonotonicity();
+    auto bounds = expression2->getBounds();
 
-    std::cout << "Calculating nonlinear constraint value " << constraintValue.functionValue << " (should be equal to "
-              << realValue << ").\n";
+    {
+        SHOT::ExpressionPropertyCacheScope propertyCacheScope;
+        sharedExpression1->getConvexity();
 
-    if(constraintValue.functionValue != realValue)
-        passed = false;
+        std::cout << "Convexity with the property cache: " << (int)sharedExpression2->getConvexity()
+                  << " (should be " << (int)convexity << ").\n";
 
-    bool isFulfilled = nonlinearConstraint->isFulfilled(point);
+        if(sharedExpression2->getConvexity() != convexity || sharedExpression2->getMonotonicity() != monotonicity
+            || sharedExpression2->getBounds().l() != bounds.l() || sharedExpression2->getBounds().u() != bounds.u())
+            passed = false;
+    }
 
-    std::cout << "Is nonlinear constraint valid in point (x,y)=(" << point.at(0) << "," << point.at(1) << ")? ";
-    std::cout << (nonlinearConstraint->isFulfilled(point) ? "yes" : "no");
-    std::cout << ". Function value: " << nonlinearConstraint->calculateFunctionValue(point);
-    std::cout << "\n";
+    // Expressions with the same structure but other variables have the same signature
+    auto var_z = std::make_shared<SHOT::Variable>("z", 2, SHOT::E_VariableType::Real, 0.5, 10.0);
+    auto var_w = std::make_shared<SHOT::Variable>("w", 3, SHOT::E_VariableType::Real, 1.0, 4.0);
 
-    if(isFulfilled)
-        passed = false;
+    auto substitutedExpression = SHOT::copyNonlinearExpression(expression1.get());
+    SHOT::substituteVariables(substitutedExpression, { { var_x.get(), var_w }, { var_y.get(), var_z } });
 
-    point.at(0) = 1.0;
-    point.at(1) = 1.0;
+    SHOT::Variables signatureVariables1, signatureVariables2;
+    auto signature1 = SHOT::getStructuralSignature(expression1.get(), signatureVariables1);
+    auto signature2 = SHOT::getStructuralSignature(substitutedExpression.get(), signatureVariables2);
 
-    isFulfilled = nonlinearConstraint->isFulfilled(point);
+    std::cout << "Structural signatures: " << signature1 << " and " << signature2 << " (should be equal).\n";
 
-    std::cout << "Is nonlinear constraint valid in point (x,y)=(" << point.at(0) << "," << point.at(1) << ")? ";
-    std::cout << (nonlinearConstraint->isFulfilled(point) ? "yes" : "no");
-    std::cout << ". Function value: " << nonlinearConstraint->calculateFunctionValue(point);
-    std::cout << "\n";
+    if(signature1 != signature2 || signatureVariables2.size() != 2 || signatureVariables2[0] != var_w
+        || signatureVariables2[1] != var_z)
+        passed = false;
 
-    if(!isFulfilled)
+    if(substitutedExpression->calculate(SHOT::VectorDouble({ 0.0, 0.0, 3.0, 2.0 })) != value1)
         passed = false;
 
     return passed;
 }
 
-bool ModelTestCreateProblem()
+bool ModelTestQuadraticBlocks()
 {
     bool passed = true;
 
@@ -391,7 +765,366 @@ bool ModelTestCreateProblem()
     SHOT::ProblemPtr problem = std::make_shared<SHOT::Problem>(env);
     env->problem = problem;
 
-    // Creating variables
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, -10.0, 10.0);
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Real, -10.0, 10.0);
+    auto var_z = std::make_shared<SHOT::Variable>("z", 2, SHOT::E_VariableType::Real, -10.0, 10.0);
+    auto var_w = std::make_shared<SHOT::Variable>("w", 3, SHOT::E_VariableType::Real, -10.0, 10.0);
+
+    SHOT::Variables variables = { var_x, var_y, var_z, var_w };
+    problem->add(variables);
+
+    // Two blocks (x,y) and (z,w), which both have the eigenvalues 1 and 3 if the coefficient is 1
+    auto createTerms = [&](double coefficient) {
+        SHOT::QuadraticTerms terms;
+        terms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_x, var_x));
+        terms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_z, var_z));
+        terms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_x, var_y));
+        terms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_y, var_y));
+        terms.add(std::make_shared<SHOT::QuadraticTerm>(coefficient, var_z, var_w));
+        terms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_w, var_w));
+        terms.takeOwnership(problem);
+        return (terms);
+    };
+
+    for(int maxBlockSize : { 1000, 1 })
+    {
+        env->settings->updateSetting("Convexity.Quadratics.MaxDenseBlockSize", "Model", maxBlockSize);
+
+        auto convexTerms = createTerms(1.0);
+        auto nonconvexTerms = createTerms(4.0);
+
+        std::cout << "Largest block solved with eigenvalue decomposition: " << maxBlockSize << "\n";
+
+        if(convexTerms.getConvexity() != E_Convexity::Convex || nonconvexTerms.getConvexity() != E_Convexity::Nonconvex)
+        {
+            std::cout << "Wrong convexity of the quadratic terms.\n";
+            passed = false;
+        }
+
+        std::cout << "Number of eigenvalues calculated: " << convexTerms.eigenvalues.size()
+                  << ", smallest eigenvalue: " << convexTerms.minEigenValue << "\n";
+
+        if(maxBlockSize > 1
+            && (convexTerms.eigenvalues.size() != 4 || std::abs(convexTerms.minEigenValue - 1.0) > 1e-10
+                || !convexTerms.isEigenvalueDecompositionComplete))
+        {
+            std::cout << "Wrong eigenvalues of the quadratic terms.\n";
+            passed = false;
+        }
+
+        if(maxBlockSize == 1 && convexTerms.isEigenvalueDecompositionComplete)
+        {
+            std::cout << "Eigenvalues should not be calculated for the blocks.\n";
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+bool ModelTestPresolve()
+{
+    bool passed = true;
+
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    SHOT::ProblemPtr problem = std::make_shared<SHOT::Problem>(env);
+    env->problem = problem;
+
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 10.0);
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Real, 0.0, 10.0);
+    auto var_z = std::make_shared<SHOT::Variable>("z", 2, SHOT::E_VariableType::Integer, 0.0, 10.0);
+    auto var_w = std::make_shared<SHOT::Variable>("w", 3, SHOT::E_VariableType::Real, 0.0, 10.0);
+    auto var_u = std::make_shared<SHOT::Variable>("u", 4, SHOT::E_VariableType::Real, -5.0, 5.0);
+
+    SHOT::Variables variables = { var_x, var_y, var_z, var_w, var_u };
+    problem->add(variables);
+
+    auto objective = std::make_shared<SHOT::LinearObjectiveFunction>(SHOT::E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<SHOT::LinearTerm>(1.0, var_y));
+    objective->add(std::make_shared<SHOT::LinearTerm>(1.0, var_z));
+    objective->add(std::make_shared<SHOT::LinearTerm>(-1.0, var_u));
+    problem->add(objective);
+
+    // x + y <= 8 and the parallel 2x + 2y <= 10, which are merged into x + y <= 5
+    SHOT::LinearTerms firstTerms;
+    firstTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, var_x));
+    firstTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, var_y));
+    problem->add(std::make_shared<SHOT::LinearConstraint>(0, "c1", firstTerms, SHOT_DBL_MIN, 8.0));
+
+    SHOT::LinearTerms secondTerms;
+    secondTerms.add(std::make_shared<SHOT::LinearTerm>(2.0, var_y));
+    secondTerms.add(std::make_shared<SHOT::LinearTerm>(2.0, var_x));
+    problem->add(std::make_shared<SHOT::LinearConstraint>(1, "c2", secondTerms, SHOT_DBL_MIN, 10.0));
+
+    // A singleton constraint 2z >= 3, which gives the bound z >= 2
+    SHOT::LinearTerms thirdTerms;
+    thirdTerms.add(std::make_shared<SHOT::LinearTerm>(2.0, var_z));
+    problem->add(std::make_shared<SHOT::LinearConstraint>(2, "c3", thirdTerms, 3.0, SHOT_DBL_MAX));
+
+    // x^2 + w >= 1, so that x and w are not fixed
+    SHOT::QuadraticTerms quadraticTerms;
+    quadraticTerms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_x, var_x));
+    auto quadraticConstraint
+        = std::make_shared<SHOT::QuadraticConstraint>(3, "c4", quadraticTerms, 1.0, SHOT_DBL_MAX);
+    quadraticConstraint->add(std::make_shared<SHOT::LinearTerm>(1.0, var_w));
+    problem->add(quadraticConstraint);
+
+    // Now y can be fixed to zero, after which x + y <= 5 is a singleton constraint, and z and u to their bounds
+    SHOT::Presolve presolve(env, problem);
+    presolve.run();
+
+    std::cout << "Presolve removed " << presolve.numberOfRemovedConstraints << " constraints and fixed "
+              << presolve.numberOfFixedVariables << " variables.\n";
+
+    if(problem->linearConstraints.size() != 0 || problem->numericConstraints.size() != 1
+        || problem->numericConstraints[0] != quadraticConstraint || quadraticConstraint->index != 0)
+    {
+        std::cout << "The linear constraints were not removed.\n";
+        passed = false;
+    }
+
+    if(var_x->upperBound != 5.0 || var_z->lowerBound != 2.0 || var_z->upperBound != 2.0)
+    {
+        std::cout << "Wrong bounds from the singleton constraints.\n";
+        passed = false;
+    }
+
+    if(var_y->upperBound != 0.0 || var_u->lowerBound != 5.0 || var_w->lowerBound == var_w->upperBound)
+    {
+        std::cout << "Wrong dominated variables fixed.\n";
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool ModelTestSparsityPatterns()
+{
+    bool passed = true;
+
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    SHOT::ProblemPtr problem = std::make_shared<SHOT::Problem>(env);
+    env->problem = problem;
+
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 10.0);
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Real, 0.0, 10.0);
+    auto var_z = std::make_shared<SHOT::Variable>("z", 2, SHOT::E_VariableType::Real, 0.0, 10.0);
+
+    SHOT::Variables variables = { var_x, var_y, var_z };
+    problem->add(variables);
+
+    // min x^2 + z
+    auto objective = std::make_shared<SHOT::QuadraticObjectiveFunction>(SHOT::E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_x, var_x));
+    objective->add(std::make_shared<SHOT::LinearTerm>(1.0, var_z));
+    problem->add(objective);
+
+    // z + x <= 5
+    SHOT::LinearTerms linearTerms;
+    linearTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, var_z));
+    linearTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, var_x));
+    problem->add(std::make_shared<SHOT::LinearConstraint>(0, "c1", linearTerms, SHOT_DBL_MIN, 5.0));
+
+    // y * z + y >= 1
+    SHOT::QuadraticTerms quadraticTerms;
+    quadraticTerms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_z, var_y));
+    auto quadraticConstraint
+        = std::make_shared<SHOT::QuadraticConstraint>(1, "c2", quadraticTerms, 1.0, SHOT_DBL_MAX);
+    quadraticConstraint->add(std::make_shared<SHOT::LinearTerm>(1.0, var_y));
+    problem->add(quadraticConstraint);
+
+    problem->finalize();
+
+    auto& jacobian = problem->getJacobianSparsityPatternCSR();
+
+    if(jacobian.rowStarts != std::vector<int> { 0, 2, 4 } || jacobian.columns != std::vector<int> { 0, 2, 1, 2 })
+    {
+        std::cout << "Wrong Jacobian sparsity pattern.\n";
+        passed = false;
+    }
+
+    if(jacobian.rowSize(1) != quadraticConstraint->getGradientSparsityPattern()->size()
+        || *jacobian.rowBegin(1) != 1 || jacobian.rowEnd(1) != jacobian.columns.data() + 4)
+    {
+        std::cout << "Wrong row in the Jacobian sparsity pattern.\n";
+        passed = false;
+    }
+
+    auto& hessian = problem->getLagrangianHessianSparsityPatternCSR();
+
+    if(hessian.rowStarts != std::vector<int> { 0, 1, 2, 2 } || hessian.columns != std::vector<int> { 0, 2 })
+    {
+        std::cout << "Wrong Lagrangian Hessian sparsity pattern.\n";
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool ModelTestObjective()
+{
+    bool passed = true;
+
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 100.0);
+    SHOT::ExpressionVariablePtr expressionVariable_x = std::make_shared<SHOT::ExpressionVariable>(var_x);
+
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Integer, 0.0, 1.0);
+    SHOT::ExpressionVariablePtr expressionVariable_y = std::make_shared<SHOT::ExpressionVariable>(var_y);
+
+    std::cout << "Creating linear terms\n";
+    SHOT::LinearTermPtr linearTerm1 = std::make_shared<SHOT::LinearTerm>(-1, var_x);
+    SHOT::LinearTermPtr linearTerm2 = std::make_shared<SHOT::LinearTerm>(1.2, var_y);
+    SHOT::LinearTerms linearTerms;
+    linearTerms.add(linearTerm1);
+    linearTerms.add(linearTerm2);
+    std::cout << "Linear terms " << linearTerms << " created\n";
+
+    std::cout << "Creating quadratic terms\n";
+    SHOT::QuadraticTermPtr quadraticTerm1 = std::make_shared<SHOT::QuadraticTerm>(1, var_x, var_y);
+    SHOT::QuadraticTermPtr quadraticTerm2 = std::make_shared<SHOT::QuadraticTerm>(2, var_x, var_x);
+    SHOT::QuadraticTerms quadraticTerms;
+    quadraticTerms.add(quadraticTerm1);
+    quadraticTerms.add(quadraticTerm2);
+    std::cout << "Quadratic terms " << quadraticTerms << " created\n";
+
+    std::cout << "Creating nonlinear expression:\n";
+    SHOT::NonlinearExpressions expressions;
+    expressions.add(expressionVariable_x);
+    expressions.add(expressionVariable_x);
+    expressions.add(expressionVariable_y);
+    SHOT::NonlinearExpressionPtr exprProduct = std::make_shared<SHOT::ExpressionProduct>(expressions);
+    std::cout << "Nonlinear expression " << exprProduct << " created\n";
+
+    SHOT::VectorDouble point;
+    point.push_back(2.0);
+    point.push_back(3.0);
+
+    std::cout << "Creating objective function:\n";
+    SHOT::NonlinearObjectiveFunctionPtr nonlinearObjective = std::make_shared<SHOT::NonlinearObjectiveFunction>(
+        SHOT::E_ObjectiveFunctionDirection::Minimize, linearTerms, quadraticTerms, exprProduct, 10.0);
+
+    std::cout << "Objective function " << nonlinearObjective << " created\n";
+    double objectiveValue = nonlinearObjective->calculateValue(point);
+    double realValue = nonlinearObjective->constant + linearTerm1->coefficient * point.at(0)
+        + linearTerm2->coefficient * point.at(1) + quadraticTerm1->coefficient * point.at(0) * point.at(1)
+        + +quadraticTerm2->coefficient * point.at(0) * point.at(0) + point.at(0) * point.at(0) * point.at(1);
+
+    std::cout << "Calculating objective value: " << objectiveValue << " (should be equal to " << realValue << ").\n";
+
+    if(objectiveValue != realValue)
+        passed = false;
+
+    return passed;
+}
+
+bool ModelTestConstraints()
+{
+    bool passed = true;
+
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 100.0);
+    SHOT::ExpressionVariablePtr expressionVariable_x = std::make_shared<SHOT::ExpressionVariable>(var_x);
+
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Integer, 0.0, 1.0);
+    SHOT::ExpressionVariablePtr expressionVariable_y = std::make_shared<SHOT::ExpressionVariable>(var_y);
+
+    std::cout << "Creating linear terms\n";
+    SHOT::LinearTermPtr linearTerm1 = std::make_shared<SHOT::LinearTerm>(-1, var_x);
+    SHOT::LinearTermPtr linearTerm2 = std::make_shared<SHOT::LinearTerm>(1.2, var_y);
+    SHOT::LinearTerms linearTerms;
+    linearTerms.add(linearTerm1);
+    linearTerms.add(linearTerm2);
+    std::cout << "Linear terms " << linearTerms << " created\n";
+
+    std::cout << "Creating quadratic terms\n";
+    SHOT::QuadraticTermPtr quadraticTerm1 = std::make_shared<SHOT::QuadraticTerm>(1, var_x, var_y);
+    SHOT::QuadraticTermPtr quadraticTerm2 = std::make_shared<SHOT::QuadraticTerm>(2, var_x, var_x);
+    SHOT::QuadraticTerms quadraticTerms;
+    quadraticTerms.add(quadraticTerm1);
+    quadraticTerms.add(quadraticTerm2);
+    std::cout << "Quadratic terms " << quadraticTerms << " created\n";
+
+    std::cout << "Creating quadratic constraint:\n";
+    SHOT::QuadraticConstraintPtr quadraticConstraint
+        = std::make_shared<SHOT::QuadraticConstraint>(0, "quadconstr", linearTerms, quadraticTerms, -10.0, 20.0);
+    std::cout << "Quadratic constraint created\n";
+
+    SHOT::VectorDouble point;
+    point.push_back(2.0);
+    point.push_back(3.0);
+
+    auto constraintValue = quadraticConstraint->calculateNumericValue(point);
+    double realValue = linearTerm1->coefficient * point.at(0) + linearTerm2->coefficient * point.at(1)
+        + quadraticTerm1->coefficient * point.at(0) * point.at(1)
+        + +quadraticTerm2->coefficient * point.at(0) * point.at(0);
+
+    std::cout << "Calculating constraint value: " << constraintValue.functionValue << " (should be equal to "
+              << realValue << ").\n";
+
+    if(constraintValue.functionValue != realValue)
+        passed = false;
+
+    std::cout << "Creating nonlinear expression:\n";
+    SHOT::NonlinearExpressions expressions;
+    expressions.add(expressionVariable_x);
+    expressions.add(expressionVariable_x);
+    expressions.add(expressionVariable_y);
+    SHOT::NonlinearExpressionPtr exprProduct = std::make_shared<SHOT::ExpressionProduct>(expressions);
+    std::cout << "Nonlinear expression " << exprProduct << " created\n";
+
+    std::cout << "Creating nonlinear constraint:\n";
+    SHOT::NonlinearConstraintPtr nonlinearConstraint = std::make_shared<SHOT::NonlinearConstraint>(
+        0, "nlconstr", linearTerms, quadraticTerms, exprProduct, -10.0, 20.0);
+    std::cout << "Nonlinear constraint " << nonlinearConstraint << " created\n";
+
+    constraintValue = nonlinearConstraint->calculateNumericValue(point);
+    realValue = linearTerm1->coefficient * point.at(0) + linearTerm2->coefficient * point.at(1)
+        + quadraticTerm1->coefficient * point.at(0) * point.at(1)
+        + quadraticTerm2->coefficient * point.at(0) * point.at(0) + point.at(0) * point.at(0) * point.at(1);
+
+    std::cout << "Calculating nonlinear constraint value " << constraintValue.functionValue << " (should be equal to "
+              << realValue << ").\n";
+
+    if(constraintValue.functionValue != realValue)
+        passed = false;
+
+    bool isFulfilled = nonlinearConstraint->isFulfilled(point);
+
+    std::cout << "Is nonlinear constraint valid in point (x,y)=(" << point.at(0) << "," << point.at(1) << ")? ";
+    std::cout << (nonlinearConstraint->isFulfilled(point) ? "yes" : "no");
+    std::cout << ". Function value: " << nonlinearConstraint->calculateFunctionValue(point);
+    std::cout << "\n";
+
+    if(isFulfilled)
+        passed = false;
+
+    point.at(0) = 1.0;
+    point.at(1) = 1.0;
+
+    isFulfilled = nonlinearConstraint->isFulfilled(point);
+
+    std::cout << "Is nonlinear constraint valid in point (x,y)=(" << point.at(0) << "," << point.at(1) << ")? ";
+    std::cout << (nonlinearConstraint->isFulfilled(point) ? "yes" : "no");
+    std::cout << ". Function value: " << nonlinearConstraint->calculateFunctionValue(point);
+    std::cout << "\n";
+
+    if(!isFulfilled)
+        passed = false;
+
+    return passed;
+}
+
+bool ModelTestCreateProblem()
+{
+    bool passed = true;
+
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    SHOT::ProblemPtr problem = std::make_shared<SHOT::Problem>(env);
+    env->problem = problem;
+
+    // Creating variables
 
     auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 100.0);
     SHOT::ExpressionVariablePtr expressionVariable_x = std::make_shared<SHOT::ExpressionVariable>(var_x);
@@ -502,8 +1235,30 @@ bool ModelTestCreateProblem()
     std::cout << '\n';
     std::cout << "Considering point (" << point[0] << ',' << point[1] << ',' << point[2] << ')' << '\n';
 
-    std::cout << "\nJacobian sparsity pattern:\n";
-    auto jacobianSparsityPattern = problem->getConstraintsJacobianSparsityPattern();
+    std::cout << "\nChecking and projecting to the variable bounds:\n";
+
+    if(problem->areVariableBoundsFulfilled(point, 1e-6))
+    {
+        std::cout << "The value of y should not be within its bounds.\n";
+        passed = false;
+    }
+
+    // The bound vectors are updated when a bound is changed
+    problem->setVariableUpperBound(0, 1.0);
+
+    auto projectedPoint = point;
+
+    if(problem->getVariableUpperBounds()[0] != 1.0 || problem->projectToVariableBounds(projectedPoint)
+        || projectedPoint[0] != 1.0 || projectedPoint[1] != 1.0 || projectedPoint[2] != 1.0)
+    {
+        std::cout << "The point was not projected to the changed bounds.\n";
+        passed = false;
+    }
+
+    problem->setVariableUpperBound(0, 100.0);
+
+    std::cout << "\nJacobian sparsity pattern:\n";
+    auto jacobianSparsityPattern = problem->getConstraintsJacobianSparsityPattern();
 
     for(auto& E : *jacobianSparsityPattern)
     {
@@ -591,6 +1346,34 @@ bool ModelTestCreateProblem()
         std::cout << "(" + H.first.first->name << "," << H.first.second->name << "): " << H.second << '\n';
     }
 
+    std::cout << "\nComparing sparse gradients with the gradients above:\n";
+    SHOT::SparseGradient sparseGradient;
+
+    for(auto& C : problem->numericConstraints)
+    {
+        C->calculateSparseGradient(point, sparseGradient);
+        auto gradient = C->calculateGradient(point, false);
+
+        for(size_t k = 0; k < sparseGradient.size(); k++)
+        {
+            double value = 0.0;
+
+            for(auto const& G : gradient)
+            {
+                if(G.first->index == sparseGradient.indexes[k])
+                    value += G.second;
+            }
+
+            std::cout << C->name << " " << sparseGradient.indexes[k] << ": " << sparseGradient.values[k] << '\n';
+
+            if(std::abs(value - sparseGradient.values[k]) > 1.0e-10)
+            {
+                std::cout << "Sparse gradient differs, value should be " << value << '\n';
+                passed = false;
+            }
+        }
+    }
+
     SHOT::Interval X(1., 2.);
     SHOT::Interval Y(2., 3.);
     SHOT::Interval Z(3., 4.);
@@ -1185,5 +1968,843 @@ bool ModelTestCopy()
     std::cout << "Relaxed problem copy created:\n\n";
     std::cout << problemRelaxedCopy << '\n';
 
+    auto problemCopyWithoutObjective = problem->createCopy(solver->getEnvironment(), true, false, false, true);
+
+    if(problemCopyWithoutObjective->objectiveFunction->properties.classification
+            != E_ObjectiveFunctionClassification::Linear
+        || problemCopyWithoutObjective->objectiveFunction->properties.hasLinearTerms
+        || problemCopyWithoutObjective->numericConstraints.size() != problem->numericConstraints.size())
+    {
+        std::cout << "Problem copy without objective function not correct.\n";
+        passed = false;
+    }
+
     return passed;
 }
+
+bool ModelTestAuxiliaryVariables()
+{
+    bool passed = true;
+
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    SHOT::ProblemPtr problem = std::make_shared<SHOT::Problem>(env);
+    env->problem = problem;
+
+    auto var_x = std::make_shared<SHOT::Variable>("x", 0, SHOT::E_VariableType::Real, 0.0, 10.0);
+    auto var_y = std::make_shared<SHOT::Variable>("y", 1, SHOT::E_VariableType::Real, 0.0, 10.0);
+
+    SHOT::Variables variables = { var_x, var_y };
+    problem->add(variables);
+
+    // a = 2x + y and b = xy only depend on the original variables, c = a + b on both of them
+    auto var_a = std::make_shared<SHOT::AuxiliaryVariable>("a", 2, SHOT::E_VariableType::Real, 0.0, 100.0);
+    var_a->linearTerms.add(std::make_shared<SHOT::LinearTerm>(2.0, var_x));
+    var_a->linearTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, var_y));
+    problem->add(var_a);
+
+    auto var_b = std::make_shared<SHOT::AuxiliaryVariable>("b", 3, SHOT::E_VariableType::Real, 0.0, 100.0);
+    var_b->quadraticTerms.add(std::make_shared<SHOT::QuadraticTerm>(1.0, var_x, var_y));
+    problem->add(var_b);
+
+    auto var_c = std::make_shared<SHOT::AuxiliaryVariable>("c", 4, SHOT::E_VariableType::Real, 0.0, 200.0);
+    var_c->linearTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, var_a));
+    var_c->linearTerms.add(std::make_shared<SHOT::LinearTerm>(1.0, var_b));
+    problem->add(var_c);
+
+    auto objective = std::make_shared<SHOT::LinearObjectiveFunction>(SHOT::E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<SHOT::LinearTerm>(1.0, var_c));
+    problem->add(objective);
+
+    problem->properties.isReformulated = true;
+    problem->finalize();
+
+    SHOT::VectorDouble point = { 1.0, 2.0 };
+    problem->augmentAuxiliaryVariableValues(point);
+
+    SHOT::VectorDouble expectedPoint = { 1.0, 2.0, 4.0, 2.0, 6.0 };
+
+    std::cout << "Point with auxiliary variables:";
+
+    for(auto& P : point)
+        std::cout << ' ' << P;
+
+    std::cout << '\n';
+
+    if(point != expectedPoint)
+    {
+        std::cout << "Wrong auxiliary variable values.\n";
+        passed = false;
+    }
+
+    return (passed);
+}
+
+bool ModelTestProblemBuilder()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+
+    ProblemBuilder builder(env);
+
+    builder.setVariables({ 0.0, 0.0, 0.0 }, { 10.0, 5.0, 1.0 },
+        { E_VariableType::Real, E_VariableType::Integer, E_VariableType::Binary }, { "x", "y", "b" });
+
+    // c0: x + 2y <= 8, c1: x^2 + yb <= 20 and c2: exp(x) - log(1 + y) <= 100
+    builder.setConstraints({ SHOT_DBL_MIN, SHOT_DBL_MIN, SHOT_DBL_MIN }, { 8.0, 20.0, 100.0 });
+    builder.setLinearTerms({ 0, 2, 2, 2 }, { 0, 1 }, { 1.0, 2.0 });
+    builder.setQuadraticTerms({ 1, 1 }, { 0, 1 }, { 0, 2 }, { 1.0, 1.0 });
+
+    builder.setNonlinearExpressions({ 2 }, { 0, 8 },
+        { E_NonlinearExpressionTypes::Variable, E_NonlinearExpressionTypes::Exp, E_NonlinearExpressionTypes::Constant,
+            E_NonlinearExpressionTypes::Variable, E_NonlinearExpressionTypes::Sum, E_NonlinearExpressionTypes::Log,
+            E_NonlinearExpressionTypes::Negate, E_NonlinearExpressionTypes::Sum },
+        { 0.0, 0.0, 1.0, 1.0, 2.0, 0.0, 0.0, 2.0 });
+
+    builder.setObjective(E_ObjectiveFunctionDirection::Minimize, { 0, 1, 2 }, { 1.0, 1.0, 1.0 });
+
+    auto problem = builder.build("builder");
+
+    std::cout << problem << '\n';
+
+    if(problem->properties.numberOfVariables != 3 || problem->properties.numberOfLinearConstraints != 1
+        || problem->properties.numberOfQuadraticConstraints != 1
+        || problem->properties.numberOfNonlinearConstraints != 1)
+    {
+        std::cout << "The problem does not have the expected variables and constraints." << std::endl;
+        return false;
+    }
+
+    VectorDouble point = { 1.0, 2.0, 1.0 };
+
+    if(std::abs(problem->numericConstraints[0]->calculateFunctionValue(point) - 5.0) > 1e-10
+        || std::abs(problem->numericConstraints[1]->calculateFunctionValue(point) - 3.0) > 1e-10
+        || std::abs(problem->numericConstraints[2]->calculateFunctionValue(point) - (std::exp(1.0) - std::log(3.0)))
+            > 1e-10)
+    {
+        std::cout << "The constraint values are not correct." << std::endl;
+        return false;
+    }
+
+    // A sum with more arguments than on the stack
+    builder.setNonlinearExpressions({ 2 }, { 0, 2 },
+        { E_NonlinearExpressionTypes::Variable, E_NonlinearExpressionTypes::Sum }, { 0.0, 2.0 });
+
+    try
+    {
+        builder.build();
+        std::cout << "An invalid nonlinear expression was accepted." << std::endl;
+        return false;
+    }
+    catch(const Exception&)
+    {
+    }
+
+    return true;
+}
+
+bool ModelTestSimplificationRewrites()
+{
+    auto var_x = std::make_shared<Variable>("x", 0, E_VariableType::Real, 0.0, 10.0);
+    auto var_y = std::make_shared<Variable>("y", 1, E_VariableType::Real, 0.0, 10.0);
+
+    // exp(x) + 2 * x * y + 3 has nothing to simplify
+    NonlinearExpressionPtr expression = std::make_shared<ExpressionSum>(
+        std::make_shared<ExpressionExp>(std::make_shared<ExpressionVariable>(var_x)),
+        std::make_shared<ExpressionProduct>(std::make_shared<ExpressionConstant>(2.0),
+            std::make_shared<ExpressionVariable>(var_x), std::make_shared<ExpressionVariable>(var_y)),
+        std::make_shared<ExpressionConstant>(3.0));
+
+    bool isChanged = true;
+    auto simplified = simplify(expression, isChanged);
+
+    if(isChanged || simplified != expression)
+    {
+        std::cout << "An expression without simplifications is changed: " << simplified << std::endl;
+        return false;
+    }
+
+    // x + x + x * 1 is 3 * x
+    expression = std::make_shared<ExpressionSum>(std::make_shared<ExpressionVariable>(var_x),
+        std::make_shared<ExpressionVariable>(var_x),
+        std::make_shared<ExpressionProduct>(
+            std::make_shared<ExpressionVariable>(var_x), std::make_shared<ExpressionConstant>(1.0)));
+
+    simplified = simplify(expression, isChanged);
+
+    if(!isChanged)
+    {
+        std::cout << "The change of " << expression << " is not reported." << std::endl;
+        return false;
+    }
+
+    simplified = simplifyToFixedPoint(simplified);
+    simplify(simplified, isChanged);
+
+    VectorDouble point = { 2.0, 1.0 };
+
+    std::cout << "Simplified expression: " << simplified << std::endl;
+
+    if(isChanged || std::abs(simplified->calculate(point) - 6.0) > 1e-12)
+    {
+        std::cout << "The expression is not simplified to a fixed point with the same value." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ModelTestQuadraticSegmentCoefficients()
+{
+    auto var_x = std::make_shared<Variable>("x", 0, E_VariableType::Real, -10.0, 10.0);
+    auto var_y = std::make_shared<Variable>("y", 1, E_VariableType::Real, -10.0, 10.0);
+
+    // 2x^2 + 3xy - y^2
+    QuadraticTerms quadraticTerms;
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(2.0, var_x, var_x));
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(3.0, var_x, var_y));
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(-1.0, var_y, var_y));
+
+    auto constraint
+        = std::make_shared<QuadraticConstraint>(0, "q", LinearTerms(), quadraticTerms, SHOT_DBL_MIN, 0.0);
+
+    VectorDouble firstPoint = { 1.0, 2.0 };
+    VectorDouble secondPoint = { 3.0, -1.0 };
+
+    auto coefficients = constraint->calculateQuadraticSegmentCoefficients(firstPoint, secondPoint);
+
+    for(double lambda : { 0.0, 0.3, 1.0 })
+    {
+        VectorDouble point = { lambda * firstPoint[0] + (1 - lambda) * secondPoint[0],
+            lambda * firstPoint[1] + (1 - lambda) * secondPoint[1] };
+
+        double value = coefficients[0] + lambda * (coefficients[1] + lambda * coefficients[2]);
+
+        std::cout << "Value " << value << " along the segment for lambda " << lambda << std::endl;
+
+        if(std::abs(value - constraint->calculateNonaffineFunctionValue(point)) > 1e-12)
+        {
+            std::cout << "The polynomial does not give the value of the quadratic terms." << std::endl;
+            return false;
+        }
+    }
+
+    return (!constraint->hasNonquadraticTerms());
+}
+
+bool ModelTestNonquadraticSegmentTerms()
+{
+    auto var_x = std::make_shared<Variable>("x", 0, E_VariableType::Real, 0.1, 10.0);
+    auto var_y = std::make_shared<Variable>("y", 1, E_VariableType::Real, 0.1, 10.0);
+    auto var_z = std::make_shared<Variable>("z", 2, E_VariableType::Real, 0.1, 10.0);
+
+    auto constraint = std::make_shared<NonlinearConstraint>(0, "s", SHOT_DBL_MIN, 0.0);
+
+    // 3x^0.5 + y^2z^-1 - 2z^1.5 + xyz, where only x differs between the end points
+    SignomialElements elements1;
+    elements1.push_back(std::make_shared<SignomialElement>(var_x, 0.5));
+    constraint->add(std::make_shared<SignomialTerm>(3.0, elements1));
+
+    SignomialElements elements2;
+    elements2.push_back(std::make_shared<SignomialElement>(var_y, 2.0));
+    elements2.push_back(std::make_shared<SignomialElement>(var_z, -1.0));
+    constraint->add(std::make_shared<SignomialTerm>(1.0, elements2));
+
+    SignomialElements elements3;
+    elements3.push_back(std::make_shared<SignomialElement>(var_z, 1.5));
+    constraint->add(std::make_shared<SignomialTerm>(-2.0, elements3));
+
+    constraint->add(std::make_shared<MonomialTerm>(1.0, Variables({ var_x, var_y, var_z })));
+
+    VectorDouble firstPoint = { 1.0, 2.0, 4.0 };
+    VectorDouble secondPoint = { 9.0, 2.0, 4.0 };
+
+    auto terms = constraint->getNonquadraticSegmentTerms(firstPoint, secondPoint);
+
+    std::cout << "Number of terms that are not constant along the segment: " << terms.movingTerms.size()
+              << " (should be 2)." << std::endl;
+
+    if(terms.movingTerms.size() != 2 || terms.hasRemainingTerms)
+        return false;
+
+    for(double lambda : { 0.0, 0.3, 1.0 })
+    {
+        VectorDouble point = { lambda * firstPoint[0] + (1 - lambda) * secondPoint[0], 2.0, 4.0 };
+
+        double value = constraint->calculateNonquadraticSegmentValue(terms, point);
+        double realValue = constraint->calculateNonquadraticFunctionValue(point);
+
+        std::cout << "Value " << value << " along the segment for lambda " << lambda << " (should be " << realValue
+                  << ")." << std::endl;
+
+        if(std::abs(value - realValue) > 1e-12 * std::abs(realValue))
+            return false;
+    }
+
+    return true;
+}
+
+bool ModelTestSymmetryDetection()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    auto problem = std::make_shared<Problem>(env);
+    env->problem = problem;
+
+    Variables variables;
+
+    for(int i = 0; i < 5; i++)
+        variables.push_back(
+            std::make_shared<Variable>("b" + std::to_string(i), i, E_VariableType::Binary, 0.0, 1.0));
+
+    problem->add(variables);
+
+    // max b0 + b1 + b2 + b3 + 2 b4, where b0, b1 and b2 are interchangeable
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Maximize);
+
+    for(int i = 0; i < 5; i++)
+        objective->add(std::make_shared<LinearTerm>(i < 4 ? 1.0 : 2.0, variables[i]));
+
+    problem->add(objective);
+
+    // b0 + b1 + b2 + b3 <= 2
+    LinearTerms linearTerms1;
+
+    for(int i = 0; i < 4; i++)
+        linearTerms1.add(std::make_shared<LinearTerm>(1.0, variables[i]));
+
+    problem->add(std::make_shared<LinearConstraint>(0, "c1", linearTerms1, SHOT_DBL_MIN, 2.0));
+
+    // b3 + b4 <= 1
+    LinearTerms linearTerms2;
+    linearTerms2.add(std::make_shared<LinearTerm>(1.0, variables[3]));
+    linearTerms2.add(std::make_shared<LinearTerm>(1.0, variables[4]));
+    problem->add(std::make_shared<LinearConstraint>(1, "c2", linearTerms2, SHOT_DBL_MIN, 1.0));
+
+    // b0 * b1 + b1 * b2 + b0 * b2 <= 1
+    QuadraticTerms quadraticTerms;
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(1.0, variables[0], variables[1]));
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(1.0, variables[1], variables[2]));
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(1.0, variables[0], variables[2]));
+    problem->add(std::make_shared<QuadraticConstraint>(2, "c3", LinearTerms(), quadraticTerms, SHOT_DBL_MIN, 1.0));
+
+    problem->finalize();
+
+    SymmetryDetection symmetryDetection(env, problem);
+    auto groups = symmetryDetection.findInterchangeableVariables();
+
+    std::cout << "Number of groups of interchangeable variables: " << groups.size() << " (should be 1)." << std::endl;
+
+    if(groups.size() != 1 || groups[0] != VectorInteger({ 0, 1, 2 }))
+        return false;
+
+    // Not symmetric if one of the products is removed
+    quadraticTerms.erase(quadraticTerms.begin() + 2);
+    problem->quadraticConstraints[0]->quadraticTerms = quadraticTerms;
+
+    groups = SymmetryDetection(env, problem).findInterchangeableVariables();
+
+    std::cout << "Number of groups of interchangeable variables without b0 * b2: " << groups.size()
+              << " (should be 1, with b0 and b2)." << std::endl;
+
+    return (groups.size() == 1 && groups[0] == VectorInteger({ 0, 2 }));
+}
+
+bool ModelTestIncrementalProperties()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    auto problem = std::make_shared<Problem>(env);
+    env->problem = problem;
+
+    auto x = std::make_shared<Variable>("x", 0, E_VariableType::Real, 0.0, 2.0);
+    auto y = std::make_shared<Variable>("y", 1, E_VariableType::Real, 0.0, 10.0);
+    problem->add(Variables({ x, y }));
+
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<LinearTerm>(1.0, y));
+    problem->add(objective);
+
+    // x + y <= 4
+    LinearTerms linearTerms;
+    linearTerms.add(std::make_shared<LinearTerm>(1.0, x));
+    linearTerms.add(std::make_shared<LinearTerm>(1.0, y));
+    auto linearConstraint = std::make_shared<LinearConstraint>(0, "c1", linearTerms, SHOT_DBL_MIN, 4.0);
+    problem->add(linearConstraint);
+
+    // x^3 - y <= 0, which is only convex when x is nonnegative
+    LinearTerms nonlinearLinearTerms;
+    nonlinearLinearTerms.add(std::make_shared<LinearTerm>(-1.0, y));
+    auto power = std::make_shared<ExpressionPower>(
+        std::make_shared<ExpressionVariable>(x), std::make_shared<ExpressionConstant>(3.0));
+    auto nonlinearConstraint
+        = std::make_shared<NonlinearConstraint>(1, "c2", nonlinearLinearTerms, power, SHOT_DBL_MIN, 0.0);
+    problem->add(nonlinearConstraint);
+
+    problem->updateProperties();
+
+    std::cout << "Convexity of c2 with x in [0, 2]: " << (int)nonlinearConstraint->properties.convexity << std::endl;
+
+    if(nonlinearConstraint->properties.convexity != E_Convexity::Convex)
+        return false;
+
+    // Nothing has changed since the properties were updated
+    if(linearConstraint->updatePropertiesIfChanged() || nonlinearConstraint->updatePropertiesIfChanged())
+    {
+        std::cout << "The properties of unchanged constraints were updated." << std::endl;
+        return false;
+    }
+
+    // The convexity depends on the variable bounds
+    x->lowerBound = -2.0;
+
+    if(linearConstraint->updatePropertiesIfChanged() || !nonlinearConstraint->updatePropertiesIfChanged())
+    {
+        std::cout << "Only the properties of the nonlinear constraint should be updated." << std::endl;
+        return false;
+    }
+
+    std::cout << "Convexity of c2 with x in [-2, 2]: " << (int)nonlinearConstraint->properties.convexity << std::endl;
+
+    if(nonlinearConstraint->properties.convexity == E_Convexity::Convex)
+        return false;
+
+    // The monotonicity of the linear constraint changes with the coefficient
+    linearConstraint->linearTerms[0]->coefficient = -1.0;
+
+    if(!linearConstraint->updatePropertiesIfChanged())
+    {
+        std::cout << "The properties of the linear constraint were not updated after changing a coefficient."
+                  << std::endl;
+        return false;
+    }
+
+    return (linearConstraint->properties.monotonicity == E_Monotonicity::Unknown);
+}
+
+bool ModelTestPropagateVariableBounds()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    auto problem = std::make_shared<Problem>(env);
+    env->problem = problem;
+
+    auto x = std::make_shared<Variable>("x", 0, E_VariableType::Binary, 0.0, 1.0);
+    auto y = std::make_shared<Variable>("y", 1, E_VariableType::Binary, 0.0, 1.0);
+    auto z = std::make_shared<Variable>("z", 2, E_VariableType::Binary, 0.0, 1.0);
+    auto w = std::make_shared<Variable>("w", 3, E_VariableType::Real, 0.0, 1.0);
+    problem->add(Variables({ x, y, z, w }));
+
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<LinearTerm>(1.0, w));
+    problem->add(objective);
+
+    // x + y + z = 1
+    LinearTerms linearTerms1;
+    linearTerms1.add(std::make_shared<LinearTerm>(1.0, x));
+    linearTerms1.add(std::make_shared<LinearTerm>(1.0, y));
+    linearTerms1.add(std::make_shared<LinearTerm>(1.0, z));
+    problem->add(std::make_shared<LinearConstraint>(0, "c1", linearTerms1, 1.0, 1.0));
+
+    // y + w >= 0.5
+    LinearTerms linearTerms2;
+    linearTerms2.add(std::make_shared<LinearTerm>(1.0, y));
+    linearTerms2.add(std::make_shared<LinearTerm>(1.0, w));
+    problem->add(std::make_shared<LinearConstraint>(1, "c2", linearTerms2, 0.5, SHOT_DBL_MAX));
+
+    problem->finalize();
+
+    // Fixing x to one fixes y and z to zero, so that w >= 0.5
+    x->lowerBound = 1.0;
+
+    if(!problem->propagateVariableBounds({ x }, 10.0))
+    {
+        std::cout << "A conflict was found after fixing x to one." << std::endl;
+        return false;
+    }
+
+    std::cout << "Bounds after fixing x: y in [" << y->lowerBound << ", " << y->upperBound << "], z in ["
+              << z->lowerBound << ", " << z->upperBound << "], w in [" << w->lowerBound << ", " << w->upperBound
+              << "]" << std::endl;
+
+    if(y->upperBound != 0.0 || z->upperBound != 0.0 || std::abs(w->lowerBound - 0.5) > 1e-10)
+        return false;
+
+    // With w <= 0.2, y must be one, which conflicts with x being one
+    for(auto& V : { y, z, w })
+    {
+        V->lowerBound = 0.0;
+        V->upperBound = 1.0;
+    }
+
+    w->upperBound = 0.2;
+
+    if(problem->propagateVariableBounds({ x, w }, 10.0))
+    {
+        std::cout << "No conflict was found after fixing x to one with w <= 0.2." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ModelTestFixedProblemReduction()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    auto problem = std::make_shared<Problem>(env);
+    env->problem = problem;
+
+    auto b = std::make_shared<Variable>("b", 0, E_VariableType::Binary, 0.0, 1.0);
+    auto x = std::make_shared<Variable>("x", 1, E_VariableType::Real, 0.0, 10.0);
+    auto y = std::make_shared<Variable>("y", 2, E_VariableType::Real, 0.0, 10.0);
+    auto z = std::make_shared<Variable>("z", 3, E_VariableType::Real, 0.0, 10.0);
+    auto w = std::make_shared<Variable>("w", 4, E_VariableType::Real, 0.0, 5.0);
+    problem->add(Variables({ b, x, y, z, w }));
+
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<LinearTerm>(1.0, x));
+    objective->add(std::make_shared<LinearTerm>(1.0, y));
+    problem->add(objective);
+
+    // x^2 + b*y <= 10
+    LinearTerms linearTerms1;
+    QuadraticTerms quadraticTerms1;
+    quadraticTerms1.add(std::make_shared<QuadraticTerm>(1.0, x, x));
+    quadraticTerms1.add(std::make_shared<QuadraticTerm>(1.0, b, y));
+    problem->add(std::make_shared<QuadraticConstraint>(0, "c1", linearTerms1, quadraticTerms1, SHOT_DBL_MIN, 10.0));
+
+    // 2b + y <= 5
+    LinearTerms linearTerms2;
+    linearTerms2.add(std::make_shared<LinearTerm>(2.0, b));
+    linearTerms2.add(std::make_shared<LinearTerm>(1.0, y));
+    problem->add(std::make_shared<LinearConstraint>(1, "c2", linearTerms2, SHOT_DBL_MIN, 5.0));
+
+    // z + w <= 4
+    LinearTerms linearTerms3;
+    linearTerms3.add(std::make_shared<LinearTerm>(1.0, z));
+    linearTerms3.add(std::make_shared<LinearTerm>(1.0, w));
+    problem->add(std::make_shared<LinearConstraint>(2, "c3", linearTerms3, SHOT_DBL_MIN, 4.0));
+
+    // b >= 0.5
+    LinearTerms linearTerms4;
+    linearTerms4.add(std::make_shared<LinearTerm>(1.0, b));
+    problem->add(std::make_shared<LinearConstraint>(3, "c4", linearTerms4, 0.5, SHOT_DBL_MAX));
+
+    problem->finalize();
+
+    VectorDouble point = { 1.0, 1.0, 1.0, 1.0, 1.0 };
+
+    // With b = 1, c1 becomes x^2 + y <= 10, c2 the bound y <= 3, c4 is constant and the block {z, w} is removed
+    FixedProblemReduction reduction(env, problem);
+
+    if(!reduction.createReducedProblem({ 0 }, { 1.0 }, point))
+    {
+        std::cout << "The reduction with b = 1 was infeasible." << std::endl;
+        return false;
+    }
+
+    auto reducedProblem = reduction.getReducedProblem();
+
+    std::cout << "Reduced problem with b = 1:" << std::endl;
+    std::cout << reducedProblem << std::endl;
+
+    std::cout << "Removed variables: " << reduction.numberOfRemovedVariables
+              << ", removed constraints: " << reduction.numberOfRemovedConstraints << std::endl;
+
+    if(reducedProblem->allVariables.size() != 2 || reducedProblem->numericConstraints.size() != 1)
+        return false;
+
+    if(reduction.numberOfRemovedVariables != 3 || reduction.numberOfRemovedConstraints != 3)
+        return false;
+
+    if(std::abs(reducedProblem->allVariables[1]->upperBound - 3.0) > 1e-10)
+    {
+        std::cout << "The upper bound of y is " << reducedProblem->allVariables[1]->upperBound
+                  << " (should be 3)." << std::endl;
+        return false;
+    }
+
+    auto sourcePoint = reduction.getSourcePoint({ 0.5, 1.0 });
+    VectorDouble expectedPoint = { 1.0, 0.5, 1.0, 1.0, 1.0 };
+
+    for(size_t i = 0; i < expectedPoint.size(); i++)
+    {
+        if(std::abs(sourcePoint[i] - expectedPoint[i]) > 1e-10)
+        {
+            std::cout << "The value of variable " << i << " in the mapped point is " << sourcePoint[i]
+                      << " (should be " << expectedPoint[i] << ")." << std::endl;
+            return false;
+        }
+    }
+
+    // With b = 0, the constraint b >= 0.5 cannot be fulfilled
+    FixedProblemReduction infeasibleReduction(env, problem);
+
+    if(infeasibleReduction.createReducedProblem({ 0 }, { 0.0 }, point))
+    {
+        std::cout << "The reduction with b = 0 was not infeasible." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ModelTestUnivariateFunctions()
+{
+    auto x = std::make_shared<Variable>("x", 0, E_VariableType::Real, 1.0, 2.0);
+    auto y = std::make_shared<Variable>("y", 1, E_VariableType::Real, -1.0, 1.0);
+
+    auto expressionX = std::make_shared<ExpressionVariable>(x);
+    auto expressionY = std::make_shared<ExpressionVariable>(y);
+
+    auto exponential = getUnivariateFunction(std::make_shared<ExpressionExp>(expressionX));
+
+    if(!exponential || exponential->type != E_UnivariateFunctionType::Exp || exponential->variableIndex != 0)
+    {
+        std::cout << "exp(x) was not detected as a univariate function." << std::endl;
+        return false;
+    }
+
+    auto power = getUnivariateFunction(
+        std::make_shared<ExpressionPower>(expressionX, std::make_shared<ExpressionConstant>(2.5)));
+
+    if(!power || power->type != E_UnivariateFunctionType::Power || power->parameter != 2.5)
+    {
+        std::cout << "x^2.5 was not detected as a univariate function." << std::endl;
+        return false;
+    }
+
+    // Not defined on the whole domain of y
+    if(getUnivariateFunction(std::make_shared<ExpressionLog>(expressionY)))
+    {
+        std::cout << "log(y) was detected as a univariate function." << std::endl;
+        return false;
+    }
+
+    if(getUnivariateFunction(std::make_shared<ExpressionPower>(expressionY, std::make_shared<ExpressionConstant>(0.5))))
+    {
+        std::cout << "y^0.5 was detected as a univariate function." << std::endl;
+        return false;
+    }
+
+    // Not a function of a variable
+    if(getUnivariateFunction(
+           std::make_shared<ExpressionSin>(std::make_shared<ExpressionProduct>(expressionX, expressionY))))
+    {
+        std::cout << "sin(x*y) was detected as a univariate function." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ModelTestBlockDecomposition()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    auto problem = std::make_shared<Problem>(env);
+    env->problem = problem;
+
+    auto b1 = std::make_shared<Variable>("b1", 0, E_VariableType::Binary, 0.0, 1.0);
+    auto b2 = std::make_shared<Variable>("b2", 1, E_VariableType::Binary, 0.0, 1.0);
+    auto x1 = std::make_shared<Variable>("x1", 2, E_VariableType::Real, 0.0, 2.0);
+    auto x2 = std::make_shared<Variable>("x2", 3, E_VariableType::Real, 0.0, 2.0);
+    problem->add(Variables({ b1, b2, x1, x2 }));
+
+    // min x1^2 + x2^2 + b1 + b2
+    auto objective = std::make_shared<QuadraticObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<LinearTerm>(1.0, b1));
+    objective->add(std::make_shared<LinearTerm>(1.0, b2));
+    objective->add(std::make_shared<QuadraticTerm>(1.0, x1, x1));
+    objective->add(std::make_shared<QuadraticTerm>(1.0, x2, x2));
+    problem->add(objective);
+
+    // x1 + b1 >= 1
+    LinearTerms linearTerms1;
+    linearTerms1.add(std::make_shared<LinearTerm>(1.0, x1));
+    linearTerms1.add(std::make_shared<LinearTerm>(1.0, b1));
+    problem->add(std::make_shared<LinearConstraint>(0, "c1", linearTerms1, 1.0, SHOT_DBL_MAX));
+
+    // x2 + b2 >= 1
+    LinearTerms linearTerms2;
+    linearTerms2.add(std::make_shared<LinearTerm>(1.0, x2));
+    linearTerms2.add(std::make_shared<LinearTerm>(1.0, b2));
+    problem->add(std::make_shared<LinearConstraint>(1, "c2", linearTerms2, 1.0, SHOT_DBL_MAX));
+
+    // b1 + b2 <= 1
+    LinearTerms linearTerms3;
+    linearTerms3.add(std::make_shared<LinearTerm>(1.0, b1));
+    linearTerms3.add(std::make_shared<LinearTerm>(1.0, b2));
+    problem->add(std::make_shared<LinearConstraint>(2, "c3", linearTerms3, SHOT_DBL_MIN, 1.0));
+
+    problem->finalize();
+
+    // The blocks are {x1} and {x2}, linked by b1 and b2 respectively, and c3 is in the master problem
+    BlockDecomposition decomposition(env, problem);
+
+    if(!decomposition.createBlocks())
+    {
+        std::cout << "The problem was not decomposed." << std::endl;
+        return false;
+    }
+
+    std::cout << "Number of blocks: " << decomposition.blocks.size()
+              << ", master constraints: " << decomposition.masterConstraints.size() << std::endl;
+
+    if(decomposition.blocks.size() != 2 || decomposition.masterConstraints.size() != 1
+        || decomposition.masterLinearTerms.size() != 2)
+        return false;
+
+    auto& block = decomposition.blocks[0];
+
+    std::cout << "Block problem:" << std::endl;
+    std::cout << block.problem << std::endl;
+
+    if(block.sourceIndexes != VectorInteger({ 2, 0 }) || block.linkingPositions != VectorInteger({ 1 }))
+        return false;
+
+    if(block.problem->numericConstraints.size() != 1 || block.feasibilityProblem->allVariables.size() != 3)
+        return false;
+
+    // x1 = 0.5 and b1 = 0.5
+    double value = block.problem->objectiveFunction->calculateValue(VectorDouble({ 0.5, 0.5 }));
+
+    std::cout << "Block objective value: " << value << " (should be 0.25)." << std::endl;
+
+    if(std::abs(value - 0.25) > 1e-10)
+        return false;
+
+    // Two blocks are fewer than required
+    env->settings->updateSetting("Decomposition.MinimumNumberOfBlocks", "Strategy", 3);
+
+    if(decomposition.createBlocks())
+    {
+        std::cout << "The problem was decomposed into fewer blocks than required." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool ModelTestCompactTermStorage()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    env->settings->updateSetting("CompactTermStorage.Use", "Model", true);
+
+    auto problem = std::make_shared<Problem>(env);
+    env->problem = problem;
+
+    auto x = std::make_shared<Variable>("x", 0, E_VariableType::Real, -10.0, 10.0);
+    auto y = std::make_shared<Variable>("y", 1, E_VariableType::Real, -10.0, 10.0);
+    auto z = std::make_shared<Variable>("z", 2, E_VariableType::Real, -10.0, 10.0);
+    problem->add(Variables({ x, y, z }));
+
+    problem->add(std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize));
+
+    // x - y + z <= 1
+    LinearTerms linearTerms;
+    linearTerms.add(std::make_shared<LinearTerm>(1.0, x));
+    linearTerms.add(std::make_shared<LinearTerm>(-1.0, y));
+    linearTerms.add(std::make_shared<LinearTerm>(1.0, z));
+    auto linearConstraint = std::make_shared<LinearConstraint>(0, "c1", linearTerms, SHOT_DBL_MIN, 1.0);
+    problem->add(linearConstraint);
+
+    // 2x^2 - xy + 2z^2 + 0.5y <= 4
+    QuadraticTerms quadraticTerms;
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(2.0, x, x));
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(-1.0, x, y));
+    quadraticTerms.add(std::make_shared<QuadraticTerm>(2.0, z, z));
+    LinearTerms quadraticLinearTerms;
+    quadraticLinearTerms.add(std::make_shared<LinearTerm>(0.5, y));
+    auto quadraticConstraint = std::make_shared<QuadraticConstraint>(
+        1, "c2", quadraticLinearTerms, quadraticTerms, SHOT_DBL_MIN, 4.0);
+    problem->add(quadraticConstraint);
+
+    problem->finalize();
+
+    VectorDouble point = { 1.5, -2.0, 3.0 };
+
+    double linearValue = linearConstraint->calculateFunctionValue(point);
+    double quadraticValue = quadraticConstraint->calculateFunctionValue(point);
+
+    std::cout << "Linear constraint value: " << linearValue << " (should be 6.5)." << std::endl;
+    std::cout << "Quadratic constraint value: " << quadraticValue << " (should be 24.5)." << std::endl;
+
+    if(std::abs(linearValue - 6.5) > 1e-12 || std::abs(quadraticValue - 24.5) > 1e-12)
+        return false;
+
+    auto maxValue = problem->getMaxLinearConstraintValueOrFirstViolation(point, SHOT_DBL_MAX);
+
+    if(std::abs(maxValue.normalizedValue - 5.5) > 1e-12)
+    {
+        std::cout << "The linear constraints are not evaluated without the constraint matrix." << std::endl;
+        return false;
+    }
+
+    // The coefficients 1 and -1 are each stored once
+    PackedLinearTerms packedTerms;
+    packedTerms.update(linearTerms, true);
+
+    if(!packedTerms.coefficients.isCompact() || packedTerms.coefficients.dictionary.size() != 2
+        || packedTerms.calculate(point) != linearTerms.calculate(point))
+        return false;
+
+    // The coefficients are kept as they are if there are too many different ones
+    auto variable = std::make_shared<Variable>("w", 3, E_VariableType::Real, 0.0, 1.0);
+    LinearTerms manyTerms;
+
+    for(int i = 0; i < 300; i++)
+        manyTerms.push_back(std::make_shared<LinearTerm>(i + 1.0, variable));
+
+    packedTerms.update(manyTerms, true);
+
+    if(packedTerms.coefficients.isCompact() || packedTerms.size() != 300 || packedTerms.coefficients[299] != 300.0)
+        return false;
+
+    return true;
+}
+
+bool ModelTestIncrementalFBBTAfterEarlierTightening()
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+    auto problem = std::make_shared<Problem>(env);
+    env->problem = problem;
+
+    auto x = std::make_shared<Variable>("x", 0, E_VariableType::Real, 0.0, 10.0);
+    auto y = std::make_shared<Variable>("y", 1, E_VariableType::Real, 0.0, 10.0);
+    problem->add(Variables({ x, y }));
+
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<LinearTerm>(1.0, x));
+    problem->add(objective);
+
+    // y - x <= 0
+    LinearTerms linearTerms;
+    linearTerms.add(std::make_shared<LinearTerm>(1.0, y));
+    linearTerms.add(std::make_shared<LinearTerm>(-1.0, x));
+    problem->add(std::make_shared<LinearConstraint>(0, "c1", linearTerms, SHOT_DBL_MIN, 0.0));
+
+    problem->finalize();
+
+    // The bound tightening timer accumulates over the solution process, so let it build up more time than the
+    // time limit of the incremental tightening below
+    env->timing->startTimer("BoundTightening");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    env->timing->stopTimer("BoundTightening");
+
+    // The cutoff x <= 2 should give y <= 2 through the constraint
+    LinearTerms cutoffTerms;
+    cutoffTerms.add(std::make_shared<LinearTerm>(1.0, x));
+    auto cutoff = std::make_shared<LinearConstraint>(-1, "cutoff", cutoffTerms, SHOT_DBL_MIN, 2.0);
+
+    auto tightenedVariables = problem->doIncrementalFBBT(cutoff, 0.1);
+
+    std::cout << "Bounds after the incremental tightening: x in [" << x->lowerBound << ", " << x->upperBound
+              << "], y in [" << y->lowerBound << ", " << y->upperBound << "]" << std::endl;
+
+    return (tightenedVariables.size() == 2 && std::abs(x->upperBound - 2.0) < 1e-10
+        && std::abs(y->upperBound - 2.0) < 1e-10);
+}
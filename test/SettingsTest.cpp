@@ -27,6 +27,7 @@ namespace fs = std::experimental;
 using namespace SHOT;
 
 bool SettingsTestOptions(bool useOSiL);
+bool SettingsTestHandles();
 
 int SettingsTest(int argc, char* argv[])
 {
@@ -57,6 +58,11 @@ int SettingsTest(int argc, char* argv[])
         passed = SettingsTestOptions(false);
         std::cout << "Finished test to read and write opt files." << std::endl;
         break;
+    case 3:
+        std::cout << "Starting test of setting handles and change callbacks:" << std::endl;
+        passed = SettingsTestHandles();
+        std::cout << "Finished test of setting handles and change callbacks." << std::endl;
+        break;
     default:
         passed = false;
         std::cout << "Test #" << choice << " does not exist!\n";
@@ -120,4 +126,61 @@ bool SettingsTestOptions(bool useOSiL)
     }
 
     return passed;
-}
\ No newline at end of file
+}
+// Test that setting handles follow updates and that the change callbacks are called
+bool SettingsTestHandles()
+{
+    bool passed = true;
+
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+
+    auto handle = env->settings->getSettingHandle<int>("Rootsearch.MaxIterations", "Subsolver");
+
+    if(handle.get() != env->settings->getSetting<int>("Rootsearch.MaxIterations", "Subsolver"))
+    {
+        std::cout << "Setting handle does not give the same value as the setting." << std::endl;
+        passed = false;
+    }
+
+    int numberOfCallbacks = 0;
+
+    int callbackId = env->settings->addSettingChangedCallback(
+        [&numberOfCallbacks](const std::string& name, const std::string& category) {
+            if(name == "Rootsearch.MaxIterations" && category == "Subsolver")
+                numberOfCallbacks++;
+        });
+
+    int newValue = handle.get() + 1;
+    env->settings->updateSetting("Rootsearch.MaxIterations", "Subsolver", newValue);
+
+    if(handle.get() != newValue)
+    {
+        std::cout << "Setting handle not updated: " << handle.get() << " != " << newValue << std::endl;
+        passed = false;
+    }
+
+    // Setting the same value again should not trigger the callback
+    env->settings->updateSetting("Rootsearch.MaxIterations", "Subsolver", newValue);
+
+    env->settings->removeSettingChangedCallback(callbackId);
+    env->settings->updateSetting("Rootsearch.MaxIterations", "Subsolver", newValue + 1);
+
+    if(numberOfCallbacks != 1)
+    {
+        std::cout << "Setting changed callback called " << numberOfCallbacks << " times instead of once." << std::endl;
+        passed = false;
+    }
+
+    try
+    {
+        env->settings->getSettingHandle<int>("NotASetting", "Subsolver");
+        std::cout << "Handle to a nonexisting setting was returned." << std::endl;
+        passed = false;
+    }
+    catch(SettingKeyNotFoundException&)
+    {
+    }
+
+    return passed;
+}
@@ -9,11 +9,24 @@
 */
 
 #include "../src/Solver.h"
+#include "../src/SolverPortfolio.h"
+#include "../src/CancellationToken.h"
+#include "../src/DebugWriter.h"
+#include "../src/DualSolver.h"
 #include "../src/Environment.h"
+#include "../src/FixedNLPWorker.h"
+#include "../src/Metrics.h"
 #include "../src/Results.h"
+#include "../src/Settings.h"
 #include "../src/Structs.h"
 #include "../src/TaskHandler.h"
+#include "../src/Timing.h"
 #include "../src/Utilities.h"
+#include "../src/WarmStart.h"
+#include "../src/MIPSolver/IMIPSolver.h"
+#include "../src/MIPSolver/RelaxedCutPolicy.h"
+#include "../src/MIPSolver/SpatialBranching.h"
+#include "../src/Model/ProblemBuilder.h"
 #include "../src/Model/Simplifications.h"
 
 #include "../src/Model/Variables.h"
@@ -27,7 +40,15 @@
 
 #include "../src/RootsearchMethod/RootsearchMethodBoost.h"
 
+#include "../src/Tasks/TaskParallel.h"
 #include "../src/Tasks/TaskReformulateProblem.h"
+#include "../src/Tasks/TaskSelectPrimalCandidatesFromRootsearch.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
 
 using namespace SHOT;
 
@@ -97,6 +118,80 @@ bool SolveProblem(std::string filename)
     return passed;
 }
 
+bool ReadProblemSnapshot(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    if(!solver->setProblem(filename) || !solver->writeProblemSnapshot("problem.shotsnap"))
+        return (false);
+
+    auto snapshotSolver = std::make_unique<SHOT::Solver>();
+    auto snapshotEnv = snapshotSolver->getEnvironment();
+
+    if(!snapshotSolver->setProblem("problem.shotsnap"))
+        return (false);
+
+    bool passed = true;
+
+    std::vector<std::pair<ProblemPtr, ProblemPtr>> problems = { { env->problem, snapshotEnv->problem },
+        { env->reformulatedProblem, snapshotEnv->reformulatedProblem } };
+
+    for(auto& [problem, snapshotProblem] : problems)
+    {
+        if(problem->allVariables.size() != snapshotProblem->allVariables.size()
+            || problem->numericConstraints.size() != snapshotProblem->numericConstraints.size()
+            || problem->auxiliaryVariables.size() != snapshotProblem->auxiliaryVariables.size()
+            || problem->properties.convexity != snapshotProblem->properties.convexity)
+        {
+            std::cout << "The problem read from the snapshot differs in size or convexity." << std::endl;
+            passed = false;
+            continue;
+        }
+
+        VectorDouble point(problem->allVariables.size());
+
+        for(size_t i = 0; i < point.size(); i++)
+        {
+            auto& variable = problem->allVariables[i];
+            auto& snapshotVariable = snapshotProblem->allVariables[i];
+
+            if(variable->lowerBound != snapshotVariable->lowerBound
+                || variable->upperBound != snapshotVariable->upperBound)
+            {
+                std::cout << "The bounds of the variable " << variable->name << " differ." << std::endl;
+                passed = false;
+            }
+
+            point[i] = std::max(variable->lowerBound, std::min(1.0, variable->upperBound));
+        }
+
+        double value = problem->objectiveFunction->calculateValue(point);
+        double snapshotValue = snapshotProblem->objectiveFunction->calculateValue(point);
+
+        if(std::abs(value - snapshotValue) > 1e-10 * std::max(1.0, std::abs(value)))
+        {
+            std::cout << "The objective values " << value << " and " << snapshotValue << " differ." << std::endl;
+            passed = false;
+        }
+
+        for(size_t i = 0; i < problem->numericConstraints.size(); i++)
+        {
+            double constraintValue = problem->numericConstraints[i]->calculateFunctionValue(point);
+            double snapshotConstraintValue = snapshotProblem->numericConstraints[i]->calculateFunctionValue(point);
+
+            if(std::abs(constraintValue - snapshotConstraintValue) > 1e-10 * std::max(1.0, std::abs(constraintValue)))
+            {
+                std::cout << "The values of the constraint " << problem->numericConstraints[i]->name << " differ."
+                          << std::endl;
+                passed = false;
+            }
+        }
+    }
+
+    return passed;
+}
+
 bool TestRootsearch(const std::string& problemFile)
 {
     bool passed = true;
@@ -414,54 +509,2027 @@ bool CreateAndSolveProblem()
     return passed;
 }
 
-int SolverTest(int argc, char* argv[])
+bool TestMetrics(std::string filename)
 {
-    int defaultchoice = 1;
+    auto solver = std::make_unique<SHOT::Solver>();
 
-    int choice = defaultchoice;
+    if(!solver->setProblem(filename))
+        return false;
 
-    if(argc > 1)
+    solver->solveProblem();
+
+    auto metrics = solver->getMetrics();
+
+    if(!metrics)
     {
-        if(sscanf(argv[1], "%d", &choice) != 1)
+        std::cout << "No metrics available." << std::endl;
+        return false;
+    }
+
+    bool passed = true;
+
+    for(auto counter : { E_MetricsCounter::ConstraintEvaluations, E_MetricsCounter::CutsAdded,
+             E_MetricsCounter::MIPProblems, E_MetricsCounter::RootsearchCalls })
+    {
+        std::cout << Metrics::getName(counter) << ": " << metrics->getCounterValue(counter) << std::endl;
+
+        if(metrics->getCounterValue(counter) == 0)
+            passed = false;
+    }
+
+    auto histogram = metrics->getHistogramValues(E_MetricsHistogram::MIPSolveTime);
+
+    if(histogram.count != metrics->getCounterValue(E_MetricsCounter::MIPProblems))
+    {
+        std::cout << "The number of MIP solve times does not match the number of MIP problems." << std::endl;
+        passed = false;
+    }
+
+    auto prometheus = solver->getMetricsPrometheus();
+    auto json = solver->getMetricsJSON();
+
+    if(prometheus.find("shot_cuts_added_total") == std::string::npos
+        || prometheus.find("shot_mip_solve_duration_seconds_bucket{le=\"+Inf\"}") == std::string::npos)
+    {
+        std::cout << "Metrics missing in the Prometheus format:" << std::endl << prometheus << std::endl;
+        passed = false;
+    }
+
+    if(json.find("\"cuts_added\"") == std::string::npos || json.find("\"histograms\"") == std::string::npos
+        || json.find("\"model_memory_bytes\"") == std::string::npos)
+    {
+        std::cout << "Metrics missing in the JSON format:" << std::endl << json << std::endl;
+        passed = false;
+    }
+
+    if(prometheus.find("# TYPE shot_resident_memory_bytes gauge") == std::string::npos)
+    {
+        std::cout << "Memory gauges missing in the Prometheus format." << std::endl;
+        passed = false;
+    }
+
+    // The sizes of the data structures are estimated on all platforms
+    for(auto gauge : { E_MetricsGauge::ModelMemory, E_MetricsGauge::CutPoolMemory,
+             E_MetricsGauge::IterationHistoryMemory })
+    {
+        std::cout << Metrics::getName(gauge) << ": " << metrics->getGaugeValue(gauge) << std::endl;
+
+        if(metrics->getGaugeValue(gauge) == 0)
+            passed = false;
+    }
+
+#ifdef __linux__
+    if(metrics->getGaugeValue(E_MetricsGauge::PeakResidentMemory) == 0)
+    {
+        std::cout << "The peak resident memory was not sampled." << std::endl;
+        passed = false;
+    }
+#endif
+
+    return passed;
+}
+
+bool TestIterationRetention(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Iterations.Retained", "Output", 3);
+
+    if(!solver->setProblem(filename))
+        return false;
+
+    solver->solveProblem();
+
+    bool passed = true;
+    int numberOfIterations = env->results->getNumberOfIterations();
+
+    std::cout << "Number of iterations: " << numberOfIterations << ", retained: " << env->results->iterations.size()
+              << std::endl;
+
+    if(numberOfIterations <= 3 || env->results->iterations.size() != 3)
+    {
+        std::cout << "Expected more than three iterations with three of them retained." << std::endl;
+        passed = false;
+    }
+
+    auto summaries = env->results->getIterationSummaries();
+
+    if((int)summaries.size() != numberOfIterations || summaries.back().iterationNumber != numberOfIterations)
+    {
+        std::cout << "Expected a summary for each iteration." << std::endl;
+        passed = false;
+    }
+
+    if(env->results->getIteration(1) != nullptr
+        || env->results->getIteration(numberOfIterations) != env->results->getCurrentIteration())
+    {
+        std::cout << "The retained iterations are not the last ones." << std::endl;
+        passed = false;
+    }
+
+    // Only the current and previous iteration keep the point data
+    if(env->results->iterations.front()->hyperplanePoints.size() > 0)
+    {
+        std::cout << "Point data kept for an older iteration." << std::endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool TestWriteResults(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    if(!solver->setProblem(filename))
+        return false;
+
+    solver->solveProblem();
+
+    bool passed = true;
+
+    if(!solver->writeResultsOSrL("result.osrl") || !solver->writeResultsTrace("result.trc")
+        || !solver->writeResultsSol("result.sol"))
+    {
+        std::cout << "Could not write the result files." << std::endl;
+        return false;
+    }
+
+    if(Utilities::getFileAsString("result.osrl") != solver->getResultsOSrL()
+        || Utilities::getFileAsString("result.sol") != solver->getResultsSol())
+    {
+        std::cout << "The written results differ from the returned ones." << std::endl;
+        passed = false;
+    }
+
+    // The trace contains the time when it was created, so only the start is compared
+    std::string trace = Utilities::getFileAsString("result.trc");
+
+    if(trace.substr(0, trace.find(',', env->problem->name.size() + 1)) != env->problem->name + ",MINLP")
+    {
+        std::cout << "Unexpected start of trace: " << trace << std::endl;
+        passed = false;
+    }
+
+    tinyxml2::XMLDocument osrlDocument;
+
+    if(osrlDocument.Parse(solver->getResultsOSrL().c_str()) != tinyxml2::XML_SUCCESS)
+    {
+        std::cout << "The OSrL is not valid XML." << std::endl;
+        return false;
+    }
+
+    auto optimizationNode = osrlDocument.FirstChildElement("osrl")->FirstChildElement("optimization");
+    auto variablesNode = optimizationNode->FirstChildElement("solution")
+                             ->FirstChildElement("variables")
+                             ->FirstChildElement("values");
+
+    if(variablesNode->IntAttribute("numberOfVar") != env->problem->properties.numberOfVariables
+        || optimizationNode->FirstChildElement("solution")->LastChildElement()->Name() != std::string("status"))
+    {
+        std::cout << "Unexpected structure of the OSrL." << std::endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool TestUpdateProblemData(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    if(!solver->setProblem(filename))
+        return false;
+
+    if(!solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    double firstObjective = solver->getPrimalBound();
+    auto firstSolution = solver->getPrimalSolution().point;
+
+    // Solving again without changes should give the same objective value
+    if(!solver->updateProblemData(SHOT::ProblemDataUpdate()) || !solver->solveProblem()
+        || !solver->hasPrimalSolution())
+    {
+        std::cout << "Could not solve the problem again." << std::endl;
+        return false;
+    }
+
+    bool passed = true;
+    double tolerance = 1e-2 * std::max(1.0, std::abs(firstObjective));
+
+    std::cout << "Objective values: " << firstObjective << " and " << solver->getPrimalBound() << std::endl;
+
+    if(std::abs(solver->getPrimalBound() - firstObjective) > tolerance)
+    {
+        std::cout << "The objective value differs after solving again." << std::endl;
+        passed = false;
+    }
+
+    // Moves the upper bound of a variable below its value in the first solution
+    int index = -1;
+
+    for(auto& V : env->problem->allVariables)
+    {
+        if(firstSolution[V->index] - V->lowerBound > 1e-3 && V->lowerBound > SHOT_DBL_MIN)
         {
-            printf("Couldn't parse that input as a number\n");
-            return -1;
+            index = V->index;
+            break;
+        }
+    }
+
+    if(index == -1)
+        return passed;
+
+    double newUpperBound = (firstSolution[index] + env->problem->allVariables[index]->lowerBound) / 2.0;
+
+    if(env->problem->allVariables[index]->properties.type != SHOT::E_VariableType::Real)
+        newUpperBound = std::floor(newUpperBound);
+
+    SHOT::ProblemDataUpdate update;
+    update.variableBounds.emplace_back(index, env->problem->allVariables[index]->lowerBound, newUpperBound);
+
+    if(!solver->updateProblemData(update) || !solver->solveProblem())
+    {
+        std::cout << "Could not solve the problem after updating a variable bound." << std::endl;
+        return false;
+    }
+
+    std::cout << "Objective value with the upper bound of variable " << index << " changed to " << newUpperBound
+              << ": " << solver->getPrimalBound() << std::endl;
+
+    if(solver->hasPrimalSolution())
+    {
+        bool isMinimize = env->problem->objectiveFunction->properties.isMinimize;
+
+        if(solver->getPrimalSolution().point[index] > newUpperBound + 1e-6)
+        {
+            std::cout << "The solution does not fulfill the updated bound." << std::endl;
+            passed = false;
+        }
+
+        if((isMinimize && solver->getPrimalBound() < firstObjective - tolerance)
+            || (!isMinimize && solver->getPrimalBound() > firstObjective + tolerance))
+        {
+            std::cout << "The objective value improved although the problem was restricted." << std::endl;
+            passed = false;
         }
     }
 
+    return passed;
+}
+
+bool TestUpdateConstraintBounds()
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    auto problem = std::make_shared<SHOT::Problem>(env);
+    problem->name = "updatebounds";
+
+    auto x = std::make_shared<Variable>("x", 0, E_VariableType::Real, 0.0, 10.0);
+    auto y = std::make_shared<Variable>("y", 1, E_VariableType::Real, 0.0, 10.0);
+    problem->add({ x, y });
+
+    auto objective = std::make_shared<LinearObjectiveFunction>(E_ObjectiveFunctionDirection::Minimize);
+    objective->add(std::make_shared<LinearTerm>(1.0, x));
+    objective->add(std::make_shared<LinearTerm>(1.0, y));
+    problem->add(objective);
+
+    // c0: x + y >= 2 is standardized as -x - y <= -2
+    auto c0 = std::make_shared<LinearConstraint>(0, "c0", 2.0, SHOT_DBL_MAX);
+    c0->add(std::make_shared<LinearTerm>(1.0, x));
+    c0->add(std::make_shared<LinearTerm>(1.0, y));
+    problem->add(c0);
+
+    // c1: 1 <= exp(x) + y <= 50 is split into exp(x) + y <= 50 and -exp(x) - y <= -1
+    auto c1 = std::make_shared<NonlinearConstraint>(1, "c1", 1.0, 50.0);
+    c1->add(std::make_shared<LinearTerm>(1.0, y));
+    c1->add(std::make_shared<ExpressionExp>(std::make_shared<ExpressionVariable>(x)));
+    problem->add(c1);
+
+    problem->updateProperties();
+    problem->finalize();
+
+    if(!solver->setProblem(problem))
+        return false;
+
+    size_t numberOfConstraints = env->problem->numericConstraints.size();
+
+    auto isFeasible = [&](const VectorDouble& point) {
+        return (std::all_of(env->problem->numericConstraints.begin(), env->problem->numericConstraints.end(),
+            [&](auto& C) { return (C->calculateNumericValue(point).isFulfilled); }));
+    };
+
+    SHOT::ProblemDataUpdate update;
+    update.constraintBounds.emplace_back(0, 3.0, SHOT_DBL_MAX);
+    update.constraintBounds.emplace_back(1, 5.0, 20.0);
+
     bool passed = true;
 
-    switch(choice)
+    // Updating twice with the same bounds should give the same constraints
+    for(int i = 0; i < 2; i++)
     {
-    case 1:
-        std::cout << "Starting test to read OSiL files:" << std::endl;
-        passed = ReadProblem("data/tls2.osil");
-        std::cout << "Finished test to read OSiL files." << std::endl;
-        break;
-    case 2:
-        std::cout << "Starting test to read NL files:" << std::endl;
-        passed = ReadProblem("data/tls2.nl");
-        std::cout << "Finished test to read NL files." << std::endl;
-        break;
-    case 3:
-        std::cout << "Starting test to solve a MINLP problem in OSiL syntax:" << std::endl;
-        passed = SolveProblem("data/tls2.osil");
-        std::cout << "Finished test to solve a MINLP problem in OSiL syntax." << std::endl;
-        break;
-    case 4:
-        std::cout << "Starting test to evaluate gradients in OSiL file:" << std::endl;
-        passed = TestGradient("data/flay02h.osil");
-        std::cout << "Finished test to evaluate gradients in OSiL file." << std::endl;
-        break;
-    case 5:
-        std::cout << "Starting test solving model using SHOT API:" << std::endl;
-        passed = CreateAndSolveProblem();
-        std::cout << "Finished test solving model using SHOT API." << std::endl;
-        break;
-    case 6:
-        std::cout << "Starting test to read OSiL file with semicont. variables:" << std::endl;
-        passed = ReadProblem("data/meanvarxsc.osil");
-        std::cout << "Finished test to read OSiL file with semicont. variables." << std::endl;
+        if(!solver->updateProblemData(update))
+        {
+            std::cout << "Could not update the constraint bounds." << std::endl;
+            return false;
+        }
+
+        if(env->problem->numericConstraints.size() != numberOfConstraints)
+        {
+            std::cout << "The number of constraints changed from " << numberOfConstraints << " to "
+                      << env->problem->numericConstraints.size() << " when updating the bounds." << std::endl;
+            passed = false;
+        }
+
+        // The points fulfill 3 <= x + y and 5 <= exp(x) + y <= 20 except for the violated bound given
+        if(!isFeasible({ 0.0, 4.5 }) || !isFeasible({ 1.5, 2.0 }))
+        {
+            std::cout << "A point fulfilling the updated bounds is infeasible." << std::endl;
+            passed = false;
+        }
+
+        if(isFeasible({ 2.0, 0.5 }) || isFeasible({ 0.0, 3.5 }) || isFeasible({ 2.5, 9.0 }))
+        {
+            std::cout << "A point violating the updated bounds is feasible." << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+bool TestWarmStart(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    solver->updateSetting("HyperplaneCuts.SaveHyperplanePoints", "Dual", true);
+
+    if(!solver->setProblem(filename) || !solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    double firstObjective = solver->getPrimalBound();
+    int firstNumberOfIterations = solver->getEnvironment()->results->getNumberOfIterations();
+
+    auto warmStart = solver->getWarmStart();
+
+    std::cout << "Warm start with " << warmStart->cuts.size() << " cuts, " << warmStart->interiorPoints.size()
+              << " interior points and " << warmStart->primalSolutions.size() << " primal solutions." << std::endl;
+
+    if(warmStart->cuts.size() == 0 || warmStart->primalSolutions.size() == 0)
+    {
+        std::cout << "No cuts or primal solutions in the warm start." << std::endl;
+        return false;
+    }
+
+    if(!warmStart->write("warmstart.shotwarm"))
+        return false;
+
+    auto warmSolver = std::make_unique<SHOT::Solver>();
+    auto readWarmStart = std::make_shared<SHOT::WarmStart>(warmSolver->getEnvironment());
+
+    if(!readWarmStart->read("warmstart.shotwarm"))
+        return false;
+
+    bool passed = true;
+
+    if(readWarmStart->cuts.size() != warmStart->cuts.size()
+        || readWarmStart->cuts.back().point != warmStart->cuts.back().point
+        || readWarmStart->primalSolutions.front() != warmStart->primalSolutions.front())
+    {
+        std::cout << "The warm start read differs from the one written." << std::endl;
+        passed = false;
+    }
+
+    if(!warmSolver->setProblem(filename))
+        return false;
+
+    warmSolver->setWarmStart(readWarmStart);
+
+    if(!warmSolver->solveProblem() || !warmSolver->hasPrimalSolution())
+        return false;
+
+    int numberOfIterations = warmSolver->getEnvironment()->results->getNumberOfIterations();
+
+    std::cout << "Objective values: " << firstObjective << " and " << warmSolver->getPrimalBound()
+              << ", iterations: " << firstNumberOfIterations << " and " << numberOfIterations << std::endl;
+
+    if(std::abs(warmSolver->getPrimalBound() - firstObjective) > 1e-2 * std::max(1.0, std::abs(firstObjective)))
+    {
+        std::cout << "The objective value differs with the warm start." << std::endl;
+        passed = false;
+    }
+
+    if(numberOfIterations > firstNumberOfIterations)
+    {
+        std::cout << "More iterations needed with the warm start." << std::endl;
+        passed = false;
+    }
+
+    // The points of the cuts are only kept in the cut store file, which can also be read as a warm start
+    auto storeSolver = std::make_unique<SHOT::Solver>();
+    storeSolver->updateSetting("HyperplaneCuts.DiskStore.File", "Dual", std::string("warmstart.shotcuts"));
+
+    if(!storeSolver->setProblem(filename) || !storeSolver->solveProblem())
+        return false;
+
+    auto storeWarmStart = storeSolver->getWarmStart();
+    auto readStoreWarmStart = std::make_shared<SHOT::WarmStart>(storeSolver->getEnvironment());
+
+    if(!readStoreWarmStart->read("warmstart.shotcuts"))
+        return false;
+
+    std::cout << "Cut store with " << readStoreWarmStart->cuts.size() << " cuts." << std::endl;
+
+    if(storeWarmStart->cuts.size() == 0 || readStoreWarmStart->cuts.size() < storeWarmStart->cuts.size()
+        || std::none_of(readStoreWarmStart->cuts.begin(), readStoreWarmStart->cuts.end(),
+            [&](const SHOT::WarmStart::Cut& C) { return (C.point == storeWarmStart->cuts.back().point); }))
+    {
+        std::cout << "The cuts in the cut store differ from the generated ones." << std::endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool TestTypedEvents(std::string filename, bool useAsynchronous)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+    solver->updateSetting("Events.Asynchronous", "Output", useAsynchronous);
+
+    if(!solver->setProblem(filename))
+        return false;
+
+    std::vector<double> objectiveValues;
+    std::vector<int> iterationNumbers;
+    bool isCalledFromOtherThread = false;
+    auto solverThread = std::this_thread::get_id();
+
+    solver->registerCallback(E_EventType::NewPrimalSolution, [&](const PrimalSolution& solution) {
+        objectiveValues.push_back(solution.objValue);
+        isCalledFromOtherThread = isCalledFromOtherThread || std::this_thread::get_id() != solverThread;
+    });
+
+    solver->registerCallback(E_EventType::IterationFinished,
+        [&](const IterationSummary& summary) { iterationNumbers.push_back(summary.iterationNumber); });
+
+    if(!solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    std::cout << "Received " << objectiveValues.size() << " primal solutions and " << iterationNumbers.size()
+              << " finished iterations." << std::endl;
+
+    bool passed = true;
+
+    double primalBound = solver->getPrimalBound();
+
+    if(std::none_of(objectiveValues.begin(), objectiveValues.end(),
+           [&](double V) { return (std::abs(V - primalBound) < 1e-6 * std::max(1.0, std::abs(primalBound))); }))
+    {
+        std::cout << "The best primal solution was not received." << std::endl;
+        passed = false;
+    }
+
+    if(iterationNumbers.empty() || iterationNumbers.back() > solver->getEnvironment()->results->getNumberOfIterations()
+        || !std::is_sorted(iterationNumbers.begin(), iterationNumbers.end()))
+    {
+        std::cout << "The finished iterations were not received in order." << std::endl;
+        passed = false;
+    }
+
+    if(isCalledFromOtherThread != useAsynchronous)
+    {
+        std::cout << "The callbacks were not called from the expected thread." << std::endl;
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool TestPortfolio(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    if(!solver->setProblem(filename) || !solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    double objective = solver->getPrimalBound();
+
+    SolverPortfolio portfolio;
+    portfolio.addConfiguration("ESH", "Dual.CutStrategy = 0\n");
+    portfolio.addConfiguration("ECP", "Dual.CutStrategy = 1\n");
+
+    if(!portfolio.setProblem(filename) || !portfolio.solveProblem())
+        return false;
+
+    auto& bestSolver = portfolio.getBestSolver();
+
+    std::cout << "Objective values: " << objective << " and " << bestSolver.getPrimalBound() << " with configuration "
+              << portfolio.getConfigurationName(portfolio.getBestConfiguration()) << std::endl;
+
+    if(!bestSolver.hasPrimalSolution()
+        || std::abs(bestSolver.getPrimalBound() - objective) > 1e-2 * std::max(1.0, std::abs(objective)))
+    {
+        std::cout << "The portfolio did not find the same objective value." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestConstraintBlocks(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    if(!solver->setProblem(filename) || !solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    double objective = solver->getPrimalBound();
+
+    solver = std::make_unique<SHOT::Solver>();
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+    solver->updateSetting("ESH.Rootsearch.Blocks.Use", "Dual", true);
+    solver->updateSetting("ESH.Rootsearch.Blocks.LinkingVariableThreshold", "Dual", 1);
+
+    if(!solver->setProblem(filename))
+        return false;
+
+    auto problem = solver->getEnvironment()->reformulatedProblem;
+
+    // With a threshold of one, every variable in several constraints is a linking variable
+    auto blocks = problem->getNonlinearConstraintBlocks(1);
+
+    std::cout << "Number of blocks: " << blocks.size() << " with " << problem->nonlinearConstraints.size()
+              << " nonlinear constraints" << std::endl;
+
+    if(blocks.size() != problem->nonlinearConstraints.size() || blocks.size() < 2)
+        return false;
+
+    for(auto& B : blocks)
+    {
+        for(size_t k = 1; k < B.variables.size(); k++)
+        {
+            if(B.variables[k - 1]->index >= B.variables[k]->index)
+            {
+                std::cout << "The variables of a block are not sorted." << std::endl;
+                return false;
+            }
+        }
+    }
+
+    if(problem->getNonlinearConstraintBlocks(0).size() != 1)
+    {
+        std::cout << "The nonlinear constraints should form one block without linking variables." << std::endl;
+        return false;
+    }
+
+    if(!solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    std::cout << "Objective values: " << objective << " and " << solver->getPrimalBound() << std::endl;
+
+    if(std::abs(solver->getPrimalBound() - objective) > 1e-2 * std::max(1.0, std::abs(objective)))
+    {
+        std::cout << "The root searches in blocks did not give the same objective value." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestRemoteFixedNLP(std::string filename)
+{
+    auto workerSolver = std::make_unique<SHOT::Solver>();
+    workerSolver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    if(!workerSolver->setProblem(filename))
+        return false;
+
+    FixedNLPWorker worker(workerSolver->getEnvironment());
+
+    if(!worker.listen(0))
+        return false;
+
+    std::thread workerThread([&worker] { worker.serve(); });
+
+    auto solver = std::make_unique<SHOT::Solver>();
+    solver->updateSetting("FixedInteger.RemoteWorkers", "Primal", "localhost:" + std::to_string(worker.getPort()));
+    solver->updateSetting("FixedInteger.Frequency.Iteration", "Primal", 1);
+
+    bool passed = solver->setProblem(filename) && solver->solveProblem() && solver->hasPrimalSolution();
+
+    worker.stop();
+    workerThread.join();
+
+    if(!passed)
+        return false;
+
+    std::cout << "Objective value: " << solver->getPrimalBound() << ", fixed NLP problems solved by the worker: "
+              << worker.getNumberOfSolvedProblems() << std::endl;
+
+    return (worker.getNumberOfSolvedProblems() > 0);
+}
+
+bool TestSolutionPool(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    solver->updateSetting("SaveNumberOfSolutions", "Output", 5);
+
+    if(!solver->setProblem(filename))
+        return false;
+
+    // The pool and progress are polled from another thread while the problem is solved
+    std::atomic<bool> isSolved(false);
+    std::atomic<bool> isPollingConsistent(true);
+
+    std::thread pollingThread([&]() {
+        uint64_t previousGeneration = 0;
+
+        while(!isSolved)
+        {
+            auto view = solver->getPrimalSolutionsView();
+            auto progress = solver->getProgress();
+
+            if(view.getGeneration() < previousGeneration || progress.primalSolutionsGeneration < view.getGeneration())
+                isPollingConsistent = false;
+
+            previousGeneration = view.getGeneration();
+
+            for(size_t i = 0; i < view.size(); i++)
+            {
+                if(view[i].point.empty())
+                    isPollingConsistent = false;
+            }
+
+            std::this_thread::yield();
+        }
+    });
+
+    bool isSolvedWithSolution = solver->solveProblem() && solver->hasPrimalSolution();
+
+    isSolved = true;
+    pollingThread.join();
+
+    if(!isSolvedWithSolution)
+        return false;
+
+    if(!isPollingConsistent)
+    {
+        std::cout << "The solution pool views or progress were inconsistent while solving." << std::endl;
+        return false;
+    }
+
+    auto solutions = solver->getPrimalSolutions();
+    auto view = solver->getPrimalSolutionsView();
+    auto progress = solver->getProgress();
+
+    if(view.size() != solutions.size() || view[0].point != solutions[0].point
+        || progress.numberOfPrimalSolutions != (int)solutions.size()
+        || progress.primalSolutionsGeneration != view.getGeneration()
+        || progress.primalBound != solver->getPrimalBound()
+        || progress.terminationReason != solver->getTerminationReason())
+    {
+        std::cout << "The solution pool view or progress differs from the results." << std::endl;
+        return false;
+    }
+    bool isMinimize = solver->getEnvironment()->problem->objectiveFunction->properties.isMinimize;
+
+    std::cout << "Number of solutions in the pool: " << solutions.size() << std::endl;
+
+    if(solutions.size() > 5 || solutions[0].objValue != solver->getPrimalBound())
+        return false;
+
+    for(size_t i = 1; i < solutions.size(); i++)
+    {
+        if((isMinimize && solutions[i].objValue < solutions[i - 1].objValue)
+            || (!isMinimize && solutions[i].objValue > solutions[i - 1].objValue))
+        {
+            std::cout << "The solution pool is not sorted." << std::endl;
+            return false;
+        }
+
+        for(size_t j = 0; j < i; j++)
+        {
+            if(solutions[i].point == solutions[j].point)
+            {
+                std::cout << "The same solution is saved twice in the solution pool." << std::endl;
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+bool TestSharedSettings()
+{
+    auto firstSolver = std::make_unique<SHOT::Solver>();
+    auto firstSettings = firstSolver->getEnvironment()->settings;
+
+    int defaultValue = firstSettings->getSetting<int>("Relaxation.IterationLimit", "Dual");
+    firstSettings->updateSetting("Relaxation.IterationLimit", "Dual", defaultValue + 1);
+
+    // The second solver gets its settings from the default settings created when the first solver was created
+    auto secondSolver = std::make_unique<SHOT::Solver>();
+    auto secondSettings = secondSolver->getEnvironment()->settings;
+
+    if(secondSettings->getNumberOfSettings() != firstSettings->getNumberOfSettings()
+        || secondSettings->getSetting<int>("Relaxation.IterationLimit", "Dual") != defaultValue
+        || secondSettings->getChangedSettings().size() != 0 || firstSettings->getChangedSettings().size() != 1)
+    {
+        std::cout << "The settings of the solvers are not independent." << std::endl;
+        return false;
+    }
+
+    secondSettings->createSetting("Test.Value", "Output", 1, "A setting only created in the second solver");
+
+    if(firstSettings->getNumberOfSettings() == secondSettings->getNumberOfSettings()
+        || firstSettings->getSettingDescription("Relaxation.IterationLimit", "Dual")
+            != secondSettings->getSettingDescription("Relaxation.IterationLimit", "Dual"))
+    {
+        std::cout << "The setting definitions were changed in the wrong solver." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestCheckpoint(std::string filename)
+{
+    // A checkpoint is written in every iteration of the stopped run
+    auto stoppedSolver = std::make_unique<SHOT::Solver>();
+    stoppedSolver->updateSetting("Checkpoint.File", "Output", std::string("checkpoint.shotwarm"));
+    stoppedSolver->updateSetting("Checkpoint.Frequency.Time", "Output", 0.0);
+    stoppedSolver->updateSetting("IterationLimit", "Termination", 5);
+
+    if(!stoppedSolver->setProblem(filename) || !stoppedSolver->solveProblem())
+        return false;
+
+    auto resumedSolver = std::make_unique<SHOT::Solver>();
+    auto checkpoint = std::make_shared<SHOT::WarmStart>(resumedSolver->getEnvironment());
+
+    if(!checkpoint->read("checkpoint.shotwarm"))
+        return false;
+
+    std::cout << "Checkpoint with " << checkpoint->cuts.size() << " cuts, " << checkpoint->integerCuts.size()
+              << " integer cuts and " << checkpoint->primalSolutions.size() << " primal solutions." << std::endl;
+
+    if(!checkpoint->isCheckpoint || checkpoint->cuts.size() == 0
+        || (int)checkpoint->variableLowerBounds.size() != checkpoint->numberOfVariables
+        || (int)checkpoint->variableUpperBounds.size() != checkpoint->numberOfVariables)
+    {
+        std::cout << "The checkpoint is not complete." << std::endl;
+        return false;
+    }
+
+    if(!resumedSolver->setProblem(filename))
+        return false;
+
+    resumedSolver->setWarmStart(checkpoint);
+
+    if(!resumedSolver->solveProblem() || !resumedSolver->hasPrimalSolution())
+        return false;
+
+    auto solver = std::make_unique<SHOT::Solver>();
+
+    if(!solver->setProblem(filename) || !solver->solveProblem())
+        return false;
+
+    std::cout << "Objective values: " << solver->getPrimalBound() << " and " << resumedSolver->getPrimalBound()
+              << " when resumed." << std::endl;
+
+    if(std::abs(resumedSolver->getPrimalBound() - solver->getPrimalBound())
+        > 1e-2 * std::max(1.0, std::abs(solver->getPrimalBound())))
+    {
+        std::cout << "The objective value differs when resumed." << std::endl;
+        return false;
+    }
+
+    // The statistics of the stopped run are included
+    if(resumedSolver->getEnvironment()->solutionStatistics.getNumberOfTotalDualProblems()
+        <= stoppedSolver->getEnvironment()->solutionStatistics.getNumberOfTotalDualProblems())
+    {
+        std::cout << "The statistics of the stopped run are not included when resumed." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestPrimalSolutionHint(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+
+    if(!solver->setProblem(filename) || !solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    VectorString variableNames;
+
+    for(auto& V : solver->getOriginalProblem()->allVariables)
+        variableNames.push_back(V->name);
+
+    Utilities::saveVariablePointVectorToFile(solver->getPrimalSolution().point, variableNames, "hint.txt");
+    std::vector<std::string> hintFiles = { "hint.txt" };
+
+#ifdef HAS_AMPL
+    // The sol file is written with the options header of AMPL
+    if(!solver->writeResultsSol("hint.sol"))
+        return false;
+
+    hintFiles.push_back("hint.sol");
+#endif
+
+    for(auto& hintFile : hintFiles)
+    {
+        auto hintSolver = std::make_unique<SHOT::Solver>();
+
+        if(!hintSolver->setProblem(filename) || !hintSolver->readPrimalSolutionHint(hintFile))
+            return false;
+
+        std::vector<E_PrimalSolutionSource> sources;
+
+        hintSolver->registerCallback(E_EventType::NewPrimalSolution,
+            [&](const PrimalSolution& solution) { sources.push_back(solution.sourceType); });
+
+        if(!hintSolver->solveProblem() || !hintSolver->hasPrimalSolution())
+            return false;
+
+        std::cout << "Objective values: " << solver->getPrimalBound() << " and " << hintSolver->getPrimalBound()
+                  << " with the hint in " << hintFile << "." << std::endl;
+
+        if(sources.size() == 0 || sources.front() != E_PrimalSolutionSource::WarmStart)
+        {
+            std::cout << "The hint is not the first primal solution." << std::endl;
+            return false;
+        }
+
+        if(std::abs(hintSolver->getPrimalBound() - solver->getPrimalBound())
+            > 1e-2 * std::max(1.0, std::abs(solver->getPrimalBound())))
+        {
+            std::cout << "The objective value differs with the hint." << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool TestRelaxedCutPolicy()
+{
+    auto createPoint = [](double value, double violation) {
+        SolutionPoint point;
+        point.point = { value, 2.0 * value };
+        point.maxDeviation = PairIndexValue(0, violation);
+        return (point);
+    };
+
+    RelaxedCutPolicy policy;
+    policy.setLimits(2, 0.0, 0.1, 10);
+
+    if(policy.shouldSeparate(createPoint(1.0, 0.01), 0, 0, 0.0))
+    {
+        std::cout << "A solution with a too small violation is separated." << std::endl;
+        return false;
+    }
+
+    if(!policy.shouldSeparate(createPoint(1.0, 1.0), 0, 0, 0.0)
+        || policy.shouldSeparate(createPoint(1.0, 1.0), 1, 0, 0.0)
+        || !policy.shouldSeparate(createPoint(1.0, 1.0), 1, 1, 0.0))
+    {
+        std::cout << "The solutions separated by a thread are not remembered by that thread only." << std::endl;
+        return false;
+    }
+
+    if(!policy.shouldSeparate(createPoint(2.0, 1.0), 0, 0, 0.0)
+        || policy.shouldSeparate(createPoint(3.0, 1.0), 0, 0, 0.0)
+        || !policy.shouldSeparate(createPoint(3.0, 1.0), -1, 0, 0.0))
+    {
+        std::cout << "The limit per depth is not used." << std::endl;
+        return false;
+    }
+
+    policy.setLimits(0, 2.0, 0.0, 0);
+
+    int numberOfSeparated = 0;
+
+    for(int i = 0; i < 10; i++)
+        numberOfSeparated += policy.shouldSeparate(createPoint(i, 1.0), i, 0, 0.0) ? 1 : 0;
+
+    // Two more are available after one second
+    numberOfSeparated += policy.shouldSeparate(createPoint(10.0, 1.0), 0, 0, 1.0) ? 1 : 0;
+    numberOfSeparated += policy.shouldSeparate(createPoint(11.0, 1.0), 0, 0, 1.0) ? 1 : 0;
+    numberOfSeparated += policy.shouldSeparate(createPoint(12.0, 1.0), 0, 0, 1.0) ? 1 : 0;
+
+    if(numberOfSeparated != 4)
+    {
+        std::cout << "The rate limit is not used, " << numberOfSeparated << " solutions separated." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestSpatialBranching()
+{
+    // The term w = x * y with the indexes 2, 0 and 1
+    SpatialBranching branching(1e-6);
+    branching.addTerm(2, 0, 1);
+
+    VectorDouble point = { 2.0, 1.0, 0.0 };
+
+    if(branching.getViolatedEnvelopes(point, { 0.0, 0.0, 0.0 }, { 4.0, 2.0, 8.0 }).size() > 0)
+    {
+        std::cout << "The global envelopes are violated by a point that satisfies them." << std::endl;
+        return false;
+    }
+
+    VectorDouble lowerBounds = { 1.0, 0.0, 0.0 };
+    VectorDouble upperBounds = { 4.0, 2.0, 8.0 };
+
+    auto envelopes = branching.getViolatedEnvelopes(point, lowerBounds, upperBounds);
+
+    if(envelopes.size() == 0)
+    {
+        std::cout << "No local envelopes are violated." << std::endl;
+        return false;
+    }
+
+    // The envelopes must be valid for all points in the node
+    for(auto& C : envelopes)
+    {
+        for(double x = 1.0; x <= 4.0; x += 0.5)
+        {
+            for(double y = 0.0; y <= 2.0; y += 0.5)
+            {
+                VectorDouble feasiblePoint = { x, y, x * y };
+                double lhs = 0.0;
+
+                for(auto& T : C.terms)
+                    lhs += T.second * feasiblePoint[T.first];
+
+                if(lhs > C.rhs + 1e-9)
+                {
+                    std::cout << "A local envelope cuts off the point x = " << x << ", y = " << y << std::endl;
+                    return false;
+                }
+            }
+        }
+    }
+
+    auto branch = branching.selectBranch(point, { 0.0, 0.0, 0.0 }, { 4.0, 2.0, 8.0 });
+
+    if(branch.variableIndex != 0 || branch.value != 2.0)
+    {
+        std::cout << "The variable with the widest domain is not branched on at its value." << std::endl;
+        return false;
+    }
+
+    branch = branching.selectBranch({ 0.1, 1.0, 0.0 }, { 0.0, 0.0, 0.0 }, { 4.0, 2.0, 8.0 });
+
+    if(branch.variableIndex != 0 || std::abs(branch.value - 0.4) > 1e-9)
+    {
+        std::cout << "The branching value is not moved away from the bound." << std::endl;
+        return false;
+    }
+
+    if(branching.selectBranch({ 2.0, 1.0, 2.0 }, { 0.0, 0.0, 0.0 }, { 4.0, 2.0, 8.0 }).variableIndex != -1)
+    {
+        std::cout << "A term that is not violated is branched on." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestLogarithmicIntegerBilinear()
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+    solver->updateSetting(
+        "Reformulation.Bilinear.IntegerFormulation", "Model", static_cast<int>(ES_ReformulateBilinearInteger::Yes));
+    solver->updateSetting("Reformulation.Bilinear.IntegerFormulation.Encoding", "Model",
+        static_cast<int>(ES_BilinearIntegerEncoding::Logarithmic));
+
+    // max t s.t. x + y <= 20 and t <= x * y with x integer in [0, 50], the optimum is x = y = 10
+    ProblemBuilder builder(env);
+
+    builder.setVariables({ 0.0, 0.0, 0.0 }, { 50.0, 10.0, 1000.0 },
+        { E_VariableType::Integer, E_VariableType::Real, E_VariableType::Real }, { "x", "y", "t" });
+    builder.setConstraints({ SHOT_DBL_MIN, SHOT_DBL_MIN }, { 20.0, 0.0 });
+    builder.setLinearTerms({ 0, 2, 3 }, { 0, 1, 2 }, { 1.0, 1.0, 1.0 });
+    builder.setQuadraticTerms({ 1 }, { 0 }, { 1 }, { -1.0 });
+    builder.setObjective(E_ObjectiveFunctionDirection::Maximize, { 2 }, { 1.0 });
+
+    if(!solver->setProblem(builder.build("logbilinear")) || !solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    // ceil(log2(51)) = 6 bits instead of 51 binaries
+    int numberOfBinaries = 0;
+
+    for(auto& V : solver->getReformulatedProblem()->allVariables)
+    {
+        if(V->properties.type == E_VariableType::Binary)
+            numberOfBinaries++;
+    }
+
+    std::cout << "Objective value " << solver->getPrimalBound() << " with " << numberOfBinaries << " binaries."
+              << std::endl;
+
+    if(numberOfBinaries != 6)
+    {
+        std::cout << "The integer variable is not encoded with six binaries." << std::endl;
+        return false;
+    }
+
+    if(std::abs(solver->getPrimalBound() - 100.0) > 1e-2)
+    {
+        std::cout << "The optimal objective value 100 is not found." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestResolveWithChangedBounds()
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+    solver->updateSetting(
+        "Reformulation.Quadratics.Strategy", "Model", static_cast<int>(ES_QuadraticProblemStrategy::Nonlinear));
+
+    // min t s.t. x^2 + y^2 <= t with x and y in [1, 3], the optimum is x = y = 1
+    ProblemBuilder builder(env);
+
+    builder.setVariables({ 1.0, 1.0, 0.0 }, { 3.0, 3.0, 100.0 },
+        { E_VariableType::Real, E_VariableType::Real, E_VariableType::Real }, { "x", "y", "t" });
+    builder.setConstraints({ SHOT_DBL_MIN }, { 0.0 });
+    builder.setLinearTerms({ 0, 1 }, { 2 }, { -1.0 });
+    builder.setQuadraticTerms({ 0, 0 }, { 0, 1 }, { 0, 1 }, { 1.0, 1.0 });
+    builder.setObjective(E_ObjectiveFunctionDirection::Minimize, { 2 }, { 1.0 });
+
+    if(!solver->setProblem(builder.build("resolve")) || !solver->solveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    std::cout << "Objective value " << solver->getPrimalBound() << " before changing the bounds." << std::endl;
+
+    if(std::abs(solver->getPrimalBound() - 2.0) > 1e-2)
+    {
+        std::cout << "The optimal objective value 2 is not found." << std::endl;
+        return false;
+    }
+
+    auto numberOfHyperplanes = env->dualSolver->generatedHyperplanes.size();
+
+    // The optimum is x = 2 and y = 1 when x is in [2, 3]
+    solver->getOriginalProblem()->setVariableBounds(0, 2.0, 3.0);
+    solver->getReformulatedProblem()->setVariableBounds(0, 2.0, 3.0);
+    env->dualSolver->MIPSolver->updateVariableBound(0, 2.0, 3.0);
+
+    if(!solver->resolveProblem() || !solver->hasPrimalSolution())
+        return false;
+
+    std::cout << "Objective value " << solver->getPrimalBound() << " after changing the bounds, with "
+              << env->dualSolver->generatedHyperplanes.size() - numberOfHyperplanes << " new hyperplanes."
+              << std::endl;
+
+    if(std::abs(solver->getPrimalBound() - 5.0) > 1e-2)
+    {
+        std::cout << "The optimal objective value 5 is not found after changing the bounds." << std::endl;
+        return false;
+    }
+
+    // The hyperplanes of the first problem are kept in the dual problem
+    if(env->dualSolver->generatedHyperplanes.size() < numberOfHyperplanes)
+    {
+        std::cout << "The hyperplanes of the first problem have been removed." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestRootsearchWarmStart()
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    // x^2 + y^2 <= 4
+    ProblemBuilder builder(env);
+
+    builder.setVariables({ -10.0, -10.0 }, { 10.0, 10.0 }, { E_VariableType::Real, E_VariableType::Real });
+    builder.setConstraints({ SHOT_DBL_MIN }, { 4.0 });
+    builder.setQuadraticTerms({ 0, 0 }, { 0, 1 }, { 0, 1 }, { 1.0, 1.0 });
+    builder.setObjective(E_ObjectiveFunctionDirection::Minimize, { 0 }, { 1.0 });
+
+    if(!solver->setProblem(builder.build("rootsearch")) || !solver->getMetrics())
+        return false;
+
+    std::vector<NumericConstraint*> constraints;
+
+    for(auto& C : env->problem->numericConstraints)
+        constraints.push_back(C.get());
+
+    auto rootsearch = std::make_unique<RootsearchMethodBoost>(env);
+    VectorDouble interiorPoint = { 0.0, 0.0 };
+
+    // The second exterior point is close to the first one, so that its root is in the bracket around the first root
+    for(auto& exteriorPoint : { VectorDouble{ 3.0, 0.0 }, VectorDouble{ 3.0, 0.1 } })
+    {
+        auto root = rootsearch->findZero(interiorPoint, exteriorPoint, 100, 1e-12, 1e-6, constraints, false);
+        double radius = std::sqrt(root.first[0] * root.first[0] + root.first[1] * root.first[1]);
+
+        std::cout << "Root found with radius " << radius << "." << std::endl;
+
+        if(std::abs(radius - 2.0) > 1e-6)
+        {
+            std::cout << "The root is not on the boundary of the constraint." << std::endl;
+            return false;
+        }
+    }
+
+    auto warmStarts = solver->getMetrics()->getCounterValue(E_MetricsCounter::RootsearchWarmStarts);
+
+    std::cout << "Number of warm started root searches: " << warmStarts << std::endl;
+
+    if(warmStarts != 1)
+    {
+        std::cout << "The second root search was not warm started." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestConcurrentSolvers(std::vector<std::string> filenames)
+{
+    auto solve = [](const std::string& filename, double& primalBound) {
+        auto solver = std::make_unique<SHOT::Solver>();
+
+        solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+        solver->updateSetting("MIP.NumberOfThreads", "Dual", 1);
+
+        if(!solver->setProblem(filename) || !solver->solveProblem() || !solver->hasPrimalSolution())
+            return false;
+
+        primalBound = solver->getPrimalBound();
+        return true;
+    };
+
+    VectorDouble referenceBounds(filenames.size());
+
+    for(size_t i = 0; i < filenames.size(); i++)
+    {
+        if(!solve(filenames[i], referenceBounds[i]))
+        {
+            std::cout << "Could not solve " << filenames[i] << "." << std::endl;
+            return false;
+        }
+    }
+
+    // Each thread creates its own solvers, which solve the problems in turn
+    int numberOfThreads = 8;
+    int solvesPerThread = 4;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> numberOfFailedSolves(0);
+
+    for(int t = 0; t < numberOfThreads; t++)
+    {
+        threads.emplace_back([&, t]() {
+            for(int k = 0; k < solvesPerThread; k++)
+            {
+                size_t i = (t + k) % filenames.size();
+                double primalBound = SHOT_DBL_MAX;
+
+                if(!solve(filenames[i], primalBound)
+                    || std::abs(primalBound - referenceBounds[i]) > 1e-2 * std::max(1.0, std::abs(referenceBounds[i])))
+                    numberOfFailedSolves++;
+            }
+        });
+    }
+
+    for(auto& T : threads)
+        T.join();
+
+    std::cout << numberOfThreads * solvesPerThread << " problems solved in " << numberOfThreads
+              << " threads with " << numberOfFailedSolves << " failed solves." << std::endl;
+
+    if(numberOfFailedSolves > 0)
+    {
+        std::cout << "The concurrent solvers did not find the same solutions as a single solver." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestDebugWriter(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    std::string debugPath = Utilities::createTemporaryDirectory("shot_debug_");
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+    solver->updateSetting("Debug.Enable", "Output", true);
+    solver->updateSetting("Debug.Path", "Output", debugPath);
+
+    // The calling thread waits for each file to be written, since the queue cannot hold any
+    solver->updateSetting("Debug.QueueSize", "Output", 0.0);
+
+    if(!solver->setProblem(filename))
+        return false;
+
+    solver->solveProblem();
+
+    bool passed = true;
+
+    // The files of the solution process have been written when the solver returns
+    for(auto file : { "originalproblem.txt", "usedsettings.opt" })
+    {
+        if(!std::ifstream(debugPath + "/" + file))
+        {
+            std::cout << "Debug file " << file << " has not been written." << std::endl;
+            passed = false;
+        }
+    }
+
+    std::vector<std::string> contents;
+
+    for(int i = 0; i < 20; i++)
+    {
+        contents.push_back(std::string(1000 * (i + 1), 'a' + i % 26));
+        env->debugWriter->write(debugPath + "/file" + std::to_string(i) + ".txt", contents.back());
+    }
+
+    env->debugWriter->flush();
+
+    for(size_t i = 0; i < contents.size(); i++)
+    {
+        if(Utilities::getFileAsString(debugPath + "/file" + std::to_string(i) + ".txt") != contents[i])
+        {
+            std::cout << "Debug file " << i << " has not been written correctly." << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+bool TestDeterministicParallel(std::string filename)
+{
+    struct SolutionSummary
+    {
+        int numberOfIterations;
+        int numberOfHyperplanes;
+        double primalBound;
+        double dualBound;
+    };
+
+    auto solve = [&](SolutionSummary& summary) {
+        auto solver = std::make_unique<SHOT::Solver>();
+        auto env = solver->getEnvironment();
+
+        solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+        solver->updateSetting("Parallel.Deterministic", "Strategy", true);
+        solver->updateSetting("ESH.Rootsearch.NumberOfThreads", "Dual", 4);
+        solver->updateSetting("Rootsearch.NumberOfThreads", "Primal", 4);
+        solver->updateSetting("Rootsearch.Asynchronous", "Primal", true);
+
+        if(!solver->setProblem(filename) || !solver->solveProblem())
+            return false;
+
+        // The asynchronous primal root searches are not used in the deterministic mode
+        if(env->settings->getSetting<bool>("Rootsearch.Asynchronous", "Primal"))
+        {
+            std::cout << "The primal root searches are still asynchronous." << std::endl;
+            return false;
+        }
+
+        summary.numberOfIterations = env->results->getNumberOfIterations();
+        summary.numberOfHyperplanes = env->results->getCurrentIteration()->totNumHyperplanes;
+        summary.primalBound = env->results->getPrimalBound();
+        summary.dualBound = env->results->getGlobalDualBound();
+
+        return true;
+    };
+
+    SolutionSummary referenceSummary;
+
+    if(!solve(referenceSummary))
+        return false;
+
+    bool passed = true;
+
+    for(int i = 0; i < 3; i++)
+    {
+        SolutionSummary summary;
+
+        if(!solve(summary))
+            return false;
+
+        if(summary.numberOfIterations != referenceSummary.numberOfIterations
+            || summary.numberOfHyperplanes != referenceSummary.numberOfHyperplanes
+            || summary.primalBound != referenceSummary.primalBound || summary.dualBound != referenceSummary.dualBound)
+        {
+            std::cout << "Solution " << i + 1 << " differs from the first one: " << summary.numberOfIterations
+                      << " iterations and " << summary.numberOfHyperplanes << " hyperplanes compared to "
+                      << referenceSummary.numberOfIterations << " and " << referenceSummary.numberOfHyperplanes
+                      << "." << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+bool TestCancellation(std::string filename)
+{
+    bool passed = true;
+
+    // The watchdog cancels the token at the deadline and calls the registered functions
+    CancellationToken token;
+    std::atomic<int> numberOfCalls(0);
+
+    token.registerCallback([&numberOfCalls] { numberOfCalls++; });
+    token.setDeadline(0.05);
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    if(!token.isCancelled() || token.getReason() != E_TerminationReason::TimeLimit || numberOfCalls != 1)
+    {
+        std::cout << "The token was not cancelled at the deadline." << std::endl;
+        passed = false;
+    }
+
+    token.reset();
+    token.cancel();
+    token.cancel();
+
+    if(token.getReason() != E_TerminationReason::UserAbort || numberOfCalls != 2)
+    {
+        std::cout << "The token was not cancelled once after it was reset." << std::endl;
+        passed = false;
+    }
+
+    double timeLimit = 0.2;
+
+    // Some margin for the work that is finished after the deadline, e.g. the final report
+    double maxTime = timeLimit + 0.5;
+
+    {
+        auto solver = std::make_unique<SHOT::Solver>();
+        auto env = solver->getEnvironment();
+
+        solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+        solver->updateSetting("TimeLimit", "Termination", timeLimit);
+        solver->updateSetting("TimeLimit.Hard", "Termination", true);
+
+        if(!solver->setProblem(filename))
+            return false;
+
+        solver->solveProblem();
+
+        double solutionTime = env->timing->getElapsedTime("Total");
+
+        if(solutionTime > maxTime)
+        {
+            std::cout << "The solver returned after " << solutionTime << " s with a hard time limit of " << timeLimit
+                      << " s." << std::endl;
+            passed = false;
+        }
+
+        if(solutionTime >= timeLimit && solver->getTerminationReason() != E_TerminationReason::TimeLimit)
+        {
+            std::cout << "The solver was not terminated by the time limit." << std::endl;
+            passed = false;
+        }
+    }
+
+    {
+        auto solver = std::make_unique<SHOT::Solver>();
+        auto env = solver->getEnvironment();
+
+        solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+        if(!solver->setProblem(filename))
+            return false;
+
+        std::thread cancellingThread([&solver, timeLimit] {
+            std::this_thread::sleep_for(std::chrono::duration<double>(timeLimit));
+            solver->cancel();
+        });
+
+        double startTime = env->timing->getElapsedTime("Total");
+        solver->solveProblem();
+        double solutionTime = env->timing->getElapsedTime("Total") - startTime;
+
+        cancellingThread.join();
+
+        if(solutionTime > maxTime)
+        {
+            std::cout << "The solver returned " << solutionTime << " s after it was started, although it was cancelled"
+                      << " after " << timeLimit << " s." << std::endl;
+            passed = false;
+        }
+
+        if(solutionTime >= timeLimit && solver->getTerminationReason() != E_TerminationReason::UserAbort)
+        {
+            std::cout << "The solver was not terminated by the user." << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+bool TestAsynchronousRootsearchAtTermination(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+    solver->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::MultiTree));
+    solver->updateSetting("Rootsearch.Asynchronous", "Primal", true);
+    solver->updateSetting("Relaxation.Use", "Dual", false);
+
+    // The termination criteria, e.g. the iteration limit, are checked after the root searches of the iteration have
+    // been started in the background, so the solution process ends while they are performed
+    solver->updateSetting("IterationLimit", "Termination", 3);
+
+    if(!solver->setProblem(filename) || !solver->solveProblem())
+        return false;
+
+    auto rootsearchTask = std::dynamic_pointer_cast<TaskSelectPrimalCandidatesFromRootsearch>(
+        env->tasks->getTask("SelectPrimRootsearch"));
+
+    if(!rootsearchTask)
+        return false;
+
+    int numberOfStarted = rootsearchTask->getNumberOfStartedAsynchronousRootsearches();
+    int numberOfFinished = rootsearchTask->getNumberOfFinishedAsynchronousRootsearches();
+
+    std::cout << numberOfStarted << " asynchronous root search batches were started and the candidates of "
+              << numberOfFinished << " were added." << std::endl;
+
+    if(numberOfStarted == 0)
+    {
+        std::cout << "No root searches were performed in the background." << std::endl;
+        return false;
+    }
+
+    if(numberOfFinished != numberOfStarted)
+    {
+        std::cout << "The candidates of the last root searches were not added before the solution was reported."
+                  << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Waits for a limited time until the given number of tasks are running at the same time
+class TestTaskWaitingForOthers : public TaskBase
+{
+public:
+    TestTaskWaitingForOthers(EnvironmentPtr envPtr, std::atomic<int>& running, int numberOfTasks)
+        : TaskBase(envPtr), running(running), numberOfTasks(numberOfTasks)
+    {
+    }
+
+    void run() override
+    {
+        running++;
+
+        auto timeEnd = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+
+        while(running < numberOfTasks && std::chrono::steady_clock::now() < timeEnd)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        isOverlapping = (running >= numberOfTasks);
+        running--;
+    }
+
+    std::vector<E_TaskEnvironmentState> getReadStates() override { return { E_TaskEnvironmentState::Results }; }
+    std::vector<E_TaskEnvironmentState> getModifiedStates() override { return { E_TaskEnvironmentState::Report }; }
+
+    std::atomic<bool> isOverlapping = false;
+
+private:
+    std::atomic<int>& running;
+    int numberOfTasks;
+};
+
+bool TestTaskGraph(std::string filename)
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    // Two tasks that only read the results are run at the same time, and a task modifying them after both
+    std::atomic<int> running = 0;
+    auto firstTask = std::make_shared<TestTaskWaitingForOthers>(env, running, 2);
+    auto secondTask = std::make_shared<TestTaskWaitingForOthers>(env, running, 2);
+    auto dependentTask = std::make_shared<TestTaskWaitingForOthers>(env, running, 1);
+
+    TaskParallel taskGroup(env, 2);
+    taskGroup.addTasks({ firstTask, secondTask, dependentTask });
+    taskGroup.run();
+
+    if(!firstTask->isOverlapping || !secondTask->isOverlapping)
+    {
+        std::cout << "The independent tasks were not run at the same time." << std::endl;
+        return false;
+    }
+
+    // The default task uses everything, and is never run together with the other tasks
+    std::atomic<int> runningWithDefault = 0;
+    TaskParallel defaultTaskGroup(env, 2);
+    defaultTaskGroup.addTasks({ std::make_shared<TestTaskWaitingForOthers>(env, runningWithDefault, 1),
+        std::make_shared<TaskBase>(env) });
+    defaultTaskGroup.run();
+
+    if(defaultTaskGroup.getMaxNumberOfConcurrentTasks() != 1)
+    {
+        std::cout << "A task using the whole environment was run together with another task." << std::endl;
+        return false;
+    }
+
+    // The iteration report and the checkpoint are run at the same time in the multi-tree strategy
+    solver->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::MultiTree));
+    solver->updateSetting("TaskGraph.Use", "Strategy", true);
+    solver->updateSetting("Parallel.NumberOfThreads", "Strategy", 2);
+    solver->updateSetting("Checkpoint.File", "Output", std::string("taskgraph.shotwarm"));
+    solver->updateSetting("Checkpoint.Frequency.Time", "Output", 0.0);
+
+    bool passed = solver->setProblem(filename) && solver->solveProblem() && solver->hasPrimalSolution();
+
+    auto reportTask = std::dynamic_pointer_cast<TaskParallel>(env->tasks->getTask("PrintIterReport"));
+
+    if(!passed)
+        return false;
+
+    if(!reportTask || reportTask->getMaxNumberOfConcurrentTasks() != 2)
+    {
+        std::cout << "The iteration report and the checkpoint were not run at the same time." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestParallelECPGradients(std::string filename)
+{
+    struct SolutionSummary
+    {
+        int numberOfIterations;
+        int numberOfHyperplanes;
+        double primalBound;
+        double dualBound;
+    };
+
+    auto solve = [&](int numberOfThreads, SolutionSummary& summary) {
+        auto solver = std::make_unique<SHOT::Solver>();
+        auto env = solver->getEnvironment();
+
+        solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+        solver->updateSetting("TreeStrategy", "Dual", static_cast<int>(ES_TreeStrategy::MultiTree));
+        solver->updateSetting("Parallel.Deterministic", "Strategy", true);
+        solver->updateSetting("CutStrategy", "Dual", static_cast<int>(ES_HyperplaneCutStrategy::ECP));
+        solver->updateSetting("HyperplaneCuts.ECP.NumberOfThreads", "Dual", numberOfThreads);
+
+        // Cuts for the same constraint are added in all the solution pool points violating it, so the first gradients
+        // of a constraint are calculated by several threads at the same time
+        solver->updateSetting("ESH.Rootsearch.UniqueConstraints", "Dual", false);
+        solver->updateSetting("HyperplaneCuts.ConstraintSelectionFactor", "Dual", 1.0);
+
+        if(!solver->setProblem(filename) || !solver->solveProblem())
+            return false;
+
+        summary.numberOfIterations = env->results->getNumberOfIterations();
+        summary.numberOfHyperplanes = env->results->getCurrentIteration()->totNumHyperplanes;
+        summary.primalBound = env->results->getPrimalBound();
+        summary.dualBound = env->results->getGlobalDualBound();
+
+        return true;
+    };
+
+    SolutionSummary referenceSummary;
+
+    if(!solve(1, referenceSummary))
+        return false;
+
+    bool passed = true;
+
+    for(int i = 0; i < 3; i++)
+    {
+        SolutionSummary summary;
+
+        if(!solve(4, summary))
+            return false;
+
+        if(summary.numberOfIterations != referenceSummary.numberOfIterations
+            || summary.numberOfHyperplanes != referenceSummary.numberOfHyperplanes
+            || summary.primalBound != referenceSummary.primalBound || summary.dualBound != referenceSummary.dualBound)
+        {
+            std::cout << "Solution " << i + 1 << " with four threads differs from the one with a single thread: "
+                      << summary.numberOfIterations << " iterations and " << summary.numberOfHyperplanes
+                      << " hyperplanes compared to " << referenceSummary.numberOfIterations << " and "
+                      << referenceSummary.numberOfHyperplanes << "." << std::endl;
+            passed = false;
+        }
+    }
+
+    return passed;
+}
+
+bool TestCppADThreadOverflow(std::string filename)
+{
+    std::unique_ptr<Solver> solver = std::make_unique<Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Error));
+
+    if(!solver->setProblem(filename))
+    {
+        std::cout << "Error while reading problem";
+        return false;
+    }
+
+    VectorDouble point;
+
+    for(auto& V : env->problem->allVariables)
+        point.push_back((V->upperBound + V->lowerBound) / 2.0);
+
+    std::vector<SparseVariableVector> referenceGradients;
+
+    for(auto& C : env->problem->nonlinearConstraints)
+        referenceGradients.push_back(C->calculateGradient(point, false));
+
+    // All threads are using CppAD at the same time, so the last ones share a CppAD thread number
+    int numberOfThreads = CPPAD_MAX_NUM_THREADS + 4;
+    int evaluationsPerThread = 10;
+
+    std::vector<std::thread> threads;
+    std::atomic<int> numberOfStartedThreads(0);
+    std::atomic<int> numberOfWrongGradients(0);
+
+    for(int t = 0; t < numberOfThreads; t++)
+    {
+        threads.emplace_back([&]() {
+            for(int k = 0; k < evaluationsPerThread; k++)
+            {
+                for(size_t i = 0; i < env->problem->nonlinearConstraints.size(); i++)
+                {
+                    if(env->problem->nonlinearConstraints[i]->calculateGradient(point, false) != referenceGradients[i])
+                        numberOfWrongGradients++;
+                }
+
+                if(k == 0)
+                {
+                    numberOfStartedThreads++;
+
+                    while(numberOfStartedThreads < numberOfThreads)
+                        std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    for(auto& T : threads)
+        T.join();
+
+    std::cout << "Gradients calculated in " << numberOfThreads << " threads with " << numberOfWrongGradients
+              << " wrong gradients." << std::endl;
+
+    return (numberOfWrongGradients == 0);
+}
+
+bool TestBinaryIntegerCutTerms()
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    IntegerCut integerCut;
+    integerCut.variableIndexes = { 0, 1, 2, 3 };
+    integerCut.variableValues = { 1, 0, 1, 1 };
+    integerCut.areAllVariablesBinary = true;
+
+    // x0 - x1 + x2 + x3 <= 2, i.e. the RHS is the number of ones minus one
+    auto terms = env->dualSolver->getBinaryIntegerCutTerms(integerCut);
+
+    if(!terms)
+    {
+        std::cout << "No terms were created for the integer cut." << std::endl;
+        return false;
+    }
+
+    std::map<int, double> correctTerms = { { 0, 1.0 }, { 1, -1.0 }, { 2, 1.0 }, { 3, 1.0 } };
+
+    if(terms->first != correctTerms)
+    {
+        std::cout << "The integer cut has the wrong terms." << std::endl;
+        return false;
+    }
+
+    if(-terms->second != 2.0)
+    {
+        std::cout << "The integer cut has the RHS " << -terms->second << " instead of 2." << std::endl;
+        return false;
+    }
+
+    // Only binary values can be used
+    integerCut.variableValues = { 1, 0, 2, 1 };
+
+    if(env->dualSolver->getBinaryIntegerCutTerms(integerCut))
+    {
+        std::cout << "Terms were created for an integer cut with a nonbinary value." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool TestCombineIntegerCuts()
+{
+    auto solver = std::make_unique<SHOT::Solver>();
+    auto env = solver->getEnvironment();
+
+    solver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    // x0 + x1 + x2 <= 2 with binary variables
+    ProblemBuilder builder(env);
+
+    builder.setVariables({ 0.0, 0.0, 0.0 }, { 1.0, 1.0, 1.0 },
+        { E_VariableType::Binary, E_VariableType::Binary, E_VariableType::Binary });
+    builder.setConstraints({ SHOT_DBL_MIN }, { 2.0 });
+    builder.setLinearTerms({ 0, 3 }, { 0, 1, 2 }, { 1.0, 1.0, 1.0 });
+    builder.setObjective(E_ObjectiveFunctionDirection::Maximize, { 0, 1, 2 }, { 1.0, 2.0, 3.0 });
+
+    if(!solver->setProblem(builder.build("integercuts")))
+        return false;
+
+    // The cuts only differ in the value of x1
+    IntegerCut firstCut;
+    firstCut.variableIndexes = { 0, 1, 2 };
+    firstCut.variableValues = { 1, 0, 1 };
+
+    IntegerCut secondCut;
+    secondCut.variableIndexes = { 0, 1, 2 };
+    secondCut.variableValues = { 1, 1, 1 };
+
+    env->dualSolver->addIntegerCut(firstCut);
+    env->dualSolver->addIntegerCut(secondCut);
+
+    if(env->dualSolver->integerCutWaitingList.size() != 2)
+    {
+        std::cout << "The integer cuts were not added to the waiting list." << std::endl;
+        return false;
+    }
+
+    env->dualSolver->combineIntegerCuts();
+
+    auto& waitingList = env->dualSolver->integerCutWaitingList;
+
+    if(waitingList.size() != 1)
+    {
+        std::cout << waitingList.size() << " integer cuts in the waiting list instead of one combined cut."
+                  << std::endl;
+        return false;
+    }
+
+    auto& combinedCut = waitingList[0];
+
+    if(combinedCut.source != E_IntegerCutSource::Combined || combinedCut.variableIndexes != VectorInteger{ 0, 2 }
+        || combinedCut.variableValues != VectorInteger{ 1, 1 })
+    {
+        std::cout << "The combined integer cut does not exclude x0 = x2 = 1 without x1." << std::endl;
+        return false;
+    }
+
+    // x0 + x2 <= 1
+    auto terms = env->dualSolver->getBinaryIntegerCutTerms(combinedCut);
+
+    if(!terms || terms->first != std::map<int, double>{ { 0, 1.0 }, { 2, 1.0 } } || terms->second != -1.0)
+    {
+        std::cout << "The combined integer cut has the wrong terms." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+int SolverTest(int argc, char* argv[])
+{
+    int defaultchoice = 1;
+
+    int choice = defaultchoice;
+
+    if(argc > 1)
+    {
+        if(sscanf(argv[1], "%d", &choice) != 1)
+        {
+            printf("Couldn't parse that input as a number\n");
+            return -1;
+        }
+    }
+
+    bool passed = true;
+
+    switch(choice)
+    {
+    case 1:
+        std::cout << "Starting test to read OSiL files:" << std::endl;
+        passed = ReadProblem("data/tls2.osil");
+        std::cout << "Finished test to read OSiL files." << std::endl;
+        break;
+    case 2:
+        std::cout << "Starting test to read NL files:" << std::endl;
+        passed = ReadProblem("data/tls2.nl");
+        std::cout << "Finished test to read NL files." << std::endl;
+        break;
+    case 3:
+        std::cout << "Starting test to solve a MINLP problem in OSiL syntax:" << std::endl;
+        passed = SolveProblem("data/tls2.osil");
+        std::cout << "Finished test to solve a MINLP problem in OSiL syntax." << std::endl;
+        break;
+    case 4:
+        std::cout << "Starting test to evaluate gradients in OSiL file:" << std::endl;
+        passed = TestGradient("data/flay02h.osil");
+        std::cout << "Finished test to evaluate gradients in OSiL file." << std::endl;
+        break;
+    case 5:
+        std::cout << "Starting test solving model using SHOT API:" << std::endl;
+        passed = CreateAndSolveProblem();
+        std::cout << "Finished test solving model using SHOT API." << std::endl;
+        break;
+    case 6:
+        std::cout << "Starting test to read OSiL file with semicont. variables:" << std::endl;
+        passed = ReadProblem("data/meanvarxsc.osil");
+        std::cout << "Finished test to read OSiL file with semicont. variables." << std::endl;
+        break;
+    case 7:
+        std::cout << "Starting test to write and read a problem snapshot:" << std::endl;
+        passed = ReadProblemSnapshot("data/tls2.osil");
+        std::cout << "Finished test to write and read a problem snapshot." << std::endl;
+        break;
+    case 8:
+        std::cout << "Starting test to collect and export metrics:" << std::endl;
+        passed = TestMetrics("data/tls2.osil");
+        std::cout << "Finished test to collect and export metrics." << std::endl;
+        break;
+    case 9:
+        std::cout << "Starting test to limit the retained iterations:" << std::endl;
+        passed = TestIterationRetention("data/tls2.osil");
+        std::cout << "Finished test to limit the retained iterations." << std::endl;
+        break;
+    case 10:
+        std::cout << "Starting test to write the results to files:" << std::endl;
+        passed = TestWriteResults("data/tls2.osil");
+        std::cout << "Finished test to write the results to files." << std::endl;
+        break;
+    case 11:
+        std::cout << "Starting test to solve a problem again after updating its data:" << std::endl;
+        passed = TestUpdateProblemData("data/tls2.osil");
+        std::cout << "Finished test to solve a problem again after updating its data." << std::endl;
+        break;
+    case 12:
+        std::cout << "Starting test to warm start the solution of a problem:" << std::endl;
+        passed = TestWarmStart("data/tls2.osil");
+        std::cout << "Finished test to warm start the solution of a problem." << std::endl;
+        break;
+    case 13:
+        std::cout << "Starting test to receive typed event payloads:" << std::endl;
+        passed = TestTypedEvents("data/tls2.osil", false) && TestTypedEvents("data/tls2.osil", true);
+        std::cout << "Finished test to receive typed event payloads." << std::endl;
+        break;
+    case 14:
+        std::cout << "Starting test to solve a problem with a portfolio of configurations:" << std::endl;
+        passed = TestPortfolio("data/tls2.osil");
+        std::cout << "Finished test to solve a problem with a portfolio of configurations." << std::endl;
+        break;
+    case 15:
+        std::cout << "Starting test to solve the fixed NLP problems in a worker:" << std::endl;
+        passed = TestRemoteFixedNLP("data/tls2.osil");
+        std::cout << "Finished test to solve the fixed NLP problems in a worker." << std::endl;
+        break;
+    case 16:
+        std::cout << "Starting test to perform the root searches in blocks of nonlinear constraints:" << std::endl;
+        passed = TestConstraintBlocks("data/tls2.osil");
+        std::cout << "Finished test to perform the root searches in blocks of nonlinear constraints." << std::endl;
+        break;
+    case 17:
+        std::cout << "Starting test to save several primal solutions in the solution pool:" << std::endl;
+        passed = TestSolutionPool("data/tls2.osil");
+        std::cout << "Finished test to save several primal solutions in the solution pool." << std::endl;
+        break;
+    case 18:
+        std::cout << "Starting test to create several solvers with the default settings:" << std::endl;
+        passed = TestSharedSettings();
+        std::cout << "Finished test to create several solvers with the default settings." << std::endl;
+        break;
+    case 19:
+        std::cout << "Starting test to resume a stopped run from a checkpoint:" << std::endl;
+        passed = TestCheckpoint("data/tls2.osil");
+        std::cout << "Finished test to resume a stopped run from a checkpoint." << std::endl;
+        break;
+    case 20:
+        std::cout << "Starting test to start from a primal solution hint:" << std::endl;
+        passed = TestPrimalSolutionHint("data/tls2.osil");
+        std::cout << "Finished test to start from a primal solution hint." << std::endl;
+        break;
+    case 21:
+        std::cout << "Starting test to select the relaxed solutions used for cuts:" << std::endl;
+        passed = TestRelaxedCutPolicy();
+        std::cout << "Finished test to select the relaxed solutions used for cuts." << std::endl;
+        break;
+    case 22:
+        std::cout << "Starting test to branch on bilinear terms:" << std::endl;
+        passed = TestSpatialBranching();
+        std::cout << "Finished test to branch on bilinear terms." << std::endl;
+        break;
+    case 23:
+        std::cout << "Starting test to reformulate integer bilinear terms with a logarithmic encoding:" << std::endl;
+        passed = TestLogarithmicIntegerBilinear();
+        std::cout << "Finished test to reformulate integer bilinear terms with a logarithmic encoding." << std::endl;
+        break;
+    case 24:
+        std::cout << "Starting test to resolve a problem after changing the bounds:" << std::endl;
+        passed = TestResolveWithChangedBounds();
+        std::cout << "Finished test to resolve a problem after changing the bounds." << std::endl;
+        break;
+    case 25:
+        std::cout << "Starting test to warm start root searches:" << std::endl;
+        passed = TestRootsearchWarmStart();
+        std::cout << "Finished test to warm start root searches." << std::endl;
+        break;
+    case 26:
+        std::cout << "Starting test to solve problems with several solvers at the same time:" << std::endl;
+        passed = TestConcurrentSolvers({ "data/tls2.osil", "data/flay02h.osil" });
+        std::cout << "Finished test to solve problems with several solvers at the same time." << std::endl;
+        break;
+    case 27:
+        std::cout << "Starting test to write the debug files from a background thread:" << std::endl;
+        passed = TestDebugWriter("data/tls2.osil");
+        std::cout << "Finished test to write the debug files from a background thread." << std::endl;
+        break;
+    case 28:
+        std::cout << "Starting test to solve a problem with deterministic parallel root searches:" << std::endl;
+        passed = TestDeterministicParallel("data/tls2.osil");
+        std::cout << "Finished test to solve a problem with deterministic parallel root searches." << std::endl;
+        break;
+    case 29:
+        std::cout << "Starting test to cancel the solver and stop it at a hard time limit:" << std::endl;
+        passed = TestCancellation("data/fo7.osil");
+        std::cout << "Finished test to cancel the solver and stop it at a hard time limit." << std::endl;
+        break;
+    case 30:
+        std::cout << "Starting test to add the asynchronous root search candidates at termination:" << std::endl;
+        passed = TestAsynchronousRootsearchAtTermination("data/tls2.osil");
+        std::cout << "Finished test to add the asynchronous root search candidates at termination." << std::endl;
+        break;
+    case 31:
+        std::cout << "Starting test to run independent tasks at the same time:" << std::endl;
+        passed = TestTaskGraph("data/tls2.osil");
+        std::cout << "Finished test to run independent tasks at the same time." << std::endl;
+        break;
+    case 32:
+        std::cout << "Starting test to update the bounds of standardized constraints:" << std::endl;
+        passed = TestUpdateConstraintBounds();
+        std::cout << "Finished test to update the bounds of standardized constraints." << std::endl;
+        break;
+    case 33:
+        std::cout << "Starting test to calculate the ECP cut gradients on several threads:" << std::endl;
+        passed = TestParallelECPGradients("data/synthes1.osil");
+        std::cout << "Finished test to calculate the ECP cut gradients on several threads." << std::endl;
+        break;
+    case 34:
+        std::cout << "Starting test to calculate gradients on more threads than CppAD has thread numbers:" << std::endl;
+        passed = TestCppADThreadOverflow("data/synthes1.osil");
+        std::cout << "Finished test to calculate gradients on more threads than CppAD has thread numbers." << std::endl;
+        break;
+    case 35:
+        std::cout << "Starting test to create the terms of a binary integer cut:" << std::endl;
+        passed = TestBinaryIntegerCutTerms();
+        std::cout << "Finished test to create the terms of a binary integer cut." << std::endl;
+        break;
+    case 36:
+        std::cout << "Starting test to combine integer cuts that differ in one binary variable:" << std::endl;
+        passed = TestCombineIntegerCuts();
+        std::cout << "Finished test to combine integer cuts that differ in one binary variable." << std::endl;
         break;
     default:
         passed = false;
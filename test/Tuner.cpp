@@ -0,0 +1,567 @@
+/**
+   The Supporting Hyperplane Optimization Toolkit (SHOT).
+
+   @author Andreas Lundell, Åbo Akademi University
+
+   @section LICENSE
+   This software is licensed under the Eclipse Public License 2.0.
+   Please see the README and LICENSE files for more information.
+*/
+
+// Settings tuner built on the benchmark harness. Configurations of the chosen settings are sampled at random and
+// evaluated on a set of instances, either all with the full time limit (random search) or with successive halving,
+// where all configurations are first run with a short time limit and the best fraction is kept and rerun with a
+// longer one. The score of a configuration is the shifted geometric mean of the times to the target gap, where the
+// runs not reaching the gap are penalized with a multiple of the time limit. The first configuration is always the
+// default one, so the result is never worse than the defaults on the tuning set. The best configuration is written
+// as an options file that can be read with Solver::setOptionsFromFile or the --opt argument of shot_bench.
+
+#include "BenchmarkHarness.h"
+
+#include "../src/Solver.h"
+#include "../src/Environment.h"
+#include "../src/Settings.h"
+#include "../src/Utilities.h"
+
+#include "argh.h"
+#include "spdlog/fmt/fmt.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace SHOT;
+
+// A setting with either a list of values, or a range that is sampled uniformly or logarithmically
+struct TunedSetting
+{
+    std::string key; // Category.Name as in the options files
+    std::vector<std::string> values;
+
+    bool isRange = false;
+    bool isInteger = false;
+    bool isLogarithmic = false;
+    double lowerBound = 0.0;
+    double upperBound = 0.0;
+};
+
+// The values of the tuned settings, the settings not in the map have their default values
+using Configuration = std::map<std::string, std::string>;
+
+struct Evaluation
+{
+    int configurationIndex = 0;
+    double timeLimit = 0.0;
+    double score = 0.0;
+    int numberOfRunsReachingGap = 0;
+    int numberOfRuns = 0;
+};
+
+// The settings that differ most between the model families, used if no settings are given
+const std::vector<std::string> defaultSearchSpace = { "Dual.CutStrategy = 0,1", "Dual.TreeStrategy = 0,1",
+    "Dual.HyperplaneCuts.ConstraintSelectionFactor = 0.1:1.0", "Dual.HyperplaneCuts.MaxPerIteration = 10:1000:log",
+    "Primal.FixedInteger.CallStrategy = 0,1,2", "Primal.FixedInteger.Frequency.Iteration = 1:50:log",
+    "Primal.Rootsearch.Use = true,false", "Subsolver.Rootsearch.Method = 0,1,2" };
+
+// Parses a setting given as Category.Name=v1,v2,... or Category.Name=lower:upper[:log]. The range is an integer range
+// if both bounds are integers.
+bool parseTunedSetting(const std::string& specification, TunedSetting& setting)
+{
+    auto equalitySignIndex = specification.find('=');
+
+    if(equalitySignIndex == std::string::npos)
+        return (false);
+
+    std::string key = specification.substr(0, equalitySignIndex);
+    std::string values = specification.substr(equalitySignIndex + 1);
+    setting.key = Utilities::trim(key);
+    values = Utilities::trim(values);
+
+    if(setting.key.find('.') == std::string::npos || values.empty())
+        return (false);
+
+    if(values.find(':') == std::string::npos)
+    {
+        std::stringstream stream(values);
+        std::string value;
+
+        while(std::getline(stream, value, ','))
+        {
+            value = Utilities::trim(value);
+
+            if(!value.empty())
+                setting.values.push_back(value);
+        }
+
+        return (!setting.values.empty());
+    }
+
+    std::vector<std::string> parts;
+    std::stringstream stream(values);
+    std::string part;
+
+    while(std::getline(stream, part, ':'))
+        parts.push_back(Utilities::trim(part));
+
+    if(parts.size() < 2 || parts.size() > 3 || (parts.size() == 3 && parts[2] != "log"))
+        return (false);
+
+    try
+    {
+        setting.lowerBound = std::stod(parts[0]);
+        setting.upperBound = std::stod(parts[1]);
+    }
+    catch(...)
+    {
+        return (false);
+    }
+
+    auto isIntegerString = [](const std::string& value) { return (value.find_first_of(".eE") == std::string::npos); };
+
+    setting.isRange = true;
+    setting.isInteger = isIntegerString(parts[0]) && isIntegerString(parts[1]);
+    setting.isLogarithmic = (parts.size() == 3);
+
+    return (setting.lowerBound <= setting.upperBound && (!setting.isLogarithmic || setting.lowerBound > 0));
+}
+
+std::string sampleValue(const TunedSetting& setting, std::mt19937& generator)
+{
+    if(!setting.isRange)
+    {
+        std::uniform_int_distribution<size_t> distribution(0, setting.values.size() - 1);
+        return (setting.values[distribution(generator)]);
+    }
+
+    double value;
+
+    if(setting.isLogarithmic)
+    {
+        std::uniform_real_distribution<double> distribution(
+            std::log(setting.lowerBound), std::log(setting.upperBound));
+        value = std::exp(distribution(generator));
+    }
+    else
+    {
+        std::uniform_real_distribution<double> distribution(setting.lowerBound, setting.upperBound);
+        value = distribution(generator);
+    }
+
+    if(setting.isInteger)
+    {
+        return (fmt::format(
+            "{}", (long long)std::clamp(std::round(value), setting.lowerBound, setting.upperBound)));
+    }
+
+    return (fmt::format("{:.6g}", value));
+}
+
+std::vector<std::string> getOptionLines(const Configuration& configuration)
+{
+    std::vector<std::string> lines;
+
+    for(auto& [key, value] : configuration)
+        lines.push_back(key + " = " + value);
+
+    return (lines);
+}
+
+std::string getConfigurationString(const Configuration& configuration)
+{
+    if(configuration.empty())
+        return ("defaults");
+
+    std::string result;
+
+    for(auto& [key, value] : configuration)
+        result += (result.empty() ? "" : " ") + key + "=" + value;
+
+    return (result);
+}
+
+// Solves all instances with the configuration and the time limit. The runs not reaching the gap count as the time
+// limit times the penalty factor in the shifted geometric mean of the times.
+Evaluation evaluateConfiguration(int configurationIndex, const Configuration& configuration,
+    const std::vector<std::string>& instances, int repetitions, const std::string& optionsFile,
+    const std::vector<std::string>& baseOptions, double gapTarget, double timeLimit, double penaltyFactor,
+    double shift)
+{
+    Evaluation evaluation;
+    evaluation.configurationIndex = configurationIndex;
+    evaluation.timeLimit = timeLimit;
+
+    auto options = baseOptions;
+
+    for(auto& L : getOptionLines(configuration))
+        options.push_back(L);
+
+    // The solver is stopped at the target gap, since the time after it is not measured
+    options.push_back(fmt::format("Termination.ObjectiveGap.Relative = {}", gapTarget));
+    options.push_back(fmt::format("Termination.TimeLimit = {}", timeLimit));
+
+    double sumOfLogarithms = 0.0;
+
+    for(auto& I : instances)
+    {
+        for(int r = 0; r < repetitions; r++)
+        {
+            auto run = runInstance(I, r + 1, optionsFile, options, gapTarget);
+
+            double time = penaltyFactor * timeLimit;
+
+            if(run.isSolved && run.timeToGap >= 0 && run.timeToGap <= timeLimit)
+            {
+                time = run.timeToGap;
+                evaluation.numberOfRunsReachingGap++;
+            }
+
+            sumOfLogarithms += std::log(time + shift);
+            evaluation.numberOfRuns++;
+        }
+    }
+
+    evaluation.score = std::exp(sumOfLogarithms / std::max(1, evaluation.numberOfRuns)) - shift;
+
+    std::cout << fmt::format("Configuration {:>4} ({:>8.2f} s limit): score {:>10.3f}, {:>3}/{:<3} reached gap  {}",
+                     configurationIndex, timeLimit, evaluation.score, evaluation.numberOfRunsReachingGap,
+                     evaluation.numberOfRuns, getConfigurationString(configuration))
+              << std::endl;
+
+    return (evaluation);
+}
+
+bool isBetter(const Evaluation& first, const Evaluation& second)
+{
+    if(first.score != second.score)
+        return (first.score < second.score);
+
+    // Ties are broken in favor of the earlier configuration, i.e. the defaults
+    return (first.configurationIndex < second.configurationIndex);
+}
+
+// Writes the configuration together with the base options given to the tuner as an options file
+bool writeOptionsFile(const std::string& filename, const Configuration& configuration, const Evaluation& evaluation,
+    const Evaluation& defaultEvaluation, size_t numberOfInstances, const std::string& optionsFile,
+    const std::vector<std::string>& baseOptions)
+{
+    auto solver = std::make_unique<Solver>();
+
+    if(optionsFile != "" && !solver->setOptionsFromFile(optionsFile))
+        return (false);
+
+    std::string options;
+
+    for(auto& O : baseOptions)
+        options += O + '\n';
+
+    for(auto& L : getOptionLines(configuration))
+        options += L + '\n';
+
+    if(!solver->setOptionsFromString(options))
+        return (false);
+
+    std::stringstream output;
+    output << fmt::format("* Tuned with shot_tune on {} instances with a {} s time limit\n", numberOfInstances,
+        evaluation.timeLimit);
+    output << fmt::format("* Score {:.3f} (defaults: {:.3f}), {} of {} runs reached the target gap\n",
+        evaluation.score, defaultEvaluation.score, evaluation.numberOfRunsReachingGap, evaluation.numberOfRuns);
+    output << solver->getEnvironment()->settings->getSettingsAsString(true, true);
+
+    return (Utilities::writeStringToFile(filename, output.str()));
+}
+
+bool writeEvaluationsCSV(const std::string& filename, const std::vector<Evaluation>& evaluations,
+    const std::vector<Configuration>& configurations)
+{
+    std::stringstream output;
+    output << "configuration,time_limit,score,runs_reaching_gap,runs,settings\n";
+
+    for(auto& E : evaluations)
+    {
+        output << fmt::format("{},{},{},{},{},\"{}\"\n", E.configurationIndex, E.timeLimit, E.score,
+            E.numberOfRunsReachingGap, E.numberOfRuns, getConfigurationString(configurations[E.configurationIndex]));
+    }
+
+    return (Utilities::writeStringToFile(filename, output.str()));
+}
+
+int main(int argc, char* argv[])
+{
+    argh::parser cmdl;
+    cmdl.add_params({ "--instances", "--dir", "--opt", "--repetitions", "--gap", "--timelimit", "--penalty" });
+    cmdl.add_params({ "--param", "--space", "--strategy", "--trials", "--eta", "--seed", "--output", "--csv" });
+    cmdl.parse(argc, argv);
+
+    if(cmdl["--help"])
+    {
+        std::cout << "Usage: shot_tune [INSTANCES] [OPTIONS] [OPTIONNAME=VALUE ...]" << std::endl
+                  << std::endl
+                  << "  --instances FILE     File with one instance per line" << std::endl
+                  << "  --dir DIRECTORY      Use the OSiL files in DIRECTORY (default: data)" << std::endl
+                  << "  --opt FILE           Reads in the SHOT options from FILE in GAMS format" << std::endl
+                  << "  --repetitions N      Number of times each instance is solved (default: 1)" << std::endl
+                  << "  --gap VALUE          Target relative gap (default: 0.01)" << std::endl
+                  << "  --timelimit VALUE    Time limit (s) per instance in the final evaluations (default: 60)"
+                  << std::endl
+                  << "  --penalty VALUE      Runs not reaching the gap count as VALUE times the time limit "
+                     "(default: 2)"
+                  << std::endl
+                  << "  --param SPEC         Tuned setting as Category.Name=v1,v2,... or Category.Name=lower:upper"
+                     "[:log], separated by semicolons"
+                  << std::endl
+                  << "  --space FILE         File with one tuned setting per line" << std::endl
+                  << "  --strategy NAME      random or halving (default: halving)" << std::endl
+                  << "  --trials N           Number of configurations, including the defaults (default: 16)"
+                  << std::endl
+                  << "  --eta N              Fraction 1/N of the configurations kept in each halving round "
+                     "(default: 2)"
+                  << std::endl
+                  << "  --seed N             Seed for sampling the configurations (default: 1)" << std::endl
+                  << "  --output FILE        Writes the best configuration to FILE (default: tuned.opt)" << std::endl
+                  << "  --csv FILE           Writes all evaluations to FILE (default: tuning.csv)" << std::endl
+                  << std::endl
+                  << "The options given as OPTIONNAME=VALUE are used in all configurations." << std::endl;
+
+        return (0);
+    }
+
+    std::vector<std::string> instances;
+    std::vector<std::string> baseOptions;
+
+    for(size_t i = 1; i < cmdl.pos_args().size(); i++)
+    {
+        auto& arg = cmdl.pos_args()[i];
+
+        if(arg.find('=') != std::string::npos)
+            baseOptions.push_back(arg);
+        else
+            instances.push_back(arg);
+    }
+
+    if(cmdl("--instances"))
+    {
+        auto listed = readInstanceList(cmdl("--instances").str());
+        instances.insert(instances.end(), listed.begin(), listed.end());
+    }
+
+    if(instances.size() == 0)
+        instances = findInstances(cmdl("--dir", "data").str(), { ".osil", ".xml" });
+
+    if(instances.size() == 0)
+    {
+        std::cout << "No instances to tune on." << std::endl;
+        return (1);
+    }
+
+    std::vector<std::string> specifications;
+
+    if(cmdl("--param"))
+    {
+        std::stringstream stream(cmdl("--param").str());
+        std::string specification;
+
+        while(std::getline(stream, specification, ';'))
+            specifications.push_back(specification);
+    }
+
+    if(cmdl("--space"))
+    {
+        std::ifstream file(cmdl("--space").str());
+
+        if(!file)
+        {
+            std::cout << "Could not read search space " << cmdl("--space").str() << std::endl;
+            return (1);
+        }
+
+        std::string line;
+
+        while(std::getline(file, line))
+        {
+            line = Utilities::trim(line);
+
+            if(!line.empty() && line[0] != '#' && line[0] != '*')
+                specifications.push_back(line);
+        }
+    }
+
+    if(specifications.size() == 0)
+        specifications = defaultSearchSpace;
+
+    std::vector<TunedSetting> searchSpace;
+
+    // The settings are checked against the definitions in the solver before any instance is solved
+    auto checkSolver = std::make_unique<Solver>();
+    checkSolver->updateSetting("Console.LogLevel", "Output", static_cast<int>(E_LogLevel::Off));
+
+    for(auto& S : specifications)
+    {
+        TunedSetting setting;
+
+        if(!parseTunedSetting(S, setting))
+        {
+            std::cout << "Could not parse the tuned setting \"" << S << "\"" << std::endl;
+            return (1);
+        }
+
+        std::mt19937 generator(0);
+
+        if(!checkSolver->setOptionsFromString(setting.key + " = " + sampleValue(setting, generator)))
+        {
+            std::cout << "The tuned setting " << setting.key << " is not defined in SHOT" << std::endl;
+            return (1);
+        }
+
+        searchSpace.push_back(setting);
+    }
+
+    int repetitions = 1;
+    int numberOfTrials = 16;
+    int eta = 2;
+    int seed = 1;
+    double gapTarget = 0.01;
+    double timeLimit = 60.0;
+    double penaltyFactor = 2.0;
+
+    cmdl("--repetitions", 1) >> repetitions;
+    cmdl("--trials", 16) >> numberOfTrials;
+    cmdl("--eta", 2) >> eta;
+    cmdl("--seed", 1) >> seed;
+    cmdl("--gap", 0.01) >> gapTarget;
+    cmdl("--timelimit", 60.0) >> timeLimit;
+    cmdl("--penalty", 2.0) >> penaltyFactor;
+
+    repetitions = std::max(1, repetitions);
+    numberOfTrials = std::max(1, numberOfTrials);
+    eta = std::max(2, eta);
+
+    std::string strategy = cmdl("--strategy", "halving").str();
+
+    if(strategy != "random" && strategy != "halving")
+    {
+        std::cout << "Unknown strategy " << strategy << ", should be random or halving" << std::endl;
+        return (1);
+    }
+
+    std::string optionsFile = cmdl("--opt", "").str();
+
+    // Duplicate configurations are resampled a limited number of times, since a small search space cannot fill all
+    // the trials
+    std::mt19937 generator(seed);
+    std::vector<Configuration> configurations = { Configuration() };
+
+    for(int attempts = 0; (int)configurations.size() < numberOfTrials && attempts < 100 * numberOfTrials; attempts++)
+    {
+        Configuration configuration;
+
+        for(auto& S : searchSpace)
+            configuration[S.key] = sampleValue(S, generator);
+
+        if(std::find(configurations.begin(), configurations.end(), configuration) == configurations.end())
+            configurations.push_back(configuration);
+    }
+
+    std::cout << fmt::format("Tuning {} settings with {} configurations on {} instances using {}.", searchSpace.size(),
+                     configurations.size(), instances.size(),
+                     strategy == "random" ? "random search" : "successive halving")
+              << std::endl
+              << std::endl;
+
+    // The shift in the geometric mean reduces the influence of the very easy instances
+    const double shift = std::min(1.0, 0.1 * timeLimit);
+
+    std::vector<Evaluation> evaluations;
+    std::vector<int> candidates;
+
+    for(size_t i = 0; i < configurations.size(); i++)
+        candidates.push_back((int)i);
+
+    int numberOfRounds = 1;
+
+    if(strategy == "halving")
+    {
+        for(size_t remaining = configurations.size(); remaining > 1; remaining = (remaining + eta - 1) / eta)
+            numberOfRounds++;
+    }
+
+    std::vector<Evaluation> roundEvaluations;
+
+    for(int round = 0; round < numberOfRounds; round++)
+    {
+        double roundTimeLimit = timeLimit / std::pow(eta, numberOfRounds - 1 - round);
+
+        if(numberOfRounds > 1)
+        {
+            std::cout << fmt::format("Round {} of {} with {} configurations and a {:.2f} s time limit:", round + 1,
+                             numberOfRounds, candidates.size(), roundTimeLimit)
+                      << std::endl;
+        }
+
+        roundEvaluations.clear();
+
+        for(auto C : candidates)
+        {
+            roundEvaluations.push_back(evaluateConfiguration(C, configurations[C], instances, repetitions,
+                optionsFile, baseOptions, gapTarget, roundTimeLimit, penaltyFactor, shift));
+        }
+
+        evaluations.insert(evaluations.end(), roundEvaluations.begin(), roundEvaluations.end());
+        std::sort(roundEvaluations.begin(), roundEvaluations.end(), isBetter);
+
+        size_t numberKept = std::max((size_t)1, (candidates.size() + eta - 1) / eta);
+        candidates.clear();
+
+        for(size_t i = 0; i < numberKept && i < roundEvaluations.size(); i++)
+            candidates.push_back(roundEvaluations[i].configurationIndex);
+
+        std::cout << std::endl;
+    }
+
+    auto& best = roundEvaluations.front();
+
+    // The defaults are compared with the best configuration at the same time limit, and evaluated separately if they
+    // were eliminated in an earlier round
+    auto defaultEvaluation = std::find_if(roundEvaluations.begin(), roundEvaluations.end(),
+        [](const Evaluation& E) { return (E.configurationIndex == 0); });
+
+    Evaluation defaults;
+
+    if(defaultEvaluation != roundEvaluations.end())
+    {
+        defaults = *defaultEvaluation;
+    }
+    else
+    {
+        defaults = evaluateConfiguration(0, configurations[0], instances, repetitions, optionsFile, baseOptions,
+            gapTarget, best.timeLimit, penaltyFactor, shift);
+        evaluations.push_back(defaults);
+    }
+
+    std::cout << fmt::format("Best configuration {}: score {:.3f} (defaults: {:.3f})", best.configurationIndex,
+                     best.score, defaults.score)
+              << std::endl
+              << "  " << getConfigurationString(configurations[best.configurationIndex]) << std::endl;
+
+    auto csvFile = cmdl("--csv", "tuning.csv").str();
+    auto outputFile = cmdl("--output", "tuned.opt").str();
+
+    if(!writeEvaluationsCSV(csvFile, evaluations, configurations))
+        std::cout << "Could not write the evaluations to " << csvFile << std::endl;
+
+    if(!writeOptionsFile(outputFile, configurations[best.configurationIndex], best, defaults, instances.size(),
+           optionsFile, baseOptions))
+    {
+        std::cout << "Could not write the best configuration to " << outputFile << std::endl;
+        return (1);
+    }
+
+    std::cout << "Best configuration written to " << outputFile << std::endl;
+
+    return (0);
+}